@@ -0,0 +1,256 @@
+#!/usr/bin/env python3
+"""
+Performance regression suite of the AliceVision command line tools.
+
+The workloads of workloads.json (feature extraction, matching, SfM, depth map estimation, meshing)
+are run in order on a fixed image set, and their wall time, peak resident memory and peak GPU memory
+are recorded in a JSON report. The report can be compared to a baseline report: a metric
+above the baseline value by more than the tolerance is a regression, and the script then fails.
+
+Usage:
+    python3 runPerfTests.py --binDir <install>/bin --images <images folder> --output <output folder>
+                            [--baseline baseline.json] [--timeTolerance 0.1] [--memoryTolerance 0.1]
+                            [--repeat 3] [--workloads featureExtraction_sift,incrementalSfM]
+
+The images of the SfM_quality_evaluation repository used by the functional tests
+(e.g. Benchmarking_Camera_Calibration_2008/fountain-P11/images) are a representative mid-size dataset.
+From the build folder, the 'perfTests' target runs the suite on ALICEVISION_PERF_TESTS_IMAGES.
+"""
+
+import argparse
+import json
+import os
+import platform
+import shutil
+import statistics
+import subprocess
+import sys
+import threading
+import time
+
+SCRIPT_DIR = os.path.abspath(os.path.dirname(__file__))
+DEFAULT_WORKLOADS = os.path.join(SCRIPT_DIR, "workloads.json")
+DEFAULT_SENSOR_DATABASE = os.path.join(SCRIPT_DIR, "..", "src", "aliceVision", "sensorDB", "cameraSensors.db")
+
+# Metrics compared to the baseline, with the name of their tolerance argument
+COMPARED_METRICS = {
+    "time": "timeTolerance",
+    "peakRss": "memoryTolerance",
+    "peakGpuMemory": "memoryTolerance",
+}
+
+# Metrics below these values are not compared (too small to be measured reliably)
+MIN_COMPARED_VALUES = {
+    "time": 0.5,  # seconds
+    "peakRss": 64 * 1024 * 1024,  # bytes
+    "peakGpuMemory": 64 * 1024 * 1024,  # bytes
+}
+
+
+class GpuMemoryMonitor(threading.Thread):
+    """ Poll the GPU memory used by a process with nvidia-smi, and keep its peak value. """
+
+    def __init__(self, pid, period=0.2):
+        super().__init__(daemon=True)
+        self.pid = pid
+        self.period = period
+        self.peak = 0
+        self._stopEvent = threading.Event()
+
+    @staticmethod
+    def available():
+        return shutil.which("nvidia-smi") is not None
+
+    def run(self):
+        while not self._stopEvent.is_set():
+            try:
+                output = subprocess.run(["nvidia-smi", "--query-compute-apps=pid,used_memory",
+                                         "--format=csv,noheader,nounits"],
+                                        capture_output=True, text=True, timeout=5).stdout
+                for line in output.splitlines():
+                    fields = [field.strip() for field in line.split(",")]
+                    if len(fields) == 2 and fields[0] == str(self.pid):
+                        self.peak = max(self.peak, int(fields[1]) * 1024 * 1024)
+            except (subprocess.SubprocessError, ValueError):
+                pass
+            self._stopEvent.wait(self.period)
+
+    def stop(self):
+        self._stopEvent.set()
+        self.join()
+
+
+def expandCommand(command, variables):
+    """ Replace the '{variable}' patterns of the command arguments. """
+    return [argument.format(**variables) for argument in command]
+
+
+def runCommand(command, logFile, monitorGpu):
+    """
+    Run a command and measure its wall time, its peak resident memory and its peak GPU memory.
+    Return a dictionary of metrics, raise a RuntimeError if the command fails.
+    """
+    with open(logFile, "w") as log:
+        start = time.perf_counter()
+        process = subprocess.Popen(command, stdout=log, stderr=subprocess.STDOUT)
+
+        monitor = None
+        if monitorGpu and GpuMemoryMonitor.available():
+            monitor = GpuMemoryMonitor(process.pid)
+            monitor.start()
+
+        # wait4 gives the resource usage of this process only
+        _, status, usage = os.wait4(process.pid, 0)
+        elapsed = time.perf_counter() - start
+        process.returncode = os.waitstatus_to_exitcode(status)
+
+        if monitor:
+            monitor.stop()
+
+    if process.returncode != 0:
+        raise RuntimeError("Command failed ({}), see '{}':\n{}".format(process.returncode, logFile, " ".join(command)))
+
+    # ru_maxrss is in kilobytes on Linux, in bytes on macOS
+    peakRss = usage.ru_maxrss if platform.system() == "Darwin" else usage.ru_maxrss * 1024
+
+    metrics = {"time": elapsed, "peakRss": peakRss}
+    if monitor:
+        metrics["peakGpuMemory"] = monitor.peak
+    return metrics
+
+
+def runWorkloads(args):
+    """ Run the workloads and return the report. """
+    with open(args.workloadsFile) as f:
+        workloads = json.load(f)["workloads"]
+
+    selected = set(args.workloads.split(",")) if args.workloads else None
+
+    os.makedirs(args.output, exist_ok=True)
+    logsFolder = os.path.join(args.output, "logs")
+    os.makedirs(logsFolder, exist_ok=True)
+
+    variables = {
+        "bin": os.path.abspath(args.binDir),
+        "images": os.path.abspath(args.images),
+        "sensorDatabase": os.path.abspath(args.sensorDatabase),
+        "output": os.path.abspath(args.output),
+    }
+
+    report = {
+        "host": platform.node(),
+        "platform": platform.platform(),
+        "date": time.strftime("%Y-%m-%dT%H:%M:%S"),
+        "images": variables["images"],
+        "repeat": args.repeat,
+        "workloads": {},
+    }
+
+    for workload in workloads:
+        name = workload["name"]
+        command = expandCommand(workload["command"], variables)
+        setup = workload.get("setup", False)
+
+        # the setup steps are always run (the next workloads depend on their outputs)
+        if not setup and selected is not None and name not in selected:
+            print("[skip]  {}".format(name))
+            continue
+
+        nbRuns = 1 if setup else args.repeat
+        runs = []
+        for run in range(nbRuns):
+            logFile = os.path.join(logsFolder, "{}_{}.log".format(name, run))
+            runs.append(runCommand(command, logFile, workload.get("gpu", False)))
+
+        if setup:
+            print("[setup] {} ({:.1f} s)".format(name, runs[0]["time"]))
+            continue
+
+        # the median of the runs (the peak memories are the maximum)
+        metrics = {"time": statistics.median(run["time"] for run in runs),
+                   "timeRuns": [run["time"] for run in runs],
+                   "peakRss": max(run["peakRss"] for run in runs)}
+        if "peakGpuMemory" in runs[0]:
+            metrics["peakGpuMemory"] = max(run["peakGpuMemory"] for run in runs)
+        report["workloads"][name] = metrics
+
+        print("[run]   {}: {:.2f} s, {:.0f} MB".format(name, metrics["time"], metrics["peakRss"] / (1024 * 1024)))
+
+    return report
+
+
+def compareToBaseline(report, baseline, args):
+    """ Compare the metrics of the report to the baseline, return the list of regressions. """
+    regressions = []
+    for name, metrics in report["workloads"].items():
+        baselineMetrics = baseline.get("workloads", {}).get(name)
+        if baselineMetrics is None:
+            print("[new]   {}: no baseline".format(name))
+            continue
+
+        for metric, toleranceName in COMPARED_METRICS.items():
+            if metric not in metrics or metric not in baselineMetrics:
+                continue
+            value = metrics[metric]
+            reference = baselineMetrics[metric]
+            if max(value, reference) < MIN_COMPARED_VALUES[metric]:
+                continue
+
+            tolerance = getattr(args, toleranceName)
+            ratio = value / reference if reference > 0 else float("inf")
+            status = "ok"
+            if ratio > 1.0 + tolerance:
+                status = "REGRESSION"
+                regressions.append({"workload": name, "metric": metric, "value": value,
+                                    "baseline": reference, "ratio": ratio})
+            elif ratio < 1.0 - tolerance:
+                status = "improvement"
+            print("[{}] {} {}: {:+.1f}%".format(status, name, metric, (ratio - 1.0) * 100.0))
+
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description="AliceVision performance regression suite.")
+    parser.add_argument("--binDir", required=True, help="Folder of the AliceVision executables.")
+    parser.add_argument("--images", required=True, help="Folder of the input images.")
+    parser.add_argument("--output", required=True, help="Output folder (intermediate files, logs and report).")
+    parser.add_argument("--report", default="", help="Path of the JSON report (default: <output>/perfReport.json).")
+    parser.add_argument("--baseline", default="", help="Baseline JSON report to compare to.")
+    parser.add_argument("--timeTolerance", type=float, default=0.1,
+                        help="Relative increase of the time above which a workload is a regression.")
+    parser.add_argument("--memoryTolerance", type=float, default=0.1,
+                        help="Relative increase of the peak memory above which a workload is a regression.")
+    parser.add_argument("--repeat", type=int, default=3, help="Number of runs of each workload (the median time is kept).")
+    parser.add_argument("--workloads", default="", help="Comma separated names of the workloads to run (default: all).")
+    parser.add_argument("--workloadsFile", default=DEFAULT_WORKLOADS, help="JSON description of the workloads.")
+    parser.add_argument("--sensorDatabase", default=DEFAULT_SENSOR_DATABASE, help="Camera sensors database.")
+    args = parser.parse_args()
+
+    try:
+        report = runWorkloads(args)
+    except RuntimeError as e:
+        print(e, file=sys.stderr)
+        return 2
+
+    regressions = []
+    if args.baseline:
+        with open(args.baseline) as f:
+            baseline = json.load(f)
+        regressions = compareToBaseline(report, baseline, args)
+        report["baseline"] = os.path.abspath(args.baseline)
+        report["regressions"] = regressions
+
+    reportPath = args.report or os.path.join(args.output, "perfReport.json")
+    with open(reportPath, "w") as f:
+        json.dump(report, f, indent=4)
+    print("Report written to '{}'.".format(reportPath))
+
+    if regressions:
+        print("{} performance regression(s) detected.".format(len(regressions)), file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
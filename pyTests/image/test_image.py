@@ -0,0 +1,64 @@
+"""
+Collection of unit tests for the Image class.
+"""
+
+import numpy as np
+
+from pyalicevision import image as av
+
+##################
+### List of functions:
+# - Image() => DONE
+# - Image(int width, int height, bool fInit) => DONE
+# - void resize(int width, int height, bool fInit) => DONE
+# - int width() => DONE
+# - int height() => DONE
+# - int channels() => DONE
+# - numpy getNumpyArray() => DONE
+##################
+
+def test_image_default_constructor():
+    """ Test creating an empty Image object and checking its size. """
+    img = av.ImageFloat()
+    assert img.width() == 0 and img.height() == 0
+    assert img.getNumpyArray().shape == (0, 0)
+
+
+def test_image_constructor():
+    """ Test creating Image objects of different pixel types and checking their sizes. """
+    img = av.ImageFloat(4, 3, True)
+    assert img.width() == 4 and img.height() == 3
+    assert img.channels() == 1
+
+    img_rgb = av.ImageRGBfColor(4, 3)
+    assert img_rgb.channels() == 3
+
+    img_rgba = av.ImageRGBAColor(4, 3)
+    assert img_rgba.channels() == 4
+
+    img.resize(8, 2)
+    assert img.width() == 8 and img.height() == 2
+
+
+def test_image_numpy_view():
+    """ Test getting numpy views over the pixels of Image objects and editing them in place. """
+    img = av.ImageRGBfColor(4, 3, True)
+    array = img.getNumpyArray()
+    assert array.shape == (3, 4, 3)
+    assert array.dtype == np.float32
+
+    # The view shares the pixels of the image
+    array[2, 1] = [0.25, 0.5, 1.0]
+    assert np.array_equal(img.getNumpyArray()[2, 1], [0.25, 0.5, 1.0])
+
+    img_gray = av.ImageUChar(5, 2, True)
+    array_gray = img_gray.getNumpyArray()
+    assert array_gray.shape == (2, 5)
+    assert array_gray.dtype == np.uint8
+
+
+def test_image_numpy_view_lifetime():
+    """ Test that a numpy view keeps its Image object alive. """
+    array = av.ImageFloat(6, 4, True).getNumpyArray()
+    array[:] = 2.0
+    assert array.sum() == 48.0
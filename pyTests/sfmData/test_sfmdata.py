@@ -18,6 +18,9 @@ from ..constants import IMAGE_PATH, VIEW_ID, INTRINSIC_ID, POSE_ID, IMAGE_WIDTH,
 # - Rigs& getRigs() => DONE
 # - Intrinsics& getIntrinsics() => DONE / Intrinsics derived classes not fully binded
 # - Landmarks& getLandmarks() => DONE
+# - numpy getLandmarksIds() => DONE
+# - numpy getLandmarksPositions() => DONE
+# - numpy getLandmarksColors() => DONE
 # - Constraints2D& getConstraints2D() => DONE
 # - RotationPriors& getRotationPriors() => DONE
 # - vector<string>& getRelativeFeaturesFolders() => DONE
@@ -124,6 +127,24 @@ def test_sfmdata_get_landmarks():
         "The list of Landmarks should have been updated"
 
 
+def test_sfmdata_get_landmarks_arrays():
+    """ Test creating an SfMData object with Landmarks and retrieving their values as numpy arrays. """
+    data = av.SfMData()
+    assert data.getLandmarksIds().shape == (0,)
+    assert data.getLandmarksPositions().shape == (0, 3)
+
+    landmarks = data.getLandmarks()
+    landmarks[456] = av.Landmark()
+    landmarks[123] = av.Landmark()
+
+    # The arrays are ordered by Landmark id
+    assert list(data.getLandmarksIds()) == [123, 456]
+    assert data.getLandmarksPositions().shape == (2, 3)
+    colors = data.getLandmarksColors()
+    assert colors.shape == (2, 3)
+    assert (colors == 255).all(), "The default color of a Landmark is white"
+
+
 def test_sfmdata_get_constraints2d():
     """" Test creating an empty SfMData object, retrieving and editing its Constraints2D. """
     data = av.SfMData()
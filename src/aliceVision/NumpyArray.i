@@ -0,0 +1,49 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+// NumPy C API, for the modules that return numpy arrays (views over the C++ buffers or bulk copies).
+
+%{
+#define NPY_NO_DEPRECATED_API NPY_1_7_API_VERSION
+#include <numpy/arrayobject.h>
+%}
+
+%init %{
+import_array();
+%}
+
+%{
+namespace aliceVision {
+namespace numpy {
+
+/**
+ * @brief Create a numpy array over a C++ buffer, without copy.
+ *        The array keeps a reference on the Python owner of the buffer, so that the buffer lives as long as the array.
+ * @param[in] owner The Python object owning the buffer
+ * @param[in] ndims The number of dimensions
+ * @param[in] dims The dimensions
+ * @param[in] typenum The numpy type of the elements
+ * @param[in] data The buffer
+ * @return the array (new reference), nullptr with a Python error set on failure
+ */
+inline PyObject* createView(PyObject* owner, int ndims, npy_intp* dims, int typenum, void* data)
+{
+    PyObject* array = PyArray_SimpleNewFromData(ndims, dims, typenum, data);
+    if (array == nullptr)
+        return nullptr;
+
+    Py_INCREF(owner);
+    if (PyArray_SetBaseObject(reinterpret_cast<PyArrayObject*>(array), owner) < 0)
+    {
+        Py_DECREF(array);
+        return nullptr;
+    }
+    return array;
+}
+
+}  // namespace numpy
+}  // namespace aliceVision
+%}
@@ -12,6 +12,7 @@
 %import <aliceVision/camera/Camera.i>
 %import <aliceVision/geometry/Geometry.i>
 %import <aliceVision/hdr/Hdr.i>
+%import <aliceVision/image/Image.i>
 %import <aliceVision/sensorDB/SensorDB.i>
 %import <aliceVision/sfmDataIO/SfMDataIO.i>
 %import <aliceVision/sfmData/SfMData.i>
@@ -26,14 +26,35 @@ using RowVector = Matrix<Type, 1, Size>;
 namespace aliceVision {
 namespace calibration {
 
-bool CheckerDetector::process(const image::Image<image::RGBColor>& source, bool useNestedGrids, bool debug)
+std::size_t CheckerDetector::getMemoryConsumption(std::size_t width, std::size_t height, bool debug)
+{
+    // source, grayscale and normalized images, then the intermediate float images of the finest level:
+    // rescaled, normalized, smoothed, 5 derivatives, Hessian response and peaks
+    const std::size_t bytesPerPixel = 3 + 2 * sizeof(float) + 10 * sizeof(float) + (debug ? 3 : 0);
+    return width * height * bytesPerPixel;
+}
+
+bool CheckerDetector::process(const image::Image<image::RGBColor>& source, bool useNestedGrids, bool debug, bool coarseToFine)
 {
     image::Image<float> grayscale;
     image::ConvertPixelType(source, &grayscale);
 
     const Vec2 center(grayscale.width() / 2, grayscale.height() / 2);
 
-    const double scales[] = {1.0, 0.75, 0.5, 0.25};
+    // Normalize image between 0 and 1
+    image::Image<float> normalized;
+    normalizeImage(normalized, grayscale);
+
+    // In coarse-to-fine mode, the corners are only searched on the downscaled images
+    // and their positions are refined locally at full resolution
+    const std::vector<double> scales = coarseToFine ? std::vector<double>{0.5, 0.25} : std::vector<double>{1.0, 0.75, 0.5, 0.25};
+
+    image::Image<float> gx, gy;
+    if (coarseToFine)
+    {
+        imageXDerivative(normalized, gx, true);
+        imageYDerivative(normalized, gy, true);
+    }
 
     std::vector<IntermediateCorner> allCorners;
     for (double scale : scales)
@@ -46,6 +67,14 @@ bool CheckerDetector::process(const image::Image<image::RGBColor>& source, bool
             return false;
         }
 
+        if (coarseToFine)
+        {
+            std::vector<Vec2> refinedCorners;
+            refineCorners(refinedCorners, corners, gx, gy);
+            corners.clear();
+            pruneCorners(corners, refinedCorners, normalized);
+        }
+
         ALICEVISION_LOG_DEBUG("[CheckerDetector] detected " << corners.size() << " corners");
 
         // Merge with previous level corners
@@ -74,10 +103,6 @@ bool CheckerDetector::process(const image::Image<image::RGBColor>& source, bool
 
     ALICEVISION_LOG_DEBUG("[CheckerDetector] kept " << allCorners.size() << " corners positions after merge between levels");
 
-    // Normalize image between 0 and 1
-    image::Image<float> normalized;
-    normalizeImage(normalized, grayscale);
-
     std::vector<CheckerBoardCorner> fittedCorners;
     fitCorners(fittedCorners, allCorners, normalized);
 
@@ -250,13 +275,7 @@ void CheckerDetector::normalizeImage(image::Image<float>& output, const image::I
     getMinMax(min, max, input);
 
     output.resize(input.width(), input.height());
-    for (int y = 0; y < output.height(); ++y)
-    {
-        for (int x = 0; x < output.width(); ++x)
-        {
-            output(y, x) = (input(y, x) - min) / (max - min);
-        }
-    }
+    output.array() = (input.array() - min) / (max - min);
 }
 
 void CheckerDetector::computeHessianResponse(image::Image<float>& output, const image::Image<float>& input) const
@@ -275,14 +294,9 @@ void CheckerDetector::computeHessianResponse(image::Image<float>& output, const
     imageXDerivative(gy, gxy, true);
     imageYDerivative(gy, gyy, true);
 
+    // Vectorized over the whole image
     output.resize(input.width(), input.height());
-    for (int y = 0; y < input.height(); ++y)
-    {
-        for (int x = 0; x < input.width(); ++x)
-        {
-            output(y, x) = std::abs(gxx(y, x) * gyy(y, x) - 2.0 * gxy(y, x));
-        }
-    }
+    output.array() = (gxx.array() * gyy.array() - 2.0f * gxy.array()).abs();
 }
 
 void CheckerDetector::extractCorners(std::vector<Vec2>& rawCorners, const image::Image<float>& hessianResponse) const
@@ -294,34 +308,22 @@ void CheckerDetector::extractCorners(std::vector<Vec2>& rawCorners, const image:
     const int radius = 7;
 
     // Find peaks (local maxima) of the Hessian response
-    image::Image<float> output(hessianResponse.width(), hessianResponse.height(), true, 0.0f);
     for (int i = radius; i < hessianResponse.height() - radius; ++i)
     {
         for (int j = radius; j < hessianResponse.width() - radius; ++j)
         {
-            bool isMaximal = true;
             const float val = hessianResponse(i, j);
 
-            // Compare value to neighborhood
-            for (int k = -radius; k <= radius; ++k)
-            {
-                for (int l = -radius; l <= radius; ++l)
-                {
-                    if (hessianResponse(i + k, j + l) > val)
-                    {
-                        isMaximal = false;
-                    }
-                }
-            }
+            // Peak must be higher than a global threshold
+            if (val <= threshold)
+                continue;
 
+            // Compare value to neighborhood
+            const bool isMaximal = (hessianResponse.block(i - radius, j - radius, 2 * radius + 1, 2 * radius + 1).array() <= val).all();
             if (!isMaximal)
                 continue;
 
-            // Peak must be higher than a global threshold
-            if (val > threshold)
-            {
-                rawCorners.emplace_back(j, i);
-            }
+            rawCorners.emplace_back(j, i);
         }
     }
 }
@@ -330,14 +332,11 @@ void CheckerDetector::getMinMax(float& min, float& max, const image::Image<float
 {
     min = std::numeric_limits<float>::max();
     max = std::numeric_limits<float>::min();
-    for (int y = 0; y < input.height(); ++y)
-    {
-        for (int x = 0; x < input.width(); ++x)
-        {
-            min = std::min(min, input(y, x));
-            max = std::max(max, input(y, x));
-        }
-    }
+    if (input.size() == 0)
+        return;
+
+    min = std::min(min, input.minCoeff());
+    max = std::max(max, input.maxCoeff());
 }
 
 void CheckerDetector::refineCorners(std::vector<Vec2>& refinedCorners, const std::vector<Vec2>& rawCorners, const image::Image<float>& input) const
@@ -346,6 +345,14 @@ void CheckerDetector::refineCorners(std::vector<Vec2>& refinedCorners, const std
     imageXDerivative(input, gx, true);
     imageYDerivative(input, gy, true);
 
+    refineCorners(refinedCorners, rawCorners, gx, gy);
+}
+
+void CheckerDetector::refineCorners(std::vector<Vec2>& refinedCorners,
+                                    const std::vector<Vec2>& rawCorners,
+                                    const image::Image<float>& gx,
+                                    const image::Image<float>& gy) const
+{
     const int radius = 5;
 
     for (const Vec2& pt : rawCorners)
@@ -111,9 +111,21 @@ class CheckerDetector
      * @param source[in] Input image containing checkerboards.
      * @param useNestedGrid[in] Indicate if the image contains nested calibration grids.
      * @param debug[in] Indicate if debug images should be drawn.
+     * @param coarseToFine[in] Only search the corners on the downscaled images and refine their positions at full resolution,
+     *                         faster on large images but may miss the smallest checkers.
      * @return False if a problem occured during detection, otherwise true.
      */
-    bool process(const image::Image<image::RGBColor>& source, bool useNestedGrids = false, bool debug = false);
+    bool process(const image::Image<image::RGBColor>& source, bool useNestedGrids = false, bool debug = false, bool coarseToFine = false);
+
+    /**
+     * @brief Estimate the peak memory used by the detection on an image.
+     *
+     * @param[in] width Image width.
+     * @param[in] height Image height.
+     * @param[in] debug Indicate if debug images are drawn.
+     * @return The estimated memory in bytes.
+     */
+    static std::size_t getMemoryConsumption(std::size_t width, std::size_t height, bool debug);
 
     /// Return a copy of detected checkerboards.
     std::vector<CheckerBoard> getBoards() const { return _boards; }
@@ -207,6 +219,19 @@ class CheckerDetector
      */
     void refineCorners(std::vector<Vec2>& refinedCorners, const std::vector<Vec2>& rawCorners, const image::Image<float>& input) const;
 
+    /**
+     * @brief Refine corners positions using precomputed image gradients.
+     *
+     * @param[out] refinedCorners Refined corners positions.
+     * @param[in] rawCorners Initial corners positions.
+     * @param[in] gx Image gradient along x.
+     * @param[in] gy Image gradient along y.
+     */
+    void refineCorners(std::vector<Vec2>& refinedCorners,
+                       const std::vector<Vec2>& rawCorners,
+                       const image::Image<float>& gx,
+                       const image::Image<float>& gy) const;
+
     /**
      * @brief Analyze grayscale values in the neighborhood of given corners positions and select the ones that match a checkerboard pattern.
      * @see [Bok]
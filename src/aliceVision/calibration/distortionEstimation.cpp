@@ -10,11 +10,81 @@
 
 #include <ceres/ceres.h>
 
+#include <algorithm>
 #include <cmath>
+#include <stdexcept>
 
 namespace aliceVision {
 namespace calibration {
 
+ELinearSolver ELinearSolver_stringToEnum(const std::string& linearSolver)
+{
+    std::string type = linearSolver;
+    std::transform(type.begin(), type.end(), type.begin(), ::tolower);  // tolower
+
+    if (type == "dense_qr")
+        return ELinearSolver::DENSE_QR;
+    if (type == "dense_schur")
+        return ELinearSolver::DENSE_SCHUR;
+    if (type == "sparse_schur")
+        return ELinearSolver::SPARSE_SCHUR;
+
+    throw std::out_of_range(linearSolver);
+}
+
+std::string ELinearSolver_enumToString(ELinearSolver linearSolver)
+{
+    switch (linearSolver)
+    {
+        case ELinearSolver::DENSE_QR:
+            return "dense_qr";
+        case ELinearSolver::DENSE_SCHUR:
+            return "dense_schur";
+        case ELinearSolver::SPARSE_SCHUR:
+            return "sparse_schur";
+    }
+    throw std::out_of_range("Invalid linear solver enum");
+}
+
+/**
+ * @brief Fill the Ceres solver options from the estimation options.
+ * @note The cost functions update their shared undistortion object, so the residuals are evaluated on a single thread.
+ */
+void setSolverOptions(ceres::Solver::Options& solverOptions, const EstimationOptions& options)
+{
+    solverOptions.use_inner_iterations = true;
+    solverOptions.max_num_iterations = options.maxNumIterations;
+    solverOptions.logging_type = ceres::SILENT;
+    solverOptions.num_threads = 1;
+
+    switch (options.linearSolver)
+    {
+        case ELinearSolver::DENSE_QR:
+            solverOptions.linear_solver_type = ceres::DENSE_QR;
+            break;
+        case ELinearSolver::DENSE_SCHUR:
+            solverOptions.linear_solver_type = ceres::DENSE_SCHUR;
+            break;
+        case ELinearSolver::SPARSE_SCHUR:
+            if (ceres::IsSparseLinearAlgebraLibraryTypeAvailable(ceres::SUITE_SPARSE))
+            {
+                solverOptions.linear_solver_type = ceres::SPARSE_SCHUR;
+                solverOptions.sparse_linear_algebra_library_type = ceres::SUITE_SPARSE;
+            }
+            else if (ceres::IsSparseLinearAlgebraLibraryTypeAvailable(ceres::EIGEN_SPARSE))
+            {
+                solverOptions.linear_solver_type = ceres::SPARSE_SCHUR;
+                solverOptions.sparse_linear_algebra_library_type = ceres::EIGEN_SPARSE;
+            }
+            else
+            {
+                ALICEVISION_LOG_WARNING("No sparse linear algebra library available, fallback to the dense Schur solver.");
+                solverOptions.linear_solver_type = ceres::DENSE_SCHUR;
+            }
+            break;
+    }
+}
+
 class CostLine : public ceres::CostFunction
 {
   public:
@@ -189,7 +259,8 @@ bool estimate(std::shared_ptr<camera::Undistortion> undistortionToEstimate,
               Statistics& statistics,
               std::vector<LineWithPoints>& lines,
               bool lockCenter,
-              const std::vector<bool>& lockDistortions)
+              const std::vector<bool>& lockDistortions,
+              const EstimationOptions& options)
 {
     if (!undistortionToEstimate)
     {
@@ -274,13 +345,25 @@ bool estimate(std::shared_ptr<camera::Undistortion> undistortionToEstimate,
         }
     }
 
-    ceres::Solver::Options options;
-    options.use_inner_iterations = true;
-    options.max_num_iterations = 100;
-    options.logging_type = ceres::SILENT;
+    ceres::Solver::Options solverOptions;
+    setSolverOptions(solverOptions, options);
+
+    if (options.linearSolver != ELinearSolver::DENSE_QR)
+    {
+        // Eliminate the independent line parameters first, the reduced system only contains the camera parameters
+        std::shared_ptr<ceres::ParameterBlockOrdering> ordering = std::make_shared<ceres::ParameterBlockOrdering>();
+        for (auto& l : lines)
+        {
+            ordering->AddElementToGroup(&l.angle, 0);
+            ordering->AddElementToGroup(&l.dist, 0);
+        }
+        ordering->AddElementToGroup(center, 1);
+        ordering->AddElementToGroup(ptrUndistortionParameters, 1);
+        solverOptions.linear_solver_ordering = ordering;
+    }
 
     ceres::Solver::Summary summary;
-    ceres::Solve(options, &problem, &summary);
+    ceres::Solve(solverOptions, &problem, &summary);
 
     ALICEVISION_LOG_TRACE(summary.FullReport());
 
@@ -326,7 +409,8 @@ bool estimate(std::shared_ptr<camera::Undistortion> undistortionToEstimate,
               Statistics& statistics,
               const std::vector<PointPair>& pointpairs,
               bool lockCenter,
-              const std::vector<bool>& lockDistortions)
+              const std::vector<bool>& lockDistortions,
+              const EstimationOptions& options)
 {
     if (!undistortionToEstimate)
     {
@@ -406,13 +490,15 @@ bool estimate(std::shared_ptr<camera::Undistortion> undistortionToEstimate,
         problem.AddResidualBlock(costFunction, lossFunction, center, ptrUndistortionParameters);
     }
 
-    ceres::Solver::Options options;
-    options.use_inner_iterations = true;
-    options.max_num_iterations = 100;
-    options.logging_type = ceres::SILENT;
+    // No parameter to eliminate in this problem, the Schur solvers are replaced by the dense QR
+    EstimationOptions pointOptions = options;
+    pointOptions.linearSolver = ELinearSolver::DENSE_QR;
+
+    ceres::Solver::Options solverOptions;
+    setSolverOptions(solverOptions, pointOptions);
 
     ceres::Solver::Summary summary;
-    ceres::Solve(options, &problem, &summary);
+    ceres::Solve(solverOptions, &problem, &summary);
 
     ALICEVISION_LOG_TRACE(summary.FullReport());
 
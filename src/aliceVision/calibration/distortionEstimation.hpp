@@ -12,6 +12,7 @@
 
 #include <vector>
 #include <memory>
+#include <string>
 
 namespace aliceVision {
 namespace calibration {
@@ -55,6 +56,31 @@ struct Statistics
     double max;
 };
 
+/**
+ * @brief Linear solver used by the distortion estimation.
+ */
+enum class ELinearSolver
+{
+    /// dense QR factorization of the whole problem
+    DENSE_QR,
+    /// line parameters eliminated with the Schur complement, dense reduced system
+    DENSE_SCHUR,
+    /// line parameters eliminated with the Schur complement, sparse reduced system
+    SPARSE_SCHUR
+};
+
+ELinearSolver ELinearSolver_stringToEnum(const std::string& linearSolver);
+std::string ELinearSolver_enumToString(ELinearSolver linearSolver);
+
+/**
+ * @brief Options of the distortion estimation solver.
+ */
+struct EstimationOptions
+{
+    ELinearSolver linearSolver = ELinearSolver::DENSE_QR;
+    unsigned int maxNumIterations = 100;
+};
+
 /**
  * @brief Estimate the undistortion parameters of a camera using a set of line aligned points.
  *
@@ -65,13 +91,15 @@ struct Statistics
  * @param[in] lines Set of line aligned points used to estimate distortion.
  * @param[in] lockCenter Lock the distortion offset during optimization.
  * @param[in] lockDistortions Distortion parameters to lock during optimization.
+ * @param[in] options Solver options.
  * @return False if the estimation failed, otherwise true.
  */
 bool estimate(std::shared_ptr<camera::Undistortion> undistortionToEstimate,
               Statistics& statistics,
               std::vector<LineWithPoints>& lines,
               bool lockCenter,
-              const std::vector<bool>& lockDistortions);
+              const std::vector<bool>& lockDistortions,
+              const EstimationOptions& options = EstimationOptions());
 
 
 /**
@@ -84,13 +112,15 @@ bool estimate(std::shared_ptr<camera::Undistortion> undistortionToEstimate,
  * @param[in] pointpairs Set of pair of points used to estimate distortion.
  * @param[in] lockCenter Lock the distortion offset during optimization.
  * @param[in] lockDistortions Distortion parameters to lock during optimization.
+ * @param[in] options Solver options.
  * @return False if the estimation failed, otherwise true.
  */
 bool estimate(std::shared_ptr<camera::Undistortion> undistortionToEstimate,
               Statistics& statistics,
               const std::vector<PointPair>& pointpairs,
               bool lockCenter,
-              const std::vector<bool>& lockDistortions);
+              const std::vector<bool>& lockDistortions,
+              const EstimationOptions& options = EstimationOptions());
 
 }  // namespace calibration
 }  // namespace aliceVision
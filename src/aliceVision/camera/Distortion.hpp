@@ -29,7 +29,7 @@ class Distortion
 
     virtual Distortion* clone() const = 0;
 
-    // not virtual as child classes do not hold any data
+    // not virtual as child classes do not hold any data, apart from caches derived from the parameters
     bool operator==(const Distortion& other) const { return _distortionParams == other._distortionParams; }
 
     void setParameters(const std::vector<double>& params)
@@ -57,6 +57,31 @@ class Distortion
     /// Remove distortion (return p' such that disto(p') = p)
     virtual Vec2 removeDistortion(const Vec2& p) const { return p; }
 
+    /**
+     * @brief Add distortion to a set of points in the camera frame, in place.
+     *        Models with a closed form override it to process all the points at once.
+     * @param[in,out] pts the points, one per column
+     */
+    virtual void addDistortionBatch(Mat2X& pts) const
+    {
+        for (Eigen::Index i = 0; i < pts.cols(); ++i)
+        {
+            pts.col(i) = addDistortion(pts.col(i));
+        }
+    }
+
+    /**
+     * @brief Remove distortion from a set of points in the camera frame, in place.
+     * @param[in,out] pts the points, one per column
+     */
+    virtual void removeDistortionBatch(Mat2X& pts) const
+    {
+        for (Eigen::Index i = 0; i < pts.cols(); ++i)
+        {
+            pts.col(i) = removeDistortion(pts.col(i));
+        }
+    }
+
     virtual double getUndistortedRadius(double r) const { return r; }
 
     virtual Eigen::Matrix2d getDerivativeAddDistoWrtPt(const Vec2& p) const { return Eigen::Matrix2d::Identity(); }
@@ -112,10 +112,17 @@ Eigen::MatrixXd DistortionFisheye::getDerivativeAddDistoWrtDisto(const Vec2& p)
 }
 
 Vec2 DistortionFisheye::removeDistortion(const Vec2& p) const
+{
+    const double r2 = p(0) * p(0) + p(1) * p(1);
+    const double scale = _inverseCache.getScale(_distortionParams, r2, [this](double r2) { return getUndistortionScale(r2); });
+    return p * scale;
+}
+
+double DistortionFisheye::getUndistortionScale(double r2) const
 {
     const double eps = 1e-8;
     double scale = 1.0;
-    const double theta_dist = std::hypot(p[0], p[1]);
+    const double theta_dist = std::sqrt(r2);
     if (theta_dist > eps)
     {
         double theta = theta_dist;
@@ -130,7 +137,7 @@ Vec2 DistortionFisheye::removeDistortion(const Vec2& p) const
         }
         scale = std::tan(theta) / theta_dist;
     }
-    return p * scale;
+    return scale;
 }
 
 Eigen::Matrix2d DistortionFisheye::getDerivativeRemoveDistoWrtPt(const Vec2& p) const
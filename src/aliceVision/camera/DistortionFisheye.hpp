@@ -8,6 +8,7 @@
 #pragma once
 
 #include <aliceVision/camera/Distortion.hpp>
+#include <aliceVision/camera/RadialInverseCache.hpp>
 
 namespace aliceVision {
 namespace camera {
@@ -38,6 +39,12 @@ class DistortionFisheye : public Distortion
     Eigen::MatrixXd getDerivativeRemoveDistoWrtDisto(const Vec2& p) const override;
 
     ~DistortionFisheye() override = default;
+
+  private:
+    /// Exact undistortion scale s such that removeDistortion(p) = s(|p|^2) * p
+    double getUndistortionScale(double r2) const;
+
+    RadialInverseCache _inverseCache;
 };
 
 }  // namespace camera
@@ -23,6 +23,13 @@ Vec2 DistortionRadialK1::addDistortion(const Vec2& p) const
     return (p * r_coeff);
 }
 
+void DistortionRadialK1::addDistortionBatch(Mat2X& pts) const
+{
+    const double k1 = _distortionParams.at(0);
+    const Eigen::Array<double, 1, Eigen::Dynamic> r2 = pts.colwise().squaredNorm().array();
+    pts.array().rowwise() *= (1. + k1 * r2);
+}
+
 Eigen::Matrix2d DistortionRadialK1::getDerivativeAddDistoWrtPt(const Vec2& p) const
 {
     const double k1 = _distortionParams[0];
@@ -48,10 +55,15 @@ Vec2 DistortionRadialK1::removeDistortion(const Vec2& p) const
     // Minimize disto(radius(p')^2) == actual Squared(radius(p))
 
     const double r2 = p(0) * p(0) + p(1) * p(1);
-    const double radius = (r2 == 0) ? 1. : ::sqrt(radial_distortion::bisection_Radius_Solve(_distortionParams, r2, distoFunctor) / r2);
+    const double radius = _inverseCache.getScale(_distortionParams, r2, [this](double r2) { return getUndistortionScale(r2); });
     return radius * p;
 }
 
+double DistortionRadialK1::getUndistortionScale(double r2) const
+{
+    return (r2 == 0) ? 1. : ::sqrt(radial_distortion::bisection_Radius_Solve(_distortionParams, r2, distoFunctor) / r2);
+}
+
 Eigen::Matrix2d DistortionRadialK1::getDerivativeRemoveDistoWrtPt(const Vec2& p) const
 {
     const double r = sqrt(p(0) * p(0) + p(1) * p(1));
@@ -123,6 +135,16 @@ Vec2 DistortionRadialK3::addDistortion(const Vec2& p) const
     return (p * r_coeff);
 }
 
+void DistortionRadialK3::addDistortionBatch(Mat2X& pts) const
+{
+    const double k1 = _distortionParams[0];
+    const double k2 = _distortionParams[1];
+    const double k3 = _distortionParams[2];
+
+    const Eigen::Array<double, 1, Eigen::Dynamic> r2 = pts.colwise().squaredNorm().array();
+    pts.array().rowwise() *= (1. + r2 * (k1 + r2 * (k2 + r2 * k3)));
+}
+
 Eigen::Matrix2d DistortionRadialK3::getDerivativeAddDistoWrtPt(const Vec2& p) const
 {
     const double& k1 = _distortionParams[0];
@@ -180,12 +202,15 @@ Vec2 DistortionRadialK3::removeDistortion(const Vec2& p) const
     // Minimize disto(radius(p')^2) == actual Squared(radius(p))
 
     const double r2 = p(0) * p(0) + p(1) * p(1);
-    const double radius = (r2 == 0) ?  // 1. : ::sqrt(bisectionSolve(_distortionParams, r2) / r2);
-                            1.
-                                    : ::sqrt(radial_distortion::bisection_Radius_Solve(_distortionParams, r2, distoFunctor) / r2);
+    const double radius = _inverseCache.getScale(_distortionParams, r2, [this](double r2) { return getUndistortionScale(r2); });
     return radius * p;
 }
 
+double DistortionRadialK3::getUndistortionScale(double r2) const
+{
+    return (r2 == 0) ? 1. : ::sqrt(radial_distortion::bisection_Radius_Solve(_distortionParams, r2, distoFunctor) / r2);
+}
+
 Eigen::Matrix2d DistortionRadialK3::getDerivativeRemoveDistoWrtPt(const Vec2& p) const
 {
     const double r = sqrt(p(0) * p(0) + p(1) * p(1));
@@ -414,14 +439,17 @@ Vec2 DistortionRadialK3PT::removeDistortion(const Vec2& p) const
     // Minimize disto(radius(p')^2) == actual Squared(radius(p))
 
     const double r2 = p(0) * p(0) + p(1) * p(1);
-    const double radius = (r2 == 0) ?  // 1. : ::sqrt(bisectionSolve(_distortionParams, r2) / r2);
-                            1.
-                                    : ::sqrt(radial_distortion::bisection_Radius_Solve(_distortionParams, r2, distoFunctor, 1e-12) / r2);
+    const double radius = _inverseCache.getScale(_distortionParams, r2, [this](double r2) { return getUndistortionScale(r2); });
 
     const Vec2 p_undist = radius * p;
     return p_undist;
 }
 
+double DistortionRadialK3PT::getUndistortionScale(double r2) const
+{
+    return (r2 == 0) ? 1. : ::sqrt(radial_distortion::bisection_Radius_Solve(_distortionParams, r2, distoFunctor, 1e-12) / r2);
+}
+
 double DistortionRadialK3PT::getUndistortedRadius(double r) const
 {
     return std::sqrt(radial_distortion::bisection_Radius_Solve(_distortionParams, r * r, distoFunctor));
@@ -8,6 +8,7 @@
 #pragma once
 
 #include <aliceVision/camera/Distortion.hpp>
+#include <aliceVision/camera/RadialInverseCache.hpp>
 
 namespace aliceVision {
 namespace camera {
@@ -73,6 +74,9 @@ class DistortionRadialK1 : public Distortion
     /// Add distortion to the point p (assume p is in the camera frame [normalized coordinates])
     Vec2 addDistortion(const Vec2& p) const override;
 
+    /// Add distortion to all the points at once
+    void addDistortionBatch(Mat2X& pts) const override;
+
     Eigen::Matrix2d getDerivativeAddDistoWrtPt(const Vec2& p) const override;
 
     Eigen::MatrixXd getDerivativeAddDistoWrtDisto(const Vec2& p) const override;
@@ -90,6 +94,12 @@ class DistortionRadialK1 : public Distortion
     static double distoFunctor(const std::vector<double>& params, double r2);
 
     ~DistortionRadialK1() override = default;
+
+  private:
+    /// Exact undistortion scale s such that removeDistortion(p) = s(|p|^2) * p
+    double getUndistortionScale(double r2) const;
+
+    RadialInverseCache _inverseCache;
 };
 
 /**
@@ -120,6 +130,9 @@ class DistortionRadialK3 : public Distortion
     /// Add distortion to the point p (assume p is in the camera frame [normalized coordinates])
     Vec2 addDistortion(const Vec2& p) const override;
 
+    /// Add distortion to all the points at once
+    void addDistortionBatch(Mat2X& pts) const override;
+
     Eigen::Matrix2d getDerivativeAddDistoWrtPt(const Vec2& p) const override;
 
     Eigen::MatrixXd getDerivativeAddDistoWrtDisto(const Vec2& p) const override;
@@ -137,6 +150,12 @@ class DistortionRadialK3 : public Distortion
     static double distoFunctor(const std::vector<double>& params, double r2);
 
     ~DistortionRadialK3() override = default;
+
+  private:
+    /// Exact undistortion scale s such that removeDistortion(p) = s(|p|^2) * p
+    double getUndistortionScale(double r2) const;
+
+    RadialInverseCache _inverseCache;
 };
 
 class DistortionRadialK3PT : public Distortion
@@ -170,6 +189,12 @@ class DistortionRadialK3PT : public Distortion
     static double distoFunctor(const std::vector<double>& params, double r2);
 
     ~DistortionRadialK3PT() override = default;
+
+  private:
+    /// Exact undistortion scale s such that removeDistortion(p) = s(|p|^2) * p
+    double getUndistortionScale(double r2) const;
+
+    RadialInverseCache _inverseCache;
 };
 
 }  // namespace camera
@@ -166,6 +166,36 @@ class IntrinsicBase
      */
     virtual Eigen::Matrix<double, 2, Eigen::Dynamic> getDerivativeProjectWrtParams(const Eigen::Matrix4d& pos, const Vec4& pt3D) const = 0;
 
+    /**
+     * @brief Project a set of 3D points into the image plane.
+     *        The default implementation projects the points one by one,
+     *        the models with a closed form override it to process all the points at once.
+     * @param[in] pose The pose
+     * @param[in] pts3D The 3D points, one per column
+     * @param[out] pts2D The projected points in the image plane
+     * @param[in] applyDistortion If true apply distrortion if any
+     */
+    void projectBatch(const geometry::Pose3& pose, const Mat3X& pts3D, Mat2X& pts2D, bool applyDistortion = true) const
+    {
+        projectBatch(pose.getHomogeneous(), pts3D, pts2D, applyDistortion);
+    }
+
+    /**
+     * @brief Project a set of 3D points into the image plane.
+     * @param[in] pose The pose, as a 4x4 matrix
+     * @param[in] pts3D The 3D points, one per column
+     * @param[out] pts2D The projected points in the image plane
+     * @param[in] applyDistortion If true apply distrortion if any
+     */
+    virtual void projectBatch(const Eigen::Matrix4d& pose, const Mat3X& pts3D, Mat2X& pts2D, bool applyDistortion = true) const
+    {
+        pts2D.resize(2, pts3D.cols());
+        for (Eigen::Index i = 0; i < pts3D.cols(); ++i)
+        {
+            pts2D.col(i) = project(pose, pts3D.col(i).homogeneous(), applyDistortion);
+        }
+    }
+
     /**
      * @brief Compute the residual between the 3D projected point X and an image observation x
      * @param[in] pose The pose
@@ -189,13 +219,9 @@ class IntrinsicBase
     inline Mat2X residuals(const geometry::Pose3& pose, const Mat3X& X, const Mat2X& x) const
     {
         assert(X.cols() == x.cols());
-        const std::size_t numPts = x.cols();
-        Mat2X residuals = Mat2X::Zero(2, numPts);
-        for (std::size_t i = 0; i < numPts; ++i)
-        {
-            residuals.col(i) = residual(pose, ((const Vec3&)X.col(i)).homogeneous(), x.col(i));
-        }
-        return residuals;
+        Mat2X proj;
+        projectBatch(pose, X, proj);
+        return x - proj;
     }
 
     /**
@@ -330,6 +356,30 @@ class IntrinsicBase
      */
     virtual Vec2 removeDistortion(const Vec2& p) const = 0;
 
+    /**
+     * @brief Add distortion to a set of points in the camera plane, in place.
+     * @param[in,out] pts Points in the camera plane, one per column.
+     */
+    virtual void addDistortionBatch(Mat2X& pts) const
+    {
+        for (Eigen::Index i = 0; i < pts.cols(); ++i)
+        {
+            pts.col(i) = addDistortion(pts.col(i));
+        }
+    }
+
+    /**
+     * @brief Remove distortion from a set of points in the camera plane, in place.
+     * @param[in,out] pts Points in the camera plane, one per column.
+     */
+    virtual void removeDistortionBatch(Mat2X& pts) const
+    {
+        for (Eigen::Index i = 0; i < pts.cols(); ++i)
+        {
+            pts.col(i) = removeDistortion(pts.col(i));
+        }
+    }
+
     /**
      * @brief Return the undistorted pixel (with removed distortion)
      * @param[in] p The point
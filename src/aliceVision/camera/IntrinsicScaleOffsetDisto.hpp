@@ -103,6 +103,38 @@ class IntrinsicScaleOffsetDisto : public IntrinsicScaleOffset
         return p;
     }
 
+    /**
+     * @brief Add distortion to a set of points in the camera plane, in place.
+     * @param[in,out] pts Points in the camera plane, one per column.
+     */
+    void addDistortionBatch(Mat2X& pts) const override
+    {
+        if (_pDistortion)
+        {
+            _pDistortion->addDistortionBatch(pts);
+        }
+        else if (_pUndistortion)
+        {
+            IntrinsicBase::addDistortionBatch(pts);
+        }
+    }
+
+    /**
+     * @brief Remove distortion from a set of points in the camera plane, in place.
+     * @param[in,out] pts Points in the camera plane, one per column.
+     */
+    void removeDistortionBatch(Mat2X& pts) const override
+    {
+        if (_pUndistortion)
+        {
+            IntrinsicBase::removeDistortionBatch(pts);
+        }
+        else if (_pDistortion)
+        {
+            _pDistortion->removeDistortionBatch(pts);
+        }
+    }
+
     /// Return the un-distorted pixel (with removed distortion)
     Vec2 getUndistortedPixel(const Vec2& p) const override;
 
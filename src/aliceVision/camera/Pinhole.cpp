@@ -46,6 +46,20 @@ Vec2 Pinhole::project(const Eigen::Matrix4d& pose, const Vec4& pt, bool applyDis
     return impt;
 }
 
+void Pinhole::projectBatch(const Eigen::Matrix4d& pose, const Mat3X& pts3D, Mat2X& pts2D, bool applyDistortion) const
+{
+    const Mat3X X = (pose.topLeftCorner<3, 3>() * pts3D).colwise() + pose.topRightCorner<3, 1>();  // apply pose
+    pts2D = X.topRows<2>().array().rowwise() / X.row(2).array();
+
+    if (applyDistortion)
+    {
+        addDistortionBatch(pts2D);
+    }
+
+    // cam2ima
+    pts2D = (pts2D.array().colwise() * _scale.array()).colwise() + getPrincipalPoint().array();
+}
+
 Eigen::Matrix<double, 2, 9> Pinhole::getDerivativeProjectWrtRotation(const Eigen::Matrix4d& pose, const Vec4& pt)
 {
     const Vec4 X = pose * pt;  // apply pose
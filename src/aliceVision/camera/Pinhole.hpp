@@ -70,6 +70,14 @@ class Pinhole : public IntrinsicScaleOffsetDisto
 
     Vec2 project(const Eigen::Matrix4d& pose, const Vec4& pt, bool applyDistortion = true) const override;
 
+    void projectBatch(const geometry::Pose3& pose, const Mat3X& pts3D, Mat2X& pts2D, bool applyDistortion = true) const
+    {
+        projectBatch(pose.getHomogeneous(), pts3D, pts2D, applyDistortion);
+    }
+
+    /// Project all the points at once: one matrix product for the pose, one distortion call for the batch
+    void projectBatch(const Eigen::Matrix4d& pose, const Mat3X& pts3D, Mat2X& pts2D, bool applyDistortion = true) const override;
+
     Eigen::Matrix<double, 2, 9> getDerivativeProjectWrtRotation(const Eigen::Matrix4d& pose, const Vec4& pt);
 
     Eigen::Matrix<double, 2, 16> getDerivativeProjectWrtPose(const Eigen::Matrix4d& pose, const Vec4& pt) const override;
@@ -0,0 +1,130 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "RadialInverseCache.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+namespace aliceVision {
+namespace camera {
+
+bool RadialInverseCache::lookup(const std::vector<double>& params, double r2, double& scale) const
+{
+    const std::shared_ptr<const Table> table = std::atomic_load(&_table);
+    if (!table || r2 > table->maxR2 || !(r2 >= 0.0) || table->params != params)
+        return false;
+
+    const double position = r2 * table->invStep;
+    const std::size_t index = std::min(static_cast<std::size_t>(position), table->scales.size() - 2);
+    const double t = position - static_cast<double>(index);
+
+    scale = table->scales[index] * (1.0 - t) + table->scales[index + 1] * t;
+    return true;
+}
+
+void RadialInverseCache::record(const std::vector<double>& params, double r2, const ExactScale& exactScale) const
+{
+    std::unique_lock<std::mutex> lock(_mutex, std::try_to_lock);
+    if (!lock.owns_lock())
+        return;
+
+    if (params != _recordedParams)
+    {
+        _recordedParams = params;
+        _recordedCount = 0;
+        _recordedMaxR2 = 0.0;
+        _nbBuilds = 0;
+    }
+
+    if (_nbBuilds >= maxBuilds)
+        return;
+
+    // only the solves not covered by the table are recorded:
+    // build at the end of the warmup, then extend the range if too many points fall outside of it
+    _recordedMaxR2 = std::max(_recordedMaxR2, r2);
+    if (++_recordedCount < warmupCount || _recordedMaxR2 <= 0.0)
+        return;
+
+    _recordedCount = 0;
+    ++_nbBuilds;
+
+    // margin on the observed range, so that the next points fall in the table,
+    // unless the model cannot be inverted on this larger range (e.g. fisheye beyond 90 degrees)
+    std::shared_ptr<const Table> table = build(params, 1.25 * _recordedMaxR2, exactScale);
+    if (!table)
+        table = build(params, _recordedMaxR2, exactScale);
+
+    if (!table)
+    {
+        // no valid approximation for these parameters: keep the exact solve
+        _nbBuilds = maxBuilds;
+        return;
+    }
+
+    std::atomic_store(&_table, table);
+}
+
+void RadialInverseCache::reset()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::atomic_store(&_table, std::shared_ptr<const Table>());
+    _recordedParams.clear();
+    _recordedCount = 0;
+    _recordedMaxR2 = 0.0;
+    _nbBuilds = 0;
+}
+
+std::shared_ptr<const RadialInverseCache::Table> RadialInverseCache::build(const std::vector<double>& params,
+                                                                           double maxR2,
+                                                                           const ExactScale& exactScale)
+{
+    const std::size_t minSamples = 1024;
+    const std::size_t maxSamples = 65536;
+
+    for (std::size_t nbIntervals = minSamples; nbIntervals <= maxSamples; nbIntervals *= 4)
+    {
+        std::shared_ptr<Table> table = std::make_shared<Table>();
+        table->params = params;
+        table->maxR2 = maxR2;
+        table->invStep = static_cast<double>(nbIntervals) / maxR2;
+
+        const double step = maxR2 / static_cast<double>(nbIntervals);
+        table->scales.resize(nbIntervals + 1);
+        for (std::size_t i = 1; i <= nbIntervals; ++i)
+        {
+            table->scales[i] = exactScale(static_cast<double>(i) * step);
+            // a finer resolution cannot help on a singularity
+            if (!std::isfinite(table->scales[i]))
+                return nullptr;
+        }
+        // the exact solve returns 1 at the center, not the limit of the scale (e.g. for DistortionRadialK3PT)
+        // the point itself is null there, the value only matters for the interpolation of the first interval
+        table->scales[0] = 2.0 * table->scales[1] - table->scales[2];
+
+        // check the interpolation on the middle of the intervals, the worst case of the linear interpolation
+        // the tolerance is the position error in the camera plane, plus the precision of the iterative solvers near the center
+        bool valid = true;
+        for (std::size_t i = 0; i < nbIntervals && valid; ++i)
+        {
+            const double r2 = (static_cast<double>(i) + 0.5) * step;
+            const double r = std::sqrt(r2);
+            const double error = std::abs(0.5 * (table->scales[i] + table->scales[i + 1]) - exactScale(r2)) * r;
+            const double tolerance = 1e-7 + 1e-8 / r;
+
+            valid = error <= tolerance;
+        }
+
+        if (valid)
+            return table;
+    }
+
+    return nullptr;
+}
+
+}  // namespace camera
+}  // namespace aliceVision
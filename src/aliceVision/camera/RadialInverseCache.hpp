@@ -0,0 +1,119 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace aliceVision {
+namespace camera {
+
+/**
+ * @brief Table of the inverse of a radial distortion, built lazily.
+ *
+ * The radial models remove the distortion with an iterative solve of the undistortion scale s(r^2),
+ * such that removeDistortion(p) = s(|p|^2) * p.
+ * Once a distortion has been inverted a number of times with the same parameters,
+ * the scale is tabulated over the observed radius range and linearly interpolated,
+ * with a resolution refined until the interpolation error is below the solver precision.
+ *
+ * The table is discarded as soon as the parameters change (e.g. during a bundle adjustment),
+ * so it is only built for the repeated undistortions with fixed parameters.
+ * The radius outside of the table range and the parameters without a valid table use the exact solve.
+ */
+class RadialInverseCache
+{
+  public:
+    using ExactScale = std::function<double(double)>;
+
+    /// number of exact solves with the same parameters before building the table
+    static constexpr std::size_t warmupCount = 256;
+
+    /// maximum number of tables built for the same parameters, when the range of the solves grows
+    static constexpr std::size_t maxBuilds = 4;
+
+    RadialInverseCache() = default;
+
+    // the table is not shared between copies of a distortion, its parameters may be changed independently
+    RadialInverseCache(const RadialInverseCache&) {}
+    RadialInverseCache& operator=(const RadialInverseCache&)
+    {
+        reset();
+        return *this;
+    }
+
+    /**
+     * @brief Get the undistortion scale, from the table when available or with the exact solve otherwise.
+     * @param[in] params the current distortion parameters
+     * @param[in] r2 the squared distorted radius
+     * @param[in] exactScale the exact undistortion scale as a function of the squared distorted radius
+     * @return the undistortion scale
+     */
+    template<typename F>
+    double getScale(const std::vector<double>& params, double r2, const F& exactScale) const
+    {
+        double scale;
+        if (lookup(params, r2, scale))
+            return scale;
+
+        scale = exactScale(r2);
+        record(params, r2, exactScale);
+        return scale;
+    }
+
+    /**
+     * @brief Get the undistortion scale from the table.
+     * @param[in] params the current distortion parameters
+     * @param[in] r2 the squared distorted radius
+     * @param[out] scale the undistortion scale
+     * @return false if no valid table covers this radius with these parameters
+     */
+    bool lookup(const std::vector<double>& params, double r2, double& scale) const;
+
+    /**
+     * @brief Record an exact solve, and build the table once enough solves have been done with the same parameters.
+     * @note The solve is not recorded if another thread is recording, to avoid any contention when the parameters change.
+     * @param[in] params the current distortion parameters
+     * @param[in] r2 the squared distorted radius of the exact solve
+     * @param[in] exactScale the exact undistortion scale as a function of the squared distorted radius
+     */
+    void record(const std::vector<double>& params, double r2, const ExactScale& exactScale) const;
+
+    /**
+     * @brief Discard the table and the recorded solves.
+     */
+    void reset();
+
+  private:
+    struct Table
+    {
+        std::vector<double> params;
+        double maxR2 = 0.0;
+        double invStep = 0.0;
+        std::vector<double> scales;
+    };
+
+    /**
+     * @brief Tabulate the scale over [0, maxR2], refining the resolution until the error bound is reached.
+     * @return the table, nullptr if the error bound cannot be reached
+     */
+    static std::shared_ptr<const Table> build(const std::vector<double>& params, double maxR2, const ExactScale& exactScale);
+
+    mutable std::shared_ptr<const Table> _table;
+
+    mutable std::mutex _mutex;
+    mutable std::vector<double> _recordedParams;
+    mutable std::size_t _recordedCount = 0;
+    mutable double _recordedMaxR2 = 0.0;
+    mutable std::size_t _nbBuilds = 0;
+};
+
+}  // namespace camera
+}  // namespace aliceVision
@@ -0,0 +1,90 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "UndistortionMap.hpp"
+
+#include <aliceVision/camera/cameraCommon.hpp>
+#include <aliceVision/camera/Pinhole.hpp>
+#include <aliceVision/system/Logger.hpp>
+#include <aliceVision/system/Timer.hpp>
+
+#include <cmath>
+
+namespace aliceVision {
+namespace camera {
+
+UndistortionMap::UndistortionMap(const IntrinsicBase& intrinsic, int width, int height, bool correctPrincipalPoint)
+  : _width(width),
+    _height(height),
+    _x(static_cast<std::size_t>(width) * height, invalid),
+    _y(static_cast<std::size_t>(width) * height, invalid)
+{
+    const Vec2 center(width * 0.5, height * 0.5);
+    Vec2 ppCorrection(0.0, 0.0);
+
+    if (correctPrincipalPoint && camera::isPinhole(intrinsic.getType()))
+    {
+        const camera::Pinhole& pinhole = dynamic_cast<const camera::Pinhole&>(intrinsic);
+        ppCorrection = pinhole.getPrincipalPoint() - center;
+    }
+
+    const double fractionScale = static_cast<double>(1 << fractionBits);
+
+#pragma omp parallel for
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            const Vec2 distortedPix = intrinsic.getDistortedPixel(Vec2(x, y) + ppCorrection);
+
+            // same domain test as camera::UndistortImage
+            const double dx = distortedPix(0);
+            const double dy = distortedPix(1);
+            if (!(dx > -1.0 && dx < width && dy > -1.0 && dy < height))
+                continue;
+
+            const std::size_t index = static_cast<std::size_t>(y) * width + x;
+            _x[index] = static_cast<std::int32_t>(std::lround(dx * fractionScale));
+            _y[index] = static_cast<std::int32_t>(std::lround(dy * fractionScale));
+        }
+    }
+}
+
+UndistortionMapCache& UndistortionMapCache::get()
+{
+    static UndistortionMapCache cache;
+    return cache;
+}
+
+std::shared_ptr<const UndistortionMap> UndistortionMapCache::getMap(const IntrinsicBase& intrinsic, int width, int height, bool correctPrincipalPoint)
+{
+    std::shared_ptr<Entry> entry;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        std::shared_ptr<Entry>& cached = _entries[Key(intrinsic.hashValue(), width, height, correctPrincipalPoint)];
+        if (!cached)
+            cached = std::make_shared<Entry>();
+        entry = cached;
+    }
+
+    // build outside of the lock, the other maps stay available meanwhile
+    std::call_once(entry->built, [&]() {
+        system::Timer timer;
+        entry->map = std::make_shared<const UndistortionMap>(intrinsic, width, height, correctPrincipalPoint);
+        ALICEVISION_LOG_DEBUG("Undistortion map " << width << "x" << height << " built in " << timer.elapsedMs() << " ms.");
+    });
+
+    return entry->map;
+}
+
+void UndistortionMapCache::clear()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _entries.clear();
+}
+
+}  // namespace camera
+}  // namespace aliceVision
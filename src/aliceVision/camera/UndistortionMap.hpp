@@ -0,0 +1,159 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/camera/IntrinsicBase.hpp>
+#include <aliceVision/image/Image.hpp>
+#include <aliceVision/image/Sampler.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+namespace aliceVision {
+namespace camera {
+
+/**
+ * @brief Lookup map from the undistorted image pixels to their distorted position in the source image.
+ *        The distortion model is evaluated once per pixel when the map is built,
+ *        then each image of the same intrinsic is undistorted with a gather and a bilinear interpolation.
+ *
+ * The positions are stored as fixed-point coordinates with 8 fractional bits,
+ * so the sampling position differs by at most 1/512 pixel from the exact one.
+ */
+class UndistortionMap
+{
+  public:
+    /// number of fractional bits of the fixed-point coordinates
+    static constexpr int fractionBits = 8;
+
+    /**
+     * @brief Build the map of an intrinsic, in parallel.
+     * @param[in] intrinsic the camera intrinsic with distortion
+     * @param[in] width the source image width
+     * @param[in] height the source image height
+     * @param[in] correctPrincipalPoint move the principal point to the image center (pinhole only)
+     */
+    UndistortionMap(const IntrinsicBase& intrinsic, int width, int height, bool correctPrincipalPoint = false);
+
+    int width() const { return _width; }
+    int height() const { return _height; }
+
+    /**
+     * @brief Undistort an image, equivalent to camera::UndistortImage without ROI.
+     * @param[in] imageIn the distorted image, of the map size
+     * @param[out] imageOut the undistorted image
+     * @param[in] fillcolor the color of the pixels outside the source image
+     */
+    template<typename T>
+    void remap(const image::Image<T>& imageIn, image::Image<T>& imageOut, T fillcolor) const;
+
+  private:
+    /// sentinel of the pixels falling outside the source image
+    static constexpr std::int32_t invalid = std::numeric_limits<std::int32_t>::min();
+    static constexpr std::int32_t fractionMask = (1 << fractionBits) - 1;
+
+    int _width = 0;
+    int _height = 0;
+    /// fixed-point distorted coordinates, one entry per pixel in row-major order
+    std::vector<std::int32_t> _x;
+    std::vector<std::int32_t> _y;
+};
+
+/**
+ * @brief Process-wide cache of the undistortion maps, computed once per intrinsic and image size.
+ */
+class UndistortionMapCache
+{
+  public:
+    static UndistortionMapCache& get();
+
+    /**
+     * @brief Get the map of an intrinsic, building it at the first request.
+     * @note Concurrent requests of the same map wait for a single build.
+     * @param[in] intrinsic the camera intrinsic with distortion
+     * @param[in] width the source image width
+     * @param[in] height the source image height
+     * @param[in] correctPrincipalPoint move the principal point to the image center (pinhole only)
+     * @return the undistortion map
+     */
+    std::shared_ptr<const UndistortionMap> getMap(const IntrinsicBase& intrinsic, int width, int height, bool correctPrincipalPoint = false);
+
+    /**
+     * @brief Release all the cached maps.
+     */
+    void clear();
+
+  private:
+    UndistortionMapCache() = default;
+
+    struct Entry
+    {
+        std::once_flag built;
+        std::shared_ptr<const UndistortionMap> map;
+    };
+
+    using Key = std::tuple<std::size_t, int, int, bool>;
+
+    std::mutex _mutex;
+    std::map<Key, std::shared_ptr<Entry>> _entries;
+};
+
+template<typename T>
+void UndistortionMap::remap(const image::Image<T>& imageIn, image::Image<T>& imageOut, T fillcolor) const
+{
+    using RealPixel = image::RealPixel<T>;
+
+    imageOut.resize(_width, _height, true, fillcolor);
+
+    const int inWidth = imageIn.width();
+    const int inHeight = imageIn.height();
+    const double fractionScale = 1.0 / static_cast<double>(1 << fractionBits);
+    const image::Sampler2d<image::SamplerLinear> sampler;
+
+#pragma omp parallel for
+    for (int y = 0; y < _height; ++y)
+    {
+        const std::int32_t* rowX = _x.data() + static_cast<std::size_t>(y) * _width;
+        const std::int32_t* rowY = _y.data() + static_cast<std::size_t>(y) * _width;
+
+        for (int x = 0; x < _width; ++x)
+        {
+            const std::int32_t fx = rowX[x];
+            if (fx == invalid)
+                continue;
+
+            const std::int32_t fy = rowY[x];
+            const int ix = fx >> fractionBits;
+            const int iy = fy >> fractionBits;
+
+            // the neighbors are out of the image on the last row and column: same border handling as the sampler
+            if (ix < 0 || iy < 0 || ix + 1 >= inWidth || iy + 1 >= inHeight)
+            {
+                imageOut(y, x) = sampler(imageIn, static_cast<float>(fy * fractionScale), static_cast<float>(fx * fractionScale));
+                continue;
+            }
+
+            const double wx = (fx & fractionMask) * fractionScale;
+            const double wy = (fy & fractionMask) * fractionScale;
+
+            const T* row0 = &imageIn(iy, ix);
+            const T* row1 = &imageIn(iy + 1, ix);
+
+            const typename RealPixel::real_type top = RealPixel::convert_to_real(row0[0]) * (1.0 - wx) + RealPixel::convert_to_real(row0[1]) * wx;
+            const typename RealPixel::real_type bottom = RealPixel::convert_to_real(row1[0]) * (1.0 - wx) + RealPixel::convert_to_real(row1[1]) * wx;
+            imageOut(y, x) = RealPixel::convert_from_real(top * (1.0 - wy) + bottom * wy);
+        }
+    }
+}
+
+}  // namespace camera
+}  // namespace aliceVision
@@ -51,3 +51,53 @@ BOOST_AUTO_TEST_CASE(distortion_distort_undistort)
         }
     }
 }
+
+//-----------------
+// Test summary:
+//-----------------
+// - Undistort enough points to build the inverse tables of the radial models
+// - Assert that the cached undistortion is still the inverse of the distortion
+// - Change the parameters and assert that the table built for the previous parameters is not used
+//-----------------
+BOOST_AUTO_TEST_CASE(distortion_undistort_cached)
+{
+    makeRandomOperationsReproducible();
+
+    std::array<std::unique_ptr<Distortion>, 4> distortionsModels;
+    distortionsModels[0].reset(new DistortionFisheye(0.02, -0.03, 0.1, -0.2));
+    distortionsModels[1].reset(new DistortionRadialK1(0.02));
+    distortionsModels[2].reset(new DistortionRadialK3(-1.8061369278146561e-01, 1.8759742680633607e-01, -2.5341468279930644e-02));
+    distortionsModels[3].reset(new DistortionRadialK3PT(-1.8061369278146561e-01, 1.8759742680633607e-01, -2.5341468279930644e-02));
+
+    const double epsilon = 1e-6;
+    const double lim{0.8};
+
+    for (const auto& model : distortionsModels)
+    {
+        // warmup with the exact solve
+        for (std::size_t i = 0; i < 2 * RadialInverseCache::warmupCount; ++i)
+        {
+            model->removeDistortion(model->addDistortion(lim * Vec2::Random()));
+        }
+
+        for (std::size_t i = 0; i < 1000; ++i)
+        {
+            const Vec2 distorted = model->addDistortion(lim * Vec2::Random());
+            const Vec2 undistorted = model->removeDistortion(distorted);
+
+            EXPECT_MATRIX_NEAR(distorted, model->addDistortion(undistorted), epsilon);
+        }
+
+        std::vector<double> params = model->getParameters();
+        params[0] += 0.01;
+        model->setParameters(params);
+
+        for (std::size_t i = 0; i < 100; ++i)
+        {
+            const Vec2 distorted = model->addDistortion(lim * Vec2::Random());
+            const Vec2 undistorted = model->removeDistortion(distorted);
+
+            EXPECT_MATRIX_NEAR(distorted, model->addDistortion(undistorted), epsilon);
+        }
+    }
+}
@@ -101,3 +101,42 @@ BOOST_AUTO_TEST_CASE(cameraPinholeRadial_disto_undisto_K3)
         EXPECT_MATRIX_NEAR(ptImage_gt, pt2d_proj, epsilon);
     }
 }
+
+//-----------------
+// Test summary:
+//-----------------
+// - Create a PinholeRadialK1 and a PinholeRadialK3 camera
+// - Generate random 3D points in front of the camera
+// - Assert that the batch projection matches the per-point projection
+//-----------------
+BOOST_AUTO_TEST_CASE(cameraPinholeRadial_projectBatch)
+{
+    makeRandomOperationsReproducible();
+
+    const std::vector<std::shared_ptr<Distortion>> distortions = {std::make_shared<DistortionRadialK1>(0.1),
+                                                                  std::make_shared<DistortionRadialK3>(-0.245539, 0.255195, 0.163773)};
+
+    for (const std::shared_ptr<Distortion>& distortion : distortions)
+    {
+        std::shared_ptr<Pinhole> cam = std::make_shared<Pinhole>(1000, 1000, 1000, 1000, 0, 0, distortion);
+
+        const geometry::Pose3 pose(geometry::randomPose());
+
+        // random points in front of the camera
+        Mat3X pts3D(3, 100);
+        for (Eigen::Index i = 0; i < pts3D.cols(); ++i)
+        {
+            const Vec2 ptImage = (Vec2::Random() * 800. / 2.) + Vec2(500, 500);
+            pts3D.col(i) = cam->backproject(ptImage, true, pose, 1.0 + std::abs(Vec2::Random()(0)) * 100.0);
+        }
+
+        Mat2X pts2D;
+        cam->projectBatch(pose, pts3D, pts2D);
+
+        BOOST_CHECK_EQUAL(pts2D.cols(), pts3D.cols());
+        for (Eigen::Index i = 0; i < pts3D.cols(); ++i)
+        {
+            EXPECT_MATRIX_NEAR(cam->project(pose, pts3D.col(i).homogeneous()), pts2D.col(i), 1e-8);
+        }
+    }
+}
@@ -0,0 +1,125 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/camera/camera.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace aliceVision;
+using namespace aliceVision::camera;
+
+namespace {
+
+const std::size_t nbPoints = 1 << 16;
+
+enum class CameraModel
+{
+    pinhole,
+    pinholeRadialK3,
+    pinholeBrown,
+    pinholeFisheye,
+    equidistantRadialK3
+};
+
+std::shared_ptr<IntrinsicBase> createCamera(CameraModel model)
+{
+    const unsigned int w = 4000;
+    const unsigned int h = 3000;
+    switch (model)
+    {
+        case CameraModel::pinhole:
+            return std::make_shared<Pinhole>(w, h, 3000.0, 3000.0, 12.0, -8.0);
+        case CameraModel::pinholeRadialK3:
+            return std::make_shared<Pinhole>(w, h, 3000.0, 3000.0, 12.0, -8.0, std::make_shared<DistortionRadialK3>(-0.1, 0.05, -0.01));
+        case CameraModel::pinholeBrown:
+            return std::make_shared<Pinhole>(w, h, 3000.0, 3000.0, 12.0, -8.0, std::make_shared<DistortionBrown>(-0.1, 0.05, -0.01, 0.001, -0.001));
+        case CameraModel::pinholeFisheye:
+            return std::make_shared<Pinhole>(w, h, 1500.0, 1500.0, 12.0, -8.0, std::make_shared<DistortionFisheye>(0.1, -0.05, 0.01, -0.001));
+        case CameraModel::equidistantRadialK3:
+            return std::make_shared<Equidistant>(w, h, 1200.0, 12.0, -8.0, std::make_shared<DistortionRadialK3PT>(0.1, -0.05, 0.01));
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Random 3D points in front of the camera, in homogeneous coordinates.
+ */
+std::vector<Vec4> randomPoints()
+{
+    std::mt19937 generator(0);
+    std::uniform_real_distribution<double> distributionXY(-0.5, 0.5);
+    std::uniform_real_distribution<double> distributionZ(1.0, 10.0);
+    std::vector<Vec4> points(nbPoints);
+    for (auto& point : points)
+    {
+        const double z = distributionZ(generator);
+        point = Vec4(distributionXY(generator) * z, distributionXY(generator) * z, z, 1.0);
+    }
+    return points;
+}
+
+/**
+ * @brief Projection of 3D points with distortion (residuals of the bundle adjustment, reprojection errors, ...).
+ */
+void BM_project(benchmark::State& state, CameraModel model)
+{
+    const std::shared_ptr<IntrinsicBase> camera = createCamera(model);
+    const std::vector<Vec4> points = randomPoints();
+    const Eigen::Matrix4d pose = Eigen::Matrix4d::Identity();
+
+    for (auto _ : state)
+    {
+        for (const Vec4& point : points)
+        {
+            benchmark::DoNotOptimize(camera->project(pose, point, true));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * points.size());
+}
+
+/**
+ * @brief Back-projection of image points with undistortion (iterative for most of the distortion models).
+ */
+void BM_backproject(benchmark::State& state, CameraModel model)
+{
+    const std::shared_ptr<IntrinsicBase> camera = createCamera(model);
+    const std::vector<Vec4> points = randomPoints();
+    const Eigen::Matrix4d pose = Eigen::Matrix4d::Identity();
+
+    std::vector<Vec2> imagePoints;
+    imagePoints.reserve(points.size());
+    for (const Vec4& point : points)
+        imagePoints.push_back(camera->project(pose, point, true));
+
+    for (auto _ : state)
+    {
+        for (const Vec2& imagePoint : imagePoints)
+        {
+            benchmark::DoNotOptimize(camera->backproject(imagePoint, true));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * imagePoints.size());
+}
+
+}  // namespace
+
+BENCHMARK_CAPTURE(BM_project, pinhole, CameraModel::pinhole)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_project, pinholeRadialK3, CameraModel::pinholeRadialK3)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_project, pinholeBrown, CameraModel::pinholeBrown)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_project, pinholeFisheye, CameraModel::pinholeFisheye)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_project, equidistantRadialK3, CameraModel::equidistantRadialK3)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_CAPTURE(BM_backproject, pinhole, CameraModel::pinhole)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_backproject, pinholeRadialK3, CameraModel::pinholeRadialK3)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_backproject, pinholeBrown, CameraModel::pinholeBrown)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_backproject, pinholeFisheye, CameraModel::pinholeFisheye)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_backproject, equidistantRadialK3, CameraModel::equidistantRadialK3)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,63 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/camera/camera.hpp>
+#include <aliceVision/camera/UndistortionMap.hpp>
+
+#define BOOST_TEST_MODULE undistortionMap
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/tools/floating_point_comparison.hpp>
+#include <aliceVision/unitTest.hpp>
+
+using namespace aliceVision;
+using namespace aliceVision::camera;
+
+//-----------------
+// Test summary:
+//-----------------
+// - Create a PinholeRadialK3 camera and a random image
+// - Undistort the image with the direct per-pixel evaluation and with the precomputed map
+// - Assert that both images are equal up to the fixed-point precision of the map
+// - Assert that the cache returns the same map for the same intrinsic
+//-----------------
+BOOST_AUTO_TEST_CASE(undistortionMap_remap)
+{
+    makeRandomOperationsReproducible();
+
+    const int width = 320;
+    const int height = 240;
+
+    std::shared_ptr<Distortion> distortion = std::make_shared<DistortionRadialK3>(-0.2, 0.05, -0.01);
+    std::shared_ptr<Pinhole> cam = std::make_shared<Pinhole>(width, height, 300, 300, 0, 0, distortion);
+
+    image::Image<float> imageIn(width, height);
+    imageIn.setRandom();
+
+    image::Image<float> expected;
+    UndistortImage(imageIn, cam.get(), expected, 0.0f);
+
+    const UndistortionMap undistortionMap(*cam, width, height);
+    image::Image<float> result;
+    undistortionMap.remap(imageIn, result, 0.0f);
+
+    BOOST_CHECK_EQUAL(result.width(), expected.width());
+    BOOST_CHECK_EQUAL(result.height(), expected.height());
+
+    // position error below 1/512 pixel, on values in [-1, 1]
+    const float epsilon = 2e-2f;
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            BOOST_CHECK_SMALL(result(y, x) - expected(y, x), epsilon);
+        }
+    }
+
+    const std::shared_ptr<const UndistortionMap> cached = UndistortionMapCache::get().getMap(*cam, width, height);
+    BOOST_CHECK(cached == UndistortionMapCache::get().getMap(*cam, width, height));
+    UndistortionMapCache::get().clear();
+}
@@ -1,6 +1,10 @@
 #include "cmdline.hpp"
 
 #include <aliceVision/system/cpu.hpp>
+#include <aliceVision/system/ProgressReport.hpp>
+#include <aliceVision/system/ResourceReport.hpp>
+#include <aliceVision/system/TaskScheduler.hpp>
+#include <aliceVision/system/Tracer.hpp>
 #include <aliceVision/alicevision_omp.hpp>
 
 namespace aliceVision {
@@ -8,11 +12,23 @@ namespace aliceVision {
 bool CmdLine::execute(int argc, char** argv)
 {
     std::string verboseLevel = system::EVerboseLevel_enumToString(system::Logger::getDefaultVerboseLevel());
+    std::string traceFile;
+    std::string resourceReportFile;
+    std::string progressFile;
 
     boost::program_options::options_description logParams("Log parameters");
     logParams.add_options()("verboseLevel,v",
                             boost::program_options::value<std::string>(&verboseLevel)->default_value(verboseLevel),
-                            "verbosity level (fatal, error, warning, info, debug, trace).");
+                            "verbosity level (fatal, error, warning, info, debug, trace).")(
+      "traceFile",
+      boost::program_options::value<std::string>(&traceFile)->default_value(traceFile),
+      "Chrome trace JSON file (chrome://tracing, Perfetto) of the instrumented zones, written at exit (disabled if empty).")(
+      "resourceReport",
+      boost::program_options::value<std::string>(&resourceReportFile)->default_value(resourceReportFile),
+      "JSON report of the resources used by the run (phase times, peak memory, I/O, thread utilization), written at exit (disabled if empty).")(
+      "progressFile",
+      boost::program_options::value<std::string>(&progressFile)->default_value(progressFile),
+      "JSON heartbeat of the live progress of the run (current task, count, items per second, ETA), rewritten every second (disabled if empty).");
 
     _allParams.add(logParams);
 
@@ -20,10 +36,18 @@ bool CmdLine::execute(int argc, char** argv)
 
     size_t uma = _hContext.getUserMaxMemoryAvailable();
     unsigned int uca = _hContext.getUserMaxCoresAvailable();
+    bool numaAware = _hContext.isNumaAware();
+    system::ETaskBackend taskBackend = system::TaskScheduler::get().getBackend();
 
     hardwareParams.add_options()(
       "maxMemoryAvailable", boost::program_options::value<size_t>(&uma)->default_value(uma), "User specified available RAM")(
-      "maxCoresAvailable", boost::program_options::value<unsigned int>(&uca)->default_value(uca), "User specified available number of cores");
+      "maxCoresAvailable", boost::program_options::value<unsigned int>(&uca)->default_value(uca), "User specified available number of cores")(
+      "numaAware",
+      boost::program_options::value<bool>(&numaAware)->default_value(numaAware),
+      "Bind the threads to the NUMA nodes, to keep them close to the memory they use on multi-socket systems.")(
+      "taskBackend",
+      boost::program_options::value<system::ETaskBackend>(&taskBackend)->default_value(taskBackend),
+      "Backend of the parallel loops ported to the task scheduler: 'scheduler' (work-stealing, nested loops share the threads) or 'openmp'.");
 
     _allParams.add(hardwareParams);
 
@@ -58,10 +82,31 @@ bool CmdLine::execute(int argc, char** argv)
     // set verbose level
     system::Logger::get()->setLogLevel(verboseLevel);
 
+    // enable tracing
+    if (!traceFile.empty())
+        system::Tracer::get().enable(traceFile);
+
+    // enable the resource report
+    if (!resourceReportFile.empty())
+        system::ResourceReport::get().enable(resourceReportFile);
+
+    // enable the progress heartbeat
+    if (!progressFile.empty())
+        system::ProgressReport::get().enable(progressFile);
+
     _hContext.setUserMaxMemoryAvailable(uma);
     _hContext.setUserMaxCoresAvailable(uca);
+    _hContext.setNumaAware(numaAware);
     _hContext.displayHardware();
 
+    // limit the threads to the available cores (including the cgroup CPU quota) to avoid oversubscription
+    omp_set_num_threads(_hContext.getMaxThreads());
+    system::TaskScheduler::get().setNbThreads(_hContext.getMaxThreads());
+    system::TaskScheduler::get().setBackend(taskBackend);
+
+    _hContext.bindThreadsToNumaNodes();
+    system::ResourceReport::get().setNbThreads(_hContext.getMaxThreads());
+
     return true;
 }
 
@@ -64,11 +64,15 @@ class CommonDataByPair_vldSegment : public CommonDataByPair
         // indices of match in the initial matches, if true at the end of KVLD, a match is kept.
         std::vector<bool> valid(_matches.size(), true);
 
+        // scale image pyramids shared by the successive KVLD passes, as the gvld-consistency matrix
+        const ImageScale scaleA(imgA);
+        const ImageScale scaleB(imgB);
+
         size_t it_num = 0;
         KvldParameters kvldparameters;  // initial parameters of KVLD
         // kvldparameters.K = 5;
         while (it_num < 5 &&
-               kvldparameters.inlierRate > KVLD(imgA, imgB, _featsL, _featsR, matchesPair, matchesFiltered, vec_score, E, valid, kvldparameters))
+               kvldparameters.inlierRate > KVLD(scaleA, scaleB, _featsL, _featsR, matchesPair, matchesFiltered, vec_score, E, valid, kvldparameters))
         {
             kvldparameters.inlierRate /= 2;
             ALICEVISION_LOG_DEBUG("low inlier rate, re-select matches with new rate=" << kvldparameters.inlierRate);
@@ -10,6 +10,46 @@
 namespace aliceVision {
 namespace lInfinity {
 
+void computeQuantilePositions(const relativeColorHistogramEdge& edge, std::vector<double>& positionsI, std::vector<double>& positionsJ)
+{
+    //-- compute the two cumulated and normalized histogram
+
+    const std::vector<size_t>& vec_histoI = edge.histoI;
+    const std::vector<size_t>& vec_histoJ = edge.histoJ;
+
+    const size_t nBuckets = vec_histoI.size();
+
+    // Normalize histogram
+    std::vector<double> ndf_I(nBuckets), ndf_J(nBuckets);
+    histogram::normalizeHisto(vec_histoI, ndf_I);
+    histogram::normalizeHisto(vec_histoJ, ndf_J);
+
+    // Compute cumulative distribution functions (cdf)
+    std::vector<double> cdf_I(nBuckets), cdf_J(nBuckets);
+    histogram::cdf(ndf_I, cdf_I);
+    histogram::cdf(ndf_J, cdf_J);
+
+    const double incrementPourcentile = 1. / 10.;
+    double currentPourcentile = 5. / 100.;
+
+    //-- Compute pourcentile and their positions
+    positionsI.clear();
+    positionsJ.clear();
+    positionsI.reserve(1.0 / incrementPourcentile);
+    positionsJ.reserve(1.0 / incrementPourcentile);
+
+    while (currentPourcentile < 1.0)
+    {
+        std::vector<double>::const_iterator iterFI = std::lower_bound(cdf_I.begin(), cdf_I.end(), currentPourcentile);
+        positionsI.push_back(std::distance(cdf_I.cbegin(), iterFI));
+
+        std::vector<double>::const_iterator iterFJ = std::lower_bound(cdf_J.begin(), cdf_J.end(), currentPourcentile);
+        positionsJ.push_back(std::distance(cdf_J.cbegin(), iterFJ));
+
+        currentPourcentile += incrementPourcentile;
+    }
+}
+
 void Encode_histo_relation(const size_t nImage,
                            const std::vector<relativeColorHistogramEdge>& vec_relativeHistograms,
                            const std::vector<size_t>& vec_indexToFix,
@@ -64,7 +104,6 @@ void Encode_histo_relation(const size_t nImage,
     //--
 
     size_t rowPos = 0;
-    double incrementPourcentile = 1. / (double)nbQuantile;
 
     for (size_t i = 0; i < Nrelative; ++i)
     {
@@ -73,45 +112,8 @@ void Encode_histo_relation(const size_t nImage,
 
         const relativeColorHistogramEdge& edge = *iter;
 
-        //-- compute the two cumulated and normalized histogram
-
-        const std::vector<size_t>& vec_histoI = edge.histoI;
-        const std::vector<size_t>& vec_histoJ = edge.histoJ;
-
-        const size_t nBuckets = vec_histoI.size();
-
-        // Normalize histogram
-        std::vector<double> ndf_I(nBuckets), ndf_J(nBuckets);
-        histogram::normalizeHisto(vec_histoI, ndf_I);
-        histogram::normalizeHisto(vec_histoJ, ndf_J);
-
-        // Compute cumulative distribution functions (cdf)
-        std::vector<double> cdf_I(nBuckets), cdf_J(nBuckets);
-        histogram::cdf(ndf_I, cdf_I);
-        histogram::cdf(ndf_J, cdf_J);
-
-        double currentPourcentile = 5. / 100.;
-
-        //-- Compute pourcentile and their positions
         std::vector<double> vec_pourcentilePositionI, vec_pourcentilePositionJ;
-        vec_pourcentilePositionI.reserve(1.0 / incrementPourcentile);
-        vec_pourcentilePositionJ.reserve(1.0 / incrementPourcentile);
-
-        std::vector<double>::const_iterator cdf_I_IterBegin = cdf_I.begin();
-        std::vector<double>::const_iterator cdf_J_IterBegin = cdf_J.begin();
-        while (currentPourcentile < 1.0)
-        {
-            std::vector<double>::const_iterator iterFI = std::lower_bound(cdf_I.begin(), cdf_I.end(), currentPourcentile);
-            const size_t positionI = std::distance(cdf_I_IterBegin, iterFI);
-
-            std::vector<double>::const_iterator iterFJ = std::lower_bound(cdf_J.begin(), cdf_J.end(), currentPourcentile);
-            const size_t positionJ = std::distance(cdf_J_IterBegin, iterFJ);
-
-            vec_pourcentilePositionI.push_back(positionI);
-            vec_pourcentilePositionJ.push_back(positionJ);
-
-            currentPourcentile += incrementPourcentile;
-        }
+        computeQuantilePositions(edge, vec_pourcentilePositionI, vec_pourcentilePositionJ);
 
         //-- Add the constraints:
         // pos * ga + offa - pos * gb - offb <= gamma
@@ -56,6 +56,14 @@ inline void cdf(const std::vector<T>& vec_df, std::vector<T>& vec_cdf)
 
 };  // namespace histogram
 
+/**
+ * @brief Compute the positions of the quantiles 5%, 15%, ..., 95% of the two histograms of an edge.
+ * @param[in] edge the pair of histograms
+ * @param[out] positionsI the quantile positions in the histogram of the image I
+ * @param[out] positionsJ the quantile positions in the histogram of the image J
+ */
+void computeQuantilePositions(const relativeColorHistogramEdge& edge, std::vector<double>& positionsI, std::vector<double>& positionsJ);
+
 // Implementation of the formula (1) of [1] with 10 quantiles.
 //-- L_infinity alignment of pair of histograms over a graph thanks to a linear program.
 void Encode_histo_relation(const std::size_t nImage,
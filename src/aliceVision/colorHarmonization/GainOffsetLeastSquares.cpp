@@ -0,0 +1,143 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "GainOffsetLeastSquares.hpp"
+
+#include <aliceVision/numeric/numeric.hpp>
+#include <aliceVision/system/Logger.hpp>
+
+#include <Eigen/SparseCholesky>
+
+#include <algorithm>
+#include <cmath>
+
+namespace aliceVision {
+namespace colorHarmonization {
+
+bool solveGainOffsetLeastSquares(std::size_t nbImages,
+                                 const std::vector<lInfinity::relativeColorHistogramEdge>& relativeHistograms,
+                                 const std::vector<std::size_t>& indexToFix,
+                                 bool robust,
+                                 std::vector<double>& solution,
+                                 int maxIterations)
+{
+    // column of the gain of each free image, the offset is the next one
+    const Eigen::Index fixed = -1;
+    std::vector<Eigen::Index> columns(nbImages, 0);
+    for (const std::size_t index : indexToFix)
+        columns.at(index) = fixed;
+
+    Eigen::Index nbVariables = 0;
+    for (Eigen::Index& column : columns)
+    {
+        if (column != fixed)
+        {
+            column = nbVariables;
+            nbVariables += 2;
+        }
+    }
+
+    // residuals: A * x + b, the fixed images contribute to the constant term
+    std::vector<Eigen::Triplet<double>> triplets;
+    std::vector<double> constants;
+    triplets.reserve(relativeHistograms.size() * 10 * 4);
+    constants.reserve(relativeHistograms.size() * 10);
+
+    std::vector<double> positionsI, positionsJ;
+    for (const lInfinity::relativeColorHistogramEdge& edge : relativeHistograms)
+    {
+        lInfinity::computeQuantilePositions(edge, positionsI, positionsJ);
+
+        const Eigen::Index columnI = columns.at(edge.I);
+        const Eigen::Index columnJ = columns.at(edge.J);
+
+        for (std::size_t k = 0; k < positionsI.size(); ++k)
+        {
+            const Eigen::Index row = constants.size();
+            double constant = 0.0;
+
+            if (columnI == fixed)
+                constant += positionsI[k];
+            else
+            {
+                triplets.emplace_back(row, columnI, positionsI[k]);
+                triplets.emplace_back(row, columnI + 1, 1.0);
+            }
+
+            if (columnJ == fixed)
+                constant -= positionsJ[k];
+            else
+            {
+                triplets.emplace_back(row, columnJ, -positionsJ[k]);
+                triplets.emplace_back(row, columnJ + 1, -1.0);
+            }
+
+            constants.push_back(constant);
+        }
+    }
+
+    const Eigen::Index nbResiduals = constants.size();
+    sMat A(nbResiduals, nbVariables);
+    A.setFromTriplets(triplets.begin(), triplets.end());
+    const Vec b = Eigen::Map<const Vec>(constants.data(), nbResiduals);
+
+    Vec x = Vec::Zero(nbVariables);
+    Vec residuals = b;
+
+    if (nbVariables > 0)
+    {
+        // weights of the residuals, updated at each IRLS iteration to approximate the L1 norm
+        Vec weights = Vec::Ones(nbResiduals);
+        const sMat At = A.transpose();
+        Eigen::SimplicialLDLT<sMat> solver;
+
+        const int nbIterations = robust ? std::max(1, maxIterations) : 1;
+        for (int iteration = 0; iteration < nbIterations; ++iteration)
+        {
+            const sMat H = At * weights.asDiagonal() * A;
+            // the pattern is the same at each iteration
+            if (iteration == 0)
+                solver.analyzePattern(H);
+            solver.factorize(H);
+            if (solver.info() != Eigen::Success)
+            {
+                ALICEVISION_LOG_WARNING("Gain offset least squares: the system cannot be factorized, some images are not connected to a fixed one.");
+                return false;
+            }
+
+            const Vec previous = x;
+            x = solver.solve(-(At * weights.cwiseProduct(b)));
+            if (solver.info() != Eigen::Success)
+                return false;
+
+            residuals = A * x + b;
+
+            if (!robust || (x - previous).lpNorm<Eigen::Infinity>() < 1e-6)
+                break;
+
+            // the residuals are in histogram bins: below 1e-3 bin, the weight is bounded to keep the system well conditioned
+            weights = residuals.cwiseAbs().cwiseMax(1e-3).cwiseInverse();
+        }
+    }
+
+    solution.assign(2 * nbImages + 1, 0.0);
+    for (std::size_t i = 0; i < nbImages; ++i)
+    {
+        if (columns[i] == fixed)
+            solution[2 * i] = 1.0;
+        else
+        {
+            solution[2 * i] = x(columns[i]);
+            solution[2 * i + 1] = x(columns[i] + 1);
+        }
+    }
+    solution.back() = nbResiduals > 0 ? residuals.lpNorm<Eigen::Infinity>() : 0.0;
+
+    return true;
+}
+
+}  // namespace colorHarmonization
+}  // namespace aliceVision
@@ -0,0 +1,87 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/colorHarmonization/GainOffsetConstraintBuilder.hpp>
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace aliceVision {
+namespace colorHarmonization {
+
+/**
+ * @brief Solver of the gains and offsets of the images.
+ */
+enum class EGainOffsetSolver
+{
+    LINF_LP = 0,  //< minimize the maximal histogram quantile residual with a linear program [1].
+    L2,           //< minimize the sum of squared residuals with a sparse least squares.
+    L1_IRLS       //< minimize the sum of absolute residuals with an iteratively reweighted least squares.
+};
+
+inline std::string EGainOffsetSolver_enumToString(EGainOffsetSolver solver)
+{
+    switch (solver)
+    {
+        case EGainOffsetSolver::LINF_LP:
+            return "linf_lp";
+        case EGainOffsetSolver::L2:
+            return "l2";
+        case EGainOffsetSolver::L1_IRLS:
+            return "l1_irls";
+    }
+    throw std::out_of_range("Invalid gain offset solver enum");
+}
+
+inline EGainOffsetSolver EGainOffsetSolver_stringToEnum(const std::string& solver)
+{
+    if (solver == "linf_lp")
+        return EGainOffsetSolver::LINF_LP;
+    if (solver == "l2")
+        return EGainOffsetSolver::L2;
+    if (solver == "l1_irls")
+        return EGainOffsetSolver::L1_IRLS;
+    throw std::out_of_range("Invalid gain offset solver: " + solver);
+}
+
+inline std::ostream& operator<<(std::ostream& os, EGainOffsetSolver e) { return os << EGainOffsetSolver_enumToString(e); }
+
+inline std::istream& operator>>(std::istream& in, EGainOffsetSolver& solver)
+{
+    std::string token(std::istreambuf_iterator<char>(in), {});
+    solver = EGainOffsetSolver_stringToEnum(token);
+    return in;
+}
+
+/**
+ * @brief Solve the gains and offsets aligning the histogram quantiles of the image pairs in the least squares sense.
+ *
+ * Same residuals as the linear program of lInfinity::Encode_histo_relation:
+ * pos_I * g_I + o_I - pos_J * g_J - o_J for each quantile of each edge,
+ * but the sparse normal equations are solved directly, so the cost grows with the number of edges
+ * instead of the number of variables of the linear program.
+ *
+ * @param[in] nbImages the number of images
+ * @param[in] relativeHistograms the histograms of the image pairs
+ * @param[in] indexToFix the images with a fixed gain of 1 and offset of 0
+ * @param[in] robust minimize the L1 norm of the residuals with an IRLS, instead of the L2 norm
+ * @param[out] solution {g_0, o_0, ..., g_n, o_n, maximal absolute residual}, same layout as the linear program solution
+ * @param[in] maxIterations the maximal number of IRLS iterations
+ * @return false if the system cannot be solved (e.g. an image is not connected to a fixed image)
+ */
+bool solveGainOffsetLeastSquares(std::size_t nbImages,
+                                 const std::vector<lInfinity::relativeColorHistogramEdge>& relativeHistograms,
+                                 const std::vector<std::size_t>& indexToFix,
+                                 bool robust,
+                                 std::vector<double>& solution,
+                                 int maxIterations = 20);
+
+}  // namespace colorHarmonization
+}  // namespace aliceVision
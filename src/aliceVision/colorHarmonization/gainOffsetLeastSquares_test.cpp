@@ -0,0 +1,122 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/colorHarmonization/GainOffsetLeastSquares.hpp>
+#include <aliceVision/utils/Histogram.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#define BOOST_TEST_MODULE GainOffsetLeastSquares
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/tools/floating_point_comparison.hpp>
+
+using namespace aliceVision;
+using namespace aliceVision::colorHarmonization;
+using namespace aliceVision::lInfinity;
+
+//-----------------
+// Test summary:
+//-----------------
+// - Create a reference histogram and a copy shifted by a constant offset
+// - Solve the gains and offsets with the L2 and the L1 IRLS solvers, the first image being fixed
+// - Assert that the offset is recovered with a perfect alignment
+//-----------------
+BOOST_AUTO_TEST_CASE(GainOffsetLeastSquares_simple_offset)
+{
+    std::mt19937 generator(0);
+    std::normal_distribution<double> distribution(127, 10);
+
+    utils::Histogram<double> histo(0, 256, 255);
+    for (std::size_t i = 0; i < 6000; i++)
+        histo.Add(distribution(generator));
+
+    const std::size_t offset = 20;
+    const std::vector<std::size_t> reference = histo.GetHist();
+    std::vector<std::size_t> shifted = reference;
+    std::rotate(shifted.begin(), shifted.begin() + offset, shifted.end());
+
+    const std::vector<relativeColorHistogramEdge> relativeHistograms = {relativeColorHistogramEdge(0, 1, reference, shifted)};
+    const std::vector<std::size_t> indexToFix(1, 0);
+
+    for (const bool robust : {false, true})
+    {
+        std::vector<double> solution;
+        BOOST_CHECK(solveGainOffsetLeastSquares(2, relativeHistograms, indexToFix, robust, solution));
+        BOOST_REQUIRE_EQUAL(solution.size(), 5);
+
+        BOOST_CHECK_SMALL(1. - solution[0], 1e-6);
+        BOOST_CHECK_SMALL(0. - solution[1], 1e-6);
+        BOOST_CHECK_SMALL(1. - solution[2], 1e-2);
+        BOOST_CHECK_SMALL(offset - solution[3], 1e-1);
+        BOOST_CHECK_SMALL(solution[4], 1e-1);
+    }
+}
+
+//-----------------
+// Test summary:
+//-----------------
+// - Create a reference histogram and a histogram with a gain and an offset
+// - Solve the gains and offsets of three images linked by three edges, the first image being fixed
+// - Assert that the inverse gain and offset are recovered up to the quantization error
+//-----------------
+BOOST_AUTO_TEST_CASE(GainOffsetLeastSquares_offset_gain)
+{
+    std::mt19937 generator(0);
+    std::normal_distribution<double> distribution(127, 10);
+
+    utils::Histogram<double> histoRef(0, 256, 255);
+    utils::Histogram<double> histoOffsetGain(0, 256, 255);
+    const double gain = 3.0;
+    const double offset = 160;
+    for (std::size_t i = 0; i < 10000; i++)
+    {
+        const double val = distribution(generator);
+        histoRef.Add(val);
+        histoOffsetGain.Add((val - 127) * gain + offset);
+    }
+    const std::vector<std::size_t> reference = histoRef.GetHist();
+    const std::vector<std::size_t> shifted = histoOffsetGain.GetHist();
+
+    const std::vector<relativeColorHistogramEdge> relativeHistograms = {relativeColorHistogramEdge(0, 1, reference, shifted),
+                                                                        relativeColorHistogramEdge(1, 2, shifted, reference),
+                                                                        relativeColorHistogramEdge(0, 2, reference, reference)};
+    const std::vector<std::size_t> indexToFix(1, 0);
+
+    for (const bool robust : {false, true})
+    {
+        std::vector<double> solution;
+        BOOST_CHECK(solveGainOffsetLeastSquares(3, relativeHistograms, indexToFix, robust, solution));
+        BOOST_REQUIRE_EQUAL(solution.size(), 7);
+
+        BOOST_CHECK_SMALL(1. - solution[0], 1e-6);
+        BOOST_CHECK_SMALL(0. - solution[1], 1e-6);
+        BOOST_CHECK_SMALL((1. / gain) - solution[2], 1e-1);
+        BOOST_CHECK_SMALL((127 - offset / gain) - solution[3], 2.);  // +/- quantization error (2 gray levels)
+        BOOST_CHECK_SMALL(1. - solution[4], 1e-2);
+        BOOST_CHECK_SMALL(0. - solution[5], 2.);
+        BOOST_CHECK(solution[6] < 2.0);
+    }
+}
+
+//-----------------
+// Test summary:
+//-----------------
+// - Solve an image pair without any fixed image
+// - Assert that the solver reports the singular system
+//-----------------
+BOOST_AUTO_TEST_CASE(GainOffsetLeastSquares_not_fixed)
+{
+    std::vector<std::size_t> histo(256, 0);
+    for (std::size_t i = 100; i < 150; ++i)
+        histo[i] = 10;
+
+    const std::vector<relativeColorHistogramEdge> relativeHistograms = {relativeColorHistogramEdge(0, 1, histo, histo)};
+    std::vector<double> solution;
+    BOOST_CHECK(!solveGainOffsetLeastSquares(2, relativeHistograms, {}, false, solution));
+}
@@ -45,7 +45,61 @@ public:
         _countMeshesForFile = 0;
     }
 
+    /**
+     * @brief Read the next scan, with the structured grid of the sensor.
+     * @param[out] sensorPosition the scan sensor position in the world frame
+     * @param[out] vertices the valid points of the scan in the world frame
+     * @param[out] grid the index of the vertex of each row and column of the sensor, maximal value if none
+     * @return false if there is no more scan or the scan cannot be read
+     */
     bool getNext(Eigen::Vector3d & sensorPosition, std::vector<PointInfo> & vertices, Eigen::Matrix<size_t, -1, -1> & grid)
+    {
+        int64_t maxRows = 0;
+        int64_t maxColumns = 0;
+        return readNext(sensorPosition, vertices, &grid, maxRows, maxColumns);
+    }
+
+    /**
+     * @brief Read the next scan, without the structured grid of the sensor.
+     * @note The grid holds one index per row and column of the sensor, several GB for a high resolution scan,
+     *       only its size is returned here.
+     * @param[out] sensorPosition the scan sensor position in the world frame
+     * @param[out] vertices the valid points of the scan in the world frame
+     * @param[out] maxRows the number of rows of the sensor
+     * @param[out] maxColumns the number of columns of the sensor
+     * @return false if there is no more scan or the scan cannot be read
+     */
+    bool getNext(Eigen::Vector3d & sensorPosition, std::vector<PointInfo> & vertices, int64_t & maxRows, int64_t & maxColumns)
+    {
+        return readNext(sensorPosition, vertices, nullptr, maxRows, maxColumns);
+    }
+
+    bool getNext(Eigen::Vector3d & sensorPosition)
+    {
+        e57::Data3D scanHeader;
+        Eigen::Matrix3d R;
+        return nextScan(scanHeader, R, sensorPosition);
+    }
+
+    int getIdMesh()
+    {
+        return _idMesh;
+    }
+
+    void setRequiredIntensity(double requirement)
+    {
+        _requiredIntensity = requirement;
+    }
+
+private:
+    /**
+     * @brief Go to the next scan, opening the next file if needed.
+     * @param[out] scanHeader the scan header
+     * @param[out] R the sensor rotation (worldTsensor)
+     * @param[out] t the sensor position (worldTsensor)
+     * @return false if there is no more scan or the scan header cannot be read
+     */
+    bool nextScan(e57::Data3D & scanHeader, Eigen::Matrix3d & R, Eigen::Vector3d & t)
     {
         // Go to next mesh of current file
         _idMesh++;
@@ -88,7 +142,6 @@ public:
         }
 
         // Get header
-        e57::Data3D scanHeader;
         if (!_reader->ReadData3D(_idMesh, scanHeader))
         {
             ALICEVISION_LOG_ERROR("Error reading mesh #" << _idMesh);
@@ -101,21 +154,37 @@ public:
                                     scanHeader.pose.rotation.y, 
                                     scanHeader.pose.rotation.z);
 
-        Eigen::Matrix3d R = q.normalized().toRotationMatrix();
+        R = q.normalized().toRotationMatrix();
 
-        Eigen::Vector3d t;
         t(0) = scanHeader.pose.translation.x;
         t(1) = scanHeader.pose.translation.y;
         t(2) = scanHeader.pose.translation.z;
 
-        int64_t maxRows = 0;
-        int64_t maxColumns = 0;
+        return true;
+    }
+
+    bool readNext(Eigen::Vector3d & sensorPosition,
+                  std::vector<PointInfo> & vertices,
+                  Eigen::Matrix<size_t, -1, -1> * grid,
+                  int64_t & maxRows,
+                  int64_t & maxColumns)
+    {
+        e57::Data3D scanHeader;
+        Eigen::Matrix3d R;
+        Eigen::Vector3d t;
+        if (!nextScan(scanHeader, R, t))
+        {
+            return false;
+        }
+
+        maxRows = 0;
+        maxColumns = 0;
         int64_t countPoints = 0;
         int64_t countGroups = 0;
         int64_t maxGroupSize = 0;
         bool isColumnIndex;
 
-        if (!_reader->GetData3DSizes(0, maxRows, maxColumns, countPoints, countGroups, maxGroupSize, isColumnIndex))
+        if (!_reader->GetData3DSizes(_idMesh, maxRows, maxColumns, countPoints, countGroups, maxGroupSize, isColumnIndex))
         {
             ALICEVISION_LOG_ERROR("Error reading content of mesh #" << _idMesh);
             return false;
@@ -129,8 +198,11 @@ public:
         vertices.reserve(countPoints);
 
         //Prepare structured grid for sensor
-        grid.resize(maxRows, maxColumns);
-        grid.fill(std::numeric_limits<size_t>::max());
+        if (grid)
+        {
+            grid->resize(maxRows, maxColumns);
+            grid->fill(std::numeric_limits<size_t>::max());
+        }
 
         unsigned readCount = 0;
         while ((readCount = datareader.read()) > 0)
@@ -187,9 +259,12 @@ public:
                 PointInfo pi;
                 pi.coords = (R * pt + t);
                 pi.idMesh = _idMesh;
-                pi.intensity = data3DPoints.intensity[pos],
+                pi.intensity = data3DPoints.intensity[pos];
 
-                grid(data3DPoints.rowIndex[pos], data3DPoints.columnIndex[pos]) = vertices.size();
+                if (grid)
+                {
+                    (*grid)(data3DPoints.rowIndex[pos], data3DPoints.columnIndex[pos]) = vertices.size();
+                }
                 vertices.push_back(pi);
             }
         }
@@ -199,85 +274,6 @@ public:
         return true;
     }
 
-    bool getNext(Eigen::Vector3d & sensorPosition)
-    {
-        // Go to next mesh of current file
-        _idMesh++;
-
-        // Load next file if needed
-        if (_idMesh >= _countMeshesForFile)
-        {
-            _idPath++;
-            _idMesh = 0;
-            if (_idPath >= _paths.size())
-            {
-                return false;
-            }
-
-            // Create reader
-            _reader = std::make_unique<e57::Reader>(_paths[_idPath], e57::ReaderOptions());
-            if (!_reader->IsOpen())
-            {
-                return false;
-            }
-
-            e57::E57Root root;
-            if (!_reader->GetE57Root(root))
-            {
-                return false;
-            }
-
-            // Compute number of meshes in file
-            _countMeshesForFile = _reader->GetData3DCount();
-        }
-
-        if (_idMesh >= _countMeshesForFile)
-        {
-            return false;
-        }
-
-        if (!_reader)
-        {
-            return false;
-        }
-
-        // Get header
-        e57::Data3D scanHeader;
-        if (!_reader->ReadData3D(_idMesh, scanHeader))
-        {
-            ALICEVISION_LOG_ERROR("Error reading mesh #" << _idMesh);
-            return false;
-        }
-
-        // Get sensor pose (worldTsensor)
-        Eigen::Quaternion<double> q(scanHeader.pose.rotation.w, 
-                                    scanHeader.pose.rotation.x, 
-                                    scanHeader.pose.rotation.y, 
-                                    scanHeader.pose.rotation.z);
-
-        Eigen::Matrix3d R = q.normalized().toRotationMatrix();
-
-        Eigen::Vector3d t;
-        t(0) = scanHeader.pose.translation.x;
-        t(1) = scanHeader.pose.translation.y;
-        t(2) = scanHeader.pose.translation.z;
-
-        sensorPosition = t;
-
-        return true;
-    }
-
-    int getIdMesh()
-    {
-        return _idMesh;
-    }
-
-    void setRequiredIntensity(double requirement)
-    {
-        _requiredIntensity = requirement;
-    }
-
-private:
     std::vector<std::string> _paths;
     std::unique_ptr<e57::Reader> _reader;
 
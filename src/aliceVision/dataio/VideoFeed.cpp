@@ -61,8 +61,12 @@ VideoFeed::FeederImpl::FeederImpl(const std::string& videoPath, const std::strin
     _withIntrinsics(false),
     _videoPath(videoPath)
 {
-    // load the video
+    // load the video, with the hardware accelerated decoding if available (OpenCV falls back to the software decoding otherwise)
+#if CV_VERSION_MAJOR > 4 || (CV_VERSION_MAJOR == 4 && (CV_VERSION_MINOR > 5 || (CV_VERSION_MINOR == 5 && CV_VERSION_REVISION >= 2)))
+    _videoCapture.open(videoPath, cv::CAP_ANY, {cv::CAP_PROP_HW_ACCELERATION, cv::VIDEO_ACCELERATION_ANY});
+#else
     _videoCapture.open(videoPath);
+#endif
     if (!_videoCapture.isOpened())
     {
         ALICEVISION_LOG_WARNING("Unable to open the video : " << videoPath);
@@ -8,20 +8,29 @@
 
 #include <aliceVision/system/Logger.hpp>
 #include <aliceVision/system/Timer.hpp>
+#include <aliceVision/system/ProgressDisplay.hpp>
+#include <aliceVision/system/ResourceReport.hpp>
 #include <aliceVision/mvsUtils/fileIO.hpp>
 #include <aliceVision/mvsUtils/mapIO.hpp>
 #include <aliceVision/mvsUtils/MultiViewParams.hpp>
 #include <aliceVision/depthMap/depthMapUtils.hpp>
 #include <aliceVision/depthMap/DepthMapParams.hpp>
+#include <aliceVision/depthMap/DeviceMemoryPlan.hpp>
 #include <aliceVision/depthMap/SgmDepthList.hpp>
 #include <aliceVision/depthMap/Sgm.hpp>
 #include <aliceVision/depthMap/Refine.hpp>
+#include <aliceVision/depthMap/PatchMatch.hpp>
 #include <aliceVision/depthMap/cuda/host/utils.hpp>
 #include <aliceVision/depthMap/cuda/host/patchPattern.hpp>
 #include <aliceVision/depthMap/cuda/host/DeviceCache.hpp>
+#include <aliceVision/depthMap/cuda/host/DeviceMemoryPool.hpp>
 #include <aliceVision/depthMap/cuda/host/DeviceStreamManager.hpp>
+#include <aliceVision/depthMap/cuda/host/DeviceTrace.hpp>
 #include <aliceVision/depthMap/cuda/planeSweeping/deviceDepthSimilarityMap.hpp>
 
+#include <algorithm>
+#include <map>
+
 namespace aliceVision {
 namespace depthMap {
 
@@ -37,7 +46,7 @@ DepthMapEstimator::DepthMapEstimator(const mvsUtils::MultiViewParams& mp,
     _refineParams(refineParams)
 {
     // compute maximum downscale (scaleStep)
-    const int maxDownscale = std::max(_sgmParams.scale * _sgmParams.stepXY, _refineParams.scale * _refineParams.stepXY);
+    const int maxDownscale = getMaxDownscale();
 
     // compute tile ROI list
     getTileRoiList(_tileParams, _mp.getMaxImageWidth(), _mp.getMaxImageHeight(), maxDownscale, _tileRoiList);
@@ -45,17 +54,39 @@ DepthMapEstimator::DepthMapEstimator(const mvsUtils::MultiViewParams& mp,
     // log tiling information and ROI list
     logTileRoiList(_tileParams, _mp.getMaxImageWidth(), _mp.getMaxImageHeight(), maxDownscale, _tileRoiList);
 
-    // log SGM downscale & stepXY
-    ALICEVISION_LOG_INFO("SGM parameters:" << std::endl << "\t- scale: " << _sgmParams.scale << std::endl << "\t- stepXY: " << _sgmParams.stepXY);
+    // log PatchMatch downscale & stepXY
+    if (_depthMapParams.usePatchMatch)
+    {
+        ALICEVISION_LOG_INFO("PatchMatch parameters:" << std::endl
+                                                      << "\t- scale: " << _depthMapParams.patchMatch.scale << std::endl
+                                                      << "\t- stepXY: " << _depthMapParams.patchMatch.stepXY << std::endl
+                                                      << "\t- # iterations: " << _depthMapParams.patchMatch.nbIterations);
+    }
+    else
+    {
+        // log SGM downscale & stepXY
+        ALICEVISION_LOG_INFO("SGM parameters:" << std::endl << "\t- scale: " << _sgmParams.scale << std::endl << "\t- stepXY: " << _sgmParams.stepXY);
+
+        // log Refine downscale & stepXY
+        ALICEVISION_LOG_INFO("Refine parameters:" << std::endl
+                                                  << "\t- scale: " << _refineParams.scale << std::endl
+                                                  << "\t- stepXY: " << _refineParams.stepXY);
+    }
+}
+
+int DepthMapEstimator::getMaxDownscale() const
+{
+    if (_depthMapParams.usePatchMatch)
+        return _depthMapParams.patchMatch.scale * _depthMapParams.patchMatch.stepXY;
 
-    // log Refine downscale & stepXY
-    ALICEVISION_LOG_INFO("Refine parameters:" << std::endl
-                                              << "\t- scale: " << _refineParams.scale << std::endl
-                                              << "\t- stepXY: " << _refineParams.stepXY);
+    return std::max(_sgmParams.scale * _sgmParams.stepXY, _refineParams.scale * _refineParams.stepXY);
 }
 
 int DepthMapEstimator::getNbSimultaneousTiles() const
 {
+    const bool usePatchMatch = _depthMapParams.usePatchMatch;
+    const bool useRefine = _depthMapParams.useRefine && !usePatchMatch;
+
     const int nbTilesPerCamera = _tileRoiList.size();
 
     // mipmap image cost
@@ -70,16 +101,20 @@ int DepthMapEstimator::getNbSimultaneousTiles() const
 
     // number of camera parameters in device constant memory
     // (Rc + Tcs) * 2 (SGM + Refine downscale) + 1 (SGM needs downscale 1)
+    // or (Rc + Tcs) for PatchMatch
+    // (Rc + Tcs) more for the SGM low resolution coarse pass downscale
     // note: special case SGM downsccale = Refine downscale not handle
-    const int rcNbCameraParams = (_depthMapParams.useRefine) ? 2 : 1;
-    const int rcCamParams = (1 /* rc */ + _depthMapParams.maxTCams) * rcNbCameraParams + ((_refineParams.scale > 1) ? 1 : 0);
+    const bool useLowResolutionCoarsePass = !usePatchMatch && _sgmParams.coarseToFineFactor > 1 && _sgmParams.coarseToFineLowResolution;
+    const int rcNbCameraParams = ((useRefine) ? 2 : 1) + (useLowResolutionCoarsePass ? 1 : 0);
+    const int rcCamParams = (1 /* rc */ + _depthMapParams.maxTCams) * rcNbCameraParams + ((!usePatchMatch && _refineParams.scale > 1) ? 1 : 0);
 
     // single tile SGM cost
     double sgmTileCostMB = 0.0;
     double sgmTileCostUnpaddedMB = 0.0;
 
+    if (!usePatchMatch)
     {
-        const bool sgmComputeDepthSimMap = !_depthMapParams.useRefine;
+        const bool sgmComputeDepthSimMap = !useRefine;
         const bool sgmComputeNormalMap = _refineParams.useSgmNormalMap;
 
         Sgm sgm(_mp, _tileParams, _sgmParams, sgmComputeDepthSimMap, sgmComputeNormalMap, 0 /*stream*/);
@@ -91,17 +126,28 @@ int DepthMapEstimator::getNbSimultaneousTiles() const
     double refineTileCostMB = 0.0;
     double refineTileCostUnpaddedMB = 0.0;
 
-    if (_depthMapParams.useRefine)
+    if (useRefine)
     {
         Refine refine(_mp, _tileParams, _refineParams, 0 /*stream*/);
         refineTileCostMB = refine.getDeviceMemoryConsumption();
         refineTileCostUnpaddedMB = refine.getDeviceMemoryConsumptionUnpadded();
     }
 
+    // single tile PatchMatch cost
+    double patchMatchTileCostMB = 0.0;
+    double patchMatchTileCostUnpaddedMB = 0.0;
+
+    if (usePatchMatch)
+    {
+        PatchMatch patchMatch(_mp, _tileParams, _depthMapParams.patchMatch, 0 /*stream*/);
+        patchMatchTileCostMB = patchMatch.getDeviceMemoryConsumption();
+        patchMatchTileCostUnpaddedMB = patchMatch.getDeviceMemoryConsumptionUnpadded();
+    }
+
     // tile computation cost
-    // SGM tile cost + Refine tile cost
-    const double tileCostMB = sgmTileCostMB + refineTileCostMB;
-    const double tileCostUnpaddedMB = sgmTileCostUnpaddedMB + refineTileCostUnpaddedMB;
+    // SGM tile cost + Refine tile cost or PatchMatch tile cost
+    const double tileCostMB = sgmTileCostMB + refineTileCostMB + patchMatchTileCostMB;
+    const double tileCostUnpaddedMB = sgmTileCostUnpaddedMB + refineTileCostUnpaddedMB + patchMatchTileCostUnpaddedMB;
 
     // min/max cost of an R camera computation
     // min cost for a single tile computation
@@ -111,10 +157,10 @@ int DepthMapEstimator::getNbSimultaneousTiles() const
 
     // available device memory
     double deviceMemoryMB;
+    double deviceAvailableMB, deviceUsedMB, deviceTotalMB;
     {
-        double availableMB, usedMB, totalMB;
-        getDeviceMemoryInfo(availableMB, usedMB, totalMB);
-        deviceMemoryMB = availableMB * 0.8;  // available memory margin
+        getDeviceMemoryInfo(deviceAvailableMB, deviceUsedMB, deviceTotalMB);
+        deviceMemoryMB = deviceAvailableMB * 0.8;  // available memory margin
     }
 
     // number of full R camera computation that can be done simultaneously
@@ -128,8 +174,10 @@ int DepthMapEstimator::getNbSimultaneousTiles() const
     }
 
     // check that we do not need more constant camera parameters than the ones in device constant memory
+    bool limitedByConstantMemory = false;
     if (ALICEVISION_DEVICE_MAX_CONSTANT_CAMERA_PARAM_SETS < ((nbSimultaneousFullRc + ((nbRemainingTiles > 0) ? 1 : 0)) * rcCamParams))
     {
+        limitedByConstantMemory = true;
         const int previousNbSimultaneousFullRc = nbSimultaneousFullRc;
         nbSimultaneousFullRc = static_cast<int>(ALICEVISION_DEVICE_MAX_CONSTANT_CAMERA_PARAM_SETS / rcCamParams);
 
@@ -147,13 +195,17 @@ int DepthMapEstimator::getNbSimultaneousTiles() const
                                           << "\t- requirement for the first tile: " << rcMinCostMB << " MB" << std::endl
                                           << "\t- # computation buffers per tile: " << tileCostMB << " MB"
                                           << " (Sgm: " << sgmTileCostMB << " MB"
-                                          << ", Refine: " << refineTileCostMB << " MB)" << std::endl
+                                          << ", Refine: " << refineTileCostMB << " MB"
+                                          << ", PatchMatch: " << patchMatchTileCostMB << " MB)" << std::endl
                                           << "\t- # input images (R + " << _depthMapParams.maxTCams << " Ts): " << rcCamsCostMB
-                                          << " MB (single mipmap image size: " << mipmapCostMB << " MB)");
+                                          << " MB (single mipmap image size: " << mipmapCostMB << " MB)" << std::endl
+                                          << "\t- similarity volume element size: " << sizeof(TSim) << " byte(s) (Sgm), " << sizeof(TSimRefine)
+                                          << " byte(s) (Refine)");
 
     ALICEVISION_LOG_DEBUG("Theoretical device memory cost for a tile without padding: " << tileCostUnpaddedMB << " MB"
                                                                                         << " (Sgm: " << sgmTileCostUnpaddedMB << " MB"
-                                                                                        << ", Refine: " << refineTileCostUnpaddedMB << " MB)");
+                                                                                        << ", Refine: " << refineTileCostUnpaddedMB << " MB"
+                                                                                        << ", PatchMatch: " << patchMatchTileCostUnpaddedMB << " MB)");
 
     ALICEVISION_LOG_INFO("Parallelization:" << std::endl
                                             << "\t- # tiles per image: " << nbTilesPerCamera << std::endl
@@ -161,15 +213,162 @@ int DepthMapEstimator::getNbSimultaneousTiles() const
                                             << ((nbRemainingTiles < 1) ? nbSimultaneousFullRc : (nbSimultaneousFullRc + 1)) << std::endl
                                             << "\t- # simultaneous tiles computation: " << out_nbSimultaneousTiles);
 
+    // build device memory plan
+    DeviceMemoryPlan plan;
+    plan.cudaDeviceId = getCudaDeviceId();
+    plan.deviceTotalMB = deviceTotalMB;
+    plan.deviceAvailableMB = deviceAvailableMB;
+    plan.deviceBudgetMB = deviceMemoryMB;
+    plan.mipmapCostMB = mipmapCostMB;
+    plan.rcCamsCostMB = rcCamsCostMB;
+    plan.sgmTileCostMB = sgmTileCostMB;
+    plan.refineTileCostMB = refineTileCostMB;
+    plan.patchMatchTileCostMB = patchMatchTileCostMB;
+    plan.tileBufferWidth = _tileParams.bufferWidth;
+    plan.tileBufferHeight = _tileParams.bufferHeight;
+    plan.nbTilesPerCamera = nbTilesPerCamera;
+    plan.nbSimultaneousFullRc = nbSimultaneousFullRc;
+    plan.nbRemainingTiles = nbRemainingTiles;
+    plan.nbSimultaneousTiles = out_nbSimultaneousTiles;
+    plan.limitedByConstantMemory = limitedByConstantMemory;
+    plan.maxTileBufferSide = computeMaxTileBufferSide(plan, getMaxDownscale());
+
+    logDeviceMemoryPlan(plan);
+
+    // export device memory plan for farm schedulers
+    if (_depthMapParams.exportMemoryPlan)
+    {
+        const std::string planPath = _mp.getDepthMapsFolder() + "deviceMemoryPlan_" + std::to_string(plan.cudaDeviceId) + ".json";
+        exportDeviceMemoryPlan(plan, planPath);
+        ALICEVISION_LOG_INFO("Device memory plan exported: " << planPath);
+    }
+
     // check at least one single tile computation
     if (rcCamParams > ALICEVISION_DEVICE_MAX_CONSTANT_CAMERA_PARAM_SETS || out_nbSimultaneousTiles < 1)
     {
-        ALICEVISION_THROW_ERROR("Not enough GPU memory to compute a single tile.");
+        ALICEVISION_THROW_ERROR("Not enough GPU memory to compute a single tile (tile buffer: "
+                                << _tileParams.bufferWidth << "x" << _tileParams.bufferHeight
+                                << ", largest tile buffer side that fits: " << plan.maxTileBufferSide << ").");
     }
 
     return out_nbSimultaneousTiles;
 }
 
+void DepthMapEstimator::orderCamsByViewGraph(std::vector<int>& cams) const
+{
+    const int nbCams = static_cast<int>(cams.size());
+
+    if (nbCams < 3)
+        return;
+
+    // sorted set of cameras used by each R camera: itself and its T cameras
+    std::vector<std::vector<int>> camSets(nbCams);
+
+    // cameras list index of the R cameras using each camera
+    std::map<int, std::vector<int>> usedBy;
+
+    for (int i = 0; i < nbCams; ++i)
+    {
+        std::vector<int>& camSet = camSets.at(i);
+        camSet = _mp.findNearestCamsFromLandmarks(cams.at(i), _depthMapParams.maxTCams).getDataWritable();
+        camSet.push_back(cams.at(i));
+        std::sort(camSet.begin(), camSet.end());
+
+        for (const int c : camSet)
+            usedBy[c].push_back(i);
+    }
+
+    const auto countSharedCams = [&](int a, int b) {
+        const std::vector<int>& setA = camSets.at(a);
+        const std::vector<int>& setB = camSets.at(b);
+        int nbShared = 0;
+        auto itA = setA.begin();
+        auto itB = setB.begin();
+        while (itA != setA.end() && itB != setB.end())
+        {
+            if (*itA < *itB)
+                ++itA;
+            else if (*itB < *itA)
+                ++itB;
+            else
+            {
+                ++nbShared;
+                ++itA;
+                ++itB;
+            }
+        }
+        return nbShared;
+    };
+
+    // greedy traversal of the view graph:
+    // the next R camera is the unvisited one sharing the most cameras with the current one,
+    // or the first unvisited one of the input list if none (disconnected components)
+    std::vector<bool> visited(nbCams, false);
+    std::vector<int> scores(nbCams, 0);
+    std::vector<int> candidates;
+    std::vector<int> order;
+    order.reserve(nbCams);
+
+    int current = 0;
+    int firstUnvisited = 0;
+
+    while (current >= 0)
+    {
+        visited.at(current) = true;
+        order.push_back(current);
+
+        // score the unvisited R cameras sharing cameras with the current one
+        candidates.clear();
+        for (const int c : camSets.at(current))
+        {
+            for (const int j : usedBy.at(c))
+            {
+                if (!visited.at(j) && (scores.at(j)++ == 0))
+                    candidates.push_back(j);
+            }
+        }
+
+        int next = -1;
+        for (const int j : candidates)
+        {
+            if (next < 0 || scores.at(j) > scores.at(next) || (scores.at(j) == scores.at(next) && j < next))
+                next = j;
+        }
+
+        for (const int j : candidates)
+            scores.at(j) = 0;
+
+        if (next < 0)
+        {
+            while (firstUnvisited < nbCams && visited.at(firstUnvisited))
+                ++firstUnvisited;
+
+            next = (firstUnvisited < nbCams) ? firstUnvisited : -1;
+        }
+
+        current = next;
+    }
+
+    // log the mean number of cameras shared by consecutive R cameras
+    std::size_t nbSharedBefore = 0;
+    std::size_t nbSharedAfter = 0;
+
+    for (int i = 1; i < nbCams; ++i)
+    {
+        nbSharedBefore += countSharedCams(i - 1, i);
+        nbSharedAfter += countSharedCams(order.at(i - 1), order.at(i));
+    }
+
+    ALICEVISION_LOG_INFO("Order R cameras along the view graph: mean number of cameras shared by consecutive R cameras from "
+                         << (double(nbSharedBefore) / (nbCams - 1)) << " to " << (double(nbSharedAfter) / (nbCams - 1)) << ".");
+
+    std::vector<int> orderedCams(nbCams);
+    for (int i = 0; i < nbCams; ++i)
+        orderedCams.at(i) = cams.at(order.at(i));
+
+    cams.swap(orderedCams);
+}
+
 void DepthMapEstimator::getTilesList(const std::vector<int>& cams, std::vector<Tile>& tiles) const
 {
     const int nbTilesPerCamera = _tileRoiList.size();
@@ -201,6 +400,11 @@ void DepthMapEstimator::getTilesList(const std::vector<int>& cams, std::vector<T
             {
                 // do nothing, this ROI cannot intersect the R camera ROI.
             }
+            else if (_depthMapParams.chooseTCamsPerTile && _depthMapParams.usePatchMatch)
+            {
+                // find nearest T cameras per tile, PatchMatch uses the SGM T cameras list
+                t.sgmTCams = _mp.findTileNearestCams(rc, _depthMapParams.patchMatch.maxTCamsPerTile, tCams, t.roi);
+            }
             else if (_depthMapParams.chooseTCamsPerTile)
             {
                 // find nearest T cameras per tile
@@ -221,8 +425,37 @@ void DepthMapEstimator::getTilesList(const std::vector<int>& cams, std::vector<T
     }
 }
 
+void DepthMapEstimator::getTilesCams(const std::vector<Tile>& tiles, int firstTileIndex, int lastTileIndex, int maxCams, std::vector<int>& cams) const
+{
+    // cameras list should be empty
+    assert(cams.empty());
+
+    const auto addCam = [&](int camId) {
+        if (static_cast<int>(cams.size()) < maxCams && std::find(cams.begin(), cams.end(), camId) == cams.end())
+            cams.push_back(camId);
+    };
+
+    for (int i = firstTileIndex; i < lastTileIndex; ++i)
+    {
+        const Tile& tile = tiles.at(i);
+
+        addCam(tile.rc);
+
+        for (const int tc : tile.sgmTCams)
+            addCam(tc);
+
+        if (_depthMapParams.useRefine && !_depthMapParams.usePatchMatch)
+        {
+            for (const int tc : tile.refineTCams)
+                addCam(tc);
+        }
+    }
+}
+
 void DepthMapEstimator::compute(int cudaDeviceId, const std::vector<int>& cams)
 {
+    ALICEVISION_RESOURCE_PHASE("DepthMapEstimator::compute");
+
     // set the device to use for GPU executions
     // the CUDA runtime API is thread-safe, it maintains per-thread state about the current device
     setCudaDeviceId(cudaDeviceId);
@@ -241,13 +474,17 @@ void DepthMapEstimator::compute(int cudaDeviceId, const std::vector<int>& cams)
     DeviceStreamManager deviceStreamManager(nbStreams);
 
     // constants
+    const bool usePatchMatch = _depthMapParams.usePatchMatch;                   // PatchMatch replaces SGM + Refine
+    const bool useRefine = _depthMapParams.useRefine && !usePatchMatch;
     const bool hasRcSameDownscale = (_sgmParams.scale == _refineParams.scale);  // we only need one camera params per image
     const bool hasRcWithoutDownscale =
-      _sgmParams.scale == 1 || (_depthMapParams.useRefine && _refineParams.scale == 1);  // we need R camera params SGM (downscale = 1)
-    const int nbCameraParamsPerSgm =
-      (1 + _depthMapParams.maxTCams) + (hasRcWithoutDownscale ? 0 : 1);  // number of Sgm camera parameters per R camera
+      usePatchMatch || _sgmParams.scale == 1 || (useRefine && _refineParams.scale == 1);  // we need R camera params SGM (downscale = 1)
+    const bool useLowResolutionCoarsePass =
+      !usePatchMatch && _sgmParams.coarseToFineFactor > 1 && _sgmParams.coarseToFineLowResolution;  // we need Sgm camera params at the coarse downscale
+    const int nbCameraParamsPerSgm = (1 + _depthMapParams.maxTCams) * (useLowResolutionCoarsePass ? 2 : 1) +
+                                     (hasRcWithoutDownscale ? 0 : 1);  // number of Sgm (or PatchMatch) camera parameters per R camera
     const int nbCameraParamsPerRefine =
-      (_depthMapParams.useRefine && !hasRcSameDownscale) ? (1 + _depthMapParams.maxTCams) : 0;  // number of Refine camera parameters per R camera
+      (useRefine && !hasRcSameDownscale) ? (1 + _depthMapParams.maxTCams) : 0;  // number of Refine camera parameters per R camera
 
     // build device cache
     const int nbTilesPerCamera = static_cast<int>(_tileRoiList.size());
@@ -270,19 +507,22 @@ void DepthMapEstimator::compute(int cudaDeviceId, const std::vector<int>& cams)
     deviceCache.build(nbMipmapImagesPerBatch, nbCamerasParamsPerBatch);
 
     // build custom patch pattern in CUDA constant memory
-    if (_sgmParams.useCustomPatchPattern || _refineParams.useCustomPatchPattern)
+    if ((usePatchMatch) ? _depthMapParams.patchMatch.useCustomPatchPattern : (_sgmParams.useCustomPatchPattern || _refineParams.useCustomPatchPattern))
         buildCustomPatchPattern(_depthMapParams.customPatchPattern);
 
-    // allocate Sgm and Refine per stream in device memory
+    // allocate Sgm and Refine (or PatchMatch) per stream in device memory
     std::vector<Sgm> sgmPerStream;
     std::vector<Refine> refinePerStream;
+    std::vector<PatchMatch> patchMatchPerStream;
 
-    sgmPerStream.reserve(nbStreams);
-    refinePerStream.reserve(_depthMapParams.useRefine ? nbStreams : 0);
+    sgmPerStream.reserve(usePatchMatch ? 0 : nbStreams);
+    refinePerStream.reserve(useRefine ? nbStreams : 0);
+    patchMatchPerStream.reserve(usePatchMatch ? nbStreams : 0);
 
     // initialize Sgm and Refine objects
+    if (!usePatchMatch)
     {
-        const bool sgmComputeDepthSimMap = !_depthMapParams.useRefine;
+        const bool sgmComputeDepthSimMap = !useRefine;
         const bool sgmComputeNormalMap = _refineParams.useSgmNormalMap;
 
         // initialize Sgm objects
@@ -290,10 +530,16 @@ void DepthMapEstimator::compute(int cudaDeviceId, const std::vector<int>& cams)
             sgmPerStream.emplace_back(_mp, _tileParams, _sgmParams, sgmComputeDepthSimMap, sgmComputeNormalMap, deviceStreamManager.getStream(i));
 
         // initialize Refine objects
-        if (_depthMapParams.useRefine)
+        if (useRefine)
             for (int i = 0; i < nbStreams; ++i)
                 refinePerStream.emplace_back(_mp, _tileParams, _refineParams, deviceStreamManager.getStream(i));
     }
+    else
+    {
+        // initialize PatchMatch objects
+        for (int i = 0; i < nbStreams; ++i)
+            patchMatchPerStream.emplace_back(_mp, _tileParams, _depthMapParams.patchMatch, deviceStreamManager.getStream(i));
+    }
 
     // allocate final deth/similarity map tile list in host memory
     std::vector<std::vector<CudaHostMemoryHeap<float2, 2>>> depthSimMapTilePerCam(nbRcPerBatch);
@@ -309,7 +555,9 @@ void DepthMapEstimator::compute(int cudaDeviceId, const std::vector<int>& cams)
 
         for (int j = 0; j < nbTilesPerCamera; ++j)
         {
-            if (_depthMapParams.useRefine)
+            if (usePatchMatch)
+                depthSimMapTiles.at(j).allocate(patchMatchPerStream.front().getDeviceDepthSimMap().getSize());
+            else if (useRefine)
                 depthSimMapTiles.at(j).allocate(refinePerStream.front().getDeviceDepthSimMap().getSize());
             else  // final depth/similarity map is SGM only
                 depthSimMapTiles.at(j).allocate(sgmPerStream.front().getDeviceDepthSimMap().getSize());
@@ -321,12 +569,17 @@ void DepthMapEstimator::compute(int cudaDeviceId, const std::vector<int>& cams)
 
     // compute number of batches
     const int nbBatches = divideRoundUp(static_cast<int>(tiles.size()), nbTilesPerBatch);
-    const int minMipmapDownscale = std::min(_refineParams.scale, _sgmParams.scale);
-    const int maxMipmapDownscale = std::max(_refineParams.scale, _sgmParams.scale) * std::pow(2, 6);  // we add 6 downscale levels
+    const int minMipmapDownscale = (usePatchMatch) ? _depthMapParams.patchMatch.scale : std::min(_refineParams.scale, _sgmParams.scale);
+    const int maxMipmapDownscale = ((usePatchMatch) ? _depthMapParams.patchMatch.scale : std::max(_refineParams.scale, _sgmParams.scale)) *
+                                   std::pow(2, 6);  // we add 6 downscale levels
+
+    auto progressDisplay = system::createConsoleProgressDisplay(tiles.size(), std::cout, "Depth map estimation\n");
 
     // compute each batch of R cameras
     for (int b = 0; b < nbBatches; ++b)
     {
+        ALICEVISION_TRACE_ZONE_CAT("DepthMapEstimator::computeBatch", "depthMap");
+
         // find first/last tile to compute
         const int firstTileIndex = b * nbTilesPerBatch;
         const int lastTileIndex = std::min((b + 1) * nbTilesPerBatch, static_cast<int>(tiles.size()));
@@ -336,6 +589,21 @@ void DepthMapEstimator::compute(int cudaDeviceId, const std::vector<int>& cams)
         {
             const Tile& tile = tiles.at(i);
 
+            if (usePatchMatch)
+            {
+                // add PatchMatch R and T cameras to Device cache
+                deviceCache.addMipmapImage(tile.rc, minMipmapDownscale, maxMipmapDownscale, ic, _mp);
+                deviceCache.addCameraParams(tile.rc, _depthMapParams.patchMatch.scale, _mp);
+
+                for (const int tc : tile.sgmTCams)
+                {
+                    deviceCache.addMipmapImage(tc, minMipmapDownscale, maxMipmapDownscale, ic, _mp);
+                    deviceCache.addCameraParams(tc, _depthMapParams.patchMatch.scale, _mp);
+                }
+
+                continue;
+            }
+
             // add Sgm R camera to Device cache
             deviceCache.addMipmapImage(tile.rc, minMipmapDownscale, maxMipmapDownscale, ic, _mp);
             deviceCache.addCameraParams(tile.rc, _sgmParams.scale, _mp);
@@ -347,7 +615,18 @@ void DepthMapEstimator::compute(int cudaDeviceId, const std::vector<int>& cams)
                 deviceCache.addCameraParams(tc, _sgmParams.scale, _mp);
             }
 
-            if (_depthMapParams.useRefine)
+            if (useLowResolutionCoarsePass)
+            {
+                // add Sgm R and T cameras at the coarse pass downscale to Device cache
+                const int coarseScale = _sgmParams.scale * _sgmParams.coarseToFineFactor;
+
+                deviceCache.addCameraParams(tile.rc, coarseScale, _mp);
+
+                for (const int tc : tile.sgmTCams)
+                    deviceCache.addCameraParams(tc, coarseScale, _mp);
+            }
+
+            if (useRefine)
             {
                 // add Refine R camera to Device cache
                 deviceCache.addCameraParams(tile.rc, _refineParams.scale, _mp);
@@ -371,11 +650,26 @@ void DepthMapEstimator::compute(int cudaDeviceId, const std::vector<int>& cams)
         // wait for camera loading in device cache
         cudaDeviceSynchronize();
 
+        // prefetch next batch R and T camera images in the host image cache
+        // image decoding is done by a CPU thread while the current batch tiles are computed on device
+        if (_depthMapParams.prefetchImages && (b + 1 < nbBatches))
+        {
+            const int nextFirstTileIndex = lastTileIndex;
+            const int nextLastTileIndex = std::min((b + 2) * nbTilesPerBatch, static_cast<int>(tiles.size()));
+
+            std::vector<int> prefetchCams;
+            getTilesCams(tiles, nextFirstTileIndex, nextLastTileIndex, ic.getCacheSize(), prefetchCams);
+
+            ALICEVISION_LOG_DEBUG("Prefetch " << prefetchCams.size() << " image(s) for the next batch of tiles (" << (b + 2) << "/" << nbBatches << ").");
+
+            ic.refreshImages_async(prefetchCams);
+        }
+
         // compute each batch tile
         for (int i = firstTileIndex; i < lastTileIndex; ++i)
         {
             Tile& tile = tiles.at(i);
-            const int batchCamIndex = tile.rc % nbRcPerBatch;
+            const int batchCamIndex = (i / nbTilesPerCamera) % nbRcPerBatch;  // tiles are ordered by R camera
             const int streamIndex = tile.id % nbStreams;
 
             // do not compute empty ROI
@@ -387,7 +681,7 @@ void DepthMapEstimator::compute(int cudaDeviceId, const std::vector<int>& cams)
             CudaHostMemoryHeap<float2, 2>& tileDepthSimMap_hmh = depthSimMapTilePerCam.at(batchCamIndex).at(tile.id);
 
             // check T cameras
-            if (tile.sgmTCams.empty() || (_depthMapParams.useRefine && tile.refineTCams.empty()))  // no T camera found
+            if (tile.sgmTCams.empty() || (useRefine && tile.refineTCams.empty()))  // no T camera found
             {
                 resetDepthSimMap(tileDepthSimMap_hmh);
                 continue;
@@ -410,6 +704,33 @@ void DepthMapEstimator::compute(int cudaDeviceId, const std::vector<int>& cams)
             // remove T cameras with no depth found.
             sgmDepthList.removeTcWithNoDepth(tile);
 
+            // compute PatchMatch
+            // note: the SGM depth list only gives the tile depth range
+            if (usePatchMatch)
+            {
+                // store min/max depth
+                depthMinMaxTilePerCam.at(batchCamIndex).at(tile.id) = sgmDepthList.getMinMaxDepths();
+
+                PatchMatch& patchMatch = patchMatchPerStream.at(streamIndex);
+                patchMatch.patchMatchRc(tile, sgmDepthList);
+
+                // copy PatchMatch depth/similarity map from device to host
+                tileDepthSimMap_hmh.copyFrom(patchMatch.getDeviceDepthSimMap(), deviceStreamManager.getStream(streamIndex));
+                continue;
+            }
+
+            // get the stream Semi-Global Matching
+            Sgm& sgm = sgmPerStream.at(streamIndex);
+
+            // reduce the depth list around the best depths of a coarse plane sweep pass (if enabled)
+            if (_sgmParams.coarseToFineFactor > 1)
+            {
+                sgm.selectCoarseToFineDepths(tile, sgmDepthList);
+
+                // remove T cameras with no depth left
+                sgmDepthList.removeTcWithNoDepth(tile);
+            }
+
             // store min/max depth
             depthMinMaxTilePerCam.at(batchCamIndex).at(tile.id) = sgmDepthList.getMinMaxDepths();
 
@@ -420,10 +741,9 @@ void DepthMapEstimator::compute(int cudaDeviceId, const std::vector<int>& cams)
             sgmDepthList.checkStartingAndStoppingDepth();
 
             // compute Semi-Global Matching
-            Sgm& sgm = sgmPerStream.at(streamIndex);
             sgm.sgmRc(tile, sgmDepthList);
 
-            if (_depthMapParams.useRefine)
+            if (useRefine)
             {
                 // smooth SGM thickness map
                 // in order to be a proper Refine input parameter
@@ -446,20 +766,39 @@ void DepthMapEstimator::compute(int cudaDeviceId, const std::vector<int>& cams)
         // wait for tiles batch computation
         cudaDeviceSynchronize();
 
-        // find first and last tile R camera
-        const int firstRc = tiles.at(firstTileIndex).rc;
-        int lastRc = tiles.at(lastTileIndex - 1).rc;
+        // add the batch device zones to the trace
+        flushDeviceTraceZones();
 
-        // check if last tile depth map is finished
-        if (lastTileIndex < tiles.size() && (tiles.at(lastTileIndex).rc == lastRc))
-            --lastRc;
+        // update the peak device memory of the resource report
+        if (system::ResourceReport::get().isEnabled())
+        {
+            double deviceAvailableMB, deviceUsedMB, deviceTotalMB;
+            getDeviceMemoryInfo(deviceAvailableMB, deviceUsedMB, deviceTotalMB);
+            system::ResourceReport::get().updatePeakGpuMemory(static_cast<std::size_t>(deviceUsedMB * 1024.0 * 1024.0));
+        }
+
+        // find first and last R camera of the batch in the cameras list
+        // note: batches contain all the tiles of their R cameras, the cameras list may not be sorted
+        const int firstCamIndex = firstTileIndex / nbTilesPerCamera;
+        const int lastCamIndex = divideRoundUp(lastTileIndex, nbTilesPerCamera);
 
         // write depth/sim map result
-        for (int c = firstRc; c <= lastRc; ++c)
-        {
-            const int batchCamIndex = c % nbRcPerBatch;
+        ALICEVISION_TRACE_ZONE_CAT("DepthMapEstimator::writeBatchDepthSimMaps", "depthMap");
 
-            if (_depthMapParams.useRefine)
+        for (int camIndex = firstCamIndex; camIndex < lastCamIndex; ++camIndex)
+        {
+            const int c = cams.at(camIndex);
+            const int batchCamIndex = camIndex % nbRcPerBatch;
+
+            if (usePatchMatch)
+                writeDepthSimMapFromTileList(c,
+                                             _mp,
+                                             _tileParams,
+                                             _tileRoiList,
+                                             depthSimMapTilePerCam.at(batchCamIndex),
+                                             _depthMapParams.patchMatch.scale,
+                                             _depthMapParams.patchMatch.stepXY);
+            else if (useRefine)
                 writeDepthSimMapFromTileList(
                   c, _mp, _tileParams, _tileRoiList, depthSimMapTilePerCam.at(batchCamIndex), _refineParams.scale, _refineParams.stepXY);
             else
@@ -469,6 +808,8 @@ void DepthMapEstimator::compute(int cudaDeviceId, const std::vector<int>& cams)
             if (_depthMapParams.exportTilePattern)
                 exportDepthSimMapTilePatternObj(c, _mp, _tileRoiList, depthMinMaxTilePerCam.at(batchCamIndex));
         }
+
+        progressDisplay += static_cast<unsigned long>(lastTileIndex - firstTileIndex);
     }
 
     // merge intermediate results tiles if needed and desired
@@ -477,6 +818,14 @@ void DepthMapEstimator::compute(int cudaDeviceId, const std::vector<int>& cams)
         // merge tiles if needed and desired
         for (int rc : cams)
         {
+            if (usePatchMatch)
+            {
+                if (_depthMapParams.patchMatch.exportNormalMaps)
+                    mergeNormalMapTiles(rc, _mp, _depthMapParams.patchMatch.scale, _depthMapParams.patchMatch.stepXY, "patchMatch");
+
+                continue;
+            }
+
             if (_sgmParams.exportIntermediateDepthSimMaps)
             {
                 mergeDepthSimMapTiles(rc, _mp, _sgmParams.scale, _sgmParams.stepXY, "sgm");
@@ -487,7 +836,7 @@ void DepthMapEstimator::compute(int cudaDeviceId, const std::vector<int>& cams)
                 mergeNormalMapTiles(rc, _mp, _sgmParams.scale, _sgmParams.stepXY, "sgm");
             }
 
-            if (_depthMapParams.useRefine)
+            if (useRefine)
             {
                 if (_refineParams.exportIntermediateDepthSimMaps)
                 {
@@ -496,19 +845,26 @@ void DepthMapEstimator::compute(int cudaDeviceId, const std::vector<int>& cams)
                 }
 
                 if (_refineParams.exportIntermediateNormalMaps)
-                {
                     mergeNormalMapTiles(rc, _mp, _refineParams.scale, _refineParams.stepXY, "refinedFused");
+
+                if (_refineParams.computeNormalMap || _refineParams.exportIntermediateNormalMaps)
                     mergeNormalMapTiles(rc, _mp, _refineParams.scale, _refineParams.stepXY);
-                }
             }
         }
     }
 
+    // log device cache hit rates
+    deviceCache.logStatistics();
+
     // some objects countains CUDA objects
     // this objects should be destroyed before the end of the program (i.e. the end of the CUDA context)
     DeviceCache::getInstance().clear();
     sgmPerStream.clear();
     refinePerStream.clear();
+    patchMatchPerStream.clear();
+
+    // give the cached device buffers back to the device
+    DeviceMemoryPool::get().release();
 }
 
 }  // namespace depthMap
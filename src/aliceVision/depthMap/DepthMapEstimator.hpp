@@ -57,6 +57,13 @@ class DepthMapEstimator : public IGPUJob
      */
     void compute(int cudaDeviceId, const std::vector<int>& cams) override;
 
+    /**
+     * @brief Order the given R cameras along the view graph.
+     *        Consecutive R cameras share most of their T cameras, so the device cache reuses the loaded images.
+     * @param[in,out] cams the list of cameras
+     */
+    void orderCamsByViewGraph(std::vector<int>& cams) const;
+
   private:
     // private methods
 
@@ -67,6 +74,12 @@ class DepthMapEstimator : public IGPUJob
      */
     int getNbSimultaneousTiles() const;
 
+    /**
+     * @brief Get the maximum downscale (scale * stepXY) of the depth map estimation processes.
+     * @return maximum downscale
+     */
+    int getMaxDownscale() const;
+
     /**
      * @brief Build tile list from the given cameras.
      * @param[in] cams the list of cameras
@@ -74,6 +87,16 @@ class DepthMapEstimator : public IGPUJob
      */
     void getTilesList(const std::vector<int>& cams, std::vector<Tile>& tiles) const;
 
+    /**
+     * @brief Get the list of R and T cameras used by the given range of tiles.
+     * @param[in] tiles the tiles list
+     * @param[in] firstTileIndex the first tile index
+     * @param[in] lastTileIndex the last tile index (excluded)
+     * @param[in] maxCams the maximum number of cameras to return
+     * @param[in,out] cams the output cameras list (R cameras first)
+     */
+    void getTilesCams(const std::vector<Tile>& tiles, int firstTileIndex, int lastTileIndex, int maxCams, std::vector<int>& cams) const;
+
     // private members
 
     const mvsUtils::MultiViewParams& _mp;     //< multi-view parameters
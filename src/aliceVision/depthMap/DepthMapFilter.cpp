@@ -0,0 +1,155 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "DepthMapFilter.hpp"
+
+#include <aliceVision/system/Logger.hpp>
+#include <aliceVision/system/Timer.hpp>
+#include <aliceVision/utils/filesIO.hpp>
+#include <aliceVision/image/io.hpp>
+#include <aliceVision/mvsUtils/fileIO.hpp>
+#include <aliceVision/mvsUtils/mapIO.hpp>
+#include <aliceVision/depthMap/cuda/host/utils.hpp>
+#include <aliceVision/depthMap/cuda/host/DeviceCache.hpp>
+#include <aliceVision/depthMap/cuda/filtering/deviceDepthMapFilter.hpp>
+
+#include <algorithm>
+
+namespace aliceVision {
+namespace depthMap {
+
+DepthMapFilter::DepthMapFilter(const mvsUtils::MultiViewParams& mp, const DepthMapFilterParams& filterParams)
+  : _mp(mp),
+    _filterParams(filterParams)
+{}
+
+void DepthMapFilter::compute(int cudaDeviceId, const std::vector<int>& cams)
+{
+    // set the device to use for GPU executions
+    // the CUDA runtime API is thread-safe, it maintains per-thread state about the current device
+    setCudaDeviceId(cudaDeviceId);
+
+    // the R camera and its nearest T cameras parameters are kept in the cache,
+    // the nearest cameras of successive R cameras are often the same
+    const int nbCameraParams = std::min(_filterParams.nNearestCams + 1, ALICEVISION_DEVICE_MAX_CONSTANT_CAMERA_PARAM_SETS);
+
+    DeviceCache& deviceCache = DeviceCache::getInstance();
+    deviceCache.build(0, std::max(nbCameraParams, 2));  // 0 mipmap image
+
+    for (const int rc : cams)
+    {
+        const std::string depthMapFilepath = getFileNameFromIndex(_mp, rc, mvsUtils::EFileType::depthMapFiltered);
+        const std::string simMapFilepath = getFileNameFromIndex(_mp, rc, mvsUtils::EFileType::simMapFiltered);
+
+        if (utils::exists(depthMapFilepath) && utils::exists(simMapFilepath))
+            continue;
+
+        const system::Timer timer;
+
+        ALICEVISION_LOG_INFO("Filter depth map (rc: " << rc << ")");
+
+        // read input depth/sim maps from depthMapEstimation folder
+        image::Image<float> depthMap;
+        image::Image<float> simMap;
+        mvsUtils::readMap(rc, _mp, mvsUtils::EFileType::depthMap, depthMap);
+        mvsUtils::readMap(rc, _mp, mvsUtils::EFileType::simMap, simMap);
+
+        const int width = _mp.getWidth(rc);
+        const int height = _mp.getHeight(rc);
+
+        if ((depthMap.size() != width * height) || (simMap.size() != width * height))
+        {
+            ALICEVISION_THROW_ERROR("Filter depth map: bad image dimension for camera: "
+                                    << _mp.getViewId(rc) << std::endl
+                                    << "depthMap size: " << depthMap.size() << ", simMap size: " << simMap.size() << ", width: " << width
+                                    << ", height: " << height);
+        }
+
+        // copy input depth/sim maps into device memory
+        const CudaSize<2> mapDim(width, height);
+
+        CudaDeviceMemoryPitched<float, 2> depthMap_dmp(mapDim);
+        CudaDeviceMemoryPitched<float, 2> simMap_dmp(mapDim);
+        depthMap_dmp.copyFrom(depthMap.data(), width, height);
+        simMap_dmp.copyFrom(simMap.data(), width, height);
+
+        // allocate the support count and the number of consistent T cameras maps in device memory
+        // note: as in the CPU filtering, the support counts are accumulated over the T cameras
+        CudaDeviceMemoryPitched<int, 2> supportMap_dmp(mapDim);
+        CudaDeviceMemoryPitched<unsigned char, 2> modalsMap_dmp(mapDim);
+        CHECK_CUDA_RETURN_ERROR(cudaMemset2D(supportMap_dmp.getBuffer(), supportMap_dmp.getPitch(), 0, width * sizeof(int), height));
+        CHECK_CUDA_RETURN_ERROR(cudaMemset2D(modalsMap_dmp.getBuffer(), modalsMap_dmp.getPitch(), 0, width * sizeof(unsigned char), height));
+
+        CudaDeviceMemoryPitched<float, 2> tcDepthMap_dmp;
+        image::Image<float> tcDepthMap;
+
+        const StaticVector<int> tcams = _mp.findNearestCamsFromLandmarks(rc, _filterParams.nNearestCams);
+
+        for (const int tc : tcams)
+        {
+            // read T camera depth map from depthMapEstimation folder
+            mvsUtils::readMap(tc, _mp, mvsUtils::EFileType::depthMap, tcDepthMap);
+
+            if (tcDepthMap.width() <= 0 || tcDepthMap.height() <= 0)
+                continue;
+
+            // add R and T cameras parameters to the device cache (device constant memory)
+            // no aditional downscale applied, we are working at input depth map resolution
+            // note: R camera parameters are added again to stay the most recently used
+            deviceCache.addCameraParams(rc, 1 /*downscale*/, _mp);
+            deviceCache.addCameraParams(tc, 1 /*downscale*/, _mp);
+
+            const int rcDeviceCameraParamsId = deviceCache.requestCameraParamsId(rc, 1 /*downscale*/, _mp);
+            const int tcDeviceCameraParamsId = deviceCache.requestCameraParamsId(tc, 1 /*downscale*/, _mp);
+
+            // copy T camera depth map into device memory
+            const CudaSize<2> tcMapDim(tcDepthMap.width(), tcDepthMap.height());
+            if (tcDepthMap_dmp.getSize() != tcMapDim)
+                tcDepthMap_dmp.allocate(tcMapDim);
+            tcDepthMap_dmp.copyFrom(tcDepthMap.data(), tcDepthMap.width(), tcDepthMap.height());
+
+            cuda_depthMapFilterAccumulateSupport(supportMap_dmp,
+                                                 depthMap_dmp,
+                                                 simMap_dmp,
+                                                 tcDepthMap_dmp,
+                                                 rcDeviceCameraParamsId,
+                                                 tcDeviceCameraParamsId,
+                                                 _filterParams,
+                                                 _mp.g_border,
+                                                 0 /*stream*/);
+
+            cuda_depthMapFilterCountModals(modalsMap_dmp, supportMap_dmp, 0 /*stream*/);
+        }
+
+        // filter depth/sim maps from the number of consistent T cameras
+        cuda_depthMapFilterApply(depthMap_dmp, simMap_dmp, modalsMap_dmp, _filterParams, 0 /*stream*/);
+
+        // copy filtered depth/sim maps and number of consistent T cameras map back to host memory
+        image::Image<unsigned char> modalsMap(width, height);
+        modalsMap_dmp.copyTo(modalsMap.data(), width, height);
+        depthMap_dmp.copyTo(depthMap.data(), width, height);
+        simMap_dmp.copyTo(simMap.data(), width, height);
+
+        // write output number of consistent T cameras map, used by the meshing
+        image::writeImageWithFloat(
+          getFileNameFromIndex(_mp, rc, mvsUtils::EFileType::nmodMap),
+          modalsMap,
+          image::ImageWriteOptions().toColorSpace(image::EImageColorSpace::LINEAR).storageDataType(image::EStorageDataType::Float));
+
+        // write output filtered depth/sim maps
+        mvsUtils::writeMap(rc, _mp, mvsUtils::EFileType::depthMapFiltered, depthMap);
+        mvsUtils::writeMap(rc, _mp, mvsUtils::EFileType::simMapFiltered, simMap);
+
+        ALICEVISION_LOG_INFO("Filter depth map (rc: " << rc << ") done in: " << timer.elapsedMs() << " ms.");
+    }
+
+    // device cache countains CUDA objects
+    // this objects should be destroyed before the end of the program (i.e. the end of the CUDA context)
+    DeviceCache::getInstance().clear();
+}
+
+}  // namespace depthMap
+}  // namespace aliceVision
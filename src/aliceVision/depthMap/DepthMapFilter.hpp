@@ -0,0 +1,59 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/mvsUtils/MultiViewParams.hpp>
+#include <aliceVision/depthMap/DepthMapFilterParams.hpp>
+#include <aliceVision/depthMap/computeOnMultiGPUs.hpp>
+
+#include <vector>
+
+namespace aliceVision {
+namespace depthMap {
+
+/**
+ * @brief Depth Map Filter
+ * @brief Wrap the GPU filtering of the depth maps from their consistency with the nearest cameras depth maps.
+ * @note Same filtering and outputs as fuseCut::Fuser filterGroups / filterDepthMaps,
+ *       the number of consistent cameras map is kept in device memory between the two steps.
+ * @note Allows muli-GPUs computation (interface IGPUJob)
+ */
+class DepthMapFilter : public IGPUJob
+{
+  public:
+    /**
+     * @brief Depth Map Filter constructor.
+     * @param[in] mp the multi-view parameters
+     * @param[in] filterParams the depth map filtering parameters
+     */
+    DepthMapFilter(const mvsUtils::MultiViewParams& mp, const DepthMapFilterParams& filterParams);
+
+    // no copy constructor
+    DepthMapFilter(DepthMapFilter const&) = delete;
+
+    // no copy operator
+    void operator=(DepthMapFilter const&) = delete;
+
+    // destructor
+    ~DepthMapFilter() = default;
+
+    /**
+     * @brief Filter the depth maps of the given cameras.
+     * @param[in] cudaDeviceId the CUDA device id
+     * @param[in] cams the list of cameras
+     */
+    void compute(int cudaDeviceId, const std::vector<int>& cams) override;
+
+  private:
+    // private members
+
+    const mvsUtils::MultiViewParams& _mp;     //< multi-view parameters
+    const DepthMapFilterParams _filterParams;  //< depth map filtering parameters
+};
+
+}  // namespace depthMap
+}  // namespace aliceVision
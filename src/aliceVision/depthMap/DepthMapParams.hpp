@@ -10,6 +10,7 @@
 #include <aliceVision/depthMap/CustomPatchPatternParams.hpp>
 #include <aliceVision/depthMap/SgmParams.hpp>
 #include <aliceVision/depthMap/RefineParams.hpp>
+#include <aliceVision/depthMap/PatchMatchParams.hpp>
 
 namespace aliceVision {
 namespace depthMap {
@@ -24,11 +25,18 @@ struct DepthMapParams
     int maxTCams = 10;                 //< global T cameras maximum
     bool chooseTCamsPerTile = true;    //< choose T cameras per R tile or for the entire R image
     bool exportTilePattern = false;    //< export tile pattern obj
+    bool exportMemoryPlan = false;     //< export device memory plan json
     bool autoAdjustSmallImage = true;  //< allow program to override parameters for the single tile case
+    bool prefetchImages = true;        //< load next batch images on CPU while the current batch is computed on GPU
+    bool usePatchMatch = false;        //< use the PatchMatch estimator instead of SGM + Refine
+    bool orderCamsByViewGraph = true;  //< process R cameras along the view graph to reuse the cached T camera images
 
     /// user custom patch pattern for similarity volume computation (both SGM & Refine)
     CustomPatchPatternParams customPatchPattern;
 
+    /// PatchMatch estimator parameters (if usePatchMatch)
+    PatchMatchParams patchMatch;
+
     // constant parameters
 
     const bool useRefine = true;  //< for debug purposes: enable or disable Refine process
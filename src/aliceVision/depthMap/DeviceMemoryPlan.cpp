@@ -0,0 +1,82 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "DeviceMemoryPlan.hpp"
+
+#include <aliceVision/system/Logger.hpp>
+
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/json_parser.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace aliceVision {
+namespace depthMap {
+
+namespace bpt = boost::property_tree;
+
+int computeMaxTileBufferSide(const DeviceMemoryPlan& plan, int maxDownscale)
+{
+    const double tileCostMB = plan.getTileCostMB();
+    const double tileAreaBudgetMB = plan.deviceBudgetMB - plan.rcCamsCostMB;
+
+    if (tileCostMB <= 0.0 || tileAreaBudgetMB <= 0.0 || plan.tileBufferWidth <= 0 || plan.tileBufferHeight <= 0)
+        return 0;
+
+    // cost per tile buffer pixel
+    const double pixelCostMB = tileCostMB / (double(plan.tileBufferWidth) * double(plan.tileBufferHeight));
+
+    const int side = static_cast<int>(std::sqrt(tileAreaBudgetMB / pixelCostMB));
+    const int step = std::max(1, maxDownscale);
+
+    return (side / step) * step;
+}
+
+void logDeviceMemoryPlan(const DeviceMemoryPlan& plan)
+{
+    ALICEVISION_LOG_INFO("Device memory plan (device id: " << plan.cudaDeviceId << "):" << std::endl
+                                                           << "\t- budget: " << plan.deviceBudgetMB << " MB (available: " << plan.deviceAvailableMB
+                                                           << " MB, total: " << plan.deviceTotalMB << " MB)" << std::endl
+                                                           << "\t- planned: " << plan.getPlannedMB() << " MB" << std::endl
+                                                           << "\t- tile buffer: " << plan.tileBufferWidth << "x" << plan.tileBufferHeight
+                                                           << " (max single tile buffer side: " << plan.maxTileBufferSide << ")" << std::endl
+                                                           << "\t- # simultaneous tiles: " << plan.nbSimultaneousTiles
+                                                           << (plan.limitedByConstantMemory ? " (limited by device constant memory)" : ""));
+}
+
+void exportDeviceMemoryPlan(const DeviceMemoryPlan& plan, const std::string& filepath)
+{
+    bpt::ptree tree;
+
+    tree.put("cudaDeviceId", plan.cudaDeviceId);
+
+    tree.put("device.totalMB", plan.deviceTotalMB);
+    tree.put("device.availableMB", plan.deviceAvailableMB);
+    tree.put("device.budgetMB", plan.deviceBudgetMB);
+    tree.put("device.plannedMB", plan.getPlannedMB());
+
+    tree.put("cost.mipmapImageMB", plan.mipmapCostMB);
+    tree.put("cost.rcCamerasMB", plan.rcCamsCostMB);
+    tree.put("cost.sgmTileMB", plan.sgmTileCostMB);
+    tree.put("cost.refineTileMB", plan.refineTileCostMB);
+    tree.put("cost.patchMatchTileMB", plan.patchMatchTileCostMB);
+
+    tree.put("tiling.bufferWidth", plan.tileBufferWidth);
+    tree.put("tiling.bufferHeight", plan.tileBufferHeight);
+    tree.put("tiling.nbTilesPerCamera", plan.nbTilesPerCamera);
+    tree.put("tiling.maxTileBufferSide", plan.maxTileBufferSide);
+
+    tree.put("parallelization.nbSimultaneousFullRc", plan.nbSimultaneousFullRc);
+    tree.put("parallelization.nbRemainingTiles", plan.nbRemainingTiles);
+    tree.put("parallelization.nbSimultaneousTiles", plan.nbSimultaneousTiles);
+    tree.put("parallelization.limitedByConstantMemory", plan.limitedByConstantMemory);
+
+    bpt::write_json(filepath, tree);
+}
+
+}  // namespace depthMap
+}  // namespace aliceVision
@@ -0,0 +1,91 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <string>
+
+namespace aliceVision {
+namespace depthMap {
+
+/**
+ * @struct Device Memory Plan
+ * @brief Support class to keep the device memory budget and the resulting
+ *        depth map parallelization decision for a single device.
+ */
+struct DeviceMemoryPlan
+{
+    int cudaDeviceId = -1;  //< CUDA device id
+
+    // device memory (MB)
+
+    double deviceTotalMB = 0.0;      //< device total memory
+    double deviceAvailableMB = 0.0;  //< device available memory
+    double deviceBudgetMB = 0.0;     //< device memory budget (available memory minus margin)
+
+    // costs (MB)
+
+    double mipmapCostMB = 0.0;          //< single mipmap image cost
+    double rcCamsCostMB = 0.0;          //< R and T cameras mipmap images cost per R camera
+    double sgmTileCostMB = 0.0;         //< Sgm buffers cost per tile
+    double refineTileCostMB = 0.0;      //< Refine buffers cost per tile
+    double patchMatchTileCostMB = 0.0;  //< PatchMatch buffers cost per tile (replaces Sgm + Refine)
+
+    // tiling
+
+    int tileBufferWidth = 0;   //< tile buffer width
+    int tileBufferHeight = 0;  //< tile buffer height
+    int nbTilesPerCamera = 0;  //< number of tiles per R camera
+
+    // decision
+
+    int nbSimultaneousFullRc = 0;          //< number of full R camera computations done simultaneously
+    int nbRemainingTiles = 0;              //< number of additional tiles of a partial R camera computation
+    int nbSimultaneousTiles = 0;           //< number of tiles computed simultaneously
+    bool limitedByConstantMemory = false;  //< parallelization is limited by the camera parameters device constant memory
+    int maxTileBufferSide = 0;             //< approximate largest square tile buffer side for a single tile computation
+
+    /**
+     * @brief Get a single tile computation cost (Sgm + Refine).
+     * @return tile cost (MB)
+     */
+    inline double getTileCostMB() const { return sgmTileCostMB + refineTileCostMB + patchMatchTileCostMB; }
+
+    /**
+     * @brief Get the device memory needed by the planned computation.
+     * @return planned memory (MB)
+     */
+    inline double getPlannedMB() const
+    {
+        const int nbRc = nbSimultaneousFullRc + ((nbRemainingTiles > 0) ? 1 : 0);
+        return nbRc * rcCamsCostMB + nbSimultaneousTiles * getTileCostMB();
+    }
+};
+
+/**
+ * @brief Compute the approximate largest square tile buffer side that fits the device memory budget.
+ * @note Tile buffers (volumes and maps) cost scales with the tile area.
+ * @param[in] plan the device memory plan with costs computed for the current tile buffer size
+ * @param[in] maxDownscale the maximum downscale (scale * stepXY), the tile side is a multiple of it
+ * @return tile buffer side (0 if even the cameras mipmap images do not fit)
+ */
+int computeMaxTileBufferSide(const DeviceMemoryPlan& plan, int maxDownscale);
+
+/**
+ * @brief Log the given device memory plan.
+ * @param[in] plan the device memory plan
+ */
+void logDeviceMemoryPlan(const DeviceMemoryPlan& plan);
+
+/**
+ * @brief Export the given device memory plan in a JSON file.
+ * @param[in] plan the device memory plan
+ * @param[in] filepath the output JSON file path
+ */
+void exportDeviceMemoryPlan(const DeviceMemoryPlan& plan, const std::string& filepath);
+
+}  // namespace depthMap
+}  // namespace aliceVision
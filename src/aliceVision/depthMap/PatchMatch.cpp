@@ -0,0 +1,150 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "PatchMatch.hpp"
+
+#include <aliceVision/system/Logger.hpp>
+#include <aliceVision/depthMap/depthMapUtils.hpp>
+#include <aliceVision/depthMap/cuda/host/DeviceCache.hpp>
+#include <aliceVision/depthMap/cuda/host/DeviceTrace.hpp>
+#include <aliceVision/depthMap/cuda/patchMatch/devicePatchMatch.hpp>
+
+#include <algorithm>
+
+namespace aliceVision {
+namespace depthMap {
+
+PatchMatch::PatchMatch(const mvsUtils::MultiViewParams& mp,
+                       const mvsUtils::TileParams& tileParams,
+                       const PatchMatchParams& patchMatchParams,
+                       cudaStream_t stream)
+  : _mp(mp),
+    _tileParams(tileParams),
+    _patchMatchParams(patchMatchParams),
+    _stream(stream)
+{
+    // get tile maximum dimensions
+    const int downscale = _patchMatchParams.scale * _patchMatchParams.stepXY;
+    const int maxTileWidth = divideRoundUp(tileParams.bufferWidth, downscale);
+    const int maxTileHeight = divideRoundUp(tileParams.bufferHeight, downscale);
+
+    // compute map maximum dimensions
+    const CudaSize<2> mapDim(maxTileWidth, maxTileHeight);
+
+    // allocate depth/sim map and normal map in device memory
+    // note: no similarity volume, the memory only depends on the tile size
+    _depthSimMap_dmp.allocate(mapDim);
+    _normalMap_dmp.allocate(mapDim);
+}
+
+double PatchMatch::getDeviceMemoryConsumption() const
+{
+    size_t bytes = 0;
+
+    bytes += _depthSimMap_dmp.getBytesPadded();
+    bytes += _normalMap_dmp.getBytesPadded();
+
+    return (double(bytes) / (1024.0 * 1024.0));
+}
+
+double PatchMatch::getDeviceMemoryConsumptionUnpadded() const
+{
+    size_t bytes = 0;
+
+    bytes += _depthSimMap_dmp.getBytesUnpadded();
+    bytes += _normalMap_dmp.getBytesUnpadded();
+
+    return (double(bytes) / (1024.0 * 1024.0));
+}
+
+void PatchMatch::patchMatchRc(const Tile& tile, const SgmDepthList& tileDepthList)
+{
+    ALICEVISION_TRACE_ZONE_CAT("PatchMatch::patchMatchRc", "depthMap");
+    ALICEVISION_DEVICE_TRACE_ZONE("PatchMatch::patchMatchRc", _stream);
+
+    const IndexT viewId = _mp.getViewId(tile.rc);
+
+    ALICEVISION_LOG_INFO(tile << "PatchMatch depth/sim map of view id: " << viewId << ", rc: " << tile.rc << " (" << (tile.rc + 1) << " / "
+                              << _mp.ncams << ").");
+
+    // downscale the region of interest
+    const ROI downscaledRoi = downscaleROI(tile.roi, _patchMatchParams.scale * _patchMatchParams.stepXY);
+
+    // get the tile depth range
+    const std::pair<float, float> minMaxDepths = tileDepthList.getMinMaxDepths();
+
+    // get device cache instance
+    DeviceCache& deviceCache = DeviceCache::getInstance();
+
+    // get R device camera parameters id from cache
+    const int rcDeviceCameraParamsId = deviceCache.requestCameraParamsId(tile.rc, _patchMatchParams.scale, _mp);
+
+    // get R device mipmap image from cache
+    const DeviceMipmapImage& rcDeviceMipmapImage = deviceCache.requestMipmapImage(tile.rc, _mp);
+
+    // get T cameras device parameters ids and mipmap images from cache
+    DevicePatchMatchTCams tCams;
+    tCams.nbTCams = std::min(int(tile.sgmTCams.size()), ALICEVISION_DEVICE_PATCHMATCH_MAX_TCAMS);
+
+    for (int tci = 0; tci < tCams.nbTCams; ++tci)
+    {
+        const int tc = tile.sgmTCams.at(tci);
+        const DeviceMipmapImage& tcDeviceMipmapImage = deviceCache.requestMipmapImage(tc, _mp);
+        const CudaSize<2> tcLevelDim = tcDeviceMipmapImage.getDimensions(_patchMatchParams.scale);
+
+        tCams.deviceCameraParamsIds[tci] = deviceCache.requestCameraParamsId(tc, _patchMatchParams.scale, _mp);
+        tCams.mipmapImage_tex[tci] = tcDeviceMipmapImage.getTextureObject();
+        tCams.levelWidth[tci] = (unsigned int)(tcLevelDim.x());
+        tCams.levelHeight[tci] = (unsigned int)(tcLevelDim.y());
+    }
+
+    ALICEVISION_LOG_DEBUG(tile << "PatchMatch:" << std::endl
+                               << "\t- rc: " << tile.rc << std::endl
+                               << "\t- nb tc: " << tCams.nbTCams << std::endl
+                               << "\t- depth range: [" << minMaxDepths.first << " - " << minMaxDepths.second << "]" << std::endl
+                               << "\t- tile range x: [" << downscaledRoi.x.begin << " - " << downscaledRoi.x.end << "]" << std::endl
+                               << "\t- tile range y: [" << downscaledRoi.y.begin << " - " << downscaledRoi.y.end << "]" << std::endl);
+
+    // random initialization
+    cuda_patchMatchInitialize(_depthSimMap_dmp,
+                              _normalMap_dmp,
+                              rcDeviceCameraParamsId,
+                              rcDeviceMipmapImage,
+                              tCams,
+                              _patchMatchParams,
+                              minMaxDepths.first,
+                              minMaxDepths.second,
+                              downscaledRoi,
+                              _stream);
+
+    // propagation and random refinement iterations
+    for (int iteration = 0; iteration < _patchMatchParams.nbIterations; ++iteration)
+    {
+        cuda_patchMatchIterate(_depthSimMap_dmp,
+                               _normalMap_dmp,
+                               rcDeviceCameraParamsId,
+                               rcDeviceMipmapImage,
+                               tCams,
+                               _patchMatchParams,
+                               minMaxDepths.first,
+                               minMaxDepths.second,
+                               iteration,
+                               downscaledRoi,
+                               _stream);
+    }
+
+    // filter out the invalid and poorly supported depths
+    cuda_patchMatchFinalize(_depthSimMap_dmp, _patchMatchParams, downscaledRoi, _stream);
+
+    // export the estimated normal map (if requested by user)
+    if (_patchMatchParams.exportNormalMaps)
+        writeNormalMap(tile.rc, _mp, _tileParams, tile.roi, _normalMap_dmp, _patchMatchParams.scale, _patchMatchParams.stepXY, "patchMatch");
+
+    ALICEVISION_LOG_INFO(tile << "PatchMatch depth/sim map done.");
+}
+
+}  // namespace depthMap
+}  // namespace aliceVision
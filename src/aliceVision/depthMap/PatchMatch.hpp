@@ -0,0 +1,85 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/mvsUtils/MultiViewParams.hpp>
+#include <aliceVision/mvsUtils/TileParams.hpp>
+#include <aliceVision/depthMap/Tile.hpp>
+#include <aliceVision/depthMap/SgmDepthList.hpp>
+#include <aliceVision/depthMap/PatchMatchParams.hpp>
+#include <aliceVision/depthMap/cuda/host/memory.hpp>
+
+namespace aliceVision {
+namespace depthMap {
+
+/**
+ * @class Depth map estimation PatchMatch
+ * @brief Manages the calculation of the PatchMatch depth map estimation,
+ *        an alternative to SGM + Refine without similarity volume.
+ */
+class PatchMatch
+{
+  public:
+    /**
+     * @brief PatchMatch constructor.
+     * @param[in] mp the multi-view parameters
+     * @param[in] tileParams tile workflow parameters
+     * @param[in] patchMatchParams the PatchMatch parameters
+     * @param[in] stream the stream for gpu execution
+     */
+    PatchMatch(const mvsUtils::MultiViewParams& mp,
+               const mvsUtils::TileParams& tileParams,
+               const PatchMatchParams& patchMatchParams,
+               cudaStream_t stream);
+
+    // no default constructor
+    PatchMatch() = delete;
+
+    // default destructor
+    ~PatchMatch() = default;
+
+    // final depth/similarity map getter
+    inline const CudaDeviceMemoryPitched<float2, 2>& getDeviceDepthSimMap() const { return _depthSimMap_dmp; }
+
+    // final normal map getter
+    inline const CudaDeviceMemoryPitched<float3, 2>& getDeviceNormalMap() const { return _normalMap_dmp; }
+
+    /**
+     * @brief Get memory consumpyion in device memory.
+     * @return device memory consumpyion (in MB)
+     */
+    double getDeviceMemoryConsumption() const;
+
+    /**
+     * @brief Get unpadded memory consumpyion in device memory.
+     * @return unpadded device memory consumpyion (in MB)
+     */
+    double getDeviceMemoryConsumptionUnpadded() const;
+
+    /**
+     * @brief Compute for a single R camera the PatchMatch depth/sim map.
+     * @param[in] tile The given tile for PatchMatch computation
+     * @param[in] tileDepthList the tile depth list, only used for its depth range
+     */
+    void patchMatchRc(const Tile& tile, const SgmDepthList& tileDepthList);
+
+  private:
+    // private members
+
+    const mvsUtils::MultiViewParams& _mp;         //< Multi-view parameters
+    const mvsUtils::TileParams& _tileParams;      //< tile workflow parameters
+    const PatchMatchParams& _patchMatchParams;    //< PatchMatch parameters
+
+    // private members in device memory
+
+    CudaDeviceMemoryPitched<float2, 2> _depthSimMap_dmp;  //< rc depth/sim map
+    CudaDeviceMemoryPitched<float3, 2> _normalMap_dmp;    //< rc normal map
+    cudaStream_t _stream;                                 //< stream for gpu execution
+};
+
+}  // namespace depthMap
+}  // namespace aliceVision
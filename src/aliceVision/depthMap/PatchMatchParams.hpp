@@ -0,0 +1,44 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+namespace aliceVision {
+namespace depthMap {
+
+// maximum number of T cameras per tile used by the PatchMatch kernels
+#define ALICEVISION_DEVICE_PATCHMATCH_MAX_TCAMS 8
+
+/**
+ * @brief PatchMatch Parameters
+ */
+struct PatchMatchParams
+{
+    // user parameters
+
+    int scale = 1;
+    int stepXY = 1;
+    int wsh = 3;
+    int nbIterations = 6;
+    int maxTCamsPerTile = 4;
+    double gammaC = 15.5;
+    double gammaP = 8.0;
+    double maxSimilarity = -0.2;  //< similarity threshold (between -1 and 0) to filter out poorly supported depth values
+    bool useConsistentScale = false;
+    bool useCustomPatchPattern = false;
+    bool exportNormalMaps = false;
+
+    // constant parameters
+
+    const int nbRandomRefinements = 3;            //< number of random hypotheses tested per pixel and iteration
+    const float depthPerturbation = 0.25f;        //< initial relative depth perturbation of the random refinement
+    const float normalPerturbation = 0.5f;        //< initial normal perturbation of the random refinement
+    const float perturbationDecay = 0.5f;         //< perturbation decay at each iteration
+    const unsigned int randomSeed = 1234u;        //< seed of the device random number generator
+};
+
+}  // namespace depthMap
+}  // namespace aliceVision
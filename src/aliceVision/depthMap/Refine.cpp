@@ -14,6 +14,7 @@
 #include <aliceVision/depthMap/depthMapUtils.hpp>
 #include <aliceVision/depthMap/volumeIO.hpp>
 #include <aliceVision/depthMap/cuda/host/DeviceCache.hpp>
+#include <aliceVision/depthMap/cuda/host/DeviceTrace.hpp>
 #include <aliceVision/depthMap/cuda/planeSweeping/deviceDepthSimilarityMap.hpp>
 #include <aliceVision/depthMap/cuda/planeSweeping/deviceSimilarityVolume.hpp>
 
@@ -44,7 +45,7 @@ Refine::Refine(const mvsUtils::MultiViewParams& mp, const mvsUtils::TileParams&
         _sgmNormalMap_dmp.allocate(depthSimMapDim);
 
     // allocate normal map in device memory
-    if (_refineParams.exportIntermediateNormalMaps)
+    if (_refineParams.computeNormalMap || _refineParams.exportIntermediateNormalMaps)
         _normalMap_dmp.allocate(depthSimMapDim);
 
     // compute volume maximum dimensions
@@ -98,6 +99,9 @@ void Refine::refineRc(const Tile& tile,
                       const CudaDeviceMemoryPitched<float2, 2>& in_sgmDepthThicknessMap_dmp,
                       const CudaDeviceMemoryPitched<float3, 2>& in_sgmNormalMap_dmp)
 {
+    ALICEVISION_TRACE_ZONE_CAT("Refine::refineRc", "depthMap");
+    ALICEVISION_DEVICE_TRACE_ZONE("Refine::refineRc", _stream);
+
     const IndexT viewId = _mp.getViewId(tile.rc);
 
     ALICEVISION_LOG_INFO(tile << "Refine depth/sim map of view id: " << viewId << ", rc: " << tile.rc << " (" << (tile.rc + 1) << " / " << _mp.ncams
@@ -168,8 +172,8 @@ void Refine::refineRc(const Tile& tile,
         _optimizedDepthSimMap_dmp.copyFrom(_refinedDepthSimMap_dmp, _stream);
     }
 
-    // export intermediate normal map (if requested by user)
-    if (_refineParams.exportIntermediateNormalMaps)
+    // compute the normal map while the depth/sim map is on device (if requested by user)
+    if (_refineParams.computeNormalMap || _refineParams.exportIntermediateNormalMaps)
         computeAndWriteNormalMap(tile, _optimizedDepthSimMap_dmp);
 
     ALICEVISION_LOG_INFO(tile << "Refine depth/sim map done.");
@@ -266,7 +270,8 @@ void Refine::optimizeDepthSimMap(const Tile& tile)
                                             rcDeviceMipmapImage,
                                             _refineParams,
                                             downscaledRoi,
-                                            _stream);
+                                            _stream,
+                                            &_optimizationGraph);
 
     ALICEVISION_LOG_INFO(tile << "Color optimize depth/sim map done.");
 }
@@ -31,6 +31,7 @@ struct RefineParams
     bool useCustomPatchPattern = false;
     bool useRefineFuse = true;
     bool useColorOptimization = true;
+    bool computeNormalMap = false;  //< compute the normal map of the refined depth map on device and write it alongside
 
     // intermediate results export parameters
 
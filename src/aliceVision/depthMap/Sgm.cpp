@@ -12,6 +12,7 @@
 #include <aliceVision/depthMap/volumeIO.hpp>
 #include <aliceVision/depthMap/cuda/host/utils.hpp>
 #include <aliceVision/depthMap/cuda/host/DeviceCache.hpp>
+#include <aliceVision/depthMap/cuda/host/DeviceTrace.hpp>
 #include <aliceVision/depthMap/cuda/planeSweeping/deviceDepthSimilarityMap.hpp>
 #include <aliceVision/depthMap/cuda/planeSweeping/deviceSimilarityVolume.hpp>
 
@@ -30,6 +31,7 @@ Sgm::Sgm(const mvsUtils::MultiViewParams& mp,
   : _mp(mp),
     _tileParams(tileParams),
     _sgmParams(sgmParams),
+    _coarseSgmParams(sgmParams),
     _computeDepthSimMap(computeDepthSimMap || sgmParams.exportIntermediateDepthSimMaps),
     _computeNormalMap(computeNormalMap || sgmParams.exportIntermediateNormalMaps),
     _stream(stream)
@@ -78,6 +80,20 @@ Sgm::Sgm(const mvsUtils::MultiViewParams& mp,
         _volumeSliceAccB_dmp.allocate(CudaSize<2>(maxTileSide, _sgmParams.maxDepths));
         _volumeAxisAcc_dmp.allocate(CudaSize<2>(maxTileSide, 1));
     }
+
+    // allocate coarse-to-fine depths support buffers
+    if (sgmParams.coarseToFineFactor > 1)
+    {
+        // coarse pass at low resolution
+        // note: the similarity volumes are allocated for the SGM downscale, large enough
+        if (sgmParams.coarseToFineLowResolution)
+            _coarseSgmParams.scale = _sgmParams.scale * _sgmParams.coarseToFineFactor;
+
+        const CudaSize<2> histogramDim(_sgmParams.maxDepths, 1);
+
+        _depthHistogram_hmh.allocate(histogramDim);
+        _depthHistogram_dmp.allocate(histogramDim);
+    }
 }
 
 double Sgm::getDeviceMemoryConsumption() const
@@ -93,6 +109,7 @@ double Sgm::getDeviceMemoryConsumption() const
     bytes += _volumeSliceAccA_dmp.getBytesPadded();
     bytes += _volumeSliceAccB_dmp.getBytesPadded();
     bytes += _volumeAxisAcc_dmp.getBytesPadded();
+    bytes += _depthHistogram_dmp.getBytesPadded();
 
     return (double(bytes) / (1024.0 * 1024.0));
 }
@@ -110,12 +127,16 @@ double Sgm::getDeviceMemoryConsumptionUnpadded() const
     bytes += _volumeSliceAccA_dmp.getBytesUnpadded();
     bytes += _volumeSliceAccB_dmp.getBytesUnpadded();
     bytes += _volumeAxisAcc_dmp.getBytesUnpadded();
+    bytes += _depthHistogram_dmp.getBytesUnpadded();
 
     return (double(bytes) / (1024.0 * 1024.0));
 }
 
 void Sgm::sgmRc(const Tile& tile, const SgmDepthList& tileDepthList)
 {
+    ALICEVISION_TRACE_ZONE_CAT("Sgm::sgmRc", "depthMap");
+    ALICEVISION_DEVICE_TRACE_ZONE("Sgm::sgmRc", _stream);
+
     const IndexT viewId = _mp.getViewId(tile.rc);
 
     ALICEVISION_LOG_INFO(tile << "SGM depth/thickness map of view id: " << viewId << ", rc: " << tile.rc << " (" << (tile.rc + 1) << " / "
@@ -133,7 +154,7 @@ void Sgm::sgmRc(const Tile& tile, const SgmDepthList& tileDepthList)
     _depths_dmp.copyFrom(_depths_hmh, _stream);
 
     // compute best sim and second best sim volumes
-    computeSimilarityVolumes(tile, tileDepthList);
+    computeSimilarityVolumes(tile, tileDepthList, _sgmParams);
 
     // export intermediate volume information (if requested by user)
     exportVolumeInformation(tile, tileDepthList, _volumeSecBestSim_dmp, "beforeFiltering");
@@ -143,7 +164,7 @@ void Sgm::sgmRc(const Tile& tile, const SgmDepthList& tileDepthList)
     // it must equals to true in normal case
     if (_sgmParams.doSgmOptimizeVolume)
     {
-        optimizeSimilarityVolume(tile, tileDepthList);
+        optimizeSimilarityVolume(tile, tileDepthList, _sgmParams);
     }
     else
     {
@@ -187,6 +208,60 @@ void Sgm::sgmRc(const Tile& tile, const SgmDepthList& tileDepthList)
     ALICEVISION_LOG_INFO(tile << "SGM depth/thickness map done.");
 }
 
+void Sgm::selectCoarseToFineDepths(const Tile& tile, SgmDepthList& inout_tileDepthList)
+{
+    const int factor = _sgmParams.coarseToFineFactor;
+
+    // not enough depths for a coarse pass
+    if (factor <= 1 || inout_tileDepthList.getDepths().size() < 2 * factor)
+        return;
+
+    ALICEVISION_LOG_INFO(tile << "SGM coarse-to-fine depths selection (factor: " << factor << ", downscale: " << _coarseSgmParams.scale << ").");
+
+    // build the coarse depth list
+    SgmDepthList coarseDepthList(_mp, _sgmParams, tile);
+    coarseDepthList.computeCoarseListRc(inout_tileDepthList, factor);
+
+    // copy rc coarse depth data in page-locked host memory
+    for (int i = 0; i < coarseDepthList.getDepths().size(); ++i)
+        _depths_hmh(i, 0) = coarseDepthList.getDepths()[i];
+
+    // copy rc coarse depth data in device memory
+    _depths_dmp.copyFrom(_depths_hmh, _stream);
+
+    // compute and optimize the coarse similarity volume
+    computeSimilarityVolumes(tile, coarseDepthList, _coarseSgmParams);
+
+    if (_sgmParams.doSgmOptimizeVolume)
+    {
+        optimizeSimilarityVolume(tile, coarseDepthList, _coarseSgmParams);
+    }
+    else
+    {
+        _volumeBestSim_dmp.copyFrom(_volumeSecBestSim_dmp, _stream);
+    }
+
+    // count the tile pixels per best coarse depth
+    const ROI downscaledRoi = downscaleROI(tile.roi, _coarseSgmParams.scale * _coarseSgmParams.stepXY);
+    const Range depthRange(0, coarseDepthList.getDepths().size());
+
+    cuda_volumeBestDepthHistogram(_depthHistogram_dmp, _volumeBestSim_dmp, _coarseSgmParams, depthRange, downscaledRoi, _stream);
+
+    // copy coarse depths support from device to host
+    _depthHistogram_hmh.copyFrom(_depthHistogram_dmp, _stream);
+    CHECK_CUDA_RETURN_ERROR(cudaStreamSynchronize(_stream));
+
+    std::vector<int> coarseDepthSupport(coarseDepthList.getDepths().size());
+
+    for (int i = 0; i < coarseDepthSupport.size(); ++i)
+        coarseDepthSupport[i] = _depthHistogram_hmh(i, 0);
+
+    // keep the fine depths around the supported coarse depths
+    inout_tileDepthList.keepCoarseSupportedDepths(factor, coarseDepthSupport);
+
+    ALICEVISION_LOG_INFO(tile << "SGM coarse-to-fine depths selection done (nb depths: " << inout_tileDepthList.getDepths().size() << ").");
+}
+
 void Sgm::smoothThicknessMap(const Tile& tile, const RefineParams& refineParams)
 {
     ALICEVISION_LOG_INFO(tile << "SGM Smooth thickness map.");
@@ -200,12 +275,12 @@ void Sgm::smoothThicknessMap(const Tile& tile, const RefineParams& refineParams)
     ALICEVISION_LOG_INFO(tile << "SGM Smooth thickness map done.");
 }
 
-void Sgm::computeSimilarityVolumes(const Tile& tile, const SgmDepthList& tileDepthList)
+void Sgm::computeSimilarityVolumes(const Tile& tile, const SgmDepthList& tileDepthList, const SgmParams& sgmParams)
 {
     ALICEVISION_LOG_INFO(tile << "SGM Compute similarity volume.");
 
     // downscale the region of interest
-    const ROI downscaledRoi = downscaleROI(tile.roi, _sgmParams.scale * _sgmParams.stepXY);
+    const ROI downscaledRoi = downscaleROI(tile.roi, sgmParams.scale * sgmParams.stepXY);
 
     // initialize the two similarity volumes at 255
     cuda_volumeInitialize(_volumeBestSim_dmp, 255.f, _stream);
@@ -215,7 +290,7 @@ void Sgm::computeSimilarityVolumes(const Tile& tile, const SgmDepthList& tileDep
     DeviceCache& deviceCache = DeviceCache::getInstance();
 
     // get R device camera parameters id from cache
-    const int rcDeviceCameraParamsId = deviceCache.requestCameraParamsId(tile.rc, _sgmParams.scale, _mp);
+    const int rcDeviceCameraParamsId = deviceCache.requestCameraParamsId(tile.rc, sgmParams.scale, _mp);
 
     // get R device mipmap image from cache
     const DeviceMipmapImage& rcDeviceMipmapImage = deviceCache.requestMipmapImage(tile.rc, _mp);
@@ -231,7 +306,7 @@ void Sgm::computeSimilarityVolumes(const Tile& tile, const SgmDepthList& tileDep
         const Range tcDepthRange(firstDepth, lastDepth);
 
         // get T device camera parameters id from cache
-        const int tcDeviceCameraParamsId = deviceCache.requestCameraParamsId(tc, _sgmParams.scale, _mp);
+        const int tcDeviceCameraParamsId = deviceCache.requestCameraParamsId(tc, sgmParams.scale, _mp);
 
         // get T device mipmap image from cache
         const DeviceMipmapImage& tcDeviceMipmapImage = deviceCache.requestMipmapImage(tc, _mp);
@@ -253,7 +328,7 @@ void Sgm::computeSimilarityVolumes(const Tile& tile, const SgmDepthList& tileDep
                                      tcDeviceCameraParamsId,
                                      rcDeviceMipmapImage,
                                      tcDeviceMipmapImage,
-                                     _sgmParams,
+                                     sgmParams,
                                      tcDepthRange,
                                      downscaledRoi,
                                      _stream);
@@ -272,12 +347,12 @@ void Sgm::computeSimilarityVolumes(const Tile& tile, const SgmDepthList& tileDep
     ALICEVISION_LOG_INFO(tile << "SGM Compute similarity volume done.");
 }
 
-void Sgm::optimizeSimilarityVolume(const Tile& tile, const SgmDepthList& tileDepthList)
+void Sgm::optimizeSimilarityVolume(const Tile& tile, const SgmDepthList& tileDepthList, const SgmParams& sgmParams)
 {
-    ALICEVISION_LOG_INFO(tile << "SGM Optimizing volume (filtering axes: " << _sgmParams.filteringAxes << ").");
+    ALICEVISION_LOG_INFO(tile << "SGM Optimizing volume (filtering axes: " << sgmParams.filteringAxes << ").");
 
     // downscale the region of interest
-    const ROI downscaledRoi = downscaleROI(tile.roi, _sgmParams.scale * _sgmParams.stepXY);
+    const ROI downscaledRoi = downscaleROI(tile.roi, sgmParams.scale * sgmParams.stepXY);
 
     // get R device mipmap image from cache
     DeviceCache& deviceCache = DeviceCache::getInstance();
@@ -289,7 +364,7 @@ void Sgm::optimizeSimilarityVolume(const Tile& tile, const SgmDepthList& tileDep
                         _volumeAxisAcc_dmp,     // axis accumulation buffer pre-allocate
                         _volumeSecBestSim_dmp,  // input volume
                         rcDeviceMipmapImage,
-                        _sgmParams,
+                        sgmParams,
                         tileDepthList.getDepths().size(),
                         downscaledRoi,
                         _stream);
@@ -79,6 +79,17 @@ class Sgm
      */
     void sgmRc(const Tile& tile, const SgmDepthList& tileDepthList);
 
+    /**
+     * @brief Reduce the tile depth list with a first plane sweep pass on a coarse depth list.
+     * @note Only the fine depths around the coarse depths found as best depths in the tile are kept,
+     *       it reduces the similarity volume computation for large depth ranges.
+     *       If coarseToFineLowResolution is enabled, the coarse pass is also computed at a resolution
+     *       downscaled by the coarse-to-fine factor (one coarse depth step is about one low resolution pixel).
+     * @param[in] tile The given tile for SGM computation
+     * @param[in,out] inout_tileDepthList the tile SGM depth list to reduce
+     */
+    void selectCoarseToFineDepths(const Tile& tile, SgmDepthList& inout_tileDepthList);
+
     /**
      * @brief Smooth SGM result thickness map
      * @note Important to be a proper Refine input parameter.
@@ -94,8 +105,9 @@ class Sgm
      * @brief Compute for each RcTc the best / second best similarity volumes.
      * @param[in] tile The given tile for SGM computation
      * @param[in] tileDepthList the tile SGM depth list
+     * @param[in] sgmParams the Semi Global Matching parameters of the pass (downscale)
      */
-    void computeSimilarityVolumes(const Tile& tile, const SgmDepthList& tileDepthList);
+    void computeSimilarityVolumes(const Tile& tile, const SgmDepthList& tileDepthList, const SgmParams& sgmParams);
 
     /**
      * @brief Optimize the given similarity volume.
@@ -103,8 +115,9 @@ class Sgm
      *        So it downweights local minimums that are not supported by their neighborhood.
      * @param[in] tile The given tile for SGM computation
      * @param[in] tileDepthList the tile SGM depth list
+     * @param[in] sgmParams the Semi Global Matching parameters of the pass (downscale)
      */
-    void optimizeSimilarityVolume(const Tile& tile, const SgmDepthList& tileDepthList);
+    void optimizeSimilarityVolume(const Tile& tile, const SgmDepthList& tileDepthList, const SgmParams& sgmParams);
 
     /**
      * @brief Retrieve the best depths in the given similarity volume.
@@ -131,6 +144,7 @@ class Sgm
     const mvsUtils::MultiViewParams& _mp;     //< Multi-view parameters
     const mvsUtils::TileParams& _tileParams;  //< tile workflow parameters
     const SgmParams& _sgmParams;              //< Semi Global Matching parameters
+    SgmParams _coarseSgmParams;               //< coarse-to-fine pass Semi Global Matching parameters
     const bool _computeDepthSimMap;           //< needs to compute a final depth/sim map
     const bool _computeNormalMap;             //< needs to compute a final normal map
 
@@ -146,6 +160,8 @@ class Sgm
     CudaDeviceMemoryPitched<TSimAcc, 2> _volumeSliceAccA_dmp;   //< for optimization: volume accumulation slice A
     CudaDeviceMemoryPitched<TSimAcc, 2> _volumeSliceAccB_dmp;   //< for optimization: volume accumulation slice B
     CudaDeviceMemoryPitched<TSimAcc, 2> _volumeAxisAcc_dmp;     //< for optimization: volume accumulation axis
+    CudaHostMemoryHeap<int, 2> _depthHistogram_hmh;            //< for coarse-to-fine: coarse depths support host memory
+    CudaDeviceMemoryPitched<int, 2> _depthHistogram_dmp;        //< for coarse-to-fine: coarse depths support device memory
     cudaStream_t _stream;                                       //< stream for gpu execution
 };
 
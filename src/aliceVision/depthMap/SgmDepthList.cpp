@@ -14,11 +14,14 @@
 #include <aliceVision/mvsData/OrientedPoint.hpp>
 #include <aliceVision/mvsData/geometry.hpp>
 #include <aliceVision/mvsUtils/common.hpp>
+#include <aliceVision/numeric/numeric.hpp>
 #include <aliceVision/sfmData/SfMData.hpp>
 
 #include <boost/accumulators/accumulators.hpp>
 #include <boost/accumulators/statistics.hpp>
 
+#include <numeric>
+
 namespace aliceVision {
 namespace depthMap {
 
@@ -191,6 +194,101 @@ void SgmDepthList::computeListRc()
     ALICEVISION_LOG_DEBUG(_tile << "Compute SGM depths list done.");
 }
 
+void SgmDepthList::computeCoarseListRc(const SgmDepthList& fineDepthList, int factor)
+{
+    assert(factor > 0);
+
+    // reset member variables
+    _depths.clear();
+    _depthsTcLimits.clear();
+
+    // one depth out of the factor
+    for (std::size_t i = 0; i < fineDepthList._depths.size(); i += factor)
+        _depths.push_back(fineDepthList._depths.at(i));
+
+    // coarse T camera depth limits, enclosing the fine depth limits
+    for (const Pixel& tcLimits : fineDepthList._depthsTcLimits)
+    {
+        if (tcLimits.x == -1 || tcLimits.y == -1)
+        {
+            _depthsTcLimits.push_back(tcLimits);
+            continue;
+        }
+
+        const int first = tcLimits.x / factor;
+        const int last = std::min(divideRoundUp(tcLimits.x + tcLimits.y, factor), int(_depths.size()));
+
+        _depthsTcLimits.emplace_back(first, std::max(1, last - first));
+    }
+
+    ALICEVISION_LOG_DEBUG(_tile << "Compute SGM coarse depths list (factor: " << factor << ", nb depths: " << _depths.size() << ").");
+}
+
+void SgmDepthList::keepCoarseSupportedDepths(int factor, const std::vector<int>& coarseDepthSupport)
+{
+    const int nbSupport = std::accumulate(coarseDepthSupport.begin(), coarseDepthSupport.end(), 0);
+
+    if (nbSupport == 0)
+    {
+        ALICEVISION_LOG_DEBUG(_tile << "No coarse depth supported, keep the full SGM depths list.");
+        return;  // nothing to do
+    }
+
+    const int minSupport = std::max(1, int(std::ceil(nbSupport * _sgmParams.coarseToFineMinSupport)));
+    const int nbDepths = int(_depths.size());
+
+    // keep the fine depths enclosed by the coarse depths around each supported coarse depth
+    std::vector<bool> keepDepth(nbDepths, false);
+
+    for (int c = 0; c < int(coarseDepthSupport.size()); ++c)
+    {
+        if (coarseDepthSupport.at(c) < minSupport)
+            continue;
+
+        const int first = std::max(0, (c - _sgmParams.coarseToFineMargin) * factor);
+        const int last = std::min(nbDepths, (c + _sgmParams.coarseToFineMargin) * factor + 1);
+
+        std::fill(keepDepth.begin() + first, keepDepth.begin() + last, true);
+    }
+
+    // for each fine depth, its index in the reduced depth list (number of kept depths before it)
+    std::vector<int> keptIndexes(nbDepths + 1, 0);
+    std::vector<float> depths;
+
+    for (int i = 0; i < nbDepths; ++i)
+    {
+        keptIndexes.at(i + 1) = keptIndexes.at(i) + (keepDepth.at(i) ? 1 : 0);
+
+        if (keepDepth.at(i))
+            depths.push_back(_depths.at(i));
+    }
+
+    if (depths.empty())
+    {
+        ALICEVISION_LOG_DEBUG(_tile << "No coarse depth with enough support, keep the full SGM depths list.");
+        return;  // nothing to do
+    }
+
+    ALICEVISION_LOG_DEBUG(_tile << "Coarse-to-fine SGM depths list:" << std::endl
+                                << "\t- nb depths: " << nbDepths << std::endl
+                                << "\t- nb selected depths: " << depths.size() << std::endl
+                                << "\t- min coarse depth support: " << minSupport);
+
+    // update depth tc limits
+    for (Pixel& tcLimits : _depthsTcLimits)
+    {
+        if (tcLimits.x == -1 || tcLimits.y == -1)
+            continue;
+
+        const int first = keptIndexes.at(tcLimits.x);
+        const int last = keptIndexes.at(std::min(tcLimits.x + tcLimits.y, nbDepths));
+
+        tcLimits = (last > first) ? Pixel(first, last - first) : Pixel(-1, -1);
+    }
+
+    std::swap(_depths, depths);
+}
+
 void SgmDepthList::removeTcWithNoDepth(Tile& tile)
 {
     assert(tile.rc == _tile.rc);
@@ -46,6 +46,22 @@ class SgmDepthList
      */
     void computeListRc();
 
+    /**
+     * @brief Compute a coarse depth list from a fine depth list, for a first coarse plane sweep pass.
+     * @note The coarse depth list keeps one depth out of the given factor, the T camera depth limits are adjusted.
+     * @param[in] fineDepthList the fine depth list, already computed
+     * @param[in] factor the number of fine depths per coarse depth
+     */
+    void computeCoarseListRc(const SgmDepthList& fineDepthList, int factor);
+
+    /**
+     * @brief Keep only the depths around the coarse depths supported by a coarse plane sweep pass.
+     * @note The T camera depth limits are adjusted, the depth list is kept as is if no coarse depth is supported.
+     * @param[in] factor the number of fine depths per coarse depth
+     * @param[in] coarseDepthSupport the number of tile pixels with their best similarity at each coarse depth
+     */
+    void keepCoarseSupportedDepths(int factor, const std::vector<int>& coarseDepthSupport);
+
     /**
      * @brief Remove tile tcs with no depth
      * @note also remove depthsTcLimits with no depth
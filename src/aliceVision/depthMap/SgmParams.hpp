@@ -36,6 +36,8 @@ struct SgmParams
     bool depthListPerTile = false;
     bool useConsistentScale = false;
     bool useCustomPatchPattern = false;
+    int coarseToFineFactor = 1;
+    bool coarseToFineLowResolution = false;
 
     // intermediate results export parameters
 
@@ -53,6 +55,8 @@ struct SgmParams
     const float prematchingMaxDepthScale = 1.5f;
     const double seedsRangePercentile = 0.999;
     const bool doSgmOptimizeVolume = true;
+    const float coarseToFineMinSupport = 0.001f;  // minimal ratio of the tile pixels supporting a coarse depth
+    const int coarseToFineMargin = 1;             // number of coarse depth steps kept around a supported coarse depth
 };
 
 }  // namespace depthMap
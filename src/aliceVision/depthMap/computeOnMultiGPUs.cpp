@@ -7,12 +7,18 @@
 #include "computeOnMultiGPUs.hpp"
 
 #include <aliceVision/alicevision_omp.hpp>
+#include <aliceVision/system/Logger.hpp>
+#include <aliceVision/system/Timer.hpp>
 #include <aliceVision/depthMap/cuda/host/utils.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <sstream>
+
 namespace aliceVision {
 namespace depthMap {
 
-void computeOnMultiGPUs(const std::vector<int>& cams, IGPUJob& gpujob, int nbGPUsToUse)
+void computeOnMultiGPUs(const std::vector<int>& cams, IGPUJob& gpujob, int nbGPUsToUse, int nbCamsPerChunk)
 {
     const int nbGPUDevices = listCudaDevices();
     const int nbCPUThreads = omp_get_max_threads();
@@ -36,6 +42,21 @@ void computeOnMultiGPUs(const std::vector<int>& cams, IGPUJob& gpujob, int nbGPU
     }
     else
     {
+        // number of cameras pulled at once by a device
+        // small chunks balance the load between heterogeneous devices,
+        // large chunks amortize the device initialization of each job
+        if (nbCamsPerChunk <= 0)
+            nbCamsPerChunk = std::max(1, static_cast<int>(cams.size()) / (nbThreads * 4));
+
+        ALICEVISION_LOG_INFO("Cameras are dispatched to CUDA devices by chunks of " << nbCamsPerChunk << " camera(s).");
+
+        // shared camera queue, each device thread pulls the next chunk when it becomes free
+        std::atomic<std::size_t> nextCamIndex(0);
+
+        // per-device statistics
+        std::vector<std::size_t> nbCamsPerDevice(nbThreads, 0);
+        std::vector<double> elapsedPerDevice(nbThreads, 0.0);
+
         // backup max threads to keep potentially previously set value
         int previous_count_threads = omp_get_max_threads();
         omp_set_num_threads(nbThreads);  // create as many CPU threads as there are CUDA devices
@@ -46,25 +67,37 @@ void computeOnMultiGPUs(const std::vector<int>& cams, IGPUJob& gpujob, int nbGPU
 
             ALICEVISION_LOG_INFO("CPU thread " << cpuThreadId << " (of " << nbThreads << ") uses CUDA device: " << cudaDeviceId);
 
-            const int nbCamsPerThread = (cams.size() / nbThreads);
-            const int rcFrom = cudaDeviceId * nbCamsPerThread;
-            int rcTo = (cudaDeviceId + 1) * nbCamsPerThread;
-            if (cudaDeviceId == nbThreads - 1)
+            const system::Timer timer;
+
+            while (true)
             {
-                rcTo = cams.size();
-            }
+                const std::size_t rcFrom = nextCamIndex.fetch_add(nbCamsPerChunk);
 
-            std::vector<int> subcams;
-            subcams.reserve(cams.size());
+                if (rcFrom >= cams.size())
+                    break;
 
-            for (int rc = rcFrom; rc < rcTo; ++rc)
-            {
-                subcams.push_back(cams[rc]);
+                const std::size_t rcTo = std::min(rcFrom + nbCamsPerChunk, cams.size());
+                const std::vector<int> subcams(cams.begin() + rcFrom, cams.begin() + rcTo);
+
+                gpujob.compute(cudaDeviceId, subcams);
+
+                nbCamsPerDevice.at(cudaDeviceId) += subcams.size();
             }
 
-            gpujob.compute(cudaDeviceId, subcams);
+            elapsedPerDevice.at(cudaDeviceId) = timer.elapsed();
         }
         omp_set_num_threads(previous_count_threads);
+
+        // log per-device throughput
+        std::ostringstream oss;
+        for (int i = 0; i < nbThreads; ++i)
+        {
+            const double elapsed = elapsedPerDevice.at(i);
+            oss << std::endl
+                << "\t- CUDA device " << i << ": " << nbCamsPerDevice.at(i) << " camera(s) in " << system::prettyTime(elapsed * 1000.0) << " ("
+                << ((elapsed > 0.0) ? (nbCamsPerDevice.at(i) * 60.0 / elapsed) : 0.0) << " camera(s) / minute)";
+        }
+        ALICEVISION_LOG_INFO("Multi-GPUs computation statistics:" << oss.str());
     }
 }
 
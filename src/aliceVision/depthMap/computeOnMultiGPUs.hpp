@@ -28,11 +28,15 @@ class IGPUJob
 
 /**
  * @brief Perform computation from the given cameras on multiple GPUs.
+ * @note Cameras are not split in equal ranges per device. Each device pulls the next
+ *       chunk of cameras from a shared queue when it becomes free, so faster devices
+ *       process more cameras on heterogeneous systems.
  * @param[in] cams the given list of cameras
  * @param[in,out] gpujob the object that wrap computation (should use IGPUJob interface)
  * @param[in] nbGPUsToUse the number of GPUs to use
+ * @param[in] nbCamsPerChunk the number of cameras pulled at once by a device (<= 0 for automatic)
  */
-void computeOnMultiGPUs(const std::vector<int>& cams, IGPUJob& gpujob, int nbGPUsToUse);
+void computeOnMultiGPUs(const std::vector<int>& cams, IGPUJob& gpujob, int nbGPUsToUse, int nbCamsPerChunk = -1);
 
 }  // namespace depthMap
 }  // namespace aliceVision
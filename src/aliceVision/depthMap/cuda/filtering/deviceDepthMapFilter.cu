@@ -0,0 +1,116 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "deviceDepthMapFilter.hpp"
+#include "deviceDepthMapFilterKernels.cuh"
+
+#include <aliceVision/depthMap/cuda/host/divUp.hpp>
+
+namespace aliceVision {
+namespace depthMap {
+
+__host__ void cuda_depthMapFilterAccumulateSupport(CudaDeviceMemoryPitched<int, 2>& inout_supportMap_dmp,
+                                                   const CudaDeviceMemoryPitched<float, 2>& in_rcDepthMap_dmp,
+                                                   const CudaDeviceMemoryPitched<float, 2>& in_rcSimMap_dmp,
+                                                   const CudaDeviceMemoryPitched<float, 2>& in_tcDepthMap_dmp,
+                                                   const int rcDeviceCameraParamsId,
+                                                   const int tcDeviceCameraParamsId,
+                                                   const DepthMapFilterParams& filterParams,
+                                                   const int border,
+                                                   cudaStream_t stream)
+{
+    // get R and T maps dimensions
+    const CudaSize<2>& rcMapDim = in_rcDepthMap_dmp.getSize();
+    const CudaSize<2>& tcMapDim = in_tcDepthMap_dmp.getSize();
+
+    // kernel launch parameters
+    const int blockSize = 16;
+    const dim3 block(blockSize, blockSize, 1);
+    const dim3 grid(divUp(tcMapDim.x(), blockSize), divUp(tcMapDim.y(), blockSize), 1);
+
+    // kernel execution
+    depthMapFilterAccumulateSupport_kernel<<<grid, block, 0, stream>>>(
+        inout_supportMap_dmp.getBuffer(),
+        inout_supportMap_dmp.getPitch(),
+        in_rcDepthMap_dmp.getBuffer(),
+        in_rcDepthMap_dmp.getPitch(),
+        in_rcSimMap_dmp.getBuffer(),
+        in_rcSimMap_dmp.getPitch(),
+        in_tcDepthMap_dmp.getBuffer(),
+        in_tcDepthMap_dmp.getPitch(),
+        rcDeviceCameraParamsId,
+        tcDeviceCameraParamsId,
+        (unsigned int)(rcMapDim.x()),
+        (unsigned int)(rcMapDim.y()),
+        (unsigned int)(tcMapDim.x()),
+        (unsigned int)(tcMapDim.y()),
+        border,
+        filterParams.pixToleranceFactor,
+        filterParams.pixSizeBall,
+        filterParams.pixSizeBallWithLowSimilarity);
+
+    // check cuda last error
+    CHECK_CUDA_ERROR();
+}
+
+__host__ void cuda_depthMapFilterCountModals(CudaDeviceMemoryPitched<unsigned char, 2>& inout_modalsMap_dmp,
+                                             const CudaDeviceMemoryPitched<int, 2>& in_supportMap_dmp,
+                                             cudaStream_t stream)
+{
+    // get map dimensions
+    const CudaSize<2>& mapDim = inout_modalsMap_dmp.getSize();
+
+    // kernel launch parameters
+    const int blockSize = 16;
+    const dim3 block(blockSize, blockSize, 1);
+    const dim3 grid(divUp(mapDim.x(), blockSize), divUp(mapDim.y(), blockSize), 1);
+
+    // kernel execution
+    depthMapFilterCountModals_kernel<<<grid, block, 0, stream>>>(
+        inout_modalsMap_dmp.getBuffer(),
+        inout_modalsMap_dmp.getPitch(),
+        in_supportMap_dmp.getBuffer(),
+        in_supportMap_dmp.getPitch(),
+        (unsigned int)(mapDim.x()),
+        (unsigned int)(mapDim.y()));
+
+    // check cuda last error
+    CHECK_CUDA_ERROR();
+}
+
+__host__ void cuda_depthMapFilterApply(CudaDeviceMemoryPitched<float, 2>& inout_depthMap_dmp,
+                                       CudaDeviceMemoryPitched<float, 2>& inout_simMap_dmp,
+                                       const CudaDeviceMemoryPitched<unsigned char, 2>& in_modalsMap_dmp,
+                                       const DepthMapFilterParams& filterParams,
+                                       cudaStream_t stream)
+{
+    // get map dimensions
+    const CudaSize<2>& mapDim = inout_depthMap_dmp.getSize();
+
+    // kernel launch parameters
+    const int blockSize = 16;
+    const dim3 block(blockSize, blockSize, 1);
+    const dim3 grid(divUp(mapDim.x(), blockSize), divUp(mapDim.y(), blockSize), 1);
+
+    // kernel execution
+    depthMapFilterApply_kernel<<<grid, block, 0, stream>>>(
+        inout_depthMap_dmp.getBuffer(),
+        inout_depthMap_dmp.getPitch(),
+        inout_simMap_dmp.getBuffer(),
+        inout_simMap_dmp.getPitch(),
+        in_modalsMap_dmp.getBuffer(),
+        in_modalsMap_dmp.getPitch(),
+        (unsigned int)(mapDim.x()),
+        (unsigned int)(mapDim.y()),
+        filterParams.minNumOfConsistentCams,
+        filterParams.minNumOfConsistentCamsWithLowSimilarity);
+
+    // check cuda last error
+    CHECK_CUDA_ERROR();
+}
+
+}  // namespace depthMap
+}  // namespace aliceVision
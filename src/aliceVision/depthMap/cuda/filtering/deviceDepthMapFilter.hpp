@@ -0,0 +1,63 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/depthMap/DepthMapFilterParams.hpp>
+#include <aliceVision/depthMap/cuda/host/memory.hpp>
+
+namespace aliceVision {
+namespace depthMap {
+
+/**
+ * @brief Accumulate the support of the T camera depth map in the R camera depth map.
+ *        Each T pixel is back-projected and counted in the R pixels of its ball with a consistent depth.
+ * @param[in,out] inout_supportMap_dmp the R camera support count map
+ * @param[in] in_rcDepthMap_dmp the R camera depth map
+ * @param[in] in_rcSimMap_dmp the R camera similarity map
+ * @param[in] in_tcDepthMap_dmp the T camera depth map
+ * @param[in] rcDeviceCameraParamsId the R camera parameters id for array in device constant memory
+ * @param[in] tcDeviceCameraParamsId the T camera parameters id for array in device constant memory
+ * @param[in] filterParams the depth map filtering parameters
+ * @param[in] border the R camera image border (in px)
+ * @param[in] stream the stream for gpu execution
+ */
+extern void cuda_depthMapFilterAccumulateSupport(CudaDeviceMemoryPitched<int, 2>& inout_supportMap_dmp,
+                                                 const CudaDeviceMemoryPitched<float, 2>& in_rcDepthMap_dmp,
+                                                 const CudaDeviceMemoryPitched<float, 2>& in_rcSimMap_dmp,
+                                                 const CudaDeviceMemoryPitched<float, 2>& in_tcDepthMap_dmp,
+                                                 const int rcDeviceCameraParamsId,
+                                                 const int tcDeviceCameraParamsId,
+                                                 const DepthMapFilterParams& filterParams,
+                                                 const int border,
+                                                 cudaStream_t stream);
+
+/**
+ * @brief Increment the number of consistent T cameras of the R pixels with a support.
+ * @param[in,out] inout_modalsMap_dmp the R camera number of consistent T cameras map
+ * @param[in] in_supportMap_dmp the R camera support count map
+ * @param[in] stream the stream for gpu execution
+ */
+extern void cuda_depthMapFilterCountModals(CudaDeviceMemoryPitched<unsigned char, 2>& inout_modalsMap_dmp,
+                                           const CudaDeviceMemoryPitched<int, 2>& in_supportMap_dmp,
+                                           cudaStream_t stream);
+
+/**
+ * @brief Filter the R camera depth/sim maps from the number of consistent T cameras.
+ * @param[in,out] inout_depthMap_dmp the R camera depth map
+ * @param[in,out] inout_simMap_dmp the R camera similarity map
+ * @param[in] in_modalsMap_dmp the R camera number of consistent T cameras map
+ * @param[in] filterParams the depth map filtering parameters
+ * @param[in] stream the stream for gpu execution
+ */
+extern void cuda_depthMapFilterApply(CudaDeviceMemoryPitched<float, 2>& inout_depthMap_dmp,
+                                     CudaDeviceMemoryPitched<float, 2>& inout_simMap_dmp,
+                                     const CudaDeviceMemoryPitched<unsigned char, 2>& in_modalsMap_dmp,
+                                     const DepthMapFilterParams& filterParams,
+                                     cudaStream_t stream);
+
+}  // namespace depthMap
+}  // namespace aliceVision
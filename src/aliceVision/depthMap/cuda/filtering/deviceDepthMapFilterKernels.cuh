@@ -0,0 +1,272 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/depthMap/cuda/device/buffer.cuh>
+#include <aliceVision/depthMap/cuda/device/matrix.cuh>
+#include <aliceVision/depthMap/cuda/device/Patch.cuh>
+#include <aliceVision/depthMap/cuda/device/DeviceCameraParams.hpp>
+
+#include <cfloat>
+
+namespace aliceVision {
+namespace depthMap {
+
+/**
+ * @brief Get the intersections of a 2d line with the image borders.
+ * @note Same as mvsUtils::get2dLineImageIntersection
+ * @param[out] out_from the intersection closest to linePoint1
+ * @param[out] out_to the other intersection
+ * @param[in] linePoint1 the first point of the line
+ * @param[in] linePoint2 the second point of the line
+ * @param[in] width the image width
+ * @param[in] height the image height
+ * @return false if the line doesn't cross the image
+ */
+__device__ inline bool get2dLineImageIntersection(float2& out_from,
+                                                  float2& out_to,
+                                                  const float2& linePoint1,
+                                                  const float2& linePoint2,
+                                                  float width,
+                                                  float height)
+{
+    float2 v = linePoint2 - linePoint1;
+
+    if(size(v) < FLT_EPSILON)
+        return false; // bad configuration ... forward motion with cental ref pixel
+
+    normalize(v);
+
+    // ax + by + c = 0
+    const float a = -v.y;
+    const float b = v.x;
+    const float c = -a * linePoint1.x - b * linePoint1.y;
+
+    float2 intersections[4];
+    int nbIntersections = 0;
+
+    // left side of the image
+    float y = -c / b;
+    if((y >= 0.0f) && (y < height))
+        intersections[nbIntersections++] = make_float2(0.0f, y);
+
+    // right side of the image
+    y = (-c - a * width) / b;
+    if((y >= 0.0f) && (y < height))
+        intersections[nbIntersections++] = make_float2(width, y);
+
+    // top side of the image
+    float x = -c / a;
+    if((x >= 0.0f) && (x < width))
+        intersections[nbIntersections++] = make_float2(x, 0.0f);
+
+    // bottom side of the image
+    x = (-c - b * height) / a;
+    if((x >= 0.0f) && (x < width))
+        intersections[nbIntersections++] = make_float2(x, height);
+
+    if(nbIntersections != 2)
+        return false;
+
+    const bool swap = size(linePoint1 - intersections[0]) > size(linePoint1 - intersections[1]);
+    out_from = intersections[swap ? 1 : 0];
+    out_to = intersections[swap ? 0 : 1];
+    return true;
+}
+
+/**
+ * @brief Get the size in 3d space of a displacement of one pixel along the epipolar line in the T camera.
+ * @note Same as mvsUtils::MultiViewParams::getCamPixelSizeRcTc with an offset of one pixel
+ * @param[in] rcDeviceCamParams the R camera parameters
+ * @param[in] tcDeviceCamParams the T camera parameters
+ * @param[in] p the 3d point
+ * @param[in] tcWidth the T camera image width
+ * @param[in] tcHeight the T camera image height
+ * @return the 3d distance between p and the point triangulated from the displaced T pixel
+ */
+__device__ inline float getCamPixelSizeRcTc(const DeviceCameraParams& rcDeviceCamParams,
+                                            const DeviceCameraParams& tcDeviceCamParams,
+                                            const float3& p,
+                                            int tcWidth,
+                                            int tcHeight)
+{
+    float2 rpix;
+    getPixelFor3DPoint(rpix, rcDeviceCamParams, p);
+
+    float3 refvect = M3x3mulV2(rcDeviceCamParams.iP, rpix);
+    normalize(refvect);
+
+    // epipolar line of the R pixel in the T camera
+    const float d = size(rcDeviceCamParams.C - tcDeviceCamParams.C);
+
+    float2 tarpix1;
+    float2 tarpix2;
+    getPixelFor3DPoint(tarpix1, tcDeviceCamParams, refvect * d + rcDeviceCamParams.C);
+    getPixelFor3DPoint(tarpix2, tcDeviceCamParams, refvect * (d * 500.0f) + rcDeviceCamParams.C);
+
+    float2 pFromTar;
+    float2 pToTar;
+    if(!get2dLineImageIntersection(pFromTar, pToTar, tarpix1, tarpix2, float(tcWidth), float(tcHeight)))
+    {
+        pFromTar = tarpix1;
+        pToTar = tarpix2;
+    }
+
+    // vector of one pixel length on the epipolar line in the T camera
+    float2 pixelVect = pToTar - pFromTar;
+    normalize(pixelVect);
+
+    float2 tpix;
+    getPixelFor3DPoint(tpix, tcDeviceCamParams, p);
+
+    float3 tarvect = M3x3mulV2(tcDeviceCamParams.iP, tpix + pixelVect);
+    normalize(tarvect);
+
+    // parallel rays, fallback to the pixel size in the R camera only
+    const float cosAngle = dot(refvect, tarvect);
+    if(1.0f - cosAngle * cosAngle < FLT_EPSILON)
+        return computePixSize(rcDeviceCamParams, p);
+
+    float k;
+    float l;
+    float3 lli1;
+    float3 lli2;
+    const float3 s = lineLineIntersect(&k, &l, &lli1, &lli2,
+                                       rcDeviceCamParams.C, rcDeviceCamParams.C + refvect,
+                                       tcDeviceCamParams.C, tcDeviceCamParams.C + tarvect);
+    return size(p - s);
+}
+
+__global__ void depthMapFilterAccumulateSupport_kernel(int* inout_supportMap_d, int inout_supportMap_p,
+                                                       const float* in_rcDepthMap_d, int in_rcDepthMap_p,
+                                                       const float* in_rcSimMap_d, int in_rcSimMap_p,
+                                                       const float* in_tcDepthMap_d, int in_tcDepthMap_p,
+                                                       const int rcDeviceCameraParamsId,
+                                                       const int tcDeviceCameraParamsId,
+                                                       const unsigned int rcWidth,
+                                                       const unsigned int rcHeight,
+                                                       const unsigned int tcWidth,
+                                                       const unsigned int tcHeight,
+                                                       const int border,
+                                                       const float pixToleranceFactor,
+                                                       const int pixSizeBall,
+                                                       const int pixSizeBallWithLowSimilarity)
+{
+    const unsigned int x = blockIdx.x * blockDim.x + threadIdx.x;
+    const unsigned int y = blockIdx.y * blockDim.y + threadIdx.y;
+
+    if(x >= tcWidth || y >= tcHeight)
+        return;
+
+    const float tcDepth = *get2DBufferAt(in_tcDepthMap_d, in_tcDepthMap_p, x, y);
+
+    if(tcDepth <= 0.0f)
+        return;
+
+    // R and T camera parameters
+    const DeviceCameraParams& rcDeviceCamParams = constantCameraParametersArray_d[rcDeviceCameraParamsId];
+    const DeviceCameraParams& tcDeviceCamParams = constantCameraParametersArray_d[tcDeviceCameraParamsId];
+
+    // T pixel 3d point
+    const float3 p = get3DPointForPixelAndDepthFromRC(tcDeviceCamParams, make_float2(float(x), float(y)), tcDepth);
+
+    // corresponding R pixel
+    float2 rpix;
+    getPixelFor3DPoint(rpix, rcDeviceCamParams, p);
+
+    const int cellX = int(floorf(rpix.x + 0.5f));
+    const int cellY = int(floorf(rpix.y + 0.5f));
+
+    if(cellX < border || cellX >= int(rcWidth) - border || cellY < border || cellY >= int(rcHeight) - border)
+        return;
+
+    const float pixDepth = size(rcDeviceCamParams.C - p);
+
+    // weakly supported R pixel use a specific ball size
+    const float rcSim = *get2DBufferAt(in_rcSimMap_d, in_rcSimMap_p, cellX, cellY);
+    const int d = (rcSim >= 1.0f) ? pixSizeBallWithLowSimilarity : pixSizeBall;
+
+    // average of the pixel size in the R and T cameras
+    const float pixSize = pixToleranceFactor * 0.5f *
+                          (getCamPixelSizeRcTc(rcDeviceCamParams, tcDeviceCamParams, p, int(tcWidth), int(tcHeight)) +
+                           computePixSize(rcDeviceCamParams, p));
+
+    const int xBegin = max(0, cellX - d);
+    const int xEnd = min(int(rcWidth) - 1, cellX + d);
+    const int yBegin = max(0, cellY - d);
+    const int yEnd = min(int(rcHeight) - 1, cellY + d);
+
+    for(int ny = yBegin; ny <= yEnd; ++ny)
+    {
+        for(int nx = xBegin; nx <= xEnd; ++nx)
+        {
+            const float rcDepth = *get2DBufferAt(in_rcDepthMap_d, in_rcDepthMap_p, nx, ny);
+
+            if(fabsf(pixDepth - rcDepth) < pixSize)
+                atomicAdd(get2DBufferAt(inout_supportMap_d, inout_supportMap_p, nx, ny), 1);
+        }
+    }
+}
+
+__global__ void depthMapFilterCountModals_kernel(unsigned char* inout_modalsMap_d, int inout_modalsMap_p,
+                                                 const int* in_supportMap_d, int in_supportMap_p,
+                                                 const unsigned int width,
+                                                 const unsigned int height)
+{
+    const unsigned int x = blockIdx.x * blockDim.x + threadIdx.x;
+    const unsigned int y = blockIdx.y * blockDim.y + threadIdx.y;
+
+    if(x >= width || y >= height)
+        return;
+
+    if(*get2DBufferAt(in_supportMap_d, in_supportMap_p, x, y) > 0)
+        *get2DBufferAt(inout_modalsMap_d, inout_modalsMap_p, x, y) += 1;
+}
+
+__global__ void depthMapFilterApply_kernel(float* inout_depthMap_d, int inout_depthMap_p,
+                                           float* inout_simMap_d, int inout_simMap_p,
+                                           const unsigned char* in_modalsMap_d, int in_modalsMap_p,
+                                           const unsigned int width,
+                                           const unsigned int height,
+                                           const int minNumOfConsistentCams,
+                                           const int minNumOfConsistentCamsWithLowSimilarity)
+{
+    const unsigned int x = blockIdx.x * blockDim.x + threadIdx.x;
+    const unsigned int y = blockIdx.y * blockDim.y + threadIdx.y;
+
+    if(x >= width || y >= height)
+        return;
+
+    float* depth = get2DBufferAt(inout_depthMap_d, inout_depthMap_p, x, y);
+    float* sim = get2DBufferAt(inout_simMap_d, inout_simMap_p, x, y);
+    const int nbModals = int(*get2DBufferAt(in_modalsMap_d, in_modalsMap_p, x, y));
+
+    // masked pixel
+    if(*depth <= -2.0f)
+        return;
+
+    // weakly supported pixel consistent in enough T cameras, make it strongly supported
+    if((nbModals >= minNumOfConsistentCamsWithLowSimilarity - 1) && (*sim >= 1.0f))
+        *sim -= 2.0f;
+
+    // weakly supported pixel must be consistent in at least two T cameras
+    if((nbModals <= 1) && (*sim >= 1.0f))
+    {
+        *depth = -1.0f;
+        *sim = 1.0f;
+    }
+
+    // strongly supported pixel not consistent in the minimal number of T cameras
+    if((nbModals < minNumOfConsistentCams - 1) && (*sim < 1.0f))
+    {
+        *depth = -1.0f;
+        *sim = 1.0f;
+    }
+}
+
+}  // namespace depthMap
+}  // namespace aliceVision
@@ -6,7 +6,9 @@
 
 #include "DeviceCache.hpp"
 
+#include <aliceVision/camera/IntrinsicBase.hpp>
 #include <aliceVision/system/Logger.hpp>
+#include <aliceVision/system/Tracer.hpp>
 #include <aliceVision/depthMap/cuda/host/utils.hpp>
 #include <aliceVision/depthMap/cuda/device/DeviceCameraParams.hpp>
 #include <aliceVision/depthMap/cuda/imageProcessing/deviceGaussianFilter.hpp>
@@ -184,6 +186,8 @@ void DeviceCache::clear()
     // get the current device id
     const int cudaDeviceId = getCudaDeviceId();
 
+    std::lock_guard<std::mutex> lock(_cachePerDeviceMutex);
+
     // find the current SingleDeviceCache
     auto it = _cachePerDevice.find(cudaDeviceId);
 
@@ -197,8 +201,13 @@ void DeviceCache::build(int maxMipmapImages, int maxCameraParams)
     // get the current device id
     const int cudaDeviceId = getCudaDeviceId();
 
+    // allocate the current device cache outside of the lock
+    std::unique_ptr<SingleDeviceCache> deviceCache(new SingleDeviceCache(maxMipmapImages, maxCameraParams));
+
+    std::lock_guard<std::mutex> lock(_cachePerDeviceMutex);
+
     // reset the current device cache
-    _cachePerDevice[cudaDeviceId].reset(new SingleDeviceCache(maxMipmapImages, maxCameraParams));
+    _cachePerDevice[cudaDeviceId] = std::move(deviceCache);
 }
 
 DeviceCache::SingleDeviceCache& DeviceCache::getCurrentDeviceCache()
@@ -206,6 +215,8 @@ DeviceCache::SingleDeviceCache& DeviceCache::getCurrentDeviceCache()
     // get the current device id
     const int cudaDeviceId = getCudaDeviceId();
 
+    std::lock_guard<std::mutex> lock(_cachePerDeviceMutex);
+
     // find the current SingleDeviceCache
     auto it = _cachePerDevice.find(cudaDeviceId);
 
@@ -239,10 +250,15 @@ void DeviceCache::addMipmapImage(int camId,
     // check if the camera is already in cache
     if (!newInsertion)
     {
+        ++currentDeviceCache.nbMipmapHits;
         ALICEVISION_LOG_TRACE("Add mipmap image on device cache: already on cache (id: " << camId << ", view id: " << viewId << ").");
         return;  // nothing to do
     }
 
+    ++currentDeviceCache.nbMipmapMisses;
+
+    ALICEVISION_TRACE_ZONE_CAT("DeviceCache::addMipmapImage", "depthMap");
+
     ALICEVISION_LOG_TRACE("Add mipmap image on device cache (id: " << camId << ", view id: " << viewId << ").");
 
     // get image buffer
@@ -276,8 +292,50 @@ void DeviceCache::addMipmapImage(int camId,
         }
     }
 
+    // source images are undistorted on the device, instead of reading the undistorted images of prepareDenseScene
+    const CudaHostMemoryHeap<float2, 2>* undistortionMap_hmh = nullptr;
+    const camera::IntrinsicBase* intrinsic = mp.getSourceImageIntrinsic(camId);
+    if (intrinsic != nullptr)
+        undistortionMap_hmh = &getUndistortionMap(currentDeviceCache, *intrinsic, imgSize, mp.getOriginalWidth(camId));
+
     DeviceMipmapImage& deviceMipmapImage = *(currentDeviceCache.mipmaps.at(deviceMipmapId));
-    deviceMipmapImage.fill(img_hmh, minDownscale, maxDownscale);
+    deviceMipmapImage.fill(img_hmh, minDownscale, maxDownscale, undistortionMap_hmh);
+}
+
+const CudaHostMemoryHeap<float2, 2>& DeviceCache::getUndistortionMap(SingleDeviceCache& deviceCache,
+                                                                     const camera::IntrinsicBase& intrinsic,
+                                                                     const CudaSize<2>& imgSize,
+                                                                     int originalWidth)
+{
+    std::unique_ptr<CudaHostMemoryHeap<float2, 2>>& map_hmh =
+      deviceCache.undistortionMaps[std::make_tuple(intrinsic.hashValue(), imgSize.x(), imgSize.y())];
+
+    if (map_hmh != nullptr)
+        return *map_hmh;
+
+    ALICEVISION_LOG_TRACE("Build undistortion map on device cache (size: " << imgSize.x() << "x" << imgSize.y() << ").");
+
+    map_hmh = std::make_unique<CudaHostMemoryHeap<float2, 2>>(imgSize);
+
+    // the loaded image may be downscaled, the intrinsic is defined on the original image
+    // note: pixel centers are aligned between the scales
+    const double scale = double(originalWidth) / double(imgSize.x());
+
+#pragma omp parallel for
+    for (int y = 0; y < int(imgSize.y()); ++y)
+    {
+        for (int x = 0; x < int(imgSize.x()); ++x)
+        {
+            const Vec2 undistortedPix((x + 0.5) * scale - 0.5, (y + 0.5) * scale - 0.5);
+            const Vec2 distortedPix = ((intrinsic.getDistortedPixel(undistortedPix).array() + 0.5) / scale - 0.5).matrix();
+
+            float2& pos = (*map_hmh)(x, y);
+            pos.x = float(distortedPix.x());
+            pos.y = float(distortedPix.y());
+        }
+    }
+
+    return *map_hmh;
 }
 
 void DeviceCache::addCameraParams(int camId, int downscale, const mvsUtils::MultiViewParams& mp)
@@ -296,11 +354,14 @@ void DeviceCache::addCameraParams(int camId, int downscale, const mvsUtils::Mult
     // check if the camera is already in cache
     if (!newInsertion)
     {
+        ++currentDeviceCache.nbCameraParamsHits;
         ALICEVISION_LOG_TRACE("Add camera parameters on device cache: already on cache (id: " << camId << ", view id: " << viewId
                                                                                               << ", downscale: " << downscale << ").");
         return;  // nothing to do
     }
 
+    ++currentDeviceCache.nbCameraParamsMisses;
+
     ALICEVISION_LOG_TRACE("Add camera parameters on device cache (id: " << camId << ", view id: " << viewId << ", downscale: " << downscale << ").");
 
     // build host-side device camera parameters struct
@@ -372,5 +433,23 @@ const int DeviceCache::requestCameraParamsId(int camId, int downscale, const mvs
     return deviceCameraParamsId;
 }
 
+void DeviceCache::logStatistics()
+{
+    // get current device cache
+    const SingleDeviceCache& currentDeviceCache = getCurrentDeviceCache();
+
+    const auto hitRate = [](std::size_t nbHits, std::size_t nbMisses) {
+        const std::size_t nbRequests = nbHits + nbMisses;
+        return (nbRequests > 0) ? (100.0 * double(nbHits) / double(nbRequests)) : 0.0;
+    };
+
+    ALICEVISION_LOG_INFO("Device cache statistics (device id: " << getCudaDeviceId() << "):" << std::endl
+                         << "\t- mipmap images: " << currentDeviceCache.nbMipmapMisses << " upload(s), " << currentDeviceCache.nbMipmapHits
+                         << " hit(s) (hit rate: " << hitRate(currentDeviceCache.nbMipmapHits, currentDeviceCache.nbMipmapMisses) << "%)" << std::endl
+                         << "\t- camera parameters: " << currentDeviceCache.nbCameraParamsMisses << " upload(s), "
+                         << currentDeviceCache.nbCameraParamsHits << " hit(s) (hit rate: "
+                         << hitRate(currentDeviceCache.nbCameraParamsHits, currentDeviceCache.nbCameraParamsMisses) << "%)");
+}
+
 }  // namespace depthMap
 }  // namespace aliceVision
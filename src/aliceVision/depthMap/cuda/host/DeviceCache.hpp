@@ -6,7 +6,10 @@
 
 #pragma once
 
+#include <map>
 #include <memory>
+#include <mutex>
+#include <tuple>
 
 #include <aliceVision/mvsUtils/MultiViewParams.hpp>
 #include <aliceVision/mvsUtils/ImagesCache.hpp>
@@ -88,6 +91,11 @@ class DeviceCache
      */
     const int requestCameraParamsId(int camId, int downscale, const mvsUtils::MultiViewParams& mp);
 
+    /**
+     * @brief Log the current gpu device cache hit rates since the cache was built.
+     */
+    void logStatistics();
+
   private:
     // private members
 
@@ -105,8 +113,18 @@ class DeviceCache
         LRUCameraCache cameraParamCache;  //< device camera parameters id cached per (camera id, downscale)
 
         std::vector<std::unique_ptr<DeviceMipmapImage>> mipmaps;  //< cached device mipmap images
+
+        // host-sided undistortion maps of the source images, per (intrinsic hash, width, height)
+        std::map<std::tuple<std::size_t, std::size_t, std::size_t>, std::unique_ptr<CudaHostMemoryHeap<float2, 2>>> undistortionMaps;
+
+        // statistics
+        std::size_t nbMipmapHits = 0;          //< number of mipmap images added already in cache
+        std::size_t nbMipmapMisses = 0;        //< number of mipmap images added and uploaded to the device
+        std::size_t nbCameraParamsHits = 0;    //< number of camera parameters added already in cache
+        std::size_t nbCameraParamsMisses = 0;  //< number of camera parameters added and uploaded to the device
     };
     std::map<int, std::unique_ptr<SingleDeviceCache>> _cachePerDevice;  // <cudaDeviceId, SingleDeviceCachePtr>
+    std::mutex _cachePerDeviceMutex;                                    // protect _cachePerDevice, devices build/clear their cache concurrently
 
     // private methods
 
@@ -121,6 +139,19 @@ class DeviceCache
      * @return SingleDeviceCache
      */
     SingleDeviceCache& getCurrentDeviceCache();
+
+    /**
+     * @brief Get the undistortion map of a source image, computed at the first request.
+     * @param[in,out] deviceCache the SingleDeviceCache holding the maps
+     * @param[in] intrinsic the camera intrinsic with distortion
+     * @param[in] imgSize the loaded image dimensions
+     * @param[in] originalWidth the image width of the intrinsic, the loaded image may be downscaled
+     * @return the distorted position of each pixel of the undistorted image
+     */
+    const CudaHostMemoryHeap<float2, 2>& getUndistortionMap(SingleDeviceCache& deviceCache,
+                                                            const camera::IntrinsicBase& intrinsic,
+                                                            const CudaSize<2>& imgSize,
+                                                            int originalWidth);
 };
 
 }  // namespace depthMap
@@ -0,0 +1,86 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "DeviceGraph.hpp"
+
+#include <aliceVision/system/Logger.hpp>
+#include <aliceVision/depthMap/cuda/host/utils.hpp>
+
+#include <sstream>
+#include <stdexcept>
+#include <cstdio>
+
+namespace aliceVision {
+namespace depthMap {
+
+DeviceGraph::~DeviceGraph()
+{
+    if (_graphExec != nullptr)
+        cudaGraphExecDestroy(_graphExec);
+}
+
+DeviceGraph::DeviceGraph(DeviceGraph&& other) noexcept
+  : _graphExec(other._graphExec)
+{
+    other._graphExec = nullptr;
+}
+
+void DeviceGraph::beginCapture(cudaStream_t stream)
+{
+    // thread local mode: other host threads can still use the CUDA API during the capture
+    CHECK_CUDA_RETURN_ERROR(cudaStreamBeginCapture(stream, cudaStreamCaptureModeThreadLocal));
+}
+
+void DeviceGraph::endCaptureAndLaunch(cudaStream_t stream)
+{
+    cudaGraph_t graph;
+    CHECK_CUDA_RETURN_ERROR(cudaStreamEndCapture(stream, &graph));
+
+    // try to update the previous executable graph with the new parameters
+    // the update fails if the graph topology has changed (e.g. different number of kernels)
+    bool updated = false;
+
+    if (_graphExec != nullptr)
+    {
+#if CUDART_VERSION >= 12000
+        cudaGraphExecUpdateResultInfo resultInfo;
+        updated = (cudaGraphExecUpdate(_graphExec, graph, &resultInfo) == cudaSuccess);
+#else
+        cudaGraphNode_t errorNode;
+        cudaGraphExecUpdateResult updateResult;
+        updated = (cudaGraphExecUpdate(_graphExec, graph, &errorNode, &updateResult) == cudaSuccess);
+#endif
+        if (!updated)
+        {
+            // clear the update error
+            cudaGetLastError();
+            cudaGraphExecDestroy(_graphExec);
+            _graphExec = nullptr;
+        }
+    }
+
+    if (!updated)
+    {
+#if CUDART_VERSION >= 12000
+        const cudaError_t err = cudaGraphInstantiate(&_graphExec, graph, 0);
+#else
+        const cudaError_t err = cudaGraphInstantiate(&_graphExec, graph, nullptr, nullptr, 0);
+#endif
+        if (err != cudaSuccess)
+        {
+            cudaGraphDestroy(graph);
+            CHECK_CUDA_RETURN_ERROR(err);
+        }
+    }
+
+    // the executable graph does not depend on the graph
+    cudaGraphDestroy(graph);
+
+    CHECK_CUDA_RETURN_ERROR(cudaGraphLaunch(_graphExec, stream));
+}
+
+}  // namespace depthMap
+}  // namespace aliceVision
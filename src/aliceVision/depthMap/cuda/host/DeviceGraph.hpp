@@ -0,0 +1,76 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <cuda_runtime.h>
+
+namespace aliceVision {
+namespace depthMap {
+
+/**
+ * @class Device graph
+ * @brief Small class allowing to replay a sequence of kernel launches as a single CUDA graph.
+ * @note The sequence is captured at each call and the executable graph is updated in place
+ *       when possible, so consecutive calls with different parameters (tile, camera, ...)
+ *       pay neither the per-kernel launch overhead nor the graph instantiation cost.
+ */
+class DeviceGraph
+{
+  public:
+    // default constructor
+    DeviceGraph() = default;
+
+    // destructor
+    ~DeviceGraph();
+
+    // this class handles unique data, a copy starts with no executable graph
+    DeviceGraph(DeviceGraph const&) {}
+
+    // this class handles unique data, no copy operator
+    void operator=(DeviceGraph const&) = delete;
+
+    // move constructor
+    DeviceGraph(DeviceGraph&& other) noexcept;
+
+    /**
+     * @brief Capture the given launch sequence on the given stream and launch it as a graph.
+     * @note The legacy default stream cannot be captured, in this case the launch sequence is executed directly.
+     * @param[in] launchSequence the function that launches the kernels on the given stream
+     * @param[in] stream the stream for gpu execution
+     */
+    template<typename LaunchSequenceT>
+    void launch(LaunchSequenceT&& launchSequence, cudaStream_t stream)
+    {
+        if (stream == 0)
+        {
+            launchSequence();
+            return;
+        }
+
+        beginCapture(stream);
+        launchSequence();
+        endCaptureAndLaunch(stream);
+    }
+
+  private:
+    /**
+     * @brief Start the launch sequence capture on the given stream.
+     * @param[in] stream the stream for gpu execution
+     */
+    void beginCapture(cudaStream_t stream);
+
+    /**
+     * @brief Stop the launch sequence capture, update or instantiate the executable graph and launch it.
+     * @param[in] stream the stream for gpu execution
+     */
+    void endCaptureAndLaunch(cudaStream_t stream);
+
+    cudaGraphExec_t _graphExec = nullptr;  //< executable graph, kept between calls
+};
+
+}  // namespace depthMap
+}  // namespace aliceVision
@@ -0,0 +1,170 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "DeviceMemoryPool.hpp"
+
+#include <aliceVision/system/Logger.hpp>
+
+#include <algorithm>
+
+namespace aliceVision {
+namespace depthMap {
+
+DeviceMemoryPool& DeviceMemoryPool::get()
+{
+    static DeviceMemoryPool* pool = new DeviceMemoryPool();
+    return *pool;
+}
+
+cudaError_t DeviceMemoryPool::allocate(void** ptr, std::size_t& pitch, std::size_t widthBytes, std::size_t height, std::size_t depth)
+{
+    int device = 0;
+    cudaGetDevice(&device);
+    const Shape shape(device, widthBytes, height, depth);
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    Stats& stats = _stats[device];
+
+    // reuse a cached block: the first one whose release is done, or the oldest one (waiting for its release)
+    auto freeIt = _freeBlocks.find(shape);
+    if (freeIt != _freeBlocks.end() && !freeIt->second.empty())
+    {
+        std::vector<std::pair<void*, Block>>& blocks = freeIt->second;
+        auto blockIt = std::find_if(blocks.begin(), blocks.end(), [](const std::pair<void*, Block>& block) {
+            return cudaEventQuery(block.second.released) == cudaSuccess;
+        });
+        if (blockIt == blocks.end())
+        {
+            blockIt = blocks.begin();
+            cudaEventSynchronize(blockIt->second.released);
+        }
+
+        *ptr = blockIt->first;
+        pitch = blockIt->second.pitch;
+        stats.cachedBytes -= blockIt->second.bytes;
+        stats.usedBytes += blockIt->second.bytes;
+        stats.peakUsedBytes = std::max(stats.peakUsedBytes, stats.usedBytes);
+        ++stats.nbReused;
+        _usedBlocks.emplace(blockIt->first, blockIt->second);
+        blocks.erase(blockIt);
+        return cudaSuccess;
+    }
+    lock.unlock();
+
+    const auto deviceAllocate = [&]() -> cudaError_t {
+        if (depth == 0)
+            return cudaMallocPitch(ptr, &pitch, widthBytes, height);
+
+        cudaPitchedPtr pitchDevPtr;
+        const cudaError_t err = cudaMalloc3D(&pitchDevPtr, make_cudaExtent(widthBytes, height, depth));
+        *ptr = pitchDevPtr.ptr;
+        pitch = pitchDevPtr.pitch;
+        return err;
+    };
+
+    cudaError_t err = deviceAllocate();
+    if (err == cudaErrorMemoryAllocation)
+    {
+        // the cached blocks of other shapes may fragment the device memory
+        cudaGetLastError();
+        releaseDevice(device);
+        err = deviceAllocate();
+    }
+    if (err != cudaSuccess)
+        return err;
+
+    Block block;
+    block.shape = shape;
+    block.pitch = pitch;
+    block.bytes = pitch * height * std::max<std::size_t>(depth, 1);
+
+    lock.lock();
+    stats.usedBytes += block.bytes;
+    stats.peakUsedBytes = std::max(stats.peakUsedBytes, stats.usedBytes);
+    ++stats.nbAllocated;
+    _usedBlocks.emplace(*ptr, block);
+    return cudaSuccess;
+}
+
+cudaError_t DeviceMemoryPool::free(void* ptr)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto usedIt = _usedBlocks.find(ptr);
+    if (usedIt == _usedBlocks.end())
+        return cudaFree(ptr);
+
+    Block block = usedIt->second;
+    _usedBlocks.erase(usedIt);
+
+    Stats& stats = _stats[std::get<0>(block.shape)];
+    stats.usedBytes -= block.bytes;
+
+    // the block is reused once the work already issued on the device is done
+    // (the legacy default stream waits for the other blocking streams)
+    cudaError_t err = cudaSuccess;
+    if (block.released == nullptr)
+        err = cudaEventCreateWithFlags(&block.released, cudaEventDisableTiming);
+    if (err == cudaSuccess)
+        err = cudaEventRecord(block.released, 0);
+    if (err != cudaSuccess)
+    {
+        if (block.released != nullptr)
+            cudaEventDestroy(block.released);
+        return cudaFree(ptr);
+    }
+
+    stats.cachedBytes += block.bytes;
+    _freeBlocks[block.shape].emplace_back(ptr, block);
+    return cudaSuccess;
+}
+
+void DeviceMemoryPool::release()
+{
+    int device = 0;
+    cudaGetDevice(&device);
+    releaseDevice(device);
+}
+
+void DeviceMemoryPool::releaseDevice(int device)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    for (auto it = _freeBlocks.begin(); it != _freeBlocks.end();)
+    {
+        if (std::get<0>(it->first) != device)
+        {
+            ++it;
+            continue;
+        }
+        for (std::pair<void*, Block>& block : it->second)
+        {
+            cudaEventDestroy(block.second.released);
+            cudaFree(block.first);
+        }
+        it = _freeBlocks.erase(it);
+    }
+
+    Stats& stats = _stats[device];
+    if (stats.cachedBytes > 0)
+        ALICEVISION_LOG_DEBUG("Device memory pool: release " << stats.cachedBytes / (1024 * 1024) << " MB of cached buffers on device " << device
+                                                             << " (peak used: " << stats.peakUsedBytes / (1024 * 1024) << " MB, "
+                                                             << stats.nbReused << " reused / " << stats.nbAllocated << " allocated buffers).");
+    stats.cachedBytes = 0;
+}
+
+DeviceMemoryPool::Stats DeviceMemoryPool::getStats() const
+{
+    int device = 0;
+    cudaGetDevice(&device);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _stats.find(device);
+    return (it != _stats.end()) ? it->second : Stats();
+}
+
+}  // namespace depthMap
+}  // namespace aliceVision
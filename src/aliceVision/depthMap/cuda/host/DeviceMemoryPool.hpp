@@ -0,0 +1,110 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <cuda_runtime.h>
+
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace aliceVision {
+namespace depthMap {
+
+/**
+ * @class Device memory pool
+ * @brief Process-wide caching pool of the pitched device allocations (CudaDeviceMemoryPitched).
+ *
+ * The freed buffers are kept per device and per shape (row bytes, height, depth) and given back to the next allocations
+ * of the same shape, so that the tiles and cameras loops do not allocate and free (with an implicit device synchronization)
+ * the same buffers again and again.
+ * A freed buffer is only reused once the device work issued before its release is done (event on the legacy default stream).
+ * When an allocation fails, the cached buffers of the device are released and the allocation is retried.
+ * The calls are thread safe.
+ */
+class DeviceMemoryPool
+{
+  public:
+    struct Stats
+    {
+        std::size_t usedBytes = 0;      //< bytes of the buffers in use
+        std::size_t cachedBytes = 0;    //< bytes of the free buffers kept by the pool
+        std::size_t peakUsedBytes = 0;  //< peak of the bytes of the buffers in use
+        std::size_t nbReused = 0;       //< number of allocations served from the cache
+        std::size_t nbAllocated = 0;    //< number of device allocations
+    };
+
+    /**
+     * @brief Get the device memory pool.
+     * @return the device memory pool singleton
+     */
+    static DeviceMemoryPool& get();
+
+    // singleton, no copy constructor
+    DeviceMemoryPool(DeviceMemoryPool const&) = delete;
+
+    // singleton, no copy operator
+    void operator=(DeviceMemoryPool const&) = delete;
+
+    /**
+     * @brief Allocate a pitched buffer on the current device, reusing a cached buffer of the same shape if any.
+     * @param[out] ptr the buffer
+     * @param[out] pitch the buffer pitch (in bytes)
+     * @param[in] widthBytes the bytes of a row
+     * @param[in] height the number of rows
+     * @param[in] depth the number of slices (0 for a 2D allocation with cudaMallocPitch, cudaMalloc3D otherwise)
+     * @return the allocation error
+     */
+    cudaError_t allocate(void** ptr, std::size_t& pitch, std::size_t widthBytes, std::size_t height, std::size_t depth);
+
+    /**
+     * @brief Give a buffer allocated by the pool back to the pool.
+     * @param[in] ptr the buffer
+     * @return the error of the release
+     */
+    cudaError_t free(void* ptr);
+
+    /**
+     * @brief Free the cached buffers of the current device, e.g. at the end of a computation to give the memory back to the other steps.
+     */
+    void release();
+
+    /**
+     * @brief Get the statistics of the current device.
+     */
+    Stats getStats() const;
+
+  private:
+    DeviceMemoryPool() = default;
+
+    // the cached buffers are not freed at exit: the device contexts may already be destroyed
+    ~DeviceMemoryPool() = default;
+
+    /// device, row bytes, height, depth
+    using Shape = std::tuple<int, std::size_t, std::size_t, std::size_t>;
+
+    struct Block
+    {
+        Shape shape;
+        std::size_t pitch = 0;
+        std::size_t bytes = 0;
+        cudaEvent_t released = nullptr;  //< recorded when the block is given back to the pool
+    };
+
+    void releaseDevice(int device);
+
+    mutable std::mutex _mutex;
+    std::unordered_map<void*, Block> _usedBlocks;
+    std::map<Shape, std::vector<std::pair<void*, Block>>> _freeBlocks;  //< in release order
+    std::map<int, Stats> _stats;
+};
+
+}  // namespace depthMap
+}  // namespace aliceVision
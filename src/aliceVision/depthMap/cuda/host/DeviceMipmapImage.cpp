@@ -10,6 +10,7 @@
 #include <aliceVision/depthMap/cuda/imageProcessing/deviceColorConversion.hpp>
 #include <aliceVision/depthMap/cuda/imageProcessing/deviceGaussianFilter.hpp>
 #include <aliceVision/depthMap/cuda/imageProcessing/deviceMipmappedArray.hpp>
+#include <aliceVision/depthMap/cuda/imageProcessing/deviceUndistortion.hpp>
 
 namespace aliceVision {
 namespace depthMap {
@@ -25,7 +26,10 @@ DeviceMipmapImage::~DeviceMipmapImage()
         CHECK_CUDA_RETURN_ERROR_NOEXCEPT(cudaFreeMipmappedArray(_mipmappedArray));
 }
 
-void DeviceMipmapImage::fill(const CudaHostMemoryHeap<CudaRGBA, 2>& in_img_hmh, int minDownscale, int maxDownscale)
+void DeviceMipmapImage::fill(const CudaHostMemoryHeap<CudaRGBA, 2>& in_img_hmh,
+                             int minDownscale,
+                             int maxDownscale,
+                             const CudaHostMemoryHeap<float2, 2>* in_undistortionMap_hmh)
 {
     // update private members
     _minDownscale = minDownscale;
@@ -48,6 +52,26 @@ void DeviceMipmapImage::fill(const CudaHostMemoryHeap<CudaRGBA, 2>& in_img_hmh,
     // copy the host-sided full-size input image buffer onto the device-sided image buffer
     img_dmpPtr->copyFrom(in_img_hmh);
 
+    // undistort the device-sided full-size input image buffer
+    if (in_undistortionMap_hmh != nullptr)
+    {
+        // the undistorted image has the map size
+        _width = in_undistortionMap_hmh->getSize().x();
+        _height = in_undistortionMap_hmh->getSize().y();
+
+        CudaDeviceMemoryPitched<float2, 2> undistortionMap_dmp(in_undistortionMap_hmh->getSize());
+        undistortionMap_dmp.copyFrom(*in_undistortionMap_hmh);
+
+        auto undistortedImg_dmpPtr = std::make_shared<CudaDeviceMemoryPitched<CudaRGBA, 2>>(in_undistortionMap_hmh->getSize());
+        cuda_undistortImage(*undistortedImg_dmpPtr, *img_dmpPtr, undistortionMap_dmp, 0 /*stream*/);
+
+        // wait for undistortion kernel completion
+        CHECK_CUDA_RETURN_ERROR(cudaDeviceSynchronize());
+
+        // use undistorted image buffer as input full-size image buffer
+        img_dmpPtr.swap(undistortedImg_dmpPtr);
+    }
+
     // downscale device-sided full-size input image buffer to min downscale
     if (minDownscale > 1)
     {
@@ -35,8 +35,12 @@ class DeviceMipmapImage
      * @param[in] in_img_hmh the input image buffer in CUDA host memory
      * @param[in] minDownscale the first downscale level of the mipmap image (level 0)
      * @param[in] maxDownscale the last downscale level of the mipmap image
+     * @param[in] in_undistortionMap_hmh the distorted position of each pixel in the input image, to undistort it on the device (optional)
      */
-    void fill(const CudaHostMemoryHeap<CudaRGBA, 2>& in_img_hmh, int minDownscale, int maxDownscale);
+    void fill(const CudaHostMemoryHeap<CudaRGBA, 2>& in_img_hmh,
+              int minDownscale,
+              int maxDownscale,
+              const CudaHostMemoryHeap<float2, 2>* in_undistortionMap_hmh = nullptr);
 
     /**
      * @brief Get the corresponding mipmap image level of the given downscale
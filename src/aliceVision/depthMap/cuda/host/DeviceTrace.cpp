@@ -0,0 +1,148 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "DeviceTrace.hpp"
+
+#include <aliceVision/depthMap/cuda/host/utils.hpp>
+
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace aliceVision {
+namespace depthMap {
+
+namespace {
+
+/**
+ * @brief Timed zone waiting for its events to be resolved
+ */
+struct PendingDeviceZone
+{
+    const char* name;
+    cudaEvent_t beginEvent;
+    cudaEvent_t endEvent;
+};
+
+/**
+ * @brief Per-device trace state
+ * @note The reference event gives the host time origin of the device events.
+ */
+struct DeviceTraceState
+{
+    int trackId = -1;
+    cudaEvent_t referenceEvent = nullptr;
+    std::int64_t referenceUs = 0;
+    std::vector<PendingDeviceZone> pendingZones;
+};
+
+std::mutex deviceTraceMutex;
+std::map<int, DeviceTraceState> deviceTraceStates;
+
+/**
+ * @brief Get the trace state of the given device, initialized at first use.
+ * @note deviceTraceMutex should be locked.
+ */
+DeviceTraceState& getDeviceTraceState(int cudaDeviceId)
+{
+    DeviceTraceState& state = deviceTraceStates[cudaDeviceId];
+
+    if (state.referenceEvent == nullptr)
+    {
+        state.trackId = system::Tracer::get().registerTrack("CUDA device " + std::to_string(cudaDeviceId));
+
+        CHECK_CUDA_RETURN_ERROR(cudaEventCreate(&state.referenceEvent));
+        CHECK_CUDA_RETURN_ERROR(cudaEventRecord(state.referenceEvent));
+        CHECK_CUDA_RETURN_ERROR(cudaEventSynchronize(state.referenceEvent));
+        state.referenceUs = system::Tracer::nowUs();
+    }
+    return state;
+}
+
+}  // namespace
+
+DeviceTraceZone::DeviceTraceZone(const char* name, cudaStream_t stream)
+  : _name(name),
+    _stream(stream)
+{
+    if (!system::Tracer::get().isEnabled())
+        return;
+
+    // initialize the device reference event before any zone event
+    {
+        int cudaDeviceId = 0;
+        CHECK_CUDA_RETURN_ERROR(cudaGetDevice(&cudaDeviceId));
+
+        const std::lock_guard<std::mutex> lock(deviceTraceMutex);
+        getDeviceTraceState(cudaDeviceId);
+    }
+
+    CHECK_CUDA_RETURN_ERROR(cudaEventCreate(&_beginEvent));
+    CHECK_CUDA_RETURN_ERROR(cudaEventRecord(_beginEvent, _stream));
+}
+
+DeviceTraceZone::~DeviceTraceZone()
+{
+    if (_beginEvent == nullptr)
+        return;
+
+    cudaEvent_t endEvent;
+    cudaError_t err = cudaEventCreate(&endEvent);
+    if (err == cudaSuccess)
+        err = cudaEventRecord(endEvent, _stream);
+
+    CHECK_CUDA_RETURN_ERROR_NOEXCEPT(err);
+
+    if (err != cudaSuccess)
+    {
+        cudaEventDestroy(_beginEvent);
+        return;
+    }
+
+    int cudaDeviceId = 0;
+    cudaGetDevice(&cudaDeviceId);
+
+    const std::lock_guard<std::mutex> lock(deviceTraceMutex);
+    deviceTraceStates[cudaDeviceId].pendingZones.push_back({_name, _beginEvent, endEvent});
+}
+
+void flushDeviceTraceZones()
+{
+    int cudaDeviceId = 0;
+    CHECK_CUDA_RETURN_ERROR(cudaGetDevice(&cudaDeviceId));
+
+    const std::lock_guard<std::mutex> lock(deviceTraceMutex);
+
+    const auto it = deviceTraceStates.find(cudaDeviceId);
+    if (it == deviceTraceStates.end() || it->second.pendingZones.empty())
+        return;
+
+    DeviceTraceState& state = it->second;
+
+    for (const PendingDeviceZone& zone : state.pendingZones)
+    {
+        CHECK_CUDA_RETURN_ERROR(cudaEventSynchronize(zone.endEvent));
+
+        float beginMs = 0.f;
+        float durationMs = 0.f;
+        CHECK_CUDA_RETURN_ERROR(cudaEventElapsedTime(&beginMs, state.referenceEvent, zone.beginEvent));
+        CHECK_CUDA_RETURN_ERROR(cudaEventElapsedTime(&durationMs, zone.beginEvent, zone.endEvent));
+
+        const std::int64_t beginUs = state.referenceUs + std::int64_t(beginMs * 1000.0);
+        system::Tracer::get().addTrackZone(state.trackId, zone.name, "gpu", beginUs, beginUs + std::int64_t(durationMs * 1000.0));
+
+        cudaEventDestroy(zone.beginEvent);
+        cudaEventDestroy(zone.endEvent);
+    }
+
+    state.pendingZones.clear();
+}
+
+}  // namespace depthMap
+}  // namespace aliceVision
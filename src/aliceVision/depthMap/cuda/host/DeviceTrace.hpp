@@ -0,0 +1,57 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/system/Tracer.hpp>
+
+#include <cuda_runtime.h>
+
+namespace aliceVision {
+namespace depthMap {
+
+/**
+ * @class Device trace zone
+ * @brief RAII zone timing the GPU work enqueued on a stream with CUDA events.
+ *        The events are only resolved by flushDeviceTraceZones, so the zone never synchronizes the stream.
+ *        Nothing is recorded when the tracer is disabled.
+ */
+class DeviceTraceZone
+{
+  public:
+    /**
+     * @brief DeviceTraceZone constructor.
+     * @param[in] name the zone name, must be a string literal
+     * @param[in] stream the CUDA stream of the timed work
+     */
+    DeviceTraceZone(const char* name, cudaStream_t stream);
+
+    // no copy constructor
+    DeviceTraceZone(DeviceTraceZone const&) = delete;
+
+    // no copy operator
+    void operator=(DeviceTraceZone const&) = delete;
+
+    // destructor
+    ~DeviceTraceZone();
+
+  private:
+    const char* _name;
+    cudaStream_t _stream;
+    cudaEvent_t _beginEvent = nullptr;
+};
+
+/**
+ * @brief Resolve the pending device trace zones of the current device and add them to the tracer.
+ * @note Blocks until the timed work is done, should be called after a device synchronization.
+ */
+void flushDeviceTraceZones();
+
+}  // namespace depthMap
+}  // namespace aliceVision
+
+#define ALICEVISION_DEVICE_TRACE_ZONE(name, stream) \
+    aliceVision::depthMap::DeviceTraceZone ALICEVISION_TRACE_CONCAT(aliceVisionDeviceTraceZone_, __LINE__)(name, stream)
@@ -15,6 +15,7 @@
     #include <cuda_fp16.h>
 #endif
 
+#include <aliceVision/depthMap/cuda/host/DeviceMemoryPool.hpp>
 #include <aliceVision/depthMap/cuda/host/utils.hpp>
 #include <aliceVision/system/Logger.hpp>
 
@@ -479,7 +480,9 @@ class CudaDeviceMemoryPitched : public CudaMemorySizeBase<Type, Dim>
 
         if (Dim == 2)
         {
-            cudaError_t err = cudaMallocPitch<Type>(&buffer, &this->getPitchRef(), this->getUnpaddedBytesInRow(), this->getUnitsInDim(1));
+            void* ptr = nullptr;
+            cudaError_t err = DeviceMemoryPool::get().allocate(&ptr, this->getPitchRef(), this->getUnpaddedBytesInRow(), this->getUnitsInDim(1), 0);
+            buffer = (Type*)ptr;
             if (err != cudaSuccess)
             {
                 int devid;
@@ -493,12 +496,10 @@ class CudaDeviceMemoryPitched : public CudaMemorySizeBase<Type, Dim>
         }
         else if (Dim == 3)
         {
-            cudaExtent extent;
-            extent.width = this->getUnpaddedBytesInRow();
-            extent.height = this->getUnitsInDim(1);
-            extent.depth = this->getUnitsInDim(2);
-            cudaPitchedPtr pitchDevPtr;
-            cudaError_t err = cudaMalloc3D(&pitchDevPtr, extent);
+            void* ptr = nullptr;
+            size_t pitch = 0;
+            cudaError_t err =
+              DeviceMemoryPool::get().allocate(&ptr, pitch, this->getUnpaddedBytesInRow(), this->getUnitsInDim(1), this->getUnitsInDim(2));
             if (err != cudaSuccess)
             {
                 int devid;
@@ -514,11 +515,11 @@ class CudaDeviceMemoryPitched : public CudaMemorySizeBase<Type, Dim>
                 throw std::runtime_error(ss.str());
             }
 
-            buffer = (Type*)pitchDevPtr.ptr;
-            this->setPitch(pitchDevPtr.pitch);
+            buffer = (Type*)ptr;
+            this->setPitch(pitch);
 
             ALICEVISION_LOG_DEBUG("GPU 3D allocation: " << this->getUnitsInDim(0) << "x" << this->getUnitsInDim(1) << "x" << this->getUnitsInDim(2)
-                                                        << ", type size=" << sizeof(Type) << ", pitch=" << pitchDevPtr.pitch);
+                                                        << ", type size=" << sizeof(Type) << ", pitch=" << pitch);
             ALICEVISION_LOG_DEBUG("                 : "
                                   << this->getBytesUnpadded() << ", padded=" << this->getBytesPadded()
                                   << ", wasted=" << this->getBytesPadded() - this->getBytesUnpadded() << ", wasted ratio="
@@ -535,7 +536,7 @@ class CudaDeviceMemoryPitched : public CudaMemorySizeBase<Type, Dim>
         if (buffer == nullptr)
             return;
 
-        cudaError_t err = cudaFree(buffer);
+        cudaError_t err = DeviceMemoryPool::get().free(buffer);
         if (err != cudaSuccess)
         {
             std::stringstream ss;
@@ -0,0 +1,100 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "deviceUndistortion.hpp"
+
+#include <aliceVision/depthMap/cuda/host/divUp.hpp>
+#include <aliceVision/depthMap/cuda/device/buffer.cuh>
+#include <aliceVision/depthMap/cuda/device/operators.cuh>
+
+namespace aliceVision {
+namespace depthMap {
+
+__device__ inline float4 getRGBA(const CudaRGBA* in_img_d, unsigned int in_img_p, int x, int y)
+{
+    const CudaRGBA& rgba = *get2DBufferAt(in_img_d, in_img_p, x, y);
+    return make_float4(float(rgba.x), float(rgba.y), float(rgba.z), float(rgba.w));
+}
+
+__global__ void undistortImage_kernel(CudaRGBA* out_img_d,
+                                      unsigned int out_img_p,
+                                      const CudaRGBA* in_img_d,
+                                      unsigned int in_img_p,
+                                      const float2* in_map_d,
+                                      unsigned int in_map_p,
+                                      unsigned int width,
+                                      unsigned int height,
+                                      unsigned int inWidth,
+                                      unsigned int inHeight)
+{
+    const unsigned int x = blockIdx.x * blockDim.x + threadIdx.x;
+    const unsigned int y = blockIdx.y * blockDim.y + threadIdx.y;
+
+    if((x >= width) || (y >= height))
+        return;
+
+    const float2 pos = *get2DBufferAt(in_map_d, in_map_p, x, y);
+    CudaRGBA* out = get2DBufferAt(out_img_d, out_img_p, x, y);
+
+    // same domain as camera::UndistortImage
+    if(!(pos.x > -1.f && pos.x < float(inWidth) && pos.y > -1.f && pos.y < float(inHeight)))
+    {
+        out->x = 0.f;
+        out->y = 0.f;
+        out->z = 0.f;
+        out->w = 0.f;
+        return;
+    }
+
+    // bilinear interpolation, clamped on the image borders
+    const int x0 = int(floorf(pos.x));
+    const int y0 = int(floorf(pos.y));
+    const float wx = pos.x - float(x0);
+    const float wy = pos.y - float(y0);
+
+    const int xa = max(x0, 0);
+    const int ya = max(y0, 0);
+    const int xb = min(x0 + 1, int(inWidth) - 1);
+    const int yb = min(y0 + 1, int(inHeight) - 1);
+
+    const float4 top = getRGBA(in_img_d, in_img_p, xa, ya) * (1.f - wx) + getRGBA(in_img_d, in_img_p, xb, ya) * wx;
+    const float4 bottom = getRGBA(in_img_d, in_img_p, xa, yb) * (1.f - wx) + getRGBA(in_img_d, in_img_p, xb, yb) * wx;
+    const float4 rgba = top * (1.f - wy) + bottom * wy;
+
+    out->x = rgba.x;
+    out->y = rgba.y;
+    out->z = rgba.z;
+    out->w = rgba.w;
+}
+
+__host__ void cuda_undistortImage(CudaDeviceMemoryPitched<CudaRGBA, 2>& out_img_dmp,
+                                  const CudaDeviceMemoryPitched<CudaRGBA, 2>& in_img_dmp,
+                                  const CudaDeviceMemoryPitched<float2, 2>& in_map_dmp,
+                                  cudaStream_t stream)
+{
+    // kernel launch parameters
+    const dim3 block(32, 2, 1);
+    const dim3 grid(divUp(out_img_dmp.getSize().x(), block.x), divUp(out_img_dmp.getSize().y(), block.y), 1);
+
+    // undistort with the lookup map
+    undistortImage_kernel<<<grid, block, 0, stream>>>(
+        out_img_dmp.getBuffer(),
+        (unsigned int)out_img_dmp.getPitch(),
+        in_img_dmp.getBuffer(),
+        (unsigned int)in_img_dmp.getPitch(),
+        in_map_dmp.getBuffer(),
+        (unsigned int)in_map_dmp.getPitch(),
+        (unsigned int)out_img_dmp.getSize().x(),
+        (unsigned int)out_img_dmp.getSize().y(),
+        (unsigned int)in_img_dmp.getSize().x(),
+        (unsigned int)in_img_dmp.getSize().y());
+
+    // check cuda last error
+    CHECK_CUDA_ERROR();
+}
+
+} // namespace depthMap
+} // namespace aliceVision
@@ -0,0 +1,28 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/depthMap/cuda/host/memory.hpp>
+
+namespace aliceVision {
+namespace depthMap {
+
+/**
+ * @brief Undistort an image with a lookup map using CUDA.
+ * @note The pixels whose distorted position is outside of the input image are set to zero (alpha included).
+ * @param[out] out_img_dmp the output undistorted image buffer in device memory, of the map size
+ * @param[in] in_img_dmp the input distorted image buffer in device memory
+ * @param[in] in_map_dmp the distorted position (x, y) in the input image of each output pixel, in device memory
+ * @param[in] stream the CUDA stream for gpu execution
+ */
+extern void cuda_undistortImage(CudaDeviceMemoryPitched<CudaRGBA, 2>& out_img_dmp,
+                                const CudaDeviceMemoryPitched<CudaRGBA, 2>& in_img_dmp,
+                                const CudaDeviceMemoryPitched<float2, 2>& in_map_dmp,
+                                cudaStream_t stream);
+
+}  // namespace depthMap
+}  // namespace aliceVision
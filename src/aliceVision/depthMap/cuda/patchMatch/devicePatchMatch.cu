@@ -0,0 +1,149 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "devicePatchMatch.hpp"
+#include "devicePatchMatchKernels.cuh"
+
+#include <aliceVision/depthMap/cuda/host/divUp.hpp>
+
+#include <cmath>
+
+namespace aliceVision {
+namespace depthMap {
+
+__host__ void cuda_patchMatchInitialize(CudaDeviceMemoryPitched<float2, 2>& out_depthSimMap_dmp,
+                                        CudaDeviceMemoryPitched<float3, 2>& out_normalMap_dmp,
+                                        const int rcDeviceCameraParamsId,
+                                        const DeviceMipmapImage& rcDeviceMipmapImage,
+                                        const DevicePatchMatchTCams& tCams,
+                                        const PatchMatchParams& patchMatchParams,
+                                        const float minDepth,
+                                        const float maxDepth,
+                                        const ROI& roi,
+                                        cudaStream_t stream)
+{
+    // get R mipmap image level and dimensions
+    const float rcMipmapLevel = rcDeviceMipmapImage.getLevel(patchMatchParams.scale);
+    const CudaSize<2> rcLevelDim = rcDeviceMipmapImage.getDimensions(patchMatchParams.scale);
+
+    // kernel launch parameters
+    const int blockSize = 16;
+    const dim3 block(blockSize, blockSize, 1);
+    const dim3 grid(divUp(roi.width(), blockSize), divUp(roi.height(), blockSize), 1);
+
+    // kernel execution
+    patchMatch_initialize_kernel<<<grid, block, 0, stream>>>(
+        out_depthSimMap_dmp.getBuffer(),
+        out_depthSimMap_dmp.getPitch(),
+        out_normalMap_dmp.getBuffer(),
+        out_normalMap_dmp.getPitch(),
+        rcDeviceCameraParamsId,
+        rcDeviceMipmapImage.getTextureObject(),
+        (unsigned int)(rcLevelDim.x()),
+        (unsigned int)(rcLevelDim.y()),
+        tCams,
+        rcMipmapLevel,
+        patchMatchParams.stepXY,
+        patchMatchParams.wsh,
+        (1.f / float(patchMatchParams.gammaC)), // inverted gammaC
+        (1.f / float(patchMatchParams.gammaP)), // inverted gammaP
+        patchMatchParams.useConsistentScale,
+        patchMatchParams.useCustomPatchPattern,
+        minDepth,
+        maxDepth,
+        patchMatchParams.randomSeed,
+        roi);
+
+    // check cuda last error
+    CHECK_CUDA_ERROR();
+}
+
+__host__ void cuda_patchMatchIterate(CudaDeviceMemoryPitched<float2, 2>& inout_depthSimMap_dmp,
+                                     CudaDeviceMemoryPitched<float3, 2>& inout_normalMap_dmp,
+                                     const int rcDeviceCameraParamsId,
+                                     const DeviceMipmapImage& rcDeviceMipmapImage,
+                                     const DevicePatchMatchTCams& tCams,
+                                     const PatchMatchParams& patchMatchParams,
+                                     const float minDepth,
+                                     const float maxDepth,
+                                     const int iteration,
+                                     const ROI& roi,
+                                     cudaStream_t stream)
+{
+    // get R mipmap image level and dimensions
+    const float rcMipmapLevel = rcDeviceMipmapImage.getLevel(patchMatchParams.scale);
+    const CudaSize<2> rcLevelDim = rcDeviceMipmapImage.getDimensions(patchMatchParams.scale);
+
+    // random refinement perturbation range at this iteration
+    const float decay = std::pow(patchMatchParams.perturbationDecay, float(iteration));
+    const float depthPerturbation = patchMatchParams.depthPerturbation * decay;
+    const float normalPerturbation = patchMatchParams.normalPerturbation * decay;
+
+    // kernel launch parameters
+    // note: each thread handles one pixel of a pair of columns
+    const int blockSize = 16;
+    const dim3 block(blockSize, blockSize, 1);
+    const dim3 grid(divUp(divUp(roi.width(), 2), blockSize), divUp(roi.height(), blockSize), 1);
+
+    // red-black passes, the pixels of one color being updated from the pixels of the other color
+    for(int parity = 0; parity < 2; ++parity)
+    {
+        // kernel execution
+        patchMatch_propagateAndRefine_kernel<<<grid, block, 0, stream>>>(
+            inout_depthSimMap_dmp.getBuffer(),
+            inout_depthSimMap_dmp.getPitch(),
+            inout_normalMap_dmp.getBuffer(),
+            inout_normalMap_dmp.getPitch(),
+            rcDeviceCameraParamsId,
+            rcDeviceMipmapImage.getTextureObject(),
+            (unsigned int)(rcLevelDim.x()),
+            (unsigned int)(rcLevelDim.y()),
+            tCams,
+            rcMipmapLevel,
+            patchMatchParams.stepXY,
+            patchMatchParams.wsh,
+            (1.f / float(patchMatchParams.gammaC)), // inverted gammaC
+            (1.f / float(patchMatchParams.gammaP)), // inverted gammaP
+            patchMatchParams.useConsistentScale,
+            patchMatchParams.useCustomPatchPattern,
+            minDepth,
+            maxDepth,
+            patchMatchParams.nbRandomRefinements,
+            depthPerturbation,
+            normalPerturbation,
+            iteration,
+            parity,
+            patchMatchParams.randomSeed,
+            roi);
+
+        // check cuda last error
+        CHECK_CUDA_ERROR();
+    }
+}
+
+__host__ void cuda_patchMatchFinalize(CudaDeviceMemoryPitched<float2, 2>& inout_depthSimMap_dmp,
+                                      const PatchMatchParams& patchMatchParams,
+                                      const ROI& roi,
+                                      cudaStream_t stream)
+{
+    // kernel launch parameters
+    const int blockSize = 16;
+    const dim3 block(blockSize, blockSize, 1);
+    const dim3 grid(divUp(roi.width(), blockSize), divUp(roi.height(), blockSize), 1);
+
+    // kernel execution
+    patchMatch_finalize_kernel<<<grid, block, 0, stream>>>(
+        inout_depthSimMap_dmp.getBuffer(),
+        inout_depthSimMap_dmp.getPitch(),
+        float(patchMatchParams.maxSimilarity),
+        roi);
+
+    // check cuda last error
+    CHECK_CUDA_ERROR();
+}
+
+}  // namespace depthMap
+}  // namespace aliceVision
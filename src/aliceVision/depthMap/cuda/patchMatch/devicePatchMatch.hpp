@@ -0,0 +1,92 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/mvsData/ROI.hpp>
+#include <aliceVision/depthMap/PatchMatchParams.hpp>
+#include <aliceVision/depthMap/cuda/host/memory.hpp>
+#include <aliceVision/depthMap/cuda/host/DeviceMipmapImage.hpp>
+
+namespace aliceVision {
+namespace depthMap {
+
+/**
+ * @brief T cameras of a PatchMatch tile, passed by value to the kernels.
+ */
+struct DevicePatchMatchTCams
+{
+    int nbTCams = 0;
+    int deviceCameraParamsIds[ALICEVISION_DEVICE_PATCHMATCH_MAX_TCAMS];
+    cudaTextureObject_t mipmapImage_tex[ALICEVISION_DEVICE_PATCHMATCH_MAX_TCAMS];
+    unsigned int levelWidth[ALICEVISION_DEVICE_PATCHMATCH_MAX_TCAMS];
+    unsigned int levelHeight[ALICEVISION_DEVICE_PATCHMATCH_MAX_TCAMS];
+};
+
+/**
+ * @brief Initialize the depth/sim map and the normal map with random hypotheses.
+ * @param[out] out_depthSimMap_dmp the output depth/sim map
+ * @param[out] out_normalMap_dmp the output normal map
+ * @param[in] rcDeviceCameraParamsId the R camera parameters id for array in device constant memory
+ * @param[in] rcDeviceMipmapImage the R camera device mipmap image
+ * @param[in] tCams the T cameras
+ * @param[in] patchMatchParams the PatchMatch parameters
+ * @param[in] minDepth the minimum plane depth of the tile
+ * @param[in] maxDepth the maximum plane depth of the tile
+ * @param[in] roi the 2d region of interest
+ * @param[in] stream the stream for gpu execution
+ */
+extern void cuda_patchMatchInitialize(CudaDeviceMemoryPitched<float2, 2>& out_depthSimMap_dmp,
+                                      CudaDeviceMemoryPitched<float3, 2>& out_normalMap_dmp,
+                                      const int rcDeviceCameraParamsId,
+                                      const DeviceMipmapImage& rcDeviceMipmapImage,
+                                      const DevicePatchMatchTCams& tCams,
+                                      const PatchMatchParams& patchMatchParams,
+                                      const float minDepth,
+                                      const float maxDepth,
+                                      const ROI& roi,
+                                      cudaStream_t stream);
+
+/**
+ * @brief Run one PatchMatch iteration: red-black propagation of the neighbor planes and random refinement.
+ * @param[in,out] inout_depthSimMap_dmp the depth/sim map
+ * @param[in,out] inout_normalMap_dmp the normal map
+ * @param[in] rcDeviceCameraParamsId the R camera parameters id for array in device constant memory
+ * @param[in] rcDeviceMipmapImage the R camera device mipmap image
+ * @param[in] tCams the T cameras
+ * @param[in] patchMatchParams the PatchMatch parameters
+ * @param[in] minDepth the minimum plane depth of the tile
+ * @param[in] maxDepth the maximum plane depth of the tile
+ * @param[in] iteration the iteration index
+ * @param[in] roi the 2d region of interest
+ * @param[in] stream the stream for gpu execution
+ */
+extern void cuda_patchMatchIterate(CudaDeviceMemoryPitched<float2, 2>& inout_depthSimMap_dmp,
+                                   CudaDeviceMemoryPitched<float3, 2>& inout_normalMap_dmp,
+                                   const int rcDeviceCameraParamsId,
+                                   const DeviceMipmapImage& rcDeviceMipmapImage,
+                                   const DevicePatchMatchTCams& tCams,
+                                   const PatchMatchParams& patchMatchParams,
+                                   const float minDepth,
+                                   const float maxDepth,
+                                   const int iteration,
+                                   const ROI& roi,
+                                   cudaStream_t stream);
+
+/**
+ * @brief Invalidate the depths with a similarity worse than the PatchMatch maximum similarity.
+ * @param[in,out] inout_depthSimMap_dmp the depth/sim map
+ * @param[in] patchMatchParams the PatchMatch parameters
+ * @param[in] roi the 2d region of interest
+ * @param[in] stream the stream for gpu execution
+ */
+extern void cuda_patchMatchFinalize(CudaDeviceMemoryPitched<float2, 2>& inout_depthSimMap_dmp,
+                                    const PatchMatchParams& patchMatchParams,
+                                    const ROI& roi,
+                                    cudaStream_t stream);
+
+}  // namespace depthMap
+}  // namespace aliceVision
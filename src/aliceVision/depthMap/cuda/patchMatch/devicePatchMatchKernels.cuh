@@ -0,0 +1,401 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/depthMap/cuda/device/buffer.cuh>
+#include <aliceVision/depthMap/cuda/device/matrix.cuh>
+#include <aliceVision/depthMap/cuda/device/Patch.cuh>
+#include <aliceVision/depthMap/cuda/device/DeviceCameraParams.hpp>
+#include <aliceVision/depthMap/cuda/patchMatch/devicePatchMatch.hpp>
+
+#include <math_constants.h>
+
+namespace aliceVision {
+namespace depthMap {
+
+/**
+ * @brief Get a pseudo-random number in [0, 1) from a counter-based hash.
+ * @note Stateless, each pixel / iteration / draw gives its own seed.
+ * @param[in,out] state the random state, updated at each draw
+ * @return uniform random value in [0, 1)
+ */
+__device__ inline float patchMatch_random(unsigned int& state)
+{
+    // PCG hash
+    state = state * 747796405u + 2891336453u;
+    unsigned int word = ((state >> ((state >> 28u) + 4u)) ^ state) * 277803737u;
+    word = (word >> 22u) ^ word;
+    return float(word >> 8) * (1.0f / 16777216.0f);
+}
+
+/**
+ * @brief Initialize the random state of a pixel for a given iteration.
+ * @param[in] x the pixel x coordinate
+ * @param[in] y the pixel y coordinate
+ * @param[in] iteration the PatchMatch iteration
+ * @param[in] seed the global random seed
+ * @return the pixel random state
+ */
+__device__ inline unsigned int patchMatch_randomState(unsigned int x, unsigned int y, unsigned int iteration, unsigned int seed)
+{
+    unsigned int state = seed ^ (x * 73856093u) ^ (y * 19349663u) ^ (iteration * 83492791u);
+    patchMatch_random(state);
+    return state;
+}
+
+/**
+ * @brief Get the R camera normalized ray of a pixel.
+ * @param[in] rcDeviceCamParams the R camera parameters
+ * @param[in] pix the R camera pixel
+ * @return the normalized ray direction
+ */
+__device__ inline float3 patchMatch_getRay(const DeviceCameraParams& rcDeviceCamParams, const float2& pix)
+{
+    float3 v = M3x3mulV2(rcDeviceCamParams.iP, pix);
+    normalize(v);
+    return v;
+}
+
+/**
+ * @brief Make the given normal face the R camera along the given ray.
+ * @param[in,out] n the normal
+ * @param[in] ray the R camera normalized ray
+ */
+__device__ inline void patchMatch_faceCamera(float3& n, const float3& ray)
+{
+    normalize(n);
+
+    if(dot(n, ray) > 0.0f)
+        n = n * -1.0f;
+}
+
+/**
+ * @brief Compute the cost of a depth / normal hypothesis of a R camera pixel,
+ *        as the mean similarity of the best half of the T cameras.
+ * @param[in] rcDeviceCamParams the R camera parameters
+ * @param[in] rcMipmapImage_tex the R camera mipmap image texture
+ * @param[in] rcLevelWidth the R camera image width at the PatchMatch mipmap level
+ * @param[in] rcLevelHeight the R camera image height at the PatchMatch mipmap level
+ * @param[in] tCams the T cameras
+ * @param[in] rcMipmapLevel the PatchMatch mipmap level
+ * @param[in] wsh the half-width of the patch
+ * @param[in] invGammaC the inverted strength of grouping by color similarity
+ * @param[in] invGammaP the inverted strength of grouping by proximity
+ * @param[in] useConsistentScale enable consistent scale patch comparison
+ * @param[in] useCustomPatchPattern enable user custom patch pattern
+ * @param[in] ray the R camera pixel normalized ray
+ * @param[in] depth the hypothesis depth along the ray
+ * @param[in] normal the hypothesis normal
+ * @return cost in range (-1.f, 0.f), lower is better or CUDART_INF_F if no T camera is valid
+ */
+__device__ inline float patchMatch_computeCost(const DeviceCameraParams& rcDeviceCamParams,
+                                               const cudaTextureObject_t rcMipmapImage_tex,
+                                               const unsigned int rcLevelWidth,
+                                               const unsigned int rcLevelHeight,
+                                               const DevicePatchMatchTCams& tCams,
+                                               const float rcMipmapLevel,
+                                               const int wsh,
+                                               const float invGammaC,
+                                               const float invGammaP,
+                                               const bool useConsistentScale,
+                                               const bool useCustomPatchPattern,
+                                               const float3& ray,
+                                               const float depth,
+                                               const float3& normal)
+{
+    // we do not need positive and filtered similarity values
+    constexpr bool invertAndFilter = false;
+
+    float sims[ALICEVISION_DEVICE_PATCHMATCH_MAX_TCAMS];
+    int nbValidSims = 0;
+
+    Patch patch;
+    patch.p = rcDeviceCamParams.C + ray * depth;
+    patch.n = normal;
+    patch.d = computePixSize(rcDeviceCamParams, patch.p);
+
+    for(int c = 0; c < tCams.nbTCams; ++c)
+    {
+        const DeviceCameraParams& tcDeviceCamParams = constantCameraParametersArray_d[tCams.deviceCameraParamsIds[c]];
+
+        // patch axes: y orthogonal to the epipolar plane, x on the patch plane
+        {
+            float3 v1 = rcDeviceCamParams.C - patch.p;
+            float3 v2 = tcDeviceCamParams.C - patch.p;
+            normalize(v1);
+            normalize(v2);
+
+            patch.y = cross(v1, v2);
+            normalize(patch.y);
+
+            patch.x = cross(patch.y, patch.n);
+            normalize(patch.x);
+
+            patch.y = cross(patch.n, patch.x);
+        }
+
+        float fsim = CUDART_INF_F;
+
+        if(useCustomPatchPattern)
+        {
+            fsim = compNCCby3DptsYK_customPatchPattern<invertAndFilter>(rcDeviceCamParams,
+                                                                        tcDeviceCamParams,
+                                                                        rcMipmapImage_tex,
+                                                                        tCams.mipmapImage_tex[c],
+                                                                        rcLevelWidth,
+                                                                        rcLevelHeight,
+                                                                        tCams.levelWidth[c],
+                                                                        tCams.levelHeight[c],
+                                                                        rcMipmapLevel,
+                                                                        invGammaC,
+                                                                        invGammaP,
+                                                                        useConsistentScale,
+                                                                        patch);
+        }
+        else
+        {
+            fsim = compNCCby3DptsYK<invertAndFilter>(rcDeviceCamParams,
+                                                     tcDeviceCamParams,
+                                                     rcMipmapImage_tex,
+                                                     tCams.mipmapImage_tex[c],
+                                                     rcLevelWidth,
+                                                     rcLevelHeight,
+                                                     tCams.levelWidth[c],
+                                                     tCams.levelHeight[c],
+                                                     rcMipmapLevel,
+                                                     wsh,
+                                                     invGammaC,
+                                                     invGammaP,
+                                                     useConsistentScale,
+                                                     patch);
+        }
+
+        if(fsim == CUDART_INF_F) // invalid similarity
+            continue;
+
+        // insertion sort, best (lowest) similarity first
+        int i = nbValidSims++;
+        while(i > 0 && sims[i - 1] > fsim)
+        {
+            sims[i] = sims[i - 1];
+            --i;
+        }
+        sims[i] = fsim;
+    }
+
+    if(nbValidSims == 0)
+        return CUDART_INF_F;
+
+    // mean of the best half, robust to occlusions in some T cameras
+    const int nbBestSims = (nbValidSims + 1) / 2;
+    float sum = 0.0f;
+    for(int i = 0; i < nbBestSims; ++i)
+        sum += sims[i];
+
+    return sum / float(nbBestSims);
+}
+
+__global__ void patchMatch_initialize_kernel(float2* out_depthSimMap_d, int out_depthSimMap_p,
+                                             float3* out_normalMap_d, int out_normalMap_p,
+                                             const int rcDeviceCameraParamsId,
+                                             const cudaTextureObject_t rcMipmapImage_tex,
+                                             const unsigned int rcLevelWidth,
+                                             const unsigned int rcLevelHeight,
+                                             const DevicePatchMatchTCams tCams,
+                                             const float rcMipmapLevel,
+                                             const int stepXY,
+                                             const int wsh,
+                                             const float invGammaC,
+                                             const float invGammaP,
+                                             const bool useConsistentScale,
+                                             const bool useCustomPatchPattern,
+                                             const float minDepth,
+                                             const float maxDepth,
+                                             const unsigned int seed,
+                                             const ROI roi)
+{
+    const unsigned int roiX = blockIdx.x * blockDim.x + threadIdx.x;
+    const unsigned int roiY = blockIdx.y * blockDim.y + threadIdx.y;
+
+    if(roiX >= roi.width() || roiY >= roi.height())
+        return;
+
+    // R camera parameters
+    const DeviceCameraParams& rcDeviceCamParams = constantCameraParametersArray_d[rcDeviceCameraParamsId];
+
+    // corresponding image coordinates
+    const float2 pix = make_float2(float(roi.x.begin + roiX) * float(stepXY), float(roi.y.begin + roiY) * float(stepXY));
+    const float3 ray = patchMatch_getRay(rcDeviceCamParams, pix);
+
+    // depth range along the pixel ray from the plane depth range
+    const float cosRay = fmaxf(dot(ray, rcDeviceCamParams.ZVect), 0.1f);
+
+    unsigned int state = patchMatch_randomState(roi.x.begin + roiX, roi.y.begin + roiY, 0, seed);
+
+    // uniform sampling of the inverse depth, favors the close depths as the plane sweeping depth list
+    const float invDepth = (1.0f / minDepth) + patchMatch_random(state) * ((1.0f / maxDepth) - (1.0f / minDepth));
+    const float depth = (1.0f / invDepth) / cosRay;
+
+    // random normal in the hemisphere facing the R camera
+    float3 normal = make_float3(2.0f * patchMatch_random(state) - 1.0f,
+                                2.0f * patchMatch_random(state) - 1.0f,
+                                2.0f * patchMatch_random(state) - 1.0f) + ray * -1.0f;
+    patchMatch_faceCamera(normal, ray);
+
+    const float cost = patchMatch_computeCost(rcDeviceCamParams, rcMipmapImage_tex, rcLevelWidth, rcLevelHeight, tCams,
+                                              rcMipmapLevel, wsh, invGammaC, invGammaP, useConsistentScale, useCustomPatchPattern,
+                                              ray, depth, normal);
+
+    *get2DBufferAt(out_depthSimMap_d, out_depthSimMap_p, roiX, roiY) = make_float2(depth, cost);
+    *get2DBufferAt(out_normalMap_d, out_normalMap_p, roiX, roiY) = normal;
+}
+
+__global__ void patchMatch_propagateAndRefine_kernel(float2* inout_depthSimMap_d, int inout_depthSimMap_p,
+                                                     float3* inout_normalMap_d, int inout_normalMap_p,
+                                                     const int rcDeviceCameraParamsId,
+                                                     const cudaTextureObject_t rcMipmapImage_tex,
+                                                     const unsigned int rcLevelWidth,
+                                                     const unsigned int rcLevelHeight,
+                                                     const DevicePatchMatchTCams tCams,
+                                                     const float rcMipmapLevel,
+                                                     const int stepXY,
+                                                     const int wsh,
+                                                     const float invGammaC,
+                                                     const float invGammaP,
+                                                     const bool useConsistentScale,
+                                                     const bool useCustomPatchPattern,
+                                                     const float minDepth,
+                                                     const float maxDepth,
+                                                     const int nbRandomRefinements,
+                                                     const float depthPerturbation,
+                                                     const float normalPerturbation,
+                                                     const int iteration,
+                                                     const int parity,
+                                                     const unsigned int seed,
+                                                     const ROI roi)
+{
+    // checkerboard: each thread handles the pixel of the current color in its pair
+    const unsigned int roiY = blockIdx.y * blockDim.y + threadIdx.y;
+    const unsigned int roiX = 2 * (blockIdx.x * blockDim.x + threadIdx.x) + ((roiY + parity) & 1);
+
+    if(roiX >= roi.width() || roiY >= roi.height())
+        return;
+
+    // R camera parameters
+    const DeviceCameraParams& rcDeviceCamParams = constantCameraParametersArray_d[rcDeviceCameraParamsId];
+
+    // corresponding image coordinates
+    const float2 pix = make_float2(float(roi.x.begin + roiX) * float(stepXY), float(roi.y.begin + roiY) * float(stepXY));
+    const float3 ray = patchMatch_getRay(rcDeviceCamParams, pix);
+
+    // depth range along the pixel ray
+    const float cosRay = fmaxf(dot(ray, rcDeviceCamParams.ZVect), 0.1f);
+    const float rayMinDepth = minDepth / cosRay;
+    const float rayMaxDepth = maxDepth / cosRay;
+
+    float2* depthSimPtr = get2DBufferAt(inout_depthSimMap_d, inout_depthSimMap_p, roiX, roiY);
+    float3* normalPtr = get2DBufferAt(inout_normalMap_d, inout_normalMap_p, roiX, roiY);
+
+    float bestDepth = depthSimPtr->x;
+    float bestCost = depthSimPtr->y;
+    float3 bestNormal = *normalPtr;
+
+    // propagation: the neighbors at odd offsets have the other color and are not updated by this pass
+    constexpr int nbNeighbors = 8;
+    const int2 neighborOffsets[nbNeighbors] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}, {-3, 0}, {3, 0}, {0, -3}, {0, 3}};
+
+    for(int i = 0; i < nbNeighbors; ++i)
+    {
+        const int nx = int(roiX) + neighborOffsets[i].x;
+        const int ny = int(roiY) + neighborOffsets[i].y;
+
+        if(nx < 0 || ny < 0 || nx >= int(roi.width()) || ny >= int(roi.height()))
+            continue;
+
+        const float2 neighborDepthSim = *get2DBufferAt(inout_depthSimMap_d, inout_depthSimMap_p, nx, ny);
+
+        if(neighborDepthSim.y == CUDART_INF_F)
+            continue;
+
+        const float3 neighborNormal = *get2DBufferAt(inout_normalMap_d, inout_normalMap_p, nx, ny);
+
+        // neighbor plane intersection with the pixel ray
+        const float2 neighborPix = make_float2(float(roi.x.begin + nx) * float(stepXY), float(roi.y.begin + ny) * float(stepXY));
+        const float3 neighborPoint = get3DPointForPixelAndDepthFromRC(rcDeviceCamParams, neighborPix, neighborDepthSim.x);
+
+        if(fabsf(dot(neighborNormal, ray)) < 0.1f) // grazing plane
+            continue;
+
+        const float3 p = linePlaneIntersect(rcDeviceCamParams.C, ray, neighborPoint, neighborNormal);
+        const float depth = dot(p - rcDeviceCamParams.C, ray);
+
+        if(depth < rayMinDepth || depth > rayMaxDepth)
+            continue;
+
+        const float cost = patchMatch_computeCost(rcDeviceCamParams, rcMipmapImage_tex, rcLevelWidth, rcLevelHeight, tCams,
+                                                  rcMipmapLevel, wsh, invGammaC, invGammaP, useConsistentScale, useCustomPatchPattern,
+                                                  ray, depth, neighborNormal);
+        if(cost < bestCost)
+        {
+            bestCost = cost;
+            bestDepth = depth;
+            bestNormal = neighborNormal;
+        }
+    }
+
+    // random refinement: perturbation of the best hypothesis, the perturbation range being halved at each draw
+    unsigned int state = patchMatch_randomState(roi.x.begin + roiX, roi.y.begin + roiY, iteration + 1, seed);
+
+    float depthRange = depthPerturbation;
+    float normalRange = normalPerturbation;
+
+    for(int i = 0; i < nbRandomRefinements; ++i)
+    {
+        const float depth = fminf(fmaxf(bestDepth * (1.0f + depthRange * (2.0f * patchMatch_random(state) - 1.0f)), rayMinDepth), rayMaxDepth);
+
+        float3 normal = bestNormal + make_float3(normalRange * (2.0f * patchMatch_random(state) - 1.0f),
+                                                 normalRange * (2.0f * patchMatch_random(state) - 1.0f),
+                                                 normalRange * (2.0f * patchMatch_random(state) - 1.0f));
+        patchMatch_faceCamera(normal, ray);
+
+        const float cost = patchMatch_computeCost(rcDeviceCamParams, rcMipmapImage_tex, rcLevelWidth, rcLevelHeight, tCams,
+                                                  rcMipmapLevel, wsh, invGammaC, invGammaP, useConsistentScale, useCustomPatchPattern,
+                                                  ray, depth, normal);
+        if(cost < bestCost)
+        {
+            bestCost = cost;
+            bestDepth = depth;
+            bestNormal = normal;
+        }
+
+        depthRange *= 0.5f;
+        normalRange *= 0.5f;
+    }
+
+    *depthSimPtr = make_float2(bestDepth, bestCost);
+    *normalPtr = bestNormal;
+}
+
+__global__ void patchMatch_finalize_kernel(float2* inout_depthSimMap_d, int inout_depthSimMap_p,
+                                           const float maxSimilarity,
+                                           const ROI roi)
+{
+    const unsigned int roiX = blockIdx.x * blockDim.x + threadIdx.x;
+    const unsigned int roiY = blockIdx.y * blockDim.y + threadIdx.y;
+
+    if(roiX >= roi.width() || roiY >= roi.height())
+        return;
+
+    float2* depthSimPtr = get2DBufferAt(inout_depthSimMap_d, inout_depthSimMap_p, roiX, roiY);
+
+    // invalid or poorly supported depth
+    if(depthSimPtr->y > maxSimilarity)
+        *depthSimPtr = make_float2(-1.0f, 1.0f);
+}
+
+}  // namespace depthMap
+}  // namespace aliceVision
@@ -199,7 +199,8 @@ __host__ void cuda_depthSimMapOptimizeGradientDescent(CudaDeviceMemoryPitched<fl
                                                       const DeviceMipmapImage& rcDeviceMipmapImage,
                                                       const RefineParams& refineParams,
                                                       const ROI& roi,
-                                                      cudaStream_t stream)
+                                                      cudaStream_t stream,
+                                                      DeviceGraph* optimizationGraph)
 {
     // get R mipmap image level and dimensions
     const float rcMipmapLevel = rcDeviceMipmapImage.getLevel(refineParams.scale);
@@ -233,30 +234,40 @@ __host__ void cuda_depthSimMapOptimizeGradientDescent(CudaDeviceMemoryPitched<fl
     const dim3 block(blockSize, blockSize, 1);
     const dim3 grid(divUp(roi.width(), blockSize), divUp(roi.height(), blockSize), 1);
 
-    for(int iter = 0; iter < refineParams.optimizationNbIterations; ++iter) // default nb iterations is 100
+    // optimization iterations launch sequence
+    // 2 small kernels per iteration, this sequence is launch-bound for small tiles
+    const auto launchIterations = [&]()
     {
-        // copy depths values from out_depthSimMapOptimized_dmp to inout_tmpOptDepthMap_dmp
-        optimize_getOptDeptMapFromOptDepthSimMap_kernel<<<grid, block, 0, stream>>>(
-            inout_tmpOptDepthMap_dmp.getBuffer(), 
-            inout_tmpOptDepthMap_dmp.getPitch(), 
-            out_optimizeDepthSimMap_dmp.getBuffer(), // initialized with SGM depth/pixSize map
-            out_optimizeDepthSimMap_dmp.getPitch(),
-            roi);
-
-        // adjust depth/sim by using previously computed depths
-        optimize_depthSimMap_kernel<<<grid, block, 0, stream>>>(
-            out_optimizeDepthSimMap_dmp.getBuffer(),
-            out_optimizeDepthSimMap_dmp.getPitch(),
-            in_sgmDepthPixSizeMap_dmp.getBuffer(),
-            in_sgmDepthPixSizeMap_dmp.getPitch(),
-            in_refineDepthSimMap_dmp.getBuffer(),
-            in_refineDepthSimMap_dmp.getPitch(),
-            rcDeviceCameraParamsId,
-            imgVarianceTex.textureObj,
-            depthTex.textureObj,
-            iter, 
-            roi);
-    }
+        for(int iter = 0; iter < refineParams.optimizationNbIterations; ++iter) // default nb iterations is 100
+        {
+            // copy depths values from out_depthSimMapOptimized_dmp to inout_tmpOptDepthMap_dmp
+            optimize_getOptDeptMapFromOptDepthSimMap_kernel<<<grid, block, 0, stream>>>(
+                inout_tmpOptDepthMap_dmp.getBuffer(), 
+                inout_tmpOptDepthMap_dmp.getPitch(), 
+                out_optimizeDepthSimMap_dmp.getBuffer(), // initialized with SGM depth/pixSize map
+                out_optimizeDepthSimMap_dmp.getPitch(),
+                roi);
+
+            // adjust depth/sim by using previously computed depths
+            optimize_depthSimMap_kernel<<<grid, block, 0, stream>>>(
+                out_optimizeDepthSimMap_dmp.getBuffer(),
+                out_optimizeDepthSimMap_dmp.getPitch(),
+                in_sgmDepthPixSizeMap_dmp.getBuffer(),
+                in_sgmDepthPixSizeMap_dmp.getPitch(),
+                in_refineDepthSimMap_dmp.getBuffer(),
+                in_refineDepthSimMap_dmp.getPitch(),
+                rcDeviceCameraParamsId,
+                imgVarianceTex.textureObj,
+                depthTex.textureObj,
+                iter, 
+                roi);
+        }
+    };
+
+    if(optimizationGraph != nullptr)
+        optimizationGraph->launch(launchIterations, stream);
+    else
+        launchIterations();
 
     // check cuda last error
     CHECK_CUDA_ERROR();
@@ -11,6 +11,7 @@
 #include <aliceVision/depthMap/RefineParams.hpp>
 #include <aliceVision/depthMap/cuda/host/memory.hpp>
 #include <aliceVision/depthMap/cuda/host/DeviceMipmapImage.hpp>
+#include <aliceVision/depthMap/cuda/host/DeviceGraph.hpp>
 
 namespace aliceVision {
 namespace depthMap {
@@ -99,6 +100,7 @@ extern void cuda_depthSimMapComputeNormal(CudaDeviceMemoryPitched<float3, 2>& ou
  * @param[in] refineParams the Refine parameters
  * @param[in] roi the 2d region of interest
  * @param[in] stream the stream for gpu execution
+ * @param[in,out] optimizationGraph the graph used to replay the optimization iterations (or nullptr for direct launches)
  */
 extern void cuda_depthSimMapOptimizeGradientDescent(CudaDeviceMemoryPitched<float2, 2>& out_optimizeDepthSimMap_dmp,
                                                     CudaDeviceMemoryPitched<float, 2>& inout_imgVariance_dmp,
@@ -109,7 +111,8 @@ extern void cuda_depthSimMapOptimizeGradientDescent(CudaDeviceMemoryPitched<floa
                                                     const DeviceMipmapImage& rcDeviceMipmapImage,
                                                     const RefineParams& refineParams,
                                                     const ROI& roi,
-                                                    cudaStream_t stream);
+                                                    cudaStream_t stream,
+                                                    DeviceGraph* optimizationGraph = nullptr);
 
 }  // namespace depthMap
 }  // namespace aliceVision
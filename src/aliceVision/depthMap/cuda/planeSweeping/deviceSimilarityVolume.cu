@@ -169,37 +169,49 @@ __host__ void cuda_volumeComputeSimilarity(CudaDeviceMemoryPitched<TSim, 3>& out
     const CudaSize<2> rcLevelDim = rcDeviceMipmapImage.getDimensions(sgmParams.scale);
     const CudaSize<2> tcLevelDim = tcDeviceMipmapImage.getDimensions(sgmParams.scale);
 
-    // kernel launch parameters
-    const dim3 block = getMaxPotentialBlockSize(volume_computeSimilarity_kernel);
-    const dim3 grid(divUp(roi.width(), block.x), divUp(roi.height(), block.y), depthRange.size());
+    // kernel launch and execution
+    const auto launch = [&](auto kernel)
+    {
+      // kernel launch parameters
+      const dim3 block = getMaxPotentialBlockSize(kernel);
+      const dim3 grid(divUp(roi.width(), block.x), divUp(roi.height(), block.y), depthRange.size());
+
+      // kernel execution
+      kernel<<<grid, block, 0, stream>>>(
+          out_volBestSim_dmp.getBuffer(),
+          out_volBestSim_dmp.getBytesPaddedUpToDim(1),
+          out_volBestSim_dmp.getBytesPaddedUpToDim(0),
+          out_volSecBestSim_dmp.getBuffer(),
+          out_volSecBestSim_dmp.getBytesPaddedUpToDim(1),
+          out_volSecBestSim_dmp.getBytesPaddedUpToDim(0),
+          in_depths_dmp.getBuffer(),
+          in_depths_dmp.getBytesPaddedUpToDim(0),
+          rcDeviceCameraParamsId,
+          tcDeviceCameraParamsId,
+          rcDeviceMipmapImage.getTextureObject(),
+          tcDeviceMipmapImage.getTextureObject(),
+          (unsigned int)(rcLevelDim.x()),
+          (unsigned int)(rcLevelDim.y()),
+          (unsigned int)(tcLevelDim.x()),
+          (unsigned int)(tcLevelDim.y()),
+          rcMipmapLevel,
+          sgmParams.stepXY,
+          sgmParams.wsh,
+          (1.f / float(sgmParams.gammaC)), // inverted gammaC
+          (1.f / float(sgmParams.gammaP)), // inverted gammaP
+          sgmParams.useConsistentScale,
+          sgmParams.useCustomPatchPattern,
+          depthRange,
+          roi);
+    };
 
-    // kernel execution
-    volume_computeSimilarity_kernel<<<grid, block, 0, stream>>>(
-        out_volBestSim_dmp.getBuffer(),
-        out_volBestSim_dmp.getBytesPaddedUpToDim(1),
-        out_volBestSim_dmp.getBytesPaddedUpToDim(0),
-        out_volSecBestSim_dmp.getBuffer(),
-        out_volSecBestSim_dmp.getBytesPaddedUpToDim(1),
-        out_volSecBestSim_dmp.getBytesPaddedUpToDim(0),
-        in_depths_dmp.getBuffer(),
-        in_depths_dmp.getBytesPaddedUpToDim(0),
-        rcDeviceCameraParamsId,
-        tcDeviceCameraParamsId,
-        rcDeviceMipmapImage.getTextureObject(),
-        tcDeviceMipmapImage.getTextureObject(),
-        (unsigned int)(rcLevelDim.x()),
-        (unsigned int)(rcLevelDim.y()),
-        (unsigned int)(tcLevelDim.x()),
-        (unsigned int)(tcLevelDim.y()),
-        rcMipmapLevel,
-        sgmParams.stepXY,
-        sgmParams.wsh,
-        (1.f / float(sgmParams.gammaC)), // inverted gammaC
-        (1.f / float(sgmParams.gammaP)), // inverted gammaP
-        sgmParams.useConsistentScale,
-        sgmParams.useCustomPatchPattern,
-        depthRange,
-        roi);
+    // use the kernels specialized for the default patch half-widths (unrolled patch loops)
+    if(!sgmParams.useCustomPatchPattern && sgmParams.wsh == 4)
+      launch(volume_computeSimilarity_kernel<4>);
+    else if(!sgmParams.useCustomPatchPattern && sgmParams.wsh == 3)
+      launch(volume_computeSimilarity_kernel<3>);
+    else
+      launch(volume_computeSimilarity_kernel<-1>);
 
     // check cuda last error
     CHECK_CUDA_ERROR();
@@ -222,37 +234,49 @@ extern void cuda_volumeRefineSimilarity(CudaDeviceMemoryPitched<TSimRefine, 3>&
     const CudaSize<2> rcLevelDim = rcDeviceMipmapImage.getDimensions(refineParams.scale);
     const CudaSize<2> tcLevelDim = tcDeviceMipmapImage.getDimensions(refineParams.scale);
 
-    // kernel launch parameters
-    const dim3 block = getMaxPotentialBlockSize(volume_refineSimilarity_kernel);
-    const dim3 grid(divUp(roi.width(), block.x), divUp(roi.height(), block.y), depthRange.size());
+    // kernel launch and execution
+    const auto launch = [&](auto kernel)
+    {
+      // kernel launch parameters
+      const dim3 block = getMaxPotentialBlockSize(kernel);
+      const dim3 grid(divUp(roi.width(), block.x), divUp(roi.height(), block.y), depthRange.size());
+
+      // kernel execution
+      kernel<<<grid, block, 0, stream>>>(
+          inout_volSim_dmp.getBuffer(),
+          inout_volSim_dmp.getBytesPaddedUpToDim(1),
+          inout_volSim_dmp.getBytesPaddedUpToDim(0),
+          in_sgmDepthPixSizeMap_dmp.getBuffer(),
+          in_sgmDepthPixSizeMap_dmp.getBytesPaddedUpToDim(0),
+          (in_sgmNormalMap_dmpPtr == nullptr) ? nullptr : in_sgmNormalMap_dmpPtr->getBuffer(),
+          (in_sgmNormalMap_dmpPtr == nullptr) ? 0 : in_sgmNormalMap_dmpPtr->getBytesPaddedUpToDim(0),
+          rcDeviceCameraParamsId,
+          tcDeviceCameraParamsId,
+          rcDeviceMipmapImage.getTextureObject(),
+          tcDeviceMipmapImage.getTextureObject(),
+          (unsigned int)(rcLevelDim.x()),
+          (unsigned int)(rcLevelDim.y()),
+          (unsigned int)(tcLevelDim.x()),
+          (unsigned int)(tcLevelDim.y()),
+          rcMipmapLevel,
+          int(inout_volSim_dmp.getSize().z()), 
+          refineParams.stepXY,
+          refineParams.wsh, 
+          (1.f / float(refineParams.gammaC)), // inverted gammaC
+          (1.f / float(refineParams.gammaP)), // inverted gammaP
+          refineParams.useConsistentScale,
+          refineParams.useCustomPatchPattern,
+          depthRange,
+          roi);
+    };
 
-    // kernel execution
-    volume_refineSimilarity_kernel<<<grid, block, 0, stream>>>(
-        inout_volSim_dmp.getBuffer(),
-        inout_volSim_dmp.getBytesPaddedUpToDim(1),
-        inout_volSim_dmp.getBytesPaddedUpToDim(0),
-        in_sgmDepthPixSizeMap_dmp.getBuffer(),
-        in_sgmDepthPixSizeMap_dmp.getBytesPaddedUpToDim(0),
-        (in_sgmNormalMap_dmpPtr == nullptr) ? nullptr : in_sgmNormalMap_dmpPtr->getBuffer(),
-        (in_sgmNormalMap_dmpPtr == nullptr) ? 0 : in_sgmNormalMap_dmpPtr->getBytesPaddedUpToDim(0),
-        rcDeviceCameraParamsId,
-        tcDeviceCameraParamsId,
-        rcDeviceMipmapImage.getTextureObject(),
-        tcDeviceMipmapImage.getTextureObject(),
-        (unsigned int)(rcLevelDim.x()),
-        (unsigned int)(rcLevelDim.y()),
-        (unsigned int)(tcLevelDim.x()),
-        (unsigned int)(tcLevelDim.y()),
-        rcMipmapLevel,
-        int(inout_volSim_dmp.getSize().z()), 
-        refineParams.stepXY,
-        refineParams.wsh, 
-        (1.f / float(refineParams.gammaC)), // inverted gammaC
-        (1.f / float(refineParams.gammaP)), // inverted gammaP
-        refineParams.useConsistentScale,
-        refineParams.useCustomPatchPattern,
-        depthRange,
-        roi);
+    // use the kernels specialized for the default patch half-widths (unrolled patch loops)
+    if(!refineParams.useCustomPatchPattern && refineParams.wsh == 4)
+      launch(volume_refineSimilarity_kernel<4>);
+    else if(!refineParams.useCustomPatchPattern && refineParams.wsh == 3)
+      launch(volume_refineSimilarity_kernel<3>);
+    else
+      launch(volume_refineSimilarity_kernel<-1>);
 
     // check cuda last error
     CHECK_CUDA_ERROR();
@@ -424,6 +448,38 @@ __host__ void cuda_volumeOptimize(CudaDeviceMemoryPitched<TSim, 3>& out_volSimFi
     }
 }
 
+__host__ void cuda_volumeBestDepthHistogram(CudaDeviceMemoryPitched<int, 2>& out_depthHistogram_dmp,
+                                            const CudaDeviceMemoryPitched<TSim, 3>& in_volSim_dmp,
+                                            const SgmParams& sgmParams,
+                                            const Range& depthRange,
+                                            const ROI& roi,
+                                            cudaStream_t stream)
+{
+    // constant kernel inputs
+    const float maxSimilarity = float(sgmParams.maxSimilarity) * 254.f; // convert from (0, 1) to (0, 254)
+
+    // reset the histogram
+    CHECK_CUDA_RETURN_ERROR(cudaMemsetAsync(out_depthHistogram_dmp.getBuffer(), 0, out_depthHistogram_dmp.getBytesPadded(), stream));
+
+    // kernel launch parameters
+    const dim3 block = getMaxPotentialBlockSize(volume_bestDepthHistogram_kernel);
+    const dim3 grid(divUp(roi.width(), block.x), divUp(roi.height(), block.y), 1);
+
+    // kernel execution
+    volume_bestDepthHistogram_kernel<<<grid, block, 0, stream>>>(
+        out_depthHistogram_dmp.getBuffer(),
+        out_depthHistogram_dmp.getBytesPaddedUpToDim(0),
+        in_volSim_dmp.getBuffer(),
+        in_volSim_dmp.getBytesPaddedUpToDim(1),
+        in_volSim_dmp.getBytesPaddedUpToDim(0),
+        maxSimilarity,
+        depthRange,
+        roi);
+
+    // check cuda last error
+    CHECK_CUDA_ERROR();
+}
+
 __host__ void cuda_volumeRetrieveBestDepth(CudaDeviceMemoryPitched<float2, 2>& out_sgmDepthThicknessMap_dmp,
                                            CudaDeviceMemoryPitched<float2, 2>& out_sgmDepthSimMap_dmp,
                                            const CudaDeviceMemoryPitched<float, 2>& in_depths_dmp, 
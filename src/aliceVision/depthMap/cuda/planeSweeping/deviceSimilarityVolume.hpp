@@ -128,6 +128,23 @@ extern void cuda_volumeOptimize(CudaDeviceMemoryPitched<TSim, 3>& out_volSimFilt
                                 const ROI& roi,
                                 cudaStream_t stream);
 
+/**
+ * @brief Count for each depth of the given similarity volume the number of pixels with their best similarity at this depth.
+ * @note Same best depth selection as cuda_volumeRetrieveBestDepth, the pixels with a too bad similarity are not counted.
+ * @param[out] out_depthHistogram_dmp the output number of pixels per depth in device memory
+ * @param[in] in_volSim_dmp the input similarity volume in device memory
+ * @param[in] sgmParams the Semi Global Matching parameters
+ * @param[in] depthRange the volume depth range to compute
+ * @param[in] roi the 2d region of interest
+ * @param[in] stream the stream for gpu execution
+ */
+extern void cuda_volumeBestDepthHistogram(CudaDeviceMemoryPitched<int, 2>& out_depthHistogram_dmp,
+                                          const CudaDeviceMemoryPitched<TSim, 3>& in_volSim_dmp,
+                                          const SgmParams& sgmParams,
+                                          const Range& depthRange,
+                                          const ROI& roi,
+                                          cudaStream_t stream);
+
 /**
  * @brief Retrieve the best depth/sim in the given similarity volume.
  * @param[out] out_sgmDepthThicknessMap_dmp the output depth/thickness map in device memory
@@ -106,6 +106,8 @@ __global__ void volume_updateUninitialized_kernel(TSim* inout_volume2nd_d, int i
     }
 }
 
+// TWsh: compile-time patch half-width, negative for the generic kernel (runtime half-width and custom patch pattern)
+template <int TWsh>
 __global__ void volume_computeSimilarity_kernel(TSim* out_volume1st_d, int out_volume1st_s, int out_volume1st_p,
                                                 TSim* out_volume2nd_d, int out_volume2nd_s, int out_volume2nd_p,
                                                 const float* in_depths_d, const int in_depths_p,
@@ -160,7 +162,7 @@ __global__ void volume_computeSimilarity_kernel(TSim* out_volume1st_d, int out_v
     float fsim = CUDART_INF_F;
 
     // compute patch similarity
-    if(useCustomPatchPattern)
+    if(TWsh < 0 && useCustomPatchPattern)
     {
         fsim = compNCCby3DptsYK_customPatchPattern<invertAndFilter>(rcDeviceCamParams,
                                                                     tcDeviceCamParams,
@@ -178,20 +180,20 @@ __global__ void volume_computeSimilarity_kernel(TSim* out_volume1st_d, int out_v
     }
     else
     {
-        fsim = compNCCby3DptsYK<invertAndFilter>(rcDeviceCamParams,
-                                                 tcDeviceCamParams,
-                                                 rcMipmapImage_tex,
-                                                 tcMipmapImage_tex,
-                                                 rcSgmLevelWidth,
-                                                 rcSgmLevelHeight,
-                                                 tcSgmLevelWidth,
-                                                 tcSgmLevelHeight,
-                                                 rcMipmapLevel,
-                                                 wsh,
-                                                 invGammaC,
-                                                 invGammaP,
-                                                 useConsistentScale,
-                                                 patch);
+        fsim = compNCCby3DptsYK<invertAndFilter, TWsh>(rcDeviceCamParams,
+                                                       tcDeviceCamParams,
+                                                       rcMipmapImage_tex,
+                                                       tcMipmapImage_tex,
+                                                       rcSgmLevelWidth,
+                                                       rcSgmLevelHeight,
+                                                       tcSgmLevelWidth,
+                                                       tcSgmLevelHeight,
+                                                       rcMipmapLevel,
+                                                       wsh,
+                                                       invGammaC,
+                                                       invGammaP,
+                                                       useConsistentScale,
+                                                       patch);
     }
 
     if(fsim == CUDART_INF_F) // invalid similarity
@@ -232,6 +234,8 @@ __global__ void volume_computeSimilarity_kernel(TSim* out_volume1st_d, int out_v
     }
 }
 
+// TWsh: compile-time patch half-width, negative for the generic kernel (runtime half-width and custom patch pattern)
+template <int TWsh>
 __global__ void volume_refineSimilarity_kernel(TSimRefine* inout_volSim_d, int inout_volSim_s, int inout_volSim_p,
                                                const float2* in_sgmDepthPixSizeMap_d, const int in_sgmDepthPixSizeMap_p,
                                                const float3* in_sgmNormalMap_d, const int in_sgmNormalMap_p,
@@ -336,7 +340,7 @@ __global__ void volume_refineSimilarity_kernel(TSimRefine* inout_volSim_d, int i
     float fsimInvertedFiltered = CUDART_INF_F;
 
     // compute similarity
-    if(useCustomPatchPattern)
+    if(TWsh < 0 && useCustomPatchPattern)
     {
         fsimInvertedFiltered = compNCCby3DptsYK_customPatchPattern<invertAndFilter>(rcDeviceCamParams,
                                                                                     tcDeviceCamParams,
@@ -354,20 +358,20 @@ __global__ void volume_refineSimilarity_kernel(TSimRefine* inout_volSim_d, int i
     }
     else
     {
-        fsimInvertedFiltered = compNCCby3DptsYK<invertAndFilter>(rcDeviceCamParams,
-                                                                 tcDeviceCamParams,
-                                                                 rcMipmapImage_tex,
-                                                                 tcMipmapImage_tex,
-                                                                 rcRefineLevelWidth,
-                                                                 rcRefineLevelHeight,
-                                                                 tcRefineLevelWidth,
-                                                                 tcRefineLevelHeight,
-                                                                 rcMipmapLevel,
-                                                                 wsh,
-                                                                 invGammaC,
-                                                                 invGammaP,
-                                                                 useConsistentScale,
-                                                                 patch);
+        fsimInvertedFiltered = compNCCby3DptsYK<invertAndFilter, TWsh>(rcDeviceCamParams,
+                                                                       tcDeviceCamParams,
+                                                                       rcMipmapImage_tex,
+                                                                       tcMipmapImage_tex,
+                                                                       rcRefineLevelWidth,
+                                                                       rcRefineLevelHeight,
+                                                                       tcRefineLevelWidth,
+                                                                       tcRefineLevelHeight,
+                                                                       rcMipmapLevel,
+                                                                       wsh,
+                                                                       invGammaC,
+                                                                       invGammaP,
+                                                                       useConsistentScale,
+                                                                       patch);
     }
 
     if(fsimInvertedFiltered == CUDART_INF_F) // invalid similarity
@@ -390,6 +394,41 @@ __global__ void volume_refineSimilarity_kernel(TSimRefine* inout_volSim_d, int i
 #endif
 }
 
+__global__ void volume_bestDepthHistogram_kernel(int* inout_depthHistogram_d, const int inout_depthHistogram_p,
+                                                const TSim* in_volSim_d, const int in_volSim_s, const int in_volSim_p,
+                                                const float maxSimilarity,
+                                                const Range depthRange,
+                                                const ROI roi)
+{
+    const unsigned int vx = blockIdx.x * blockDim.x + threadIdx.x;
+    const unsigned int vy = blockIdx.y * blockDim.y + threadIdx.y;
+
+    if(vx >= roi.width() || vy >= roi.height())
+        return;
+
+    // find the best depth plane index for the current pixel
+    // same as volume_retrieveBestDepth_kernel
+    float bestSim = 255.f;
+    int bestZIdx = -1;
+
+    for(int vz = depthRange.begin; vz < depthRange.end; ++vz)
+    {
+      const float simAtZ = *get3DBufferAt(in_volSim_d, in_volSim_s, in_volSim_p, vx, vy, vz);
+
+      if(simAtZ < bestSim)
+      {
+        bestSim = simAtZ;
+        bestZIdx = vz;
+      }
+    }
+
+    // filtering out invalid values and values with a too bad score
+    if((bestZIdx == -1) || (bestSim > maxSimilarity))
+        return;
+
+    atomicAdd(get2DBufferAt(inout_depthHistogram_d, inout_depthHistogram_p, bestZIdx, 0), 1);
+}
+
 __global__ void volume_retrieveBestDepth_kernel(float2* out_sgmDepthThicknessMap_d, int out_sgmDepthThicknessMap_p,
                                                 float2* out_sgmDepthSimMap_d, int out_sgmDepthSimMap_p, // output depth/sim map is optional (nullptr)
                                                 const float* in_depths_d, const int in_depths_p,
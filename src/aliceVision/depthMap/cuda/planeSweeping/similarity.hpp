@@ -6,7 +6,9 @@
 
 #pragma once
 
-#define TSIM_REFINE_USE_HALF
+// similarity volumes storage precision is selected at build time:
+// - TSIM_USE_FLOAT (CMake ALICEVISION_DEPTHMAP_TSIM_USE_FLOAT, default OFF)
+// - TSIM_REFINE_USE_HALF (CMake ALICEVISION_DEPTHMAP_TSIM_REFINE_USE_HALF, default ON)
 
 #ifdef TSIM_REFINE_USE_HALF
     #define CUDA_NO_HALF
@@ -279,9 +279,9 @@ void writeDepthSimMapFromTileList(int rc,
         mvsUtils::addTileMapWeighted(rc, mp, tileParams, roi, scaleStep, tileSimMap, simMap);
     }
 
-    // write fullsize maps on disk
-    mvsUtils::writeMap(rc, mp, mvsUtils::EFileType::depthMap, depthMap, scale, step, customSuffix);  // write the merged depth map
-    mvsUtils::writeMap(rc, mp, mvsUtils::EFileType::simMap, simMap, scale, step, customSuffix);      // write the merged similarity map
+    // write fullsize maps on disk, one file tile per tile effective area
+    mvsUtils::writeTiledMap(rc, mp, mvsUtils::EFileType::depthMap, tileParams, tileRoiList, depthMap, scale, step, customSuffix);
+    mvsUtils::writeTiledMap(rc, mp, mvsUtils::EFileType::simMap, tileParams, tileRoiList, simMap, scale, step, customSuffix);
 }
 
 void resetDepthSimMap(CudaHostMemoryHeap<float2, 2>& inout_depthSimMap_hmh, float depth, float sim)
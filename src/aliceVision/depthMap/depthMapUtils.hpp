@@ -129,6 +129,8 @@ void writeDepthSimMap(int rc,
 
 /**
  * @brief Write a depth/similarity map on disk from a tile list in host memory.
+ *        The tiles are fused in memory and each map is written in a single tiled file,
+ *        with one file tile per tile effective area, so no merge pass is needed.
  * @param[in] rc the related R camera index
  * @param[in] mp the multi-view parameters
  * @param[in] tileParams tile workflow parameters
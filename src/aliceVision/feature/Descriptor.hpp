@@ -15,6 +15,7 @@
 #include <string>
 #include <vector>
 #include <exception>
+#include <type_traits>
 
 namespace aliceVision {
 namespace feature {
@@ -268,11 +269,28 @@ inline void loadDescsFromBinFile(const std::string& sfileNameDescs, std::vector<
     // Compute the memory size of one descriptor
     constexpr std::size_t oneDescSize = FileDescriptorT::static_size * sizeof(typename FileDescriptorT::bin_type);
 
-    FileDescriptorT fileDescriptor;
-    for (typename std::vector<DescriptorT>::iterator iter = begin; iter != vec_desc.end(); ++iter)
+    static_assert(sizeof(FileDescriptorT) == oneDescSize, "Descriptor memory layout is not packed.");
+    const std::size_t nbDescsToRead = std::distance(begin, vec_desc.end());
+
+    if (std::is_same<DescriptorT, FileDescriptorT>::value)
+    {
+        // Same layout on disk and in memory: read all descriptors at once
+        if (nbDescsToRead > 0)
+            fileIn.read((char*)begin->getData(), nbDescsToRead * oneDescSize);
+    }
+    else
     {
-        fileIn.read((char*)fileDescriptor.getData(), oneDescSize);
-        convertDesc<FileDescriptorT, DescriptorT>(fileDescriptor, *iter);
+        // Read descriptors by blocks and convert them
+        constexpr std::size_t blockSize = 4096;
+        std::vector<FileDescriptorT> fileDescriptors(std::min(blockSize, nbDescsToRead));
+
+        for (std::size_t i = 0; i < nbDescsToRead; i += blockSize)
+        {
+            const std::size_t nbDescsInBlock = std::min(blockSize, nbDescsToRead - i);
+            fileIn.read((char*)fileDescriptors.front().getData(), nbDescsInBlock * oneDescSize);
+            for (std::size_t j = 0; j < nbDescsInBlock; ++j)
+                convertDesc<FileDescriptorT, DescriptorT>(fileDescriptors[j], *(begin + i + j));
+        }
     }
 
     if (fileIn.bad())
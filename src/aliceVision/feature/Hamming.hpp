@@ -8,8 +8,10 @@
 #pragma once
 
 #include "metric.hpp"
+#include "metricKernels.hpp"
 
 #include <bitset>
+#include <type_traits>
 
 #ifdef _MSC_VER
 typedef unsigned __int32 uint32_t;
@@ -26,7 +28,8 @@ typedef unsigned __int64 uint64_t;
 // Brief:
 // Hamming distance count the number of bits in common between descriptors
 //  by using a XOR operation + a count.
-// For maximal performance SSE4 must be enable for builtin popcount activation.
+// For maximal performance SSE4 must be enable for builtin popcount activation,
+//  otherwise the unsigned char version uses the POPCNT instruction if the CPU supports it.
 
 namespace aliceVision {
 namespace feature {
@@ -113,6 +116,12 @@ struct Hamming
     template<typename Iterator1, typename Iterator2>
     inline ResultType operator()(Iterator1 a, Iterator2 b, size_t size) const
     {
+#if !defined(__POPCNT__)
+        if constexpr (std::is_same<T, unsigned char>::value)
+        {
+            return hammingDistance(reinterpret_cast<const unsigned char*>(&(*a)), reinterpret_cast<const unsigned char*>(&(*b)), size);
+        }
+#endif
         ResultType result = 0;
         // Windows & generic platforms:
 
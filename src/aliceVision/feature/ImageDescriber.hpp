@@ -11,10 +11,12 @@
 #include <aliceVision/feature/imageDescriberCommon.hpp>
 #include <aliceVision/feature/Regions.hpp>
 #include <aliceVision/image/Image.hpp>
+#include <functional>
 #include <memory>
 
 #include <string>
 #include <iostream>
+#include <vector>
 
 namespace aliceVision {
 namespace feature {
@@ -208,6 +210,31 @@ class ImageDescriber
      */
     virtual void setCudaPipe(int pipe) {}
 
+    /**
+     * @brief Set the number of GPUs used by a CUDA image describer
+     * @param[in] nbGPUs The number of GPUs (0 to use all the available GPUs)
+     */
+    virtual void setNbGPUs(int nbGPUs) {}
+
+    /**
+     * @brief Keep the temporary buffers of the extraction (e.g. scale space) between the images processed by a thread,
+     *        to reuse them for the next image of the same size instead of reallocating them
+     * @param[in] reuseBuffers
+     */
+    virtual void setReuseBuffers(bool reuseBuffers) { _reuseBuffers = reuseBuffers; }
+
+    /**
+     * @brief Check if the temporary buffers are kept between the images
+     * @return True if the temporary buffers are reused
+     */
+    bool reuseBuffers() const { return _reuseBuffers; }
+
+    /**
+     * @brief Release the temporary buffers kept for the next images
+     * @note Should not be called while an image is described
+     */
+    virtual void releaseBuffers() {}
+
     /**
      * @brief Use a preset to control the number of detected regions
      * @param[in] preset The preset configuration
@@ -242,6 +269,43 @@ class ImageDescriber
         return false;
     }
 
+    /**
+     * @brief Detect regions on a batch of float images and compute their attributes (description).
+     *        The regions of each image are given to the callback in the images order. The image describers
+     *        able to pipeline the extraction (e.g. upload the next images while the current one is processed)
+     *        override this method, so the callback of an image runs while the next images are processed.
+     * @param[in] images The float images
+     * @param[in] onRegions The callback called with the index of the image in the batch and its regions
+     */
+    virtual void describeBatch(const std::vector<const image::Image<float>*>& images,
+                               const std::function<void(std::size_t, std::unique_ptr<Regions>&)>& onRegions)
+    {
+        for (std::size_t i = 0; i < images.size(); ++i)
+        {
+            std::unique_ptr<Regions> regions;
+            describe(*images.at(i), regions);
+            onRegions(i, regions);
+        }
+    }
+
+    /**
+     * @brief Detect regions on a batch of 8-bit images and compute their attributes (description).
+     *        The regions of each image are given to the callback in the images order. The image describers
+     *        able to process several images at once (e.g. on concurrent CUDA pipes) override this method.
+     * @param[in] images The 8-bit images
+     * @param[in] onRegions The callback called with the index of the image in the batch and its regions
+     */
+    virtual void describeBatch(const std::vector<const image::Image<unsigned char>*>& images,
+                               const std::function<void(std::size_t, std::unique_ptr<Regions>&)>& onRegions)
+    {
+        for (std::size_t i = 0; i < images.size(); ++i)
+        {
+            std::unique_ptr<Regions> regions;
+            describe(*images.at(i), regions);
+            onRegions(i, regions);
+        }
+    }
+
     /**
      * @brief Allocate Regions type depending of the ImageDescriber
      * @param[in,out] regions
@@ -258,6 +322,9 @@ class ImageDescriber
     void Save(const Regions* regions, const std::string& sfileNameFeats, const std::string& sfileNameDescs) const;
 
     void LoadFeatures(Regions* regions, const std::string& sfileNameFeats) const { regions->LoadFeatures(sfileNameFeats); }
+
+  protected:
+    bool _reuseBuffers = false;
 };
 
 /**
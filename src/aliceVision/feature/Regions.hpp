@@ -107,6 +107,10 @@ class Regions
     // - Binary: Hamming
     virtual double SquaredDescriptorDistance(std::size_t i, const Regions*, std::size_t j) const = 0;
 
+    /// Compute the squared distances between the ith descriptor and several descriptors of another Regions
+    // Same metric as SquaredDescriptorDistance, with a single type check for all the candidates.
+    virtual void SquaredDescriptorDistances(std::size_t i, const Regions*, const IndexT* indexes, std::size_t nbIndexes, double* out_distances) const = 0;
+
     /// Add the Inth region to another Region container
     virtual void CopyRegion(std::size_t i, Regions*) const = 0;
 
@@ -186,7 +190,7 @@ class FeatDescRegions : public Regions
 
     inline const void* DescriptorRawData() const override { return &_vec_descs[0]; }
 
-    inline void clearDescriptors() override { _vec_descs.clear(); }
+    inline void clearDescriptors() override { DescsT().swap(_vec_descs); }
 
     inline void swap(This& other)
     {
@@ -206,6 +210,25 @@ class FeatDescRegions : public Regions
         return metric(this->_vec_descs[i].getData(), regionsT->_vec_descs[j].getData(), DescriptorT::static_size);
     }
 
+    void SquaredDescriptorDistances(std::size_t i,
+                                    const Regions* genericRegions,
+                                    const IndexT* indexes,
+                                    std::size_t nbIndexes,
+                                    double* out_distances) const override
+    {
+        assert(i < this->_vec_descs.size());
+        assert(genericRegions);
+
+        const This* regionsT = dynamic_cast<const This*>(genericRegions);
+        static typename SquaredMetric<T, regionType>::Metric metric;
+        const T* descI = this->_vec_descs[i].getData();
+        for (std::size_t k = 0; k < nbIndexes; ++k)
+        {
+            assert(indexes[k] < regionsT->_vec_descs.size());
+            out_distances[k] = metric(descI, regionsT->_vec_descs[indexes[k]].getData(), DescriptorT::static_size);
+        }
+    }
+
     /**
      * @brief Add the Inth region to another Region container
      * @param[in] i: index of the region to copy
@@ -0,0 +1,61 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace aliceVision {
+namespace feature {
+
+/**
+ * @brief Per-thread cache of the temporary buffers of an image describer (e.g. scale space, keypoints).
+ *        Each thread gets its own buffers, kept between the images it processes:
+ *        the buffers are reused as is for an image of the same size and reallocated otherwise.
+ * @note The buffers are only released by clear(), when no thread is using them.
+ */
+template<typename Buffers>
+class ThreadBufferCache
+{
+  public:
+    ThreadBufferCache() = default;
+
+    // the buffers are not shared between copies of an image describer
+    ThreadBufferCache(const ThreadBufferCache&) {}
+    ThreadBufferCache& operator=(const ThreadBufferCache&) { return *this; }
+
+    /**
+     * @brief Get the buffers of the current thread, created at the first call of each thread.
+     * @return the buffers of the current thread
+     */
+    Buffers& local()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        std::unique_ptr<Buffers>& buffers = _buffers[std::this_thread::get_id()];
+        if (!buffers)
+            buffers = std::make_unique<Buffers>();
+        return *buffers;
+    }
+
+    /**
+     * @brief Release the buffers of all the threads.
+     */
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _buffers.clear();
+    }
+
+  private:
+    std::mutex _mutex;
+    std::map<std::thread::id, std::unique_ptr<Buffers>> _buffers;
+};
+
+}  // namespace feature
+}  // namespace aliceVision
@@ -151,9 +151,10 @@ void convertScale(Image& src)
 }
 #endif  // DEBUG_OCTAVE
 
-AKAZE::AKAZE(const image::Image<float>& image, const AKAZEOptions& options)
-  : _input(image),
-    _options(options)
+AKAZE::AKAZE(const image::Image<float>& image, const AKAZEOptions& options, std::vector<TEvolution>* evolution)
+  : _options(options),
+    _evolution(evolution ? *evolution : _ownedEvolution),
+    _input(image)
 {
     _options.descFactor = std::max(6.f * sqrtf(2.f), _options.descFactor);
 
@@ -167,6 +168,9 @@ void AKAZE::computeScaleSpace()
     float contrastFactor = computeAutomaticContrastFactor(_input, 0.7f);
     image::Image<float> input = _input;
 
+    // the slices of a reused scale space keep their memory for the images of the same size
+    _evolution.resize(_options.nbOctaves * _options.nbSlicePerOctave);
+
     // octave computation
     for (int p = 0; p < _options.nbOctaves; ++p)
     {
@@ -174,8 +178,7 @@ void AKAZE::computeScaleSpace()
 
         for (int q = 0; q < _options.nbSlicePerOctave; ++q)
         {
-            _evolution.emplace_back(TEvolution());
-            TEvolution& evo = _evolution.back();
+            TEvolution& evo = _evolution[p * _options.nbSlicePerOctave + q];
 
             // compute Slice at (p,q) index
             computeAKAZESlice(input, p, q, _options.nbSlicePerOctave, _options.sigma0, contrastFactor, evo.cur, evo.Lx, evo.Ly, evo.Lhess);
@@ -100,8 +100,10 @@ class AKAZE
      * @brief Constructor
      * @param[in] image Input image
      * @param[in] options AKAZE configuration options
+     * @param[in,out] evolution Scale space slices reused between the images (optional),
+     *                          their memory is kept for the images of the same size
      */
-    AKAZE(const image::Image<float>& image, const AKAZEOptions& options);
+    AKAZE(const image::Image<float>& image, const AKAZEOptions& options, std::vector<TEvolution>* evolution = nullptr);
 
     /**
      * @brief Compute the AKAZE non linear diffusion scale space per slice
@@ -151,8 +153,10 @@ class AKAZE
   private:
     /// configuration options for AKAZE
     AKAZEOptions _options;
+    /// vector of nonlinear diffusion evolution (Scale Space), if not given to the constructor
+    std::vector<TEvolution> _ownedEvolution;
     /// vector of nonlinear diffusion evolution (Scale Space)
-    std::vector<TEvolution> _evolution;
+    std::vector<TEvolution>& _evolution;
     /// input image
     image::Image<float> _input;
 };
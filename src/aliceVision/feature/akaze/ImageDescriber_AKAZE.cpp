@@ -15,10 +15,14 @@ bool ImageDescriber_AKAZE::describe(const image::Image<float>& image, std::uniqu
     _params.options.descFactor =
       (_params.akazeDescriptorType == AKAZE_MSURF || _params.akazeDescriptorType == AKAZE_LIOP) ? 10.f * sqrtf(2.f) : 11.f * sqrtf(2.f);  // MLDB
 
-    std::vector<AKAZEKeypoint> keypoints;
+    AKAZEBuffers localBuffers;
+    AKAZEBuffers& buffers = _reuseBuffers ? _buffers.local() : localBuffers;
+
+    std::vector<AKAZEKeypoint>& keypoints = buffers.keypoints;
+    keypoints.clear();
     keypoints.reserve(_params.options.maxTotalKeypoints * 2);
 
-    AKAZE akaze(image, _params.options);
+    AKAZE akaze(image, _params.options, &buffers.evolution);
     akaze.computeScaleSpace();
     akaze.featureDetection(keypoints);
     akaze.subpixelRefinement(keypoints);
@@ -11,6 +11,7 @@
 #include <aliceVision/feature/ImageDescriber.hpp>
 #include <aliceVision/feature/imageDescriberCommon.hpp>
 #include <aliceVision/feature/regionsFactory.hpp>
+#include <aliceVision/feature/ThreadBufferCache.hpp>
 #include <aliceVision/feature/akaze/AKAZE.hpp>
 #include <aliceVision/feature/akaze/descriptorLIOP.hpp>
 #include <aliceVision/feature/akaze/descriptorMLDB.hpp>
@@ -181,9 +182,26 @@ class ImageDescriber_AKAZE : public ImageDescriber
 
     ~ImageDescriber_AKAZE() override = default;
 
+    /**
+     * @brief Release the temporary buffers kept for the next images
+     */
+    void releaseBuffers() override { _buffers.clear(); }
+
   private:
+    /**
+     * @brief Temporary buffers of an AKAZE extraction, reused between the images of the same size.
+     */
+    struct AKAZEBuffers
+    {
+        /// scale space slices
+        std::vector<AKAZE::TEvolution> evolution;
+        /// detected keypoints
+        std::vector<AKAZEKeypoint> keypoints;
+    };
+
     AKAZEParams _params;
     bool _isOriented = true;
+    ThreadBufferCache<AKAZEBuffers> _buffers;
 };
 
 }  // namespace feature
@@ -13,7 +13,41 @@
 namespace aliceVision {
 namespace feature {
 
-DescriptorExtractor_LIOP::DescriptorExtractor_LIOP() { GeneratePatternMap(m_LiopPatternMap, m_LiopPosWeight, _liopNum); }
+DescriptorExtractor_LIOP::DescriptorExtractor_LIOP()
+{
+    GeneratePatternMap(m_LiopPatternMap, m_LiopPosWeight, _liopNum);
+
+    const int offsetWidth = 2 * _offsetRadius + 1;
+    m_sampleOffsets.resize(offsetWidth * offsetWidth * 2 * _liopNum);
+
+    for (int y = -_offsetRadius; y <= _offsetRadius; ++y)
+    {
+        for (int x = -_offsetRadius; x <= _offsetRadius; ++x)
+        {
+            const int index = (y + _offsetRadius) * offsetWidth + x + _offsetRadius;
+            computeSampleOffsets(x, y, &m_sampleOffsets[index * 2 * _liopNum]);
+        }
+    }
+}
+
+void DescriptorExtractor_LIOP::computeSampleOffsets(int x, int y, float offsets[2 * _liopNum])
+{
+    const float theta = 2.0f * M_PI / (float)_liopNum;
+
+    const float nDirX = static_cast<float>(x);
+    const float nDirY = static_cast<float>(y);
+    float nOri = atan2(nDirY, nDirX);
+    if (fabs(nOri - M_PI) < FLT_EPSILON)  //[-M_PI, M_PI)
+    {
+        nOri = static_cast<float>(-M_PI);
+    }
+
+    for (int k = 0; k < _liopNum; k++)
+    {
+        offsets[2 * k] = _lsRadius * cos(nOri + k * theta);
+        offsets[2 * k + 1] = _lsRadius * sin(nOri + k * theta);
+    }
+}
 
 struct Pixel
 {
@@ -153,8 +187,8 @@ void DescriptorExtractor_LIOP::CreateLIOP_GOrder(const image::Image<float>& outP
     const float inRadius2 = float(inRadius * inRadius);
     const int outRadius = outPatch.width() / 2;
 
-    const int lsRadius = 6;
-    const float theta = 2.0f * M_PI / (float)_liopNum;
+    const int offsetWidth = 2 * _offsetRadius + 1;
+    float pixelOffsets[2 * _liopNum];
 
     Pixel pixel[_maxPixelNum];
     int pixelCount = 0;
@@ -175,22 +209,21 @@ void DescriptorExtractor_LIOP::CreateLIOP_GOrder(const image::Image<float>& outP
             if (cur_flag == 0)
                 continue;
 
-            const float nDirX = static_cast<float>(x);
-            const float nDirY = static_cast<float>(y);
-            float nOri = atan2(nDirY, nDirX);
-            if (fabs(nOri - M_PI) < FLT_EPSILON)  //[-M_PI, M_PI)
+            const float* offsets = pixelOffsets;
+            if (std::abs(x) <= _offsetRadius && std::abs(y) <= _offsetRadius)
             {
-                nOri = static_cast<float>(-M_PI);
+                offsets = &m_sampleOffsets[((y + _offsetRadius) * offsetWidth + x + _offsetRadius) * 2 * _liopNum];
+            }
+            else
+            {
+                computeSampleOffsets(x, y, pixelOffsets);
             }
 
             bool isInBound = true;
             for (int k = 0; k < _liopNum; k++)
             {
-                const float deltaX = lsRadius * cos(nOri + k * theta);
-                const float deltaY = lsRadius * sin(nOri + k * theta);
-
-                const float sampleX = x + deltaX + outRadius;
-                const float sampleY = y + deltaY + outRadius;
+                const float sampleX = x + offsets[2 * k] + outRadius;
+                const float sampleY = y + offsets[2 * k + 1] + outRadius;
                 float gray;
 
                 if (!BilinearInterpolation_BorderCheck(gray, sampleX, sampleY, outPatch, flagPatch))
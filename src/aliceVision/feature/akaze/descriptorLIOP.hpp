@@ -33,12 +33,24 @@ class DescriptorExtractor_LIOP
   private:
     std::map<int, unsigned char> m_LiopPatternMap;
     std::vector<int> m_LiopPosWeight;
+    /// sampling offsets of the neighbors of each pixel of the patch, they only depend on the pixel position
+    std::vector<float> m_sampleOffsets;
 
     static const int _maxRegionNum = 10;
     static const int _maxPixelNum = 1681;
     static const int _maxSampleNum = 10;
     static const int _liopNum = 4;
     static const int _regionNum = 6;
+    static const int _lsRadius = 6;
+    static const int _offsetRadius = 15;  // patch radius used by extract
+
+    /**
+     * @brief Compute the sampling offsets of the neighbors of a patch pixel
+     * @param[in] x the pixel column relative to the patch center
+     * @param[in] y the pixel row relative to the patch center
+     * @param[out] offsets the x and y offsets of each neighbor
+     */
+    static void computeSampleOffsets(int x, int y, float offsets[2 * _liopNum]);
 
   public:
     DescriptorExtractor_LIOP();
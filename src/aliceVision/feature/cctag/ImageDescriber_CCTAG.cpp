@@ -8,6 +8,7 @@
 #include "ImageDescriber_CCTAG.hpp"
 #include <aliceVision/gpu/gpu.hpp>
 #include <aliceVision/system/Logger.hpp>
+#include <aliceVision/alicevision_omp.hpp>
 
 #include <cctag/ICCTag.hpp>
 #include <cctag/utils/LogTime.hpp>
@@ -75,6 +76,67 @@ void ImageDescriber_CCTAG::setUseCuda(bool useCuda) { _params._internalParams->_
 bool ImageDescriber_CCTAG::describe(const image::Image<unsigned char>& image,
                                     std::unique_ptr<Regions>& regions,
                                     const image::Image<unsigned char>* mask)
+{
+    detect(image, regions, _cudaPipe);
+    return true;
+}
+
+void ImageDescriber_CCTAG::describeBatch(const std::vector<const image::Image<unsigned char>*>& images,
+                                         const std::function<void(std::size_t, std::unique_ptr<Regions>&)>& onRegions)
+{
+    if (!useCuda() || images.size() <= 1)
+    {
+        ImageDescriber::describeBatch(images, onRegions);
+        return;
+    }
+
+    // each CUDA pipe has its own streams and device buffers: the images of the batch are detected concurrently
+    const int nbPipes = std::min(static_cast<int>(images.size()), maxConcurrentCudaPipes);
+
+    ALICEVISION_LOG_DEBUG("CCTag detection of " << images.size() << " images on " << nbPipes << " CUDA pipes.");
+
+    std::vector<std::exception_ptr> exceptions(images.size());
+    // first failed image, only accessed in the ordered region
+    int failedIndex = -1;
+
+    // the regions are given to the callback in the images order, while the next images are detected
+#pragma omp parallel for ordered schedule(static, 1) num_threads(nbPipes)
+    for (int i = 0; i < static_cast<int>(images.size()); ++i)
+    {
+        std::unique_ptr<Regions> regions;
+        try
+        {
+            detect(*images.at(i), regions, _cudaPipe + i % nbPipes);
+        }
+        catch (...)
+        {
+            exceptions.at(i) = std::current_exception();
+        }
+
+#pragma omp ordered
+        {
+            if (failedIndex < 0)
+            {
+                try
+                {
+                    if (exceptions.at(i))
+                        std::rethrow_exception(exceptions.at(i));
+                    onRegions(i, regions);
+                }
+                catch (...)
+                {
+                    exceptions.at(i) = std::current_exception();
+                    failedIndex = i;
+                }
+            }
+        }
+    }
+
+    if (failedIndex >= 0)
+        std::rethrow_exception(exceptions.at(failedIndex));
+}
+
+void ImageDescriber_CCTAG::detect(const image::Image<unsigned char>& image, std::unique_ptr<Regions>& regions, int cudaPipe) const
 {
     if (!_doAppend)
         allocate(regions);
@@ -88,7 +150,7 @@ bool ImageDescriber_CCTAG::describe(const image::Image<unsigned char>& image,
     regionsCasted->Descriptors().reserve(regionsCasted->Descriptors().size() + 50);
 
     boost::ptr_list<cctag::ICCTag> cctags;
-    cctag::logtime::Mgmt* durations = new cctag::logtime::Mgmt(25);
+    std::unique_ptr<cctag::logtime::Mgmt> durations(new cctag::logtime::Mgmt(25));
     // cctag::CCTagMarkersBank bank(_params._nCrowns);
 
 #ifndef CPU_ADAPT_OF_GPU_PART
@@ -96,11 +158,11 @@ bool ImageDescriber_CCTAG::describe(const image::Image<unsigned char>& image,
     //// Invert the image
     // cv::Mat invertImg;
     // cv::bitwise_not(graySrc,invertImg);
-    cctag::cctagDetection(cctags, _cudaPipe, 1, graySrc, *_params._internalParams, durations);
+    cctag::cctagDetection(cctags, cudaPipe, 1, graySrc, *_params._internalParams, durations.get());
 #else  // todo: #ifdef depreciated
     cctag::MemoryPool::instance().updateMemoryAuthorizedWithRAM();
     cctag::View cctagView((const unsigned char*)image.data(), image.width(), image.height(), image.depth() * image.width());
-    cctag::cctagDetection(cctags, _cudaPipe, 1, cctagView._grayView, *_params._internalParams, durations);
+    cctag::cctagDetection(cctags, cudaPipe, 1, cctagView._grayView, *_params._internalParams, durations.get());
 #endif
     durations->print(std::cerr);
 
@@ -127,8 +189,6 @@ bool ImageDescriber_CCTAG::describe(const image::Image<unsigned char>& image,
     }
 
     cctags.clear();
-
-    return true;
 }
 
 }  // namespace feature
@@ -90,6 +90,16 @@ class ImageDescriber_CCTAG : public ImageDescriber
                   std::unique_ptr<Regions>& regions,
                   const image::Image<unsigned char>* mask = nullptr) override;
 
+    /**
+     * @brief Detect regions on a batch of 8-bit images and compute their attributes (description).
+     *        With CUDA, the images are processed concurrently, each one on its own CUDA pipe.
+     * @param[in] images The 8-bit images
+     * @param[in] onRegions The callback called with the index of the image in the batch and its regions
+     */
+    void describeBatch(const std::vector<const image::Image<unsigned char>*>& images,
+                       const std::function<void(std::size_t, std::unique_ptr<Regions>&)>& onRegions) override;
+    using ImageDescriber::describeBatch;
+
     /**
      * @brief Allocate Regions type depending of the ImageDescriber
      * @param[in,out] regions
@@ -110,6 +120,17 @@ class ImageDescriber_CCTAG : public ImageDescriber
     };
 
   private:
+    /// maximum number of CUDA pipes used concurrently by a batch, from the CUDA pipe set with setCudaPipe
+    static constexpr int maxConcurrentCudaPipes = 4;
+
+    /**
+     * @brief Detect the CCTags of an 8-bit image on the given CUDA pipe
+     * @param[in] image Image.
+     * @param[in,out] regions The detected regions, allocated if regions are not appended
+     * @param[in] cudaPipe The CUDA pipe id
+     */
+    void detect(const image::Image<unsigned char>& image, std::unique_ptr<Regions>& regions, int cudaPipe) const;
+
     // CCTag parameters
     CCTagParameters _params;
     bool _doAppend = false;
@@ -128,4 +128,15 @@ BOOST_AUTO_TEST_CASE(descriptorIO_BINARY)
         for (int j = 0; j < DESC_LENGTH; ++j)
             BOOST_CHECK_EQUAL(vec_descs[i][j], vec_descs_read[i][j]);
     }
+
+    // Read a subset of the saved data with a conversion to another descriptor type
+    std::vector<Descriptor<double, DESC_LENGTH>> vec_descs_converted;
+    BOOST_CHECK_NO_THROW((loadDescsFromBinFile<Descriptor<double, DESC_LENGTH>, Desc_T>("tempDescsBin.desc", vec_descs_converted, false, CARD / 2)));
+    BOOST_CHECK_EQUAL(CARD / 2, vec_descs_converted.size());
+
+    for (int i = 0; i < CARD / 2; ++i)
+    {
+        for (int j = 0; j < DESC_LENGTH; ++j)
+            BOOST_CHECK_EQUAL(double(vec_descs[i][j]), vec_descs_converted[i][j]);
+    }
 }
@@ -8,6 +8,7 @@
 #pragma once
 
 #include "Hamming.hpp"
+#include "metricKernels.hpp"
 
 #include <aliceVision/numeric/Accumulator.hpp>
 #include <aliceVision/config.hpp>
@@ -15,6 +16,7 @@
 #if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_SSE)
     #include <aliceVision/system/Logger.hpp>
     #include <xmmintrin.h>
+    #include <emmintrin.h>
 #endif
 
 #include <cstddef>
@@ -121,10 +123,42 @@ inline float l2_sse(const float* b1, const float* b2, int size)
         return 0.0f;
     }
 }
+
+// Euclidean distance (SSE2 method) (squared result) on unsigned char descriptors
+inline float l2_sse_uchar(const unsigned char* b1, const unsigned char* b2, std::size_t size)
+{
+    const __m128i zeros = _mm_setzero_si128();
+    __m128i cumSum = _mm_setzero_si128();
+    std::size_t i = 0;
+    for (; i + 16 <= size; i += 16)
+    {
+        const __m128i srcA = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b1 + i));
+        const __m128i srcB = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b2 + i));
+        //-- Widen to 16 bits and subtract
+        const __m128i diffLow = _mm_sub_epi16(_mm_unpacklo_epi8(srcA, zeros), _mm_unpacklo_epi8(srcB, zeros));
+        const __m128i diffHigh = _mm_sub_epi16(_mm_unpackhi_epi8(srcA, zeros), _mm_unpackhi_epi8(srcB, zeros));
+        //-- Multiply and sum pairs into 32 bits
+        cumSum = _mm_add_epi32(cumSum, _mm_madd_epi16(diffLow, diffLow));
+        cumSum = _mm_add_epi32(cumSum, _mm_madd_epi16(diffHigh, diffHigh));
+    }
+    int res[4];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(res), cumSum);
+    int result = res[0] + res[1] + res[2] + res[3];
+    // Process the last 0-15 values. Not needed for standard descriptor lengths.
+    for (; i < size; ++i)
+    {
+        const int diff = int(b1[i]) - int(b2[i]);
+        result += diff * diff;
+    }
+    return static_cast<float>(result);
+}
+
 }  // namespace optim_ss2
 
-// Template specification to run SSE L2 squared distance
-//  on float vector
+#endif  // ALICEVISION_HAVE_SSE
+
+// Template specification to run the L2 squared distance
+//  on float vector with the SIMD instructions of the CPU
 template<>
 struct L2_Vectorized<float>
 {
@@ -134,11 +168,24 @@ struct L2_Vectorized<float>
     template<typename Iterator1, typename Iterator2>
     inline ResultType operator()(Iterator1 a, Iterator2 b, size_t size) const
     {
-        return optim_ss2::l2_sse(a, b, size);
+        return squaredL2(&(*a), &(*b), size);
     }
 };
 
-#endif  // ALICEVISION_HAVE_SSE
+// Template specification to run the L2 squared distance
+//  on unsigned char vector with the SIMD instructions of the CPU
+template<>
+struct L2_Vectorized<unsigned char>
+{
+    typedef unsigned char ElementType;
+    typedef Accumulator<unsigned char>::Type ResultType;
+
+    template<typename Iterator1, typename Iterator2>
+    inline ResultType operator()(Iterator1 a, Iterator2 b, size_t size) const
+    {
+        return static_cast<ResultType>(squaredL2(&(*a), &(*b), size));
+    }
+};
 
 }  // namespace feature
 }  // namespace aliceVision
@@ -0,0 +1,367 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "metricKernels.hpp"
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(ALICEVISION_SIMD_X86)
+    #include <immintrin.h>
+#endif
+
+namespace aliceVision {
+namespace feature {
+
+namespace {
+
+using SquaredL2FloatKernel = float(const float*, const float*, std::size_t);
+using SquaredL2UCharKernel = unsigned int(const unsigned char*, const unsigned char*, std::size_t);
+using HammingKernel = unsigned int(const unsigned char*, const unsigned char*, std::size_t);
+
+//--------------------------------------------------------------------------
+// Generic implementations
+//--------------------------------------------------------------------------
+
+float squaredL2FloatGeneric(const float* a, const float* b, std::size_t size)
+{
+    // 4 independent accumulators to hide the latency of the additions
+    float sum0 = 0.f, sum1 = 0.f, sum2 = 0.f, sum3 = 0.f;
+    std::size_t i = 0;
+    for (; i + 4 <= size; i += 4)
+    {
+        const float diff0 = a[i] - b[i];
+        const float diff1 = a[i + 1] - b[i + 1];
+        const float diff2 = a[i + 2] - b[i + 2];
+        const float diff3 = a[i + 3] - b[i + 3];
+        sum0 += diff0 * diff0;
+        sum1 += diff1 * diff1;
+        sum2 += diff2 * diff2;
+        sum3 += diff3 * diff3;
+    }
+    float result = (sum0 + sum1) + (sum2 + sum3);
+    for (; i < size; ++i)
+    {
+        const float diff = a[i] - b[i];
+        result += diff * diff;
+    }
+    return result;
+}
+
+unsigned int squaredL2UCharGeneric(const unsigned char* a, const unsigned char* b, std::size_t size)
+{
+    unsigned int result = 0;
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        const int diff = int(a[i]) - int(b[i]);
+        result += static_cast<unsigned int>(diff * diff);
+    }
+    return result;
+}
+
+inline unsigned int popcount64Generic(std::uint64_t n)
+{
+    n -= ((n >> 1) & 0x5555555555555555ULL);
+    n = (n & 0x3333333333333333ULL) + ((n >> 2) & 0x3333333333333333ULL);
+    return static_cast<unsigned int>((((n + (n >> 4)) & 0x0f0f0f0f0f0f0f0fULL) * 0x0101010101010101ULL) >> 56);
+}
+
+unsigned int hammingGeneric(const unsigned char* a, const unsigned char* b, std::size_t size)
+{
+    unsigned int result = 0;
+    std::size_t i = 0;
+    for (; i + 8 <= size; i += 8)
+    {
+        std::uint64_t wordA, wordB;
+        std::memcpy(&wordA, a + i, sizeof(wordA));
+        std::memcpy(&wordB, b + i, sizeof(wordB));
+        result += popcount64Generic(wordA ^ wordB);
+    }
+    for (; i < size; ++i)
+        result += popcount64Generic(static_cast<std::uint64_t>(a[i] ^ b[i]));
+    return result;
+}
+
+#if defined(ALICEVISION_SIMD_X86)
+
+//--------------------------------------------------------------------------
+// SSE2 implementations
+//--------------------------------------------------------------------------
+
+ALICEVISION_TARGET_SSE2 float squaredL2FloatSse2(const float* a, const float* b, std::size_t size)
+{
+    __m128 sum0 = _mm_setzero_ps();
+    __m128 sum1 = _mm_setzero_ps();
+    std::size_t i = 0;
+    for (; i + 8 <= size; i += 8)
+    {
+        const __m128 diff0 = _mm_sub_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i));
+        const __m128 diff1 = _mm_sub_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4));
+        sum0 = _mm_add_ps(sum0, _mm_mul_ps(diff0, diff0));
+        sum1 = _mm_add_ps(sum1, _mm_mul_ps(diff1, diff1));
+    }
+    float sums[4];
+    _mm_storeu_ps(sums, _mm_add_ps(sum0, sum1));
+    float result = (sums[0] + sums[1]) + (sums[2] + sums[3]);
+    for (; i < size; ++i)
+    {
+        const float diff = a[i] - b[i];
+        result += diff * diff;
+    }
+    return result;
+}
+
+ALICEVISION_TARGET_SSE2 unsigned int squaredL2UCharSse2(const unsigned char* a, const unsigned char* b, std::size_t size)
+{
+    const __m128i zeros = _mm_setzero_si128();
+    __m128i sum = _mm_setzero_si128();
+    std::size_t i = 0;
+    for (; i + 16 <= size; i += 16)
+    {
+        const __m128i srcA = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        const __m128i srcB = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        // widen to 16 bits, subtract, then multiply and sum pairs into 32 bits
+        const __m128i diffLow = _mm_sub_epi16(_mm_unpacklo_epi8(srcA, zeros), _mm_unpacklo_epi8(srcB, zeros));
+        const __m128i diffHigh = _mm_sub_epi16(_mm_unpackhi_epi8(srcA, zeros), _mm_unpackhi_epi8(srcB, zeros));
+        sum = _mm_add_epi32(sum, _mm_madd_epi16(diffLow, diffLow));
+        sum = _mm_add_epi32(sum, _mm_madd_epi16(diffHigh, diffHigh));
+    }
+    unsigned int sums[4];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(sums), sum);
+    return sums[0] + sums[1] + sums[2] + sums[3] + squaredL2UCharGeneric(a + i, b + i, size - i);
+}
+
+//--------------------------------------------------------------------------
+// AVX2 implementations
+//--------------------------------------------------------------------------
+
+ALICEVISION_TARGET_AVX2 inline float horizontalSum(__m256 value)
+{
+    const __m128 sum4 = _mm_add_ps(_mm256_castps256_ps128(value), _mm256_extractf128_ps(value, 1));
+    const __m128 sum2 = _mm_add_ps(sum4, _mm_movehl_ps(sum4, sum4));
+    return _mm_cvtss_f32(_mm_add_ss(sum2, _mm_shuffle_ps(sum2, sum2, 1)));
+}
+
+ALICEVISION_TARGET_AVX2 inline unsigned int horizontalSum(__m256i value)
+{
+    const __m128i sum4 = _mm_add_epi32(_mm256_castsi256_si128(value), _mm256_extracti128_si256(value, 1));
+    const __m128i sum2 = _mm_add_epi32(sum4, _mm_unpackhi_epi64(sum4, sum4));
+    return static_cast<unsigned int>(_mm_cvtsi128_si32(_mm_add_epi32(sum2, _mm_shuffle_epi32(sum2, 1))));
+}
+
+ALICEVISION_TARGET_AVX2 float squaredL2FloatAvx2(const float* a, const float* b, std::size_t size)
+{
+    // 4 independent accumulators to hide the latency of the FMA
+    __m256 sum0 = _mm256_setzero_ps();
+    __m256 sum1 = _mm256_setzero_ps();
+    __m256 sum2 = _mm256_setzero_ps();
+    __m256 sum3 = _mm256_setzero_ps();
+    std::size_t i = 0;
+    for (; i + 32 <= size; i += 32)
+    {
+        const __m256 diff0 = _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i));
+        const __m256 diff1 = _mm256_sub_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8));
+        const __m256 diff2 = _mm256_sub_ps(_mm256_loadu_ps(a + i + 16), _mm256_loadu_ps(b + i + 16));
+        const __m256 diff3 = _mm256_sub_ps(_mm256_loadu_ps(a + i + 24), _mm256_loadu_ps(b + i + 24));
+        sum0 = _mm256_fmadd_ps(diff0, diff0, sum0);
+        sum1 = _mm256_fmadd_ps(diff1, diff1, sum1);
+        sum2 = _mm256_fmadd_ps(diff2, diff2, sum2);
+        sum3 = _mm256_fmadd_ps(diff3, diff3, sum3);
+    }
+    for (; i + 8 <= size; i += 8)
+    {
+        const __m256 diff = _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i));
+        sum0 = _mm256_fmadd_ps(diff, diff, sum0);
+    }
+    float result = horizontalSum(_mm256_add_ps(_mm256_add_ps(sum0, sum1), _mm256_add_ps(sum2, sum3)));
+    for (; i < size; ++i)
+    {
+        const float diff = a[i] - b[i];
+        result += diff * diff;
+    }
+    return result;
+}
+
+ALICEVISION_TARGET_AVX2 unsigned int squaredL2UCharAvx2(const unsigned char* a, const unsigned char* b, std::size_t size)
+{
+    __m256i sum0 = _mm256_setzero_si256();
+    __m256i sum1 = _mm256_setzero_si256();
+    std::size_t i = 0;
+    for (; i + 32 <= size; i += 32)
+    {
+        // widen 16 values to 16 bits, subtract, then multiply and sum pairs into 32 bits
+        const __m256i diff0 = _mm256_sub_epi16(_mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i))),
+                                               _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i))));
+        const __m256i diff1 = _mm256_sub_epi16(_mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i + 16))),
+                                               _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i + 16))));
+        sum0 = _mm256_add_epi32(sum0, _mm256_madd_epi16(diff0, diff0));
+        sum1 = _mm256_add_epi32(sum1, _mm256_madd_epi16(diff1, diff1));
+    }
+    return horizontalSum(_mm256_add_epi32(sum0, sum1)) + squaredL2UCharGeneric(a + i, b + i, size - i);
+}
+
+ALICEVISION_TARGET_AVX2 unsigned int hammingPopcnt(const unsigned char* a, const unsigned char* b, std::size_t size)
+{
+    unsigned int result = 0;
+    std::size_t i = 0;
+    #if defined(__x86_64__) || defined(_M_X64)
+    for (; i + 8 <= size; i += 8)
+    {
+        std::uint64_t wordA, wordB;
+        std::memcpy(&wordA, a + i, sizeof(wordA));
+        std::memcpy(&wordB, b + i, sizeof(wordB));
+        result += static_cast<unsigned int>(_mm_popcnt_u64(wordA ^ wordB));
+    }
+    #endif
+    for (; i + 4 <= size; i += 4)
+    {
+        std::uint32_t wordA, wordB;
+        std::memcpy(&wordA, a + i, sizeof(wordA));
+        std::memcpy(&wordB, b + i, sizeof(wordB));
+        result += static_cast<unsigned int>(_mm_popcnt_u32(wordA ^ wordB));
+    }
+    for (; i < size; ++i)
+        result += static_cast<unsigned int>(_mm_popcnt_u32(a[i] ^ b[i]));
+    return result;
+}
+
+//--------------------------------------------------------------------------
+// AVX-512 implementations
+//--------------------------------------------------------------------------
+
+// the halves are reloaded from memory rather than extracted, the extraction intrinsics of GCC 12 raise spurious -Wuninitialized warnings
+ALICEVISION_TARGET_AVX512 inline float horizontalSum(__m512 value)
+{
+    float values[16];
+    _mm512_storeu_ps(values, value);
+    return horizontalSum(_mm256_add_ps(_mm256_loadu_ps(values), _mm256_loadu_ps(values + 8)));
+}
+
+ALICEVISION_TARGET_AVX512 inline unsigned int horizontalSum(__m512i value)
+{
+    int values[16];
+    _mm512_storeu_si512(values, value);
+    return horizontalSum(_mm256_add_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(values)),
+                                          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + 8))));
+}
+
+ALICEVISION_TARGET_AVX512 float squaredL2FloatAvx512(const float* a, const float* b, std::size_t size)
+{
+    __m512 sum0 = _mm512_setzero_ps();
+    __m512 sum1 = _mm512_setzero_ps();
+    std::size_t i = 0;
+    for (; i + 32 <= size; i += 32)
+    {
+        const __m512 diff0 = _mm512_sub_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i));
+        const __m512 diff1 = _mm512_sub_ps(_mm512_loadu_ps(a + i + 16), _mm512_loadu_ps(b + i + 16));
+        sum0 = _mm512_fmadd_ps(diff0, diff0, sum0);
+        sum1 = _mm512_fmadd_ps(diff1, diff1, sum1);
+    }
+    // the last 0-31 values with masked loads
+    for (; i < size; i += 16)
+    {
+        const __mmask16 mask = (size - i >= 16) ? __mmask16(0xFFFF) : __mmask16((1u << (size - i)) - 1);
+        const __m512 diff = _mm512_sub_ps(_mm512_maskz_loadu_ps(mask, a + i), _mm512_maskz_loadu_ps(mask, b + i));
+        sum0 = _mm512_fmadd_ps(diff, diff, sum0);
+    }
+    return horizontalSum(_mm512_add_ps(sum0, sum1));
+}
+
+ALICEVISION_TARGET_AVX512 unsigned int squaredL2UCharAvx512(const unsigned char* a, const unsigned char* b, std::size_t size)
+{
+    __m512i sum0 = _mm512_setzero_si512();
+    __m512i sum1 = _mm512_setzero_si512();
+    std::size_t i = 0;
+    for (; i + 64 <= size; i += 64)
+    {
+        // widen 32 values to 16 bits, subtract, then multiply and sum pairs into 32 bits
+        const __m512i diff0 = _mm512_sub_epi16(_mm512_cvtepu8_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i))),
+                                               _mm512_cvtepu8_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i))));
+        const __m512i diff1 = _mm512_sub_epi16(_mm512_cvtepu8_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i + 32))),
+                                               _mm512_cvtepu8_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i + 32))));
+        sum0 = _mm512_add_epi32(sum0, _mm512_madd_epi16(diff0, diff0));
+        sum1 = _mm512_add_epi32(sum1, _mm512_madd_epi16(diff1, diff1));
+    }
+    // the last 0-63 values with masked loads
+    for (; i < size; i += 32)
+    {
+        const __mmask32 mask = (size - i >= 32) ? __mmask32(0xFFFFFFFF) : __mmask32((1u << (size - i)) - 1);
+        const __m512i diff =
+          _mm512_sub_epi16(_mm512_cvtepu8_epi16(_mm256_maskz_loadu_epi8(mask, a + i)), _mm512_cvtepu8_epi16(_mm256_maskz_loadu_epi8(mask, b + i)));
+        sum0 = _mm512_add_epi32(sum0, _mm512_madd_epi16(diff, diff));
+    }
+    return horizontalSum(_mm512_add_epi32(sum0, sum1));
+}
+
+#endif  // ALICEVISION_SIMD_X86
+
+SquaredL2FloatKernel* selectSquaredL2Float(system::ESimdLevel simdLevel)
+{
+#if defined(ALICEVISION_SIMD_X86)
+    return system::selectSimdImplementation<SquaredL2FloatKernel>(
+      simdLevel, &squaredL2FloatGeneric, &squaredL2FloatSse2, &squaredL2FloatAvx2, &squaredL2FloatAvx512);
+#else
+    return &squaredL2FloatGeneric;
+#endif
+}
+
+SquaredL2UCharKernel* selectSquaredL2UChar(system::ESimdLevel simdLevel)
+{
+#if defined(ALICEVISION_SIMD_X86)
+    return system::selectSimdImplementation<SquaredL2UCharKernel>(
+      simdLevel, &squaredL2UCharGeneric, &squaredL2UCharSse2, &squaredL2UCharAvx2, &squaredL2UCharAvx512);
+#else
+    return &squaredL2UCharGeneric;
+#endif
+}
+
+HammingKernel* selectHamming(system::ESimdLevel simdLevel)
+{
+#if defined(ALICEVISION_SIMD_X86)
+    // POPCNT is part of the AVX2 level, there is no faster AVX-512 version without the VPOPCNTDQ extension
+    return system::selectSimdImplementation<HammingKernel>(simdLevel, &hammingGeneric, nullptr, &hammingPopcnt, nullptr);
+#else
+    return &hammingGeneric;
+#endif
+}
+
+}  // namespace
+
+float squaredL2(const float* a, const float* b, std::size_t size, system::ESimdLevel simdLevel)
+{
+    return selectSquaredL2Float(simdLevel)(a, b, size);
+}
+
+float squaredL2(const float* a, const float* b, std::size_t size)
+{
+    static SquaredL2FloatKernel* const kernel = selectSquaredL2Float(system::getSimdLevel());
+    return kernel(a, b, size);
+}
+
+unsigned int squaredL2(const unsigned char* a, const unsigned char* b, std::size_t size, system::ESimdLevel simdLevel)
+{
+    return selectSquaredL2UChar(simdLevel)(a, b, size);
+}
+
+unsigned int squaredL2(const unsigned char* a, const unsigned char* b, std::size_t size)
+{
+    static SquaredL2UCharKernel* const kernel = selectSquaredL2UChar(system::getSimdLevel());
+    return kernel(a, b, size);
+}
+
+unsigned int hammingDistance(const unsigned char* a, const unsigned char* b, std::size_t size, system::ESimdLevel simdLevel)
+{
+    return selectHamming(simdLevel)(a, b, size);
+}
+
+unsigned int hammingDistance(const unsigned char* a, const unsigned char* b, std::size_t size)
+{
+    static HammingKernel* const kernel = selectHamming(system::getSimdLevel());
+    return kernel(a, b, size);
+}
+
+}  // namespace feature
+}  // namespace aliceVision
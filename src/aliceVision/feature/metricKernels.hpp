@@ -0,0 +1,50 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/system/cpu.hpp>
+
+#include <cstddef>
+
+namespace aliceVision {
+namespace feature {
+
+// Descriptor distance kernels, vectorized for each SIMD level.
+// The overloads without SIMD level use the implementation selected once for the CPU (see system::getSimdLevel).
+
+/**
+ * @brief Squared Euclidean distance between two float vectors.
+ * @param[in] a, b the vectors, without alignment requirement
+ * @param[in] size the number of elements
+ * @param[in] simdLevel the SIMD level of the implementation, must be supported by the CPU
+ * @return the squared distance
+ */
+float squaredL2(const float* a, const float* b, std::size_t size, system::ESimdLevel simdLevel);
+float squaredL2(const float* a, const float* b, std::size_t size);
+
+/**
+ * @brief Squared Euclidean distance between two unsigned char vectors (e.g. SIFT descriptors).
+ * @param[in] a, b the vectors, without alignment requirement
+ * @param[in] size the number of elements
+ * @param[in] simdLevel the SIMD level of the implementation, must be supported by the CPU
+ * @return the squared distance
+ */
+unsigned int squaredL2(const unsigned char* a, const unsigned char* b, std::size_t size, system::ESimdLevel simdLevel);
+unsigned int squaredL2(const unsigned char* a, const unsigned char* b, std::size_t size);
+
+/**
+ * @brief Hamming distance between two binary vectors (e.g. AKAZE MLDB descriptors).
+ * @param[in] a, b the vectors, without alignment requirement
+ * @param[in] size the number of bytes
+ * @param[in] simdLevel the SIMD level of the implementation, must be supported by the CPU
+ * @return the number of different bits
+ */
+unsigned int hammingDistance(const unsigned char* a, const unsigned char* b, std::size_t size, system::ESimdLevel simdLevel);
+unsigned int hammingDistance(const unsigned char* a, const unsigned char* b, std::size_t size);
+
+}  // namespace feature
+}  // namespace aliceVision
@@ -0,0 +1,71 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/feature/metric.hpp>
+#include <aliceVision/feature/Hamming.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace aliceVision;
+using namespace aliceVision::feature;
+
+namespace {
+
+/**
+ * @brief Random descriptors, row major.
+ */
+template<typename T>
+std::vector<T> randomDescriptors(std::size_t nbDescriptors, std::size_t dimension)
+{
+    std::mt19937 generator(0);
+    std::uniform_int_distribution<int> distribution(0, 255);
+    std::vector<T> descriptors(nbDescriptors * dimension);
+    for (auto& value : descriptors)
+        value = static_cast<T>(distribution(generator));
+    return descriptors;
+}
+
+/**
+ * @brief Distances between one query and a database of descriptors (brute force matching inner loop).
+ * @param state range(0): number of database descriptors
+ * @tparam dimension number of elements of a descriptor
+ */
+template<typename Metric, std::size_t dimension>
+void BM_metric(benchmark::State& state)
+{
+    using T = typename Metric::ElementType;
+    const std::size_t nbDescriptors = static_cast<std::size_t>(state.range(0));
+    const std::vector<T> database = randomDescriptors<T>(nbDescriptors, dimension);
+    const std::vector<T> query = randomDescriptors<T>(1, dimension);
+    const Metric metric;
+
+    for (auto _ : state)
+    {
+        for (std::size_t i = 0; i < nbDescriptors; ++i)
+        {
+            benchmark::DoNotOptimize(metric(query.data(), database.data() + i * dimension, dimension));
+        }
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * nbDescriptors);
+    state.SetBytesProcessed(state.iterations() * nbDescriptors * dimension * sizeof(T));
+}
+
+}  // namespace
+
+// SIFT descriptors (128 dimensions)
+BENCHMARK_TEMPLATE(BM_metric, L2_Simple<unsigned char>, 128)->Arg(1 << 10)->Arg(1 << 14);
+BENCHMARK_TEMPLATE(BM_metric, L2_Vectorized<unsigned char>, 128)->Arg(1 << 10)->Arg(1 << 14);
+BENCHMARK_TEMPLATE(BM_metric, L2_Simple<float>, 128)->Arg(1 << 10)->Arg(1 << 14);
+BENCHMARK_TEMPLATE(BM_metric, L2_Vectorized<float>, 128)->Arg(1 << 10)->Arg(1 << 14);
+
+// binary descriptors (256 bits, e.g. AKAZE MLDB, ORB)
+BENCHMARK_TEMPLATE(BM_metric, Hamming<unsigned char>, 32)->Arg(1 << 10)->Arg(1 << 14);
@@ -8,7 +8,9 @@
 #include <aliceVision/feature/metric.hpp>
 
 #include <iostream>
+#include <random>
 #include <string>
+#include <vector>
 
 #define BOOST_TEST_MODULE matchingMetric
 
@@ -45,6 +47,29 @@ BOOST_AUTO_TEST_CASE(Metric_L2_Vectorized)
     BOOST_CHECK_EQUAL(168, DistanceT<L2_Vectorized<double>>());
 }
 
+BOOST_AUTO_TEST_CASE(Metric_L2_Vectorized_SIFT)
+{
+    // Compare the vectorized implementation against the simple one on SIFT-like descriptors
+    std::mt19937 generator(0);
+    std::uniform_int_distribution<int> distribution(0, 255);
+
+    for (const std::size_t size : {128, 130})
+    {
+        std::vector<unsigned char> array1(size);
+        std::vector<unsigned char> array2(size);
+        for (int i = 0; i < 10; ++i)
+        {
+            for (std::size_t j = 0; j < size; ++j)
+            {
+                array1[j] = distribution(generator);
+                array2[j] = distribution(generator);
+            }
+            BOOST_CHECK_EQUAL(L2_Simple<unsigned char>()(array1.data(), array2.data(), size),
+                              L2_Vectorized<unsigned char>()(array1.data(), array2.data(), size));
+        }
+    }
+}
+
 BOOST_AUTO_TEST_CASE(Metric_HAMMING_BITSET)
 {
     std::bitset<8> a(std::string("01010101"));
@@ -152,3 +177,47 @@ BOOST_AUTO_TEST_CASE(Metric_HAMMING_BITSET_RAW_MEMORY_32BITS)
         }
     }
 }
+
+BOOST_AUTO_TEST_CASE(Metric_SIMD_Levels)
+{
+    // Compare the implementation of each SIMD level supported by the CPU against the simple one,
+    //  on descriptor lengths with and without remaining values after the vectorized loops
+    const system::ESimdLevel detectedLevel = system::detectSimdLevel();
+    std::mt19937 generator(0);
+    std::uniform_int_distribution<int> distribution(0, 255);
+
+    for (const system::ESimdLevel level :
+         {system::ESimdLevel::Generic, system::ESimdLevel::SSE2, system::ESimdLevel::AVX2, system::ESimdLevel::AVX512})
+    {
+        if (level > detectedLevel)
+            continue;
+        BOOST_TEST_CONTEXT("SIMD level: " << level)
+        {
+            for (const std::size_t size : {0, 1, 7, 31, 32, 61, 64, 100, 128, 130})
+            {
+                std::vector<unsigned char> array1(size);
+                std::vector<unsigned char> array2(size);
+                std::vector<float> arrayf1(size);
+                std::vector<float> arrayf2(size);
+                for (std::size_t j = 0; j < size; ++j)
+                {
+                    array1[j] = distribution(generator);
+                    array2[j] = distribution(generator);
+                    arrayf1[j] = array1[j] / 255.f;
+                    arrayf2[j] = array2[j] / 255.f;
+                }
+
+                BOOST_CHECK_EQUAL(L2_Simple<unsigned char>()(array1.data(), array2.data(), size),
+                                  squaredL2(array1.data(), array2.data(), size, level));
+                BOOST_CHECK_CLOSE(L2_Simple<float>()(arrayf1.data(), arrayf2.data(), size) + 1.f,
+                                  squaredL2(arrayf1.data(), arrayf2.data(), size, level) + 1.f,
+                                  1e-4);
+
+                unsigned int hamming = 0;
+                for (std::size_t j = 0; j < size; ++j)
+                    hamming += std::bitset<8>(array1[j] ^ array2[j]).count();
+                BOOST_CHECK_EQUAL(hamming, hammingDistance(array1.data(), array2.data(), size, level));
+            }
+        }
+    }
+}
@@ -72,11 +72,18 @@ bool extractDSPSIFT(const image::Image<float>& image,
                     std::unique_ptr<Regions>& regions,
                     const DspSiftParams& params,
                     bool orientation,
-                    const image::Image<unsigned char>* mask)
+                    const image::Image<unsigned char>* mask,
+                    DspSiftBuffers* buffers)
 {
     const int w = image.width(), h = image.height();
     // Setup covariant SIFT detector.
-    std::unique_ptr<VlCovDet, void (*)(VlCovDet*)> covdet(vl_covdet_new(VL_COVDET_METHOD_DOG), &vl_covdet_delete);
+    // A reused detector keeps its scale space if the image geometry is the same, and reallocates it otherwise.
+    DspSiftBuffers localBuffers;
+    if (!buffers)
+        buffers = &localBuffers;
+    if (!buffers->covdet)
+        buffers->covdet.reset(vl_covdet_new(VL_COVDET_METHOD_DOG));
+    std::unique_ptr<VlCovDet, void (*)(VlCovDet*)>& covdet = buffers->covdet;
 
     // if image resolution is low, increase resolution for extraction
     const int firstOctave = params.getImageFirstOctave(w, h);
@@ -291,7 +298,12 @@ bool extractDSPSIFT(const image::Image<float>& image,
         regionsCasted->Features().resize(indexSort.size());
         regionsCasted->Descriptors().resize(indexSort.size());
 
-        std::unique_ptr<VlSiftFilt, void (*)(VlSiftFilt*)> sift(vl_sift_new(16, 16, 1, params._numScales, 0), &vl_sift_delete);
+        if (!buffers->sift || buffers->siftNumScales != params._numScales)
+        {
+            buffers->sift.reset(vl_sift_new(16, 16, 1, params._numScales, 0));
+            buffers->siftNumScales = params._numScales;
+        }
+        std::unique_ptr<VlSiftFilt, void (*)(VlSiftFilt*)>& sift = buffers->sift;
 
         // All constant parameters
         const size_t kPatchResolution = 15;
@@ -385,13 +397,15 @@ template bool extractDSPSIFT<float>(const image::Image<float>& image,
                                     std::unique_ptr<Regions>& regions,
                                     const DspSiftParams& params,
                                     bool orientation,
-                                    const image::Image<unsigned char>* mask);
+                                    const image::Image<unsigned char>* mask,
+                                    DspSiftBuffers* buffers);
 
 template bool extractDSPSIFT<unsigned char>(const image::Image<float>& image,
                                             std::unique_ptr<Regions>& regions,
                                             const DspSiftParams& params,
                                             bool orientation,
-                                            const image::Image<unsigned char>* mask);
+                                            const image::Image<unsigned char>* mask,
+                                            DspSiftBuffers* buffers);
 
 }  // namespace feature
 }  // namespace aliceVision
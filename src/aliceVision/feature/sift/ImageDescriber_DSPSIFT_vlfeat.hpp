@@ -10,13 +10,16 @@
 #include <aliceVision/feature/ImageDescriber.hpp>
 #include <aliceVision/feature/regionsFactory.hpp>
 #include <aliceVision/feature/sift/SIFT.hpp>
+#include <aliceVision/feature/ThreadBufferCache.hpp>
 
 extern "C"
 {
+#include <nonFree/sift/vl/covdet.h>
 #include <nonFree/sift/vl/sift.h>
 }
 
 #include <iostream>
+#include <memory>
 #include <numeric>
 
 namespace aliceVision {
@@ -33,12 +36,27 @@ struct DspSiftParams : public SiftParams
     void setPreset(ConfigurationPreset preset) override;
 };
 
+/**
+ * @brief Temporary buffers of a DSP-SIFT extraction, reused between the images.
+ *        The covariant detector keeps its scale space while the image geometry is the same.
+ */
+struct DspSiftBuffers
+{
+    /// VLFeat covariant detector, owning the scale space and the detected features
+    std::unique_ptr<VlCovDet, void (*)(VlCovDet*)> covdet{nullptr, &vl_covdet_delete};
+    /// VLFeat SIFT filter used to compute the patch descriptors
+    std::unique_ptr<VlSiftFilt, void (*)(VlSiftFilt*)> sift{nullptr, &vl_sift_delete};
+    /// number of scales of the SIFT filter
+    int siftNumScales = 0;
+};
+
 template<typename T>
 bool extractDSPSIFT(const image::Image<float>& image,
                     std::unique_ptr<Regions>& regions,
                     const DspSiftParams& params,
                     bool orientation,
-                    const image::Image<unsigned char>* mask);
+                    const image::Image<unsigned char>* mask,
+                    DspSiftBuffers* buffers = nullptr);
 
 /**
  * @brief Create an ImageDescriber interface for VLFeat SIFT feature extractor
@@ -122,9 +140,14 @@ class ImageDescriber_DSPSIFT_vlfeat : public ImageDescriber
      */
     bool describe(const image::Image<float>& image, std::unique_ptr<Regions>& regions, const image::Image<unsigned char>* mask = nullptr) override
     {
-        return extractDSPSIFT<unsigned char>(image, regions, _params, _isOriented, mask);
+        return extractDSPSIFT<unsigned char>(image, regions, _params, _isOriented, mask, _reuseBuffers ? &_buffers.local() : nullptr);
     }
 
+    /**
+     * @brief Release the temporary buffers kept for the next images
+     */
+    void releaseBuffers() override { _buffers.clear(); }
+
     /**
      * @brief Allocate Regions type depending of the ImageDescriber
      * @param[in,out] regions
@@ -133,6 +156,7 @@ class ImageDescriber_DSPSIFT_vlfeat : public ImageDescriber
 
   private:
     DspSiftParams _params;
+    ThreadBufferCache<DspSiftBuffers> _buffers;
     bool _isOriented;
 };
 
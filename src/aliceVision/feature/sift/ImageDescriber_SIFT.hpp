@@ -88,14 +88,31 @@ class ImageDescriber_SIFT : public ImageDescriber
         {
             _imageDescriberImpl.release();  // release first to ensure that we don't create the new ImageDescriber before destroying the previous one
             _imageDescriberImpl.reset(new ImageDescriber_SIFT_popSIFT(_params, _isOriented));
+            _imageDescriberImpl->setReuseBuffers(_reuseBuffers);
             return;
         }
 #endif
 
         _imageDescriberImpl.release();  // release first to ensure that we don't create the new ImageDescriber before destroying the previous one
         _imageDescriberImpl.reset(new ImageDescriber_SIFT_vlfeat(_params, _isOriented));
+        _imageDescriberImpl->setReuseBuffers(_reuseBuffers);
     }
 
+    /**
+     * @brief Keep the temporary buffers of the extraction between the images processed by a thread
+     * @param[in] reuseBuffers
+     */
+    void setReuseBuffers(bool reuseBuffers) override
+    {
+        ImageDescriber::setReuseBuffers(reuseBuffers);
+        _imageDescriberImpl->setReuseBuffers(reuseBuffers);
+    }
+
+    /**
+     * @brief Release the temporary buffers kept for the next images
+     */
+    void releaseBuffers() override { _imageDescriberImpl->releaseBuffers(); }
+
     /**
      * @brief set the CUDA pipe
      * @param[in] pipe The CUDA pipe id
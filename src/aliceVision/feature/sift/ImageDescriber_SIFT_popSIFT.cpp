@@ -14,41 +14,30 @@
 #include <popsift/sift_octave.h>
 #include <popsift/common/device_prop.h>
 
+#include <algorithm>
 #include <atomic>
+#include <stdexcept>
 
 namespace aliceVision {
 namespace feature {
 
-std::unique_ptr<PopSift> ImageDescriber_SIFT_popSIFT::_popSift{nullptr};
+std::vector<std::unique_ptr<PopSift>> ImageDescriber_SIFT_popSIFT::_popSifts;
 std::atomic<int> ImageDescriber_SIFT_popSIFT::_instanceCounter{0};
 
-void ImageDescriber_SIFT_popSIFT::setConfigurationPreset(ConfigurationPreset preset)
-{
-    _params.setPreset(preset);
-    _popSift.reset(nullptr);  // reset by describe method
-}
+namespace {
 
-bool ImageDescriber_SIFT_popSIFT::describe(const image::Image<float>& image,
-                                           std::unique_ptr<Regions>& regions,
-                                           const image::Image<unsigned char>* mask)
+/**
+ * @brief Convert the PopSift features into SIFT regions (one region per orientation)
+ */
+void convertPopSiftFeatures(popsift::Features& popFeatures, SIFT_Regions& regions)
 {
-    if (_popSift == nullptr)
-        resetConfiguration();
-
-    std::unique_ptr<SiftJob> job(_popSift->enqueue(image.width(), image.height(), &image(0, 0)));
-    std::unique_ptr<popsift::Features> popFeatures(job->get());
-
-    allocate(regions);
+    regions.Features().reserve(popFeatures.getDescriptorCount());
+    regions.Descriptors().reserve(popFeatures.getDescriptorCount());
 
-    // Build alias to cached data
-    SIFT_Regions* regionsCasted = dynamic_cast<SIFT_Regions*>(regions.get());
-    regionsCasted->Features().reserve(popFeatures->getDescriptorCount());
-    regionsCasted->Descriptors().reserve(popFeatures->getDescriptorCount());
-
-    ALICEVISION_LOG_TRACE("PopSIFT features count: " << popFeatures->getFeatureCount() << ", descriptors count: " << popFeatures->getDescriptorCount()
+    ALICEVISION_LOG_TRACE("PopSIFT features count: " << popFeatures.getFeatureCount() << ", descriptors count: " << popFeatures.getDescriptorCount()
                                                      << std::endl);
 
-    for (const auto& popFeat : *popFeatures)
+    for (const auto& popFeat : popFeatures)
     {
         for (int orientationIndex = 0; orientationIndex < popFeat.num_ori; ++orientationIndex)
         {
@@ -60,25 +49,70 @@ bool ImageDescriber_SIFT_popSIFT::describe(const image::Image<float>& image,
             for (std::size_t k = 0; k < 128; ++k)
                 desc[k] = static_cast<unsigned char>(popDesc->features[k]);
 
-            regionsCasted->Features().emplace_back(popFeat.xpos, popFeat.ypos, popFeat.sigma, popFeat.orientation[orientationIndex]);
+            regions.Features().emplace_back(popFeat.xpos, popFeat.ypos, popFeat.sigma, popFeat.orientation[orientationIndex]);
 
-            regionsCasted->Descriptors().emplace_back(desc);
+            regions.Descriptors().emplace_back(desc);
         }
     }
 
-    ALICEVISION_LOG_TRACE("aliceVision PopSIFT feature count : " << regionsCasted->RegionCount() << std::endl);
+    ALICEVISION_LOG_TRACE("aliceVision PopSIFT feature count : " << regions.RegionCount() << std::endl);
+}
+
+}  // namespace
+
+void ImageDescriber_SIFT_popSIFT::setConfigurationPreset(ConfigurationPreset preset)
+{
+    _params.setPreset(preset);
+    _popSifts.clear();  // reset by describe method
+}
 
+bool ImageDescriber_SIFT_popSIFT::describe(const image::Image<float>& image,
+                                           std::unique_ptr<Regions>& regions,
+                                           const image::Image<unsigned char>* mask)
+{
+    describeBatch({&image}, [&](std::size_t, std::unique_ptr<Regions>& imageRegions) { regions = std::move(imageRegions); });
     return true;
 }
 
+void ImageDescriber_SIFT_popSIFT::describeBatch(const std::vector<const image::Image<float>*>& images,
+                                                const std::function<void(std::size_t, std::unique_ptr<Regions>&)>& onRegions)
+{
+    if (_popSifts.empty())
+        resetConfiguration();
+
+    // enqueue all the images first, so the upload of the next images overlaps the extraction of the current one
+    std::vector<std::unique_ptr<SiftJob>> jobs;
+    jobs.reserve(images.size());
+    for (std::size_t i = 0; i < images.size(); ++i)
+    {
+        const image::Image<float>& image = *images.at(i);
+        jobs.emplace_back(_popSifts.at(i % _popSifts.size())->enqueue(image.width(), image.height(), &image(0, 0)));
+    }
+
+    // retrieve the results in order, the callback of an image runs while the next ones are processed
+    for (std::size_t i = 0; i < jobs.size(); ++i)
+    {
+        std::unique_ptr<popsift::Features> popFeatures(jobs.at(i)->get());
+
+        std::unique_ptr<Regions> regions;
+        allocate(regions);
+        convertPopSiftFeatures(*popFeatures, dynamic_cast<SIFT_Regions&>(*regions));
+
+        jobs.at(i).reset();
+        onRegions(i, regions);
+    }
+}
+
 void ImageDescriber_SIFT_popSIFT::resetConfiguration()
 {
-    // destroy all allocations and reset all state
-    // on the current device in the current process
-    cudaDeviceReset();
+    _popSifts.clear();
+
+    int nbDevices = 0;
+    if (cudaGetDeviceCount(&nbDevices) != cudaSuccess || nbDevices <= 0)
+        throw std::runtime_error("PopSIFT: no CUDA device available.");
 
-    popsift::cuda::device_prop_t deviceInfo;
-    deviceInfo.set(0, true);  // use only the first device & print information
+    if (_nbGPUs > 0)
+        nbDevices = std::min(nbDevices, _nbGPUs);
 
     // reset configuration
     popsift::Config config;
@@ -91,7 +125,21 @@ void ImageDescriber_SIFT_popSIFT::resetConfiguration()
     config.setFilterMaxExtrema(_params._maxTotalKeypoints);
     config.setFilterSorting(popsift::Config::LargestScaleFirst);
 
-    _popSift.reset(new PopSift(config, popsift::Config::ExtractingMode, PopSift::FloatImages));
+    ALICEVISION_LOG_INFO("PopSIFT uses " << nbDevices << " CUDA device(s).");
+
+    for (int device = 0; device < nbDevices; ++device)
+    {
+        // destroy all allocations and reset all state
+        // on the device in the current process
+        cudaSetDevice(device);
+        cudaDeviceReset();
+
+        popsift::cuda::device_prop_t deviceInfo;
+        deviceInfo.set(device, true);  // print information
+
+        _popSifts.emplace_back(new PopSift(config, popsift::Config::ExtractingMode, PopSift::FloatImages, device));
+    }
+    cudaSetDevice(0);
 }
 
 ImageDescriber_SIFT_popSIFT::ImageDescriber_SIFT_popSIFT(const SiftParams& params, bool isOriented)
@@ -108,7 +156,7 @@ ImageDescriber_SIFT_popSIFT::~ImageDescriber_SIFT_popSIFT()
 
     if (_instanceCounter.load() == 0)
     {
-        _popSift.reset(nullptr);
+        _popSifts.clear();
     }
 }
 
@@ -12,8 +12,12 @@
 #include <aliceVision/feature/regionsFactory.hpp>
 #include <aliceVision/feature/sift/SIFT.hpp>
 
+#include <atomic>
+#include <functional>
 #include <iostream>
+#include <memory>
 #include <numeric>
+#include <vector>
 
 class PopSift;
 
@@ -86,6 +90,28 @@ class ImageDescriber_SIFT_popSIFT : public ImageDescriber
      */
     bool describe(const image::Image<float>& image, std::unique_ptr<Regions>& regions, const image::Image<unsigned char>* mask = nullptr) override;
 
+    /**
+     * @brief Detect regions on a batch of float images and compute their attributes (description).
+     *        All the images are enqueued before retrieving the results: PopSift copies them in its pinned buffers
+     *        and uploads the next image while the current one is processed, and the callback of an image runs while
+     *        the next ones are processed. The images are dispatched to the GPUs in a round-robin way.
+     * @param[in] images The float images
+     * @param[in] onRegions The callback called with the index of the image in the batch and its regions
+     */
+    void describeBatch(const std::vector<const image::Image<float>*>& images,
+                       const std::function<void(std::size_t, std::unique_ptr<Regions>&)>& onRegions) override;
+    using ImageDescriber::describeBatch;
+
+    /**
+     * @brief Set the number of GPUs used to extract the features
+     * @param[in] nbGPUs The number of GPUs (0 to use all the available GPUs)
+     */
+    void setNbGPUs(int nbGPUs) override
+    {
+        _nbGPUs = nbGPUs;
+        _popSifts.clear();  // reset by describe method
+    }
+
     /**
      * @brief Allocate Regions type depending of the ImageDescriber
      * @param[in,out] regions
@@ -102,7 +128,9 @@ class ImageDescriber_SIFT_popSIFT : public ImageDescriber
 
     SiftParams _params;
     bool _isOriented = true;
-    static std::unique_ptr<PopSift> _popSift;
+    int _nbGPUs = 0;
+    /// one PopSift pipeline per GPU
+    static std::vector<std::unique_ptr<PopSift>> _popSifts;
     static std::atomic<int> _instanceCounter;
 };
 
@@ -11,6 +11,7 @@
 #include <aliceVision/feature/ImageDescriber.hpp>
 #include <aliceVision/feature/regionsFactory.hpp>
 #include <aliceVision/feature/sift/SIFT.hpp>
+#include <aliceVision/feature/ThreadBufferCache.hpp>
 
 extern "C"
 {
@@ -97,9 +98,14 @@ class ImageDescriber_SIFT_vlfeat : public ImageDescriber
      */
     bool describe(const image::Image<float>& image, std::unique_ptr<Regions>& regions, const image::Image<unsigned char>* mask = nullptr) override
     {
-        return extractSIFT<unsigned char>(image, regions, _params, _isOriented, mask);
+        return extractSIFT<unsigned char>(image, regions, _params, _isOriented, mask, _reuseBuffers ? &_buffers.local() : nullptr);
     }
 
+    /**
+     * @brief Release the temporary buffers kept for the next images
+     */
+    void releaseBuffers() override { _buffers.clear(); }
+
     /**
      * @brief Allocate Regions type depending of the ImageDescriber
      * @param[in,out] regions
@@ -109,6 +115,7 @@ class ImageDescriber_SIFT_vlfeat : public ImageDescriber
   private:
     SiftParams _params;
     bool _isOriented;
+    ThreadBufferCache<SiftBuffers> _buffers;
 };
 
 }  // namespace feature
@@ -6,6 +6,8 @@
 
 #include "SIFT.hpp"
 
+#include <array>
+
 namespace aliceVision {
 namespace feature {
 
@@ -120,6 +122,26 @@ std::size_t getMemoryConsumptionVLFeat(std::size_t width, std::size_t height, co
            (params._maxTotalKeypoints * 128 * sizeof(float));  // output keypoints
 }
 
+VlSiftFilt* SiftBuffers::getFilter(int w, int h, int nbScales, int imageFirstOctave)
+{
+    if (filt && width == w && height == h && numScales == nbScales && firstOctave == imageFirstOctave)
+    {
+        // same scale space geometry, only reset the thresholds to the VLFeat defaults
+        vl_sift_set_peak_thresh(filt.get(), 0.0);
+        vl_sift_set_edge_thresh(filt.get(), 10.0);
+        return filt.get();
+    }
+
+    // release the previous scale space before allocating the new one
+    filt.reset();
+    filt.reset(vl_sift_new(w, h, -1, nbScales, imageFirstOctave));  // numOctaves: auto
+    width = w;
+    height = h;
+    numScales = nbScales;
+    firstOctave = imageFirstOctave;
+    return filt.get();
+}
+
 void VLFeatInstance::initialize()
 {
     assert(nbInstances >= 0);
@@ -141,13 +163,14 @@ bool extractSIFT(const image::Image<float>& image,
                  std::unique_ptr<Regions>& regions,
                  const SiftParams& params,
                  bool orientation,
-                 const image::Image<unsigned char>* mask)
+                 const image::Image<unsigned char>* mask,
+                 SiftBuffers* buffers)
 {
     const int w = image.width(), h = image.height();
     const int numOctaves = -1;  // auto
     // if image resolution is low, increase resolution for extraction
     const int firstOctave = params.getImageFirstOctave(w, h);
-    VlSiftFilt* filt = vl_sift_new(w, h, numOctaves, params._numScales, firstOctave);
+    VlSiftFilt* filt = buffers ? buffers->getFilter(w, h, params._numScales, firstOctave) : vl_sift_new(w, h, numOctaves, params._numScales, firstOctave);
     if (params._edgeThreshold >= 0)
         vl_sift_set_edge_thresh(filt, params._edgeThreshold);
 
@@ -198,7 +221,9 @@ bool extractSIFT(const image::Image<float>& image,
     const std::size_t reserveSize = (params._gridSize && params._maxTotalKeypoints) ? params._maxTotalKeypoints : 2000;
     regionsCasted->Features().reserve(reserveSize);
     regionsCasted->Descriptors().reserve(reserveSize);
-    std::vector<float> featuresPeakValue;
+    std::vector<float> localFeaturesPeakValue;
+    std::vector<float>& featuresPeakValue = buffers ? buffers->featuresPeakValue : localFeaturesPeakValue;
+    featuresPeakValue.clear();
     featuresPeakValue.reserve(reserveSize);
 
     size_t maxOctaveKeypoints = params._maxTotalKeypoints;
@@ -317,10 +342,11 @@ bool extractSIFT(const image::Image<float>& image,
         else if (params._maxTotalKeypoints && params._contrastFiltering == EFeatureConstrastFiltering::NonExtremaFiltering)
         {
             std::vector<float> radiusMaxima(nkeys, std::numeric_limits<float>::max());
-            for (IndexT i = 0; i < nkeys; ++i)
+#pragma omp parallel for
+            for (int i = 0; i < nkeys; ++i)
             {
                 const auto& keypointI = keys[i];
-                for (IndexT j = 0; j < nkeys; ++j)
+                for (int j = 0; j < nkeys; ++j)
                 {
                     const auto& keypointJ = keys[j];
                     if (keypointJ.peak_value > keypointI.peak_value)
@@ -369,43 +395,52 @@ bool extractSIFT(const image::Image<float>& image,
             filteredKeypointsIndex.swap(newFilteredKeypointsIndex);
         }
 
-        std::vector<std::vector<double>> anglesPerKeypoint(filteredKeypointsIndex.size());
+        // Compute the orientations and descriptors in parallel, then append them in the keypoints order
+        // to keep the extraction deterministic whatever the number of threads.
+        const int nbFilteredKeypoints = filteredKeypointsIndex.size();
+        std::vector<int> nbAnglesPerKeypoint(nbFilteredKeypoints, 0);
+        std::vector<std::array<double, 4>> anglesPerKeypoint(nbFilteredKeypoints);
+        std::vector<Descriptor<T, 128>> octaveDescriptors(4 * nbFilteredKeypoints);
 
 #pragma omp parallel for
-        for (int ii = 0; ii < filteredKeypointsIndex.size(); ++ii)
+        for (int ii = 0; ii < nbFilteredKeypoints; ++ii)
         {
             const int i = filteredKeypointsIndex[ii];
 
-            double angles[4] = {0.0, 0.0, 0.0, 0.0};
+            std::array<double, 4>& angles = anglesPerKeypoint[ii];
+            angles.fill(0.0);
             int nangles = 1;  // by default (1 upright feature)
             if (orientation)
             {  // compute from 1 to 4 orientations
-                nangles = vl_sift_calc_keypoint_orientations(filt, angles, keys + i);
+                nangles = vl_sift_calc_keypoint_orientations(filt, angles.data(), keys + i);
             }
+            nbAnglesPerKeypoint[ii] = nangles;
 
             Descriptor<vl_sift_pix, 128> vlFeatDescriptor;
-            Descriptor<T, 128> descriptor;
 
             for (int q = 0; q < nangles; ++q)
             {
-                const PointFeature fp(keys[i].x, keys[i].y, keys[i].sigma, static_cast<float>(angles[q]));
-
                 vl_sift_calc_keypoint_descriptor(filt, &vlFeatDescriptor[0], keys + i, angles[q]);
-                convertSIFT<T>(&vlFeatDescriptor[0], descriptor, params._rootSift);
+                convertSIFT<T>(&vlFeatDescriptor[0], octaveDescriptors[4 * ii + q], params._rootSift);
+            }
+        }
 
-#pragma omp critical
-                {
-                    regionsCasted->Descriptors().push_back(descriptor);
-                    regionsCasted->Features().push_back(fp);
-                    featuresPeakValue.push_back(keys[i].peak_value);
-                }
+        for (int ii = 0; ii < nbFilteredKeypoints; ++ii)
+        {
+            const int i = filteredKeypointsIndex[ii];
+            for (int q = 0; q < nbAnglesPerKeypoint[ii]; ++q)
+            {
+                regionsCasted->Descriptors().push_back(octaveDescriptors[4 * ii + q]);
+                regionsCasted->Features().emplace_back(keys[i].x, keys[i].y, keys[i].sigma, static_cast<float>(anglesPerKeypoint[ii][q]));
+                featuresPeakValue.push_back(keys[i].peak_value);
             }
         }
 
         if (vl_sift_process_next_octave(filt))
             break;  // Last octave
     }
-    vl_sift_delete(filt);
+    if (!buffers)
+        vl_sift_delete(filt);
 
     assert(regionsCasted->Features().size() == regionsCasted->Descriptors().size());
 
@@ -578,13 +613,15 @@ template bool extractSIFT<float>(const image::Image<float>& image,
                                  std::unique_ptr<Regions>& regions,
                                  const SiftParams& params,
                                  bool orientation,
-                                 const image::Image<unsigned char>* mask);
+                                 const image::Image<unsigned char>* mask,
+                                 SiftBuffers* buffers);
 
 template bool extractSIFT<unsigned char>(const image::Image<float>& image,
                                          std::unique_ptr<Regions>& regions,
                                          const SiftParams& params,
                                          bool orientation,
-                                         const image::Image<unsigned char>* mask);
+                                         const image::Image<unsigned char>* mask,
+                                         SiftBuffers* buffers);
 
 }  // namespace feature
 }  // namespace aliceVision
@@ -21,8 +21,10 @@ extern "C"
 }
 
 #include <iostream>
+#include <memory>
 #include <numeric>
 #include <stdexcept>
+#include <vector>
 
 namespace aliceVision {
 namespace feature {
@@ -59,6 +61,32 @@ struct SiftParams
     }
 };
 
+/**
+ * @brief Temporary buffers of a VLFeat SIFT extraction, reused between the images of the same size.
+ */
+struct SiftBuffers
+{
+    /// VLFeat SIFT filter, owning the scale space
+    std::unique_ptr<VlSiftFilt, void (*)(VlSiftFilt*)> filt{nullptr, &vl_sift_delete};
+    /// geometry of the filter scale space
+    int width = 0;
+    int height = 0;
+    int numScales = 0;
+    int firstOctave = 0;
+    /// peak values of the extracted features
+    std::vector<float> featuresPeakValue;
+
+    /**
+     * @brief Get a SIFT filter for the given geometry, reusing the current one if the geometry is the same.
+     * @param[in] w The image width
+     * @param[in] h The image height
+     * @param[in] nbScales The number of scales per octave
+     * @param[in] imageFirstOctave The first octave
+     * @return the SIFT filter, with the default thresholds
+     */
+    VlSiftFilt* getFilter(int w, int h, int nbScales, int imageFirstOctave);
+};
+
 // VLFeat Instance management
 class VLFeatInstance
 {
@@ -126,6 +154,7 @@ std::size_t getMemoryConsumptionVLFeat(std::size_t width, std::size_t height, co
  * @param params
  * @param orientation
  * @param mask
+ * @param buffers temporary buffers reused between the images (optional)
  * @return
  */
 template<typename T>
@@ -133,7 +162,8 @@ bool extractSIFT(const image::Image<float>& image,
                  std::unique_ptr<Regions>& regions,
                  const SiftParams& params,
                  bool orientation,
-                 const image::Image<unsigned char>* mask);
+                 const image::Image<unsigned char>* mask,
+                 SiftBuffers* buffers = nullptr);
 
 }  // namespace feature
 }  // namespace aliceVision
@@ -0,0 +1,54 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/feature/ThreadBufferCache.hpp>
+
+#include <thread>
+#include <vector>
+
+#define BOOST_TEST_MODULE threadBufferCache
+
+#include <boost/test/unit_test.hpp>
+
+using namespace aliceVision;
+using namespace aliceVision::feature;
+
+BOOST_AUTO_TEST_CASE(threadBufferCache_reusedByThread)
+{
+    ThreadBufferCache<std::vector<float>> cache;
+
+    std::vector<float>& buffers = cache.local();
+    buffers.resize(100);
+
+    // same thread: same buffers
+    BOOST_CHECK_EQUAL(&cache.local(), &buffers);
+    BOOST_CHECK_EQUAL(cache.local().size(), 100);
+
+    // other thread: its own buffers
+    std::vector<float>* otherBuffers = nullptr;
+    std::thread other([&]() {
+        otherBuffers = &cache.local();
+        otherBuffers->resize(10);
+    });
+    other.join();
+
+    BOOST_CHECK_NE(otherBuffers, &buffers);
+    BOOST_CHECK_EQUAL(cache.local().size(), 100);
+}
+
+BOOST_AUTO_TEST_CASE(threadBufferCache_clear)
+{
+    ThreadBufferCache<std::vector<float>> cache;
+    cache.local().resize(100);
+
+    cache.clear();
+    BOOST_CHECK(cache.local().empty());
+
+    // copies do not share the buffers
+    cache.local().resize(100);
+    ThreadBufferCache<std::vector<float>> copy(cache);
+    BOOST_CHECK(copy.local().empty());
+}
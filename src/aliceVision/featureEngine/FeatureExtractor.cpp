@@ -6,12 +6,23 @@
 
 #include "FeatureExtractor.hpp"
 #include <aliceVision/image/io.hpp>
+#include <aliceVision/system/MemoryAdmissionQueue.hpp>
 #include <aliceVision/system/MemoryInfo.hpp>
+#include <aliceVision/system/ProgressDisplay.hpp>
+#include <aliceVision/system/ResourceReport.hpp>
+#include <aliceVision/system/Tracer.hpp>
 #include <aliceVision/utils/filesIO.hpp>
 #include <aliceVision/alicevision_omp.hpp>
 
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
 #include <filesystem>
 #include <iomanip>
+#include <mutex>
+#include <thread>
 
 namespace fs = std::filesystem;
 
@@ -46,6 +57,19 @@ void FeatureExtractorViewJob::setImageDescribers(const std::vector<std::shared_p
     }
 }
 
+std::size_t FeatureExtractorViewJob::memoryConsuption(const std::vector<std::shared_ptr<feature::ImageDescriber>>& imageDescribers,
+                                                      std::size_t width,
+                                                      std::size_t height) const
+{
+    std::size_t memoryConsuption = 0;
+    for (const bool useGPU : {false, true})
+    {
+        for (const std::size_t imageDescriberIndex : imageDescriberIndexes(useGPU))
+            memoryConsuption += imageDescribers.at(imageDescriberIndex)->getMemoryConsumption(width, height);
+    }
+    return memoryConsuption;
+}
+
 FeatureExtractor::FeatureExtractor(const sfmData::SfMData& sfmData)
   : _sfmData(sfmData)
 {}
@@ -54,6 +78,9 @@ FeatureExtractor::~FeatureExtractor() = default;
 
 void FeatureExtractor::process(const HardwareContext& hContext, const image::EImageColorSpace workingColorSpace)
 {
+    ALICEVISION_TRACE_ZONE_CAT("FeatureExtractor::process", "featureExtraction");
+    ALICEVISION_RESOURCE_PHASE("FeatureExtractor::process");
+
     size_t maxAvailableMemory = hContext.getUserMaxMemoryAvailable();
     unsigned int maxAvailableCores = hContext.getMaxThreads();
 
@@ -71,8 +98,7 @@ void FeatureExtractor::process(const HardwareContext& hContext, const image::EIm
 
     std::size_t jobMaxMemoryConsuption = 0;
 
-    std::vector<FeatureExtractorViewJob> cpuJobs;
-    std::vector<FeatureExtractorViewJob> gpuJobs;
+    std::vector<FeatureExtractorViewJob> jobs;
 
     for (auto it = itViewBegin; it != itViewEnd; ++it)
     {
@@ -82,14 +108,77 @@ void FeatureExtractor::process(const HardwareContext& hContext, const image::EIm
         viewJob.setImageDescribers(_imageDescribers);
         jobMaxMemoryConsuption = std::max(jobMaxMemoryConsuption, viewJob.memoryConsuption());
 
-        if (viewJob.useCPU())
-            cpuJobs.push_back(viewJob);
+        if (viewJob.useCPU() || viewJob.useGPU())
+            jobs.push_back(viewJob);
+    }
+
+    // Each view is decoded once by the CPU workers, which extract the CPU features
+    // and share the decoded images with the GPU worker.
+    // The GPU worker extracts the GPU features concurrently, by batches of images.
+    struct SharedViewImages
+    {
+        const FeatureExtractorViewJob* job;
+        std::shared_ptr<const ViewImages> images;
+    };
+
+    // number of images given at once to a GPU describer, to pipeline their upload and their extraction
+    const std::size_t gpuBatchSize = 4;
+    // maximum number of decoded images waiting for the GPU worker: the next batch is decoded while the current one is processed
+    const std::size_t maxPendingGpuImages = gpuBatchSize;
+    std::deque<SharedViewImages> gpuQueue;
+    std::mutex gpuQueueMutex;
+    std::condition_variable gpuQueueCondition;
+    bool cpuWorkersDone = false;
+    bool gpuWorkerFailed = false;
+    std::exception_ptr gpuWorkerException;
+    std::exception_ptr cpuWorkerException;
+    std::mutex cpuWorkerExceptionMutex;
+
+    // the CPU workers keep the temporary buffers of the describers (e.g. scale spaces) between the images
+    for (const auto& imageDescriber : _imageDescribers)
+        imageDescriber->setReuseBuffers(true);
+
+    std::thread gpuWorker;
+
+    if (std::any_of(jobs.begin(), jobs.end(), [](const FeatureExtractorViewJob& job) { return job.useGPU(); }))
+    {
+        gpuWorker = std::thread([&]() {
+            try
+            {
+                while (true)
+                {
+                    std::vector<SharedViewImages> batch;
+                    {
+                        std::unique_lock<std::mutex> lock(gpuQueueMutex);
+                        gpuQueueCondition.wait(lock, [&]() { return !gpuQueue.empty() || cpuWorkersDone; });
+                        while (!gpuQueue.empty() && batch.size() < gpuBatchSize)
+                        {
+                            batch.push_back(gpuQueue.front());
+                            gpuQueue.pop_front();
+                        }
+                    }
+                    gpuQueueCondition.notify_all();
+
+                    if (batch.empty())
+                        break;
 
-        if (viewJob.useGPU())
-            gpuJobs.push_back(viewJob);
+                    describeBatch(batch.size(),
+                                  [&](std::size_t i) -> const FeatureExtractorViewJob& { return *batch.at(i).job; },
+                                  [&](std::size_t i) -> const ViewImages& { return *batch.at(i).images; });
+                }
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(gpuQueueMutex);
+                gpuWorkerException = std::current_exception();
+                gpuWorkerFailed = true;
+                gpuQueue.clear();
+            }
+            gpuQueueCondition.notify_all();
+        });
     }
 
-    if (!cpuJobs.empty())
+    if (!jobs.empty())
     {
         system::MemoryInfo memoryInformation = system::getMemoryInfo();
 
@@ -103,12 +192,15 @@ void FeatureExtractor::process(const HardwareContext& hContext, const image::EIm
         if (jobMaxMemoryConsuption == 0)
             throw std::runtime_error("Cannot compute feature extraction job max memory consumption.");
 
-        // How many buffers can fit in 90% of the available RAM?
-        // This is used to estimate how many jobs can be computed in parallel without SWAP.
-        const std::size_t memoryImageCapacity = std::size_t((0.9 * maxMemory) / jobMaxMemoryConsuption);
+        // The running jobs share 90% of the available RAM, to run as many jobs in parallel as possible without SWAP.
+        // The memory of a job is reserved when it starts and released when it is done, the largest images
+        // are started first and the smallest ones fill the remaining memory.
+        const std::size_t memoryBudget = std::size_t(0.9 * maxMemory);
+        system::MemoryAdmissionQueue admissionQueue(memoryBudget);
+        for (std::size_t i = 0; i < jobs.size(); ++i)
+            admissionQueue.push(i, jobs.at(i).memoryConsuption());
 
-        std::size_t nbThreads = std::max(std::size_t(1), memoryImageCapacity);
-        ALICEVISION_LOG_INFO("Max number of threads regarding memory usage: " << nbThreads);
+        ALICEVISION_LOG_INFO("Memory budget for extraction: " << memoryBudget / (1024 * 1024) << " MB");
         const double oneGB = 1024.0 * 1024.0 * 1024.0;
         if (jobMaxMemoryConsuption > maxMemory)
         {
@@ -137,39 +229,96 @@ void FeatureExtractor::process(const HardwareContext& hContext, const image::EIm
         {
             ALICEVISION_LOG_WARNING("Cannot find available system memory, this can be due to OS limitation.\n"
                                     "Use only one thread for CPU feature extraction.");
-            nbThreads = 1;
+            // with an empty budget, the admission queue runs the jobs one at a time
         }
 
-        // nbThreads should not be higher than the available cores
-        nbThreads = std::min(static_cast<std::size_t>(maxAvailableCores), nbThreads);
-
-        // nbThreads should not be higher than the number of jobs
-        nbThreads = std::min(cpuJobs.size(), nbThreads);
+        // the number of workers is bounded by the available cores and the number of jobs,
+        // the number of running jobs by the memory budget
+        const std::size_t nbWorkers = std::min(static_cast<std::size_t>(maxAvailableCores), jobs.size());
 
-        ALICEVISION_LOG_INFO("# threads for extraction: " << nbThreads);
+        ALICEVISION_LOG_INFO("# threads for extraction: up to " << nbWorkers << " image(s) in parallel, bounded by the memory budget");
         omp_set_nested(1);
 
-#pragma omp parallel for num_threads(nbThreads)
-        for (int i = 0; i < cpuJobs.size(); ++i)
-            computeViewJob(cpuJobs.at(i), false, workingColorSpace);
+        auto progressDisplay = system::createConsoleProgressDisplay(jobs.size(), std::cout, "Feature extraction\n");
+
+#pragma omp parallel num_threads(nbWorkers)
+        {
+            std::size_t jobIndex;
+            while (admissionQueue.pop(jobIndex))
+            {
+                const FeatureExtractorViewJob& job = jobs.at(jobIndex);
+
+                try
+                {
+                    // the cores not used by the other running images parallelize the extraction inside this image
+                    omp_set_num_threads(std::max(1, static_cast<int>(maxAvailableCores / std::max<std::size_t>(1, admissionQueue.nbRunningJobs()))));
+
+                    auto images = std::make_shared<ViewImages>();
+                    loadViewImages(job, workingColorSpace, *images);
+
+                    // correct the reservation with the decoded image size (e.g. missing metadata or resampled pixels)
+                    admissionQueue.resize(jobIndex, job.memoryConsuption(_imageDescribers, images->imageGrayFloat.width(), images->imageGrayFloat.height()));
+
+                    if (job.useGPU())
+                    {
+                        std::unique_lock<std::mutex> lock(gpuQueueMutex);
+                        gpuQueueCondition.wait(lock, [&]() { return gpuQueue.size() < maxPendingGpuImages || gpuWorkerFailed; });
+                        if (!gpuWorkerFailed)
+                            gpuQueue.push_back({&job, images});
+                        lock.unlock();
+                        gpuQueueCondition.notify_all();
+                    }
+
+                    describeView(job, false, *images);
+                }
+                catch (...)
+                {
+                    // stop the other workers, the exception is rethrown once the GPU worker is done
+                    std::lock_guard<std::mutex> lock(cpuWorkerExceptionMutex);
+                    if (!cpuWorkerException)
+                        cpuWorkerException = std::current_exception();
+                    admissionQueue.cancel();
+                }
+
+                admissionQueue.release(jobIndex);
+                ++progressDisplay;
+            }
+        }
+
+        ALICEVISION_LOG_INFO("Peak memory reserved for extraction: " << admissionQueue.peakReservedMemory() / (1024 * 1024) << " MB, with up to "
+                                                                      << admissionQueue.peakRunningJobs() << " image(s) in parallel");
     }
 
-    if (!gpuJobs.empty())
     {
-        for (const auto& job : gpuJobs)
-            computeViewJob(job, true, workingColorSpace);
+        std::lock_guard<std::mutex> lock(gpuQueueMutex);
+        cpuWorkersDone = true;
     }
+    gpuQueueCondition.notify_all();
+
+    if (gpuWorker.joinable())
+        gpuWorker.join();
+
+    for (const auto& imageDescriber : _imageDescribers)
+        imageDescriber->releaseBuffers();
+
+    if (gpuWorkerException)
+        std::rethrow_exception(gpuWorkerException);
+
+    if (cpuWorkerException)
+        std::rethrow_exception(cpuWorkerException);
 }
 
-void FeatureExtractor::computeViewJob(const FeatureExtractorViewJob& job, bool useGPU, const image::EImageColorSpace workingColorSpace)
+void FeatureExtractor::loadViewImages(const FeatureExtractorViewJob& job, const image::EImageColorSpace workingColorSpace, ViewImages& images) const
 {
-    image::Image<float> imageGrayFloat;
-    image::Image<unsigned char> imageGrayUChar;
-    image::Image<unsigned char> mask;
+    ALICEVISION_TRACE_ZONE_CAT("FeatureExtractor::loadViewImages", "featureExtraction");
+
+    image::Image<float>& imageGrayFloat = images.imageGrayFloat;
+    image::Image<unsigned char>& mask = images.mask;
+    double& pixelRatio = images.pixelRatio;
 
     image::readImage(job.view().getImage().getImagePath(), imageGrayFloat, workingColorSpace);
 
-    double pixelRatio = 1.0;
+    pixelRatio = 1.0;
     job.view().getImage().getDoubleMetadata({"PixelAspectRatio"}, pixelRatio);
 
     if (pixelRatio != 1.0)
@@ -202,6 +351,21 @@ void FeatureExtractor::computeViewJob(const FeatureExtractorViewJob& job, bool u
         }
     }
 
+    // convert the float buffer to uchar once if one of the CPU or GPU describers can't use the float image
+    bool needUCharImage = false;
+    for (const bool useGPU : {false, true})
+    {
+        for (const auto& imageDescriberIndex : job.imageDescriberIndexes(useGPU))
+            needUCharImage = needUCharImage || !_imageDescribers.at(imageDescriberIndex)->useFloatImage();
+    }
+    if (needUCharImage)
+        images.imageGrayUChar = (imageGrayFloat.getMat() * 255.f).cast<unsigned char>();
+}
+
+void FeatureExtractor::describeView(const FeatureExtractorViewJob& job, bool useGPU, const ViewImages& images) const
+{
+    ALICEVISION_TRACE_ZONE_CAT("FeatureExtractor::describeView", "featureExtraction");
+
     for (const auto& imageDescriberIndex : job.imageDescriberIndexes(useGPU))
     {
         const auto& imageDescriber = _imageDescribers.at(imageDescriberIndex);
@@ -216,90 +380,147 @@ void FeatureExtractor::computeViewJob(const FeatureExtractorViewJob& job, bool u
         if (imageDescriber->useFloatImage())
         {
             // image buffer use float image, use the read buffer
-            imageDescriber->describe(imageGrayFloat, regions);
+            imageDescriber->describe(images.imageGrayFloat, regions);
         }
         else
         {
-            // image buffer can't use float image
-            if (imageGrayUChar.width() == 0)  // the first time, convert the float buffer to uchar
-                imageGrayUChar = (imageGrayFloat.getMat() * 255.f).cast<unsigned char>();
-            imageDescriber->describe(imageGrayUChar, regions);
+            // image buffer can't use float image, use the converted buffer
+            imageDescriber->describe(images.imageGrayUChar, regions);
         }
 
-        if (pixelRatio != 1.0)
+        saveRegions(job, *imageDescriber, images, regions);
+    }
+}
+
+void FeatureExtractor::describeBatch(std::size_t nbViews,
+                                     const std::function<const FeatureExtractorViewJob&(std::size_t)>& getJob,
+                                     const std::function<const ViewImages&(std::size_t)>& getImages) const
+{
+    ALICEVISION_TRACE_ZONE_CAT("FeatureExtractor::describeBatch", "featureExtraction");
+
+    for (std::size_t imageDescriberIndex = 0; imageDescriberIndex < _imageDescribers.size(); ++imageDescriberIndex)
+    {
+        const auto& imageDescriber = _imageDescribers.at(imageDescriberIndex);
+        const std::string imageDescriberTypeName = feature::EImageDescriberType_enumToString(imageDescriber->getDescriberType());
+
+        // views of the batch for which the features of this GPU describer are not already computed
+        std::vector<std::size_t> viewIndexes;
+        std::vector<const image::Image<float>*> batchImages;
+        std::vector<const image::Image<unsigned char>*> batchImagesUChar;
+        for (std::size_t i = 0; i < nbViews; ++i)
         {
-            // Re-position point features on input image
-            for (auto& feat : regions->Features())
-            {
-                feat.x() /= pixelRatio;
-            }
+            const std::vector<std::size_t>& gpuIndexes = getJob(i).imageDescriberIndexes(true);
+            if (std::find(gpuIndexes.begin(), gpuIndexes.end(), imageDescriberIndex) == gpuIndexes.end())
+                continue;
+
+            ALICEVISION_LOG_INFO("Extracting " << imageDescriberTypeName << " features from view '" << getJob(i).view().getImage().getImagePath()
+                                               << "' [gpu]");
+            viewIndexes.push_back(i);
+            batchImages.push_back(&getImages(i).imageGrayFloat);
+            batchImagesUChar.push_back(&getImages(i).imageGrayUChar);
         }
 
-        //Get Fisheye mask
-        bool isFisheye = false;
-        Vec2 circleCenter = Vec2::Zero();
-        double circleRadius = std::numeric_limits<double>::max();
-        auto & intrinsics = _sfmData.getIntrinsics();
-        if (job.view().getIntrinsicId() != UndefinedIndexT)
+        if (viewIndexes.empty())
+            continue;
+
+        // the regions of a view are saved while the GPU processes the next views of the batch
+        const auto onRegions = [&](std::size_t batchIndex, std::unique_ptr<feature::Regions>& regions) {
+            const std::size_t i = viewIndexes.at(batchIndex);
+            saveRegions(getJob(i), *imageDescriber, getImages(i), regions);
+        };
+
+        if (imageDescriber->useFloatImage())
+            imageDescriber->describeBatch(batchImages, onRegions);
+        else
+            imageDescriber->describeBatch(batchImagesUChar, onRegions);
+    }
+}
+
+void FeatureExtractor::saveRegions(const FeatureExtractorViewJob& job,
+                                   const feature::ImageDescriber& imageDescriber,
+                                   const ViewImages& images,
+                                   std::unique_ptr<feature::Regions>& regions) const
+{
+    ALICEVISION_TRACE_ZONE_CAT("FeatureExtractor::saveRegions", "featureExtraction");
+
+    const image::Image<unsigned char>& mask = images.mask;
+    const double pixelRatio = images.pixelRatio;
+    const feature::EImageDescriberType imageDescriberType = imageDescriber.getDescriberType();
+    const std::string imageDescriberTypeName = feature::EImageDescriberType_enumToString(imageDescriberType);
+
+    if (pixelRatio != 1.0)
+    {
+        // Re-position point features on input image
+        for (auto& feat : regions->Features())
         {
-            const auto & intrinsic = intrinsics.at(job.view().getIntrinsicId());
-            const auto & equidistant = std::dynamic_pointer_cast<const camera::Equidistant>(intrinsic);
+            feat.x() /= pixelRatio;
+        }
+    }
+
+    //Get Fisheye mask
+    bool isFisheye = false;
+    Vec2 circleCenter = Vec2::Zero();
+    double circleRadius = std::numeric_limits<double>::max();
+    auto & intrinsics = _sfmData.getIntrinsics();
+    if (job.view().getIntrinsicId() != UndefinedIndexT)
+    {
+        const auto & intrinsic = intrinsics.at(job.view().getIntrinsicId());
+        const auto & equidistant = std::dynamic_pointer_cast<const camera::Equidistant>(intrinsic);
 
-            //If the current view comes from a fisheye optic
-            if (equidistant)
+        //If the current view comes from a fisheye optic
+        if (equidistant)
+        {
+            //Make sure the circle radius has been initialized before
+            if (equidistant->getCircleRadius() > 1.0)
             {
-                //Make sure the circle radius has been initialized before
-                if (equidistant->getCircleRadius() > 1.0)
-                {
-                    circleCenter = equidistant->getCircleCenter();
-                    circleRadius = equidistant->getCircleRadius();
-                    isFisheye = true;
-                }
+                circleCenter = equidistant->getCircleCenter();
+                circleRadius = equidistant->getCircleRadius();
+                isFisheye = true;
             }
         }
+    }
 
-        //On mask or fisheye circle availability
-        if (mask.height() > 0 || isFisheye); 
+    //On mask or fisheye circle availability
+    if (mask.height() > 0 || isFisheye); 
+    {
+        std::vector<feature::FeatureInImage> selectedIndices;
+        for (size_t i = 0, n = regions->RegionCount(); i != n; ++i)
         {
-            std::vector<feature::FeatureInImage> selectedIndices;
-            for (size_t i = 0, n = regions->RegionCount(); i != n; ++i)
-            {
-                const Vec2 position = regions->GetRegionPosition(i);
-                const int x = int(position.x());
-                const int y = int(position.y());
+            const Vec2 position = regions->GetRegionPosition(i);
+            const int x = int(position.x());
+            const int y = int(position.y());
 
 
-                bool masked = false;
+            bool masked = false;
 
-                //Check if point lies inside potential fisheye circle
-                if ((position - circleCenter).norm() > circleRadius)
+            //Check if point lies inside potential fisheye circle
+            if ((position - circleCenter).norm() > circleRadius)
+            {
+                masked = true;
+            }
+            //Check if the optional image mask tells us to ignore this coordinate
+            else if (x < mask.width() && y < mask.height())
+            {
+                if ((mask(y, x) == 0 && !_maskInvert) || (mask(y, x) != 0 && _maskInvert))
                 {
                     masked = true;
                 }
-                //Check if the optional image mask tells us to ignore this coordinate
-                else if (x < mask.width() && y < mask.height())
-                {
-                    if ((mask(y, x) == 0 && !_maskInvert) || (mask(y, x) != 0 && _maskInvert))
-                    {
-                        masked = true;
-                    }
-                }
-
-                if (!masked)
-                {
-                    selectedIndices.push_back({IndexT(i), 0});
-                }
             }
 
-            std::vector<IndexT> out_associated3dPoint;
-            std::map<IndexT, IndexT> out_mapFullToLocal;
-            regions = regions->createFilteredRegions(selectedIndices, out_associated3dPoint, out_mapFullToLocal);
+            if (!masked)
+            {
+                selectedIndices.push_back({IndexT(i), 0});
+            }
         }
 
-        imageDescriber->Save(regions.get(), job.getFeaturesPath(imageDescriberType), job.getDescriptorPath(imageDescriberType));
-        ALICEVISION_LOG_INFO(std::left << std::setw(6) << " " << regions->RegionCount() << " " << imageDescriberTypeName
-                                       << " features extracted from view '" << job.view().getImage().getImagePath() << "'");
+        std::vector<IndexT> out_associated3dPoint;
+        std::map<IndexT, IndexT> out_mapFullToLocal;
+        regions = regions->createFilteredRegions(selectedIndices, out_associated3dPoint, out_mapFullToLocal);
     }
+
+    imageDescriber.Save(regions.get(), job.getFeaturesPath(imageDescriberType), job.getDescriptorPath(imageDescriberType));
+    ALICEVISION_LOG_INFO(std::left << std::setw(6) << " " << regions->RegionCount() << " " << imageDescriberTypeName
+                                   << " features extracted from view '" << job.view().getImage().getImagePath() << "'");
 }
 
 }  // namespace featureEngine
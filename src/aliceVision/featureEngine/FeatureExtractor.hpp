@@ -8,6 +8,11 @@
 #include <aliceVision/sfmData/SfMData.hpp>
 #include <aliceVision/sfmData/View.hpp>
 #include <aliceVision/system/hardwareContext.hpp>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
 namespace aliceVision {
 namespace featureEngine {
 
@@ -38,6 +43,17 @@ class FeatureExtractorViewJob
 
     std::size_t memoryConsuption() const { return _memoryConsuption; }
 
+    /**
+     * @brief Estimate the memory consumption of the job for the given image size (e.g. the decoded image size).
+     * @param[in] imageDescribers The image describers given to setImageDescribers
+     * @param[in] width The image width
+     * @param[in] height The image height
+     * @return the estimated memory consumption in bytes
+     */
+    std::size_t memoryConsuption(const std::vector<std::shared_ptr<feature::ImageDescriber>>& imageDescribers,
+                                 std::size_t width,
+                                 std::size_t height) const;
+
     const std::vector<std::size_t>& imageDescriberIndexes(bool useGPU) const
     {
         return useGPU ? _gpuImageDescriberIndexes : _cpuImageDescriberIndexes;
@@ -77,9 +93,55 @@ class FeatureExtractor
     void process(const HardwareContext& hcontext, const image::EImageColorSpace workingColorSpace = image::EImageColorSpace::SRGB);
 
   private:
-    void computeViewJob(const FeatureExtractorViewJob& job,
-                        bool useGPU,
-                        const image::EImageColorSpace workingColorSpace = image::EImageColorSpace::SRGB);
+    /**
+     * @brief Images of a view, decoded once and shared by all the image describers of the view.
+     */
+    struct ViewImages
+    {
+        image::Image<float> imageGrayFloat;
+        image::Image<unsigned char> imageGrayUChar;
+        image::Image<unsigned char> mask;
+        double pixelRatio = 1.0;
+    };
+
+    /**
+     * @brief Read the image (resampled to square pixels) and the optional mask of a view.
+     * @param[in] job The view job
+     * @param[in] workingColorSpace The color space of the image
+     * @param[out] images The decoded images, the 8-bit image is only filled if a describer of the job needs it
+     */
+    void loadViewImages(const FeatureExtractorViewJob& job, const image::EImageColorSpace workingColorSpace, ViewImages& images) const;
+
+    /**
+     * @brief Extract the features of the given image describers from the decoded images and save them.
+     * @param[in] job The view job
+     * @param[in] useGPU Use the GPU or the CPU image describers of the job
+     * @param[in] images The decoded images of the view
+     */
+    void describeView(const FeatureExtractorViewJob& job, bool useGPU, const ViewImages& images) const;
+
+    /**
+     * @brief Extract the features of the GPU image describers from a batch of decoded views and save them.
+     *        The views are given at once to each GPU describer, to pipeline their upload and their extraction.
+     * @param[in] nbViews The number of views in the batch
+     * @param[in] getJob Get the view job of the i-th view of the batch
+     * @param[in] getImages Get the decoded images of the i-th view of the batch
+     */
+    void describeBatch(std::size_t nbViews,
+                       const std::function<const FeatureExtractorViewJob&(std::size_t)>& getJob,
+                       const std::function<const ViewImages&(std::size_t)>& getImages) const;
+
+    /**
+     * @brief Filter the regions of a view with the mask and the fisheye circle, and save them.
+     * @param[in] job The view job
+     * @param[in] imageDescriber The image describer which extracted the regions
+     * @param[in] images The decoded images of the view
+     * @param[in,out] regions The extracted regions
+     */
+    void saveRegions(const FeatureExtractorViewJob& job,
+                     const feature::ImageDescriber& imageDescriber,
+                     const ViewImages& images,
+                     std::unique_ptr<feature::Regions>& regions) const;
 
     const sfmData::SfMData& _sfmData;
     std::vector<std::shared_ptr<feature::ImageDescriber>> _imageDescribers;
@@ -7,6 +7,7 @@
 #include "Fuser.hpp"
 #include <aliceVision/image/io.hpp>
 #include <aliceVision/system/Logger.hpp>
+#include <aliceVision/system/Tracer.hpp>
 #include <aliceVision/utils/filesIO.hpp>
 #include <aliceVision/sfmData/SfMData.hpp>
 #include <aliceVision/mvsData/geometry.hpp>
@@ -124,6 +125,8 @@ bool Fuser::updateInSurr(float pixToleranceFactor,
 // minNumOfModals number of other cams including this cam ... minNumOfModals /in 2,3,...
 void Fuser::filterGroups(const std::vector<int>& cams, float pixToleranceFactor, int pixSizeBall, int pixSizeBallWSP, int nNearestCams)
 {
+    ALICEVISION_TRACE_ZONE_CAT("Fuser::filterGroups", "meshing");
+
     ALICEVISION_LOG_INFO("Precomputing groups.");
     long t1 = clock();
 #pragma omp parallel for
@@ -220,6 +223,8 @@ bool Fuser::filterGroupsRC(int rc, float pixToleranceFactor, int pixSizeBall, in
 // minNumOfModals number of other cams including this cam ... minNumOfModals /in 2,3,...
 void Fuser::filterDepthMaps(const std::vector<int>& cams, int minNumOfModals, int minNumOfModalsWSP2SSP)
 {
+    ALICEVISION_TRACE_ZONE_CAT("Fuser::filterDepthMaps", "meshing");
+
     ALICEVISION_LOG_INFO("Filtering depth maps.");
     long t1 = clock();
 
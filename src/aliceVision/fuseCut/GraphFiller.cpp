@@ -9,13 +9,75 @@
 #include <aliceVision/mvsUtils/common.hpp>
 #include <aliceVision/fuseCut/Intersections.hpp>
 #include <aliceVision/fuseCut/MaxFlow_AdjList.hpp>
+#include <aliceVision/fuseCut/MaxFlow_CSR.hpp>
+#include <aliceVision/system/ResourceReport.hpp>
+#include <aliceVision/system/TaskScheduler.hpp>
+#include <aliceVision/system/Tracer.hpp>
 
 #include <boost/atomic/atomic_ref.hpp>
 
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
 
 namespace aliceVision {
 namespace fuseCut {
 
+namespace {
+
+/**
+ * @brief Spread the 21 lower bits of a value every 3 bits.
+ */
+std::uint64_t spreadBits3(std::uint64_t x)
+{
+    x &= 0x1fffff;
+    x = (x | (x << 32)) & 0x1f00000000ffff;
+    x = (x | (x << 16)) & 0x1f0000ff0000ff;
+    x = (x | (x << 8)) & 0x100f00f00f00f00f;
+    x = (x | (x << 4)) & 0x10c30c30c30c30c3;
+    x = (x | (x << 2)) & 0x1249249249249249;
+    return x;
+}
+
+/**
+ * @brief Get the vertices indices sorted along a Morton (Z-order) curve of their bounding box.
+ */
+std::vector<int> getVerticesMortonOrder(const std::vector<Point3d>& vertices)
+{
+    Point3d bbMin(std::numeric_limits<double>::max(), std::numeric_limits<double>::max(), std::numeric_limits<double>::max());
+    Point3d bbMax(std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest());
+    for (const Point3d& p : vertices)
+    {
+        bbMin = Point3d(std::min(bbMin.x, p.x), std::min(bbMin.y, p.y), std::min(bbMin.z, p.z));
+        bbMax = Point3d(std::max(bbMax.x, p.x), std::max(bbMax.y, p.y), std::max(bbMax.z, p.z));
+    }
+
+    const double maxCoord = double((1 << 21) - 1);
+    const double extent = std::max({bbMax.x - bbMin.x, bbMax.y - bbMin.y, bbMax.z - bbMin.z, std::numeric_limits<double>::min()});
+    const double scale = maxCoord / extent;
+
+    std::vector<std::pair<std::uint64_t, int>> codes(vertices.size());
+#pragma omp parallel for
+    for (int i = 0; i < static_cast<int>(vertices.size()); ++i)
+    {
+        const Point3d& p = vertices[i];
+        const std::uint64_t x = static_cast<std::uint64_t>(std::clamp((p.x - bbMin.x) * scale, 0.0, maxCoord));
+        const std::uint64_t y = static_cast<std::uint64_t>(std::clamp((p.y - bbMin.y) * scale, 0.0, maxCoord));
+        const std::uint64_t z = static_cast<std::uint64_t>(std::clamp((p.z - bbMin.z) * scale, 0.0, maxCoord));
+        codes[i] = std::make_pair(spreadBits3(x) | (spreadBits3(y) << 1) | (spreadBits3(z) << 2), i);
+    }
+    std::sort(codes.begin(), codes.end());
+
+    std::vector<int> ids(codes.size());
+    for (std::size_t i = 0; i < codes.size(); ++i)
+        ids[i] = codes[i].second;
+
+    return ids;
+}
+
+}  // namespace
+
 GraphFiller::GraphFiller(mvsUtils::MultiViewParams& mp, 
                         const PointCloud & pc, 
                         const Tetrahedralization & tetrahedralization)
@@ -31,26 +93,15 @@ GraphFiller::GraphFiller(mvsUtils::MultiViewParams& mp,
 
 void GraphFiller::initCells()
 {
-    _cellsAttr.resize(_tetrahedralization.nb_cells());
-
-    for (int i = 0; i < _cellsAttr.size(); ++i)
-    {
-        GC_cellInfo& c = _cellsAttr[i];
-
-        c.cellSWeight = 0.0f;
-        c.cellTWeight = 0.0f;
-        c.on = 0.0f;
-        c.emptinessScore = 0.0f;
-        for (int s = 0; s < 4; ++s)
-        {
-            //weights for the 4 faces of the tetrahedron
-            c.gEdgeVisWeight[s] = 0.0f;
-        }
-    }
+    // zero weights, for the 4 faces of each tetrahedron
+    // initialized in parallel to spread the memory pages over the NUMA nodes of the threads
+    system::parallelFirstTouchResize(_cellsAttr, _tetrahedralization.nb_cells(), GC_cellInfo());
 }
 
 void GraphFiller::build(const StaticVector<int>& cams)
 {
+    ALICEVISION_TRACE_ZONE_CAT("GraphFiller::build", "meshing");
+
     const int maxint = std::numeric_limits<int>::max();
 
     const double nPixelSizeBehind = _mp.userParams.get<double>("delaunaycut.nPixelSizeBehind", 4.0);
@@ -81,34 +132,62 @@ void GraphFiller::addToInfiniteSw(float sW)
 
 void GraphFiller::fillGraph(double nPixelSizeBehind, float fullWeight)
 {
+    ALICEVISION_TRACE_ZONE_CAT("GraphFiller::fillGraph", "meshing");
+    ALICEVISION_RESOURCE_PHASE("GraphFiller::fillGraph");
+
     ALICEVISION_LOG_INFO("Computing s-t graph weights.");
 
-    // choose random order to prevent waiting
+    // the rays of close vertices cross the same cells: the vertices are grouped in blocks along a Morton curve
+    // and the rays of a block are marched camera by camera, for the cells and vertices to stay in cache
+    const std::vector<int> verticesSpatialIds = getVerticesMortonOrder(_verticesCoords);
+    const int blockSize = 64;
+    const int nbBlocks = (static_cast<int>(verticesSpatialIds.size()) + blockSize - 1) / blockSize;
+
+    // choose random order of the blocks to prevent waiting
     const unsigned int seed = (unsigned int)_mp.userParams.get<unsigned int>("delaunaycut.seed", 0);
-    const std::vector<int> verticesRandIds = mvsUtils::createRandomArrayOfIntegers(_verticesAttr.size(), seed);
+    const std::vector<int> blocksRandIds = mvsUtils::createRandomArrayOfIntegers(nbBlocks, seed);
 
-#pragma omp parallel for 
-    for (int i = 0; i < verticesRandIds.size(); i++)
-    {
-        const int vertexIndex = verticesRandIds[i];
-        const GC_vertexInfo& v = _verticesAttr[vertexIndex];
+    // read the user params once, outside of the parallel loop
+    const boost::optional<double> forceWeight = _mp.userParams.get_optional<double>("LargeScale.forceWeight");
 
-        if (!v.isReal())
-        {  
-            continue;
-        }
-        
-        float weight = (float)v.nrc;  // number of cameras
+    // the number of rays per block varies a lot, blocks are stolen one by one by the idle threads to balance them
+    system::parallelFor(0, static_cast<std::ptrdiff_t>(nbBlocks), 1, [&](std::ptrdiff_t b) {
+        const std::size_t firstId = static_cast<std::size_t>(blocksRandIds[b]) * blockSize;
+        const std::size_t lastId = std::min(firstId + blockSize, verticesSpatialIds.size());
+
+        // (camera, vertex) rays of the block
+        std::vector<std::pair<int, int>> rays;
+        for (std::size_t i = firstId; i < lastId; ++i)
+        {
+            const int vertexIndex = verticesSpatialIds[i];
+            const GC_vertexInfo& v = _verticesAttr[vertexIndex];
+
+            if (!v.isReal())
+            {
+                continue;
+            }
 
-        //Overwrite with forced weight if available
-        weight = (float)_mp.userParams.get<double>("LargeScale.forceWeight", weight);
+            for (int c = 0; c < v.cams.size(); c++)
+            {
+                rays.emplace_back(v.cams[c], vertexIndex);
+            }
+        }
+        std::sort(rays.begin(), rays.end());
 
-        for (int c = 0; c < v.cams.size(); c++)
+        for (const auto& ray : rays)
         {
-            rayMarchingGraphEmpty(vertexIndex, v.cams[c], weight);
-            rayMarchingGraphFull(vertexIndex, v.cams[c], weight* fullWeight, nPixelSizeBehind);
+            const int vertexIndex = ray.second;
+
+            float weight = (float)_verticesAttr[vertexIndex].nrc;  // number of cameras
+
+            //Overwrite with forced weight if available
+            if (forceWeight)
+                weight = (float)*forceWeight;
+
+            rayMarchingGraphEmpty(vertexIndex, ray.first, weight);
+            rayMarchingGraphFull(vertexIndex, ray.first, weight* fullWeight, nPixelSizeBehind);
         }
-    }
+    });
 }
 
 void GraphFiller::rayMarchingGraphEmpty(int vertexIndex,
@@ -255,6 +334,8 @@ void GraphFiller::rayMarchingGraphFull(int vertexIndex,
 
 void GraphFiller::forceTedgesByGradientIJCV(float nPixelSizeBehind)
 {
+    ALICEVISION_TRACE_ZONE_CAT("GraphFiller::forceTedgesByGradientIJCV", "meshing");
+
     const float forceTEdgeDelta = 0.1f;
     const float minJumpPartRange = 10000.0f;
     const float maxSilentPartRange = 100.0f;
@@ -268,7 +349,7 @@ void GraphFiller::forceTedgesByGradientIJCV(float nPixelSizeBehind)
     const std::vector<int> verticesRandIds = mvsUtils::createRandomArrayOfIntegers(_verticesAttr.size(), seed);
 
 
-#pragma omp parallel for
+#pragma omp parallel for schedule(dynamic, 64)
     for (int i = 0; i < verticesRandIds.size(); ++i)
     {
         const int vertexIndex = verticesRandIds[i];
@@ -450,8 +531,10 @@ void GraphFiller::forceTedgesByGradientIJCV(float nPixelSizeBehind)
         }
     }
 
-    for (GC_cellInfo& c : _cellsAttr)
+#pragma omp parallel for
+    for (int ci = 0; ci < _cellsAttr.size(); ++ci)
     {
+        GC_cellInfo& c = _cellsAttr[ci];
         const float w = std::max(1.0f, c.cellTWeight) * c.on;
 
         // cellTWeight = clamp(w, cellTWeight, 1000000.0f);
@@ -479,8 +562,34 @@ std::vector<CellIndex> GraphFiller::getNeighboringCellsByGeometry(const Geometry
 void GraphFiller::binarize()
 {
     const std::size_t nbCells = _cellsAttr.size();
+    const EMaxFlowType maxFlowType = EMaxFlowType_stringToEnum(_mp.userParams.get<std::string>("delaunaycut.maxFlowType", "adjList"));
+
+    ALICEVISION_LOG_INFO("Graph cut with maxflow type: " << maxFlowType);
+
+    switch (maxFlowType)
+    {
+        case EMaxFlowType::ADJLIST:
+        {
+            MaxFlow_AdjList maxFlowGraph(nbCells);
+            cutGraph(maxFlowGraph);
+            break;
+        }
+        case EMaxFlowType::CSR:
+        {
+            MaxFlow_CSR maxFlowGraph(nbCells);
+            cutGraph(maxFlowGraph);
+            break;
+        }
+    }
+}
+
+template<typename MaxFlowT>
+void GraphFiller::cutGraph(MaxFlowT& maxFlowGraph)
+{
+    ALICEVISION_TRACE_ZONE_CAT("GraphFiller::cutGraph", "meshing");
+    ALICEVISION_RESOURCE_PHASE("GraphFiller::cutGraph");
 
-    MaxFlow_AdjList maxFlowGraph(nbCells);
+    const std::size_t nbCells = _cellsAttr.size();
 
     // fill s-t edges
     for (CellIndex ci = 0; ci < nbCells; ++ci)
@@ -10,11 +10,51 @@
 #include <aliceVision/fuseCut/Tetrahedralization.hpp>
 #include <aliceVision/mvsUtils/MultiViewParams.hpp>
 #include <aliceVision/fuseCut/Intersections.hpp>
+#include <aliceVision/system/numa.hpp>
 
 
 namespace aliceVision {
 namespace fuseCut {
 
+/**
+ * @brief Maxflow graph representation used for the graph cut
+ */
+enum class EMaxFlowType
+{
+    ADJLIST = 0,  //< Adjacency list graph
+    CSR           //< Compressed sparse row graph, uses less memory
+};
+
+inline std::string EMaxFlowType_enumToString(EMaxFlowType maxFlowType)
+{
+    switch (maxFlowType)
+    {
+        case EMaxFlowType::ADJLIST:
+            return "adjList";
+        case EMaxFlowType::CSR:
+            return "csr";
+    }
+    throw std::out_of_range("Invalid maxflow type enum");
+}
+
+inline EMaxFlowType EMaxFlowType_stringToEnum(const std::string& maxFlowType)
+{
+    if (maxFlowType == "adjList")
+        return EMaxFlowType::ADJLIST;
+    if (maxFlowType == "csr")
+        return EMaxFlowType::CSR;
+    throw std::out_of_range("Invalid maxflow type string: " + maxFlowType);
+}
+
+inline std::ostream& operator<<(std::ostream& os, EMaxFlowType e) { return os << EMaxFlowType_enumToString(e); }
+
+inline std::istream& operator>>(std::istream& in, EMaxFlowType& maxFlowType)
+{
+    std::string token(std::istreambuf_iterator<char>(in), {});
+    maxFlowType = EMaxFlowType_stringToEnum(token);
+    return in;
+}
+
 class GraphFiller
 {
 public:
@@ -22,7 +62,7 @@ public:
 
     void build(const StaticVector<int>& cams);
 
-    const std::vector<GC_cellInfo> & getCellsAttributes() const
+    const system::FirstTouchVector<GC_cellInfo> & getCellsAttributes() const
     {
         return _cellsAttr;
     }
@@ -35,6 +75,9 @@ public:
     void binarize();
 
 private:
+    template<typename MaxFlowT>
+    void cutGraph(MaxFlowT& maxFlowGraph);
+
     void initCells();
     void addToInfiniteSw(float sW);
 
@@ -53,7 +96,7 @@ private:
 
 private:
     mvsUtils::MultiViewParams& _mp;
-    std::vector<GC_cellInfo> _cellsAttr;
+    system::FirstTouchVector<GC_cellInfo> _cellsAttr;
     std::vector<bool> _cellIsFull;
 };
 
@@ -59,6 +59,13 @@ Input tag_invoke(boost::json::value_to_tag<Input>, boost::json::value const& jv)
     ret.subMeshPath = boost::json::value_to<std::string>(obj.at("subMeshPath"));
     ret.bbMin = boost::json::value_to<Eigen::Vector3d>(obj.at("bbMin"));
     ret.bbMax = boost::json::value_to<Eigen::Vector3d>(obj.at("bbMax"));
+    // the inputs without borders own their whole bounding box
+    ret.ownedBbMin = obj.contains("ownedBbMin") ? boost::json::value_to<Eigen::Vector3d>(obj.at("ownedBbMin")) : ret.bbMin;
+    ret.ownedBbMax = obj.contains("ownedBbMax") ? boost::json::value_to<Eigen::Vector3d>(obj.at("ownedBbMax")) : ret.bbMax;
+    if (obj.contains("nbPoints"))
+    {
+        ret.nbPoints = boost::json::value_to<std::size_t>(obj.at("nbPoints"));
+    }
 
     return ret;
 }
@@ -70,6 +77,9 @@ void tag_invoke(const boost::json::value_from_tag&, boost::json::value& jv, Inpu
       {"subMeshPath", t.subMeshPath},
       {"bbMin", boost::json::value_from(t.bbMin)},
       {"bbMax", boost::json::value_from(t.bbMax)},
+      {"ownedBbMin", boost::json::value_from(t.ownedBbMin)},
+      {"ownedBbMax", boost::json::value_from(t.ownedBbMax)},
+      {"nbPoints", t.nbPoints},
     };
 }
 
@@ -18,6 +18,12 @@ struct Input
     std::string subMeshPath;
     Eigen::Vector3d bbMin;
     Eigen::Vector3d bbMax;
+    /// region owned by this input, inside [bbMin, bbMax]: the borders are shared with the neighboring inputs,
+    /// the merge keeps the triangles of each sub mesh inside its owned region
+    Eigen::Vector3d ownedBbMin;
+    Eigen::Vector3d ownedBbMax;
+    /// number of points of the sub region, 0 if unknown
+    std::size_t nbPoints = 0;
 };
 
 using InputSet = std::vector<Input>;
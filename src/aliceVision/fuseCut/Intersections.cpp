@@ -116,6 +116,24 @@ GeometryIntersection TetrahedronsRayMarching::intersectNextGeomFacet()
     
     const CellIndex tetrahedronIndex = _intersection.facet.cellIndex;
 
+    // The ray sides of the 6 edges of the tetrahedron are shared by its facets
+    std::array<Eigen::Vector3d, 4> points;
+    for (int i = 0; i < 4; ++i)
+    {
+        points[i] = getRelativePoint(_tetrahedralization.cell_vertex(tetrahedronIndex, i));
+    }
+
+    double sides[4][4];
+    for (int i = 0; i < 4; ++i)
+    {
+        sides[i][i] = 0.0;
+        for (int j = i + 1; j < 4; ++j)
+        {
+            sides[i][j] = raySide(points[i], points[j]);
+            sides[j][i] = -sides[i][j];
+        }
+    }
+
     // Test all facets of the tetrahedron using i as localVertexIndex to define next intersectionFacet
     for (int i = 0; i < 4; ++i)
     {
@@ -126,9 +144,17 @@ GeometryIntersection TetrahedronsRayMarching::intersectNextGeomFacet()
         }
 
         const Facet intersectionFacet(tetrahedronIndex, i);
+        const VertexIndex a = intersectionFacet.getIndex(0);
+        const VertexIndex b = intersectionFacet.getIndex(1);
+        const VertexIndex c = intersectionFacet.getIndex(2);
         bool ambiguous = false;
 
-        const GeometryIntersection result = rayIntersectTriangle(intersectionFacet, _previousIntersectionPoint, _intersectionPoint, ambiguous);
+        const GeometryIntersection result = rayIntersectTriangle(intersectionFacet,
+                                                                 {points[a], points[b], points[c]},
+                                                                 {sides[b][c], sides[c][a], sides[a][b]},
+                                                                 _previousIntersectionPoint,
+                                                                 _intersectionPoint,
+                                                                 ambiguous);
         if (result.type != EGeometryType::None)
         {
             if (!ambiguous)
@@ -241,64 +267,25 @@ GeometryIntersection TetrahedronsRayMarching::intersectNextGeomVertex()
     return bestMatch;
 }
 
-Eigen::Vector2d TetrahedronsRayMarching::getLineTriangleIntersectBarycCoords(Eigen::Vector3d & P,
-                                                                            const Eigen::Vector3d & A, 
-                                                                            const Eigen::Vector3d & B, 
-                                                                            const Eigen::Vector3d & C) const
+GeometryIntersection TetrahedronsRayMarching::rayIntersectTriangle(
+                                                        const Facet& facet,
+                                                        const Eigen::Vector3d & lastIntersectionPoint,
+                                                        Eigen::Vector3d & intersectPt,
+                                                        bool& ambiguous) const
 {
-    const double A_x = A.x();
-    const double A_y = A.y();
-    const double A_z = A.z();
-    const double linePoint_x = _origin.x();
-    const double linePoint_y = _origin.y();
-    const double linePoint_z = _origin.z();
-    const double lineVect_x = _direction.x();
-    const double lineVect_y = _direction.y();
-    const double lineVect_z = _direction.z();
-    const double v0_x = C.x() - A_x;
-    const double v0_y = C.y() - A_y;
-    const double v0_z = C.z() - A_z;
-    const double v1_x = B.x() - A_x;
-    const double v1_y = B.y() - A_y;
-    const double v1_z = B.z() - A_z;
-    const double _n_x = v0_y * v1_z - v0_z * v1_y;
-    const double _n_y = v0_z * v1_x - v0_x * v1_z;
-    const double _n_z = v0_x * v1_y - v0_y * v1_x;
-    const double k = ((A_x * _n_x + A_y * _n_y + A_z * _n_z) - (_n_x * linePoint_x + _n_y * linePoint_y + _n_z * linePoint_z)) / (_n_x * lineVect_x + _n_y * lineVect_y + _n_z * lineVect_z);
-    const double P_x = linePoint_x + lineVect_x * k;
-    const double P_y = linePoint_y + lineVect_y * k;
-    const double P_z = linePoint_z + lineVect_z * k;
-
-    // Compute vectors
-    const double v2_x = P_x - A_x;
-    const double v2_y = P_y - A_y;
-    const double v2_z = P_z - A_z;
-
-    // Compute dot products
-    const double dot00 = (v0_x * v0_x + v0_y * v0_y + v0_z * v0_z);
-    const double dot01 = (v0_x * v1_x + v0_y * v1_y + v0_z * v1_z);
-    const double dot02 = (v0_x * v2_x + v0_y * v2_y + v0_z * v2_z);
-    const double dot11 = (v1_x * v1_x + v1_y * v1_y + v1_z * v1_z);
-    const double dot12 = (v1_x * v2_x + v1_y * v2_y + v1_z * v2_z);
-
-    // Compute barycentric coordinates
-    const double invDenom = 1.0 / (dot00 * dot11 - dot01 * dot01);
-    const double u = (dot11 * dot02 - dot01 * dot12) * invDenom;
-    const double v = (dot00 * dot12 - dot01 * dot02) * invDenom;
-
-    P.x() = P_x;
-    P.y() = P_y;
-    P.z() = P_z;
-
-    Eigen::Vector2d ret;
-    ret.x() = u;
-    ret.y() = v;
-
-    return ret;
+    const std::array<Eigen::Vector3d, 3> points{{getRelativePoint(_tetrahedralization.cell_vertex(facet.cellIndex, facet.getIndex(0))),
+                                                 getRelativePoint(_tetrahedralization.cell_vertex(facet.cellIndex, facet.getIndex(1))),
+                                                 getRelativePoint(_tetrahedralization.cell_vertex(facet.cellIndex, facet.getIndex(2)))}};
+
+    const std::array<double, 3> sides{{raySide(points[1], points[2]), raySide(points[2], points[0]), raySide(points[0], points[1])}};
+
+    return rayIntersectTriangle(facet, points, sides, lastIntersectionPoint, intersectPt, ambiguous);
 }
 
 GeometryIntersection TetrahedronsRayMarching::rayIntersectTriangle(
                                                         const Facet& facet,
+                                                        const std::array<Eigen::Vector3d, 3> & points,
+                                                        const std::array<double, 3> & sides,
                                                         const Eigen::Vector3d & lastIntersectionPoint,
                                                         Eigen::Vector3d & intersectPt,
                                                         bool& ambiguous) const
@@ -315,21 +302,6 @@ GeometryIntersection TetrahedronsRayMarching::rayIntersectTriangle(
     const Point3d & B = vertices[BvertexIndex];
     const Point3d & C = vertices[CvertexIndex];
 
-    Eigen::Vector3d eA;
-    eA.x() = A.x;
-    eA.y() = A.y;
-    eA.z() = A.z;
-
-    Eigen::Vector3d eB;
-    eB.x() = B.x;
-    eB.y() = B.y;
-    eB.z() = B.z;
-
-    Eigen::Vector3d eC;
-    eC.x() = C.x;
-    eC.y() = C.y;
-    eC.z() = C.z;
-
     const double ABSize = (A - B).size();
     const double BCSize = (B - C).size();
     const double ACSize = (A - C).size();
@@ -337,10 +309,12 @@ GeometryIntersection TetrahedronsRayMarching::rayIntersectTriangle(
     const double marginEpsilon = std::min({ABSize, BCSize, ACSize}) * _epsilonFactor;
     const double ambiguityEpsilon = (ABSize + BCSize + ACSize) / 3.0 * 1.0e-2;
 
-    
+    // Barycentric coordinates of the intersection of the ray line with the facet plane
+    const double invSidesSum = 1.0 / (sides[0] + sides[1] + sides[2]);
+    const double u = sides[2] * invSidesSum;  // A to C
+    const double v = sides[1] * invSidesSum;  // A to B
 
-    Eigen::Vector3d tempIntersectPt;
-    const Eigen::Vector2d triangleUv = getLineTriangleIntersectBarycCoords(tempIntersectPt, eA, eB, eC);
+    const Eigen::Vector3d tempIntersectPt = _origin + (1.0 - u - v) * points[0] + v * points[1] + u * points[2];
 
     if (!std::isnormal(tempIntersectPt.x()) 
         || !std::isnormal(tempIntersectPt.y()) 
@@ -349,9 +323,6 @@ GeometryIntersection TetrahedronsRayMarching::rayIntersectTriangle(
         return GeometryIntersection();
     }
 
-    const double u = triangleUv.x();  // A to C
-    const double v = triangleUv.y();  // A to B
-
     // If we find invalid uv coordinate
     if (!std::isfinite(u) || !std::isfinite(v))
     {
@@ -386,12 +357,12 @@ GeometryIntersection TetrahedronsRayMarching::rayIntersectTriangle(
     {
         if (u < marginEpsilon)
         {
-            intersectPt = eA;
+            intersectPt = Eigen::Vector3d(A.x, A.y, A.z);
             return GeometryIntersection(AvertexIndex);  // vertex A
         }
         if (u > 1.0 - marginEpsilon)
         {
-            intersectPt = eC;
+            intersectPt = Eigen::Vector3d(C.x, C.y, C.z);
             return GeometryIntersection(CvertexIndex);  // vertex C
         }
 
@@ -402,7 +373,7 @@ GeometryIntersection TetrahedronsRayMarching::rayIntersectTriangle(
     {
         if (v > 1.0 - marginEpsilon)
         {
-            intersectPt = eB;
+            intersectPt = Eigen::Vector3d(B.x, B.y, B.z);
             return GeometryIntersection(BvertexIndex);  // vertex B
         }
 
@@ -127,15 +127,46 @@ private:
 
     GeometryIntersection intersectNextGeomVertex();
 
-    Eigen::Vector2d getLineTriangleIntersectBarycCoords(Eigen::Vector3d & P, 
-                                                        const Eigen::Vector3d & A,  
-                                                        const Eigen::Vector3d & B, 
-                                                        const Eigen::Vector3d & C) const;
+    /**
+     * @brief Position of a vertex relative to the ray origin.
+     */
+    Eigen::Vector3d getRelativePoint(VertexIndex vi) const
+    {
+        const Point3d & p = _tetrahedralization.getVertices()[vi];
+        return Eigen::Vector3d(p.x - _origin.x(), p.y - _origin.y(), p.z - _origin.z());
+    }
+
+    /**
+     * @brief Side of the oriented line (P, Q) relative to the ray (permuted inner product of their Plücker coordinates).
+     * @note The points are relative to the ray origin, so the product is the determinant of (direction, P, Q).
+     */
+    double raySide(const Eigen::Vector3d & p, const Eigen::Vector3d & q) const
+    {
+        return _direction.dot(p.cross(q));
+    }
 
     GeometryIntersection rayIntersectTriangle(const Facet& facet,
                                             const Eigen::Vector3d & lastIntersectPt,
                                             Eigen::Vector3d & intersectPt,
-                                            bool& ambiguous) const;    
+                                            bool& ambiguous) const;
+
+    /**
+     * @brief Intersect the ray with a facet from the ray sides of its edges.
+     *        The barycentric coordinates of the intersection are the normalized sides of the opposite edges.
+     * @param[in] facet the facet
+     * @param[in] points the facet vertices A, B, C relative to the ray origin
+     * @param[in] sides the ray sides of the edges BC, CA, AB
+     * @param[in] lastIntersectPt the previous intersection point
+     * @param[out] intersectPt the intersection point
+     * @param[out] ambiguous the intersection is too close to the previous intersection point
+     * @return the intersected geometry (facet, or edge or vertex within the margins)
+     */
+    GeometryIntersection rayIntersectTriangle(const Facet& facet,
+                                            const std::array<Eigen::Vector3d, 3> & points,
+                                            const std::array<double, 3> & sides,
+                                            const Eigen::Vector3d & lastIntersectPt,
+                                            Eigen::Vector3d & intersectPt,
+                                            bool& ambiguous) const;
 
 private:
     const Tetrahedralization & _tetrahedralization;
@@ -0,0 +1,107 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "MaxFlow_CSR.hpp"
+
+#include <map>
+#include <utility>
+
+namespace aliceVision {
+namespace fuseCut {
+
+void MaxFlow_CSR::buildGraph()
+{
+    const std::size_t nbEdges = _edgesSource.size();
+
+    // counting sort of the edges by source node
+    std::vector<EdgeIndexType> offsets(_numNodes + 1, 0);
+    for (const NodeType s : _edgesSource)
+        ++offsets[s + 1];
+    for (std::size_t n = 0; n < _numNodes; ++n)
+        offsets[n + 1] += offsets[n];
+
+    std::vector<EdgeIndexType> sortedIndex(nbEdges);
+    for (std::size_t e = 0; e < nbEdges; ++e)
+        sortedIndex[e] = offsets[_edgesSource[e]]++;
+    offsets.clear();
+    offsets.shrink_to_fit();
+
+    std::vector<std::pair<NodeType, NodeType>> sortedEdges(nbEdges);
+    std::vector<Edge> sortedEdgesData(nbEdges);
+    for (std::size_t e = 0; e < nbEdges; ++e)
+    {
+        const std::size_t reverse = e ^ 1;
+        const EdgeIndexType i = sortedIndex[e];
+
+        sortedEdges[i] = std::make_pair(_edgesSource[e], _edgesTarget[e]);
+        sortedEdgesData[i].capacity = _edgesCapacity[e];
+        sortedEdgesData[i].reverse = edge_descriptor(_edgesSource[reverse], sortedIndex[reverse]);
+    }
+
+    // release the input edges before the graph allocation
+    std::vector<EdgeIndexType>().swap(sortedIndex);
+    std::vector<NodeType>().swap(_edgesSource);
+    std::vector<NodeType>().swap(_edgesTarget);
+    std::vector<ValueType>().swap(_edgesCapacity);
+
+    _graph = Graph(boost::edges_are_sorted, sortedEdges.begin(), sortedEdges.end(), sortedEdgesData.begin(), _numNodes, nbEdges);
+}
+
+MaxFlow_CSR::ValueType MaxFlow_CSR::compute()
+{
+    ALICEVISION_LOG_INFO("Build compressed sparse row graph.");
+    buildGraph();
+
+    printStats();
+    ALICEVISION_LOG_INFO("Compute boykov_kolmogorov_max_flow.");
+
+    const std::size_t nbVertices = boost::num_vertices(_graph);
+    _color.resize(nbVertices, boost::white_color);
+    std::vector<edge_descriptor> pred(nbVertices);
+    std::vector<NodeType> dist(nbVertices);
+
+    const auto vertexIndexMap = boost::get(boost::vertex_index, _graph);
+    const ValueType v = boost::boykov_kolmogorov_max_flow(_graph,
+                                                          boost::get(&Edge::capacity, _graph),
+                                                          boost::get(&Edge::residual, _graph),
+                                                          boost::get(&Edge::reverse, _graph),
+                                                          boost::make_iterator_property_map(pred.begin(), vertexIndexMap),
+                                                          boost::make_iterator_property_map(_color.begin(), vertexIndexMap),
+                                                          boost::make_iterator_property_map(dist.begin(), vertexIndexMap),
+                                                          vertexIndexMap,
+                                                          _S,
+                                                          _T);
+
+    printColorStats();
+
+    return v;
+}
+
+void MaxFlow_CSR::printStats() const
+{
+    ALICEVISION_LOG_INFO("# vertices: " << boost::num_vertices(_graph) << ", # edges: " << boost::num_edges(_graph));
+}
+
+void MaxFlow_CSR::printColorStats() const
+{
+    std::map<int, int> histColor;
+
+    for (const auto& color : _color)
+    {
+        ++histColor[(int)color];
+    }
+    ALICEVISION_LOG_INFO("Full (white):" << int(boost::white_color));
+    ALICEVISION_LOG_INFO("Empty (black):" << int(boost::black_color));
+    ALICEVISION_LOG_INFO("Undefined (gray):" << int(boost::gray_color));
+
+    for (const auto& it : histColor)
+    {
+        ALICEVISION_LOG_INFO("\t- color[" << it.first << "]: " << it.second);
+    }
+}
+
+}  // namespace fuseCut
+}  // namespace aliceVision
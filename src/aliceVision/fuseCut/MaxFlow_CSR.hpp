@@ -0,0 +1,133 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/system/Logger.hpp>
+
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/compressed_sparse_row_graph.hpp>
+#include <boost/graph/boykov_kolmogorov_max_flow.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace aliceVision {
+namespace fuseCut {
+
+/**
+ * @brief Maxflow computation based on a Compressed Sparse Row graph representation.
+ *
+ * Edges are stored in flat arrays while the graph is filled, then sorted by source
+ * into the CSR graph right before the maxflow computation.
+ * It uses less memory than MaxFlow_AdjList which allocates one edge list per node.
+ *
+ * @see MaxFlow_AdjList
+ */
+class MaxFlow_CSR
+{
+  public:
+    using NodeType = std::uint32_t;
+    using EdgeIndexType = std::uint64_t;
+    using ValueType = float;
+
+    using edge_descriptor = boost::detail::csr_edge_descriptor<NodeType, EdgeIndexType>;
+
+    struct Edge
+    {
+        ValueType capacity{};
+        ValueType residual{};
+        edge_descriptor reverse;
+    };
+
+    using Graph = boost::compressed_sparse_row_graph<boost::directedS,
+                                                     boost::no_property,  // VertexProperty
+                                                     Edge,                // EdgeProperty
+                                                     boost::no_property,  // GraphProperty
+                                                     NodeType,            // Vertex
+                                                     EdgeIndexType        // EdgeIndex
+                                                     >;
+
+  public:
+    explicit MaxFlow_CSR(std::size_t numNodes)
+      : _numNodes(numNodes + 2),
+        _S(NodeType(numNodes)),
+        _T(NodeType(numNodes + 1))
+    {
+        // 2 edges per s-t link and 2 edges for each of the 4 facets per cell
+        const std::size_t nbEdgesEstimation = numNodes * 2 + numNodes * 8;
+        _edgesSource.reserve(nbEdgesEstimation);
+        _edgesTarget.reserve(nbEdgesEstimation);
+        _edgesCapacity.reserve(nbEdgesEstimation);
+    }
+
+    inline void addNode(NodeType n, ValueType source, ValueType sink)
+    {
+        assert(source >= 0 && sink >= 0);
+        const ValueType score = source - sink;
+        if (score > 0)
+        {
+            addEdgePair(_S, n, score, score);
+        }
+        else  // if(score <= 0)
+        {
+            addEdgePair(n, _T, -score, -score);
+        }
+    }
+
+    inline void addEdge(NodeType n1, NodeType n2, ValueType capacity, ValueType reverseCapacity)
+    {
+        assert(capacity >= 0 && reverseCapacity >= 0);
+        addEdgePair(n1, n2, capacity, reverseCapacity);
+    }
+
+    void printStats() const;
+    void printColorStats() const;
+
+    /**
+     * @brief Build the CSR graph from the added edges and compute the maxflow.
+     * @return the total flow
+     */
+    ValueType compute();
+
+    /// is empty
+    inline bool isSource(NodeType n) const { return (_color[n] == boost::black_color); }
+    /// is full
+    inline bool isTarget(NodeType n) const { return (_color[n] == boost::white_color); }
+
+  private:
+    /**
+     * @brief Add an edge and its reverse edge, stored consecutively so that the reverse of edge e is e^1.
+     */
+    inline void addEdgePair(NodeType n1, NodeType n2, ValueType capacity, ValueType reverseCapacity)
+    {
+        _edgesSource.push_back(n1);
+        _edgesTarget.push_back(n2);
+        _edgesCapacity.push_back(capacity);
+
+        _edgesSource.push_back(n2);
+        _edgesTarget.push_back(n1);
+        _edgesCapacity.push_back(reverseCapacity);
+    }
+
+    /**
+     * @brief Sort the added edges by source node and build the CSR graph.
+     */
+    void buildGraph();
+
+  protected:
+    const std::size_t _numNodes;
+    std::vector<NodeType> _edgesSource;
+    std::vector<NodeType> _edgesTarget;
+    std::vector<ValueType> _edgesCapacity;
+    Graph _graph;
+    std::vector<boost::default_color_type> _color;
+    const NodeType _S;  //< emptyness
+    const NodeType _T;  //< fullness
+};
+
+}  // namespace fuseCut
+}  // namespace aliceVision
@@ -8,6 +8,8 @@
 
 #include <aliceVision/mvsData/Universe.hpp>
 #include <aliceVision/mvsData/geometry.hpp>
+#include <aliceVision/system/ResourceReport.hpp>
+#include <aliceVision/system/Tracer.hpp>
 #include <boost/atomic/atomic_ref.hpp>
 
 namespace aliceVision {
@@ -29,6 +31,9 @@ Mesher::Mesher(mvsUtils::MultiViewParams& mp,
 
 mesh::Mesh* Mesher::createMesh(int maxNbConnectedHelperPoints)
 {
+    ALICEVISION_TRACE_ZONE_CAT("Mesher::createMesh", "meshing");
+    ALICEVISION_RESOURCE_PHASE("Mesher::createMesh");
+
 
     std::vector<bool> vertexIsOnSurface;
     const int nbSurfaceFacets = computeIsOnSurface(vertexIsOnSurface);
@@ -272,6 +277,9 @@ void Mesher::filterLargeHelperPoints(std::vector<bool>& out_reliableVertices,
 
 void Mesher::graphCutPostProcessing(const Point3d hexah[8])
 {
+    ALICEVISION_TRACE_ZONE_CAT("Mesher::graphCutPostProcessing", "meshing");
+    ALICEVISION_RESOURCE_PHASE("Mesher::graphCutPostProcessing");
+
     long timer = std::clock();
     ALICEVISION_LOG_INFO("Graph cut post-processing.");
 
@@ -127,6 +127,34 @@ class SimpleNode
         }
     }
 
+    /**
+     * @brief List the non empty nodes whose bounding box, enlarged by a margin, contains the point.
+     * @param[in] pt the point
+     * @param[in] margin the enlargement of the bounding boxes
+     * @param[out] list the nodes containing the point
+     */
+    void getNodesContaining(const Eigen::Vector3d& pt, double margin, std::vector<SimpleNode::ptr>& list)
+    {
+        // the children are inside their parent: the whole subtree is skipped
+        if ((pt - _bbMin).minCoeff() < -margin || (_bbMax - pt).minCoeff() < -margin)
+        {
+            return;
+        }
+
+        if (_count > 0)
+        {
+            list.push_back(this);
+        }
+
+        for (auto& item : _nodes)
+        {
+            if (item)
+            {
+                item->getNodesContaining(pt, margin, list);
+            }
+        }
+    }
+
     void regroup(size_t maxPointsPerNode)
     {
         size_t count = getCount();
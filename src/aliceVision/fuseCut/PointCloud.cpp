@@ -7,6 +7,8 @@
 #include "PointCloud.hpp"
 
 #include <aliceVision/utils/filesIO.hpp>
+#include <aliceVision/system/ResourceReport.hpp>
+#include <aliceVision/system/Tracer.hpp>
 
 #include <aliceVision/fuseCut/Fuser.hpp>
 #include <aliceVision/mvsUtils/mapIO.hpp>
@@ -15,15 +17,76 @@
 #include <aliceVision/mvsData/geometry.hpp>
 
 #include <aliceVision/fuseCut/Kdtree.hpp>
+#include <aliceVision/mesh/spatialOrder.hpp>
 
 #include <geogram/mesh/mesh.h>
 #include <geogram/basic/geometry_nd.h>
 
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+
 namespace aliceVision {
 namespace fuseCut {
 
 namespace fs = std::filesystem;
 
+namespace {
+
+/**
+ * @brief Spatial hash of points on a regular grid of cells, to find the points closer than the cell size of a position.
+ */
+class PointsSpatialHash
+{
+  public:
+    explicit PointsSpatialHash(double cellSize)
+      : _invCellSize(1.0 / cellSize)
+    {}
+
+    void insert(const Point3d& p, std::size_t index) { _cells[getCellKey(getCell(p))].push_back(index); }
+
+    /**
+     * @brief Call f(index) for the indices of the inserted points of the 27 cells around p.
+     */
+    template<typename F>
+    void forEachCandidate(const Point3d& p, F f) const
+    {
+        const std::array<std::int64_t, 3> cell = getCell(p);
+        for (std::int64_t dx = -1; dx <= 1; ++dx)
+            for (std::int64_t dy = -1; dy <= 1; ++dy)
+                for (std::int64_t dz = -1; dz <= 1; ++dz)
+                {
+                    const auto it = _cells.find(getCellKey({cell[0] + dx, cell[1] + dy, cell[2] + dz}));
+                    if (it == _cells.end())
+                        continue;
+                    for (std::size_t index : it->second)
+                        f(index);
+                }
+    }
+
+  private:
+    std::array<std::int64_t, 3> getCell(const Point3d& p) const
+    {
+        return {static_cast<std::int64_t>(std::floor(p.x * _invCellSize)),
+                static_cast<std::int64_t>(std::floor(p.y * _invCellSize)),
+                static_cast<std::int64_t>(std::floor(p.z * _invCellSize))};
+    }
+
+    static std::uint64_t getCellKey(const std::array<std::int64_t, 3>& cell)
+    {
+        // 21 bits per axis
+        return (static_cast<std::uint64_t>(cell[0] & 0x1fffff) << 42) | (static_cast<std::uint64_t>(cell[1] & 0x1fffff) << 21) |
+               static_cast<std::uint64_t>(cell[2] & 0x1fffff);
+    }
+
+    double _invCellSize;
+    std::unordered_map<std::uint64_t, std::vector<std::size_t>> _cells;
+};
+
+}  // namespace
+
 /// Filter by pixSize
 void filterByPixSize(const std::vector<Point3d>& verticesCoordsPrepare,
                      std::vector<double>& pixSizePrepare,
@@ -251,6 +314,9 @@ PointCloud::PointCloud(mvsUtils::MultiViewParams& mp) : _mp(mp)
 
 void PointCloud::fuseFromDepthMaps(const StaticVector<int>& cams, const Point3d voxel[8], const PointCloudFuseParams& params)
 {
+    ALICEVISION_TRACE_ZONE_CAT("PointCloud::fuseFromDepthMaps", "meshing");
+    ALICEVISION_RESOURCE_PHASE("PointCloud::fuseFromDepthMaps");
+
      ALICEVISION_LOG_INFO("fuseFromDepthMaps, maxVertices: " << params.maxPoints);
 
     // Load depth from depth maps, select points per depth maps (1 value per tile).
@@ -269,16 +335,17 @@ void PointCloud::fuseFromDepthMaps(const StaticVector<int>& cams, const Point3d
     int step = std::floor(std::sqrt(double(nbPixels) / double(params.maxInputPoints)));
     step = std::max(step, params.minStep);
     std::size_t realMaxVertices = 0;
-    std::vector<int> startIndex(_mp.getNbCameras(), 0);
     for (int i = 0; i < _mp.getNbCameras(); ++i)
     {
         const auto& imgParams = _mp.getImageParams(i);
-        startIndex[i] = realMaxVertices;
         realMaxVertices += divideRoundUp(imgParams.width, step) * divideRoundUp(imgParams.height, step);
     }
-    std::vector<Point3d> verticesCoordsPrepare(realMaxVertices);
-    std::vector<double> pixSizePrepare(realMaxVertices);
-    std::vector<float> simScorePrepare(realMaxVertices);
+
+    // Points are streamed per depth map: only the valid points of each camera are kept,
+    // so the memory does not depend on the number of input depth values but on the number of selected points.
+    std::vector<std::vector<Point3d>> camsVerticesCoords(cams.size());
+    std::vector<std::vector<double>> camsPixSize(cams.size());
+    std::vector<std::vector<float>> camsSimScore(cams.size());
 
     // counter for filtered points
     int minVisCounter = 0;
@@ -292,8 +359,11 @@ void PointCloud::fuseFromDepthMaps(const StaticVector<int>& cams, const Point3d
 
     ALICEVISION_LOG_INFO("Load depth maps and add points.");
     {
+        // the loading time varies with the depth maps compression and tiling, so the cameras are dynamically scheduled
+        const int nbLoadThreads = std::max(1, params.nbLoadThreads);
+
         omp_set_nested(1);
-#pragma omp parallel for num_threads(3)
+#pragma omp parallel for num_threads(nbLoadThreads) schedule(dynamic)
         for (int c = 0; c < cams.size(); c++)
         {
             image::Image<float> depthMap;
@@ -347,12 +417,18 @@ void PointCloud::fuseFromDepthMaps(const StaticVector<int>& cams, const Point3d
 
             const int syMax = divideRoundUp(height, step);
             const int sxMax = divideRoundUp(width, step);
+
+            // points selected in the current depth map (1 value per tile)
+            std::vector<Point3d> verticesCoordsCam(syMax * sxMax);
+            std::vector<double> pixSizeCam(syMax * sxMax);
+            std::vector<float> simScoreCam(syMax * sxMax);
+
 #pragma omp parallel for
             for (int sy = 0; sy < syMax; ++sy)
             {
                 for (int sx = 0; sx < sxMax; ++sx)
                 {
-                    const int index = startIndex[c] + sy * sxMax + sx;
+                    const int index = sy * sxMax + sx;
                     float bestDepth = std::numeric_limits<float>::max();
                     float bestScore = 0;
                     float bestSimScore = 0;
@@ -399,7 +475,7 @@ void PointCloud::fuseFromDepthMaps(const StaticVector<int>& cams, const Point3d
                     if (bestScore < 3 * 13)
                     {
                         // discard the point
-                        pixSizePrepare[index] = -1.0;
+                        pixSizeCam[index] = -1.0;
                     }
                     else
                     {
@@ -408,23 +484,60 @@ void PointCloud::fuseFromDepthMaps(const StaticVector<int>& cams, const Point3d
                         // TODO: isPointInHexahedron: here or in the previous loop per pixel to not loose point?
                         if (voxel == nullptr || mvsUtils::isPointInHexahedron(p, voxel))
                         {
-                            verticesCoordsPrepare[index] = p;
-                            simScorePrepare[index] = bestSimScore;
-                            pixSizePrepare[index] = _mp.getCamPixelSize(p, c);
+                            verticesCoordsCam[index] = p;
+                            simScoreCam[index] = bestSimScore;
+                            pixSizeCam[index] = _mp.getCamPixelSize(p, c);
                         }
                         else
                         {
                             // discard the point
-                            // verticesCoordsPrepare[index] = p;
-                            pixSizePrepare[index] = -1.0;
+                            pixSizeCam[index] = -1.0;
                         }
                     }
                 }
             }
+
+            // keep only the valid points of the current depth map
+            removeInvalidPoints(verticesCoordsCam, pixSizeCam, simScoreCam);
+            verticesCoordsCam.shrink_to_fit();
+            pixSizeCam.shrink_to_fit();
+            simScoreCam.shrink_to_fit();
+
+            camsVerticesCoords[c].swap(verticesCoordsCam);
+            camsPixSize[c].swap(pixSizeCam);
+            camsSimScore[c].swap(simScoreCam);
         }
         omp_set_nested(0);
     }
 
+    // Concatenate the points of all depth maps in the cameras order
+    std::vector<Point3d> verticesCoordsPrepare;
+    std::vector<double> pixSizePrepare;
+    std::vector<float> simScorePrepare;
+    {
+        std::size_t nbLoadedVertices = 0;
+        for (const auto& verticesCoordsCam : camsVerticesCoords)
+            nbLoadedVertices += verticesCoordsCam.size();
+
+        verticesCoordsPrepare.reserve(nbLoadedVertices);
+        pixSizePrepare.reserve(nbLoadedVertices);
+        simScorePrepare.reserve(nbLoadedVertices);
+
+        for (int c = 0; c < cams.size(); ++c)
+        {
+            verticesCoordsPrepare.insert(verticesCoordsPrepare.end(), camsVerticesCoords[c].begin(), camsVerticesCoords[c].end());
+            pixSizePrepare.insert(pixSizePrepare.end(), camsPixSize[c].begin(), camsPixSize[c].end());
+            simScorePrepare.insert(simScorePrepare.end(), camsSimScore[c].begin(), camsSimScore[c].end());
+
+            // release the camera points as soon as they are merged
+            std::vector<Point3d>().swap(camsVerticesCoords[c]);
+            std::vector<double>().swap(camsPixSize[c]);
+            std::vector<float>().swap(camsSimScore[c]);
+        }
+
+        ALICEVISION_LOG_INFO(nbLoadedVertices << " points loaded from depth maps (realMaxVertices: " << realMaxVertices << ").");
+    }
+
     ALICEVISION_LOG_INFO("Filter initial 3D points by pixel size to remove duplicates.");
 
     filterByPixSize(verticesCoordsPrepare, pixSizePrepare, params.pixSizeMarginInitCoef, simScorePrepare);
@@ -710,18 +823,31 @@ void PointCloud::densifyWithHelperPoints(int nbFront, int nbBack, double scale)
         return;
 
     const std::size_t nbInputVertices = _verticesCoords.size();
+    const std::size_t nbHelperPointsPerVertex = std::max(nbFront, 0) + std::max(nbBack, 0);
 
-    std::vector<Point3d> newHelperPoints;
-    newHelperPoints.reserve((nbFront + nbBack) * nbInputVertices);
-
+    // offset of the helper points of each vertex, the vertices without cameras or pixel size have no helper points
+    std::vector<std::size_t> helperPointsOffsets(nbInputVertices + 1, 0);
     for (std::size_t vi = 0; vi < nbInputVertices; ++vi)
     {
-        const Point3d& v = _verticesCoords[vi];
         const GC_vertexInfo& vAttr = _verticesAttr[vi];
+        const bool hasHelperPoints = !vAttr.cams.empty() && vAttr.pixSize > std::numeric_limits<float>::epsilon();
+        helperPointsOffsets[vi + 1] = helperPointsOffsets[vi] + (hasHelperPoints ? nbHelperPointsPerVertex : 0);
+    }
+    const std::size_t nbHelperPoints = helperPointsOffsets.back();
 
-        if (vAttr.cams.empty() || vAttr.pixSize <= std::numeric_limits<float>::epsilon())
+    // Keep vertexInfo of the helper points with default/empty values, so they will be removed at the end as other helper points
+    _verticesCoords.resize(nbInputVertices + nbHelperPoints);
+    _verticesAttr.resize(nbInputVertices + nbHelperPoints);
+
+#pragma omp parallel for schedule(dynamic, 1024)
+    for (std::ptrdiff_t vi = 0; vi < static_cast<std::ptrdiff_t>(nbInputVertices); ++vi)
+    {
+        if (helperPointsOffsets[vi + 1] == helperPointsOffsets[vi])
             continue;
 
+        const Point3d& v = _verticesCoords[vi];
+        const GC_vertexInfo& vAttr = _verticesAttr[vi];
+
         Point3d mainCamDir;
         for (int camId : vAttr.cams)
         {
@@ -732,22 +858,14 @@ void PointCloud::densifyWithHelperPoints(int nbFront, int nbBack, double scale)
         mainCamDir /= double(vAttr.cams.size());
         mainCamDir = mainCamDir.normalize() * vAttr.pixSize;
 
+        std::size_t newVi = nbInputVertices + helperPointsOffsets[vi];
         for (int iFront = 1; iFront < nbFront + 1; ++iFront)
-            newHelperPoints.push_back(v + mainCamDir * iFront * scale);
+            _verticesCoords[newVi++] = v + mainCamDir * iFront * scale;
         for (int iBack = 1; iBack < nbBack + 1; ++iBack)
-            newHelperPoints.push_back(v - mainCamDir * iBack * scale);
-    }
-    _verticesCoords.resize(nbInputVertices + newHelperPoints.size());
-    _verticesAttr.resize(nbInputVertices + newHelperPoints.size());
-    for (std::size_t vi = 0; vi < newHelperPoints.size(); ++vi)
-    {
-        _verticesCoords[nbInputVertices + vi] = newHelperPoints[vi];
-        // GC_vertexInfo& vAttr = _verticesAttr[nbInputVertices + vi];
-        // Keep vertexInfo with default/empty values, so they will be removed at the end as other helper points
-        // vAttr.nrc = 0;
+            _verticesCoords[newVi++] = v - mainCamDir * iBack * scale;
     }
 
-    ALICEVISION_LOG_WARNING("Densify the " << nbInputVertices << " vertices with " << newHelperPoints.size() << " new helper points.");
+    ALICEVISION_LOG_WARNING("Densify the " << nbInputVertices << " vertices with " << nbHelperPoints << " new helper points.");
 }
 
 void PointCloud::addGridHelperPoints(int helperPointsGridSize, const Point3d voxel[8], float minDist)
@@ -770,16 +888,8 @@ void PointCloud::addGridHelperPoints(int helperPointsGridSize, const Point3d vox
     std::mt19937 generator(seed != 0 ? seed : std::random_device{}());
     auto rand = std::bind(std::uniform_real_distribution<float>{-1.0, 1.0}, generator);
 
-    const double minDist2 = minDist * minDist;
-    ALICEVISION_LOG_TRACE("GRID: Prepare kdtree");
-    Tree kdTree(_verticesCoords);
-
-    ALICEVISION_LOG_TRACE("GRID: Allocate vertices");
-    std::vector<Point3d> gridVerticesCoords(std::pow(float(ns + 1), 3.f));
-    std::vector<bool> valid(gridVerticesCoords.size());
-
     ALICEVISION_LOG_TRACE("Create helper points.");
-#pragma omp parallel for
+    std::vector<Point3d> gridVerticesCoords(std::pow(float(ns + 1), 3.f));
     for (int x = 0; x <= ns; ++x)
     {
         for (int y = 0; y <= ns; ++y)
@@ -789,23 +899,33 @@ void PointCloud::addGridHelperPoints(int helperPointsGridSize, const Point3d vox
                 int i = x * (ns + 1) * (ns + 1) + y * (ns + 1) + z;
                 const Point3d pt = voxel[0] + vx * ((double)x / double(ns)) + vy * ((double)y / double(ns)) + vz * ((double)z / double(ns));
                 const Point3d noise(maxNoiseSize.x * rand(), maxNoiseSize.y * rand(), maxNoiseSize.z * rand());
-                const Point3d p = pt + noise;
-                std::size_t vi{};
-                double sq_dist{};
-
-                // if there is no nearest vertex or the nearest vertex is not too close
-                if (!kdTree.locateNearestVertex(p, vi, sq_dist) || (sq_dist > minDist2))
-                {
-                    gridVerticesCoords[i] = p;
-                    valid[i] = true;
-                }
-                else
-                {
-                    valid[i] = false;
-                }
+                gridVerticesCoords[i] = pt + noise;
             }
         }
     }
+
+    // the helper points closer than minDist to a vertex are not added:
+    // the few helper points are hashed, and all the vertices look for their close helper points in parallel
+    ALICEVISION_LOG_TRACE("Remove helper points close to the vertices.");
+    const double minDist2 = minDist * minDist;
+    PointsSpatialHash gridHash(std::max(static_cast<double>(minDist), std::numeric_limits<double>::min()));
+    for (std::size_t i = 0; i < gridVerticesCoords.size(); ++i)
+        gridHash.insert(gridVerticesCoords[i], i);
+
+    std::vector<std::atomic<bool>> valid(gridVerticesCoords.size());
+    for (std::atomic<bool>& v : valid)
+        v.store(true, std::memory_order_relaxed);
+
+#pragma omp parallel for schedule(dynamic, 4096)
+    for (std::ptrdiff_t vi = 0; vi < static_cast<std::ptrdiff_t>(_verticesCoords.size()); ++vi)
+    {
+        const Point3d& v = _verticesCoords[vi];
+        gridHash.forEachCandidate(v, [&](std::size_t i) {
+            if (valid[i].load(std::memory_order_relaxed) && (gridVerticesCoords[i] - v).size2() <= minDist2)
+                valid[i].store(false, std::memory_order_relaxed);
+        });
+    }
+
     ALICEVISION_LOG_TRACE("Insert helper points.");
     _verticesCoords.reserve(_verticesCoords.size() + gridVerticesCoords.size());
     _verticesAttr.reserve(_verticesAttr.size() + gridVerticesCoords.size());
@@ -863,6 +983,10 @@ void PointCloud::addMaskHelperPoints(const Point3d voxel[8], const StaticVector<
             const int syMax = divideRoundUp(height, step);
             const int sxMax = divideRoundUp(width, step);
 
+            // points of each row of blocks, concatenated in order
+            std::vector<std::vector<Point3d>> rowsPoints(syMax);
+
+#pragma omp parallel for schedule(dynamic)
             for (int sy = 0; sy < syMax; ++sy)
             {
                 for (int sx = 0; sx < sxMax; ++sx)
@@ -906,7 +1030,8 @@ void PointCloud::addMaskHelperPoints(const Point3d voxel[8], const StaticVector<
                     {
                         const Point3d& cam = _mp.CArr[c];
                         Point3d maxP = cam + (_mp.iCamArr[c] * Point2d((float)bestX, (float)bestY)).normalize() * 10000000.0;
-                        StaticVector<Point3d>* intersectionsPtr = mvsUtils::lineSegmentHexahedronIntersection(cam, maxP, inflatedVoxel);
+                        const std::unique_ptr<StaticVector<Point3d>> intersectionsPtr(
+                          mvsUtils::lineSegmentHexahedronIntersection(cam, maxP, inflatedVoxel));
 
                         if (intersectionsPtr->size() <= 0)
                             continue;
@@ -922,17 +1047,25 @@ void PointCloud::addMaskHelperPoints(const Point3d voxel[8], const StaticVector<
                                 maxDepth = depth;
                             }
                         }
-                        GC_vertexInfo newv;
-                        newv.nrc = params.maskHelperPointsWeight;
-                        newv.pixSize = 0.0f;
-                        newv.cams.push_back_distinct(c);
-
-                        _verticesAttr.push_back(newv);
-                        _verticesCoords.emplace_back(p);
-                        ++nbAddedPoints;
+                        rowsPoints[sy].push_back(p);
                     }
                 }
             }
+
+            GC_vertexInfo newv;
+            newv.nrc = params.maskHelperPointsWeight;
+            newv.pixSize = 0.0f;
+            newv.cams.push_back_distinct(c);
+
+            for (const std::vector<Point3d>& rowPoints : rowsPoints)
+            {
+                for (const Point3d& p : rowPoints)
+                {
+                    _verticesAttr.push_back(newv);
+                    _verticesCoords.emplace_back(p);
+                    ++nbAddedPoints;
+                }
+            }
         }
     }
     ALICEVISION_LOG_INFO("Added Points: " << nbAddedPoints);
@@ -944,6 +1077,9 @@ void PointCloud::createDensePointCloud(const Point3d hexah[8],
                                              const sfmData::SfMData* sfmData,
                                              const PointCloudFuseParams* depthMapsFuseParams)
 {
+    ALICEVISION_TRACE_ZONE_CAT("PointCloud::createDensePointCloud", "meshing");
+    ALICEVISION_RESOURCE_PHASE("PointCloud::createDensePointCloud");
+
     assert(sfmData != nullptr || depthMapsFuseParams != nullptr);
 
     ALICEVISION_LOG_INFO("Creating dense point cloud.");
@@ -985,29 +1121,48 @@ void PointCloud::createDensePointCloud(const Point3d hexah[8],
             addMaskHelperPoints(hexahExt, cams, *depthMapsFuseParams);
     }
 
+    reorderSpatially();
+
     _verticesCoords.shrink_to_fit();
     _verticesAttr.shrink_to_fit();
 
     ALICEVISION_LOG_WARNING("Final dense point cloud: " << _verticesCoords.size() << " points.");
 }
 
+void PointCloud::reorderSpatially()
+{
+    std::vector<int> order;
+    mesh::computeMortonOrder(_verticesCoords.data(), _verticesCoords.size(), order);
+
+    std::vector<int> newIds;
+    mesh::invertOrder(order, newIds);
+
+    mesh::applyOrder(order, _verticesCoords);
+    mesh::applyOrder(order, _verticesAttr);
+    for (int& vi : _camsVertexes)
+    {
+        if (vi >= 0)
+            vi = newIds[vi];
+    }
+}
+
 void PointCloud::createPtsCams(StaticVector<StaticVector<int>>& out_ptsCams)
 {
-    long t = std::clock();
-    int npts = _verticesCoords.size();
+    const int npts = _verticesCoords.size();
+    const int offset = out_ptsCams.size();
 
-    out_ptsCams.reserve(npts);
+    out_ptsCams.resize(offset + npts);
 
-    for (const GC_vertexInfo& v : _verticesAttr)
+#pragma omp parallel for schedule(dynamic, 4096)
+    for (int vi = 0; vi < npts; ++vi)
     {
-        StaticVector<int> cams;
+        const GC_vertexInfo& v = _verticesAttr[vi];
+        StaticVector<int>& cams = out_ptsCams[offset + vi];
         cams.reserve(v.getNbCameras());
         for (int c = 0; c < v.getNbCameras(); c++)
         {
             cams.push_back(v.cams[c]);
         }
-
-        out_ptsCams.push_back(cams);
     }
 }
 
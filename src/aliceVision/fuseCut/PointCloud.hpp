@@ -23,6 +23,8 @@ struct PointCloudFuseParams
     /// The step used to load depth values from depth maps is computed from maxInputPts. Here we define the minimal value for this step,
     /// so on small datasets we will not spend too much time at the beginning loading all depth values.
     int minStep = 2;
+    /// Number of depth maps loaded in parallel, each loading thread keeps its full depth/sim maps in memory
+    int nbLoadThreads = 3;
     /// After fusion, filter points based on their number of observations
     int minVis = 2;
 
@@ -79,6 +81,8 @@ private:
     void densifyWithHelperPoints(int nbFront, int nbBack, double scale);
     void addGridHelperPoints(int helperPointsGridSize, const Point3d Voxel[8], float minDist);
     void addMaskHelperPoints(const Point3d voxel[8], const StaticVector<int>& cams, const PointCloudFuseParams& params);
+    /// sort the vertices in Morton order, for the locality of the tetrahedralization and graph cut accesses
+    void reorderSpatially();
 
 private:
     std::vector<Point3d> _verticesCoords;
@@ -8,27 +8,48 @@
 
 #include <aliceVision/mvsData/geometry.hpp>
 #include <aliceVision/system/Logger.hpp>
+#include <aliceVision/system/ResourceReport.hpp>
+#include <aliceVision/system/Tracer.hpp>
 
 #include <geogram/delaunay/delaunay.h>
 #include <geogram/delaunay/delaunay_3d.h>
 
+#include <mutex>
+
 namespace aliceVision {
 namespace fuseCut {
 
-Tetrahedralization::Tetrahedralization(const std::vector<Point3d> & vertices)
+Tetrahedralization::Tetrahedralization(const std::vector<Point3d> & vertices, bool parallel)
 : _vertices(vertices)
 {
+    ALICEVISION_TRACE_ZONE_CAT("Tetrahedralization::Tetrahedralization", "meshing");
+    ALICEVISION_RESOURCE_PHASE("Tetrahedralization::Tetrahedralization");
+
     //Use geogram to build tetrahedrons
-    GEO::initialize();
-    GEO::Delaunay_var tetrahedralization = GEO::Delaunay::create(3, "BDEL");
+    // the initialization is global: once for the tetrahedralizations built concurrently (e.g. by lidarMeshing)
+    static std::once_flag geogramInitialized;
+    std::call_once(geogramInitialized, [] { GEO::initialize(); });
+
+    // PDEL is only registered when geogram is built with multithreading support
+    const bool useParallel = parallel && GEO::DelaunayFactory::has_creator("PDEL");
+    if (parallel && !useParallel)
+    {
+        ALICEVISION_LOG_WARNING("Parallel Delaunay is not available, use the sequential construction.");
+    }
+    ALICEVISION_LOG_INFO("Build " << (useParallel ? "parallel" : "sequential") << " Delaunay tetrahedralization of " << _vertices.size()
+                                  << " vertices.");
+
+    GEO::Delaunay_var tetrahedralization = GEO::Delaunay::create(3, useParallel ? "PDEL" : "BDEL");
     tetrahedralization->set_stores_neighbors(true);
     tetrahedralization->set_vertices(_vertices.size(), _vertices.front().m);
 
     //Copy information
     _mesh.clear();
     _neighboringCellsPerVertex.clear();
+    // cells are left uninitialized and first touched by the parallel copy, spreading the memory pages over the NUMA nodes of the threads
     _mesh.resize(tetrahedralization->nb_cells());
-    for (CellIndex ci = 0; ci < tetrahedralization->nb_cells(); ci++)
+#pragma omp parallel for schedule(static)
+    for (int ci = 0; ci < tetrahedralization->nb_cells(); ci++)
     {
         Cell & c = _mesh[ci];
         c.indices[0] = tetrahedralization->cell_vertex(ci, 0);
@@ -52,8 +73,8 @@ void Tetrahedralization::updateVertexToCellsCache(const size_t verticesCount)
 {
     _neighboringCellsPerVertex.clear();
 
-    std::map<VertexIndex, std::set<CellIndex>> neighboringCellsPerVertexTmp;
-
+    // count the cells per vertex first to allocate each list once
+    std::vector<std::size_t> nbCellsPerVertex(verticesCount, 0);
     for (CellIndex ci = 0; ci < nb_cells(); ++ci)
     {
         for (VertexIndex k = 0; k < 4; ++k)
@@ -65,16 +86,30 @@ void Tetrahedralization::updateVertexToCellsCache(const size_t verticesCount)
                 continue;
             }
 
-            neighboringCellsPerVertexTmp[vi].insert(ci);
+            ++nbCellsPerVertex[vi];
         }
     }
-    
+
     _neighboringCellsPerVertex.resize(verticesCount);
-    for (const auto& it : neighboringCellsPerVertexTmp)
+    for (std::size_t vi = 0; vi < verticesCount; ++vi)
     {
-        const std::set<CellIndex>& input = it.second;
-        std::vector<CellIndex>& output = _neighboringCellsPerVertex[it.first];
-        output.assign(input.begin(), input.end());
+        _neighboringCellsPerVertex[vi].reserve(nbCellsPerVertex[vi]);
+    }
+
+    // a vertex appears once per cell, so iterating over cells in order gives sorted unique lists
+    for (CellIndex ci = 0; ci < nb_cells(); ++ci)
+    {
+        for (VertexIndex k = 0; k < 4; ++k)
+        {
+            const VertexIndex vi = cell_vertex(ci, k);
+
+            if (vi == GEO::NO_VERTEX || vi >= verticesCount)
+            {
+                continue;
+            }
+
+            _neighboringCellsPerVertex[vi].push_back(ci);
+        }
     }
 }
 
@@ -8,6 +8,7 @@
 
 #include <aliceVision/mvsData/Point3d.hpp>
 #include <aliceVision/fuseCut/Octree.hpp>
+#include <aliceVision/system/numa.hpp>
 
 #include <geogram/basic/numeric.h>
 #include <geogram/mesh/mesh.h>
@@ -91,7 +92,12 @@ public:
     };
 
 public:
-    Tetrahedralization(const std::vector<Point3d> & vertices);
+    /**
+     * @brief Build the Delaunay tetrahedralization of the given vertices.
+     * @param[in] vertices the input vertices
+     * @param[in] parallel use the multithreaded Delaunay construction if available
+     */
+    Tetrahedralization(const std::vector<Point3d> & vertices, bool parallel = true);
 
     //Find local index for given global index 
     VertexIndex index(CellIndex ci, VertexIndex vi) const
@@ -231,7 +237,7 @@ private:
     void updateVertexToCellsCache(size_t verticesCount);
 
 private:
-    std::vector<Cell> _mesh;
+    system::FirstTouchVector<Cell> _mesh;
     std::vector<std::vector<CellIndex>> _neighboringCellsPerVertex;
     const std::vector<Point3d> & _vertices;
 };
@@ -0,0 +1,89 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/fuseCut/MaxFlow_AdjList.hpp>
+#include <aliceVision/fuseCut/MaxFlow_CSR.hpp>
+
+#include <random>
+#include <vector>
+
+#define BOOST_TEST_MODULE fuseCutMaxFlow
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/tools/floating_point_comparison.hpp>
+
+using namespace aliceVision;
+using namespace aliceVision::fuseCut;
+
+/**
+ * @brief Fill the given maxflow graph with a random grid graph (4-connectivity).
+ */
+template<typename MaxFlowT>
+void fillGridGraph(MaxFlowT& maxFlow, int width, int height, unsigned int seed)
+{
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<float> distribution(0.0f, 10.0f);
+
+    for (int n = 0; n < width * height; ++n)
+    {
+        const float source = distribution(generator);
+        const float sink = distribution(generator);
+        maxFlow.addNode(n, source, sink);
+    }
+
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            const int n = y * width + x;
+            if (x + 1 < width)
+                maxFlow.addEdge(n, n + 1, distribution(generator), distribution(generator));
+            if (y + 1 < height)
+                maxFlow.addEdge(n, n + width, distribution(generator), distribution(generator));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(fuseCut_maxflow_simple)
+{
+    // node 0 is attached to the source, node 1 to the sink, the minimum cut is the edge between them
+    MaxFlow_CSR maxFlow(2);
+    maxFlow.addNode(0, 5.0f, 0.0f);
+    maxFlow.addNode(1, 0.0f, 4.0f);
+    maxFlow.addEdge(0, 1, 3.0f, 0.0f);
+
+    const float flow = maxFlow.compute();
+
+    BOOST_CHECK_CLOSE(flow, 3.0f, 1e-4);
+    BOOST_CHECK(maxFlow.isSource(0));
+    BOOST_CHECK(maxFlow.isTarget(1));
+}
+
+BOOST_AUTO_TEST_CASE(fuseCut_maxflow_csr_vs_adjList)
+{
+    const int width = 40;
+    const int height = 30;
+
+    for (unsigned int seed = 0; seed < 5; ++seed)
+    {
+        MaxFlow_AdjList maxFlowAdjList(width * height);
+        MaxFlow_CSR maxFlowCSR(width * height);
+
+        fillGridGraph(maxFlowAdjList, width, height, seed);
+        fillGridGraph(maxFlowCSR, width, height, seed);
+
+        const float flowAdjList = maxFlowAdjList.compute();
+        const float flowCSR = maxFlowCSR.compute();
+
+        BOOST_CHECK_CLOSE(flowAdjList, flowCSR, 1e-3);
+
+        // with random capacities the minimum cut is unique
+        for (int n = 0; n < width * height; ++n)
+        {
+            BOOST_CHECK_EQUAL(maxFlowAdjList.isTarget(n), maxFlowCSR.isTarget(n));
+        }
+    }
+}
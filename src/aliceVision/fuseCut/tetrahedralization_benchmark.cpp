@@ -0,0 +1,84 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/fuseCut/Tetrahedralization.hpp>
+#include <aliceVision/system/Logger.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+using namespace aliceVision;
+using namespace aliceVision::fuseCut;
+
+namespace {
+
+/**
+ * @brief Random points in the unit cube.
+ */
+std::vector<Point3d> randomPoints(std::size_t nbPoints, unsigned int seed)
+{
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<double> distribution(0.0, 1.0);
+    std::vector<Point3d> points(nbPoints);
+    for (auto& point : points)
+        point = Point3d(distribution(generator), distribution(generator), distribution(generator));
+    return points;
+}
+
+/**
+ * @brief Delaunay tetrahedralization of a point cloud.
+ * @param state range(0): number of vertices
+ */
+void BM_tetrahedralization(benchmark::State& state)
+{
+    system::Logger::get()->setLogLevel(system::EVerboseLevel::Warning);
+
+    const std::vector<Point3d> vertices = randomPoints(static_cast<std::size_t>(state.range(0)), 0);
+
+    for (auto _ : state)
+    {
+        const Tetrahedralization tetrahedralization(vertices);
+        benchmark::DoNotOptimize(tetrahedralization.nb_cells());
+    }
+
+    state.SetItemsProcessed(state.iterations() * vertices.size());
+}
+
+/**
+ * @brief Location of points in the tetrahedralization (walk from a random cell).
+ * @param state range(0): number of vertices
+ */
+void BM_locate(benchmark::State& state)
+{
+    system::Logger::get()->setLogLevel(system::EVerboseLevel::Warning);
+
+    const std::vector<Point3d> vertices = randomPoints(static_cast<std::size_t>(state.range(0)), 0);
+    const Tetrahedralization tetrahedralization(vertices);
+
+    // queries inside the convex hull
+    std::vector<Eigen::Vector3d> queries;
+    for (const Point3d& point : randomPoints(1000, 1))
+        queries.emplace_back(0.1 + 0.8 * point.x, 0.1 + 0.8 * point.y, 0.1 + 0.8 * point.z);
+
+    for (auto _ : state)
+    {
+        for (const Eigen::Vector3d& query : queries)
+        {
+            CellIndex cell;
+            benchmark::DoNotOptimize(tetrahedralization.locate(query, cell));
+            benchmark::DoNotOptimize(cell);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+}  // namespace
+
+BENCHMARK(BM_tetrahedralization)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_locate)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMillisecond);
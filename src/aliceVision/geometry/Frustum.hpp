@@ -108,6 +108,61 @@ struct Frustum
     // Return the supporting frustum points (5 for the infinite, 8 for the truncated)
     const std::vector<Vec3>& frustum_points() const { return points; }
 
+    /// Return true if the Frustum is bounded (a far plane is defined)
+    bool isBounded() const { return z_far > 0; }
+
+    /// Compute the axis aligned bounding box of a bounded Frustum, return false for an unbounded one
+    bool getBoundingBox(Vec3& bbMin, Vec3& bbMax) const
+    {
+        if (!isBounded() || points.empty())
+            return false;
+
+        bbMin = bbMax = points.front();
+        for (const Vec3& point : points)
+        {
+            bbMin = bbMin.cwiseMin(point);
+            bbMax = bbMax.cwiseMax(point);
+        }
+        return true;
+    }
+
+    /// Test if the Frustum is strictly on the negative side of the given half plane:
+    /// all the supporting points are on the negative side and the unbounded edges do not go toward the positive side
+    bool isOnNegativeSide(const Half_plane& plane) const
+    {
+        for (const Vec3& point : points)
+        {
+            if (plane.signedDistance(point) >= 0.0)
+                return false;
+        }
+        if (!isBounded())
+        {
+            for (int i = 1; i < 5; ++i)
+            {
+                if (plane.normal().dot(cones[i] - cones[0]) > 0.0)
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    /// Cheap conservative test before intersect(): return true if a plane of one of the two frustums separates them,
+    /// false means that they may intersect
+    bool isSeparated(const Frustum& f) const
+    {
+        for (const Half_plane& plane : planes)
+        {
+            if (f.isOnNegativeSide(plane))
+                return true;
+        }
+        for (const Half_plane& plane : f.planes)
+        {
+            if (isOnNegativeSide(plane))
+                return true;
+        }
+        return false;
+    }
+
 };  // struct Frustum
 
 }  // namespace geometry
@@ -289,3 +289,58 @@ BOOST_AUTO_TEST_CASE(panorama_without_intersection)
         }
     }
 }
+
+BOOST_AUTO_TEST_CASE(separation_and_bounding_box)
+{
+    // The separating planes test must be consistent with the linear program:
+    // separated frustums never intersect, and a frustum is never separated from itself.
+    const int focal = 1000;
+    const int principal_Point = 500;
+    const int iNviews = 4;
+    const int iNbPoints = 6;
+    const NViewDataSet d = NRealisticCamerasRing(iNviews, iNbPoints, NViewDatasetConfigurator(focal, focal, principal_Point, principal_Point, 5, 0));
+
+    for (const bool flip : {false, true})
+    {
+        const Mat3 flipMatrix = flip ? RotationAroundY(degreeToRadian(180.0)) : Mat3::Identity();
+
+        std::vector<Frustum> vec_frustum;
+        for (int i = 0; i < iNviews; ++i)
+        {
+            double minDepth = std::numeric_limits<double>::max();
+            double maxDepth = std::numeric_limits<double>::min();
+            for (int j = 0; j < iNbPoints; ++j)
+            {
+                const double depth = Depth(d._R[i], d._t[i], d._X.col(j));
+                minDepth = std::min(minDepth, depth);
+                maxDepth = std::max(maxDepth, depth);
+            }
+            // infinite, partially truncated and truncated frustums
+            vec_frustum.push_back(Frustum(principal_Point * 2, principal_Point * 2, d._K[i], d._R[i] * flipMatrix, d._C[i]));
+            vec_frustum.push_back(Frustum(principal_Point * 2, principal_Point * 2, d._K[i], d._R[i] * flipMatrix, d._C[i], minDepth, -1.0));
+            vec_frustum.push_back(Frustum(principal_Point * 2, principal_Point * 2, d._K[i], d._R[i] * flipMatrix, d._C[i], minDepth, maxDepth));
+        }
+
+        for (const Frustum& frustum : vec_frustum)
+        {
+            Vec3 bbMin, bbMax;
+            BOOST_CHECK_EQUAL(frustum.getBoundingBox(bbMin, bbMax), frustum.isTruncated());
+            if (frustum.isTruncated())
+            {
+                for (const Vec3& point : frustum.frustum_points())
+                    BOOST_CHECK((point.array() >= bbMin.array()).all() && (point.array() <= bbMax.array()).all());
+            }
+        }
+
+        for (std::size_t i = 0; i < vec_frustum.size(); ++i)
+        {
+            BOOST_CHECK(!vec_frustum[i].isSeparated(vec_frustum[i]));
+            for (std::size_t j = 0; j < vec_frustum.size(); ++j)
+            {
+                BOOST_CHECK_EQUAL(vec_frustum[i].isSeparated(vec_frustum[j]), vec_frustum[j].isSeparated(vec_frustum[i]));
+                if (vec_frustum[i].isSeparated(vec_frustum[j]))
+                    BOOST_CHECK(!vec_frustum[i].intersect(vec_frustum[j]));
+            }
+        }
+    }
+}
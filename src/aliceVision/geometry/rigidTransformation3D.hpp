@@ -10,6 +10,8 @@
 #include <aliceVision/numeric/numeric.hpp>
 #include <aliceVision/numeric/LMFunctor.hpp>
 #include <aliceVision/robustEstimation/ISolver.hpp>
+
+#include <algorithm>
 #include <random>
 
 namespace aliceVision {
@@ -188,6 +190,17 @@ class RTSSolver : public robustEstimation::ISolver<robustEstimation::MatrixModel
         const Vec3& t = matrixRTS.topRightCorner<3, 1>();
         return (pt2 - (RS * pt1 + t)).norm();
     }
+
+    // compute the residuals of the transformation for all the correspondences
+    inline void errors(const robustEstimation::MatrixModel<Mat4>& RTS,
+                       const Eigen::Ref<const Mat>& x1,
+                       const Eigen::Ref<const Mat>& x2,
+                       double* out_errors) const
+    {
+        const Mat4& matrixRTS = RTS.getMatrix();
+        Eigen::Map<Eigen::Array<double, 1, Eigen::Dynamic>>(out_errors, x1.cols()) =
+          (x2 - ((matrixRTS.topLeftCorner<3, 3>() * x1).colwise() + matrixRTS.topRightCorner<3, 1>())).colwise().norm().array();
+    }
 };
 
 /**
@@ -204,6 +217,17 @@ struct RTSSquaredResidualError
         const Vec3& t = matrixRTS.topRightCorner<3, 1>();
         return (pt2 - (RS * pt1 + t)).squaredNorm();
     }
+
+    // return the squared errors of all the correspondences
+    inline void errors(const robustEstimation::MatrixModel<Mat4>& RTS,
+                       const Eigen::Ref<const Mat>& x1,
+                       const Eigen::Ref<const Mat>& x2,
+                       double* out_errors) const
+    {
+        const Mat4& matrixRTS = RTS.getMatrix();
+        Eigen::Map<Eigen::Array<double, 1, Eigen::Dynamic>>(out_errors, x1.cols()) =
+          (x2 - ((matrixRTS.topLeftCorner<3, 3>() * x1).colwise() + matrixRTS.topRightCorner<3, 1>())).colwise().squaredNorm().array();
+    }
 };
 
 /**
@@ -252,9 +276,24 @@ class ACKernelAdaptor_PointsRegistrationSRT
 
     void errors(const ModelT& model, std::vector<double>& vec_errors) const
     {
-        vec_errors.resize(x1_.cols());
-        for (std::size_t sample = 0; sample < x1_.cols(); ++sample)
-            vec_errors[sample] = error(sample, model);
+        const Mat::Index nbSamples = x1_.cols();
+        vec_errors.resize(nbSamples);
+
+        // the large registrations (e.g. the common landmarks of two scenes) are evaluated by blocks in parallel
+        const Mat::Index blockSize = 8192;
+        const int nbBlocks = static_cast<int>((nbSamples + blockSize - 1) / blockSize);
+
+#pragma omp parallel for if (nbBlocks > 1)
+        for (int b = 0; b < nbBlocks; ++b)
+        {
+            const Mat::Index begin = b * blockSize;
+            const Mat::Index size = std::min(blockSize, nbSamples - begin);
+            double* blockErrors = vec_errors.data() + begin;
+
+            _errorEstimator.errors(model, x1_.middleCols(begin, size), x2_.middleCols(begin, size), blockErrors);
+            for (Mat::Index i = 0; i < size; ++i)
+                blockErrors[i] = Square(blockErrors[i]);
+        }
     }
 
     std::size_t nbSamples() const { return static_cast<std::size_t>(x1_.cols()); }
@@ -5,6 +5,7 @@
 // You can obtain one at https://mozilla.org/MPL/2.0/.
 
 #include "hdrMerge.hpp"
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <limits>
@@ -41,6 +42,29 @@ inline float sigmoidInv(float zeroVal, float endVal, float sigwidth, float sigMi
     return zeroVal + (endVal - zeroVal) * (1.0f / (1.0f + expf(10.0f * ((sigMid - xval) / sigwidth))));
 }
 
+namespace {
+
+/**
+ * @brief Evaluate a curve, same as rgbCurve::operator() without the per call checks.
+ */
+inline float evaluateCurve(const float* curve, std::size_t curveSize, float sample)
+{
+    float infIndex;
+    const float valueScaled = std::max(0.f, std::min(1.f, sample)) * (curveSize - 1.0f);
+    const float fractionalPart = std::modf(valueScaled, &infIndex);
+    const std::size_t index = std::size_t(infIndex);
+
+    /* Do not interpolate 1.0 */
+    if (index == curveSize - 1)
+    {
+        return curve[index];
+    }
+
+    return (1.0f - fractionalPart) * curve[index] + fractionalPart * curve[index + 1];
+}
+
+}  // namespace
+
 void hdrMerge::process(const std::vector<image::Image<image::RGBfColor>>& images,
                        const std::vector<double>& times,
                        const rgbCurve& weight,
@@ -59,6 +83,7 @@ void hdrMerge::process(const std::vector<image::Image<image::RGBfColor>>& images
     // get images width, height
     const std::size_t width = images.front().width();
     const std::size_t height = images.front().height();
+    const int nbImages = images.size();
 
     // resize and reset radiance image to 0.0
     radiance.resize(width, height, true, image::RGBfColor(0.f, 0.f, 0.f));
@@ -83,111 +108,100 @@ void hdrMerge::process(const std::vector<image::Image<image::RGBfColor>>& images
     lowLight.resize(width, height, true, image::RGBfColor(0.f, 0.f, 0.f));
     noMidLight.resize(width, height, true, image::RGBfColor(0.f, 0.f, 0.f));
 
-#pragma omp parallel for
-    for (int y = 0; y < height; ++y)
+    // weight curve of each exposure
+    std::vector<const rgbCurve*> exposureWeights(nbImages, &weight);
+    exposureWeights.front() = &weightShortestExposure;
+    if (nbImages > 1)
     {
-        for (int x = 0; x < width; ++x)
-        {
-            // for each pixels
-            image::RGBfColor& radianceColor = radiance(y, x);
-            image::RGBfColor& highLightColor = highLight(y, x);
-            image::RGBfColor& lowLightColor = lowLight(y, x);
-            image::RGBfColor& noMidLightColor = noMidLight(y, x);
+        exposureWeights.back() = &weightLongestExposure;
+    }
 
-            std::vector<std::vector<double>> vv_coeff;
-            std::vector<std::vector<double>> vv_value;
-            std::vector<std::vector<double>> vv_normalizedValue;
+#pragma omp parallel
+    {
+        // per thread buffers of one row: [exposure][channel][x]
+        std::vector<float> rowResponse(nbImages * 3 * width);
+        std::vector<float> rowCoeff(nbImages * 3 * width);
 
-            // Compute merging range
-            std::vector<int> v_firstIndex;
-            std::vector<int> v_lastIndex;
-            for (std::size_t channel = 0; channel < 3; ++channel)
+#pragma omp for
+        for (int y = 0; y < height; ++y)
+        {
+            // Evaluate the response and the weight curves once per value, channel by channel on contiguous rows
+            for (int e = 0; e < nbImages; ++e)
             {
-                int firstIndex = mergingParams.refImageIndex;
-                while (firstIndex > 0 &&
-                       (response(images[firstIndex](y, x)(channel), channel) > v_minValue[channel] || firstIndex == images.size() - 1))
-                {
-                    firstIndex--;
-                }
-                v_firstIndex.push_back(firstIndex);
+                const float* values = reinterpret_cast<const float*>(&images[e](y, 0));
 
-                int lastIndex = v_firstIndex[channel] + 1;
-                while (lastIndex < images.size() - 1 && response(images[lastIndex](y, x)(channel), channel) < v_maxValue[channel])
+                for (std::size_t channel = 0; channel < 3; ++channel)
                 {
-                    lastIndex++;
+                    const std::vector<float>& responseCurve = response.getCurve(channel);
+                    const std::vector<float>& weightCurve = exposureWeights[e]->getCurve(channel);
+                    float* resp = rowResponse.data() + (e * 3 + channel) * width;
+                    float* coeff = rowCoeff.data() + (e * 3 + channel) * width;
+
+                    for (std::size_t x = 0; x < width; ++x)
+                    {
+                        const float value = values[x * 3 + channel];
+                        resp[x] = evaluateCurve(responseCurve.data(), responseCurve.size(), value);
+                        coeff[x] = std::max(0.001f, evaluateCurve(weightCurve.data(), weightCurve.size(), value));
+                    }
                 }
-                v_lastIndex.push_back(lastIndex);
             }
 
-            // Compute merging coeffs and values to be merged
-            for (std::size_t channel = 0; channel < 3; ++channel)
+            for (int x = 0; x < width; ++x)
             {
-                std::vector<double> v_coeff;
-                std::vector<double> v_normalizedValue;
-                std::vector<double> v_value;
+                // for each pixels
+                image::RGBfColor& radianceColor = radiance(y, x);
+                image::RGBfColor& highLightColor = highLight(y, x);
+                image::RGBfColor& lowLightColor = lowLight(y, x);
+                image::RGBfColor& noMidLightColor = noMidLight(y, x);
 
-                for (std::size_t e = 0; e < images.size(); ++e)
+                for (std::size_t channel = 0; channel < 3; ++channel)
                 {
-                    const double value = images[e](y, x)(channel);
-                    const double resp = response(value, channel);
-                    const double normalizedValue = resp / times[e];
-                    double coeff = std::max(0.001f,
-                                            e == 0 ? weightShortestExposure(value, channel)
-                                                   : (e == images.size() - 1 ? weightLongestExposure(value, channel) : weight(value, channel)));
-
-                    v_value.push_back(value);
-                    v_normalizedValue.push_back(normalizedValue);
-                    v_coeff.push_back(coeff);
-                }
+                    const auto respAt = [&](int e) { return rowResponse[(e * 3 + channel) * width + x]; };
+                    const auto coeffAt = [&](int e) { return rowCoeff[(e * 3 + channel) * width + x]; };
 
-                vv_coeff.push_back(v_coeff);
-                vv_normalizedValue.push_back(v_normalizedValue);
-                vv_value.push_back(v_value);
-            }
+                    // Compute merging range
+                    int firstIndex = mergingParams.refImageIndex;
+                    while (firstIndex > 0 && (respAt(firstIndex) > v_minValue[channel] || firstIndex == nbImages - 1))
+                    {
+                        firstIndex--;
+                    }
 
-            // Compute light masks if required (monitoring and debug purposes)
-            if (mergingParams.computeLightMasks)
-            {
-                for (std::size_t channel = 0; channel < 3; ++channel)
-                {
-                    int idxMaxValue = 0;
-                    int idxMinValue = 0;
-                    double maxValue = 0.0;
-                    double minValue = 10000.0;
-                    bool jump = true;
-                    for (std::size_t e = 0; e < images.size(); ++e)
+                    int lastIndex = firstIndex + 1;
+                    while (lastIndex < nbImages - 1 && respAt(lastIndex) < v_maxValue[channel])
                     {
-                        if (vv_value[channel][e] > maxValue)
-                        {
-                            maxValue = vv_value[channel][e];
-                            idxMaxValue = e;
-                        }
-                        if (vv_value[channel][e] < minValue)
+                        lastIndex++;
+                    }
+
+                    // Compute light masks if required (monitoring and debug purposes)
+                    if (mergingParams.computeLightMasks)
+                    {
+                        double maxValue = 0.0;
+                        double minValue = 10000.0;
+                        bool jump = true;
+                        for (int e = 0; e < nbImages; ++e)
                         {
-                            minValue = vv_value[channel][e];
-                            idxMinValue = e;
+                            const double value = images[e](y, x)(channel);
+                            maxValue = std::max(maxValue, value);
+                            minValue = std::min(minValue, value);
+                            jump = jump && ((value < mergingParams.minSignificantValue && e < nbImages - 1) ||
+                                            (value > mergingParams.maxSignificantValue && e > 0));
                         }
-                        jump = jump && ((vv_value[channel][e] < mergingParams.minSignificantValue && e < images.size() - 1) ||
-                                        (vv_value[channel][e] > mergingParams.maxSignificantValue && e > 0));
+                        highLightColor(channel) = minValue > mergingParams.maxSignificantValue ? 1.0 : 0.0;
+                        lowLightColor(channel) = maxValue < mergingParams.minSignificantValue ? 1.0 : 0.0;
+                        noMidLightColor(channel) = jump ? 1.0 : 0.0;
                     }
-                    highLightColor(channel) = minValue > mergingParams.maxSignificantValue ? 1.0 : 0.0;
-                    lowLightColor(channel) = maxValue < mergingParams.minSignificantValue ? 1.0 : 0.0;
-                    noMidLightColor(channel) = jump ? 1.0 : 0.0;
-                }
-            }
 
-            // Compute the final result and adjust the exposure to the reference one.
-            for (std::size_t channel = 0; channel < 3; ++channel)
-            {
-                double v = 0.0;
-                double sumCoeff = 0.0;
-                for (std::size_t i = v_firstIndex[channel]; i <= v_lastIndex[channel]; ++i)
-                {
-                    v += vv_coeff[channel][i] * vv_normalizedValue[channel][i];
-                    sumCoeff += vv_coeff[channel][i];
+                    // Compute the final result and adjust the exposure to the reference one.
+                    double v = 0.0;
+                    double sumCoeff = 0.0;
+                    for (int i = firstIndex; i <= lastIndex; ++i)
+                    {
+                        v += coeffAt(i) * (respAt(i) / times[i]);
+                        sumCoeff += coeffAt(i);
+                    }
+                    radianceColor(channel) = mergingParams.targetCameraExposure *
+                                             (sumCoeff != 0.0 ? v / sumCoeff : respAt(mergingParams.refImageIndex) / times[mergingParams.refImageIndex]);
                 }
-                radianceColor(channel) =
-                  mergingParams.targetCameraExposure * (sumCoeff != 0.0 ? v / sumCoeff : vv_normalizedValue[channel][mergingParams.refImageIndex]);
             }
         }
     }
@@ -210,24 +224,25 @@ void hdrMerge::postProcessHighlight(const std::vector<image::Image<image::RGBfCo
     if (highlightCorrectionFactor == 0.0f)
         return;
 
-    const image::Image<image::RGBfColor>& inputImage = images.front();
-    // Target Camera Exposure = 1 for EV-0 (iso=100, shutter=1, fnumber=1) => 2.5 lux
-    float highlightTarget = highlightTargetLux * targetCameraExposure * 2.5;
+    image::Image<float> isPixelClamped;
+    computeClampedPixels(images.front(), isPixelClamped);
 
+    postProcessHighlight(isPixelClamped, radiance, targetCameraExposure, highlightCorrectionFactor, highlightTargetLux);
+}
+
+void hdrMerge::computeClampedPixels(const image::Image<image::RGBfColor>& inputImage, image::Image<float>& isPixelClamped)
+{
     // get images width, height
     const std::size_t width = inputImage.width();
-
     const std::size_t height = inputImage.height();
-    image::Image<float> isPixelClamped(width, height);
+
+    isPixelClamped.resize(width, height);
 
 #pragma omp parallel for
     for (int y = 0; y < height; ++y)
     {
         for (int x = 0; x < width; ++x)
         {
-            // for each pixels
-            image::RGBfColor& radianceColor = radiance(y, x);
-
             float& isClamped = isPixelClamped(y, x);
             isClamped = 0.0f;
 
@@ -245,6 +260,23 @@ void hdrMerge::postProcessHighlight(const std::vector<image::Image<image::RGBfCo
             isPixelClamped(y, x) /= 3.0;
         }
     }
+}
+
+void hdrMerge::postProcessHighlight(const image::Image<float>& isPixelClamped,
+                                    image::Image<image::RGBfColor>& radiance,
+                                    float targetCameraExposure,
+                                    float highlightCorrectionFactor,
+                                    float highlightTargetLux)
+{
+    if (highlightCorrectionFactor == 0.0f)
+        return;
+
+    // Target Camera Exposure = 1 for EV-0 (iso=100, shutter=1, fnumber=1) => 2.5 lux
+    float highlightTarget = highlightTargetLux * targetCameraExposure * 2.5;
+
+    // get images width, height
+    const std::size_t width = isPixelClamped.width();
+    const std::size_t height = isPixelClamped.height();
 
     image::Image<float> isPixelClamped_g(width, height);
     image::imageGaussianFilter(isPixelClamped, 1.0f, isPixelClamped_g, 3, 3);
@@ -25,7 +25,8 @@ class hdrMerge
 {
   public:
     /**
-     * @brief
+     * @brief Merge the brackets. Each pixel only depends on the same pixel of the brackets,
+     *        so the images can also be bands of rows of the brackets.
      * @param images
      * @param radiance
      * @param times
@@ -50,6 +51,25 @@ class hdrMerge
                               float clampedValueCorrection,
                               float targetCameraExposure,
                               float highlightMaxLumimance);
+
+    /**
+     * @brief Compute how much the pixels of the shortest exposure are clamped, used by the highlight post-processing.
+     * @param[in] inputImage The shortest exposure (or a band of its rows)
+     * @param[out] isPixelClamped The clamping status in [0, 1] of each pixel
+     */
+    static void computeClampedPixels(const image::Image<image::RGBfColor>& inputImage, image::Image<float>& isPixelClamped);
+
+    /**
+     * @brief Highlight post-processing from the clamping status of the pixels of the whole image,
+     *        which allows to merge the brackets band by band.
+     * @param[in] isPixelClamped The clamping status of the pixels of the shortest exposure (see computeClampedPixels)
+     * @param[in,out] radiance The merged image
+     */
+    void postProcessHighlight(const image::Image<float>& isPixelClamped,
+                              image::Image<image::RGBfColor>& radiance,
+                              float targetCameraExposure,
+                              float highlightCorrectionFactor,
+                              float highlightTargetLux);
 };
 
 }  // namespace hdr
@@ -0,0 +1,136 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#define BOOST_TEST_MODULE hdr_merge
+
+#include "hdrMerge.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <random>
+
+using namespace aliceVision;
+
+namespace {
+
+void buildBrackets(std::vector<image::Image<image::RGBfColor>>& images, std::vector<double>& times, int width, int height)
+{
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<float> distribution(0.0f, 2.0f);
+
+    image::Image<image::RGBfColor> radiance(width, height);
+    for (int y = 0; y < height; ++y)
+        for (int x = 0; x < width; ++x)
+            radiance(y, x) = image::RGBfColor(distribution(generator), distribution(generator), distribution(generator));
+
+    times = {0.25, 1.0, 4.0};
+    for (const double time : times)
+    {
+        image::Image<image::RGBfColor> image(width, height);
+        for (int y = 0; y < height; ++y)
+            for (int x = 0; x < width; ++x)
+                for (int c = 0; c < 3; ++c)
+                    image(y, x)(c) = std::min(1.0f, float(radiance(y, x)(c) * time));
+        images.push_back(image);
+    }
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(hdr_mergeBands)
+{
+    // merging the brackets band by band gives the same result as merging the whole images
+    const int width = 37;
+    const int height = 29;
+    const int bandHeight = 8;
+
+    std::vector<image::Image<image::RGBfColor>> images;
+    std::vector<double> times;
+    buildBrackets(images, times, width, height);
+
+    hdr::rgbCurve weight(1024);
+    weight.setFunction(hdr::EFunctionType::GAUSSIAN);
+    hdr::rgbCurve response(1024);
+    response.setLinear();
+
+    hdr::MergingParams mergingParams;
+    mergingParams.targetCameraExposure = 1.0f;
+    mergingParams.refImageIndex = 1;
+    mergingParams.computeLightMasks = true;
+
+    hdr::hdrMerge merge;
+    image::Image<image::RGBfColor> radiance, lowLight, highLight, noMidLight;
+    merge.process(images, times, weight, response, radiance, lowLight, highLight, noMidLight, mergingParams);
+
+    BOOST_CHECK_EQUAL(radiance.width(), width);
+    BOOST_CHECK_EQUAL(radiance.height(), height);
+
+    for (int ybegin = 0; ybegin < height; ybegin += bandHeight)
+    {
+        const int rows = std::min(bandHeight, height - ybegin);
+
+        std::vector<image::Image<image::RGBfColor>> bands;
+        for (const auto& image : images)
+        {
+            image::Image<image::RGBfColor> band(width, rows);
+            band.getMat() = image.getMat().block(ybegin, 0, rows, width);
+            bands.push_back(band);
+        }
+
+        image::Image<image::RGBfColor> bandRadiance, bandLowLight, bandHighLight, bandNoMidLight;
+        merge.process(bands, times, weight, response, bandRadiance, bandLowLight, bandHighLight, bandNoMidLight, mergingParams);
+
+        for (int y = 0; y < rows; ++y)
+        {
+            for (int x = 0; x < width; ++x)
+            {
+                for (int c = 0; c < 3; ++c)
+                {
+                    BOOST_CHECK_EQUAL(bandRadiance(y, x)(c), radiance(ybegin + y, x)(c));
+                    BOOST_CHECK_EQUAL(bandLowLight(y, x)(c), lowLight(ybegin + y, x)(c));
+                    BOOST_CHECK_EQUAL(bandHighLight(y, x)(c), highLight(ybegin + y, x)(c));
+                    BOOST_CHECK_EQUAL(bandNoMidLight(y, x)(c), noMidLight(ybegin + y, x)(c));
+                }
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(hdr_mergeLinear)
+{
+    // with a linear response, the unclamped pixels of the reference exposure are recovered
+    std::vector<image::Image<image::RGBfColor>> images;
+    std::vector<double> times;
+    buildBrackets(images, times, 16, 16);
+
+    hdr::rgbCurve weight(1024);
+    weight.setFunction(hdr::EFunctionType::GAUSSIAN);
+    hdr::rgbCurve response(1024);
+    response.setLinear();
+
+    hdr::MergingParams mergingParams;
+    mergingParams.targetCameraExposure = 1.0f;
+    mergingParams.refImageIndex = 1;
+
+    hdr::hdrMerge merge;
+    image::Image<image::RGBfColor> radiance, lowLight, highLight, noMidLight;
+    merge.process(images, times, weight, response, radiance, lowLight, highLight, noMidLight, mergingParams);
+
+    for (int y = 0; y < radiance.height(); ++y)
+    {
+        for (int x = 0; x < radiance.width(); ++x)
+        {
+            for (int c = 0; c < 3; ++c)
+            {
+                // unclamped in all the merged exposures
+                if (images.back()(y, x)(c) < 0.9f && images.front()(y, x)(c) > 0.1f)
+                {
+                    BOOST_CHECK_CLOSE(radiance(y, x)(c), images[1](y, x)(c), 1.0);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,105 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#define BOOST_TEST_MODULE hdr_sampling
+
+#include "sampling.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace aliceVision;
+
+namespace {
+
+/**
+ * @brief Build samples with a single bracket, all sharing the same gray value.
+ */
+std::vector<hdr::ImageSample> buildSamples(std::size_t count, float value)
+{
+    std::vector<hdr::ImageSample> samples(count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        hdr::PixelDescription description;
+        description.exposure = 1.0f;
+        description.mean = image::Rgb<float>(value, value, value);
+        description.variance = image::Rgb<float>(0.0f, 0.0f, 0.0f);
+
+        samples[i].x = i;
+        samples[i].descriptions.push_back(description);
+    }
+
+    return samples;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(hdr_samplingReservoirBound)
+{
+    // the reservoirs never keep more than the maximum number of samples, whatever the number of analyzed groups
+    const std::size_t maxSamples = 50;
+    hdr::Sampling sampling(maxSamples);
+
+    std::vector<hdr::ImageSample> samples = buildSamples(200, 0.5f);
+    for (int group = 0; group < 20; ++group)
+    {
+        sampling.analyzeSource(samples, 1024, group);
+    }
+
+    // one descriptor per channel
+    BOOST_CHECK_EQUAL(sampling.getPositions().size(), 3);
+    for (const auto& item : sampling.getPositions())
+    {
+        BOOST_CHECK_EQUAL(item.second.coordinates.size(), maxSamples);
+        BOOST_CHECK_EQUAL(item.second.countSeen, 200 * 20);
+    }
+    BOOST_CHECK_EQUAL(sampling.getCountSamples(), 3 * maxSamples);
+
+    sampling.filter(60);
+    BOOST_CHECK_LE(sampling.getCountSamples(), 60);
+}
+
+BOOST_AUTO_TEST_CASE(hdr_samplingMerge)
+{
+    // merging the samplings of two chunks keeps the groups in proportion of their samples count
+    const std::size_t maxSamples = 400;
+    std::vector<hdr::ImageSample> smallGroup = buildSamples(1000, 0.5f);
+    std::vector<hdr::ImageSample> largeGroup = buildSamples(3000, 0.5f);
+
+    hdr::Sampling first(maxSamples);
+    first.analyzeSource(smallGroup, 1024, 0);
+
+    hdr::Sampling second(maxSamples);
+    second.analyzeSource(largeGroup, 1024, 1);
+
+    first.merge(second);
+    BOOST_CHECK_EQUAL(first.getPositions().size(), 3);
+
+    for (const auto& item : first.getPositions())
+    {
+        BOOST_CHECK_EQUAL(item.second.coordinates.size(), maxSamples);
+        BOOST_CHECK_EQUAL(item.second.countSeen, 4000);
+
+        std::size_t countFirst = 0;
+        for (const auto& coordinates : item.second.coordinates)
+        {
+            BOOST_CHECK(coordinates.imageIndex == 0 || coordinates.imageIndex == 1);
+            if (coordinates.imageIndex == 0)
+            {
+                countFirst++;
+            }
+        }
+
+        // a quarter of the samples are expected from the first group
+        BOOST_CHECK_GT(countFirst, maxSamples / 8);
+        BOOST_CHECK_LT(countFirst, maxSamples * 3 / 8);
+    }
+
+    // the samples kept for a group are valid indices of this group, each channel has its own reservoir
+    std::vector<hdr::ImageSample> extracted;
+    first.extractUsefulSamples(extracted, largeGroup, 1);
+    BOOST_CHECK(!extracted.empty());
+    BOOST_CHECK_LE(extracted.size(), 3 * maxSamples);
+}
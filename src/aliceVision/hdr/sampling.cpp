@@ -10,6 +10,8 @@
 #include <aliceVision/system/Logger.hpp>
 
 #include <OpenImageIO/imagebufalgo.h>
+
+#include <algorithm>
 #include <random>
 
 namespace aliceVision {
@@ -506,6 +508,11 @@ bool Sampling::extractSamplesFromImages(std::vector<ImageSample>& out_samples,
     return true;
 }
 
+Sampling::Sampling(std::size_t maxSamplesPerDescriptor)
+  : _maxSamplesPerDescriptor(std::max<std::size_t>(maxSamplesPerDescriptor, 1)),
+    _generator(std::random_device()())
+{}
+
 void Sampling::analyzeSource(std::vector<ImageSample>& samples, int channelQuantization, int imageIndex)
 {
     for (std::size_t sampleIndex = 0; sampleIndex < samples.size(); ++sampleIndex)
@@ -530,24 +537,76 @@ void Sampling::analyzeSource(std::vector<ImageSample>& samples, int channelQuant
                 c.imageIndex = imageIndex;
                 c.sampleIndex = sampleIndex;
 
-                _positions[udesc].push_back(c);
+                // Reservoir sampling: the n-th sample replaces a kept one with a probability of size/n
+                Reservoir& reservoir = _positions[udesc];
+                reservoir.countSeen++;
+                if (reservoir.coordinates.size() < _maxSamplesPerDescriptor)
+                {
+                    reservoir.coordinates.push_back(c);
+                }
+                else
+                {
+                    std::uniform_int_distribution<std::size_t> distribution(0, reservoir.countSeen - 1);
+                    const std::size_t pos = distribution(_generator);
+                    if (pos < _maxSamplesPerDescriptor)
+                    {
+                        reservoir.coordinates[pos] = c;
+                    }
+                }
             }
         }
     }
+}
 
-    std::random_device randomDevice;
-    std::mt19937 rng(randomDevice());
-
-    for (auto& item : _positions)
+void Sampling::merge(const Sampling& other)
+{
+    for (const auto& item : other._positions)
     {
-        // TODO: expose as parameters
-        const std::size_t maxSamples = 500;
-        if (item.second.size() > maxSamples)
+        auto found = _positions.find(item.first);
+        if (found == _positions.end())
         {
-            // Shuffle and ignore the exceeding samples
-            std::shuffle(item.second.begin(), item.second.end(), rng);
-            item.second.resize(500);
+            _positions[item.first] = item.second;
+            continue;
         }
+
+        Reservoir& current = found->second;
+        const Reservoir& added = item.second;
+
+        std::vector<Coordinates> currentCoordinates = current.coordinates;
+        std::vector<Coordinates> addedCoordinates = added.coordinates;
+        std::shuffle(currentCoordinates.begin(), currentCoordinates.end(), _generator);
+        std::shuffle(addedCoordinates.begin(), addedCoordinates.end(), _generator);
+
+        // Draw without replacement from the two populations, in proportion of their remaining sizes.
+        // A reservoir holds min(size, countSeen) samples, so it cannot run out before its population does.
+        std::size_t remainingCurrent = current.countSeen;
+        std::size_t remainingAdded = added.countSeen;
+        const std::size_t count = std::min(_maxSamplesPerDescriptor, currentCoordinates.size() + addedCoordinates.size());
+
+        Reservoir merged;
+        merged.countSeen = current.countSeen + added.countSeen;
+        merged.coordinates.reserve(count);
+
+        std::size_t posCurrent = 0;
+        std::size_t posAdded = 0;
+        while (merged.coordinates.size() < count)
+        {
+            std::uniform_int_distribution<std::size_t> distribution(0, remainingCurrent + remainingAdded - 1);
+            const bool fromCurrent = distribution(_generator) < remainingCurrent;
+
+            if ((fromCurrent && posCurrent < currentCoordinates.size()) || posAdded >= addedCoordinates.size())
+            {
+                merged.coordinates.push_back(currentCoordinates[posCurrent++]);
+                remainingCurrent--;
+            }
+            else
+            {
+                merged.coordinates.push_back(addedCoordinates[posAdded++]);
+                remainingAdded--;
+            }
+        }
+
+        current = std::move(merged);
     }
 }
 
@@ -557,9 +616,6 @@ void Sampling::filter(size_t maxTotalPoints)
     size_t limitPerGroup = 510;
     size_t total_points = maxTotalPoints + 1;
 
-    std::random_device randomDevice;
-    std::mt19937 rng(randomDevice());
-
     while (total_points > maxTotalPoints)
     {
         limitPerGroup = limitPerGroup - 10;
@@ -567,25 +623,37 @@ void Sampling::filter(size_t maxTotalPoints)
         total_points = 0;
         for (auto& item : _positions)
         {
-            if (item.second.size() > limitPerGroup)
+            std::vector<Coordinates>& coordinates = item.second.coordinates;
+            if (coordinates.size() > limitPerGroup)
             {
                 // Shuffle and ignore the exceeding samples
-                std::shuffle(item.second.begin(), item.second.end(), rng);
-                item.second.resize(limitPerGroup);
+                std::shuffle(coordinates.begin(), coordinates.end(), _generator);
+                coordinates.resize(limitPerGroup);
             }
 
-            total_points += item.second.size();
+            total_points += coordinates.size();
         }
     }
 }
 
+std::size_t Sampling::getCountSamples() const
+{
+    std::size_t count = 0;
+    for (const auto& item : _positions)
+    {
+        count += item.second.coordinates.size();
+    }
+
+    return count;
+}
+
 void Sampling::extractUsefulSamples(std::vector<ImageSample>& out_samples, const std::vector<ImageSample>& samples, int imageIndex) const
 {
     std::set<unsigned int> uniqueIndices;
 
     for (auto& item : _positions)
     {
-        for (auto& pos : item.second)
+        for (auto& pos : item.second.coordinates)
         {
             if (pos.imageIndex == imageIndex)
             {
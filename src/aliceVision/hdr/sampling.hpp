@@ -8,6 +8,8 @@
 
 #include <aliceVision/image/all.hpp>
 #include <aliceVision/numeric/numeric.hpp>
+#include <map>
+#include <random>
 #include <set>
 
 namespace aliceVision {
@@ -59,13 +61,52 @@ class Sampling
         size_t maxCountSample = 200;
     };
 
-    using MapSampleRefList = std::map<UniqueDescriptor, std::vector<Coordinates>>;
+    /**
+     * @brief Uniform random subset of the samples seen for a descriptor, with a bounded size.
+     */
+    struct Reservoir
+    {
+        std::vector<Coordinates> coordinates;
+        /// number of samples offered to the reservoir
+        std::size_t countSeen = 0;
+    };
+
+    using MapSampleRefList = std::map<UniqueDescriptor, Reservoir>;
 
   public:
+    /**
+     * @brief Constructor
+     * @param[in] maxSamplesPerDescriptor the maximum number of samples kept for each descriptor
+     */
+    explicit Sampling(std::size_t maxSamplesPerDescriptor = 500);
+
+    /**
+     * @brief Add the samples of a group to the reservoirs.
+     * The memory is bounded by the number of descriptors, whatever the number of analyzed groups.
+     * @param[in] samples the samples of the group
+     * @param[in] channelQuantization the quantization of the samples values
+     * @param[in] imageIndex the index of the group, used by extractUsefulSamples
+     */
     void analyzeSource(std::vector<ImageSample>& samples, int channelQuantization, int imageIndex);
+
+    /**
+     * @brief Merge the reservoirs of a sampling which analyzed other groups.
+     * The result is a uniform subset of the union of the analyzed samples,
+     * so groups can be analyzed in parallel or in chunks and merged afterward.
+     * @param[in] other a sampling with the same maximum number of samples per descriptor
+     */
+    void merge(const Sampling& other);
+
     void filter(size_t maxTotalPoints);
     void extractUsefulSamples(std::vector<ImageSample>& out_samples, const std::vector<ImageSample>& samples, int imageIndex) const;
 
+    /**
+     * @brief Get the total number of samples kept in the reservoirs.
+     */
+    std::size_t getCountSamples() const;
+
+    const MapSampleRefList& getPositions() const { return _positions; }
+
     static bool extractSamplesFromImages(std::vector<ImageSample>& out_samples,
                                          const std::vector<std::string>& imagePaths,
                                          const std::vector<IndexT>& viewIds,
@@ -79,6 +120,8 @@ class Sampling
 
   private:
     MapSampleRefList _positions;
+    std::size_t _maxSamplesPerDescriptor;
+    std::mt19937 _generator;
 };
 
 }  // namespace hdr
@@ -0,0 +1,124 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "AsyncImageWriter.hpp"
+
+#include <aliceVision/system/Logger.hpp>
+
+#include <algorithm>
+
+namespace aliceVision {
+namespace image {
+
+AsyncImageWriter::AsyncImageWriter(std::size_t nbThreads, std::size_t maxQueuedBytes)
+  : _maxQueuedBytes(maxQueuedBytes)
+{
+    nbThreads = std::max(nbThreads, std::size_t(1));
+    _threads.reserve(nbThreads);
+    for (std::size_t i = 0; i < nbThreads; ++i)
+    {
+        _threads.emplace_back(&AsyncImageWriter::run, this);
+    }
+}
+
+AsyncImageWriter::~AsyncImageWriter()
+{
+    // no throw in destructor
+    try
+    {
+        flush();
+    }
+    catch (const std::exception& e)
+    {
+        ALICEVISION_LOG_ERROR("Failed to write an image: " << e.what());
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopped = true;
+    }
+    _queueCondition.notify_all();
+    for (std::thread& thread : _threads)
+    {
+        thread.join();
+    }
+}
+
+void AsyncImageWriter::enqueue(std::function<void()> write, std::size_t nbBytes)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    // an image larger than the bound is queued alone
+    _spaceCondition.wait(lock, [&] { return _error || _queuedBytes == 0 || _queuedBytes + nbBytes <= _maxQueuedBytes; });
+    if (_error)
+        std::rethrow_exception(_error);
+
+    _queuedBytes += nbBytes;
+    ++_nbPending;
+    _queue.push_back({std::move(write), nbBytes});
+    _queueCondition.notify_one();
+}
+
+void AsyncImageWriter::flush()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    _spaceCondition.wait(lock, [&] { return _nbPending == 0; });
+    if (_error)
+    {
+        std::exception_ptr error = _error;
+        _error = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+void AsyncImageWriter::run()
+{
+    while (true)
+    {
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _queueCondition.wait(lock, [&] { return !_queue.empty() || _stopped; });
+            if (_queue.empty())
+                return;
+            task = std::move(_queue.front());
+            _queue.pop_front();
+        }
+
+        std::exception_ptr error;
+        try
+        {
+            task.write();
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+        // release the image before the next one is queued
+        task.write = nullptr;
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _queuedBytes -= task.nbBytes;
+            --_nbPending;
+            if (error)
+            {
+                if (!_error)
+                    _error = error;
+                // the queued images are dropped
+                for (const Task& dropped : _queue)
+                {
+                    _queuedBytes -= dropped.nbBytes;
+                    --_nbPending;
+                }
+                _queue.clear();
+            }
+        }
+        _spaceCondition.notify_all();
+    }
+}
+
+}  // namespace image
+}  // namespace aliceVision
@@ -0,0 +1,102 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/image/Image.hpp>
+#include <aliceVision/image/io.hpp>
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace aliceVision {
+namespace image {
+
+/**
+ * @brief Write images with writeImage in background threads, so that the computations go on while the files are encoded.
+ *
+ * The images are moved into the queue and written by a pool of writer threads (one file per thread at a time),
+ * in the order of the calls to write(). The memory of the images waiting to be written is bounded:
+ * write() waits while the writer threads are late.
+ * flush() waits for all the queued images and rethrows the first error of the writer threads.
+ */
+class AsyncImageWriter
+{
+  public:
+    /**
+     * @param[in] nbThreads The number of writer threads
+     * @param[in] maxQueuedBytes The maximum memory of the images queued or being written (an image larger than this is queued alone)
+     */
+    explicit AsyncImageWriter(std::size_t nbThreads = 2, std::size_t maxQueuedBytes = std::size_t(1) << 30);
+
+    /**
+     * @brief Wait for the queued images, without throwing.
+     */
+    ~AsyncImageWriter();
+
+    // no copy
+    AsyncImageWriter(const AsyncImageWriter&) = delete;
+    AsyncImageWriter& operator=(const AsyncImageWriter&) = delete;
+
+    /**
+     * @brief Queue an image to be written. Thread safe.
+     * @param[in] path The image path
+     * @param[in] image The image, moved in the queue
+     * @param[in] options The write options
+     * @param[in] metadata The image metadata
+     */
+    template<typename T>
+    void write(const std::string& path, Image<T> image, const ImageWriteOptions& options, const oiio::ParamValueList& metadata = oiio::ParamValueList())
+    {
+        const std::size_t nbBytes = image.memorySize();
+        auto queuedImage = std::make_shared<Image<T>>(std::move(image));
+        enqueue([path, queuedImage, options, metadata]() { writeImage(path, *queuedImage, options, metadata); }, nbBytes);
+    }
+
+    /**
+     * @brief Wait until all the queued images are written.
+     *        Rethrow the first error of the writer threads, the images queued after the error are not written.
+     */
+    void flush();
+
+  private:
+    struct Task
+    {
+        std::function<void()> write;
+        std::size_t nbBytes;
+    };
+
+    void enqueue(std::function<void()> write, std::size_t nbBytes);
+
+    /**
+     * @brief Writer thread: write the queued images until the writer is destroyed.
+     */
+    void run();
+
+    const std::size_t _maxQueuedBytes;
+
+    std::mutex _mutex;
+    std::condition_variable _queueCondition;
+    std::condition_variable _spaceCondition;
+    std::deque<Task> _queue;
+    std::size_t _queuedBytes = 0;   //< images queued or being written
+    std::size_t _nbPending = 0;     //< images queued or being written
+    bool _stopped = false;
+    std::exception_ptr _error;
+
+    std::vector<std::thread> _threads;
+};
+
+}  // namespace image
+}  // namespace aliceVision
@@ -0,0 +1,116 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+%module (module="pyalicevision") image
+
+%include <aliceVision/global.i>
+%include <aliceVision/NumpyArray.i>
+
+%{
+#include <aliceVision/image/Image.hpp>
+#include <aliceVision/image/pixelTypes.hpp>
+
+namespace aliceVision {
+namespace image {
+
+/// numpy type of the channels of a pixel type
+template<typename T>
+struct NumpyPixel;
+
+template<>
+struct NumpyPixel<unsigned char>
+{
+    static constexpr int typenum = NPY_UINT8;
+};
+
+template<>
+struct NumpyPixel<float>
+{
+    static constexpr int typenum = NPY_FLOAT32;
+};
+
+template<>
+struct NumpyPixel<RGBColor>
+{
+    static constexpr int typenum = NPY_UINT8;
+};
+
+template<>
+struct NumpyPixel<RGBfColor>
+{
+    static constexpr int typenum = NPY_FLOAT32;
+};
+
+template<>
+struct NumpyPixel<RGBAColor>
+{
+    static constexpr int typenum = NPY_UINT8;
+};
+
+template<>
+struct NumpyPixel<RGBAfColor>
+{
+    static constexpr int typenum = NPY_FLOAT32;
+};
+
+/**
+ * @brief Get a numpy view (height x width, or height x width x channels) over the pixels of an image, without copy.
+ */
+template<typename T>
+PyObject* getNumpyView(Image<T>& image, PyObject* owner)
+{
+    const int nbChannels = NbChannels<T>::size;
+    npy_intp dims[3] = {image.height(), image.width(), nbChannels};
+    return numpy::createView(owner, (nbChannels == 1) ? 2 : 3, dims, NumpyPixel<T>::typenum, static_cast<void*>(image.data()));
+}
+
+}  // namespace image
+}  // namespace aliceVision
+%}
+
+// Image derives from an Eigen matrix: only its own interface is exposed
+namespace aliceVision {
+namespace image {
+
+template<typename T>
+class Image
+{
+  public:
+    Image();
+    Image(int width, int height, bool fInit = false);
+
+    void resize(int width, int height, bool fInit = true);
+
+    int width() const;
+    int height() const;
+    int depth() const;
+    int channels() const;
+    bool contains(int y, int x) const;
+};
+
+}  // namespace image
+}  // namespace aliceVision
+
+%extend aliceVision::image::Image {
+    /// Pixels view, the owner is the Python image (see getNumpyArray)
+    PyObject* _getNumpyArray(PyObject* owner) { return aliceVision::image::getNumpyView(*$self, owner); }
+
+    %pythoncode %{
+    def getNumpyArray(self):
+        """
+        Get a numpy view over the pixels of the image, without copy (height x width [x channels]).
+        The view keeps the image alive, it must not be used after a resize of the image.
+        """
+        return self._getNumpyArray(self)
+    %}
+}
+
+%template(ImageUChar) aliceVision::image::Image<unsigned char>;
+%template(ImageFloat) aliceVision::image::Image<float>;
+%template(ImageRGBColor) aliceVision::image::Image<aliceVision::image::RGBColor>;
+%template(ImageRGBfColor) aliceVision::image::Image<aliceVision::image::RGBfColor>;
+%template(ImageRGBAColor) aliceVision::image::Image<aliceVision::image::RGBAColor>;
+%template(ImageRGBAfColor) aliceVision::image::Image<aliceVision::image::RGBAfColor>;
@@ -8,6 +8,8 @@
 
 #include <aliceVision/system/Logger.hpp>
 
+#include <tuple>
+
 namespace aliceVision {
 namespace image {
 
@@ -113,40 +115,198 @@ unsigned long long int CacheValue::memorySize() const
     return 0;
 }
 
-ImageCache::ImageCache(float capacity_MiB, float maxSize_MiB, const ImageReadOptions& options)
+ImageCache::ImageCache(float capacity_MiB, float maxSize_MiB, const ImageReadOptions& options, int nbDecodeThreads)
   : _info(capacity_MiB, maxSize_MiB),
-    _options(options)
+    _options(options),
+    _nbDecodeThreads(nbDecodeThreads > 0 ? nbDecodeThreads : std::max(1u, std::thread::hardware_concurrency()))
 {}
 
-ImageCache::~ImageCache() {}
+ImageCache::~ImageCache()
+{
+    {
+        const std::scoped_lock<std::mutex> lockTasks(_mutexDecodeTasks);
+        _stopDecodeThreads = true;
+        _decodeTasks.clear();
+    }
+    _decodeTasksCondition.notify_all();
+
+    for (std::thread& thread : _decodeThreads)
+        thread.join();
+}
+
+CacheInfo ImageCache::info() const
+{
+    CacheInfo info = _info;
+    info.nbImages = _nbImages;
+    info.contentSize = _contentSize;
+    info.nbLoadFromDisk = _nbLoadFromDisk;
+    info.nbLoadFromCache = _nbLoadFromCache;
+    info.nbRemoveUnused = _nbRemoveUnused;
+    return info;
+}
 
 std::string ImageCache::toString() const
 {
     std::string description = "Image cache content (LRU to MRU): ";
 
-    for (const CacheKey& key : _keys)
+    std::vector<std::pair<std::uint64_t, std::string>> keyDescs;
+    for (const CacheShard& shard : _shards)
     {
-        std::string keyDesc = key.filename + ", nbChannels: " + std::to_string(key.nbChannels) + ", typeDesc: " + std::to_string(key.typeDesc) +
-                              ", downscaleLevel: " + std::to_string(key.downscaleLevel) +
-                              ", usages: " + std::to_string(_imagePtrs.at(key).useCount()) +
-                              ", size: " + std::to_string(_imagePtrs.at(key).memorySize());
-        description += "\n * " + keyDesc;
+        const std::scoped_lock<std::mutex> lockShard(shard.mutex);
+        for (const auto& entryPair : shard.entries)
+        {
+            const CacheKey& key = entryPair.first;
+            const CacheEntry& entry = entryPair.second;
+            std::string keyDesc = key.filename + ", nbChannels: " + std::to_string(key.nbChannels) + ", typeDesc: " + std::to_string(key.typeDesc) +
+                                  ", downscaleLevel: " + std::to_string(key.downscaleLevel);
+            if (key.tileSize > 0)
+                keyDesc += ", tile: (" + std::to_string(key.tileX) + ", " + std::to_string(key.tileY) + ") of size " + std::to_string(key.tileSize);
+            if (entry.value)
+                keyDesc += ", usages: " + std::to_string(entry.value->useCount()) + ", size: " + std::to_string(entry.value->memorySize());
+            else
+                keyDesc += ", loading";
+            keyDescs.emplace_back(entry.lastAccess, keyDesc);
+        }
     }
+    std::sort(keyDescs.begin(), keyDescs.end());
+
+    for (const auto& keyDesc : keyDescs)
+        description += "\n * " + keyDesc.second;
 
     std::string memUsageDesc = "\nMemory usage: "
                                "\n * capacity: " +
                                std::to_string(_info.capacity) + "\n * max size: " + std::to_string(_info.maxSize) +
-                               "\n * nb images: " + std::to_string(_info.nbImages) + "\n * content size: " + std::to_string(_info.contentSize);
+                               "\n * nb images: " + std::to_string(_nbImages) + "\n * content size: " + std::to_string(_contentSize);
     description += memUsageDesc;
 
     std::string statsDesc = "\nUsage statistics: "
                             "\n * nb load from disk: " +
-                            std::to_string(_info.nbLoadFromDisk) + "\n * nb load from cache: " + std::to_string(_info.nbLoadFromCache) +
-                            "\n * nb remove unused: " + std::to_string(_info.nbRemoveUnused);
+                            std::to_string(_nbLoadFromDisk) + "\n * nb load from cache: " + std::to_string(_nbLoadFromCache) +
+                            "\n * nb remove unused: " + std::to_string(_nbRemoveUnused);
     description += statsDesc;
 
     return description;
 }
 
+void ImageCache::reserve(unsigned long long int memSize, bool lazyCleaning)
+{
+    const std::scoped_lock<std::mutex> lockGeneral(_mutexGeneral);
+
+    // add image to cache if it fits in capacity
+    if (memSize + _contentSize <= _info.capacity)
+    {
+        _contentSize += memSize;
+        return;
+    }
+
+    // collect the images not used externally, from LRU to MRU
+    std::vector<std::tuple<std::uint64_t, unsigned long long int, CacheKey>> unusedImages;
+    for (const CacheShard& shard : _shards)
+    {
+        const std::scoped_lock<std::mutex> lockShard(shard.mutex);
+        for (const auto& entryPair : shard.entries)
+        {
+            const CacheEntry& entry = entryPair.second;
+            if (entry.value && entry.value->useCount() == 1)
+                unusedImages.emplace_back(entry.lastAccess, entry.value->memorySize(), entryPair.first);
+        }
+    }
+    std::sort(unusedImages.begin(), unusedImages.end(), [](const auto& a, const auto& b) { return std::get<0>(a) < std::get<0>(b); });
+
+    // retrieve missing capacity
+    long long int missingCapacity = memSize + _contentSize - _info.capacity;
+
+    // find unused image with size bigger than missing capacity
+    // remove it and add image to cache
+    if (lazyCleaning)
+    {
+        for (const auto& unusedImage : unusedImages)
+        {
+            if (std::get<1>(unusedImage) >= missingCapacity && removeUnused(std::get<2>(unusedImage)))
+            {
+                _contentSize += memSize;
+                return;
+            }
+        }
+    }
+
+    // remove as few unused images as possible
+    for (const auto& unusedImage : unusedImages)
+    {
+        if (missingCapacity <= 0)
+            break;
+
+        if (removeUnused(std::get<2>(unusedImage)))
+            missingCapacity = memSize + _contentSize - _info.capacity;
+    }
+
+    // add image to cache if it fits in maxSize
+    if (memSize + _contentSize <= _info.maxSize)
+    {
+        _contentSize += memSize;
+        return;
+    }
+
+    ALICEVISION_THROW_ERROR("[image] ImageCache: failed to load image \n" << toString());
+}
+
+void ImageCache::updateReservedSize(unsigned long long int reservedSize, unsigned long long int memSize)
+{
+    const std::scoped_lock<std::mutex> lockGeneral(_mutexGeneral);
+    _contentSize = _contentSize - reservedSize + memSize;
+}
+
+bool ImageCache::removeUnused(const CacheKey& key)
+{
+    CacheShard& shard = getShard(key);
+    const std::scoped_lock<std::mutex> lockShard(shard.mutex);
+
+    auto it = shard.entries.find(key);
+    if (it == shard.entries.end() || !it->second.value || it->second.value->useCount() != 1)
+        return false;
+
+    _nbImages--;
+    _contentSize -= it->second.value->memorySize();
+    _nbRemoveUnused++;
+
+    shard.entries.erase(it);
+    return true;
+}
+
+void ImageCache::enqueueDecodeTask(std::function<void()> task)
+{
+    {
+        const std::scoped_lock<std::mutex> lockTasks(_mutexDecodeTasks);
+
+        if (_decodeThreads.empty())
+        {
+            for (int i = 0; i < _nbDecodeThreads; ++i)
+                _decodeThreads.emplace_back(&ImageCache::decodeThreadLoop, this);
+        }
+
+        _decodeTasks.push_back(std::move(task));
+    }
+    _decodeTasksCondition.notify_one();
+}
+
+void ImageCache::decodeThreadLoop()
+{
+    while (true)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lockTasks(_mutexDecodeTasks);
+            _decodeTasksCondition.wait(lockTasks, [this]() { return _stopDecodeThreads || !_decodeTasks.empty(); });
+
+            if (_stopDecodeThreads)
+                return;
+
+            task = std::move(_decodeTasks.front());
+            _decodeTasks.pop_front();
+        }
+        task();
+    }
+}
+
 }  // namespace image
 }  // namespace aliceVision
@@ -20,9 +20,16 @@
 #include <memory>
 #include <unordered_map>
 #include <functional>
-#include <list>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <future>
 #include <mutex>
+#include <optional>
 #include <thread>
+#include <vector>
 #include <algorithm>
 
 namespace aliceVision {
@@ -38,19 +45,34 @@ struct CacheKey
     oiio::TypeDesc::BASETYPE typeDesc;
     int downscaleLevel;
     std::time_t lastWriteTime;
-
-    CacheKey(const std::string& path, int nchannels, oiio::TypeDesc::BASETYPE baseType, int level, std::time_t time)
+    /// tile of the downscaled image on a regular grid (tileSize == 0 for the whole image)
+    int tileX;
+    int tileY;
+    int tileSize;
+
+    CacheKey(const std::string& path,
+             int nchannels,
+             oiio::TypeDesc::BASETYPE baseType,
+             int level,
+             std::time_t time,
+             int tileXIndex = 0,
+             int tileYIndex = 0,
+             int tileSizePx = 0)
       : filename(path),
         nbChannels(nchannels),
         typeDesc(baseType),
         downscaleLevel(level),
-        lastWriteTime(time)
+        lastWriteTime(time),
+        tileX(tileXIndex),
+        tileY(tileYIndex),
+        tileSize(tileSizePx)
     {}
 
     bool operator==(const CacheKey& other) const
     {
         return (filename == other.filename && nbChannels == other.nbChannels && typeDesc == other.typeDesc &&
-                downscaleLevel == other.downscaleLevel && lastWriteTime == other.lastWriteTime);
+                downscaleLevel == other.downscaleLevel && lastWriteTime == other.lastWriteTime && tileX == other.tileX && tileY == other.tileY &&
+                tileSize == other.tileSize);
     }
 };
 
@@ -64,6 +86,9 @@ struct CacheKeyHasher
         boost::hash_combine(seed, key.typeDesc);
         boost::hash_combine(seed, key.downscaleLevel);
         boost::hash_combine(seed, key.lastWriteTime);
+        boost::hash_combine(seed, key.tileX);
+        boost::hash_combine(seed, key.tileY);
+        boost::hash_combine(seed, key.tileSize);
         return seed;
     }
 };
@@ -203,6 +228,11 @@ inline std::shared_ptr<Image<RGBAfColor>> CacheValue::get<RGBAfColor>()
  * or until there is nothing to remove
  * 5. if the image fits in the maximal size, load it, store it and return it
  * 6. the image is too big for the cache, throw an error.
+ *
+ * The entries are split in shards according to the hash of their key, so that concurrent requests for different images
+ * do not wait for each other. An image requested by several threads at the same time is only decoded once:
+ * the other threads wait for the first request to complete.
+ * Images can also be loaded asynchronously by a pool of decoding threads (see asyncGet and prefetch).
  */
 class ImageCache
 {
@@ -212,11 +242,14 @@ class ImageCache
      * @param[in] capacity_MiB the cache capacity (in MiB)
      * @param[in] maxSize_MiB the cache maximal size (in MiB)
      * @param[in] options the reading options that will be used when loading images through this cache
+     * @param[in] nbDecodeThreads the number of threads used by the asynchronous requests (0 to use the hardware concurrency),
+     *            the threads are only started on the first asynchronous request
      */
-    ImageCache(float capacity_MiB, float maxSize_MiB, const ImageReadOptions& options);
+    ImageCache(float capacity_MiB, float maxSize_MiB, const ImageReadOptions& options, int nbDecodeThreads = 0);
 
     /**
      * @brief Destroy the cache and the unused images it contains.
+     * @note The pending asynchronous requests are cancelled.
      */
     ~ImageCache();
 
@@ -237,6 +270,42 @@ class ImageCache
     template<typename TPix>
     std::shared_ptr<Image<TPix>> get(const std::string& filename, int downscaleLevel = 1, bool cachedOnly = false, bool lazyCleaning = true);
 
+    /**
+     * @brief Retrieve a cached tile of an image at a given downscale level.
+     *        Only the region of the tile is decoded (see ImageReadOptions::subROI), and the tiles are cached independently,
+     *        so that the consumers of large images only keep the parts they use in memory.
+     * @note This method is thread-safe.
+     * @param[in] filename the image's filename on disk
+     * @param[in] tileX the tile column in the regular grid of the downscaled image
+     * @param[in] tileY the tile row in the regular grid of the downscaled image
+     * @param[in] tileSize the tile size in pixels of the downscaled image, the tiles on the right and bottom borders can be smaller
+     * @param[in] downscaleLevel the downscale level
+     * @return a shared pointer to the cached tile
+     * @throws std::runtime_error if the tile is outside of the image or does not fit in the maximal size of the cache
+     */
+    template<typename TPix>
+    std::shared_ptr<Image<TPix>> getTile(const std::string& filename, int tileX, int tileY, int tileSize, int downscaleLevel = 1);
+
+    /**
+     * @brief Retrieve a cached image at a given downscale level, the image is loaded by the decoding threads.
+     * @note This method is thread-safe.
+     * @param[in] filename the image's filename on disk
+     * @param[in] downscaleLevel the downscale level
+     * @return a future on the shared pointer to the cached image, that holds the error if the image cannot be loaded
+     */
+    template<typename TPix>
+    std::shared_future<std::shared_ptr<Image<TPix>>> asyncGet(const std::string& filename, int downscaleLevel = 1);
+
+    /**
+     * @brief Load images in the cache with the decoding threads, so that the next requests on them do not wait for the disk.
+     * @note This method is thread-safe. The prefetched images are not used externally: they can be removed from the cache
+     *       to fit other images before they are requested.
+     * @param[in] filenames the images' filenames on disk, loaded in this order
+     * @param[in] downscaleLevel the downscale level
+     */
+    template<typename TPix>
+    void prefetch(const std::vector<std::string>& filenames, int downscaleLevel = 1);
+
     /**
      * @brief Check if an image at a given downscale level is currently in the cache.
      * @note This method is thread-safe.
@@ -250,7 +319,7 @@ class ImageCache
     /**
      * @return information on the current cache state and usage
      */
-    inline const CacheInfo& info() const { return _info; }
+    CacheInfo info() const;
 
     /**
      * @return the image reading options of the cache
@@ -265,21 +334,102 @@ class ImageCache
 
   private:
     /**
-     * @brief Load a new image corresponding to the given key and add it as a new entry in the cache.
+     * @brief An entry of the cache: the loaded image, or the future result of the request which is loading it.
+     */
+    struct CacheEntry
+    {
+        std::optional<CacheValue> value;
+        std::shared_future<CacheValue> loading;
+        std::uint64_t lastAccess = 0;
+    };
+
+    /**
+     * @brief A subset of the cache entries protected by its own mutex.
+     */
+    struct CacheShard
+    {
+        mutable std::mutex mutex;
+        std::unordered_map<CacheKey, CacheEntry, CacheKeyHasher> entries;
+    };
+
+    static constexpr std::size_t nbShards = 16;
+
+    inline CacheShard& getShard(const CacheKey& key) { return _shards[CacheKeyHasher()(key) % nbShards]; }
+    inline const CacheShard& getShard(const CacheKey& key) const { return _shards[CacheKeyHasher()(key) % nbShards]; }
+
+    /**
+     * @brief Load a new image corresponding to the given key.
      * @param[in] key the key used to identify the entry in the cache
-     * @param[in] lockPeek lock on the peeking mutex, will be released
+     * @param[in] lazyCleaning if true, will try lazy cleaning heuristic before LRU cleaning
+     * @return the loaded image
+     */
+    /**
+     * @brief Retrieve a cached image or tile, or load it (only once for concurrent requests).
+     * @param[in] key the cache key of the image or tile
+     * @param[in] cachedOnly if true, only return images that are already in the cache
+     * @param[in] lazyCleaning if true, will try lazy cleaning heuristic before LRU cleaning
+     * @return a shared pointer to the cached image
      */
     template<typename TPix>
-    void load(const CacheKey& key, std::unique_lock<std::mutex>& lockPeek);
+    std::shared_ptr<Image<TPix>> getEntry(const CacheKey& key, bool cachedOnly, bool lazyCleaning);
+
+    template<typename TPix>
+    CacheValue load(const CacheKey& key, bool lazyCleaning);
+
+    /**
+     * @brief Reserve memory in the cache for an image, removing unused images if needed.
+     * @param[in] memSize the memory size of the image
+     * @param[in] lazyCleaning if true, will try lazy cleaning heuristic before LRU cleaning
+     * @throws std::runtime_error if the image does not fit in the maximal size of the cache
+     */
+    void reserve(unsigned long long int memSize, bool lazyCleaning);
+
+    /**
+     * @brief Update the cache content size with the actual size of a loaded image.
+     * @param[in] reservedSize the memory size reserved for the image
+     * @param[in] memSize the memory size of the loaded image (0 if the loading failed)
+     */
+    void updateReservedSize(unsigned long long int reservedSize, unsigned long long int memSize);
+
+    /**
+     * @brief Remove an image from the cache if it is not used externally.
+     * @return true if the image has been removed
+     */
+    bool removeUnused(const CacheKey& key);
+
+    /**
+     * @brief Add a task to the queue of the decoding threads, starting them if needed.
+     */
+    void enqueueDecodeTask(std::function<void()> task);
+
+    void decodeThreadLoop();
 
     CacheInfo _info;
     ImageReadOptions _options;
-    std::unordered_map<CacheKey, CacheValue, CacheKeyHasher> _imagePtrs;
-    /// ordered from LRU (Least Recently Used) to MRU (Most Recently Used)
-    std::list<CacheKey> _keys;
+    std::array<CacheShard, nbShards> _shards;
+
+    /// current state of the cache
+    std::atomic<int> _nbImages{0};
+    std::atomic<unsigned long long int> _contentSize{0};
+
+    /// usage statistics
+    std::atomic<int> _nbLoadFromDisk{0};
+    std::atomic<int> _nbLoadFromCache{0};
+    std::atomic<int> _nbRemoveUnused{0};
 
+    /// access counter giving the LRU order of the entries
+    std::atomic<std::uint64_t> _accessCounter{0};
+
+    /// protect the memory usage of the cache
     mutable std::mutex _mutexGeneral;
-    mutable std::mutex _mutexPeek;
+
+    /// decoding threads
+    const int _nbDecodeThreads;
+    std::vector<std::thread> _decodeThreads;
+    std::deque<std::function<void()>> _decodeTasks;
+    std::mutex _mutexDecodeTasks;
+    std::condition_variable _decodeTasksCondition;
+    bool _stopDecodeThreads = false;
 };
 
 // Since some methods in the ImageCache class are templated
@@ -294,151 +444,200 @@ std::shared_ptr<Image<TPix>> ImageCache::get(const std::string& filename, int do
                                 << "request was made with downscale level " << downscaleLevel);
     }
 
-    std::unique_lock<std::mutex> lockPeek(_mutexPeek);
-
     ALICEVISION_LOG_TRACE("[image] ImageCache: reading " << filename << " with downscale level " << downscaleLevel << " from thread "
                                                          << std::this_thread::get_id());
 
     using TInfo = ColorTypeInfo<TPix>;
 
     auto lastWriteTime = utils::getLastWriteTime(filename);
-    CacheKey keyReq(filename, TInfo::size, TInfo::typeDesc, downscaleLevel, lastWriteTime);
+    const CacheKey keyReq(filename, TInfo::size, TInfo::typeDesc, downscaleLevel, lastWriteTime);
+
+    return getEntry<TPix>(keyReq, cachedOnly, lazyCleaning);
+}
+
+template<typename TPix>
+std::shared_ptr<Image<TPix>> ImageCache::getTile(const std::string& filename, int tileX, int tileY, int tileSize, int downscaleLevel)
+{
+    if (downscaleLevel < 1)
+    {
+        ALICEVISION_THROW_ERROR("[image] ImageCache: cannot load image with downscale level < 1, "
+                                << "request was made with downscale level " << downscaleLevel);
+    }
+    if (tileSize < 1 || tileX < 0 || tileY < 0)
+    {
+        ALICEVISION_THROW_ERROR("[image] ImageCache: invalid tile (" << tileX << ", " << tileY << ") of size " << tileSize << " requested for "
+                                                                     << filename);
+    }
+
+    using TInfo = ColorTypeInfo<TPix>;
+
+    auto lastWriteTime = utils::getLastWriteTime(filename);
+    const CacheKey keyReq(filename, TInfo::size, TInfo::typeDesc, downscaleLevel, lastWriteTime, tileX, tileY, tileSize);
+
+    return getEntry<TPix>(keyReq, false, true);
+}
+
+template<typename TPix>
+std::shared_ptr<Image<TPix>> ImageCache::getEntry(const CacheKey& keyReq, bool cachedOnly, bool lazyCleaning)
+{
+    CacheShard& shard = getShard(keyReq);
+    std::promise<CacheValue> loadingPromise;
 
     // find the requested image in the cached images
     {
-        auto it = std::find(_keys.begin(), _keys.end(), keyReq);
-        if (it != _keys.end())
+        std::unique_lock<std::mutex> lockShard(shard.mutex);
+
+        auto it = shard.entries.find(keyReq);
+        if (it != shard.entries.end())
         {
-            // image becomes LRU
-            _keys.erase(it);
-            _keys.push_back(keyReq);
+            CacheEntry& entry = it->second;
+
+            // image becomes MRU
+            entry.lastAccess = ++_accessCounter;
+            _nbLoadFromCache++;
+
+            if (entry.value)
+            {
+                return entry.value->get<TPix>();
+            }
 
-            _info.nbLoadFromCache++;
+            // the image is being loaded by another request: wait for it
+            const std::shared_future<CacheValue> loading = entry.loading;
+            lockShard.unlock();
 
-            ALICEVISION_LOG_TRACE("[image] ImageCache: " << toString());
-            return _imagePtrs.at(keyReq).get<TPix>();
+            CacheValue value = loading.get();
+            return value.get<TPix>();
         }
         else if (cachedOnly)
         {
             return nullptr;
         }
+
+        CacheEntry& entry = shard.entries[keyReq];
+        entry.loading = loadingPromise.get_future().share();
+        entry.lastAccess = ++_accessCounter;
     }
 
-    const std::scoped_lock<std::mutex> lockGeneral(_mutexGeneral);
+    try
+    {
+        CacheValue value = load<TPix>(keyReq, lazyCleaning);
 
-    // retrieve image size
-    int width, height;
-    readImageSize(filename, width, height);
-    unsigned long long int memSize = (width / downscaleLevel) * (height / downscaleLevel) * sizeof(TPix);
+        {
+            const std::scoped_lock<std::mutex> lockShard(shard.mutex);
+            CacheEntry& entry = shard.entries.at(keyReq);
+            entry.value = value;
+            entry.loading = std::shared_future<CacheValue>();
+        }
+        _nbImages++;
 
-    // add image to cache if it fits in capacity
-    if (memSize + _info.contentSize <= _info.capacity)
-    {
-        load<TPix>(keyReq, lockPeek);
+        loadingPromise.set_value(value);
 
         ALICEVISION_LOG_TRACE("[image] ImageCache: " << toString());
-        return _imagePtrs.at(keyReq).get<TPix>();
+        return value.get<TPix>();
     }
-
-    // retrieve missing capacity
-    long long int missingCapacity = memSize + _info.contentSize - _info.capacity;
-
-    // find unused image with size bigger than missing capacity
-    // remove it and add image to cache
-    if (lazyCleaning)
+    catch (...)
     {
-        auto it = _keys.begin();
-        while (it != _keys.end())
         {
-            const CacheKey& key = *it;
-            const CacheValue& value = _imagePtrs.at(key);
-            if (value.useCount() == 1 && value.memorySize() >= missingCapacity)
-            {
-                _info.nbImages--;
-                _info.contentSize -= value.memorySize();
-                _imagePtrs.erase(key);
-                _keys.erase(it);
+            const std::scoped_lock<std::mutex> lockShard(shard.mutex);
+            shard.entries.erase(keyReq);
+        }
+        loadingPromise.set_exception(std::current_exception());
+        throw;
+    }
+}
 
-                _info.nbRemoveUnused++;
+template<typename TPix>
+CacheValue ImageCache::load(const CacheKey& key, bool lazyCleaning)
+{
+    // retrieve image size
+    int width, height;
+    readImageSize(key.filename, width, height);
 
-                load<TPix>(keyReq, lockPeek);
+    ImageReadOptions options = _options;
+    int loadedWidth = width / key.downscaleLevel;
+    int loadedHeight = height / key.downscaleLevel;
 
-                ALICEVISION_LOG_TRACE("[image] ImageCache: " << toString());
-                return _imagePtrs.at(keyReq).get<TPix>();
-            }
-            ++it;
+    if (key.tileSize > 0)
+    {
+        // tile region in the downscaled image
+        const int xBegin = key.tileX * key.tileSize;
+        const int yBegin = key.tileY * key.tileSize;
+        if (xBegin >= loadedWidth || yBegin >= loadedHeight)
+        {
+            ALICEVISION_THROW_ERROR("[image] ImageCache: the tile (" << key.tileX << ", " << key.tileY << ") is outside of the image " << key.filename);
         }
+        loadedWidth = std::min(key.tileSize, loadedWidth - xBegin);
+        loadedHeight = std::min(key.tileSize, loadedHeight - yBegin);
+
+        // only decode the tile region of the full resolution image
+        options.subROI = oiio::ROI(xBegin * key.downscaleLevel,
+                                   (xBegin + loadedWidth) * key.downscaleLevel,
+                                   yBegin * key.downscaleLevel,
+                                   (yBegin + loadedHeight) * key.downscaleLevel);
     }
 
-    // remove as few unused images as possible
-    while (missingCapacity > 0)
-    {
-        auto it = std::find_if(_keys.begin(), _keys.end(), [this](const CacheKey& k) { return _imagePtrs.at(k).useCount() == 1; });
+    const unsigned long long int memSize = static_cast<unsigned long long int>(loadedWidth) * loadedHeight * sizeof(TPix);
 
-        if (it != _keys.end())
-        {
-            const CacheKey& key = *it;
-            const CacheValue& value = _imagePtrs.at(key);
+    reserve(memSize, lazyCleaning);
 
-            _info.nbImages--;
-            _info.contentSize -= value.memorySize();
-            _imagePtrs.erase(key);
-            _keys.erase(it);
+    auto img = std::make_shared<Image<TPix>>();
 
-            _info.nbRemoveUnused++;
+    try
+    {
+        // load image from disk
+        readImage(key.filename, *img, options);
 
-            missingCapacity = memSize + _info.contentSize - _info.capacity;
-        }
-        else
+        // apply downscale
+        if (key.downscaleLevel > 1)
         {
-            break;
+            imageAlgo::resizeImage(key.downscaleLevel, *img);
         }
     }
-
-    // add image to cache if it fits in maxSize
-    if (memSize + _info.contentSize <= _info.maxSize)
+    catch (...)
     {
-        load<TPix>(keyReq, lockPeek);
-
-        ALICEVISION_LOG_TRACE("[image] ImageCache: " << toString());
-        return _imagePtrs.at(keyReq).get<TPix>();
+        updateReservedSize(memSize, 0);
+        throw;
     }
 
-    ALICEVISION_THROW_ERROR("[image] ImageCache: failed to load image \n" << toString());
+    _nbLoadFromDisk++;
+
+    // create wrapper around shared pointer
+    CacheValue value = CacheValue::wrap(img);
+
+    // update memory usage
+    updateReservedSize(memSize, value.memorySize());
 
-    return nullptr;
+    return value;
 }
 
 template<typename TPix>
-void ImageCache::load(const CacheKey& key, std::unique_lock<std::mutex>& lockPeek)
+std::shared_future<std::shared_ptr<Image<TPix>>> ImageCache::asyncGet(const std::string& filename, int downscaleLevel)
 {
-    lockPeek.unlock();
+    auto task = std::make_shared<std::packaged_task<std::shared_ptr<Image<TPix>>()>>(
+      [this, filename, downscaleLevel]() { return get<TPix>(filename, downscaleLevel); });
 
-    auto img = std::make_shared<Image<TPix>>();
+    std::shared_future<std::shared_ptr<Image<TPix>>> result = task->get_future().share();
+    enqueueDecodeTask([task]() { (*task)(); });
 
-    // load image from disk
-    readImage(key.filename, *img, _options);
+    return result;
+}
 
-    // apply downscale
-    if (key.downscaleLevel > 1)
+template<typename TPix>
+void ImageCache::prefetch(const std::vector<std::string>& filenames, int downscaleLevel)
+{
+    for (const std::string& filename : filenames)
     {
-        imageAlgo::resizeImage(key.downscaleLevel, *img);
+        enqueueDecodeTask([this, filename, downscaleLevel]() {
+            try
+            {
+                get<TPix>(filename, downscaleLevel);
+            }
+            catch (const std::exception& e)
+            {
+                ALICEVISION_LOG_WARNING("[image] ImageCache: failed to prefetch " << filename << ": " << e.what());
+            }
+        });
     }
-
-    lockPeek.lock();
-
-    _info.nbLoadFromDisk++;
-
-    // create wrapper around shared pointer
-    CacheValue value = CacheValue::wrap(img);
-
-    // add to cache as MRU
-    _imagePtrs.insert({key, value});
-    _keys.push_back(key);
-
-    // update memory usage
-    _info.nbImages++;
-    _info.contentSize += value.memorySize();
 }
 
 template<typename TPix>
@@ -450,16 +649,17 @@ bool ImageCache::contains(const std::string& filename, int downscaleLevel) const
                                 << "request was made with downscale level " << downscaleLevel);
     }
 
-    const std::scoped_lock<std::mutex> lockPeek(_mutexPeek);
-
     using TInfo = ColorTypeInfo<TPix>;
 
     auto lastWriteTime = utils::getLastWriteTime(filename);
     CacheKey keyReq(filename, TInfo::size, TInfo::typeDesc, downscaleLevel, lastWriteTime);
 
-    auto it = std::find(_keys.begin(), _keys.end(), keyReq);
+    const CacheShard& shard = getShard(keyReq);
+    const std::scoped_lock<std::mutex> lockShard(shard.mutex);
+
+    auto it = shard.entries.find(keyReq);
 
-    return it != _keys.end();
+    return it != shard.entries.end() && it->second.value.has_value();
 }
 
 }  // namespace image
@@ -0,0 +1,150 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/image/Image.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#if defined(__linux__)
+    #include <sys/mman.h>
+    #include <unistd.h>
+#endif
+
+namespace aliceVision {
+namespace image {
+
+/**
+ * @brief Pool of the buffers of released images, to reuse them for the next images of the same number of pixels.
+ *
+ * The images of a loop (tiles, per view buffers) are often all of the same size: acquiring them from a pool
+ * avoids the allocation, the page faults and the zeroing of a new buffer at each iteration.
+ * The free buffers are stored by number of pixels (an Image keeps its buffer when it is resized to the same number of pixels)
+ * and their total memory is bounded. The new buffers larger than a huge page are advised to be backed by huge pages (Linux).
+ * The pool is thread safe. The images are regular images, the pool is opt-in: an image not released to the pool is just freed.
+ */
+template<typename T>
+class ImagePool
+{
+  public:
+    /**
+     * @param[in] maxFreeBytes The maximum memory of the free buffers kept by the pool
+     */
+    explicit ImagePool(std::size_t maxFreeBytes = std::size_t(1) << 30)
+      : _maxFreeBytes(maxFreeBytes)
+    {}
+
+    // no copy
+    ImagePool(const ImagePool&) = delete;
+    ImagePool& operator=(const ImagePool&) = delete;
+
+    /**
+     * @brief Get an image, reusing a free buffer of the same number of pixels if any.
+     * @param[in] width The image width
+     * @param[in] height The image height
+     * @param[in] fInit Initialize the pixels (the pixels of a reused buffer are the ones of its previous image otherwise)
+     * @param[in] val The value of the pixels if fInit is true
+     */
+    Image<T> acquire(int width, int height, bool fInit = false, const T val = T{})
+    {
+        const std::size_t nbPixels = static_cast<std::size_t>(width) * static_cast<std::size_t>(height);
+
+        Image<T> image;
+        bool reused = false;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            auto it = _free.find(nbPixels);
+            if (it != _free.end() && !it->second.empty())
+            {
+                image.swap(it->second.back());
+                it->second.pop_back();
+                _freeBytes -= nbPixels * sizeof(T);
+                reused = true;
+            }
+        }
+
+        // same number of pixels: no reallocation
+        image.resize(width, height, false);
+        if (!reused)
+            adviseHugePages(image.data(), nbPixels * sizeof(T));
+        if (fInit)
+            image.fill(val);
+        return image;
+    }
+
+    /**
+     * @brief Give the buffer of an image back to the pool. The image is empty after the call.
+     *        The buffer is freed if the pool is full.
+     */
+    void release(Image<T>& image)
+    {
+        const std::size_t nbBytes = static_cast<std::size_t>(image.size()) * sizeof(T);
+        if (nbBytes == 0)
+            return;
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_freeBytes + nbBytes > _maxFreeBytes)
+        {
+            image = Image<T>();
+            return;
+        }
+        std::vector<Image<T>>& buffers = _free[static_cast<std::size_t>(image.size())];
+        buffers.emplace_back();
+        buffers.back().swap(image);
+        _freeBytes += nbBytes;
+    }
+
+    /**
+     * @brief Free all the buffers of the pool.
+     */
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _free.clear();
+        _freeBytes = 0;
+    }
+
+    /**
+     * @brief Get the memory of the free buffers of the pool.
+     */
+    std::size_t getFreeBytes() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _freeBytes;
+    }
+
+  private:
+    /**
+     * @brief Advise the kernel to back the pages of a new buffer with transparent huge pages, before they are touched.
+     */
+    static void adviseHugePages(void* data, std::size_t nbBytes)
+    {
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+        constexpr std::size_t hugePageSize = std::size_t(2) << 20;
+        if (nbBytes < 2 * hugePageSize)
+            return;
+        // the buffer is not page aligned: only advise the pages inside of it
+        const std::size_t pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+        const std::uintptr_t begin = (reinterpret_cast<std::uintptr_t>(data) + pageSize - 1) / pageSize * pageSize;
+        const std::uintptr_t end = (reinterpret_cast<std::uintptr_t>(data) + nbBytes) / pageSize * pageSize;
+        if (end > begin)
+            madvise(reinterpret_cast<void*>(begin), end - begin, MADV_HUGEPAGE);
+#endif
+    }
+
+    const std::size_t _maxFreeBytes;
+    std::size_t _freeBytes = 0;
+    mutable std::mutex _mutex;
+    std::map<std::size_t, std::vector<Image<T>>> _free;
+};
+
+}  // namespace image
+}  // namespace aliceVision
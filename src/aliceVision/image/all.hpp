@@ -29,3 +29,4 @@
 #include "aliceVision/image/conversionOpenCV.hpp"
 #include "aliceVision/image/dcp.hpp"
 #include "aliceVision/image/ImageCache.hpp"
+#include "aliceVision/image/ImagePool.hpp"
@@ -31,9 +31,17 @@ void CacheManager::wipe()
     _nextObjectId = 0;
 }
 
-void CacheManager::setMaxMemory(size_t maxMemorySize) { _incoreBlockUsageMax = maxMemorySize / _blockSize; }
+void CacheManager::setMaxMemory(size_t maxMemorySize)
+{
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    _incoreBlockUsageMax = maxMemorySize / _blockSize;
+}
 
-void CacheManager::setInCoreMaxObjectCount(size_t max) { _incoreBlockUsageMax = max; }
+void CacheManager::setInCoreMaxObjectCount(size_t max)
+{
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    _incoreBlockUsageMax = max;
+}
 
 std::string CacheManager::getPathForIndex(size_t indexId)
 {
@@ -209,6 +217,8 @@ size_t CacheManager::getFreeBlockId(size_t blockCount)
 
 bool CacheManager::createObject(size_t& objectId, size_t blockCount)
 {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+
     objectId = _nextObjectId;
     _nextObjectId++;
 
@@ -220,8 +230,10 @@ bool CacheManager::createObject(size_t& objectId, size_t blockCount)
     return true;
 }
 
-bool CacheManager::acquireObject(std::unique_ptr<unsigned char>& data, size_t objectId)
+bool CacheManager::acquireObject(std::unique_ptr<unsigned char>& data, size_t objectId, bool pin)
 {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+
     MemoryMap::iterator itfind = _memoryMap.find(objectId);
     if (itfind == _memoryMap.end())
     {
@@ -263,12 +275,28 @@ bool CacheManager::acquireObject(std::unique_ptr<unsigned char>& data, size_t ob
         _mru.relocate(_mru.begin(), p.first);
     }
 
-    while (_incoreBlockUsageCount > _incoreBlockUsageMax && _mru.size() > 1)
+    if (pin)
     {
-        MRUItem item = _mru.back();
+        _pinnedObjects[objectId]++;
+    }
+
+    /*
+    Move the least recently used objects out of core.
+    The first item is the acquired object, the pinned objects are skipped.
+    */
+    MRUType::iterator it = _mru.end();
+    while (_incoreBlockUsageCount > _incoreBlockUsageMax && std::prev(it) != _mru.begin())
+    {
+        --it;
+        if (_pinnedObjects.count(it->objectId))
+        {
+            continue;
+        }
+
+        MRUItem item = *it;
 
         /*Remove item from mru*/
-        _mru.pop_back();
+        it = _mru.erase(it);
 
         /*Update memory usage*/
         _incoreBlockUsageCount -= item.objectSize;
@@ -279,6 +307,22 @@ bool CacheManager::acquireObject(std::unique_ptr<unsigned char>& data, size_t ob
     return true;
 }
 
+void CacheManager::releaseObject(size_t objectId)
+{
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+
+    auto itfind = _pinnedObjects.find(objectId);
+    if (itfind == _pinnedObjects.end())
+    {
+        return;
+    }
+
+    if (--itfind->second == 0)
+    {
+        _pinnedObjects.erase(itfind);
+    }
+}
+
 bool CacheManager::saveObject(std::unique_ptr<unsigned char>&& data, size_t objectId)
 {
     MemoryMap::iterator itfind = _memoryMap.find(objectId);
@@ -307,7 +351,11 @@ bool CacheManager::saveObject(std::unique_ptr<unsigned char>&& data, size_t obje
 
 void CacheManager::addFreeBlock(size_t blockId, size_t blockCount) { _freeBlocks[blockCount].push_back(blockId); }
 
-size_t CacheManager::getActiveBlocks() const { return _memoryMap.size(); }
+size_t CacheManager::getActiveBlocks() const
+{
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    return _memoryMap.size();
+}
 
 CachedTile::~CachedTile()
 {
@@ -318,7 +366,7 @@ CachedTile::~CachedTile()
     }
 }
 
-bool CachedTile::acquire()
+bool CachedTile::acquire(bool pin)
 {
     std::shared_ptr<TileCacheManager> manager = _manager.lock();
     if (!manager)
@@ -326,9 +374,18 @@ bool CachedTile::acquire()
         return false;
     }
 
-    return manager->acquire(_uid);
+    return manager->acquire(_uid, pin);
+}
 
-    return true;
+void CachedTile::release()
+{
+    std::shared_ptr<TileCacheManager> manager = _manager.lock();
+    if (!manager)
+    {
+        return;
+    }
+
+    manager->release(_uid);
 }
 
 TileCacheManager::TileCacheManager(const std::string& pathStorage, size_t tileWidth, size_t tileHeight, size_t maxTilesPerIndex)
@@ -376,6 +433,8 @@ std::shared_ptr<TileCacheManager> TileCacheManager::create(const std::string& pa
 
 std::shared_ptr<CachedTile> TileCacheManager::requireNewCachedTile(size_t width, size_t height, size_t blockCount)
 {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+
     CachedTile::smart_pointer ret;
     size_t uid;
 
@@ -396,6 +455,8 @@ std::shared_ptr<CachedTile> TileCacheManager::requireNewCachedTile(size_t width,
 
 void TileCacheManager::notifyDestroy(size_t tileId)
 {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+
     /* Remove weak pointer */
     _objectMap.erase(tileId);
 
@@ -408,6 +469,7 @@ void TileCacheManager::notifyDestroy(size_t tileId)
     size_t blockId = it->second.startBlockId;
     size_t blockCount = it->second.countBlock;
     _memoryMap.erase(it);
+    _pinnedObjects.erase(tileId);
 
     /*If memory block is valid*/
     if (blockId != ~0)
@@ -417,8 +479,10 @@ void TileCacheManager::notifyDestroy(size_t tileId)
     }
 }
 
-bool TileCacheManager::acquire(size_t tileId)
+bool TileCacheManager::acquire(size_t tileId, bool pin)
 {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+
     MapCachedTile::iterator itfind = _objectMap.find(tileId);
     if (itfind == _objectMap.end())
     {
@@ -433,7 +497,7 @@ bool TileCacheManager::acquire(size_t tileId)
 
     /*Acquire the object*/
     std::unique_ptr<unsigned char> content = tile->getData();
-    if (!CacheManager::acquireObject(content, tileId))
+    if (!CacheManager::acquireObject(content, tileId, pin))
     {
         return false;
     }
@@ -444,6 +508,8 @@ bool TileCacheManager::acquire(size_t tileId)
     return true;
 }
 
+void TileCacheManager::release(size_t tileId) { CacheManager::releaseObject(tileId); }
+
 void TileCacheManager::onRemovedFromMRU(size_t objectId)
 {
     MapCachedTile::iterator itfind = _objectMap.find(objectId);
@@ -19,6 +19,7 @@
 
 #include <fstream>
 #include <list>
+#include <mutex>
 #include <sstream>
 #include <queue>
 
@@ -80,9 +81,17 @@ class CachedTile
     /*
     Tells the system that we need the data for this tile.
     This means that the data is out of core, we want it back.
+    @param pin if true, the tile stays in core until release() is called.
+    A tile must be pinned when other threads may acquire tiles while its data is used.
     @return false if the process failed to grab data.
     */
-    bool acquire();
+    bool acquire(bool pin = false);
+
+    /*
+    Tells the system that the data of a tile acquired with pin is not used anymore.
+    The tile may then be moved out of core.
+    */
+    void release();
 
     /**
      * Update data with a new buffer
@@ -198,9 +207,16 @@ class CacheManager
      * Acquire a given object
      * @param data the result data acquired
      * @param objectId the object index to acquire
+     * @param pin if true, the object is not moved out of core until releaseObject is called
      * @return true if the object was acquired
      */
-    bool acquireObject(std::unique_ptr<unsigned char>& data, size_t objectId);
+    bool acquireObject(std::unique_ptr<unsigned char>& data, size_t objectId, bool pin = false);
+
+    /**
+     * Release an object acquired with pin
+     * @param objectId the object index to release
+     */
+    void releaseObject(size_t objectId);
 
     /**
      * Get the number of managed blocks
@@ -237,6 +253,13 @@ class CacheManager
 
     MRUType _mru;
     MemoryMap _memoryMap;
+
+    /// Pin count of the objects which can't be moved out of core
+    std::unordered_map<size_t, size_t> _pinnedObjects;
+
+    /// Protects the whole state of the manager, so that tiles may be acquired from several threads.
+    /// It is recursive because destroying a tile calls back the manager.
+    mutable std::recursive_mutex _mutex;
 };
 
 /**
@@ -273,9 +296,16 @@ class TileCacheManager : public CacheManager, public std::enable_shared_from_thi
     /**
      * Acquire a given tile
      * @param tileId the tile index to acquire
+     * @param pin if true, the tile stays in core until release is called
      * @return true if the tile was acquired
      */
-    bool acquire(size_t tileId);
+    bool acquire(size_t tileId, bool pin = false);
+
+    /**
+     * Release a tile acquired with pin
+     * @param tileId the tile index to release
+     */
+    void release(size_t tileId);
 
     /**
      * Acquire a given tile
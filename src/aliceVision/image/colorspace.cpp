@@ -14,6 +14,10 @@
 #include <boost/algorithm/string.hpp>
 
 #include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
 #include <vector>
 
 namespace aliceVision {
@@ -144,6 +148,41 @@ void initColorConfigOCIO(const std::string& colorConfigFilePath)
     ALICEVISION_LOG_INFO("OCIO color config initialized with OCIO version: " << ocioMajor << "." << ocioMinor << "." << ocioPatch);
 }
 
+oiio::ColorProcessorHandle getColorProcessor(const std::string& fromColorSpaceName,
+                                             const std::string& toColorSpaceName,
+                                             const std::string& colorConfigFilePath)
+{
+    static std::mutex mutex;
+    static std::map<std::string, std::unique_ptr<oiio::ColorConfig>> colorConfigs;
+    static std::map<std::tuple<std::string, std::string, std::string>, oiio::ColorProcessorHandle> processors;
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    const auto key = std::make_tuple(colorConfigFilePath, fromColorSpaceName, toColorSpaceName);
+    const auto it = processors.find(key);
+    if (it != processors.end())
+    {
+        return it->second;
+    }
+
+    std::unique_ptr<oiio::ColorConfig>& colorConfig = colorConfigs[colorConfigFilePath];
+    if (!colorConfig)
+    {
+        colorConfig = std::make_unique<oiio::ColorConfig>(colorConfigFilePath);
+    }
+
+    oiio::ColorProcessorHandle processor = colorConfig->createColorProcessor(fromColorSpaceName, toColorSpaceName);
+    if (!processor)
+    {
+        ALICEVISION_LOG_WARNING("Cannot create the color conversion from " << fromColorSpaceName << " to " << toColorSpaceName << ": "
+                                                                           << colorConfig->geterror());
+        return processor;
+    }
+
+    processors.emplace(key, processor);
+    return processor;
+}
+
 std::string EImageColorSpace_informations()
 {
     return EImageColorSpace_enumToString(EImageColorSpace::AUTO) + ", " + EImageColorSpace_enumToString(EImageColorSpace::LINEAR) + ", " +
@@ -62,5 +62,17 @@ std::string getDefaultColorConfigFilePath();
 void initColorConfigOCIO(const std::string& colorConfigFilePath);
 oiio::ColorConfig& getGlobalColorConfigOCIO();
 
+/**
+ * @brief Get the processor of a color space conversion, created at the first request and shared by the next ones.
+ *        (the conversions through the OIIO color space names create a color config and a processor per call)
+ * @param[in] fromColorSpaceName The source OIIO color space name
+ * @param[in] toColorSpaceName The destination OIIO color space name
+ * @param[in] colorConfigFilePath The OCIO config file, or empty for the OIIO default config
+ * @return The processor, null if the conversion is not supported by the config
+ */
+oiio::ColorProcessorHandle getColorProcessor(const std::string& fromColorSpaceName,
+                                             const std::string& toColorSpaceName,
+                                             const std::string& colorConfigFilePath = "");
+
 }  // namespace image
 }  // namespace aliceVision
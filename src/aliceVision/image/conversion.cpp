@@ -0,0 +1,87 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "conversion.hpp"
+
+#include <aliceVision/system/cpu.hpp>
+
+#include <cstddef>
+
+#if defined(ALICEVISION_SIMD_X86)
+    #include <immintrin.h>
+#endif
+
+namespace aliceVision {
+namespace image {
+
+namespace {
+
+/// Conversion of interleaved float RGB pixels to grayscale
+using RgbToGrayKernel = void(const float* rgb, std::size_t nbPixels, float* gray);
+
+void rgbToGrayGeneric(const float* rgb, std::size_t nbPixels, float* gray)
+{
+    for (std::size_t i = 0; i < nbPixels; ++i)
+        gray[i] = Rgb2GrayLinear(rgb[3 * i], rgb[3 * i + 1], rgb[3 * i + 2]);
+}
+
+#if defined(ALICEVISION_SIMD_X86)
+
+ALICEVISION_TARGET_AVX2 void rgbToGrayAvx2(const float* rgb, std::size_t nbPixels, float* gray)
+{
+    const __m256 weightR = _mm256_set1_ps(0.2126f);
+    const __m256 weightG = _mm256_set1_ps(0.7152f);
+    const __m256 weightB = _mm256_set1_ps(0.0722f);
+    // lanes order of the channels after the blends, see below
+    const __m256i permuteR = _mm256_setr_epi32(0, 3, 6, 1, 4, 7, 2, 5);
+    const __m256i permuteG = _mm256_setr_epi32(1, 4, 7, 2, 5, 0, 3, 6);
+    const __m256i permuteB = _mm256_setr_epi32(2, 5, 0, 3, 6, 1, 4, 7);
+
+    std::size_t i = 0;
+    for (; i + 8 <= nbPixels; i += 8)
+    {
+        // 8 pixels: r0 g0 b0 r1 g1 b1 r2 g2 | b2 r3 g3 b3 r4 g4 b4 r5 | g5 b5 r6 g6 b6 r7 g7 b7
+        const __m256 v0 = _mm256_loadu_ps(rgb + 3 * i);
+        const __m256 v1 = _mm256_loadu_ps(rgb + 3 * i + 8);
+        const __m256 v2 = _mm256_loadu_ps(rgb + 3 * i + 16);
+
+        // gather each channel in a register (each channel value is at a different lane in the 3 loads),
+        // then restore the pixels order
+        const __m256 r = _mm256_permutevar8x32_ps(_mm256_blend_ps(_mm256_blend_ps(v0, v1, 0x92), v2, 0x24), permuteR);
+        const __m256 g = _mm256_permutevar8x32_ps(_mm256_blend_ps(_mm256_blend_ps(v0, v1, 0x24), v2, 0x49), permuteG);
+        const __m256 b = _mm256_permutevar8x32_ps(_mm256_blend_ps(_mm256_blend_ps(v0, v1, 0x49), v2, 0x92), permuteB);
+
+        const __m256 result = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(r, weightR), _mm256_mul_ps(g, weightG)), _mm256_mul_ps(b, weightB));
+        _mm256_storeu_ps(gray + i, result);
+    }
+    rgbToGrayGeneric(rgb + 3 * i, nbPixels - i, gray + i);
+}
+
+#endif  // ALICEVISION_SIMD_X86
+
+RgbToGrayKernel* selectRgbToGray(system::ESimdLevel simdLevel)
+{
+#if defined(ALICEVISION_SIMD_X86)
+    // the conversion is limited by the memory bandwidth beyond AVX2
+    return system::selectSimdImplementation<RgbToGrayKernel>(simdLevel, &rgbToGrayGeneric, nullptr, &rgbToGrayAvx2, nullptr);
+#else
+    return &rgbToGrayGeneric;
+#endif
+}
+
+}  // namespace
+
+void ConvertPixelType(const Image<RGBfColor>& imaIn, Image<float>* imaOut)
+{
+    static RgbToGrayKernel* const rgbToGray = selectRgbToGray(system::getSimdLevel());
+
+    (*imaOut) = Image<float>(imaIn.width(), imaIn.height());
+    // the pixels of both images are contiguous (row major, 3 floats per RGB pixel)
+    rgbToGray(reinterpret_cast<const float*>(imaIn.data()), static_cast<std::size_t>(imaIn.width()) * imaIn.height(), imaOut->data());
+}
+
+}  // namespace image
+}  // namespace aliceVision
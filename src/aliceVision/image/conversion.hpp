@@ -111,6 +111,13 @@ void ConvertPixelType(const ImageIn& imaIn, ImageOut* imaOut)
             Convert(imaIn(j, i), (*imaOut)(j, i));
 }
 
+/**
+ * @brief Convert a float RGB image to grayscale (see Rgb2GrayLinear), with the SIMD instructions of the CPU.
+ * @param[in] imaIn the RGB image
+ * @param[out] imaOut the grayscale image
+ */
+void ConvertPixelType(const Image<RGBfColor>& imaIn, Image<float>* imaOut);
+
 //--------------------------------------------------------------------------
 // RGB ( unsigned char or int ) to Float
 //--------------------------------------------------------------------------
@@ -7,9 +7,123 @@
 
 #include "convolution.hpp"
 
+#include <aliceVision/system/cpu.hpp>
+
+#include <vector>
+
+#if defined(ALICEVISION_SIMD_X86)
+    #include <immintrin.h>
+#endif
+
 namespace aliceVision {
 namespace image {
 
+namespace {
+
+/// Weighted sum of rows: out[x] = sum_k weights[k] * rows[k][x], for x in [0, width)
+using WeightedSumKernel = void(const float* const* rows, const float* weights, int nbRows, int width, float* out);
+
+void weightedSumGeneric(const float* const* rows, const float* weights, int nbRows, int width, float* out)
+{
+    // Eigen vectorizes for the build target
+    Eigen::Map<Eigen::RowVectorXf> outRow(out, width);
+    outRow = weights[0] * Eigen::Map<const Eigen::RowVectorXf>(rows[0], width);
+    for (int k = 1; k < nbRows; ++k)
+        outRow += weights[k] * Eigen::Map<const Eigen::RowVectorXf>(rows[k], width);
+}
+
+#if defined(ALICEVISION_SIMD_X86)
+
+// The SIMD versions accumulate a block of outputs in registers over all the rows,
+// instead of reading and writing the whole output row for each row.
+
+ALICEVISION_TARGET_AVX2 void weightedSumAvx2(const float* const* rows, const float* weights, int nbRows, int width, float* out)
+{
+    int x = 0;
+    for (; x + 32 <= width; x += 32)
+    {
+        __m256 sum0 = _mm256_setzero_ps();
+        __m256 sum1 = _mm256_setzero_ps();
+        __m256 sum2 = _mm256_setzero_ps();
+        __m256 sum3 = _mm256_setzero_ps();
+        for (int k = 0; k < nbRows; ++k)
+        {
+            const __m256 weight = _mm256_set1_ps(weights[k]);
+            const float* row = rows[k] + x;
+            sum0 = _mm256_fmadd_ps(weight, _mm256_loadu_ps(row), sum0);
+            sum1 = _mm256_fmadd_ps(weight, _mm256_loadu_ps(row + 8), sum1);
+            sum2 = _mm256_fmadd_ps(weight, _mm256_loadu_ps(row + 16), sum2);
+            sum3 = _mm256_fmadd_ps(weight, _mm256_loadu_ps(row + 24), sum3);
+        }
+        _mm256_storeu_ps(out + x, sum0);
+        _mm256_storeu_ps(out + x + 8, sum1);
+        _mm256_storeu_ps(out + x + 16, sum2);
+        _mm256_storeu_ps(out + x + 24, sum3);
+    }
+    for (; x + 8 <= width; x += 8)
+    {
+        __m256 sum = _mm256_setzero_ps();
+        for (int k = 0; k < nbRows; ++k)
+            sum = _mm256_fmadd_ps(_mm256_set1_ps(weights[k]), _mm256_loadu_ps(rows[k] + x), sum);
+        _mm256_storeu_ps(out + x, sum);
+    }
+    for (; x < width; ++x)
+    {
+        float sum = 0.f;
+        for (int k = 0; k < nbRows; ++k)
+            sum += weights[k] * rows[k][x];
+        out[x] = sum;
+    }
+}
+
+ALICEVISION_TARGET_AVX512 void weightedSumAvx512(const float* const* rows, const float* weights, int nbRows, int width, float* out)
+{
+    int x = 0;
+    for (; x + 64 <= width; x += 64)
+    {
+        __m512 sum0 = _mm512_setzero_ps();
+        __m512 sum1 = _mm512_setzero_ps();
+        __m512 sum2 = _mm512_setzero_ps();
+        __m512 sum3 = _mm512_setzero_ps();
+        for (int k = 0; k < nbRows; ++k)
+        {
+            const __m512 weight = _mm512_set1_ps(weights[k]);
+            const float* row = rows[k] + x;
+            sum0 = _mm512_fmadd_ps(weight, _mm512_loadu_ps(row), sum0);
+            sum1 = _mm512_fmadd_ps(weight, _mm512_loadu_ps(row + 16), sum1);
+            sum2 = _mm512_fmadd_ps(weight, _mm512_loadu_ps(row + 32), sum2);
+            sum3 = _mm512_fmadd_ps(weight, _mm512_loadu_ps(row + 48), sum3);
+        }
+        _mm512_storeu_ps(out + x, sum0);
+        _mm512_storeu_ps(out + x + 16, sum1);
+        _mm512_storeu_ps(out + x + 32, sum2);
+        _mm512_storeu_ps(out + x + 48, sum3);
+    }
+    // the last 0-63 outputs, with masked loads and stores
+    for (; x < width; x += 16)
+    {
+        const __mmask16 mask = (width - x >= 16) ? __mmask16(0xFFFF) : __mmask16((1u << (width - x)) - 1);
+        __m512 sum = _mm512_setzero_ps();
+        for (int k = 0; k < nbRows; ++k)
+            sum = _mm512_fmadd_ps(_mm512_set1_ps(weights[k]), _mm512_maskz_loadu_ps(mask, rows[k] + x), sum);
+        _mm512_mask_storeu_ps(out + x, mask, sum);
+    }
+}
+
+#endif  // ALICEVISION_SIMD_X86
+
+WeightedSumKernel* selectWeightedSum(system::ESimdLevel simdLevel)
+{
+#if defined(ALICEVISION_SIMD_X86)
+    // SSE2 is the baseline of Eigen on x86-64
+    return system::selectSimdImplementation<WeightedSumKernel>(simdLevel, &weightedSumGeneric, nullptr, &weightedSumAvx2, &weightedSumAvx512);
+#else
+    return &weightedSumGeneric;
+#endif
+}
+
+}  // namespace
+
 void separableConvolution2d(const RowMatrixXf& image,
                             const Eigen::Matrix<float, 1, Eigen::Dynamic>& kernelX,
                             const Eigen::Matrix<float, 1, Eigen::Dynamic>& kernelY,
@@ -36,11 +150,17 @@ void separableConvolution2d(const RowMatrixXf& image,
                                          reverseKernelY.head(reverseSize) * image.block(image.rows() - reverseSize - 1, 0, reverseSize, image.cols());
     }
 
-// Applying the rest of the y filter.
-#pragma omp parallel for schedule(dynamic)
+    static WeightedSumKernel* const weightedSum = selectWeightedSum(system::getSimdLevel());
+
+    // Applying the rest of the y filter.
+    std::vector<const float*> rows(sigmaY);
+
+#pragma omp parallel for firstprivate(rows), schedule(dynamic)
     for (int row = halfSigmaY; row < image.rows() - halfSigmaY; row++)
     {
-        out->row(row) = kernelY * image.block(row - halfSigmaY, 0, sigmaY, out->cols());
+        for (int k = 0; k < sigmaY; ++k)
+            rows[k] = image.row(row - halfSigmaY + k).data();
+        weightedSum(rows.data(), kernelY.data(), sigmaY, static_cast<int>(out->cols()), out->row(row).data());
     }
 
     const int sigmaX = static_cast<int>(kernelX.cols());
@@ -52,20 +172,20 @@ void separableConvolution2d(const RowMatrixXf& image,
     // to end up with the correct convolved values.
     Eigen::RowVectorXf tempRow(image.cols() + sigmaX - 1);
 
-#pragma omp parallel for firstprivate(tempRow), schedule(dynamic)
+    // The shifted row segments are the rows of the weighted sum
+    std::vector<const float*> segments(sigmaX);
+
+#pragma omp parallel for firstprivate(tempRow, segments), schedule(dynamic)
     for (int row = 0; row < out->rows(); row++)
     {
         tempRow.head(halfSigmaX) = out->row(row).segment(1, halfSigmaX).reverse();
         tempRow.segment(halfSigmaX, image.cols()) = out->row(row);
         tempRow.tail(halfSigmaX) = out->row(row).segment(image.cols() - 2 - halfSigmaX, halfSigmaX).reverse();
 
-        // Convolve the row. We perform the first step here explicitly so that we
-        // avoid setting the row equal to zero.
-        out->row(row) = kernelX(0) * tempRow.head(image.cols());
-        for (int i = 1; i < sigmaX; i++)
-        {
-            out->row(row) += kernelX(i) * tempRow.segment(i, image.cols());
-        }
+        // Convolve the row.
+        for (int i = 0; i < sigmaX; i++)
+            segments[i] = tempRow.data() + i;
+        weightedSum(segments.data(), kernelX.data(), sigmaX, static_cast<int>(image.cols()), out->row(row).data());
     }
 }
 
@@ -0,0 +1,101 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/image/Image.hpp>
+#include <aliceVision/image/convolution.hpp>
+#include <aliceVision/image/filtering.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+using namespace aliceVision;
+using namespace aliceVision::image;
+
+namespace {
+
+template<typename T>
+Image<T> randomImage(int width, int height)
+{
+    std::mt19937 generator(0);
+    std::uniform_int_distribution<int> distribution(0, 255);
+    Image<T> image(width, height);
+    for (int y = 0; y < height; ++y)
+        for (int x = 0; x < width; ++x)
+            image(y, x) = static_cast<T>(distribution(generator));
+    return image;
+}
+
+/**
+ * @brief Separable gaussian convolution of a full HD image (e.g. a scale space level).
+ * @param state range(0): gaussian sigma
+ */
+template<typename T>
+void BM_imageSeparableConvolution(benchmark::State& state)
+{
+    const Image<T> image = randomImage<T>(1920, 1080);
+    const Vec kernel = computeGaussianKernel(0, static_cast<double>(state.range(0)));
+    Image<T> out;
+
+    for (auto _ : state)
+    {
+        imageSeparableConvolution(image, kernel, kernel, out);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * image.width() * image.height());
+}
+
+/**
+ * @brief Horizontal convolution only (contiguous memory accesses).
+ */
+template<typename T>
+void BM_imageHorizontalConvolution(benchmark::State& state)
+{
+    const Image<T> image = randomImage<T>(1920, 1080);
+    const Vec kernel = computeGaussianKernel(0, static_cast<double>(state.range(0)));
+    const Eigen::Matrix<typename Accumulator<T>::Type, Eigen::Dynamic, 1> kernelCast = kernel.cast<typename Accumulator<T>::Type>();
+    Image<T> out;
+
+    for (auto _ : state)
+    {
+        imageHorizontalConvolution(image, kernelCast, out);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * image.width() * image.height());
+}
+
+/**
+ * @brief Vertical convolution only (strided memory accesses).
+ */
+template<typename T>
+void BM_imageVerticalConvolution(benchmark::State& state)
+{
+    const Image<T> image = randomImage<T>(1920, 1080);
+    const Vec kernel = computeGaussianKernel(0, static_cast<double>(state.range(0)));
+    const Eigen::Matrix<typename Accumulator<T>::Type, Eigen::Dynamic, 1> kernelCast = kernel.cast<typename Accumulator<T>::Type>();
+    Image<T> out;
+
+    for (auto _ : state)
+    {
+        imageVerticalConvolution(image, kernelCast, out);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * image.width() * image.height());
+}
+
+}  // namespace
+
+// float images use the Eigen based separableConvolution2d specialization
+BENCHMARK_TEMPLATE(BM_imageSeparableConvolution, float)->Arg(1)->Arg(4)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_imageSeparableConvolution, unsigned char)->Arg(1)->Arg(4)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_imageHorizontalConvolution, float)->Arg(1)->Arg(4)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_imageVerticalConvolution, float)->Arg(1)->Arg(4)->Unit(benchmark::kMillisecond);
@@ -19,6 +19,45 @@ namespace image {
 using aliceVision::clamp;
 namespace fs = std::filesystem;
 
+namespace {
+
+/**
+ * @brief Apply a function on the three first channels of each pixel of an image buffer, in parallel.
+ *        The pixels of the float buffers held in memory are accessed in place, the others through getpixel/setpixel.
+ */
+template<typename RGBFunction>
+void forEachRGB(OIIO::ImageBuf& image, RGBFunction function)
+{
+    const OIIO::ImageSpec& spec = image.spec();
+
+    if (image.localpixels() != nullptr && spec.format == OIIO::TypeDesc::FLOAT && spec.nchannels >= 3)
+    {
+        const int nchannels = spec.nchannels;
+#pragma omp parallel for
+        for (int i = 0; i < spec.height; ++i)
+        {
+            float* row = static_cast<float*>(image.pixeladdr(spec.x, spec.y + i));
+            for (int j = 0; j < spec.width; ++j)
+            {
+                function(row + j * nchannels);
+            }
+        }
+        return;
+    }
+
+#pragma omp parallel for
+    for (int i = 0; i < spec.height; ++i)
+        for (int j = 0; j < spec.width; ++j)
+        {
+            float rgb[3];
+            image.getpixel(j, i, rgb, 3);
+            function(rgb);
+            image.setpixel(j, i, rgb, 3);
+        }
+}
+
+}  // namespace
+
 double calibrationIlluminantToTemperature(const LightSource light)
 {
     // These temperatures are those found in DNG SDK reference code
@@ -1349,23 +1388,17 @@ void DCPProfile::apply(OIIO::ImageBuf& image, const DCPProfileApplyParams& param
     }
 
     // Apply DCP profile
-#pragma omp parallel for
-    for (int i = 0; i < image.spec().height; ++i)
-        for (int j = 0; j < image.spec().width; ++j)
+    forEachRGB(image, [&](float* rgb) {
+        for (int c = 0; c < 3; ++c)
         {
-            float rgb[3];
-            image.getpixel(j, i, rgb, 3);
-            for (int c = 0; c < 3; ++c)
-            {
-                rgb[c] *= 65535.0;
-            }
-            apply(rgb, params);
-            for (int c = 0; c < 3; ++c)
-            {
-                rgb[c] /= 65535.0;
-            }
-            image.setpixel(j, i, rgb, 3);
+            rgb[c] *= 65535.0;
         }
+        apply(rgb, params);
+        for (int c = 0; c < 3; ++c)
+        {
+            rgb[c] /= 65535.0;
+        }
+    });
 }
 
 void DCPProfile::apply(float* rgb, const DCPProfileApplyParams& params) const
@@ -2309,24 +2342,21 @@ void DCPProfile::applyLinear(OIIO::ImageBuf& image, const Triple& neutral, doubl
 
     ALICEVISION_LOG_INFO("cameraToACES2065Matrix: " << cameraToACES2065Matrix);
 
-#pragma omp parallel for
-    for (int i = 0; i < image.spec().height; ++i)
-        for (int j = 0; j < image.spec().width; ++j)
+    forEachRGB(image, [&](float* rgb) {
+        float rgbOut[3];
+        for (int r = 0; r < 3; ++r)
         {
-            float rgb[3];
-            image.getpixel(j, i, rgb, 3);
-
-            float rgbOut[3];
-            for (int r = 0; r < 3; ++r)
+            rgbOut[r] = 0.0;
+            for (int c = 0; c < 3; ++c)
             {
-                rgbOut[r] = 0.0;
-                for (int c = 0; c < 3; ++c)
-                {
-                    rgbOut[r] += cameraToACES2065Matrix[r][c] * rgb[c];
-                }
+                rgbOut[r] += cameraToACES2065Matrix[r][c] * rgb[c];
             }
-            image.setpixel(j, i, rgbOut, 3);
         }
+        for (int c = 0; c < 3; ++c)
+        {
+            rgb[c] = rgbOut[c];
+        }
+    });
 }
 
 void DCPProfile::applyLinear(Image<image::RGBAfColor>& image,
@@ -2427,7 +2457,7 @@ bool DCPDatabase::retrieveDcpForCamera(const std::string& make, const std::strin
 
         if (it != dcpFilenamesList.end())
         {
-            dcpProf.Load(*it);
+            dcpProf = *DCPProfileCache::get().getProfile(*it);
             dcpStore.insert(std::pair<std::string, image::DCPProfile>(dcpKey, dcpProf));
             return true;
         }
@@ -2457,5 +2487,33 @@ void DCPDatabase::add_or_replace(DCPProfile& dcpProf, const std::string& make, c
     }
 }
 
+DCPProfileCache& DCPProfileCache::get()
+{
+    static DCPProfileCache cache;
+    return cache;
+}
+
+std::shared_ptr<const DCPProfile> DCPProfileCache::getProfile(const std::string& filename)
+{
+    std::shared_ptr<Entry> entry;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        std::shared_ptr<Entry>& cached = _entries[filename];
+        if (!cached)
+            cached = std::make_shared<Entry>();
+        entry = cached;
+    }
+
+    std::call_once(entry->loaded, [&]() { entry->profile = std::make_shared<const DCPProfile>(filename); });
+
+    return entry->profile;
+}
+
+void DCPProfileCache::clear()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _entries.clear();
+}
+
 }  // namespace image
 }  // namespace aliceVision
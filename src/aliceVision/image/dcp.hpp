@@ -4,6 +4,7 @@
 #include <vector>
 #include <array>
 #include <memory>
+#include <mutex>
 #include <string>
 
 #include <OpenImageIO/imagebuf.h>
@@ -363,5 +364,39 @@ class DCPDatabase final
     std::map<std::string, DCPProfile> dcpStore;
 };
 
+/**
+ * @brief Process-wide cache of the DCP profiles loaded from disk, each file is parsed once.
+ */
+class DCPProfileCache final
+{
+  public:
+    static DCPProfileCache& get();
+
+    /**
+     * @brief Get the profile of a DCP file, loading it at the first request.
+     * @note Concurrent requests of the same file wait for a single load.
+     * param[in] filename The dcp path on disk
+     * return The profile
+     */
+    std::shared_ptr<const DCPProfile> getProfile(const std::string& filename);
+
+    /**
+     * @brief Release all the cached profiles.
+     */
+    void clear();
+
+  private:
+    DCPProfileCache() = default;
+
+    struct Entry
+    {
+        std::once_flag loaded;
+        std::shared_ptr<const DCPProfile> profile;
+    };
+
+    std::mutex _mutex;
+    std::map<std::string, std::shared_ptr<Entry>> _entries;
+};
+
 }  // namespace image
 }  // namespace aliceVision
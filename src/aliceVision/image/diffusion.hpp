@@ -50,38 +50,42 @@ void imagePeronaMalikG2DiffusionCoef(const Image& Lx, const Image& Ly, const typ
 ** @param out Output image
 ** @param row_start Row range beginning (range is [row_start ; row_end [ )
 ** @param row_end Row range end (range is [row_start ; row_end [ )
+** @param src_weight 1 to add the source to the diffusion step (ie compute the evolved image), 0 for the step only
 **/
 template<typename Image>
-void imageFEDCentral(const Image& src, const Image& diff, const typename Image::Tpixel half_t, Image& out, const int row_start, const int row_end)
+void imageFEDCentral(const Image& src,
+                     const Image& diff,
+                     const typename Image::Tpixel half_t,
+                     Image& out,
+                     const int row_start,
+                     const int row_end,
+                     const typename Image::Tpixel src_weight = 0)
 {
     typedef typename Image::Tpixel Real;
     const int width = src.width();
-    Real n_diff[4];
-    Real n_src[4];
     // Compute FED step on general range
     for (int i = row_start; i < row_end; ++i)
     {
+        // the images are stored by rows: contiguous accesses, so that the loop over the columns can be vectorized
+        const Real* src_prev = &src(i - 1, 0);
+        const Real* src_cur = &src(i, 0);
+        const Real* src_next = &src(i + 1, 0);
+        const Real* diff_prev = &diff(i - 1, 0);
+        const Real* diff_cur = &diff(i, 0);
+        const Real* diff_next = &diff(i + 1, 0);
+        Real* out_cur = &out(i, 0);
+
         for (int j = 1; j < width - 1; ++j)
         {
-            // Retrieve neighbors : TODO check if we need a cache efficient version ?
-            n_diff[0] = diff(i, j + 1);
-            n_diff[1] = diff(i - 1, j);
-            n_diff[2] = diff(i, j - 1);
-            n_diff[3] = diff(i + 1, j);
-            n_src[0] = src(i, j + 1);
-            n_src[1] = src(i - 1, j);
-            n_src[2] = src(i, j - 1);
-            n_src[3] = src(i + 1, j);
-
             // Compute diffusion factor for given pixel
-            const Real cur_src = src(i, j);
-            const Real cur_diff = diff(i, j);
-            const Real a = (cur_diff + n_diff[0]) * (n_src[0] - cur_src);
-            const Real b = (cur_diff + n_diff[1]) * (cur_src - n_src[1]);
-            const Real c = (cur_diff + n_diff[2]) * (cur_src - n_src[2]);
-            const Real d = (cur_diff + n_diff[3]) * (n_src[3] - cur_src);
+            const Real cur_src = src_cur[j];
+            const Real cur_diff = diff_cur[j];
+            const Real a = (cur_diff + diff_cur[j + 1]) * (src_cur[j + 1] - cur_src);
+            const Real b = (cur_diff + diff_prev[j]) * (cur_src - src_prev[j]);
+            const Real c = (cur_diff + diff_cur[j - 1]) * (cur_src - src_cur[j - 1]);
+            const Real d = (cur_diff + diff_next[j]) * (src_next[j] - cur_src);
             const Real value = half_t * (a - c + d - b);
-            out(i, j) = value;
+            out_cur[j] = src_weight * cur_src + value;
         }
     }
 }
@@ -92,9 +96,14 @@ void imageFEDCentral(const Image& src, const Image& diff, const typename Image::
 ** @param diff diffusion coefficient image
 ** @param half_t Half diffusion time
 ** @param out Output image
+** @param src_weight 1 to add the source to the diffusion step (ie compute the evolved image), 0 for the step only
 **/
 template<typename Image>
-void imageFEDCentralCPPThread(const Image& src, const Image& diff, const typename Image::Tpixel half_t, Image& out)
+void imageFEDCentralCPPThread(const Image& src,
+                              const Image& diff,
+                              const typename Image::Tpixel half_t,
+                              Image& out,
+                              const typename Image::Tpixel src_weight = 0)
 {
     const int nb_thread = omp_get_max_threads();
 
@@ -105,7 +114,7 @@ void imageFEDCentralCPPThread(const Image& src, const Image& diff, const typenam
 #pragma omp parallel for schedule(dynamic)
     for (int i = 1; i < static_cast<int>(range.size()); ++i)
     {
-        imageFEDCentral(src, diff, half_t, out, range[i - 1], range[i]);
+        imageFEDCentral(src, diff, half_t, out, range[i - 1], range[i], src_weight);
     }
 }
 
@@ -115,9 +124,10 @@ void imageFEDCentralCPPThread(const Image& src, const Image& diff, const typenam
 ** @param diff diffusion coefficient image
 ** @param t diffusion time
 ** @param out output image
+** @param src_weight 1 to add the source to the diffusion step (ie compute the evolved image), 0 for the step only
 **/
 template<typename Image>
-void imageFED(const Image& src, const Image& diff, const typename Image::Tpixel t, Image& out)
+void imageFED(const Image& src, const Image& diff, const typename Image::Tpixel t, Image& out, const typename Image::Tpixel src_weight = 0)
 {
     typedef typename Image::Tpixel Real;
     const int width = src.width();
@@ -131,7 +141,7 @@ void imageFED(const Image& src, const Image& diff, const typename Image::Tpixel
     Real n_src[4];
 
     // Take care of the central part
-    imageFEDCentralCPPThread(src, diff, half_t, out);
+    imageFEDCentralCPPThread(src, diff, half_t, out, src_weight);
 
     // Take care of the border
     // - first/last row
@@ -154,7 +164,7 @@ void imageFED(const Image& src, const Image& diff, const typename Image::Tpixel
         const Real c = (cur_diff + n_diff[2]) * (cur_src - n_src[2]);
         const Real d = (cur_diff + n_diff[3]) * (n_src[3] - cur_src);
         const Real value = half_t * (a - c + d);
-        out(0, j) = value;
+        out(0, j) = src_weight * cur_src + value;
     }
 
     // Compute FED step on last row
@@ -174,7 +184,7 @@ void imageFED(const Image& src, const Image& diff, const typename Image::Tpixel
         const Real b = (cur_diff + n_diff[1]) * (cur_src - n_src[1]);
         const Real c = (cur_diff + n_diff[2]) * (cur_src - n_src[2]);
         const Real value = half_t * (a - c - b);
-        out(height - 1, j) = value;
+        out(height - 1, j) = src_weight * cur_src + value;
     }
 
     // Compute FED step on first col
@@ -194,7 +204,7 @@ void imageFED(const Image& src, const Image& diff, const typename Image::Tpixel
         const Real b = (cur_diff + n_diff[1]) * (cur_src - n_src[1]);
         const Real d = (cur_diff + n_diff[3]) * (n_src[3] - cur_src);
         const Real value = half_t * (a + d - b);
-        out(i, 0) = value;
+        out(i, 0) = src_weight * cur_src + value;
     }
 
     // Compute FED step on last col
@@ -214,8 +224,14 @@ void imageFED(const Image& src, const Image& diff, const typename Image::Tpixel
         const Real c = (cur_diff + n_diff[2]) * (cur_src - n_src[2]);
         const Real d = (cur_diff + n_diff[3]) * (n_src[3] - cur_src);
         const Real value = half_t * (-c + d - b);
-        out(i, width - 1) = value;
+        out(i, width - 1) = src_weight * cur_src + value;
     }
+
+    // No diffusion step on the corners
+    out(0, 0) = src_weight * src(0, 0);
+    out(0, width - 1) = src_weight * src(0, width - 1);
+    out(height - 1, 0) = src_weight * src(height - 1, 0);
+    out(height - 1, width - 1) = src_weight * src(height - 1, width - 1);
 }
 
 /**
@@ -227,11 +243,13 @@ void imageFED(const Image& src, const Image& diff, const typename Image::Tpixel
 template<typename Image>
 void imageFEDCycle(Image& self, const Image& diff, const std::vector<typename Image::Tpixel>& tau)
 {
+    typedef typename Image::Tpixel Real;
     Image tmp;
     for (int i = 0; i < tau.size(); ++i)
     {
-        imageFED(self, diff, tau[i], tmp);
-        self.array() += tmp.array();
+        // compute the evolved image in a single pass, then swap the buffers
+        imageFED(self, diff, tau[i], tmp, static_cast<Real>(1));
+        self.swap(tmp);
     }
 }
 
@@ -8,6 +8,7 @@
 #include "aliceVision/image/all.hpp"
 
 #include <iostream>
+#include <random>
 
 #define BOOST_TEST_MODULE ImageFiltering
 
@@ -139,3 +140,73 @@ BOOST_AUTO_TEST_CASE(Image_Convolution_Sobel_X_Y)
     BOOST_CHECK_NO_THROW(
       writeImage("out_SobelY.png", outFilteredCast, image::ImageWriteOptions().toColorSpace(image::EImageColorSpace::NO_CONVERSION)));
 }
+
+BOOST_AUTO_TEST_CASE(Image_FEDCycle)
+{
+    Image<float> in(40, 30);
+    for (int j = 0; j < in.height(); ++j)
+        for (int i = 0; i < in.width(); ++i)
+            in(j, i) = static_cast<float>(rand() % 256) / 255.f;
+
+    Image<float> diff(in.width(), in.height());
+    diff.fill(0.5f);
+
+    std::vector<float> tau;
+    fedCycleTimings(2.f, 0.25f, tau);
+
+    // accumulate the diffusion steps
+    Image<float> expected = in;
+    Image<float> step;
+    for (const float t : tau)
+    {
+        imageFED(expected, diff, t, step);
+        expected.array() += step.array();
+    }
+
+    Image<float> evolved = in;
+    imageFEDCycle(evolved, diff, tau);
+
+    BOOST_CHECK_SMALL((evolved.array() - expected.array()).abs().maxCoeff(), 1e-6f);
+
+    // no diffusion on the corners
+    BOOST_CHECK_EQUAL(evolved(0, 0), in(0, 0));
+    BOOST_CHECK_EQUAL(evolved(in.height() - 1, in.width() - 1), in(in.height() - 1, in.width() - 1));
+
+    // a constant image is a steady state
+    Image<float> constant(in.width(), in.height(), true, 0.25f);
+    imageFEDCycle(constant, diff, tau);
+    BOOST_CHECK_SMALL((constant.array() - 0.25f).abs().maxCoeff(), 1e-6f);
+}
+
+BOOST_AUTO_TEST_CASE(Image_Convolution_Separable_Float)
+{
+    // The float separable convolution is vectorized with the SIMD instructions of the CPU
+    //  (ALICEVISION_SIMD_LEVEL to check the other levels): compare with the 2D convolution, away from the borders.
+    //  The widths leave outputs after the vectorized blocks.
+    for (const int width : {64, 101, 250})
+    {
+        Image<float> in(width, 67);
+        std::mt19937 generator(0);
+        std::uniform_real_distribution<float> distribution(0.f, 1.f);
+        for (int y = 0; y < in.height(); ++y)
+            for (int x = 0; x < in.width(); ++x)
+                in(y, x) = distribution(generator);
+
+        const Vec kernel = computeGaussianKernel(0, 2.0);
+        const int halfSize = static_cast<int>(kernel.size()) / 2;
+        Image<float> out;
+        imageSeparableConvolution(in, kernel, kernel, out);
+
+        BOOST_CHECK_EQUAL(out.width(), in.width());
+        BOOST_CHECK_EQUAL(out.height(), in.height());
+        for (int y = halfSize; y < in.height() - halfSize; ++y)
+            for (int x = halfSize; x < in.width() - halfSize; ++x)
+            {
+                double expected = 0.0;
+                for (int j = 0; j < kernel.size(); ++j)
+                    for (int i = 0; i < kernel.size(); ++i)
+                        expected += kernel(j) * kernel(i) * in(y - halfSize + j, x - halfSize + i);
+                BOOST_CHECK_SMALL(out(y, x) - expected, 1e-5);
+            }
+    }
+}
@@ -107,6 +107,24 @@ void processImage(oiio::ImageBuf& dst, const oiio::ImageBuf& src, std::function<
     processImage(dst, pixelFunc);
 }
 
+namespace {
+
+/**
+ * @brief Convert an image buffer in place between two OIIO color spaces, with the shared color processors.
+ */
+void colorconvertInPlace(oiio::ImageBuf& imgBuf, const std::string& fromColorSpaceOIIOName, const std::string& toColorSpaceOIIOName)
+{
+    const oiio::ColorProcessorHandle processor = image::getColorProcessor(fromColorSpaceOIIOName, toColorSpaceOIIOName);
+    oiio::ImageBufAlgo::colorconvert(imgBuf, imgBuf, processor.get(), true);
+}
+
+void colorconvertInPlace(oiio::ImageBuf& imgBuf, image::EImageColorSpace fromColorSpace, image::EImageColorSpace toColorSpace)
+{
+    colorconvertInPlace(imgBuf, image::EImageColorSpace_enumToOIIOString(fromColorSpace), image::EImageColorSpace_enumToOIIOString(toColorSpace));
+}
+
+}  // namespace
+
 void colorconvert(oiio::ImageBuf& imgBuf, const std::string& fromColorSpaceOIIOName, image::EImageColorSpace toColorSpace)
 {
     using image::EImageColorSpace;
@@ -121,13 +139,12 @@ void colorconvert(oiio::ImageBuf& imgBuf, const std::string& fromColorSpaceOIION
             // We don't know about OIIO format and OIIO does not know about the destination format.
             // Convert to LINEAR and then do conversion as usual (colorconvert will handle
             // formats unknown to OIIO)
-            oiio::ImageBufAlgo::colorconvert(
-              imgBuf, imgBuf, fromColorSpaceOIIOName, image::EImageColorSpace_enumToOIIOString(EImageColorSpace::LINEAR));
+            colorconvertInPlace(imgBuf, fromColorSpaceOIIOName, image::EImageColorSpace_enumToOIIOString(EImageColorSpace::LINEAR));
             colorconvert(imgBuf, EImageColorSpace::LINEAR, toColorSpace);
             return;
         }
         // We don't know about OIIO format, but OIIO knows about the destination format
-        oiio::ImageBufAlgo::colorconvert(imgBuf, imgBuf, fromColorSpaceOIIOName, image::EImageColorSpace_enumToOIIOString(toColorSpace));
+        colorconvertInPlace(imgBuf, fromColorSpaceOIIOName, image::EImageColorSpace_enumToOIIOString(toColorSpace));
     }
     else
     {
@@ -146,8 +163,7 @@ void colorconvert(oiio::ImageBuf& imgBuf, image::EImageColorSpace fromColorSpace
     else if (toColorSpace == EImageColorSpace::LINEAR)
     {
         if (fromColorSpace == EImageColorSpace::SRGB)
-            oiio::ImageBufAlgo::colorconvert(
-              imgBuf, imgBuf, EImageColorSpace_enumToOIIOString(EImageColorSpace::SRGB), EImageColorSpace_enumToOIIOString(EImageColorSpace::LINEAR));
+            colorconvertInPlace(imgBuf, EImageColorSpace::SRGB, EImageColorSpace::LINEAR);
         else if (fromColorSpace == EImageColorSpace::XYZ)
             processImage(imgBuf, &XYZtoRGB);
         else if (fromColorSpace == EImageColorSpace::LAB)
@@ -159,8 +175,7 @@ void colorconvert(oiio::ImageBuf& imgBuf, image::EImageColorSpace fromColorSpace
             processImage(imgBuf, &XYZtoRGB);
         else if (fromColorSpace == EImageColorSpace::LAB)
             processImage(imgBuf, &LABtoRGB);
-        oiio::ImageBufAlgo::colorconvert(
-          imgBuf, imgBuf, EImageColorSpace_enumToOIIOString(EImageColorSpace::LINEAR), EImageColorSpace_enumToOIIOString(EImageColorSpace::SRGB));
+        colorconvertInPlace(imgBuf, EImageColorSpace::LINEAR, EImageColorSpace::SRGB);
     }
     else if (toColorSpace == EImageColorSpace::XYZ)
     {
@@ -168,8 +183,7 @@ void colorconvert(oiio::ImageBuf& imgBuf, image::EImageColorSpace fromColorSpace
             processImage(imgBuf, &RGBtoXYZ);
         else if (fromColorSpace == EImageColorSpace::SRGB)
         {
-            oiio::ImageBufAlgo::colorconvert(
-              imgBuf, imgBuf, EImageColorSpace_enumToOIIOString(EImageColorSpace::SRGB), EImageColorSpace_enumToOIIOString(EImageColorSpace::LINEAR));
+            colorconvertInPlace(imgBuf, EImageColorSpace::SRGB, EImageColorSpace::LINEAR);
             processImage(imgBuf, &RGBtoXYZ);
         }
         else if (fromColorSpace == EImageColorSpace::LAB)
@@ -181,8 +195,7 @@ void colorconvert(oiio::ImageBuf& imgBuf, image::EImageColorSpace fromColorSpace
             processImage(imgBuf, &RGBtoLAB);
         else if (fromColorSpace == EImageColorSpace::SRGB)
         {
-            oiio::ImageBufAlgo::colorconvert(
-              imgBuf, imgBuf, EImageColorSpace_enumToOIIOString(EImageColorSpace::SRGB), EImageColorSpace_enumToOIIOString(EImageColorSpace::LINEAR));
+            colorconvertInPlace(imgBuf, EImageColorSpace::SRGB, EImageColorSpace::LINEAR);
             processImage(imgBuf, &RGBtoLAB);
         }
         else if (fromColorSpace == EImageColorSpace::XYZ)
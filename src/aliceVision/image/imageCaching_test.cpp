@@ -6,6 +6,9 @@
 
 #include "aliceVision/image/all.hpp"
 
+#include <thread>
+#include <vector>
+
 #define BOOST_TEST_MODULE imageCaching
 
 #include <boost/test/unit_test.hpp>
@@ -56,3 +59,64 @@ BOOST_AUTO_TEST_CASE(load_all_pixel_types)
     BOOST_CHECK_EQUAL(cache.info().nbImages, 6);
     BOOST_CHECK_EQUAL(cache.info().nbLoadFromDisk, 6);
 }
+
+BOOST_AUTO_TEST_CASE(load_image_concurrently)
+{
+    ImageCache cache(256, 1024, EImageColorSpace::LINEAR);
+    const std::string filename = std::string(THIS_SOURCE_DIR) + "/image_test/lena.png";
+
+    std::vector<std::shared_ptr<Image<RGBfColor>>> images(8);
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < images.size(); ++i)
+        threads.emplace_back([&, i]() { images[i] = cache.get<RGBfColor>(filename); });
+    for (std::thread& thread : threads)
+        thread.join();
+
+    for (const auto& img : images)
+        BOOST_CHECK_EQUAL(img, images.front());
+    BOOST_CHECK_EQUAL(cache.info().nbImages, 1);
+    BOOST_CHECK_EQUAL(cache.info().nbLoadFromDisk, 1);
+    BOOST_CHECK_EQUAL(cache.info().nbLoadFromCache, images.size() - 1);
+}
+
+BOOST_AUTO_TEST_CASE(load_image_async)
+{
+    ImageCache cache(256, 1024, EImageColorSpace::LINEAR, 2);
+    const std::string filename = std::string(THIS_SOURCE_DIR) + "/image_test/lena.png";
+
+    auto futureImg = cache.asyncGet<RGBAfColor>(filename);
+    cache.prefetch<float>({filename});
+
+    auto img = cache.get<RGBAfColor>(filename);
+    BOOST_CHECK_EQUAL(futureImg.get(), img);
+
+    auto imgFloat = cache.get<float>(filename);
+    BOOST_CHECK(imgFloat);
+    BOOST_CHECK_EQUAL(cache.info().nbImages, 2);
+    BOOST_CHECK_EQUAL(cache.info().nbLoadFromDisk, 2);
+
+    auto futureMissing = cache.asyncGet<float>(std::string(THIS_SOURCE_DIR) + "/image_test/missing.png");
+    BOOST_CHECK_THROW(futureMissing.get(), std::exception);
+}
+
+BOOST_AUTO_TEST_CASE(load_image_tiles)
+{
+    ImageCache cache(256, 1024, EImageColorSpace::LINEAR);
+    const std::string filename = std::string(THIS_SOURCE_DIR) + "/image_test/lena.png";
+    const int tileSize = 100;
+
+    auto img = cache.get<RGBfColor>(filename);
+    auto tile = cache.getTile<RGBfColor>(filename, 1, 2, tileSize);
+
+    BOOST_CHECK_EQUAL(tile->width(), std::min(tileSize, img->width() - tileSize));
+    BOOST_CHECK_EQUAL(tile->height(), std::min(tileSize, img->height() - 2 * tileSize));
+    for (int i = 0; i < tile->height(); ++i)
+        for (int j = 0; j < tile->width(); ++j)
+            BOOST_CHECK_EQUAL((*tile)(i, j), (*img)(2 * tileSize + i, tileSize + j));
+
+    // the tile is cached independently of the image
+    BOOST_CHECK_EQUAL(cache.getTile<RGBfColor>(filename, 1, 2, tileSize), tile);
+    BOOST_CHECK_EQUAL(cache.info().nbImages, 2);
+
+    BOOST_CHECK_THROW(cache.getTile<RGBfColor>(filename, 100, 0, tileSize), std::exception);
+}
@@ -85,4 +85,48 @@ BOOST_AUTO_TEST_CASE(Image_ImageConverter)
     Image<RGBAColor> imaColorRGBA(5, 5);
     imaColorRGBA.fill(RGBAColor(10, 10, 10, 255));
     ConvertPixelType(imaColorRGBA, &imaGray);
+
+    // float RGB to grayscale, vectorized: odd width so that the last pixels are converted separately
+    Image<RGBfColor> imaColorRGBf(13, 5);
+    for (int y = 0; y < imaColorRGBf.height(); ++y)
+        for (int x = 0; x < imaColorRGBf.width(); ++x)
+            imaColorRGBf(y, x) = RGBfColor(0.1f * x, 0.2f * y, 0.05f * (x + y));
+    Image<float> imaGrayf;
+    ConvertPixelType(imaColorRGBf, &imaGrayf);
+    BOOST_CHECK_EQUAL(imaGrayf.width(), imaColorRGBf.width());
+    BOOST_CHECK_EQUAL(imaGrayf.height(), imaColorRGBf.height());
+    for (int y = 0; y < imaColorRGBf.height(); ++y)
+        for (int x = 0; x < imaColorRGBf.width(); ++x)
+        {
+            const RGBfColor& color = imaColorRGBf(y, x);
+            BOOST_CHECK_SMALL(imaGrayf(y, x) - Rgb2GrayLinear(color.r(), color.g(), color.b()), 1e-6f);
+        }
+}
+
+BOOST_AUTO_TEST_CASE(Image_Pool)
+{
+    ImagePool<float> pool(1024 * sizeof(float));
+
+    Image<float> image = pool.acquire(16, 8, true, 1.f);
+    BOOST_CHECK_EQUAL(16, image.width());
+    BOOST_CHECK_EQUAL(8, image.height());
+    BOOST_CHECK_EQUAL(1.f, image(7, 15));
+    const float* data = image.data();
+
+    pool.release(image);
+    BOOST_CHECK_EQUAL(0, image.size());
+    BOOST_CHECK_EQUAL(16 * 8 * sizeof(float), pool.getFreeBytes());
+
+    // same number of pixels: the buffer is reused
+    Image<float> reused = pool.acquire(8, 16, true, 2.f);
+    BOOST_CHECK_EQUAL(data, reused.data());
+    BOOST_CHECK_EQUAL(8, reused.width());
+    BOOST_CHECK_EQUAL(2.f, reused(15, 7));
+    BOOST_CHECK_EQUAL(0, pool.getFreeBytes());
+
+    // above the pool capacity: the buffer is freed
+    Image<float> large = pool.acquire(64, 32);
+    pool.release(large);
+    BOOST_CHECK_EQUAL(0, large.size());
+    BOOST_CHECK_EQUAL(0, pool.getFreeBytes());
 }
@@ -26,6 +26,7 @@
 #include <stdexcept>
 #include <iostream>
 #include <cmath>
+#include <sstream>
 
 namespace aliceVision {
 namespace image {
@@ -412,6 +413,13 @@ bool isSupportedUndistortFormat(const std::string& ext)
     return (std::find(start, end, boost::to_lower_copy(ext)) != end);
 }
 
+std::string getDownscaledImagePath(const std::string& path, int downscale)
+{
+    const fs::path imagePath(path);
+    return (imagePath.parent_path() / (imagePath.stem().string() + "_downscale" + std::to_string(downscale) + imagePath.extension().string()))
+      .string();
+}
+
 std::string ERawColorInterpretation_informations()
 {
     return "Raw color interpretation :\n"
@@ -564,6 +572,286 @@ bool isRawFormat(const std::string& path)
     return (imgFormat.compare("raw") == 0);
 }
 
+/**
+ * @brief Check if a color conversion is needed from the given color space name to the working color space.
+ */
+bool needColorSpaceConversion(const std::string& fromColorSpaceName, EImageColorSpace workingColorSpace)
+{
+    return (workingColorSpace != EImageColorSpace::NO_CONVERSION) && (workingColorSpace != EImageColorSpace_stringToEnum(fromColorSpaceName));
+}
+
+/**
+ * @brief Convert an image buffer from the given color space name to the working color space.
+ *        The conversion is done in place, so the buffer can wrap the memory of an Image<T>.
+ */
+void convertColorSpaceInPlace(oiio::ImageBuf& buf, const std::string& fromColorSpaceName, EImageColorSpace workingColorSpace)
+{
+    if (!needColorSpaceConversion(fromColorSpaceName, workingColorSpace))
+    {
+        // Do nothing. Note that calling imageAlgo::colorconvert() will copy the source buffer
+        // even if no conversion is needed.
+        return;
+    }
+
+    if (EImageColorSpace_isSupportedOIIOEnum(workingColorSpace) && EImageColorSpace_isSupportedOIIOEnum(EImageColorSpace_stringToEnum(fromColorSpaceName)))
+    {
+        const auto colorConfigPath = getAliceVisionOCIOConfig();
+        if (colorConfigPath.empty())
+        {
+            throw std::runtime_error("ALICEVISION_ROOT is not defined, OCIO config file cannot be accessed.");
+        }
+        const oiio::ColorProcessorHandle processor =
+          getColorProcessor(fromColorSpaceName, EImageColorSpace_enumToOIIOString(workingColorSpace), colorConfigPath);
+        oiio::ImageBufAlgo::colorconvert(buf, buf, processor.get(), true);
+    }
+    else
+    {
+        const oiio::ColorProcessorHandle processor = getColorProcessor(fromColorSpaceName, EImageColorSpace_enumToOIIOString(workingColorSpace));
+        oiio::ImageBufAlgo::colorconvert(buf, buf, processor.get(), true);
+    }
+}
+
+/**
+ * @brief Get the region to read: the requested region of interest inside the image, or the whole image.
+ */
+oiio::ROI getReadROI(const oiio::ImageSpec& spec, const ImageReadOptions& imageReadOptions, const std::string& path)
+{
+    oiio::ROI roi = spec.roi();
+    if (imageReadOptions.subROI.defined())
+        roi = oiio::roi_intersection(imageReadOptions.subROI, roi);
+
+    if (roi.width() <= 0 || roi.height() <= 0)
+        ALICEVISION_THROW_ERROR("The region of interest " << imageReadOptions.subROI << " is outside of the image file: '" << path << "'.");
+
+    roi.zbegin = 0;
+    roi.zend = 1;
+    return roi;
+}
+
+/**
+ * @brief Decode only the tiles or the scanlines covering a region of an image.
+ *        The decoded rows are cropped in the output buffer, with a temporary buffer of the region rows (or tiles) only.
+ * @param[in] in the opened image input
+ * @param[in] spec the image spec (at the given mip level)
+ * @param[in] roi the region to decode, inside the image
+ * @param[in] mipLevel the mip level
+ * @param[in] nchannels the number of decoded channels
+ * @param[in] format the output pixel format
+ * @param[out] data the output buffer, of roi.width() * roi.height() pixels
+ * @param[in] path the image path, for the error messages
+ */
+void readRegion(oiio::ImageInput& in,
+                const oiio::ImageSpec& spec,
+                const oiio::ROI& roi,
+                int mipLevel,
+                int nchannels,
+                oiio::TypeDesc format,
+                void* data,
+                const std::string& path)
+{
+    const std::size_t pixelSize = nchannels * format.size();
+    const bool isTiled = (spec.tile_width > 0 && spec.tile_height > 0);
+
+    // whole scanlines: no crop needed
+    if (!isTiled && roi.xbegin == spec.x && roi.width() == spec.width)
+    {
+        if (!in.read_scanlines(0, mipLevel, roi.ybegin, roi.yend, spec.z, 0, nchannels, format, data))
+            ALICEVISION_THROW_ERROR("Failed to read the region " << roi << " of the image file: '" << path << "'. " << in.geterror());
+        return;
+    }
+
+    // decoded area: tiles aligned for tiled files, whole scanlines otherwise
+    int xbegin = spec.x;
+    int xend = spec.x + spec.width;
+    int ybegin = roi.ybegin;
+    int yend = roi.yend;
+
+    if (isTiled)
+    {
+        xbegin = spec.x + ((roi.xbegin - spec.x) / spec.tile_width) * spec.tile_width;
+        xend = std::min(spec.x + divideRoundUp(roi.xend - spec.x, spec.tile_width) * spec.tile_width, spec.x + spec.width);
+        ybegin = spec.y + ((roi.ybegin - spec.y) / spec.tile_height) * spec.tile_height;
+        yend = std::min(spec.y + divideRoundUp(roi.yend - spec.y, spec.tile_height) * spec.tile_height, spec.y + spec.height);
+    }
+
+    std::vector<unsigned char> buffer(static_cast<std::size_t>(xend - xbegin) * (yend - ybegin) * pixelSize);
+
+    const bool success = isTiled ? in.read_tiles(0, mipLevel, xbegin, xend, ybegin, yend, spec.z, spec.z + 1, 0, nchannels, format, buffer.data())
+                                 : in.read_scanlines(0, mipLevel, ybegin, yend, spec.z, 0, nchannels, format, buffer.data());
+    if (!success)
+        ALICEVISION_THROW_ERROR("Failed to read the region " << roi << " of the image file: '" << path << "'. " << in.geterror());
+
+    const std::size_t bufferRowSize = static_cast<std::size_t>(xend - xbegin) * pixelSize;
+    const std::size_t rowSize = static_cast<std::size_t>(roi.width()) * pixelSize;
+    for (int y = roi.ybegin; y < roi.yend; ++y)
+    {
+        const unsigned char* src = buffer.data() + (y - ybegin) * bufferRowSize + (roi.xbegin - xbegin) * pixelSize;
+        std::memcpy(static_cast<unsigned char*>(data) + (y - roi.ybegin) * rowSize, src, rowSize);
+    }
+}
+
+/**
+ * @brief Decode a non raw image directly in the Image<T> storage and convert its color space in place,
+ *        without any intermediate full resolution buffer.
+ *        It is only possible if the file channels can be read as is: same number of channels than requested,
+ *        or more channels without color conversion (the extra channels are not decoded).
+ * @return false if the generic read is needed (channels conversion, DCP profile from metadata, etc.), nothing is read in this case
+ */
+template<typename T>
+bool readImageInPlace(const std::string& path, oiio::TypeDesc format, int nchannels, Image<T>& image, const ImageReadOptions& imageReadOptions)
+{
+    // the generic read reports the errors
+    if (imageReadOptions.workingColorSpace == EImageColorSpace::AUTO)
+        return false;
+
+    std::unique_ptr<oiio::ImageInput> in(oiio::ImageInput::open(path));
+    if (!in)
+        return false;
+
+    if (imageReadOptions.mipLevel > 0 && !in->seek_subimage(0, imageReadOptions.mipLevel))
+        ALICEVISION_THROW_ERROR("The mip level " << imageReadOptions.mipLevel << " does not exist in the image file: '" << path << "'.");
+
+    const oiio::ImageSpec spec = in->spec();
+
+    // Get color space name. Default image color space is sRGB
+    const std::string ext = boost::to_lower_copy(fs::path(path).extension().string());
+    std::string fromColorSpaceName = (imageReadOptions.inputColorSpace == EImageColorSpace::AUTO)
+                                       ? getImageColorSpace(spec, ext == ".exr" ? "linear" : "sRGB", path)
+                                       : EImageColorSpace_enumToString(imageReadOptions.inputColorSpace);
+
+    const bool isGamma = (fromColorSpaceName.substr(0, 5) == "Gamma");
+    const std::string linearizedColorSpaceName = isGamma ? "linear" : fromColorSpaceName;
+
+    // DCP profile from the metadata
+    if ((linearizedColorSpaceName == "no_conversion") && (imageReadOptions.workingColorSpace != EImageColorSpace::NO_CONVERSION))
+        return false;
+
+    const bool needConversion = isGamma || needColorSpaceConversion(linearizedColorSpaceName, imageReadOptions.workingColorSpace);
+
+    // the color conversion is done in float, and with all the channels (alpha unpremultiply)
+    if (needConversion && (format != oiio::TypeDesc::FLOAT || spec.nchannels != nchannels))
+        return false;
+    if (spec.nchannels != nchannels && !(nchannels >= 3 && spec.nchannels > nchannels))
+        return false;
+
+    ALICEVISION_LOG_TRACE("Read image " << path << " in place (encoded in " << fromColorSpaceName << " colorspace).");
+
+    const oiio::ROI roi = getReadROI(spec, imageReadOptions, path);
+
+    image.resize(roi.width(), roi.height(), false);
+
+    if (roi.xbegin == spec.x && roi.ybegin == spec.y && roi.width() == spec.width && roi.height() == spec.height)
+    {
+        if (!in->read_image(0, imageReadOptions.mipLevel, 0, nchannels, format, image.data()))
+            ALICEVISION_THROW_ERROR("Failed to read the image file: '" << path << "'. " << in->geterror());
+    }
+    else
+    {
+        readRegion(*in, spec, roi, imageReadOptions.mipLevel, nchannels, format, image.data(), path);
+    }
+
+    if (needConversion)
+    {
+        // wrap the image storage
+        oiio::ImageBuf buf(oiio::ImageSpec(roi.width(), roi.height(), nchannels, format), image.data());
+
+        // Manage oiio GammaX.Y color space assuming that the gamma correction has been applied on an image with sRGB primaries.
+        if (isGamma)
+            oiio::ImageBufAlgo::pow(buf, buf, std::stof(fromColorSpaceName.substr(5)));
+
+        convertColorSpaceInPlace(buf, linearizedColorSpaceName, imageReadOptions.workingColorSpace);
+    }
+
+    return true;
+}
+
+namespace {
+
+/**
+ * @brief Get the key of a decoded raw image, from the file and the options that change the decoded pixels.
+ */
+std::string getRawCacheKey(const std::string& path, const ImageReadOptions& imageReadOptions)
+{
+    std::error_code ec;
+    const auto fileSize = fs::file_size(path, ec);
+    const auto lastWriteTime = fs::last_write_time(path, ec).time_since_epoch().count();
+
+    std::ostringstream key;
+    key << fs::absolute(path).generic_string() << ";" << fileSize << ";" << lastWriteTime << ";"
+        << ERawColorInterpretation_enumToString(imageReadOptions.rawColorInterpretation) << ";" << imageReadOptions.colorProfileFileName << ";"
+        << imageReadOptions.useDCPColorMatrixOnly << ";" << imageReadOptions.doWBAfterDemosaicing << ";" << imageReadOptions.demosaicingAlgo
+        << ";" << imageReadOptions.highlightMode << ";" << imageReadOptions.rawAutoBright << ";" << imageReadOptions.rawExposureAdjustment << ";"
+        << imageReadOptions.correlatedColorTemperature << ";" << imageReadOptions.mipLevel;
+    return key.str();
+}
+
+std::string getRawCachePath(const std::string& cacheFolder, const std::string& path, const std::string& key)
+{
+    std::ostringstream filename;
+    filename << fs::path(path).stem().string() << "_" << std::hex << std::hash<std::string>()(key) << ".exr";
+    return (fs::path(cacheFolder) / filename.str()).generic_string();
+}
+
+/**
+ * @brief Read a decoded raw image from the cache.
+ * @return false if the image is not in the cache
+ */
+bool readRawCache(const std::string& cachePath, const std::string& key, oiio::ImageBuf& buffer)
+{
+    if (!fs::exists(cachePath))
+        return false;
+
+    oiio::ImageBuf cached(cachePath);
+    if (!cached.read(0, 0, true, oiio::TypeDesc::FLOAT))
+    {
+        ALICEVISION_LOG_WARNING("Failed to read the cached raw image '" << cachePath << "': " << cached.geterror());
+        return false;
+    }
+
+    // the file name is only a hash of the key
+    if (cached.spec().get_string_attribute("AliceVision:rawCacheKey") != key)
+        return false;
+
+    ALICEVISION_LOG_TRACE("Read the decoded raw image from the cache '" << cachePath << "'.");
+    buffer.swap(cached);
+    return true;
+}
+
+/**
+ * @brief Store a decoded raw image in the cache.
+ *        The pixels of the buffer are rounded to the half float precision of the cache,
+ *        so that the decoded image is the same whether it comes from the cache or not.
+ */
+void writeRawCache(const std::string& cachePath, const std::string& key, oiio::ImageBuf& buffer)
+{
+    oiio::ImageBuf halfBuffer;
+    halfBuffer.copy(buffer, oiio::TypeDesc::HALF);
+    buffer.copy(halfBuffer, oiio::TypeDesc::FLOAT);
+
+    halfBuffer.specmod().attribute("AliceVision:rawCacheKey", key);
+    halfBuffer.specmod().attribute("compression", "zips");
+
+    std::error_code ec;
+    fs::create_directories(fs::path(cachePath).parent_path(), ec);
+
+    // write in a temporary file and rename it, for the concurrent reads and writes of other processes
+    const std::string tmpPath = cachePath + "." + utils::generateUniqueFilename() + ".exr";
+    if (!halfBuffer.write(tmpPath))
+    {
+        ALICEVISION_LOG_WARNING("Failed to write the decoded raw image in the cache '" << cachePath << "': " << halfBuffer.geterror());
+        fs::remove(tmpPath, ec);
+        return;
+    }
+    fs::rename(tmpPath, cachePath, ec);
+    if (ec)
+    {
+        ALICEVISION_LOG_WARNING("Failed to write the decoded raw image in the cache '" << cachePath << "': " << ec.message());
+        fs::remove(tmpPath, ec);
+    }
+}
+
+}  // namespace
+
 template<typename T>
 void readImage(const std::string& path, oiio::TypeDesc format, int nchannels, Image<T>& image, const ImageReadOptions& imageReadOptions)
 {
@@ -578,6 +866,10 @@ void readImage(const std::string& path, oiio::TypeDesc format, int nchannels, Im
     oiio::ImageSpec configSpec;
 
     const bool isRawImage = isRawFormat(path);
+
+    // fast path: decode directly in the image storage
+    if (!isRawImage && readImageInPlace(path, format, nchannels, image, imageReadOptions))
+        return;
     image::DCPProfile::Triple neutral = {1.0, 1.0, 1.0};
 
     if (isRawImage)
@@ -729,71 +1021,89 @@ void readImage(const std::string& path, oiio::TypeDesc format, int nchannels, Im
         }
     }
 
-    oiio::ImageBuf inBuf(path, 0, 0, NULL, &configSpec);
+    // the decoded raw images are shared through the raw cache folder, if any
+    const std::string rawCacheFolder = isRawImage ? getRawCacheFolder() : std::string();
+    const std::string rawCacheKey = rawCacheFolder.empty() ? std::string() : getRawCacheKey(path, imageReadOptions);
+    const std::string rawCachePath = rawCacheFolder.empty() ? std::string() : getRawCachePath(rawCacheFolder, path, rawCacheKey);
 
-    inBuf.read(0, 0, true, oiio::TypeDesc::FLOAT);  // force image convertion to float (for grayscale and color space convertion)
+    oiio::ImageBuf inBuf;
+    if (rawCachePath.empty() || !readRawCache(rawCachePath, rawCacheKey, inBuf))
+    {
+        inBuf.reset(path, 0, imageReadOptions.mipLevel, NULL, &configSpec);
 
-    if (!inBuf.initialized())
-        ALICEVISION_THROW_ERROR("Failed to open the image file: '" << path << "'. The file might not exist.");
+        // force image convertion to float (for grayscale and color space convertion)
+        inBuf.read(0, imageReadOptions.mipLevel, true, oiio::TypeDesc::FLOAT);
 
-    // check picture channels number
-    if (inBuf.spec().nchannels == 0)
-        ALICEVISION_THROW_ERROR("No channel in the input image file: '" + path + "'.");
-    if (inBuf.spec().nchannels == 2)
-        ALICEVISION_THROW_ERROR("Load of 2 channels is not supported. Image file: '" + path + "'.");
+        if (!inBuf.initialized())
+            ALICEVISION_THROW_ERROR("Failed to open the image file: '" << path << "'. The file might not exist.");
 
-    oiio::ParamValueList imgMetadata = readImageMetadata(path);
+        // check picture channels number
+        if (inBuf.spec().nchannels == 0)
+            ALICEVISION_THROW_ERROR("No channel in the input image file: '" + path + "'.");
+        if (inBuf.spec().nchannels == 2)
+            ALICEVISION_THROW_ERROR("Load of 2 channels is not supported. Image file: '" + path + "'.");
 
-    if (isRawImage)
-    {
-        // Check orientation metadata. If image is mirrored, mirror it back and update orientation metadata
-        int orientation = imgMetadata.get_int("orientation", -1);
+        oiio::ParamValueList imgMetadata = readImageMetadata(path);
 
-        if (orientation == 2 || orientation == 4 || orientation == 5 || orientation == 7)
+        if (isRawImage)
         {
-            // horizontal mirroring
-            oiio::ImageBuf inBufMirrored = oiio::ImageBufAlgo::flop(inBuf);
-            inBuf = inBufMirrored;
+            // Check orientation metadata. If image is mirrored, mirror it back and update orientation metadata
+            int orientation = imgMetadata.get_int("orientation", -1);
 
-            orientation += (orientation == 2 || orientation == 4) ? -1 : 1;
-        }
-    }
-
-    // Apply DCP profile
-    if (!imageReadOptions.colorProfileFileName.empty() && imageReadOptions.rawColorInterpretation == ERawColorInterpretation::DcpLinearProcessing)
-    {
-        image::DCPProfile dcpProfile(imageReadOptions.colorProfileFileName);
+            if (orientation == 2 || orientation == 4 || orientation == 5 || orientation == 7)
+            {
+                // horizontal mirroring
+                oiio::ImageBuf inBufMirrored = oiio::ImageBufAlgo::flop(inBuf);
+                inBuf = inBufMirrored;
 
-        // oiio::ParamValueList imgMetadata = readImageMetadata(path);
-        std::string cam_mul = "";
-        if (!imgMetadata.getattribute("raw:cam_mul", cam_mul))
-        {
-            cam_mul = "{1024, 1024, 1024, 1024}";
-            ALICEVISION_LOG_WARNING(
-              "[readImage]: cam_mul metadata not available, the openImageIO version might be too old (>= 2.4.5.0 requested for dcp management).");
+                orientation += (orientation == 2 || orientation == 4) ? -1 : 1;
+            }
         }
 
-        std::vector<float> v_mult;
-        size_t last = 1;
-        size_t next = 1;
-        while ((next = cam_mul.find(",", last)) != std::string::npos)
+        // Apply DCP profile
+        if (!imageReadOptions.colorProfileFileName.empty() &&
+            imageReadOptions.rawColorInterpretation == ERawColorInterpretation::DcpLinearProcessing)
         {
-            v_mult.push_back(std::stof(cam_mul.substr(last, next - last)));
-            last = next + 1;
-        }
-        v_mult.push_back(std::stof(cam_mul.substr(last, cam_mul.find("}", last) - last)));
+            // the profile file is parsed once and shared by all the images of the camera
+            const std::shared_ptr<const image::DCPProfile> dcpProfile =
+              image::DCPProfileCache::get().getProfile(imageReadOptions.colorProfileFileName);
 
-        image::DCPProfile::Triple neutral;
-        for (int i = 0; i < 3; i++)
-        {
-            neutral[i] = v_mult[i] / v_mult[1];
-        }
+            // oiio::ParamValueList imgMetadata = readImageMetadata(path);
+            std::string cam_mul = "";
+            if (!imgMetadata.getattribute("raw:cam_mul", cam_mul))
+            {
+                cam_mul = "{1024, 1024, 1024, 1024}";
+                ALICEVISION_LOG_WARNING(
+                  "[readImage]: cam_mul metadata not available, the openImageIO version might be too old (>= 2.4.5.0 requested for dcp management).");
+            }
 
-        ALICEVISION_LOG_TRACE("Apply DCP Linear processing with neutral = " << neutral);
+            std::vector<float> v_mult;
+            size_t last = 1;
+            size_t next = 1;
+            while ((next = cam_mul.find(",", last)) != std::string::npos)
+            {
+                v_mult.push_back(std::stof(cam_mul.substr(last, next - last)));
+                last = next + 1;
+            }
+            v_mult.push_back(std::stof(cam_mul.substr(last, cam_mul.find("}", last) - last)));
 
-        double cct = imageReadOptions.correlatedColorTemperature;
+            image::DCPProfile::Triple neutral;
+            for (int i = 0; i < 3; i++)
+            {
+                neutral[i] = v_mult[i] / v_mult[1];
+            }
+
+            ALICEVISION_LOG_TRACE("Apply DCP Linear processing with neutral = " << neutral);
+
+            double cct = imageReadOptions.correlatedColorTemperature;
 
-        dcpProfile.applyLinear(inBuf, neutral, cct, imageReadOptions.doWBAfterDemosaicing, imageReadOptions.useDCPColorMatrixOnly);
+            dcpProfile->applyLinear(inBuf, neutral, cct, imageReadOptions.doWBAfterDemosaicing, imageReadOptions.useDCPColorMatrixOnly);
+        }
+
+        if (!rawCachePath.empty())
+        {
+            writeRawCache(rawCachePath, rawCacheKey, inBuf);
+        }
     }
 
     // color conversion
@@ -860,39 +1170,7 @@ void readImage(const std::string& path, oiio::TypeDesc format, int nchannels, Im
         fromColorSpaceName = "aces2065-1";
     }
 
-    if ((imageReadOptions.workingColorSpace == EImageColorSpace::NO_CONVERSION) ||
-        (imageReadOptions.workingColorSpace == EImageColorSpace_stringToEnum(fromColorSpaceName)))
-    {
-        // Do nothing. Note that calling imageAlgo::colorconvert() will copy the source buffer
-        // even if no conversion is needed.
-    }
-    else if (EImageColorSpace_isSupportedOIIOEnum(imageReadOptions.workingColorSpace) &&
-             EImageColorSpace_isSupportedOIIOEnum(EImageColorSpace_stringToEnum(fromColorSpaceName)))
-    {
-        const auto colorConfigPath = getAliceVisionOCIOConfig();
-        if (colorConfigPath.empty())
-        {
-            throw std::runtime_error("ALICEVISION_ROOT is not defined, OCIO config file cannot be accessed.");
-        }
-        oiio::ImageBuf colorspaceBuf;
-        oiio::ColorConfig colorConfig(colorConfigPath);
-        oiio::ImageBufAlgo::colorconvert(colorspaceBuf,
-                                         inBuf,
-                                         fromColorSpaceName,
-                                         EImageColorSpace_enumToOIIOString(imageReadOptions.workingColorSpace),
-                                         true,
-                                         "",
-                                         "",
-                                         &colorConfig);
-        inBuf = colorspaceBuf;
-    }
-    else
-    {
-        oiio::ImageBuf colorspaceBuf;
-        oiio::ImageBufAlgo::colorconvert(
-          colorspaceBuf, inBuf, fromColorSpaceName, EImageColorSpace_enumToOIIOString(imageReadOptions.workingColorSpace));
-        inBuf = colorspaceBuf;
-    }
+    convertColorSpaceInPlace(inBuf, fromColorSpaceName, imageReadOptions.workingColorSpace);
 
     // convert to grayscale if needed
     if (nchannels == 1 && inBuf.spec().nchannels >= 3)
@@ -939,12 +1217,12 @@ void readImage(const std::string& path, oiio::TypeDesc format, int nchannels, Im
     }
 
     // copy pixels from oiio to eigen
-    image.resize(inBuf.spec().width, inBuf.spec().height, false);
     {
-        oiio::ROI exportROI = inBuf.roi();
+        oiio::ROI exportROI = getReadROI(inBuf.spec(), imageReadOptions, path);
         exportROI.chbegin = 0;
         exportROI.chend = nchannels;
 
+        image.resize(exportROI.width(), exportROI.height(), false);
         inBuf.get_pixels(exportROI, format, image.data());
     }
 }
@@ -1089,8 +1367,8 @@ void writeImage(const std::string& path,
                         (toColorSpace == EImageColorSpace::NO_CONVERSION) ? EImageColorSpace_enumToString(fromColorSpace)
                                                                           : EImageColorSpace_enumToString(toColorSpace));
 
-    const oiio::ImageBuf imgBuf = oiio::ImageBuf(imageSpec, const_cast<T*>(image.data()));  // original image buffer
-    const oiio::ImageBuf* outBuf = &imgBuf;                                                 // buffer to write
+    oiio::ImageBuf imgBuf = oiio::ImageBuf(imageSpec, const_cast<T*>(image.data()));  // original image buffer
+    oiio::ImageBuf* outBuf = &imgBuf;                                                 // buffer to write
 
     oiio::ImageBuf colorspaceBuf = oiio::ImageBuf(imageSpec, const_cast<T*>(image.data()));  // buffer for image colorspace modification
     if ((fromColorSpace == toColorSpace) || (toColorSpace == EImageColorSpace::NO_CONVERSION))
@@ -1105,21 +1383,16 @@ void writeImage(const std::string& path,
         {
             throw std::runtime_error("ALICEVISION_ROOT is not defined, OCIO config file cannot be accessed.");
         }
-        oiio::ColorConfig colorConfig(colorConfigPath);
-        oiio::ImageBufAlgo::colorconvert(colorspaceBuf,
-                                         *outBuf,
-                                         EImageColorSpace_enumToOIIOString(fromColorSpace),
-                                         EImageColorSpace_enumToOIIOString(toColorSpace),
-                                         true,
-                                         "",
-                                         "",
-                                         &colorConfig);
+        const oiio::ColorProcessorHandle processor =
+          getColorProcessor(EImageColorSpace_enumToOIIOString(fromColorSpace), EImageColorSpace_enumToOIIOString(toColorSpace), colorConfigPath);
+        oiio::ImageBufAlgo::colorconvert(colorspaceBuf, *outBuf, processor.get(), true);
         outBuf = &colorspaceBuf;
     }
     else
     {
-        oiio::ImageBufAlgo::colorconvert(
-          colorspaceBuf, *outBuf, EImageColorSpace_enumToOIIOString(fromColorSpace), EImageColorSpace_enumToOIIOString(toColorSpace));
+        const oiio::ColorProcessorHandle processor =
+          getColorProcessor(EImageColorSpace_enumToOIIOString(fromColorSpace), EImageColorSpace_enumToOIIOString(toColorSpace));
+        oiio::ImageBufAlgo::colorconvert(colorspaceBuf, *outBuf, processor.get(), true);
         outBuf = &colorspaceBuf;
     }
 
@@ -1164,6 +1437,31 @@ void writeImage(const std::string& path,
         }
     }
 
+    if (isEXR && options.getMipmap())
+    {
+        // write a tiled MIP-mapped texture, the levels are computed from the image buffer
+        oiio::ImageSpec textureConfig;
+        textureConfig.tile_width = (options.getTileWidth() > 0) ? options.getTileWidth() : 64;
+        textureConfig.tile_height = (options.getTileHeight() > 0) ? options.getTileHeight() : 64;
+        textureConfig.tile_depth = 1;
+        textureConfig.format = outBuf->spec().format;
+        textureConfig.attribute("compression", compressionMethod);
+        textureConfig.attribute("maketx:filtername", "box");
+
+        if (!oiio::ImageBufAlgo::make_texture(oiio::ImageBufAlgo::MakeTxTexture, *outBuf, tmpPath, textureConfig))
+            ALICEVISION_THROW_ERROR("Can't write output texture file '" + path + "': " + oiio::geterror());
+
+        // rename temporary filename
+        fs::rename(tmpPath, path);
+        return;
+    }
+
+    // write tiles instead of scanlines
+    if (isEXR && options.getTileWidth() > 0 && options.getTileHeight() > 0)
+    {
+        outBuf->set_write_tiles(options.getTileWidth(), options.getTileHeight());
+    }
+
     // write image
     if (!outBuf->write(tmpPath))
         ALICEVISION_THROW_ERROR("Can't write output image file '" + path + "'.");
@@ -1254,6 +1552,80 @@ void readImage(const std::string& path, Image<RGBColor>& image, const ImageReadO
     readImage(path, oiio::TypeDesc::UINT8, 3, image, imageReadOptions);
 }
 
+ImageBandReader::ImageBandReader(const std::string& path, const ImageReadOptions& imageReadOptions)
+  : _path(path),
+    _workingColorSpace(imageReadOptions.workingColorSpace)
+{
+    if (imageReadOptions.subROI.defined() || imageReadOptions.mipLevel > 0)
+        ALICEVISION_THROW_ERROR("The band reading does not support regions of interest nor mip levels. Image file: '" << path << "'.");
+
+    // same conditions than the in place decoding (see readImageInPlace)
+    if (_workingColorSpace != EImageColorSpace::AUTO && !isRawFormat(path))
+    {
+        std::unique_ptr<oiio::ImageInput> in(oiio::ImageInput::open(path));
+        if (in)
+        {
+            const oiio::ImageSpec spec = in->spec();
+
+            const std::string ext = boost::to_lower_copy(fs::path(path).extension().string());
+            const std::string fromColorSpaceName = (imageReadOptions.inputColorSpace == EImageColorSpace::AUTO)
+                                                     ? getImageColorSpace(spec, ext == ".exr" ? "linear" : "sRGB", path)
+                                                     : EImageColorSpace_enumToString(imageReadOptions.inputColorSpace);
+
+            const bool isGamma = (fromColorSpaceName.substr(0, 5) == "Gamma");
+            const std::string linearizedColorSpaceName = isGamma ? "linear" : fromColorSpaceName;
+            const bool dcpFromMetadata = (linearizedColorSpaceName == "no_conversion") && (_workingColorSpace != EImageColorSpace::NO_CONVERSION);
+            const bool needConversion = isGamma || needColorSpaceConversion(linearizedColorSpaceName, _workingColorSpace);
+
+            if (!dcpFromMetadata && (needConversion ? spec.nchannels == 3 : spec.nchannels >= 3))
+            {
+                _in = std::move(in);
+                _spec = spec;
+                _fromColorSpaceName = linearizedColorSpaceName;
+                _gamma = isGamma ? std::stof(fromColorSpaceName.substr(5)) : 0.0f;
+                _needConversion = needConversion;
+                _width = spec.width;
+                _height = spec.height;
+                return;
+            }
+        }
+    }
+
+    readImage(path, _image, imageReadOptions);
+    _width = _image.width();
+    _height = _image.height();
+}
+
+ImageBandReader::~ImageBandReader() = default;
+
+void ImageBandReader::read(int ybegin, int yend, Image<RGBfColor>& band)
+{
+    if (ybegin < 0 || yend > _height || ybegin >= yend)
+        ALICEVISION_THROW_ERROR("Invalid band [" << ybegin << ", " << yend << ") of the image file: '" << _path << "'.");
+
+    band.resize(_width, yend - ybegin, false);
+
+    if (!_in)
+    {
+        band.getMat() = _image.getMat().block(ybegin, 0, yend - ybegin, _width);
+        return;
+    }
+
+    const oiio::ROI roi(_spec.x, _spec.x + _spec.width, _spec.y + ybegin, _spec.y + yend, 0, 1, 0, 3);
+    readRegion(*_in, _spec, roi, 0, 3, oiio::TypeDesc::FLOAT, band.data(), _path);
+
+    if (_needConversion)
+    {
+        // wrap the band storage
+        oiio::ImageBuf buf(oiio::ImageSpec(band.width(), band.height(), 3, oiio::TypeDesc::FLOAT), band.data());
+
+        if (_gamma > 0.0f)
+            oiio::ImageBufAlgo::pow(buf, buf, _gamma);
+
+        convertColorSpaceInPlace(buf, _fromColorSpaceName, _workingColorSpace);
+    }
+}
+
 void logOIIOImageCacheInfo()
 {
     oiio::ImageCache* cache = oiio::ImageCache::create(true);
@@ -1401,5 +1773,17 @@ std::string getAliceVisionOCIOConfig()
 
 void setAliceVisionRootOverride(const std::string& value) { aliceVisionRootOverride = value; }
 
+static std::string rawCacheFolderOverride;
+
+std::string getRawCacheFolder()
+{
+    if (!rawCacheFolderOverride.empty())
+        return rawCacheFolderOverride;
+    const char* value = std::getenv("ALICEVISION_RAW_CACHE");
+    return value ? value : "";
+}
+
+void setRawCacheFolderOverride(const std::string& value) { rawCacheFolderOverride = value; }
+
 }  // namespace image
 }  // namespace aliceVision
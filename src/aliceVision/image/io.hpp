@@ -27,6 +27,7 @@
 #include <OpenImageIO/imagebuf.h>
 #include <OpenImageIO/color.h>
 
+#include <memory>
 #include <string>
 
 namespace aliceVision {
@@ -241,7 +242,8 @@ struct ImageReadOptions
         rawAutoBright(false),
         rawExposureAdjustment(1.0),
         correlatedColorTemperature(-1.0),
-        subROI(roi)
+        subROI(roi),
+        mipLevel(0)
     {}
 
     EImageColorSpace workingColorSpace;
@@ -257,7 +259,11 @@ struct ImageReadOptions
     double correlatedColorTemperature;
     // ROI for this image.
     // If the image contains an roi, this is the roi INSIDE the roi.
+    // When defined, only this region (in pixels, at the requested mip level) is decoded:
+    // the tiles covering it for tiled files, its scanlines otherwise.
     oiio::ROI subROI;
+    // Mip level (or subresolution level) to read, 0 is the full resolution.
+    int mipLevel;
 };
 
 /**
@@ -275,6 +281,9 @@ class ImageWriteOptions
     int getExrCompressionLevel() const { return _exrCompressionLevel; }
     bool getJpegCompress() const { return _jpegCompress; }
     int getJpegQuality() const { return _jpegQuality; }
+    int getTileWidth() const { return _tileWidth; }
+    int getTileHeight() const { return _tileHeight; }
+    bool getMipmap() const { return _mipmap; }
 
     ImageWriteOptions& fromColorSpace(EImageColorSpace colorSpace)
     {
@@ -318,6 +327,29 @@ class ImageWriteOptions
         return *this;
     }
 
+    /**
+     * @brief Write the file as tiles of the given size, for the formats that support it (EXR only).
+     *        A region of a tiled file can be read by decoding only the tiles covering it.
+     * @note No tiling if width or height is 0 (default), the file is written as scanlines.
+     */
+    ImageWriteOptions& tileSize(int width, int height)
+    {
+        _tileWidth = width;
+        _tileHeight = height;
+        return *this;
+    }
+
+    /**
+     * @brief Write the file as a tiled MIP-mapped texture (EXR only): the image and its successive half resolution levels.
+     *        The viewers can stream only the tiles of the visible level.
+     * @note The tiles are 64x64 pixels if no tile size is given.
+     */
+    ImageWriteOptions& mipmap(bool mipmap)
+    {
+        _mipmap = mipmap;
+        return *this;
+    }
+
   private:
     EImageColorSpace _fromColorSpace{EImageColorSpace::LINEAR};
     EImageColorSpace _toColorSpace{EImageColorSpace::AUTO};
@@ -326,6 +358,9 @@ class ImageWriteOptions
     int _exrCompressionLevel{0};
     bool _jpegCompress{true};
     int _jpegQuality{90};
+    int _tileWidth{0};
+    int _tileHeight{0};
+    bool _mipmap{false};
 };
 
 /**
@@ -335,6 +370,16 @@ class ImageWriteOptions
  */
 bool isSupportedUndistortFormat(const std::string& ext);
 
+/**
+ * @brief Get the path of the pre-downscaled version of an undistorted image.
+ * @note Pre-downscaled images are written next to the full resolution image by prepareDenseScene
+ *       in order to avoid decoding and downscaling the full resolution image in each dense node.
+ * @param[in] path The full resolution image path
+ * @param[in] downscale The downscale factor
+ * @return the pre-downscaled image path (eg "<folder>/<stem>_downscale2.exr")
+ */
+std::string getDownscaledImagePath(const std::string& path, int downscale);
+
 /**
  * @brief convert a metadata string map into an oiio::ParamValueList
  * @param[in] metadataMap string map
@@ -415,6 +460,52 @@ void readImage(const std::string& path, Image<RGBColor>& image, const ImageReadO
 void readImageDirect(const std::string& path, Image<IndexT>& image);
 void readImageDirect(const std::string& path, Image<unsigned char>& image);
 
+/**
+ * @brief Read an RGB float image by bands of rows, in the working color space.
+ *        When the image can be decoded in place (non raw image, no channels conversion), the file stays open
+ *        and only the rows of each band are decoded. Otherwise the whole image is read on construction.
+ */
+class ImageBandReader
+{
+  public:
+    /**
+     * @brief Open an image
+     * @param[in] path The given path to the image
+     * @param[in] imageReadOptions The read options, the region of interest and the mip level are not supported
+     */
+    ImageBandReader(const std::string& path, const ImageReadOptions& imageReadOptions);
+    ~ImageBandReader();
+
+    int getWidth() const { return _width; }
+
+    int getHeight() const { return _height; }
+
+    /**
+     * @return true if the bands are decoded on demand, false if the whole image is in memory
+     */
+    bool isStreamed() const { return _in != nullptr; }
+
+    /**
+     * @brief Read the rows [ybegin, yend) of the image
+     * @param[in] ybegin The first row
+     * @param[in] yend The row after the last one
+     * @param[out] band The output band
+     */
+    void read(int ybegin, int yend, Image<RGBfColor>& band);
+
+  private:
+    std::string _path;
+    EImageColorSpace _workingColorSpace;
+    std::unique_ptr<oiio::ImageInput> _in;
+    oiio::ImageSpec _spec;
+    std::string _fromColorSpaceName;
+    float _gamma = 0.0f;
+    bool _needConversion = false;
+    Image<RGBfColor> _image;
+    int _width = 0;
+    int _height = 0;
+};
+
 /**
  * @brief log information about the memory usage of the OIIO default shared image cache
  */
@@ -557,5 +648,17 @@ std::string getAliceVisionOCIOConfig();
 
 void setAliceVisionRootOverride(const std::string& value);
 
+/**
+ * Returns the folder of the decoded raw images cache, the value of ALICEVISION_RAW_CACHE environmental
+ * variable, or empty string if it is not defined (no cache). The returned value can be overridden by
+ * `setRawCacheFolderOverride` if needed, for example in tests.
+ * When defined, the raw images decoded by readImage are stored in this folder (half float EXR files, keyed by
+ * the file path, size and modification time and by the raw decoding options), and read back by the next reads
+ * of the same images with the same options, in any process.
+ */
+std::string getRawCacheFolder();
+
+void setRawCacheFolderOverride(const std::string& value);
+
 }  // namespace image
 }  // namespace aliceVision
@@ -10,11 +10,15 @@
 
 #define BOOST_TEST_MODULE imageIO
 
+#include <OpenImageIO/imageio.h>
+
 #include <boost/test/unit_test.hpp>
 #include <boost/test/tools/floating_point_comparison.hpp>
 
 #include <cstdio>
+#include <filesystem>
 #include <iostream>
+#include <memory>
 #include <vector>
 #include <string>
 
@@ -106,6 +110,26 @@ BOOST_AUTO_TEST_CASE(read_png_rgba)
     BOOST_CHECK_EQUAL(image(0, 0).a(), 255);
 }
 
+BOOST_AUTO_TEST_CASE(read_png_rgba_as_rgb)
+{
+    // the alpha channel is not decoded
+    Image<RGBfColor> image;
+    const std::string png_filename = string(THIS_SOURCE_DIR) + "/image_test/two_pixels_color.png";
+    BOOST_CHECK_NO_THROW(readImage(png_filename, image, image::EImageColorSpace::NO_CONVERSION));
+    BOOST_CHECK_EQUAL(2, image.width());
+    BOOST_CHECK_EQUAL(1, image.height());
+    BOOST_CHECK_CLOSE(image(0, 0).r(), 1.f, 1e-4);
+    BOOST_CHECK_CLOSE(image(0, 0).g(), 125.f / 255.f, 1e-4);
+    BOOST_CHECK_CLOSE(image(0, 1).b(), 1.f, 1e-4);
+
+    // the same pixels converted in place in the linear color space
+    Image<RGBfColor> imageLinear;
+    BOOST_CHECK_NO_THROW(readImage(png_filename, imageLinear, image::EImageColorSpace::LINEAR));
+    BOOST_CHECK_EQUAL(2, imageLinear.width());
+    BOOST_CHECK_CLOSE(imageLinear(0, 0).r(), 1.f, 0.1);
+    BOOST_CHECK_LT(imageLinear(0, 0).g(), image(0, 0).g());
+}
+
 BOOST_AUTO_TEST_CASE(read_pgm)
 {
     Image<unsigned char> image;
@@ -270,3 +294,84 @@ BOOST_AUTO_TEST_CASE(read_write_from_grayscale_to_rgb)
         remove(filename.c_str());
     }
 }
+
+BOOST_AUTO_TEST_CASE(downscaled_image_path)
+{
+    BOOST_CHECK_EQUAL(getDownscaledImagePath("/tmp/dense/12345.exr", 2), "/tmp/dense/12345_downscale2.exr");
+    BOOST_CHECK_EQUAL(getDownscaledImagePath("12345.png", 4), "12345_downscale4.png");
+
+    // the pre-downscaled image must not be found as a view image (the view image stem is the view id)
+    BOOST_CHECK(std::filesystem::path(getDownscaledImagePath("/tmp/dense/12345.exr", 2)).stem() != "12345");
+}
+
+BOOST_AUTO_TEST_CASE(read_tiled_exr_region)
+{
+    Image<float> image(40, 30);
+    for (int y = 0; y < image.height(); ++y)
+        for (int x = 0; x < image.width(); ++x)
+            image(y, x) = float(y * image.width() + x);
+
+    const std::string filename = "test_write_tiled.exr";
+    BOOST_CHECK_NO_THROW(writeImage(filename,
+                                    image,
+                                    image::ImageWriteOptions()
+                                      .toColorSpace(image::EImageColorSpace::NO_CONVERSION)
+                                      .storageDataType(image::EStorageDataType::Float)
+                                      .tileSize(16, 16)));
+
+    // region across several file tiles
+    image::ImageReadOptions readOptions(image::EImageColorSpace::NO_CONVERSION);
+    readOptions.subROI = oiio::ROI(10, 35, 5, 20);
+
+    Image<float> read_image;
+    BOOST_CHECK_NO_THROW(readImage(filename, read_image, readOptions));
+    BOOST_CHECK_EQUAL(read_image.width(), 25);
+    BOOST_CHECK_EQUAL(read_image.height(), 15);
+
+    for (int y = 0; y < read_image.height(); ++y)
+        for (int x = 0; x < read_image.width(); ++x)
+            BOOST_CHECK_EQUAL(read_image(y, x), image(y + 5, x + 10));
+
+    remove(filename.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(write_mipmap_exr)
+{
+    Image<float> image(40, 30);
+    for (int y = 0; y < image.height(); ++y)
+        for (int x = 0; x < image.width(); ++x)
+            image(y, x) = float(y * image.width() + x);
+
+    const std::string filename = "test_write_mipmap.exr";
+    BOOST_CHECK_NO_THROW(writeImage(filename,
+                                    image,
+                                    image::ImageWriteOptions()
+                                      .toColorSpace(image::EImageColorSpace::NO_CONVERSION)
+                                      .storageDataType(image::EStorageDataType::Float)
+                                      .tileSize(16, 16)
+                                      .mipmap(true)));
+
+    // the first level is the image
+    Image<float> read_image;
+    BOOST_CHECK_NO_THROW(readImage(filename, read_image, image::EImageColorSpace::NO_CONVERSION));
+    BOOST_CHECK_EQUAL(read_image.width(), image.width());
+    BOOST_CHECK_EQUAL(read_image.height(), image.height());
+
+    for (int y = 0; y < read_image.height(); ++y)
+        for (int x = 0; x < read_image.width(); ++x)
+            BOOST_CHECK_EQUAL(read_image(y, x), image(y, x));
+
+    // tiled file with half resolution levels
+    std::unique_ptr<oiio::ImageInput> in = oiio::ImageInput::open(filename);
+    BOOST_REQUIRE(in);
+    BOOST_CHECK_EQUAL(in->spec().tile_width, 16);
+
+    oiio::ImageSpec levelSpec;
+    BOOST_CHECK(in->seek_subimage(0, 1, levelSpec));
+    BOOST_CHECK_EQUAL(levelSpec.width, 20);
+    BOOST_CHECK_EQUAL(levelSpec.height, 15);
+    in->close();
+    in.reset();
+
+    remove(filename.c_str());
+}
@@ -119,3 +119,23 @@ BOOST_AUTO_TEST_CASE(Resampling_SampleRotate)
     BOOST_CHECK_NO_THROW(imageRotation(image, Sampler2d<SamplerSpline16>(), "SamplerSpline16"));
     BOOST_CHECK_NO_THROW(imageRotation(image, Sampler2d<SamplerSpline64>(), "SamplerSpline64"));
 }
+
+BOOST_AUTO_TEST_CASE(Resampling_HalfSample)
+{
+    // the half sampling must give the same result as the bilinear downscale
+    Image<float> image(101, 77);
+    for (int i = 0; i < image.height(); ++i)
+        for (int j = 0; j < image.width(); ++j)
+            image(i, j) = i * 1000.f + j;
+
+    Image<float> imageDownscaled;
+    Image<float> imageHalfSampled;
+    downscaleImage<SamplerLinear>(image, imageDownscaled, 2);
+    imageHalfSample(image, imageHalfSampled);
+
+    BOOST_CHECK_EQUAL(imageHalfSampled.width(), 50);
+    BOOST_CHECK_EQUAL(imageHalfSampled.height(), 38);
+    BOOST_CHECK_EQUAL(imageHalfSampled.width(), imageDownscaled.width());
+    BOOST_CHECK_EQUAL(imageHalfSampled.height(), imageDownscaled.height());
+    BOOST_CHECK_EQUAL((imageHalfSampled.getMat() - imageDownscaled.getMat()).cwiseAbs().maxCoeff(), 0.f);
+}
@@ -0,0 +1,97 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/image/Image.hpp>
+#include <aliceVision/image/Sampler.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+using namespace aliceVision;
+using namespace aliceVision::image;
+
+namespace {
+
+const int imageWidth = 1920;
+const int imageHeight = 1080;
+const std::size_t nbSamples = 1 << 20;
+
+template<typename T>
+Image<T> randomImage()
+{
+    std::mt19937 generator(0);
+    std::uniform_real_distribution<float> distribution(0.f, 1.f);
+    Image<T> image(imageWidth, imageHeight);
+    for (int y = 0; y < imageHeight; ++y)
+        for (int x = 0; x < imageWidth; ++x)
+            image(y, x) = T(distribution(generator));
+    return image;
+}
+
+/**
+ * @brief Random sub-pixel positions (x, y), e.g. the reprojections of a warp.
+ */
+std::vector<Vec2f> randomPositions()
+{
+    std::mt19937 generator(1);
+    std::uniform_real_distribution<float> distributionX(0.f, static_cast<float>(imageWidth - 1));
+    std::uniform_real_distribution<float> distributionY(0.f, static_cast<float>(imageHeight - 1));
+    std::vector<Vec2f> positions(nbSamples);
+    for (auto& position : positions)
+        position = Vec2f(distributionX(generator), distributionY(generator));
+    return positions;
+}
+
+/**
+ * @brief Sampling with the generic Sampler2d (separable weights, normalization).
+ */
+template<typename T, typename SamplerFunc>
+void BM_sampler2d(benchmark::State& state)
+{
+    const Image<T> image = randomImage<T>();
+    const std::vector<Vec2f> positions = randomPositions();
+    const Sampler2d<SamplerFunc> sampler;
+
+    for (auto _ : state)
+    {
+        for (const Vec2f& position : positions)
+        {
+            benchmark::DoNotOptimize(sampler(image, position.y(), position.x()));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * positions.size());
+}
+
+/**
+ * @brief Sampling with the dedicated bilinear interpolation.
+ */
+template<typename T>
+void BM_getInterpolateColor(benchmark::State& state)
+{
+    const Image<T> image = randomImage<T>();
+    const std::vector<Vec2f> positions = randomPositions();
+
+    for (auto _ : state)
+    {
+        for (const Vec2f& position : positions)
+        {
+            benchmark::DoNotOptimize(getInterpolateColor(image, position.y(), position.x()));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * positions.size());
+}
+
+}  // namespace
+
+BENCHMARK_TEMPLATE(BM_sampler2d, float, SamplerLinear)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_sampler2d, RGBfColor, SamplerLinear)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_sampler2d, float, SamplerCubic)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_getInterpolateColor, float)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_getInterpolateColor, RGBfColor)->Unit(benchmark::kMillisecond);
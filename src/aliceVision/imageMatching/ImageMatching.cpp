@@ -6,6 +6,8 @@
 
 #include "ImageMatching.hpp"
 #include <aliceVision/voctree/databaseIO.hpp>
+#include <aliceVision/voctree/GlobalDescriptorIndex.hpp>
+#include <aliceVision/utils/filesIO.hpp>
 
 namespace aliceVision {
 namespace imageMatching {
@@ -40,6 +42,8 @@ std::string EImageMatchingMethod_enumToString(EImageMatchingMethod m)
             return "Frustum";
         case EImageMatchingMethod::FRUSTUM_OR_VOCABULARYTREE:
             return "FrustumOrVocabularyTree";
+        case EImageMatchingMethod::GLOBALDESCRIPTOR:
+            return "GlobalDescriptor";
     }
     throw std::out_of_range("Invalid EImageMatchingMethod enum: " + std::to_string(int(m)));
 }
@@ -61,6 +65,8 @@ EImageMatchingMethod EImageMatchingMethod_stringToEnum(const std::string& m)
         return EImageMatchingMethod::FRUSTUM;
     if (mode == "frustumorvocabularytree")
         return EImageMatchingMethod::FRUSTUM_OR_VOCABULARYTREE;
+    if (mode == "globaldescriptor")
+        return EImageMatchingMethod::GLOBALDESCRIPTOR;
 
     throw std::out_of_range("Invalid EImageMatchingMethod: " + m);
 }
@@ -254,6 +260,33 @@ void generateFromVoctree(PairList& allMatches,
             allMatches[descriptorPair.first] = {};
     }
 
+    if (modeMultiSfM != EImageMatchingMode::A_B)
+    {
+        // sparse histograms of A are already computed in the DB:
+        // query all the documents at once, without copying their histograms
+        std::vector<const aliceVision::voctree::SparseHistogram*> queries;
+        queries.reserve(descriptorsFiles.size());
+        for (const auto& descriptorPair : descriptorsFiles)
+            queries.push_back(&db.getSparseHistogramPerImage().at(descriptorPair.first));
+
+        std::vector<aliceVision::voctree::DocMatches> queriesMatches;
+        db.find(queries, numImageQuery, queriesMatches);
+
+        std::size_t i = 0;
+        for (const auto& descriptorPair : descriptorsFiles)
+        {
+            ListOfImageID& imgMatches = allMatches.at(descriptorPair.first);
+            const aliceVision::voctree::DocMatches& matches = queriesMatches[i++];
+            imgMatches.reserve(imgMatches.size() + matches.size());
+
+            for (const aliceVision::voctree::DocMatch& m : matches)
+            {
+                imgMatches.push_back(m.id);
+            }
+        }
+        return;
+    }
+
     // query each document
 #pragma omp parallel for
     for (ptrdiff_t i = 0; i < static_cast<ptrdiff_t>(descriptorsFiles.size()); ++i)
@@ -263,21 +296,11 @@ void generateFromVoctree(PairList& allMatches,
         const IndexT viewIdA = itA->first;
         const std::string featuresPathA = itA->second;
 
-        aliceVision::voctree::SparseHistogram imageSH;
-
-        if (modeMultiSfM != EImageMatchingMode::A_B)
-        {
-            // sparse histogram of A is already computed in the DB
-            imageSH = db.getSparseHistogramPerImage().at(viewIdA);
-        }
-        else  // mode AB
-        {
-            // compute the sparse histogram of each image A
-            std::vector<DescriptorUChar> descriptors;
-            // read the descriptors
-            loadDescsFromBinFile(featuresPathA, descriptors, false, nbMaxDescriptors);
-            imageSH = tree.quantizeToSparse(descriptors);
-        }
+        // compute the sparse histogram of each image A
+        std::vector<DescriptorUChar> descriptors;
+        // read the descriptors
+        loadDescsFromBinFile(featuresPathA, descriptors, false, nbMaxDescriptors);
+        const aliceVision::voctree::SparseHistogram imageSH = tree.quantizeToSparse(descriptors);
 
         std::vector<aliceVision::voctree::DocMatch> matches;
 
@@ -306,6 +329,7 @@ void conditionVocTree(const std::string& treeName,
                       bool useMultiSfM,
                       const std::map<IndexT, std::string>& descriptorsFilesA,
                       std::size_t numImageQuery,
+                      const std::string& databaseFilepath,
                       OrderedPairList& selectedPairs)
 {
     if (treeName.empty())
@@ -313,6 +337,13 @@ void conditionVocTree(const std::string& treeName,
         throw std::runtime_error("No vocabulary tree argument.");
     }
 
+    const bool useDatabaseFile = !databaseFilepath.empty();
+    if (useDatabaseFile && matchingMode != EImageMatchingMode::A_A)
+    {
+        throw std::runtime_error("The vocabulary tree database file is only supported in mode: " +
+                                 EImageMatchingMode_enumToString(EImageMatchingMode::A_A));
+    }
+
     // load vocabulary tree
     ALICEVISION_LOG_INFO("Loading vocabulary tree");
 
@@ -334,6 +365,32 @@ void conditionVocTree(const std::string& treeName,
     aliceVision::voctree::Database db(tree.words());
     aliceVision::voctree::Database db2;
 
+    // images to insert in the database and to query
+    std::map<IndexT, std::string> newDescriptorsFilesA;
+
+    if (useDatabaseFile && utils::exists(databaseFilepath))
+    {
+        ALICEVISION_LOG_INFO("Loading the database: " << databaseFilepath);
+        db.load(databaseFilepath);
+
+        if (db.getWeights().size() != tree.words())
+        {
+            throw std::runtime_error("The database '" + databaseFilepath + "' has not been created with the vocabulary tree '" + treeName + "'.");
+        }
+
+        for (const auto& descriptorPair : descriptorsFilesA)
+        {
+            if (!db.contains(descriptorPair.first))
+                newDescriptorsFilesA.insert(descriptorPair);
+        }
+
+        ALICEVISION_LOG_INFO("The database contains " << db.size() << " images, " << newDescriptorsFilesA.size() << " new images to insert.");
+    }
+    else
+    {
+        newDescriptorsFilesA = descriptorsFilesA;
+    }
+
     if (withWeights)
     {
         ALICEVISION_LOG_INFO("Loading weights...");
@@ -365,10 +422,10 @@ void conditionVocTree(const std::string& treeName,
             if ((matchingMode == EImageMatchingMode::A_A_AND_A_B) || (matchingMode == EImageMatchingMode::A_AB) ||
                 (matchingMode == EImageMatchingMode::A_A))
             {
-                nbFeaturesLoadedInputA = voctree::populateDatabase<DescriptorUChar>(sfmDataA, featuresFolders, tree, db, nbMaxDescriptors);
-                nbSetDescriptors = db.getSparseHistogramPerImage().size();
+                nbFeaturesLoadedInputA = voctree::populateDatabase<DescriptorUChar>(newDescriptorsFilesA, tree, db, nbMaxDescriptors);
+                nbSetDescriptors = newDescriptorsFilesA.size();
 
-                if (nbFeaturesLoadedInputA == 0)
+                if (nbFeaturesLoadedInputA == 0 && db.size() == newDescriptorsFilesA.size())
                 {
                     throw std::runtime_error("No descriptors loaded in '" + sfmDataFilenameA + "'");
                 }
@@ -423,7 +480,7 @@ void conditionVocTree(const std::string& treeName,
         }
         else
         {
-            generateFromVoctree(allMatches, descriptorsFilesA, db, tree, matchingMode, nbMaxDescriptors, numImageQuery);
+            generateFromVoctree(allMatches, newDescriptorsFilesA, db, tree, matchingMode, nbMaxDescriptors, numImageQuery);
         }
 
         auto detect_elapsed = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - detect_start);
@@ -437,6 +494,88 @@ void conditionVocTree(const std::string& treeName,
         detect_elapsed = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - detect_start);
         ALICEVISION_LOG_INFO("Convert all matches to pairList took " << detect_elapsed.count() << " sec.");
     }
+
+    if (useDatabaseFile)
+    {
+        ALICEVISION_LOG_INFO("Saving the database: " << databaseFilepath);
+        db.save(databaseFilepath);
+    }
+}
+
+void conditionGlobalDescriptor(const std::string& treeName,
+                               const std::map<IndexT, std::string>& descriptorsFiles,
+                               std::size_t nbMaxDescriptors,
+                               std::size_t numImageQuery,
+                               OrderedPairList& selectedPairs)
+{
+    if (treeName.empty())
+    {
+        throw std::runtime_error("No vocabulary tree argument.");
+    }
+
+    ALICEVISION_LOG_INFO("Loading vocabulary tree");
+    const aliceVision::voctree::VocabularyTree<DescriptorFloat> tree(treeName);
+
+    // compute the global descriptor of each image
+    ALICEVISION_LOG_INFO("Computing the global descriptors of " << descriptorsFiles.size() << " images...");
+    auto detect_start = std::chrono::steady_clock::now();
+
+    std::vector<IndexT> viewIds;
+    viewIds.reserve(descriptorsFiles.size());
+    for (const auto& descriptorPair : descriptorsFiles)
+        viewIds.push_back(descriptorPair.first);
+
+    std::vector<std::vector<float>> globalDescriptors(viewIds.size());
+#pragma omp parallel for
+    for (ptrdiff_t i = 0; i < static_cast<ptrdiff_t>(viewIds.size()); ++i)
+    {
+        std::vector<DescriptorUChar> descriptors;
+        loadDescsFromBinFile(descriptorsFiles.at(viewIds[i]), descriptors, false, nbMaxDescriptors);
+        globalDescriptors[i] = tree.computeVLAD(descriptors, 0);
+    }
+
+    auto detect_elapsed = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - detect_start);
+    ALICEVISION_LOG_INFO("Computing the global descriptors took " << detect_elapsed.count() << " sec.");
+
+    // build the approximate nearest neighbors index
+    detect_start = std::chrono::steady_clock::now();
+
+    aliceVision::voctree::GlobalDescriptorIndex index;
+    for (std::size_t i = 0; i < viewIds.size(); ++i)
+        index.insert(viewIds[i], globalDescriptors[i]);
+    index.build();
+
+    detect_elapsed = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - detect_start);
+    ALICEVISION_LOG_INFO("Building the index of " << index.nbLists() << " lists took " << detect_elapsed.count() << " sec.");
+
+    // query each image
+    if (numImageQuery == 0)
+    {
+        // if 0 retrieve all the images
+        numImageQuery = viewIds.size();
+    }
+
+    PairList allMatches;
+    for (const IndexT viewId : viewIds)
+        allMatches[viewId] = {};
+
+    detect_start = std::chrono::steady_clock::now();
+#pragma omp parallel for
+    for (ptrdiff_t i = 0; i < static_cast<ptrdiff_t>(viewIds.size()); ++i)
+    {
+        // the image itself is its first match
+        aliceVision::voctree::DocMatches matches;
+        index.find(globalDescriptors[i], numImageQuery + 1, matches);
+
+        ListOfImageID& imgMatches = allMatches.at(viewIds[i]);
+        imgMatches.reserve(matches.size());
+        for (const aliceVision::voctree::DocMatch& m : matches)
+            imgMatches.push_back(m.id);
+    }
+    detect_elapsed = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - detect_start);
+    ALICEVISION_LOG_INFO("Query all images took " << detect_elapsed.count() << " sec.");
+
+    convertAllMatchesToPairList(allMatches, numImageQuery, selectedPairs);
 }
 
 EImageMatchingMethod selectImageMatchingMethod(EImageMatchingMethod method,
@@ -481,7 +620,8 @@ EImageMatchingMethod selectImageMatchingMethod(EImageMatchingMethod method,
     }
 
     // if not enough images to use the VOCABULARYTREE use the EXHAUSTIVE method
-    if (method == EImageMatchingMethod::VOCABULARYTREE || method == EImageMatchingMethod::SEQUENTIAL_AND_VOCABULARYTREE)
+    if (method == EImageMatchingMethod::VOCABULARYTREE || method == EImageMatchingMethod::SEQUENTIAL_AND_VOCABULARYTREE ||
+        method == EImageMatchingMethod::GLOBALDESCRIPTOR)
     {
         if ((sfmDataA.getViews().size() + sfmDataB.getViews().size()) < minNbImages)
         {
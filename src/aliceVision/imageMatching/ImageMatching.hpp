@@ -54,7 +54,8 @@ enum class EImageMatchingMethod
     SEQUENTIAL = 2,
     SEQUENTIAL_AND_VOCABULARYTREE = 3,
     FRUSTUM = 4,
-    FRUSTUM_OR_VOCABULARYTREE = 5
+    FRUSTUM_OR_VOCABULARYTREE = 5,
+    GLOBALDESCRIPTOR = 6
 };
 
 /**
@@ -127,6 +128,12 @@ void generateFromVoctree(PairList& allMatches,
                          std::size_t nbMaxDescriptors,
                          std::size_t numImageQuery);
 
+/**
+ * @brief Select the image pairs with the vocabulary tree.
+ *        If a database file is given (only in A_A mode), the documents it contains are loaded instead of being
+ *        recomputed, only the images which are not in the database are quantized and queried (so only their pairs are
+ *        selected), and the updated database is saved back to the file.
+ */
 void conditionVocTree(const std::string& treeName,
                       bool withWeights,
                       const std::string& weightsName,
@@ -140,8 +147,25 @@ void conditionVocTree(const std::string& treeName,
                       bool useMultiSfM,
                       const std::map<IndexT, std::string>& descriptorsFilesA,
                       std::size_t numImageQuery,
+                      const std::string& databaseFilepath,
                       OrderedPairList& selectedPairs);
 
+/**
+ * @brief Select the image pairs with the closest global descriptors.
+ *        The VLAD descriptor of each image is computed on the first level of the vocabulary tree,
+ *        and the nearest images are retrieved with an approximate nearest neighbors index (inverted file).
+ * @param[in] treeName The vocabulary tree filepath
+ * @param[in] descriptorsFiles The descriptor file of each image
+ * @param[in] nbMaxDescriptors The maximum number of descriptors loaded per image (0 for no limit)
+ * @param[in] numImageQuery The number of matches to retrieve for each image (0 for all)
+ * @param[out] selectedPairs The selected image pairs
+ */
+void conditionGlobalDescriptor(const std::string& treeName,
+                               const std::map<IndexT, std::string>& descriptorsFiles,
+                               std::size_t nbMaxDescriptors,
+                               std::size_t numImageQuery,
+                               OrderedPairList& selectedPairs);
+
 EImageMatchingMethod selectImageMatchingMethod(EImageMatchingMethod method,
                                                const sfmData::SfMData& sfmDataA,
                                                const sfmData::SfMData& sfmDataB,
@@ -5,10 +5,19 @@
 // You can obtain one at https://mozilla.org/MPL/2.0/.
 
 #include "KeyframeSelector.hpp"
+#include <aliceVision/config.hpp>
 #include <aliceVision/sfmDataIO/viewIO.hpp>
 #include <aliceVision/system/Logger.hpp>
 #include <aliceVision/utils/filesIO.hpp>
 
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_OPENCV_CUDA)
+    #include <opencv2/core/cuda.hpp>
+    #include <opencv2/cudafilters.hpp>
+    #include <opencv2/cudaoptflow.hpp>
+#endif
+
+#include <condition_variable>
+#include <deque>
 #include <random>
 #include <tuple>
 #include <cassert>
@@ -35,6 +44,111 @@ int getRandomInt()
     return randomDist(randomTwEngine);
 }
 
+/// Number of frames scored at once by the GPU scoring thread
+const std::size_t gpuScoringBatchSize = 8;
+
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_OPENCV_CUDA)
+/**
+ * @brief Compute on the GPU the Laplacians and dense optical flows used by the sharpness and motion scores
+ *        of a batch of frames: the uploads, computations and downloads of the whole batch are queued
+ *        on a single CUDA stream, which is only synchronized once for the batch.
+ */
+class CudaScorer
+{
+  public:
+    CudaScorer()
+      : _flow(cv::cuda::FarnebackOpticalFlow::create()),
+        _laplacian(cv::cuda::createLaplacianFilter(CV_32FC1, CV_32FC1, 1))
+    {}
+
+    /**
+     * @param[in] sharpnessImages the frames of the batch rescaled for the sharpness
+     * @param[in] flowImages the frames of the batch rescaled for the optical flow
+     * @param[in] previousFlow the previous frame rescaled for the optical flow of each frame of the batch, nullptr for none
+     * @param[in] skipSharpnessComputation if true, the Laplacians are not computed
+     * @param[out] laplacians the Laplacian of each frame (CV_32F), empty if skipped
+     * @param[out] flows the dense optical flow of each frame (CV_32FC2), empty if there is no previous frame
+     */
+    void compute(const std::vector<const cv::Mat*>& sharpnessImages,
+                 const std::vector<const cv::Mat*>& flowImages,
+                 const std::vector<const cv::Mat*>& previousFlow,
+                 const bool skipSharpnessComputation,
+                 std::vector<cv::Mat>& laplacians,
+                 std::vector<cv::Mat>& flows)
+    {
+        const std::size_t batchSize = flowImages.size();
+        resizeBuffers(batchSize);
+        laplacians.assign(batchSize, cv::Mat());
+        flows.assign(batchSize, cv::Mat());
+
+        for (std::size_t i = 0; i < batchSize; ++i)
+        {
+            if (!skipSharpnessComputation)
+            {
+                _gpuSharpness.at(i).upload(*sharpnessImages.at(i), _stream);
+                _gpuSharpness.at(i).convertTo(_gpuSharpnessFloat.at(i), CV_32F, _stream);
+                _laplacian->apply(_gpuSharpnessFloat.at(i), _gpuLaplacian.at(i), _stream);
+                _gpuLaplacian.at(i).download(laplacians.at(i), _stream);
+            }
+
+            if (previousFlow.at(i))
+            {
+                const cv::Mat& flowImage = *flowImages.at(i);
+                if (flowImage.size() != previousFlow.at(i)->size())
+                {
+                    ALICEVISION_THROW(std::invalid_argument,
+                                      "The images used for the optical flow computation have different sizes ("
+                                        << flowImage.size().width << "x" << flowImage.size().height << " and "
+                                        << previousFlow.at(i)->size().width << "x" << previousFlow.at(i)->size().height << ")");
+                }
+
+                _gpuFlowImage.at(i).upload(flowImage, _stream);
+                _gpuPreviousFlowImage.at(i).upload(*previousFlow.at(i), _stream);
+                _flow->calc(_gpuFlowImage.at(i), _gpuPreviousFlowImage.at(i), _gpuFlow.at(i), _stream);
+                _gpuFlow.at(i).download(flows.at(i), _stream);
+            }
+        }
+
+        _stream.waitForCompletion();
+    }
+
+  private:
+    void resizeBuffers(std::size_t batchSize)
+    {
+        for (auto* buffers : {&_gpuSharpness, &_gpuSharpnessFloat, &_gpuLaplacian, &_gpuFlowImage, &_gpuPreviousFlowImage, &_gpuFlow})
+        {
+            if (buffers->size() < batchSize)
+                buffers->resize(batchSize);
+        }
+    }
+
+    cv::Ptr<cv::cuda::FarnebackOpticalFlow> _flow;
+    cv::Ptr<cv::cuda::Filter> _laplacian;
+    cv::cuda::Stream _stream;
+
+    // device buffers of each frame of the batch, kept between the batches
+    std::vector<cv::cuda::GpuMat> _gpuSharpness;
+    std::vector<cv::cuda::GpuMat> _gpuSharpnessFloat;
+    std::vector<cv::cuda::GpuMat> _gpuLaplacian;
+    std::vector<cv::cuda::GpuMat> _gpuFlowImage;
+    std::vector<cv::cuda::GpuMat> _gpuPreviousFlowImage;
+    std::vector<cv::cuda::GpuMat> _gpuFlow;
+};
+#endif
+
+/**
+ * @brief Check whether the scores can be computed on the GPU.
+ * @return true if OpenCV has been built with its CUDA modules and a CUDA device is available
+ */
+bool isCudaScoringAvailable()
+{
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_OPENCV_CUDA)
+    return cv::cuda::getCudaEnabledDeviceCount() > 0;
+#else
+    return false;
+#endif
+}
+
 /**
  * @brief Find the median value in an unsorted vector of double values.
  * @param[in] vec The unsorted vector of double values
@@ -355,6 +469,7 @@ bool KeyframeSelector::computeScores(const std::size_t rescaledWidthSharpness,
 
     // Create single feed and count minimum number of frames
     std::size_t nbFrames = std::numeric_limits<std::size_t>::max();
+    bool hasVideo = false;
 
     for (std::size_t mediaIndex = 0; mediaIndex < _mediaPaths.size(); ++mediaIndex)
     {
@@ -371,6 +486,7 @@ bool KeyframeSelector::computeScores(const std::size_t rescaledWidthSharpness,
 
         // Number of frames in the rig might slightly differ
         nbFrames = std::min(nbFrames, static_cast<std::size_t>(feed->nbFrames()));
+        hasVideo = hasVideo || feed->isVideo();
 
         if (mediaIndex == 0)
         {
@@ -406,6 +522,23 @@ bool KeyframeSelector::computeScores(const std::size_t rescaledWidthSharpness,
         ALICEVISION_THROW(std::invalid_argument, "One or multiple medias can't be found or is empty!");
     }
 
+    bool useGpu = false;
+    if (_useGpu)
+    {
+        useGpu = isCudaScoringAvailable();
+        if (!useGpu)
+            ALICEVISION_LOG_WARNING("The GPU scoring is not available (no CUDA device or OpenCV built without the CUDA modules), "
+                                    "the scores will be computed on the CPU.");
+    }
+
+    // Seeking in a video decodes the whole group of pictures preceding the frame:
+    // decode it once, sequentially, for all the scoring threads
+    if (hasVideo || useGpu)
+    {
+        return computeScoresPipeline(
+          nbFrames, rescaledWidthSharpness, rescaledWidthFlow, sharpnessWindowSize, flowCellSize, skipSharpnessComputation, useGpu);
+    }
+
     // With the number of threads available and the number of frames to process known,
     // blocks can be prepared for multi-threading
     int nbThreads = omp_get_max_threads();
@@ -502,46 +635,26 @@ bool KeyframeSelector::computeScoresProc(const std::size_t startFrame,
         }
     }
 
-    // Feed provider variables
-    camera::Pinhole queryIntrinsics;  // image associated camera intrinsics
-    bool hasIntrinsics = false;       // true if queryIntrinsics is valid
-
-    // Input feed provider variables
-    image::Image<image::RGBColor> image;  // original image
-    std::string currentImgName;           // current image name
-
-    // Mask feed provider variables
-    image::Image<image::RGBColor> mask;  // original mask
-    std::string currentMaskName;         // current mask name
-
-    // Feed and metadata initialization
+    // Feeds initialization
     for (std::size_t mediaIndex = 0; mediaIndex < feeds.size(); ++mediaIndex)
     {
         // First frame with offset
-        feeds.at(mediaIndex)->goToFrame(startFrame);
-
-        if (!feeds.at(mediaIndex)->readImage(image, queryIntrinsics, currentImgName, hasIntrinsics))
+        if (!feeds.at(mediaIndex)->goToFrame(startFrame))
         {
             ALICEVISION_THROW(std::invalid_argument, "Cannot read media first frame " << _mediaPaths[mediaIndex]);
         }
 
-        if (masksProvided)
+        if (masksProvided && !maskFeeds.at(mediaIndex)->goToFrame(startFrame))
         {
-            maskFeeds.at(mediaIndex)->goToFrame(startFrame);
-            if (!maskFeeds.at(mediaIndex)->readImage(mask, queryIntrinsics, currentMaskName, hasIntrinsics))
-            {
-                ALICEVISION_THROW(std::invalid_argument, "Cannot read mask media first frame " << _maskPaths[mediaIndex]);
-            }
+            ALICEVISION_THROW(std::invalid_argument, "Cannot read mask media first frame " << _maskPaths[mediaIndex]);
         }
     }
 
     std::size_t currentFrame = startFrame;
-    cv::Mat currentMatSharpness;              // OpenCV matrix for the sharpness computation
-    cv::Mat previousMatFlow, currentMatFlow;  // OpenCV matrices for the optical flow computation
+    FrameImages currentImages;                           // Frame rescaled for the sharpness and the optical flow computations
+    std::vector<cv::Mat> previousMatFlow(feeds.size());  // Previous frame of each media for the optical flow computation
     auto ptrFlow = cv::optflow::createOptFlow_DeepFlow();
 
-    cv::Mat currentMatFlowMask, currentMatMask;  // OpenCV matrices that will contain the masks
-
     while (currentFrame < endFrame)
     {
         double minimalSharpness = skipSharpnessComputation ? 1.0f : std::numeric_limits<double>::max();
@@ -550,104 +663,73 @@ bool KeyframeSelector::computeScoresProc(const std::size_t startFrame,
         for (std::size_t mediaIndex = 0; mediaIndex < feeds.size(); ++mediaIndex)
         {
             auto& feed = *feeds.at(mediaIndex);
+            dataio::FeedProvider* maskFeed = masksProvided ? maskFeeds.at(mediaIndex).get() : nullptr;
 
             if (currentFrame > startFrame)
-            {  // Get currentFrame - 1 for the optical flow computation
-                previousMatFlow = readImage(feed, rescaledWidthFlow);
+            {
                 feed.goToNextFrame();
 
-                if (masksProvided)
-                {
-                    auto& maskFeed = *maskFeeds.at(mediaIndex);
-                    maskFeed.goToNextFrame();
-                }
+                if (maskFeed)
+                    maskFeed->goToNextFrame();
             }
 
             /* Handle input feeds that may have invalid or missing frames:
-             *   - catch the "invalid argument" exception thrown by "readImage" if a frame is invalid or missing
+             *   - catch the "invalid argument" exception thrown by "readFrameImages" if a frame is invalid or missing
              *   - try reading the next frame instead
              *   - if the next frame is correctly read, then push dummy scores for the invalid frame and go on with
              *     the process
              *   - otherwise (feed not correctly moved to the next frame), keep on going to the next frame until it is
              *     valid or the end of the feed is reached
              */
-            if (!skipSharpnessComputation)
+            try
             {
-                try
+                // Read the frame once and rescale it for both the sharpness and the optical flow
+                readFrameImages(feed, maskFeed, rescaledWidthSharpness, rescaledWidthFlow, skipSharpnessComputation, currentImages);
+            }
+            catch (const std::invalid_argument& ex)
+            {
+                bool success = false;
+                while (!success && currentFrame < nbFrames)
                 {
-                    // Read image for sharpness and rescale it if requested
-                    currentMatSharpness = readImage(feed, rescaledWidthSharpness);
-                    if (masksProvided)
+                    // currentFrame + 1 = currently evaluated frame with indexing starting at 1, for display reasons
+                    // currentFrame + 2 = next frame to evaluate with indexing starting at 1, for display reasons
+                    ALICEVISION_LOG_WARNING("Invalid or missing frame " << currentFrame + 1 << ", attempting to read frame " << currentFrame + 2
+                                                                        << ".");
+
                     {
-                        auto& maskFeed = *maskFeeds.at(mediaIndex);
-                        currentMatMask = readImage(maskFeed, rescaledWidthSharpness);
+                        // Push dummy scores for the frame that was skipped
+                        const std::scoped_lock lock(_mutex);
+                        _sharpnessScores[currentFrame] = -1.f;
+                        _flowScores[currentFrame] = -1.f;
                     }
-                }
-                catch (const std::invalid_argument& ex)
-                {
-                    bool success = false;
-                    while (!success && currentFrame < nbFrames)
-                    {
-                        // currentFrame + 1 = currently evaluated frame with indexing starting at 1, for display reasons
-                        // currentFrame + 2 = next frame to evaluate with indexing starting at 1, for display reasons
-                        ALICEVISION_LOG_WARNING("Invalid or missing frame " << currentFrame + 1 << ", attempting to read frame " << currentFrame + 2
-                                                                            << ".");
 
-                        {
-                            // Push dummy scores for the frame that was skipped
-                            const std::scoped_lock lock(_mutex);
-                            _sharpnessScores[currentFrame] = -1.f;
-                            _flowScores[currentFrame] = -1.f;
-                        }
-
-                        success = feed.goToFrame(++currentFrame);
-                        if (success)
-                        {
-                            currentMatSharpness = readImage(feed, rescaledWidthSharpness);
+                    success = feed.goToFrame(++currentFrame);
+                    if (success)
+                    {
+                        if (maskFeed)
+                            maskFeed->goToFrame(currentFrame);
 
-                            if (masksProvided)
-                            {
-                                auto& maskFeed = *maskFeeds.at(mediaIndex);
-                                maskFeed.goToFrame(currentFrame);
-                                currentMatMask = readImage(maskFeed, rescaledWidthSharpness);
-                            }
-                        }
+                        readFrameImages(feed, maskFeed, rescaledWidthSharpness, rescaledWidthFlow, skipSharpnessComputation, currentImages);
                     }
                 }
             }
 
-            if (rescaledWidthSharpness == rescaledWidthFlow && !skipSharpnessComputation)
-            {
-                currentMatFlow = currentMatSharpness;
-                if (masksProvided)
-                {
-                    auto& maskFeed = *maskFeeds.at(mediaIndex);
-                    currentMatFlowMask = currentMatMask;
-                }
-            }
-            else
-            {
-                currentMatFlow = readImage(feed, rescaledWidthFlow);
-                if (masksProvided)
-                {
-                    auto& maskFeed = *maskFeeds.at(mediaIndex);
-                    currentMatFlowMask = readImage(maskFeed, rescaledWidthFlow);
-                }
-            }
-
             // Compute sharpness
             if (!skipSharpnessComputation)
             {
-                const double sharpness = computeSharpness(currentMatSharpness, sharpnessWindowSize, currentMatMask);
+                const double sharpness = computeSharpness(currentImages.sharpness, sharpnessWindowSize, currentImages.sharpnessMask);
                 minimalSharpness = std::min(minimalSharpness, sharpness);
             }
 
             // Compute optical flow
-            if (currentFrame > startFrame)
+            if (currentFrame > startFrame && !previousMatFlow.at(mediaIndex).empty())
             {
-                const double flow = estimateFlow(ptrFlow, currentMatFlow, previousMatFlow, flowCellSize, currentMatFlowMask);
+                const double flow =
+                  estimateFlow(ptrFlow, currentImages.flow, previousMatFlow.at(mediaIndex), flowCellSize, currentImages.flowMask);
                 minimalFlow = std::min(minimalFlow, flow);
             }
+            // The current frame is the previous one of the next iteration, no need to read it again
+            previousMatFlow.at(mediaIndex) = currentImages.flow;
 
             std::string rigInfo = feeds.size() > 1 ? " (media " + std::to_string(mediaIndex + 1) + "/" + std::to_string(feeds.size()) + ")" : "";
             ALICEVISION_LOG_INFO("Finished processing frame " << currentFrame + 1 << "/" << nbFrames << rigInfo);
@@ -657,13 +739,325 @@ bool KeyframeSelector::computeScoresProc(const std::size_t startFrame,
             // Save scores for the current frame
             const std::scoped_lock lock(_mutex);
             _sharpnessScores[currentFrame] = minimalSharpness;
-            _flowScores[currentFrame] = currentFrame > startFrame ? minimalFlow : -1.f;
+            _flowScores[currentFrame] = (currentFrame > startFrame && minimalFlow < std::numeric_limits<double>::max()) ? minimalFlow : -1.f;
         }
         ++currentFrame;
     }
     return true;
 }
 
+bool KeyframeSelector::computeScoresPipeline(const std::size_t nbFrames,
+                                             const std::size_t rescaledWidthSharpness,
+                                             const std::size_t rescaledWidthFlow,
+                                             const std::size_t sharpnessWindowSize,
+                                             const std::size_t flowCellSize,
+                                             const bool skipSharpnessComputation,
+                                             const bool useGpu)
+{
+    // Frame of all the medias, decoded and rescaled once, with the previous frame for the optical flow
+    struct DecodedFrame
+    {
+        std::size_t frameIndex = 0;
+        bool valid = true;
+        std::vector<FrameImages> images;
+        /// Previous valid frame of each media rescaled for the optical flow, empty for the first frame
+        std::vector<cv::Mat> previousFlow;
+    };
+
+    const bool masksProvided = _maskPaths.size() > 0;
+
+    // The decoding thread runs alongside the scoring threads, the GPU scoring thread processes the frames by batches
+    const int nbWorkers = useGpu ? 1 : std::max(1, omp_get_max_threads() - 1);
+    const std::size_t batchSize = useGpu ? gpuScoringBatchSize : 1;
+    // Maximum number of decoded frames waiting to be scored
+    const std::size_t maxPendingFrames = 2 * std::max(static_cast<std::size_t>(nbWorkers), batchSize);
+
+    std::deque<DecodedFrame> frameQueue;
+    std::mutex frameQueueMutex;
+    std::condition_variable frameDecoded;
+    std::condition_variable frameScored;
+    bool decodingDone = false;
+    bool failed = false;
+    std::exception_ptr exception;
+
+    const auto setException = [&]() {
+        {
+            std::lock_guard<std::mutex> lock(frameQueueMutex);
+            if (!exception)
+                exception = std::current_exception();
+            failed = true;
+        }
+        frameDecoded.notify_all();
+        frameScored.notify_all();
+    };
+
+    ALICEVISION_LOG_INFO("Decoding " << nbFrames << " frames once for " << nbWorkers << (useGpu ? " GPU" : "") << " scoring thread(s).");
+
+    std::thread decoder([&]() {
+        try
+        {
+            std::vector<std::unique_ptr<dataio::FeedProvider>> feeds;
+            std::vector<std::unique_ptr<dataio::FeedProvider>> maskFeeds;
+
+            for (std::size_t mediaIndex = 0; mediaIndex < _mediaPaths.size(); ++mediaIndex)
+            {
+                feeds.push_back(std::make_unique<dataio::FeedProvider>(_mediaPaths.at(mediaIndex)));
+                if (!feeds.back()->isInit())
+                {
+                    ALICEVISION_THROW(std::invalid_argument, "Cannot initialize the FeedProvider with " << _mediaPaths.at(mediaIndex));
+                }
+
+                if (masksProvided)
+                {
+                    maskFeeds.push_back(std::make_unique<dataio::FeedProvider>(_maskPaths.at(mediaIndex)));
+                    if (!maskFeeds.back()->isInit())
+                    {
+                        ALICEVISION_THROW(std::invalid_argument, "Invalid path to masks: " << _maskPaths.at(mediaIndex));
+                    }
+                }
+            }
+
+            std::vector<cv::Mat> previousFlow;
+
+            for (std::size_t frameIndex = 0; frameIndex < nbFrames; ++frameIndex)
+            {
+                DecodedFrame frame;
+                frame.frameIndex = frameIndex;
+                frame.images.resize(feeds.size());
+
+                for (std::size_t mediaIndex = 0; mediaIndex < feeds.size(); ++mediaIndex)
+                {
+                    auto& feed = *feeds.at(mediaIndex);
+                    dataio::FeedProvider* maskFeed = masksProvided ? maskFeeds.at(mediaIndex).get() : nullptr;
+
+                    // Sequential reading: the decoder never seeks after the first frame
+                    bool moved = (frameIndex == 0) ? feed.goToFrame(0) : feed.goToNextFrame();
+                    if (maskFeed)
+                        moved = ((frameIndex == 0) ? maskFeed->goToFrame(0) : maskFeed->goToNextFrame()) && moved;
+
+                    if (!moved || !frame.valid)
+                    {
+                        // Keep moving the other medias of the rig to stay synchronized
+                        frame.valid = false;
+                        continue;
+                    }
+
+                    try
+                    {
+                        readFrameImages(
+                          feed, maskFeed, rescaledWidthSharpness, rescaledWidthFlow, skipSharpnessComputation, frame.images.at(mediaIndex));
+                    }
+                    catch (const std::invalid_argument& ex)
+                    {
+                        frame.valid = false;
+                    }
+                }
+
+                if (frame.valid)
+                {
+                    frame.previousFlow = previousFlow;
+                    previousFlow.resize(feeds.size());
+                    for (std::size_t mediaIndex = 0; mediaIndex < feeds.size(); ++mediaIndex)
+                        previousFlow.at(mediaIndex) = frame.images.at(mediaIndex).flow;
+                }
+                else
+                {
+                    ALICEVISION_LOG_WARNING("Invalid or missing frame " << frameIndex + 1 << ", dummy scores will be used for it.");
+                    frame.images.clear();
+                }
+
+                {
+                    std::unique_lock<std::mutex> lock(frameQueueMutex);
+                    frameScored.wait(lock, [&]() { return failed || frameQueue.size() < maxPendingFrames; });
+                    if (failed)
+                        return;
+                    frameQueue.push_back(std::move(frame));
+                }
+                frameDecoded.notify_one();
+            }
+        }
+        catch (...)
+        {
+            setException();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(frameQueueMutex);
+            decodingDone = true;
+        }
+        frameDecoded.notify_all();
+    });
+
+    // Wait for at least one decoded frame and pop up to batchSize frames, return false once all the frames are scored
+    const auto popFrames = [&](std::vector<DecodedFrame>& frames) {
+        frames.clear();
+        {
+            std::unique_lock<std::mutex> lock(frameQueueMutex);
+            frameDecoded.wait(lock, [&]() { return failed || decodingDone || !frameQueue.empty(); });
+            if (failed)
+                return false;
+            while (!frameQueue.empty() && frames.size() < batchSize)
+            {
+                frames.push_back(std::move(frameQueue.front()));
+                frameQueue.pop_front();
+            }
+        }
+        frameScored.notify_one();
+        return !frames.empty();
+    };
+
+    const auto saveScores = [&](const DecodedFrame& frame, double minimalSharpness, double minimalFlow) {
+        {
+            // Save scores for the current frame
+            const std::scoped_lock lock(_mutex);
+            _sharpnessScores[frame.frameIndex] = frame.valid ? minimalSharpness : -1.f;
+            _flowScores[frame.frameIndex] = (frame.valid && !frame.previousFlow.empty()) ? minimalFlow : -1.f;
+        }
+
+        ALICEVISION_LOG_INFO("Finished processing frame " << frame.frameIndex + 1 << "/" << nbFrames);
+    };
+
+    std::vector<std::thread> workers;
+    for (int i = 0; i < nbWorkers; ++i)
+    {
+        workers.emplace_back([&]() {
+            try
+            {
+                std::vector<DecodedFrame> frames;
+
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_OPENCV_CUDA)
+                if (useGpu)
+                {
+                    CudaScorer scorer;
+                    std::vector<cv::Mat> laplacians;
+                    std::vector<cv::Mat> flows;
+
+                    while (popFrames(frames))
+                    {
+                        // Flatten the batch: one entry per media of each valid frame
+                        std::vector<const cv::Mat*> batchSharpness;
+                        std::vector<const cv::Mat*> batchFlow;
+                        std::vector<const cv::Mat*> batchPreviousFlow;
+                        for (const DecodedFrame& frame : frames)
+                        {
+                            for (std::size_t mediaIndex = 0; mediaIndex < frame.images.size(); ++mediaIndex)
+                            {
+                                batchSharpness.push_back(&frame.images.at(mediaIndex).sharpness);
+                                batchFlow.push_back(&frame.images.at(mediaIndex).flow);
+                                batchPreviousFlow.push_back(frame.previousFlow.empty() ? nullptr : &frame.previousFlow.at(mediaIndex));
+                            }
+                        }
+
+                        scorer.compute(batchSharpness, batchFlow, batchPreviousFlow, skipSharpnessComputation, laplacians, flows);
+
+                        std::size_t batchIndex = 0;
+                        for (const DecodedFrame& frame : frames)
+                        {
+                            double minimalSharpness = skipSharpnessComputation ? 1.0f : std::numeric_limits<double>::max();
+                            double minimalFlow = std::numeric_limits<double>::max();
+                            for (std::size_t mediaIndex = 0; mediaIndex < frame.images.size(); ++mediaIndex, ++batchIndex)
+                            {
+                                const FrameImages& images = frame.images.at(mediaIndex);
+
+                                if (!skipSharpnessComputation)
+                                {
+                                    const double sharpness =
+                                      computeSharpnessFromLaplacian(laplacians.at(batchIndex), sharpnessWindowSize, images.sharpnessMask);
+                                    minimalSharpness = std::min(minimalSharpness, sharpness);
+                                }
+
+                                if (!frame.previousFlow.empty())
+                                {
+                                    const double flow = computeFlowScore(flows.at(batchIndex), flowCellSize, images.flowMask);
+                                    minimalFlow = std::min(minimalFlow, flow);
+                                }
+                            }
+                            saveScores(frame, minimalSharpness, minimalFlow);
+                        }
+                    }
+                    return;
+                }
+#endif
+
+                auto ptrFlow = cv::optflow::createOptFlow_DeepFlow();
+
+                while (popFrames(frames))
+                {
+                    const DecodedFrame& frame = frames.front();
+
+                    double minimalSharpness = skipSharpnessComputation ? 1.0f : std::numeric_limits<double>::max();
+                    double minimalFlow = std::numeric_limits<double>::max();
+
+                    for (std::size_t mediaIndex = 0; mediaIndex < frame.images.size(); ++mediaIndex)
+                    {
+                        const FrameImages& images = frame.images.at(mediaIndex);
+
+                        // Compute sharpness
+                        if (!skipSharpnessComputation)
+                        {
+                            const double sharpness = computeSharpness(images.sharpness, sharpnessWindowSize, images.sharpnessMask);
+                            minimalSharpness = std::min(minimalSharpness, sharpness);
+                        }
+
+                        // Compute optical flow
+                        if (!frame.previousFlow.empty())
+                        {
+                            const double flow = estimateFlow(ptrFlow, images.flow, frame.previousFlow.at(mediaIndex), flowCellSize, images.flowMask);
+                            minimalFlow = std::min(minimalFlow, flow);
+                        }
+                    }
+
+                    saveScores(frame, minimalSharpness, minimalFlow);
+                }
+            }
+            catch (...)
+            {
+                setException();
+            }
+        });
+    }
+
+    decoder.join();
+    for (auto& worker : workers)
+        worker.join();
+
+    if (exception)
+        std::rethrow_exception(exception);
+
+    return true;
+}
+
+void KeyframeSelector::readFrameImages(dataio::FeedProvider& feed,
+                                       dataio::FeedProvider* maskFeed,
+                                       const std::size_t rescaledWidthSharpness,
+                                       const std::size_t rescaledWidthFlow,
+                                       const bool skipSharpnessComputation,
+                                       FrameImages& images)
+{
+    const auto rescale = [](const cv::Mat& grayscale, std::size_t width) {
+        if (width == 0 || static_cast<std::size_t>(grayscale.cols) <= width)
+            return grayscale;
+
+        cv::Mat rescaled;
+        cv::resize(grayscale, rescaled, cv::Size(width, double(grayscale.rows) * double(width) / double(grayscale.cols)));
+        return rescaled;
+    };
+
+    // Decode each frame once, and only rescale it for each computation
+    const cv::Mat frame = readImage(feed);
+    images.flow = rescale(frame, rescaledWidthFlow);
+    if (!skipSharpnessComputation)
+        images.sharpness = (rescaledWidthSharpness == rescaledWidthFlow) ? images.flow : rescale(frame, rescaledWidthSharpness);
+
+    if (maskFeed)
+    {
+        const cv::Mat mask = readImage(*maskFeed);
+        images.flowMask = rescale(mask, rescaledWidthFlow);
+        if (!skipSharpnessComputation)
+            images.sharpnessMask = (rescaledWidthSharpness == rescaledWidthFlow) ? images.flowMask : rescale(mask, rescaledWidthSharpness);
+    }
+}
+
 bool KeyframeSelector::writeSelection(const std::vector<std::string>& brands,
                                       const std::vector<std::string>& models,
                                       const std::vector<float>& mmFocals,
@@ -984,35 +1378,42 @@ cv::Mat KeyframeSelector::readImage(dataio::FeedProvider& feed, std::size_t widt
     if (width == 0)
         return cvGrayscale;
 
+    if (static_cast<std::size_t>(cvGrayscale.cols) <= width)
+        return cvGrayscale;
+
     cv::Mat cvRescaled;
-    if (cvGrayscale.cols > width && width > 0)
-    {
-        cv::resize(cvGrayscale, cvRescaled, cv::Size(width, double(cvGrayscale.rows) * double(width) / double(cvGrayscale.cols)));
-    }
+    cv::resize(cvGrayscale, cvRescaled, cv::Size(width, double(cvGrayscale.rows) * double(width) / double(cvGrayscale.cols)));
 
     return cvRescaled;
 }
 
 double KeyframeSelector::computeSharpness(const cv::Mat& grayscaleImage, const std::size_t windowSize, const cv::Mat& mask)
 {
-    if (windowSize > grayscaleImage.size().width || windowSize > grayscaleImage.size().height)
+    cv::Mat laplacian;
+    cv::Laplacian(grayscaleImage, laplacian, CV_64F);
+
+    return computeSharpnessFromLaplacian(laplacian, windowSize, mask);
+}
+
+double KeyframeSelector::computeSharpnessFromLaplacian(const cv::Mat& laplacian, const std::size_t windowSize, const cv::Mat& mask)
+{
+    if (windowSize > laplacian.size().width || windowSize > laplacian.size().height)
     {
         ALICEVISION_THROW(std::invalid_argument,
                           "Cannot use a sliding window bigger than the image (sliding window size: "
-                            << windowSize << ", image size: " << grayscaleImage.size().width << "x" << grayscaleImage.size().height << ")");
+                            << windowSize << ", image size: " << laplacian.size().width << "x" << laplacian.size().height << ")");
     }
 
-    if (!mask.empty() && (mask.size().width != grayscaleImage.size().width || mask.size().height != grayscaleImage.size().height))
+    if (!mask.empty() && (mask.size().width != laplacian.size().width || mask.size().height != laplacian.size().height))
     {
         ALICEVISION_THROW(std::invalid_argument,
                           "The sizes of the frame and the mask differ (image size: "
-                            << grayscaleImage.size().width << "x" << grayscaleImage.size().height << ", mask size: " << mask.size().width << "x"
+                            << laplacian.size().width << "x" << laplacian.size().height << ", mask size: " << mask.size().width << "x"
                             << mask.size().height << ")");
     }
 
-    cv::Mat sum, squaredSum, laplacian;
-    cv::Laplacian(grayscaleImage, laplacian, CV_64F);
-    cv::integral(laplacian, sum, squaredSum);
+    cv::Mat sum, squaredSum;
+    cv::integral(laplacian, sum, squaredSum, CV_64F, CV_64F);
 
     cv::Mat maskedSum = sum;
     cv::Mat maskedSquaredSum = squaredSum;
@@ -1106,13 +1507,6 @@ double KeyframeSelector::estimateFlow(const cv::Ptr<cv::DenseOpticalFlow>& ptrFl
                                       const std::size_t cellSize,
                                       const cv::Mat& mask)
 {
-    if (cellSize > grayscaleImage.size().width)
-    {  // If the cell size is bigger than the height, it will be adjusted
-        ALICEVISION_THROW(std::invalid_argument,
-                          "Cannot use a cell size bigger than the image's width (cell size: " << cellSize << ", image's width: "
-                                                                                              << grayscaleImage.size().width << ")");
-    }
-
     if (grayscaleImage.size() != previousGrayscaleImage.size())
     {
         ALICEVISION_THROW(std::invalid_argument,
@@ -1121,17 +1515,29 @@ double KeyframeSelector::estimateFlow(const cv::Ptr<cv::DenseOpticalFlow>& ptrFl
                             << "x" << previousGrayscaleImage.size().height << ")");
     }
 
-    if (!mask.empty() && (grayscaleImage.size().width != mask.size().width || grayscaleImage.size().height != mask.size().height))
+    cv::Mat flow;
+    ptrFlow->calc(grayscaleImage, previousGrayscaleImage, flow);
+
+    return computeFlowScore(flow, cellSize, mask);
+}
+
+double KeyframeSelector::computeFlowScore(const cv::Mat& flow, const std::size_t cellSize, const cv::Mat& mask)
+{
+    if (cellSize > flow.size().width)
+    {  // If the cell size is bigger than the height, it will be adjusted
+        ALICEVISION_THROW(std::invalid_argument,
+                          "Cannot use a cell size bigger than the image's width (cell size: " << cellSize << ", image's width: "
+                                                                                              << flow.size().width << ")");
+    }
+
+    if (!mask.empty() && (flow.size().width != mask.size().width || flow.size().height != mask.size().height))
     {
         ALICEVISION_THROW(std::invalid_argument,
                           "The sizes of the framse and the masks differ (image size: "
-                            << grayscaleImage.size().width << "x" << grayscaleImage.size().height << ", mask size: " << mask.size().width << "x"
+                            << flow.size().width << "x" << flow.size().height << ", mask size: " << mask.size().width << "x"
                             << mask.size().height << ")");
     }
 
-    cv::Mat flow;
-    ptrFlow->calc(grayscaleImage, previousGrayscaleImage, flow);
-
     cv::Mat sumflow;
     cv::integral(flow, sumflow, CV_64F);
 
@@ -179,11 +179,20 @@ class KeyframeSelector
     void setMaxOutFrames(unsigned int nbFrames) { _maxOutFrames = nbFrames; }
 
     /**
-     * @brief Set the minimum size of the blocks of frames for the multi-threading
+     * @brief Set the minimum size of the blocks of frames for the multi-threading of the image sequences
+     *        (the videos are decoded once by a single thread feeding the scoring threads)
      * @param[in] blockSize minimum number of frames in a block for a thread to be spawned
      */
     void setMinBlockSize(std::size_t blockSize) { _minBlockSize = blockSize; }
 
+    /**
+     * @brief Compute the sharpness and optical flow scores on the GPU, by batches of frames, if possible
+     *        (requires OpenCV with the CUDA modules and a CUDA device, the CPU is used otherwise)
+     * @note The GPU optical flow is a Farneback flow instead of a DeepFlow: the motion scores are close but not identical.
+     * @param[in] useGpu true to compute the scores on the GPU
+     */
+    void setUseGpu(bool useGpu) { _useGpu = useGpu; }
+
     /**
      * @brief Get the minimum frame step parameter for the processing algorithm
      * @return minimum number of frames between two keyframes
@@ -209,6 +218,18 @@ class KeyframeSelector
     unsigned int getMaxOutFrames() const { return _maxOutFrames; }
 
   private:
+    /**
+     * @brief Grayscale frame of a media, rescaled for the sharpness and the optical flow computations
+     *        (the matrices share their data when both widths are equal), with its rescaled masks if masks are provided
+     */
+    struct FrameImages
+    {
+        cv::Mat sharpness;
+        cv::Mat flow;
+        cv::Mat sharpnessMask;
+        cv::Mat flowMask;
+    };
+
     /**
      * @brief Read an image from a feed provider into a grayscale OpenCV matrix, and rescale it if a size is provided
      * @param[in] feed The feed provider
@@ -218,6 +239,49 @@ class KeyframeSelector
      */
     cv::Mat readImage(dataio::FeedProvider& feed, std::size_t width = 0);
 
+    /**
+     * @brief Read the current frame of a feed provider once, and rescale it for the sharpness and the optical flow computations
+     * @param[in] feed the feed provider
+     * @param[in] maskFeed the feed provider of the masks, nullptr if no masks are provided
+     * @param[in] rescaledWidthSharpness the width to resize the frame to for the sharpness computation (0: no rescale)
+     * @param[in] rescaledWidthFlow the width to resize the frame to for the optical flow computation (0: no rescale)
+     * @param[in] skipSharpnessComputation if true, the frame is not rescaled for the sharpness computation
+     * @param[out] images the rescaled frame and masks
+     * @throw std::invalid_argument if the frame or its mask cannot be read
+     */
+    void readFrameImages(dataio::FeedProvider& feed,
+                         dataio::FeedProvider* maskFeed,
+                         const std::size_t rescaledWidthSharpness,
+                         const std::size_t rescaledWidthFlow,
+                         const bool skipSharpnessComputation,
+                         FrameImages& images);
+
+    /**
+     * @brief Compute the sharpness and optical flow scores of all the frames by decoding the input medias once:
+     *        a single thread reads the frames sequentially, without seeking, and feeds a bounded queue of rescaled
+     *        frames to the scoring threads. Used for the videos, whose seeks decode whole groups of pictures,
+     *        and for the GPU scoring.
+     * @param[in] nbFrames the total number of frames in the sequence
+     * @param[in] rescaledWidthSharpness the width to resize the input frames to before using them to compute the
+     *            sharpness scores (if equal to 0, no rescale will be performed)
+     * @param[in] rescaledWidthFlow the width to resize the input frames to before using them to compute the
+     *            motion scores (if equal to 0, no rescale will be performed)
+     * @param[in] sharpnessWindowSize the size of the sliding window used to compute sharpness scores, in pixels
+     * @param[in] flowCellSize the size of the cells within a frame that are used to compute the optical flow scores,
+     *            in pixels
+     * @param[in] skipSharpnessComputation if true, the sharpness score computations will not be performed and a fixed
+     *            sharpness score will be given to all the input frames
+     * @param[in] useGpu if true, a single GPU scoring thread processes the frames by batches
+     * @return true if the scores have been successfully computed for all frames, false otherwise
+     */
+    bool computeScoresPipeline(const std::size_t nbFrames,
+                               const std::size_t rescaledWidthSharpness,
+                               const std::size_t rescaledWidthFlow,
+                               const std::size_t sharpnessWindowSize,
+                               const std::size_t flowCellSize,
+                               const bool skipSharpnessComputation,
+                               const bool useGpu);
+
     /**
      * @brief Compute the sharpness and optical flow scores for the input media paths for a given range of frames
      * @param[in] startFrame the index of the first frame to compute the scores for
@@ -252,6 +316,15 @@ class KeyframeSelector
      */
     double computeSharpness(const cv::Mat& grayscaleImage, const std::size_t windowSize, const cv::Mat& mask);
 
+    /**
+     * @brief Compute the sharpness scores of a frame with a sliding window from its Laplacian
+     * @param[in] laplacian the Laplacian of the grayscale frame (CV_32F or CV_64F)
+     * @param[in] windowSize the size of the sliding window
+     * @param[in] mask the mask associated to the input frame if it exists, an empty cv::Mat otherwise
+     * @return a double value representing the sharpness score of the sharpest tile in the image
+     */
+    double computeSharpnessFromLaplacian(const cv::Mat& laplacian, const std::size_t windowSize, const cv::Mat& mask);
+
     /**
      * @brief Compute the standard deviation of the local averaged Laplacian in an image
      * @param[in] sum the (masked) integral image of the Laplacian of a given image
@@ -284,6 +357,15 @@ class KeyframeSelector
                         const std::size_t cellSize,
                         const cv::Mat& mask);
 
+    /**
+     * @brief Compute the optical flow score of a frame cell by cell from its dense optical flow
+     * @param[in] flow the dense optical flow between the frame and its previous frame (CV_32FC2)
+     * @param[in] cellSize the size of the evaluated cells within the frame
+     * @param[in] mask the mask associated to the current frame if it exists, an empty cv::Mat otherwise
+     * @return a double value representing the median motion of all the image's cells
+     */
+    double computeFlowScore(const cv::Mat& flow, const std::size_t cellSize, const cv::Mat& mask);
+
     /**
      * @brief Write the output SfMData files with the selected and non-selected keyframes information
      * @param[in] mediaPath input video file path, image sequence directory or SfMData file
@@ -386,6 +468,8 @@ class KeyframeSelector
 
     /// Minimum block size for multi-threading
     std::size_t _minBlockSize = 10;
+    /// Compute the scores on the GPU if possible
+    bool _useGpu = false;
 
     /// Sharpness scores for each frame
     std::map<std::size_t, double> _sharpnessScores;
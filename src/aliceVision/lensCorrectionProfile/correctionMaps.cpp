@@ -0,0 +1,266 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "correctionMaps.hpp"
+
+#include <aliceVision/image/Sampler.hpp>
+#include <aliceVision/numeric/numeric.hpp>
+#include <aliceVision/stl/hash.hpp>
+#include <aliceVision/system/Logger.hpp>
+#include <aliceVision/system/Timer.hpp>
+
+#include <algorithm>
+
+namespace aliceVision {
+
+VignettingMap::VignettingMap(const std::vector<float>& vparam, int width, int height)
+  : _width(width),
+    _height(height),
+    _gains(static_cast<std::size_t>(width) * height, 1.f)
+{
+    if (!isValid(vparam))
+    {
+        return;
+    }
+
+    const float focX = vparam[0];
+    const float focY = vparam[1];
+    const float imageXCenter = vparam[2];
+    const float imageYCenter = vparam[3];
+
+    const float p1 = -vparam[4];
+    const float p2 = vparam[4] * vparam[4] - vparam[5];
+    const float p3 = -(vparam[4] * vparam[4] * vparam[4] - 2 * vparam[4] * vparam[5] + vparam[6]);
+    const float p4 =
+      vparam[4] * vparam[4] * vparam[4] * vparam[4] + vparam[5] * vparam[5] + 2 * vparam[4] * vparam[6] - 3 * vparam[4] * vparam[4] * vparam[5];
+
+#pragma omp parallel for
+    for (int j = 0; j < height; ++j)
+    {
+        float* rowGains = _gains.data() + static_cast<std::size_t>(j) * width;
+        for (int i = 0; i < width; ++i)
+        {
+            const Vec2 p(i, j);
+
+            Vec2 np;
+            np(0) = ((p(0) / width) - imageXCenter) / focX;
+            np(1) = ((p(1) / height) - imageYCenter) / focY;
+
+            const float rsqr = np(0) * np(0) + np(1) * np(1);
+            rowGains[i] = 1.f + p1 * rsqr + p2 * rsqr * rsqr + p3 * rsqr * rsqr * rsqr + p4 * rsqr * rsqr * rsqr * rsqr;
+        }
+    }
+}
+
+void VignettingMap::apply(image::Image<image::RGBAfColor>& image) const
+{
+    using ArrayRow = Eigen::Map<Eigen::Array<float, 4, Eigen::Dynamic>>;
+    using GainsRow = Eigen::Map<const Eigen::Array<float, 1, Eigen::Dynamic>>;
+
+#pragma omp parallel for
+    for (int j = 0; j < _height; ++j)
+    {
+        ArrayRow row(image(j, 0).data(), 4, _width);
+        row.rowwise() *= GainsRow(_gains.data() + static_cast<std::size_t>(j) * _width, _width);
+    }
+}
+
+void VignettingMap::apply(image::Image<image::RGBAfColor>& image, float colorFactor) const
+{
+#pragma omp parallel for
+    for (int j = 0; j < _height; ++j)
+    {
+        const float* rowGains = _gains.data() + static_cast<std::size_t>(j) * _width;
+        for (int i = 0; i < _width; ++i)
+        {
+            image::RGBAfColor& pixel = image(j, i);
+            const float gain = rowGains[i];
+            pixel.r() = (pixel.r() * colorFactor) * gain;
+            pixel.g() = (pixel.g() * colorFactor) * gain;
+            pixel.b() = (pixel.b() * colorFactor) * gain;
+            pixel.a() *= gain;
+        }
+    }
+}
+
+ChromaticAberrationMap::ChromaticAberrationMap(const RectilinearModel& greenModel,
+                                               const RectilinearModel& blueGreenModel,
+                                               const RectilinearModel& redGreenModel,
+                                               int width,
+                                               int height,
+                                               bool undistortGeometry)
+  : _width(width),
+    _height(height),
+    _positions(static_cast<std::size_t>(width) * height * 6)
+{
+    const float maxWH = std::max(width, height);
+    const float ppX = greenModel.ImageXCenter * width;
+    const float ppY = greenModel.ImageYCenter * height;
+    const float scaleX = greenModel.FocalLengthX * maxWH;
+    const float scaleY = greenModel.FocalLengthY * maxWH;
+
+#pragma omp parallel for
+    for (int v = 0; v < height; ++v)
+    {
+        // RectilinearModel::distort is not const
+        RectilinearModel green = greenModel;
+        RectilinearModel blueGreen = blueGreenModel;
+        RectilinearModel redGreen = redGreenModel;
+
+        float* rowPositions = _positions.data() + static_cast<std::size_t>(v) * width * 6;
+        for (int u = 0; u < width; ++u)
+        {
+            // image to camera
+            const float x = (u - ppX) / scaleX;
+            const float y = (v - ppY) / scaleY;
+
+            // disto
+            float xdRed, ydRed, xdGreen, ydGreen, xdBlue, ydBlue;
+            if (undistortGeometry)
+            {
+                green.distort(x, y, xdGreen, ydGreen);
+            }
+            else
+            {
+                xdGreen = x;
+                ydGreen = y;
+            }
+            redGreen.distort(xdGreen, ydGreen, xdRed, ydRed);
+            blueGreen.distort(xdGreen, ydGreen, xdBlue, ydBlue);
+
+            // camera to image
+            float* position = rowPositions + 6 * u;
+            position[0] = xdRed * scaleX + ppX;
+            position[1] = ydRed * scaleY + ppY;
+            position[2] = xdGreen * scaleX + ppX;
+            position[3] = ydGreen * scaleY + ppY;
+            position[4] = xdBlue * scaleX + ppX;
+            position[5] = ydBlue * scaleY + ppY;
+        }
+    }
+}
+
+void ChromaticAberrationMap::remap(const image::Image<image::RGBAfColor>& imageIn,
+                                   image::Image<image::RGBAfColor>& imageOut,
+                                   const image::RGBAfColor& fillcolor) const
+{
+    imageOut.resize(_width, _height, true, fillcolor);
+    const image::Sampler2d<image::SamplerLinear> sampler;
+
+#pragma omp parallel for
+    for (int v = 0; v < _height; ++v)
+    {
+        const float* rowPositions = _positions.data() + static_cast<std::size_t>(v) * _width * 6;
+        for (int u = 0; u < _width; ++u)
+        {
+            const float* position = rowPositions + 6 * u;
+
+            // pick pixel if it is in the image domain
+            for (int channel = 0; channel < 3; ++channel)
+            {
+                const float x = position[2 * channel];
+                const float y = position[2 * channel + 1];
+                if (imageIn.contains(y, x))
+                {
+                    imageOut(v, u)[channel] = sampler(imageIn, y, x)[channel];
+                }
+            }
+        }
+    }
+}
+
+LensCorrectionMapCache& LensCorrectionMapCache::get()
+{
+    static LensCorrectionMapCache cache;
+    return cache;
+}
+
+namespace {
+
+std::size_t hashModel(const RectilinearModel& model)
+{
+    std::size_t seed = 0;
+    stl::hash_combine(seed, model.FocalLengthX);
+    stl::hash_combine(seed, model.FocalLengthY);
+    stl::hash_combine(seed, model.ImageXCenter);
+    stl::hash_combine(seed, model.ImageYCenter);
+    stl::hash_combine(seed, model.RadialDistortParam1);
+    stl::hash_combine(seed, model.RadialDistortParam2);
+    stl::hash_combine(seed, model.RadialDistortParam3);
+    stl::hash_combine(seed, model.TangentialDistortParam1);
+    stl::hash_combine(seed, model.TangentialDistortParam2);
+    stl::hash_combine(seed, model.ScaleFactor);
+    return seed;
+}
+
+/**
+ * @brief Get the entry of a key in a cache map, building its map at the first request outside of the cache lock.
+ */
+template<typename Entry, typename Build>
+auto getOrBuild(std::mutex& mutex, std::map<std::tuple<std::size_t, int, int>, std::shared_ptr<Entry>>& entries, const std::tuple<std::size_t, int, int>& key, Build build)
+{
+    std::shared_ptr<Entry> entry;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::shared_ptr<Entry>& cached = entries[key];
+        if (!cached)
+            cached = std::make_shared<Entry>();
+        entry = cached;
+    }
+
+    std::call_once(entry->built, [&]() { entry->map = build(); });
+
+    return entry->map;
+}
+
+}  // namespace
+
+std::shared_ptr<const VignettingMap> LensCorrectionMapCache::getVignettingMap(const std::vector<float>& vparam, int width, int height)
+{
+    std::size_t seed = 0;
+    for (float param : vparam)
+    {
+        stl::hash_combine(seed, param);
+    }
+
+    return getOrBuild(_mutex, _vignettingEntries, Key(seed, width, height), [&]() {
+        system::Timer timer;
+        std::shared_ptr<const VignettingMap> map = std::make_shared<const VignettingMap>(vparam, width, height);
+        ALICEVISION_LOG_DEBUG("Vignetting map " << width << "x" << height << " built in " << timer.elapsedMs() << " ms.");
+        return map;
+    });
+}
+
+std::shared_ptr<const ChromaticAberrationMap> LensCorrectionMapCache::getChromaticAberrationMap(const RectilinearModel& greenModel,
+                                                                                                const RectilinearModel& blueGreenModel,
+                                                                                                const RectilinearModel& redGreenModel,
+                                                                                                int width,
+                                                                                                int height,
+                                                                                                bool undistortGeometry)
+{
+    std::size_t seed = 0;
+    stl::hash_combine(seed, hashModel(greenModel));
+    stl::hash_combine(seed, hashModel(blueGreenModel));
+    stl::hash_combine(seed, hashModel(redGreenModel));
+    stl::hash_combine(seed, undistortGeometry);
+
+    return getOrBuild(_mutex, _chromaticAberrationEntries, Key(seed, width, height), [&]() {
+        system::Timer timer;
+        std::shared_ptr<const ChromaticAberrationMap> map =
+          std::make_shared<const ChromaticAberrationMap>(greenModel, blueGreenModel, redGreenModel, width, height, undistortGeometry);
+        ALICEVISION_LOG_DEBUG("Chromatic aberration map " << width << "x" << height << " built in " << timer.elapsedMs() << " ms.");
+        return map;
+    });
+}
+
+void LensCorrectionMapCache::clear()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _vignettingEntries.clear();
+    _chromaticAberrationEntries.clear();
+}
+
+}  // namespace aliceVision
@@ -0,0 +1,156 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/lensCorrectionProfile/lcp.hpp>
+#include <aliceVision/image/Image.hpp>
+#include <aliceVision/image/pixelTypes.hpp>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+namespace aliceVision {
+
+/**
+ * @brief Vignetting gain of each pixel, from the parameters of a lens correction profile vignetting model.
+ *        The model is evaluated once per pixel when the map is built,
+ *        then the images of the same lens and settings are corrected with a single multiplication per pixel.
+ */
+class VignettingMap
+{
+  public:
+    /**
+     * @brief Build the map, in parallel.
+     * @param[in] vparam The vignetting model parameters (focal x, focal y, center x, center y and the 3 model parameters)
+     * @param[in] width The image width
+     * @param[in] height The image height
+     */
+    VignettingMap(const std::vector<float>& vparam, int width, int height);
+
+    /**
+     * @brief Check that the vignetting model parameters are complete.
+     */
+    static bool isValid(const std::vector<float>& vparam) { return vparam.size() >= 7; }
+
+    int width() const { return _width; }
+    int height() const { return _height; }
+
+    /**
+     * @brief Correct the vignetting of an image (all the channels are multiplied by the gain).
+     * @param[in,out] image The image, of the map size
+     */
+    void apply(image::Image<image::RGBAfColor>& image) const;
+
+    /**
+     * @brief Scale the colors of an image and correct its vignetting in a single pass.
+     *        The result is the same as a multiplication of the color channels by the factor followed by apply().
+     * @param[in,out] image The image, of the map size
+     * @param[in] colorFactor The factor of the color channels (the alpha channel is only multiplied by the gain)
+     */
+    void apply(image::Image<image::RGBAfColor>& image, float colorFactor) const;
+
+  private:
+    int _width = 0;
+    int _height = 0;
+    /// gain of each pixel, in row-major order
+    std::vector<float> _gains;
+};
+
+/**
+ * @brief Source position of the red, green and blue channels of each pixel,
+ *        from the chromatic aberration models of a lens correction profile.
+ *        The models are evaluated once per pixel when the map is built,
+ *        then the images of the same lens and settings are corrected with a gather of the three channels.
+ */
+class ChromaticAberrationMap
+{
+  public:
+    /**
+     * @brief Build the map, in parallel.
+     * @param[in] greenModel The green channel model
+     * @param[in] blueGreenModel The blue channel model, relative to the green channel
+     * @param[in] redGreenModel The red channel model, relative to the green channel
+     * @param[in] width The image width
+     * @param[in] height The image height
+     * @param[in] undistortGeometry Also undistort the geometry with the green channel model
+     */
+    ChromaticAberrationMap(const RectilinearModel& greenModel,
+                           const RectilinearModel& blueGreenModel,
+                           const RectilinearModel& redGreenModel,
+                           int width,
+                           int height,
+                           bool undistortGeometry);
+
+    int width() const { return _width; }
+    int height() const { return _height; }
+
+    /**
+     * @brief Correct the chromatic aberrations of an image (bilinear interpolation of each channel).
+     * @param[in] imageIn The image, of the map size
+     * @param[out] imageOut The corrected image
+     * @param[in] fillcolor The color of the pixels whose channels fall outside the source image
+     */
+    void remap(const image::Image<image::RGBAfColor>& imageIn, image::Image<image::RGBAfColor>& imageOut, const image::RGBAfColor& fillcolor) const;
+
+  private:
+    int _width = 0;
+    int _height = 0;
+    /// source positions (red x, red y, green x, green y, blue x, blue y) of each pixel, in row-major order
+    std::vector<float> _positions;
+};
+
+/**
+ * @brief Process-wide cache of the lens correction maps, computed once per model and image size.
+ */
+class LensCorrectionMapCache
+{
+  public:
+    static LensCorrectionMapCache& get();
+
+    /**
+     * @brief Get the vignetting map of a model, building it at the first request.
+     * @note Concurrent requests of the same map wait for a single build.
+     */
+    std::shared_ptr<const VignettingMap> getVignettingMap(const std::vector<float>& vparam, int width, int height);
+
+    /**
+     * @brief Get the chromatic aberration map of the models, building it at the first request.
+     * @note Concurrent requests of the same map wait for a single build.
+     */
+    std::shared_ptr<const ChromaticAberrationMap> getChromaticAberrationMap(const RectilinearModel& greenModel,
+                                                                            const RectilinearModel& blueGreenModel,
+                                                                            const RectilinearModel& redGreenModel,
+                                                                            int width,
+                                                                            int height,
+                                                                            bool undistortGeometry);
+
+    /**
+     * @brief Release all the cached maps.
+     */
+    void clear();
+
+  private:
+    LensCorrectionMapCache() = default;
+
+    template<typename Map>
+    struct Entry
+    {
+        std::once_flag built;
+        std::shared_ptr<const Map> map;
+    };
+
+    using Key = std::tuple<std::size_t, int, int>;
+
+    std::mutex _mutex;
+    std::map<Key, std::shared_ptr<Entry<VignettingMap>>> _vignettingEntries;
+    std::map<Key, std::shared_ptr<Entry<ChromaticAberrationMap>>> _chromaticAberrationEntries;
+};
+
+}  // namespace aliceVision
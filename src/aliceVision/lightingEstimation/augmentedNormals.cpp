@@ -9,5 +9,50 @@
 #include "augmentedNormals.hpp"
 
 namespace aliceVision {
-namespace lightingEstimation {}
+namespace lightingEstimation {
+
+int evaluateAugmentedNormals(const image::RGBfColor* normals, int nbNormals, float* coefficients, int stride)
+{
+    const float* n = normals[0].data();
+
+    float* nx = coefficients;
+    float* ny = coefficients + stride;
+    float* nz = coefficients + 2 * stride;
+    float* nambiant = coefficients + 3 * stride;
+
+    // deinterleave the normals, the validity is stored in the ambiant coefficient
+    int nbValid = 0;
+    for (int i = 0; i < nbNormals; ++i)
+    {
+        const float x = n[3 * i];
+        const float y = n[3 * i + 1];
+        const float z = n[3 * i + 2];
+        const bool valid = !(x == -1.0f && y == -1.0f && z == -1.0f);
+        nx[i] = valid ? x : 0.f;
+        ny[i] = valid ? y : 0.f;
+        nz[i] = valid ? z : 0.f;
+        nambiant[i] = valid ? 1.f : 0.f;
+        nbValid += valid;
+    }
+
+    float* nx_ny = coefficients + 4 * stride;
+    float* nx_nz = coefficients + 5 * stride;
+    float* ny_nz = coefficients + 6 * stride;
+    float* nx2_ny2 = coefficients + 7 * stride;
+    float* nz2 = coefficients + 8 * stride;
+
+    // second order coefficients, contiguous loops without branches
+    for (int i = 0; i < nbNormals; ++i)
+    {
+        nx_ny[i] = nx[i] * ny[i];
+        nx_nz[i] = nx[i] * nz[i];
+        ny_nz[i] = ny[i] * nz[i];
+        nx2_ny2[i] = nx[i] * nx[i] - ny[i] * ny[i];
+        nz2[i] = 3 * nz[i] * nz[i] - nambiant[i];
+    }
+
+    return nbValid;
+}
+
+}  // namespace lightingEstimation
 }  // namespace aliceVision
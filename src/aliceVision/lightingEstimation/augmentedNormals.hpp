@@ -86,5 +86,17 @@ class AugmentedNormal : public Eigen::Matrix<float, 9, 1, 0, 9, 1>
     inline T& nz2() { return (*this)(8); }
 };
 
+/**
+ * @brief Evaluate the augmented normals of a range of normals, one coefficient after the other (structure of arrays),
+ *        so that the evaluation of each coefficient is vectorized.
+ * @note The undefined normals (-1, -1, -1) get null coefficients, so that they do not contribute to the lighting estimation.
+ * @param[in] normals The normals
+ * @param[in] nbNormals The number of normals
+ * @param[out] coefficients The coefficient k of the normal i is coefficients[k * stride + i]
+ * @param[in] stride The stride between two coefficients, at least nbNormals
+ * @return The number of defined normals
+ */
+int evaluateAugmentedNormals(const image::RGBfColor* normals, int nbNormals, float* coefficients, int stride);
+
 }  // namespace lightingEstimation
 }  // namespace aliceVision
@@ -24,6 +24,7 @@
 #include <Eigen/Dense>
 #include <Eigen/Core>
 
+#include <exception>
 #include <filesystem>
 #include <math.h>
 
@@ -93,20 +94,32 @@ void lightCalibration(const sfmData::SfMData& sfmData,
     }
 
     Eigen::MatrixXf lightMat(imageList.size(), 3);
-    std::vector<float> intList;
+    std::vector<float> intList(imageList.size());
 
-    for (size_t i = 0; i < imageList.size(); ++i)
+    // The images are calibrated independently: they are read and fitted in parallel
+    std::exception_ptr exception;
+
+#pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < static_cast<int>(imageList.size()); ++i)
     {
-        std::string picturePath = imageList.at(i);
-        std::array<float, 3> sphereParam = allSpheresParams.at(i);
-        float focal = focals.at(i);
-
-        Eigen::Vector3f lightingDirection;
-        lightCalibrationOneImage(picturePath, sphereParam, focal, method, lightingDirection);
-        lightMat.row(i) = lightingDirection;
-        intList.push_back(lightingDirection.norm());
+        try
+        {
+            Eigen::Vector3f lightingDirection;
+            lightCalibrationOneImage(imageList.at(i), allSpheresParams.at(i), focals.at(i), method, lightingDirection);
+            lightMat.row(i) = lightingDirection;
+            intList.at(i) = lightingDirection.norm();
+        }
+        catch (...)
+        {
+#pragma omp critical(lightCalibrationException)
+            if (!exception)
+                exception = std::current_exception();
+        }
     }
 
+    if (exception)
+        std::rethrow_exception(exception);
+
     // Write in JSON file
     writeJSON(outputPath, sfmData, imageList, lightMat, intList, saveAsModel);
 }
@@ -185,7 +198,7 @@ void lightCalibrationOneImage(const std::string& picturePath,
 
         Eigen::VectorXf imSphereMasked(currentIndex);
         imSphereMasked = imSphere.head(currentIndex);
-        lightingDirection = normalSphere.colPivHouseholderQr().solve(imSphere);
+        lightingDirection = normalSphereMasked.colPivHouseholderQr().solve(imSphereMasked);
     }
 }
 
@@ -8,70 +8,82 @@
 #include "augmentedNormals.hpp"
 
 #include <aliceVision/system/Logger.hpp>
+#include <aliceVision/alicevision_omp.hpp>
 
 #include <Eigen/Dense>
 
+#include <algorithm>
 #include <iostream>
+#include <vector>
 
 namespace aliceVision {
 namespace lightingEstimation {
 
-/**
- * @brief Evaluate albedo and normal product for one channel
- */
-void albedoNormalsProduct(MatrixXf& rhoTimesN, const MatrixXf& albedoChannel, const image::Image<AugmentedNormal>& augmentedNormals)
-{
-    std::size_t validIndex = 0;
-    for (int i = 0; i < augmentedNormals.size(); ++i)
-    {
-        // If the normal is undefined
-        if (augmentedNormals(i).nx() == -1.0f && augmentedNormals(i).ny() == -1.0f && augmentedNormals(i).nz() == -1.0f)
-        {
-            continue;
-        }
-        rhoTimesN(validIndex, 0) = albedoChannel(i) * augmentedNormals(i).nx();
-        rhoTimesN(validIndex, 1) = albedoChannel(i) * augmentedNormals(i).ny();
-        rhoTimesN(validIndex, 2) = albedoChannel(i) * augmentedNormals(i).nz();
-        rhoTimesN(validIndex, 3) = albedoChannel(i) * augmentedNormals(i).nambiant();
-        rhoTimesN(validIndex, 4) = albedoChannel(i) * augmentedNormals(i).nx_ny();
-        rhoTimesN(validIndex, 5) = albedoChannel(i) * augmentedNormals(i).nx_nz();
-        rhoTimesN(validIndex, 6) = albedoChannel(i) * augmentedNormals(i).ny_nz();
-        rhoTimesN(validIndex, 7) = albedoChannel(i) * augmentedNormals(i).nx2_ny2();
-        rhoTimesN(validIndex, 8) = albedoChannel(i) * augmentedNormals(i).nz2();
-        ++validIndex;
-    }
-}
+namespace {
+
+/// number of pixels of the blocks of samples accumulated at once
+const int blockSize = 1024;
 
-void prepareImageData(const MatrixXf& albedo,
-                      const MatrixXf& picture,
-                      const image::Image<AugmentedNormal>& augmentedNormals,
-                      MatrixXf& rhoTimesN,
-                      MatrixXf& colors)
+}  // namespace
+
+void LighthingEstimator::accumulate(const float* albedo, const float* picture, int nbChannels, const image::Image<image::RGBfColor>& normals)
 {
-    std::size_t nbValidPoints = 0;
+    const int nbPixels = normals.width() * normals.height();
+    const int nbBlocks = (nbPixels + blockSize - 1) / blockSize;
+
+    // per-thread normal equations, reduced in the thread order at the end
+    std::vector<std::array<NormalEquations, 3>> threadsNormalEquations(omp_get_max_threads());
 
-    for (int i = 0; i < augmentedNormals.size(); ++i)
+#pragma omp parallel
     {
-        // if the normal is undefined
-        if (augmentedNormals(i).nx() == -1.0f && augmentedNormals(i).ny() == -1.0f && augmentedNormals(i).nz() == -1.0f)
-            continue;
-        ++nbValidPoints;
-    }
+        std::array<NormalEquations, 3>& threadNormalEquations = threadsNormalEquations[omp_get_thread_num()];
 
-    rhoTimesN.resize(nbValidPoints, 9);
-    albedoNormalsProduct(rhoTimesN, albedo, augmentedNormals);
-    colors.resize(nbValidPoints, 1);
+        // per-thread buffers, reused for all the blocks
+        Eigen::Matrix<float, Eigen::Dynamic, 9> augmentedNormals(blockSize, 9);
+        Eigen::Matrix<double, Eigen::Dynamic, 9> rhoTimesN(blockSize, 9);
+        Eigen::VectorXd channelAlbedo(blockSize);
+        Eigen::VectorXd channelPicture(blockSize);
 
-    {
-        std::size_t validIndex = 0;
-        for (int i = 0; i < augmentedNormals.size(); ++i)
+#pragma omp for schedule(static)
+        for (int block = 0; block < nbBlocks; ++block)
         {
-            // if the normal is undefined
-            if (augmentedNormals(i).nx() == -1.0f && augmentedNormals(i).ny() == -1.0f && augmentedNormals(i).nz() == -1.0f)
+            const int begin = block * blockSize;
+            const int size = std::min(blockSize, nbPixels - begin);
+
+            const int nbValid = evaluateAugmentedNormals(normals.data() + begin, size, augmentedNormals.data(), blockSize);
+            if (nbValid == 0)
                 continue;
 
-            colors(validIndex++) = picture(i);
+            for (int channel = 0; channel < nbChannels; ++channel)
+            {
+                for (int i = 0; i < size; ++i)
+                {
+                    channelAlbedo(i) = albedo[std::size_t(begin + i) * nbChannels + channel];
+                    channelPicture(i) = picture[std::size_t(begin + i) * nbChannels + channel];
+                }
+
+                // the undefined normals have null rows, they do not contribute
+                rhoTimesN.topRows(size) = augmentedNormals.topRows(size).cast<double>().array().colwise() * channelAlbedo.head(size).array();
+
+                // the normal equations are badly conditioned, they are accumulated in double precision
+                NormalEquations& equations = threadNormalEquations[channel];
+                equations.AtA.noalias() += rhoTimesN.topRows(size).transpose() * rhoTimesN.topRows(size);
+                equations.Atb.noalias() += rhoTimesN.topRows(size).transpose() * channelPicture.head(size);
+                equations.nbSamples += nbValid;
+            }
+        }
+    }
+
+    for (int channel = 0; channel < nbChannels; ++channel)
+    {
+        NormalEquations& equations = _normalEquations.at(channel);
+        for (const std::array<NormalEquations, 3>& threadNormalEquations : threadsNormalEquations)
+        {
+            equations.AtA += threadNormalEquations[channel].AtA;
+            equations.Atb += threadNormalEquations[channel].Atb;
+            equations.nbSamples += threadNormalEquations[channel].nbSamples;
         }
+        ++equations.nbImages;
     }
 }
 
@@ -79,54 +91,14 @@ void LighthingEstimator::addImage(const image::Image<float>& albedo,
                                   const image::Image<float>& picture,
                                   const image::Image<image::RGBfColor>& normals)
 {
-    using namespace Eigen;
-
-    // augmented normales
-    image::Image<AugmentedNormal> augmentedNormals(normals.cast<AugmentedNormal>());
-
-    const std::size_t nbPixels = augmentedNormals.width() * augmentedNormals.height();
-
-    MatrixXf rhoTimesN;
-    MatrixXf colors;
-
-    // map albedo, image
-    Map<const MatrixXf> channelAlbedo(albedo.data(), nbPixels, 1);
-    Map<const MatrixXf> channelPicture(picture.data(), nbPixels, 1);
-
-    prepareImageData(channelAlbedo, channelPicture, augmentedNormals, rhoTimesN, colors);
-
-    // store image data
-    _all_rhoTimesN.at(0).push_back(rhoTimesN);
-    _all_pictureChannel.at(0).push_back(colors);
+    accumulate(albedo.data(), picture.data(), 1, normals);
 }
 
 void LighthingEstimator::addImage(const image::Image<image::RGBfColor>& albedo,
                                   const image::Image<image::RGBfColor>& picture,
                                   const image::Image<image::RGBfColor>& normals)
 {
-    using namespace Eigen;
-
-    // augmented normales
-    image::Image<AugmentedNormal> augmentedNormals(normals.cast<AugmentedNormal>());
-
-    const std::size_t nbPixels = augmentedNormals.width() * augmentedNormals.height();
-
-    // estimate lighting per channel
-    for (std::size_t channel = 0; channel < 3; ++channel)
-    {
-        MatrixXf rhoTimesN;
-        MatrixXf colors;
-
-        // map albedo, image
-        Map<const MatrixXf, 0, InnerStride<3>> channelAlbedo(static_cast<const float*>(&(albedo(0, 0)(channel))), nbPixels, 1);
-        Map<const MatrixXf, 0, InnerStride<3>> channelPicture(static_cast<const float*>(&(picture(0, 0)(channel))), nbPixels, 1);
-
-        prepareImageData(channelAlbedo, channelPicture, augmentedNormals, rhoTimesN, colors);
-
-        // store image data
-        _all_rhoTimesN.at(channel).push_back(rhoTimesN);
-        _all_pictureChannel.at(channel).push_back(colors);
-    }
+    accumulate(albedo.data()->data(), picture.data()->data(), 3, normals);
 }
 
 void LighthingEstimator::estimateLigthing(LightingVector& lighting) const
@@ -136,7 +108,7 @@ void LighthingEstimator::estimateLigthing(LightingVector& lighting) const
     // check number of channels
     for (int channel = 0; channel < 3; ++channel)
     {
-        if (_all_rhoTimesN.at(channel).empty())
+        if (_normalEquations.at(channel).nbImages == 0)
         {
             nbChannels = channel;
             break;
@@ -146,46 +118,10 @@ void LighthingEstimator::estimateLigthing(LightingVector& lighting) const
     // for each channel
     for (int channel = 0; channel < nbChannels; ++channel)
     {
-        std::size_t nbRows_all_rhoTimesN = 0;
-        std::size_t nbRows_all_pictureChannel = 0;
-
-        // count and check matrices rows
-        {
-            for (const MatrixXf& matrix : _all_rhoTimesN.at(channel))
-                nbRows_all_rhoTimesN += matrix.rows();
-
-            for (const MatrixXf& matrix : _all_pictureChannel.at(channel))
-                nbRows_all_pictureChannel += matrix.rows();
-
-            assert(nbRows_all_rhoTimesN == nbRows_all_pictureChannel);
-        }
-
-        // agglomerate rhoTimesN
-        MatrixXf rhoTimesN(nbRows_all_rhoTimesN, 9);
-        {
-            std::size_t nbRow = 0;
-            for (const MatrixXf& matrix : _all_rhoTimesN.at(channel))
-            {
-                for (int matrixRow = 0; matrixRow < matrix.rows(); ++matrixRow)
-                    rhoTimesN.row(nbRow + matrixRow) = matrix.row(matrixRow);
-                nbRow += matrix.rows();
-            }
-        }
-
-        // agglomerate pictureChannel
-        MatrixXf pictureChannel(nbRows_all_pictureChannel, 1);
-        {
-            std::size_t nbRow = 0;
-            for (const MatrixXf& matrix : _all_pictureChannel.at(channel))
-            {
-                for (int matrixRow = 0; matrixRow < matrix.rows(); ++matrixRow)
-                    pictureChannel.row(nbRow + matrixRow) = matrix.row(matrixRow);
-                nbRow += matrix.rows();
-            }
-        }
+        const NormalEquations& equations = _normalEquations.at(channel);
 
-        ALICEVISION_LOG_INFO("Estimate ligthing channel: rhoTimesN(" << rhoTimesN.rows() << "x" << rhoTimesN.cols() << ")");
-        Eigen::Matrix<float, 9, 1> lightingC = rhoTimesN.colPivHouseholderQr().solve(pictureChannel);
+        ALICEVISION_LOG_INFO("Estimate ligthing channel: " << equations.nbSamples << " samples.");
+        const Eigen::Matrix<float, 9, 1> lightingC = equations.AtA.colPivHouseholderQr().solve(equations.Atb).cast<float>();
 
         // lighting vectors fusion
         lighting.col(channel) = lightingC;
@@ -201,8 +137,7 @@ void LighthingEstimator::estimateLigthing(LightingVector& lighting) const
 
 void LighthingEstimator::clear()
 {
-    _all_rhoTimesN = std::array<std::vector<MatrixXf>, 3>();
-    _all_pictureChannel = std::array<std::vector<MatrixXf>, 3>();
+    _normalEquations = std::array<NormalEquations, 3>();
 }
 
 }  // namespace lightingEstimation
@@ -13,6 +13,7 @@
 #include <Eigen/Core>
 #include <Eigen/Dense>
 
+#include <array>
 #include <iostream>
 
 namespace aliceVision {
@@ -66,8 +67,28 @@ class LighthingEstimator
     void clear();
 
   private:
-    std::array<std::vector<MatrixXf>, 3> _all_rhoTimesN;
-    std::array<std::vector<MatrixXf>, 3> _all_pictureChannel;
+    /**
+     * @brief Normal equations of the least squares lighting estimation of a channel, accumulated image after image
+     *        (the sample matrices are not stored).
+     */
+    struct NormalEquations
+    {
+        Eigen::Matrix<double, 9, 9> AtA = Eigen::Matrix<double, 9, 9>::Zero();
+        Eigen::Matrix<double, 9, 1> Atb = Eigen::Matrix<double, 9, 1>::Zero();
+        std::size_t nbSamples = 0;
+        std::size_t nbImages = 0;
+    };
+
+    /**
+     * @brief Accumulate the samples of an image in the normal equations of its channels, in parallel.
+     * @param[in] albedo The albedo, nbChannels interleaved floats per pixel
+     * @param[in] picture The picture, nbChannels interleaved floats per pixel
+     * @param[in] nbChannels The number of channels (1 or 3)
+     * @param[in] normals The normals image
+     */
+    void accumulate(const float* albedo, const float* picture, int nbChannels, const image::Image<image::RGBfColor>& normals);
+
+    std::array<NormalEquations, 3> _normalEquations;
 };
 
 }  // namespace lightingEstimation
@@ -128,3 +128,54 @@ BOOST_AUTO_TEST_CASE(LIGHTING_ESTIMATION_Lambertian_noise)
     const float epsilon = 1e-2f;
     EXPECT_MATRIX_NEAR(lightingEst, lightingSynt, epsilon);
 }
+
+BOOST_AUTO_TEST_CASE(LIGHTING_ESTIMATION_Lambertian_undefinedNormals)
+{
+    makeRandomOperationsReproducible();
+
+    const std::size_t sx = 100;
+    const std::size_t sy = 30;
+
+    // Random initialization of lighting, albedo and normals
+    LightingVector lightingSynt = MatrixXf::Random(9, 3).cwiseAbs();
+
+    LighthingEstimator estimator;
+
+    // luminance estimation from several images, with undefined normals
+    for (int imageIndex = 0; imageIndex < 3; ++imageIndex)
+    {
+        Image<float> albedoSynt(sy, sx);
+        Image<RGBfColor> normalsSynt(sy, sx);
+        Image<float> pictureGenerated(sy, sx);
+
+        for (std::size_t y = 0; y < sy; ++y)
+        {
+            for (std::size_t x = 0; x < sx; ++x)
+            {
+                albedoSynt(x, y) = zeroOneRand();
+                if ((x + y) % 7 == 0)
+                {
+                    // undefined normal, with an inconsistent color
+                    normalsSynt(x, y) = RGBfColor(-1.0f, -1.0f, -1.0f);
+                    pictureGenerated(x, y) = 1000.f;
+                    continue;
+                }
+                RGBfColor n(zeroOneRand(), zeroOneRand(), std::abs(zeroOneRand()));
+                n.normalize();
+                normalsSynt(x, y) = n;
+                pictureGenerated(x, y) = albedoSynt(x, y) * AugmentedNormal(n).dot(lightingSynt.col(0));
+            }
+        }
+
+        estimator.addImage(albedoSynt, pictureGenerated, normalsSynt);
+    }
+
+    LightingVector lightingEst;
+    estimator.estimateLigthing(lightingEst);
+
+    const float epsilon = 1e-3f;
+    for (int ch = 0; ch < 3; ++ch)
+    {
+        EXPECT_MATRIX_NEAR(lightingEst.col(ch), lightingSynt.col(0), epsilon);
+    }
+}
@@ -189,13 +189,10 @@ bool CCTagLocalizer::loadReconstructionDescriptors(const sfmData::SfMData& sfm_d
     return true;
 }
 
-bool CCTagLocalizer::localize(const image::Image<float>& imageGrey,
-                              const LocalizerParameters* parameters,
-                              std::mt19937& randomNumberGenerator,
-                              bool useInputIntrinsics,
-                              camera::Pinhole& queryIntrinsics,
-                              LocalizationResult& localizationResult,
-                              const std::string& imagePath)
+void CCTagLocalizer::extractQueryRegions(const image::Image<float>& imageGrey,
+                                         const LocalizerParameters* parameters,
+                                         feature::MapRegionsPerDesc& queryRegions,
+                                         const std::string& imagePath)
 {
     namespace fs = std::filesystem;
 
@@ -210,23 +207,36 @@ bool CCTagLocalizer::localize(const image::Image<float>& imageGrey,
     image::Image<unsigned char> imageGrayUChar;  // cctag image describer don't support float image
     imageGrayUChar = (imageGrey.getMat() * 255.f).cast<unsigned char>();
 
-    feature::MapRegionsPerDesc tmpQueryRegions;
-
     _imageDescriber.setCudaPipe(_cudaPipe);
     _imageDescriber.setConfigurationPreset(param->_featurePreset);
-    _imageDescriber.describe(imageGrayUChar, tmpQueryRegions[_cctagDescType]);
-    ALICEVISION_LOG_DEBUG("[features]\tExtract CCTAG done: found " << tmpQueryRegions.at(_cctagDescType)->RegionCount() << " features");
-
-    std::pair<std::size_t, std::size_t> imageSize = std::make_pair(imageGrey.width(), imageGrey.height());
+    _imageDescriber.describe(imageGrayUChar, queryRegions[_cctagDescType]);
+    ALICEVISION_LOG_DEBUG("[features]\tExtract CCTAG done: found " << queryRegions.at(_cctagDescType)->RegionCount() << " features");
 
     if (!param->_visualDebug.empty() && !imagePath.empty())
     {
+        const std::pair<std::size_t, std::size_t> imageSize = std::make_pair(imageGrey.width(), imageGrey.height());
+
         // it automatically throws an exception if the cast does not work
-        const feature::CCTAG_Regions& cctagQueryRegions = tmpQueryRegions.getRegions<feature::CCTAG_Regions>(_cctagDescType);
+        const feature::CCTAG_Regions& cctagQueryRegions = queryRegions.getRegions<feature::CCTAG_Regions>(_cctagDescType);
 
         // just debugging -- save the svg image with detected cctag
         matching::saveCCTag2SVG(imagePath, imageSize, cctagQueryRegions, param->_visualDebug + "/" + fs::path(imagePath).stem().string() + ".svg");
     }
+}
+
+bool CCTagLocalizer::localize(const image::Image<float>& imageGrey,
+                              const LocalizerParameters* parameters,
+                              std::mt19937& randomNumberGenerator,
+                              bool useInputIntrinsics,
+                              camera::Pinhole& queryIntrinsics,
+                              LocalizationResult& localizationResult,
+                              const std::string& imagePath)
+{
+    feature::MapRegionsPerDesc tmpQueryRegions;
+    extractQueryRegions(imageGrey, parameters, tmpQueryRegions, imagePath);
+
+    std::pair<std::size_t, std::size_t> imageSize = std::make_pair(imageGrey.width(), imageGrey.height());
+
     return localize(
       tmpQueryRegions, imageSize, parameters, randomNumberGenerator, useInputIntrinsics, queryIntrinsics, localizationResult, imagePath);
 }
@@ -42,6 +42,18 @@ class CCTagLocalizer : public ILocalizer
 
     void setCudaPipe(int i) override;
 
+    /**
+     * @brief Extract the CCTag regions of the query image.
+     * @param[in] imageGrey The input greyscale image.
+     * @param[in] parameters The parameters for the localization.
+     * @param[out] queryRegions The extracted regions.
+     * @param[in] imagePath Optional complete path to the image, used only for debugging purposes.
+     */
+    void extractQueryRegions(const image::Image<float>& imageGrey,
+                             const LocalizerParameters* parameters,
+                             feature::MapRegionsPerDesc& queryRegions,
+                             const std::string& imagePath = std::string()) override;
+
     /**
      * @brief Just a wrapper around the different localization algorithm, the algorith
      * used to localized is chosen using \p param._algorithm
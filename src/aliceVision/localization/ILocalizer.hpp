@@ -73,6 +73,19 @@ class ILocalizer
 
     const sfmData::SfMData& getSfMData() const { return _sfm_data; }
 
+    /**
+     * @brief Extract the regions of a query image, as done by localize() before the localization itself.
+     *
+     * @param[in] imageGrey The input greyscale image.
+     * @param[in] param The parameters for the localization.
+     * @param[out] queryRegions The extracted regions, for each describer type of the localizer.
+     * @param[in] imagePath Optional complete path to the image, used only for debugging purposes.
+     */
+    virtual void extractQueryRegions(const image::Image<float>& imageGrey,
+                                     const LocalizerParameters* param,
+                                     feature::MapRegionsPerDesc& queryRegions,
+                                     const std::string& imagePath = std::string()) = 0;
+
     /**
      * @brief Localize one image
      *
@@ -0,0 +1,206 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "LocalizationServer.hpp"
+
+#include <aliceVision/system/Logger.hpp>
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace aliceVision {
+namespace localization {
+
+namespace {
+
+/**
+ * @brief Blocking FIFO queue with a maximum size connecting two stages of the pipeline.
+ */
+class FrameQueue
+{
+  public:
+    explicit FrameQueue(std::size_t maxSize)
+      : _maxSize(std::max<std::size_t>(maxSize, 1))
+    {}
+
+    /**
+     * @brief Append a frame, wait while the queue is full.
+     * @return false if the queue has been aborted
+     */
+    bool push(std::unique_ptr<LocalizationFrame> frame)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _notFull.wait(lock, [&] { return _aborted || _frames.size() < _maxSize; });
+        if (_aborted)
+            return false;
+        _frames.push_back(std::move(frame));
+        _notEmpty.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief Remove the first frame, wait while the queue is empty.
+     * @return nullptr at the end of the stream or if the queue has been aborted
+     */
+    std::unique_ptr<LocalizationFrame> pop()
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _notEmpty.wait(lock, [&] { return _aborted || _closed || !_frames.empty(); });
+        if (_aborted || _frames.empty())
+            return nullptr;
+        std::unique_ptr<LocalizationFrame> frame = std::move(_frames.front());
+        _frames.pop_front();
+        _notFull.notify_one();
+        return frame;
+    }
+
+    /// End of the stream: the remaining frames can still be popped.
+    void close()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _closed = true;
+        _notEmpty.notify_all();
+    }
+
+    /// Stop the pipeline: the remaining frames are dropped and the waiting stages are released.
+    void abort()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _aborted = true;
+        _frames.clear();
+        _notEmpty.notify_all();
+        _notFull.notify_all();
+    }
+
+  private:
+    std::size_t _maxSize;
+    std::deque<std::unique_ptr<LocalizationFrame>> _frames;
+    bool _closed = false;
+    bool _aborted = false;
+    std::mutex _mutex;
+    std::condition_variable _notEmpty;
+    std::condition_variable _notFull;
+};
+
+}  // namespace
+
+LocalizationServer::LocalizationServer(ILocalizer& localizer, const LocalizerParameters& param, std::size_t queueSize)
+  : _localizer(localizer),
+    _param(param),
+    _queueSize(queueSize)
+{
+    if (!_localizer.isInit())
+        throw std::invalid_argument("The localizer of the localization server is not initialized.");
+}
+
+std::size_t LocalizationServer::processStream(const FrameReader& readFrame, const FrameCallback& onLocalized, std::mt19937& randomNumberGenerator)
+{
+    FrameQueue decodedFrames(_queueSize);
+    FrameQueue extractedFrames(_queueSize);
+    std::exception_ptr decodeError;
+    std::exception_ptr extractionError;
+
+    // decode stage
+    std::thread decodeThread([&] {
+        try
+        {
+            for (std::size_t frameId = 0;; ++frameId)
+            {
+                auto frame = std::make_unique<LocalizationFrame>();
+                frame->frameId = frameId;
+                if (!readFrame(*frame))
+                    break;
+                frame->imageSize = std::make_pair(frame->imageGrey.width(), frame->imageGrey.height());
+                frame->latency.decodeMs = frame->timer.elapsedMs();
+                if (!decodedFrames.push(std::move(frame)))
+                    break;
+            }
+        }
+        catch (...)
+        {
+            decodeError = std::current_exception();
+        }
+        decodedFrames.close();
+    });
+
+    // feature extraction stage
+    std::thread extractionThread([&] {
+        try
+        {
+            while (std::unique_ptr<LocalizationFrame> frame = decodedFrames.pop())
+            {
+                system::Timer timer;
+                _localizer.extractQueryRegions(frame->imageGrey, &_param, frame->queryRegions, frame->imagePath);
+                frame->latency.extractionMs = timer.elapsedMs();
+                // the image is not needed anymore
+                frame->imageGrey = image::Image<float>();
+                if (!extractedFrames.push(std::move(frame)))
+                    break;
+            }
+        }
+        catch (...)
+        {
+            extractionError = std::current_exception();
+            decodedFrames.abort();
+        }
+        extractedFrames.close();
+    });
+
+    // localization stage, on the caller thread to keep the frames in the stream order
+    std::size_t nbFrames = 0;
+    try
+    {
+        while (std::unique_ptr<LocalizationFrame> frame = extractedFrames.pop())
+        {
+            system::Timer timer;
+            LocalizationResult localizationResult;
+            _localizer.localize(frame->queryRegions,
+                                frame->imageSize,
+                                &_param,
+                                randomNumberGenerator,
+                                frame->hasIntrinsics,
+                                frame->queryIntrinsics,
+                                localizationResult,
+                                frame->imagePath);
+            frame->latency.localizationMs = timer.elapsedMs();
+            frame->latency.totalMs = frame->timer.elapsedMs();
+
+            ALICEVISION_LOG_DEBUG("[server]\tFrame " << frame->frameId << " latency: decode " << frame->latency.decodeMs << " [ms], extraction "
+                                                      << frame->latency.extractionMs << " [ms], localization " << frame->latency.localizationMs
+                                                      << " [ms], total " << frame->latency.totalMs << " [ms]");
+
+            onLocalized(*frame, localizationResult);
+            ++nbFrames;
+        }
+    }
+    catch (...)
+    {
+        decodedFrames.abort();
+        extractedFrames.abort();
+        decodeThread.join();
+        extractionThread.join();
+        throw;
+    }
+
+    decodeThread.join();
+    extractionThread.join();
+
+    if (decodeError)
+        std::rethrow_exception(decodeError);
+    if (extractionError)
+        std::rethrow_exception(extractionError);
+
+    return nbFrames;
+}
+
+}  // namespace localization
+}  // namespace aliceVision
@@ -0,0 +1,117 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/localization/ILocalizer.hpp>
+#include <aliceVision/localization/LocalizationResult.hpp>
+#include <aliceVision/image/Image.hpp>
+#include <aliceVision/camera/Pinhole.hpp>
+#include <aliceVision/feature/RegionsPerView.hpp>
+#include <aliceVision/system/Timer.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <random>
+#include <string>
+
+namespace aliceVision {
+namespace localization {
+
+/**
+ * @brief Latency of each stage of the localization pipeline for one frame (in milliseconds).
+ */
+struct FrameLatency
+{
+    /// time spent to read and decode the frame
+    double decodeMs = 0.0;
+    /// time spent to extract the features of the frame
+    double extractionMs = 0.0;
+    /// time spent to match and resect the frame
+    double localizationMs = 0.0;
+    /// time between the start of the decoding and the end of the localization, including the waiting in the queues
+    double totalMs = 0.0;
+};
+
+/**
+ * @brief A frame going through the localization pipeline.
+ */
+struct LocalizationFrame
+{
+    /// index of the frame in the stream
+    std::size_t frameId = 0;
+    /// the greyscale image, released once the features are extracted
+    image::Image<float> imageGrey;
+    /// size of the image
+    std::pair<std::size_t, std::size_t> imageSize;
+    /// intrinsics of the camera, estimated by the localization if hasIntrinsics is false
+    camera::Pinhole queryIntrinsics;
+    /// whether the intrinsics are known
+    bool hasIntrinsics = false;
+    /// path to the image, used for debugging purposes
+    std::string imagePath;
+    /// the extracted features of the frame
+    feature::MapRegionsPerDesc queryRegions;
+    /// per-stage latency
+    FrameLatency latency;
+    /// started when the decoding of the frame begins
+    system::Timer timer;
+};
+
+/**
+ * @brief Long-lived localization service on top of an ILocalizer.
+ *
+ * The localizer, and thus the vocabulary tree and the reconstruction descriptors, stays resident
+ * between the streams, so the database is loaded only once for all the processed feeds.
+ * The frames of a stream go through a pipeline of three stages running on their own threads:
+ * decode -> feature extraction -> localization (matching and resection).
+ * The stages are connected by bounded queues, so consecutive frames overlap while the memory stays bounded.
+ * The localization stage is sequential, so the frames are localized and reported in the stream order.
+ */
+class LocalizationServer
+{
+  public:
+    /**
+     * @brief Read the next frame of the stream. It is called from the decode thread.
+     * It has to fill the image, the intrinsics, hasIntrinsics and the image path of the frame.
+     * @return false at the end of the stream
+     */
+    using FrameReader = std::function<bool(LocalizationFrame& frame)>;
+
+    /**
+     * @brief Called from the caller thread for each localized frame, in the order of the stream.
+     */
+    using FrameCallback = std::function<void(const LocalizationFrame& frame, const LocalizationResult& localizationResult)>;
+
+    /**
+     * @brief Build a localization server.
+     * @param[in] localizer The initialized localizer, it must outlive the server
+     * @param[in] param The parameters of the localization, they must outlive the server
+     * @param[in] queueSize Maximum number of frames waiting between two stages
+     */
+    LocalizationServer(ILocalizer& localizer, const LocalizerParameters& param, std::size_t queueSize = 2);
+
+    /**
+     * @brief Localize all the frames of a stream.
+     * The localization runs on the caller thread, the decoding and the extraction run on two worker threads.
+     * An exception thrown by one of the stages stops the pipeline and is rethrown.
+     * @param[in] readFrame The function reading the frames of the stream
+     * @param[in] onLocalized The function called for each localized frame
+     * @param[in,out] randomNumberGenerator The random generator used by the localization
+     * @return the number of processed frames
+     */
+    std::size_t processStream(const FrameReader& readFrame, const FrameCallback& onLocalized, std::mt19937& randomNumberGenerator);
+
+    const ILocalizer& getLocalizer() const { return _localizer; }
+
+  private:
+    ILocalizer& _localizer;
+    const LocalizerParameters& _param;
+    std::size_t _queueSize;
+};
+
+}  // namespace localization
+}  // namespace aliceVision
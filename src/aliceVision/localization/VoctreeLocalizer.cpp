@@ -8,6 +8,7 @@
 #include "rigResection.hpp"
 #include "optimization.hpp"
 #include <aliceVision/config.hpp>
+#include <aliceVision/alicevision_omp.hpp>
 #include <aliceVision/sfmDataIO/sfmDataIO.hpp>
 #include <aliceVision/sfm/pipeline/RelativePoseInfo.hpp>
 #include <aliceVision/sfm/bundle/BundleAdjustmentCeres.hpp>
@@ -22,6 +23,7 @@
 #include <aliceVision/matchingImageCollection/GeometricFilterMatrix.hpp>
 #include <aliceVision/numeric/numeric.hpp>
 #include <aliceVision/multiview/relativePose/FundamentalError.hpp>
+#include <aliceVision/multiview/relativePose/HomographyError.hpp>
 #include <aliceVision/matching/guidedMatching.hpp>
 #include <aliceVision/system/Logger.hpp>
 #include <aliceVision/system/ProgressDisplay.hpp>
@@ -156,43 +158,62 @@ bool VoctreeLocalizer::localize(const feature::MapRegionsPerDesc& queryRegions,
         throw std::invalid_argument("The parameters are not in the right format!!");
     }
 
-    switch (voctreeParam->_algorithm)
+    bool localized = false;
+
+    // first try to track the landmarks of the previous frame
+    if (voctreeParam->_useTracking && _previousFrame)
     {
-        case Algorithm::FirstBest:
-            return localizeFirstBestResult(
-              queryRegions, imageSize, *voctreeParam, randomNumberGenerator, useInputIntrinsics, queryIntrinsics, localizationResult, imagePath);
-        case Algorithm::BestResult:
-            throw std::invalid_argument("BestResult not yet implemented");
-        case Algorithm::AllResults:
-            return localizeAllResults(
-              queryRegions, imageSize, *voctreeParam, randomNumberGenerator, useInputIntrinsics, queryIntrinsics, localizationResult, imagePath);
-        case Algorithm::Cluster:
-            throw std::invalid_argument("Cluster not yet implemented");
-        default:
-            throw std::invalid_argument("Unknown algorithm type");
+        localized = localizeTracking(
+          queryRegions, imageSize, *voctreeParam, randomNumberGenerator, useInputIntrinsics, queryIntrinsics, localizationResult, imagePath);
+    }
+
+    if (!localized)
+    {
+        switch (voctreeParam->_algorithm)
+        {
+            case Algorithm::FirstBest:
+                localized = localizeFirstBestResult(
+                  queryRegions, imageSize, *voctreeParam, randomNumberGenerator, useInputIntrinsics, queryIntrinsics, localizationResult, imagePath);
+                break;
+            case Algorithm::BestResult:
+                throw std::invalid_argument("BestResult not yet implemented");
+            case Algorithm::AllResults:
+                localized = localizeAllResults(
+                  queryRegions, imageSize, *voctreeParam, randomNumberGenerator, useInputIntrinsics, queryIntrinsics, localizationResult, imagePath);
+                break;
+            case Algorithm::Cluster:
+                throw std::invalid_argument("Cluster not yet implemented");
+            default:
+                throw std::invalid_argument("Unknown algorithm type");
+        }
+    }
+
+    if (voctreeParam->_useTracking)
+    {
+        // keep the inliers of the last localized frame for the tracking of the next one
+        if (localized)
+            _previousFrame = std::make_unique<FrameData>(localizationResult, queryRegions);
+        else
+            _previousFrame.reset();
     }
+
+    return localized;
 }
 
-bool VoctreeLocalizer::localize(const image::Image<float>& imageGrey,
-                                const LocalizerParameters* param,
-                                std::mt19937& randomNumberGenerator,
-                                bool useInputIntrinsics,
-                                camera::Pinhole& queryIntrinsics,
-                                LocalizationResult& localizationResult,
-                                const std::string& imagePath /* = std::string() */)
+void VoctreeLocalizer::extractQueryRegions(const image::Image<float>& imageGrey,
+                                           const LocalizerParameters* param,
+                                           feature::MapRegionsPerDesc& queryRegions,
+                                           const std::string& imagePath)
 {
-    // A. extract descriptors and features from image
     ALICEVISION_LOG_DEBUG("[features]\tExtract Regions from query image");
-    feature::MapRegionsPerDesc queryRegionsPerDesc;
-
     image::Image<unsigned char> imageGrayUChar;  // uchar image copy for uchar image describer
 
     for (const auto& imageDescriber : _imageDescribers)
     {
         const auto descType = imageDescriber->getDescriberType();
-        auto& queryRegions = queryRegionsPerDesc[descType];
+        auto& regions = queryRegions[descType];
 
-        imageDescriber->allocate(queryRegions);
+        imageDescriber->allocate(regions);
 
         system::Timer timer;
         imageDescriber->setCudaPipe(_cudaPipe);
@@ -200,37 +221,51 @@ bool VoctreeLocalizer::localize(const image::Image<float>& imageGrey,
 
         if (imageDescriber->useFloatImage())
         {
-            imageDescriber->describe(imageGrey, queryRegions, nullptr);
+            imageDescriber->describe(imageGrey, regions, nullptr);
         }
         else
         {
             // image descriptor can't use float image
             if (imageGrayUChar.width() == 0)  // the first time, convert the float buffer to uchar
                 imageGrayUChar = (imageGrey.getMat() * 255.f).cast<unsigned char>();
-            imageDescriber->describe(imageGrayUChar, queryRegions, nullptr);
+            imageDescriber->describe(imageGrayUChar, regions, nullptr);
         }
 
         ALICEVISION_LOG_DEBUG("[features]\tExtract " << feature::EImageDescriberType_enumToString(descType) << " done: found "
-                                                     << queryRegions->RegionCount() << " features in " << timer.elapsedMs() << " [ms]");
+                                                     << regions->RegionCount() << " features in " << timer.elapsedMs() << " [ms]");
     }
 
-    const std::pair<std::size_t, std::size_t> queryImageSize = std::make_pair(imageGrey.width(), imageGrey.height());
-
     // if debugging is enable save the svg image with the extracted features
     if (!param->_visualDebug.empty() && !imagePath.empty())
     {
+        const std::pair<std::size_t, std::size_t> queryImageSize = std::make_pair(imageGrey.width(), imageGrey.height());
         feature::MapFeaturesPerDesc extractedFeatures;
 
         for (const auto& imageDescriber : _imageDescribers)
         {
             const auto descType = imageDescriber->getDescriberType();
-            extractedFeatures[descType] = queryRegionsPerDesc.at(descType)->GetRegionsPositions();
+            extractedFeatures[descType] = queryRegions.at(descType)->GetRegionsPositions();
         }
 
         namespace fs = std::filesystem;
         matching::saveFeatures2SVG(
           imagePath, queryImageSize, extractedFeatures, param->_visualDebug + "/" + fs::path(imagePath).stem().string() + ".svg");
     }
+}
+
+bool VoctreeLocalizer::localize(const image::Image<float>& imageGrey,
+                                const LocalizerParameters* param,
+                                std::mt19937& randomNumberGenerator,
+                                bool useInputIntrinsics,
+                                camera::Pinhole& queryIntrinsics,
+                                LocalizationResult& localizationResult,
+                                const std::string& imagePath /* = std::string() */)
+{
+    // A. extract descriptors and features from image
+    feature::MapRegionsPerDesc queryRegionsPerDesc;
+    extractQueryRegions(imageGrey, param, queryRegionsPerDesc, imagePath);
+
+    const std::pair<std::size_t, std::size_t> queryImageSize = std::make_pair(imageGrey.width(), imageGrey.height());
 
     return localize(
       queryRegionsPerDesc, queryImageSize, param, randomNumberGenerator, useInputIntrinsics, queryIntrinsics, localizationResult, imagePath);
@@ -305,59 +340,71 @@ bool VoctreeLocalizer::initDatabase(const std::string& vocTreeFilepath, const st
     if (!featFolder.empty())
         featuresFolders.emplace_back(featFolder);
 
-        // Read for each view the corresponding Regions and store them
-#pragma omp parallel for num_threads(3)
-    for (int i = 0; i < _sfm_data.getViews().size(); ++i)
+    // We always initialize objects with empty structures,
+    // so all views and descTypes always exist in the map.
+    // It simplifies the code based on these data structures,
+    // so you have a data structure with 0 element and you don't need to add
+    // special cases everywhere for empty elements.
+    // The entries are created sequentially, so the parallel loading only writes in its own entries without any lock.
+    std::vector<IndexT> viewIds;
+    viewIds.reserve(_sfm_data.getViews().size());
+    for (const auto& viewPair : _sfm_data.getViews())
     {
-        auto iter = _sfm_data.getViews().cbegin();
-        std::advance(iter, i);
-        const IndexT id_view = iter->second->getViewId();
+        const IndexT id_view = viewPair.second->getViewId();
         if (observationsPerView.count(id_view) == 0)
+        {
+            ++progressDisplay;
             continue;
+        }
+        viewIds.push_back(id_view);
+        for (const auto& imageDescriber : _imageDescribers)
+        {
+            const feature::EImageDescriberType descType = imageDescriber->getDescriberType();
+            _reconstructedRegionsMappingPerView[id_view][descType] = ReconstructedRegionsMapping();
+            imageDescriber->allocate(_regionsPerView.getData()[id_view][descType]);
+        }
+    }
+
+    // the histograms are inserted in the database after the loading, in the order of the views
+    std::vector<voctree::SparseHistogram> histograms(viewIds.size());
+
+    // Read for each view the corresponding Regions and store them
+#pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < viewIds.size(); ++i)
+    {
+        const IndexT id_view = viewIds[i];
         const auto& observations = observationsPerView.at(id_view);
+        auto& mappingPerDesc = _reconstructedRegionsMappingPerView.at(id_view);
+        auto& regionsPerDesc = _regionsPerView.getData().at(id_view);
+
         for (const auto& imageDescriber : _imageDescribers)
         {
             const feature::EImageDescriberType descType = imageDescriber->getDescriberType();
 
-            ReconstructedRegionsMapping mapping;
+            // no descriptor of this type in this View
             if (observations.count(descType) == 0)
-            {
-                // no descriptor of this type in this View
-#pragma omp critical
-                {
-                    // We always initialize objects with empty structures,
-                    // so all views and descTypes always exist in the map.
-                    // It simplifies the code based on these data structures,
-                    // so you have a data structure with 0 element and you don't need to add
-                    // special cases everywhere for empty elements.
-                    _reconstructedRegionsMappingPerView[id_view][descType] = std::move(mapping);
-                    imageDescriber->allocate(_regionsPerView.getData()[id_view][descType]);
-                }
                 continue;
-            }
 
             // Load from files
             std::unique_ptr<feature::Regions> currRegions = sfm::loadRegions(featuresFolders, id_view, *imageDescriber);
 
             if (descType == _voctreeDescType)
             {
-                voctree::SparseHistogram histo = _voctree->quantizeToSparse(currRegions->blindDescriptors());
-#pragma omp critical
-                {
-                    _database.insert(id_view, histo);
-                }
+                histograms[i] = _voctree->quantizeToSparse(currRegions->blindDescriptors());
             }
 
             // Filter descriptors to keep only the 3D reconstructed points
-            std::unique_ptr<feature::Regions> filteredRegions = createFilteredRegions(*currRegions, observations.at(descType), mapping);
-#pragma omp critical
-            {
-                _reconstructedRegionsMappingPerView[id_view][descType] = std::move(mapping);
-                _regionsPerView.getData()[id_view][descType] = std::move(filteredRegions);
-            }
+            regionsPerDesc.at(descType) = createFilteredRegions(*currRegions, observations.at(descType), mappingPerDesc.at(descType));
         }
         ++progressDisplay;
     }
+
+    for (std::size_t i = 0; i < viewIds.size(); ++i)
+    {
+        if (!histograms[i].empty())
+            _database.insert(viewIds[i], histograms[i]);
+    }
+
     return true;
 }
 
@@ -627,6 +674,40 @@ bool VoctreeLocalizer::localizeAllResults(const feature::MapRegionsPerDesc& quer
     assert(resectionData.pt2D.cols() == numCollectedPts);
     assert(resectionData.pt3D.cols() == numCollectedPts);
 
+    if (!estimatePose(queryImageSize,
+                      param,
+                      randomNumberGenerator,
+                      useInputIntrinsics,
+                      queryIntrinsics,
+                      resectionData,
+                      associationIDs,
+                      matchedImages,
+                      localizationResult,
+                      imagePath))
+    {
+        return localizationResult.isValid();
+    }
+
+    if (param._nbFrameBufferMatching > 0)
+    {
+        // add everything to the buffer
+        _frameBuffer.emplace_back(localizationResult, queryRegions);
+    }
+
+    return localizationResult.isValid();
+}
+
+bool VoctreeLocalizer::estimatePose(const std::pair<std::size_t, std::size_t>& queryImageSize,
+                                    const Parameters& param,
+                                    std::mt19937& randomNumberGenerator,
+                                    bool useInputIntrinsics,
+                                    camera::Pinhole& queryIntrinsics,
+                                    sfm::ImageLocalizerMatchData& resectionData,
+                                    const std::vector<IndMatch3D2D>& associationIDs,
+                                    const std::vector<voctree::DocMatch>& matchedImages,
+                                    LocalizationResult& localizationResult,
+                                    const std::string& imagePath) const
+{
     geometry::Pose3 pose;
 
     // estimate the pose
@@ -651,7 +732,7 @@ bool VoctreeLocalizer::localizeAllResults(const feature::MapRegionsPerDesc& quer
               imagePath, queryImageSize, resectionData.pt2D, param._visualDebug + "/" + fs::path(imagePath).stem().string() + ".associations.svg");
         }
         localizationResult = LocalizationResult(resectionData, associationIDs, pose, queryIntrinsics, matchedImages, bResection);
-        return localizationResult.isValid();
+        return false;
     }
     ALICEVISION_LOG_DEBUG("[poseEstimation]\tResection SUCCEDED");
 
@@ -707,13 +788,100 @@ bool VoctreeLocalizer::localizeAllResults(const feature::MapRegionsPerDesc& quer
                                         << " max = " << std::sqrt(sqrErrors.maxCoeff()));
     }
 
+    return true;
+}
+
+bool VoctreeLocalizer::localizeTracking(const feature::MapRegionsPerDesc& queryRegions,
+                                        const std::pair<std::size_t, std::size_t>& queryImageSize,
+                                        const Parameters& param,
+                                        std::mt19937& randomNumberGenerator,
+                                        bool useInputIntrinsics,
+                                        camera::Pinhole& queryIntrinsics,
+                                        LocalizationResult& localizationResult,
+                                        const std::string& imagePath)
+{
+    assert(_previousFrame);
+    const FrameData& previousFrame = *_previousFrame;
+
+    // A. guided matching with the inliers of the previous frame
+    // the features of the previous frame are the projections of their landmarks with the previous pose
+    // (up to the resection residual), they are searched in the query image within the search radius
+    const robustEstimation::Mat3Model identity(Mat3::Identity());
+    matching::MatchesPerDescType featureMatches;
+    matching::guidedMatching<robustEstimation::Mat3Model, multiview::relativePose::HomographyAsymmetricError>(identity,
+                                                                                                             nullptr,
+                                                                                                             previousFrame._regions,
+                                                                                                             nullptr,
+                                                                                                             queryRegions,
+                                                                                                             Square(param._trackingSearchRadius),
+                                                                                                             Square(param._fDistRatio),
+                                                                                                             featureMatches);
+
+    const std::size_t nbTrackedLandmarks = featureMatches.getNbAllMatches();
+    ALICEVISION_LOG_DEBUG("[tracking]\tTracked " << nbTrackedLandmarks << " landmarks from the previous frame");
+    if (nbTrackedLandmarks < param._trackingMinNbInliers)
+        return false;
+
+    // B. recover the 2D-3D associations from the matches
+    sfm::ImageLocalizerMatchData resectionData;
+    resectionData.pt2D = Mat2X(2, nbTrackedLandmarks);
+    resectionData.pt3D = Mat3X(3, nbTrackedLandmarks);
+    resectionData.vec_descType.reserve(nbTrackedLandmarks);
+    std::vector<IndMatch3D2D> associationIDs;
+    associationIDs.reserve(nbTrackedLandmarks);
+
+    for (const auto& featureMatchesIt : featureMatches)
+    {
+        const feature::EImageDescriberType descType = featureMatchesIt.first;
+        const auto& previousRegionsMapping = previousFrame._regionsWith3D.at(descType);
+        for (const matching::IndMatch& featureMatch : featureMatchesIt.second)
+        {
+            const IndexT landmarkId = previousRegionsMapping._associated3dPoint.at(featureMatch._i);
+            const IndexT featureId = featureMatch._j;
+            const std::size_t index = associationIDs.size();
+
+            resectionData.pt2D.col(index) = queryRegions.at(descType)->GetRegionPosition(featureId);
+            resectionData.pt3D.col(index) = _sfm_data.getLandmarks().at(landmarkId).X;
+            resectionData.vec_descType.push_back(descType);
+            associationIDs.emplace_back(landmarkId, descType, featureId);
+        }
+    }
+
+    // C. estimate the pose
+    LocalizationResult trackingResult;
+    camera::Pinhole trackingIntrinsics = queryIntrinsics;
+    if (!estimatePose(queryImageSize,
+                      param,
+                      randomNumberGenerator,
+                      useInputIntrinsics,
+                      trackingIntrinsics,
+                      resectionData,
+                      associationIDs,
+                      std::vector<voctree::DocMatch>(),
+                      trackingResult,
+                      imagePath) ||
+        !trackingResult.isValid())
+    {
+        ALICEVISION_LOG_DEBUG("[tracking]\tResection failed, fall back to the database retrieval");
+        return false;
+    }
+
+    if (trackingResult.getInliers().size() < param._trackingMinNbInliers)
+    {
+        ALICEVISION_LOG_DEBUG("[tracking]\tOnly " << trackingResult.getInliers().size() << " inliers, fall back to the database retrieval");
+        return false;
+    }
+
+    queryIntrinsics = trackingIntrinsics;
+    localizationResult = trackingResult;
+
     if (param._nbFrameBufferMatching > 0)
     {
         // add everything to the buffer
         _frameBuffer.emplace_back(localizationResult, queryRegions);
     }
 
-    return localizationResult.isValid();
+    return true;
 }
 
 void VoctreeLocalizer::getAllAssociations(const feature::MapRegionsPerDesc& queryRegions,
@@ -766,140 +934,185 @@ void VoctreeLocalizer::getAllAssociations(const feature::MapRegionsPerDesc& quer
 
     // B. for each found similar image, try to find the correspondences between the
     // query image adn the similar image
+    // The similar images are matched in parallel by chunks of nbThreads images, each one with
+    // its own results, which are then merged in the order of the similar images.
     // stop when param._maxResults successful matches have been found
-    std::size_t goodMatches = 0;
-    for (const voctree::DocMatch& matchedImage : out_matchedImages)
+    const int maxNbThreads = omp_get_max_threads();
+    const int nbThreads = (param._nbMatchingThreads > 0) ? std::min(param._nbMatchingThreads, maxNbThreads) : maxNbThreads;
+    const std::size_t chunkSize = (param._maxResults == 0) ? out_matchedImages.size() : static_cast<std::size_t>(nbThreads);
+
+    struct CandidateMatches
     {
-        // minimum number of points that allows a reliable 3D reconstruction
-        const size_t minNum3DPoints = 5;
+        IndexT viewId;
+        const camera::Pinhole* intrinsics;
+        std::mt19937::result_type seed;
+        bool matchWorked = false;
+        matching::MatchesPerDescType featureMatches;
+    };
 
-        const auto matchedViewId = matchedImage.id;
-        // the handler to the current view
-        const std::shared_ptr<sfmData::View> matchedView = _sfm_data.getViews().at(matchedViewId);
-        // its associated reconstructed regions
-        const feature::MapRegionsPerDesc& matchedRegions = _regionsPerView.getRegionsPerDesc(matchedViewId);
+    std::size_t goodMatches = 0;
+    for (std::size_t chunkStart = 0; chunkStart < out_matchedImages.size(); chunkStart += chunkSize)
+    {
+        const std::size_t chunkEnd = std::min(chunkStart + chunkSize, out_matchedImages.size());
 
-        // safeguard: we should match the query image with an image that has at least
-        // some 3D points visible --> if this is not true it is likely that it is an
-        // image of the dataset that was not reconstructed
-        if (matchedRegions.getNbAllRegions() < minNum3DPoints)
+        // select the candidates of the chunk, the random seeds are drawn sequentially
+        // to keep the results independent of the number of threads
+        std::vector<CandidateMatches> candidates;
+        candidates.reserve(chunkEnd - chunkStart);
+        for (std::size_t c = chunkStart; c < chunkEnd; ++c)
         {
-            ALICEVISION_LOG_DEBUG("[matching]\tSkipping matching with " << matchedView->getImage().getImagePath()
-                                                                        << " as it has too few visible 3D points");
-            continue;
-        }
-        ALICEVISION_LOG_TRACE("[matching]\tTrying to match the query image with " << matchedView->getImage().getImagePath());
-        ALICEVISION_LOG_TRACE("[matching]\tIt has " << matchedRegions.getNbAllRegions() << " available features to match");
+            // minimum number of points that allows a reliable 3D reconstruction
+            const size_t minNum3DPoints = 5;
+
+            const auto matchedViewId = out_matchedImages[c].id;
+            // the handler to the current view
+            const std::shared_ptr<sfmData::View> matchedView = _sfm_data.getViews().at(matchedViewId);
+            // its associated reconstructed regions
+            const feature::MapRegionsPerDesc& matchedRegions = _regionsPerView.getRegionsPerDesc(matchedViewId);
+
+            // safeguard: we should match the query image with an image that has at least
+            // some 3D points visible --> if this is not true it is likely that it is an
+            // image of the dataset that was not reconstructed
+            if (matchedRegions.getNbAllRegions() < minNum3DPoints)
+            {
+                ALICEVISION_LOG_DEBUG("[matching]\tSkipping matching with " << matchedView->getImage().getImagePath()
+                                                                            << " as it has too few visible 3D points");
+                continue;
+            }
+            ALICEVISION_LOG_TRACE("[matching]\tTrying to match the query image with " << matchedView->getImage().getImagePath());
+            ALICEVISION_LOG_TRACE("[matching]\tIt has " << matchedRegions.getNbAllRegions() << " available features to match");
 
-        // its associated intrinsics
-        // this is just ugly!
-        const camera::IntrinsicBase* matchedIntrinsicsBase = _sfm_data.getIntrinsics().at(matchedView->getIntrinsicId()).get();
-        if (!isPinhole(matchedIntrinsicsBase->getType()))
-        {
-            //@fixme maybe better to throw something here
-            ALICEVISION_CERR("Only Pinhole cameras are supported!");
-            return;
+            // its associated intrinsics
+            // this is just ugly!
+            const camera::IntrinsicBase* matchedIntrinsicsBase = _sfm_data.getIntrinsics().at(matchedView->getIntrinsicId()).get();
+            if (!isPinhole(matchedIntrinsicsBase->getType()))
+            {
+                //@fixme maybe better to throw something here
+                ALICEVISION_CERR("Only Pinhole cameras are supported!");
+                return;
+            }
+
+            CandidateMatches candidate;
+            candidate.viewId = matchedViewId;
+            candidate.intrinsics = (const camera::Pinhole*)(matchedIntrinsicsBase);
+            candidate.seed = randomNumberGenerator();
+            candidates.push_back(std::move(candidate));
         }
-        const camera::Pinhole* matchedIntrinsics = (const camera::Pinhole*)(matchedIntrinsicsBase);
 
-        matching::MatchesPerDescType featureMatches;
-        const bool matchWorked = robustMatching(matchers,
-                                                // pass the input intrinsic if they are valid, null otherwise
-                                                (useInputIntrinsics) ? &queryIntrinsics : nullptr,
-                                                matchedRegions,
-                                                matchedIntrinsics,
-                                                param._fDistRatio,
-                                                param._matchingError,
-                                                param._useRobustMatching,
-                                                param._useGuidedMatching,
-                                                imageSize,
-                                                std::make_pair(matchedView->getImage().getWidth(), matchedView->getImage().getHeight()),
-                                                randomNumberGenerator,
-                                                featureMatches,
-                                                param._matchingEstimator);
-        if (!matchWorked)
+        // the matchers only read the query regions, so they are shared by all the threads
+#pragma omp parallel for num_threads(nbThreads) schedule(dynamic)
+        for (int c = 0; c < candidates.size(); ++c)
         {
-            //      ALICEVISION_LOG_DEBUG("[matching]\tMatching with " << matchedView->getImage().getImagePath() << " failed! Skipping image");
-            continue;
+            CandidateMatches& candidate = candidates[c];
+            const std::shared_ptr<sfmData::View> matchedView = _sfm_data.getViews().at(candidate.viewId);
+            std::mt19937 candidateRandomNumberGenerator(candidate.seed);
+
+            candidate.matchWorked = robustMatching(matchers,
+                                                   // pass the input intrinsic if they are valid, null otherwise
+                                                   (useInputIntrinsics) ? &queryIntrinsics : nullptr,
+                                                   _regionsPerView.getRegionsPerDesc(candidate.viewId),
+                                                   candidate.intrinsics,
+                                                   param._fDistRatio,
+                                                   param._matchingError,
+                                                   param._useRobustMatching,
+                                                   param._useGuidedMatching,
+                                                   imageSize,
+                                                   std::make_pair(matchedView->getImage().getWidth(), matchedView->getImage().getHeight()),
+                                                   candidateRandomNumberGenerator,
+                                                   candidate.featureMatches,
+                                                   param._matchingEstimator);
         }
 
-        ALICEVISION_LOG_DEBUG("[matching]\tFound " << featureMatches.getNbAllMatches() << " geometrically validated matches");
-        assert(featureMatches.getNbAllMatches() > 0);
-
-        // if debug is enable save the matches between the query image and the current matching image
-        // It saves the feature matches in a folder with the same name as the query
-        // image, if it does not exist it will create it. The final svg file will have
-        // a name like this: queryImage_matchedImage.svg placed in the following directory:
-        // param._visualDebug/queryImage/
-        if (!param._visualDebug.empty() && !imagePath.empty())
+        for (const CandidateMatches& candidate : candidates)
         {
-            namespace fs = std::filesystem;
-            const sfmData::View* mview = _sfm_data.getViews().at(matchedViewId).get();
-            // the current query image without extension
-            const auto queryImage = fs::path(imagePath).stem();
-            // the matching image without extension
-            const auto matchedImage = fs::path(mview->getImage().getImagePath()).stem();
-            // the full path of the matching image
-            const auto matchedPath = mview->getImage().getImagePath();
-
-            // the directory where to save the feature matches
-            const auto baseDir = fs::path(param._visualDebug) / queryImage;
-            if ((!utils::exists(baseDir)))
+            if (!candidate.matchWorked)
             {
-                ALICEVISION_LOG_DEBUG("created " << baseDir.string());
-                fs::create_directories(baseDir);
+                continue;
             }
 
-            // damn you, boost, what does it take to make the operator "+"?
-            // the final filename for the output svg file as a composition of the query
-            // image and the matched image
-            auto outputName = baseDir / queryImage;
-            outputName += "_";
-            outputName += matchedImage;
-            outputName += ".svg";
+            const IndexT matchedViewId = candidate.viewId;
+            const matching::MatchesPerDescType& featureMatches = candidate.featureMatches;
 
-            matching::saveMatches2SVG(imagePath,
-                                      imageSize,
-                                      queryRegions,
-                                      matchedPath,
-                                      std::make_pair(mview->getImage().getWidth(), mview->getImage().getHeight()),
-                                      _regionsPerView.getRegionsPerDesc(matchedViewId),
-                                      featureMatches,
-                                      outputName.string());
-        }
-
-        const auto& matchedRegionsMapping = _reconstructedRegionsMappingPerView.at(matchedViewId);
+            ALICEVISION_LOG_DEBUG("[matching]\tFound " << featureMatches.getNbAllMatches() << " geometrically validated matches");
+            assert(featureMatches.getNbAllMatches() > 0);
 
-        // C. recover the 2D-3D associations from the matches
-        // Each matched feature in the current similar image is associated to a 3D point
-        for (const auto& featureMatchesIt : featureMatches)
-        {
-            feature::EImageDescriberType descType = featureMatchesIt.first;
-            const auto& matchedRegionsMappingType = matchedRegionsMapping.at(descType);
-            for (const matching::IndMatch& featureMatch : featureMatchesIt.second)
+            // if debug is enable save the matches between the query image and the current matching image
+            // It saves the feature matches in a folder with the same name as the query
+            // image, if it does not exist it will create it. The final svg file will have
+            // a name like this: queryImage_matchedImage.svg placed in the following directory:
+            // param._visualDebug/queryImage/
+            if (!param._visualDebug.empty() && !imagePath.empty())
             {
-                // the ID of the 3D point
-                const IndexT pt3D_id = matchedRegionsMappingType._associated3dPoint[featureMatch._j];
-                const IndexT pt2D_id = featureMatch._i;
-
-                const OccurenceKey key(pt3D_id, descType, pt2D_id);
-                if (out_occurences.count(key))
+                namespace fs = std::filesystem;
+                const sfmData::View* mview = _sfm_data.getViews().at(matchedViewId).get();
+                // the current query image without extension
+                const auto queryImage = fs::path(imagePath).stem();
+                // the matching image without extension
+                const auto matchedImage = fs::path(mview->getImage().getImagePath()).stem();
+                // the full path of the matching image
+                const auto matchedPath = mview->getImage().getImagePath();
+
+                // the directory where to save the feature matches
+                const auto baseDir = fs::path(param._visualDebug) / queryImage;
+                if ((!utils::exists(baseDir)))
                 {
-                    out_occurences[key]++;
+                    ALICEVISION_LOG_DEBUG("created " << baseDir.string());
+                    fs::create_directories(baseDir);
                 }
-                else
+
+                // damn you, boost, what does it take to make the operator "+"?
+                // the final filename for the output svg file as a composition of the query
+                // image and the matched image
+                auto outputName = baseDir / queryImage;
+                outputName += "_";
+                outputName += matchedImage;
+                outputName += ".svg";
+
+                matching::saveMatches2SVG(imagePath,
+                                          imageSize,
+                                          queryRegions,
+                                          matchedPath,
+                                          std::make_pair(mview->getImage().getWidth(), mview->getImage().getHeight()),
+                                          _regionsPerView.getRegionsPerDesc(matchedViewId),
+                                          featureMatches,
+                                          outputName.string());
+            }
+
+            const auto& matchedRegionsMapping = _reconstructedRegionsMappingPerView.at(matchedViewId);
+
+            // C. recover the 2D-3D associations from the matches
+            // Each matched feature in the current similar image is associated to a 3D point
+            for (const auto& featureMatchesIt : featureMatches)
+            {
+                feature::EImageDescriberType descType = featureMatchesIt.first;
+                const auto& matchedRegionsMappingType = matchedRegionsMapping.at(descType);
+                for (const matching::IndMatch& featureMatch : featureMatchesIt.second)
                 {
-                    out_occurences[key] = 1;
+                    // the ID of the 3D point
+                    const IndexT pt3D_id = matchedRegionsMappingType._associated3dPoint[featureMatch._j];
+                    const IndexT pt2D_id = featureMatch._i;
+
+                    const OccurenceKey key(pt3D_id, descType, pt2D_id);
+                    if (out_occurences.count(key))
+                    {
+                        out_occurences[key]++;
+                    }
+                    else
+                    {
+                        out_occurences[key] = 1;
+                    }
                 }
             }
+            ++goodMatches;
+            if ((param._maxResults != 0) && (goodMatches == param._maxResults))
+            {
+                // let's say we have enough features
+                ALICEVISION_LOG_DEBUG("[matching]\tgot enough point from " << param._maxResults << " images");
+                break;
+            }
         }
-        ++goodMatches;
         if ((param._maxResults != 0) && (goodMatches == param._maxResults))
-        {
-            // let's say we have enough features
-            ALICEVISION_LOG_DEBUG("[matching]\tgot enough point from " << param._maxResults << " images");
             break;
-        }
     }
 
     if (param._nbFrameBufferMatching > 0)
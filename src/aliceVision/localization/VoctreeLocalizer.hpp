@@ -56,7 +56,11 @@ class VoctreeLocalizer : public ILocalizer
             _numCommonViews(3),
             _ccTagUseCuda(true),
             _matchingError(std::numeric_limits<double>::infinity()),
-            _nbFrameBufferMatching(10)
+            _nbFrameBufferMatching(10),
+            _nbMatchingThreads(0),
+            _useTracking(false),
+            _trackingSearchRadius(20.0),
+            _trackingMinNbInliers(50)
         {}
 
         /// Enable/disable guided matching when matching images
@@ -77,6 +81,14 @@ class VoctreeLocalizer : public ILocalizer
         double _matchingError;
         /// maximum capacity of the frame buffer
         std::size_t _nbFrameBufferMatching;
+        /// number of threads used to match the query image with the similar images of the database (0 to use all the available threads)
+        int _nbMatchingThreads;
+        /// Enable/disable the tracking of the landmarks of the previous frame before the database retrieval (single camera feeds only)
+        bool _useTracking;
+        /// for tracking, radius (in pixels) around the previous position of a landmark where it is searched in the query image
+        double _trackingSearchRadius;
+        /// for tracking, minimum number of tracked landmarks (and of resection inliers) to accept the pose, otherwise it falls back to the retrieval
+        std::size_t _trackingMinNbInliers;
     };
 
   public:
@@ -104,6 +116,18 @@ class VoctreeLocalizer : public ILocalizer
 
     void setCudaPipe(int i) override { _cudaPipe = i; }
 
+    /**
+     * @brief Extract the regions of the query image for each describer type of the localizer.
+     * @param[in] imageGrey The input greyscale image.
+     * @param[in] param The parameters for the localization.
+     * @param[out] queryRegions The extracted regions.
+     * @param[in] imagePath Optional complete path to the image, used only for debugging purposes.
+     */
+    void extractQueryRegions(const image::Image<float>& imageGrey,
+                             const LocalizerParameters* param,
+                             feature::MapRegionsPerDesc& queryRegions,
+                             const std::string& imagePath = std::string()) override;
+
     /**
      * @brief Just a wrapper around the different localization algorithm, the algorithm
      * used to localized is chosen using \p param._algorithm. This version extract the
@@ -241,6 +265,31 @@ class VoctreeLocalizer : public ILocalizer
                             LocalizationResult& localizationResult,
                             const std::string& imagePath = std::string());
 
+    /**
+     * @brief Try to localize an image by tracking the landmarks of the previous frame: each inlier
+     * landmark of the previous frame is searched with guided matching around its position in the previous frame,
+     * then the pose is estimated with these correspondences. It supposes a small motion between the frames.
+     *
+     * @param[in] queryRegions The input features of the query image
+     * @param[in] imageSize The size of the input image
+     * @param[in] param The parameters for the localization
+     * @param[in] randomNumberGenerator The random seed
+     * @param[in] useInputIntrinsics Uses the \p queryIntrinsics as known calibration
+     * @param[in,out] queryIntrinsics Intrinsic parameters of the camera, they are used if the
+     * flag useInputIntrinsics is set to true, otherwise they are estimated from the correspondences.
+     * @param[out] localizationResult The localization result containing the pose and the associations.
+     * @param[in] imagePath Optional complete path to the image, used only for debugging purposes.
+     * @return true if enough landmarks have been tracked and the localization is successful
+     */
+    bool localizeTracking(const feature::MapRegionsPerDesc& queryRegions,
+                          const std::pair<std::size_t, std::size_t>& imageSize,
+                          const Parameters& param,
+                          std::mt19937& randomNumberGenerator,
+                          bool useInputIntrinsics,
+                          camera::Pinhole& queryIntrinsics,
+                          LocalizationResult& localizationResult,
+                          const std::string& imagePath = std::string());
+
     /**
      * @brief Retrieve matches to all images of the database.
      *
@@ -271,6 +320,32 @@ class VoctreeLocalizer : public ILocalizer
                             const std::string& imagePath = std::string()) const;
 
   private:
+    /**
+     * @brief Estimate and refine the pose of the query image from its 2D-3D correspondences.
+     *
+     * @param[in] queryImageSize The size of the input image
+     * @param[in] param The parameters for the localization
+     * @param[in] randomNumberGenerator The random seed
+     * @param[in] useInputIntrinsics Uses the \p queryIntrinsics as known calibration
+     * @param[in,out] queryIntrinsics Intrinsic parameters of the camera
+     * @param[in,out] resectionData The 2D-3D correspondences, the inliers are set by the resection
+     * @param[in] associationIDs The ids of the 2D-3D correspondences
+     * @param[in] matchedImages The images of the database used to get the correspondences
+     * @param[out] localizationResult The localization result containing the pose and the associations.
+     * @param[in] imagePath Optional complete path to the image, used only for debugging purposes.
+     * @return true if the resection succeeded, the validity of the refined pose is given by \p localizationResult
+     */
+    bool estimatePose(const std::pair<std::size_t, std::size_t>& queryImageSize,
+                      const Parameters& param,
+                      std::mt19937& randomNumberGenerator,
+                      bool useInputIntrinsics,
+                      camera::Pinhole& queryIntrinsics,
+                      sfm::ImageLocalizerMatchData& resectionData,
+                      const std::vector<IndMatch3D2D>& associationIDs,
+                      const std::vector<voctree::DocMatch>& matchedImages,
+                      LocalizationResult& localizationResult,
+                      const std::string& imagePath) const;
+
     /**
      * @brief Load the vocabulary tree.
 
@@ -356,6 +431,9 @@ class VoctreeLocalizer : public ILocalizer
     /// Last frames buffer
     BoundedBuffer<FrameData> _frameBuffer;
 
+    /// Last localized frame, used for tracking
+    std::unique_ptr<FrameData> _previousFrame;
+
     matching::EMatcherType _matcherType = matching::ANN_L2;
 };
 
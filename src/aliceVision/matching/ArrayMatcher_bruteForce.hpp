@@ -114,28 +114,33 @@ class ArrayMatcher_bruteForce : public ArrayMatcher<Scalar, Metric>
         pvec_distances->resize(nbQuery * NN);
         pvec_indices->resize(nbQuery * NN);
 
-#pragma omp parallel for schedule(dynamic)
-        for (int queryIndex = 0; queryIndex < nbQuery; ++queryIndex)
+#pragma omp parallel
         {
-            std::vector<DistanceType> vec_distance((*memMapping).rows(), 0.0);
-            const Scalar* queryPtr = mat_query.row(queryIndex).data();
-            const Scalar* rowPtr = (*memMapping).data();
-            for (int i = 0; i < (*memMapping).rows(); ++i)
-            {
-                vec_distance[i] = metric(queryPtr, rowPtr, (*memMapping).cols());
-                rowPtr += (*memMapping).cols();
-            }
-
-            // Find the N minimum distances:
-            const int maxMinFound = (int)std::min(size_t(NN), vec_distance.size());
+            // Per-thread buffers reused for all the queries
             using namespace stl::indexed_sort;
+            std::vector<DistanceType> vec_distance((*memMapping).rows(), 0.0);
             std::vector<sort_index_packet_ascend<DistanceType, int>> packet_vec(vec_distance.size());
-            sort_index_helper(packet_vec, &vec_distance[0], maxMinFound);
 
-            for (int i = 0; i < maxMinFound; ++i)
+#pragma omp for schedule(dynamic)
+            for (int queryIndex = 0; queryIndex < nbQuery; ++queryIndex)
             {
-                (*pvec_distances)[queryIndex * NN + i] = packet_vec[i].val;
-                (*pvec_indices)[queryIndex * NN + i] = IndMatch(queryIndex, packet_vec[i].index);
+                const Scalar* queryPtr = mat_query.row(queryIndex).data();
+                const Scalar* rowPtr = (*memMapping).data();
+                for (int i = 0; i < (*memMapping).rows(); ++i)
+                {
+                    vec_distance[i] = metric(queryPtr, rowPtr, (*memMapping).cols());
+                    rowPtr += (*memMapping).cols();
+                }
+
+                // Find the N minimum distances:
+                const int maxMinFound = (int)std::min(size_t(NN), vec_distance.size());
+                sort_index_helper(packet_vec, &vec_distance[0], maxMinFound);
+
+                for (int i = 0; i < maxMinFound; ++i)
+                {
+                    (*pvec_distances)[queryIndex * NN + i] = packet_vec[i].val;
+                    (*pvec_indices)[queryIndex * NN + i] = IndMatch(queryIndex, packet_vec[i].index);
+                }
             }
         }
         return true;
@@ -0,0 +1,122 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/matching/ArrayMatcher.hpp>
+#include <aliceVision/matching/cuda/DeviceBruteForceMatcher.hpp>
+#include <aliceVision/feature/metric.hpp>
+
+#include <vector>
+
+namespace aliceVision {
+namespace matching {
+
+/**
+ * @brief Brute force matcher computing square(L2 distance) on the GPU.
+ *
+ * The dataset descriptors stay on the device while the matcher is alive,
+ * so matching many query images against the same dataset only uploads the queries.
+ * Only supports up to 2 nearest neighbours (enough for the distance ratio test).
+ */
+template<typename Scalar = float, typename Metric = feature::L2_Simple<Scalar>>
+class ArrayMatcher_bruteForceCuda : public ArrayMatcher<Scalar, Metric>
+{
+  public:
+    typedef typename Metric::ResultType DistanceType;
+
+    ArrayMatcher_bruteForceCuda() {}
+    virtual ~ArrayMatcher_bruteForceCuda() {}
+
+    /**
+     * Build the matching structure
+     *
+     * \param[in] dataset   Input data.
+     * \param[in] nbRows    The number of component.
+     * \param[in] dimension Length of the data contained in the dataset.
+     *
+     * \return True if success.
+     */
+    bool Build(std::mt19937& randomNumberGenerator, const Scalar* dataset, int nbRows, int dimension)
+    {
+        if (nbRows < 1)
+        {
+            _isBuilt = false;
+            return false;
+        }
+        _deviceMatcher.setDataset(dataset, nbRows, dimension);
+        _isBuilt = true;
+        return true;
+    }
+
+    /**
+     * Search the nearest Neighbor of the scalar array query.
+     *
+     * \param[in]   query     The query array
+     * \param[out]  indice    The indice of array in the dataset that
+     *  have been computed as the nearest array.
+     * \param[out]  distance  The distance between the two arrays.
+     *
+     * \return True if success.
+     */
+    bool SearchNeighbour(const Scalar* query, int* indice, DistanceType* distance)
+    {
+        if (!_isBuilt)
+            return false;
+
+        int indices[2];
+        float distances[2];
+        _deviceMatcher.searchTwoNearestNeighbours(query, 1, indices, distances);
+
+        *indice = indices[0];
+        *distance = static_cast<DistanceType>(distances[0]);
+        return true;
+    }
+
+    /**
+     * Search the N (N <= 2) nearest Neighbor of the scalar array query.
+     *
+     * \param[in]   query     The query array
+     * \param[in]   nbQuery   The number of query rows
+     * \param[out]  indices   The corresponding (query, neighbor) indices
+     * \param[out]  distances The distances between the matched arrays.
+     * \param[out]  NN        The number of maximal neighbor that will be searched.
+     *
+     * \return True if success.
+     */
+    bool SearchNeighbours(const Scalar* query, int nbQuery, IndMatches* pvec_indices, std::vector<DistanceType>* pvec_distances, size_t NN)
+    {
+        if (!_isBuilt)
+            return false;
+
+        if (NN > 2 || NN > std::size_t(_deviceMatcher.getNbRows()) || nbQuery < 1)
+            return false;
+
+        std::vector<int> indices(nbQuery * 2);
+        std::vector<float> distances(nbQuery * 2);
+        _deviceMatcher.searchTwoNearestNeighbours(query, nbQuery, indices.data(), distances.data());
+
+        pvec_distances->resize(nbQuery * NN);
+        pvec_indices->resize(nbQuery * NN);
+
+        for (int queryIndex = 0; queryIndex < nbQuery; ++queryIndex)
+        {
+            for (std::size_t i = 0; i < NN; ++i)
+            {
+                (*pvec_distances)[queryIndex * NN + i] = static_cast<DistanceType>(distances[queryIndex * 2 + i]);
+                (*pvec_indices)[queryIndex * NN + i] = IndMatch(queryIndex, indices[queryIndex * 2 + i]);
+            }
+        }
+        return true;
+    }
+
+  private:
+    cuda::DeviceBruteForceMatcher<Scalar> _deviceMatcher;
+    bool _isBuilt = false;
+};
+
+}  // namespace matching
+}  // namespace aliceVision
@@ -0,0 +1,190 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/numeric/numeric.hpp>
+#include <aliceVision/matching/ArrayMatcher.hpp>
+#include <aliceVision/matching/ProductQuantizer.hpp>
+#include <aliceVision/feature/metric.hpp>
+#include <aliceVision/stl/indexedSort.hpp>
+
+#include <algorithm>
+#include <memory>
+
+namespace aliceVision {
+namespace matching {
+
+// Implementation of descriptor matching with a product quantization of the database (see ProductQuantizer).
+// The database descriptors are compressed, each query is compared to all the codes with the approximate
+// asymmetric distance, then the best candidates are re-ranked with the exact Metric.
+// By default compute square(L2 distance).
+template<typename Scalar = float, typename Metric = feature::L2_Simple<Scalar>>
+class ArrayMatcher_productQuantization : public ArrayMatcher<Scalar, Metric>
+{
+  public:
+    typedef typename Metric::ResultType DistanceType;
+
+    /**
+     * @param[in] nbCandidates The number of approximate neighbors re-ranked with the exact distance
+     */
+    explicit ArrayMatcher_productQuantization(int nbCandidates = 16)
+      : _nbCandidates(nbCandidates)
+    {}
+    virtual ~ArrayMatcher_productQuantization() { memMapping.reset(); }
+
+    /**
+     * @brief Use trained codebooks (e.g. shared by all the images of a dataset) instead of training them on each database.
+     * @note Must be called before Build().
+     */
+    void setQuantizer(const std::shared_ptr<const ProductQuantizer>& quantizer) { _quantizer = quantizer; }
+
+    const std::shared_ptr<const ProductQuantizer>& getQuantizer() const { return _quantizer; }
+
+    /// the compressed database, quantizer codeSize() bytes per descriptor
+    const std::vector<std::uint8_t>& getCodes() const { return _codes; }
+
+    /**
+     * Build the matching structure
+     *
+     * \param[in] dataset   Input data.
+     * \param[in] nbRows    The number of component.
+     * \param[in] dimension Length of the data contained in the dataset.
+     *
+     * \return True if success.
+     */
+    bool Build(std::mt19937& randomNumberGenerator, const Scalar* dataset, int nbRows, int dimension)
+    {
+        if (nbRows < 1)
+        {
+            memMapping.reset(nullptr);
+            _codes.clear();
+            return false;
+        }
+        memMapping.reset(new Eigen::Map<BaseMat>((Scalar*)dataset, nbRows, dimension));
+
+        if (!_quantizer || !_quantizer->isTrained() || _quantizer->dimension() != dimension)
+        {
+            std::shared_ptr<ProductQuantizer> quantizer = std::make_shared<ProductQuantizer>(dimension);
+            quantizer->train(randomNumberGenerator, dataset, nbRows);
+            _quantizer = quantizer;
+        }
+        _quantizer->encode(dataset, nbRows, _codes);
+        return true;
+    }
+
+    /**
+     * Search the nearest Neighbor of the scalar array query.
+     *
+     * \param[in]   query     The query array
+     * \param[out]  indice    The indice of array in the dataset that
+     *  have been computed as the nearest array.
+     * \param[out]  distance  The distance between the two arrays.
+     *
+     * \return True if success.
+     */
+    bool SearchNeighbour(const Scalar* query, int* indice, DistanceType* distance)
+    {
+        IndMatches indices;
+        std::vector<DistanceType> distances;
+        if (!SearchNeighbours(query, 1, &indices, &distances, 1))
+            return false;
+        *indice = indices.front()._j;
+        *distance = distances.front();
+        return true;
+    }
+
+    /**
+     * Search the N nearest Neighbor of the scalar array query.
+     *
+     * \param[in]   query     The query array
+     * \param[in]   nbQuery   The number of query rows
+     * \param[out]  indices   The corresponding (query, neighbor) indices
+     * \param[out]  distances The distances between the matched arrays.
+     * \param[out]  NN        The number of maximal neighbor that will be searched.
+     *
+     * \return True if success.
+     */
+    bool SearchNeighbours(const Scalar* query, int nbQuery, IndMatches* pvec_indices, std::vector<DistanceType>* pvec_distances, size_t NN)
+    {
+        if (memMapping.get() == nullptr)
+        {
+            return false;
+        }
+
+        const int nbRows = static_cast<int>((*memMapping).rows());
+        if (NN > static_cast<size_t>(nbRows) || nbQuery < 1)
+        {
+            return false;
+        }
+
+        const int dimension = static_cast<int>((*memMapping).cols());
+        const int codeSize = _quantizer->codeSize();
+        const int nbCandidates = std::min(nbRows, std::max(static_cast<int>(NN), _nbCandidates));
+        Metric metric;
+
+        pvec_distances->resize(nbQuery * NN);
+        pvec_indices->resize(nbQuery * NN);
+
+#pragma omp parallel
+        {
+            // Per-thread buffers reused for all the queries
+            using namespace stl::indexed_sort;
+            std::vector<float> table(_quantizer->distanceTableSize());
+            std::vector<float> approximateDistances(nbRows);
+            std::vector<int> candidates(nbRows);
+            std::vector<DistanceType> exactDistances(nbCandidates);
+            std::vector<sort_index_packet_ascend<DistanceType, int>> packet_vec(nbCandidates);
+
+#pragma omp for schedule(dynamic)
+            for (int queryIndex = 0; queryIndex < nbQuery; ++queryIndex)
+            {
+                const Scalar* queryPtr = query + static_cast<std::size_t>(queryIndex) * dimension;
+
+                // approximate distances to all the codes
+                _quantizer->computeDistanceTable(queryPtr, table.data());
+                const std::uint8_t* code = _codes.data();
+                for (int i = 0; i < nbRows; ++i)
+                {
+                    approximateDistances[i] = _quantizer->asymmetricDistance(table.data(), code);
+                    candidates[i] = i;
+                    code += codeSize;
+                }
+
+                // keep the best candidates
+                std::nth_element(candidates.begin(), candidates.begin() + (nbCandidates - 1), candidates.end(), [&](int a, int b) {
+                    return approximateDistances[a] < approximateDistances[b];
+                });
+
+                // exact verification
+                for (int c = 0; c < nbCandidates; ++c)
+                {
+                    exactDistances[c] = metric(queryPtr, (*memMapping).row(candidates[c]).data(), dimension);
+                }
+
+                sort_index_helper(packet_vec, &exactDistances[0], static_cast<int>(NN));
+
+                for (int i = 0; i < static_cast<int>(NN); ++i)
+                {
+                    (*pvec_distances)[queryIndex * NN + i] = packet_vec[i].val;
+                    (*pvec_indices)[queryIndex * NN + i] = IndMatch(queryIndex, candidates[packet_vec[i].index]);
+                }
+            }
+        }
+        return true;
+    };
+
+  private:
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> BaseMat;
+    /// Use a memory mapping in order to avoid memory re-allocation
+    std::unique_ptr<Eigen::Map<BaseMat>> memMapping;
+    std::shared_ptr<const ProductQuantizer> _quantizer;
+    std::vector<std::uint8_t> _codes;
+    int _nbCandidates;
+};
+
+}  // namespace matching
+}  // namespace aliceVision
@@ -10,33 +10,45 @@
 #include <aliceVision/numeric/numeric.hpp>
 #include <aliceVision/feature/metric.hpp>
 #include <aliceVision/matching/IndMatch.hpp>
-#include <aliceVision/stl/DynamicBitset.hpp>
 
+#include <algorithm>
+#include <cstdint>
 #include <iostream>
 #include <random>
 #include <cmath>
+#include <utility>
+#include <vector>
 
 namespace aliceVision {
 namespace matching {
 
-struct HashedDescription
+struct HashedDescriptions
 {
-    // Hash code generated by the primary hashing function.
-    stl::dynamic_bitset hash_code;
+    // The number of 64-bit blocks of each hash code.
+    int nb_hash_blocks = 0;
+    // The number of bucket groups.
+    int nb_bucket_groups = 0;
+    // The number of buckets in each group.
+    int nb_buckets_per_group = 0;
 
-    // Each bucket_ids[x] = y means the descriptor belongs to bucket y in bucket
+    // Hash codes generated by the primary hashing function,
+    // packed in nb_hash_blocks blocks per description.
+    std::vector<uint64_t> hash_codes;
+
+    // Each bucket_ids[i * nb_bucket_groups + x] = y means the description i belongs to bucket y in bucket
     // group x.
     std::vector<uint16_t> bucket_ids;
-};
 
-struct HashedDescriptions
-{
-    // The hash information.
-    std::vector<HashedDescription> hashed_desc;
+    // Contiguous storage of the buckets (container of description ids): the bucket y of the bucket group x
+    // contains bucket_descriptions[bucket_offsets[b]] to bucket_descriptions[bucket_offsets[b + 1] - 1]
+    // with b = x * nb_buckets_per_group + y.
+    std::vector<int> bucket_offsets;
+    std::vector<int> bucket_descriptions;
 
-    typedef std::vector<int> Bucket;
-    // buckets[bucket_group][bucket_id] = bucket (container of description ids).
-    std::vector<std::vector<Bucket>> buckets;
+    /// The number of hashed descriptions
+    inline std::size_t size() const { return nb_bucket_groups == 0 ? 0 : bucket_ids.size() / nb_bucket_groups; }
+
+    inline const uint64_t* hashCode(std::size_t i) const { return hash_codes.data() + i * nb_hash_blocks; }
 };
 
 /**
@@ -56,7 +68,9 @@ struct HashedDescriptions
  *
  * This implementation is based on the Theia library implementation from Chris Sweeney.
  * Update compare to the initial paper [1] and initial author code:
- * - hashing projection is made by using Eigen to use vectorization
+ * - hashing projection is made by using Eigen to use vectorization,
+ *   by blocks of descriptions
+ * - hash codes are packed in 64-bit blocks and buckets are stored contiguously
  * - replace the BoxMuller random number generation by C++ 11 random number generation
  * - this implementation can support various descriptor length and internal type
  *   SIFT, SURF, ... all scalar based descriptor
@@ -99,15 +113,14 @@ class CascadeHasher
                 primary_hash_projection_(i, j) = d(generator);
         }
 
-        // Initialize secondary hash projection.
-        secondary_hash_projection_.resize(nb_bucket_groups);
+        // Initialize secondary hash projection (the projections of all the bucket groups are stacked).
+        secondary_hash_projection_.resize(nb_bucket_groups * nb_bits_per_bucket_, nb_hash_code);
         for (int i = 0; i < nb_bucket_groups; ++i)
         {
-            secondary_hash_projection_[i].resize(nb_bits_per_bucket_, nb_hash_code);
             for (int j = 0; j < nb_bits_per_bucket_; ++j)
             {
                 for (int k = 0; k < nb_hash_code; ++k)
-                    secondary_hash_projection_[i](j, k) = d(generator);
+                    secondary_hash_projection_(i * nb_bits_per_bucket_ + j, k) = d(generator);
             }
         }
         return true;
@@ -145,60 +158,78 @@ class CascadeHasher
             return hashed_descriptions;
         }
 
+        const typename MatrixT::Index nbDescriptions = descriptions.rows();
+        hashed_descriptions.nb_hash_blocks = (nb_hash_code_ + 63) / 64;
+        hashed_descriptions.nb_bucket_groups = nb_bucket_groups_;
+        hashed_descriptions.nb_buckets_per_group = nb_buckets_per_group_;
+
         // Create hash codes for each description.
         {
-            // Allocate space for hash codes.
-            const typename MatrixT::Index nbDescriptions = descriptions.rows();
-            hashed_descriptions.hashed_desc.resize(nbDescriptions);
-            Eigen::VectorXf descriptor(descriptions.cols());
-            for (int i = 0; i < nbDescriptions; ++i)
+            // Allocate space for hash codes and bucket ids.
+            hashed_descriptions.hash_codes.assign(nbDescriptions * hashed_descriptions.nb_hash_blocks, 0);
+            hashed_descriptions.bucket_ids.resize(nbDescriptions * nb_bucket_groups_);
+
+            // Project the descriptions by blocks (one description per column) to use matrix products
+            const typename MatrixT::Index blockSize = 1024;
+            Eigen::MatrixXf descriptors;
+            Eigen::MatrixXf primary_projection;
+            Eigen::MatrixXf secondary_projection;
+            for (typename MatrixT::Index start = 0; start < nbDescriptions; start += blockSize)
             {
-                // Allocate space for each bucket id.
-                hashed_descriptions.hashed_desc[i].bucket_ids.resize(nb_bucket_groups_);
-
-                for (int k = 0; k < descriptions.cols(); ++k)
-                {
-                    descriptor(k) = descriptions(i, k);
-                }
-                descriptor -= zero_mean_descriptor;
+                const typename MatrixT::Index nbInBlock = std::min(blockSize, nbDescriptions - start);
+                descriptors = descriptions.middleRows(start, nbInBlock).template cast<float>().transpose();
+                descriptors.colwise() -= zero_mean_descriptor;
 
-                auto& hash_code = hashed_descriptions.hashed_desc[i].hash_code;
-                hash_code = stl::dynamic_bitset(descriptions.cols());
+                primary_projection.noalias() = primary_hash_projection_ * descriptors;
+                secondary_projection.noalias() = secondary_hash_projection_ * descriptors;
 
-                // Compute hash code.
-                const Eigen::VectorXf primary_projection = primary_hash_projection_ * descriptor;
-                for (int j = 0; j < nb_hash_code_; ++j)
+                for (typename MatrixT::Index b = 0; b < nbInBlock; ++b)
                 {
-                    hash_code[j] = primary_projection(j) > 0;
-                }
+                    const typename MatrixT::Index i = start + b;
 
-                // Determine the bucket index for each group.
-                Eigen::VectorXf secondary_projection;
-                for (int j = 0; j < nb_bucket_groups_; ++j)
-                {
-                    uint16_t bucket_id = 0;
-                    secondary_projection = secondary_hash_projection_[j] * descriptor;
+                    // Compute hash code.
+                    uint64_t* hash_code = hashed_descriptions.hash_codes.data() + i * hashed_descriptions.nb_hash_blocks;
+                    for (int j = 0; j < nb_hash_code_; ++j)
+                    {
+                        if (primary_projection(j, b) > 0)
+                            hash_code[j / 64] |= uint64_t(1) << (j % 64);
+                    }
 
-                    for (int k = 0; k < nb_bits_per_bucket_; ++k)
+                    // Determine the bucket index for each group.
+                    for (int j = 0; j < nb_bucket_groups_; ++j)
                     {
-                        bucket_id = (bucket_id << 1) + (secondary_projection(k) > 0 ? 1 : 0);
+                        uint16_t bucket_id = 0;
+                        for (int k = 0; k < nb_bits_per_bucket_; ++k)
+                        {
+                            bucket_id = (bucket_id << 1) + (secondary_projection(j * nb_bits_per_bucket_ + k, b) > 0 ? 1 : 0);
+                        }
+                        hashed_descriptions.bucket_ids[i * nb_bucket_groups_ + j] = bucket_id;
                     }
-                    hashed_descriptions.hashed_desc[i].bucket_ids[j] = bucket_id;
                 }
             }
         }
         // Build the Buckets
         {
-            hashed_descriptions.buckets.resize(nb_bucket_groups_);
-            for (int i = 0; i < nb_bucket_groups_; ++i)
+            // Count the descriptions of each bucket
+            const int nbBuckets = nb_bucket_groups_ * nb_buckets_per_group_;
+            hashed_descriptions.bucket_offsets.assign(nbBuckets + 1, 0);
+            for (typename MatrixT::Index i = 0; i < nbDescriptions; ++i)
             {
-                hashed_descriptions.buckets[i].resize(nb_buckets_per_group_);
+                for (int j = 0; j < nb_bucket_groups_; ++j)
+                    ++hashed_descriptions.bucket_offsets[j * nb_buckets_per_group_ + hashed_descriptions.bucket_ids[i * nb_bucket_groups_ + j] + 1];
+            }
+            for (int b = 0; b < nbBuckets; ++b)
+                hashed_descriptions.bucket_offsets[b + 1] += hashed_descriptions.bucket_offsets[b];
 
-                // Add the descriptor ID to the proper bucket group and id.
-                for (int j = 0; j < hashed_descriptions.hashed_desc.size(); ++j)
+            // Add the descriptor ID to the proper bucket group and id.
+            std::vector<int> bucket_fill(hashed_descriptions.bucket_offsets.begin(), hashed_descriptions.bucket_offsets.end() - 1);
+            hashed_descriptions.bucket_descriptions.resize(nbDescriptions * nb_bucket_groups_);
+            for (typename MatrixT::Index i = 0; i < nbDescriptions; ++i)
+            {
+                for (int j = 0; j < nb_bucket_groups_; ++j)
                 {
-                    const uint16_t bucket_id = hashed_descriptions.hashed_desc[j].bucket_ids[i];
-                    hashed_descriptions.buckets[i][bucket_id].push_back(j);
+                    const int b = j * nb_buckets_per_group_ + hashed_descriptions.bucket_ids[i * nb_bucket_groups_ + j];
+                    hashed_descriptions.bucket_descriptions[bucket_fill[b]++] = i;
                 }
             }
         }
@@ -221,16 +252,24 @@ class CascadeHasher
 
         static const int kNumTopCandidates = 10;
 
+        typedef feature::Hamming<uint64_t> HammingMetricType;
+
+        const std::size_t nbDescriptions1 = hashed_descriptions1.size();
+        const std::size_t nbDescriptions2 = hashed_descriptions2.size();
+        const int nb_hash_blocks = hashed_descriptions1.nb_hash_blocks;
+        if (nbDescriptions1 == 0 || nbDescriptions2 == 0)
+            return;
+
         // Preallocate the candidate descriptors container.
         std::vector<int> candidate_descriptors;
-        candidate_descriptors.reserve(hashed_descriptions2.hashed_desc.size());
+        candidate_descriptors.reserve(nbDescriptions2);
 
-        // Preallocated hamming distances. Each column indicates the hamming distance
-        // and the rows collect the descriptor ids with that
-        // distance. num_descriptors_with_hamming_distance keeps track of how many
-        // descriptors have that distance.
-        Eigen::MatrixXi candidate_hamming_distances(hashed_descriptions2.hashed_desc.size(), nb_hash_code_ + 1);
-        Eigen::VectorXi num_descriptors_with_hamming_distance(nb_hash_code_ + 1);
+        // Preallocated (hamming distance, descriptor id) of the unique candidates.
+        // num_descriptors_with_hamming_distance keeps track of how many
+        // descriptors have each distance.
+        std::vector<std::pair<int, int>> candidate_hamming_distances;
+        candidate_hamming_distances.reserve(nbDescriptions2);
+        std::vector<int> num_descriptors_with_hamming_distance(nb_hash_code_ + 1);
 
         // Preallocate the container for keeping euclidean distances.
         std::vector<std::pair<DistanceType, int>> candidate_euclidean_distances;
@@ -238,27 +277,29 @@ class CascadeHasher
 
         // A preallocated vector to determine if we have already used a particular
         // feature for matching (i.e., prevents duplicates).
-        std::vector<bool> used_descriptor(hashed_descriptions2.hashed_desc.size());
+        std::vector<unsigned char> used_descriptor(nbDescriptions2, 0);
 
-        typedef feature::Hamming<stl::dynamic_bitset::BlockType> HammingMetricType;
-        static const HammingMetricType metricH = {};
-        for (int i = 0; i < hashed_descriptions1.hashed_desc.size(); ++i)
+        for (std::size_t i = 0; i < nbDescriptions1; ++i)
         {
             candidate_descriptors.clear();
-            num_descriptors_with_hamming_distance.setZero();
+            candidate_hamming_distances.clear();
+            std::fill(num_descriptors_with_hamming_distance.begin(), num_descriptors_with_hamming_distance.end(), 0);
             candidate_euclidean_distances.clear();
 
-            const auto& hashed_desc = hashed_descriptions1.hashed_desc[i];
+            const uint64_t* hash_code = hashed_descriptions1.hashCode(i);
+            const uint16_t* bucket_ids = hashed_descriptions1.bucket_ids.data() + i * nb_bucket_groups_;
 
             // Accumulate all descriptors in each bucket group that are in the same
             // bucket id as the query descriptor.
             for (int j = 0; j < nb_bucket_groups_; ++j)
             {
-                const uint16_t bucket_id = hashed_desc.bucket_ids[j];
-                for (const auto& feature_id : hashed_descriptions2.buckets[j][bucket_id])
+                const int b = j * nb_buckets_per_group_ + bucket_ids[j];
+                const int* bucketBegin = hashed_descriptions2.bucket_descriptions.data() + hashed_descriptions2.bucket_offsets[b];
+                const int* bucketEnd = hashed_descriptions2.bucket_descriptions.data() + hashed_descriptions2.bucket_offsets[b + 1];
+                for (const int* feature_id = bucketBegin; feature_id != bucketEnd; ++feature_id)
                 {
-                    candidate_descriptors.emplace_back(feature_id);
-                    used_descriptor[feature_id] = false;
+                    candidate_descriptors.emplace_back(*feature_id);
+                    used_descriptor[*feature_id] = 0;
                 }
             }
 
@@ -269,33 +310,54 @@ class CascadeHasher
             }
 
             // Compute the hamming distance of all candidates based on the comp hash
-            // code. Put the descriptors into buckets corresponding to their hamming
-            // distance.
+            // code and count the descriptors with each hamming distance.
             for (const int candidate_id : candidate_descriptors)
             {
                 if (!used_descriptor[candidate_id])  // avoid selecting the same candidate multiple times
                 {
-                    used_descriptor[candidate_id] = true;
+                    used_descriptor[candidate_id] = 1;
 
-                    const HammingMetricType::ResultType hamming_distance = metricH(hashed_desc.hash_code.data(),
-                                                                                   hashed_descriptions2.hashed_desc[candidate_id].hash_code.data(),
-                                                                                   hashed_desc.hash_code.num_blocks());
-                    candidate_hamming_distances(num_descriptors_with_hamming_distance(hamming_distance)++, hamming_distance) = candidate_id;
+                    const uint64_t* candidate_hash_code = hashed_descriptions2.hashCode(candidate_id);
+                    int hamming_distance = 0;
+                    for (int k = 0; k < nb_hash_blocks; ++k)
+                        hamming_distance += HammingMetricType::popcnt64(hash_code[k] ^ candidate_hash_code[k]);
+
+                    candidate_hamming_distances.emplace_back(hamming_distance, candidate_id);
+                    ++num_descriptors_with_hamming_distance[hamming_distance];
+                }
+            }
+
+            // Find the hamming distance threshold selecting the k descriptors with the best hamming distance
+            // (with the same hamming distance, the first candidates are selected).
+            int max_hamming_distance = nb_hash_code_ + 1;
+            int nb_below_max_hamming_distance = 0;
+            for (int j = 0; j <= nb_hash_code_; ++j)
+            {
+                if (nb_below_max_hamming_distance + num_descriptors_with_hamming_distance[j] >= kNumTopCandidates)
+                {
+                    max_hamming_distance = j;
+                    break;
                 }
+                nb_below_max_hamming_distance += num_descriptors_with_hamming_distance[j];
             }
+            int nb_at_max_hamming_distance = kNumTopCandidates - nb_below_max_hamming_distance;
 
             // Compute the euclidean distance of the k descriptors with the best hamming
             // distance.
-            candidate_euclidean_distances.reserve(kNumTopCandidates);
-            for (int j = 0; j < candidate_hamming_distances.cols() && (candidate_euclidean_distances.size() < kNumTopCandidates); ++j)
+            for (const auto& candidate : candidate_hamming_distances)
             {
-                for (int k = 0; k < num_descriptors_with_hamming_distance(j) && (candidate_euclidean_distances.size() < kNumTopCandidates); ++k)
+                if (candidate.first > max_hamming_distance)
+                    continue;
+                if (candidate.first == max_hamming_distance)
                 {
-                    const int candidate_id = candidate_hamming_distances(k, j);
-                    const DistanceType distance = metric(descriptions2.row(candidate_id).data(), descriptions1.row(i).data(), descriptions1.cols());
-
-                    candidate_euclidean_distances.emplace_back(distance, candidate_id);
+                    if (nb_at_max_hamming_distance == 0)
+                        continue;
+                    --nb_at_max_hamming_distance;
                 }
+                const int candidate_id = candidate.second;
+                const DistanceType distance = metric(descriptions2.row(candidate_id).data(), descriptions1.row(i).data(), descriptions1.cols());
+
+                candidate_euclidean_distances.emplace_back(distance, candidate_id);
             }
 
             // Assert that each query is having at least NN retrieved neighbors
@@ -319,8 +381,8 @@ class CascadeHasher
     // Primary hashing function.
     Eigen::MatrixXf primary_hash_projection_;
 
-    // Secondary hashing function.
-    std::vector<Eigen::MatrixXf> secondary_hash_projection_;
+    // Secondary hashing function (projections of all the bucket groups stacked by rows).
+    Eigen::MatrixXf secondary_hash_projection_;
 };
 
 }  // namespace matching
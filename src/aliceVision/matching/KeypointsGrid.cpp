@@ -0,0 +1,193 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "KeypointsGrid.hpp"
+
+#include <aliceVision/camera/IntrinsicBase.hpp>
+#include <aliceVision/feature/Regions.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace aliceVision {
+namespace matching {
+
+namespace {
+
+std::vector<Vec2> getUndistortedPositions(const camera::IntrinsicBase* camera, const feature::Regions& regions)
+{
+    std::vector<Vec2> positions(regions.RegionCount());
+    const bool undistort = camera && camera->isValid();
+    for (std::size_t i = 0; i < positions.size(); ++i)
+        positions[i] = undistort ? camera->getUndistortedPixel(regions.GetRegionPosition(i)) : regions.GetRegionPosition(i);
+    return positions;
+}
+
+}  // namespace
+
+KeypointsGrid::KeypointsGrid(std::vector<Vec2> positions, double pointsPerCell)
+  : _positions(std::move(positions))
+{
+    if (_positions.empty())
+        return;
+
+    Vec2 maxCorner = _positions.front();
+    _origin = _positions.front();
+    for (const Vec2& position : _positions)
+    {
+        _origin = _origin.cwiseMin(position);
+        maxCorner = maxCorner.cwiseMax(position);
+    }
+
+    // choose the cell size to get the requested average number of keypoints per cell
+    const Vec2 extent = maxCorner - _origin;
+    const double area = std::max(extent(0), 1.0) * std::max(extent(1), 1.0);
+    _cellSize = std::max(1.0, std::sqrt(area * std::max(pointsPerCell, 1.0) / _positions.size()));
+
+    for (int axis = 0; axis < 2; ++axis)
+        _nbCells[axis] = std::max(1, static_cast<int>(std::ceil(extent(axis) / _cellSize)));
+
+    // counting sort of the keypoints per cell, the keypoints of a cell stay in ascending order
+    const std::size_t nbCells = std::size_t(_nbCells[0]) * _nbCells[1];
+    std::vector<IndexT> keypointsCell(_positions.size());
+    _cellOffsets.assign(nbCells + 1, 0);
+    for (std::size_t i = 0; i < _positions.size(); ++i)
+    {
+        keypointsCell[i] = toCell(_positions[i](1), 1) * _nbCells[0] + toCell(_positions[i](0), 0);
+        ++_cellOffsets[keypointsCell[i] + 1];
+    }
+    std::partial_sum(_cellOffsets.begin(), _cellOffsets.end(), _cellOffsets.begin());
+
+    std::vector<IndexT> cellsFill(_cellOffsets.begin(), _cellOffsets.end() - 1);
+    _indexes.resize(_positions.size());
+    for (std::size_t i = 0; i < _positions.size(); ++i)
+        _indexes[cellsFill[keypointsCell[i]]++] = i;
+}
+
+KeypointsGrid::KeypointsGrid(const camera::IntrinsicBase* camera, const feature::Regions& regions, double pointsPerCell)
+  : KeypointsGrid(getUndistortedPositions(camera, regions), pointsPerCell)
+{}
+
+int KeypointsGrid::toCell(double value, int axis) const
+{
+    const double cell = std::floor((value - _origin(axis)) / _cellSize);
+    if (!(cell > 0.0))  // also handles NaN
+        return 0;
+    return static_cast<int>(std::min(cell, static_cast<double>(_nbCells[axis] - 1)));
+}
+
+void KeypointsGrid::appendCells(int fixed, int begin, int end, bool byRow, std::vector<IndexT>& out_candidates) const
+{
+    if (byRow)
+    {
+        // the cells of a row are contiguous
+        const std::size_t firstCell = std::size_t(fixed) * _nbCells[0];
+        out_candidates.insert(
+          out_candidates.end(), _indexes.begin() + _cellOffsets[firstCell + begin], _indexes.begin() + _cellOffsets[firstCell + end + 1]);
+        return;
+    }
+
+    for (int row = begin; row <= end; ++row)
+    {
+        const std::size_t cell = std::size_t(row) * _nbCells[0] + fixed;
+        out_candidates.insert(out_candidates.end(), _indexes.begin() + _cellOffsets[cell], _indexes.begin() + _cellOffsets[cell + 1]);
+    }
+}
+
+void KeypointsGrid::getCandidatesInBand(const Vec3& line, double halfWidth, std::vector<IndexT>& out_candidates) const
+{
+    out_candidates.clear();
+
+    const double norm = line.head<2>().norm();
+    if (_positions.empty() || !(norm > 0.0))
+        return;
+
+    const Vec3 l = line / norm;
+
+    // walk along the axis the most parallel to the line, so that the band crosses few cells per step
+    const int walkAxis = (std::abs(l(1)) >= std::abs(l(0))) ? 0 : 1;
+    const int otherAxis = 1 - walkAxis;
+    const double walkCoef = l(walkAxis);
+    const double otherCoef = l(otherAxis);
+    const double bandExtent = halfWidth / std::abs(otherCoef);
+    const double otherMin = _origin(otherAxis);
+    const double otherMax = _origin(otherAxis) + _nbCells[otherAxis] * _cellSize;
+
+    for (int step = 0; step < _nbCells[walkAxis]; ++step)
+    {
+        // band extent along the other axis over the cells of this step
+        const double w0 = _origin(walkAxis) + step * _cellSize;
+        const double w1 = w0 + _cellSize;
+        const double o0 = -(walkCoef * w0 + l(2)) / otherCoef;
+        const double o1 = -(walkCoef * w1 + l(2)) / otherCoef;
+        const double bandMin = std::min(o0, o1) - bandExtent;
+        const double bandMax = std::max(o0, o1) + bandExtent;
+
+        if (bandMax < otherMin || bandMin > otherMax)
+            continue;
+
+        appendCells(step, toCell(bandMin, otherAxis), toCell(bandMax, otherAxis), walkAxis == 1, out_candidates);
+    }
+
+    std::sort(out_candidates.begin(), out_candidates.end());
+}
+
+void KeypointsGrid::getCandidatesInDisc(const Vec2& center, double radius, std::vector<IndexT>& out_candidates) const
+{
+    out_candidates.clear();
+
+    if (_positions.empty() || !center.allFinite())
+        return;
+
+    for (int axis = 0; axis < 2; ++axis)
+    {
+        if (center(axis) + radius < _origin(axis) || center(axis) - radius > _origin(axis) + _nbCells[axis] * _cellSize)
+            return;
+    }
+
+    const int colBegin = toCell(center(0) - radius, 0);
+    const int colEnd = toCell(center(0) + radius, 0);
+    for (int row = toCell(center(1) - radius, 1); row <= toCell(center(1) + radius, 1); ++row)
+        appendCells(row, colBegin, colEnd, true, out_candidates);
+
+    std::sort(out_candidates.begin(), out_candidates.end());
+}
+
+void KeypointsGrid::getAllCandidates(std::vector<IndexT>& out_candidates) const
+{
+    out_candidates.resize(_positions.size());
+    std::iota(out_candidates.begin(), out_candidates.end(), IndexT(0));
+}
+
+const KeypointsGrid& KeypointsGridCache::getGrid(IndexT viewId,
+                                                 feature::EImageDescriberType descType,
+                                                 const camera::IntrinsicBase* camera,
+                                                 const feature::Regions& regions)
+{
+    const std::pair<IndexT, feature::EImageDescriberType> key(viewId, descType);
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        const auto it = _grids.find(key);
+        if (it != _grids.end())
+            return *it->second;
+    }
+
+    // build the grid outside of the lock, if another thread was faster its grid is kept
+    std::unique_ptr<const KeypointsGrid> grid = std::make_unique<const KeypointsGrid>(camera, regions);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    return *_grids.emplace(key, std::move(grid)).first->second;
+}
+
+void KeypointsGridCache::clear()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _grids.clear();
+}
+
+}  // namespace matching
+}  // namespace aliceVision
@@ -0,0 +1,159 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/types.hpp>
+#include <aliceVision/numeric/numeric.hpp>
+#include <aliceVision/feature/imageDescriberCommon.hpp>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace aliceVision {
+
+namespace camera {
+class IntrinsicBase;
+}
+
+namespace feature {
+class Regions;
+}
+
+namespace matching {
+
+/**
+ * @brief Uniform grid index of the (undistorted) keypoints positions of a view.
+ *        Used by the guided matching to only compare the keypoints close to
+ *        an epipolar line or to a transferred point instead of all the keypoints.
+ *
+ * The keypoints indexes are stored cell by cell (row major) and sorted in each cell.
+ */
+class KeypointsGrid
+{
+  public:
+    /**
+     * @brief Build the grid index of the given positions.
+     * @param[in] positions The keypoints positions
+     * @param[in] pointsPerCell The average number of keypoints per cell used to choose the cell size
+     */
+    explicit KeypointsGrid(std::vector<Vec2> positions, double pointsPerCell = 8.0);
+
+    /**
+     * @brief Build the grid index of the undistorted positions of the given regions.
+     * @param[in] camera Optional camera (in order to undistord the regions positions, can be NULL)
+     * @param[in] regions The regions
+     * @param[in] pointsPerCell The average number of keypoints per cell used to choose the cell size
+     */
+    KeypointsGrid(const camera::IntrinsicBase* camera, const feature::Regions& regions, double pointsPerCell = 8.0);
+
+    /**
+     * @brief Get the indexed keypoints positions.
+     * @return the keypoints positions
+     */
+    inline const std::vector<Vec2>& getPositions() const { return _positions; }
+
+    /**
+     * @brief Get the number of indexed keypoints.
+     * @return the number of keypoints
+     */
+    inline std::size_t size() const { return _positions.size(); }
+
+    /**
+     * @brief Get the keypoints of the cells crossed by the band of a line.
+     *        The output is a superset of the keypoints at a distance to the line below the half width.
+     * @param[in] line The line (a, b, c) of equation a.x + b.y + c = 0
+     * @param[in] halfWidth The half width of the band (in pixels)
+     * @param[out] out_candidates The keypoints indexes, sorted in ascending order
+     */
+    void getCandidatesInBand(const Vec3& line, double halfWidth, std::vector<IndexT>& out_candidates) const;
+
+    /**
+     * @brief Get the keypoints of the cells crossed by a square centered on a point.
+     *        The output is a superset of the keypoints at a distance to the point below the radius.
+     * @param[in] center The center of the search region
+     * @param[in] radius The radius of the search region (in pixels)
+     * @param[out] out_candidates The keypoints indexes, sorted in ascending order
+     */
+    void getCandidatesInDisc(const Vec2& center, double radius, std::vector<IndexT>& out_candidates) const;
+
+    /**
+     * @brief Get all the keypoints.
+     * @param[out] out_candidates The keypoints indexes, sorted in ascending order
+     */
+    void getAllCandidates(std::vector<IndexT>& out_candidates) const;
+
+  private:
+    /**
+     * @brief Get the cell coordinate of a position along one axis, clamped to the grid.
+     * @param[in] value The position along the axis
+     * @param[in] axis The axis (0 for the columns, 1 for the rows)
+     * @return the cell coordinate
+     */
+    int toCell(double value, int axis) const;
+
+    /**
+     * @brief Append the keypoints of a range of cells of a row or of a column.
+     * @param[in] fixed The fixed cell coordinate (row if byRow, column otherwise)
+     * @param[in] begin The first cell coordinate along the other axis
+     * @param[in] end The last cell coordinate along the other axis (included)
+     * @param[in] byRow True to append cells of a row, false for cells of a column
+     * @param[out] out_candidates The keypoints indexes
+     */
+    void appendCells(int fixed, int begin, int end, bool byRow, std::vector<IndexT>& out_candidates) const;
+
+    std::vector<Vec2> _positions;
+    /// grid origin (bounding box min corner of the keypoints)
+    Vec2 _origin = Vec2::Zero();
+    double _cellSize = 1.0;
+    /// number of cells per axis (columns, rows)
+    int _nbCells[2] = {0, 0};
+    /// offsets of the first keypoint of each cell in _indexes (nbCells + 1)
+    std::vector<IndexT> _cellOffsets;
+    /// keypoints indexes sorted by cell
+    std::vector<IndexT> _indexes;
+};
+
+/**
+ * @brief Thread-safe cache of the keypoints grids per view and describer type,
+ *        so that a grid is built once and reused by all the image pairs of a view.
+ * @note The grids are built on the first request and never updated:
+ *       the regions and the cameras of the views must not change during the cache lifetime.
+ */
+class KeypointsGridCache
+{
+  public:
+    KeypointsGridCache() = default;
+
+    // no copy
+    KeypointsGridCache(const KeypointsGridCache&) = delete;
+    KeypointsGridCache& operator=(const KeypointsGridCache&) = delete;
+
+    /**
+     * @brief Get the keypoints grid of a view, built on the first call.
+     * @param[in] viewId The view id
+     * @param[in] descType The describer type of the regions
+     * @param[in] camera Optional camera of the view (can be NULL)
+     * @param[in] regions The regions of the view for the given describer type
+     * @return the keypoints grid
+     */
+    const KeypointsGrid& getGrid(IndexT viewId, feature::EImageDescriberType descType, const camera::IntrinsicBase* camera, const feature::Regions& regions);
+
+    /**
+     * @brief Release all the grids.
+     */
+    void clear();
+
+  private:
+    std::mutex _mutex;
+    std::map<std::pair<IndexT, feature::EImageDescriberType>, std::unique_ptr<const KeypointsGrid>> _grids;
+};
+
+}  // namespace matching
+}  // namespace aliceVision
@@ -0,0 +1,210 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "ProductQuantizer.hpp"
+
+#include <aliceVision/system/Logger.hpp>
+
+#include <fstream>
+#include <limits>
+
+namespace aliceVision {
+namespace matching {
+
+namespace {
+
+const std::uint32_t productQuantizerMagic = 0x31515041;  // "APQ1"
+
+inline float squaredDistance(const float* a, const float* b, int size)
+{
+    float distance = 0.f;
+    for (int i = 0; i < size; ++i)
+    {
+        const float d = a[i] - b[i];
+        distance += d * d;
+    }
+    return distance;
+}
+
+/**
+ * @brief Index of the nearest centroid of a sub-vector.
+ */
+inline int nearestCentroid(const float* centroids, int nbCentroids, const float* x, int size)
+{
+    int best = 0;
+    float bestDistance = std::numeric_limits<float>::max();
+    for (int k = 0; k < nbCentroids; ++k)
+    {
+        const float distance = squaredDistance(centroids + static_cast<std::size_t>(k) * size, x, size);
+        if (distance < bestDistance)
+        {
+            bestDistance = distance;
+            best = k;
+        }
+    }
+    return best;
+}
+
+}  // namespace
+
+ProductQuantizer::ProductQuantizer(int dimension, int nbSubspaces, int nbCentroids)
+  : _dimension(dimension),
+    _nbCentroids(std::min(std::max(nbCentroids, 1), 256))
+{
+    nbSubspaces = std::min(std::max(nbSubspaces, 1), std::max(dimension, 1));
+    _offsets.resize(nbSubspaces + 1);
+    for (int m = 0; m <= nbSubspaces; ++m)
+        _offsets[m] = (m * dimension) / nbSubspaces;
+}
+
+void ProductQuantizer::trainKMeans(std::mt19937& randomNumberGenerator, const std::vector<float>& samples, int nbIterations)
+{
+    const int nbSamples = static_cast<int>(samples.size() / std::max(_dimension, 1));
+    if (nbSamples < 1)
+        ALICEVISION_THROW_ERROR("Cannot train a product quantizer without descriptors.");
+
+    _centroids.assign(static_cast<std::size_t>(_dimension) * _nbCentroids, 0.f);
+
+    // seeds of each subspace, drawn before the parallel section for reproducibility
+    const int nbSubspaces = this->nbSubspaces();
+    std::vector<int> seeds(static_cast<std::size_t>(nbSubspaces) * _nbCentroids);
+    {
+        std::vector<int> rows(nbSamples);
+        for (int i = 0; i < nbSamples; ++i)
+            rows[i] = i;
+        for (int m = 0; m < nbSubspaces; ++m)
+        {
+            std::shuffle(rows.begin(), rows.end(), randomNumberGenerator);
+            for (int k = 0; k < _nbCentroids; ++k)
+                seeds[m * _nbCentroids + k] = rows[k % nbSamples];
+        }
+    }
+
+    // the subspaces are independent
+#pragma omp parallel for schedule(dynamic)
+    for (int m = 0; m < nbSubspaces; ++m)
+    {
+        const int offset = _offsets[m];
+        const int size = _offsets[m + 1] - offset;
+        float* centroids = _centroids.data() + static_cast<std::size_t>(offset) * _nbCentroids;
+
+        for (int k = 0; k < _nbCentroids; ++k)
+        {
+            const float* seed = samples.data() + static_cast<std::size_t>(seeds[m * _nbCentroids + k]) * _dimension + offset;
+            std::copy_n(seed, size, centroids + static_cast<std::size_t>(k) * size);
+        }
+
+        std::vector<int> assignment(nbSamples, -1);
+        std::vector<double> sums(static_cast<std::size_t>(_nbCentroids) * size);
+        std::vector<int> counts(_nbCentroids);
+
+        for (int iteration = 0; iteration < nbIterations; ++iteration)
+        {
+            bool changed = false;
+            std::fill(sums.begin(), sums.end(), 0.0);
+            std::fill(counts.begin(), counts.end(), 0);
+
+            for (int i = 0; i < nbSamples; ++i)
+            {
+                const float* x = samples.data() + static_cast<std::size_t>(i) * _dimension + offset;
+                const int k = nearestCentroid(centroids, _nbCentroids, x, size);
+                changed |= (assignment[i] != k);
+                assignment[i] = k;
+                ++counts[k];
+                double* sum = sums.data() + static_cast<std::size_t>(k) * size;
+                for (int d = 0; d < size; ++d)
+                    sum[d] += x[d];
+            }
+
+            if (!changed)
+                break;
+
+            // empty clusters keep their previous centroid
+            for (int k = 0; k < _nbCentroids; ++k)
+            {
+                if (counts[k] == 0)
+                    continue;
+                const double* sum = sums.data() + static_cast<std::size_t>(k) * size;
+                float* centroid = centroids + static_cast<std::size_t>(k) * size;
+                for (int d = 0; d < size; ++d)
+                    centroid[d] = static_cast<float>(sum[d] / counts[k]);
+            }
+        }
+    }
+}
+
+void ProductQuantizer::encodeDescriptor(const float* descriptor, std::uint8_t* code) const
+{
+    const int nbSubspaces = this->nbSubspaces();
+    for (int m = 0; m < nbSubspaces; ++m)
+    {
+        const int size = _offsets[m + 1] - _offsets[m];
+        code[m] = static_cast<std::uint8_t>(nearestCentroid(subspaceCentroids(m), _nbCentroids, descriptor + _offsets[m], size));
+    }
+}
+
+void ProductQuantizer::computeDistanceTable(const float* query, float* table) const
+{
+    const int nbSubspaces = this->nbSubspaces();
+    for (int m = 0; m < nbSubspaces; ++m)
+    {
+        const int size = _offsets[m + 1] - _offsets[m];
+        const float* centroids = subspaceCentroids(m);
+        const float* x = query + _offsets[m];
+        for (int k = 0; k < _nbCentroids; ++k)
+            table[k] = squaredDistance(centroids + static_cast<std::size_t>(k) * size, x, size);
+        table += _nbCentroids;
+    }
+}
+
+void ProductQuantizer::decode(const std::uint8_t* code, float* descriptor) const
+{
+    const int nbSubspaces = this->nbSubspaces();
+    for (int m = 0; m < nbSubspaces; ++m)
+    {
+        const int size = _offsets[m + 1] - _offsets[m];
+        std::copy_n(subspaceCentroids(m) + static_cast<std::size_t>(code[m]) * size, size, descriptor + _offsets[m]);
+    }
+}
+
+void ProductQuantizer::save(const std::string& filepath) const
+{
+    std::ofstream stream(filepath, std::ios::binary);
+    if (!stream.is_open())
+        ALICEVISION_THROW_ERROR("Unable to write the product quantizer file: " << filepath);
+
+    const std::uint32_t header[4] = {
+      productQuantizerMagic, static_cast<std::uint32_t>(_dimension), static_cast<std::uint32_t>(nbSubspaces()), static_cast<std::uint32_t>(_nbCentroids)};
+    stream.write(reinterpret_cast<const char*>(header), sizeof(header));
+    stream.write(reinterpret_cast<const char*>(_centroids.data()), _centroids.size() * sizeof(float));
+
+    if (!stream.good())
+        ALICEVISION_THROW_ERROR("Failed to write the product quantizer file: " << filepath);
+}
+
+void ProductQuantizer::load(const std::string& filepath)
+{
+    std::ifstream stream(filepath, std::ios::binary);
+    if (!stream.is_open())
+        ALICEVISION_THROW_ERROR("Unable to open the product quantizer file: " << filepath);
+
+    std::uint32_t header[4];
+    stream.read(reinterpret_cast<char*>(header), sizeof(header));
+    if (!stream.good() || header[0] != productQuantizerMagic || header[3] < 1 || header[3] > 256)
+        ALICEVISION_THROW_ERROR("Invalid product quantizer file: " << filepath);
+
+    *this = ProductQuantizer(static_cast<int>(header[1]), static_cast<int>(header[2]), static_cast<int>(header[3]));
+    if (nbSubspaces() != static_cast<int>(header[2]))
+        ALICEVISION_THROW_ERROR("Invalid product quantizer file: " << filepath);
+
+    _centroids.resize(static_cast<std::size_t>(_dimension) * _nbCentroids);
+    stream.read(reinterpret_cast<char*>(_centroids.data()), _centroids.size() * sizeof(float));
+    if (!stream.good())
+        ALICEVISION_THROW_ERROR("Invalid product quantizer file: " << filepath);
+}
+
+}  // namespace matching
+}  // namespace aliceVision
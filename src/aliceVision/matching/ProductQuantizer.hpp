@@ -0,0 +1,175 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace aliceVision {
+namespace matching {
+
+//------------------
+//-- Bibliography --
+//------------------
+//- [1] "Product Quantization for Nearest Neighbor Search"
+//- Authors: Herve Jegou, Matthijs Douze, Cordelia Schmid.
+//- Date: 2011.
+//- Journal: IEEE Transactions on Pattern Analysis and Machine Intelligence.
+//
+
+/**
+ * @brief Product quantizer of [1].
+ *
+ * The descriptor space is split in contiguous subspaces, each subspace is quantized with its own k-means codebook.
+ * A descriptor is compressed to one byte per subspace (the index of its nearest centroid in each subspace).
+ * The squared L2 distance between a query and a compressed descriptor is approximated with the distances
+ * between the query and the centroids (asymmetric distance computation, ADC), with a lookup table computed once per query.
+ */
+class ProductQuantizer
+{
+  public:
+    ProductQuantizer() = default;
+
+    /**
+     * @brief Configure an untrained quantizer.
+     * @param[in] dimension The descriptors dimension
+     * @param[in] nbSubspaces The number of subspaces (bytes per code), clamped to the dimension
+     * @param[in] nbCentroids The number of centroids per subspace, clamped to [1, 256]
+     */
+    explicit ProductQuantizer(int dimension, int nbSubspaces = 16, int nbCentroids = 256);
+
+    bool isTrained() const { return !_centroids.empty(); }
+    int dimension() const { return _dimension; }
+    int nbSubspaces() const { return static_cast<int>(_offsets.size()) - 1; }
+    int nbCentroids() const { return _nbCentroids; }
+    /// number of bytes of a code
+    int codeSize() const { return nbSubspaces(); }
+    /// number of floats of a distance table
+    int distanceTableSize() const { return nbSubspaces() * _nbCentroids; }
+
+    /**
+     * @brief Train the codebooks with k-means on a random subset of the descriptors.
+     * @param[in] randomNumberGenerator The random generator of the subset and of the k-means seeds
+     * @param[in] data The descriptors, row major
+     * @param[in] nbRows The number of descriptors
+     * @param[in] maxTrainingRows The maximum number of descriptors used for the training
+     * @param[in] nbIterations The number of k-means iterations
+     */
+    template<typename Scalar>
+    void train(std::mt19937& randomNumberGenerator, const Scalar* data, int nbRows, int maxTrainingRows = 8192, int nbIterations = 8)
+    {
+        std::vector<int> rows(nbRows);
+        for (int i = 0; i < nbRows; ++i)
+            rows[i] = i;
+        if (nbRows > maxTrainingRows)
+        {
+            std::shuffle(rows.begin(), rows.end(), randomNumberGenerator);
+            rows.resize(maxTrainingRows);
+        }
+
+        std::vector<float> samples(rows.size() * _dimension);
+        for (std::size_t i = 0; i < rows.size(); ++i)
+        {
+            std::copy_n(data + static_cast<std::size_t>(rows[i]) * _dimension, _dimension, samples.begin() + i * _dimension);
+        }
+
+        trainKMeans(randomNumberGenerator, samples, nbIterations);
+    }
+
+    /**
+     * @brief Compress descriptors, in parallel.
+     * @param[in] data The descriptors, row major
+     * @param[in] nbRows The number of descriptors
+     * @param[out] codes The codes, codeSize() bytes per descriptor
+     */
+    template<typename Scalar>
+    void encode(const Scalar* data, int nbRows, std::vector<std::uint8_t>& codes) const
+    {
+        codes.resize(static_cast<std::size_t>(nbRows) * codeSize());
+
+#pragma omp parallel
+        {
+            std::vector<float> descriptor(_dimension);
+
+#pragma omp for
+            for (int i = 0; i < nbRows; ++i)
+            {
+                std::copy_n(data + static_cast<std::size_t>(i) * _dimension, _dimension, descriptor.begin());
+                encodeDescriptor(descriptor.data(), codes.data() + static_cast<std::size_t>(i) * codeSize());
+            }
+        }
+    }
+
+    /**
+     * @brief Compute the squared L2 distances between a query and all the centroids.
+     * @param[in] query The query descriptor
+     * @param[out] table The distance table, distanceTableSize() floats
+     */
+    template<typename Scalar>
+    void computeDistanceTable(const Scalar* query, float* table) const
+    {
+        std::vector<float> descriptor(query, query + _dimension);
+        computeDistanceTable(descriptor.data(), table);
+    }
+
+    void computeDistanceTable(const float* query, float* table) const;
+
+    /**
+     * @brief Approximate squared L2 distance between a query and a code.
+     * @param[in] table The distance table of the query
+     * @param[in] code The code
+     */
+    float asymmetricDistance(const float* table, const std::uint8_t* code) const
+    {
+        float distance = 0.f;
+        const int nbSubspaces = codeSize();
+        for (int m = 0; m < nbSubspaces; ++m)
+        {
+            distance += table[code[m]];
+            table += _nbCentroids;
+        }
+        return distance;
+    }
+
+    /**
+     * @brief Decompress a code to the concatenation of its centroids.
+     * @param[in] code The code
+     * @param[out] descriptor The approximated descriptor, dimension() floats
+     */
+    void decode(const std::uint8_t* code, float* descriptor) const;
+
+    /**
+     * @brief Save the codebooks in a binary file, to share them between the images of a dataset.
+     */
+    void save(const std::string& filepath) const;
+
+    /**
+     * @brief Load codebooks saved with save().
+     */
+    void load(const std::string& filepath);
+
+  private:
+    void trainKMeans(std::mt19937& randomNumberGenerator, const std::vector<float>& samples, int nbIterations);
+
+    void encodeDescriptor(const float* descriptor, std::uint8_t* code) const;
+
+    /// the centroids of a subspace
+    const float* subspaceCentroids(int m) const { return _centroids.data() + static_cast<std::size_t>(_offsets[m]) * _nbCentroids; }
+
+    int _dimension = 0;
+    int _nbCentroids = 0;
+    /// first dimension of each subspace, followed by the dimension
+    std::vector<int> _offsets;
+    /// centroids of each subspace (nbCentroids x subspace dimension, row major), one after the other
+    std::vector<float> _centroids;
+};
+
+}  // namespace matching
+}  // namespace aliceVision
@@ -10,8 +10,13 @@
 #include "aliceVision/matching/ArrayMatcher_bruteForce.hpp"
 #include "aliceVision/matching/ArrayMatcher_kdtreeFlann.hpp"
 #include "aliceVision/matching/ArrayMatcher_cascadeHashing.hpp"
+#include "aliceVision/matching/ArrayMatcher_productQuantization.hpp"
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
+    #include "aliceVision/matching/ArrayMatcher_bruteForceCuda.hpp"
+#endif
 
 #include <aliceVision/system/Logger.hpp>
+#include <aliceVision/config.hpp>
 
 namespace aliceVision {
 namespace matching {
@@ -91,6 +96,23 @@ std::unique_ptr<IRegionsMatcher> createRegionsMatcher(std::mt19937& randomNumber
                     out.reset(new matching::RegionsMatcher<MatcherT>(randomNumberGenerator, regions, true));
                 }
                 break;
+                case PRODUCT_QUANTIZATION_L2:
+                {
+                    typedef feature::L2_Vectorized<unsigned char> MetricT;
+                    typedef ArrayMatcher_productQuantization<unsigned char, MetricT> MatcherT;
+                    out.reset(new matching::RegionsMatcher<MatcherT>(randomNumberGenerator, regions, true));
+                }
+                break;
+                case BRUTE_FORCE_L2_CUDA:
+                {
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
+                    typedef ArrayMatcher_bruteForceCuda<unsigned char> MatcherT;
+                    out.reset(new matching::RegionsMatcher<MatcherT>(randomNumberGenerator, regions, true));
+#else
+                    ALICEVISION_THROW_ERROR("BRUTE_FORCE_L2_CUDA matcher requires a build with CUDA.");
+#endif
+                }
+                break;
                 default:
                     ALICEVISION_LOG_WARNING("Using unknown matcher type");
             }
@@ -120,6 +142,23 @@ std::unique_ptr<IRegionsMatcher> createRegionsMatcher(std::mt19937& randomNumber
                     out.reset(new matching::RegionsMatcher<MatcherT>(randomNumberGenerator, regions, true));
                 }
                 break;
+                case PRODUCT_QUANTIZATION_L2:
+                {
+                    typedef feature::L2_Vectorized<float> MetricT;
+                    typedef ArrayMatcher_productQuantization<float, MetricT> MatcherT;
+                    out.reset(new matching::RegionsMatcher<MatcherT>(randomNumberGenerator, regions, true));
+                }
+                break;
+                case BRUTE_FORCE_L2_CUDA:
+                {
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
+                    typedef ArrayMatcher_bruteForceCuda<float> MatcherT;
+                    out.reset(new matching::RegionsMatcher<MatcherT>(randomNumberGenerator, regions, true));
+#else
+                    ALICEVISION_THROW_ERROR("BRUTE_FORCE_L2_CUDA matcher requires a build with CUDA.");
+#endif
+                }
+                break;
                 default:
                     ALICEVISION_LOG_WARNING("Using unknown matcher type");
             }
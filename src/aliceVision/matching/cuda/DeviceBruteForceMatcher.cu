@@ -0,0 +1,210 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "DeviceBruteForceMatcher.hpp"
+
+#include <cuda_runtime.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <sstream>
+#include <stdexcept>
+
+#define CHECK_MATCHING_CUDA_ERROR(err)                                                                                                               \
+    if (err != cudaSuccess)                                                                                                                          \
+    {                                                                                                                                                \
+        std::stringstream s;                                                                                                                         \
+        s << "\n  CUDA Error: " << cudaGetErrorString(err) << "\n  file:  " << __FILE__ << "\n  function:   " << __FUNCTION__                        \
+          << "\n  line:       " << __LINE__ << "\n";                                                                                                 \
+        throw std::runtime_error(s.str());                                                                                                           \
+    }
+
+namespace aliceVision {
+namespace matching {
+namespace cuda {
+
+/// Number of threads per block, one block per query descriptor (must be a power of 2)
+constexpr int BLOCK_SIZE = 128;
+
+/**
+ * @brief Keep the 2 smallest distances of two sorted pairs of candidates in (d1, i1, d2, i2).
+ */
+__device__ inline void mergeTwoNearest(float& d1, int& i1, float& d2, int& i2, float e1, int j1, float e2, int j2)
+{
+    if (e1 < d1)
+    {
+        // e1 is the best, second is the min of d1 and e2
+        if (d1 < e2)
+        {
+            d2 = d1;
+            i2 = i1;
+        }
+        else
+        {
+            d2 = e2;
+            i2 = j2;
+        }
+        d1 = e1;
+        i1 = j1;
+    }
+    else if (e1 < d2)
+    {
+        d2 = e1;
+        i2 = j1;
+    }
+}
+
+/**
+ * @brief Brute force 2-nearest neighbours of each query descriptor.
+ *        Each block processes one query, each thread a strided subset of the dataset.
+ */
+template<typename Scalar>
+__global__ void twoNearestNeighbours_kernel(const Scalar* dataset,
+                                            int nbRows,
+                                            const Scalar* queries,
+                                            int dimension,
+                                            int* out_indices,
+                                            float* out_distances)
+{
+    extern __shared__ float sharedMem[];
+    float* query = sharedMem;                         // dimension
+    float* bestDist = sharedMem + dimension;          // 2 * BLOCK_SIZE
+    int* bestIndex = (int*)(bestDist + 2 * BLOCK_SIZE);  // 2 * BLOCK_SIZE
+
+    const int queryIndex = blockIdx.x;
+    const int tid = threadIdx.x;
+
+    // load the query descriptor in shared memory
+    const Scalar* queryPtr = queries + std::size_t(queryIndex) * dimension;
+    for (int k = tid; k < dimension; k += BLOCK_SIZE)
+        query[k] = float(queryPtr[k]);
+
+    __syncthreads();
+
+    float d1 = FLT_MAX;
+    float d2 = FLT_MAX;
+    int i1 = -1;
+    int i2 = -1;
+
+    for (int r = tid; r < nbRows; r += BLOCK_SIZE)
+    {
+        const Scalar* rowPtr = dataset + std::size_t(r) * dimension;
+        float dist = 0.f;
+        for (int k = 0; k < dimension; ++k)
+        {
+            const float diff = float(rowPtr[k]) - query[k];
+            dist += diff * diff;
+        }
+        mergeTwoNearest(d1, i1, d2, i2, dist, r, FLT_MAX, -1);
+    }
+
+    bestDist[2 * tid] = d1;
+    bestDist[2 * tid + 1] = d2;
+    bestIndex[2 * tid] = i1;
+    bestIndex[2 * tid + 1] = i2;
+
+    __syncthreads();
+
+    // reduce the per-thread candidates in shared memory
+    for (int s = BLOCK_SIZE / 2; s > 0; s >>= 1)
+    {
+        if (tid < s)
+        {
+            const int other = tid + s;
+            mergeTwoNearest(d1, i1, d2, i2, bestDist[2 * other], bestIndex[2 * other], bestDist[2 * other + 1], bestIndex[2 * other + 1]);
+            bestDist[2 * tid] = d1;
+            bestDist[2 * tid + 1] = d2;
+            bestIndex[2 * tid] = i1;
+            bestIndex[2 * tid + 1] = i2;
+        }
+        __syncthreads();
+    }
+
+    if (tid == 0)
+    {
+        out_indices[2 * queryIndex] = i1;
+        out_indices[2 * queryIndex + 1] = i2;
+        out_distances[2 * queryIndex] = d1;
+        out_distances[2 * queryIndex + 1] = d2;
+    }
+}
+
+template<typename Scalar>
+DeviceBruteForceMatcher<Scalar>::~DeviceBruteForceMatcher()
+{
+    // no throw in destructor
+    cudaFree(_dataset);
+    cudaFree(_queries);
+    cudaFree(_indices);
+    cudaFree(_distances);
+}
+
+template<typename Scalar>
+void DeviceBruteForceMatcher<Scalar>::setDataset(const Scalar* dataset, int nbRows, int dimension)
+{
+    const std::size_t bytes = std::size_t(nbRows) * dimension * sizeof(Scalar);
+
+    if (std::size_t(_nbRows) * _dimension < std::size_t(nbRows) * dimension)
+    {
+        CHECK_MATCHING_CUDA_ERROR(cudaFree(_dataset));
+        _dataset = nullptr;
+        CHECK_MATCHING_CUDA_ERROR(cudaMalloc(&_dataset, bytes));
+    }
+
+    _nbRows = nbRows;
+    _dimension = dimension;
+
+    CHECK_MATCHING_CUDA_ERROR(cudaMemcpy(_dataset, dataset, bytes, cudaMemcpyHostToDevice));
+}
+
+template<typename Scalar>
+void DeviceBruteForceMatcher<Scalar>::allocateQueries(int nbQueries)
+{
+    if (std::size_t(nbQueries) <= _queriesCapacity && std::size_t(_dimension) <= _queriesDimension)
+        return;
+
+    CHECK_MATCHING_CUDA_ERROR(cudaFree(_queries));
+    CHECK_MATCHING_CUDA_ERROR(cudaFree(_indices));
+    CHECK_MATCHING_CUDA_ERROR(cudaFree(_distances));
+    _queries = nullptr;
+    _indices = nullptr;
+    _distances = nullptr;
+
+    _queriesCapacity = std::max(_queriesCapacity, std::size_t(nbQueries));
+    _queriesDimension = std::max(_queriesDimension, std::size_t(_dimension));
+
+    CHECK_MATCHING_CUDA_ERROR(cudaMalloc(&_queries, _queriesCapacity * _queriesDimension * sizeof(Scalar)));
+    CHECK_MATCHING_CUDA_ERROR(cudaMalloc(&_indices, _queriesCapacity * 2 * sizeof(int)));
+    CHECK_MATCHING_CUDA_ERROR(cudaMalloc(&_distances, _queriesCapacity * 2 * sizeof(float)));
+}
+
+template<typename Scalar>
+void DeviceBruteForceMatcher<Scalar>::searchTwoNearestNeighbours(const Scalar* queries, int nbQueries, int* indices, float* distances)
+{
+    if (nbQueries < 1 || _nbRows < 1)
+        return;
+
+    allocateQueries(nbQueries);
+
+    CHECK_MATCHING_CUDA_ERROR(cudaMemcpy(_queries, queries, std::size_t(nbQueries) * _dimension * sizeof(Scalar), cudaMemcpyHostToDevice));
+
+    const std::size_t sharedMemSize = _dimension * sizeof(float) + 2 * BLOCK_SIZE * (sizeof(float) + sizeof(int));
+
+    twoNearestNeighbours_kernel<Scalar>
+      <<<nbQueries, BLOCK_SIZE, sharedMemSize>>>(_dataset, _nbRows, _queries, _dimension, _indices, _distances);
+
+    CHECK_MATCHING_CUDA_ERROR(cudaGetLastError());
+
+    CHECK_MATCHING_CUDA_ERROR(cudaMemcpy(indices, _indices, std::size_t(nbQueries) * 2 * sizeof(int), cudaMemcpyDeviceToHost));
+    CHECK_MATCHING_CUDA_ERROR(cudaMemcpy(distances, _distances, std::size_t(nbQueries) * 2 * sizeof(float), cudaMemcpyDeviceToHost));
+}
+
+template class DeviceBruteForceMatcher<unsigned char>;
+template class DeviceBruteForceMatcher<float>;
+
+}  // namespace cuda
+}  // namespace matching
+}  // namespace aliceVision
@@ -0,0 +1,77 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <cstddef>
+
+namespace aliceVision {
+namespace matching {
+namespace cuda {
+
+/**
+ * @class DeviceBruteForceMatcher
+ * @brief Brute force 2-nearest neighbours search of descriptors on the GPU (squared L2 distance).
+ *
+ * The dataset descriptors are uploaded once and stay resident on the device,
+ * so that several sets of query descriptors can be matched against them.
+ *
+ * @note Explicitly instantiated for unsigned char and float descriptors.
+ */
+template<typename Scalar>
+class DeviceBruteForceMatcher
+{
+  public:
+    DeviceBruteForceMatcher() = default;
+    ~DeviceBruteForceMatcher();
+
+    // no copy
+    DeviceBruteForceMatcher(const DeviceBruteForceMatcher&) = delete;
+    DeviceBruteForceMatcher& operator=(const DeviceBruteForceMatcher&) = delete;
+
+    /**
+     * @brief Upload the dataset descriptors to the device.
+     * @param[in] dataset The host dataset descriptors (row major)
+     * @param[in] nbRows The number of dataset descriptors
+     * @param[in] dimension The descriptor length
+     */
+    void setDataset(const Scalar* dataset, int nbRows, int dimension);
+
+    /**
+     * @brief Search the 2 nearest dataset descriptors of each query descriptor.
+     * @param[in] queries The host query descriptors (row major, same dimension as the dataset)
+     * @param[in] nbQueries The number of query descriptors
+     * @param[out] indices The host output dataset indices (nbQueries * 2), -1 if there is no neighbour
+     * @param[out] distances The host output squared L2 distances (nbQueries * 2)
+     */
+    void searchTwoNearestNeighbours(const Scalar* queries, int nbQueries, int* indices, float* distances);
+
+    inline int getNbRows() const { return _nbRows; }
+    inline int getDimension() const { return _dimension; }
+
+  private:
+    /**
+     * @brief Ensure that the device query and result buffers can hold the given number of queries.
+     * @param[in] nbQueries The number of query descriptors
+     */
+    void allocateQueries(int nbQueries);
+
+    // dataset
+    Scalar* _dataset = nullptr;
+    int _nbRows = 0;
+    int _dimension = 0;
+
+    // query and result buffers, reused between calls
+    Scalar* _queries = nullptr;
+    int* _indices = nullptr;
+    float* _distances = nullptr;
+    std::size_t _queriesCapacity = 0;  //< in number of query descriptors
+    std::size_t _queriesDimension = 0;
+};
+
+}  // namespace cuda
+}  // namespace matching
+}  // namespace aliceVision
@@ -9,13 +9,23 @@
 
 #include <aliceVision/numeric/numeric.hpp>
 #include <aliceVision/matching/IndMatch.hpp>
+#include <aliceVision/matching/KeypointsGrid.hpp>
 #include <aliceVision/feature/RegionsPerView.hpp>
 #include <aliceVision/feature/Regions.hpp>
 #include <aliceVision/camera/IntrinsicBase.hpp>
 
+#include <cmath>
 #include <vector>
 
 namespace aliceVision {
+
+namespace multiview {
+namespace relativePose {
+struct FundamentalEpipolarDistanceError;
+struct HomographyAsymmetricError;
+}  // namespace relativePose
+}  // namespace multiview
+
 namespace matching {
 
 /**
@@ -188,78 +198,120 @@ void guidedMatching(const ModelT& mod,
     matching::IndMatch::getDeduplicated(vec_corresponding_index);
 }
 
+/**
+ * @brief Search region of the guided matching candidates for an error metric.
+ *        By default all the keypoints are candidates, the error metrics bounded by
+ *        a distance in the second image are specialized to only query the close keypoints.
+ *
+ * @tparam ErrorT The metric to compute distance to the model
+ */
+template<typename ErrorT>
+struct GuidedMatchingSearch
+{
+    template<typename ModelT>
+    static void getCandidates(const ModelT& mod, const Vec2& xL, double errorTh, const KeypointsGrid& rGrid, std::vector<IndexT>& out_candidates)
+    {
+        rGrid.getAllCandidates(out_candidates);
+    }
+};
+
+/**
+ * @brief The epipolar distance is the distance to the epipolar line in the second image:
+ *        query the band of the epipolar line.
+ */
+template<>
+struct GuidedMatchingSearch<multiview::relativePose::FundamentalEpipolarDistanceError>
+{
+    template<typename ModelT>
+    static void getCandidates(const ModelT& mod, const Vec2& xL, double errorTh, const KeypointsGrid& rGrid, std::vector<IndexT>& out_candidates)
+    {
+        const Vec3 line = mod.getMatrix() * Vec3(xL(0), xL(1), 1.0);
+        rGrid.getCandidatesInBand(line, std::sqrt(errorTh), out_candidates);
+    }
+};
+
+/**
+ * @brief The homography asymmetric error is the transfer distance in the second image:
+ *        query the neighborhood of the transferred point.
+ */
+template<>
+struct GuidedMatchingSearch<multiview::relativePose::HomographyAsymmetricError>
+{
+    template<typename ModelT>
+    static void getCandidates(const ModelT& mod, const Vec2& xL, double errorTh, const KeypointsGrid& rGrid, std::vector<IndexT>& out_candidates)
+    {
+        const Vec3 xR = mod.getMatrix() * Vec3(xL(0), xL(1), 1.0);
+        rGrid.getCandidatesInDisc(xR.head<2>() / xR(2), std::sqrt(errorTh), out_candidates);
+    }
+};
+
 /**
  * @brief Guided Matching (features + descriptors with distance ratio):
  *        Use a model to find valid correspondences:
  *        Keep the best corresponding points for the given model under the
  *        user specified distance ratio.
+ *        Only the right keypoints of the search region of the error metric are tested
+ *        (see GuidedMatchingSearch) and their descriptors are compared at once.
  *
  * @tparam ModelT The used model type
  * @tparam ErrorT The metric to compute distance to the model
  *
  * @param[in] mod The model
- * @param[in] camL Optional camera (in order to undistord on the fly feature positions, can be NULL)
- * @param[in] lRegions regions (point features & corresponding descriptors)
- * @param[in] camR Optional camera (in order to undistord on the fly feature positions, can be NULL)
- * @param[in] rRegions regions (point features & corresponding descriptors)
+ * @param[in] lPositions left regions (undistorted) positions
+ * @param[in] lRegions left regions (point features & corresponding descriptors)
+ * @param[in] rGrid grid index of the right regions (undistorted) positions
+ * @param[in] rRegions right regions (point features & corresponding descriptors)
  * @param[in] errorTh Maximal authorized error threshold
  * @param[in] distRatio Maximal authorized distance ratio
  * @param[out] out_matches Ouput corresponding index
  */
 template<typename ModelT, typename ErrorT>
 void guidedMatching(const ModelT& mod,
-                    const camera::IntrinsicBase* camL,
+                    const std::vector<Vec2>& lPositions,
                     const feature::Regions& lRegions,
-                    const camera::IntrinsicBase* camR,
+                    const KeypointsGrid& rGrid,
                     const feature::Regions& rRegions,
                     double errorTh,
                     double distRatio,
                     matching::IndMatches& out_matches)
 {
+    assert(lPositions.size() == lRegions.RegionCount());
+    assert(rGrid.size() == rRegions.RegionCount());
+
     // looking for the corresponding points that have to satisfy:
     //   1. a geometric distance below the provided Threshold
     //   2. a distance ratio between descriptors of valid geometric correspondencess
 
     const ErrorT errorEstimator = ErrorT();
+    const std::vector<Vec2>& rPositions = rGrid.getPositions();
 
-    // build region positions arrays (in order to un-distord on-demand point position once)
-    std::vector<Vec2> lRegionsPos(lRegions.RegionCount());
-    std::vector<Vec2> rRegionsPos(rRegions.RegionCount());
+    std::vector<IndexT> candidates;
+    std::vector<double> descDistances;
 
-    if (camL && camL->isValid())
+    for (std::size_t i = 0; i < lPositions.size(); ++i)
     {
-        for (std::size_t i = 0; i < lRegions.RegionCount(); ++i)
-            lRegionsPos[i] = camL->getUndistortedPixel(lRegions.GetRegionPosition(i));
-    }
-    else
-    {
-        for (std::size_t i = 0; i < lRegions.RegionCount(); ++i)
-            lRegionsPos[i] = lRegions.GetRegionPosition(i);
-    }
-    if (camR && camR->isValid())
-    {
-        for (std::size_t i = 0; i < rRegions.RegionCount(); ++i)
-            rRegionsPos[i] = camR->getUndistortedPixel(rRegions.GetRegionPosition(i));
-    }
-    else
-    {
-        for (std::size_t i = 0; i < rRegions.RegionCount(); ++i)
-            rRegionsPos[i] = rRegions.GetRegionPosition(i);
-    }
+        GuidedMatchingSearch<ErrorT>::getCandidates(mod, lPositions[i], errorTh, rGrid, candidates);
 
-    for (std::size_t i = 0; i < lRegions.RegionCount(); ++i)
-    {
-        distanceRatio<double> dR;
-        for (std::size_t j = 0; j < rRegions.RegionCount(); ++j)
+        // keep the candidates with a geometric error below the threshold
+        std::size_t nbValidCandidates = 0;
+        for (const IndexT j : candidates)
         {
-            // compute the geometric error: error to the model
-            const double geomErr = errorEstimator.error(mod, lRegionsPos[i], rRegionsPos[j]);
+            if (errorEstimator.error(mod, lPositions[i], rPositions[j]) < errorTh)
+                candidates[nbValidCandidates++] = j;
+        }
 
-            if (geomErr < errorTh)
-            {
-                // update the corresponding points & distance (if required)
-                dR.update(j, lRegions.SquaredDescriptorDistance(i, &rRegions, j));
-            }
+        // the distance ratio needs two candidates
+        if (nbValidCandidates < 2)
+            continue;
+
+        descDistances.resize(nbValidCandidates);
+        lRegions.SquaredDescriptorDistances(i, &rRegions, candidates.data(), nbValidCandidates, descDistances.data());
+
+        distanceRatio<double> dR;
+        for (std::size_t k = 0; k < nbValidCandidates; ++k)
+        {
+            // update the corresponding points & distance (if required)
+            dR.update(candidates[k], descDistances[k]);
         }
         // add correspondence only iff the distance ratio is valid
         if (dR.isValid(distRatio))
@@ -273,6 +325,54 @@ void guidedMatching(const ModelT& mod,
     matching::IndMatch::getDeduplicated(out_matches);
 }
 
+/**
+ * @brief Guided Matching (features + descriptors with distance ratio):
+ *        Use a model to find valid correspondences:
+ *        Keep the best corresponding points for the given model under the
+ *        user specified distance ratio.
+ *
+ * @tparam ModelT The used model type
+ * @tparam ErrorT The metric to compute distance to the model
+ *
+ * @param[in] mod The model
+ * @param[in] camL Optional camera (in order to undistord on the fly feature positions, can be NULL)
+ * @param[in] lRegions regions (point features & corresponding descriptors)
+ * @param[in] camR Optional camera (in order to undistord on the fly feature positions, can be NULL)
+ * @param[in] rRegions regions (point features & corresponding descriptors)
+ * @param[in] errorTh Maximal authorized error threshold
+ * @param[in] distRatio Maximal authorized distance ratio
+ * @param[out] out_matches Ouput corresponding index
+ */
+template<typename ModelT, typename ErrorT>
+void guidedMatching(const ModelT& mod,
+                    const camera::IntrinsicBase* camL,
+                    const feature::Regions& lRegions,
+                    const camera::IntrinsicBase* camR,
+                    const feature::Regions& rRegions,
+                    double errorTh,
+                    double distRatio,
+                    matching::IndMatches& out_matches)
+{
+    // build region positions arrays (in order to un-distord on-demand point position once)
+    std::vector<Vec2> lRegionsPos(lRegions.RegionCount());
+
+    if (camL && camL->isValid())
+    {
+        for (std::size_t i = 0; i < lRegions.RegionCount(); ++i)
+            lRegionsPos[i] = camL->getUndistortedPixel(lRegions.GetRegionPosition(i));
+    }
+    else
+    {
+        for (std::size_t i = 0; i < lRegions.RegionCount(); ++i)
+            lRegionsPos[i] = lRegions.GetRegionPosition(i);
+    }
+
+    // the right positions are indexed in a grid
+    const KeypointsGrid rGrid(camR, rRegions);
+
+    guidedMatching<ModelT, ErrorT>(mod, lRegionsPos, lRegions, rGrid, rRegions, errorTh, distRatio, out_matches);
+}
+
 /**
  * @brief Guided Matching (features + descriptors with distance ratio):
  *        Use a model to find valid correspondences:
@@ -312,6 +412,51 @@ void guidedMatching(const ModelT& mod,
     }
 }
 
+/**
+ * @brief Guided Matching (features + descriptors with distance ratio):
+ *        Same as above, with the keypoints grids of the views taken from a cache
+ *        so that they are built once and reused by all the image pairs.
+ *
+ * @tparam ModelT The used model type
+ * @tparam ErrorT The metric to compute distance to the model
+ *
+ * @param[in] mod The model
+ * @param[in] viewIds The left and right view ids
+ * @param[in] camL Optional camera (in order to undistord on the fly feature positions, can be NULL)
+ * @param[in] lRegions regions (point features & corresponding descriptors)
+ * @param[in] camR Optional camera (in order to undistord on the fly feature positions, can be NULL)
+ * @param[in] rRegions regions (point features & corresponding descriptors)
+ * @param[in] errorTh Maximal authorized error threshold
+ * @param[in] distRatio Maximal authorized distance ratio
+ * @param[in,out] gridCache The keypoints grids cache
+ * @param[out] out_matchesPerDesc Ouput corresponding index
+ */
+template<typename ModelT, typename ErrorT>
+void guidedMatching(const ModelT& mod,
+                    const Pair& viewIds,
+                    const camera::IntrinsicBase* camL,
+                    const feature::MapRegionsPerDesc& lRegions,
+                    const camera::IntrinsicBase* camR,
+                    const feature::MapRegionsPerDesc& rRegions,
+                    double errorTh,
+                    double distRatio,
+                    KeypointsGridCache& gridCache,
+                    matching::MatchesPerDescType& out_matchesPerDesc)
+{
+    const std::vector<feature::EImageDescriberType> descTypes = getCommonDescTypes(lRegions, rRegions);
+
+    for (const feature::EImageDescriberType descType : descTypes)
+    {
+        const feature::Regions& lDescRegions = *lRegions.at(descType);
+        const feature::Regions& rDescRegions = *rRegions.at(descType);
+
+        const KeypointsGrid& lGrid = gridCache.getGrid(viewIds.first, descType, camL, lDescRegions);
+        const KeypointsGrid& rGrid = gridCache.getGrid(viewIds.second, descType, camR, rDescRegions);
+
+        guidedMatching<ModelT, ErrorT>(mod, lGrid.getPositions(), lDescRegions, rGrid, rDescRegions, errorTh, distRatio, out_matchesPerDesc[descType]);
+    }
+}
+
 /**
  * @brief Compute a bucket index from an epipolar point
  *        (the one that is closer to image border intersection)
@@ -406,6 +551,7 @@ void guidedMatchingFundamentalFast(const Mat3& FMat,
 
     // For each point in right image, find if there is good candidates.
     std::vector<distanceRatio<double>> dR(lRegions.RegionCount());
+    std::vector<double> descDistances;
     for (std::size_t j = 0; j < rRegions.RegionCount(); ++j)
     {
         // According the point:
@@ -438,12 +584,15 @@ void guidedMatchingFundamentalFast(const Mat3& FMat,
             for (BucketsVec::const_iterator itBs = buckets.begin() + bucketStart; itBs != buckets.begin() + bucketStop; ++itBs)
             {
                 const BucketVec& bucket = *itBs;
-                for (unsigned int i : bucket)
+                if (bucket.empty())
+                    continue;
+                // Compute descriptor distances of the bucket at once
+                descDistances.resize(bucket.size());
+                rRegions.SquaredDescriptorDistances(j, &lRegions, bucket.data(), bucket.size(), descDistances.data());
+                for (std::size_t k = 0; k < bucket.size(); ++k)
                 {
-                    // Compute descriptor distance
-                    const double descDist = lRegions.SquaredDescriptorDistance(i, &rRegions, j);
                     // Update the corresponding points & distance (if required)
-                    dR[i].update(j, descDist);
+                    dR[bucket[k]].update(j, descDistances[k]);
                 }
             }
         }
@@ -107,6 +107,102 @@ BOOST_AUTO_TEST_CASE(IndMatch_IO)
     fs::remove_all(testFolder);
 }
 
+BOOST_AUTO_TEST_CASE(IndMatch_IO_binary)
+{
+    const std::string testFolder = "matchingBinaryTest";
+    fs::remove_all(testFolder);
+    fs::create_directory(testFolder);
+    {
+        PairwiseMatches matches;
+        matches[std::make_pair(0, 1)][EImageDescriberType::UNKNOWN] = {{0, 0}, {1, 1}};
+        matches[std::make_pair(0, 1)][EImageDescriberType::SIFT] = {{5, 6}};
+        matches[std::make_pair(1, 2)][EImageDescriberType::UNKNOWN] = {{0, 0}, {1, 1}, {2, 2}};
+        matches[std::make_pair(2, 3)][EImageDescriberType::UNKNOWN] = {{7, 8}, {9, 10}};
+
+        BOOST_CHECK(Save(matches, testFolder, "bin", false));
+
+        // load everything
+        PairwiseMatches loadedMatches;
+        BOOST_CHECK(Load(loadedMatches, {}, {testFolder}, {}));
+        BOOST_CHECK(loadedMatches == matches);
+
+        // only the pairs between the requested views are read
+        loadedMatches.clear();
+        BOOST_CHECK(Load(loadedMatches, {0, 1, 2}, {testFolder}, {EImageDescriberType::UNKNOWN}));
+        BOOST_CHECK_EQUAL(2, loadedMatches.size());
+        BOOST_CHECK_EQUAL(0, loadedMatches.count(std::make_pair(2, 3)));
+        BOOST_CHECK_EQUAL(1, loadedMatches.at(std::make_pair(0, 1)).size());
+        BOOST_CHECK(loadedMatches.at(std::make_pair(1, 2)).at(EImageDescriberType::UNKNOWN) ==
+                    matches.at(std::make_pair(1, 2)).at(EImageDescriberType::UNKNOWN));
+    }
+    fs::remove_all(testFolder);
+    fs::create_directory(testFolder);
+    {
+        PairwiseMatches matches;
+        matches[std::make_pair(0, 1)][EImageDescriberType::UNKNOWN] = {{0, 0}, {1, 1}};
+        matches[std::make_pair(1, 2)][EImageDescriberType::UNKNOWN] = {{0, 0}, {1, 1}, {2, 2}};
+
+        BOOST_CHECK(Save(matches, testFolder, "bin", true));
+
+        PairwiseMatches loadedMatches;
+        BOOST_CHECK(Load(loadedMatches, {}, {testFolder}, {}));
+        BOOST_CHECK(loadedMatches == matches);
+    }
+    fs::remove_all(testFolder);
+}
+
+BOOST_AUTO_TEST_CASE(IndMatch_IO_stream)
+{
+    const std::string testFolder = "matchingStreamTest";
+    fs::remove_all(testFolder);
+    fs::create_directory(testFolder);
+    const std::string filepath = (fs::path(testFolder) / "matches.bin").string();
+    {
+        PairwiseMatches matches;
+        matches[std::make_pair(0, 1)][EImageDescriberType::UNKNOWN] = {{0, 0}, {1, 1}};
+        matches[std::make_pair(0, 1)][EImageDescriberType::SIFT] = {{5, 6}};
+        matches[std::make_pair(1, 2)][EImageDescriberType::UNKNOWN] = {{0, 0}, {1, 1}, {2, 2}};
+
+        // small buffer to make write() wait for the writer thread
+        {
+            MatchesStreamWriter writer(filepath, false, 2);
+            for (const auto& pairMatches : matches)
+                writer.write(pairMatches.first, pairMatches.second);
+            writer.close();
+            BOOST_CHECK_EQUAL(2, writer.getNbPairs());
+        }
+
+        PairwiseMatches loadedMatches;
+        BOOST_CHECK(LoadMatchFile(loadedMatches, filepath));
+        BOOST_CHECK(loadedMatches == matches);
+
+        // partial load of the streamed file
+        loadedMatches.clear();
+        BOOST_CHECK(LoadMatchFile(loadedMatches, filepath, {0, 1}, {EImageDescriberType::SIFT}));
+        BOOST_CHECK_EQUAL(1, loadedMatches.size());
+        BOOST_CHECK(loadedMatches.at(std::make_pair(0, 1)).at(EImageDescriberType::SIFT) ==
+                    matches.at(std::make_pair(0, 1)).at(EImageDescriberType::SIFT));
+
+        // append another chunk, which overrides the matches of the pair (1, 2)
+        PairwiseMatches chunkMatches;
+        chunkMatches[std::make_pair(1, 2)][EImageDescriberType::UNKNOWN] = {{3, 4}};
+        chunkMatches[std::make_pair(2, 3)][EImageDescriberType::UNKNOWN] = {{7, 8}, {9, 10}};
+        {
+            MatchesStreamWriter writer(filepath, true);
+            for (const auto& pairMatches : chunkMatches)
+                writer.write(pairMatches.first, pairMatches.second);
+        }
+
+        matches[std::make_pair(1, 2)] = chunkMatches.at(std::make_pair(1, 2));
+        matches[std::make_pair(2, 3)] = chunkMatches.at(std::make_pair(2, 3));
+
+        loadedMatches.clear();
+        BOOST_CHECK(Load(loadedMatches, {}, {testFolder}, {}));
+        BOOST_CHECK(loadedMatches == matches);
+    }
+    fs::remove_all(testFolder);
+}
+
 BOOST_AUTO_TEST_CASE(IndMatch_DuplicateRemoval_NoRemoval)
 {
     std::vector<IndMatch> vec_indMatch;
@@ -11,13 +11,22 @@
 #include <aliceVision/system/Logger.hpp>
 #include <aliceVision/utils/filesIO.hpp>
 
+#include <boost/interprocess/sync/file_lock.hpp>
+#include <boost/interprocess/sync/scoped_lock.hpp>
 #include <boost/range/iterator_range.hpp>
 
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
 #include <map>
 #include <filesystem>
 #include <fstream>
 #include <iterator>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace fs = std::filesystem;
@@ -25,7 +34,144 @@ namespace fs = std::filesystem;
 namespace aliceVision {
 namespace matching {
 
-bool LoadMatchFile(PairwiseMatches& matches, const std::string& filepath)
+namespace {
+
+/// Binary match file signature and version
+const char binaryMatchFileMagic[8] = {'A', 'V', 'M', 'A', 'T', 'C', 'H', '\0'};
+const std::uint32_t binaryMatchFileVersion = 1;
+/// Version of the streamed binary match files: the pair index table is at the end of the file
+const std::uint32_t streamedBinaryMatchFileVersion = 2;
+
+/**
+ * @brief Entry of the pair index table of a binary match file.
+ */
+struct BinaryMatchFileEntry
+{
+    std::uint64_t I = 0;
+    std::uint64_t J = 0;
+    std::int32_t descType = 0;
+    std::uint64_t nbMatches = 0;
+    std::uint64_t offset = 0;  //< position of the first match in the file
+};
+
+template<typename T>
+void writeBinary(std::ostream& stream, const T& value)
+{
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<typename T>
+bool readBinary(std::istream& stream, T& value)
+{
+    return bool(stream.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+/// Size in bytes of an entry of the pair index table
+const std::size_t binaryMatchFileEntrySize = 2 * sizeof(std::uint64_t) + sizeof(std::int32_t) + 2 * sizeof(std::uint64_t);
+
+/// Size in bytes of the header of a streamed binary match file: magic, version, number of entries, index offset
+const std::size_t streamedBinaryMatchFileHeaderSize = sizeof(binaryMatchFileMagic) + sizeof(std::uint32_t) + 2 * sizeof(std::uint64_t);
+
+void writeBinaryMatchFileEntry(std::ostream& stream, const BinaryMatchFileEntry& entry)
+{
+    writeBinary(stream, entry.I);
+    writeBinary(stream, entry.J);
+    writeBinary(stream, entry.descType);
+    writeBinary(stream, entry.nbMatches);
+    writeBinary(stream, entry.offset);
+}
+
+bool readBinaryMatchFileEntry(std::istream& stream, BinaryMatchFileEntry& entry)
+{
+    return readBinary(stream, entry.I) && readBinary(stream, entry.J) && readBinary(stream, entry.descType) && readBinary(stream, entry.nbMatches) &&
+           readBinary(stream, entry.offset);
+}
+
+bool loadBinaryMatchFile(PairwiseMatches& matches,
+                         const std::string& filepath,
+                         const std::set<IndexT>& viewsKeysFilter,
+                         const std::vector<feature::EImageDescriberType>& descTypesFilter)
+{
+    std::ifstream stream(filepath, std::ios::in | std::ios::binary);
+    if (!stream.is_open())
+        return false;
+
+    // header: magic, version, number of entries
+    char magic[sizeof(binaryMatchFileMagic)];
+    std::uint32_t version = 0;
+    std::uint64_t nbEntries = 0;
+    if (!stream.read(magic, sizeof(magic)) || !std::equal(magic, magic + sizeof(magic), binaryMatchFileMagic))
+    {
+        ALICEVISION_LOG_WARNING("Invalid binary match file: " << filepath);
+        return false;
+    }
+    if (!readBinary(stream, version) || (version != binaryMatchFileVersion && version != streamedBinaryMatchFileVersion))
+    {
+        ALICEVISION_LOG_WARNING("Unsupported binary match file version " << version << ": " << filepath);
+        return false;
+    }
+    if (!readBinary(stream, nbEntries))
+        return false;
+
+    // the pair index table of the streamed files is at the end
+    if (version == streamedBinaryMatchFileVersion)
+    {
+        std::uint64_t indexOffset = 0;
+        if (!readBinary(stream, indexOffset) || !stream.seekg(indexOffset))
+        {
+            ALICEVISION_LOG_WARNING("Truncated binary match file header: " << filepath);
+            return false;
+        }
+    }
+
+    // pair index table
+    // if a pair is written several times in a streamed file, the last entry is kept
+    std::vector<BinaryMatchFileEntry> entries(nbEntries);
+    for (BinaryMatchFileEntry& entry : entries)
+    {
+        if (!readBinaryMatchFileEntry(stream, entry))
+        {
+            ALICEVISION_LOG_WARNING("Truncated binary match file index: " << filepath);
+            return false;
+        }
+    }
+
+    // only read the match arrays of the requested pairs and descriptor types
+    std::vector<IndexT> buffer;
+    for (const BinaryMatchFileEntry& entry : entries)
+    {
+        const feature::EImageDescriberType descType = static_cast<feature::EImageDescriberType>(entry.descType);
+
+        if (!viewsKeysFilter.empty() && (viewsKeysFilter.count(entry.I) == 0 || viewsKeysFilter.count(entry.J) == 0))
+            continue;
+        if (!descTypesFilter.empty() && std::find(descTypesFilter.begin(), descTypesFilter.end(), descType) == descTypesFilter.end())
+            continue;
+
+        buffer.resize(2 * entry.nbMatches);
+        stream.seekg(entry.offset);
+        if (!stream.read(reinterpret_cast<char*>(buffer.data()), buffer.size() * sizeof(IndexT)))
+        {
+            ALICEVISION_LOG_WARNING("Truncated binary match file: " << filepath);
+            return false;
+        }
+
+        IndMatches& pairMatches = matches[std::make_pair(entry.I, entry.J)][descType];
+        pairMatches.resize(entry.nbMatches);
+        for (std::size_t i = 0; i < entry.nbMatches; ++i)
+        {
+            pairMatches[i]._i = buffer[2 * i];
+            pairMatches[i]._j = buffer[2 * i + 1];
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+bool LoadMatchFile(PairwiseMatches& matches,
+                   const std::string& filepath,
+                   const std::set<IndexT>& viewsKeysFilter,
+                   const std::vector<feature::EImageDescriberType>& descTypesFilter)
 {
     const std::string ext = fs::path(filepath).extension().string();
 
@@ -72,6 +218,10 @@ bool LoadMatchFile(PairwiseMatches& matches, const std::string& filepath)
         stream.close();
         return true;
     }
+    else if (ext == ".bin")
+    {
+        return loadBinaryMatchFile(matches, filepath, viewsKeysFilter, descTypesFilter);
+    }
     else
     {
         ALICEVISION_LOG_WARNING("Unknown matching file format: " << ext);
@@ -92,6 +242,19 @@ void filterMatchesByViews(PairwiseMatches& matches, const std::set<IndexT>& view
     matches.swap(filteredMatches);
 }
 
+void filterMatchesTouchingViews(PairwiseMatches& matches, const std::set<IndexT>& viewsKeys)
+{
+    matching::PairwiseMatches filteredMatches;
+    for (matching::PairwiseMatches::const_iterator iter = matches.begin(); iter != matches.end(); ++iter)
+    {
+        if (viewsKeys.find(iter->first.first) != viewsKeys.end() || viewsKeys.find(iter->first.second) != viewsKeys.end())
+        {
+            filteredMatches.insert(*iter);
+        }
+    }
+    matches.swap(filteredMatches);
+}
+
 void filterTopMatches(PairwiseMatches& allMatches, int maxNum, int minNum)
 {
     if (maxNum <= 0 && minNum <= 0)
@@ -168,18 +331,29 @@ std::size_t LoadMatchFilePerImage(PairwiseMatches& matches,
  * Load and add pair-wise matches to \p matches from all files in \p folder matching \p pattern.
  * @param[out] matches PairwiseMatches to add loaded matches to
  * @param[in] folder Folder to load matches files from
- * @param[in] pattern Pattern that files must respect to be loaded
+ * @param[in] patterns Patterns that files must respect to be loaded (one of them)
+ * @param[in] viewsKeysFilter Restrict the matches to these views (only applied while reading binary files)
+ * @param[in] descTypesFilter Restrict the matches to these types of descriptors (only applied while reading binary files)
  */
-std::size_t loadMatchesFromFolder(PairwiseMatches& matches, const std::string& folder, const std::string& pattern)
+std::size_t loadMatchesFromFolder(PairwiseMatches& matches,
+                                  const std::string& folder,
+                                  const std::vector<std::string>& patterns,
+                                  const std::set<IndexT>& viewsKeysFilter,
+                                  const std::vector<feature::EImageDescriberType>& descTypesFilter)
 {
     std::size_t nbLoadedMatchFiles = 0;
     std::vector<std::string> matchFiles;
-    // list all matches files in 'folder' matching (i.e containing) 'pattern'
+    // list all matches files in 'folder' matching (i.e containing) one of the 'patterns'
     for (const auto& entry : boost::make_iterator_range(fs::directory_iterator(folder), {}))
     {
-        if (entry.path().string().find(pattern) != std::string::npos)
+        const std::string path = entry.path().string();
+        for (const std::string& pattern : patterns)
         {
-            matchFiles.push_back(entry.path().string());
+            if (path.find(pattern) != std::string::npos)
+            {
+                matchFiles.push_back(path);
+                break;
+            }
         }
     }
 
@@ -189,7 +363,7 @@ std::size_t loadMatchesFromFolder(PairwiseMatches& matches, const std::string& f
         const std::string& matchFile = matchFiles[i];
         PairwiseMatches fileMatches;
         ALICEVISION_LOG_DEBUG("Loading match file: " << matchFile);
-        if (!LoadMatchFile(fileMatches, matchFile))
+        if (!LoadMatchFile(fileMatches, matchFile, viewsKeysFilter, descTypesFilter))
         {
             ALICEVISION_LOG_WARNING("Unable to load match file: " << matchFile);
             continue;
@@ -226,7 +400,7 @@ bool Load(PairwiseMatches& matches,
           int minNbMatches)
 {
     std::size_t nbLoadedMatchFiles = 0;
-    const std::string pattern = "matches.txt";
+    const std::vector<std::string> patterns = {"matches.txt", "matches.bin"};
 
     // build up a set with normalized paths to remove duplicates
     std::set<std::string> foldersSet;
@@ -241,7 +415,7 @@ bool Load(PairwiseMatches& matches,
 
     for (const auto& folder : foldersSet)
     {
-        nbLoadedMatchFiles += loadMatchesFromFolder(matches, folder, pattern);
+        nbLoadedMatchFiles += loadMatchesFromFolder(matches, folder, patterns, viewsKeysFilter, descTypesFilter);
     }
 
     if (!nbLoadedMatchFiles)
@@ -305,6 +479,84 @@ class MatchExporter
         fs::rename(tmpPath, filepath);
     }
 
+    void saveBinary(const std::string& filepath,
+                    const PairwiseMatches::const_iterator& matchBegin,
+                    const PairwiseMatches::const_iterator& matchEnd)
+    {
+        const fs::path bPath = fs::path(filepath);
+        const std::string tmpPath =
+          (bPath.parent_path() / bPath.stem()).string() + "." + utils::generateUniqueFilename() + bPath.extension().string();
+
+        // build the pair index table, match arrays are stored contiguously after it
+        std::vector<BinaryMatchFileEntry> entries;
+        for (PairwiseMatches::const_iterator match = matchBegin; match != matchEnd; ++match)
+        {
+            for (const auto& m : match->second)
+            {
+                BinaryMatchFileEntry entry;
+                entry.I = match->first.first;
+                entry.J = match->first.second;
+                entry.descType = static_cast<std::int32_t>(m.first);
+                entry.nbMatches = m.second.size();
+                entries.push_back(entry);
+            }
+        }
+
+        std::uint64_t offset = sizeof(binaryMatchFileMagic) + sizeof(binaryMatchFileVersion) + sizeof(std::uint64_t) +
+                               entries.size() * binaryMatchFileEntrySize;
+        for (BinaryMatchFileEntry& entry : entries)
+        {
+            entry.offset = offset;
+            offset += entry.nbMatches * 2 * sizeof(IndexT);
+        }
+
+        // write temporary file
+        {
+            std::ofstream stream(tmpPath, std::ios::out | std::ios::binary);
+
+            // header
+            stream.write(binaryMatchFileMagic, sizeof(binaryMatchFileMagic));
+            writeBinary(stream, binaryMatchFileVersion);
+            writeBinary(stream, std::uint64_t(entries.size()));
+
+            // pair index table
+            for (const BinaryMatchFileEntry& entry : entries)
+                writeBinaryMatchFileEntry(stream, entry);
+
+            // match arrays, in the same order as the index table
+            std::vector<IndexT> buffer;
+            for (PairwiseMatches::const_iterator match = matchBegin; match != matchEnd; ++match)
+            {
+                for (const auto& m : match->second)
+                {
+                    buffer.resize(2 * m.second.size());
+                    for (std::size_t i = 0; i < m.second.size(); ++i)
+                    {
+                        buffer[2 * i] = m.second[i]._i;
+                        buffer[2 * i + 1] = m.second[i]._j;
+                    }
+                    stream.write(reinterpret_cast<const char*>(buffer.data()), buffer.size() * sizeof(IndexT));
+                }
+            }
+
+            if (!stream.good())
+                throw std::runtime_error("Unable to write binary match file: " + tmpPath);
+        }
+
+        // rename temporary file
+        fs::rename(tmpPath, filepath);
+    }
+
+    void save(const std::string& filepath, const PairwiseMatches::const_iterator& matchBegin, const PairwiseMatches::const_iterator& matchEnd)
+    {
+        if (m_ext == ".txt")
+            saveTxt(filepath, matchBegin, matchEnd);
+        else if (m_ext == ".bin")
+            saveBinary(filepath, matchBegin, matchEnd);
+        else
+            throw std::runtime_error(std::string("Unknown matching file format: ") + m_ext);
+    }
+
   public:
     MatchExporter(const PairwiseMatches& matches, const std::string& folder, const std::string& filename)
       : m_matches(matches),
@@ -319,10 +571,7 @@ class MatchExporter
     {
         const std::string filepath = (fs::path(m_directory) / m_filename).string();
 
-        if (m_ext == ".txt")
-            saveTxt(filepath, m_matches.begin(), m_matches.end());
-        else
-            throw std::runtime_error(std::string("Unknown matching file format: ") + m_ext);
+        save(filepath, m_matches.begin(), m_matches.end());
     }
 
     /// Export matches into separate files, one for each image.
@@ -342,10 +591,7 @@ class MatchExporter
             const std::string filepath = (fs::path(m_directory) / (std::to_string(key) + "." + m_filename)).string();
             ALICEVISION_LOG_DEBUG("Export Matches in: " << filepath);
 
-            if (m_ext == ".txt")
-                saveTxt(filepath, matchBegin, match);
-            else
-                throw std::runtime_error(std::string("Unknown matching file format: ") + m_ext);
+            save(filepath, matchBegin, match);
 
             matchBegin = match;
         }
@@ -358,6 +604,305 @@ class MatchExporter
     std::string m_filename;
 };
 
+class MatchesStreamWriterImpl
+{
+  public:
+    MatchesStreamWriterImpl(const std::string& filepath, bool append, std::size_t maxBufferedMatches)
+      : _filepath(filepath),
+        _append(append),
+        _maxBufferedMatches(std::max(maxBufferedMatches, std::size_t(1)))
+    {
+        const fs::path bPath = fs::path(filepath);
+        _tmpPath = (bPath.parent_path() / bPath.stem()).string() + "." + utils::generateUniqueFilename() + bPath.extension().string();
+
+        _stream.open(_tmpPath, std::ios::out | std::ios::binary);
+        if (!_stream.is_open())
+            throw std::runtime_error("Unable to create binary match file: " + _tmpPath);
+
+        // header, the number of entries and the index offset are updated by close()
+        _stream.write(binaryMatchFileMagic, sizeof(binaryMatchFileMagic));
+        writeBinary(_stream, streamedBinaryMatchFileVersion);
+        writeBinary(_stream, std::uint64_t(0));
+        writeBinary(_stream, std::uint64_t(0));
+        _offset = streamedBinaryMatchFileHeaderSize;
+
+        _thread = std::thread(&MatchesStreamWriterImpl::run, this);
+    }
+
+    ~MatchesStreamWriterImpl()
+    {
+        if (_thread.joinable())
+        {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _closed = true;
+            }
+            _queueCondition.notify_all();
+            _thread.join();
+        }
+        if (!_finished)
+        {
+            _stream.close();
+            std::error_code ec;
+            fs::remove(_tmpPath, ec);
+        }
+    }
+
+    void write(const Pair& pair, MatchesPerDescType matches)
+    {
+        const std::size_t nbMatches = matches.getNbAllMatches();
+
+        std::unique_lock<std::mutex> lock(_mutex);
+        // a pair with more matches than the buffer size is queued alone
+        _spaceCondition.wait(lock, [&] { return _error || _bufferedMatches == 0 || _bufferedMatches + nbMatches <= _maxBufferedMatches; });
+        if (_error)
+            std::rethrow_exception(_error);
+        if (_closed)
+            throw std::logic_error("The binary match file is already closed: " + _filepath);
+
+        _bufferedMatches += nbMatches;
+        _queue.emplace_back(pair, std::move(matches));
+        ++_nbPairs;
+        _queueCondition.notify_one();
+    }
+
+    void close()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_closed)
+                return;
+            _closed = true;
+        }
+        _queueCondition.notify_all();
+        _thread.join();
+
+        if (_error)
+            std::rethrow_exception(_error);
+
+        // pair index table at the end of the file, then the header
+        const std::uint64_t indexOffset = _offset;
+        for (const BinaryMatchFileEntry& entry : _entries)
+            writeBinaryMatchFileEntry(_stream, entry);
+        _stream.seekp(sizeof(binaryMatchFileMagic) + sizeof(streamedBinaryMatchFileVersion));
+        writeBinary(_stream, std::uint64_t(_entries.size()));
+        writeBinary(_stream, indexOffset);
+
+        if (!_stream.good())
+            throw std::runtime_error("Unable to write binary match file: " + _tmpPath);
+        _stream.close();
+
+        if (_append)
+            appendToFile();
+        else
+            fs::rename(_tmpPath, _filepath);
+
+        _finished = true;
+    }
+
+    std::size_t getNbPairs() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _nbPairs;
+    }
+
+  private:
+    /**
+     * @brief Writer thread: write the queued pairs until close() is called and the queue is empty.
+     */
+    void run()
+    {
+        std::vector<IndexT> buffer;
+        while (true)
+        {
+            std::pair<Pair, MatchesPerDescType> pairMatches;
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _queueCondition.wait(lock, [&] { return !_queue.empty() || _closed; });
+                if (_queue.empty())
+                    return;
+                pairMatches = std::move(_queue.front());
+                _queue.pop_front();
+            }
+
+            const std::size_t nbMatches = pairMatches.second.getNbAllMatches();
+            try
+            {
+                writePair(pairMatches.first, pairMatches.second, buffer);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _error = std::current_exception();
+                _queue.clear();
+                _bufferedMatches = 0;
+                _spaceCondition.notify_all();
+                return;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _bufferedMatches -= nbMatches;
+            }
+            _spaceCondition.notify_all();
+        }
+    }
+
+    void writePair(const Pair& pair, const MatchesPerDescType& matches, std::vector<IndexT>& buffer)
+    {
+        for (const auto& m : matches)
+        {
+            BinaryMatchFileEntry entry;
+            entry.I = pair.first;
+            entry.J = pair.second;
+            entry.descType = static_cast<std::int32_t>(m.first);
+            entry.nbMatches = m.second.size();
+            entry.offset = _offset;
+
+            buffer.resize(2 * m.second.size());
+            for (std::size_t i = 0; i < m.second.size(); ++i)
+            {
+                buffer[2 * i] = m.second[i]._i;
+                buffer[2 * i + 1] = m.second[i]._j;
+            }
+            _stream.write(reinterpret_cast<const char*>(buffer.data()), buffer.size() * sizeof(IndexT));
+            if (!_stream.good())
+                throw std::runtime_error("Unable to write binary match file: " + _tmpPath);
+
+            _offset += buffer.size() * sizeof(IndexT);
+            _entries.push_back(entry);
+        }
+    }
+
+    /**
+     * @brief Add the match arrays and the index entries of the closed temporary file to the output file,
+     *        under an inter-process lock. The new data and the merged pair index table are written after
+     *        the end of the output file, and its header is updated last.
+     */
+    void appendToFile()
+    {
+        const std::string lockPath = _filepath + ".lock";
+        {
+            std::ofstream lockFile(lockPath, std::ios::app);
+        }
+        boost::interprocess::file_lock fileLock(lockPath.c_str());
+        boost::interprocess::scoped_lock<boost::interprocess::file_lock> scopedLock(fileLock);
+
+        if (!utils::exists(_filepath))
+        {
+            fs::rename(_tmpPath, _filepath);
+            return;
+        }
+
+        std::fstream target(_filepath, std::ios::in | std::ios::out | std::ios::binary);
+        if (!target.is_open())
+            throw std::runtime_error("Unable to open binary match file: " + _filepath);
+
+        char magic[sizeof(binaryMatchFileMagic)];
+        std::uint32_t version = 0;
+        std::uint64_t nbEntries = 0;
+        std::uint64_t indexOffset = 0;
+        if (!target.read(magic, sizeof(magic)) || !std::equal(magic, magic + sizeof(magic), binaryMatchFileMagic) || !readBinary(target, version) ||
+            version != streamedBinaryMatchFileVersion || !readBinary(target, nbEntries) || !readBinary(target, indexOffset))
+        {
+            throw std::runtime_error("Only the streamed binary match files can be appended: " + _filepath);
+        }
+
+        std::vector<BinaryMatchFileEntry> entries(nbEntries);
+        target.seekg(indexOffset);
+        for (BinaryMatchFileEntry& entry : entries)
+        {
+            if (!readBinaryMatchFileEntry(target, entry))
+                throw std::runtime_error("Truncated binary match file index: " + _filepath);
+        }
+
+        // copy the match arrays of the temporary file at the end of the output file
+        target.seekp(0, std::ios::end);
+        const std::uint64_t appendOffset = target.tellp();
+        const std::uint64_t dataSize = _offset - streamedBinaryMatchFileHeaderSize;
+        {
+            std::ifstream source(_tmpPath, std::ios::in | std::ios::binary);
+            source.seekg(streamedBinaryMatchFileHeaderSize);
+            std::vector<char> buffer(1 << 20);
+            std::uint64_t remaining = dataSize;
+            while (remaining > 0)
+            {
+                const std::size_t size = static_cast<std::size_t>(std::min<std::uint64_t>(remaining, buffer.size()));
+                if (!source.read(buffer.data(), size))
+                    throw std::runtime_error("Unable to read binary match file: " + _tmpPath);
+                target.write(buffer.data(), size);
+                remaining -= size;
+            }
+        }
+
+        for (BinaryMatchFileEntry entry : _entries)
+        {
+            entry.offset += appendOffset - streamedBinaryMatchFileHeaderSize;
+            entries.push_back(entry);
+        }
+        for (const BinaryMatchFileEntry& entry : entries)
+            writeBinaryMatchFileEntry(target, entry);
+
+        // the previous index stays valid until the header is updated
+        target.seekp(sizeof(binaryMatchFileMagic) + sizeof(streamedBinaryMatchFileVersion));
+        writeBinary(target, std::uint64_t(entries.size()));
+        writeBinary(target, appendOffset + dataSize);
+
+        target.flush();
+        if (!target.good())
+            throw std::runtime_error("Unable to write binary match file: " + _filepath);
+        target.close();
+
+        fs::remove(_tmpPath);
+    }
+
+    const std::string _filepath;
+    std::string _tmpPath;
+    const bool _append;
+    const std::size_t _maxBufferedMatches;
+
+    // only accessed by the writer thread, then by close()
+    std::ofstream _stream;
+    std::uint64_t _offset = 0;
+    std::vector<BinaryMatchFileEntry> _entries;
+
+    // shared with the writer thread
+    mutable std::mutex _mutex;
+    std::condition_variable _queueCondition;
+    std::condition_variable _spaceCondition;
+    std::deque<std::pair<Pair, MatchesPerDescType>> _queue;
+    std::size_t _bufferedMatches = 0;
+    std::size_t _nbPairs = 0;
+    bool _closed = false;
+    std::exception_ptr _error;
+
+    bool _finished = false;
+    std::thread _thread;
+};
+
+MatchesStreamWriter::MatchesStreamWriter(const std::string& filepath, bool append, std::size_t maxBufferedMatches)
+  : _impl(new MatchesStreamWriterImpl(filepath, append, maxBufferedMatches))
+{}
+
+MatchesStreamWriter::~MatchesStreamWriter()
+{
+    // no throw in destructor
+    try
+    {
+        _impl->close();
+    }
+    catch (const std::exception& e)
+    {
+        ALICEVISION_LOG_ERROR("Unable to close the binary match file: " << e.what());
+    }
+}
+
+void MatchesStreamWriter::write(const Pair& pair, MatchesPerDescType matches) { _impl->write(pair, std::move(matches)); }
+
+void MatchesStreamWriter::close() { _impl->close(); }
+
+std::size_t MatchesStreamWriter::getNbPairs() const { return _impl->getNbPairs(); }
+
 bool Save(const PairwiseMatches& matches, const std::string& folder, const std::string& extension, bool matchFilePerImage, const std::string& prefix)
 {
     const std::string filename = prefix + "matches." + extension;
@@ -9,6 +9,7 @@
 
 #include <aliceVision/matching/IndMatch.hpp>
 
+#include <memory>
 #include <string>
 
 namespace aliceVision {
@@ -17,10 +18,18 @@ namespace matching {
 /**
  * @brief Load a match file.
  *
+ * Binary match files (.bin) start with a pair index table, so only the requested pairs
+ * and descriptor types are read. Text match files (.txt) are always fully read.
+ *
  * @param[out] matches container for the output matches
  * @param[in] filepath the match file to load
+ * @param[in] viewsKeysFilter restrict the matches read from a binary file to these views (empty takes all)
+ * @param[in] descTypesFilter restrict the matches read from a binary file to these types of descriptors (empty takes all)
  */
-bool LoadMatchFile(PairwiseMatches& matches, const std::string& filepath);
+bool LoadMatchFile(PairwiseMatches& matches,
+                   const std::string& filepath,
+                   const std::set<IndexT>& viewsKeysFilter = {},
+                   const std::vector<feature::EImageDescriberType>& descTypesFilter = {});
 
 /**
  * @brief Load the match file for each image.
@@ -63,6 +72,13 @@ bool Load(PairwiseMatches& matches,
  */
 void filterMatchesByViews(PairwiseMatches& matches, const std::set<IndexT>& viewsKeys);
 
+/**
+ * @brief Filter to keep only the matches involving at least one of the specified views.
+ * @param[in,out] matches the matches to filter.
+ * @param[in] viewsKeys the list of views to keep matches with.
+ */
+void filterMatchesTouchingViews(PairwiseMatches& matches, const std::set<IndexT>& viewsKeys);
+
 /**
  * @brief  Filter to keep only the \c limitNum first matches per descriptor type.
  * @param[in,out] allMatches he matches to filter.
@@ -76,7 +92,7 @@ void filterTopMatches(PairwiseMatches& allMatches, int maxNum, int minNum);
  *
  * @param[in] matches: container for the output matches
  * @param[in] folder: folder containing the match files
- * @param[in] extension: txt or bin file format
+ * @param[in] extension: txt or bin (indexed binary) file format
  * @param[in] matchFilePerImage: do we store a global match file
  *            or one match file per image
  * @param[in] prefix: optional prefix for the output file(s)
@@ -87,5 +103,60 @@ bool Save(const PairwiseMatches& matches,
           bool matchFilePerImage,
           const std::string& prefix = "");
 
+class MatchesStreamWriterImpl;
+
+/**
+ * @brief Write the matches of image pairs to a binary match file as soon as they are available.
+ *
+ * The match arrays are written by a background thread in the order of the calls to write(),
+ * and the pair index table is written at the end of the file by close(), so the matches of
+ * all the pairs never have to be held in memory. The matches waiting to be written are bounded:
+ * write() waits while the writer thread is late.
+ *
+ * In append mode, the matches are streamed to a temporary file then added to the existing match file
+ * by close(), under an inter-process file lock: the processes of several chunks can append to the same file.
+ * If a pair is written several times in the same file, the last written matches are loaded.
+ */
+class MatchesStreamWriter
+{
+  public:
+    /**
+     * @param[in] filepath The output binary match file (.bin)
+     * @param[in] append Append the matches to the output file if it exists, instead of replacing it
+     * @param[in] maxBufferedMatches The maximum number of matches waiting to be written
+     */
+    explicit MatchesStreamWriter(const std::string& filepath, bool append = false, std::size_t maxBufferedMatches = 1 << 24);
+
+    /**
+     * @brief Close the file if close() has not been called, without throwing.
+     */
+    ~MatchesStreamWriter();
+
+    // no copy
+    MatchesStreamWriter(const MatchesStreamWriter&) = delete;
+    MatchesStreamWriter& operator=(const MatchesStreamWriter&) = delete;
+
+    /**
+     * @brief Queue the matches of an image pair to be written. Thread safe.
+     * @param[in] pair The image pair
+     * @param[in] matches The matches of the pair per descriptor type
+     */
+    void write(const Pair& pair, MatchesPerDescType matches);
+
+    /**
+     * @brief Wait for the queued matches, write the pair index table and move the file to its final path.
+     *        Rethrow the first error of the writer thread.
+     */
+    void close();
+
+    /**
+     * @return the number of image pairs written or queued
+     */
+    std::size_t getNbPairs() const;
+
+  private:
+    std::unique_ptr<MatchesStreamWriterImpl> _impl;
+};
+
 }  // namespace matching
 }  // namespace aliceVision
@@ -0,0 +1,121 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "aliceVision/matching/KeypointsGrid.hpp"
+
+#define BOOST_TEST_MODULE matchingKeypointsGrid
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <random>
+
+using namespace aliceVision;
+using namespace aliceVision::matching;
+
+namespace {
+
+std::vector<Vec2> randomPositions(std::size_t nbPositions, std::mt19937& randomNumberGenerator)
+{
+    std::uniform_real_distribution<double> distributionX(0.0, 1920.0);
+    std::uniform_real_distribution<double> distributionY(0.0, 1080.0);
+    std::vector<Vec2> positions(nbPositions);
+    for (Vec2& position : positions)
+        position = Vec2(distributionX(randomNumberGenerator), distributionY(randomNumberGenerator));
+    return positions;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(KeypointsGrid_band)
+{
+    std::mt19937 randomNumberGenerator(42);
+    const std::vector<Vec2> positions = randomPositions(5000, randomNumberGenerator);
+    const KeypointsGrid grid(positions);
+
+    const double halfWidth = 4.0;
+    std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+    std::vector<IndexT> candidates;
+
+    for (int i = 0; i < 100; ++i)
+    {
+        // random line through a random point of the image
+        const Vec2 direction(distribution(randomNumberGenerator), distribution(randomNumberGenerator));
+        const Vec2& point = positions.at(i);
+        const Vec3 line(direction(1), -direction(0), direction(0) * point(1) - direction(1) * point(0));
+
+        grid.getCandidatesInBand(line, halfWidth, candidates);
+
+        BOOST_CHECK(std::is_sorted(candidates.begin(), candidates.end()));
+        BOOST_CHECK(candidates.size() < positions.size());
+
+        // all the keypoints of the band are candidates
+        for (std::size_t j = 0; j < positions.size(); ++j)
+        {
+            const double distance = std::abs(line.dot(Vec3(positions[j](0), positions[j](1), 1.0))) / line.head<2>().norm();
+            if (distance < halfWidth)
+                BOOST_CHECK(std::binary_search(candidates.begin(), candidates.end(), j));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(KeypointsGrid_disc)
+{
+    std::mt19937 randomNumberGenerator(42);
+    const std::vector<Vec2> positions = randomPositions(5000, randomNumberGenerator);
+    const KeypointsGrid grid(positions);
+
+    const double radius = 8.0;
+    std::vector<IndexT> candidates;
+
+    for (int i = 0; i < 100; ++i)
+    {
+        const Vec2 center = positions.at(i) + Vec2(3.0, -2.0);
+
+        grid.getCandidatesInDisc(center, radius, candidates);
+
+        BOOST_CHECK(std::is_sorted(candidates.begin(), candidates.end()));
+
+        for (std::size_t j = 0; j < positions.size(); ++j)
+        {
+            if ((positions[j] - center).norm() < radius)
+                BOOST_CHECK(std::binary_search(candidates.begin(), candidates.end(), j));
+        }
+    }
+
+    // outside of the keypoints bounding box
+    grid.getCandidatesInDisc(Vec2(-100.0, -100.0), radius, candidates);
+    BOOST_CHECK(candidates.empty());
+}
+
+BOOST_AUTO_TEST_CASE(KeypointsGrid_degenerated)
+{
+    // empty grid
+    const KeypointsGrid emptyGrid(std::vector<Vec2>{});
+    std::vector<IndexT> candidates;
+    emptyGrid.getCandidatesInBand(Vec3(1.0, 1.0, 0.0), 4.0, candidates);
+    BOOST_CHECK(candidates.empty());
+
+    // keypoints on a horizontal line, with duplicates
+    std::vector<Vec2> positions;
+    for (int i = 0; i < 100; ++i)
+        positions.emplace_back(i / 2, 10.0);
+    const KeypointsGrid grid(positions);
+
+    grid.getCandidatesInBand(Vec3(0.0, 1.0, -10.0), 1.0, candidates);
+    BOOST_CHECK_EQUAL(candidates.size(), positions.size());
+
+    grid.getCandidatesInBand(Vec3(1.0, 0.0, -20.0), 0.5, candidates);
+    BOOST_CHECK(std::binary_search(candidates.begin(), candidates.end(), 40));
+    BOOST_CHECK(std::binary_search(candidates.begin(), candidates.end(), 41));
+
+    // invalid line
+    grid.getCandidatesInBand(Vec3(0.0, 0.0, 1.0), 1.0, candidates);
+    BOOST_CHECK(candidates.empty());
+
+    grid.getAllCandidates(candidates);
+    BOOST_CHECK_EQUAL(candidates.size(), positions.size());
+}
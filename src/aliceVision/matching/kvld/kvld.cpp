@@ -138,6 +138,8 @@ VLD::VLD(const ImageScale& series, T const& P1, T const& P2)
     const float sigma2 = r * r;
     //======calculating the descriptor=====//
 
+    const double twoPi = 2 * constants::pi<double>();
+
     double statistic[binNum];
     for (int i = 0; i < dimension; i++)
     {
@@ -148,37 +150,50 @@ VLD::VLD(const ImageScale& series, T const& P1, T const& P2)
         xi /= float(ratio);
         yi /= float(ratio);
 
-        for (int y = int(yi - r); y <= int(yi + r + 0.5); y++)
+        // the same pixels as the test inside(w, h, x, y, 1) on the bounding square of the disc
+        const int yBegin = std::max(int(yi - r), 1);
+        const int yEnd = std::min(int(yi + r + 0.5), h - 2);
+        const int xBegin = std::max(int(xi - r), 1);
+        const int xEnd = std::min(int(xi + r + 0.5), w - 2);
+
+        for (int y = yBegin; y <= yEnd; y++)
         {
-            for (int x = int(xi - r); x <= int(xi + r + 0.5); x++)
+            // the whole row is outside of the disc
+            if (std::abs(float(y) - yi) > r)
+                continue;
+
+            const float* angRow = &ang(y, 0);
+            const float* mRow = &m(y, 0);
+
+            for (int x = xBegin; x <= xEnd; x++)
             {
                 float d = point_distance(xi, yi, float(x), float(y));
-                if (d <= r && inside(w, h, x, y, 1))
+                if (d <= r)
                 {
                     //================angle and magnitude==========================//
+                    // the orientations are in [0, 2*PI[: the relative angle is in ]-2*PI, 2*PI[
                     double angle;
-                    if (ang(y, x) >= 0)
-                        angle = ang(y, x) - mainAngle;  // relative angle
+                    if (angRow[x] >= 0)
+                        angle = angRow[x] - mainAngle;  // relative angle
                     else
                         angle = 0.0;
 
-                    // cout<<angle<<endl;
-                    while (angle < 0)
-                        angle += 2 * constants::pi<double>();
-                    while (angle >= 2 * constants::pi<double>())
-                        angle -= 2 * constants::pi<double>();
+                    if (angle < 0)
+                        angle += twoPi;
+                    if (angle >= twoPi)
+                        angle -= twoPi;
 
                     //===============principle angle==============================//
-                    const int index = int(angle * binNum / (2 * constants::pi<double>()) + 0.5);
+                    const int index = int(angle * binNum / twoPi + 0.5);
 
-                    double Gweight = exp(-d * d / 4.5 / sigma2) * (m(y, x));
+                    double Gweight = exp(-d * d / 4.5 / sigma2) * (mRow[x]);
                     if (index < binNum)
                         statistic[index] += Gweight;
                     else  // possible since the 0.5
                         statistic[0] += Gweight;
 
                     //==============the descriptor===============================//
-                    const int index2 = int(angle * subdirection / (2 * constants::pi<double>()) + 0.5);
+                    const int index2 = int(angle * subdirection / twoPi + 0.5);
                     assert(index2 >= 0 && index2 <= subdirection);
 
                     if (index2 < subdirection)
@@ -213,15 +228,31 @@ float KVLD(const Image<float>& I1,
            std::vector<bool>& valide,
            KvldParameters& kvldParameters)
 {
-    matchesFiltered.clear();
-    score.clear();
-    ImageScale Chaine1(I1);
-    ImageScale Chaine2(I2);
+    const ImageScale Chaine1(I1);
+    const ImageScale Chaine2(I2);
 
     std::cout << "Image scale-space complete..." << std::endl;
 
-    const float range1 = getRange(I1, std::min(F1.size(), matches.size()), kvldParameters.inlierRate);
-    const float range2 = getRange(I2, std::min(F2.size(), matches.size()), kvldParameters.inlierRate);
+    return KVLD(Chaine1, Chaine2, F1, F2, matches, matchesFiltered, score, E, valide, kvldParameters);
+}
+
+float KVLD(const ImageScale& Chaine1,
+           const ImageScale& Chaine2,
+           const std::vector<feature::PointFeature>& F1,
+           const std::vector<feature::PointFeature>& F2,
+           const std::vector<Pair>& matches,
+           std::vector<Pair>& matchesFiltered,
+           std::vector<double>& score,
+           aliceVision::Mat& E,
+           std::vector<bool>& valide,
+           KvldParameters& kvldParameters)
+{
+    matchesFiltered.clear();
+    score.clear();
+
+    // the first scale has the size of the input image
+    const float range1 = getRange(Chaine1.angles[0], std::min(F1.size(), matches.size()), kvldParameters.inlierRate);
+    const float range2 = getRange(Chaine2.angles[0], std::min(F2.size(), matches.size()), kvldParameters.inlierRate);
 
     const size_t size = matches.size();
 
@@ -245,6 +276,35 @@ float KVLD(const Image<float>& I1,
                 dist2(b1, b2) = dist2(b2, b1) = point_distance(F2[b1], F2[b2]);
     }
 
+    // neighbors close enough to be checked, but not too close for a meaningful vld
+    const auto isNeighbor = [&](size_t a1, size_t b1, size_t a2, size_t b2) {
+        if (bPrecomputedDist)
+            return (dist1(a1, a2) > min_dist && dist2(b1, b2) > min_dist && (dist1(a1, a2) < range1 || dist2(b1, b2) < range2));
+        return (point_distance(F1[a1], F1[a2]) > min_dist && point_distance(F2[b1], F2[b2]) > min_dist &&
+                (point_distance(F1[a1], F1[a2]) < range1 || point_distance(F2[b1], F2[b2]) < range2));
+    };
+
+    // update the consistency of two matches, -2 if not consistent
+    const auto evaluate = [&](int it1, int it2) {
+        const size_t a1 = matches[it1].first, b1 = matches[it1].second;
+        const size_t a2 = matches[it2].first, b2 = matches[it2].second;
+
+        E(it1, it2) = -2;
+        E(it2, it1) = -2;
+
+        if (!kvldParameters.geometry || consistent(F1[a1], F1[a2], F2[b1], F2[b2]) < distance_thres)
+        {
+            VLD vld1(Chaine1, F1[a1], F1[a2]);
+            VLD vld2(Chaine2, F2[b1], F2[b2]);
+            double error = vld1.difference(vld2);
+            if (error < juge)
+            {
+                E(it1, it2) = (float)error;
+                E(it2, it1) = (float)error;
+            }
+        }
+    };
+
     std::fill(valide.begin(), valide.end(), true);
     std::vector<double> scoretable(size, 0.0);
     std::vector<size_t> result(size, 0);
@@ -260,7 +320,32 @@ float KVLD(const Image<float>& I1,
         std::fill(scoretable.begin(), scoretable.end(), 0.0);
         std::fill(result.begin(), result.end(), 0);
         //========substep 1: search foreach match its neighbors and verify if they are gvld-consistent ============//
-        for (int it1 = 0; it1 < size - 1; it1++)
+        // The unknown consistencies are first evaluated in parallel, for each match until max_connection consistent neighbors.
+        // The sequential pass below stops each match at the same neighbor or before, since it also counts the neighbors found by the
+        // previous matches: it only reads the evaluated consistencies and takes the same decisions.
+#pragma omp parallel for schedule(dynamic)
+        for (int it1 = 0; it1 < int(size) - 1; it1++)
+        {
+            if (!valide[it1])
+                continue;
+
+            const size_t a1 = matches[it1].first, b1 = matches[it1].second;
+            size_t nbConsistent = 0;
+
+            for (int it2 = it1 + 1; it2 < size && nbConsistent < max_connection; it2++)
+            {
+                if (!valide[it2] || !isNeighbor(a1, b1, matches[it2].first, matches[it2].second))
+                    continue;
+
+                // each pair is only written by the row of its first match
+                if (E(it1, it2) == -1)
+                    evaluate(it1, it2);
+                if (E(it1, it2) >= 0)
+                    ++nbConsistent;
+            }
+        }
+
+        for (int it1 = 0; it1 < int(size) - 1; it1++)
         {
             if (valide[it1])
             {
@@ -271,33 +356,11 @@ float KVLD(const Image<float>& I1,
                     {
                         size_t a2 = matches[it2].first, b2 = matches[it2].second;
 
-                        bool bOk = false;
-                        if (bPrecomputedDist)
-                            bOk = (dist1(a1, a2) > min_dist && dist2(b1, b2) > min_dist && (dist1(a1, a2) < range1 || dist2(b1, b2) < range2));
-                        else
-                            bOk = (point_distance(F1[a1], F1[a2]) > min_dist && point_distance(F2[b1], F2[b2]) > min_dist &&
-                                   (point_distance(F1[a1], F1[a2]) < range1 || point_distance(F2[b1], F2[b2]) < range2));
-                        if (bOk)
+                        if (isNeighbor(a1, b1, a2, b2))
                         {
                             if (E(it1, it2) == -1)
                             {  // update E ifunknow
-                                E(it1, it2) = -2;
-                                E(it2, it1) = -2;
-
-                                if (!kvldParameters.geometry || consistent(F1[a1], F1[a2], F2[b1], F2[b2]) < distance_thres)
-                                {
-                                    VLD vld1(Chaine1, F1[a1], F1[a2]);
-                                    VLD vld2(Chaine2, F2[b1], F2[b2]);
-                                    // vld1.test();
-                                    double error = vld1.difference(vld2);
-                                    // cout<<endl<<it1<<" "<<it2<<" "<<dist1(a1,a2)<<" "<< dist2(b1,b2)<<" "<<error<<endl;
-                                    if (error < juge)
-                                    {
-                                        E(it1, it2) = (float)error;
-                                        E(it2, it1) = (float)error;
-                                        // cout<<E(it2,it1)<<endl;
-                                    }
-                                }
+                                evaluate(it1, it2);
                             }
                             if (E(it1, it2) >= 0)
                             {
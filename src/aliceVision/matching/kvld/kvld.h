@@ -175,4 +175,18 @@ float KVLD(const aliceVision::image::Image<float>& I1,
            std::vector<bool>& valide,
            KvldParameters& kvldParameters);
 
+// Same as above with the scale image pyramids of I1 and I2, e.g. to reuse them when KVLD is processed again with a lower inlier rate.
+//
+// scale1, scale2: the pyramids of scale images of I1 and I2
+float KVLD(const ImageScale& scale1,
+           const ImageScale& scale2,
+           const std::vector<aliceVision::feature::PointFeature>& F1,
+           const std::vector<aliceVision::feature::PointFeature>& F2,
+           const std::vector<aliceVision::Pair>& matches,
+           std::vector<aliceVision::Pair>& matchesFiltered,
+           std::vector<double>& score,
+           aliceVision::Mat& E,
+           std::vector<bool>& valide,
+           KvldParameters& kvldParameters);
+
 #endif  // KVLD_H
@@ -18,7 +18,9 @@ enum EMatcherType
     ANN_L2,
     CASCADE_HASHING_L2,
     FAST_CASCADE_HASHING_L2,
-    BRUTE_FORCE_HAMMING
+    BRUTE_FORCE_HAMMING,
+    BRUTE_FORCE_L2_CUDA,
+    PRODUCT_QUANTIZATION_L2
 };
 
 /**
@@ -9,6 +9,9 @@
 #include "aliceVision/matching/ArrayMatcher_bruteForce.hpp"
 #include "aliceVision/matching/ArrayMatcher_kdtreeFlann.hpp"
 #include "aliceVision/matching/ArrayMatcher_cascadeHashing.hpp"
+#include "aliceVision/matching/ArrayMatcher_productQuantization.hpp"
+#include "aliceVision/matching/ProductQuantizer.hpp"
+#include <filesystem>
 #include <iostream>
 
 #define BOOST_TEST_MODULE matching
@@ -166,3 +169,142 @@ BOOST_AUTO_TEST_CASE(Matching_Cascade_Hashing_Simple_EmptyArrays)
     float fDistance = -1.0f;
     BOOST_CHECK(!matcher.SearchNeighbour(&array[0], &nIndice, &fDistance));
 }
+
+BOOST_AUTO_TEST_CASE(Matching_Cascade_Hashing_NN)
+{
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<int> distribution(0, 255);
+    std::uniform_int_distribution<int> noise(-4, 4);
+
+    const int nbDescriptors = 500;
+    const int dimension = 128;
+
+    // the query descriptors are a slightly perturbed copy of the dataset descriptors
+    std::vector<unsigned char> dataset(nbDescriptors * dimension);
+    std::vector<unsigned char> queries(nbDescriptors * dimension);
+    for (int i = 0; i < nbDescriptors * dimension; ++i)
+    {
+        dataset[i] = distribution(gen);
+        queries[i] = std::min(255, std::max(0, dataset[i] + noise(gen)));
+    }
+
+    ArrayMatcher_cascadeHashing<unsigned char, feature::L2_Vectorized<unsigned char>> matcher;
+    BOOST_CHECK(matcher.Build(gen, &dataset[0], nbDescriptors, dimension));
+
+    IndMatches vec_nIndice;
+    std::vector<float> vec_fDistance;
+    BOOST_CHECK(matcher.SearchNeighbours(&queries[0], nbDescriptors, &vec_nIndice, &vec_fDistance, 2));
+    BOOST_CHECK_EQUAL(vec_nIndice.size(), vec_fDistance.size());
+
+    // most queries retrieve their original descriptor as nearest neighbour
+    int nbCorrect = 0;
+    for (std::size_t i = 0; i < vec_nIndice.size(); i += 2)
+    {
+        BOOST_CHECK_LE(vec_fDistance[i], vec_fDistance[i + 1]);
+        if (vec_nIndice[i]._i == vec_nIndice[i]._j)
+            ++nbCorrect;
+    }
+    BOOST_CHECK_GE(nbCorrect, int(0.95 * nbDescriptors));
+}
+
+BOOST_AUTO_TEST_CASE(Matching_ProductQuantization_Simple_EmptyArrays)
+{
+    std::vector<float> array;
+    std::mt19937 gen(0);
+    ArrayMatcher_productQuantization<float> matcher;
+    BOOST_CHECK(!matcher.Build(gen, &array[0], 0, 4));
+
+    int nIndice = -1;
+    float fDistance = -1.0f;
+    BOOST_CHECK(!matcher.SearchNeighbour(&array[0], &nIndice, &fDistance));
+}
+
+BOOST_AUTO_TEST_CASE(Matching_ProductQuantization_NN)
+{
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<int> distribution(0, 255);
+    std::uniform_int_distribution<int> noise(-4, 4);
+
+    const int nbDescriptors = 500;
+    const int dimension = 128;
+
+    // the query descriptors are a slightly perturbed copy of the dataset descriptors
+    std::vector<unsigned char> dataset(nbDescriptors * dimension);
+    std::vector<unsigned char> queries(nbDescriptors * dimension);
+    for (int i = 0; i < nbDescriptors * dimension; ++i)
+    {
+        dataset[i] = distribution(gen);
+        queries[i] = std::min(255, std::max(0, dataset[i] + noise(gen)));
+    }
+
+    ArrayMatcher_productQuantization<unsigned char, feature::L2_Vectorized<unsigned char>> matcher;
+    BOOST_CHECK(matcher.Build(gen, &dataset[0], nbDescriptors, dimension));
+    BOOST_CHECK_EQUAL(matcher.getCodes().size(), nbDescriptors * matcher.getQuantizer()->codeSize());
+
+    IndMatches vec_nIndice;
+    std::vector<float> vec_fDistance;
+    BOOST_CHECK(matcher.SearchNeighbours(&queries[0], nbDescriptors, &vec_nIndice, &vec_fDistance, 2));
+    BOOST_CHECK_EQUAL(vec_nIndice.size(), vec_fDistance.size());
+
+    // most queries retrieve their original descriptor as nearest neighbour, with its exact distance
+    const feature::L2_Vectorized<unsigned char> metric;
+    int nbCorrect = 0;
+    for (std::size_t i = 0; i < vec_nIndice.size(); i += 2)
+    {
+        BOOST_CHECK_LE(vec_fDistance[i], vec_fDistance[i + 1]);
+        const IndMatch& match = vec_nIndice[i];
+        BOOST_CHECK_EQUAL(vec_fDistance[i], metric(&queries[match._i * dimension], &dataset[match._j * dimension], dimension));
+        if (match._i == match._j)
+            ++nbCorrect;
+    }
+    BOOST_CHECK_GE(nbCorrect, int(0.95 * nbDescriptors));
+}
+
+BOOST_AUTO_TEST_CASE(Matching_ProductQuantizer_SaveLoad)
+{
+    std::mt19937 gen(0);
+    std::uniform_real_distribution<float> distribution(0.f, 1.f);
+
+    const int nbDescriptors = 300;
+    const int dimension = 20;  // not a multiple of the number of subspaces
+    std::vector<float> dataset(nbDescriptors * dimension);
+    for (float& value : dataset)
+        value = distribution(gen);
+
+    ProductQuantizer quantizer(dimension, 8, 16);
+    BOOST_CHECK(!quantizer.isTrained());
+    quantizer.train(gen, &dataset[0], nbDescriptors);
+    BOOST_CHECK(quantizer.isTrained());
+
+    std::vector<std::uint8_t> codes;
+    quantizer.encode(&dataset[0], nbDescriptors, codes);
+    BOOST_CHECK_EQUAL(codes.size(), nbDescriptors * 8);
+
+    // the asymmetric distance is the distance to the decoded descriptor
+    std::vector<float> table(quantizer.distanceTableSize());
+    std::vector<float> decoded(dimension);
+    quantizer.computeDistanceTable(&dataset[0], &table[0]);
+    for (int i = 0; i < nbDescriptors; ++i)
+    {
+        quantizer.decode(&codes[i * 8], &decoded[0]);
+        float distance = 0.f;
+        for (int d = 0; d < dimension; ++d)
+            distance += Square(decoded[d] - dataset[d]);
+        BOOST_CHECK_SMALL(static_cast<double>(quantizer.asymmetricDistance(&table[0], &codes[i * 8]) - distance), 1e-4);
+    }
+
+    const std::string filepath = (std::filesystem::temp_directory_path() / "matching_test_productQuantizer.bin").string();
+    quantizer.save(filepath);
+
+    ProductQuantizer loaded;
+    loaded.load(filepath);
+    std::filesystem::remove(filepath);
+
+    BOOST_CHECK_EQUAL(loaded.dimension(), dimension);
+    BOOST_CHECK_EQUAL(loaded.nbSubspaces(), 8);
+    BOOST_CHECK_EQUAL(loaded.nbCentroids(), 16);
+
+    std::vector<std::uint8_t> loadedCodes;
+    loaded.encode(&dataset[0], nbDescriptors, loadedCodes);
+    BOOST_CHECK(codes == loadedCodes);
+}
@@ -11,10 +11,14 @@
 #include <aliceVision/feature/PointFeature.hpp>
 #include <aliceVision/feature/RegionsPerView.hpp>
 #include <aliceVision/matching/IndMatch.hpp>
+#include <aliceVision/matching/KeypointsGrid.hpp>
 #include <aliceVision/matchingImageCollection/GeometricFilterMatrix.hpp>
 #include <aliceVision/system/ProgressDisplay.hpp>
+#include <aliceVision/system/ResourceReport.hpp>
+#include <aliceVision/system/Tracer.hpp>
 
 #include <map>
+#include <memory>
 #include <random>
 #include <vector>
 
@@ -47,15 +51,35 @@ void robustModelEstimation(PairwiseMatches& out_geometricMatches,
                            const bool guidedMatching = false,
                            const double distanceRatio = 0.6)
 {
+    ALICEVISION_TRACE_ZONE_CAT("matchingImageCollection::robustModelEstimation", "featureMatching");
+    ALICEVISION_RESOURCE_PHASE("matchingImageCollection::robustModelEstimation");
+
     out_geometricMatches.clear();
 
     auto progressDisplay = system::createConsoleProgressDisplay(putativeMatches.size(), std::cout, "Robust Model Estimation\n");
 
+    // Random access to the pairs and one random seed per pair,
+    // so that the results do not depend on the threads scheduling
+    std::vector<PairwiseMatches::const_iterator> pairsIterators;
+    std::vector<std::mt19937::result_type> pairsSeeds;
+    pairsIterators.reserve(putativeMatches.size());
+    pairsSeeds.reserve(putativeMatches.size());
+    for (PairwiseMatches::const_iterator iter = putativeMatches.begin(); iter != putativeMatches.end(); ++iter)
+    {
+        pairsIterators.push_back(iter);
+        pairsSeeds.push_back(randomNumberGenerator());
+    }
+
+    // the keypoints grids of the guided matching are built once per view and shared by all the pairs
+    std::shared_ptr<matching::KeypointsGridCache> keypointsGridCache = functor.m_keypointsGridCache;
+    if (guidedMatching && !keypointsGridCache)
+        keypointsGridCache = std::make_shared<matching::KeypointsGridCache>();
+
 #pragma omp parallel for schedule(dynamic)
     for (int i = 0; i < (int)putativeMatches.size(); ++i)
     {
-        PairwiseMatches::const_iterator iter = putativeMatches.begin();
-        std::advance(iter, i);
+        PairwiseMatches::const_iterator iter = pairsIterators[i];
+        std::mt19937 pairRandomNumberGenerator(pairsSeeds[i]);
 
         const Pair currentPair = iter->first;
         const MatchesPerDescType& putativeMatchesPerType = iter->second;
@@ -65,8 +89,9 @@ void robustModelEstimation(PairwiseMatches& out_geometricMatches,
         {
             MatchesPerDescType inliers;
             GeometryFunctor geometricFilter = functor;  // use a copy since we are in a multi-thread context
+            geometricFilter.m_keypointsGridCache = keypointsGridCache;
             const EstimationStatus state =
-              geometricFilter.geometricEstimation(sfmData, regionsPerView, imagePair, putativeMatchesPerType, randomNumberGenerator, inliers);
+              geometricFilter.geometricEstimation(sfmData, regionsPerView, imagePair, putativeMatchesPerType, pairRandomNumberGenerator, inliers);
             if (state.hasStrongSupport)
             {
                 if (guidedMatching)
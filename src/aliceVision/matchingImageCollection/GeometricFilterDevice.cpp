@@ -0,0 +1,153 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "GeometricFilterDevice.hpp"
+
+#include <aliceVision/matchingImageCollection/cuda/DeviceGeometricFilter.hpp>
+#include <aliceVision/matchingImageCollection/geometricFilterUtils.hpp>
+#include <aliceVision/numeric/numeric.hpp>
+#include <aliceVision/sfmData/SfMData.hpp>
+#include <aliceVision/system/Logger.hpp>
+#include <aliceVision/system/ProgressDisplay.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+namespace aliceVision {
+namespace matchingImageCollection {
+
+void deviceGeometricFilter(matching::PairwiseMatches& out_filteredMatches,
+                           const sfmData::SfMData& sfmData,
+                           const feature::RegionsPerView& regionsPerView,
+                           const matching::PairwiseMatches& putativeMatches,
+                           EGeometricFilterType geometricFilterType,
+                           const DeviceGeometricFilterParams& params,
+                           std::mt19937& randomNumberGenerator)
+{
+    if (!isDeviceGeometricFilterSupported(geometricFilterType))
+        throw std::invalid_argument("The geometric filter " + EGeometricFilterType_enumToString(geometricFilterType) + " is not supported on the GPU.");
+
+    out_filteredMatches.clear();
+
+    const cuda::EDeviceGeometricModel model =
+      (geometricFilterType == EGeometricFilterType::HOMOGRAPHY_MATRIX) ? cuda::EDeviceGeometricModel::HOMOGRAPHY : cuda::EDeviceGeometricModel::FUNDAMENTAL;
+    const std::size_t minimalSampleSize = (model == cuda::EDeviceGeometricModel::HOMOGRAPHY) ? 4 : 8;
+    const std::size_t minNbInliers = std::max(params.minNbInliers, minimalSampleSize + 1);
+
+    // the pairs with too few putative matches can not be kept
+    std::vector<matching::PairwiseMatches::const_iterator> pairsIterators;
+    pairsIterators.reserve(putativeMatches.size());
+    for (auto iter = putativeMatches.begin(); iter != putativeMatches.end(); ++iter)
+    {
+        if (iter->second.getNbAllMatches() >= minNbInliers)
+            pairsIterators.push_back(iter);
+    }
+
+    ALICEVISION_LOG_INFO("GPU geometric filtering of " << pairsIterators.size() << " image pairs (" << putativeMatches.size() - pairsIterators.size()
+                                                       << " pairs with less than " << minNbInliers << " putative matches are discarded).");
+
+    auto progressDisplay = system::createConsoleProgressDisplay(pairsIterators.size(), std::cout, "GPU Geometric Filtering\n");
+
+    cuda::DeviceGeometricFilter deviceFilter;
+
+    std::size_t batchBegin = 0;
+    while (batchBegin < pairsIterators.size())
+    {
+        // gather the pairs of the batch, at least one pair even if it exceeds the maximum number of correspondences
+        std::vector<int> pairOffsets(1, 0);
+        std::size_t batchEnd = batchBegin;
+        while (batchEnd < pairsIterators.size())
+        {
+            const std::size_t nbMatches = pairsIterators.at(batchEnd)->second.getNbAllMatches();
+            if (batchEnd > batchBegin && pairOffsets.back() + nbMatches > params.maxBatchCorrespondences)
+                break;
+            pairOffsets.push_back(pairOffsets.back() + static_cast<int>(nbMatches));
+            ++batchEnd;
+        }
+
+        const int nbPairs = static_cast<int>(batchEnd - batchBegin);
+
+        std::vector<float> correspondences(4 * std::size_t(pairOffsets.back()));
+        std::vector<float> squaredThresholds(nbPairs);
+        std::vector<std::vector<feature::EImageDescriberType>> descTypesPerPair(nbPairs);
+
+#pragma omp parallel for
+        for (int i = 0; i < nbPairs; ++i)
+        {
+            const auto& pairMatches = *pairsIterators.at(batchBegin + i);
+            const Pair& pair = pairMatches.first;
+
+            descTypesPerPair.at(i) = regionsPerView.getCommonDescTypes(pair);
+
+            Mat xI, xJ;
+            fillMatricesWithUndistortFeaturesMatches(pair, pairMatches.second, &sfmData, regionsPerView, descTypesPerPair.at(i), xI, xJ);
+
+            // center the points and scale them by the image size for the conditioning of the linear solvers
+            const sfmData::View& viewI = sfmData.getView(pair.first);
+            const sfmData::View& viewJ = sfmData.getView(pair.second);
+            const double widthI = viewI.getImage().getWidth();
+            const double heightI = viewI.getImage().getHeight();
+            const double widthJ = viewJ.getImage().getWidth();
+            const double heightJ = viewJ.getImage().getHeight();
+            const double scaleI = 1.0 / std::max(1.0, std::max(widthI, heightI));
+            const double scaleJ = 1.0 / std::max(1.0, std::max(widthJ, heightJ));
+
+            float* pairCorrespondences = correspondences.data() + 4 * std::size_t(pairOffsets.at(i));
+            for (Mat::Index k = 0; k < xI.cols(); ++k)
+            {
+                pairCorrespondences[4 * k + 0] = static_cast<float>((xI(0, k) - 0.5 * widthI) * scaleI);
+                pairCorrespondences[4 * k + 1] = static_cast<float>((xI(1, k) - 0.5 * heightI) * scaleI);
+                pairCorrespondences[4 * k + 2] = static_cast<float>((xJ(0, k) - 0.5 * widthJ) * scaleJ);
+                pairCorrespondences[4 * k + 3] = static_cast<float>((xJ(1, k) - 0.5 * heightJ) * scaleJ);
+            }
+
+            // the errors are measured in the second image
+            squaredThresholds.at(i) = static_cast<float>(Square(params.maxError * scaleJ));
+        }
+
+        std::vector<unsigned char> inlierMask(pairOffsets.back());
+        std::vector<int> nbInliers(nbPairs);
+
+        deviceFilter.filter(model,
+                            correspondences.data(),
+                            pairOffsets.data(),
+                            squaredThresholds.data(),
+                            nbPairs,
+                            params.nbIterations,
+                            static_cast<unsigned int>(randomNumberGenerator()),
+                            inlierMask.data(),
+                            nbInliers.data());
+
+        for (int i = 0; i < nbPairs; ++i)
+        {
+            if (nbInliers.at(i) < static_cast<int>(minNbInliers))
+                continue;
+
+            const auto& pairMatches = *pairsIterators.at(batchBegin + i);
+
+            std::vector<std::size_t> inliers;
+            inliers.reserve(nbInliers.at(i));
+            for (int k = 0; k < pairOffsets.at(i + 1) - pairOffsets.at(i); ++k)
+            {
+                if (inlierMask.at(pairOffsets.at(i) + k))
+                    inliers.push_back(k);
+            }
+
+            matching::MatchesPerDescType filteredMatches;
+            copyInlierMatches(inliers, pairMatches.second, descTypesPerPair.at(i), filteredMatches);
+            out_filteredMatches.emplace(pairMatches.first, std::move(filteredMatches));
+        }
+
+        progressDisplay += nbPairs;
+        batchBegin = batchEnd;
+    }
+
+    ALICEVISION_LOG_INFO("GPU geometric filtering kept " << out_filteredMatches.size() << " image pairs.");
+}
+
+}  // namespace matchingImageCollection
+}  // namespace aliceVision
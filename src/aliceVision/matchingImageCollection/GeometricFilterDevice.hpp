@@ -0,0 +1,77 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/feature/RegionsPerView.hpp>
+#include <aliceVision/matching/IndMatch.hpp>
+#include <aliceVision/matchingImageCollection/GeometricFilterType.hpp>
+
+#include <cstddef>
+#include <random>
+
+namespace aliceVision {
+
+namespace sfmData {
+class SfMData;
+}
+
+namespace matchingImageCollection {
+
+/**
+ * @brief Parameters of the geometric filtering on the GPU.
+ */
+struct DeviceGeometricFilterParams
+{
+    /// maximum distance (in pixels) in the second image of an inlier
+    double maxError = 8.0;
+    /// number of hypotheses per image pair
+    int nbIterations = 1024;
+    /// minimum number of inliers to keep an image pair
+    std::size_t minNbInliers = 16;
+    /// maximum number of correspondences uploaded to the device at once
+    std::size_t maxBatchCorrespondences = 1 << 22;
+};
+
+/**
+ * @brief Check if the given geometric filter can be preceded by the GPU geometric filtering.
+ *        The essential matrix filter uses the fundamental matrix model on the device.
+ * @param[in] geometricFilterType The geometric filter type
+ * @return true if supported
+ */
+inline bool isDeviceGeometricFilterSupported(EGeometricFilterType geometricFilterType)
+{
+    return geometricFilterType == EGeometricFilterType::FUNDAMENTAL_MATRIX || geometricFilterType == EGeometricFilterType::ESSENTIAL_MATRIX ||
+           geometricFilterType == EGeometricFilterType::HOMOGRAPHY_MATRIX;
+}
+
+/**
+ * @brief Reject the outliers and the non-overlapping image pairs of the putative matches
+ *        with a fixed threshold RANSAC of many pairs at once on the GPU.
+ *
+ * The output keeps the same layout as the putative matches (matches per describer type),
+ * so that the usual robust model estimation with the GeometricFilterMatrix_* filters
+ * can be run on the remaining inliers to estimate the final models.
+ *
+ * @param[out] out_filteredMatches The inlier matches of the kept image pairs
+ * @param[in] sfmData The SfMData (views image sizes and intrinsics)
+ * @param[in] regionsPerView The regions of the views
+ * @param[in] putativeMatches The putative matches to filter
+ * @param[in] geometricFilterType The geometric filter type (see isDeviceGeometricFilterSupported)
+ * @param[in] params The GPU geometric filtering parameters
+ * @param[in] randomNumberGenerator The random number generator
+ * @note Only available in a build with CUDA.
+ */
+void deviceGeometricFilter(matching::PairwiseMatches& out_filteredMatches,
+                           const sfmData::SfMData& sfmData,
+                           const feature::RegionsPerView& regionsPerView,
+                           const matching::PairwiseMatches& putativeMatches,
+                           EGeometricFilterType geometricFilterType,
+                           const DeviceGeometricFilterParams& params,
+                           std::mt19937& randomNumberGenerator);
+
+}  // namespace matchingImageCollection
+}  // namespace aliceVision
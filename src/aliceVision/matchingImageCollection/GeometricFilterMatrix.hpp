@@ -7,6 +7,8 @@
 
 #pragma once
 
+#include <memory>
+
 namespace aliceVision {
 
 namespace feature {
@@ -15,6 +17,7 @@ class RegionsPerView;
 
 namespace matching {
 class MatchesPerDescType;
+class KeypointsGridCache;
 }
 
 namespace sfmData {
@@ -49,6 +52,9 @@ struct GeometricFilterMatrix
     double m_dPrecision;  // upper_bound precision used for robust estimation
     double m_dPrecision_robust;
     std::size_t m_stIteration;  // maximal number of iteration for robust estimation
+    std::size_t m_stIterationWithoutModel = 0;  // number of iterations without meaningful model before giving up (0 to disable)
+    bool m_useProsacSampling = false;  // sample the matches with the lowest distance ratio first (PROSAC)
+    std::shared_ptr<matching::KeypointsGridCache> m_keypointsGridCache;  // keypoints grids shared by the guided matching of all the pairs (optional)
 };
 
 }  // namespace matchingImageCollection
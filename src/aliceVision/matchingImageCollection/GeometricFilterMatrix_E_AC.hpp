@@ -80,6 +80,11 @@ struct GeometricFilterMatrix_E_AC : public GeometricFilterMatrix
         Mat xI, xJ;
         fillMatricesWithUndistortFeaturesMatches(pairIndex, putativeMatchesPerType, sfmData, regionsPerView, descTypes, xI, xJ);
 
+        // matches ordered by quality for PROSAC sampling
+        std::vector<std::size_t> sortedIndices;
+        if (m_useProsacSampling)
+            getMatchesSortedByDistanceRatio(putativeMatchesPerType, descTypes, sortedIndices);
+
         // define the AContrario adapted Essential matrix solver
         using KernelT = multiview::RelativePoseKernel_K<multiview::relativePose::Essential5PSolver,
                                                         multiview::relativePose::FundamentalEpipolarDistanceError,
@@ -99,8 +104,14 @@ struct GeometricFilterMatrix_E_AC : public GeometricFilterMatrix
 
         std::vector<std::size_t> inliers;
         robustEstimation::Mat3Model model;
-        const std::pair<double, double> ACRansacOut =
-          robustEstimation::ACRANSAC(kernel, randomNumberGenerator, inliers, m_stIteration, &model, upperBoundPrecision);
+        const std::pair<double, double> ACRansacOut = robustEstimation::ACRANSAC(kernel,
+                                                                                 randomNumberGenerator,
+                                                                                 inliers,
+                                                                                 m_stIteration,
+                                                                                 &model,
+                                                                                 upperBoundPrecision,
+                                                                                 m_stIterationWithoutModel,
+                                                                                 m_useProsacSampling ? &sortedIndices : nullptr);
         m_E = model.getMatrix();
 
         if (inliers.empty())
@@ -160,15 +171,33 @@ struct GeometricFilterMatrix_E_AC : public GeometricFilterMatrix
 
             robustEstimation::Mat3Model model(F);
             // multiview::relativePose::FundamentalSymmetricEpipolarDistanceError
-            matching::guidedMatching<robustEstimation::Mat3Model, multiview::relativePose::FundamentalEpipolarDistanceError>(
-              model,
-              camI,
-              regionsPerView.getAllRegions(I),
-              camJ,
-              regionsPerView.getAllRegions(J),
-              Square(m_dPrecision_robust),
-              Square(dDistanceRatio),
-              matches);
+            if (m_keypointsGridCache)
+            {
+                // reuse the keypoints grids of the views between the pairs
+                matching::guidedMatching<robustEstimation::Mat3Model, multiview::relativePose::FundamentalEpipolarDistanceError>(
+                  model,
+                  imageIdsPair,
+                  camI,
+                  regionsPerView.getAllRegions(I),
+                  camJ,
+                  regionsPerView.getAllRegions(J),
+                  Square(m_dPrecision_robust),
+                  Square(dDistanceRatio),
+                  *m_keypointsGridCache,
+                  matches);
+            }
+            else
+            {
+                matching::guidedMatching<robustEstimation::Mat3Model, multiview::relativePose::FundamentalEpipolarDistanceError>(
+                  model,
+                  camI,
+                  regionsPerView.getAllRegions(I),
+                  camJ,
+                  regionsPerView.getAllRegions(J),
+                  Square(m_dPrecision_robust),
+                  Square(dDistanceRatio),
+                  matches);
+            }
         }
 
         return matches.getNbAllMatches() != 0;
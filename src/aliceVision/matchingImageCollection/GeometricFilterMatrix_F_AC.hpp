@@ -108,6 +108,12 @@ struct GeometricFilterMatrix_F_AC : public GeometricFilterMatrix
         Mat xI, xJ;
         fillMatricesWithUndistortFeaturesMatches(putativeMatchesPerType, camI, camJ, regionI, regionJ, descTypes, xI, xJ);
 
+        // matches ordered by quality for PROSAC sampling
+        std::vector<std::size_t> sortedIndices;
+        if (m_useProsacSampling)
+            getMatchesSortedByDistanceRatio(putativeMatchesPerType, descTypes, sortedIndices);
+        const std::vector<std::size_t>* sortedIndicesPtr = m_useProsacSampling ? &sortedIndices : nullptr;
+
         std::vector<std::size_t> inliers;
         const camera::Equidistant* cam_I_equidistant = dynamic_cast<const camera::Equidistant*>(camI);
         const camera::Equidistant* cam_J_equidistant = dynamic_cast<const camera::Equidistant*>(camJ);
@@ -120,18 +126,18 @@ struct GeometricFilterMatrix_F_AC : public GeometricFilterMatrix
                 if (cam_I_equidistant && cam_J_equidistant)
                 {
                     estimationPair = geometricEstimation_Spherical_Mat(
-                      xI, xJ, cam_I_equidistant, cam_J_equidistant, imageSizeI, imageSizeJ, randomNumberGenerator, inliers);
+                      xI, xJ, cam_I_equidistant, cam_J_equidistant, imageSizeI, imageSizeJ, randomNumberGenerator, inliers, sortedIndicesPtr);
                 }
                 else if (m_estimateDistortion)
                 {
                     estimationPair =
                       geometricEstimation_Mat_ACRANSAC<multiview::relativePose::Fundamental10PSolver, multiview::relativePose::Fundamental10PModel>(
-                        xI, xJ, imageSizeI, imageSizeJ, randomNumberGenerator, inliers);
+                        xI, xJ, imageSizeI, imageSizeJ, randomNumberGenerator, inliers, sortedIndicesPtr);
                 }
                 else
                 {
                     estimationPair = geometricEstimation_Mat_ACRANSAC<multiview::relativePose::Fundamental7PSolver, robustEstimation::Mat3Model>(
-                      xI, xJ, imageSizeI, imageSizeJ, randomNumberGenerator, inliers);
+                      xI, xJ, imageSizeI, imageSizeJ, randomNumberGenerator, inliers, sortedIndicesPtr);
                 }
             }
             break;
@@ -181,6 +187,7 @@ struct GeometricFilterMatrix_F_AC : public GeometricFilterMatrix
      * @param[in] imageSizeI The size of the first image (used for normalizing the points)
      * @param[in] imageSizeJ The size of the second image
      * @param[out] geometric_inliers A vector containing the indices of the inliers
+     * @param[in] sortedIndices Optional indices of the points sorted by decreasing quality, enable PROSAC sampling
      * @return true if geometric_inliers is not empty
      */
     std::pair<bool, std::size_t> geometricEstimation_Spherical_Mat(const Mat& xI,  // points of the first image
@@ -190,7 +197,8 @@ struct GeometricFilterMatrix_F_AC : public GeometricFilterMatrix
                                                                    const std::pair<size_t, size_t>& imageSizeI,  // size of the first image
                                                                    const std::pair<size_t, size_t>& imageSizeJ,  // size of the first image
                                                                    std::mt19937& randomNumberGenerator,
-                                                                   std::vector<size_t>& out_inliers)
+                                                                   std::vector<size_t>& out_inliers,
+                                                                   const std::vector<std::size_t>* sortedIndices = nullptr)
     {
         using namespace aliceVision;
         using namespace aliceVision::robustEstimation;
@@ -240,7 +248,7 @@ struct GeometricFilterMatrix_F_AC : public GeometricFilterMatrix
 
         robustEstimation::Mat3Model model;
         const std::pair<double, double> ACRansacOut =
-          ACRANSAC(kernel, randomNumberGenerator, out_inliers, m_stIteration, &model, upper_bound_precision);
+          ACRANSAC(kernel, randomNumberGenerator, out_inliers, m_stIteration, &model, upper_bound_precision, m_stIterationWithoutModel, sortedIndices);
 
         m_F = model.getMatrix();
 
@@ -261,6 +269,7 @@ struct GeometricFilterMatrix_F_AC : public GeometricFilterMatrix
      * @param[in] imageSizeI The size of the first image (used for normalizing the points)
      * @param[in] imageSizeJ The size of the second image
      * @param[out] geometric_inliers A vector containing the indices of the inliers
+     * @param[in] sortedIndices Optional indices of the points sorted by decreasing quality, enable PROSAC sampling
      * @return true if geometric_inliers is not empty
      */
     template<class SolverT_, class ModelT_>
@@ -269,7 +278,8 @@ struct GeometricFilterMatrix_F_AC : public GeometricFilterMatrix
                                                                   const std::pair<std::size_t, std::size_t>& imageSizeI,  // size of the first image
                                                                   const std::pair<std::size_t, std::size_t>& imageSizeJ,  // size of the first image
                                                                   std::mt19937 randomNumberGenerator,
-                                                                  std::vector<std::size_t>& out_inliers)
+                                                                  std::vector<std::size_t>& out_inliers,
+                                                                  const std::vector<std::size_t>* sortedIndices = nullptr)
     {
         out_inliers.clear();
 
@@ -287,7 +297,7 @@ struct GeometricFilterMatrix_F_AC : public GeometricFilterMatrix
 
         ModelT_ model;
         const std::pair<double, double> ACRansacOut =
-          robustEstimation::ACRANSAC(kernel, randomNumberGenerator, out_inliers, m_stIteration, &model, upperBoundPrecision);
+          robustEstimation::ACRANSAC(kernel, randomNumberGenerator, out_inliers, m_stIteration, &model, upperBoundPrecision, m_stIterationWithoutModel, sortedIndices);
         m_F = model.getMatrix();
 
         if (out_inliers.empty())
@@ -378,15 +388,33 @@ struct GeometricFilterMatrix_F_AC : public GeometricFilterMatrix
             robustEstimation::Mat3Model model(m_F);
 
             // check the features correspondences that agree in the geometric and photometric domain
-            matching::guidedMatching<robustEstimation::Mat3Model, multiview::relativePose::FundamentalEpipolarDistanceError>(
-              model,
-              camI,                             // camera::IntrinsicBase
-              regionsPerView.getAllRegions(I),  // feature::Regions
-              camJ,                             // camera::IntrinsicBase
-              regionsPerView.getAllRegions(J),  // feature::Regions
-              Square(m_dPrecision_robust),
-              Square(dDistanceRatio),
-              matches);
+            if (m_keypointsGridCache)
+            {
+                // reuse the keypoints grids of the views between the pairs
+                matching::guidedMatching<robustEstimation::Mat3Model, multiview::relativePose::FundamentalEpipolarDistanceError>(
+                  model,
+                  imageIdsPair,
+                  camI,
+                  regionsPerView.getAllRegions(I),
+                  camJ,
+                  regionsPerView.getAllRegions(J),
+                  Square(m_dPrecision_robust),
+                  Square(dDistanceRatio),
+                  *m_keypointsGridCache,
+                  matches);
+            }
+            else
+            {
+                matching::guidedMatching<robustEstimation::Mat3Model, multiview::relativePose::FundamentalEpipolarDistanceError>(
+                  model,
+                  camI,                             // camera::IntrinsicBase
+                  regionsPerView.getAllRegions(I),  // feature::Regions
+                  camJ,                             // camera::IntrinsicBase
+                  regionsPerView.getAllRegions(J),  // feature::Regions
+                  Square(m_dPrecision_robust),
+                  Square(dDistanceRatio),
+                  matches);
+            }
         }
         return matches.getNbAllMatches() != 0;
     }
@@ -7,6 +7,9 @@
 #include <aliceVision/matching/svgVisualization.hpp>
 #include "GeometricFilterMatrix_HGrowing.hpp"
 
+#include <algorithm>
+#include <numeric>
+
 namespace aliceVision {
 namespace matchingImageCollection {
 
@@ -56,11 +59,165 @@ std::size_t GeometricFilterMatrix_HGrowing::getNbAllVerifiedMatches() const
     return counter;
 }
 
+namespace {
+
+/**
+ * @brief Coordinates of the matched points, one column per match,
+ *        so that the transformations are evaluated on all the matches at once.
+ */
+struct MatchesPoints
+{
+    MatchesPoints(const std::vector<feature::PointFeature>& featuresI,
+                  const std::vector<feature::PointFeature>& featuresJ,
+                  const matching::IndMatches& matches)
+      : pointsI(2, matches.size()),
+        pointsJ(2, matches.size())
+    {
+        for (std::size_t k = 0; k < matches.size(); ++k)
+        {
+            pointsI.col(k) = featuresI.at(matches[k]._i).coords().cast<double>();
+            pointsJ.col(k) = featuresJ.at(matches[k]._j).coords().cast<double>();
+        }
+    }
+
+    inline std::size_t size() const { return pointsI.cols(); }
+
+    Mat2X pointsI;
+    Mat2X pointsJ;
+};
+
+/**
+ * @brief Temporary buffers of the homography growing, reused between the seeds of a thread.
+ */
+struct GrowBuffers
+{
+    Mat3X projected;
+    Vec squaredErrors;
+};
+
+/**
+ * @brief Standardize the given matched points (zero mean and unit standard deviation), as centerMatrix.
+ */
+Mat3 centeringMatrix(const Mat2X& points, const std::vector<IndexT>& matchesId)
+{
+    Vec2 mean = Vec2::Zero();
+    for (const IndexT matchId : matchesId)
+        mean += points.col(matchId);
+    mean /= matchesId.size();
+
+    Vec2 variance = Vec2::Zero();
+    for (const IndexT matchId : matchesId)
+        variance += (points.col(matchId) - mean).cwiseAbs2();
+
+    const Vec2 stdDev = (variance / std::max<double>(matchesId.size() - 1, 1.0)).cwiseSqrt().cwiseMax(0.1);
+
+    Mat3 t;
+    t << 1. / stdDev(0), 0., -mean(0) / stdDev(0), 0., 1. / stdDev(1), -mean(1) / stdDev(1), 0., 0., 1.;
+    return t;
+}
+
+/**
+ * @brief Least squares affinity of the given matches, from the centered points (2x2 normal equations).
+ */
+void estimateAffinity(const MatchesPoints& points, const std::vector<IndexT>& matchesId, Mat3& affineTransformation)
+{
+    Vec2 meanI = Vec2::Zero();
+    Vec2 meanJ = Vec2::Zero();
+    for (const IndexT matchId : matchesId)
+    {
+        meanI += points.pointsI.col(matchId);
+        meanJ += points.pointsJ.col(matchId);
+    }
+    meanI /= matchesId.size();
+    meanJ /= matchesId.size();
+
+    // xJ - meanJ = L * (xI - meanI)
+    Eigen::Matrix2d covII = Eigen::Matrix2d::Zero();
+    Eigen::Matrix2d covIJ = Eigen::Matrix2d::Zero();
+    for (const IndexT matchId : matchesId)
+    {
+        const Vec2 dI = points.pointsI.col(matchId) - meanI;
+        const Vec2 dJ = points.pointsJ.col(matchId) - meanJ;
+        covII += dI * dI.transpose();
+        covIJ += dI * dJ.transpose();
+    }
+    const Eigen::Matrix2d linear = Eigen::JacobiSVD<Eigen::Matrix2d>(covII, Eigen::ComputeFullU | Eigen::ComputeFullV).solve(covIJ).transpose();
+
+    affineTransformation = Mat3::Identity();
+    affineTransformation.topLeftCorner<2, 2>() = linear;
+    affineTransformation.block<2, 1>(0, 2) = meanJ - linear * meanI;
+}
+
+/**
+ * @brief DLT homography of the given matches, from the standardized points.
+ *        The smallest eigenvector of the 9x9 normal matrix is the smallest right singular vector of the DLT system.
+ */
+void estimateHomography(const MatchesPoints& points, const std::vector<IndexT>& matchesId, Mat3& H)
+{
+    const Mat3 CI = centeringMatrix(points.pointsI, matchesId);
+    const Mat3 CJ = centeringMatrix(points.pointsJ, matchesId);
+
+    using Mat9 = Eigen::Matrix<double, 9, 9>;
+    using Vec9 = Eigen::Matrix<double, 9, 1>;
+
+    Mat9 AtA = Mat9::Zero();
+    for (const IndexT matchId : matchesId)
+    {
+        const Vec3 ptI = CI * points.pointsI.col(matchId).homogeneous();
+        const Vec3 ptJ = CJ * points.pointsJ.col(matchId).homogeneous();
+
+        Vec9 rowX = Vec9::Zero();
+        rowX.head<3>() = ptI;
+        rowX.tail<3>() = -ptJ(0) * ptI;
+        Vec9 rowY = Vec9::Zero();
+        rowY.segment<3>(3) = ptI;
+        rowY.tail<3>() = -ptJ(1) * ptI;
+
+        AtA.selfadjointView<Eigen::Lower>().rankUpdate(rowX);
+        AtA.selfadjointView<Eigen::Lower>().rankUpdate(rowY);
+    }
+
+    const Eigen::SelfAdjointEigenSolver<Mat9> solver(AtA.selfadjointView<Eigen::Lower>());
+    const Vec9 h = solver.eigenvectors().col(0);
+
+    Mat3 H0;
+    H0.row(0) = h.head<3>().transpose();
+    H0.row(1) = h.segment<3>(3).transpose();
+    H0.row(2) = h.tail<3>().transpose();
+
+    H = CJ.inverse() * H0 * CI;
+    if (std::fabs(H(2, 2)) > std::numeric_limits<double>::epsilon())
+        H /= H(2, 2);
+}
+
+/**
+ * @brief Find the matches with a reprojection error below the tolerance, as findTransformationInliers.
+ */
+void findInliers(const MatchesPoints& points, const Mat3& transformation, double tolerance, GrowBuffers& buffers, std::vector<IndexT>& inliersId)
+{
+    buffers.projected.noalias() = transformation.leftCols<2>() * points.pointsI;
+    buffers.projected.colwise() += transformation.col(2);
+    buffers.squaredErrors = (points.pointsJ - buffers.projected.colwise().hnormalized()).colwise().squaredNorm().transpose();
+
+    const double squaredTolerance = Square(tolerance);
+    inliersId.clear();
+    for (Vec::Index k = 0; k < buffers.squaredErrors.size(); ++k)
+    {
+        if (buffers.squaredErrors(k) < squaredTolerance)
+            inliersId.push_back(k);
+    }
+}
+
+/**
+ * @brief growHomography on the matched points buffers.
+ */
 bool growHomography(const std::vector<feature::PointFeature>& featuresI,
                     const std::vector<feature::PointFeature>& featuresJ,
                     const matching::IndMatches& matches,
-                    const IndexT& seedMatchId,
-                    std::set<IndexT>& planarMatchesIndices,
+                    const MatchesPoints& points,
+                    const IndexT seedMatchId,
+                    GrowBuffers& buffers,
+                    std::vector<IndexT>& planarMatchesIndices,
                     Mat3& transformation,
                     const GrowParameters& param)
 {
@@ -70,30 +227,38 @@ bool growHomography(const std::vector<feature::PointFeature>& featuresI,
     transformation = Mat3::Identity();
 
     const matching::IndMatch& seedMatch = matches.at(seedMatchId);
-    const feature::PointFeature& seedFeatureI = featuresI.at(seedMatch._i);
-    const feature::PointFeature& seedFeatureJ = featuresJ.at(seedMatch._j);
 
-    double currTolerance;
+    // an empty set of matches means all the matches for the estimations (as estimateAffinity / estimateHomography)
+    std::vector<IndexT> allMatchesId;
 
     for (IndexT iRefineStep = 0; iRefineStep < param._nbRefiningIterations; ++iRefineStep)
     {
+        double currTolerance;
+
+        if (iRefineStep > 0 && planarMatchesIndices.empty() && allMatchesId.empty())
+        {
+            allMatchesId.resize(matches.size());
+            std::iota(allMatchesId.begin(), allMatchesId.end(), IndexT(0));
+        }
+        const std::vector<IndexT>& estimationMatchesId = planarMatchesIndices.empty() ? allMatchesId : planarMatchesIndices;
+
         if (iRefineStep == 0)
         {
-            computeSimilarity(seedFeatureI, seedFeatureJ, transformation);
+            computeSimilarity(featuresI.at(seedMatch._i), featuresJ.at(seedMatch._j), transformation);
             currTolerance = param._similarityTolerance;
         }
         else if (iRefineStep <= 4)
         {
-            estimateAffinity(featuresI, featuresJ, matches, transformation, planarMatchesIndices);
+            estimateAffinity(points, estimationMatchesId, transformation);
             currTolerance = param._affinityTolerance;
         }
         else
         {
-            estimateHomography(featuresI, featuresJ, matches, transformation, planarMatchesIndices);
+            estimateHomography(points, estimationMatchesId, transformation);
             currTolerance = param._homographyTolerance;
         }
 
-        findTransformationInliers(featuresI, featuresJ, matches, transformation, currTolerance, planarMatchesIndices);
+        findInliers(points, transformation, currTolerance, buffers, planarMatchesIndices);
 
         if (planarMatchesIndices.size() < param._minInliersToRefine)
             return false;
@@ -105,6 +270,25 @@ bool growHomography(const std::vector<feature::PointFeature>& featuresI,
     return !transformation.isIdentity();
 }
 
+}  // namespace
+
+bool growHomography(const std::vector<feature::PointFeature>& featuresI,
+                    const std::vector<feature::PointFeature>& featuresJ,
+                    const matching::IndMatches& matches,
+                    const IndexT& seedMatchId,
+                    std::set<IndexT>& planarMatchesIndices,
+                    Mat3& transformation,
+                    const GrowParameters& param)
+{
+    const MatchesPoints points(featuresI, featuresJ, matches);
+    GrowBuffers buffers;
+    std::vector<IndexT> planarMatches;
+
+    const bool grown = growHomography(featuresI, featuresJ, matches, points, seedMatchId, buffers, planarMatches, transformation, param);
+    planarMatchesIndices = std::set<IndexT>(planarMatches.begin(), planarMatches.end());
+    return grown;
+}
+
 void filterMatchesByHGrowing(const std::vector<feature::PointFeature>& siofeatures_I,
                              const std::vector<feature::PointFeature>& siofeatures_J,
                              const matching::IndMatches& putativeMatches,
@@ -115,57 +299,104 @@ void filterMatchesByHGrowing(const std::vector<feature::PointFeature>& siofeatur
     using namespace aliceVision::feature;
     using namespace aliceVision::matching;
 
+    // the seeds are grown in parallel by chunks and the results are merged in the seeds order,
+    // so that the output does not depend on the number of threads
+    const int seedsChunkSize = 128;
+
+    // features coordinates, converted once for the refinements of all the homographies
+    Mat2X pointsI;
+    Mat2X pointsJ;
+    feature::PointsToMat(siofeatures_I, pointsI);
+    feature::PointsToMat(siofeatures_J, pointsJ);
+
     IndMatches remainingMatches = putativeMatches;
-    GeometricFilterMatrix_HGrowing dummy;
 
     for (IndexT iH = 0; iH < param._maxNbHomographies; ++iH)
     {
-        std::set<IndexT> usedMatchesId, bestMatchesId;
-        Mat3 bestHomography;
+        // stop when the number of remaining matches is too small to support another homography
+        if (remainingMatches.size() < param._minNbMatchesPerH)
+            break;
+
+        const MatchesPoints remainingPoints(siofeatures_I, siofeatures_J, remainingMatches);
+        const int nbRemainingMatches = static_cast<int>(remainingMatches.size());
+
+        // each match is used once only per homography estimation (increases computation time) [1st improvement ([F.Srajer, 2016] p. 20) ]
+        std::vector<bool> usedMatches(nbRemainingMatches, false);
+        std::vector<IndexT> bestMatchesId;  // be careful: it contains the id. in the 'remainingMatches' vector not 'putativeMatches' vector.
+        Mat3 bestHomography = Mat3::Identity();
 
-// -- Estimate H using homography-growing approach
-#pragma omp parallel for  // (huge optimization but modify results a little)
-        for (int iMatch = 0; iMatch < remainingMatches.size(); ++iMatch)
+        std::vector<std::vector<IndexT>> chunkPlanarMatches(seedsChunkSize);
+        std::vector<Mat3> chunkHomographies(seedsChunkSize);
+        std::vector<char> chunkGrown(seedsChunkSize);
+
+        // -- Estimate H using homography-growing approach
+        for (int chunkBegin = 0; chunkBegin < nbRemainingMatches; chunkBegin += seedsChunkSize)
         {
-            // Growing a homography from one match ([F.Srajer, 2016] algo. 1, p. 20)
-            // each match is used once only per homography estimation (increases computation time) [1st improvement ([F.Srajer, 2016] p. 20) ]
-            if (usedMatchesId.find(iMatch) != usedMatchesId.end())
-                continue;
-            std::set<IndexT> planarMatchesId;  // be careful: it contains the id. in the 'remainingMatches' vector not 'putativeMatches' vector.
-            Mat3 homography;
-
-            if (!growHomography(siofeatures_I, siofeatures_J, remainingMatches, iMatch, planarMatchesId, homography, param._growParam))
+            const int chunkSize = std::min(seedsChunkSize, nbRemainingMatches - chunkBegin);
+
+#pragma omp parallel
             {
-                continue;
-            }
+                GrowBuffers buffers;
 
-#pragma omp critical
-            usedMatchesId.insert(planarMatchesId.begin(), planarMatchesId.end());
+#pragma omp for schedule(dynamic)
+                for (int k = 0; k < chunkSize; ++k)
+                {
+                    const int iMatch = chunkBegin + k;
+                    chunkGrown[k] = false;
+
+                    if (usedMatches[iMatch])
+                        continue;
+
+                    // Growing a homography from one match ([F.Srajer, 2016] algo. 1, p. 20)
+                    chunkGrown[k] = growHomography(siofeatures_I,
+                                                   siofeatures_J,
+                                                   remainingMatches,
+                                                   remainingPoints,
+                                                   iMatch,
+                                                   buffers,
+                                                   chunkPlanarMatches[k],
+                                                   chunkHomographies[k],
+                                                   param._growParam);
+                }
+            }
 
-            if (planarMatchesId.size() > bestMatchesId.size())
+            for (int k = 0; k < chunkSize; ++k)
             {
-#pragma omp critical
+                if (!chunkGrown[k])
+                    continue;
+
+                for (const IndexT id : chunkPlanarMatches[k])
+                    usedMatches[id] = true;
+
+                if (chunkPlanarMatches[k].size() > bestMatchesId.size())
                 {
-                    // if(iH == 3) { std::cout << "best iMatch" << iMatch << std::endl; }
-                    bestMatchesId =
-                      planarMatchesId;  // be careful: it contains the id. in the 'remainingMatches' vector not 'putativeMatches' vector.
-                    bestHomography = homography;
+                    bestMatchesId.swap(chunkPlanarMatches[k]);
+                    bestHomography = chunkHomographies[k];
                 }
             }
+
+            // no homography can have more inliers than all the remaining matches
+            if (bestMatchesId.size() == remainingMatches.size())
+                break;
         }  // 'iMatch'
 
+        // stop when no homography can be grown from the remaining matches
+        if (bestMatchesId.empty())
+            break;
+
         // -- Refine H using Ceres minimizer
-        refineHomography(siofeatures_I, siofeatures_J, remainingMatches, bestHomography, bestMatchesId, param._growParam._homographyTolerance);
+        std::set<IndexT> bestMatchesIdSet(bestMatchesId.begin(), bestMatchesId.end());
+        refineHomography(pointsI, pointsJ, remainingMatches, bestHomography, bestMatchesIdSet, param._growParam._homographyTolerance);
 
         // stop when the models get too small
-        if (bestMatchesId.size() < param._minNbMatchesPerH)
+        if (bestMatchesIdSet.size() < param._minNbMatchesPerH)
             break;
 
         // Store validated results:
         {
             IndMatches matches;
             Mat3 H = bestHomography;
-            for (IndexT id : bestMatchesId)
+            for (IndexT id : bestMatchesIdSet)
             {
                 matches.push_back(remainingMatches.at(id));
             }
@@ -173,23 +404,23 @@ void filterMatchesByHGrowing(const std::vector<feature::PointFeature>& siofeatur
         }
 
         // -- Update not used matches & Save geometrically verified matches
-        for (IndexT id : bestMatchesId)
+        for (IndexT id : bestMatchesIdSet)
         {
             outGeometricInliers.push_back(remainingMatches.at(id));
         }
 
         // update remaining matches (/!\ Keep ordering)
-        std::size_t cpt = 0;
-        for (IndexT id : bestMatchesId)
+        IndMatches notUsedMatches;
+        notUsedMatches.reserve(remainingMatches.size() - bestMatchesIdSet.size());
+        auto itInlier = bestMatchesIdSet.begin();
+        for (IndexT id = 0; id < remainingMatches.size(); ++id)
         {
-            remainingMatches.erase(remainingMatches.begin() + id - cpt);
-            ++cpt;
+            if (itInlier != bestMatchesIdSet.end() && *itInlier == id)
+                ++itInlier;
+            else
+                notUsedMatches.push_back(remainingMatches[id]);
         }
-
-        // stop when the number of remaining matches is too small
-        if (remainingMatches.size() < param._minNbMatchesPerH)
-            break;
-
+        remainingMatches.swap(notUsedMatches);
     }  // 'iH'
 }
 
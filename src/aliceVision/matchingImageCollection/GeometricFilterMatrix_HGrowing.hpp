@@ -113,6 +113,7 @@ struct HGrowingFilteringParam
  * @param[out] homographiesAndMatches Contains each found homography and the relevant supporting matches.
  * @param[out] outGeometricInliers All the matches that supports one of the found homographies.
  * @param[in] param The parameters of the algorithm.
+ * @note The seeds are grown in parallel by fixed size chunks, the results do not depend on the number of threads.
  */
 void filterMatchesByHGrowing(const std::vector<feature::PointFeature>& siofeatures_I,
                              const std::vector<feature::PointFeature>& siofeatures_J,
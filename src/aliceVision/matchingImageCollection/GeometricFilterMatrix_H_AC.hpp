@@ -62,6 +62,11 @@ struct GeometricFilterMatrix_H_AC : public GeometricFilterMatrix
         Mat xI, xJ;
         fillMatricesWithUndistortFeaturesMatches(pairIndex, putativeMatchesPerType, sfmData, regionsPerView, descTypes, xI, xJ);
 
+        // matches ordered by quality for PROSAC sampling
+        std::vector<std::size_t> sortedIndices;
+        if (m_useProsacSampling)
+            getMatchesSortedByDistanceRatio(putativeMatchesPerType, descTypes, sortedIndices);
+
         // define the AContrario adapted Homography matrix solver
         using KernelT = multiview::RelativePoseKernel<multiview::relativePose::Homography4PSolver,
                                                       multiview::relativePose::HomographyAsymmetricError,
@@ -81,8 +86,14 @@ struct GeometricFilterMatrix_H_AC : public GeometricFilterMatrix
 
         std::vector<std::size_t> inliers;
         robustEstimation::Mat3Model model;
-        const std::pair<double, double> ACRansacOut =
-          robustEstimation::ACRANSAC(kernel, randomNumberGenerator, inliers, m_stIteration, &model, upperBoundPrecision);
+        const std::pair<double, double> ACRansacOut = robustEstimation::ACRANSAC(kernel,
+                                                                                 randomNumberGenerator,
+                                                                                 inliers,
+                                                                                 m_stIteration,
+                                                                                 &model,
+                                                                                 upperBoundPrecision,
+                                                                                 m_stIterationWithoutModel,
+                                                                                 m_useProsacSampling ? &sortedIndices : nullptr);
         m_H = model.getMatrix();
 
         if (inliers.empty())
@@ -211,6 +222,22 @@ struct GeometricFilterMatrix_H_AC : public GeometricFilterMatrix
                     matches[descType] = localMatches;
                 }
             }
+            else if (m_keypointsGridCache)
+            {
+                // filtering based on region positions and regions descriptors,
+                // reusing the keypoints grids of the views between the pairs
+                matching::guidedMatching<robustEstimation::Mat3Model, multiview::relativePose::HomographyAsymmetricError>(
+                  model,
+                  imageIdsPair,
+                  camI,
+                  regionsPerView.getAllRegions(I),
+                  camJ,
+                  regionsPerView.getAllRegions(J),
+                  Square(m_dPrecision_robust),
+                  Square(dDistanceRatio),
+                  *m_keypointsGridCache,
+                  matches);
+            }
             else
             {
                 // filtering based on region positions and regions descriptors
@@ -10,6 +10,8 @@
 #include <aliceVision/matching/IndMatchDecorator.hpp>
 #include <aliceVision/matching/filters.hpp>
 #include <aliceVision/system/ProgressDisplay.hpp>
+#include <aliceVision/system/ResourceReport.hpp>
+#include <aliceVision/system/Tracer.hpp>
 #include <aliceVision/config.hpp>
 
 namespace aliceVision {
@@ -197,6 +199,9 @@ void ImageCollectionMatcher_cascadeHashing::Match(std::mt19937& gen,
                                                   PairwiseMatches& map_PutativesMatches  // the pairwise photometric corresponding points
 ) const
 {
+    ALICEVISION_TRACE_ZONE_CAT("ImageCollectionMatcher_cascadeHashing::Match", "featureMatching");
+    ALICEVISION_RESOURCE_PHASE("ImageCollectionMatcher_cascadeHashing::Match");
+
 #if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_OPENMP)
     ALICEVISION_LOG_DEBUG("Using the OPENMP thread interface");
 #endif
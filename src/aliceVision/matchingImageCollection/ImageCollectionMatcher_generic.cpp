@@ -12,7 +12,16 @@
 #include <aliceVision/matching/RegionsMatcher.hpp>
 #include <aliceVision/matchingImageCollection/IImageCollectionMatcher.hpp>
 #include <aliceVision/system/ProgressDisplay.hpp>
+#include <aliceVision/system/ResourceReport.hpp>
+#include <aliceVision/system/TaskScheduler.hpp>
+#include <aliceVision/system/Tracer.hpp>
 #include <aliceVision/config.hpp>
+#include <aliceVision/alicevision_omp.hpp>
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <vector>
 
 namespace aliceVision {
 namespace matchingImageCollection {
@@ -33,15 +42,19 @@ void ImageCollectionMatcher_generic::Match(std::mt19937& randomNumberGenerator,
                                            feature::EImageDescriberType descType,
                                            matching::PairwiseMatches& map_PutativesMatches) const  // the pairwise photometric corresponding points
 {
+    ALICEVISION_TRACE_ZONE_CAT("ImageCollectionMatcher_generic::Match", "featureMatching");
+    ALICEVISION_RESOURCE_PHASE("ImageCollectionMatcher_generic::Match");
+
 #if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_OPENMP)
     ALICEVISION_LOG_DEBUG("Using the OPENMP thread interface");
 #endif
+    // CASCADE_HASHING_L2 does not use OpenMP internally, so it is parallelized over chunks of pairs.
+    // The other matchers are already multithreaded over the query descriptors.
     const bool b_multithreaded_pair_search = (_matcherType == CASCADE_HASHING_L2);
-    // -> set to true for CASCADE_HASHING_L2, since OpenMP instructions are not used in this matcher
 
     auto progressDisplay = system::createConsoleProgressDisplay(pairs.size(), std::cout);
 
-    // Sort pairs according the first index to minimize the MatcherT build operations
+    // Group pairs according the first index to build the MatcherT only once per image
     typedef std::map<size_t, std::vector<size_t>> Map_vectorT;
     Map_vectorT map_Pairs;
     for (PairSet::const_iterator iter = pairs.begin(); iter != pairs.end(); ++iter)
@@ -49,24 +62,53 @@ void ImageCollectionMatcher_generic::Match(std::mt19937& randomNumberGenerator,
         map_Pairs[iter->first].push_back(iter->second);
     }
 
-    // Perform matching between all the pairs
+    // Split the largest groups in chunks to balance the work between threads,
+    // each chunk builds its own MatcherT
+    std::size_t maxChunkSize = pairs.size();
+    if (b_multithreaded_pair_search)
+        maxChunkSize = std::max<std::size_t>(1, pairs.size() / (4 * system::TaskScheduler::get().getNbThreads()));
+
+    struct PairsChunk
+    {
+        size_t I;
+        const std::vector<size_t>* indexToCompare;
+        std::size_t begin;
+        std::size_t end;
+    };
+    std::vector<PairsChunk> chunks;
     for (Map_vectorT::const_iterator iter = map_Pairs.begin(); iter != map_Pairs.end(); ++iter)
     {
-        const size_t I = iter->first;
-        const std::vector<size_t>& indexToCompare = iter->second;
+        for (std::size_t begin = 0; begin < iter->second.size(); begin += maxChunkSize)
+            chunks.push_back({iter->first, &iter->second, begin, std::min(iter->second.size(), begin + maxChunkSize)});
+    }
+
+    // Process the largest chunks first
+    std::stable_sort(chunks.begin(), chunks.end(), [](const PairsChunk& a, const PairsChunk& b) { return (a.end - a.begin) > (b.end - b.begin); });
+
+    // One random seed per chunk, so that the results do not depend on the threads scheduling
+    std::vector<std::mt19937::result_type> chunkSeeds(chunks.size());
+    for (std::size_t c = 0; c < chunks.size(); ++c)
+        chunkSeeds[c] = randomNumberGenerator();
+
+    std::mutex putativesMatchesMutex;
+
+    const auto matchChunk = [&](std::ptrdiff_t c) {
+        const PairsChunk& chunk = chunks[c];
+        const size_t I = chunk.I;
+        const std::vector<size_t>& indexToCompare = *chunk.indexToCompare;
+        std::mt19937 chunkRandomNumberGenerator(chunkSeeds[c]);
 
         const feature::Regions& regionsI = regionsPerView.getRegions(I, descType);
         if (regionsI.RegionCount() == 0)
         {
-            progressDisplay += indexToCompare.size();
-            continue;
+            progressDisplay += chunk.end - chunk.begin;
+            return;
         }
 
         // Initialize the matching interface
-        matching::RegionsDatabaseMatcher matcher(randomNumberGenerator, _matcherType, regionsI);
+        matching::RegionsDatabaseMatcher matcher(chunkRandomNumberGenerator, _matcherType, regionsI);
 
-#pragma omp parallel for schedule(dynamic) if (b_multithreaded_pair_search)
-        for (int j = 0; j < (int)indexToCompare.size(); ++j)
+        for (std::size_t j = chunk.begin; j < chunk.end; ++j)
         {
             const size_t J = indexToCompare[j];
 
@@ -83,7 +125,7 @@ void ImageCollectionMatcher_generic::Match(std::mt19937& randomNumberGenerator,
             if (_useCrossMatching)
             {
                 // Initialize the matching interface
-                matching::RegionsDatabaseMatcher matcherCross(randomNumberGenerator, _matcherType, regionsJ);
+                matching::RegionsDatabaseMatcher matcherCross(chunkRandomNumberGenerator, _matcherType, regionsJ);
 
                 IndMatches vec_putatives_matches_cross;
                 matcherCross.Match(_f_dist_ratio, regionsI, vec_putatives_matches_cross);
@@ -110,8 +152,8 @@ void ImageCollectionMatcher_generic::Match(std::mt19937& randomNumberGenerator,
                 std::swap(vec_putatives_matches, vec_putatives_matches_checked);
             }
 
-#pragma omp critical
             {
+                std::lock_guard<std::mutex> lock(putativesMatchesMutex);
                 ++progressDisplay;
                 if (!vec_putatives_matches.empty())
                 {
@@ -119,6 +161,17 @@ void ImageCollectionMatcher_generic::Match(std::mt19937& randomNumberGenerator,
                 }
             }
         }
+    };
+
+    // Perform matching between all the pairs, one chunk per task
+    if (b_multithreaded_pair_search)
+    {
+        system::parallelFor(0, static_cast<std::ptrdiff_t>(chunks.size()), 1, matchChunk);
+    }
+    else
+    {
+        for (std::ptrdiff_t c = 0; c < static_cast<std::ptrdiff_t>(chunks.size()); ++c)
+            matchChunk(c);
     }
 }
 
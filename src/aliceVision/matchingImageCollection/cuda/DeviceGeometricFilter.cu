@@ -0,0 +1,400 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "DeviceGeometricFilter.hpp"
+
+#include <cuda_runtime.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <sstream>
+#include <stdexcept>
+
+#define CHECK_GEOMETRIC_FILTER_CUDA_ERROR(err)                                                                                                       \
+    if (err != cudaSuccess)                                                                                                                          \
+    {                                                                                                                                                \
+        std::stringstream s;                                                                                                                         \
+        s << "\n  CUDA Error: " << cudaGetErrorString(err) << "\n  file:  " << __FILE__ << "\n  function:   " << __FUNCTION__                        \
+          << "\n  line:       " << __LINE__ << "\n";                                                                                                 \
+        throw std::runtime_error(s.str());                                                                                                           \
+    }
+
+namespace aliceVision {
+namespace matchingImageCollection {
+namespace cuda {
+
+/// Number of threads per block, one block per image pair
+constexpr int BLOCK_SIZE = 128;
+
+/// Maximum number of correspondences of a minimal sample (8 points fundamental matrix)
+constexpr int MAX_SAMPLE_SIZE = 8;
+
+/**
+ * @brief Integer hash (lowbias32), used as a stateless random generator.
+ */
+__device__ inline unsigned int hashRandom(unsigned int x)
+{
+    x ^= x >> 16;
+    x *= 0x7feb352dU;
+    x ^= x >> 15;
+    x *= 0x846ca68bU;
+    x ^= x >> 16;
+    return x;
+}
+
+/**
+ * @brief Draw nbSamples distinct correspondence indices in [0, n[.
+ */
+__device__ inline void drawSample(unsigned int state, int n, int nbSamples, int* sample)
+{
+    for (int k = 0; k < nbSamples; ++k)
+    {
+        bool duplicate = true;
+        while (duplicate)
+        {
+            state = hashRandom(state + 0x9e3779b9U);
+            sample[k] = static_cast<int>(state % static_cast<unsigned int>(n));
+            duplicate = false;
+            for (int j = 0; j < k; ++j)
+                duplicate |= (sample[j] == sample[k]);
+        }
+    }
+}
+
+/**
+ * @brief Solve the 9 unknowns of A.x = 0 for a 8x9 matrix of rank 8
+ *        by a Gaussian elimination with full pivoting.
+ * @return false if the matrix is rank deficient
+ */
+__device__ inline bool solveNullspace8x9(double A[8][9], double x[9])
+{
+    int columns[9];
+    for (int c = 0; c < 9; ++c)
+        columns[c] = c;
+
+    for (int k = 0; k < 8; ++k)
+    {
+        // full pivoting: largest remaining coefficient
+        int pivotRow = k;
+        int pivotColumn = k;
+        double pivotValue = 0.0;
+        for (int r = k; r < 8; ++r)
+        {
+            for (int c = k; c < 9; ++c)
+            {
+                const double v = fabs(A[r][columns[c]]);
+                if (v > pivotValue)
+                {
+                    pivotValue = v;
+                    pivotRow = r;
+                    pivotColumn = c;
+                }
+            }
+        }
+        if (pivotValue < 1e-12)
+            return false;
+
+        if (pivotRow != k)
+        {
+            for (int c = 0; c < 9; ++c)
+            {
+                const double tmp = A[k][c];
+                A[k][c] = A[pivotRow][c];
+                A[pivotRow][c] = tmp;
+            }
+        }
+        const int tmp = columns[k];
+        columns[k] = columns[pivotColumn];
+        columns[pivotColumn] = tmp;
+
+        const double pivot = A[k][columns[k]];
+        for (int r = k + 1; r < 8; ++r)
+        {
+            const double factor = A[r][columns[k]] / pivot;
+            for (int c = k; c < 9; ++c)
+                A[r][columns[c]] -= factor * A[k][columns[c]];
+        }
+    }
+
+    // the last column is the free unknown, back substitution of the others
+    x[columns[8]] = 1.0;
+    for (int k = 7; k >= 0; --k)
+    {
+        double sum = 0.0;
+        for (int c = k + 1; c < 9; ++c)
+            sum += A[k][columns[c]] * x[columns[c]];
+        x[columns[k]] = -sum / A[k][columns[k]];
+    }
+
+    double norm = 0.0;
+    for (int c = 0; c < 9; ++c)
+        norm += x[c] * x[c];
+    norm = sqrt(norm);
+    for (int c = 0; c < 9; ++c)
+        x[c] /= norm;
+    return true;
+}
+
+/**
+ * @brief Fill the linear constraints of a minimal sample on the row major model.
+ */
+__device__ inline void fillConstraints(EDeviceGeometricModel model, const float4* points, const int* sample, double A[8][9])
+{
+    if (model == EDeviceGeometricModel::HOMOGRAPHY)
+    {
+        // xJ x (H.xI) = 0, two independent rows per correspondence
+        for (int k = 0; k < 4; ++k)
+        {
+            const float4 p = points[sample[k]];
+            double* r0 = A[2 * k];
+            double* r1 = A[2 * k + 1];
+            r0[0] = 0.0;
+            r0[1] = 0.0;
+            r0[2] = 0.0;
+            r0[3] = -p.x;
+            r0[4] = -p.y;
+            r0[5] = -1.0;
+            r0[6] = p.w * p.x;
+            r0[7] = p.w * p.y;
+            r0[8] = p.w;
+            r1[0] = p.x;
+            r1[1] = p.y;
+            r1[2] = 1.0;
+            r1[3] = 0.0;
+            r1[4] = 0.0;
+            r1[5] = 0.0;
+            r1[6] = -p.z * p.x;
+            r1[7] = -p.z * p.y;
+            r1[8] = -p.z;
+        }
+    }
+    else
+    {
+        // xJ^T.F.xI = 0, one row per correspondence
+        for (int k = 0; k < 8; ++k)
+        {
+            const float4 p = points[sample[k]];
+            double* r = A[k];
+            r[0] = p.z * p.x;
+            r[1] = p.z * p.y;
+            r[2] = p.z;
+            r[3] = p.w * p.x;
+            r[4] = p.w * p.y;
+            r[5] = p.w;
+            r[6] = p.x;
+            r[7] = p.y;
+            r[8] = 1.0;
+        }
+    }
+}
+
+/**
+ * @brief Squared error of a correspondence (xI, yI, xJ, yJ) in the second image.
+ */
+__device__ inline float squaredError(EDeviceGeometricModel model, const float* m, const float4 p)
+{
+    const float a = m[0] * p.x + m[1] * p.y + m[2];
+    const float b = m[3] * p.x + m[4] * p.y + m[5];
+    const float c = m[6] * p.x + m[7] * p.y + m[8];
+
+    if (model == EDeviceGeometricModel::HOMOGRAPHY)
+    {
+        if (fabsf(c) < 1e-12f)
+            return FLT_MAX;
+        const float dx = a / c - p.z;
+        const float dy = b / c - p.w;
+        return dx * dx + dy * dy;
+    }
+
+    // distance of xJ to the epipolar line F.xI
+    const float lineNorm = a * a + b * b;
+    if (lineNorm < 1e-24f)
+        return FLT_MAX;
+    const float d = a * p.z + b * p.w + c;
+    return d * d / lineNorm;
+}
+
+/**
+ * @brief RANSAC of one image pair per block.
+ */
+__global__ void ransac_kernel(const float4* correspondences,
+                              const int* pairOffsets,
+                              const float* squaredThresholds,
+                              EDeviceGeometricModel model,
+                              int nbIterations,
+                              unsigned int seed,
+                              unsigned char* out_inlierMask,
+                              int* out_nbInliers)
+{
+    __shared__ int threadsBestCount[BLOCK_SIZE];
+    __shared__ float bestModel[9];
+    __shared__ int bestThread;
+
+    const int pairIndex = blockIdx.x;
+    const int tid = threadIdx.x;
+
+    const int begin = pairOffsets[pairIndex];
+    const int n = pairOffsets[pairIndex + 1] - begin;
+    const float4* points = correspondences + begin;
+    const float squaredThreshold = squaredThresholds[pairIndex];
+    const int nbSamples = (model == EDeviceGeometricModel::HOMOGRAPHY) ? 4 : 8;
+
+    if (n < nbSamples)
+    {
+        for (int i = tid; i < n; i += BLOCK_SIZE)
+            out_inlierMask[begin + i] = 0;
+        if (tid == 0)
+            out_nbInliers[pairIndex] = 0;
+        return;
+    }
+
+    int bestCount = 0;
+    float threadModel[9] = {0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f};
+
+    for (int iteration = tid; iteration < nbIterations; iteration += BLOCK_SIZE)
+    {
+        int sample[MAX_SAMPLE_SIZE];
+        drawSample(hashRandom(seed ^ hashRandom(static_cast<unsigned int>(pairIndex) * 0x01000193U + static_cast<unsigned int>(iteration))),
+                   n,
+                   nbSamples,
+                   sample);
+
+        double A[8][9];
+        double x[9];
+        fillConstraints(model, points, sample, A);
+        if (!solveNullspace8x9(A, x))
+            continue;
+
+        float m[9];
+        for (int c = 0; c < 9; ++c)
+            m[c] = static_cast<float>(x[c]);
+
+        int count = 0;
+        for (int i = 0; i < n; ++i)
+            count += (squaredError(model, m, points[i]) < squaredThreshold);
+
+        if (count > bestCount)
+        {
+            bestCount = count;
+            for (int c = 0; c < 9; ++c)
+                threadModel[c] = m[c];
+        }
+    }
+
+    threadsBestCount[tid] = bestCount;
+    __syncthreads();
+
+    // lowest thread index in case of tie, to be deterministic
+    if (tid == 0)
+    {
+        int best = 0;
+        for (int t = 1; t < BLOCK_SIZE; ++t)
+        {
+            if (threadsBestCount[t] > threadsBestCount[best])
+                best = t;
+        }
+        bestThread = best;
+    }
+    __syncthreads();
+
+    if (tid == bestThread)
+    {
+        for (int c = 0; c < 9; ++c)
+            bestModel[c] = threadModel[c];
+    }
+    __syncthreads();
+
+    const int pairBestCount = threadsBestCount[bestThread];
+    for (int i = tid; i < n; i += BLOCK_SIZE)
+        out_inlierMask[begin + i] = (pairBestCount > 0 && squaredError(model, bestModel, points[i]) < squaredThreshold) ? 1 : 0;
+
+    if (tid == 0)
+        out_nbInliers[pairIndex] = pairBestCount;
+}
+
+DeviceGeometricFilter::~DeviceGeometricFilter()
+{
+    // no throw in destructor
+    cudaFree(_correspondences);
+    cudaFree(_inlierMask);
+    cudaFree(_pairOffsets);
+    cudaFree(_squaredThresholds);
+    cudaFree(_nbInliers);
+}
+
+void DeviceGeometricFilter::allocate(int nbPairs, int nbCorrespondences)
+{
+    if (std::size_t(nbCorrespondences) > _correspondencesCapacity)
+    {
+        CHECK_GEOMETRIC_FILTER_CUDA_ERROR(cudaFree(_correspondences));
+        CHECK_GEOMETRIC_FILTER_CUDA_ERROR(cudaFree(_inlierMask));
+        _correspondences = nullptr;
+        _inlierMask = nullptr;
+
+        _correspondencesCapacity = nbCorrespondences;
+
+        CHECK_GEOMETRIC_FILTER_CUDA_ERROR(cudaMalloc(&_correspondences, _correspondencesCapacity * 4 * sizeof(float)));
+        CHECK_GEOMETRIC_FILTER_CUDA_ERROR(cudaMalloc(&_inlierMask, _correspondencesCapacity * sizeof(unsigned char)));
+    }
+
+    if (std::size_t(nbPairs) > _pairsCapacity)
+    {
+        CHECK_GEOMETRIC_FILTER_CUDA_ERROR(cudaFree(_pairOffsets));
+        CHECK_GEOMETRIC_FILTER_CUDA_ERROR(cudaFree(_squaredThresholds));
+        CHECK_GEOMETRIC_FILTER_CUDA_ERROR(cudaFree(_nbInliers));
+        _pairOffsets = nullptr;
+        _squaredThresholds = nullptr;
+        _nbInliers = nullptr;
+
+        _pairsCapacity = nbPairs;
+
+        CHECK_GEOMETRIC_FILTER_CUDA_ERROR(cudaMalloc(&_pairOffsets, (_pairsCapacity + 1) * sizeof(int)));
+        CHECK_GEOMETRIC_FILTER_CUDA_ERROR(cudaMalloc(&_squaredThresholds, _pairsCapacity * sizeof(float)));
+        CHECK_GEOMETRIC_FILTER_CUDA_ERROR(cudaMalloc(&_nbInliers, _pairsCapacity * sizeof(int)));
+    }
+}
+
+void DeviceGeometricFilter::filter(EDeviceGeometricModel model,
+                                   const float* correspondences,
+                                   const int* pairOffsets,
+                                   const float* squaredThresholds,
+                                   int nbPairs,
+                                   int nbIterations,
+                                   unsigned int seed,
+                                   unsigned char* inlierMask,
+                                   int* nbInliers)
+{
+    if (nbPairs < 1)
+        return;
+
+    const int nbCorrespondences = pairOffsets[nbPairs];
+
+    allocate(nbPairs, std::max(nbCorrespondences, 1));
+
+    CHECK_GEOMETRIC_FILTER_CUDA_ERROR(
+      cudaMemcpy(_correspondences, correspondences, std::size_t(nbCorrespondences) * 4 * sizeof(float), cudaMemcpyHostToDevice));
+    CHECK_GEOMETRIC_FILTER_CUDA_ERROR(cudaMemcpy(_pairOffsets, pairOffsets, std::size_t(nbPairs + 1) * sizeof(int), cudaMemcpyHostToDevice));
+    CHECK_GEOMETRIC_FILTER_CUDA_ERROR(
+      cudaMemcpy(_squaredThresholds, squaredThresholds, std::size_t(nbPairs) * sizeof(float), cudaMemcpyHostToDevice));
+
+    ransac_kernel<<<nbPairs, BLOCK_SIZE>>>(reinterpret_cast<const float4*>(_correspondences),
+                                           _pairOffsets,
+                                           _squaredThresholds,
+                                           model,
+                                           nbIterations,
+                                           seed,
+                                           _inlierMask,
+                                           _nbInliers);
+
+    CHECK_GEOMETRIC_FILTER_CUDA_ERROR(cudaGetLastError());
+
+    CHECK_GEOMETRIC_FILTER_CUDA_ERROR(cudaMemcpy(inlierMask, _inlierMask, std::size_t(nbCorrespondences) * sizeof(unsigned char), cudaMemcpyDeviceToHost));
+    CHECK_GEOMETRIC_FILTER_CUDA_ERROR(cudaMemcpy(nbInliers, _nbInliers, std::size_t(nbPairs) * sizeof(int), cudaMemcpyDeviceToHost));
+}
+
+}  // namespace cuda
+}  // namespace matchingImageCollection
+}  // namespace aliceVision
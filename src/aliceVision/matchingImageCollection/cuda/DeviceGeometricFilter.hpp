@@ -0,0 +1,89 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <cstddef>
+
+namespace aliceVision {
+namespace matchingImageCollection {
+namespace cuda {
+
+/**
+ * @brief Geometric model estimated on the device.
+ */
+enum class EDeviceGeometricModel
+{
+    FUNDAMENTAL = 0,  //< 8 points linear fundamental matrix, point to epipolar line distance in the second image
+    HOMOGRAPHY        //< 4 points homography, transfer distance in the second image
+};
+
+/**
+ * @class DeviceGeometricFilter
+ * @brief Fixed threshold RANSAC of many image pairs at once on the GPU.
+ *
+ * Each image pair is processed by one block: the threads draw and score strided
+ * subsets of the hypotheses, then the best hypothesis of the block gives the inliers mask.
+ * The models are not refined: the output is meant to be a geometric pre-filter of
+ * the putative matches before the usual robust estimation.
+ *
+ * The samples only depend on the seed, the pair index and the iteration index,
+ * so the results do not depend on the device scheduling.
+ */
+class DeviceGeometricFilter
+{
+  public:
+    DeviceGeometricFilter() = default;
+    ~DeviceGeometricFilter();
+
+    // no copy
+    DeviceGeometricFilter(const DeviceGeometricFilter&) = delete;
+    DeviceGeometricFilter& operator=(const DeviceGeometricFilter&) = delete;
+
+    /**
+     * @brief Estimate the given model for each pair and compute its inliers.
+     * @param[in] model The geometric model to estimate
+     * @param[in] correspondences The host correspondences of all the pairs (xI, yI, xJ, yJ per correspondence)
+     * @param[in] pairOffsets The host offsets of the first correspondence of each pair (nbPairs + 1)
+     * @param[in] squaredThresholds The host squared inlier threshold of each pair (nbPairs)
+     * @param[in] nbPairs The number of image pairs
+     * @param[in] nbIterations The number of hypotheses per pair
+     * @param[in] seed The random seed of the samples
+     * @param[out] inlierMask The host inliers mask of all the correspondences (1 for an inlier)
+     * @param[out] nbInliers The host number of inliers of each pair (nbPairs)
+     */
+    void filter(EDeviceGeometricModel model,
+                const float* correspondences,
+                const int* pairOffsets,
+                const float* squaredThresholds,
+                int nbPairs,
+                int nbIterations,
+                unsigned int seed,
+                unsigned char* inlierMask,
+                int* nbInliers);
+
+  private:
+    /**
+     * @brief Ensure that the device buffers can hold the given number of pairs and correspondences.
+     * @param[in] nbPairs The number of image pairs
+     * @param[in] nbCorrespondences The total number of correspondences
+     */
+    void allocate(int nbPairs, int nbCorrespondences);
+
+    // input and output buffers, reused between calls
+    float* _correspondences = nullptr;
+    unsigned char* _inlierMask = nullptr;
+    std::size_t _correspondencesCapacity = 0;  //< in number of correspondences
+
+    int* _pairOffsets = nullptr;
+    float* _squaredThresholds = nullptr;
+    int* _nbInliers = nullptr;
+    std::size_t _pairsCapacity = 0;
+};
+
+}  // namespace cuda
+}  // namespace matchingImageCollection
+}  // namespace aliceVision
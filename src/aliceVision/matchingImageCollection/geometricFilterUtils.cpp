@@ -7,6 +7,9 @@
 #include "geometricFilterUtils.hpp"
 #include <ceres/ceres.h>
 
+#include <algorithm>
+#include <numeric>
+
 namespace aliceVision {
 namespace matchingImageCollection {
 
@@ -36,6 +39,27 @@ void copyInlierMatches(const std::vector<size_t>& inliers,
     }
 }
 
+void getMatchesSortedByDistanceRatio(const matching::MatchesPerDescType& putativeMatchesPerType,
+                                     const std::vector<feature::EImageDescriberType>& descTypes,
+                                     std::vector<std::size_t>& out_sortedIndices)
+{
+    std::vector<float> distanceRatios;
+    distanceRatios.reserve(putativeMatchesPerType.getNbAllMatches());
+    for (const auto& descType : descTypes)
+    {
+        if (!putativeMatchesPerType.count(descType))
+            continue;
+        for (const matching::IndMatch& match : putativeMatchesPerType.at(descType))
+            distanceRatios.push_back(match._distanceRatio);
+    }
+
+    out_sortedIndices.resize(distanceRatios.size());
+    std::iota(out_sortedIndices.begin(), out_sortedIndices.end(), 0);
+    std::stable_sort(out_sortedIndices.begin(), out_sortedIndices.end(), [&](std::size_t a, std::size_t b) {
+        return distanceRatios[a] < distanceRatios[b];
+    });
+}
+
 void centerMatrix(const Eigen::Matrix2Xf& points2d, Mat3& t)
 {
     t = Mat3::Identity();
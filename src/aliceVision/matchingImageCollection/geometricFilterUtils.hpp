@@ -164,6 +164,17 @@ void copyInlierMatches(const std::vector<size_t>& inliers,
                        const std::vector<feature::EImageDescriberType>& descTypes,
                        matching::MatchesPerDescType& out_geometricInliersPerType);
 
+/**
+ * @brief Get the indices of the matches (in the order used by fillMatricesWithUndistortFeaturesMatches)
+ * sorted by increasing distance ratio, i.e. from the most to the least distinctive match.
+ * @param[in] putativeMatchesPerType
+ * @param[in] descTypes
+ * @param[out] out_sortedIndices
+ */
+void getMatchesSortedByDistanceRatio(const matching::MatchesPerDescType& putativeMatchesPerType,
+                                     const std::vector<feature::EImageDescriberType>& descTypes,
+                                     std::vector<std::size_t>& out_sortedIndices);
+
 /**
  * @brief Compute the transformation that standardize the input points so that
  * they are z-scores (i.e. zero mean and unit standard deviation).
@@ -37,6 +37,12 @@ std::unique_ptr<IImageCollectionMatcher> createImageCollectionMatcher(matching::
         case matching::BRUTE_FORCE_HAMMING:
             matcherPtr.reset(new ImageCollectionMatcher_generic(distRatio, crossMatching, matching::BRUTE_FORCE_HAMMING));
             break;
+        case matching::BRUTE_FORCE_L2_CUDA:
+            matcherPtr.reset(new ImageCollectionMatcher_generic(distRatio, crossMatching, matching::BRUTE_FORCE_L2_CUDA));
+            break;
+        case matching::PRODUCT_QUANTIZATION_L2:
+            matcherPtr.reset(new ImageCollectionMatcher_generic(distRatio, crossMatching, matching::PRODUCT_QUANTIZATION_L2));
+            break;
 
         default:
             throw std::out_of_range("Invalid matcherType enum");
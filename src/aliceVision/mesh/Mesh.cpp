@@ -7,7 +7,9 @@
 #include "Mesh.hpp"
 #include <aliceVision/system/Logger.hpp>
 #include <aliceVision/utils/filesIO.hpp>
+#include <aliceVision/mesh/meshIO.hpp>
 #include <aliceVision/mesh/meshVisibility.hpp>
+#include <aliceVision/mesh/spatialOrder.hpp>
 #include <aliceVision/mvsData/geometry.hpp>
 #include <aliceVision/mvsData/OrientedPoint.hpp>
 #include <aliceVision/mvsData/Pixel.hpp>
@@ -23,6 +25,7 @@
 #include <assimp/scene.h>
 #include <Eigen/Dense>
 
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
 #include <list>
@@ -48,6 +51,8 @@ std::string EFileType_enumToString(const EFileType meshFileType)
             return "stl";
         case EFileType::GLTF:
             return "gltf";
+        case EFileType::PLY:
+            return "ply";
     }
     throw std::out_of_range("Unrecognized EMeshFileType");
 }
@@ -65,6 +70,8 @@ EFileType EFileType_stringToEnum(const std::string& meshFileType)
         return EFileType::STL;
     if (m == "gltf")
         return EFileType::GLTF;
+    if (m == "ply")
+        return EFileType::PLY;
     throw std::out_of_range("Invalid mesh file type " + meshFileType);
 }
 
@@ -79,74 +86,87 @@ std::istream& operator>>(std::istream& in, EFileType& meshFileType)
 void Mesh::save(const std::string& filepath)
 {
     const std::string fileTypeStr = std::filesystem::path(filepath).extension().string().substr(1);
+    if (boost::to_lower_copy(fileTypeStr) == "bin")
+    {
+        saveToBin(filepath);
+        return;
+    }
+
     const EFileType fileType = mesh::EFileType_stringToEnum(fileTypeStr);
 
     ALICEVISION_LOG_INFO("Save " << fileTypeStr << " mesh file");
 
-    aiScene scene;
+    // the OBJ and PLY files are streamed directly, without building an Assimp scene
+    if (fileType == EFileType::OBJ)
+    {
+        writeObj(filepath, *this);
+    }
+    else if (fileType == EFileType::PLY)
+    {
+        writePly(filepath, *this);
+    }
+    else
+    {
+        aiScene scene;
 
-    scene.mRootNode = new aiNode;
+        scene.mRootNode = new aiNode;
 
-    scene.mMeshes = new aiMesh*[1];
-    scene.mNumMeshes = 1;
-    scene.mRootNode->mMeshes = new unsigned int[1];
-    scene.mRootNode->mNumMeshes = 1;
+        scene.mMeshes = new aiMesh*[1];
+        scene.mNumMeshes = 1;
+        scene.mRootNode->mMeshes = new unsigned int[1];
+        scene.mRootNode->mNumMeshes = 1;
 
-    scene.mMaterials = new aiMaterial*[1];
-    scene.mNumMaterials = 1;
-    scene.mMaterials[0] = new aiMaterial;
+        scene.mMaterials = new aiMaterial*[1];
+        scene.mNumMaterials = 1;
+        scene.mMaterials[0] = new aiMaterial;
 
-    scene.mRootNode->mMeshes[0] = 0;
-    scene.mMeshes[0] = new aiMesh;
-    aiMesh* aimesh = scene.mMeshes[0];
-    aimesh->mMaterialIndex = 0;
+        scene.mRootNode->mMeshes[0] = 0;
+        scene.mMeshes[0] = new aiMesh;
+        aiMesh* aimesh = scene.mMeshes[0];
+        aimesh->mMaterialIndex = 0;
 
-    aimesh->mNumVertices = pts.size();
-    aimesh->mVertices = new aiVector3D[pts.size()];
+        aimesh->mNumVertices = pts.size();
+        aimesh->mVertices = new aiVector3D[pts.size()];
 
-    int index = 0;
-    for (const auto& p : pts)
-    {
-        aimesh->mVertices[index].x = p.x;
-        aimesh->mVertices[index].y = -p.y;
-        aimesh->mVertices[index].z = -p.z;
+        int index = 0;
+        for (const auto& p : pts)
+        {
+            aimesh->mVertices[index].x = p.x;
+            aimesh->mVertices[index].y = -p.y;
+            aimesh->mVertices[index].z = -p.z;
 
-        ++index;
-    }
+            ++index;
+        }
 
-    aimesh->mNumFaces = tris.size();
-    aimesh->mFaces = new aiFace[tris.size()];
+        aimesh->mNumFaces = tris.size();
+        aimesh->mFaces = new aiFace[tris.size()];
 
-    for (int i = 0; i < tris.size(); ++i)
-    {
-        aimesh->mFaces[i].mNumIndices = 3;
-        aimesh->mFaces[i].mIndices = new unsigned int[3];
+        for (int i = 0; i < tris.size(); ++i)
+        {
+            aimesh->mFaces[i].mNumIndices = 3;
+            aimesh->mFaces[i].mIndices = new unsigned int[3];
 
-        for (int k = 0; k < 3; ++k)
+            for (int k = 0; k < 3; ++k)
+            {
+                aimesh->mFaces[i].mIndices[k] = tris[i].v[k];
+            }
+        }
+
+        std::string formatId = fileTypeStr;
+        unsigned int pPreprocessing = 0u;
+        // If gltf, use gltf 2.0
+        if (fileType == EFileType::GLTF)
         {
-            aimesh->mFaces[i].mIndices[k] = tris[i].v[k];
+            formatId = "gltf2";
+            // gen normals in order to have correct shading in Qt 3D Scene
+            // but cause problems with assimp importer
+            pPreprocessing |= aiProcess_GenNormals;
         }
-    }
 
-    std::string formatId = fileTypeStr;
-    unsigned int pPreprocessing = 0u;
-    // If gltf, use gltf 2.0
-    if (fileType == EFileType::GLTF)
-    {
-        formatId = "gltf2";
-        // gen normals in order to have correct shading in Qt 3D Scene
-        // but cause problems with assimp importer
-        pPreprocessing |= aiProcess_GenNormals;
-    }
-    // If obj, do not use material
-    else if (fileType == EFileType::OBJ)
-    {
-        formatId = "objnomtl";
+        Assimp::Exporter exporter;
+        exporter.Export(&scene, formatId, filepath, pPreprocessing);
     }
 
-    Assimp::Exporter exporter;
-    exporter.Export(&scene, formatId, filepath, pPreprocessing);
-
     ALICEVISION_LOG_INFO("Save mesh to " << fileTypeStr << " done.");
 
     ALICEVISION_LOG_DEBUG("Vertices: " << pts.size());
@@ -155,51 +175,13 @@ void Mesh::save(const std::string& filepath)
     ALICEVISION_LOG_DEBUG("Normals: " << normals.size());
 }
 
-bool Mesh::loadFromBin(const std::string& binFilepath)
-{
-    FILE* f = fopen(binFilepath.c_str(), "rb");
-
-    if (f == nullptr)
-        return false;
-
-    int npts;
-    fread(&npts, sizeof(int), 1, f);
-    pts = StaticVector<Point3d>();
-    pts.resize(npts);
-    fread(&pts[0], sizeof(Point3d), npts, f);
-
-    int ntris;
-    fread(&ntris, sizeof(int), 1, f);
-    tris = StaticVector<Mesh::triangle>();
-    tris.resize(ntris);
-    fread(&tris[0], sizeof(Mesh::triangle), ntris, f);
-
-    fclose(f);
-    return true;
-}
+bool Mesh::loadFromBin(const std::string& binFilepath) { return readBinaryMesh(binFilepath, *this); }
 
 void Mesh::saveToBin(const std::string& binFilepath)
 {
     long t = std::clock();
     ALICEVISION_LOG_DEBUG("Save mesh to bin.");
-    // printf("open\n");
-    FILE* f = fopen(binFilepath.c_str(), "wb");
-
-    int npts = pts.size();
-    // printf("write npts %i\n",npts);
-    fwrite(&npts, sizeof(int), 1, f);
-    // printf("write pts\n");
-    fwrite(&pts[0], sizeof(Point3d), npts, f);
-
-    int ntris = tris.size();
-    // printf("write ntris %i\n",ntris);
-    fwrite(&ntris, sizeof(int), 1, f);
-    // printf("write tris\n");
-    fwrite(&tris[0], sizeof(Mesh::triangle), ntris, f);
-
-    // printf("close\n");
-    fclose(f);
-    // printf("done\n");
+    writeBinaryMesh(binFilepath, *this);
     mvsUtils::printfElapsedTime(t, "Save mesh to bin ");
 }
 
@@ -537,56 +519,58 @@ bool Mesh::doesTriangleIntersectsRectangle(Mesh::triangle_proj& tp, Mesh::rectan
     */
 }
 
-void Mesh::getPtsNeighborTriangles(StaticVector<StaticVector<int>>& out_ptsNeighTris) const
+void Mesh::getPtsNeighborTriangles(std::vector<int>& out_offsets, std::vector<int>& out_trisIds) const
 {
-    // array of tuples <x: vertexIndex, y: triangleIndex, z: numberOfNeighbors>
-    StaticVector<Voxel> vertexNeighborhoodPairs;
-    vertexNeighborhoodPairs.reserve(tris.size() * 3);
-    for (int i = 0; i < tris.size(); ++i)
+    const int nbPts = pts.size();
+    const int nbTris = tris.size();
+
+    // count the triangles of each vertex
+    std::vector<int> nbNeighbors(nbPts, 0);
+
+#pragma omp parallel for
+    for (int i = 0; i < nbTris; ++i)
     {
-        vertexNeighborhoodPairs.push_back(Voxel(tris[i].v[0], i, 0));
-        vertexNeighborhoodPairs.push_back(Voxel(tris[i].v[1], i, 0));
-        vertexNeighborhoodPairs.push_back(Voxel(tris[i].v[2], i, 0));
+        for (int k = 0; k < 3; ++k)
+            boost::atomic_ref<int>{nbNeighbors[tris[i].v[k]]}.fetch_add(1);
     }
-    qsort(&vertexNeighborhoodPairs[0], vertexNeighborhoodPairs.size(), sizeof(Voxel), qSortCompareVoxelByXAsc);
 
-    int i = 0;  // index of the unique pair of <vertex, neighborhood>
-    int j = 0;  // index of the vertex
-    int k = 0;  // number of neighbors
-    int firstid = 0;
-    while (i < vertexNeighborhoodPairs.size())
+    out_offsets.resize(nbPts + 1);
+    out_offsets[0] = 0;
+    for (int i = 0; i < nbPts; ++i)
+        out_offsets[i + 1] = out_offsets[i] + nbNeighbors[i];
+
+    // fill the rows, the cursors starting at the row offsets
+    out_trisIds.resize(out_offsets[nbPts]);
+    std::copy(out_offsets.begin(), out_offsets.end() - 1, nbNeighbors.begin());
+
+#pragma omp parallel for
+    for (int i = 0; i < nbTris; ++i)
     {
-        ++k;
-        // (*vertexNeighborhoodPairs)[i].z = j;
-        if ((i == vertexNeighborhoodPairs.size() - 1) || (vertexNeighborhoodPairs[i].x != vertexNeighborhoodPairs[i + 1].x))
+        for (int k = 0; k < 3; ++k)
         {
-            vertexNeighborhoodPairs[firstid].z = k;  // store the number of neighbors
-            ++j;
-            firstid = i + 1;
-            k = 0;
+            const int pos = boost::atomic_ref<int>{nbNeighbors[tris[i].v[k]]}.fetch_add(1);
+            out_trisIds[pos] = i;
         }
-        ++i;
     }
-    int npts = j;
 
-    out_ptsNeighTris.reserve(pts.size());
+    // sort each row so that the result doesn't depend on the threads scheduling
+#pragma omp parallel for schedule(dynamic, 1024)
+    for (int i = 0; i < nbPts; ++i)
+        std::sort(out_trisIds.begin() + out_offsets[i], out_trisIds.begin() + out_offsets[i + 1]);
+}
+
+void Mesh::getPtsNeighborTriangles(StaticVector<StaticVector<int>>& out_ptsNeighTris) const
+{
+    std::vector<int> offsets;
+    std::vector<int> trisIds;
+    getPtsNeighborTriangles(offsets, trisIds);
+
     out_ptsNeighTris.resize(pts.size());
 
-    i = 0;
-    for (j = 0; j < npts; ++j)
+#pragma omp parallel for schedule(dynamic, 1024)
+    for (int i = 0; i < pts.size(); ++i)
     {
-        int middlePtId = vertexNeighborhoodPairs[i].x;
-        int nbNeighbors = vertexNeighborhoodPairs[i].z;
-        int i0 = i;
-        int i1 = i + nbNeighbors;
-        i = i1;
-
-        StaticVector<int>& triTmp = out_ptsNeighTris[middlePtId];
-        triTmp.reserve(nbNeighbors);
-        for (int l = i0; l < i1; ++l)
-        {
-            triTmp.push_back(vertexNeighborhoodPairs[l].y);  // index of triangle
-        }
+        out_ptsNeighTris[i].getDataWritable().assign(trisIds.begin() + offsets[i], trisIds.begin() + offsets[i + 1]);
     }
 }
 
@@ -610,17 +594,22 @@ void Mesh::getPtsNeighbors(std::vector<std::vector<int>>& out_ptsNeigh) const
 
 void Mesh::getPtsNeighPtsOrdered(StaticVector<StaticVector<int>>& out_ptsNeighPts) const
 {
-    StaticVector<StaticVector<int>> ptsNeighborTriangles;
-    getPtsNeighborTriangles(ptsNeighborTriangles);
+    std::vector<int> offsets;
+    std::vector<int> trisIds;
+    getPtsNeighborTriangles(offsets, trisIds);
 
     out_ptsNeighPts.resize(pts.size());
 
+    // each vertex only writes its own ring
+#pragma omp parallel for schedule(dynamic, 1024)
     for (int middlePtId = 0; middlePtId < pts.size(); ++middlePtId)
     {
-        StaticVector<int>& neighborTriangles = ptsNeighborTriangles[middlePtId];
-        if (neighborTriangles.empty())
+        if (offsets[middlePtId] == offsets[middlePtId + 1])
             continue;
 
+        StaticVector<int> neighborTriangles;
+        neighborTriangles.getDataWritable().assign(trisIds.begin() + offsets[middlePtId], trisIds.begin() + offsets[middlePtId + 1]);
+
         StaticVector<int> vhid;
         vhid.reserve(neighborTriangles.size() * 2);
         int currentTriPtId = tris[neighborTriangles[0]].v[0];
@@ -1210,12 +1199,14 @@ void Mesh::getNotOrientedEdges(StaticVector<StaticVector<int>>& edgesNeighTris,
 
 void Mesh::getLaplacianSmoothingVectors(StaticVector<StaticVector<int>>& ptsNeighPts, StaticVector<Point3d>& out_nms, double maximalNeighDist)
 {
-    out_nms.reserve(pts.size());
+    out_nms.resize(pts.size());
 
+    // the vectors are all computed from the current positions before being applied (Jacobi update)
+#pragma omp parallel for
     for (int i = 0; i < pts.size(); ++i)
     {
-        Point3d& p = pts[i];
-        StaticVector<int>& nei = ptsNeighPts[i];
+        const Point3d& p = pts[i];
+        const StaticVector<int>& nei = ptsNeighPts[i];
         int nneighs = 0;
         if (!nei.empty())
         {
@@ -1224,7 +1215,7 @@ void Mesh::getLaplacianSmoothingVectors(StaticVector<StaticVector<int>>& ptsNeig
 
         if (nneighs == 0)
         {
-            out_nms.push_back(Point3d(0.0, 0.0, 0.0));
+            out_nms[i] = Point3d(0.0, 0.0, 0.0);
         }
         else
         {
@@ -1260,7 +1251,7 @@ void Mesh::getLaplacianSmoothingVectors(StaticVector<StaticVector<int>>& ptsNeig
                 n = Point3d(0.0, 0.0, 0.0);
             }
 
-            out_nms.push_back(n);
+            out_nms[i] = n;
         }
     }
 }
@@ -1278,6 +1269,7 @@ void Mesh::laplacianSmoothPts(StaticVector<StaticVector<int>>& ptsNeighPts, doub
     getLaplacianSmoothingVectors(ptsNeighPts, nms, maximalNeighDist);
 
     // smooth
+#pragma omp parallel for
     for (int i = 0; i < pts.size(); ++i)
     {
         pts[i] = pts[i] + nms[i];
@@ -1320,9 +1312,10 @@ void Mesh::computeNormalsForPts(StaticVector<StaticVector<int>>& ptsNeighTris, S
     out_nms.reserve(pts.size());
     out_nms.resize_with(pts.size(), Point3d(0.0f, 0.0f, 0.0f));
 
+#pragma omp parallel for
     for (int i = 0; i < pts.size(); ++i)
     {
-        StaticVector<int>& triTmp = ptsNeighTris[i];
+        const StaticVector<int>& triTmp = ptsNeighTris[i];
         if (!triTmp.empty())
         {
             Point3d n = Point3d(0.0f, 0.0f, 0.0f);
@@ -1352,12 +1345,16 @@ void Mesh::computeNormalsForPts(StaticVector<StaticVector<int>>& ptsNeighTris, S
 
 void Mesh::smoothNormals(StaticVector<Point3d>& nms, StaticVector<StaticVector<int>>& ptsNeighPts)
 {
+    // average the input normals (Jacobi update), so the result doesn't depend on the vertices order
+    const StaticVector<Point3d> inNms = nms;
+
+#pragma omp parallel for
     for (int i = 0; i < pts.size(); ++i)
     {
         Point3d& n = nms[i];
         for (int j = 0; j < sizeOfStaticVector<int>(ptsNeighPts[i]); ++j)
         {
-            n = n + nms[ptsNeighPts[i][j]];
+            n = n + inNms[ptsNeighPts[i][j]];
         }
         if (sizeOfStaticVector<int>(ptsNeighPts[i]) > 0)
         {
@@ -1391,6 +1388,59 @@ void Mesh::removeFreePointsFromMesh(StaticVector<int>& out_ptIdToNewPtId)
     std::swap(cleanedMesh._colors, _colors);
 }
 
+void Mesh::reorderSpatially(StaticVector<int>& out_ptIdToNewPtId)
+{
+    ALICEVISION_LOG_INFO("Reorder mesh spatially.");
+
+    // vertices
+    std::vector<int> ptsOrder;
+    computeMortonOrder(pts.getData().data(), pts.size(), ptsOrder);
+
+    std::vector<int> newPtIds;
+    invertOrder(ptsOrder, newPtIds);
+
+    applyOrder(ptsOrder, pts);
+    if (_colors.size() == ptsOrder.size())
+        applyOrder(ptsOrder, _colors);
+    if (pointsVisibilities.size() == ptsOrder.size())
+        applyOrder(ptsOrder, pointsVisibilities);
+    if (trisNormalsIds.empty() && normals.size() == ptsOrder.size())
+        applyOrder(ptsOrder, normals);
+    if (trisUvIds.empty() && uvCoords.size() == ptsOrder.size())
+        applyOrder(ptsOrder, uvCoords);
+
+    // triangles, by their smallest new vertex id
+    std::vector<std::pair<int, int>> trisKeys(tris.size());
+#pragma omp parallel for
+    for (int i = 0; i < tris.size(); ++i)
+    {
+        triangle& t = tris[i];
+        for (int k = 0; k < 3; ++k)
+        {
+            t.v[k] = newPtIds[t.v[k]];
+        }
+        trisKeys[i] = {std::min({t.v[0], t.v[1], t.v[2]}), i};
+    }
+    std::sort(trisKeys.begin(), trisKeys.end());
+
+    std::vector<int> trisOrder(trisKeys.size());
+    for (std::size_t i = 0; i < trisKeys.size(); ++i)
+    {
+        trisOrder[i] = trisKeys[i].second;
+    }
+
+    applyOrder(trisOrder, tris);
+    if (trisUvIds.size() == trisOrder.size())
+        applyOrder(trisOrder, trisUvIds);
+    if (trisNormalsIds.size() == trisOrder.size())
+        applyOrder(trisOrder, trisNormalsIds);
+    if (_trisMtlIds.size() == trisOrder.size())
+        applyOrder(trisOrder, _trisMtlIds);
+
+    out_ptIdToNewPtId.resize(newPtIds.size());
+    std::copy(newPtIds.begin(), newPtIds.end(), out_ptIdToNewPtId.begin());
+}
+
 double Mesh::computeTriangleProjectionArea(const triangle_proj& tp) const
 {
     // return (float)((tp.rd.x-tp.lu.x+1)*(tp.rd.y-tp.lu.y+1));
@@ -1659,6 +1709,14 @@ void subdivideTriangle(const Mesh& mesh,
 }  // namespace subdiv
 
 int Mesh::subdivideMesh(const Mesh& refMesh, float ratioSubdiv, bool remapVisibilities)
+{
+    GEO::AdaptiveKdTree refMesh_kdTree(3);
+    refMesh_kdTree.set_points(refMesh.pts.size(), refMesh.pts.front().m);
+
+    return subdivideMesh(refMesh, refMesh_kdTree, ratioSubdiv, remapVisibilities);
+}
+
+int Mesh::subdivideMesh(const Mesh& refMesh, const GEO::AdaptiveKdTree& refMesh_kdTree, float ratioSubdiv, bool remapVisibilities)
 {
     ALICEVISION_LOG_INFO("Subdivide mesh.");
     ALICEVISION_LOG_INFO("nb pts init: " << pts.size());
@@ -1668,9 +1726,6 @@ int Mesh::subdivideMesh(const Mesh& refMesh, float ratioSubdiv, bool remapVisibi
     ALICEVISION_LOG_INFO("nb points in refMesh: " << refMesh.pts.size());
     ALICEVISION_LOG_INFO("targetNbPts: " << targetNbPts);
 
-    GEO::AdaptiveKdTree refMesh_kdTree(3);
-    refMesh_kdTree.set_points(refMesh.pts.size(), refMesh.pts.front().m);
-
     int nbAllSubdiv = 0;
     int nsubd = 0;
     while (pts.size() < targetNbPts)
@@ -1698,6 +1753,7 @@ int Mesh::subdivideMesh(const Mesh& refMesh, float ratioSubdiv, bool remapVisibi
     if (remapVisibilities)
     {
         pointsVisibilities.resize(pts.size());
+#pragma omp parallel for
         for (int i = 0; i < pts.size(); ++i)
         {
             int iRef = refMesh_kdTree.get_nearest_neighbor(pts[i].m);
@@ -1852,6 +1908,7 @@ double Mesh::computeAverageEdgeLength() const
 {
     double s = 0.0;
     double n = 0.0;
+#pragma omp parallel for reduction(+ : s, n)
     for (int i = 0; i < tris.size(); ++i)
     {
         s += computeTriangleMaxEdgeLength(i);
@@ -2364,6 +2421,29 @@ void Mesh::load(const std::string& filepath, bool mergeCoincidentVerts, Material
         ALICEVISION_THROW_ERROR("Mesh::load: no such file: " << filepath);
     }
 
+    const std::string extension = boost::to_lower_copy(std::filesystem::path(filepath).extension().string());
+    if (extension == ".bin")
+    {
+        if (!loadFromBin(filepath))
+        {
+            ALICEVISION_THROW_ERROR("Failed loading mesh from file: " << filepath);
+        }
+        ALICEVISION_LOG_DEBUG("Vertices: " << pts.size());
+        ALICEVISION_LOG_DEBUG("Triangles: " << tris.size());
+        return;
+    }
+
+    // the OBJ and PLY files without texture coordinates nor materials are parsed directly into the mesh,
+    // without an intermediate Assimp scene
+    if (material == nullptr && !mergeCoincidentVerts &&
+        ((extension == ".obj" && readObj(filepath, *this)) || (extension == ".ply" && readPly(filepath, *this))))
+    {
+        ALICEVISION_LOG_DEBUG("Vertices: " << pts.size());
+        ALICEVISION_LOG_DEBUG("Triangles: " << tris.size());
+        ALICEVISION_LOG_DEBUG("Num Materials: " + std::to_string(nmtls));
+        return;
+    }
+
     // see https://github.com/assimp/assimp/blob/master/include/assimp/postprocess.h#L85
     const unsigned int pFlags =
       // If this flag is not specified, no vertices are referenced by more than one face
@@ -50,7 +50,8 @@ enum class EFileType
     OBJ = 0,
     FBX,
     GLTF,
-    STL
+    STL,
+    PLY
 };
 
 EFileType EFileType_stringToEnum(const std::string& filetype);
@@ -198,6 +199,13 @@ class Mesh
                      int h);
 
     void getPtsNeighbors(std::vector<std::vector<int>>& out_ptsNeighTris) const;
+    /**
+     * @brief Get the neighbor triangles of each vertex as a compressed sparse row adjacency, built in parallel.
+     *        The triangles of the vertex i are out_trisIds[out_offsets[i]] to out_trisIds[out_offsets[i + 1] - 1], sorted ascending.
+     * @param[out] out_offsets the row offsets, of size pts.size() + 1
+     * @param[out] out_trisIds the triangle ids of all the rows
+     */
+    void getPtsNeighborTriangles(std::vector<int>& out_offsets, std::vector<int>& out_trisIds) const;
     void getPtsNeighborTriangles(StaticVector<StaticVector<int>>& out_ptsNeighTris) const;
     void getPtsNeighPtsOrdered(StaticVector<StaticVector<int>>& out_ptsNeighTris) const;
 
@@ -246,6 +254,15 @@ class Mesh
 
     void removeFreePointsFromMesh(StaticVector<int>& out_ptIdToNewPtId);
 
+    /**
+     * @brief Sort the vertices in Morton order and the triangles by their first vertex,
+     *        so that the neighborhood operations access close memory.
+     *        The per-vertex data (colors, visibilities and per-vertex normals or UVs) and the per-triangle data
+     *        (UV and normal ids, material ids) are permuted consistently.
+     * @param[out] out_ptIdToNewPtId the new index of each vertex
+     */
+    void reorderSpatially(StaticVector<int>& out_ptIdToNewPtId);
+
     void letJustTringlesIdsInMesh(StaticVector<int>& trisIdsToStay);
     void letJustTringlesIdsInMesh(const StaticVectorBool& trisToStay);
 
@@ -274,6 +291,7 @@ class Mesh
     Point2d getTrianglePixelInternalPoint(Mesh::triangle_proj& tp, Mesh::rectangle& re);
 
     int subdivideMesh(const Mesh& refMesh, float ratioSubdiv, bool remapVisibilities);
+    int subdivideMesh(const Mesh& refMesh, const GEO::AdaptiveKdTree& refMesh_kdTree, float ratioSubdiv, bool remapVisibilities);
     int subdivideMeshOnce(const Mesh& refMesh, const GEO::AdaptiveKdTree& refMesh_kdTree, float ratioSubdiv);
 
     void computeTrisCams(StaticVector<StaticVector<int>>& trisCams, const mvsUtils::MultiViewParams& mp, const std::string tmpDir);
@@ -7,6 +7,9 @@
 #include "MeshClean.hpp"
 #include <aliceVision/system/Logger.hpp>
 
+#include <algorithm>
+#include <tuple>
+
 namespace aliceVision {
 namespace mesh {
 
@@ -633,15 +636,8 @@ void MeshClean::init()
 {
     deallocateCleaningAttributes();
 
+    // the rows of the adjacency are already sorted ascending
     getPtsNeighborTriangles(ptsNeighTrisSortedAsc);
-    for (int i = 0; i < pts.size(); i++)
-    {
-        StaticVector<int>& ptNeigTris = ptsNeighTrisSortedAsc[i];
-        if (sizeOfStaticVector<int>(ptNeigTris) > 1)
-        {
-            qsort(&ptNeigTris[0], ptNeigTris.size(), sizeof(int), qSortCompareIntAsc);
-        }
-    }
 
     ptsNeighPtsOrdered.reserve(pts.size());
     ptsNeighPtsOrdered.resize(pts.size());
@@ -657,32 +653,31 @@ void MeshClean::init()
     edgesXStat.reserve(pts.size());
     edgesXYStat.reserve(tris.size() * 3);
 
+    edgesNeigTris.resize(tris.size() * 3);
+    edgesNeigTrisAlive.resize_with(tris.size() * 3, true);
+
+#pragma omp parallel for
     for (int i = 0; i < tris.size(); i++)
     {
         int a = tris[i].v[0];
         int b = tris[i].v[1];
         int c = tris[i].v[2];
-        edgesNeigTris.push_back(Voxel(std::max(a, b), std::min(a, b), i));
-        edgesNeigTris.push_back(Voxel(std::max(b, c), std::min(b, c), i));
-        edgesNeigTris.push_back(Voxel(std::max(c, a), std::min(c, a), i));
-
-        edgesNeigTrisAlive.push_back(true);
-        edgesNeigTrisAlive.push_back(true);
-        edgesNeigTrisAlive.push_back(true);
+        edgesNeigTris[i * 3 + 0] = Voxel(std::max(a, b), std::min(a, b), i);
+        edgesNeigTris[i * 3 + 1] = Voxel(std::max(b, c), std::min(b, c), i);
+        edgesNeigTris[i * 3 + 2] = Voxel(std::max(c, a), std::min(c, a), i);
     }
 
-    qsort(&edgesNeigTris[0], edgesNeigTris.size(), sizeof(Voxel), qSortCompareVoxelByXAsc);
+    // sort by first vertex, then second vertex, then triangle id
+    std::sort(edgesNeigTris.begin(), edgesNeigTris.end(), [](const Voxel& a, const Voxel& b) {
+        return std::tie(a.x, a.y, a.z) < std::tie(b.x, b.y, b.z);
+    });
 
-    // sort
+    // intervals of the edges with the same first vertex, and with the same first and second vertices
     int i0 = 0;
-    long t1 = mvsUtils::initEstimate();
     for (int i = 0; i < edgesNeigTris.size(); i++)
     {
         if ((i == edgesNeigTris.size() - 1) || (edgesNeigTris[i].x != edgesNeigTris[i + 1].x))
         {
-            if (i - i0 + 1 > 1)
-                qsort(&edgesNeigTris[i0], i - i0 + 1, sizeof(Voxel), qSortCompareVoxelByYAsc);
-
             int xyI0 = edgesXYStat.size();
 
             int j0 = i0;
@@ -690,25 +685,17 @@ void MeshClean::init()
             {
                 if ((j == i) || (edgesNeigTris[j].y != edgesNeigTris[j + 1].y))
                 {
-                    if (j - j0 + 1 > 1)
-                        qsort(&edgesNeigTris[j0], j - j0 + 1, sizeof(Voxel), qSortCompareVoxelByZAsc);
-
                     edgesXYStat.push_back(Voxel(edgesNeigTris[j].y, j0, j));
                     j0 = j + 1;
                 }
             }
 
             int xyI = edgesXYStat.size() - 1;
-
-            // printf("%i of %i\n",edgesXStat->size(),edgesXStat->reserved());
             edgesXStat.push_back(Voxel(edgesNeigTris[i].x, xyI0, xyI));
 
             i0 = i + 1;
         }
-
-        mvsUtils::printfEstimate(i, edgesNeigTris.size(), t1);
     }
-    mvsUtils::finishEstimate();
 }
 
 void MeshClean::testPtsNeighTrisSortedAsc()
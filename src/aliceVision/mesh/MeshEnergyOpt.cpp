@@ -7,6 +7,9 @@
 #include "MeshEnergyOpt.hpp"
 #include <aliceVision/system/Logger.hpp>
 
+#include <algorithm>
+#include <cmath>
+
 namespace aliceVision {
 namespace mesh {
 
@@ -19,53 +22,121 @@ MeshEnergyOpt::MeshEnergyOpt(mvsUtils::MultiViewParams* _mp)
 
 MeshEnergyOpt::~MeshEnergyOpt() = default;
 
-void MeshEnergyOpt::computeLaplacianPtsParallel(StaticVector<Point3d>& out_lapPts)
+namespace {
+
+/**
+ * @brief Same as MeshAnalyze::applyLaplacianOperator, on the flat neighbors of the vertices.
+ * @return false if the vertex has no neighbors, if one of the neighbor values is null or if the result is null or NaN
+ */
+inline bool applyLaplacianOperatorCSR(const int* offsets, const int* ids, int ptId, const Point3d* values, Point3d& ln)
 {
-    out_lapPts.reserve(pts.size());
-    out_lapPts.resize_with(pts.size(), Point3d(0.0f, 0.0f, 0.f));
-    int nlabpts = 0;
+    const int begin = offsets[ptId];
+    const int end = offsets[ptId + 1];
+    if (begin == end)
+    {
+        return false;
+    }
+
+    ln = Point3d(0.0f, 0.0f, 0.0f);
+    for (int k = begin; k < end; ++k)
+    {
+        const Point3d& npt = values[ids[k]];
+        if ((npt.x == 0.0f) && (npt.y == 0.0f) && (npt.z == 0.0f))
+        {
+            return false;
+        }
+        ln = ln + npt;
+    }
+    ln = (ln / (float)(end - begin)) - values[ptId];
+
+    // a null vector can not be normalized either
+    const double d = ln.x * ln.x + ln.y * ln.y + ln.z * ln.z;
+    return (d > 0.0) && std::isfinite(d);
+}
+
+}  // namespace
+
+void MeshEnergyOpt::buildNeighborsCSR(const StaticVectorBool& ptsCanMove, NeighborsCSR& out_csr) const
+{
+    const int nbPts = pts.size();
+
+    out_csr.offsets.assign(nbPts + 1, 0);
+    for (int i = 0; i < nbPts; ++i)
+    {
+        out_csr.offsets[i + 1] = out_csr.offsets[i] + ptsNeighPtsOrdered[i].size();
+    }
+
+    out_csr.ids.resize(out_csr.offsets[nbPts]);
+    out_csr.invV.assign(nbPts, 0.0);
 
 #pragma omp parallel for
-    for (int i = 0; i < pts.size(); i++)
+    for (int i = 0; i < nbPts; ++i)
     {
-        Point3d lapPt;
-        if (getLaplacianSmoothingVector(i, lapPt))
+        const StaticVector<int>& ptNeighPtsOrdered = ptsNeighPtsOrdered[i];
+        std::copy(ptNeighPtsOrdered.begin(), ptNeighPtsOrdered.end(), out_csr.ids.begin() + out_csr.offsets[i]);
+
+        if ((!ptsCanMove.empty() && !ptsCanMove[i]) || ptNeighPtsOrdered.empty() || ptsNeighTrisSortedAsc[i].empty())
+        {
+            continue;
+        }
+
+        // kobbelt kampagna 98 Interactive Multi-Resolution Modeling on Arbitrary Meshes, page 6 eq (8)
+        float sum = 0.0f;
+        for (int neighId : ptNeighPtsOrdered)
         {
-            out_lapPts[i] = lapPt;
-            nlabpts++;
+            const int neighValence = ptsNeighPtsOrdered[neighId].size();
+            if (neighValence > 0)
+            {
+                sum += 1.0f / (float)neighValence;
+            }
         }
+        const float v = 1.0f + (1.0f / (float)ptNeighPtsOrdered.size()) * sum;
+        out_csr.invV[i] = 1.0f / v;
     }
 }
 
-void MeshEnergyOpt::updateGradientParallel(float lambda, const Point3d& LU, const Point3d& RD, StaticVectorBool& ptsCanMove)
+void MeshEnergyOpt::updateGradientParallel(float lambda,
+                                           const Point3d& LU,
+                                           const Point3d& RD,
+                                           const NeighborsCSR& csr,
+                                           std::vector<Point3d>& lapPts,
+                                           StaticVector<Point3d>& newPts)
 {
-    // printf("nlabpts %i of %i\n",nlabpts,pts->size());
-    StaticVector<Point3d> lapPts;
-    computeLaplacianPtsParallel(lapPts);
+    const int nbPts = pts.size();
+    const int* offsets = csr.offsets.data();
+    const int* ids = csr.ids.data();
+    const Point3d* ptsData = pts.getData().data();
 
-    StaticVector<Point3d> newPts;
-    newPts.reserve(pts.size());
-    newPts.push_back_arr(&pts);
+    // laplacian of all the points (also the ones which can not move, used by their neighbors)
+#pragma omp parallel for
+    for (int i = 0; i < nbPts; ++i)
+    {
+        Point3d lapPt;
+        lapPts[i] = applyLaplacianOperatorCSR(offsets, ids, i, ptsData, lapPt) ? lapPt : Point3d(0.0f, 0.0f, 0.0f);
+    }
 
+    // bi-laplacian step, each point only reads the previous iteration (Jacobi)
 #pragma omp parallel for
-    for (int i = 0; i < pts.size(); ++i)
+    for (int i = 0; i < nbPts; ++i)
     {
-        if (ptsCanMove.empty() || ptsCanMove[i])
+        newPts[i] = ptsData[i];
+
+        if (csr.invV[i] == 0.0)
         {
-            Point3d n;
+            continue;
+        }
 
-            if (getBiLaplacianSmoothingVector(i, lapPts, n))
+        Point3d n;
+        if (applyLaplacianOperatorCSR(offsets, ids, i, lapPts.data(), n))
+        {
+            const Point3d p = ptsData[i] - n * (csr.invV[i] * lambda);
+            if ((p.x > LU.x) && (p.y > LU.y) && (p.z > LU.z) && (p.x < RD.x) && (p.y < RD.y) && (p.z < RD.z))
             {
-                Point3d p = newPts[i] + n * lambda;
-                if ((p.x > LU.x) && (p.y > LU.y) && (p.z > LU.z) && (p.x < RD.x) && (p.y < RD.y) && (p.z < RD.z))
-                {
-                    newPts[i] = p;
-                }
+                newPts[i] = p;
             }
         }
     }
 
-    pts.clear();
     pts.swap(newPts);
 }
 
@@ -93,10 +164,18 @@ bool MeshEnergyOpt::optimizeSmooth(float lambda, int niter, StaticVectorBool& pt
 
     ALICEVISION_LOG_INFO("Optimizing mesh smooth: " << std::endl << "\t- lamda: " << lambda << std::endl << "\t- niters: " << niter << std::endl);
 
+    NeighborsCSR csr;
+    buildNeighborsCSR(ptsCanMove, csr);
+
+    // buffers reused by all the iterations
+    std::vector<Point3d> lapPts(pts.size());
+    StaticVector<Point3d> newPts;
+    newPts.resize(pts.size());
+
     for (int i = 0; i < niter; i++)
     {
         ALICEVISION_LOG_INFO("Optimizing mesh smooth: iteration " << i);
-        updateGradientParallel(lambda, LU, RD, ptsCanMove);
+        updateGradientParallel(lambda, LU, RD, csr, lapPts, newPts);
         // if(saveDebug)
         //     save(folder + "mesh_smoothed_" + std::to_string(i));
     }
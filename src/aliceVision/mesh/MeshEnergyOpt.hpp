@@ -10,6 +10,8 @@
 #include <aliceVision/mvsData/StaticVector.hpp>
 #include <aliceVision/mesh/MeshAnalyze.hpp>
 
+#include <vector>
+
 namespace aliceVision {
 namespace mesh {
 
@@ -22,8 +24,25 @@ class MeshEnergyOpt : public MeshAnalyze
     bool optimizeSmooth(float lambda, int niter, StaticVectorBool& ptsCanMove);
 
   private:
-    void computeLaplacianPtsParallel(StaticVector<Point3d>& out_lapPts);
-    void updateGradientParallel(float lambda, const Point3d& LU, const Point3d& RD, StaticVectorBool& ptsCanMove);
+    /**
+     * @brief Flat (CSR) copy of the ordered neighbor points of the vertices, built once for all the smoothing iterations.
+     */
+    struct NeighborsCSR
+    {
+        /// neighbors of vertex i are ids[offsets[i]] to ids[offsets[i + 1] - 1]
+        std::vector<int> offsets;
+        std::vector<int> ids;
+        /// 1 / v of the bi-laplacian operator of each vertex (0 if the vertex can not move)
+        std::vector<double> invV;
+    };
+
+    void buildNeighborsCSR(const StaticVectorBool& ptsCanMove, NeighborsCSR& out_csr) const;
+    void updateGradientParallel(float lambda,
+                                const Point3d& LU,
+                                const Point3d& RD,
+                                const NeighborsCSR& csr,
+                                std::vector<Point3d>& lapPts,
+                                StaticVector<Point3d>& newPts);
 };
 
 }  // namespace mesh
@@ -6,10 +6,15 @@
 
 #include "Texturing.hpp"
 #include "geoMesh.hpp"
+#include "TiledAccuAtlas.hpp"
 #include "UVAtlas.hpp"
 
+#include <aliceVision/alicevision_omp.hpp>
+#include <aliceVision/config.hpp>
 #include <aliceVision/utils/filesIO.hpp>
 #include <aliceVision/system/Logger.hpp>
+#include <aliceVision/system/ProgressDisplay.hpp>
+#include <aliceVision/system/TaskScheduler.hpp>
 #include <aliceVision/image/io.hpp>
 #include <aliceVision/image/pixelTypes.hpp>
 #include <aliceVision/numeric/numeric.hpp>
@@ -37,10 +42,16 @@
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 
+#include <atomic>
 #include <filesystem>
 #include <map>
+#include <numeric>
 #include <set>
 
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
+    #include <aliceVision/mesh/cuda/DeviceTextureAccumulator.hpp>
+#endif
+
 // Debug mode: save atlases decomposition in frequency bands and
 // the number of contribution in each band (if useScore is set to false)
 #define TEXTURING_MBB_DEBUG 0
@@ -167,6 +178,36 @@ Point3d barycentricToCartesian(const Point3d* triangle, const Point2d& coords)
     return triangle[0] + (triangle[2] - triangle[0]) * coords.x + (triangle[1] - triangle[0]) * coords.y;
 }
 
+/**
+ * @brief Retrieve the UV coordinates of a triangle in pixels, remapped in its UDIM, and its 3D coordinates.
+ * @param[in] mesh the mesh with UV coordinates
+ * @param[in] triangleId the triangle index
+ * @param[in] textureSide the side of the texture in pixels
+ * @param[out] triPixs the UV coordinates of the 3 vertices in pixels
+ * @param[out] triPts the 3D coordinates of the 3 vertices
+ */
+void getTriangleCoordinates(const Mesh& mesh, unsigned int triangleId, unsigned int textureSide, Point2d* triPixs, Point3d* triPts)
+{
+    const Voxel& triangleUvIds = mesh.trisUvIds[triangleId];
+    const StaticVector<Point2d>& uvCoords = mesh.uvCoords;
+    // compute the Bottom-Left minima of the current UDIM for [0,1] range remapping
+    Point2d udimBL;
+    udimBL.x = std::floor(std::min({uvCoords[triangleUvIds.m[0]].x, uvCoords[triangleUvIds.m[1]].x, uvCoords[triangleUvIds.m[2]].x}));
+    udimBL.y = std::floor(std::min({uvCoords[triangleUvIds.m[0]].y, uvCoords[triangleUvIds.m[1]].y, uvCoords[triangleUvIds.m[2]].y}));
+
+    for (int k = 0; k < 3; ++k)
+    {
+        const int pointIndex = mesh.tris[triangleId].v[k];
+        triPts[k] = mesh.pts[pointIndex];  // 3D coordinates
+        const int uvPointIndex = triangleUvIds.m[k];
+        Point2d uv = uvCoords[uvPointIndex];
+        // UDIM: remap coordinates between [0,1]
+        uv = uv - udimBL;
+
+        triPixs[k] = uv * textureSide;  // UV coordinates
+    }
+}
+
 void Texturing::generateUVsBasicMethod(mvsUtils::MultiViewParams& mp)
 {
     if (!mesh)
@@ -179,89 +220,113 @@ void Texturing::generateUVsBasicMethod(mvsUtils::MultiViewParams& mp)
     UVAtlas mua(*mesh, mp, texParams.textureSide, texParams.padding);
 
     // create a new mesh to store data
-    mesh->trisUvIds.reserve(mesh->tris.size());
-    mesh->uvCoords.reserve(mesh->pts.size());  // not sufficient
+    mesh->trisUvIds.resize(mesh->tris.size());
     _atlases.clear();
     _atlases.resize(mua.atlases().size());
     mesh->nmtls = mua.atlases().size();
 
-    // std::map<int, int> vertexCache;
-    // PointsVisibility* updatedPointsCams = new PointsVisibility;
-    // updatedPointsCams->reserve(mesh->pointsVisibilities.size());
-
-    int atlasId = 0;
-
-    for (auto& charts : mua.atlases())
+    // list the charts with a reference camera, with the position of their triangles in their atlas
+    struct ChartRef
+    {
+        int atlasId;
+        const UVAtlas::Chart* chart;
+        std::size_t atlasOffset;     //< position of the first triangle in the atlas
+        std::vector<int> pointIDs;   //< sorted vertices, one UV coordinate per chart vertex
+        std::size_t uvOffset;        //< index of the first UV coordinate
+    };
+    std::vector<ChartRef> charts;
+    for (int atlasId = 0; atlasId < mua.atlases().size(); ++atlasId)
     {
-        for (auto& chart : charts)
+        std::size_t atlasSize = 0;
+        for (const auto& chart : mua.atlases()[atlasId])
         {
             if (chart.refCameraID == -1)
                 continue;
+            charts.push_back({atlasId, &chart, atlasSize, {}, 0});
+            atlasSize += chart.triangleIDs.size();
+        }
+        _atlases[atlasId].resize(atlasSize);
+    }
+
+#pragma omp parallel for schedule(dynamic)
+    for (int c = 0; c < charts.size(); ++c)
+    {
+        std::vector<int>& pointIDs = charts[c].pointIDs;
+        for (const int triangleID : charts[c].chart->triangleIDs)
+            for (int k = 0; k < 3; ++k)
+                pointIDs.push_back(mesh->tris[triangleID].v[k]);
+        std::sort(pointIDs.begin(), pointIDs.end());
+        pointIDs.erase(std::unique(pointIDs.begin(), pointIDs.end()), pointIDs.end());
+    }
 
-            std::map<int, int> uvCache;
+    std::size_t nbUVs = 0;
+    for (ChartRef& chartRef : charts)
+    {
+        chartRef.uvOffset = nbUVs;
+        nbUVs += chartRef.pointIDs.size();
+    }
+    mesh->uvCoords.resize(nbUVs);
 
-            Point2d sourceLU(chart.sourceLU.x, chart.sourceLU.y);
-            Point2d targetLU(chart.targetLU.x, chart.targetLU.y);
+    // each chart fills its own UV coordinates and triangles
+#pragma omp parallel for schedule(dynamic)
+    for (int c = 0; c < charts.size(); ++c)
+    {
+        const ChartRef& chartRef = charts[c];
+        const UVAtlas::Chart& chart = *chartRef.chart;
+        const int atlasId = chartRef.atlasId;
 
-            // for each triangle in this chart
-            for (size_t i = 0; i < chart.triangleIDs.size(); ++i)
+        Point2d sourceLU(chart.sourceLU.x, chart.sourceLU.y);
+        Point2d targetLU(chart.targetLU.x, chart.targetLU.y);
+
+        // compute the UV coordinates of the chart vertices
+        for (std::size_t p = 0; p < chartRef.pointIDs.size(); ++p)
+        {
+            const Point3d& pt = mesh->pts[chartRef.pointIDs[p]];
+            Point2d uvPix;
+
+            Point2d pix;
+            mp.getPixelFor3DPoint(&pix, pt, chart.refCameraID);
+            if (mp.isPixelInImage(pix, chart.refCameraID))
             {
-                int triangleID = chart.triangleIDs[i];
-                // register triangle in corresponding atlas
-                mesh->trisMtlIds()[triangleID] = atlasId;
-                _atlases[atlasId].push_back(triangleID);
-
-                Voxel& triUvIds = mesh->trisUvIds[triangleID];
-                // for each point
-                for (int k = 0; k < 3; ++k)
+                // compute the final pixel coordinates
+                // get pixel offset in reference camera space with applied downscale
+                Point2d dp = (pix - sourceLU) * chart.downscale;
+                // add this offset to targetLU to get final pixel coordinates + normalize
+                uvPix = (targetLU + dp) / (float)mua.textureSide();
+                uvPix.y = 1.0 - uvPix.y;
+
+                // sanity check: discard invalid UVs
+                if (uvPix.x < 0 || uvPix.x > 1.0 || uvPix.y < 0 || uvPix.y > 1.0)
                 {
-                    int pointId = mesh->tris[triangleID].v[k];
+                    ALICEVISION_LOG_WARNING("Discarding invalid UV: " + std::to_string(uvPix.x) + ", " + std::to_string(uvPix.y));
+                    uvPix = Point2d();
+                }
 
-                    int uvIdx;
-                    auto uvCacheIt = uvCache.find(pointId);
-                    // if uv coords for this point had not been computed in this chart yet
-                    if (uvCacheIt == uvCache.end())
-                    {
-                        const Point3d& p = mesh->pts[pointId];
-                        Point2d uvPix;
+                if (texParams.useUDIM)
+                {
+                    uvPix.x += atlasId % 10;
+                    uvPix.y += atlasId / 10;
+                }
+            }
+            mesh->uvCoords[chartRef.uvOffset + p] = uvPix;
+        }
 
-                        Point2d pix;
-                        mp.getPixelFor3DPoint(&pix, p, chart.refCameraID);
-                        if (mp.isPixelInImage(pix, chart.refCameraID))
-                        {
-                            // compute the final pixel coordinates
-                            // get pixel offset in reference camera space with applied downscale
-                            Point2d dp = (pix - sourceLU) * chart.downscale;
-                            // add this offset to targetLU to get final pixel coordinates + normalize
-                            uvPix = (targetLU + dp) / (float)mua.textureSide();
-                            uvPix.y = 1.0 - uvPix.y;
-
-                            // sanity check: discard invalid UVs
-                            if (uvPix.x < 0 || uvPix.x > 1.0 || uvPix.y < 0 || uvPix.y > 1.0)
-                            {
-                                ALICEVISION_LOG_WARNING("Discarding invalid UV: " + std::to_string(uvPix.x) + ", " + std::to_string(uvPix.y));
-                                uvPix = Point2d();
-                            }
+        // for each triangle in this chart
+        for (size_t i = 0; i < chart.triangleIDs.size(); ++i)
+        {
+            int triangleID = chart.triangleIDs[i];
+            // register triangle in corresponding atlas
+            mesh->trisMtlIds()[triangleID] = atlasId;
+            _atlases[atlasId][chartRef.atlasOffset + i] = triangleID;
 
-                            if (texParams.useUDIM)
-                            {
-                                uvPix.x += atlasId % 10;
-                                uvPix.y += atlasId / 10;
-                            }
-                        }
-                        mesh->uvCoords.push_back(uvPix);
-                        uvIdx = mesh->uvCoords.size() - 1;
-                        uvCache[pointId] = uvIdx;
-                    }
-                    else
-                    {
-                        uvIdx = uvCacheIt->second;
-                    }
-                    triUvIds.m[k] = uvIdx;
-                }
+            Voxel& triUvIds = mesh->trisUvIds[triangleID];
+            for (int k = 0; k < 3; ++k)
+            {
+                const int pointId = mesh->tris[triangleID].v[k];
+                const auto it = std::lower_bound(chartRef.pointIDs.begin(), chartRef.pointIDs.end(), pointId);
+                triUvIds.m[k] = chartRef.uvOffset + std::distance(chartRef.pointIDs.begin(), it);
             }
         }
-        ++atlasId;
     }
 }
 
@@ -301,12 +366,36 @@ void Texturing::generateTextures(const mvsUtils::MultiViewParams& mp,
     }
     std::partial_sum(m.begin(), m.end(), m.begin());
 
+    if (texParams.tiledTextures && textureFileType != image::EImageFileType::EXR)
+    {
+        ALICEVISION_LOG_WARNING("Tiled textures are only supported in EXR, the textures are written in EXR instead of "
+                                << image::EImageFileType_enumToString(textureFileType) << ".");
+        textureFileType = image::EImageFileType::EXR;
+    }
+
     ALICEVISION_LOG_INFO("Texturing in " + image::EImageColorSpace_enumToString(texParams.workingColorSpace) + " colorspace.");
     mvsUtils::ImagesCache<image::Image<image::RGBfColor>> imageCache(mp, texParams.workingColorSpace, texParams.correctEV);
 
     imageCache.setCacheSize(2);
     ALICEVISION_LOG_INFO("Images loaded from cache with: " + ECorrectEV_enumToString(texParams.correctEV));
 
+    // the atlases are written in the background while the next ones are computed,
+    // at most one atlas (the size of the final texture) is waiting to be written
+    const std::size_t atlasTextureMemSize = std::size_t(texParams.textureSide) * texParams.textureSide * sizeof(image::RGBfColor);
+    image::AsyncImageWriter textureWriter(2, atlasTextureMemSize);
+
+    auto progressDisplay = system::createConsoleProgressDisplay(_atlases.size(), std::cout, "Texturing\n");
+
+    if (texParams.cameraMajorOrder)
+    {
+        if (texParams.useGpu)
+            ALICEVISION_LOG_WARNING("The camera major order is computed on the CPU.");
+        generateTexturesCameraMajor(mp, imageCache, textureWriter, outPath, memoryAvailable, textureFileType);
+        textureWriter.flush();
+        progressDisplay += _atlases.size();
+        return;
+    }
+
     // calculate the maximum number of atlases in memory in MB
     const std::size_t imageMaxMemSize = mp.getMaxImageWidth() * mp.getMaxImageHeight() * sizeof(image::RGBfColor) / std::pow(2, 20);  // MB
     const std::size_t imagePyramidMaxMemSize = texParams.nbBand * imageMaxMemSize;
@@ -324,6 +413,18 @@ void Texturing::generateTextures(const mvsUtils::MultiViewParams& mp,
     int nbAtlasMax = std::floor(availableMem / double(memoryPerAtlas));  // maximum number of textures laplacian pyramid in RAM
     nbAtlasMax = std::min(nbAtlas, nbAtlasMax);                          // if enough memory, do it with all atlases
 
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
+    if (texParams.useGpu)
+    {
+        // the atlases pyramids are accumulated on the device, only one of them at a time is in RAM
+        const int availableDeviceMem = int(cuda::DeviceTextureAccumulator::getFreeMemory() / std::pow(2, 20)) -
+                                       (imageMaxMemSize + imagePyramidMaxMemSize) - 512;  // keep 512 MB margin on the device
+        nbAtlasMax = std::floor(availableDeviceMem / double(std::max<std::size_t>(1, atlasPyramidMaxMemSize)));
+        nbAtlasMax = std::max(1, std::min(nbAtlas, nbAtlasMax));
+        ALICEVISION_LOG_INFO("availableDeviceMem: " << availableDeviceMem);
+    }
+#endif
+
     ALICEVISION_LOG_INFO("nbAtlas: " << nbAtlas);
     ALICEVISION_LOG_INFO("availableRam: " << availableRam);
     ALICEVISION_LOG_INFO("availableMem: " << availableMem);
@@ -337,7 +438,7 @@ void Texturing::generateTextures(const mvsUtils::MultiViewParams& mp,
     ALICEVISION_LOG_DEBUG("nChunks: " << nChunks);
     ALICEVISION_LOG_INFO("nbAtlasMax (after rounding): " << nbAtlasMax);
 
-    if (availableMem - nbAtlasMax * atlasPyramidMaxMemSize < 1000)  // keep 1 GB margin in memory
+    if (!texParams.useGpu && availableMem - nbAtlasMax * atlasPyramidMaxMemSize < 1000)  // keep 1 GB margin in memory
         nbAtlasMax -= 1;
     nbAtlasMax = std::max(1, nbAtlasMax);  // if not enough memory, do it one by one
 
@@ -363,26 +464,19 @@ void Texturing::generateTextures(const mvsUtils::MultiViewParams& mp,
             atlasIDs.push_back(atlasID);
         }
         ALICEVISION_LOG_INFO("Generating texture for atlases " << n * nbAtlasMax + 1 << " to " << n * nbAtlasMax + imax);
-        generateTexturesSubSet(mp, atlasIDs, imageCache, outPath, textureFileType);
+        generateTexturesSubSet(mp, atlasIDs, imageCache, textureWriter, outPath, textureFileType);
+        progressDisplay += imax;
     }
+    textureWriter.flush();
 }
 
-void Texturing::generateTexturesSubSet(const mvsUtils::MultiViewParams& mp,
-                                       const std::vector<size_t>& atlasIDs,
-                                       mvsUtils::ImagesCache<image::Image<image::RGBfColor>>& imageCache,
-                                       const fs::path& outPath,
-                                       image::EImageFileType textureFileType)
+void Texturing::computeContributionsPerCamera(const mvsUtils::MultiViewParams& mp,
+                                              const std::vector<size_t>& atlasIDs,
+                                              std::vector<CameraContributions>& contributionsPerCamera) const
 {
-    if (atlasIDs.size() > _atlases.size())
-        throw std::runtime_error("Invalid atlas IDs ");
-
-    unsigned int textureSize = texParams.textureSide * texParams.textureSide;
-
     // We select the best cameras for each triangle and store it per camera for each output texture files.
     // Triangles contributions are stored per frequency bands for multi-band blending.
-    using AtlasIndex = size_t;
-    using ScorePerTriangle = std::vector<std::pair<unsigned int, float>>;  // list of <triangleId, score>
-    std::vector<std::map<AtlasIndex, std::vector<ScorePerTriangle>>> contributionsPerCamera(mp.ncams);
+    contributionsPerCamera.assign(mp.ncams, CameraContributions());
 
     // for each atlasID, calculate contributionPerCamera
     for (const size_t atlasID : atlasIDs)
@@ -510,18 +604,53 @@ void Texturing::generateTexturesSubSet(const mvsUtils::MultiViewParams& mp,
             }
         }
     }
+}
+
+void Texturing::generateTexturesSubSet(const mvsUtils::MultiViewParams& mp,
+                                       const std::vector<size_t>& atlasIDs,
+                                       mvsUtils::ImagesCache<image::Image<image::RGBfColor>>& imageCache,
+                                       image::AsyncImageWriter& textureWriter,
+                                       const fs::path& outPath,
+                                       image::EImageFileType textureFileType)
+{
+    if (atlasIDs.size() > _atlases.size())
+        throw std::runtime_error("Invalid atlas IDs ");
+
+    unsigned int textureSize = texParams.textureSide * texParams.textureSide;
+
+    std::vector<CameraContributions> contributionsPerCamera;
+    computeContributionsPerCamera(mp, atlasIDs, contributionsPerCamera);
 
     ALICEVISION_LOG_INFO("Reading pixel color.");
 
     // pyramid of atlases frequency bands
     std::map<AtlasIndex, AccuPyramid> accuPyramids;
-    for (std::size_t atlasID : atlasIDs)
-        accuPyramids[atlasID].init(texParams.nbBand, texParams.textureSide, texParams.textureSide);
+
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
+    // on the GPU, the pyramids are accumulated on the device and only allocated on the host to create the textures
+    const bool useGpu = texParams.useGpu;
+    cuda::DeviceTextureAccumulator deviceAccumulator;
+    std::map<AtlasIndex, int> deviceAtlasIndexes;
+    if (useGpu)
+    {
+        for (std::size_t atlasID : atlasIDs)
+            deviceAtlasIndexes.emplace(atlasID, int(deviceAtlasIndexes.size()));
+        deviceAccumulator.init(int(atlasIDs.size()), texParams.nbBand, texParams.textureSide);
+    }
+#else
+    const bool useGpu = false;
+#endif
+
+    if (!useGpu)
+    {
+        for (std::size_t atlasID : atlasIDs)
+            accuPyramids[atlasID].init(texParams.nbBand, texParams.textureSide, texParams.textureSide);
+    }
 
     // for each camera, for each texture, iterate over triangles and fill the accuPyramids map
     for (int camId = 0; camId < contributionsPerCamera.size(); ++camId)
     {
-        const std::map<AtlasIndex, std::vector<ScorePerTriangle>>& cameraContributions = contributionsPerCamera[camId];
+        const CameraContributions& cameraContributions = contributionsPerCamera[camId];
 
         if (cameraContributions.empty())
         {
@@ -533,12 +662,82 @@ void Texturing::generateTexturesSubSet(const mvsUtils::MultiViewParams& mp,
 
         // Load camera image from cache
         auto imgPtr = imageCache.getImg_sync(camId);
+
+        // load the next used camera image in the background while this one is processed
+        for (int nextCamId = camId + 1; nextCamId < contributionsPerCamera.size(); ++nextCamId)
+        {
+            if (!contributionsPerCamera[nextCamId].empty())
+            {
+                imageCache.refreshImage_async(nextCamId);
+                break;
+            }
+        }
         const image::Image<image::RGBfColor>& camImg = *imgPtr;
 
         // Calculate laplacianPyramid
         std::vector<image::Image<image::RGBfColor>> pyramidL;  // laplacian pyramid
         imageAlgo::laplacianPyramid(pyramidL, camImg, texParams.nbBand, texParams.multiBandDownscale);
 
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
+        if (useGpu)
+        {
+            // all the contributions of the camera, for every atlas and band, in a single launch
+            std::vector<cuda::DeviceTextureAccumulator::Triangle> triangles;
+            for (const auto& c : cameraContributions)
+            {
+                ALICEVISION_LOG_INFO("  - Texture file: " << c.first + 1);
+                for (int band = 0; band < c.second.size(); ++band)
+                {
+                    const ScorePerTriangle& trianglesId = c.second[band];
+                    ALICEVISION_LOG_INFO("      - band " << band + 1 << ": " << trianglesId.size() << " triangles.");
+
+                    for (const auto& triangleScore : trianglesId)
+                    {
+                        Point2d triPixs[3];
+                        Point3d triPts[3];
+                        getTriangleCoordinates(*mesh, triangleScore.first, texParams.textureSide, triPixs, triPts);
+
+                        cuda::DeviceTextureAccumulator::Triangle triangle;
+                        for (int k = 0; k < 3; ++k)
+                        {
+                            triangle.uv[k][0] = triPixs[k].x;
+                            triangle.uv[k][1] = triPixs[k].y;
+                            triangle.points[k][0] = triPts[k].x;
+                            triangle.points[k][1] = triPts[k].y;
+                            triangle.points[k][2] = triPts[k].z;
+                        }
+                        triangle.atlasIndex = deviceAtlasIndexes.at(c.first);
+                        triangle.band = band;
+                        triangle.score = texParams.useScore ? triangleScore.second : 1.0f;
+                        triangles.push_back(triangle);
+                    }
+                }
+            }
+
+            std::vector<const float*> levels;
+            std::vector<int> widths;
+            std::vector<int> heights;
+            for (const image::Image<image::RGBfColor>& level : pyramidL)
+            {
+                levels.push_back(reinterpret_cast<const float*>(level.data()));
+                widths.push_back(level.width());
+                heights.push_back(level.height());
+            }
+
+            deviceAccumulator.setCamera(mp.camArr[camId].m,
+                                        mp.g_border,
+                                        reinterpret_cast<const float*>(camImg.data()),
+                                        camImg.width(),
+                                        camImg.height(),
+                                        levels,
+                                        widths,
+                                        heights,
+                                        texParams.multiBandDownscale);
+            deviceAccumulator.accumulate(triangles);
+            continue;
+        }
+#endif
+
         // for each output texture file
         for (const auto& c : cameraContributions)
         {
@@ -559,24 +758,7 @@ void Texturing::generateTexturesSubSet(const mvsUtils::MultiViewParams& mp,
                     // retrieve triangle 3D and UV coordinates
                     Point2d triPixs[3];
                     Point3d triPts[3];
-                    auto& triangleUvIds = mesh->trisUvIds[triangleId];
-                    // compute the Bottom-Left minima of the current UDIM for [0,1] range remapping
-                    Point2d udimBL;
-                    StaticVector<Point2d>& uvCoords = mesh->uvCoords;
-                    udimBL.x = std::floor(std::min({uvCoords[triangleUvIds[0]].x, uvCoords[triangleUvIds[1]].x, uvCoords[triangleUvIds[2]].x}));
-                    udimBL.y = std::floor(std::min({uvCoords[triangleUvIds[0]].y, uvCoords[triangleUvIds[1]].y, uvCoords[triangleUvIds[2]].y}));
-
-                    for (int k = 0; k < 3; ++k)
-                    {
-                        const int pointIndex = mesh->tris[triangleId].v[k];
-                        triPts[k] = mesh->pts[pointIndex];  // 3D coordinates
-                        const int uvPointIndex = triangleUvIds.m[k];
-                        Point2d uv = uvCoords[uvPointIndex];
-                        // UDIM: remap coordinates between [0,1]
-                        uv = uv - udimBL;
-
-                        triPixs[k] = uv * texParams.textureSide;  // UV coordinates
-                    }
+                    getTriangleCoordinates(*mesh, triangleId, texParams.textureSide, triPixs, triPts);
 
                     // compute triangle bounding box in pixel indexes
                     // min values: floor(value)
@@ -649,9 +831,7 @@ void Texturing::generateTexturesSubSet(const mvsUtils::MultiViewParams& mp,
 
     // calculate atlas texture in the first level of the pyramid (avoid creating a new buffer)
     // debug mode : write all the frequencies levels for each texture
-    for (std::size_t atlasID : atlasIDs)
-    {
-        AccuPyramid& accuPyramid = accuPyramids.at(atlasID);
+    const auto computeAtlasTexture = [&](std::size_t atlasID, AccuPyramid& accuPyramid) {
         AccuImage& atlasTexture = accuPyramid.pyramid[0];
         ALICEVISION_LOG_INFO("Create texture " << atlasID + 1);
 
@@ -740,7 +920,328 @@ void Texturing::generateTexturesSubSet(const mvsUtils::MultiViewParams& mp,
                 }
             }
         }
-        writeTexture(atlasTexture, atlasID, outPath, textureFileType, -1);
+    };
+
+    // the GPU path only has one atlas pyramid on the host at a time,
+    // the holes filling is already multithreaded and the debug mode writes the frequency bands of the textures
+    const bool parallelTextures = !useGpu && !texParams.fillHoles && !TEXTURING_MBB_DEBUG;
+
+    if (!parallelTextures)
+    {
+        for (std::size_t atlasID : atlasIDs)
+        {
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
+            if (useGpu)
+            {
+                // only one atlas pyramid on the host at a time
+                accuPyramids.clear();
+                AccuPyramid& deviceAccuPyramid = accuPyramids[atlasID];
+                deviceAccuPyramid.init(texParams.nbBand, texParams.textureSide, texParams.textureSide);
+
+                std::vector<float*> colors;
+                std::vector<float*> counts;
+                for (AccuImage& accuImage : deviceAccuPyramid.pyramid)
+                {
+                    colors.push_back(reinterpret_cast<float*>(accuImage.img.data()));
+                    counts.push_back(accuImage.imgCount.data());
+                }
+                deviceAccumulator.download(deviceAtlasIndexes.at(atlasID), colors, counts);
+            }
+#endif
+
+            AccuPyramid& accuPyramid = accuPyramids.at(atlasID);
+            computeAtlasTexture(atlasID, accuPyramid);
+            writeTexture(accuPyramid.pyramid[0], atlasID, outPath, textureFileType, -1, &textureWriter);
+        }
+        return;
+    }
+
+    // finalize the textures in parallel, one atlas per thread
+    // note: the atlases pyramids are already in memory, the textures are finalized in place and queued to the textures writer
+    material.diffuseType = textureFileType;
+
+    system::parallelFor(0, static_cast<std::ptrdiff_t>(atlasIDs.size()), 1, [&](std::ptrdiff_t i) {
+        const std::size_t atlasID = atlasIDs[i];
+        AccuPyramid& accuPyramid = accuPyramids.at(atlasID);
+        AccuImage& atlasTexture = accuPyramid.pyramid[0];
+
+        computeAtlasTexture(atlasID, accuPyramid);
+        finalizeTexture(atlasTexture, -1);
+
+        const fs::path texturePath = outPath / material.textureName(Material::TextureType::DIFFUSE, static_cast<int>(atlasID));
+        writeTextureFile(atlasTexture, texturePath, &textureWriter);
+
+        // the atlas pyramid is not needed anymore
+        accuPyramid.pyramid.clear();
+    });
+
+    // the textures are added to the material in the atlases order
+    for (std::size_t atlasID : atlasIDs)
+        material.addTexture(Material::TextureType::DIFFUSE, material.textureName(Material::TextureType::DIFFUSE, static_cast<int>(atlasID)));
+}
+
+void Texturing::generateTexturesCameraMajor(const mvsUtils::MultiViewParams& mp,
+                                            mvsUtils::ImagesCache<image::Image<image::RGBfColor>>& imageCache,
+                                            image::AsyncImageWriter& textureWriter,
+                                            const fs::path& outPath,
+                                            size_t memoryAvailable,
+                                            image::EImageFileType textureFileType)
+{
+    const int texSide = static_cast<int>(texParams.textureSide);
+    const int nbBand = static_cast<int>(texParams.nbBand);
+    constexpr int tileSide = TiledAccuAtlas::tileSide;
+
+    std::vector<size_t> atlasIDs(_atlases.size());
+    std::iota(atlasIDs.begin(), atlasIDs.end(), 0);
+
+    std::vector<CameraContributions> contributionsPerCamera;
+    computeContributionsPerCamera(mp, atlasIDs, contributionsPerCamera);
+
+    // memory of the accumulated tiles: keep memory for the 2 input images in cache with their laplacian pyramid,
+    // the final texture of an atlas and a margin of 1 GB
+    const std::size_t imageMemSize = std::size_t(mp.getMaxImageWidth()) * mp.getMaxImageHeight() * sizeof(image::RGBfColor);
+    const std::size_t textureMemSize = std::size_t(texSide) * texSide * (sizeof(image::RGBfColor) + sizeof(float));
+    const std::size_t reservedMemSize = 2 * (nbBand + 1) * imageMemSize + textureMemSize + (std::size_t(1) << 30);
+    const std::size_t tileMemSize = TiledAccuAtlas::getTileMemorySize(nbBand);
+    // at least one pinned tile per thread
+    const std::size_t cacheMemSize =
+      std::max(memoryAvailable > reservedMemSize ? memoryAvailable - reservedMemSize : 0, (omp_get_max_threads() + 1) * tileMemSize);
+
+    ALICEVISION_LOG_INFO("Texturing in camera major order: " << _atlases.size() << " atlases accumulated by tiles of " << tileSide << "x"
+                                                             << tileSide << " pixels, " << cacheMemSize / (1024 * 1024) << " MB in core.");
+
+    std::shared_ptr<image::TileCacheManager> cacheManager = image::TileCacheManager::create(outPath.string(), tileSide, tileSide, 1024);
+    if (!cacheManager)
+        throw std::runtime_error("Unable to create the tiles cache of the atlases.");
+    cacheManager->setMaxMemory(cacheMemSize);
+
+    std::vector<std::unique_ptr<TiledAccuAtlas>> accuAtlases;
+    for (std::size_t atlasID = 0; atlasID < _atlases.size(); ++atlasID)
+        accuAtlases.push_back(std::make_unique<TiledAccuAtlas>(cacheManager, texSide, nbBand));
+
+    // contribution of a camera to a triangle at a frequency band
+    struct TriangleContribution
+    {
+        unsigned int triangleId;
+        int band;
+        float score;
+    };
+
+    // each camera image is loaded once and scattered into all the atlases it contributes to
+    for (int camId = 0; camId < contributionsPerCamera.size(); ++camId)
+    {
+        const CameraContributions& cameraContributions = contributionsPerCamera[camId];
+
+        if (cameraContributions.empty())
+        {
+            ALICEVISION_LOG_INFO("- camera " << mp.getViewId(camId) << " (" << camId + 1 << "/" << mp.ncams << ") unused.");
+            continue;
+        }
+        ALICEVISION_LOG_INFO("- camera " << mp.getViewId(camId) << " (" << camId + 1 << "/" << mp.ncams << ") with contributions to "
+                                         << cameraContributions.size() << " texture files.");
+
+        // Load camera image from cache
+        auto imgPtr = imageCache.getImg_sync(camId);
+
+        // load the next used camera image in the background while this one is processed
+        for (int nextCamId = camId + 1; nextCamId < contributionsPerCamera.size(); ++nextCamId)
+        {
+            if (!contributionsPerCamera[nextCamId].empty())
+            {
+                imageCache.refreshImage_async(nextCamId);
+                break;
+            }
+        }
+        const image::Image<image::RGBfColor>& camImg = *imgPtr;
+
+        // Calculate laplacianPyramid
+        std::vector<image::Image<image::RGBfColor>> pyramidL;  // laplacian pyramid
+        imageAlgo::laplacianPyramid(pyramidL, camImg, texParams.nbBand, texParams.multiBandDownscale);
+
+        for (const auto& c : cameraContributions)
+        {
+            TiledAccuAtlas& accuAtlas = *accuAtlases[c.first];
+            const int tilesPerSide = accuAtlas.getTilesPerSide();
+
+            // bin the contributions by tile of the atlas, so that each tile is acquired once and filled by a single thread
+            std::vector<TriangleContribution> contributions;
+            std::vector<std::vector<int>> contributionsPerTile(accuAtlas.getTileCount());
+            for (int band = 0; band < c.second.size(); ++band)
+            {
+                for (const auto& triangleScore : c.second[band])
+                {
+                    Point2d triPixs[3];
+                    Point3d triPts[3];
+                    getTriangleCoordinates(*mesh, triangleScore.first, texParams.textureSide, triPixs, triPts);
+
+                    // triangle bounding box in the atlas image coordinates (inverted Y axis)
+                    const int xmin = clamp(static_cast<int>(std::floor(std::min({triPixs[0].x, triPixs[1].x, triPixs[2].x}))), 0, texSide);
+                    const int xmax = clamp(static_cast<int>(std::ceil(std::max({triPixs[0].x, triPixs[1].x, triPixs[2].x}))), 0, texSide);
+                    const int ymin = clamp(static_cast<int>(std::floor(std::min({triPixs[0].y, triPixs[1].y, triPixs[2].y}))), 0, texSide);
+                    const int ymax = clamp(static_cast<int>(std::ceil(std::max({triPixs[0].y, triPixs[1].y, triPixs[2].y}))), 0, texSide);
+                    if (xmin >= xmax || ymin >= ymax)
+                        continue;
+
+                    const int contributionId = contributions.size();
+                    contributions.push_back({triangleScore.first, band, texParams.useScore ? triangleScore.second : 1.0f});
+
+                    for (int ty = (texSide - ymax) / tileSide; ty <= (texSide - 1 - ymin) / tileSide; ++ty)
+                        for (int tx = xmin / tileSide; tx <= (xmax - 1) / tileSide; ++tx)
+                            contributionsPerTile[ty * tilesPerSide + tx].push_back(contributionId);
+                }
+            }
+
+            std::vector<int> tileIds;
+            for (int tileId = 0; tileId < contributionsPerTile.size(); ++tileId)
+            {
+                if (!contributionsPerTile[tileId].empty())
+                    tileIds.push_back(tileId);
+            }
+
+            ALICEVISION_LOG_INFO("  - Texture file " << c.first + 1 << ": " << contributions.size() << " triangles in " << tileIds.size()
+                                                     << " tiles.");
+
+            std::atomic<bool> tileFailure(false);
+#pragma omp parallel for schedule(dynamic)
+            for (int ti = 0; ti < tileIds.size(); ++ti)
+            {
+                const int tileId = tileIds[ti];
+                // tile area in the atlas image coordinates
+                const int tileX = (tileId % tilesPerSide) * tileSide;
+                const int tileY = (tileId / tilesPerSide) * tileSide;
+
+                TiledAccuAtlas::AccuPixel* tilePixels = accuAtlas.acquireTile(tileId);
+                if (tilePixels == nullptr)
+                {
+                    tileFailure = true;
+                    continue;
+                }
+
+                for (const int contributionId : contributionsPerTile[tileId])
+                {
+                    const TriangleContribution& contribution = contributions[contributionId];
+
+                    // retrieve triangle 3D and UV coordinates
+                    Point2d triPixs[3];
+                    Point3d triPts[3];
+                    getTriangleCoordinates(*mesh, contribution.triangleId, texParams.textureSide, triPixs, triPts);
+
+                    // triangle bounding box, clamped to the tile
+                    Pixel LU, RD;
+                    LU.x = static_cast<int>(std::floor(std::min({triPixs[0].x, triPixs[1].x, triPixs[2].x})));
+                    LU.y = static_cast<int>(std::floor(std::min({triPixs[0].y, triPixs[1].y, triPixs[2].y})));
+                    RD.x = static_cast<int>(std::ceil(std::max({triPixs[0].x, triPixs[1].x, triPixs[2].x})));
+                    RD.y = static_cast<int>(std::ceil(std::max({triPixs[0].y, triPixs[1].y, triPixs[2].y})));
+                    LU.x = clamp(LU.x, tileX, std::min(tileX + tileSide, texSide));
+                    RD.x = clamp(RD.x, tileX, std::min(tileX + tileSide, texSide));
+                    LU.y = clamp(LU.y, std::max(texSide - tileY - tileSide, 0), texSide - tileY);
+                    RD.y = clamp(RD.y, std::max(texSide - tileY - tileSide, 0), texSide - tileY);
+
+                    for (int y = LU.y; y < RD.y; ++y)
+                    {
+                        for (int x = LU.x; x < RD.x; ++x)
+                        {
+                            Pixel pix(x, y);  // top-left corner of the pixel
+                            Point2d barycCoords;
+
+                            // test if the pixel is inside triangle
+                            // and retrieve its barycentric coordinates
+                            if (!isPixelInTriangle(triPixs, pix, barycCoords))
+                                continue;
+
+                            // remap 'y' to image coordinates system (inverted Y axis)
+                            const int y_ = (texSide - 1) - y;
+                            // 1D pixel index in the tile
+                            const std::size_t tileOffset = std::size_t(y_ - tileY) * tileSide + (x - tileX);
+                            // get 3D coordinates
+                            Point3d pt3d = barycentricToCartesian(triPts, barycCoords);
+                            // get 2D coordinates in source image
+                            Point2d pixRC;
+                            mp.getPixelFor3DPoint(&pixRC, pt3d, camId);
+                            // exclude out of bounds pixels
+                            if (!mp.isPixelInImage(pixRC, camId))
+                                continue;
+
+                            // If the color is pure zero (ie. no contributions), we consider it as an invalid pixel.
+                            if (getInterpolateColor(camImg, pixRC.y, pixRC.x) == image::RGBfColor(0.f, 0.f, 0.f))
+                                continue;
+
+                            // each frequency band also contributes to lower frequencies (higher band indexes)
+                            for (std::size_t bandContrib = contribution.band; bandContrib < pyramidL.size(); ++bandContrib)
+                            {
+                                int downscaleCoef = std::pow(texParams.multiBandDownscale, bandContrib);
+                                TiledAccuAtlas::AccuPixel& accuPixel = tilePixels[bandContrib * tileSide * tileSide + tileOffset];
+
+                                const auto pixDownscaled = pixRC / downscaleCoef;
+                                accuPixel.color += getInterpolateColor(pyramidL[bandContrib], pixDownscaled.y, pixDownscaled.x) * contribution.score;
+                                accuPixel.count += contribution.score;
+                            }
+                        }
+                    }
+                }
+
+                accuAtlas.releaseTile(tileId);
+            }
+
+            if (tileFailure)
+                throw std::runtime_error("Unable to acquire the tiles of the texture atlas " + std::to_string(c.first + 1) + ".");
+        }
+    }
+
+    // average and fuse the frequency bands tile by tile, then write the textures one by one
+    for (std::size_t atlasID = 0; atlasID < _atlases.size(); ++atlasID)
+    {
+        ALICEVISION_LOG_INFO("Create texture " << atlasID + 1);
+
+        TiledAccuAtlas& accuAtlas = *accuAtlases[atlasID];
+        const int tilesPerSide = accuAtlas.getTilesPerSide();
+
+        AccuImage atlasTexture;
+        atlasTexture.resize(texSide, texSide);
+
+        for (int tileId = 0; tileId < accuAtlas.getTileCount(); ++tileId)
+        {
+            if (!accuAtlas.hasTile(tileId))
+                continue;
+
+            const TiledAccuAtlas::AccuPixel* tilePixels = accuAtlas.acquireTile(tileId);
+            if (tilePixels == nullptr)
+                throw std::runtime_error("Unable to acquire a tile of the texture atlas " + std::to_string(atlasID + 1) + ".");
+
+            const int tileX = (tileId % tilesPerSide) * tileSide;
+            const int tileY = (tileId / tilesPerSide) * tileSide;
+            const int width = std::min(tileSide, texSide - tileX);
+            const int height = std::min(tileSide, texSide - tileY);
+
+#pragma omp parallel for
+            for (int yp = 0; yp < height; ++yp)
+            {
+                for (int xp = 0; xp < width; ++xp)
+                {
+                    const std::size_t tileOffset = std::size_t(yp) * tileSide + xp;
+                    const std::size_t xyoffset = std::size_t(tileY + yp) * texSide + tileX + xp;
+
+                    // same as the average and the fusion of generateTexturesSubSet
+                    // If the count is valid on the first band, it will be valid on all the other bands
+                    const bool valid = tilePixels[tileOffset].count != 0;
+                    image::RGBfColor color(0.0f);
+                    for (int level = 0; level < nbBand; ++level)
+                    {
+                        const TiledAccuAtlas::AccuPixel& accuPixel = tilePixels[std::size_t(level) * tileSide * tileSide + tileOffset];
+                        color += valid ? accuPixel.color / accuPixel.count : accuPixel.color;
+                    }
+                    atlasTexture.img(xyoffset) = color;
+                    atlasTexture.imgCount[xyoffset] = valid ? 1 : 0;
+                }
+            }
+
+            accuAtlas.releaseTile(tileId);
+        }
+
+        // the tiles of the atlas are not needed anymore
+        accuAtlases[atlasID].reset();
+
+        writeTexture(atlasTexture, atlasID, outPath, textureFileType, -1, &textureWriter);
     }
 }
 
@@ -768,7 +1269,19 @@ void Texturing::writeTexture(AccuImage& atlasTexture,
                              const std::size_t atlasID,
                              const std::filesystem::path& outPath,
                              image::EImageFileType textureFileType,
-                             const int level)
+                             const int level,
+                             image::AsyncImageWriter* textureWriter)
+{
+    finalizeTexture(atlasTexture, level);
+
+    material.diffuseType = textureFileType;
+    const std::string textureName = material.textureName(Material::TextureType::DIFFUSE, static_cast<int>(atlasID));
+    material.addTexture(Material::TextureType::DIFFUSE, textureName);
+
+    writeTextureFile(atlasTexture, outPath / textureName, textureWriter);
+}
+
+void Texturing::finalizeTexture(AccuImage& atlasTexture, const int level) const
 {
     unsigned int outTextureSide = texParams.textureSide;
     // WARNING: we modify the "imgCount" to apply the padding (to avoid the creation of a new buffer)
@@ -893,20 +1406,24 @@ void Texturing::writeTexture(AccuImage& atlasTexture,
         imageAlgo::resizeImage(texParams.downscale, atlasTexture.img, resizedColorBuffer);
         std::swap(resizedColorBuffer, atlasTexture.img);
     }
+}
 
-    material.diffuseType = textureFileType;
-    const std::string textureName = material.textureName(Material::TextureType::DIFFUSE, static_cast<int>(atlasID));
-    material.addTexture(Material::TextureType::DIFFUSE, textureName);
-
-    fs::path texturePath = outPath / textureName;
+void Texturing::writeTextureFile(AccuImage& atlasTexture, const fs::path& texturePath, image::AsyncImageWriter* textureWriter) const
+{
     ALICEVISION_LOG_INFO("  - Writing texture file: " << texturePath.string());
 
-    image::writeImage(texturePath.string(),
-                      atlasTexture.img,
-                      image::ImageWriteOptions()
-                        .fromColorSpace(texParams.workingColorSpace)
-                        .toColorSpace(texParams.outputColorSpace)
-                        .storageDataType(image::EStorageDataType::Half));
+    image::ImageWriteOptions writeOptions = image::ImageWriteOptions()
+                                              .fromColorSpace(texParams.workingColorSpace)
+                                              .toColorSpace(texParams.outputColorSpace)
+                                              .storageDataType(image::EStorageDataType::Half);
+
+    // tiled MIP-mapped texture, written directly from the atlas texture (no conversion pass)
+    if (texParams.tiledTextures)
+        writeOptions.tileSize(256, 256).mipmap(true);
+    if (textureWriter)
+        textureWriter->write(texturePath.string(), std::move(atlasTexture.img), writeOptions);
+    else
+        image::writeImage(texturePath.string(), atlasTexture.img, writeOptions);
 }
 
 void Texturing::clear()
@@ -958,7 +1475,10 @@ void Texturing::loadWithMaterial(const std::string& filepath, bool flipNormals)
     }
 }
 
-void Texturing::remapVisibilities(EVisibilityRemappingMethod remappingMethod, const mvsUtils::MultiViewParams& mp, const Mesh& refMesh)
+void Texturing::remapVisibilities(EVisibilityRemappingMethod remappingMethod,
+                                  const mvsUtils::MultiViewParams& mp,
+                                  const Mesh& refMesh,
+                                  const NearestVertexSearch* refMeshSearch)
 {
     if (refMesh.pointsVisibilities.empty() &&
         (remappingMethod & mesh::EVisibilityRemappingMethod::Pull || remappingMethod & mesh::EVisibilityRemappingMethod::Push))
@@ -969,15 +1489,24 @@ void Texturing::remapVisibilities(EVisibilityRemappingMethod remappingMethod, co
     // remap visibilities from the reference onto the mesh
     if (remappingMethod & mesh::EVisibilityRemappingMethod::Pull)
     {
-        remapMeshVisibilities_pullVerticesVisibility(refMesh, *mesh);
+        if (refMeshSearch)
+            remapMeshVisibilities_pullVerticesVisibility(refMesh, *refMeshSearch, *mesh);
+        else
+            remapMeshVisibilities_pullVerticesVisibility(refMesh, *mesh);
     }
+
+    // the triangles search on the mesh is shared by the Push and MeshItself methods
+    std::unique_ptr<MeshFacetsSearch> meshSearch;
+    if (remappingMethod & mesh::EVisibilityRemappingMethod::Push || remappingMethod & EVisibilityRemappingMethod::MeshItself)
+        meshSearch.reset(new MeshFacetsSearch(*mesh));
+
     if (remappingMethod & mesh::EVisibilityRemappingMethod::Push)
     {
-        remapMeshVisibilities_pushVerticesVisibilityToTriangles(refMesh, *mesh);
+        remapMeshVisibilities_pushVerticesVisibilityToTriangles(refMesh, *mesh, *meshSearch);
     }
     if (remappingMethod & EVisibilityRemappingMethod::MeshItself)
     {
-        remapMeshVisibilities_meshItself(mp, *mesh);
+        remapMeshVisibilities_meshItself(mp, *mesh, *meshSearch);
     }
     if (mesh->pointsVisibilities.empty())
     {
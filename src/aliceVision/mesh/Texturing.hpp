@@ -6,7 +6,7 @@
 
 #pragma once
 
-#include <aliceVision/image/io.hpp>
+#include <aliceVision/image/AsyncImageWriter.hpp>
 #include <aliceVision/image/io.hpp>
 #include <aliceVision/mvsData/Point2d.hpp>
 #include <aliceVision/mvsData/Point3d.hpp>
@@ -19,6 +19,7 @@
 #include <aliceVision/stl/bitmask.hpp>
 
 #include <filesystem>
+#include <map>
 
 namespace fs = std::filesystem;
 
@@ -98,6 +99,10 @@ struct TexturingParams
     EVisibilityRemappingMethod visibilityRemappingMethod = EVisibilityRemappingMethod::PullPush;
 
     float subdivisionTargetRatio = 0.8;
+
+    bool useGpu = false;  //< project and blend the cameras contributions on the GPU (requires a build with CUDA)
+    bool cameraMajorOrder = false;  //< load each camera image once for all the atlases, accumulated out of core
+    bool tiledTextures = false;     //< write the textures as tiled MIP-mapped EXR files, streamed by tiles by the viewers
 };
 
 struct Texturing
@@ -129,9 +134,12 @@ struct Texturing
      * @param[in] remappingMethod the remapping method
      * @param[in] mp multiview scene params
      * @param[in] refMesh the reference mesh
-     * @param[in] refPointsVisibilities the reference visibilities
+     * @param[in] refMeshSearch optional nearest vertex search already built on the reference mesh, for the Pull method
      */
-    void remapVisibilities(EVisibilityRemappingMethod remappingMethod, const mvsUtils::MultiViewParams& mp, const Mesh& refMesh);
+    void remapVisibilities(EVisibilityRemappingMethod remappingMethod,
+                           const mvsUtils::MultiViewParams& mp,
+                           const Mesh& refMesh,
+                           const NearestVertexSearch* refMeshSearch = nullptr);
 
     /**
      * @brief Replace inner mesh with the mesh loaded from 'otherMeshPath'
@@ -192,6 +200,16 @@ struct Texturing
         }
     };
 
+    using AtlasIndex = size_t;
+    using ScorePerTriangle = std::vector<std::pair<unsigned int, float>>;  // list of <triangleId, score>
+    /// contributions of a camera: triangles per frequency band, for each atlas
+    using CameraContributions = std::map<AtlasIndex, std::vector<ScorePerTriangle>>;
+
+    /// Select the best cameras for each triangle of the given atlases and store the contributions per camera
+    void computeContributionsPerCamera(const mvsUtils::MultiViewParams& mp,
+                                       const std::vector<size_t>& atlasIDs,
+                                       std::vector<CameraContributions>& contributionsPerCamera) const;
+
     /// Generate texture files for all texture atlases
     void generateTextures(const mvsUtils::MultiViewParams& mp,
                           const fs::path& outPath,
@@ -202,9 +220,19 @@ struct Texturing
     void generateTexturesSubSet(const mvsUtils::MultiViewParams& mp,
                                 const std::vector<size_t>& atlasIDs,
                                 mvsUtils::ImagesCache<image::Image<image::RGBfColor>>& imageCache,
+                                image::AsyncImageWriter& textureWriter,
                                 const fs::path& outPath,
                                 image::EImageFileType textureFileType = image::EImageFileType::PNG);
 
+    /// Generate texture files for all texture atlases, loading each camera image once:
+    /// the atlases are accumulated by tiles, moved out of core when they don't fit in memory
+    void generateTexturesCameraMajor(const mvsUtils::MultiViewParams& mp,
+                                     mvsUtils::ImagesCache<image::Image<image::RGBfColor>>& imageCache,
+                                     image::AsyncImageWriter& textureWriter,
+                                     const fs::path& outPath,
+                                     size_t memoryAvailable,
+                                     image::EImageFileType textureFileType = image::EImageFileType::PNG);
+
     void generateNormalAndHeightMaps(const mvsUtils::MultiViewParams& mp,
                                      const Mesh& denseMesh,
                                      const fs::path& outPath,
@@ -219,11 +247,20 @@ struct Texturing
                                       const mesh::BumpMappingParams& bumpMappingParams);
 
     /// Fill holes and write texture files for the given texture atlas
+    /// If a writer is given, the atlas image is moved to it and written in the background
     void writeTexture(AccuImage& atlasTexture,
                       const std::size_t atlasID,
                       const fs::path& outPath,
                       image::EImageFileType textureFileType,
-                      const int level);
+                      const int level,
+                      image::AsyncImageWriter* textureWriter = nullptr);
+
+    /// Edge padding (or holes filling) and downscale of the given texture atlas, in place
+    /// Does not modify the Texturing state, can be called from several threads on different atlases
+    void finalizeTexture(AccuImage& atlasTexture, const int level) const;
+
+    /// Write the given finalized texture atlas file, moved to the writer if given
+    void writeTextureFile(AccuImage& atlasTexture, const fs::path& texturePath, image::AsyncImageWriter* textureWriter) const;
 
     /// Save textured mesh as an OBJ + MTL file
     void saveAs(const fs::path& dir, const std::string& basename, aliceVision::mesh::EFileType meshFileType = aliceVision::mesh::EFileType::OBJ);
@@ -0,0 +1,86 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "TiledAccuAtlas.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace aliceVision {
+namespace mesh {
+
+TiledAccuAtlas::TiledAccuAtlas(const std::shared_ptr<image::TileCacheManager>& manager, int textureSide, int nbBands)
+  : _manager(manager),
+    _textureSide(textureSide),
+    _nbBands(nbBands)
+{
+    if (!_manager || _manager->getTileWidth() != tileSide || _manager->getTileHeight() != tileSide)
+    {
+        throw std::invalid_argument("Invalid tile cache manager for the accumulated atlas.");
+    }
+
+    _tilesPerSide = (_textureSide + tileSide - 1) / tileSide;
+    _tiles.resize(getTileCount());
+}
+
+bool TiledAccuAtlas::hasTile(int tileId) const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _tiles[tileId] != nullptr;
+}
+
+TiledAccuAtlas::AccuPixel* TiledAccuAtlas::acquireTile(int tileId)
+{
+    image::CachedTile::smart_pointer tile;
+    bool created = false;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        tile = _tiles[tileId];
+        if (!tile)
+        {
+            const int x = (tileId % _tilesPerSide) * tileSide;
+            const int y = (tileId / _tilesPerSide) * tileSide;
+            tile = _manager->requireNewCachedTile(std::min(tileSide, _textureSide - x), std::min(tileSide, _textureSide - y), _nbBands * sizeof(AccuPixel));
+            if (!tile)
+            {
+                return nullptr;
+            }
+            _tiles[tileId] = tile;
+            created = true;
+        }
+    }
+
+    if (!tile->acquire(true))
+    {
+        return nullptr;
+    }
+
+    AccuPixel* pixels = reinterpret_cast<AccuPixel*>(tile->getDataPointer());
+    if (created)
+    {
+        // the new tiles are not initialized by the manager
+        std::fill(pixels, pixels + std::size_t(tileSide) * tileSide * _nbBands, AccuPixel{image::RGBfColor(0.0f), 0.0f});
+    }
+
+    return pixels;
+}
+
+void TiledAccuAtlas::releaseTile(int tileId)
+{
+    image::CachedTile::smart_pointer tile;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        tile = _tiles[tileId];
+    }
+
+    if (tile)
+    {
+        tile->release();
+    }
+}
+
+}  // namespace mesh
+}  // namespace aliceVision
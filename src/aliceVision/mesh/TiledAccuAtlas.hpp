@@ -0,0 +1,87 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/image/cache.hpp>
+#include <aliceVision/image/pixelTypes.hpp>
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace aliceVision {
+namespace mesh {
+
+/**
+ * @brief Accumulated frequency bands of a texture atlas, stored by tiles in a TileCacheManager.
+ *
+ * The tiles are created on their first use, so the empty areas of the atlas don't use any memory,
+ * and the least recently used tiles are moved out of core when the memory of the manager is full.
+ * A tile contains all the frequency bands of its pixels, in the atlas image coordinates (inverted Y axis).
+ */
+class TiledAccuAtlas
+{
+  public:
+    struct AccuPixel
+    {
+        image::RGBfColor color;
+        float count;
+    };
+
+    /// side of the tiles in pixels, a power of 2 as required by the TileCacheManager
+    static constexpr int tileSide = 256;
+
+    /**
+     * @brief Constructor
+     * @param[in] manager the cache manager, created with tileSide x tileSide tiles
+     * @param[in] textureSide the side of the atlas in pixels
+     * @param[in] nbBands the number of frequency bands
+     */
+    TiledAccuAtlas(const std::shared_ptr<image::TileCacheManager>& manager, int textureSide, int nbBands);
+
+    TiledAccuAtlas(const TiledAccuAtlas&) = delete;
+    TiledAccuAtlas& operator=(const TiledAccuAtlas&) = delete;
+
+    int getTilesPerSide() const { return _tilesPerSide; }
+    int getTileCount() const { return _tilesPerSide * _tilesPerSide; }
+    int getNbBands() const { return _nbBands; }
+
+    /// @return true if the tile has received contributions
+    bool hasTile(int tileId) const;
+
+    /**
+     * @brief Acquire the pixels of a tile in core, the tile is created and cleared if needed.
+     *        The tile stays in core until it is released. A tile must not be acquired by several threads at the same time.
+     * @param[in] tileId the tile index, row major in the atlas image coordinates
+     * @return the pixels of the tile, [band][y][x] with tileSide x tileSide pixels per band,
+     *         or nullptr if the tile can't be acquired
+     */
+    AccuPixel* acquireTile(int tileId);
+
+    /**
+     * @brief Release a tile acquired with acquireTile.
+     * @param[in] tileId the tile index
+     */
+    void releaseTile(int tileId);
+
+    /**
+     * @return The memory of a tile in bytes
+     */
+    static std::size_t getTileMemorySize(int nbBands) { return std::size_t(tileSide) * tileSide * nbBands * sizeof(AccuPixel); }
+
+  private:
+    std::shared_ptr<image::TileCacheManager> _manager;
+    std::vector<image::CachedTile::smart_pointer> _tiles;
+    int _textureSide;
+    int _nbBands;
+    int _tilesPerSide;
+    /// Protects the creation of the tiles
+    mutable std::mutex _mutex;
+};
+
+}  // namespace mesh
+}  // namespace aliceVision
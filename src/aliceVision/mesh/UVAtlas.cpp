@@ -5,13 +5,61 @@
 // You can obtain one at https://mozilla.org/MPL/2.0/.
 
 #include "UVAtlas.hpp"
+#include <aliceVision/alicevision_omp.hpp>
 #include <aliceVision/system/Logger.hpp>
 
+#include <algorithm>
+#include <cstdint>
 #include <iostream>
 
 namespace aliceVision {
 namespace mesh {
 
+namespace {
+
+/// a mesh edge as its sorted vertex pair, and one of its triangles
+struct EdgeTriangle
+{
+    std::uint64_t edge;
+    int triangleID;
+    bool operator<(const EdgeTriangle& other) const { return edge < other.edge || (edge == other.edge && triangleID < other.triangleID); }
+};
+
+/**
+ * @brief Sort a vector with OpenMP: the chunks of the vector are sorted in parallel, then merged by pairs.
+ */
+template<typename T>
+void parallelSort(std::vector<T>& values)
+{
+    const std::size_t minChunkSize = 1 << 16;
+    const int nbChunks = std::max(1, std::min(omp_get_max_threads(), int(values.size() / minChunkSize)));
+    if (nbChunks == 1)
+    {
+        std::sort(values.begin(), values.end());
+        return;
+    }
+
+    std::vector<std::size_t> bounds(nbChunks + 1);
+    for (int c = 0; c <= nbChunks; ++c)
+        bounds[c] = values.size() * c / nbChunks;
+
+#pragma omp parallel for
+    for (int c = 0; c < nbChunks; ++c)
+        std::sort(values.begin() + bounds[c], values.begin() + bounds[c + 1]);
+
+    for (int step = 1; step < nbChunks; step *= 2)
+    {
+#pragma omp parallel for
+        for (int c = 0; c < nbChunks - step; c += 2 * step)
+        {
+            const std::size_t end = bounds[std::min(c + 2 * step, nbChunks)];
+            std::inplace_merge(values.begin() + bounds[c], values.begin() + bounds[c + step], values.begin() + end);
+        }
+    }
+}
+
+}  // namespace
+
 UVAtlas::UVAtlas(const Mesh& mesh, mvsUtils::MultiViewParams& mp, unsigned int textureSide, unsigned int gutterSize)
   : _textureSide(textureSide),
     _gutterSize(gutterSize),
@@ -89,65 +137,28 @@ void UVAtlas::packCharts(std::vector<Chart>& charts, mvsUtils::MultiViewParams&
 {
     ALICEVISION_LOG_INFO("Packing texture charts (" << charts.size() << " charts).");
 
-    std::function<int(int)> findChart = [&](int cid) {
-        Chart& c = charts[cid];
-        if (c.mergedWith >= 0)
-        {
-            int r = findChart(c.mergedWith);
-            c.mergedWith = r;
-            return r;
-        }
-        return cid;
-    };
-
-    // list mesh edges (with duplicates)
-    std::vector<Edge> alledges;
-    for (int i = 0; i < _mesh.tris.size(); ++i)
-    {
-        int a = _mesh.tris[i].v[0];
-        int b = _mesh.tris[i].v[1];
-        int c = _mesh.tris[i].v[2];
-        Edge e1;
-        e1.pointIDs = std::make_pair(std::min(a, b), std::max(a, b));
-        e1.triangleIDs.emplace_back(i);
-        alledges.emplace_back(e1);
-        Edge e2;
-        e2.pointIDs = std::make_pair(std::min(b, c), std::max(b, c));
-        e2.triangleIDs.emplace_back(i);
-        alledges.emplace_back(e2);
-        Edge e3;
-        e3.pointIDs = std::make_pair(std::min(c, a), std::max(c, a));
-        e3.triangleIDs.emplace_back(i);
-        alledges.emplace_back(e3);
-    }
-    std::sort(alledges.begin(), alledges.end());
+    const int nbTriangles = _mesh.tris.size();
 
-    // merge edges (no duplicate)
-    std::vector<Edge> edges;
-    auto eit = alledges.begin() + 1;
-    while (eit != alledges.end())
-    {
-        auto& a = *(eit - 1);
-        auto& b = *eit;
-        if (a == b)
+    // find the chart a triangle belongs to, with path compression
+    const auto findChart = [&](int cid) {
+        int root = cid;
+        while (charts[root].mergedWith >= 0)
+            root = charts[root].mergedWith;
+        while (charts[cid].mergedWith >= 0)
         {
-            a.triangleIDs.insert(a.triangleIDs.end(), b.triangleIDs.begin(), b.triangleIDs.end());
-            sort(a.triangleIDs.begin(), a.triangleIDs.end());
-            edges.push_back(a);
+            const int next = charts[cid].mergedWith;
+            charts[cid].mergedWith = root;
+            cid = next;
         }
-        ++eit;
-    }
-    alledges.clear();
+        return root;
+    };
 
-    // merge charts
-    for (auto& e : edges)
-    {
-        if (e.triangleIDs.size() != 2)
-            continue;
-        int chartIDA = findChart(e.triangleIDs[0]);
-        int chartIDB = findChart(e.triangleIDs[1]);
+    // merge the charts of two adjacent triangles if they have at least 1 camera in common
+    const auto mergeCharts = [&](int triangleA, int triangleB) {
+        const int chartIDA = findChart(triangleA);
+        const int chartIDB = findChart(triangleB);
         if (chartIDA == chartIDB)
-            continue;
+            return;
         Chart& a = charts[chartIDA];
         Chart& b = charts[chartIDB];
         std::vector<int> cameraIntersection;
@@ -157,13 +168,14 @@ void UVAtlas::packCharts(std::vector<Chart>& charts, mvsUtils::MultiViewParams&
                               b.commonCameraIDs.end(),
                               std::back_inserter(cameraIntersection));
         if (cameraIntersection.empty())  // need at least 1 camera in common
-            continue;
+            return;
         if (a.triangleIDs.size() > b.triangleIDs.size())
         {
             // merge b in a
             a.commonCameraIDs = cameraIntersection;
             a.triangleIDs.insert(a.triangleIDs.end(), b.triangleIDs.begin(), b.triangleIDs.end());
             b.mergedWith = chartIDA;
+            std::vector<int>().swap(b.triangleIDs);
         }
         else
         {
@@ -171,14 +183,124 @@ void UVAtlas::packCharts(std::vector<Chart>& charts, mvsUtils::MultiViewParams&
             b.commonCameraIDs = cameraIntersection;
             b.triangleIDs.insert(b.triangleIDs.end(), a.triangleIDs.begin(), a.triangleIDs.end());
             a.mergedWith = chartIDB;
+            std::vector<int>().swap(a.triangleIDs);
+        }
+    };
+
+    // list mesh edges (with duplicates): sorted vertex pair and triangle
+    std::vector<EdgeTriangle> edgeTriangles(3 * std::size_t(nbTriangles));
+#pragma omp parallel for
+    for (int i = 0; i < nbTriangles; ++i)
+    {
+        for (int k = 0; k < 3; ++k)
+        {
+            const std::uint32_t a = _mesh.tris[i].v[k];
+            const std::uint32_t b = _mesh.tris[i].v[(k + 1) % 3];
+            edgeTriangles[3 * std::size_t(i) + k] = {(std::uint64_t(std::min(a, b)) << 32) | std::max(a, b), i};
         }
     }
-    edges.clear();
+    parallelSort(edgeTriangles);
+
+    // partition the mesh in spatially coherent parts, merged independently
+    const std::vector<int> trianglesPart = computeTrianglesPart();
+    const int nbParts = trianglesPart.empty() ? 1 : (*std::max_element(trianglesPart.begin(), trianglesPart.end()) + 1);
+    ALICEVISION_LOG_INFO("Merging texture charts in " << nbParts << " parts.");
+
+    // edges between the consecutive triangles sharing the same vertex pair
+    std::vector<std::vector<std::pair<int, int>>> partsEdges(nbParts);
+    std::vector<std::pair<int, int>> crossEdges;
+    for (std::size_t e = 1; e < edgeTriangles.size(); ++e)
+    {
+        if (edgeTriangles[e - 1].edge != edgeTriangles[e].edge)
+            continue;
+        const int triangleA = edgeTriangles[e - 1].triangleID;
+        const int triangleB = edgeTriangles[e].triangleID;
+        const int part = trianglesPart.empty() ? 0 : trianglesPart[triangleA];
+        if (trianglesPart.empty() || part == trianglesPart[triangleB])
+            partsEdges[part].emplace_back(triangleA, triangleB);
+        else
+            crossEdges.emplace_back(triangleA, triangleB);
+    }
+    std::vector<EdgeTriangle>().swap(edgeTriangles);
+
+    // merge charts: the parts don't share any chart, they are merged in parallel
+#pragma omp parallel for schedule(dynamic)
+    for (int part = 0; part < nbParts; ++part)
+    {
+        for (const auto& edge : partsEdges[part])
+            mergeCharts(edge.first, edge.second);
+    }
+    partsEdges.clear();
+
+    // then the charts are merged across the parts
+    for (const auto& edge : crossEdges)
+        mergeCharts(edge.first, edge.second);
+    crossEdges.clear();
 
     // remove merged charts
     charts.erase(remove_if(charts.begin(), charts.end(), [](Chart& c) { return (c.mergedWith >= 0); }), charts.end());
 }
 
+std::vector<int> UVAtlas::computeTrianglesPart() const
+{
+    const int nbTriangles = _mesh.tris.size();
+    const int nbParts = (nbTriangles + partMaxSize - 1) / partMaxSize;
+    if (nbParts <= 1)
+        return std::vector<int>();
+
+    // triangles centers bounding box
+    std::vector<Point3d> centers(nbTriangles);
+#pragma omp parallel for
+    for (int i = 0; i < nbTriangles; ++i)
+        centers[i] = _mesh.computeTriangleCenterOfGravity(i);
+
+    Point3d bboxMin = centers.front();
+    Point3d bboxMax = centers.front();
+    for (const Point3d& c : centers)
+    {
+        bboxMin.x = std::min(bboxMin.x, c.x);
+        bboxMin.y = std::min(bboxMin.y, c.y);
+        bboxMin.z = std::min(bboxMin.z, c.z);
+        bboxMax.x = std::max(bboxMax.x, c.x);
+        bboxMax.y = std::max(bboxMax.y, c.y);
+        bboxMax.z = std::max(bboxMax.z, c.z);
+    }
+
+    // sort the triangles along a Morton curve and split the curve in parts of the same size
+    const auto quantize = [](double value, double minValue, double maxValue) {
+        const double range = maxValue - minValue;
+        return range > 0.0 ? std::min<std::uint64_t>(std::uint64_t((value - minValue) / range * 2097152.0), 2097151) : 0;
+    };
+    const auto spreadBits = [](std::uint64_t v) {
+        // insert 2 zeros between each of the 21 bits
+        v &= 0x1fffff;
+        v = (v | v << 32) & 0x1f00000000ffff;
+        v = (v | v << 16) & 0x1f0000ff0000ff;
+        v = (v | v << 8) & 0x100f00f00f00f00f;
+        v = (v | v << 4) & 0x10c30c30c30c30c3;
+        v = (v | v << 2) & 0x1249249249249249;
+        return v;
+    };
+
+    std::vector<std::pair<std::uint64_t, int>> codes(nbTriangles);
+#pragma omp parallel for
+    for (int i = 0; i < nbTriangles; ++i)
+    {
+        const Point3d& c = centers[i];
+        const std::uint64_t code = spreadBits(quantize(c.x, bboxMin.x, bboxMax.x)) | (spreadBits(quantize(c.y, bboxMin.y, bboxMax.y)) << 1) |
+                                   (spreadBits(quantize(c.z, bboxMin.z, bboxMax.z)) << 2);
+        codes[i] = std::make_pair(code, i);
+    }
+    parallelSort(codes);
+
+    std::vector<int> trianglesPart(nbTriangles);
+#pragma omp parallel for
+    for (int i = 0; i < nbTriangles; ++i)
+        trianglesPart[codes[i].second] = int(std::size_t(i) * nbParts / nbTriangles);
+
+    return trianglesPart;
+}
+
 void UVAtlas::finalizeCharts(std::vector<Chart>& charts, mvsUtils::MultiViewParams& mp)
 {
     ALICEVISION_LOG_INFO("Finalize packed charts (" << charts.size() << " charts).");
@@ -236,147 +358,67 @@ void UVAtlas::createTextureAtlases(std::vector<Chart>& charts, mvsUtils::MultiVi
     ALICEVISION_LOG_INFO("Creating texture atlases.");
 
     // sort charts by size, descending
-    std::sort(charts.begin(), charts.end(), [](const Chart& a, const Chart& b) {
-        int wa = a.targetWidth();
-        int wb = b.targetWidth();
-        if (wa == wb)
-            return a.targetHeight() > b.targetHeight();
-        return wa > wb;
-    });
-
-    std::size_t i = 0;                  // forward index
-    std::size_t j = charts.size() - 1;  // backward index
-    std::size_t texCount = 0;
-
-    // insert charts into one or more texture atlas
-    while (i <= j)
-    {
-        texCount++;
-        // create a texture atlas
-        ALICEVISION_LOG_INFO("\t- texture atlas " << texCount);
-        std::vector<Chart> atlas;
-        // create a tree root
-        ChartRect* root = new ChartRect();
-        root->LU.x = 0;
-        root->LU.y = 0;
-        root->RD.x = _textureSide - 1;
-        root->RD.y = _textureSide - 1;
-
-        const auto insertChart = [&](size_t idx) -> bool {
-            Chart& chart = charts[idx];
-            ChartRect* rect = root->insert(chart, _gutterSize);
-            if (!rect)
-                return false;
-
-            // store the final position
-            chart.targetLU = rect->LU;
-            chart.targetLU.x += _gutterSize;
-            chart.targetLU.y += _gutterSize;
-            // add to the current texture atlas
-            atlas.emplace_back(chart);
-            return true;
-        };
-        // insert as many charts as possible in forward direction (largest to smallest)
-        while (i <= j && insertChart(i))
-        {
-            ++i;
-        }
-        // fill potential empty space (i != j) in backward direction
-        while (j > i && insertChart(j))
-        {
-            --j;
-        }
-
+    std::vector<std::pair<std::pair<int, int>, int>> chartsOrder(charts.size());  // <<height, width>, chartID>
+#pragma omp parallel for
+    for (int i = 0; i < charts.size(); ++i)
+        chartsOrder[i] = std::make_pair(std::make_pair(-charts[i].targetHeight(), -charts[i].targetWidth()), i);
+    parallelSort(chartsOrder);
+
+    // shelf packing: the charts are placed from left to right in rows (shelves) as high as their first chart,
+    // a new shelf is started below when the current one is full and a new texture atlas when there is no room for a new shelf
+    const int availableSize = _textureSide - 1;
+    int shelfY = 0;
+    int shelfHeight = 0;
+    int x = 0;
+    std::vector<Chart> atlas;
+
+    const auto addTextureAtlas = [&]() {
         if (atlas.empty())
             throw std::runtime_error("Unable to add any chart to this atlas");
 
         // atlas is full or all charts have been handled
-        ALICEVISION_LOG_INFO("Filled with " << atlas.size() << " charts.");
+        ALICEVISION_LOG_INFO("\t- texture atlas " << _atlases.size() + 1 << " filled with " << atlas.size() << " charts.");
         // store this texture
-        _atlases.emplace_back(atlas);
-        // clear the whole tree
-        root->clear();
-        delete root;
-    }
-}
-
-void UVAtlas::ChartRect::clear()
-{
-    if (child[0])
-        child[0]->clear();
-    if (child[1])
-        child[1]->clear();
-    delete child[0];
-    delete child[1];
-}
+        _atlases.emplace_back(std::move(atlas));
+        atlas.clear();
+        shelfY = 0;
+        shelfHeight = 0;
+        x = 0;
+    };
 
-UVAtlas::ChartRect* UVAtlas::ChartRect::insert(Chart& chart, size_t gutter)
-{
-    if (child[0] || child[1])  // not a leaf
-    {
-        if (child[0])
-            if (ChartRect* rect = child[0]->insert(chart, gutter))
-                return rect;
-        if (child[1])
-            if (ChartRect* rect = child[1]->insert(chart, gutter))
-                return rect;
-        return nullptr;
-    }
-    else
+    for (const auto& order : chartsOrder)
     {
-        size_t chartWidth = chart.targetWidth() + gutter * 2;
-        size_t chartHeight = chart.targetHeight() + gutter * 2;
-        // if there is already a chart here
-        if (c)
-            return nullptr;
-        // not enough space
-        if (chartWidth > (RD.x - LU.x))
-            return nullptr;
-        if (chartHeight > (RD.y - LU.y))
-            return nullptr;
-        // split & create children
-        if (chartWidth >= chartHeight)
+        Chart& chart = charts[order.second];
+        const int chartWidth = chart.targetWidth() + _gutterSize * 2;
+        const int chartHeight = chart.targetHeight() + _gutterSize * 2;
+
+        if (x + chartWidth > availableSize)
         {
-            if (chartWidth < (RD.x - LU.x))
-            {
-                child[0] = new ChartRect();
-                child[0]->LU.x = LU.x + chartWidth;
-                child[0]->LU.y = LU.y;
-                child[0]->RD.x = RD.x;
-                child[0]->RD.y = LU.y + chartHeight;
-            }
-            if (chartHeight < (RD.y - LU.y))
-            {
-                child[1] = new ChartRect();
-                child[1]->LU.x = LU.x;
-                child[1]->LU.y = LU.y + chartHeight;
-                child[1]->RD.x = RD.x;
-                child[1]->RD.y = RD.y;
-            }
+            // start a new shelf
+            shelfY += shelfHeight;
+            shelfHeight = 0;
+            x = 0;
         }
-        else
+        if (shelfY + chartHeight > availableSize)
         {
-            if (chartHeight < (RD.y - LU.y))
-            {
-                child[0] = new ChartRect();
-                child[0]->LU.x = LU.x;
-                child[0]->LU.y = LU.y + chartHeight;
-                child[0]->RD.x = LU.x + chartWidth;
-                child[0]->RD.y = RD.y;
-            }
-            if (chartWidth < (RD.x - LU.x))
-            {
-                child[1] = new ChartRect();
-                child[1]->LU.x = LU.x + chartWidth;
-                child[1]->LU.y = LU.y;
-                child[1]->RD.x = RD.x;
-                child[1]->RD.y = RD.y;
-            }
+            // start a new texture atlas
+            addTextureAtlas();
         }
-        // insert chart
-        c = &chart;
-        return this;
+        if (chartWidth > availableSize || chartHeight > availableSize)
+            throw std::runtime_error("Unable to add a chart larger than the texture atlas");
+
+        // store the final position
+        chart.targetLU.x = x + _gutterSize;
+        chart.targetLU.y = shelfY + _gutterSize;
+        x += chartWidth;
+        shelfHeight = std::max(shelfHeight, chartHeight);
+
+        // add to the current texture atlas
+        atlas.emplace_back(std::move(chart));
     }
+
+    if (!atlas.empty())
+        addTextureAtlas();
 }
 
 }  // namespace mesh
@@ -46,16 +46,6 @@ class UVAtlas
         int targetHeight() const { return sourceHeight() * downscale; }
     };
 
-    struct ChartRect
-    {
-        Chart* c = nullptr;
-        ChartRect* child[2]{nullptr, nullptr};
-        Pixel LU;
-        Pixel RD;
-        void clear();
-        ChartRect* insert(Chart& chart, size_t gutter);
-    };
-
   public:
     UVAtlas(const Mesh& mesh, mvsUtils::MultiViewParams& mp, unsigned int textureSide, unsigned int gutterSize);
 
@@ -69,10 +59,15 @@ class UVAtlas
   private:
     void createCharts(std::vector<Chart>& charts, mvsUtils::MultiViewParams& mp);
     void packCharts(std::vector<Chart>& charts, mvsUtils::MultiViewParams& mp);
+    /// Partition the triangles in spatially coherent parts of partMaxSize triangles, empty for a single part
+    std::vector<int> computeTrianglesPart() const;
     void finalizeCharts(std::vector<Chart>& charts, mvsUtils::MultiViewParams& mp);
     void createTextureAtlases(std::vector<Chart>& charts, mvsUtils::MultiViewParams& mp);
 
   private:
+    /// maximal number of triangles of the parts in which the charts are merged in parallel
+    static constexpr int partMaxSize = 100000;
+
     std::vector<std::vector<Chart>> _atlases;
     std::vector<std::vector<int>> _triangleCameraIDs;
     int _textureSide;
@@ -0,0 +1,230 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "DeviceMeshVisibility.hpp"
+
+#include <cuda_runtime.h>
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+#define CHECK_MESH_CUDA_ERROR(err)                                                                                                                   \
+    if (err != cudaSuccess)                                                                                                                          \
+    {                                                                                                                                                \
+        std::stringstream s;                                                                                                                         \
+        s << "\n  CUDA Error: " << cudaGetErrorString(err) << "\n  file:  " << __FILE__ << "\n  function:   " << __FUNCTION__                        \
+          << "\n  line:       " << __LINE__ << "\n";                                                                                                 \
+        throw std::runtime_error(s.str());                                                                                                           \
+    }
+
+namespace aliceVision {
+namespace mesh {
+namespace cuda {
+
+/// Number of threads per block, one thread per triangle or per vertex
+constexpr int BLOCK_SIZE = 128;
+
+/**
+ * @brief Camera parameters, passed by value to the kernels.
+ */
+struct CameraParams
+{
+    double P[12];
+    double C[3];
+    int width;
+    int height;
+    int border;
+    float depthTolerance;
+};
+
+/**
+ * @brief Project a point with the camera projection matrix.
+ * @return The depth of the point, x and y its pixel coordinates
+ */
+__device__ inline double project(const CameraParams& cam, const float* p, double& x, double& y)
+{
+    const double X = p[0];
+    const double Y = p[1];
+    const double Z = p[2];
+    const double u = cam.P[0] * X + cam.P[1] * Y + cam.P[2] * Z + cam.P[3];
+    const double v = cam.P[4] * X + cam.P[5] * Y + cam.P[6] * Z + cam.P[7];
+    const double w = cam.P[8] * X + cam.P[9] * Y + cam.P[10] * Z + cam.P[11];
+    x = u / w;
+    y = v / w;
+    return w;
+}
+
+/**
+ * @brief Rasterize the triangles into the depth map, the pixel centers being on the integer coordinates
+ *        as in MultiViewParams::getPixelFor3DPoint. The depth is interpolated in perspective and
+ *        the positive floats are ordered as their bits, so the closest depth is kept with an integer atomic min.
+ */
+__global__ void rasterize_kernel(CameraParams cam, const float* points, const int* triangles, int nbTriangles, unsigned int* depth)
+{
+    const int triId = blockIdx.x * blockDim.x + threadIdx.x;
+    if (triId >= nbTriangles)
+        return;
+
+    double x[3];
+    double y[3];
+    double invW[3];
+    for (int k = 0; k < 3; ++k)
+    {
+        const double w = project(cam, points + 3 * std::size_t(triangles[3 * triId + k]), x[k], y[k]);
+        // the triangles crossing the camera plane are not rendered
+        if (w <= 0.0)
+            return;
+        invW[k] = 1.0 / w;
+    }
+
+    const double area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+    if (area == 0.0 || isnan(area))
+        return;
+
+    const int xMin = max(int(ceil(fmin(x[0], fmin(x[1], x[2])))), 0);
+    const int xMax = min(int(floor(fmax(x[0], fmax(x[1], x[2])))), cam.width - 1);
+    const int yMin = max(int(ceil(fmin(y[0], fmin(y[1], y[2])))), 0);
+    const int yMax = min(int(floor(fmax(y[0], fmax(y[1], y[2])))), cam.height - 1);
+
+    for (int py = yMin; py <= yMax; ++py)
+    {
+        for (int px = xMin; px <= xMax; ++px)
+        {
+            // barycentric coordinates of the pixel center
+            const double l0 = ((x[1] - px) * (y[2] - py) - (x[2] - px) * (y[1] - py)) / area;
+            const double l1 = ((x[2] - px) * (y[0] - py) - (x[0] - px) * (y[2] - py)) / area;
+            const double l2 = 1.0 - l0 - l1;
+            if (l0 < 0.0 || l1 < 0.0 || l2 < 0.0)
+                continue;
+
+            const float d = float(1.0 / (l0 * invW[0] + l1 * invW[1] + l2 * invW[2]));
+            atomicMin(depth + std::size_t(py) * cam.width + px, __float_as_uint(d));
+        }
+    }
+}
+
+__global__ void visibility_kernel(CameraParams cam, const float* points, const float* normals, int nbPoints, const unsigned int* depth, unsigned char* visible)
+{
+    const int vi = blockIdx.x * blockDim.x + threadIdx.x;
+    if (vi >= nbPoints)
+        return;
+
+    visible[vi] = 0;
+
+    const float* p = points + 3 * std::size_t(vi);
+    double x;
+    double y;
+    const double w = project(cam, p, x, y);
+    if (w <= 0.0)
+        return;
+
+    // same rounding and border as MultiViewParams::getPixelFor3DPoint and isPixelInImage
+    const int px = int(floor(x + 0.5));
+    const int py = int(floor(y + 0.5));
+    if (px < cam.border || px >= cam.width - cam.border || py < cam.border || py >= cam.height - cam.border)
+        return;
+
+    // the vertex must face the camera
+    const float* n = normals + 3 * std::size_t(vi);
+    if ((cam.C[0] - p[0]) * n[0] + (cam.C[1] - p[1]) * n[1] + (cam.C[2] - p[2]) * n[2] < 0.0)
+        return;
+
+    float maxDepth = 0.0f;
+    for (int yy = max(py - 1, 0); yy <= min(py + 1, cam.height - 1); ++yy)
+        for (int xx = max(px - 1, 0); xx <= min(px + 1, cam.width - 1); ++xx)
+            maxDepth = fmaxf(maxDepth, __uint_as_float(depth[std::size_t(yy) * cam.width + xx]));
+
+    visible[vi] = (w <= maxDepth * (1.0f + cam.depthTolerance)) ? 1 : 0;
+}
+
+DeviceMeshVisibility::~DeviceMeshVisibility()
+{
+    // no throw in destructor
+    cudaFree(_points);
+    cudaFree(_normals);
+    cudaFree(_triangles);
+    cudaFree(_depth);
+    cudaFree(_visible);
+}
+
+void DeviceMeshVisibility::setMesh(const std::vector<float>& points, const std::vector<float>& normals, const std::vector<int>& triangles)
+{
+    if (points.size() % 3 != 0 || normals.size() != points.size() || triangles.size() % 3 != 0)
+    {
+        throw std::invalid_argument("DeviceMeshVisibility: invalid mesh.");
+    }
+
+    CHECK_MESH_CUDA_ERROR(cudaFree(_points));
+    CHECK_MESH_CUDA_ERROR(cudaFree(_normals));
+    CHECK_MESH_CUDA_ERROR(cudaFree(_triangles));
+    CHECK_MESH_CUDA_ERROR(cudaFree(_visible));
+    _points = nullptr;
+    _normals = nullptr;
+    _triangles = nullptr;
+    _visible = nullptr;
+
+    _nbPoints = int(points.size() / 3);
+    _nbTriangles = int(triangles.size() / 3);
+
+    CHECK_MESH_CUDA_ERROR(cudaMalloc(&_points, points.size() * sizeof(float)));
+    CHECK_MESH_CUDA_ERROR(cudaMalloc(&_normals, normals.size() * sizeof(float)));
+    CHECK_MESH_CUDA_ERROR(cudaMalloc(&_triangles, triangles.size() * sizeof(int)));
+    CHECK_MESH_CUDA_ERROR(cudaMalloc(&_visible, std::size_t(_nbPoints)));
+
+    CHECK_MESH_CUDA_ERROR(cudaMemcpy(_points, points.data(), points.size() * sizeof(float), cudaMemcpyHostToDevice));
+    CHECK_MESH_CUDA_ERROR(cudaMemcpy(_normals, normals.data(), normals.size() * sizeof(float), cudaMemcpyHostToDevice));
+    CHECK_MESH_CUDA_ERROR(cudaMemcpy(_triangles, triangles.data(), triangles.size() * sizeof(int), cudaMemcpyHostToDevice));
+}
+
+void DeviceMeshVisibility::computeVisibility(const double* P,
+                                             const double* C,
+                                             int width,
+                                             int height,
+                                             int border,
+                                             double depthTolerance,
+                                             std::vector<unsigned char>& out_visible)
+{
+    out_visible.assign(_nbPoints, 0);
+    if (_nbPoints == 0 || width <= 0 || height <= 0)
+        return;
+
+    const std::size_t nbPixels = std::size_t(width) * height;
+    if (nbPixels > _depthCapacity)
+    {
+        CHECK_MESH_CUDA_ERROR(cudaFree(_depth));
+        _depth = nullptr;
+        CHECK_MESH_CUDA_ERROR(cudaMalloc(&_depth, nbPixels * sizeof(unsigned int)));
+        _depthCapacity = nbPixels;
+    }
+    // 0x7f7f7f7f is a large positive float, the depth of the background
+    CHECK_MESH_CUDA_ERROR(cudaMemset(_depth, 0x7f, nbPixels * sizeof(unsigned int)));
+
+    CameraParams cam;
+    std::copy(P, P + 12, cam.P);
+    std::copy(C, C + 3, cam.C);
+    cam.width = width;
+    cam.height = height;
+    cam.border = border;
+    cam.depthTolerance = float(depthTolerance);
+
+    if (_nbTriangles > 0)
+    {
+        const int nbBlocks = (_nbTriangles + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        rasterize_kernel<<<nbBlocks, BLOCK_SIZE>>>(cam, _points, _triangles, _nbTriangles, _depth);
+        CHECK_MESH_CUDA_ERROR(cudaGetLastError());
+    }
+
+    const int nbBlocks = (_nbPoints + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    visibility_kernel<<<nbBlocks, BLOCK_SIZE>>>(cam, _points, _normals, _nbPoints, _depth, _visible);
+    CHECK_MESH_CUDA_ERROR(cudaGetLastError());
+
+    CHECK_MESH_CUDA_ERROR(cudaMemcpy(out_visible.data(), _visible, std::size_t(_nbPoints), cudaMemcpyDeviceToHost));
+}
+
+}  // namespace cuda
+}  // namespace mesh
+}  // namespace aliceVision
@@ -0,0 +1,77 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace aliceVision {
+namespace mesh {
+namespace cuda {
+
+/**
+ * @class DeviceMeshVisibility
+ * @brief Compute the visibility of the mesh vertices from the cameras on the GPU.
+ *
+ * The mesh stays resident on the device. For each camera, the triangles are rasterized into a depth map,
+ * one thread per triangle, then each vertex is tested against the rendered depth, one thread per vertex.
+ */
+class DeviceMeshVisibility
+{
+  public:
+    DeviceMeshVisibility() = default;
+    ~DeviceMeshVisibility();
+
+    // no copy
+    DeviceMeshVisibility(const DeviceMeshVisibility&) = delete;
+    DeviceMeshVisibility& operator=(const DeviceMeshVisibility&) = delete;
+
+    /**
+     * @brief Upload the mesh to the device.
+     * @param[in] points The vertices coordinates, XYZ interleaved
+     * @param[in] normals The vertices normals, XYZ interleaved
+     * @param[in] triangles The vertices indexes of the triangles
+     */
+    void setMesh(const std::vector<float>& points, const std::vector<float>& normals, const std::vector<int>& triangles);
+
+    /**
+     * @brief Render the depth map of a camera and test the visibility of each vertex.
+     *        A vertex is visible if it projects in the image, faces the camera and is not behind the rendered depth
+     *        in its 3x3 pixels neighborhood, so that the vertices on the silhouettes are kept.
+     * @param[in] P The projection matrix, 3x4 row major
+     * @param[in] C The camera center
+     * @param[in] width The width of the camera image
+     * @param[in] height The height of the camera image
+     * @param[in] border The border of the image excluded from the visibility (see MultiViewParams::isPixelInImage)
+     * @param[in] depthTolerance The relative depth tolerance of the occlusion test
+     * @param[out] out_visible The visibility of each vertex
+     */
+    void computeVisibility(const double* P,
+                           const double* C,
+                           int width,
+                           int height,
+                           int border,
+                           double depthTolerance,
+                           std::vector<unsigned char>& out_visible);
+
+  private:
+    float* _points = nullptr;
+    float* _normals = nullptr;
+    int* _triangles = nullptr;
+    int _nbPoints = 0;
+    int _nbTriangles = 0;
+
+    // rendered depth map, reused between cameras
+    unsigned int* _depth = nullptr;
+    std::size_t _depthCapacity = 0;  //< in number of pixels
+
+    unsigned char* _visible = nullptr;
+};
+
+}  // namespace cuda
+}  // namespace mesh
+}  // namespace aliceVision
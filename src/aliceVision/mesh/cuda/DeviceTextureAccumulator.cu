@@ -0,0 +1,405 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "DeviceTextureAccumulator.hpp"
+
+#include <cuda_runtime.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <sstream>
+#include <stdexcept>
+
+#define CHECK_MESH_CUDA_ERROR(err)                                                                                                                   \
+    if (err != cudaSuccess)                                                                                                                          \
+    {                                                                                                                                                \
+        std::stringstream s;                                                                                                                         \
+        s << "\n  CUDA Error: " << cudaGetErrorString(err) << "\n  file:  " << __FILE__ << "\n  function:   " << __FUNCTION__                        \
+          << "\n  line:       " << __LINE__ << "\n";                                                                                                 \
+        throw std::runtime_error(s.str());                                                                                                           \
+    }
+
+namespace aliceVision {
+namespace mesh {
+namespace cuda {
+
+/// Number of threads per block, one thread per triangle
+constexpr int BLOCK_SIZE = 128;
+
+/**
+ * @brief Camera and accumulated pyramids, passed by value to the kernel.
+ */
+struct AccumulationParams
+{
+    double P[12];
+    int border;
+    const float* image;
+    int width;
+    int height;
+    const float* levels[DeviceTextureAccumulator::maxBands];
+    int levelsWidth[DeviceTextureAccumulator::maxBands];
+    int levelsHeight[DeviceTextureAccumulator::maxBands];
+    int nbLevels;
+    int multiBandDownscale;
+    float* colors;
+    float* counts;
+    int nbBands;
+    int textureSide;
+};
+
+/**
+ * @brief Bilinear interpolation of an RGB image, same as image::getInterpolateColor.
+ */
+__device__ inline float3 interpolateColor(const float* image, int width, int height, double y, double x)
+{
+    const int xp = min(int(x), width - 2);
+    const int yp = min(int(y), height - 2);
+
+    const float ui = x - float(xp);
+    const float vi = y - float(yp);
+
+    const float* lu = image + 3 * (std::size_t(yp) * width + xp);
+    const float* ru = lu + 3;
+    const float* ld = lu + 3 * std::size_t(width);
+    const float* rd = ld + 3;
+
+    float3 out;
+    float u = lu[0] + (ru[0] - lu[0]) * ui;
+    float d = ld[0] + (rd[0] - ld[0]) * ui;
+    out.x = u + (d - u) * vi;
+    u = lu[1] + (ru[1] - lu[1]) * ui;
+    d = ld[1] + (rd[1] - ld[1]) * ui;
+    out.y = u + (d - u) * vi;
+    u = lu[2] + (ru[2] - lu[2]) * ui;
+    d = ld[2] + (rd[2] - ld[2]) * ui;
+    out.z = u + (d - u) * vi;
+    return out;
+}
+
+/**
+ * @brief Closest point of a segment [a, b] to p.
+ * @return The squared distance, t the parameter of the closest point
+ */
+__device__ inline double segmentSquaredDistance(double px, double py, double ax, double ay, double bx, double by, double& t)
+{
+    const double ex = bx - ax;
+    const double ey = by - ay;
+    const double ee = ex * ex + ey * ey;
+    t = (ee > 0.0) ? ((px - ax) * ex + (py - ay) * ey) / ee : 0.0;
+    t = fmin(fmax(t, 0.0), 1.0);
+    const double dx = ax + t * ex - px;
+    const double dy = ay + t * ey - py;
+    return dx * dx + dy * dy;
+}
+
+/**
+ * @brief Same test as isPixelInTriangle in Texturing.cpp: distance from the pixel center to the triangle
+ *        with a tolerance of 1/2 pixel, and barycentric coordinates of the closest point.
+ */
+__device__ bool isPixelInTriangle(const double uv[3][2], int x, int y, double& l2, double& l3)
+{
+    const double px = x + 0.5;
+    const double py = y + 0.5;
+
+    const double e0x = uv[1][0] - uv[0][0];
+    const double e0y = uv[1][1] - uv[0][1];
+    const double e1x = uv[2][0] - uv[0][0];
+    const double e1y = uv[2][1] - uv[0][1];
+    const double dx = px - uv[0][0];
+    const double dy = py - uv[0][1];
+
+    const double d00 = e0x * e0x + e0y * e0y;
+    const double d01 = e0x * e1x + e0y * e1y;
+    const double d11 = e1x * e1x + e1y * e1y;
+    const double denom = d00 * d11 - d01 * d01;
+
+    if (denom > 0.0)
+    {
+        const double d20 = dx * e0x + dy * e0y;
+        const double d21 = dx * e1x + dy * e1y;
+        const double v = (d11 * d20 - d01 * d21) / denom;
+        const double w = (d00 * d21 - d01 * d20) / denom;
+        if (v >= 0.0 && w >= 0.0 && v + w <= 1.0)
+        {
+            l2 = v;
+            l3 = w;
+            return true;
+        }
+    }
+
+    // outside (or degenerate): closest point on the edges
+    double t;
+    double best = segmentSquaredDistance(px, py, uv[0][0], uv[0][1], uv[1][0], uv[1][1], t);
+    l2 = t;
+    l3 = 0.0;
+
+    double dist = segmentSquaredDistance(px, py, uv[0][0], uv[0][1], uv[2][0], uv[2][1], t);
+    if (dist < best)
+    {
+        best = dist;
+        l2 = 0.0;
+        l3 = t;
+    }
+
+    dist = segmentSquaredDistance(px, py, uv[1][0], uv[1][1], uv[2][0], uv[2][1], t);
+    if (dist < best)
+    {
+        best = dist;
+        l2 = 1.0 - t;
+        l3 = t;
+    }
+
+    return best < 0.5 + DBL_EPSILON;
+}
+
+/**
+ * @brief Rasterize the triangles in the atlases and accumulate the camera contributions, one thread per triangle.
+ *        Same computation as the triangles loop of Texturing::generateTexturesSubSet.
+ */
+__global__ void accumulate_kernel(AccumulationParams params, const DeviceTextureAccumulator::Triangle* triangles, int nbTriangles)
+{
+    const int id = blockIdx.x * blockDim.x + threadIdx.x;
+    if (id >= nbTriangles)
+        return;
+
+    const DeviceTextureAccumulator::Triangle& triangle = triangles[id];
+    const int side = params.textureSide;
+    const std::size_t textureSize = std::size_t(side) * side;
+
+    // triangle bounding box in pixel indexes, clamped to [0; textureSide]
+    const int xmin = min(max(int(floor(fmin(fmin(triangle.uv[0][0], triangle.uv[1][0]), triangle.uv[2][0]))), 0), side);
+    const int ymin = min(max(int(floor(fmin(fmin(triangle.uv[0][1], triangle.uv[1][1]), triangle.uv[2][1]))), 0), side);
+    const int xmax = min(max(int(ceil(fmax(fmax(triangle.uv[0][0], triangle.uv[1][0]), triangle.uv[2][0]))), 0), side);
+    const int ymax = min(max(int(ceil(fmax(fmax(triangle.uv[0][1], triangle.uv[1][1]), triangle.uv[2][1]))), 0), side);
+
+    const double* P = params.P;
+
+    for (int y = ymin; y < ymax; ++y)
+    {
+        for (int x = xmin; x < xmax; ++x)
+        {
+            double l2, l3;
+            if (!isPixelInTriangle(triangle.uv, x, y, l2, l3))
+                continue;
+
+            // remap 'y' to image coordinates system (inverted Y axis)
+            const std::size_t xyoffset = std::size_t(side - 1 - y) * side + x;
+
+            // 3D coordinates
+            double X[3];
+            for (int k = 0; k < 3; ++k)
+            {
+                X[k] = triangle.points[0][k] + (triangle.points[2][k] - triangle.points[0][k]) * l3 +
+                       (triangle.points[1][k] - triangle.points[0][k]) * l2;
+            }
+
+            // projection in the camera image
+            const double zt = P[8] * X[0] + P[9] * X[1] + P[10] * X[2] + P[11];
+            if (zt <= 0.0)
+                continue;
+
+            const double col = (P[0] * X[0] + P[1] * X[1] + P[2] * X[2] + P[3]) / zt;
+            const double row = (P[4] * X[0] + P[5] * X[1] + P[6] * X[2] + P[7]) / zt;
+
+            // exclude out of bounds pixels
+            const int pixX = int(floor(col + 0.5));
+            const int pixY = int(floor(row + 0.5));
+            if (pixX < params.border || pixX >= params.width - params.border || pixY < params.border || pixY >= params.height - params.border)
+                continue;
+
+            // If the color is pure zero (ie. no contributions), we consider it as an invalid pixel.
+            const float3 color = interpolateColor(params.image, params.width, params.height, row, col);
+            if (color.x == 0.0f && color.y == 0.0f && color.z == 0.0f)
+                continue;
+
+            // each frequency band also contributes to lower frequencies (higher band indexes)
+            int downscaleCoef = 1;
+            for (int band = 0; band < params.nbLevels; ++band)
+            {
+                if (band >= triangle.band)
+                {
+                    const float3 value = interpolateColor(
+                      params.levels[band], params.levelsWidth[band], params.levelsHeight[band], row / downscaleCoef, col / downscaleCoef);
+
+                    const std::size_t levelOffset = (std::size_t(triangle.atlasIndex) * params.nbBands + band) * textureSize + xyoffset;
+                    atomicAdd(params.colors + 3 * levelOffset + 0, value.x * triangle.score);
+                    atomicAdd(params.colors + 3 * levelOffset + 1, value.y * triangle.score);
+                    atomicAdd(params.colors + 3 * levelOffset + 2, value.z * triangle.score);
+                    atomicAdd(params.counts + levelOffset, triangle.score);
+                }
+                downscaleCoef *= params.multiBandDownscale;
+            }
+        }
+    }
+}
+
+DeviceTextureAccumulator::~DeviceTextureAccumulator()
+{
+    // no throw in destructor
+    cudaFree(_colors);
+    cudaFree(_counts);
+    cudaFree(_image);
+    cudaFree(_pyramid);
+    cudaFree(_triangles);
+}
+
+std::size_t DeviceTextureAccumulator::getFreeMemory()
+{
+    std::size_t freeMemory = 0;
+    std::size_t totalMemory = 0;
+    CHECK_MESH_CUDA_ERROR(cudaMemGetInfo(&freeMemory, &totalMemory));
+    return freeMemory;
+}
+
+void DeviceTextureAccumulator::init(int nbAtlases, int nbBands, int textureSide)
+{
+    if (nbAtlases <= 0 || nbBands <= 0 || nbBands > maxBands || textureSide <= 0)
+    {
+        throw std::invalid_argument("DeviceTextureAccumulator: invalid atlases.");
+    }
+
+    const std::size_t size = std::size_t(nbAtlases) * nbBands * textureSide * textureSide;
+
+    if (size != std::size_t(_nbAtlases) * _nbBands * _textureSide * _textureSide)
+    {
+        CHECK_MESH_CUDA_ERROR(cudaFree(_colors));
+        CHECK_MESH_CUDA_ERROR(cudaFree(_counts));
+        _colors = nullptr;
+        _counts = nullptr;
+        CHECK_MESH_CUDA_ERROR(cudaMalloc(&_colors, size * 3 * sizeof(float)));
+        CHECK_MESH_CUDA_ERROR(cudaMalloc(&_counts, size * sizeof(float)));
+    }
+
+    _nbAtlases = nbAtlases;
+    _nbBands = nbBands;
+    _textureSide = textureSide;
+
+    CHECK_MESH_CUDA_ERROR(cudaMemset(_colors, 0, size * 3 * sizeof(float)));
+    CHECK_MESH_CUDA_ERROR(cudaMemset(_counts, 0, size * sizeof(float)));
+}
+
+void DeviceTextureAccumulator::setCamera(const double* P,
+                                         int border,
+                                         const float* image,
+                                         int width,
+                                         int height,
+                                         const std::vector<const float*>& levels,
+                                         const std::vector<int>& widths,
+                                         const std::vector<int>& heights,
+                                         int multiBandDownscale)
+{
+    if (levels.empty() || levels.size() > maxBands || levels.size() != widths.size() || levels.size() != heights.size())
+    {
+        throw std::invalid_argument("DeviceTextureAccumulator: invalid laplacian pyramid.");
+    }
+
+    std::copy(P, P + 12, _P);
+    _border = border;
+    _width = width;
+    _height = height;
+    _multiBandDownscale = multiBandDownscale;
+
+    const std::size_t imageSize = std::size_t(width) * height * 3;
+    if (imageSize > _imageCapacity)
+    {
+        CHECK_MESH_CUDA_ERROR(cudaFree(_image));
+        _image = nullptr;
+        CHECK_MESH_CUDA_ERROR(cudaMalloc(&_image, imageSize * sizeof(float)));
+        _imageCapacity = imageSize;
+    }
+    CHECK_MESH_CUDA_ERROR(cudaMemcpy(_image, image, imageSize * sizeof(float), cudaMemcpyHostToDevice));
+
+    _levelsOffset.clear();
+    _levelsWidth = widths;
+    _levelsHeight = heights;
+
+    std::size_t size = 0;
+    for (std::size_t l = 0; l < levels.size(); ++l)
+    {
+        _levelsOffset.push_back(size);
+        size += std::size_t(widths[l]) * heights[l] * 3;
+    }
+
+    if (size > _pyramidCapacity)
+    {
+        CHECK_MESH_CUDA_ERROR(cudaFree(_pyramid));
+        _pyramid = nullptr;
+        CHECK_MESH_CUDA_ERROR(cudaMalloc(&_pyramid, size * sizeof(float)));
+        _pyramidCapacity = size;
+    }
+
+    for (std::size_t l = 0; l < levels.size(); ++l)
+    {
+        const std::size_t bytes = std::size_t(widths[l]) * heights[l] * 3 * sizeof(float);
+        CHECK_MESH_CUDA_ERROR(cudaMemcpy(_pyramid + _levelsOffset[l], levels[l], bytes, cudaMemcpyHostToDevice));
+    }
+}
+
+void DeviceTextureAccumulator::accumulate(const std::vector<Triangle>& triangles)
+{
+    if (_colors == nullptr || _levelsOffset.empty())
+    {
+        throw std::logic_error("DeviceTextureAccumulator: the atlases or the camera are not set.");
+    }
+
+    if (triangles.empty())
+        return;
+
+    if (triangles.size() > _trianglesCapacity)
+    {
+        CHECK_MESH_CUDA_ERROR(cudaFree(_triangles));
+        _triangles = nullptr;
+        CHECK_MESH_CUDA_ERROR(cudaMalloc(&_triangles, triangles.size() * sizeof(Triangle)));
+        _trianglesCapacity = triangles.size();
+    }
+    CHECK_MESH_CUDA_ERROR(cudaMemcpy(_triangles, triangles.data(), triangles.size() * sizeof(Triangle), cudaMemcpyHostToDevice));
+
+    AccumulationParams params;
+    std::copy(_P, _P + 12, params.P);
+    params.border = _border;
+    params.image = _image;
+    params.width = _width;
+    params.height = _height;
+    params.nbLevels = int(_levelsOffset.size());
+    for (int l = 0; l < params.nbLevels; ++l)
+    {
+        params.levels[l] = _pyramid + _levelsOffset[l];
+        params.levelsWidth[l] = _levelsWidth[l];
+        params.levelsHeight[l] = _levelsHeight[l];
+    }
+    params.multiBandDownscale = _multiBandDownscale;
+    params.colors = _colors;
+    params.counts = _counts;
+    params.nbBands = _nbBands;
+    params.textureSide = _textureSide;
+
+    const int nbTriangles = int(triangles.size());
+    const int nbBlocks = (nbTriangles + BLOCK_SIZE - 1) / BLOCK_SIZE;
+
+    accumulate_kernel<<<nbBlocks, BLOCK_SIZE>>>(params, _triangles, nbTriangles);
+    CHECK_MESH_CUDA_ERROR(cudaGetLastError());
+}
+
+void DeviceTextureAccumulator::download(int atlasIndex, const std::vector<float*>& colors, const std::vector<float*>& counts) const
+{
+    if (atlasIndex < 0 || atlasIndex >= _nbAtlases || colors.size() != std::size_t(_nbBands) || counts.size() != std::size_t(_nbBands))
+    {
+        throw std::invalid_argument("DeviceTextureAccumulator: invalid atlas download.");
+    }
+
+    const std::size_t textureSize = std::size_t(_textureSide) * _textureSide;
+
+    for (int band = 0; band < _nbBands; ++band)
+    {
+        const std::size_t offset = (std::size_t(atlasIndex) * _nbBands + band) * textureSize;
+        CHECK_MESH_CUDA_ERROR(cudaMemcpy(colors[band], _colors + 3 * offset, textureSize * 3 * sizeof(float), cudaMemcpyDeviceToHost));
+        CHECK_MESH_CUDA_ERROR(cudaMemcpy(counts[band], _counts + offset, textureSize * sizeof(float), cudaMemcpyDeviceToHost));
+    }
+}
+
+}  // namespace cuda
+}  // namespace mesh
+}  // namespace aliceVision
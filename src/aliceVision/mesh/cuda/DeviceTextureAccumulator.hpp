@@ -0,0 +1,132 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace aliceVision {
+namespace mesh {
+namespace cuda {
+
+/**
+ * @class DeviceTextureAccumulator
+ * @brief Rasterize the triangles of the texture atlases and accumulate the camera contributions on the GPU,
+ *        as Texturing::generateTexturesSubSet does on the CPU.
+ *
+ * The accumulated pyramids of the frequency bands of a set of atlases stay resident on the device.
+ * Each camera image and its laplacian pyramid are uploaded once, then all the triangles the camera contributes to,
+ * for every atlas and band, are rasterized in a single launch.
+ */
+class DeviceTextureAccumulator
+{
+  public:
+    /// Maximal number of frequency bands
+    static constexpr int maxBands = 16;
+
+    /**
+     * @brief Contribution of a camera to a triangle of an atlas.
+     */
+    struct Triangle
+    {
+        /// pixel coordinates (x, y) of the vertices in the atlas
+        double uv[3][2];
+        /// 3D coordinates of the vertices
+        double points[3][3];
+        /// index of the atlas in the accumulator
+        int atlasIndex;
+        /// frequency band of the contribution, it also contributes to the lower frequencies (higher band indexes)
+        int band;
+        float score;
+    };
+
+    DeviceTextureAccumulator() = default;
+    ~DeviceTextureAccumulator();
+
+    // no copy
+    DeviceTextureAccumulator(const DeviceTextureAccumulator&) = delete;
+    DeviceTextureAccumulator& operator=(const DeviceTextureAccumulator&) = delete;
+
+    /**
+     * @return The free memory of the current device in bytes
+     */
+    static std::size_t getFreeMemory();
+
+    /**
+     * @brief Allocate and clear the accumulated pyramids of a set of atlases.
+     * @param[in] nbAtlases The number of atlases
+     * @param[in] nbBands The number of frequency bands
+     * @param[in] textureSide The side of the atlases in pixels
+     */
+    void init(int nbAtlases, int nbBands, int textureSide);
+
+    /**
+     * @brief Upload a camera to the device.
+     * @param[in] P The projection matrix, 3x4 row major
+     * @param[in] border The border of the image excluded from the contributions (see MultiViewParams::isPixelInImage)
+     * @param[in] image The host camera image, RGB float interleaved, row major
+     * @param[in] width The width of the camera image
+     * @param[in] height The height of the camera image
+     * @param[in] levels The host levels of the laplacian pyramid of the image, RGB float interleaved, row major
+     * @param[in] widths The width of each level
+     * @param[in] heights The height of each level
+     * @param[in] multiBandDownscale The downscale factor between two levels
+     */
+    void setCamera(const double* P,
+                   int border,
+                   const float* image,
+                   int width,
+                   int height,
+                   const std::vector<const float*>& levels,
+                   const std::vector<int>& widths,
+                   const std::vector<int>& heights,
+                   int multiBandDownscale);
+
+    /**
+     * @brief Accumulate the contributions of the current camera to a set of triangles.
+     * @param[in] triangles The triangles, of any atlas and band
+     */
+    void accumulate(const std::vector<Triangle>& triangles);
+
+    /**
+     * @brief Download the accumulated pyramid of an atlas.
+     * @param[in] atlasIndex The index of the atlas in the accumulator
+     * @param[out] colors The host accumulated colors of each band, RGB float interleaved, textureSide * textureSide * 3
+     * @param[out] counts The host accumulated weights of each band, textureSide * textureSide
+     */
+    void download(int atlasIndex, const std::vector<float*>& colors, const std::vector<float*>& counts) const;
+
+  private:
+    // accumulated pyramids, [atlas][band] in a single buffer
+    float* _colors = nullptr;
+    float* _counts = nullptr;
+    int _nbAtlases = 0;
+    int _nbBands = 0;
+    int _textureSide = 0;
+
+    // camera image and laplacian pyramid, all the levels in a single buffer
+    float* _image = nullptr;
+    std::size_t _imageCapacity = 0;  //< in number of floats
+    float* _pyramid = nullptr;
+    std::size_t _pyramidCapacity = 0;  //< in number of floats
+    std::vector<std::size_t> _levelsOffset;
+    std::vector<int> _levelsWidth;
+    std::vector<int> _levelsHeight;
+    double _P[12];
+    int _border = 0;
+    int _width = 0;
+    int _height = 0;
+    int _multiBandDownscale = 1;
+
+    // triangles buffer, reused between cameras
+    Triangle* _triangles = nullptr;
+    std::size_t _trianglesCapacity = 0;
+};
+
+}  // namespace cuda
+}  // namespace mesh
+}  // namespace aliceVision
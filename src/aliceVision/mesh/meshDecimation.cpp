@@ -0,0 +1,372 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "meshDecimation.hpp"
+
+#include <aliceVision/mesh/Mesh.hpp>
+#include <aliceVision/system/Logger.hpp>
+#include <aliceVision/alicevision_omp.hpp>
+
+#include <OpenMesh/Core/Mesh/TriMesh_ArrayKernelT.hh>
+#include <OpenMesh/Tools/Decimater/DecimaterT.hh>
+#include <OpenMesh/Tools/Decimater/ModQuadricT.hh>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+namespace aliceVision {
+namespace mesh {
+
+namespace {
+
+struct DecimationTraits : public OpenMesh::DefaultTraits
+{
+    typedef OpenMesh::Vec3d Point;
+    typedef OpenMesh::Vec3d Normal;
+};
+
+typedef OpenMesh::TriMesh_ArrayKernelT<DecimationTraits> DecimationMesh;
+typedef OpenMesh::Decimater::DecimaterT<DecimationMesh> Decimater;
+typedef OpenMesh::Decimater::ModQuadricT<DecimationMesh>::Handle HModQuadric;
+
+/// Cell of the vertices not referenced yet, and of the vertices shared by several blocks
+constexpr int unassignedVertex = -1;
+constexpr int sharedVertex = -2;
+
+/// Maximum number of cells of the grid of blocks
+constexpr int maxNbCells = 1 << 24;
+
+/**
+ * @brief Regular grid of blocks over the bounding box of the mesh.
+ */
+struct BlockGrid
+{
+    Point3d origin;
+    double cellSize = 1.0;
+    int dims[3] = {1, 1, 1};
+
+    int nbCells() const { return dims[0] * dims[1] * dims[2]; }
+
+    int cellIndex(const Point3d& p) const
+    {
+        int cell[3];
+        for (int k = 0; k < 3; ++k)
+        {
+            cell[k] = std::clamp(static_cast<int>(std::floor((p.m[k] - origin.m[k]) / cellSize)), 0, dims[k] - 1);
+        }
+        return (cell[2] * dims[1] + cell[1]) * dims[0] + cell[0];
+    }
+};
+
+/**
+ * @brief Build the grid of blocks of the mesh surface, each block holding about maxTrianglesPerBlock triangles.
+ * @param[in] shifted shift the grid by half a block
+ */
+BlockGrid buildBlockGrid(const Mesh& mesh, int maxTrianglesPerBlock, bool shifted)
+{
+    Point3d bbMin(std::numeric_limits<double>::max(), std::numeric_limits<double>::max(), std::numeric_limits<double>::max());
+    Point3d bbMax = -bbMin;
+    for (const Point3d& p : mesh.pts)
+    {
+        for (int k = 0; k < 3; ++k)
+        {
+            bbMin.m[k] = std::min(bbMin.m[k], p.m[k]);
+            bbMax.m[k] = std::max(bbMax.m[k], p.m[k]);
+        }
+    }
+
+    double area = 0.0;
+#pragma omp parallel for reduction(+ : area)
+    for (int i = 0; i < mesh.tris.size(); ++i)
+    {
+        const Mesh::triangle& t = mesh.tris[i];
+        area += 0.5 * cross(mesh.pts[t.v[1]] - mesh.pts[t.v[0]], mesh.pts[t.v[2]] - mesh.pts[t.v[0]]).size();
+    }
+
+    // a block of the surface of side s holds an area of about s^2
+    const double nbBlocks = std::max(1.0, static_cast<double>(mesh.tris.size()) / maxTrianglesPerBlock);
+    const double extent = std::max({bbMax.x - bbMin.x, bbMax.y - bbMin.y, bbMax.z - bbMin.z});
+
+    BlockGrid grid;
+    grid.cellSize = std::sqrt(area / nbBlocks);
+    if (!(grid.cellSize > 0.0) || !std::isfinite(grid.cellSize))
+        grid.cellSize = std::max(extent, 1.0);
+
+    for (;;)
+    {
+        const double shift = shifted ? 0.5 * grid.cellSize : 0.0;
+        grid.origin = bbMin - Point3d(shift, shift, shift);
+
+        double nbCells = 1.0;
+        for (int k = 0; k < 3; ++k)
+        {
+            const double cells = std::floor((bbMax.m[k] - grid.origin.m[k]) / grid.cellSize) + 1.0;
+            grid.dims[k] = static_cast<int>(std::min(cells, static_cast<double>(maxNbCells)));
+            nbCells *= cells;
+        }
+
+        if (nbCells <= maxNbCells)
+            break;
+        grid.cellSize *= 2.0;
+    }
+
+    return grid;
+}
+
+/**
+ * @brief Decimate the triangles of a block, the vertices shared with the other blocks being locked.
+ * @param[in] mesh the whole mesh
+ * @param[in] triangles the triangles of the block
+ * @param[in] nbTriangles the number of triangles of the block
+ * @param[in] verticesCell the cell of each vertex of the mesh, or sharedVertex
+ * @param[in] nbRemovals the target number of removed vertices
+ * @param[out] out_triangles the triangles of the decimated block, indexing the vertices of the mesh
+ */
+void decimateBlock(const Mesh& mesh,
+                   const int* triangles,
+                   int nbTriangles,
+                   const std::vector<int>& verticesCell,
+                   int nbRemovals,
+                   std::vector<Mesh::triangle>& out_triangles)
+{
+    std::vector<int> vertices;
+    vertices.reserve(3 * nbTriangles);
+    for (int i = 0; i < nbTriangles; ++i)
+    {
+        for (int k = 0; k < 3; ++k)
+        {
+            vertices.push_back(mesh.tris[triangles[i]].v[k]);
+        }
+    }
+    std::sort(vertices.begin(), vertices.end());
+    vertices.erase(std::unique(vertices.begin(), vertices.end()), vertices.end());
+
+    DecimationMesh blockMesh;
+    blockMesh.request_vertex_status();
+    blockMesh.request_edge_status();
+    blockMesh.request_face_status();
+
+    std::vector<DecimationMesh::VertexHandle> handles(vertices.size());
+    for (std::size_t i = 0; i < vertices.size(); ++i)
+    {
+        const Point3d& p = mesh.pts[vertices[i]];
+        handles[i] = blockMesh.add_vertex(DecimationMesh::Point(p.x, p.y, p.z));
+        if (verticesCell[vertices[i]] == sharedVertex)
+            blockMesh.status(handles[i]).set_locked(true);
+    }
+
+    // the non-manifold triangles rejected by OpenMesh are kept as is, with their vertices locked
+    for (int i = 0; i < nbTriangles; ++i)
+    {
+        const Mesh::triangle& triangle = mesh.tris[triangles[i]];
+        DecimationMesh::VertexHandle faceHandles[3];
+        for (int k = 0; k < 3; ++k)
+        {
+            faceHandles[k] = handles[std::lower_bound(vertices.begin(), vertices.end(), triangle.v[k]) - vertices.begin()];
+        }
+
+        if (!blockMesh.add_face(faceHandles[0], faceHandles[1], faceHandles[2]).is_valid())
+        {
+            out_triangles.push_back(triangle);
+            for (int k = 0; k < 3; ++k)
+                blockMesh.status(faceHandles[k]).set_locked(true);
+        }
+    }
+
+    if (nbRemovals > 0)
+    {
+        Decimater decimater(blockMesh);
+        HModQuadric hModQuadric;
+        decimater.add(hModQuadric);
+        decimater.module(hModQuadric).unset_max_err();
+        decimater.initialize();
+        decimater.decimate_to(blockMesh.n_vertices() - std::min<std::size_t>(nbRemovals, blockMesh.n_vertices()));
+    }
+
+    // the collapses keep the vertices in place, so the kept vertices are the mesh ones
+    for (DecimationMesh::FaceIter fIt = blockMesh.faces_begin(); fIt != blockMesh.faces_end(); ++fIt)
+    {
+        if (blockMesh.status(*fIt).deleted())
+            continue;
+
+        Mesh::triangle triangle;
+        DecimationMesh::FaceVertexIter fvIt = blockMesh.fv_iter(*fIt);
+        for (int k = 0; k < 3; ++k, ++fvIt)
+        {
+            triangle.v[k] = vertices[(*fvIt).idx()];
+        }
+        out_triangles.push_back(triangle);
+    }
+}
+
+/**
+ * @brief Remove the vertices not referenced anymore, with their colors and visibilities.
+ */
+void removeUnreferencedVertices(Mesh& mesh)
+{
+    const int nbPoints = mesh.pts.size();
+    std::vector<int> newIndices(nbPoints, 0);
+    for (const Mesh::triangle& triangle : mesh.tris)
+    {
+        for (int k = 0; k < 3; ++k)
+            newIndices[triangle.v[k]] = 1;
+    }
+
+    int nbUsedPoints = 0;
+    for (int& newIndex : newIndices)
+        newIndex = newIndex ? nbUsedPoints++ : -1;
+
+    const bool hasColors = mesh.colors().size() == static_cast<std::size_t>(nbPoints);
+    const bool hasVisibilities = mesh.pointsVisibilities.size() == nbPoints;
+
+    // the vertices are compacted in place, keeping their order
+    for (int i = 0; i < nbPoints; ++i)
+    {
+        const int j = newIndices[i];
+        if (j < 0 || j == i)
+            continue;
+        mesh.pts[j] = mesh.pts[i];
+        if (hasColors)
+            mesh.colors()[j] = mesh.colors()[i];
+        if (hasVisibilities)
+            mesh.pointsVisibilities[j].swap(mesh.pointsVisibilities[i]);
+    }
+    mesh.pts.resize(nbUsedPoints);
+    if (hasColors)
+        mesh.colors().resize(nbUsedPoints);
+    if (hasVisibilities)
+        mesh.pointsVisibilities.resize(nbUsedPoints);
+
+#pragma omp parallel for
+    for (int i = 0; i < mesh.tris.size(); ++i)
+    {
+        for (int k = 0; k < 3; ++k)
+            mesh.tris[i].v[k] = newIndices[mesh.tris[i].v[k]];
+    }
+}
+
+}  // namespace
+
+void decimateByBlocks(Mesh& mesh, int nbOutputVertices, const BlockDecimationParams& params)
+{
+    // the texture coordinates and normals are not remapped
+    mesh.uvCoords.clear();
+    mesh.trisUvIds.clear();
+    mesh.normals.clear();
+    mesh.trisNormalsIds.clear();
+    mesh.trisMtlIds().clear();
+    mesh.nmtls = 0;
+
+    removeUnreferencedVertices(mesh);
+
+    const int nbInputVertices = mesh.pts.size();
+    const int nbIterations = std::max(1, params.nbIterations);
+    const double ratio = static_cast<double>(nbOutputVertices) / std::max(1, nbInputVertices);
+
+    for (int iteration = 0; iteration < nbIterations && mesh.pts.size() > nbOutputVertices; ++iteration)
+    {
+        // the number of vertices decreases geometrically over the iterations
+        const int iterationTarget = (iteration + 1 == nbIterations)
+                                      ? nbOutputVertices
+                                      : static_cast<int>(nbInputVertices * std::pow(ratio, static_cast<double>(iteration + 1) / nbIterations));
+        const int nbRemovals = mesh.pts.size() - std::max(iterationTarget, nbOutputVertices);
+
+        const BlockGrid grid = buildBlockGrid(mesh, std::max(1, params.maxTrianglesPerBlock), iteration % 2 == 1);
+        const int nbCells = grid.nbCells();
+
+        // counting sort of the triangles by cell
+        std::vector<int> trianglesCell(mesh.tris.size());
+#pragma omp parallel for
+        for (int i = 0; i < mesh.tris.size(); ++i)
+        {
+            const Mesh::triangle& t = mesh.tris[i];
+            trianglesCell[i] = grid.cellIndex((mesh.pts[t.v[0]] + mesh.pts[t.v[1]] + mesh.pts[t.v[2]]) / 3.0);
+        }
+
+        std::vector<int> cellsOffset(nbCells + 1, 0);
+        for (const int cell : trianglesCell)
+            ++cellsOffset[cell + 1];
+        for (int c = 0; c < nbCells; ++c)
+            cellsOffset[c + 1] += cellsOffset[c];
+
+        std::vector<int> cellsTriangles(mesh.tris.size());
+        {
+            std::vector<int> cursors(cellsOffset.begin(), cellsOffset.end() - 1);
+            for (int i = 0; i < mesh.tris.size(); ++i)
+                cellsTriangles[cursors[trianglesCell[i]]++] = i;
+        }
+
+        std::vector<int> blocks;
+        for (int c = 0; c < nbCells; ++c)
+        {
+            if (cellsOffset[c + 1] > cellsOffset[c])
+                blocks.push_back(c);
+        }
+
+        // the vertices shared by several blocks are locked
+        std::vector<int> verticesCell(mesh.pts.size(), unassignedVertex);
+        for (int i = 0; i < mesh.tris.size(); ++i)
+        {
+            for (int k = 0; k < 3; ++k)
+            {
+                int& vertexCell = verticesCell[mesh.tris[i].v[k]];
+                if (vertexCell == unassignedVertex)
+                    vertexCell = trianglesCell[i];
+                else if (vertexCell != trianglesCell[i])
+                    vertexCell = sharedVertex;
+            }
+        }
+        std::vector<int>().swap(trianglesCell);
+
+        // the removals are distributed over the blocks by their number of free vertices
+        std::vector<int> blocksNbFreeVertices(nbCells, 0);
+        for (const int vertexCell : verticesCell)
+        {
+            if (vertexCell >= 0)
+                ++blocksNbFreeVertices[vertexCell];
+        }
+        const int nbFreeVertices = std::accumulate(blocksNbFreeVertices.begin(), blocksNbFreeVertices.end(), 0);
+
+        ALICEVISION_LOG_INFO("Decimation iteration " << iteration + 1 << "/" << nbIterations << ": " << blocks.size() << " blocks, "
+                                                     << mesh.pts.size() - nbFreeVertices << " locked vertices, target of " << nbRemovals
+                                                     << " removed vertices.");
+
+        std::vector<std::vector<Mesh::triangle>> blocksTriangles(blocks.size());
+
+#pragma omp parallel for schedule(dynamic)
+        for (int b = 0; b < static_cast<int>(blocks.size()); ++b)
+        {
+            const int cell = blocks[b];
+            const int blockRemovals =
+              (nbFreeVertices > 0) ? static_cast<int>(static_cast<double>(nbRemovals) * blocksNbFreeVertices[cell] / nbFreeVertices) : 0;
+            decimateBlock(
+              mesh, cellsTriangles.data() + cellsOffset[cell], cellsOffset[cell + 1] - cellsOffset[cell], verticesCell, blockRemovals, blocksTriangles[b]);
+        }
+
+        std::vector<Mesh::triangle>& triangles = mesh.tris.getDataWritable();
+        triangles.clear();
+        for (std::vector<Mesh::triangle>& blockTriangles : blocksTriangles)
+        {
+            triangles.insert(triangles.end(), blockTriangles.begin(), blockTriangles.end());
+            std::vector<Mesh::triangle>().swap(blockTriangles);
+        }
+
+        removeUnreferencedVertices(mesh);
+
+        ALICEVISION_LOG_INFO("Decimation iteration " << iteration + 1 << "/" << nbIterations << ": " << mesh.pts.size() << " vertices and "
+                                                     << mesh.tris.size() << " triangles.");
+    }
+
+    mesh.trisMtlIds().assign(mesh.tris.size(), 0);
+    mesh.trisUvIds.assign(mesh.tris.size(), Voxel());
+    mesh.nmtls = mesh.tris.empty() ? 0 : 1;
+}
+
+}  // namespace mesh
+}  // namespace aliceVision
@@ -0,0 +1,37 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+namespace aliceVision {
+namespace mesh {
+
+class Mesh;
+
+/**
+ * @brief Parameters of the decimation by blocks
+ */
+struct BlockDecimationParams
+{
+    /// Target number of triangles per block, setting the size of the blocks
+    int maxTrianglesPerBlock = 1000000;
+    /// Number of passes over the blocks, the grid being shifted by half a block at each pass
+    int nbIterations = 2;
+};
+
+/**
+ * @brief Decimate the mesh with the quadric error metric, by spatial blocks decimated in parallel.
+ *        The vertices shared with other blocks are locked, and the grid of blocks is shifted by half a block
+ *        at each iteration so that the borders locked by an iteration are decimated by the next one.
+ *        The collapses keep the remaining vertices in place, so their colors and visibilities are kept.
+ * @param[in,out] mesh the mesh to decimate
+ * @param[in] nbOutputVertices the target number of vertices
+ * @param[in] params the decimation parameters
+ */
+void decimateByBlocks(Mesh& mesh, int nbOutputVertices, const BlockDecimationParams& params);
+
+}  // namespace mesh
+}  // namespace aliceVision
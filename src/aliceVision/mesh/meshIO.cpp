@@ -0,0 +1,1467 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "meshIO.hpp"
+
+#include <aliceVision/mesh/Mesh.hpp>
+#include <aliceVision/system/Logger.hpp>
+#include <aliceVision/alicevision_omp.hpp>
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+namespace aliceVision {
+namespace mesh {
+
+namespace {
+
+/// Size of the blocks read from the text files, and of the compressed blocks of the binary mesh columns
+constexpr std::size_t blockSize = 64 * 1024 * 1024;
+
+/// Number of elements formatted by a thread at once
+constexpr std::size_t formatChunkSize = 1 << 16;
+
+/// Magic number and version of the internal binary mesh format
+constexpr char binaryMeshMagic[4] = {'A', 'V', 'M', 'B'};
+constexpr std::uint32_t binaryMeshVersion = 1;
+
+struct FileCloser
+{
+    void operator()(std::FILE* file) const { std::fclose(file); }
+};
+
+using FilePtr = std::unique_ptr<std::FILE, FileCloser>;
+
+using LineParts = std::vector<std::pair<const char*, const char*>>;
+
+FilePtr openFileForWriting(const std::string& filepath)
+{
+    FilePtr file(std::fopen(filepath.c_str(), "wb"));
+    if (!file)
+    {
+        ALICEVISION_THROW_ERROR("Failed to open the mesh file " << filepath << ": " << std::strerror(errno));
+    }
+    return file;
+}
+
+void closeWrittenFile(FilePtr& file, const std::string& filepath)
+{
+    if (std::fclose(file.release()) != 0)
+    {
+        ALICEVISION_THROW_ERROR("Failed writing the mesh file " << filepath << ": " << std::strerror(errno));
+    }
+}
+
+void writeBytes(std::FILE* file, const std::string& filepath, const void* data, std::size_t size)
+{
+    if (size > 0 && std::fwrite(data, 1, size, file) != size)
+    {
+        ALICEVISION_THROW_ERROR("Failed writing the mesh file " << filepath << ": " << std::strerror(errno));
+    }
+}
+
+bool readBytes(std::FILE* file, void* data, std::size_t size) { return std::fread(data, 1, size, file) == size; }
+
+bool isLittleEndian()
+{
+    const std::uint16_t value = 1;
+    unsigned char byte;
+    std::memcpy(&byte, &value, 1);
+    return byte == 1;
+}
+
+unsigned char toColorByte(double value) { return static_cast<unsigned char>(std::clamp(value, 0.0, 255.0)); }
+
+/**
+ * @brief Release the mesh data filled by a reader.
+ */
+void clearMesh(Mesh& mesh)
+{
+    mesh.pts = StaticVector<Point3d>();
+    mesh.tris = StaticVector<Mesh::triangle>();
+    std::vector<rgb>().swap(mesh.colors());
+    std::vector<int>().swap(mesh.trisMtlIds());
+    mesh.trisUvIds = StaticVector<Voxel>();
+    mesh.pointsVisibilities = PointsVisibility();
+    mesh.nmtls = 0;
+}
+
+/**
+ * @brief Set the per-triangle attributes of the Assimp loader for a mesh without materials and texture coordinates.
+ */
+void setDefaultTrianglesAttributes(Mesh& mesh)
+{
+    mesh.trisMtlIds().assign(mesh.tris.size(), 0);
+    mesh.trisUvIds.assign(mesh.tris.size(), Voxel());
+    mesh.nmtls = mesh.tris.empty() ? 0 : 1;
+}
+
+/**
+ * @brief Remove the degenerate triangles and the unreferenced vertices, as the Assimp loader does.
+ * @return false if a triangle references a vertex out of range
+ */
+bool finalizeMesh(Mesh& mesh)
+{
+    std::vector<Point3d>& points = mesh.pts.getDataWritable();
+    std::vector<Mesh::triangle>& triangles = mesh.tris.getDataWritable();
+    std::vector<rgb>& colors = mesh.colors();
+    const int nbPoints = static_cast<int>(points.size());
+
+    bool valid = true;
+#pragma omp parallel for reduction(&& : valid)
+    for (int i = 0; i < static_cast<int>(triangles.size()); ++i)
+    {
+        for (int k = 0; k < 3; ++k)
+        {
+            valid = valid && triangles[i].v[k] >= 0 && triangles[i].v[k] < nbPoints;
+        }
+    }
+
+    if (!valid)
+    {
+        ALICEVISION_LOG_WARNING("Invalid vertex index in the mesh file.");
+        return false;
+    }
+
+    triangles.erase(std::remove_if(triangles.begin(),
+                                   triangles.end(),
+                                   [](const Mesh::triangle& t) { return t.v[0] == t.v[1] || t.v[1] == t.v[2] || t.v[0] == t.v[2]; }),
+                    triangles.end());
+
+    // the vertices are compacted in place, keeping their order
+    std::vector<int> newIndices(nbPoints, 0);
+    for (const Mesh::triangle& triangle : triangles)
+    {
+        for (int k = 0; k < 3; ++k)
+        {
+            newIndices[triangle.v[k]] = 1;
+        }
+    }
+
+    int nbUsedPoints = 0;
+    for (int& newIndex : newIndices)
+    {
+        newIndex = newIndex ? nbUsedPoints++ : -1;
+    }
+
+    if (nbUsedPoints < nbPoints)
+    {
+        for (int i = 0; i < nbPoints; ++i)
+        {
+            if (newIndices[i] < 0)
+                continue;
+            points[newIndices[i]] = points[i];
+            if (!colors.empty())
+                colors[newIndices[i]] = colors[i];
+        }
+        points.resize(nbUsedPoints);
+        if (!colors.empty())
+            colors.resize(nbUsedPoints);
+
+#pragma omp parallel for
+        for (int i = 0; i < static_cast<int>(triangles.size()); ++i)
+        {
+            for (int k = 0; k < 3; ++k)
+            {
+                triangles[i].v[k] = newIndices[triangles[i].v[k]];
+            }
+        }
+    }
+
+    setDefaultTrianglesAttributes(mesh);
+
+    return true;
+}
+
+/**
+ * @brief Read the rest of a text file by large blocks cut at the line ends,
+ *        each block being split in as many line-aligned parts as threads.
+ * @param[in] processParts called for each block, in the file order, with its parts;
+ *            returns false to stop the reading
+ * @return false if the reading has been stopped by processParts
+ */
+template<class F>
+bool readLineBlocks(std::FILE* file, const std::string& filepath, F&& processParts)
+{
+    const int nbParts = omp_get_max_threads();
+    std::vector<char> buffer;
+    LineParts parts(nbParts);
+    std::size_t carry = 0;
+    bool last = false;
+
+    while (!last)
+    {
+        buffer.resize(carry + blockSize + 1);
+        const std::size_t size = carry + std::fread(buffer.data() + carry, 1, blockSize, file);
+        if (std::ferror(file))
+        {
+            ALICEVISION_THROW_ERROR("Failed reading the mesh file " << filepath << ": " << std::strerror(errno));
+        }
+        last = size < carry + blockSize;
+        // the parsing stops at the end of the buffer
+        buffer[size] = '\0';
+
+        // keep the last incomplete line for the next block
+        std::size_t end = size;
+        if (!last)
+        {
+            while (end > 0 && buffer[end - 1] != '\n')
+                --end;
+            if (end == 0)
+            {
+                carry = size;
+                continue;
+            }
+        }
+
+        std::size_t partBegin = 0;
+        for (int p = 0; p < nbParts; ++p)
+        {
+            std::size_t partEnd = (p + 1 == nbParts) ? end : std::max(partBegin, end * (p + 1) / nbParts);
+            while (partEnd < end && (partEnd == 0 || buffer[partEnd - 1] != '\n'))
+                ++partEnd;
+            parts[p] = {buffer.data() + partBegin, buffer.data() + partEnd};
+            partBegin = partEnd;
+        }
+
+        if (!processParts(parts))
+            return false;
+
+        carry = size - end;
+        std::memmove(buffer.data(), buffer.data() + end, carry);
+    }
+
+    return true;
+}
+
+inline const char* skipSpaces(const char* p)
+{
+    while (*p == ' ' || *p == '\t' || *p == '\r')
+        ++p;
+    return p;
+}
+
+inline bool isLineEnd(const char* p) { return *p == '\n' || *p == '\0'; }
+
+inline const char* nextLine(const char* p, const char* end)
+{
+    const void* lineEnd = std::memchr(p, '\n', end - p);
+    return lineEnd ? static_cast<const char*>(lineEnd) + 1 : end;
+}
+
+inline bool isKeyword(const char* p, const char* keyword)
+{
+    const std::size_t size = std::strlen(keyword);
+    return std::strncmp(p, keyword, size) == 0 && (p[size] == ' ' || p[size] == '\t' || p[size] == '\r' || isLineEnd(p + size));
+}
+
+inline bool parseDouble(const char*& p, double& value)
+{
+    p = skipSpaces(p);
+    if (isLineEnd(p))
+        return false;
+    char* end;
+    value = std::strtod(p, &end);
+    if (end == p)
+        return false;
+    p = end;
+    return true;
+}
+
+inline bool parseInt(const char*& p, long& value)
+{
+    p = skipSpaces(p);
+    const bool negative = (*p == '-');
+    if (*p == '-' || *p == '+')
+        ++p;
+    if (*p < '0' || *p > '9')
+        return false;
+    value = 0;
+    while (*p >= '0' && *p <= '9')
+    {
+        value = value * 10 + (*p - '0');
+        ++p;
+    }
+    if (negative)
+        value = -value;
+    return true;
+}
+
+/**
+ * @brief Append the fan triangulation of a polygon, the points and lines being ignored.
+ */
+void appendFace(const std::vector<long>& face, std::vector<Mesh::triangle>& triangles)
+{
+    for (std::size_t k = 2; k < face.size(); ++k)
+    {
+        triangles.emplace_back(static_cast<int>(face[0]), static_cast<int>(face[k - 1]), static_cast<int>(face[k]));
+    }
+}
+
+/**
+ * @brief Data parsed from a part of an OBJ file.
+ */
+struct ObjPart
+{
+    std::vector<Point3d> points;
+    std::vector<rgb> colors;
+    std::size_t nbColors = 0;
+    std::vector<Mesh::triangle> triangles;
+    /// Positions (3 * triangle + corner) of the negative indices, relative to the first vertex of the part
+    std::vector<std::size_t> relativeIndices;
+    bool supported = true;
+
+    void clear()
+    {
+        points.clear();
+        colors.clear();
+        nbColors = 0;
+        triangles.clear();
+        relativeIndices.clear();
+        supported = true;
+    }
+};
+
+void parseObjPart(const char* begin, const char* end, ObjPart& part)
+{
+    std::vector<long> face;
+    std::vector<bool> faceRelative;
+
+    for (const char* line = begin; line < end && part.supported; line = nextLine(line, end))
+    {
+        const char* p = skipSpaces(line);
+
+        if (isKeyword(p, "v"))
+        {
+            p += 1;
+            Point3d point;
+            if (!parseDouble(p, point.x) || !parseDouble(p, point.y) || !parseDouble(p, point.z))
+            {
+                part.supported = false;
+                break;
+            }
+            // same coordinates convention as Mesh::load
+            part.points.emplace_back(point.x, -point.y, -point.z);
+
+            rgb color;
+            double r, g, b;
+            if (parseDouble(p, r) && parseDouble(p, g) && parseDouble(p, b))
+            {
+                color = rgb(toColorByte(r * 255.0), toColorByte(g * 255.0), toColorByte(b * 255.0));
+                ++part.nbColors;
+            }
+            part.colors.push_back(color);
+        }
+        else if (isKeyword(p, "f"))
+        {
+            p += 1;
+            face.clear();
+            faceRelative.clear();
+
+            long index;
+            while (parseInt(p, index))
+            {
+                if (index == 0)
+                {
+                    part.supported = false;
+                    break;
+                }
+                faceRelative.push_back(index < 0);
+                face.push_back(index < 0 ? static_cast<long>(part.points.size()) + index : index - 1);
+
+                if (*p == '/')
+                {
+                    // the vertex has a texture coordinate
+                    if (p[1] != '/')
+                    {
+                        part.supported = false;
+                        break;
+                    }
+                    // the normals are dropped, as in Mesh::load
+                    while (*p != ' ' && *p != '\t' && *p != '\r' && !isLineEnd(p))
+                        ++p;
+                }
+            }
+
+            if (!part.supported || !isLineEnd(skipSpaces(p)))
+            {
+                part.supported = false;
+                break;
+            }
+
+            const std::size_t firstTriangle = part.triangles.size();
+            appendFace(face, part.triangles);
+            for (std::size_t t = firstTriangle; t < part.triangles.size(); ++t)
+            {
+                const std::size_t k = t - firstTriangle;
+                const std::size_t corners[3] = {0, k + 1, k + 2};
+                for (int c = 0; c < 3; ++c)
+                {
+                    if (faceRelative[corners[c]])
+                        part.relativeIndices.push_back(3 * t + c);
+                }
+            }
+        }
+        else if (isKeyword(p, "vt") || isKeyword(p, "usemtl") || isKeyword(p, "mtllib"))
+        {
+            part.supported = false;
+        }
+        // the normals, objects, groups and comments are ignored
+    }
+}
+
+enum class EPlyFormat
+{
+    Ascii,
+    BinaryLittleEndian,
+    BinaryBigEndian
+};
+
+enum class EPlyType
+{
+    Int8,
+    UInt8,
+    Int16,
+    UInt16,
+    Int32,
+    UInt32,
+    Float32,
+    Float64
+};
+
+bool EPlyType_fromString(const std::string& name, EPlyType& type)
+{
+    if (name == "char" || name == "int8")
+        type = EPlyType::Int8;
+    else if (name == "uchar" || name == "uint8")
+        type = EPlyType::UInt8;
+    else if (name == "short" || name == "int16")
+        type = EPlyType::Int16;
+    else if (name == "ushort" || name == "uint16")
+        type = EPlyType::UInt16;
+    else if (name == "int" || name == "int32")
+        type = EPlyType::Int32;
+    else if (name == "uint" || name == "uint32")
+        type = EPlyType::UInt32;
+    else if (name == "float" || name == "float32")
+        type = EPlyType::Float32;
+    else if (name == "double" || name == "float64")
+        type = EPlyType::Float64;
+    else
+        return false;
+    return true;
+}
+
+std::size_t EPlyType_size(EPlyType type)
+{
+    switch (type)
+    {
+        case EPlyType::Int8:
+        case EPlyType::UInt8:
+            return 1;
+        case EPlyType::Int16:
+        case EPlyType::UInt16:
+            return 2;
+        case EPlyType::Int32:
+        case EPlyType::UInt32:
+        case EPlyType::Float32:
+            return 4;
+        case EPlyType::Float64:
+            return 8;
+    }
+    return 0;
+}
+
+template<class T>
+double decodeScalar(const unsigned char* bytes)
+{
+    T value;
+    std::memcpy(&value, bytes, sizeof(T));
+    return static_cast<double>(value);
+}
+
+double decodePlyScalar(const char* data, EPlyType type, bool swap)
+{
+    unsigned char bytes[8];
+    const std::size_t size = EPlyType_size(type);
+    if (swap)
+        std::reverse_copy(data, data + size, bytes);
+    else
+        std::memcpy(bytes, data, size);
+
+    switch (type)
+    {
+        case EPlyType::Int8:
+            return decodeScalar<std::int8_t>(bytes);
+        case EPlyType::UInt8:
+            return decodeScalar<std::uint8_t>(bytes);
+        case EPlyType::Int16:
+            return decodeScalar<std::int16_t>(bytes);
+        case EPlyType::UInt16:
+            return decodeScalar<std::uint16_t>(bytes);
+        case EPlyType::Int32:
+            return decodeScalar<std::int32_t>(bytes);
+        case EPlyType::UInt32:
+            return decodeScalar<std::uint32_t>(bytes);
+        case EPlyType::Float32:
+            return decodeScalar<float>(bytes);
+        case EPlyType::Float64:
+            return decodeScalar<double>(bytes);
+    }
+    return 0.0;
+}
+
+struct PlyProperty
+{
+    std::string name;
+    EPlyType type = EPlyType::Float32;
+    bool isList = false;
+    EPlyType countType = EPlyType::UInt8;
+};
+
+struct PlyElement
+{
+    std::string name;
+    std::size_t count = 0;
+    std::vector<PlyProperty> properties;
+};
+
+/**
+ * @brief Indices of the properties of the vertex and face elements read into the mesh.
+ */
+struct PlyLayout
+{
+    int vertexElement = -1;
+    int faceElement = -1;
+    int coordinates[3] = {-1, -1, -1};
+    int colors[3] = {-1, -1, -1};
+    int indices = -1;
+
+    bool hasColors() const { return colors[0] >= 0 && colors[1] >= 0 && colors[2] >= 0; }
+};
+
+bool readHeaderLine(std::FILE* file, std::string& line)
+{
+    line.clear();
+    int c;
+    while ((c = std::fgetc(file)) != EOF && c != '\n')
+    {
+        if (c != '\r')
+            line.push_back(static_cast<char>(c));
+    }
+    return c != EOF || !line.empty();
+}
+
+bool readPlyHeader(std::FILE* file, EPlyFormat& format, std::vector<PlyElement>& elements)
+{
+    std::string line;
+    if (!readHeaderLine(file, line) || line != "ply")
+        return false;
+
+    bool hasFormat = false;
+    while (readHeaderLine(file, line))
+    {
+        std::istringstream stream(line);
+        std::string keyword;
+        stream >> keyword;
+
+        if (keyword == "format")
+        {
+            std::string name;
+            stream >> name;
+            if (name == "ascii")
+                format = EPlyFormat::Ascii;
+            else if (name == "binary_little_endian")
+                format = EPlyFormat::BinaryLittleEndian;
+            else if (name == "binary_big_endian")
+                format = EPlyFormat::BinaryBigEndian;
+            else
+                return false;
+            hasFormat = true;
+        }
+        else if (keyword == "element")
+        {
+            PlyElement element;
+            stream >> element.name >> element.count;
+            if (stream.fail())
+                return false;
+            elements.push_back(element);
+        }
+        else if (keyword == "property")
+        {
+            if (elements.empty())
+                return false;
+
+            PlyProperty property;
+            std::string typeName;
+            stream >> typeName;
+            if (typeName == "list")
+            {
+                std::string countTypeName;
+                stream >> countTypeName >> typeName;
+                property.isList = true;
+                if (!EPlyType_fromString(countTypeName, property.countType))
+                    return false;
+            }
+            stream >> property.name;
+            if (stream.fail() || !EPlyType_fromString(typeName, property.type))
+                return false;
+            elements.back().properties.push_back(property);
+        }
+        else if (keyword == "end_header")
+        {
+            return hasFormat;
+        }
+        // the comments and obj_info are ignored
+    }
+
+    return false;
+}
+
+bool computePlyLayout(const std::vector<PlyElement>& elements, PlyLayout& layout)
+{
+    for (int e = 0; e < static_cast<int>(elements.size()); ++e)
+    {
+        const PlyElement& element = elements[e];
+
+        if (element.name == "vertex" && layout.vertexElement < 0)
+        {
+            layout.vertexElement = e;
+            for (int p = 0; p < static_cast<int>(element.properties.size()); ++p)
+            {
+                const PlyProperty& property = element.properties[p];
+                if (property.isList)
+                    return false;
+
+                const std::string& name = property.name;
+                if (name == "x" || name == "y" || name == "z")
+                    layout.coordinates[name[0] - 'x'] = p;
+                else if (name == "red" || name == "diffuse_red")
+                    layout.colors[0] = p;
+                else if (name == "green" || name == "diffuse_green")
+                    layout.colors[1] = p;
+                else if (name == "blue" || name == "diffuse_blue")
+                    layout.colors[2] = p;
+                else if (name == "u" || name == "v" || name == "s" || name == "t" || name.rfind("texture_", 0) == 0)
+                    return false;
+            }
+        }
+        else if (element.name == "face" && layout.faceElement < 0)
+        {
+            layout.faceElement = e;
+            for (int p = 0; p < static_cast<int>(element.properties.size()); ++p)
+            {
+                const PlyProperty& property = element.properties[p];
+                if (property.isList && (property.name == "vertex_indices" || property.name == "vertex_index") && layout.indices < 0)
+                    layout.indices = p;
+                else if (property.isList)
+                    return false;
+            }
+        }
+    }
+
+    return layout.vertexElement >= 0 && layout.coordinates[0] >= 0 && layout.coordinates[1] >= 0 && layout.coordinates[2] >= 0 &&
+           (layout.faceElement < 0 || layout.indices >= 0);
+}
+
+bool isColorFloat(const PlyProperty& property) { return property.type == EPlyType::Float32 || property.type == EPlyType::Float64; }
+
+/**
+ * @brief Buffered sequential reads of a binary file.
+ */
+class BinaryFileReader
+{
+  public:
+    explicit BinaryFileReader(std::FILE* file)
+      : _file(file),
+        _buffer(1 << 20)
+    {}
+
+    bool read(void* data, std::size_t size)
+    {
+        char* output = static_cast<char*>(data);
+        while (size > 0)
+        {
+            if (_begin == _end)
+            {
+                if (size >= _buffer.size())
+                    return readBytes(_file, output, size);
+                _begin = 0;
+                _end = std::fread(_buffer.data(), 1, _buffer.size(), _file);
+                if (_end == 0)
+                    return false;
+            }
+            const std::size_t count = std::min(size, _end - _begin);
+            std::memcpy(output, _buffer.data() + _begin, count);
+            _begin += count;
+            output += count;
+            size -= count;
+        }
+        return true;
+    }
+
+  private:
+    std::FILE* _file;
+    std::vector<char> _buffer;
+    std::size_t _begin = 0;
+    std::size_t _end = 0;
+};
+
+bool readBinaryPlyValue(BinaryFileReader& reader, EPlyType type, bool swap, double& value)
+{
+    char data[8];
+    if (!reader.read(data, EPlyType_size(type)))
+        return false;
+    value = decodePlyScalar(data, type, swap);
+    return true;
+}
+
+bool readBinaryPlyVertices(BinaryFileReader& reader, const PlyElement& element, const PlyLayout& layout, bool swap, Mesh& mesh)
+{
+    std::vector<std::size_t> offsets;
+    std::size_t recordSize = 0;
+    for (const PlyProperty& property : element.properties)
+    {
+        offsets.push_back(recordSize);
+        recordSize += EPlyType_size(property.type);
+    }
+
+    std::vector<Point3d>& points = mesh.pts.getDataWritable();
+    std::vector<rgb>& colors = mesh.colors();
+    points.resize(element.count);
+    if (layout.hasColors())
+        colors.resize(element.count);
+
+    const std::size_t maxRecords = std::max<std::size_t>(1, blockSize / std::max<std::size_t>(1, recordSize));
+    std::vector<char> records;
+
+    for (std::size_t begin = 0; begin < element.count; begin += maxRecords)
+    {
+        const std::size_t nbRecords = std::min(maxRecords, element.count - begin);
+        records.resize(nbRecords * recordSize);
+        if (!reader.read(records.data(), records.size()))
+            return false;
+
+#pragma omp parallel for
+        for (int r = 0; r < static_cast<int>(nbRecords); ++r)
+        {
+            const char* record = records.data() + r * recordSize;
+            double coordinates[3];
+            for (int k = 0; k < 3; ++k)
+            {
+                const int p = layout.coordinates[k];
+                coordinates[k] = decodePlyScalar(record + offsets[p], element.properties[p].type, swap);
+            }
+            // same coordinates convention as Mesh::load
+            points[begin + r] = Point3d(coordinates[0], -coordinates[1], -coordinates[2]);
+
+            if (layout.hasColors())
+            {
+                unsigned char color[3];
+                for (int k = 0; k < 3; ++k)
+                {
+                    const PlyProperty& property = element.properties[layout.colors[k]];
+                    const double value = decodePlyScalar(record + offsets[layout.colors[k]], property.type, swap);
+                    color[k] = toColorByte(isColorFloat(property) ? value * 255.0 : value);
+                }
+                colors[begin + r] = rgb(color[0], color[1], color[2]);
+            }
+        }
+    }
+
+    return true;
+}
+
+bool readBinaryPlyElement(BinaryFileReader& reader, const PlyElement& element, int indicesProperty, bool swap, std::vector<Mesh::triangle>& triangles)
+{
+    std::vector<long> face;
+    std::vector<char> values;
+
+    for (std::size_t i = 0; i < element.count; ++i)
+    {
+        for (int p = 0; p < static_cast<int>(element.properties.size()); ++p)
+        {
+            const PlyProperty& property = element.properties[p];
+            const std::size_t valueSize = EPlyType_size(property.type);
+
+            std::size_t count = 1;
+            if (property.isList)
+            {
+                double value;
+                if (!readBinaryPlyValue(reader, property.countType, swap, value) || value < 0.0)
+                    return false;
+                count = static_cast<std::size_t>(value);
+            }
+
+            values.resize(count * valueSize);
+            if (!reader.read(values.data(), values.size()))
+                return false;
+
+            if (p == indicesProperty)
+            {
+                face.resize(count);
+                for (std::size_t k = 0; k < count; ++k)
+                    face[k] = static_cast<long>(decodePlyScalar(values.data() + k * valueSize, property.type, swap));
+                appendFace(face, triangles);
+            }
+        }
+    }
+
+    return true;
+}
+
+bool readBinaryPly(std::FILE* file, const std::vector<PlyElement>& elements, const PlyLayout& layout, bool swap, Mesh& mesh)
+{
+    BinaryFileReader reader(file);
+
+    for (int e = 0; e < static_cast<int>(elements.size()); ++e)
+    {
+        if (e == layout.vertexElement)
+        {
+            if (!readBinaryPlyVertices(reader, elements[e], layout, swap, mesh))
+                return false;
+        }
+        else if (!readBinaryPlyElement(reader, elements[e], (e == layout.faceElement) ? layout.indices : -1, swap, mesh.tris.getDataWritable()))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Data parsed from a part of an ASCII PLY file.
+ */
+struct PlyPart
+{
+    std::size_t firstLine = 0;
+    std::vector<Mesh::triangle> triangles;
+    bool supported = true;
+};
+
+bool parsePlyLine(const char* p, const PlyElement& element, const PlyLayout& layout, bool isVertex, std::vector<double>& values, std::vector<long>& face)
+{
+    for (int i = 0; i < static_cast<int>(element.properties.size()); ++i)
+    {
+        const PlyProperty& property = element.properties[i];
+        if (!property.isList)
+        {
+            if (!parseDouble(p, values[i]))
+                return false;
+            continue;
+        }
+
+        long count;
+        if (!parseInt(p, count) || count < 0)
+            return false;
+
+        if (!isVertex && i == layout.indices)
+        {
+            face.resize(count);
+            for (long k = 0; k < count; ++k)
+            {
+                if (!parseInt(p, face[k]))
+                    return false;
+            }
+        }
+        else
+        {
+            double value;
+            for (long k = 0; k < count; ++k)
+            {
+                if (!parseDouble(p, value))
+                    return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool readAsciiPly(std::FILE* file, const std::string& filepath, const std::vector<PlyElement>& elements, const PlyLayout& layout, Mesh& mesh)
+{
+    // first line of each element
+    std::vector<std::size_t> elementsFirstLine(elements.size() + 1, 0);
+    for (std::size_t e = 0; e < elements.size(); ++e)
+        elementsFirstLine[e + 1] = elementsFirstLine[e] + elements[e].count;
+
+    const PlyElement& vertexElement = elements[layout.vertexElement];
+    const std::size_t vertexFirstLine = elementsFirstLine[layout.vertexElement];
+
+    std::vector<Point3d>& points = mesh.pts.getDataWritable();
+    std::vector<rgb>& colors = mesh.colors();
+    std::vector<Mesh::triangle>& triangles = mesh.tris.getDataWritable();
+    points.resize(vertexElement.count);
+    if (layout.hasColors())
+        colors.resize(vertexElement.count);
+
+    std::vector<PlyPart> parts;
+    std::size_t nbLines = 0;
+
+    return readLineBlocks(file, filepath, [&](const LineParts& blockParts) {
+        parts.resize(blockParts.size());
+
+        // first line of each part
+#pragma omp parallel for
+        for (int p = 0; p < static_cast<int>(blockParts.size()); ++p)
+        {
+            const char* begin = blockParts[p].first;
+            const char* end = blockParts[p].second;
+            std::size_t count = std::count(begin, end, '\n');
+            if (begin != end && end[-1] != '\n')
+                ++count;
+            parts[p].firstLine = count;
+        }
+        for (PlyPart& part : parts)
+        {
+            const std::size_t count = part.firstLine;
+            part.firstLine = nbLines;
+            nbLines += count;
+        }
+
+#pragma omp parallel for
+        for (int p = 0; p < static_cast<int>(blockParts.size()); ++p)
+        {
+            PlyPart& part = parts[p];
+            part.triangles.clear();
+            part.supported = true;
+
+            std::vector<double> values;
+            std::vector<long> face;
+            std::size_t lineIndex = part.firstLine;
+            int e = static_cast<int>(std::upper_bound(elementsFirstLine.begin(), elementsFirstLine.end(), lineIndex) - elementsFirstLine.begin()) - 1;
+
+            for (const char* line = blockParts[p].first; line < blockParts[p].second; line = nextLine(line, blockParts[p].second), ++lineIndex)
+            {
+                while (e < static_cast<int>(elements.size()) && lineIndex >= elementsFirstLine[e + 1])
+                    ++e;
+                if (e >= static_cast<int>(elements.size()))
+                    break;
+                if (e != layout.vertexElement && e != layout.faceElement)
+                    continue;
+
+                const PlyElement& element = elements[e];
+                const bool isVertex = (e == layout.vertexElement);
+                values.resize(element.properties.size());
+                face.clear();
+                if (!parsePlyLine(line, element, layout, isVertex, values, face))
+                {
+                    part.supported = false;
+                    break;
+                }
+
+                if (isVertex)
+                {
+                    const std::size_t i = lineIndex - vertexFirstLine;
+                    // same coordinates convention as Mesh::load
+                    points[i] = Point3d(values[layout.coordinates[0]], -values[layout.coordinates[1]], -values[layout.coordinates[2]]);
+                    if (layout.hasColors())
+                    {
+                        unsigned char color[3];
+                        for (int k = 0; k < 3; ++k)
+                        {
+                            const double value = values[layout.colors[k]];
+                            color[k] = toColorByte(isColorFloat(element.properties[layout.colors[k]]) ? value * 255.0 : value);
+                        }
+                        colors[i] = rgb(color[0], color[1], color[2]);
+                    }
+                }
+                else
+                {
+                    appendFace(face, part.triangles);
+                }
+            }
+        }
+
+        for (const PlyPart& part : parts)
+        {
+            if (!part.supported)
+                return false;
+            triangles.insert(triangles.end(), part.triangles.begin(), part.triangles.end());
+        }
+        return true;
+    }) && nbLines >= elementsFirstLine.back();
+}
+
+/**
+ * @brief Write elements formatted in parallel by chunks, in the element order.
+ * @param[in] format appends the element of the given index to a buffer
+ */
+template<class F>
+void writeFormatted(std::FILE* file, const std::string& filepath, std::size_t nbElements, F&& format)
+{
+    const int nbChunks = omp_get_max_threads();
+    std::vector<std::string> buffers(nbChunks);
+
+    for (std::size_t begin = 0; begin < nbElements; begin += nbChunks * formatChunkSize)
+    {
+#pragma omp parallel for
+        for (int c = 0; c < nbChunks; ++c)
+        {
+            buffers[c].clear();
+            const std::size_t chunkBegin = begin + c * formatChunkSize;
+            const std::size_t chunkEnd = std::min(nbElements, chunkBegin + formatChunkSize);
+            for (std::size_t i = chunkBegin; i < chunkEnd; ++i)
+                format(buffers[c], i);
+        }
+
+        for (const std::string& buffer : buffers)
+            writeBytes(file, filepath, buffer.data(), buffer.size());
+    }
+}
+
+template<class... Args>
+void appendText(std::string& buffer, const char* format, Args... args)
+{
+    char text[128];
+    const int size = std::snprintf(text, sizeof(text), format, args...);
+    buffer.append(text, std::min<std::size_t>(std::max(size, 0), sizeof(text) - 1));
+}
+
+template<class T>
+void appendBinary(std::string& buffer, const T& value)
+{
+    buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void writeColumn(std::FILE* file, const std::string& filepath, const void* data, std::size_t size)
+{
+    const std::size_t nbBlocks = (size + blockSize - 1) / blockSize;
+    std::vector<std::vector<Bytef>> blocks(nbBlocks);
+
+    bool valid = true;
+#pragma omp parallel for reduction(&& : valid)
+    for (int b = 0; b < static_cast<int>(nbBlocks); ++b)
+    {
+        const std::size_t begin = b * blockSize;
+        const uLong rawSize = static_cast<uLong>(std::min(blockSize, size - begin));
+        uLongf compressedSize = compressBound(rawSize);
+        blocks[b].resize(compressedSize);
+        valid = valid && compress2(blocks[b].data(), &compressedSize, static_cast<const Bytef*>(data) + begin, rawSize, Z_BEST_SPEED) == Z_OK;
+        blocks[b].resize(compressedSize);
+    }
+
+    if (!valid)
+    {
+        ALICEVISION_THROW_ERROR("Failed compressing the mesh data of " << filepath);
+    }
+
+    for (const std::vector<Bytef>& block : blocks)
+    {
+        const std::uint64_t compressedSize = block.size();
+        writeBytes(file, filepath, &compressedSize, sizeof(compressedSize));
+        writeBytes(file, filepath, block.data(), block.size());
+    }
+}
+
+bool readColumn(std::FILE* file, void* data, std::size_t size)
+{
+    const std::size_t nbBlocks = (size + blockSize - 1) / blockSize;
+    std::vector<std::vector<Bytef>> blocks(nbBlocks);
+
+    for (std::vector<Bytef>& block : blocks)
+    {
+        std::uint64_t compressedSize;
+        if (!readBytes(file, &compressedSize, sizeof(compressedSize)) || compressedSize > compressBound(blockSize))
+            return false;
+        block.resize(compressedSize);
+        if (!readBytes(file, block.data(), block.size()))
+            return false;
+    }
+
+    bool valid = true;
+#pragma omp parallel for reduction(&& : valid)
+    for (int b = 0; b < static_cast<int>(nbBlocks); ++b)
+    {
+        const std::size_t begin = b * blockSize;
+        const uLong expectedSize = static_cast<uLong>(std::min(blockSize, size - begin));
+        uLongf rawSize = expectedSize;
+        valid = valid && uncompress(static_cast<Bytef*>(data) + begin, &rawSize, blocks[b].data(), blocks[b].size()) == Z_OK &&
+                rawSize == expectedSize;
+    }
+
+    return valid;
+}
+
+/**
+ * @brief Write a column of values gathered in parallel.
+ */
+template<class T, class Get>
+void writeColumn(std::FILE* file, const std::string& filepath, std::size_t size, Get get)
+{
+    std::vector<T> column(size);
+#pragma omp parallel for
+    for (int i = 0; i < static_cast<int>(size); ++i)
+        column[i] = get(i);
+    writeColumn(file, filepath, column.data(), size * sizeof(T));
+}
+
+/**
+ * @brief Read a column of values scattered in parallel.
+ */
+template<class T, class Set>
+bool readColumn(std::FILE* file, std::size_t size, Set set)
+{
+    std::vector<T> column(size);
+    if (!readColumn(file, column.data(), size * sizeof(T)))
+        return false;
+#pragma omp parallel for
+    for (int i = 0; i < static_cast<int>(size); ++i)
+        set(i, column[i]);
+    return true;
+}
+
+/**
+ * @brief Read the raw format of the previous versions: the points and triangles arrays.
+ */
+bool readLegacyBinaryMesh(std::FILE* file, Mesh& mesh)
+{
+    int nbPoints;
+    if (!readBytes(file, &nbPoints, sizeof(int)) || nbPoints < 0)
+        return false;
+    mesh.pts.resize(nbPoints);
+    if (!readBytes(file, mesh.pts.getDataWritable().data(), nbPoints * sizeof(Point3d)))
+        return false;
+
+    int nbTriangles;
+    if (!readBytes(file, &nbTriangles, sizeof(int)) || nbTriangles < 0)
+        return false;
+    mesh.tris.resize(nbTriangles);
+    return readBytes(file, mesh.tris.getDataWritable().data(), nbTriangles * sizeof(Mesh::triangle));
+}
+
+}  // namespace
+
+bool readObj(const std::string& filepath, Mesh& mesh)
+{
+    FilePtr file(std::fopen(filepath.c_str(), "rb"));
+    if (!file)
+        return false;
+
+    std::vector<Point3d>& points = mesh.pts.getDataWritable();
+    std::vector<rgb>& colors = mesh.colors();
+    std::vector<Mesh::triangle>& triangles = mesh.tris.getDataWritable();
+    std::size_t nbColors = 0;
+    std::vector<ObjPart> parts;
+
+    const bool supported = readLineBlocks(file.get(), filepath, [&](const LineParts& blockParts) {
+        parts.resize(blockParts.size());
+
+#pragma omp parallel for
+        for (int p = 0; p < static_cast<int>(blockParts.size()); ++p)
+        {
+            parts[p].clear();
+            parseObjPart(blockParts[p].first, blockParts[p].second, parts[p]);
+        }
+
+        for (ObjPart& part : parts)
+        {
+            if (!part.supported)
+                return false;
+
+            const int firstPoint = static_cast<int>(points.size());
+            for (const std::size_t position : part.relativeIndices)
+                part.triangles[position / 3].v[position % 3] += firstPoint;
+
+            points.insert(points.end(), part.points.begin(), part.points.end());
+            colors.insert(colors.end(), part.colors.begin(), part.colors.end());
+            triangles.insert(triangles.end(), part.triangles.begin(), part.triangles.end());
+            nbColors += part.nbColors;
+        }
+        return true;
+    });
+
+    // the vertex colors are kept only if all the vertices have one
+    if (nbColors != points.size())
+        std::vector<rgb>().swap(colors);
+
+    if (!supported || !finalizeMesh(mesh))
+    {
+        clearMesh(mesh);
+        return false;
+    }
+    return true;
+}
+
+bool readPly(const std::string& filepath, Mesh& mesh)
+{
+    FilePtr file(std::fopen(filepath.c_str(), "rb"));
+    if (!file)
+        return false;
+
+    EPlyFormat format;
+    std::vector<PlyElement> elements;
+    PlyLayout layout;
+    if (!readPlyHeader(file.get(), format, elements) || !computePlyLayout(elements, layout))
+        return false;
+
+    const bool swap = (format == EPlyFormat::BinaryLittleEndian) != isLittleEndian();
+    const bool supported =
+      (format == EPlyFormat::Ascii) ? readAsciiPly(file.get(), filepath, elements, layout, mesh) : readBinaryPly(file.get(), elements, layout, swap, mesh);
+
+    if (!supported || !finalizeMesh(mesh))
+    {
+        clearMesh(mesh);
+        return false;
+    }
+    return true;
+}
+
+void writeObj(const std::string& filepath, const Mesh& mesh)
+{
+    FilePtr file = openFileForWriting(filepath);
+
+    const std::string header = "# Vertices: " + std::to_string(mesh.pts.size()) + "\n# Faces: " + std::to_string(mesh.tris.size()) + "\n";
+    writeBytes(file.get(), filepath, header.data(), header.size());
+
+    // same coordinates convention and precision as the Assimp exporter used by Mesh::save
+    writeFormatted(file.get(), filepath, mesh.pts.size(), [&](std::string& buffer, std::size_t i) {
+        const Point3d& point = mesh.pts[i];
+        appendText(buffer, "v %.9g %.9g %.9g\n", point.x, -point.y, -point.z);
+    });
+
+    writeFormatted(file.get(), filepath, mesh.tris.size(), [&](std::string& buffer, std::size_t i) {
+        const Mesh::triangle& triangle = mesh.tris[i];
+        appendText(buffer, "f %d %d %d\n", triangle.v[0] + 1, triangle.v[1] + 1, triangle.v[2] + 1);
+    });
+
+    closeWrittenFile(file, filepath);
+}
+
+void writePly(const std::string& filepath, const Mesh& mesh, bool binary)
+{
+    FilePtr file = openFileForWriting(filepath);
+
+    const bool hasColors = !mesh.pts.empty() && mesh.colors().size() == static_cast<std::size_t>(mesh.pts.size());
+
+    std::ostringstream header;
+    header << "ply\n"
+           << "format " << (binary ? (isLittleEndian() ? "binary_little_endian" : "binary_big_endian") : "ascii") << " 1.0\n"
+           << "element vertex " << mesh.pts.size() << "\n"
+           << "property double x\n"
+           << "property double y\n"
+           << "property double z\n";
+    if (hasColors)
+    {
+        header << "property uchar red\n"
+               << "property uchar green\n"
+               << "property uchar blue\n";
+    }
+    header << "element face " << mesh.tris.size() << "\n"
+           << "property list uchar int vertex_indices\n"
+           << "end_header\n";
+    const std::string headerStr = header.str();
+    writeBytes(file.get(), filepath, headerStr.data(), headerStr.size());
+
+    // same coordinates convention as Mesh::save
+    writeFormatted(file.get(), filepath, mesh.pts.size(), [&](std::string& buffer, std::size_t i) {
+        const Point3d& point = mesh.pts[i];
+        if (binary)
+        {
+            appendBinary(buffer, point.x);
+            appendBinary(buffer, -point.y);
+            appendBinary(buffer, -point.z);
+            if (hasColors)
+            {
+                const rgb& color = mesh.colors()[i];
+                appendBinary(buffer, color.r);
+                appendBinary(buffer, color.g);
+                appendBinary(buffer, color.b);
+            }
+        }
+        else if (hasColors)
+        {
+            const rgb& color = mesh.colors()[i];
+            appendText(buffer, "%.9g %.9g %.9g %d %d %d\n", point.x, -point.y, -point.z, int(color.r), int(color.g), int(color.b));
+        }
+        else
+        {
+            appendText(buffer, "%.9g %.9g %.9g\n", point.x, -point.y, -point.z);
+        }
+    });
+
+    writeFormatted(file.get(), filepath, mesh.tris.size(), [&](std::string& buffer, std::size_t i) {
+        const Mesh::triangle& triangle = mesh.tris[i];
+        if (binary)
+        {
+            appendBinary(buffer, static_cast<unsigned char>(3));
+            for (int k = 0; k < 3; ++k)
+                appendBinary(buffer, static_cast<std::int32_t>(triangle.v[k]));
+        }
+        else
+        {
+            appendText(buffer, "3 %d %d %d\n", triangle.v[0], triangle.v[1], triangle.v[2]);
+        }
+    });
+
+    closeWrittenFile(file, filepath);
+}
+
+bool readBinaryMesh(const std::string& filepath, Mesh& mesh)
+{
+    FilePtr file(std::fopen(filepath.c_str(), "rb"));
+    if (!file)
+        return false;
+
+    char magic[4];
+    const bool hasMagic = readBytes(file.get(), magic, sizeof(magic)) && std::equal(magic, magic + 4, binaryMeshMagic);
+
+    bool valid;
+    if (!hasMagic)
+    {
+        std::rewind(file.get());
+        valid = readLegacyBinaryMesh(file.get(), mesh);
+    }
+    else
+    {
+        std::uint32_t version;
+        std::uint64_t nbPoints, nbTriangles;
+        std::uint8_t hasColors, hasVisibilities;
+        valid = readBytes(file.get(), &version, sizeof(version)) && version == binaryMeshVersion &&
+                readBytes(file.get(), &nbPoints, sizeof(nbPoints)) && readBytes(file.get(), &nbTriangles, sizeof(nbTriangles)) &&
+                readBytes(file.get(), &hasColors, sizeof(hasColors)) && readBytes(file.get(), &hasVisibilities, sizeof(hasVisibilities));
+
+        if (valid)
+        {
+            mesh.pts.resize(nbPoints);
+            mesh.tris.resize(nbTriangles);
+            for (int k = 0; k < 3 && valid; ++k)
+            {
+                valid = readColumn<double>(file.get(), nbPoints, [&](int i, double value) { mesh.pts[i].m[k] = value; });
+            }
+
+            // prefix sum of the delta-encoded indices
+            std::vector<std::uint32_t> indices(nbTriangles);
+            for (int k = 0; k < 3 && valid; ++k)
+            {
+                valid = readColumn(file.get(), indices.data(), nbTriangles * sizeof(std::uint32_t));
+                std::uint32_t index = 0;
+                for (std::size_t i = 0; i < nbTriangles && valid; ++i)
+                {
+                    index += indices[i];
+                    mesh.tris[i].v[k] = static_cast<int>(index);
+                }
+            }
+            std::vector<std::uint32_t>().swap(indices);
+
+            valid = valid && readColumn<std::uint8_t>(file.get(), nbTriangles, [&](int i, std::uint8_t alive) { mesh.tris[i].alive = alive; });
+
+            if (hasColors)
+            {
+                std::vector<rgb>& colors = mesh.colors();
+                colors.resize(nbPoints);
+                valid = valid && readColumn<std::uint8_t>(file.get(), nbPoints, [&](int i, std::uint8_t value) { colors[i].r = value; }) &&
+                        readColumn<std::uint8_t>(file.get(), nbPoints, [&](int i, std::uint8_t value) { colors[i].g = value; }) &&
+                        readColumn<std::uint8_t>(file.get(), nbPoints, [&](int i, std::uint8_t value) { colors[i].b = value; });
+            }
+
+            if (hasVisibilities && valid)
+            {
+                std::vector<std::uint64_t> offsets(nbPoints + 1, 0);
+                mesh.pointsVisibilities.resize(nbPoints);
+                valid = readColumn<std::int32_t>(file.get(), nbPoints, [&](int i, std::int32_t count) {
+                    mesh.pointsVisibilities[i].resize(std::max(0, count));
+                    offsets[i + 1] = std::max(0, count);
+                });
+                for (std::size_t i = 0; i < nbPoints; ++i)
+                    offsets[i + 1] += offsets[i];
+
+                std::vector<std::int32_t> cameras(offsets.back());
+                valid = valid && readColumn(file.get(), cameras.data(), cameras.size() * sizeof(std::int32_t));
+                if (valid)
+                {
+#pragma omp parallel for
+                    for (int i = 0; i < static_cast<int>(nbPoints); ++i)
+                    {
+                        std::copy(cameras.begin() + offsets[i], cameras.begin() + offsets[i + 1], mesh.pointsVisibilities[i].begin());
+                    }
+                }
+            }
+        }
+    }
+
+    if (!valid)
+    {
+        clearMesh(mesh);
+        return false;
+    }
+
+    setDefaultTrianglesAttributes(mesh);
+    return true;
+}
+
+void writeBinaryMesh(const std::string& filepath, const Mesh& mesh)
+{
+    FilePtr file = openFileForWriting(filepath);
+
+    const std::size_t nbPoints = mesh.pts.size();
+    const std::size_t nbTriangles = mesh.tris.size();
+    const std::uint8_t hasColors = !mesh.pts.empty() && mesh.colors().size() == nbPoints;
+    const std::uint8_t hasVisibilities = !mesh.pts.empty() && mesh.pointsVisibilities.size() == static_cast<int>(nbPoints);
+
+    const std::uint64_t nbPoints64 = nbPoints;
+    const std::uint64_t nbTriangles64 = nbTriangles;
+    writeBytes(file.get(), filepath, binaryMeshMagic, sizeof(binaryMeshMagic));
+    writeBytes(file.get(), filepath, &binaryMeshVersion, sizeof(binaryMeshVersion));
+    writeBytes(file.get(), filepath, &nbPoints64, sizeof(nbPoints64));
+    writeBytes(file.get(), filepath, &nbTriangles64, sizeof(nbTriangles64));
+    writeBytes(file.get(), filepath, &hasColors, sizeof(hasColors));
+    writeBytes(file.get(), filepath, &hasVisibilities, sizeof(hasVisibilities));
+
+    for (int k = 0; k < 3; ++k)
+    {
+        writeColumn<double>(file.get(), filepath, nbPoints, [&](int i) { return mesh.pts[i].m[k]; });
+    }
+
+    for (int k = 0; k < 3; ++k)
+    {
+        writeColumn<std::uint32_t>(file.get(), filepath, nbTriangles, [&](int i) {
+            const std::uint32_t previous = (i > 0) ? static_cast<std::uint32_t>(mesh.tris[i - 1].v[k]) : 0;
+            return static_cast<std::uint32_t>(mesh.tris[i].v[k]) - previous;
+        });
+    }
+
+    writeColumn<std::uint8_t>(file.get(), filepath, nbTriangles, [&](int i) { return static_cast<std::uint8_t>(mesh.tris[i].alive); });
+
+    if (hasColors)
+    {
+        writeColumn<std::uint8_t>(file.get(), filepath, nbPoints, [&](int i) { return mesh.colors()[i].r; });
+        writeColumn<std::uint8_t>(file.get(), filepath, nbPoints, [&](int i) { return mesh.colors()[i].g; });
+        writeColumn<std::uint8_t>(file.get(), filepath, nbPoints, [&](int i) { return mesh.colors()[i].b; });
+    }
+
+    if (hasVisibilities)
+    {
+        std::vector<std::uint64_t> offsets(nbPoints + 1, 0);
+        for (std::size_t i = 0; i < nbPoints; ++i)
+            offsets[i + 1] = offsets[i] + mesh.pointsVisibilities[i].size();
+
+        writeColumn<std::int32_t>(file.get(), filepath, nbPoints, [&](int i) { return mesh.pointsVisibilities[i].size(); });
+
+        std::vector<std::int32_t> cameras(offsets.back());
+#pragma omp parallel for
+        for (int i = 0; i < static_cast<int>(nbPoints); ++i)
+        {
+            std::copy(mesh.pointsVisibilities[i].begin(), mesh.pointsVisibilities[i].end(), cameras.begin() + offsets[i]);
+        }
+        writeColumn(file.get(), filepath, cameras.data(), cameras.size() * sizeof(std::int32_t));
+    }
+
+    closeWrittenFile(file, filepath);
+}
+
+}  // namespace mesh
+}  // namespace aliceVision
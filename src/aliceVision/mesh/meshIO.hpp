@@ -0,0 +1,72 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <string>
+
+namespace aliceVision {
+namespace mesh {
+
+class Mesh;
+
+/**
+ * @brief Read an OBJ file directly into the mesh, the large blocks of lines being parsed in parallel.
+ *        Only the vertices, their colors and the faces are read: the files with texture coordinates
+ *        or materials are left to the Assimp loader.
+ * @param[in] filepath the OBJ file path
+ * @param[out] mesh the mesh to fill
+ * @return false if the file is not handled by this reader, the mesh is then left empty
+ */
+bool readObj(const std::string& filepath, Mesh& mesh);
+
+/**
+ * @brief Read an ASCII or binary PLY file directly into the mesh, the vertices being decoded in parallel.
+ *        Only the vertices, their colors and the faces are read: the files with texture coordinates
+ *        are left to the Assimp loader.
+ * @param[in] filepath the PLY file path
+ * @param[out] mesh the mesh to fill
+ * @return false if the file is not handled by this reader, the mesh is then left empty
+ */
+bool readPly(const std::string& filepath, Mesh& mesh);
+
+/**
+ * @brief Write the vertices and the triangles of the mesh to an OBJ file,
+ *        formatted in parallel by chunks and streamed to the file.
+ * @param[in] filepath the OBJ file path
+ * @param[in] mesh the mesh to write
+ */
+void writeObj(const std::string& filepath, const Mesh& mesh);
+
+/**
+ * @brief Write the vertices, their colors and the triangles of the mesh to a PLY file,
+ *        formatted in parallel by chunks and streamed to the file.
+ * @param[in] filepath the PLY file path
+ * @param[in] mesh the mesh to write
+ * @param[in] binary write a binary file in the native byte order instead of an ASCII file
+ */
+void writePly(const std::string& filepath, const Mesh& mesh, bool binary = true);
+
+/**
+ * @brief Read a mesh in the internal binary format, written by writeBinaryMesh.
+ *        The raw format of the previous versions is still read.
+ * @param[in] filepath the binary mesh file path
+ * @param[out] mesh the mesh to fill
+ * @return false if the file can't be opened or is truncated
+ */
+bool readBinaryMesh(const std::string& filepath, Mesh& mesh);
+
+/**
+ * @brief Write the vertices, their colors and visibilities, and the triangles of the mesh in the internal binary format.
+ *        Each attribute is stored as a separate column, compressed by blocks in parallel.
+ *        The triangle indices are delta-encoded, as the neighbouring triangles share close vertex indices.
+ * @param[in] filepath the binary mesh file path
+ * @param[in] mesh the mesh to write
+ */
+void writeBinaryMesh(const std::string& filepath, const Mesh& mesh);
+
+}  // namespace mesh
+}  // namespace aliceVision
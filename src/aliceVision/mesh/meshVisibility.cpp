@@ -7,6 +7,7 @@
 #include "meshVisibility.hpp"
 #include "geoMesh.hpp"
 
+#include <aliceVision/config.hpp>
 #include <aliceVision/system/Logger.hpp>
 #include <aliceVision/mvsData/geometry.hpp>
 
@@ -16,34 +17,129 @@
 #include <geogram/mesh/mesh_AABB.h>
 #include <geogram/mesh/mesh_reorder.h>
 
+#include <boost/atomic/atomic_ref.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
+    #include <aliceVision/mesh/cuda/DeviceMeshVisibility.hpp>
+#endif
+
 namespace aliceVision {
 namespace mesh {
 
-void getNearestVertices(const Mesh& refMesh, const Mesh& mesh, StaticVector<int>& out_nearestVertex)
+NearestVertexSearch::NearestVertexSearch(const Mesh& refMesh)
+  : _kdTree(new GEO::AdaptiveKdTree(3)),
+    _nbPoints(refMesh.pts.size())
 {
-    ALICEVISION_LOG_DEBUG("getNearestVertices start.");
-    out_nearestVertex.resize(mesh.pts.size(), -1);
+    if (_nbPoints > 0)
+        _kdTree->set_points(_nbPoints, refMesh.pts.front().m);
+}
 
-    GEO::AdaptiveKdTree refMesh_kdTree(3);
-    refMesh_kdTree.set_points(refMesh.pts.size(), refMesh.pts.front().m);
+NearestVertexSearch::~NearestVertexSearch() = default;
+
+void NearestVertexSearch::getNearestVertices(const StaticVector<Point3d>& points, StaticVector<int>& out_nearestVertex) const
+{
+    out_nearestVertex.resize(points.size(), -1);
+    if (empty())
+        return;
 
 #pragma omp parallel for
-    for (int i = 0; i < mesh.pts.size(); ++i)
+    for (int i = 0; i < points.size(); ++i)
     {
-        out_nearestVertex[i] = refMesh_kdTree.get_nearest_neighbor(mesh.pts[i].m);
+        out_nearestVertex[i] = _kdTree->get_nearest_neighbor(points[i].m);
     }
+}
+
+struct MeshFacetsSearch::Impl
+{
+    GEO::Mesh meshG;
+    std::unique_ptr<GEO::MeshFacetsAABB> meshAABB;
+    /// index in the input mesh of each reordered facet
+    GEO::vector<GEO::index_t> facetIds;
+};
+
+MeshFacetsSearch::MeshFacetsSearch(const Mesh& mesh)
+  : _impl(new Impl())
+{
+    if (mesh.tris.empty())
+        return;
+
+    GEO::initialize();
+    toGeoMesh(mesh, _impl->meshG);
+
+    // MeshFacetAABB will reorder the mesh, so we need to keep indices
+    GEO::Attribute<GEO::index_t> reorderedFacetsAttr(_impl->meshG.facets.attributes(), "reorder");
+    for (int i = 0; i < _impl->meshG.facets.nb(); ++i)
+        reorderedFacetsAttr[i] = i;
+
+    _impl->meshAABB.reset(new GEO::MeshFacetsAABB(_impl->meshG));  // warning: mesh_reorder called inside
+
+    _impl->facetIds = reorderedFacetsAttr.get_vector();
+}
+
+MeshFacetsSearch::~MeshFacetsSearch() = default;
+
+int MeshFacetsSearch::getNearestTriangle(const Point3d& point, double& out_sqDist) const
+{
+    out_sqDist = 0.0;
+    if (!_impl->meshAABB)
+        return -1;
+
+    GEO::vec3 nearestPoint;
+    const GEO::index_t f = _impl->meshAABB->nearest_facet(GEO::vec3(point.m), nearestPoint, out_sqDist);
+    if (f == GEO::NO_FACET)
+        return -1;
+    return _impl->facetIds[f];
+}
+
+void MeshFacetsSearch::getNearestTriangles(const StaticVector<Point3d>& points, StaticVector<int>& out_triIds, StaticVector<double>& out_sqDists) const
+{
+    out_triIds.resize(points.size(), -1);
+    out_sqDists.resize(points.size(), 0.0);
+
+#pragma omp parallel for
+    for (int i = 0; i < points.size(); ++i)
+    {
+        out_triIds[i] = getNearestTriangle(points[i], out_sqDists[i]);
+    }
+}
+
+bool MeshFacetsSearch::isSegmentOccluded(const Point3d& from, const Point3d& to) const
+{
+    if (!_impl->meshAABB)
+        return false;
+
+    const GEO::vec3 gv(from.x, from.y, from.z);
+    const GEO::vec3 gc(to.x, to.y, to.z);
+    const GEO::vec3 vc = gc - gv;
+    return _impl->meshAABB->ray_intersection(GEO::Ray(gv + (vc * 0.00001), vc), 1.0);
+}
+
+void getNearestVertices(const Mesh& refMesh, const Mesh& mesh, StaticVector<int>& out_nearestVertex)
+{
+    ALICEVISION_LOG_DEBUG("getNearestVertices start.");
+    const NearestVertexSearch refMeshSearch(refMesh);
+    refMeshSearch.getNearestVertices(mesh.pts, out_nearestVertex);
     ALICEVISION_LOG_DEBUG("getNearestVertices done.");
 }
 
 void remapMeshVisibilities_pullVerticesVisibility(const Mesh& refMesh, Mesh& mesh)
+{
+    const NearestVertexSearch refMeshSearch(refMesh);
+    remapMeshVisibilities_pullVerticesVisibility(refMesh, refMeshSearch, mesh);
+}
+
+void remapMeshVisibilities_pullVerticesVisibility(const Mesh& refMesh, const NearestVertexSearch& refMeshSearch, Mesh& mesh)
 {
     ALICEVISION_LOG_DEBUG("remapMeshVisibility based on closest vertex start.");
 
     const PointsVisibility& refPtsVisibilities = refMesh.pointsVisibilities;
     PointsVisibility& out_ptsVisibilities = mesh.pointsVisibilities;
 
-    GEO::AdaptiveKdTree refMesh_kdTree(3);
-    refMesh_kdTree.set_points(refMesh.pts.size(), refMesh.pts.front().m);
+    StaticVector<int> nearestVertex;
+    refMeshSearch.getNearestVertices(mesh.pts, nearestVertex);
 
     out_ptsVisibilities.resize(mesh.pts.size());
 
@@ -52,7 +148,7 @@ void remapMeshVisibilities_pullVerticesVisibility(const Mesh& refMesh, Mesh& mes
     {
         PointVisibility& pOut = out_ptsVisibilities[i];
 
-        int iRef = refMesh_kdTree.get_nearest_neighbor(mesh.pts[i].m);
+        const int iRef = nearestVertex[i];
         if (iRef == -1)
             continue;
         const PointVisibility& pRef = refPtsVisibilities[iRef];
@@ -65,71 +161,95 @@ void remapMeshVisibilities_pullVerticesVisibility(const Mesh& refMesh, Mesh& mes
     ALICEVISION_LOG_DEBUG("remapMeshVisibility done.");
 }
 
-double mesh_facet_edges_length(const GEO::Mesh& M, GEO::index_t f)
+double meshTriangleEdgesLength(const Mesh& mesh, int triId)
 {
-    const GEO::vec3& p0 = M.vertices.point(M.facets.vertex(f, 0));
-    const GEO::vec3& p1 = M.vertices.point(M.facets.vertex(f, 1));
-    const GEO::vec3& p2 = M.vertices.point(M.facets.vertex(f, 2));
-    return (p1 - p0).length() + (p2 - p1).length() + (p0 - p2).length();
+    const Point3d& p0 = mesh.pts[mesh.tris[triId].v[0]];
+    const Point3d& p1 = mesh.pts[mesh.tris[triId].v[1]];
+    const Point3d& p2 = mesh.pts[mesh.tris[triId].v[2]];
+    return (p1 - p0).size() + (p2 - p1).size() + (p0 - p2).size();
 }
 
 void remapMeshVisibilities_pushVerticesVisibilityToTriangles(const Mesh& refMesh, Mesh& mesh)
+{
+    const MeshFacetsSearch meshSearch(mesh);
+    remapMeshVisibilities_pushVerticesVisibilityToTriangles(refMesh, mesh, meshSearch);
+}
+
+void remapMeshVisibilities_pushVerticesVisibilityToTriangles(const Mesh& refMesh, Mesh& mesh, const MeshFacetsSearch& meshSearch)
 {
     ALICEVISION_LOG_INFO("remapMeshVisibility based on triangles start.");
 
     const PointsVisibility& refPtsVisibilities = refMesh.pointsVisibilities;
     PointsVisibility& out_ptsVisibilities = mesh.pointsVisibilities;
 
-    GEO::initialize();
-    GEO::Mesh meshG;
-    toGeoMesh(mesh, meshG);
-
-    // MeshFacetAABB will reorder the mesh, so we need to keep indices
-    GEO::Attribute<GEO::index_t> reorderedVerticesAttr(meshG.vertices.attributes(), "reorder");
-    for (int i = 0; i < meshG.vertices.nb(); ++i)
-        reorderedVerticesAttr[i] = i;
-
-    GEO::MeshFacetsAABB meshAABB(meshG);  // warning: mesh_reorder called inside
-
-    GEO::vector<GEO::index_t> reorderedVertices = reorderedVerticesAttr.get_vector();
-
     if (out_ptsVisibilities.size() != mesh.pts.size())
     {
         out_ptsVisibilities.resize(mesh.pts.size());
     }
 
+    // nearest triangle of each reference vertex with a visibility, -1 if it is not pushed
+    StaticVector<int> refPtsNearestTri(refMesh.pts.size(), -1);
+
+    // number of reference vertices pushed to each vertex
+    std::vector<int> nbRefPts(mesh.pts.size() + 1, 0);
+
 #pragma omp parallel for
     for (int rvi = 0; rvi < refMesh.pts.size(); ++rvi)
     {
-        const PointVisibility& rpVis = refPtsVisibilities[rvi];
-        if (rpVis.empty())
+        if (refPtsVisibilities[rvi].empty())
             continue;
 
-        const GEO::vec3 rp(refMesh.pts[rvi].m);
-        GEO::vec3 nearestPoint;
         double dist2 = 0.0;
-        GEO::index_t f = meshAABB.nearest_facet(rp, nearestPoint, dist2);
-        if (f == GEO::NO_FACET)
+        const int triId = meshSearch.getNearestTriangle(refMesh.pts[rvi], dist2);
+        if (triId == -1)
             continue;
 
-        double avgEdgeLength = mesh_facet_edges_length(meshG, f) / 3.0;
+        const double avgEdgeLength = meshTriangleEdgesLength(mesh, triId) / 3.0;
         // if average edge length is larger than the distance between the output mesh
         // and the closest point in the reference mesh.
         if (std::sqrt(dist2) > avgEdgeLength)
             continue;
 
-#pragma omp critical
+        refPtsNearestTri[rvi] = triId;
+
+        for (int i = 0; i < 3; ++i)
+            boost::atomic_ref<int>{nbRefPts[mesh.tris[triId].v[i]]}.fetch_add(1);
+    }
+
+    // group the reference vertices by vertex, so that each vertex visibility is only written by one thread
+    std::vector<int> offsets(mesh.pts.size() + 1, 0);
+    for (int vi = 0; vi < mesh.pts.size(); ++vi)
+        offsets[vi + 1] = offsets[vi] + nbRefPts[vi];
+
+    std::vector<int> refPtsIds(offsets.back());
+    std::copy(offsets.begin(), offsets.end(), nbRefPts.begin());
+
+#pragma omp parallel for
+    for (int rvi = 0; rvi < refMesh.pts.size(); ++rvi)
+    {
+        const int triId = refPtsNearestTri[rvi];
+        if (triId == -1)
+            continue;
+
+        for (int i = 0; i < 3; ++i)
+        {
+            const int pos = boost::atomic_ref<int>{nbRefPts[mesh.tris[triId].v[i]]}.fetch_add(1);
+            refPtsIds[pos] = rvi;
+        }
+    }
+
+#pragma omp parallel for schedule(dynamic, 1024)
+    for (int vi = 0; vi < mesh.pts.size(); ++vi)
+    {
+        // keep the order of the reference vertices, so that the result doesn't depend on the threads scheduling
+        std::sort(refPtsIds.begin() + offsets[vi], refPtsIds.begin() + offsets[vi + 1]);
+
+        PointVisibility& pOut = out_ptsVisibilities[vi];
+        for (int r = offsets[vi]; r < offsets[vi + 1]; ++r)
         {
-            for (int i = 0; i < 3; ++i)
-            {
-                GEO::index_t v = meshG.facets.vertex(f, i);
-                if (v == GEO::NO_VERTEX)
-                    continue;
-                PointVisibility& pOut = out_ptsVisibilities[reorderedVertices[v]];
-
-                for (int j = 0; j < rpVis.size(); ++j)
-                    pOut.push_back_distinct(rpVis[j]);
-            }
+            const PointVisibility& rpVis = refPtsVisibilities[refPtsIds[r]];
+            for (int j = 0; j < rpVis.size(); ++j)
+                pOut.push_back_distinct(rpVis[j]);
         }
     }
 
@@ -137,24 +257,17 @@ void remapMeshVisibilities_pushVerticesVisibilityToTriangles(const Mesh& refMesh
 }
 
 void remapMeshVisibilities_meshItself(const mvsUtils::MultiViewParams& mp, Mesh& mesh)
+{
+    const MeshFacetsSearch meshSearch(mesh);
+    remapMeshVisibilities_meshItself(mp, mesh, meshSearch);
+}
+
+void remapMeshVisibilities_meshItself(const mvsUtils::MultiViewParams& mp, Mesh& mesh, const MeshFacetsSearch& meshSearch)
 {
     ALICEVISION_LOG_INFO("remapMeshVisibility based on triangles normals start.");
 
     PointsVisibility& out_ptsVisibilities = mesh.pointsVisibilities;
 
-    GEO::initialize();
-    GEO::Mesh meshG;
-    toGeoMesh(mesh, meshG);
-
-    // MeshFacetAABB will reorder the mesh, so we need to keep indices
-    GEO::Attribute<GEO::index_t> reorderedVerticesAttr(meshG.vertices.attributes(), "reorder");
-    for (int i = 0; i < meshG.vertices.nb(); ++i)
-        reorderedVerticesAttr[i] = i;
-
-    GEO::MeshFacetsAABB meshAABB(meshG);  // warning: mesh_reorder called inside
-
-    GEO::vector<GEO::index_t> reorderedVertices = reorderedVerticesAttr.get_vector();
-
     if (out_ptsVisibilities.size() != mesh.pts.size())
     {
         out_ptsVisibilities.resize(mesh.pts.size());
@@ -171,7 +284,6 @@ void remapMeshVisibilities_meshItself(const mvsUtils::MultiViewParams& mp, Mesh&
     {
         const Point3d& v = mesh.pts[vi];
         PointVisibility& vertexVisibility = out_ptsVisibilities[vi];
-        const Point3d& n = normalsPerVertex[vi];
 
         // Check by which camera the vertex is visible
         for (std::size_t camIndex = 0; camIndex < nbCameras; ++camIndex)
@@ -190,12 +302,8 @@ void remapMeshVisibilities_meshItself(const mvsUtils::MultiViewParams& mp, Mesh&
             if (angle > 90.0)
                 continue;
 
-            const GEO::vec3 gv(v.x, v.y, v.z);
-            const GEO::vec3 gc(c.x, c.y, c.z);
-            const GEO::vec3 vc = gc - gv;
             // check if there is an occlusion on the segment between the current mesh vertex and the camera
-            const bool occlusion = meshAABB.ray_intersection(GEO::Ray(gv + (vc * 0.00001), vc), 1.0);
-            if (occlusion)
+            if (meshSearch.isSegmentOccluded(v, c))
                 continue;
 
             vertexVisibility.push_back(camIndex);
@@ -204,5 +312,61 @@ void remapMeshVisibilities_meshItself(const mvsUtils::MultiViewParams& mp, Mesh&
     ALICEVISION_LOG_INFO("remapMeshVisibility based on triangles normals done.");
 }
 
+void remapMeshVisibilities_meshItselfGpu(const mvsUtils::MultiViewParams& mp, Mesh& mesh, double depthTolerance)
+{
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
+    ALICEVISION_LOG_INFO("remapMeshVisibility based on rendered depth maps start.");
+
+    PointsVisibility& out_ptsVisibilities = mesh.pointsVisibilities;
+
+    if (out_ptsVisibilities.size() != mesh.pts.size())
+    {
+        out_ptsVisibilities.resize(mesh.pts.size());
+    }
+
+    StaticVector<Point3d> normalsPerVertex;
+    mesh.computeNormalsForPts(normalsPerVertex);
+
+    // single precision copy of the mesh for the device
+    const int nbPts = mesh.pts.size();
+    std::vector<float> points(nbPts * 3);
+    std::vector<float> normals(nbPts * 3);
+    std::vector<int> triangles(mesh.tris.size() * 3);
+
+#pragma omp parallel for
+    for (int vi = 0; vi < nbPts; ++vi)
+    {
+        for (int k = 0; k < 3; ++k)
+        {
+            points[vi * 3 + k] = static_cast<float>(mesh.pts[vi].m[k]);
+            normals[vi * 3 + k] = static_cast<float>(normalsPerVertex[vi].m[k]);
+        }
+    }
+    for (int ti = 0; ti < mesh.tris.size(); ++ti)
+        std::copy(mesh.tris[ti].v, mesh.tris[ti].v + 3, triangles.begin() + ti * 3);
+
+    cuda::DeviceMeshVisibility deviceVisibility;
+    deviceVisibility.setMesh(points, normals, triangles);
+
+    std::vector<unsigned char> visible(nbPts);
+    for (int camIndex = 0; camIndex < mp.CArr.size(); ++camIndex)
+    {
+        ALICEVISION_LOG_INFO("Render the depth map of camera " << camIndex + 1 << "/" << mp.CArr.size() << ".");
+
+        deviceVisibility.computeVisibility(mp.camArr[camIndex].m, mp.CArr[camIndex].m, mp.getWidth(camIndex), mp.getHeight(camIndex), 1, depthTolerance, visible);
+
+#pragma omp parallel for
+        for (int vi = 0; vi < nbPts; ++vi)
+        {
+            if (visible[vi])
+                out_ptsVisibilities[vi].push_back(camIndex);
+        }
+    }
+    ALICEVISION_LOG_INFO("remapMeshVisibility based on rendered depth maps done.");
+#else
+    throw std::runtime_error("remapMeshVisibilities_meshItselfGpu: requires a build with CUDA.");
+#endif
+}
+
 }  // namespace mesh
 }  // namespace aliceVision
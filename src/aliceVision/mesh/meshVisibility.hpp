@@ -9,9 +9,82 @@
 #include <aliceVision/mesh/Mesh.hpp>
 #include <aliceVision/mvsData/StaticVector.hpp>
 
+#include <memory>
+
 namespace aliceVision {
 namespace mesh {
 
+/**
+ * @brief Nearest vertex search in a reference mesh.
+ *        The kd-tree is built once and can be shared by all the remappings from the same reference mesh.
+ * @note The reference mesh vertices are not copied, the reference mesh must outlive the search structure.
+ */
+class NearestVertexSearch
+{
+  public:
+    explicit NearestVertexSearch(const Mesh& refMesh);
+    ~NearestVertexSearch();
+
+    /**
+     * @brief Get the nearest reference vertex of each point, the queries being run in parallel.
+     * @param[in] points the query points
+     * @param[out] out_nearestVertex index of the nearest reference vertex for each point, -1 if the reference mesh is empty
+     */
+    void getNearestVertices(const StaticVector<Point3d>& points, StaticVector<int>& out_nearestVertex) const;
+
+    /**
+     * @return the underlying kd-tree, for the k-nearest neighbors queries
+     */
+    const GEO::AdaptiveKdTree& getKdTree() const { return *_kdTree; }
+
+    bool empty() const { return _nbPoints == 0; }
+
+  private:
+    std::unique_ptr<GEO::AdaptiveKdTree> _kdTree;
+    int _nbPoints = 0;
+};
+
+/**
+ * @brief Nearest triangle and occlusion queries on a mesh, through an axis-aligned bounding box tree of its triangles.
+ *        The tree is built once and can be shared by the push and the mesh itself remappings of the same mesh.
+ * @note The triangles are returned with their index in the input mesh.
+ */
+class MeshFacetsSearch
+{
+  public:
+    explicit MeshFacetsSearch(const Mesh& mesh);
+    ~MeshFacetsSearch();
+
+    /**
+     * @brief Get the nearest triangle of a point.
+     * @param[in] point the query point
+     * @param[out] out_sqDist squared distance from the point to its nearest triangle
+     * @return index of the nearest triangle, -1 if the mesh is empty
+     */
+    int getNearestTriangle(const Point3d& point, double& out_sqDist) const;
+
+    /**
+     * @brief Get the nearest triangle of each point, the queries being run in parallel.
+     * @param[in] points the query points
+     * @param[out] out_triIds index of the nearest triangle for each point, -1 if the mesh is empty
+     * @param[out] out_sqDists squared distance from each point to its nearest triangle
+     */
+    void getNearestTriangles(const StaticVector<Point3d>& points, StaticVector<int>& out_triIds, StaticVector<double>& out_sqDists) const;
+
+    /**
+     * @brief Check if the segment from a point of the mesh to another point intersects the mesh.
+     *        The beginning of the segment is ignored, to avoid the intersections with the triangles of the starting point.
+     * @param[in] from the point on the mesh
+     * @param[in] to the end of the segment (e.g. a camera center)
+     * @return true if the segment intersects a triangle
+     */
+    bool isSegmentOccluded(const Point3d& from, const Point3d& to) const;
+
+  private:
+    struct Impl;
+    std::unique_ptr<Impl> _impl;
+};
+
 /**
  * @brief Retrieve the nearest neighbor vertex in @p refMesh for each vertex in @p mesh.
  * @param[in] refMesh input reference mesh
@@ -31,6 +104,16 @@ void getNearestVertices(const Mesh& refMesh, const Mesh& mesh, StaticVector<int>
  */
 void remapMeshVisibilities_pullVerticesVisibility(const Mesh& refMesh, Mesh& mesh);
 
+/**
+ * @brief Transfer the visibility per vertex from one mesh to another, with a nearest vertex search already built on the reference mesh.
+ * @see remapMeshVisibilities_pullVerticesVisibility
+ *
+ * @param[in] refMesh input reference mesh
+ * @param[in] refMeshSearch nearest vertex search built on @p refMesh
+ * @param[in] mesh input target mesh
+ */
+void remapMeshVisibilities_pullVerticesVisibility(const Mesh& refMesh, const NearestVertexSearch& refMeshSearch, Mesh& mesh);
+
 /**
  * @brief Transfer the visibility per vertex from one mesh to another.
  * For each vertex of the @p refMesh, we search the closest triangle in the @p mesh and copy its visibility information to each vertex of the
@@ -42,7 +125,47 @@ void remapMeshVisibilities_pullVerticesVisibility(const Mesh& refMesh, Mesh& mes
  */
 void remapMeshVisibilities_pushVerticesVisibilityToTriangles(const Mesh& refMesh, Mesh& mesh);
 
+/**
+ * @brief Transfer the visibility per vertex from one mesh to another, with a triangles search already built on the target mesh.
+ * @see remapMeshVisibilities_pushVerticesVisibilityToTriangles
+ *
+ * @param[in] refMesh input reference mesh
+ * @param[in] mesh input target mesh
+ * @param[in] meshSearch triangles search built on @p mesh
+ */
+void remapMeshVisibilities_pushVerticesVisibilityToTriangles(const Mesh& refMesh, Mesh& mesh, const MeshFacetsSearch& meshSearch);
+
+/**
+ * @brief Compute the visibility per vertex from the mesh itself.
+ * A vertex is visible by a camera if it projects in the image, faces the camera and the segment to the camera center
+ * doesn't intersect the mesh.
+ *
+ * @param[in] mp the multi-view parameters
+ * @param[in,out] mesh the mesh
+ */
 void remapMeshVisibilities_meshItself(const mvsUtils::MultiViewParams& mp, Mesh& mesh);
 
+/**
+ * @brief Compute the visibility per vertex from the mesh itself, with a triangles search already built on the mesh.
+ * @see remapMeshVisibilities_meshItself
+ *
+ * @param[in] mp the multi-view parameters
+ * @param[in,out] mesh the mesh
+ * @param[in] meshSearch triangles search built on @p mesh
+ */
+void remapMeshVisibilities_meshItself(const mvsUtils::MultiViewParams& mp, Mesh& mesh, const MeshFacetsSearch& meshSearch);
+
+/**
+ * @brief Compute the visibility per vertex from the mesh itself on the GPU.
+ * The mesh is rendered into a depth map for each camera, and a vertex is visible if it projects in the image,
+ * faces the camera and is not behind the rendered depth.
+ * @note Requires a build with CUDA.
+ *
+ * @param[in] mp the multi-view parameters
+ * @param[in,out] mesh the mesh
+ * @param[in] depthTolerance relative depth tolerance of the occlusion test
+ */
+void remapMeshVisibilities_meshItselfGpu(const mvsUtils::MultiViewParams& mp, Mesh& mesh, double depthTolerance = 0.001);
+
 }  // namespace mesh
 }  // namespace aliceVision
@@ -0,0 +1,91 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "spatialOrder.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <utility>
+
+namespace aliceVision {
+namespace mesh {
+
+namespace {
+
+/**
+ * @brief Interleave the lower 21 bits of a value with two zero bits.
+ */
+inline std::uint64_t spreadBits(std::uint64_t x)
+{
+    x &= 0x1fffff;
+    x = (x | (x << 32)) & 0x1f00000000ffffULL;
+    x = (x | (x << 16)) & 0x1f0000ff0000ffULL;
+    x = (x | (x << 8)) & 0x100f00f00f00f00fULL;
+    x = (x | (x << 4)) & 0x10c30c30c30c30c3ULL;
+    x = (x | (x << 2)) & 0x1249249249249249ULL;
+    return x;
+}
+
+}  // namespace
+
+void computeMortonOrder(const Point3d* points, std::size_t nbPoints, std::vector<int>& out_order)
+{
+    out_order.resize(nbPoints);
+    std::iota(out_order.begin(), out_order.end(), 0);
+    if (nbPoints < 2)
+        return;
+
+    Point3d bbMin(std::numeric_limits<double>::max(), std::numeric_limits<double>::max(), std::numeric_limits<double>::max());
+    Point3d bbMax(std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest());
+    for (std::size_t i = 0; i < nbPoints; ++i)
+    {
+        const Point3d& p = points[i];
+        bbMin.x = std::min(bbMin.x, p.x);
+        bbMin.y = std::min(bbMin.y, p.y);
+        bbMin.z = std::min(bbMin.z, p.z);
+        bbMax.x = std::max(bbMax.x, p.x);
+        bbMax.y = std::max(bbMax.y, p.y);
+        bbMax.z = std::max(bbMax.z, p.z);
+    }
+
+    // same scale on the 3 axes
+    const double extent = std::max({bbMax.x - bbMin.x, bbMax.y - bbMin.y, bbMax.z - bbMin.z});
+    const double scale = (extent > 0.0) ? double(0x1fffff) / extent : 0.0;
+
+    std::vector<std::pair<std::uint64_t, int>> codes(nbPoints);
+
+#pragma omp parallel for
+    for (std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t>(nbPoints); ++i)
+    {
+        const Point3d& p = points[i];
+        const std::uint64_t x = static_cast<std::uint64_t>((p.x - bbMin.x) * scale);
+        const std::uint64_t y = static_cast<std::uint64_t>((p.y - bbMin.y) * scale);
+        const std::uint64_t z = static_cast<std::uint64_t>((p.z - bbMin.z) * scale);
+        codes[i] = {spreadBits(x) | (spreadBits(y) << 1) | (spreadBits(z) << 2), static_cast<int>(i)};
+    }
+
+    // the pairs are unique, so the result does not depend on the sort implementation
+    std::sort(codes.begin(), codes.end());
+
+    for (std::size_t i = 0; i < nbPoints; ++i)
+    {
+        out_order[i] = codes[i].second;
+    }
+}
+
+void invertOrder(const std::vector<int>& order, std::vector<int>& out_newIds)
+{
+    out_newIds.resize(order.size());
+    for (std::size_t i = 0; i < order.size(); ++i)
+    {
+        out_newIds[order[i]] = static_cast<int>(i);
+    }
+}
+
+}  // namespace mesh
+}  // namespace aliceVision
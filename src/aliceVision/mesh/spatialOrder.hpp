@@ -0,0 +1,54 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/mvsData/Point3d.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace aliceVision {
+namespace mesh {
+
+/**
+ * @brief Compute the Morton (Z-order) order of points, so that the points close in space are close in memory.
+ *        The points are quantized on a 2^21 grid over their bounding box, ties keep the input order.
+ * @param[in] points the points
+ * @param[in] nbPoints the number of points
+ * @param[out] out_order the index of the input point at each position of the sorted order
+ */
+void computeMortonOrder(const Point3d* points, std::size_t nbPoints, std::vector<int>& out_order);
+
+/**
+ * @brief Invert an order.
+ * @param[in] order the index of the input element at each position of the sorted order
+ * @param[out] out_newIds the position in the sorted order of each input element
+ */
+void invertOrder(const std::vector<int>& order, std::vector<int>& out_newIds);
+
+/**
+ * @brief Permute in place the elements of a vector.
+ * @param[in] order the index of the input element at each position of the sorted order
+ * @param[in,out] values the elements, ignored if empty
+ */
+template<typename Vector>
+void applyOrder(const std::vector<int>& order, Vector& values)
+{
+    if (values.empty())
+        return;
+
+    Vector reordered;
+    reordered.resize(order.size());
+    for (std::size_t i = 0; i < order.size(); ++i)
+    {
+        reordered[i] = std::move(values[order[i]]);
+    }
+    values.swap(reordered);
+}
+
+}  // namespace mesh
+}  // namespace aliceVision
@@ -70,6 +70,12 @@ class RelativePoseKernel : public robustEstimation::PointFittingRansacKernel<Sol
         }
     }
 
+    void errors(const ModelT_& model, std::vector<double>& errors) const override
+    {
+        // all the samples are evaluated at once
+        PFRansacKernel::PFKernel::_errorEstimator.errors(model, PFRansacKernel::PFKernel::_x1, PFRansacKernel::PFKernel::_x2, errors);
+    }
+
     void unnormalize(ModelT_& model) const override
     {
         // Unnormalize model from the computed conditioning.
@@ -154,6 +160,14 @@ class RelativePoseKernel_K : public robustEstimation::PointFittingRansacKernel<S
         return _errorEstimator.error(modelF, PFRansacKernel::PFKernel::_x1.col(sample), PFRansacKernel::PFKernel::_x2.col(sample));
     }
 
+    void errors(const ModelT_& model, std::vector<double>& errors) const override
+    {
+        // the fundamental matrix is computed once for all the samples
+        Mat3 F;
+        fundamentalFromEssential(model.getMatrix(), _K1, _K2, &F);
+        _errorEstimator.errors(ModelT_(F), PFRansacKernel::PFKernel::_x1, PFRansacKernel::PFKernel::_x2, errors);
+    }
+
     void unnormalize(ModelT_& model) const override
     {
         // do nothing, no normalization in this case
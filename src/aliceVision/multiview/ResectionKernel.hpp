@@ -50,6 +50,12 @@ class ResectionKernel : public robustEstimation::PointFittingRansacKernel<Solver
         robustEstimation::normalizePointsFromImageSize(x2d, &_x2d, &_N1, w, h);
     }
 
+    void errors(const ModelT_& model, std::vector<double>& errors) const override
+    {
+        // all the samples are evaluated at once
+        KernelBase::PFKernel::_errorEstimator.errors(model, KernelBase::PFKernel::_x1, KernelBase::PFKernel::_x2, errors);
+    }
+
     void unnormalize(ModelT_& model) const override
     {
         // unnormalize model from the computed conditioning.
@@ -118,6 +124,12 @@ class ResectionKernel_K : public robustEstimation::PointFittingRansacKernel<Solv
         robustEstimation::applyTransformationToPoints(x2d, _N1, &_x2d);
     }
 
+    void errors(const ModelT_& model, std::vector<double>& errors) const override
+    {
+        // all the samples are evaluated at once
+        KernelBase::PFKernel::_errorEstimator.errors(model, KernelBase::PFKernel::_x1, KernelBase::PFKernel::_x2, errors);
+    }
+
     void unnormalize(ModelT_& model) const override
     {
         // unnormalize model from the computed conditioning.
@@ -21,11 +21,22 @@ void Essential8PSolver::solve(const Mat& x1, const Mat& x2, std::vector<robustEs
     assert(x1.rows() == x2.rows());
     assert(x1.cols() == x2.cols());
 
-    MatX9 A(x1.cols(), 9);
-    encodeEpipolarEquation(x1, x2, &A);
-
     Vec9 e;
-    Nullspace(A, e);
+
+    if (x1.cols() == 8)
+    {
+        // in the minimal solution use fixed sized matrix to let Eigen and the
+        // compiler doing the maximum of optimization.
+        Mat9 A = Mat9::Zero();
+        encodeEpipolarEquation(x1, x2, &A);
+        Nullspace(A, e);
+    }
+    else
+    {
+        MatX9 A(x1.cols(), 9);
+        encodeEpipolarEquation(x1, x2, &A);
+        Nullspace(A, e);
+    }
     Mat3 E = Map<RMat3>(e.data());
 
     // Find the closest essential matrix to E in frobenius norm
@@ -27,7 +27,7 @@ void solveProblem(const Mat& x1, const Mat& x2, std::vector<robustEstimation::Ma
     {
         // in the minimal solution use fixed sized matrix to let Eigen and the
         // compiler doing the maximum of optimization.
-        Mat9 A = Mat::Zero(9, 9);
+        Mat9 A = Mat9::Zero();
         encodeEpipolarEquation(x1, x2, &A, weights);
         Nullspace(A, f);
     }
@@ -15,6 +15,34 @@ namespace aliceVision {
 namespace multiview {
 namespace relativePose {
 
+/**
+ * @brief Epipolar terms of a fundamental matrix for all the correspondences.
+ */
+struct EpipolarTerms
+{
+    EpipolarTerms(const Mat3& F, const Mat& x1, const Mat& x2)
+      : Fx((F.leftCols<2>() * x1).colwise() + F.col(2)),
+        Fty((F.transpose().leftCols<2>() * x2).colwise() + F.row(2).transpose()),
+        yFx((x2.array() * Fx.topRows<2>().array()).colwise().sum() + Fx.row(2).array())
+    {}
+
+    /// F * x for each point x of the first view
+    const Mat Fx;
+    /// F^T * y for each point y of the second view
+    const Mat Fty;
+    /// y^T * F * x for each correspondence
+    const Eigen::Array<double, 1, Eigen::Dynamic> yFx;
+};
+
+/**
+ * @brief Map a vector of errors as an Eigen row array.
+ */
+inline Eigen::Map<Eigen::Array<double, 1, Eigen::Dynamic>> mapErrors(std::vector<double>& errors, Mat::Index size)
+{
+    errors.resize(size);
+    return Eigen::Map<Eigen::Array<double, 1, Eigen::Dynamic>>(errors.data(), size);
+}
+
 /**
  * @brief Compute FundamentalSampsonError related to the Fundamental matrix and 2 correspondences
  */
@@ -31,6 +59,13 @@ struct FundamentalSampsonError : public ISolverErrorRelativePose<robustEstimatio
 
         return Square(y.dot(F_x)) / (F_x.head<2>().squaredNorm() + Ft_y.head<2>().squaredNorm());
     }
+
+    void errors(const robustEstimation::Mat3Model& F, const Mat& x1, const Mat& x2, std::vector<double>& errors) const override
+    {
+        const EpipolarTerms terms(F.getMatrix(), x1, x2);
+        mapErrors(errors, x1.cols()) =
+          terms.yFx.square() / (terms.Fx.topRows<2>().colwise().squaredNorm() + terms.Fty.topRows<2>().colwise().squaredNorm()).array();
+    }
 };
 
 struct FundamentalSymmetricEpipolarDistanceError : public ISolverErrorRelativePose<robustEstimation::Mat3Model>
@@ -47,6 +82,15 @@ struct FundamentalSymmetricEpipolarDistanceError : public ISolverErrorRelativePo
         // @note the divide by 4 is to make this match the Sampson distance.
         return Square(y.dot(F_x)) * (1.0 / F_x.head<2>().squaredNorm() + 1.0 / Ft_y.head<2>().squaredNorm()) / 4.0;
     }
+
+    void errors(const robustEstimation::Mat3Model& F, const Mat& x1, const Mat& x2, std::vector<double>& errors) const override
+    {
+        const EpipolarTerms terms(F.getMatrix(), x1, x2);
+        mapErrors(errors, x1.cols()) =
+          terms.yFx.square() *
+          (terms.Fx.topRows<2>().colwise().squaredNorm().array().inverse() + terms.Fty.topRows<2>().colwise().squaredNorm().array().inverse()) /
+          4.0;
+    }
 };
 
 struct FundamentalEpipolarDistanceError : public ISolverErrorRelativePose<robustEstimation::Mat3Model>
@@ -61,6 +105,12 @@ struct FundamentalEpipolarDistanceError : public ISolverErrorRelativePose<robust
 
         return Square(F_x.dot(y)) / F_x.head<2>().squaredNorm();
     }
+
+    void errors(const robustEstimation::Mat3Model& F, const Mat& x1, const Mat& x2, std::vector<double>& errors) const override
+    {
+        const EpipolarTerms terms(F.getMatrix(), x1, x2);
+        mapErrors(errors, x1.cols()) = terms.yFx.square() / terms.Fx.topRows<2>().colwise().squaredNorm().array();
+    }
 };
 
 struct EpipolarSphericalDistanceError
@@ -57,7 +57,7 @@ void Homography4PSolver::solve(const Mat& x1, const Mat& x2, std::vector<robustE
         // in the case of minimal configuration we use fixed sized matrix to let
         // Eigen and the compiler doing the maximum of optimization.
         typedef Eigen::Matrix<double, 16, 9> Mat16_9;
-        Mat16_9 L = Mat::Zero(16, 9);
+        Mat16_9 L = Mat16_9::Zero();
         buildActionMatrix(L, x1, x2);
         Nullspace(L, h);
     }
@@ -116,7 +116,7 @@ void Homography4PSphericalSolver::solve(const Mat& p1, const Mat& p2, std::vecto
         // In the case of minimal configuration we use fixed sized matrix to let
         //  Eigen and the compiler doing the maximum of optimization.
         typedef Eigen::Matrix<double, 16, 9> Mat16_9;
-        Mat16_9 L = Mat::Zero(16, 9);
+        Mat16_9 L = Mat16_9::Zero();
         buildActionMatrixSpherical(L, p1, p2);
         Nullspace(L, h);
     }
@@ -28,6 +28,16 @@ struct HomographyAsymmetricError : ISolverErrorRelativePose<robustEstimation::Ma
         const Vec2 x2_est = x2h_est.head<2>() / x2h_est[2];
         return (x2 - x2_est).squaredNorm();
     }
+
+    void errors(const robustEstimation::Mat3Model& H, const Mat& x1, const Mat& x2, std::vector<double>& errors) const override
+    {
+        const Mat3& h = H.getMatrix();
+        const Mat x2h_est = (h.leftCols<2>() * x1).colwise() + h.col(2);
+        const Mat x2_est = x2h_est.topRows<2>().array().rowwise() / x2h_est.row(2).array();
+
+        errors.resize(x1.cols());
+        Eigen::Map<Eigen::Matrix<double, 1, Eigen::Dynamic>>(errors.data(), x1.cols()) = (x2 - x2_est).colwise().squaredNorm();
+    }
 };
 
 }  // namespace relativePose
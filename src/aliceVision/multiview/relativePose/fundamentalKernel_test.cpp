@@ -122,3 +122,29 @@ BOOST_AUTO_TEST_CASE(NormalizedFundamental8PKernel_EasyCase)
 
     BOOST_CHECK(expectKernelProperties<relativePose::NormalizedFundamental8PKernel>(x1, x2));
 }
+
+template<typename ErrorT>
+void checkBatchErrors(const robustEstimation::Mat3Model& F, const Mat& x1, const Mat& x2)
+{
+    const ErrorT errorEstimator;
+    std::vector<double> errors;
+    errorEstimator.errors(F, x1, x2, errors);
+
+    BOOST_CHECK_EQUAL(errors.size(), x1.cols());
+    for (Mat::Index i = 0; i < x1.cols(); ++i)
+    {
+        const double expected = errorEstimator.error(F, x1.col(i), x2.col(i));
+        BOOST_CHECK_SMALL(errors[i] - expected, 1e-9 * std::max(1.0, expected));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(FundamentalErrors_Batch)
+{
+    const robustEstimation::Mat3Model F(Mat3::Random());
+    const Mat x1 = 100.0 * Mat::Random(2, 50);
+    const Mat x2 = 100.0 * Mat::Random(2, 50);
+
+    checkBatchErrors<relativePose::FundamentalSampsonError>(F, x1, x2);
+    checkBatchErrors<relativePose::FundamentalSymmetricEpipolarDistanceError>(F, x1, x2);
+    checkBatchErrors<relativePose::FundamentalEpipolarDistanceError>(F, x1, x2);
+}
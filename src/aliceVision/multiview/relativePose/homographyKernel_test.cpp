@@ -90,3 +90,23 @@ BOOST_AUTO_TEST_CASE(Homography4PKernel_Fitting)
         }
     }
 }
+
+BOOST_AUTO_TEST_CASE(HomographyAsymmetricError_Batch)
+{
+    Mat3 H;
+    H << 1.2, 0.1, 5.0, -0.05, 0.9, -3.0, 1e-3, 2e-3, 1.0;
+    const robustEstimation::Mat3Model model(H);
+    const Mat x1 = 100.0 * Mat::Random(2, 50);
+    const Mat x2 = 100.0 * Mat::Random(2, 50);
+
+    const relativePose::HomographyAsymmetricError errorEstimator;
+    std::vector<double> errors;
+    errorEstimator.errors(model, x1, x2, errors);
+
+    BOOST_CHECK_EQUAL(errors.size(), x1.cols());
+    for (Mat::Index i = 0; i < x1.cols(); ++i)
+    {
+        const double expected = errorEstimator.error(model, x1.col(i), x2.col(i));
+        BOOST_CHECK_SMALL(errors[i] - expected, 1e-9 * std::max(1.0, expected));
+    }
+}
@@ -6,6 +6,10 @@
 
 #pragma once
 
+#include <aliceVision/numeric/numeric.hpp>
+
+#include <vector>
+
 namespace aliceVision {
 namespace multiview {
 namespace resection {
@@ -17,6 +21,21 @@ template<typename ModelT>
 struct ISolverErrorResection
 {
     virtual double error(const ModelT& model, const Vec2& x2d, const Vec3& x3d) const = 0;
+
+    /**
+     * @brief Compute the errors of all the 2D-3D correspondences for a model.
+     *        Errors can override it with an expression evaluated on all the columns at once.
+     * @param[in] model the model to evaluate
+     * @param[in] x2d the 2D points, one per column
+     * @param[in] x3d the corresponding 3D points
+     * @param[out] errors the error of each correspondence
+     */
+    virtual void errors(const ModelT& model, const Mat& x2d, const Mat& x3d, std::vector<double>& errors) const
+    {
+        errors.resize(x2d.cols());
+        for (Mat::Index i = 0; i < x2d.cols(); ++i)
+            errors[i] = error(model, x2d.col(i), x3d.col(i));
+    }
 };
 
 }  // namespace resection
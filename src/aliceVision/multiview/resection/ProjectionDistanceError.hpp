@@ -15,6 +15,15 @@ namespace aliceVision {
 namespace multiview {
 namespace resection {
 
+/**
+ * @brief Compute the projection residuals (project(P,pt3D) - pt2D) of all the correspondences at once.
+ */
+inline Mat projectionResiduals(const Mat34& P, const Mat& x2d, const Mat& x3d)
+{
+    const Mat xh = (P.leftCols<3>() * x3d).colwise() + P.col(3);
+    return (xh.topRows<2>().array().rowwise() / xh.row(2).array()).matrix() - x2d;
+}
+
 /**
  * @brief Compute the residual of the projection distance
  *        (pt2D, project(P,pt3D))
@@ -25,6 +34,12 @@ struct ProjectionDistanceError : public ISolverErrorResection<robustEstimation::
     {
         return (project(P.getMatrix(), p3d) - p2d).norm();
     }
+
+    void errors(const robustEstimation::Mat34Model& P, const Mat& x2d, const Mat& x3d, std::vector<double>& errors) const override
+    {
+        errors.resize(x2d.cols());
+        Eigen::Map<Eigen::Matrix<double, 1, Eigen::Dynamic>>(errors.data(), x2d.cols()) = projectionResiduals(P.getMatrix(), x2d, x3d).colwise().norm();
+    }
 };
 
 /**
@@ -37,6 +52,13 @@ struct ProjectionDistanceSquaredError : public ISolverErrorResection<robustEstim
     {
         return (project(P.getMatrix(), p3d) - p2d).squaredNorm();
     }
+
+    void errors(const robustEstimation::Mat34Model& P, const Mat& x2d, const Mat& x3d, std::vector<double>& errors) const override
+    {
+        errors.resize(x2d.cols());
+        Eigen::Map<Eigen::Matrix<double, 1, Eigen::Dynamic>>(errors.data(), x2d.cols()) =
+          projectionResiduals(P.getMatrix(), x2d, x3d).colwise().squaredNorm();
+    }
 };
 
 }  // namespace resection
@@ -206,3 +206,25 @@ BOOST_AUTO_TEST_CASE(EuclideanResection_Points6AllRandomInput)
         BOOST_CHECK(bFound);
     }
 }
+
+BOOST_AUTO_TEST_CASE(ProjectionDistanceErrors_Batch)
+{
+    const NViewDataSet d = NRealisticCamerasRing(1, 20, NViewDatasetConfigurator(1000, 1000, 500, 500, 5, 0));
+    const robustEstimation::Mat34Model P(d.P(0));
+    const Mat x2d = d._x[0] + Mat::Random(2, 20);
+    const Mat x3d = d._X;
+
+    std::vector<double> errors;
+
+    const resection::ProjectionDistanceError distanceError;
+    distanceError.errors(P, x2d, x3d, errors);
+    BOOST_CHECK_EQUAL(errors.size(), x2d.cols());
+    for (Mat::Index i = 0; i < x2d.cols(); ++i)
+        BOOST_CHECK_SMALL(errors[i] - distanceError.error(P, x2d.col(i), x3d.col(i)), 1e-9);
+
+    const resection::ProjectionDistanceSquaredError squaredDistanceError;
+    squaredDistanceError.errors(P, x2d, x3d, errors);
+    BOOST_CHECK_EQUAL(errors.size(), x2d.cols());
+    for (Mat::Index i = 0; i < x2d.cols(); ++i)
+        BOOST_CHECK_SMALL(errors[i] - squaredDistanceError.error(P, x2d.col(i), x3d.col(i)), 1e-9);
+}
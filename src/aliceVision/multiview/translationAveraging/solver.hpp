@@ -57,5 +57,29 @@ bool solve_translations_problem_softl1(const std::vector<relativeInfo>& vec_init
                                        std::vector<Eigen::Vector3d>& translations,
                                        const double d_l1_loss_threshold = 0.01);
 
+/**
+ * @brief Registration of relative translations to global translations with a L1 minimization of the residuals norm,
+ *        solved by iteratively reweighted least squares on sparse normal equations (no dense linear program).
+ *        The residual of a relative translation is t_j - R_ij t_i - s t_ij, with one scale s >= 1 per relative estimate
+ *        (or per triplet of relative estimates). The translations and the scales are alternately solved.
+ *        The memory and time per iteration are linear in the number of relative estimates.
+ *
+ * @param[in] vec_initial_estimates relative motion information
+ * @param[in] b_translation_triplets tell if relative motion comes 3 or 2 views
+ *   false: 2-view estimates -> 1 relativeInfo per 2 view estimates,
+ *   true:  3-view estimates -> triplet of translations: 3 relativeInfo per triplet.
+ * @param[in] nb_poses the number of camera nodes in the relative motion graph
+ * @param[out] translations found global camera translations (the first one is fixed at the origin)
+ * @param[in] max_iterations maximum number of reweighting iterations
+ * @param[in] convergence_threshold stop when the translations change less than this ratio of their magnitude
+ * @return True if the registration can be solved
+ */
+bool solve_translations_problem_l1_irls(const std::vector<relativeInfo>& vec_initial_estimates,
+                                        const bool b_translation_triplets,
+                                        const int nb_poses,
+                                        std::vector<Eigen::Vector3d>& translations,
+                                        const int max_iterations = 200,
+                                        const double convergence_threshold = 1e-9);
+
 }  // namespace translationAveraging
 }  // namespace aliceVision
@@ -0,0 +1,161 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/multiview/translationAveraging/common.hpp>
+#include <aliceVision/multiview/translationAveraging/solver.hpp>
+#include <aliceVision/numeric/numeric.hpp>
+#include <aliceVision/system/Logger.hpp>
+
+#include <Eigen/SparseCholesky>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace aliceVision {
+namespace translationAveraging {
+
+bool solve_translations_problem_l1_irls(const std::vector<relativeInfo>& vec_initial_estimates,
+                                        const bool b_translation_triplets,
+                                        const int nb_poses,
+                                        std::vector<Eigen::Vector3d>& translations,
+                                        const int max_iterations,
+                                        const double convergence_threshold)
+{
+    if (nb_poses < 2 || vec_initial_estimates.empty())
+        return false;
+
+    const std::size_t nb_edges = vec_initial_estimates.size();
+    const std::size_t group_size = b_translation_triplets ? 3 : 1;
+    const std::size_t nb_scales = (nb_edges + group_size - 1) / group_size;
+
+    // the first pose is fixed at the origin (gauge freedom)
+    const int nb_translation_unknowns = 3 * (nb_poses - 1);
+
+    std::vector<Vec3> t(nb_poses, Vec3::Zero());
+    std::vector<double> scales(nb_scales, 1.0);
+    std::vector<double> weights(nb_edges, 1.0);
+
+    // The s >= 1 constraint is handled with an active set: the scales at the bound are constant,
+    // the others are unknowns of the least squares problem. All the scales start at the bound.
+    std::vector<int> scaleUnknown(nb_scales, -1);
+
+    // IRLS weights are bounded to keep the normal equations well conditioned
+    const double min_residual = 1e-8;
+
+    Eigen::SimplicialLDLT<sMat> solver;
+    std::vector<Eigen::Triplet<double>> coefficients;
+    coefficients.reserve(nb_edges * 7 * 7);
+
+    for (int iteration = 0; iteration < max_iterations; ++iteration)
+    {
+        int nb_unknowns = nb_translation_unknowns;
+        for (std::size_t g = 0; g < nb_scales; ++g)
+            scaleUnknown[g] = (scales[g] > 1.0) ? nb_unknowns++ : -1;
+
+        // -- A. Solve the weighted least squares problem in the translations and the free scales:
+        //       min sum_e w_e * || t_j - R_ij t_i - s_e t_ij ||^2
+        coefficients.clear();
+        Vec b = Vec::Zero(nb_unknowns);
+        for (std::size_t e = 0; e < nb_edges; ++e)
+        {
+            const relativeInfo& info = vec_initial_estimates[e];
+            const IndexT I = info.first.first;
+            const IndexT J = info.first.second;
+            const Mat3& R_ij = info.second.first;
+            const Vec3& t_ij = info.second.second;
+            const std::size_t g = e / group_size;
+            const double w = weights[e];
+
+            // residual = jacobian * unknowns - constant
+            Eigen::Matrix<double, 3, 7> jacobian;
+            jacobian << -R_ij, Mat3::Identity(), -t_ij;
+            const int cols[7] = {I != 0 ? 3 * (static_cast<int>(I) - 1) : -1,
+                                 I != 0 ? 3 * (static_cast<int>(I) - 1) + 1 : -1,
+                                 I != 0 ? 3 * (static_cast<int>(I) - 1) + 2 : -1,
+                                 J != 0 ? 3 * (static_cast<int>(J) - 1) : -1,
+                                 J != 0 ? 3 * (static_cast<int>(J) - 1) + 1 : -1,
+                                 J != 0 ? 3 * (static_cast<int>(J) - 1) + 2 : -1,
+                                 scaleUnknown[g]};
+            const Vec3 constant = (scaleUnknown[g] == -1) ? Vec3(scales[g] * t_ij) : Vec3::Zero();
+
+            for (int r = 0; r < 7; ++r)
+            {
+                if (cols[r] == -1)
+                    continue;
+                b(cols[r]) += w * jacobian.col(r).dot(constant);
+                for (int c = 0; c < 7; ++c)
+                {
+                    if (cols[c] != -1)
+                        coefficients.emplace_back(cols[r], cols[c], w * jacobian.col(r).dot(jacobian.col(c)));
+                }
+            }
+        }
+
+        sMat H(nb_unknowns, nb_unknowns);
+        H.setFromTriplets(coefficients.begin(), coefficients.end());
+
+        solver.compute(H);
+        if (solver.info() != Eigen::Success)
+        {
+            ALICEVISION_LOG_DEBUG("L1 IRLS translation averaging: the normal equations cannot be factorized (disconnected graph?).");
+            return false;
+        }
+        const Vec x = solver.solve(b);
+
+        double max_change = 0.0;
+        double max_norm = 0.0;
+        for (int p = 1; p < nb_poses; ++p)
+        {
+            const Vec3 tp = x.segment<3>(3 * (p - 1));
+            max_change = std::max(max_change, (tp - t[p]).lpNorm<Eigen::Infinity>());
+            max_norm = std::max(max_norm, tp.lpNorm<Eigen::Infinity>());
+            t[p] = tp;
+        }
+
+        // -- B. Update the active set: the free scales below the bound are set at the bound,
+        //       the scales at the bound are released if their optimal value with the new translations is above it.
+        std::vector<double> numerators(nb_scales, 0.0);
+        std::vector<double> denominators(nb_scales, 0.0);
+        for (std::size_t e = 0; e < nb_edges; ++e)
+        {
+            const relativeInfo& info = vec_initial_estimates[e];
+            const Vec3& t_ij = info.second.second;
+            const Vec3 d = t[info.first.second] - info.second.first * t[info.first.first];
+            numerators[e / group_size] += weights[e] * t_ij.dot(d);
+            denominators[e / group_size] += weights[e] * t_ij.squaredNorm();
+        }
+        bool activeSetChanged = false;
+        for (std::size_t g = 0; g < nb_scales; ++g)
+        {
+            const double optimalScale = (denominators[g] > 0.0) ? numerators[g] / denominators[g] : 1.0;
+            const double scale = (scaleUnknown[g] != -1) ? x(scaleUnknown[g]) : optimalScale;
+            const double newScale = std::max(1.0, scale);
+            activeSetChanged |= ((newScale > 1.0) != (scales[g] > 1.0));
+            scales[g] = newScale;
+        }
+
+        // -- C. Update the IRLS weights of the L1 norm of the residuals
+        for (std::size_t e = 0; e < nb_edges; ++e)
+        {
+            const relativeInfo& info = vec_initial_estimates[e];
+            const Vec3 residual = t[info.first.second] - info.second.first * t[info.first.first] - scales[e / group_size] * info.second.second;
+            weights[e] = 1.0 / std::max(residual.norm(), min_residual);
+        }
+
+        if (iteration > 0 && !activeSetChanged && max_change <= convergence_threshold * std::max(1.0, max_norm))
+        {
+            ALICEVISION_LOG_DEBUG("L1 IRLS translation averaging: converged in " << iteration + 1 << " iterations.");
+            break;
+        }
+    }
+
+    translations.assign(t.begin(), t.end());
+    return true;
+}
+
+}  // namespace translationAveraging
+}  // namespace aliceVision
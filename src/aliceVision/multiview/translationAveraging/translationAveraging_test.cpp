@@ -11,6 +11,7 @@
 
 #include <fstream>
 #include <map>
+#include <random>
 #include <utility>
 #include <vector>
 
@@ -195,3 +196,82 @@ BOOST_AUTO_TEST_CASE(translation_averaging_globalTi_from_tijs_Triplets_l2_chorda
         }
     }
 }
+
+BOOST_AUTO_TEST_CASE(translation_averaging_globalTi_from_tijs_Triplets_l1_irls)
+{
+    const int focal = 1000;
+    const int principal_Point = 500;
+    //-- Setup a circular camera rig or "cardioid".
+    const int iNviews = 12;
+    const int iNbPoints = 6;
+
+    const bool bCardiod = true;
+    const bool bRelative_Translation_PerTriplet = true;
+    std::vector<aliceVision::translationAveraging::relativeInfo> vec_relative_estimates;
+
+    const NViewDataSet d = Setup_RelativeTranslations_AndNviewDataset(
+      vec_relative_estimates, focal, principal_Point, iNviews, iNbPoints, bCardiod, bRelative_Translation_PerTriplet);
+
+    // Solve the translation averaging problem:
+    std::vector<Vec3> vec_translations;
+    BOOST_CHECK(solve_translations_problem_l1_irls(vec_relative_estimates, bRelative_Translation_PerTriplet, iNviews, vec_translations));
+
+    BOOST_CHECK_EQUAL(iNviews, vec_translations.size());
+
+    // Check accuracy of the found translations
+    for (unsigned i = 0; i < iNviews; ++i)
+    {
+        const Vec3 t = vec_translations[i];
+        const Mat3& Ri = d._R[i];
+        const Vec3 C_computed = -Ri.transpose() * t;
+
+        const Vec3 C_GT = d._C[i] - d._C[0];
+
+        //-- Check that found camera position is equal to GT value
+        if (i == 0)
+        {
+            EXPECT_MATRIX_NEAR(C_computed, C_GT, 1e-6);
+        }
+        else
+        {
+            BOOST_CHECK_SMALL(DistanceLInfinity(C_computed.normalized(), C_GT.normalized()), 1e-6);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(translation_averaging_globalTi_from_tijs_l1_irls_unknownScales)
+{
+    const int focal = 1000;
+    const int principal_Point = 500;
+    //-- Setup a circular camera rig or "cardiod".
+    const int iNviews = 12;
+    const int iNbPoints = 6;
+
+    const bool bCardiod = true;
+    const bool bRelative_Translation_PerTriplet = false;
+    std::vector<aliceVision::translationAveraging::relativeInfo> vec_relative_estimates;
+
+    const NViewDataSet d = Setup_RelativeTranslations_AndNviewDataset(
+      vec_relative_estimates, focal, principal_Point, iNviews, iNbPoints, bCardiod, bRelative_Translation_PerTriplet);
+
+    // the relative translations are only known up to a scale
+    std::mt19937 randomNumberGenerator(0);
+    std::uniform_real_distribution<double> scaleDistribution(0.2, 0.9);
+    for (auto& relative : vec_relative_estimates)
+        relative.second.second *= scaleDistribution(randomNumberGenerator);
+
+    // Solve the translation averaging problem:
+    std::vector<Vec3> vec_translations;
+    BOOST_CHECK(solve_translations_problem_l1_irls(vec_relative_estimates, bRelative_Translation_PerTriplet, iNviews, vec_translations));
+
+    BOOST_CHECK_EQUAL(iNviews, vec_translations.size());
+
+    // Check accuracy of the found translations (up to the global scale)
+    for (unsigned i = 1; i < iNviews; ++i)
+    {
+        const Vec3 C_computed = -d._R[i].transpose() * vec_translations[i];
+        const Vec3 C_GT = d._C[i] - d._C[0];
+
+        BOOST_CHECK_SMALL(DistanceLInfinity(C_computed.normalized(), C_GT.normalized()), 1e-6);
+    }
+}
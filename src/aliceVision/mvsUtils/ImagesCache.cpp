@@ -8,7 +8,8 @@
 #include <aliceVision/mvsUtils/common.hpp>
 #include <aliceVision/mvsUtils/fileIO.hpp>
 
-#include <future>
+#include <algorithm>
+#include <exception>
 
 namespace aliceVision {
 namespace mvsUtils {
@@ -52,6 +53,20 @@ ImagesCache<Image>::ImagesCache(const MultiViewParams& mp,
     initIC(imagesNames);
 }
 
+template<typename Image>
+ImagesCache<Image>::~ImagesCache()
+{
+    {
+        std::lock_guard<std::mutex> lock(_loadQueueMutex);
+        _stopLoader = true;
+        _loadQueue.clear();
+    }
+    _loadQueueCondition.notify_all();
+
+    if (_loaderThread.joinable())
+        _loaderThread.join();
+}
+
 template<typename Image>
 void ImagesCache<Image>::initIC(std::vector<std::string>& imagesNames)
 {
@@ -80,6 +95,7 @@ void ImagesCache<Image>::initIC(std::vector<std::string>& imagesNames)
 template<typename Image>
 void ImagesCache<Image>::setCacheSize(int nbPreload)
 {
+    std::lock_guard<std::mutex> lock(_cacheMutex);
     _N_PRELOADED_IMAGES = nbPreload;
     _imgs.resize(_N_PRELOADED_IMAGES);
     _mapIdCamId.resize(_N_PRELOADED_IMAGES, -1);
@@ -87,42 +103,67 @@ void ImagesCache<Image>::setCacheSize(int nbPreload)
 }
 
 template<typename Image>
-void ImagesCache<Image>::refreshData(int camId)
+typename ImagesCache<Image>::ImgSharedPtr ImagesCache<Image>::refreshData(int camId)
 {
-    // printf("camId %i\n",camId);
-    // test if the image is in the memory
-    if (_camIdMapId[camId] == -1)
+    ImgSharedPtr img;
+
     {
+        std::lock_guard<std::mutex> lock(_cacheMutex);
+
+        // test if the image is in the memory
+        if (_camIdMapId[camId] != -1)
+        {
+            ALICEVISION_LOG_DEBUG("Reuse " << _imagesNames.at(camId) << " from image cache. ");
+            return _imgs[_camIdMapId[camId]];
+        }
+
         // remove the oldest one
         int mapId = _mapIdClock.minValId();
         int oldCamId = _mapIdCamId[mapId];
         if (oldCamId >= 0)
             _camIdMapId[oldCamId] = -1;
-        // TODO: oldCamId should be protected if already used
 
         // replace with new new
         _camIdMapId[camId] = mapId;
         _mapIdCamId[mapId] = camId;
         _mapIdClock[mapId] = clock();
 
-        // reload data from files
-        long t1 = clock();
-        if (_imgs[mapId] == nullptr)
+        // allocate a new buffer if the slot is empty or if the old image is still used elsewhere
+        // (an asynchronous refresh can evict an image still held by a consumer)
+        if (_imgs[mapId] == nullptr || _imgs[mapId].use_count() > 1)
         {
             const int maxWidth = _mp.getMaxImageWidth();
             const int maxHeight = _mp.getMaxImageHeight();
             _imgs[mapId] = std::make_shared<Image>(maxWidth, maxHeight);
         }
 
-        const std::string imagePath = _imagesNames.at(camId);
-        loadImage(imagePath, _mp, camId, *(_imgs[mapId]), _colorspace, _correctEV);
+        img = _imgs[mapId];
+    }
+
+    // reload data from files
+    // note: outside of the cache lock, the camera mutex is held by the caller
+    long t1 = clock();
 
-        ALICEVISION_LOG_DEBUG("Add " << imagePath << " to image cache. " << formatElapsedTime(t1));
+    const std::string imagePath = _imagesNames.at(camId);
+    try
+    {
+        loadImage(imagePath, _mp, camId, *img, _colorspace, _correctEV);
     }
-    else
+    catch (...)
     {
-        ALICEVISION_LOG_DEBUG("Reuse " << _imagesNames.at(camId) << " from image cache. ");
+        // do not keep a partially loaded image in the cache
+        std::lock_guard<std::mutex> lock(_cacheMutex);
+        if (_camIdMapId[camId] != -1 && _imgs[_camIdMapId[camId]] == img)
+        {
+            _mapIdCamId[_camIdMapId[camId]] = -1;
+            _camIdMapId[camId] = -1;
+        }
+        throw;
     }
+
+    ALICEVISION_LOG_DEBUG("Add " << imagePath << " to image cache. " << formatElapsedTime(t1));
+
+    return img;
 }
 
 template<typename Image>
@@ -132,10 +173,27 @@ void ImagesCache<Image>::refreshImage_sync(int camId)
     refreshData(camId);
 }
 
+template<typename Image>
+typename ImagesCache<Image>::ImgSharedPtr ImagesCache<Image>::getImg_sync(int camId)
+{
+    std::lock_guard<std::mutex> lock(_imagesMutexes[camId]);
+    return refreshData(camId);
+}
+
 template<typename Image>
 void ImagesCache<Image>::refreshImage_async(int camId)
 {
-    _asyncObjects.emplace_back(std::async(std::launch::async, &ImagesCache<Image>::refreshImage_sync, this, camId));
+    {
+        std::lock_guard<std::mutex> lock(_loadQueueMutex);
+
+        if (static_cast<int>(_loadQueue.size()) >= _N_PRELOADED_IMAGES ||
+            std::find(_loadQueue.begin(), _loadQueue.end(), camId) != _loadQueue.end())
+            return;
+
+        _loadQueue.push_back(camId);
+        startLoader();
+    }
+    _loadQueueCondition.notify_all();
 }
 
 template<typename Image>
@@ -148,7 +206,86 @@ void ImagesCache<Image>::refreshImages_sync(const std::vector<int>& camIds)
 template<typename Image>
 void ImagesCache<Image>::refreshImages_async(const std::vector<int>& camIds)
 {
-    _asyncObjects.emplace_back(std::async(std::launch::async, &ImagesCache<Image>::refreshImages_sync, this, camIds));
+    {
+        std::lock_guard<std::mutex> lock(_loadQueueMutex);
+
+        // the previous predictions are obsolete
+        _loadQueue.clear();
+
+        for (int camId : camIds)
+        {
+            if (static_cast<int>(_loadQueue.size()) >= _N_PRELOADED_IMAGES)
+                break;
+            if (std::find(_loadQueue.begin(), _loadQueue.end(), camId) == _loadQueue.end())
+                _loadQueue.push_back(camId);
+        }
+
+        if (_loadQueue.empty())
+            return;
+
+        startLoader();
+    }
+    _loadQueueCondition.notify_all();
+}
+
+template<typename Image>
+void ImagesCache<Image>::prefetchNeighbourCams(int camId, int nbNeighbourCams)
+{
+    std::vector<int> camIds = {camId};
+
+    const StaticVector<int> neighbourCams = _mp.findNearestCamsFromLandmarks(camId, nbNeighbourCams);
+    for (int i = 0; i < neighbourCams.size(); ++i)
+        camIds.push_back(neighbourCams[i]);
+
+    refreshImages_async(camIds);
+}
+
+template<typename Image>
+void ImagesCache<Image>::waitAsync()
+{
+    std::unique_lock<std::mutex> lock(_loadQueueMutex);
+    _loadQueueCondition.wait(lock, [this]() { return _loadQueue.empty() && _nbLoading == 0; });
+}
+
+template<typename Image>
+void ImagesCache<Image>::startLoader()
+{
+    // note: called with the load queue lock held
+    if (!_loaderThread.joinable())
+        _loaderThread = std::thread(&ImagesCache<Image>::loaderLoop, this);
+}
+
+template<typename Image>
+void ImagesCache<Image>::loaderLoop()
+{
+    std::unique_lock<std::mutex> lock(_loadQueueMutex);
+
+    while (true)
+    {
+        _loadQueueCondition.wait(lock, [this]() { return _stopLoader || !_loadQueue.empty(); });
+
+        if (_stopLoader)
+            return;
+
+        const int camId = _loadQueue.front();
+        _loadQueue.pop_front();
+        ++_nbLoading;
+
+        lock.unlock();
+        try
+        {
+            refreshImage_sync(camId);
+        }
+        catch (const std::exception& e)
+        {
+            // the error is raised again by the synchronous access to the image
+            ALICEVISION_LOG_WARNING("Failed to load image in background: " << _imagesNames.at(camId) << " (" << e.what() << ").");
+        }
+        lock.lock();
+
+        --_nbLoading;
+        _loadQueueCondition.notify_all();
+    }
 }
 
 template class ImagesCache<image::Image<image::RGBfColor>>;
@@ -14,9 +14,10 @@
 #include <aliceVision/mvsData/StaticVector.hpp>
 #include <aliceVision/mvsUtils/MultiViewParams.hpp>
 
-#include <list>
-#include <future>
+#include <condition_variable>
+#include <deque>
 #include <mutex>
+#include <thread>
 
 namespace aliceVision {
 namespace mvsUtils {
@@ -49,9 +50,16 @@ class ImagesCache
     StaticVector<long> _mapIdClock;
 
     std::vector<std::mutex> _imagesMutexes;
+    std::mutex _cacheMutex;  //< protect the cache slots bookkeeping, images can be refreshed concurrently
     std::vector<std::string> _imagesNames;
 
-    std::list<std::future<void>> _asyncObjects;
+    // background loader
+    // a single thread decodes the queued cameras in priority order (front first)
+    std::thread _loaderThread;
+    std::deque<int> _loadQueue;
+    std::mutex _loadQueueMutex;
+    std::condition_variable _loadQueueCondition;
+    bool _stopLoader{false};
 
     image::EImageColorSpace _colorspace{image::EImageColorSpace::AUTO};
     ECorrectEV _correctEV{ECorrectEV::NO_CORRECTION};
@@ -67,23 +75,49 @@ class ImagesCache
     void initIC(std::vector<std::string>& imagesNames);
     void setCacheSize(int nbPreload);
     void setCorrectEV(const ECorrectEV correctEV) { _correctEV = correctEV; }
-    ~ImagesCache() = default;
+    int getCacheSize() const { return _N_PRELOADED_IMAGES; }
+    ~ImagesCache();
 
-    inline ImgSharedPtr getImg_sync(int camId)
-    {
-        refreshImage_sync(camId);
-        const int imageId = _camIdMapId[camId];
-        return _imgs[imageId];
-    }
+    ImgSharedPtr getImg_sync(int camId);
 
-    void refreshData(int camId);
+    ImgSharedPtr refreshData(int camId);
     void refreshImage_sync(int camId);
 
+    /**
+     * @brief Queue the loading of the given camera image in the background loader.
+     *        The request is ignored if the camera is already queued or if the queue is full (cache size).
+     * @param[in] camId the camera index
+     */
     void refreshImage_async(int camId);
 
     void refreshImages_sync(const std::vector<int>& camIds);
 
+    /**
+     * @brief Replace the pending background loads by the given cameras, in priority order.
+     *        Only the first cache size cameras are queued, so the background loads never evict an image they just loaded.
+     * @param[in] camIds the camera indexes, by decreasing priority
+     */
     void refreshImages_async(const std::vector<int>& camIds);
+
+    /**
+     * @brief Predict the next needed cameras of the given camera from the MultiViewParams neighbours
+     *        and load them in the background, the camera itself first.
+     * @param[in] camId the camera index
+     * @param[in] nbNeighbourCams the maximum number of neighbour cameras
+     */
+    void prefetchNeighbourCams(int camId, int nbNeighbourCams);
+
+    /**
+     * @brief Wait for the pending background loads.
+     */
+    void waitAsync();
+
+  private:
+    void startLoader();
+    void loaderLoop();
+
+    /// number of loads currently executed by the loader thread (protected by _loadQueueMutex)
+    int _nbLoading{0};
 };
 
 }  // namespace mvsUtils
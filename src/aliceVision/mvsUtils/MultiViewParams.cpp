@@ -15,6 +15,7 @@
 #include <aliceVision/mvsUtils/common.hpp>
 #include <aliceVision/numeric/numeric.hpp>
 #include <aliceVision/numeric/projection.hpp>
+#include <aliceVision/stl/hash.hpp>
 #include <aliceVision/utils/filesIO.hpp>
 #include <aliceVision/camera/camera.hpp>
 
@@ -25,15 +26,77 @@
 #include <boost/algorithm/string/classification.hpp>
 #include <boost/lexical_cast.hpp>
 
+#include <algorithm>
 #include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <mutex>
 #include <set>
+#include <sstream>
 
 namespace aliceVision {
 namespace mvsUtils {
 
+std::string EMapStorage_informations()
+{
+    return "Storage of the depth and similarity maps:\n"
+           "* float: float depth map, half similarity map\n"
+           "* pxr24: depth map rounded to 24 bits float (relative error < 2^-16), half similarity map, with compression\n"
+           "* halfInverseDepth: half inverse depth map (relative error < 2^-11), half similarity map, with compression";
+}
+
+EMapStorage EMapStorage_stringToEnum(const std::string& mapStorage)
+{
+    std::string type = mapStorage;
+    std::transform(type.begin(), type.end(), type.begin(), ::tolower);  // tolower
+
+    if (type == "float")
+        return EMapStorage::Float;
+    if (type == "pxr24")
+        return EMapStorage::Pxr24;
+    if (type == "halfinversedepth")
+        return EMapStorage::HalfInverseDepth;
+
+    throw std::out_of_range("Invalid EMapStorage: " + mapStorage);
+}
+
+std::string EMapStorage_enumToString(EMapStorage mapStorage)
+{
+    switch (mapStorage)
+    {
+        case EMapStorage::Float:
+            return "float";
+        case EMapStorage::Pxr24:
+            return "pxr24";
+        case EMapStorage::HalfInverseDepth:
+            return "halfInverseDepth";
+    }
+    throw std::out_of_range("Invalid EMapStorage enum");
+}
+
+std::ostream& operator<<(std::ostream& os, EMapStorage mapStorage) { return os << EMapStorage_enumToString(mapStorage); }
+
+std::istream& operator>>(std::istream& in, EMapStorage& mapStorage)
+{
+    std::string token(std::istreambuf_iterator<char>(in), {});
+    mapStorage = EMapStorage_stringToEnum(token);
+    return in;
+}
+
 namespace fs = std::filesystem;
 
+struct MultiViewParams::NeighbourCamsCache
+{
+    std::once_flag landmarksIndexed;
+    std::vector<std::vector<const sfmData::Landmark*>> landmarksPerCam;
+
+    std::mutex mutex;
+    /// view angles range of the scores
+    float minViewAngle = -1.f;
+    float maxViewAngle = -1.f;
+    std::vector<std::vector<SortedId>> scoresPerCam;
+};
+
 MultiViewParams::MultiViewParams(const sfmData::SfMData& sfmData,
                                  const std::string& imagesFolder,
                                  const std::string& depthMapsFolder,
@@ -44,7 +107,8 @@ MultiViewParams::MultiViewParams(const sfmData::SfMData& sfmData,
     _imagesFolder(imagesFolder + "/"),
     _depthMapsFolder(depthMapsFolder + "/"),
     _depthMapsFilterFolder(depthMapsFilterFolder + "/"),
-    _processDownscale(downscale)
+    _processDownscale(downscale),
+    _neighbourCamsCache(std::make_shared<NeighbourCamsCache>())
 {
     verbose = userParams.get<bool>("global.verbose", true);
     simThr = userParams.get<double>("global.simThr", 0.0);
@@ -52,6 +116,9 @@ MultiViewParams::MultiViewParams(const sfmData::SfMData& sfmData,
 
     // load image uid, path and dimensions
     {
+        const bool useImagesFolder = (_imagesFolder != "/" && !_imagesFolder.empty() && fs::is_directory(_imagesFolder) && !fs::is_empty(_imagesFolder));
+        _readSourceImages = !readFromDepthMaps && !useImagesFolder;
+
         std::set<std::pair<int, int>> dimensions;  // for print only
         int i = 0;
         for (const auto& viewPair : sfmData.getViews())
@@ -76,7 +143,7 @@ MultiViewParams::MultiViewParams(const sfmData::SfMData& sfmData,
                     path = getFileNameFromViewId(*this, view.getViewId(), mvsUtils::EFileType::depthMap);
                 }
             }
-            else if (_imagesFolder != "/" && !_imagesFolder.empty() && fs::is_directory(_imagesFolder) && !fs::is_empty(_imagesFolder))
+            else if (useImagesFolder)
             {
                 // find folder file extension
                 std::vector<std::string> paths = utils::getFilesPathsFromFolder(_imagesFolder, [&view](const fs::path& path) {
@@ -321,6 +388,20 @@ const std::map<std::string, std::string>& MultiViewParams::getMetadata(int index
     return _sfmData.getViews().at(getViewId(index))->getImage().getMetadata();
 }
 
+const camera::IntrinsicBase* MultiViewParams::getSourceImageIntrinsic(int index) const
+{
+    if (!_readSourceImages)
+        return nullptr;
+
+    const sfmData::View& view = _sfmData.getView(getViewId(index));
+    const camera::IntrinsicBase* intrinsic = _sfmData.getIntrinsicPtr(view.getIntrinsicId());
+
+    if (intrinsic == nullptr || !intrinsic->hasDistortion())
+        return nullptr;
+
+    return intrinsic;
+}
+
 bool MultiViewParams::is3DPointInFrontOfCam(const Point3d* X, int rc) const
 {
     Point3d XT = camArr[rc] * (*X);
@@ -512,62 +593,215 @@ void MultiViewParams::decomposeProjectionMatrix(Point3d& Co,
     iPo = iRo * iKo;
 }
 
-StaticVector<int> MultiViewParams::findNearestCamsFromLandmarks(int rc, int nbNearestCams) const
+const std::vector<std::vector<const sfmData::Landmark*>>& MultiViewParams::getLandmarksPerCam() const
 {
-    StaticVector<int> out;
-    std::vector<SortedId> ids;
-    ids.reserve(getNbCameras());
+    NeighbourCamsCache& cache = *_neighbourCamsCache;
 
-    for (int tc = 0; tc < getNbCameras(); ++tc)
-        ids.push_back(SortedId(tc, 0));
+    std::call_once(cache.landmarksIndexed, [&]() {
+        cache.landmarksPerCam.resize(getNbCameras());
 
-    const IndexT viewId = getViewId(rc);
-    const sfmData::View& view = *(_sfmData.getViews().at(viewId));
-    const geometry::Pose3 pose = _sfmData.getPose(view).getTransform();
-    const camera::IntrinsicBase* intrinsicPtr = _sfmData.getIntrinsicPtr(view.getIntrinsicId());
+        for (const auto& landmarkPair : _sfmData.getLandmarks())
+        {
+            for (const auto& observationPair : landmarkPair.second.getObservations())
+            {
+                const auto imageIdIt = _imageIdsPerViewId.find(observationPair.first);
+                if (imageIdIt != _imageIdsPerViewId.end())
+                    cache.landmarksPerCam.at(imageIdIt->second).push_back(&landmarkPair.second);
+            }
+        }
+    });
+
+    return cache.landmarksPerCam;
+}
+
+std::size_t MultiViewParams::computeSfMDataHash() const
+{
+    std::size_t seed = 0;
+
+    for (const ImageParams& imageParams : _imagesParams)
+    {
+        const sfmData::View& view = *(_sfmData.getViews().at(imageParams.viewId));
+        stl::hash_combine(seed, imageParams.viewId);
+
+        const geometry::Pose3 pose = _sfmData.getPose(view).getTransform();
+        const Mat34 transform = pose.getHomogeneous().topRows<3>();
+        for (Eigen::Index i = 0; i < transform.size(); ++i)
+            stl::hash_combine(seed, transform.data()[i]);
+
+        for (double param : _sfmData.getIntrinsicPtr(view.getIntrinsicId())->getParams())
+            stl::hash_combine(seed, param);
+    }
 
     for (const auto& landmarkPair : _sfmData.getLandmarks())
     {
-        const auto& observations = landmarkPair.second.getObservations();
+        stl::hash_combine(seed, landmarkPair.first);
+        for (const auto& observationPair : landmarkPair.second.getObservations())
+        {
+            stl::hash_combine(seed, observationPair.first);
+            stl::hash_combine(seed, observationPair.second.getX());
+            stl::hash_combine(seed, observationPair.second.getY());
+        }
+    }
 
-        auto viewObsIt = observations.find(viewId);
-        if (viewObsIt == observations.end())
-            continue;
+    return seed;
+}
 
-        for (const auto& observationPair : observations)
+const std::vector<SortedId>& MultiViewParams::getNearestCamsScores(int rc) const
+{
+    NeighbourCamsCache& cache = *_neighbourCamsCache;
+    std::lock_guard<std::mutex> lock(cache.mutex);
+
+    if (cache.minViewAngle == _minViewAngle && cache.maxViewAngle == _maxViewAngle)
+        return cache.scoresPerCam.at(rc);
+
+    const std::size_t sfmDataHash = computeSfMDataHash();
+    const bool useFile = (_depthMapsFolder.size() > 1);
+    const std::string filepath = _depthMapsFolder + "neighbourCams.txt";
+
+    cache.scoresPerCam.assign(getNbCameras(), std::vector<SortedId>());
+
+    // header line of the neighbour cameras file, the file is only used for the same scene and view angles
+    std::stringstream header;
+    header << "neighbourCams 1 " << sfmDataHash << " " << _minViewAngle << " " << _maxViewAngle << " " << getNbCameras();
+
+    if (useFile && utils::exists(filepath))
+    {
+        std::ifstream file(filepath);
+        std::string line;
+        if (std::getline(file, line) && line == header.str())
         {
-            const IndexT otherViewId = observationPair.first;
+            // one line per camera: view id, number of nearest cameras, (view id, score) of each nearest camera
+            bool valid = true;
+            for (int i = 0; valid && i < getNbCameras(); ++i)
+            {
+                IndexT viewId;
+                std::size_t nbScores;
+                valid = static_cast<bool>(file >> viewId >> nbScores) && _imageIdsPerViewId.count(viewId);
+                if (!valid)
+                    break;
+
+                std::vector<SortedId>& scores = cache.scoresPerCam.at(getIndexFromViewId(viewId));
+                scores.resize(nbScores);
+                for (SortedId& score : scores)
+                {
+                    IndexT otherViewId;
+                    valid = valid && static_cast<bool>(file >> otherViewId >> score.value) && _imageIdsPerViewId.count(otherViewId);
+                    if (valid)
+                        score.id = getIndexFromViewId(otherViewId);
+                }
+            }
 
-            if (otherViewId == viewId)
-                continue;
+            if (valid)
+            {
+                ALICEVISION_LOG_INFO("Nearest cameras read from file: " << filepath);
+                cache.minViewAngle = _minViewAngle;
+                cache.maxViewAngle = _maxViewAngle;
+                return cache.scoresPerCam.at(rc);
+            }
+
+            ALICEVISION_LOG_WARNING("Invalid nearest cameras file: " << filepath);
+            cache.scoresPerCam.assign(getNbCameras(), std::vector<SortedId>());
+        }
+    }
 
-            const sfmData::View& otherView = *(_sfmData.getViews().at(otherViewId));
-            const geometry::Pose3 otherPose = _sfmData.getPose(otherView).getTransform();
-            const camera::IntrinsicBase* otherIntrinsicPtr = _sfmData.getIntrinsicPtr(otherView.getIntrinsicId());
+    // compute the scores of all the cameras
+    const std::vector<std::vector<const sfmData::Landmark*>>& landmarksPerCam = getLandmarksPerCam();
 
-            const double angle = camera::angleBetweenRays(
-              pose, intrinsicPtr, otherPose, otherIntrinsicPtr, viewObsIt->second.getCoordinates(), observationPair.second.getCoordinates());
+#pragma omp parallel for schedule(dynamic)
+    for (int camIndex = 0; camIndex < getNbCameras(); ++camIndex)
+    {
+        const IndexT viewId = getViewId(camIndex);
+        const sfmData::View& view = *(_sfmData.getViews().at(viewId));
+        const geometry::Pose3 pose = _sfmData.getPose(view).getTransform();
+        const camera::IntrinsicBase* intrinsicPtr = _sfmData.getIntrinsicPtr(view.getIntrinsicId());
 
-            if (angle < _minViewAngle || angle > _maxViewAngle)
-                continue;
+        std::vector<int> nbCommonLandmarks(getNbCameras(), 0);
 
-            const int tc = getIndexFromViewId(otherViewId);
-            ++ids.at(tc).value;
+        for (const sfmData::Landmark* landmark : landmarksPerCam.at(camIndex))
+        {
+            const auto& observations = landmark->getObservations();
+            const auto viewObsIt = observations.find(viewId);
+
+            for (const auto& observationPair : observations)
+            {
+                const IndexT otherViewId = observationPair.first;
+
+                if (otherViewId == viewId)
+                    continue;
+
+                const auto otherImageIdIt = _imageIdsPerViewId.find(otherViewId);
+                if (otherImageIdIt == _imageIdsPerViewId.end())
+                    continue;
+
+                const sfmData::View& otherView = *(_sfmData.getViews().at(otherViewId));
+                const geometry::Pose3 otherPose = _sfmData.getPose(otherView).getTransform();
+                const camera::IntrinsicBase* otherIntrinsicPtr = _sfmData.getIntrinsicPtr(otherView.getIntrinsicId());
+
+                const double angle = camera::angleBetweenRays(
+                  pose, intrinsicPtr, otherPose, otherIntrinsicPtr, viewObsIt->second.getCoordinates(), observationPair.second.getCoordinates());
+
+                if (angle < _minViewAngle || angle > _maxViewAngle)
+                    continue;
+
+                ++nbCommonLandmarks[otherImageIdIt->second];
+            }
         }
+
+        std::vector<SortedId>& scores = cache.scoresPerCam[camIndex];
+        for (int tc = 0; tc < getNbCameras(); ++tc)
+        {
+            // a minimum of 10 common points is required (10*2 because points are stored in both rc/tc combinations)
+            if (nbCommonLandmarks[tc] > (10 * 2))
+                scores.push_back(SortedId(tc, nbCommonLandmarks[tc]));
+        }
+
+        std::stable_sort(scores.begin(), scores.end(), [](const SortedId& a, const SortedId& b) { return a.value > b.value; });
     }
 
-    qsort(&ids[0], ids.size(), sizeof(SortedId), qsortCompareSortedIdDesc);
+    cache.minViewAngle = _minViewAngle;
+    cache.maxViewAngle = _maxViewAngle;
+
+    // write the neighbour cameras file for the other processes of the same scene (e.g. the other chunks)
+    if (useFile)
+    {
+        const std::string tmpFilepath = filepath + "." + std::to_string(sfmDataHash) + "_" + utils::generateUniqueFilename() + ".tmp";
+        {
+            std::ofstream file(tmpFilepath);
+            file << header.str() << "\n";
+            for (int camIndex = 0; camIndex < getNbCameras(); ++camIndex)
+            {
+                const std::vector<SortedId>& scores = cache.scoresPerCam[camIndex];
+                file << getViewId(camIndex) << " " << scores.size();
+                for (const SortedId& score : scores)
+                    file << " " << getViewId(score.id) << " " << score.value;
+                file << "\n";
+            }
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(tmpFilepath, filepath, ec);
+        if (ec)
+        {
+            ALICEVISION_LOG_WARNING("Cannot write the nearest cameras file: " << filepath << " (" << ec.message() << ")");
+            std::filesystem::remove(tmpFilepath, ec);
+        }
+    }
+
+    return cache.scoresPerCam.at(rc);
+}
+
+StaticVector<int> MultiViewParams::findNearestCamsFromLandmarks(int rc, int nbNearestCams) const
+{
+    StaticVector<int> out;
+
+    const std::vector<SortedId>& scores = getNearestCamsScores(rc);
 
     // ensure the ideal number of target cameras is not superior to the actual number of cameras
-    const int maxTc = std::min({getNbCameras(), nbNearestCams, static_cast<int>(ids.size())});
+    const int maxTc = std::min({getNbCameras(), nbNearestCams, static_cast<int>(scores.size())});
     out.reserve(maxTc);
 
     for (int i = 0; i < maxTc; ++i)
-    {
-        // a minimum of 10 common points is required (10*2 because points are stored in both rc/tc combinations)
-        if (ids[i].value > (10 * 2))
-            out.push_back(ids[i].id);
-    }
+        out.push_back(scores[i].id);
 
     if (out.size() < nbNearestCams)
         ALICEVISION_LOG_INFO("Found only " << out.size() << "/" << nbNearestCams << " nearest cameras for view id: " << getViewId(rc));
@@ -602,16 +836,13 @@ std::vector<int> MultiViewParams::findTileNearestCams(int rc, int nbNearestCams,
 
     const ROI fullsizeRoi = upscaleROI(roi, getProcessDownscale());  // landmark observations are in the full-size image coordinate system
 
-    for (const auto& landmarkPair : sfmData.getLandmarks())
+    // landmarks with an observation for the R camera
+    for (const sfmData::Landmark* landmark : getLandmarksPerCam().at(rc))
     {
-        const auto& observations = landmarkPair.second.getObservations();
+        const auto& observations = landmark->getObservations();
 
         auto viewObsIt = observations.find(viewId);
 
-        // has landmark observation for the R camera
-        if (viewObsIt == observations.end())
-            continue;
-
         // landmark R camera observation is in the image full-size ROI
         if (!fullsizeRoi.contains(viewObsIt->second.getX(), viewObsIt->second.getY()))
             continue;
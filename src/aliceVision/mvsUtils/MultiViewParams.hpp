@@ -16,9 +16,11 @@
 
 #include <boost/property_tree/ptree.hpp>
 
+#include <iostream>
 #include <string>
 #include <vector>
 #include <map>
+#include <memory>
 
 namespace aliceVision {
 
@@ -26,8 +28,13 @@ namespace bpt = boost::property_tree;
 
 namespace sfmData {
 class SfMData;
+class Landmark;
 }  // namespace sfmData
 
+namespace camera {
+class IntrinsicBase;
+}  // namespace camera
+
 namespace mvsUtils {
 
 enum class EFileType
@@ -82,6 +89,27 @@ enum class EFileType
     tilePattern = 52,
 };
 
+/**
+ * @brief Storage of the depth and similarity map files
+ */
+enum class EMapStorage
+{
+    /// depth map stored as float, similarity map stored as half (lossless)
+    Float,
+    /// depth map stored as float rounded to 24 bits (relative error < 2^-16), similarity map stored as half,
+    /// both with PXR24 / ZIP compression
+    Pxr24,
+    /// depth map stored as half inverse depth relative to the minimal depth of the map (relative error < 2^-11),
+    /// similarity map stored as half, both with ZIP compression
+    HalfInverseDepth
+};
+
+std::string EMapStorage_informations();
+EMapStorage EMapStorage_stringToEnum(const std::string& mapStorage);
+std::string EMapStorage_enumToString(EMapStorage mapStorage);
+std::ostream& operator<<(std::ostream& os, EMapStorage mapStorage);
+std::istream& operator>>(std::istream& in, EMapStorage& mapStorage);
+
 class MultiViewParams
 {
   public:
@@ -166,6 +194,8 @@ class MultiViewParams
 
     inline float getMaxViewAngle() const { return _maxViewAngle; }
 
+    inline EMapStorage getMapStorage() const { return _mapStorage; }
+
     inline std::vector<double> getOriginalP(int index) const
     {
         std::vector<double> p44;                  // projection matrix (4x4) scale 1
@@ -188,6 +218,15 @@ class MultiViewParams
 
     const std::map<std::string, std::string>& getMetadata(int index) const;
 
+    /**
+     * @brief Get the intrinsic to undistort an image on the fly.
+     * @note The images written by prepareDenseScene are already undistorted,
+     *       the source images of the SfMData are read when no images folder is given.
+     * @param[in] index the camera index
+     * @return the intrinsic with distortion of a source image, nullptr if the image is already undistorted
+     */
+    const camera::IntrinsicBase* getSourceImageIntrinsic(int index) const;
+
     bool is3DPointInFrontOfCam(const Point3d* X, int rc) const;
 
     void getPixelFor3DPoint(Point2d* out, const Point3d& X, const Matrix3x4& P) const;
@@ -226,10 +265,12 @@ class MultiViewParams
     StaticVector<int> findCamsWhichIntersectsHexahedron(const Point3d hexah[8]) const;
 
     /**
-     * @brief findNearestCamsFromLandmarks
-     * @param rc
-     * @param nbNearestCams
-     * @return
+     * @brief Find the nearest cameras of a camera, from the number of landmarks they share in the view angles range.
+     * @note The scores of all the cameras are computed in parallel at the first call (or read from the neighbour cameras file
+     *       of the depth maps folder, written by the first process of the same scene and view angles).
+     * @param[in] rc R camera id
+     * @param[in] nbNearestCams maximum number of desired nearest cameras
+     * @return nearest cameras list, by decreasing number of shared landmarks
      */
     StaticVector<int> findNearestCamsFromLandmarks(int rc, int nbNearestCams) const;
 
@@ -247,6 +288,8 @@ class MultiViewParams
 
     inline void setMaxViewAngle(float maxViewAngle) { _maxViewAngle = maxViewAngle; }
 
+    inline void setMapStorage(EMapStorage mapStorage) { _mapStorage = mapStorage; }
+
   private:
     /// image params list (width, height, size)
     std::vector<ImageParams> _imagesParams;
@@ -270,9 +313,32 @@ class MultiViewParams
     float _minViewAngle = 2.0f;
     /// maximum view angle
     float _maxViewAngle = 70.0f;  // WARNING: may be too low, especially when using seeds from SfM
+    /// storage of the written depth and similarity maps
+    EMapStorage _mapStorage = EMapStorage::Float;
+    /// the images are the source images of the SfMData, not the undistorted images of prepareDenseScene
+    bool _readSourceImages = false;
     /// input sfmData
     const sfmData::SfMData& _sfmData;
 
+    struct NeighbourCamsCache;
+    /// landmarks index and nearest cameras scores, shared by the copies
+    std::shared_ptr<NeighbourCamsCache> _neighbourCamsCache;
+
+    /**
+     * @brief Get the landmarks observed by each camera, built at the first call.
+     */
+    const std::vector<std::vector<const sfmData::Landmark*>>& getLandmarksPerCam() const;
+
+    /**
+     * @brief Get the nearest cameras scores of a camera (cameras sharing enough landmarks, by decreasing number of shared landmarks).
+     */
+    const std::vector<SortedId>& getNearestCamsScores(int rc) const;
+
+    /**
+     * @brief Hash of the cameras, poses, intrinsics and landmarks observations of the input sfmData.
+     */
+    std::size_t computeSfMDataHash() const;
+
     void loadMatricesFromTxtFile(int index, const std::string& fileNameP, const std::string& fileNameD);
     void loadMatricesFromRawProjectionMatrix(int index, const double* rawProjMatix);
     void loadMatricesFromSfM(int index);
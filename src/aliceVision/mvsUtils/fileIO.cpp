@@ -11,6 +11,7 @@
 #include <aliceVision/image/io.hpp>
 #include <aliceVision/mvsUtils/common.hpp>
 #include <aliceVision/mvsUtils/MultiViewParams.hpp>
+#include <aliceVision/utils/filesIO.hpp>
 
 namespace aliceVision {
 namespace mvsUtils {
@@ -381,14 +382,42 @@ Matrix3x4 load3x4MatrixFromFile(std::istream& in)
 template<class Image>
 void loadImage(const std::string& path, const MultiViewParams& mp, int camId, Image& img, image::EImageColorSpace colorspace, ECorrectEV correctEV)
 {
+    // scale choosed by the user and apply during the process
+    const int processScale = mp.getProcessDownscale();
+
+    // try to use the pre-downscaled image written by prepareDenseScene
+    // note: the pre-downscaled image is resized in linear colorspace
+    std::string readPath = path;
+    int readScale = 1;
+
+    if (processScale > 1)
+    {
+        const std::string downscaledPath = image::getDownscaledImagePath(path, processScale);
+
+        if (utils::exists(downscaledPath))
+        {
+            const oiio::ImageSpec spec = image::readImageSpec(downscaledPath);
+
+            if ((spec.width == mp.getOriginalWidth(camId) / processScale) && (spec.height == mp.getOriginalHeight(camId) / processScale))
+            {
+                readPath = downscaledPath;
+                readScale = processScale;
+            }
+            else
+            {
+                ALICEVISION_LOG_WARNING("Ignore pre-downscaled image with bad dimension: " << downscaledPath);
+            }
+        }
+    }
+
     // check image size
-    auto checkImageSize = [&path, &mp, camId, &img]() {
-        if ((mp.getOriginalWidth(camId) != img.width()) || (mp.getOriginalHeight(camId) != img.height()))
+    auto checkImageSize = [&readPath, &mp, camId, &img, readScale]() {
+        if ((mp.getOriginalWidth(camId) / readScale != img.width()) || (mp.getOriginalHeight(camId) / readScale != img.height()))
         {
             std::stringstream s;
             s << "Bad image dimension for camera : " << camId << "\n";
-            s << "\t- image path : " << path << "\n";
-            s << "\t- expected dimension : " << mp.getOriginalWidth(camId) << "x" << mp.getOriginalHeight(camId) << "\n";
+            s << "\t- image path : " << readPath << "\n";
+            s << "\t- expected dimension : " << mp.getOriginalWidth(camId) / readScale << "x" << mp.getOriginalHeight(camId) / readScale << "\n";
             s << "\t- real dimension : " << img.width() << "x" << img.height() << "\n";
             throw std::runtime_error(s.str());
         }
@@ -396,16 +425,16 @@ void loadImage(const std::string& path, const MultiViewParams& mp, int camId, Im
 
     if (correctEV == ECorrectEV::NO_CORRECTION)
     {
-        image::readImage(path, img, colorspace);
+        image::readImage(readPath, img, colorspace);
         checkImageSize();
     }
     // if exposure correction, apply it in linear colorspace and then convert colorspace
     else
     {
-        image::readImage(path, img, image::EImageColorSpace::LINEAR);
+        image::readImage(readPath, img, image::EImageColorSpace::LINEAR);
         checkImageSize();
 
-        const auto metadata = image::readImageMetadata(path);
+        const auto metadata = image::readImageMetadata(readPath);
 
         float exposureCompensation = metadata.get_float("AliceVision:EVComp", -1);
 
@@ -429,16 +458,17 @@ void loadImage(const std::string& path, const MultiViewParams& mp, int camId, Im
         }
     }
 
-    // scale choosed by the user and apply during the process
-    const int processScale = mp.getProcessDownscale();
-
-    if (processScale > 1)
+    if (processScale > readScale)
     {
         ALICEVISION_LOG_DEBUG("Downscale (x" << processScale << ") image: " << mp.getViewId(camId) << ".");
         Image bmpr;
         imageAlgo::resizeImage(processScale, img, bmpr);
         img.swap(bmpr);
     }
+    else if (readScale > 1)
+    {
+        ALICEVISION_LOG_DEBUG("Use pre-downscaled (x" << readScale << ") image: " << mp.getViewId(camId) << ".");
+    }
 }
 
 template void loadImage<image::Image<image::RGBfColor>>(const std::string& path,
@@ -58,6 +58,16 @@ std::string getFileNameFromIndex(const MultiViewParams& mp,
  */
 Matrix3x4 load3x4MatrixFromFile(std::istream& in);
 
+/**
+ * @brief Load an image from the given path, downscaled by the multi-view parameters process downscale.
+ * @note Use the pre-downscaled image (see image::getDownscaledImagePath) if available.
+ * @param[in] path the full resolution image path
+ * @param[in] mp the multi-view parameters
+ * @param[in] camId the camera index in the multi-view parameters
+ * @param[out] img the output image
+ * @param[in] colorspace the output image colorspace
+ * @param[in] correctEV the exposure correction mode
+ */
 template<class Image>
 void loadImage(const std::string& path, const MultiViewParams& mp, int camId, Image& img, image::EImageColorSpace colorspace, ECorrectEV correctEV);
 
@@ -15,6 +15,7 @@
 #include <boost/regex.hpp>
 
 #include <filesystem>
+#include <type_traits>
 
 namespace fs = std::filesystem;
 
@@ -60,6 +61,76 @@ std::string getMapNameFromFileType(EFileType fileType)
     return "unknown map";
 }
 
+/**
+ * @brief Check if the given fileType enum is a depth map
+ * @param[in] fileType the map fileType enum
+ * @return true if depth map or filtered depth map
+ */
+inline bool isDepthMapFileType(EFileType fileType) { return (fileType == EFileType::depthMap) || (fileType == EFileType::depthMapFiltered); }
+
+/**
+ * @brief Encode a depth map as inverse depth relative to its minimal depth, for half storage.
+ *        The encoded values are in ]0, 1] and the half relative precision is kept on the decoded depth.
+ * @note Invalid and masked values (<= 0) are kept as is, they are exactly represented in half.
+ * @param[in] in_depthMap the depth map to encode
+ * @param[out] out_encodedMap the encoded map
+ * @return the reference depth (minimal valid depth) or 0 if no valid depth
+ */
+float encodeInverseDepthMap(const image::Image<float>& in_depthMap, image::Image<float>& out_encodedMap)
+{
+    float refDepth = std::numeric_limits<float>::max();
+
+    for (int i = 0; i < in_depthMap.size(); ++i)
+    {
+        if (in_depthMap(i) > 0.0f)
+            refDepth = std::min(refDepth, in_depthMap(i));
+    }
+
+    out_encodedMap = in_depthMap;
+
+    if (refDepth == std::numeric_limits<float>::max())
+        return 0.0f;  // no valid depth, nothing to encode
+
+#pragma omp parallel for
+    for (int i = 0; i < in_depthMap.size(); ++i)
+    {
+        if (in_depthMap(i) > 0.0f)
+            out_encodedMap(i) = refDepth / in_depthMap(i);
+    }
+
+    return refDepth;
+}
+
+/**
+ * @brief Decode a depth map file read as inverse depth relative to the reference depth written in its metadata.
+ * @note Nothing is done for the maps written without encoding.
+ * @param[in] mapPath the map file path
+ * @param[in] fileType the map fileType enum
+ * @param[in,out] inout_map the map read from file
+ */
+template<typename T>
+void decodeMap(const std::string& mapPath, EFileType fileType, image::Image<T>& inout_map)
+{
+    if constexpr (std::is_same<T, float>::value)
+    {
+        if (!isDepthMapFileType(fileType))
+            return;
+
+        const oiio::ParamValueList metadata = image::readImageMetadata(mapPath);
+        const float refDepth = metadata.get_float("AliceVision:inverseDepthRef", 0.0f);
+
+        if (refDepth <= 0.0f)
+            return;  // not encoded
+
+#pragma omp parallel for
+        for (int i = 0; i < inout_map.size(); ++i)
+        {
+            if (inout_map(i) > 0.0f)
+                inout_map(i) = refDepth / inout_map(i);
+        }
+    }
+}
+
 /**
  * @brief Get tile map ROI from file metadata.
  * @param[in] mapTilePath the tile map file path
@@ -332,6 +403,7 @@ void readMapFromFileOrTiles(int rc,
         ALICEVISION_LOG_TRACE("Load depth map (full image): " << mapPath << ", scale: " << scale << ", step: " << step);
         // read single file fullsize map
         image::readImage(mapPath, out_map, image::EImageColorSpace::NO_CONVERSION);
+        decodeMap(mapPath, fileType, out_map);
         return;
     }
     ALICEVISION_LOG_TRACE("No full image depth map: " << mapPath << ", scale: " << scale << ", step: " << step << ". Looking for tiles.");
@@ -388,6 +460,7 @@ void readMapFromFileOrTiles(int rc,
             // read tile
             image::Image<T> tileMap;
             image::readImage(mapTilePath, tileMap, image::EImageColorSpace::NO_CONVERSION);
+            decodeMap(mapTilePath, fileType, tileMap);
 
             // add tile to the full map
             addSingleTileMapWeighted(rc, mp, tileParams, roi, scaleStep, tileMap, out_map);
@@ -399,6 +472,84 @@ void readMapFromFileOrTiles(int rc,
     }
 }
 
+template<typename T>
+void readMapRoiFromFileOrTiles(int rc,
+                               const MultiViewParams& mp,
+                               EFileType fileType,
+                               const ROI& roi,
+                               image::Image<T>& out_map,
+                               int scale,
+                               int step,
+                               const std::string& customSuffix)
+{
+    const int scaleStep = scale * step;
+    const ROI imageRoi(Range(0, mp.getWidth(rc)), Range(0, mp.getHeight(rc)));
+    const ROI downscaledRoi = downscaleROI(intersect(roi, imageRoi), scaleStep);
+
+    if (downscaledRoi.isEmpty())
+        ALICEVISION_THROW_ERROR("Cannot read an empty region of the " << getMapNameFromFileType(fileType) << " (rc: " << rc << ").");
+
+    // single file fullsize map path
+    const std::string mapPath = getFileNameFromIndex(mp, rc, fileType, customSuffix);
+
+    // read only the region, for tiled files only the file tiles covering it are decoded
+    if (utils::exists(mapPath))
+    {
+        image::ImageReadOptions readOptions(image::EImageColorSpace::NO_CONVERSION);
+        readOptions.subROI = oiio::ROI(downscaledRoi.x.begin, downscaledRoi.x.end, downscaledRoi.y.begin, downscaledRoi.y.end);
+
+        image::readImage(mapPath, out_map, readOptions);
+        decodeMap(mapPath, fileType, out_map);
+        return;
+    }
+
+    // map written as tile files, fuse the tiles then crop
+    image::Image<T> map;
+    readMapFromFileOrTiles(rc, mp, fileType, map, scale, step, customSuffix);
+
+    out_map.resize(downscaledRoi.width(), downscaledRoi.height());
+
+    for (int y = 0; y < downscaledRoi.height(); ++y)
+    {
+        for (int x = 0; x < downscaledRoi.width(); ++x)
+            out_map(y, x) = map(downscaledRoi.y.begin + y, downscaledRoi.x.begin + x);
+    }
+}
+
+/**
+ * @brief Get the file tile size of a fullsize map written from the given tile ROI list.
+ *        The tiles begin at multiples of the effective tile size (without padding),
+ *        so that each file tile holds the effective area of one tile.
+ * @param[in] imageWidth the image width without any downscale apply
+ * @param[in] imageHeight the image height without any downscale apply
+ * @param[in] tileRoiList the tile ROI list
+ * @param[in] downscale the map downscale factor
+ * @param[out] out_fileTileWidth the file tile width
+ * @param[out] out_fileTileHeight the file tile height
+ */
+void getFileTileSize(int imageWidth,
+                     int imageHeight,
+                     const std::vector<ROI>& tileRoiList,
+                     int downscale,
+                     int& out_fileTileWidth,
+                     int& out_fileTileHeight)
+{
+    int effectiveTileWidth = imageWidth;
+    int effectiveTileHeight = imageHeight;
+
+    for (const ROI& roi : tileRoiList)
+    {
+        if (roi.x.begin > 0)
+            effectiveTileWidth = std::min(effectiveTileWidth, int(roi.x.begin));
+
+        if (roi.y.begin > 0)
+            effectiveTileHeight = std::min(effectiveTileHeight, int(roi.y.begin));
+    }
+
+    out_fileTileWidth = divideRoundUp(effectiveTileWidth, downscale);
+    out_fileTileHeight = divideRoundUp(effectiveTileHeight, downscale);
+}
+
 template<typename T>
 void writeMapToFileOrTile(int rc,
                           const MultiViewParams& mp,
@@ -408,7 +559,9 @@ void writeMapToFileOrTile(int rc,
                           const image::Image<T>& in_map,
                           int scale,
                           int step,
-                          const std::string& customSuffix = "")
+                          const std::string& customSuffix = "",
+                          int fileTileWidth = 0,
+                          int fileTileHeight = 0)
 {
     // assert scale & step
     assert(scale > 0);
@@ -437,7 +590,9 @@ void writeMapToFileOrTile(int rc,
     // output map path
     std::string mapPath;
 
-    if (downscaledROI.width() != imageWidth || downscaledROI.height() != imageHeight)  // is a tile
+    const bool isTile = (downscaledROI.width() != imageWidth || downscaledROI.height() != imageHeight);
+
+    if (isTile)
     {
         // tiled map
         mapPath = getFileNameFromIndex(mp, rc, fileType, customSuffix, roi.x.begin, roi.y.begin);
@@ -499,7 +654,7 @@ void writeMapToFileOrTile(int rc,
     }
 
     // min/max/nb depth metadata (for depth map only)
-    if ((fileType == EFileType::depthMap) || (fileType == EFileType::depthMapFiltered))
+    if (isDepthMapFileType(fileType))
     {
         const int nbDepthValues = std::count_if(in_map.data(), in_map.data() + in_map.size(), [](float v) { return v > 0.0f; });
         float maxDepth = -1.0f;
@@ -521,12 +676,21 @@ void writeMapToFileOrTile(int rc,
         metadata.push_back(oiio::ParamValue("AliceVision:maxDepth", maxDepth));
     }
 
+    const EMapStorage mapStorage = mp.getMapStorage();
+    const bool isDepthMap = isDepthMapFileType(fileType);
+
     // set colorspace
     image::ImageWriteOptions mapWriteOptions;
     mapWriteOptions.toColorSpace(image::EImageColorSpace::NO_CONVERSION);
 
+    // set file tiles, only for a fullsize map
+    if (!isTile && fileTileWidth > 0 && fileTileHeight > 0)
+    {
+        mapWriteOptions.tileSize(fileTileWidth, fileTileHeight);
+    }
+
     // set storage type
-    if ((fileType == EFileType::depthMap) || (fileType == EFileType::depthMapFiltered))
+    if (isDepthMap && (mapStorage != EMapStorage::HalfInverseDepth))
     {
         mapWriteOptions.storageDataType(image::EStorageDataType::Float);
     }
@@ -535,6 +699,33 @@ void writeMapToFileOrTile(int rc,
         mapWriteOptions.storageDataType(image::EStorageDataType::Half);
     }
 
+    // set compression
+    // note: PXR24 rounds float values to 24 bits and is lossless for half values
+    if (mapStorage == EMapStorage::Pxr24)
+    {
+        mapWriteOptions.exrCompressionMethod(image::EImageExrCompression::PXR24);
+    }
+    else if (mapStorage == EMapStorage::HalfInverseDepth)
+    {
+        mapWriteOptions.exrCompressionMethod(image::EImageExrCompression::ZIP);
+    }
+
+    // write depth map as inverse depth
+    if constexpr (std::is_same<T, float>::value)
+    {
+        if (isDepthMap && (mapStorage == EMapStorage::HalfInverseDepth))
+        {
+            image::Image<float> encodedMap;
+            const float refDepth = encodeInverseDepthMap(in_map, encodedMap);
+
+            if (refDepth > 0.0f)
+                metadata.push_back(oiio::ParamValue("AliceVision:inverseDepthRef", refDepth));
+
+            image::writeImage(mapPath, encodedMap, mapWriteOptions, metadata, displayRoi, pixelRoi);
+            return;
+        }
+    }
+
     // write map
     image::writeImage(mapPath, in_map, mapWriteOptions, metadata, displayRoi, pixelRoi);
 }
@@ -572,6 +763,30 @@ void readMap(int rc,
     readMapFromFileOrTiles(rc, mp, fileType, out_map, scale, step, customSuffix);
 }
 
+void readMap(int rc,
+             const MultiViewParams& mp,
+             const EFileType fileType,
+             const ROI& roi,
+             image::Image<float>& out_map,
+             int scale,
+             int step,
+             const std::string& customSuffix)
+{
+    readMapRoiFromFileOrTiles(rc, mp, fileType, roi, out_map, scale, step, customSuffix);
+}
+
+void readMap(int rc,
+             const MultiViewParams& mp,
+             const EFileType fileType,
+             const ROI& roi,
+             image::Image<image::RGBfColor>& out_map,
+             int scale,
+             int step,
+             const std::string& customSuffix)
+{
+    readMapRoiFromFileOrTiles(rc, mp, fileType, roi, out_map, scale, step, customSuffix);
+}
+
 void writeMap(int rc,
               const MultiViewParams& mp,
               const EFileType fileType,
@@ -598,6 +813,44 @@ void writeMap(int rc,
     writeMapToFileOrTile(rc, mp, fileType, tileParams, roi, in_map, scale, step, customSuffix);
 }
 
+void writeTiledMap(int rc,
+                   const MultiViewParams& mp,
+                   const EFileType fileType,
+                   const TileParams& tileParams,
+                   const std::vector<ROI>& tileRoiList,
+                   const image::Image<float>& in_map,
+                   int scale,
+                   int step,
+                   const std::string& customSuffix)
+{
+    const ROI roi = ROI(0, mp.getWidth(rc), 0, mp.getHeight(rc));  // fullsize roi
+
+    int fileTileWidth;
+    int fileTileHeight;
+    getFileTileSize(mp.getWidth(rc), mp.getHeight(rc), tileRoiList, scale * step, fileTileWidth, fileTileHeight);
+
+    writeMapToFileOrTile(rc, mp, fileType, tileParams, roi, in_map, scale, step, customSuffix, fileTileWidth, fileTileHeight);
+}
+
+void writeTiledMap(int rc,
+                   const MultiViewParams& mp,
+                   const EFileType fileType,
+                   const TileParams& tileParams,
+                   const std::vector<ROI>& tileRoiList,
+                   const image::Image<image::RGBfColor>& in_map,
+                   int scale,
+                   int step,
+                   const std::string& customSuffix)
+{
+    const ROI roi = ROI(0, mp.getWidth(rc), 0, mp.getHeight(rc));  // fullsize roi
+
+    int fileTileWidth;
+    int fileTileHeight;
+    getFileTileSize(mp.getWidth(rc), mp.getHeight(rc), tileRoiList, scale * step, fileTileWidth, fileTileHeight);
+
+    writeMapToFileOrTile(rc, mp, fileType, tileParams, roi, in_map, scale, step, customSuffix, fileTileWidth, fileTileHeight);
+}
+
 unsigned long getNbDepthValuesFromDepthMap(int rc, const MultiViewParams& mp, int scale, int step, const std::string& customSuffix)
 {
     const std::string depthMapPath = getFileNameFromIndex(mp, rc, EFileType::depthMapFiltered, customSuffix);
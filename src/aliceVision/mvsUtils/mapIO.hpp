@@ -11,6 +11,7 @@
 #include <aliceVision/image/Image.hpp>
 
 #include <string>
+#include <vector>
 
 namespace aliceVision {
 namespace mvsUtils {
@@ -59,6 +60,36 @@ void readMap(int rc,
              int step = 1,
              const std::string& customSuffix = "");
 
+/**
+ * @brief Read a region of a fullsize map from file(s).
+ *        For a map written with writeTiledMap, only the file tiles covering the region are decoded.
+ * @param[in] rc the related R camera index
+ * @param[in] mp the multi-view parameters
+ * @param[in] fileType the map fileType enum
+ * @param[in] roi the 2d region of interest without any downscale apply
+ * @param[out] out_map the output map region read from file(s)
+ * @param[in] scale the map downscale factor
+ * @param[in] step the map step factor
+ * @param[in] customSuffix the map filename custom suffix
+ */
+void readMap(int rc,
+             const MultiViewParams& mp,
+             const EFileType fileType,
+             const ROI& roi,
+             image::Image<float>& out_map,
+             int scale = 1,
+             int step = 1,
+             const std::string& customSuffix = "");
+
+void readMap(int rc,
+             const MultiViewParams& mp,
+             const EFileType fileType,
+             const ROI& roi,
+             image::Image<image::RGBfColor>& out_map,
+             int scale = 1,
+             int step = 1,
+             const std::string& customSuffix = "");
+
 /**
  * @brief Write a fullsize or tile map in a file.
  * @param[in] rc the related R camera index
@@ -127,6 +158,40 @@ inline void writeMap(int rc,
     writeMap(rc, mp, fileType, tileParams, roi, in_map, scale, step, customSuffix);
 }
 
+/**
+ * @brief Write a fullsize map fused from tiles in a single tiled file.
+ *        Each file tile holds the effective area (without padding) of one tile of the list,
+ *        so the map regions can be read without decoding the whole file.
+ * @param[in] rc the related R camera index
+ * @param[in] mp the multi-view parameters
+ * @param[in] fileType the map fileType enum
+ * @param[in] tileParams tile workflow parameters
+ * @param[in] tileRoiList the tile ROI list used to compute the map
+ * @param[in] in_map the input fullsize map to write
+ * @param[in] scale the map downscale factor
+ * @param[in] step the map step factor
+ * @param[in] customSuffix the map filename custom suffix
+ */
+void writeTiledMap(int rc,
+                   const MultiViewParams& mp,
+                   const EFileType fileType,
+                   const TileParams& tileParams,
+                   const std::vector<ROI>& tileRoiList,
+                   const image::Image<float>& in_map,
+                   int scale,
+                   int step,
+                   const std::string& customSuffix = "");
+
+void writeTiledMap(int rc,
+                   const MultiViewParams& mp,
+                   const EFileType fileType,
+                   const TileParams& tileParams,
+                   const std::vector<ROI>& tileRoiList,
+                   const image::Image<image::RGBfColor>& in_map,
+                   int scale,
+                   int step,
+                   const std::string& customSuffix = "");
+
 /**
  * @brief Get depth map number of depth values from metadata or computation.
  * @param[in] rc the related R camera index
@@ -0,0 +1,114 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "SessionPool.hpp"
+
+#include <aliceVision/system/hardwareContext.hpp>
+#include <aliceVision/system/Logger.hpp>
+#include <aliceVision/system/Timer.hpp>
+
+#include <algorithm>
+
+namespace aliceVision {
+namespace onnx {
+
+SessionOptions getSessionOptions(const HardwareContext& hwc, bool useGpu, int nbConcurrentRuns)
+{
+    SessionOptions options;
+    options.useGpu = useGpu;
+    // the models are sequential graphs: parallelize inside the operators,
+    // with the threads shared between the concurrent runs
+    options.intraOpThreads = std::max(1, static_cast<int>(hwc.getMaxThreads()) / std::max(1, nbConcurrentRuns));
+    options.interOpThreads = 1;
+    return options;
+}
+
+Ort::Env& getEnvironment()
+{
+    static Ort::Env environment(ORT_LOGGING_LEVEL_WARNING, "aliceVision");
+    return environment;
+}
+
+SessionPool::SessionPool()
+{
+    // The environment is created before the pool, so that it outlives the cached sessions
+    getEnvironment();
+}
+
+SessionPool& SessionPool::get()
+{
+    static SessionPool pool;
+    return pool;
+}
+
+std::shared_ptr<Ort::Session> SessionPool::getSession(const std::string& modelPath, const SessionOptions& options)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    std::shared_ptr<Ort::Session>& session = _sessions[std::make_pair(modelPath, options)];
+    if (session)
+    {
+        return session;
+    }
+
+    system::Timer timer;
+
+    Ort::SessionOptions ortSessionOptions;
+    if (options.intraOpThreads > 0)
+        ortSessionOptions.SetIntraOpNumThreads(options.intraOpThreads);
+    if (options.interOpThreads > 0)
+        ortSessionOptions.SetInterOpNumThreads(options.interOpThreads);
+
+    if (options.useGpu)
+    {
+// Disable for compilation purpose if needed
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_ONNX_GPU)
+        const auto& api = Ort::GetApi();
+        OrtCUDAProviderOptionsV2* cudaOptions = nullptr;
+        api.CreateCUDAProviderOptions(&cudaOptions);
+        api.SessionOptionsAppendExecutionProvider_CUDA_V2(static_cast<OrtSessionOptions*>(ortSessionOptions), cudaOptions);
+        api.ReleaseCUDAProviderOptions(cudaOptions);
+#else
+        ALICEVISION_LOG_WARNING("ONNX runtime has been built without CUDA, the inference of '" << modelPath << "' will run on the CPU.");
+#endif
+    }
+
+    try
+    {
+#if defined(_WIN32) || defined(_WIN64)
+        const std::wstring modelPathW(modelPath.begin(), modelPath.end());
+        session = std::make_shared<Ort::Session>(getEnvironment(), modelPathW.c_str(), ortSessionOptions);
+#else
+        session = std::make_shared<Ort::Session>(getEnvironment(), modelPath.c_str(), ortSessionOptions);
+#endif
+    }
+    catch (...)
+    {
+        _sessions.erase(std::make_pair(modelPath, options));
+        throw;
+    }
+
+    ALICEVISION_LOG_INFO("ONNX session created for '" << modelPath << "' (" << (options.useGpu ? "gpu" : "cpu") << ") in " << timer.elapsed()
+                                                      << " s.");
+
+    return session;
+}
+
+void SessionPool::releaseUnused()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    for (auto it = _sessions.begin(); it != _sessions.end();)
+    {
+        if (it->second.use_count() <= 1)
+            it = _sessions.erase(it);
+        else
+            ++it;
+    }
+}
+
+}  // namespace onnx
+}  // namespace aliceVision
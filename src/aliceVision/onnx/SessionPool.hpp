@@ -0,0 +1,94 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/config.hpp>
+
+#include <onnxruntime_cxx_api.h>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+namespace aliceVision {
+
+class HardwareContext;
+
+namespace onnx {
+
+/**
+ * @brief Options of an inference session
+ */
+struct SessionOptions
+{
+    /// Use the CUDA execution provider (ignored if ONNX runtime has been built without it)
+    bool useGpu = false;
+    /// Number of threads used to parallelize an operator (0: ONNX runtime default)
+    int intraOpThreads = 0;
+    /// Number of threads used to run independent operators in parallel (0: ONNX runtime default)
+    int interOpThreads = 0;
+
+    bool operator<(const SessionOptions& other) const
+    {
+        return std::tie(useGpu, intraOpThreads, interOpThreads) < std::tie(other.useGpu, other.intraOpThreads, other.interOpThreads);
+    }
+};
+
+/**
+ * @brief Get the session options sharing the threads allowed by the hardware context between concurrent inferences
+ * @param[in] hwc the hardware context
+ * @param[in] useGpu use the CUDA execution provider
+ * @param[in] nbConcurrentRuns the number of inferences run concurrently on the session
+ * @return the session options
+ */
+SessionOptions getSessionOptions(const HardwareContext& hwc, bool useGpu, int nbConcurrentRuns = 1);
+
+/**
+ * @brief Get the ONNX runtime environment shared by all the sessions of the process
+ * @return the environment
+ */
+Ort::Env& getEnvironment();
+
+/**
+ * @brief Cache of the ONNX runtime sessions of the process, by model and options.
+ *        Creating a session (in particular with the CUDA execution provider) is expensive:
+ *        the modules running an inference get their session from the pool, so that it is created once per model.
+ * @note Ort::Session::Run is thread-safe: a session can be used by concurrent inferences.
+ */
+class SessionPool
+{
+  public:
+    /**
+     * @brief Get the session pool of the process
+     */
+    static SessionPool& get();
+
+    /**
+     * @brief Get the session of a model, created at the first request
+     * @param[in] modelPath the ONNX model path
+     * @param[in] options the session options
+     * @return the shared session
+     * @throw Ort::Exception if the session cannot be created
+     */
+    std::shared_ptr<Ort::Session> getSession(const std::string& modelPath, const SessionOptions& options);
+
+    /**
+     * @brief Release the sessions which are not used anymore
+     */
+    void releaseUnused();
+
+  private:
+    SessionPool();
+
+    std::mutex _mutex;
+    std::map<std::pair<std::string, SessionOptions>, std::shared_ptr<Ort::Session>> _sessions;
+};
+
+}  // namespace onnx
+}  // namespace aliceVision
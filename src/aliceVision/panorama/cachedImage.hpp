@@ -78,27 +78,27 @@ class CachedImage
     template<class UnaryFunction>
     bool perPixelOperation(UnaryFunction f)
     {
-        for (int i = 0; i < _tilesArray.size(); i++)
+        const int tilesCount = getTilesCount();
+
+#pragma omp parallel for schedule(dynamic)
+        for (int id = 0; id < tilesCount; id++)
         {
-            RowType& row = _tilesArray[i];
+            image::CachedTile::smart_pointer ptr = getTile(id);
+            if (!ptr)
+            {
+                continue;
+            }
 
-            for (int j = 0; j < _tilesArray[i].size(); j++)
+            if (!ptr->acquire(true))
             {
-                image::CachedTile::smart_pointer ptr = row[j];
-                if (!ptr)
-                {
-                    continue;
-                }
+                continue;
+            }
 
-                if (!ptr->acquire())
-                {
-                    continue;
-                }
+            T* data = (T*)ptr->getDataPointer();
 
-                T* data = (T*)ptr->getDataPointer();
+            std::transform(data, data + ptr->getTileWidth() * ptr->getTileHeight(), data, f);
 
-                std::transform(data, data + ptr->getTileWidth() * ptr->getTileHeight(), data, f);
-            }
+            ptr->release();
         }
 
         return true;
@@ -112,40 +112,41 @@ class CachedImage
             return false;
         }
 
-        for (int i = 0; i < _tilesArray.size(); i++)
+        const int tilesCount = getTilesCount();
+
+#pragma omp parallel for schedule(dynamic)
+        for (int id = 0; id < tilesCount; id++)
         {
-            RowType& row = _tilesArray[i];
-            RowType& rowOther = other.getTiles()[i];
+            image::CachedTile::smart_pointer ptr = getTile(id);
+            if (!ptr)
+            {
+                continue;
+            }
 
-            for (int j = 0; j < _tilesArray[i].size(); j++)
+            image::CachedTile::smart_pointer ptrOther = other.getTile(id);
+            if (!ptrOther)
             {
-                image::CachedTile::smart_pointer ptr = row[j];
-                if (!ptr)
-                {
-                    continue;
-                }
+                continue;
+            }
 
-                image::CachedTile::smart_pointer ptrOther = rowOther[j];
-                if (!ptrOther)
-                {
-                    continue;
-                }
+            if (!ptr->acquire(true))
+            {
+                continue;
+            }
 
-                if (!ptr->acquire())
-                {
-                    continue;
-                }
+            if (!ptrOther->acquire(true))
+            {
+                ptr->release();
+                continue;
+            }
 
-                if (!ptrOther->acquire())
-                {
-                    continue;
-                }
+            T* data = (T*)ptr->getDataPointer();
+            T2* dataOther = (T2*)ptrOther->getDataPointer();
 
-                T* data = (T*)ptr->getDataPointer();
-                T2* dataOther = (T2*)ptrOther->getDataPointer();
+            std::transform(data, data + ptr->getTileWidth() * ptr->getTileHeight(), dataOther, data, f);
 
-                std::transform(data, data + ptr->getTileWidth() * ptr->getTileHeight(), dataOther, data, f);
-            }
+            ptrOther->release();
+            ptr->release();
         }
 
         return true;
@@ -160,40 +161,41 @@ class CachedImage
         if (source._tileSize != _tileSize)
             return false;
 
-        for (int i = 0; i < _tilesArray.size(); i++)
+        const int tilesCount = getTilesCount();
+
+#pragma omp parallel for schedule(dynamic)
+        for (int id = 0; id < tilesCount; id++)
         {
-            RowType& row = _tilesArray[i];
-            RowType& rowSource = source._tilesArray[i];
+            image::CachedTile::smart_pointer ptr = getTile(id);
+            if (!ptr)
+            {
+                continue;
+            }
 
-            for (int j = 0; j < _tilesArray[i].size(); j++)
+            image::CachedTile::smart_pointer ptrSource = source.getTile(id);
+            if (!ptrSource)
             {
-                image::CachedTile::smart_pointer ptr = row[j];
-                if (!ptr)
-                {
-                    continue;
-                }
+                continue;
+            }
 
-                image::CachedTile::smart_pointer ptrSource = rowSource[j];
-                if (!ptrSource)
-                {
-                    continue;
-                }
+            if (!ptr->acquire(true))
+            {
+                continue;
+            }
 
-                if (!ptr->acquire())
-                {
-                    continue;
-                }
+            if (!ptrSource->acquire(true))
+            {
+                ptr->release();
+                continue;
+            }
 
-                if (!ptrSource->acquire())
-                {
-                    continue;
-                }
+            T* data = (T*)ptr->getDataPointer();
+            T* dataSource = (T*)ptrSource->getDataPointer();
 
-                T* data = (T*)ptr->getDataPointer();
-                T* dataSource = (T*)ptrSource->getDataPointer();
+            std::memcpy(data, dataSource, _tileSize * _tileSize * sizeof(T));
 
-                std::memcpy(data, dataSource, _tileSize * _tileSize * sizeof(T));
-            }
+            ptrSource->release();
+            ptr->release();
         }
 
         return true;
@@ -247,51 +249,55 @@ class CachedImage
         int delta_y = outputBb.top - snapedBb.top;
         int delta_x = outputBb.left - snapedBb.left;
 
-        for (int i = 0; i < gridBb.height; i++)
+        prefetch(outputBb);
+
+        // Each tile is written by a single thread
+#pragma omp parallel for schedule(dynamic)
+        for (int id = 0; id < gridBb.width * gridBb.height; id++)
         {
+            const int i = id / gridBb.width;
+            const int j = id % gridBb.width;
+
             // ibb.top + i * tileSize --> snapedBb.top + delta + i * tileSize
             int ti = gridBb.top + i;
             int oy = ti * _tileSize;
             int sy = inputBb.top - delta_y + i * _tileSize;
 
-            RowType& row = _tilesArray[ti];
+            int tj = gridBb.left + j;
+            int ox = tj * _tileSize;
+            int sx = inputBb.left - delta_x + j * _tileSize;
 
-            for (int j = 0; j < gridBb.width; j++)
+            image::CachedTile::smart_pointer ptr = _tilesArray[ti][tj];
+            if (!ptr)
             {
-                int tj = gridBb.left + j;
-                int ox = tj * _tileSize;
-                int sx = inputBb.left - delta_x + j * _tileSize;
-
-                image::CachedTile::smart_pointer ptr = row[tj];
-                if (!ptr)
-                {
-                    continue;
-                }
+                continue;
+            }
 
-                if (!ptr->acquire())
-                {
-                    continue;
-                }
+            if (!ptr->acquire(true))
+            {
+                continue;
+            }
 
-                T* data = (T*)ptr->getDataPointer();
+            T* data = (T*)ptr->getDataPointer();
 
-                for (int y = 0; y < _tileSize; y++)
+            for (int y = 0; y < _tileSize; y++)
+            {
+                for (int x = 0; x < _tileSize; x++)
                 {
-                    for (int x = 0; x < _tileSize; x++)
-                    {
-                        if (sy + y < inputBb.top || sy + y > inputBb.getBottom())
-                            continue;
-                        if (sx + x < inputBb.left || sx + x > inputBb.getRight())
-                            continue;
-                        if (oy + y < outputBb.top || oy + y > outputBb.getBottom())
-                            continue;
-                        if (ox + x < outputBb.left || ox + x > outputBb.getRight())
-                            continue;
-
-                        data[y * _tileSize + x] = input(sy + y, sx + x);
-                    }
+                    if (sy + y < inputBb.top || sy + y > inputBb.getBottom())
+                        continue;
+                    if (sx + x < inputBb.left || sx + x > inputBb.getRight())
+                        continue;
+                    if (oy + y < outputBb.top || oy + y > outputBb.getBottom())
+                        continue;
+                    if (ox + x < outputBb.left || ox + x > outputBb.getRight())
+                        continue;
+
+                    data[y * _tileSize + x] = input(sy + y, sx + x);
                 }
             }
+
+            ptr->release();
         }
 
         return true;
@@ -343,50 +349,54 @@ class CachedImage
         int delta_y = inputBb.top - snapedBb.top;
         int delta_x = inputBb.left - snapedBb.left;
 
-        for (int i = 0; i < gridBb.height; i++)
+        prefetch(inputBb);
+
+        // The tiles write disjoint regions of the output
+#pragma omp parallel for schedule(dynamic)
+        for (int id = 0; id < gridBb.width * gridBb.height; id++)
         {
+            const int i = id / gridBb.width;
+            const int j = id % gridBb.width;
+
             int ti = gridBb.top + i;
             int oy = ti * _tileSize;
             int sy = outputBb.top - delta_y + i * _tileSize;
 
-            RowType& row = _tilesArray[ti];
+            int tj = gridBb.left + j;
+            int ox = tj * _tileSize;
+            int sx = outputBb.left - delta_x + j * _tileSize;
 
-            for (int j = 0; j < gridBb.width; j++)
+            image::CachedTile::smart_pointer ptr = _tilesArray[ti][tj];
+            if (!ptr)
             {
-                int tj = gridBb.left + j;
-                int ox = tj * _tileSize;
-                int sx = outputBb.left - delta_x + j * _tileSize;
-
-                image::CachedTile::smart_pointer ptr = row[tj];
-                if (!ptr)
-                {
-                    continue;
-                }
+                continue;
+            }
 
-                if (!ptr->acquire())
-                {
-                    continue;
-                }
+            if (!ptr->acquire(true))
+            {
+                continue;
+            }
 
-                T* data = (T*)ptr->getDataPointer();
+            T* data = (T*)ptr->getDataPointer();
 
-                for (int y = 0; y < _tileSize; y++)
+            for (int y = 0; y < _tileSize; y++)
+            {
+                for (int x = 0; x < _tileSize; x++)
                 {
-                    for (int x = 0; x < _tileSize; x++)
-                    {
-                        if (sy + y < outputBb.top || sy + y > outputBb.getBottom())
-                            continue;
-                        if (sx + x < outputBb.left || sx + x > outputBb.getRight())
-                            continue;
-                        if (oy + y < inputBb.top || oy + y > inputBb.getBottom())
-                            continue;
-                        if (ox + x < inputBb.left || ox + x > inputBb.getRight())
-                            continue;
-
-                        output(sy + y, sx + x) = data[y * _tileSize + x];
-                    }
+                    if (sy + y < outputBb.top || sy + y > outputBb.getBottom())
+                        continue;
+                    if (sx + x < outputBb.left || sx + x > outputBb.getRight())
+                        continue;
+                    if (oy + y < inputBb.top || oy + y > inputBb.getBottom())
+                        continue;
+                    if (ox + x < inputBb.left || ox + x > inputBb.getRight())
+                        continue;
+
+                    output(sy + y, sx + x) = data[y * _tileSize + x];
                 }
             }
+
+            ptr->release();
         }
 
         return true;
@@ -463,8 +473,57 @@ class CachedImage
         return true;
     }
 
+    /**
+     * Bring in core the tiles covering a bounding box, before a sequence of operations on this region.
+     * The tiles are read in their storage order, which avoids the random accesses of the parallel loops to the cache files.
+     * The tiles are not pinned: only the tiles fitting in the in-core budget of the manager stay in core.
+     * @param bb the bounding box, clamped to the image
+     * @return false if a tile could not be acquired
+     */
+    bool prefetch(const BoundingBox& bb)
+    {
+        if (_tilesArray.empty() || bb.isEmpty())
+        {
+            return true;
+        }
+
+        const int firstRow = std::max(0, bb.top / _tileSize);
+        const int lastRow = std::min(int(_tilesArray.size()) - 1, bb.getBottom() / _tileSize);
+        const int firstCol = std::max(0, bb.left / _tileSize);
+        const int lastCol = std::min(int(_tilesArray[0].size()) - 1, bb.getRight() / _tileSize);
+
+        bool res = true;
+        for (int i = firstRow; i <= lastRow; i++)
+        {
+            for (int j = firstCol; j <= lastCol; j++)
+            {
+                image::CachedTile::smart_pointer ptr = _tilesArray[i][j];
+                if (ptr && !ptr->acquire())
+                {
+                    res = false;
+                }
+            }
+        }
+
+        return res;
+    }
+
     std::vector<RowType>& getTiles() { return _tilesArray; }
 
+    /**
+     * @brief Number of tiles of the image
+     */
+    int getTilesCount() const { return _tilesArray.empty() ? 0 : int(_tilesArray.size() * _tilesArray[0].size()); }
+
+    /**
+     * @brief Get a tile from its index in the row major order of the tiles
+     */
+    image::CachedTile::smart_pointer getTile(int id) const
+    {
+        const int countWidth = int(_tilesArray[0].size());
+        return _tilesArray[id / countWidth][id % countWidth];
+    }
+
     int getWidth() const { return _width; }
 
     int getHeight() const { return _height; }
@@ -83,6 +83,53 @@ bool CoordinatesMap::build(const std::pair<int, int>& panoramaSize,
     return true;
 }
 
+bool CoordinatesMap::set(const aliceVision::image::Image<Eigen::Vector2f>& coordinates,
+                         const aliceVision::image::Image<unsigned char>& mask,
+                         size_t offsetX,
+                         size_t offsetY)
+{
+    if (coordinates.width() != mask.width() || coordinates.height() != mask.height())
+    {
+        return false;
+    }
+
+    _coordinates = coordinates;
+    _mask = mask;
+    _offset_x = offsetX;
+    _offset_y = offsetY;
+
+    int max_x = 0;
+    int max_y = 0;
+    int min_x = std::numeric_limits<int>::max();
+    int min_y = std::numeric_limits<int>::max();
+
+    for (int y = 0; y < _mask.height(); y++)
+    {
+        for (int x = 0; x < _mask.width(); x++)
+        {
+            if (!_mask(y, x))
+            {
+                continue;
+            }
+
+            const int cx = x + int(offsetX);
+            const int cy = y + int(offsetY);
+
+            min_x = std::min(cx, min_x);
+            min_y = std::min(cy, min_y);
+            max_x = std::max(cx, max_x);
+            max_y = std::max(cy, max_y);
+        }
+    }
+
+    _boundingBox.left = min_x;
+    _boundingBox.top = min_y;
+    _boundingBox.width = std::max(0, max_x - min_x + 1);
+    _boundingBox.height = std::max(0, max_y - min_y + 1);
+
+    return true;
+}
+
 bool CoordinatesMap::computeScale(double& result, float ratioUpscale)
 {
     std::vector<double> scales;
@@ -27,6 +27,18 @@ class CoordinatesMap
                const aliceVision::camera::IntrinsicBase& intrinsics,
                const BoundingBox& coarseBbox);
 
+    /**
+     * Set a coordinates map computed beforehand (e.g. loaded from a cache)
+     * @param coordinates the source image coordinates of each pixel
+     * @param mask the validity of each pixel
+     * @param offsetX the position of the map in the panorama
+     * @param offsetY the position of the map in the panorama
+     */
+    bool set(const aliceVision::image::Image<Eigen::Vector2f>& coordinates,
+             const aliceVision::image::Image<unsigned char>& mask,
+             size_t offsetX,
+             size_t offsetY);
+
     bool computeScale(double& result, float ratioUpscale);
 
     size_t getOffsetX() const { return _offset_x; }
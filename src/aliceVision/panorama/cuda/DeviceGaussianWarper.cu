@@ -0,0 +1,320 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "DeviceGaussianWarper.hpp"
+
+#include <cuda_runtime.h>
+
+#include <sstream>
+#include <stdexcept>
+
+#define CHECK_PANORAMA_CUDA_ERROR(err)                                                                                                               \
+    if (err != cudaSuccess)                                                                                                                          \
+    {                                                                                                                                                \
+        std::stringstream s;                                                                                                                         \
+        s << "\n  CUDA Error: " << cudaGetErrorString(err) << "\n  file:  " << __FILE__ << "\n  function:   " << __FUNCTION__                        \
+          << "\n  line:       " << __LINE__ << "\n";                                                                                                 \
+        throw std::runtime_error(s.str());                                                                                                           \
+    }
+
+namespace aliceVision {
+namespace panorama {
+namespace cuda {
+
+/// Number of threads per block, one thread per tile pixel
+constexpr int BLOCK_SIZE = 256;
+
+/// Largest finite half float value (HALF_MAX)
+constexpr float HALF_MAX_VALUE = 65504.0f;
+
+/**
+ * @brief Levels of the source pyramid, passed by value to the kernel.
+ */
+struct PyramidLevels
+{
+    const float* data[DeviceGaussianWarper::maxLevels];
+    int width[DeviceGaussianWarper::maxLevels];
+    int height[DeviceGaussianWarper::maxLevels];
+    int count;
+};
+
+/**
+ * @brief Bilinear sampling of an RGB image, same as image::Sampler2d<image::SamplerLinear>.
+ */
+__device__ inline float3 sampleLinear(const float* image, int width, int height, float y, float x)
+{
+    const float fx = floorf(x);
+    const float fy = floorf(y);
+    const float dx = x - fx;
+    const float dy = y - fy;
+    const int gridX = int(fx);
+    const int gridY = int(fy);
+
+    const float coefsX[2] = {1.0f - dx, dx};
+    const float coefsY[2] = {1.0f - dy, dy};
+
+    float3 res = make_float3(0.0f, 0.0f, 0.0f);
+    float totalWeight = 0.0f;
+
+    for (int i = 0; i < 2; ++i)
+    {
+        const int row = gridY + i;
+        if (row < 0 || row >= height)
+            continue;
+
+        for (int j = 0; j < 2; ++j)
+        {
+            const int col = gridX + j;
+            if (col < 0 || col >= width)
+                continue;
+
+            const float w = coefsX[j] * coefsY[i];
+            const float* pix = image + 3 * (std::size_t(row) * width + col);
+            res.x += w * pix[0];
+            res.y += w * pix[1];
+            res.z += w * pix[2];
+            totalWeight += w;
+        }
+    }
+
+    // too small weight means unstable sample, return the nearest pixel
+    if (totalWeight <= 0.2f)
+    {
+        const int row = min(max(gridY, 0), height - 1);
+        const int col = min(max(gridX, 0), width - 1);
+        const float* pix = image + 3 * (std::size_t(row) * width + col);
+        return make_float3(pix[0], pix[1], pix[2]);
+    }
+
+    if (totalWeight != 1.0f)
+    {
+        res.x /= totalWeight;
+        res.y /= totalWeight;
+        res.z /= totalWeight;
+    }
+
+    return res;
+}
+
+/**
+ * @brief Multi level warp of a batch of tiles, one thread per tile pixel.
+ *        Same computation as GaussianWarper::warp and distanceToCenter.
+ */
+__global__ void gaussianWarp_kernel(PyramidLevels pyramid,
+                                    const float2* coordinates,
+                                    const unsigned char* masks,
+                                    int nbTiles,
+                                    int tileWidth,
+                                    int tileHeight,
+                                    bool clamp,
+                                    float cx,
+                                    float cy,
+                                    float* out_colors,
+                                    float* out_weights)
+{
+    const std::size_t tilePixels = std::size_t(tileWidth) * tileHeight;
+    const std::size_t id = std::size_t(blockIdx.x) * blockDim.x + threadIdx.x;
+    if (id >= tilePixels * nbTiles)
+        return;
+
+    const std::size_t tileOffset = (id / tilePixels) * tilePixels;
+    const int p = int(id - tileOffset);
+    const int i = p / tileWidth;
+    const int j = p % tileWidth;
+
+    const float2* tileCoordinates = coordinates + tileOffset;
+    const unsigned char* tileMask = masks + tileOffset;
+    float* color = out_colors + 3 * id;
+
+    if (!tileMask[p])
+    {
+        // same background as the CPU warper
+        color[0] = 1.0f;
+        color[1] = 0.0f;
+        color[2] = 0.0f;
+        out_weights[id] = 0.0f;
+        return;
+    }
+
+    const float2 coord_mm = tileCoordinates[p];
+
+    // weights
+    const float wx = 1.0f - fabsf((coord_mm.x - cx) / cx);
+    const float wy = 1.0f - fabsf((coord_mm.y - cy) / cy);
+    out_weights[id] = wx * wy;
+
+    // color
+    const int next_i = (i == tileHeight - 1) ? i - 1 : i + 1;
+    const int next_j = (j == tileWidth - 1) ? j - 1 : j + 1;
+
+    float3 pixel;
+    if (!tileMask[next_i * tileWidth + j] || !tileMask[i * tileWidth + next_j])
+    {
+        pixel = sampleLinear(pyramid.data[0], pyramid.width[0], pyramid.height[0], coord_mm.y, coord_mm.x);
+    }
+    else
+    {
+        const float2 coord_mp = tileCoordinates[i * tileWidth + next_j];
+        const float2 coord_pm = tileCoordinates[next_i * tileWidth + j];
+
+        const float dxx = coord_pm.x - coord_mm.x;
+        const float dxy = coord_mp.x - coord_mm.x;
+        const float dyx = coord_pm.y - coord_mm.y;
+        const float dyy = coord_mp.y - coord_mm.y;
+        const float scale = fabsf(dxx * dyy - dxy * dyx);
+
+        const float flevel = fmaxf(0.0f, 0.5f * log2f(scale));
+        const int blevel = min(pyramid.count - 1, int(floorf(flevel)));
+
+        const float dscale = exp2f(-float(blevel));
+        const float x = coord_mm.x * dscale;
+        const float y = coord_mm.y * dscale;
+
+        if (x >= pyramid.width[blevel] - 1 || y >= pyramid.height[blevel] - 1)
+        {
+            // fallback to the first level if outside
+            pixel = sampleLinear(pyramid.data[0], pyramid.width[0], pyramid.height[0], coord_mm.y, coord_mm.x);
+        }
+        else
+        {
+            pixel = sampleLinear(pyramid.data[blevel], pyramid.width[blevel], pyramid.height[blevel], y, x);
+
+            if (clamp)
+            {
+                pixel.x = fminf(pixel.x, HALF_MAX_VALUE);
+                pixel.y = fminf(pixel.y, HALF_MAX_VALUE);
+                pixel.z = fminf(pixel.z, HALF_MAX_VALUE);
+            }
+        }
+    }
+
+    color[0] = pixel.x;
+    color[1] = pixel.y;
+    color[2] = pixel.z;
+}
+
+DeviceGaussianWarper::~DeviceGaussianWarper()
+{
+    // no throw in destructor
+    cudaFree(_pyramid);
+    cudaFree(_coordinates);
+    cudaFree(_masks);
+    cudaFree(_colors);
+    cudaFree(_weights);
+}
+
+void DeviceGaussianWarper::setPyramid(const std::vector<const float*>& levels, const std::vector<int>& widths, const std::vector<int>& heights)
+{
+    if (levels.empty() || levels.size() > maxLevels || levels.size() != widths.size() || levels.size() != heights.size())
+    {
+        throw std::invalid_argument("DeviceGaussianWarper: invalid source pyramid.");
+    }
+
+    _levelsOffset.clear();
+    _levelsWidth = widths;
+    _levelsHeight = heights;
+
+    std::size_t size = 0;
+    for (std::size_t l = 0; l < levels.size(); ++l)
+    {
+        _levelsOffset.push_back(size);
+        size += std::size_t(widths[l]) * heights[l] * 3;
+    }
+
+    if (size > _pyramidCapacity)
+    {
+        CHECK_PANORAMA_CUDA_ERROR(cudaFree(_pyramid));
+        _pyramid = nullptr;
+        CHECK_PANORAMA_CUDA_ERROR(cudaMalloc(&_pyramid, size * sizeof(float)));
+        _pyramidCapacity = size;
+    }
+
+    for (std::size_t l = 0; l < levels.size(); ++l)
+    {
+        const std::size_t bytes = std::size_t(widths[l]) * heights[l] * 3 * sizeof(float);
+        CHECK_PANORAMA_CUDA_ERROR(cudaMemcpy(_pyramid + _levelsOffset[l], levels[l], bytes, cudaMemcpyHostToDevice));
+    }
+}
+
+void DeviceGaussianWarper::allocateTiles(std::size_t nbPixels)
+{
+    if (nbPixels <= _tilesCapacity)
+        return;
+
+    CHECK_PANORAMA_CUDA_ERROR(cudaFree(_coordinates));
+    CHECK_PANORAMA_CUDA_ERROR(cudaFree(_masks));
+    CHECK_PANORAMA_CUDA_ERROR(cudaFree(_colors));
+    CHECK_PANORAMA_CUDA_ERROR(cudaFree(_weights));
+    _coordinates = nullptr;
+    _masks = nullptr;
+    _colors = nullptr;
+    _weights = nullptr;
+
+    _tilesCapacity = nbPixels;
+
+    CHECK_PANORAMA_CUDA_ERROR(cudaMalloc(&_coordinates, _tilesCapacity * 2 * sizeof(float)));
+    CHECK_PANORAMA_CUDA_ERROR(cudaMalloc(&_masks, _tilesCapacity * sizeof(unsigned char)));
+    CHECK_PANORAMA_CUDA_ERROR(cudaMalloc(&_colors, _tilesCapacity * 3 * sizeof(float)));
+    CHECK_PANORAMA_CUDA_ERROR(cudaMalloc(&_weights, _tilesCapacity * sizeof(float)));
+}
+
+void DeviceGaussianWarper::warp(const float* coordinates,
+                                const unsigned char* masks,
+                                int nbTiles,
+                                int tileWidth,
+                                int tileHeight,
+                                bool clamp,
+                                int sourceWidth,
+                                int sourceHeight,
+                                float* colors,
+                                float* weights)
+{
+    if (_levelsOffset.empty())
+    {
+        throw std::logic_error("DeviceGaussianWarper: the source pyramid is not set.");
+    }
+
+    const std::size_t nbPixels = std::size_t(nbTiles) * tileWidth * tileHeight;
+    if (nbPixels == 0)
+        return;
+
+    allocateTiles(nbPixels);
+
+    CHECK_PANORAMA_CUDA_ERROR(cudaMemcpy(_coordinates, coordinates, nbPixels * 2 * sizeof(float), cudaMemcpyHostToDevice));
+    CHECK_PANORAMA_CUDA_ERROR(cudaMemcpy(_masks, masks, nbPixels * sizeof(unsigned char), cudaMemcpyHostToDevice));
+
+    PyramidLevels pyramid;
+    pyramid.count = int(_levelsOffset.size());
+    for (int l = 0; l < pyramid.count; ++l)
+    {
+        pyramid.data[l] = _pyramid + _levelsOffset[l];
+        pyramid.width[l] = _levelsWidth[l];
+        pyramid.height[l] = _levelsHeight[l];
+    }
+
+    const int nbBlocks = int((nbPixels + BLOCK_SIZE - 1) / BLOCK_SIZE);
+
+    gaussianWarp_kernel<<<nbBlocks, BLOCK_SIZE>>>(pyramid,
+                                                  reinterpret_cast<const float2*>(_coordinates),
+                                                  _masks,
+                                                  nbTiles,
+                                                  tileWidth,
+                                                  tileHeight,
+                                                  clamp,
+                                                  sourceWidth / 2.0f,
+                                                  sourceHeight / 2.0f,
+                                                  _colors,
+                                                  _weights);
+
+    CHECK_PANORAMA_CUDA_ERROR(cudaGetLastError());
+
+    CHECK_PANORAMA_CUDA_ERROR(cudaMemcpy(colors, _colors, nbPixels * 3 * sizeof(float), cudaMemcpyDeviceToHost));
+    CHECK_PANORAMA_CUDA_ERROR(cudaMemcpy(weights, _weights, nbPixels * sizeof(float), cudaMemcpyDeviceToHost));
+}
+
+}  // namespace cuda
+}  // namespace panorama
+}  // namespace aliceVision
@@ -0,0 +1,93 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace aliceVision {
+namespace panorama {
+namespace cuda {
+
+/**
+ * @class DeviceGaussianWarper
+ * @brief Warp tiles of a source image in the panorama on the GPU, as GaussianWarper and distanceToCenter do on the CPU.
+ *
+ * The Gaussian pyramid of the source image is uploaded once and stays resident on the device,
+ * then batches of tiles are warped in a single launch from their coordinates maps.
+ * Each tile is processed independently, exactly as a GaussianWarper on the corresponding CoordinatesMap.
+ */
+class DeviceGaussianWarper
+{
+  public:
+    /// Maximal number of levels of the source pyramid
+    static constexpr int maxLevels = 32;
+
+    DeviceGaussianWarper() = default;
+    ~DeviceGaussianWarper();
+
+    // no copy
+    DeviceGaussianWarper(const DeviceGaussianWarper&) = delete;
+    DeviceGaussianWarper& operator=(const DeviceGaussianWarper&) = delete;
+
+    /**
+     * @brief Upload the Gaussian pyramid of the source image to the device.
+     * @param[in] levels The host levels, RGB float interleaved, row major (finest level first)
+     * @param[in] widths The width of each level
+     * @param[in] heights The height of each level
+     */
+    void setPyramid(const std::vector<const float*>& levels, const std::vector<int>& widths, const std::vector<int>& heights);
+
+    /**
+     * @brief Warp a batch of tiles of the same size.
+     * @param[in] coordinates The host source coordinates of the tiles pixels (x, y), nbTiles * tileWidth * tileHeight * 2
+     * @param[in] masks The host validity masks of the tiles pixels, nbTiles * tileWidth * tileHeight
+     * @param[in] nbTiles The number of tiles
+     * @param[in] tileWidth The width of the tiles
+     * @param[in] tileHeight The height of the tiles
+     * @param[in] clamp Clamp the warped colors to the half float range
+     * @param[in] sourceWidth The full resolution source width, used for the weights
+     * @param[in] sourceHeight The full resolution source height, used for the weights
+     * @param[out] colors The host warped colors, RGB float interleaved, nbTiles * tileWidth * tileHeight * 3
+     * @param[out] weights The host weights (distance to the source center), nbTiles * tileWidth * tileHeight
+     */
+    void warp(const float* coordinates,
+              const unsigned char* masks,
+              int nbTiles,
+              int tileWidth,
+              int tileHeight,
+              bool clamp,
+              int sourceWidth,
+              int sourceHeight,
+              float* colors,
+              float* weights);
+
+  private:
+    /**
+     * @brief Ensure that the device tiles buffers can hold the given number of pixels.
+     * @param[in] nbPixels The number of pixels of the batch
+     */
+    void allocateTiles(std::size_t nbPixels);
+
+    // pyramid, all the levels in a single buffer
+    float* _pyramid = nullptr;
+    std::size_t _pyramidCapacity = 0;  //< in number of floats
+    std::vector<std::size_t> _levelsOffset;
+    std::vector<int> _levelsWidth;
+    std::vector<int> _levelsHeight;
+
+    // tiles buffers, reused between calls
+    float* _coordinates = nullptr;
+    unsigned char* _masks = nullptr;
+    float* _colors = nullptr;
+    float* _weights = nullptr;
+    std::size_t _tilesCapacity = 0;  //< in number of pixels
+};
+
+}  // namespace cuda
+}  // namespace panorama
+}  // namespace aliceVision
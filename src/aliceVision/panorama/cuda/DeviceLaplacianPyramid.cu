@@ -0,0 +1,406 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "DeviceLaplacianPyramid.hpp"
+
+#include <cuda_runtime.h>
+
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+#define CHECK_PANORAMA_CUDA_ERROR(err)                                                                                                               \
+    if (err != cudaSuccess)                                                                                                                          \
+    {                                                                                                                                                \
+        std::stringstream s;                                                                                                                         \
+        s << "\n  CUDA Error: " << cudaGetErrorString(err) << "\n  file:  " << __FILE__ << "\n  function:   " << __FUNCTION__                        \
+          << "\n  line:       " << __LINE__ << "\n";                                                                                                 \
+        throw std::runtime_error(s.str());                                                                                                           \
+    }
+
+namespace aliceVision {
+namespace panorama {
+namespace cuda {
+
+/// Size of the 2D thread blocks, one thread per pixel
+constexpr int BLOCK_DIM = 16;
+
+/**
+ * @brief Mirror an index in [0, size[ (5432 | 123456 | 5432), same as gaussianBorderIndex.
+ */
+__device__ inline int mirrorIndex(int index, int size)
+{
+    if (index < 0)
+        index = -index;
+    if (index >= size)
+        index = size - 1 - (index + 1 - size);
+    return min(max(index, 0), size - 1);
+}
+
+/**
+ * @brief Horizontal pass of the 5x5 gaussian filter ([1 4 6 4 1] / 16), mirrored borders.
+ */
+template<int C>
+__global__ void gaussianRows_kernel(const float* input, float* output, int width, int height)
+{
+    const int x = blockIdx.x * blockDim.x + threadIdx.x;
+    const int y = blockIdx.y * blockDim.y + threadIdx.y;
+    if (x >= width || y >= height)
+        return;
+
+    const float kernel[5] = {1.0f / 16.0f, 4.0f / 16.0f, 6.0f / 16.0f, 4.0f / 16.0f, 1.0f / 16.0f};
+    const float* row = input + std::size_t(y) * width * C;
+
+    for (int c = 0; c < C; ++c)
+    {
+        float sum = 0.0f;
+        for (int k = 0; k < 5; ++k)
+            sum += kernel[k] * row[mirrorIndex(x + k - 2, width) * C + c];
+        output[(std::size_t(y) * width + x) * C + c] = sum;
+    }
+}
+
+/**
+ * @brief Vertical pass of the 5x5 gaussian filter ([1 4 6 4 1] / 16), mirrored borders.
+ */
+template<int C>
+__global__ void gaussianColumns_kernel(const float* input, float* output, int width, int height)
+{
+    const int x = blockIdx.x * blockDim.x + threadIdx.x;
+    const int y = blockIdx.y * blockDim.y + threadIdx.y;
+    if (x >= width || y >= height)
+        return;
+
+    const float kernel[5] = {1.0f / 16.0f, 4.0f / 16.0f, 6.0f / 16.0f, 4.0f / 16.0f, 1.0f / 16.0f};
+
+    for (int c = 0; c < C; ++c)
+    {
+        float sum = 0.0f;
+        for (int k = 0; k < 5; ++k)
+            sum += kernel[k] * input[(std::size_t(mirrorIndex(y + k - 2, height)) * width + x) * C + c];
+        output[(std::size_t(y) * width + x) * C + c] = sum;
+    }
+}
+
+/**
+ * @brief Apply the mask to the colors (out_masked) and to the weights (in place).
+ */
+__global__ void applyMask_kernel(const float* color, const float* mask, float* weights, float* out_masked, int width, int height)
+{
+    const int x = blockIdx.x * blockDim.x + threadIdx.x;
+    const int y = blockIdx.y * blockDim.y + threadIdx.y;
+    if (x >= width || y >= height)
+        return;
+
+    const std::size_t id = std::size_t(y) * width + x;
+    const bool valid = fabsf(mask[id]) > 1e-6f;
+    for (int c = 0; c < 3; ++c)
+        out_masked[3 * id + c] = valid ? color[3 * id + c] : 0.0f;
+    if (!valid)
+        weights[id] = 0.0f;
+}
+
+/**
+ * @brief Normalize the filtered colors by the filtered mask, and binarize the mask.
+ */
+__global__ void normalize_kernel(float* color, float* mask, int width, int height)
+{
+    const int x = blockIdx.x * blockDim.x + threadIdx.x;
+    const int y = blockIdx.y * blockDim.y + threadIdx.y;
+    if (x >= width || y >= height)
+        return;
+
+    const std::size_t id = std::size_t(y) * width + x;
+    const float m = mask[id];
+    const bool valid = fabsf(m) > 1e-6f;
+    for (int c = 0; c < 3; ++c)
+        color[3 * id + c] = valid ? color[3 * id + c] / m : 0.0f;
+    mask[id] = valid ? 1.0f : 0.0f;
+}
+
+/**
+ * @brief Keep one pixel out of two in both directions, same as downscale.
+ */
+template<int C>
+__global__ void downscale_kernel(const float* input, float* output, int inputWidth, int width, int height)
+{
+    const int x = blockIdx.x * blockDim.x + threadIdx.x;
+    const int y = blockIdx.y * blockDim.y + threadIdx.y;
+    if (x >= width || y >= height)
+        return;
+
+    for (int c = 0; c < C; ++c)
+        output[(std::size_t(y) * width + x) * C + c] = input[(std::size_t(2 * y) * inputWidth + 2 * x) * C + c];
+}
+
+/**
+ * @brief Upscale by filling with zeros, in place, same as upscale:
+ *        the pixels after the last even row or column of the input are not modified.
+ */
+__global__ void upscale_kernel(const float* input, float* inout, int inputWidth, int inputHeight, int width, int height)
+{
+    const int x = blockIdx.x * blockDim.x + threadIdx.x;
+    const int y = blockIdx.y * blockDim.y + threadIdx.y;
+    if (x >= width || y >= height)
+        return;
+    if ((x / 2) >= inputWidth || (y / 2) >= inputHeight)
+        return;
+
+    const bool even = ((x % 2) == 0) && ((y % 2) == 0);
+    const std::size_t id = std::size_t(y) * width + x;
+    const std::size_t inputId = std::size_t(y / 2) * inputWidth + (x / 2);
+    for (int c = 0; c < 3; ++c)
+        inout[3 * id + c] = even ? input[3 * inputId + c] : 0.0f;
+}
+
+/**
+ * @brief Keep the band pass: color - 4 * filtered upscaled color (the upscale filled with zeros).
+ */
+__global__ void bandPass_kernel(float* color, const float* filtered, int width, int height)
+{
+    const int x = blockIdx.x * blockDim.x + threadIdx.x;
+    const int y = blockIdx.y * blockDim.y + threadIdx.y;
+    if (x >= width || y >= height)
+        return;
+
+    const std::size_t id = std::size_t(y) * width + x;
+    for (int c = 0; c < 3; ++c)
+        color[3 * id + c] = color[3 * id + c] - 4.0f * filtered[3 * id + c];
+}
+
+/**
+ * @brief Accumulate the weighted colors and the weights of an input level in a band, same as LaplacianPyramid::merge.
+ */
+__global__ void merge_kernel(const float* color,
+                             const float* weights,
+                             int width,
+                             int height,
+                             int offsetX,
+                             int offsetY,
+                             float* bandColor,
+                             float* bandWeight,
+                             int bandWidth,
+                             int bandHeight)
+{
+    const int j = blockIdx.x * blockDim.x + threadIdx.x;
+    const int i = blockIdx.y * blockDim.y + threadIdx.y;
+    if (j >= width || i >= height)
+        return;
+
+    const int x = j + offsetX;
+    const int y = i + offsetY;
+    if (x < 0 || x >= bandWidth || y < 0 || y >= bandHeight)
+        return;
+
+    const std::size_t id = std::size_t(i) * width + j;
+    const std::size_t bandId = std::size_t(y) * bandWidth + x;
+    const float w = weights[id];
+    for (int c = 0; c < 3; ++c)
+        bandColor[3 * bandId + c] += color[3 * id + c] * w;
+    bandWeight[bandId] += w;
+}
+
+namespace {
+
+dim3 getGrid(int width, int height) { return dim3((width + BLOCK_DIM - 1) / BLOCK_DIM, (height + BLOCK_DIM - 1) / BLOCK_DIM); }
+
+/**
+ * @brief 5x5 gaussian filter, the output can be the input.
+ */
+template<int C>
+void gaussian(const float* input, float* output, float* buffer, int width, int height)
+{
+    const dim3 block(BLOCK_DIM, BLOCK_DIM);
+    const dim3 grid = getGrid(width, height);
+    gaussianRows_kernel<C><<<grid, block>>>(input, buffer, width, height);
+    gaussianColumns_kernel<C><<<grid, block>>>(buffer, output, width, height);
+}
+
+}  // namespace
+
+DeviceLaplacianPyramid::DeviceLaplacianPyramid(int baseWidth, int baseHeight, int nbLevels)
+{
+    int width = baseWidth;
+    int height = baseHeight;
+
+    // same sizes as the CPU pyramid
+    for (int l = 0; l < nbLevels; ++l)
+    {
+        const std::size_t nbPixels = std::size_t(width) * height;
+
+        float* color = nullptr;
+        float* weight = nullptr;
+        CHECK_PANORAMA_CUDA_ERROR(cudaMalloc(&color, nbPixels * 3 * sizeof(float)));
+        _levelsColor.push_back(color);
+        CHECK_PANORAMA_CUDA_ERROR(cudaMalloc(&weight, nbPixels * sizeof(float)));
+        _levelsWeight.push_back(weight);
+        CHECK_PANORAMA_CUDA_ERROR(cudaMemset(color, 0, nbPixels * 3 * sizeof(float)));
+        CHECK_PANORAMA_CUDA_ERROR(cudaMemset(weight, 0, nbPixels * sizeof(float)));
+
+        _levelsWidth.push_back(width);
+        _levelsHeight.push_back(height);
+
+        width = (width + 1) / 2;
+        height = (height + 1) / 2;
+    }
+}
+
+DeviceLaplacianPyramid::~DeviceLaplacianPyramid()
+{
+    // no throw in destructor
+    for (float* color : _levelsColor)
+        cudaFree(color);
+    for (float* weight : _levelsWeight)
+        cudaFree(weight);
+
+    for (float* buffer : {_color, _mask, _weights, _nextColor, _nextMask, _nextWeights, _bufColor, _bufColor2, _bufFloat, _bufFloat2})
+        cudaFree(buffer);
+}
+
+void DeviceLaplacianPyramid::allocateInputs(std::size_t nbPixels)
+{
+    if (nbPixels <= _inputsCapacity)
+        return;
+
+    for (float** buffer : {&_color, &_mask, &_weights, &_nextColor, &_nextMask, &_nextWeights, &_bufColor, &_bufColor2, &_bufFloat, &_bufFloat2})
+    {
+        CHECK_PANORAMA_CUDA_ERROR(cudaFree(*buffer));
+        *buffer = nullptr;
+    }
+
+    _inputsCapacity = nbPixels;
+
+    for (float** buffer : {&_color, &_nextColor, &_bufColor, &_bufColor2})
+        CHECK_PANORAMA_CUDA_ERROR(cudaMalloc(buffer, _inputsCapacity * 3 * sizeof(float)));
+    for (float** buffer : {&_mask, &_weights, &_nextMask, &_nextWeights, &_bufFloat, &_bufFloat2})
+        CHECK_PANORAMA_CUDA_ERROR(cudaMalloc(buffer, _inputsCapacity * sizeof(float)));
+}
+
+void DeviceLaplacianPyramid::apply(const float* color,
+                                   const float* mask,
+                                   const float* weights,
+                                   int contentWidth,
+                                   int contentHeight,
+                                   int contentLeft,
+                                   int contentTop,
+                                   int width,
+                                   int height,
+                                   int offsetX,
+                                   int offsetY)
+{
+    if (contentLeft < 0 || contentTop < 0 || contentLeft + contentWidth > width || contentTop + contentHeight > height)
+    {
+        throw std::invalid_argument("DeviceLaplacianPyramid: the input is not inside its output bounding box.");
+    }
+
+    const std::size_t nbPixels = std::size_t(width) * height;
+    if (nbPixels == 0)
+        return;
+
+    allocateInputs(nbPixels);
+
+    // upload the input in its (zero padded) output bounding box
+    CHECK_PANORAMA_CUDA_ERROR(cudaMemset(_color, 0, nbPixels * 3 * sizeof(float)));
+    CHECK_PANORAMA_CUDA_ERROR(cudaMemset(_mask, 0, nbPixels * sizeof(float)));
+    CHECK_PANORAMA_CUDA_ERROR(cudaMemset(_weights, 0, nbPixels * sizeof(float)));
+
+    const std::size_t contentOffset = std::size_t(contentTop) * width + contentLeft;
+    CHECK_PANORAMA_CUDA_ERROR(cudaMemcpy2D(_color + 3 * contentOffset,
+                                           width * 3 * sizeof(float),
+                                           color,
+                                           contentWidth * 3 * sizeof(float),
+                                           contentWidth * 3 * sizeof(float),
+                                           contentHeight,
+                                           cudaMemcpyHostToDevice));
+    CHECK_PANORAMA_CUDA_ERROR(cudaMemcpy2D(
+      _mask + contentOffset, width * sizeof(float), mask, contentWidth * sizeof(float), contentWidth * sizeof(float), contentHeight, cudaMemcpyHostToDevice));
+    CHECK_PANORAMA_CUDA_ERROR(cudaMemcpy2D(_weights + contentOffset,
+                                           width * sizeof(float),
+                                           weights,
+                                           contentWidth * sizeof(float),
+                                           contentWidth * sizeof(float),
+                                           contentHeight,
+                                           cudaMemcpyHostToDevice));
+
+    const dim3 block(BLOCK_DIM, BLOCK_DIM);
+    const int nbLevels = int(_levelsColor.size());
+
+    for (int l = 0; l < nbLevels - 1; ++l)
+    {
+        const dim3 grid = getGrid(width, height);
+        const int nextWidth = width / 2;
+        const int nextHeight = height / 2;
+        const dim3 nextGrid = getGrid(nextWidth, nextHeight);
+
+        // filter the masked colors and the mask, normalized by the filtered mask
+        applyMask_kernel<<<grid, block>>>(_color, _mask, _weights, _bufColor, width, height);
+        gaussian<3>(_bufColor, _bufColor, _bufColor2, width, height);
+        gaussian<1>(_mask, _mask, _bufFloat2, width, height);
+        normalize_kernel<<<grid, block>>>(_bufColor, _mask, width, height);
+
+        // next level
+        if (nextWidth > 0 && nextHeight > 0)
+        {
+            downscale_kernel<3><<<nextGrid, block>>>(_bufColor, _nextColor, width, nextWidth, nextHeight);
+            downscale_kernel<1><<<nextGrid, block>>>(_mask, _nextMask, width, nextWidth, nextHeight);
+        }
+
+        // band pass
+        upscale_kernel<<<grid, block>>>(_nextColor, _bufColor, nextWidth, nextHeight, width, height);
+        gaussian<3>(_bufColor, _bufColor, _bufColor2, width, height);
+        bandPass_kernel<<<grid, block>>>(_color, _bufColor, width, height);
+
+        // next level weights
+        gaussian<1>(_weights, _bufFloat, _bufFloat2, width, height);
+        if (nextWidth > 0 && nextHeight > 0)
+        {
+            downscale_kernel<1><<<nextGrid, block>>>(_bufFloat, _nextWeights, width, nextWidth, nextHeight);
+        }
+
+        // accumulate the band
+        merge_kernel<<<grid, block>>>(
+          _color, _weights, width, height, offsetX, offsetY, _levelsColor[l], _levelsWeight[l], _levelsWidth[l], _levelsHeight[l]);
+        CHECK_PANORAMA_CUDA_ERROR(cudaGetLastError());
+
+        std::swap(_color, _nextColor);
+        std::swap(_mask, _nextMask);
+        std::swap(_weights, _nextWeights);
+        width = nextWidth;
+        height = nextHeight;
+
+        // the offset is a power of two for the required levels
+        offsetX = offsetX / 2;
+        offsetY = offsetY / 2;
+    }
+
+    // last level: the low pass colors
+    if (width > 0 && height > 0)
+    {
+        merge_kernel<<<getGrid(width, height), block>>>(_color,
+                                                        _weights,
+                                                        width,
+                                                        height,
+                                                        offsetX,
+                                                        offsetY,
+                                                        _levelsColor[nbLevels - 1],
+                                                        _levelsWeight[nbLevels - 1],
+                                                        _levelsWidth[nbLevels - 1],
+                                                        _levelsHeight[nbLevels - 1]);
+    }
+    CHECK_PANORAMA_CUDA_ERROR(cudaGetLastError());
+    CHECK_PANORAMA_CUDA_ERROR(cudaDeviceSynchronize());
+}
+
+void DeviceLaplacianPyramid::download(int level, float* colors, float* weights) const
+{
+    const std::size_t nbPixels = std::size_t(_levelsWidth[level]) * _levelsHeight[level];
+    CHECK_PANORAMA_CUDA_ERROR(cudaMemcpy(colors, _levelsColor[level], nbPixels * 3 * sizeof(float), cudaMemcpyDeviceToHost));
+    CHECK_PANORAMA_CUDA_ERROR(cudaMemcpy(weights, _levelsWeight[level], nbPixels * sizeof(float), cudaMemcpyDeviceToHost));
+}
+
+}  // namespace cuda
+}  // namespace panorama
+}  // namespace aliceVision
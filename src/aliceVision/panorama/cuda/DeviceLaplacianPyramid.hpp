@@ -0,0 +1,109 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace aliceVision {
+namespace panorama {
+namespace cuda {
+
+/**
+ * @class DeviceLaplacianPyramid
+ * @brief Laplacian pyramid of the panorama on the GPU, as LaplacianPyramid does on the CPU.
+ *
+ * The bands of the panorama (weighted sums of the colors and sums of the weights of each level) stay resident on the device.
+ * The pyramid of each (feathered) input is built on the device and accumulated in the bands,
+ * the bands are only streamed back to the host once all the inputs are appended, to be collapsed.
+ * The computations are the same as the CPU pyramid, the inputs last level is accumulated directly.
+ * The calls are not thread safe.
+ */
+class DeviceLaplacianPyramid
+{
+  public:
+    /**
+     * @brief Allocate the device bands.
+     * @param[in] baseWidth The width of the first level
+     * @param[in] baseHeight The height of the first level
+     * @param[in] nbLevels The number of levels
+     */
+    DeviceLaplacianPyramid(int baseWidth, int baseHeight, int nbLevels);
+
+    ~DeviceLaplacianPyramid();
+
+    // no copy
+    DeviceLaplacianPyramid(const DeviceLaplacianPyramid&) = delete;
+    DeviceLaplacianPyramid& operator=(const DeviceLaplacianPyramid&) = delete;
+
+    /**
+     * @brief Build the pyramid of an input and accumulate it in the bands.
+     * @param[in] color The host feathered input colors, RGB float interleaved, row major
+     * @param[in] mask The host input mask (0 or 1)
+     * @param[in] weights The host input weights
+     * @param[in] contentWidth The width of the input
+     * @param[in] contentHeight The height of the input
+     * @param[in] contentLeft The position of the input in its output bounding box
+     * @param[in] contentTop The position of the input in its output bounding box
+     * @param[in] width The width of the output bounding box (scaled to accept the pyramid scales)
+     * @param[in] height The height of the output bounding box
+     * @param[in] offsetX The position of the output bounding box in the first level
+     * @param[in] offsetY The position of the output bounding box in the first level
+     */
+    void apply(const float* color,
+               const float* mask,
+               const float* weights,
+               int contentWidth,
+               int contentHeight,
+               int contentLeft,
+               int contentTop,
+               int width,
+               int height,
+               int offsetX,
+               int offsetY);
+
+    /**
+     * @brief Copy a band to the host.
+     * @param[in] level The level
+     * @param[out] colors The weighted sums of the colors, RGB float interleaved, levelWidth * levelHeight * 3
+     * @param[out] weights The sums of the weights, levelWidth * levelHeight
+     */
+    void download(int level, float* colors, float* weights) const;
+
+    int getLevelWidth(int level) const { return _levelsWidth[level]; }
+    int getLevelHeight(int level) const { return _levelsHeight[level]; }
+
+  private:
+    /**
+     * @brief Ensure that the device input buffers can hold the given number of pixels.
+     * @param[in] nbPixels The number of pixels of the output bounding box
+     */
+    void allocateInputs(std::size_t nbPixels);
+
+    // bands
+    std::vector<int> _levelsWidth;
+    std::vector<int> _levelsHeight;
+    std::vector<float*> _levelsColor;
+    std::vector<float*> _levelsWeight;
+
+    // input buffers, reused between calls
+    float* _color = nullptr;
+    float* _mask = nullptr;
+    float* _weights = nullptr;
+    float* _nextColor = nullptr;
+    float* _nextMask = nullptr;
+    float* _nextWeights = nullptr;
+    float* _bufColor = nullptr;
+    float* _bufColor2 = nullptr;
+    float* _bufFloat = nullptr;
+    float* _bufFloat2 = nullptr;
+    std::size_t _inputsCapacity = 0;  //< in number of pixels
+};
+
+}  // namespace cuda
+}  // namespace panorama
+}  // namespace aliceVision
@@ -6,6 +6,9 @@
 
 #include "distance.hpp"
 
+#include <algorithm>
+#include <vector>
+
 namespace aliceVision {
 
 bool distanceToCenter(aliceVision::image::Image<float>& _weights, const CoordinatesMap& map, int width, int height)
@@ -16,8 +19,10 @@ bool distanceToCenter(aliceVision::image::Image<float>& _weights, const Coordina
     float cx = width / 2.0f;
     float cy = height / 2.0f;
 
-    _weights = aliceVision::image::Image<float>(coordinates.width(), coordinates.height());
+    // keep the buffer of the weights if it has the right size (reused buffer)
+    _weights.resize(coordinates.width(), coordinates.height(), false);
 
+#pragma omp parallel for
     for (int i = 0; i < _weights.height(); i++)
     {
         for (int j = 0; j < _weights.width(); j++)
@@ -50,6 +55,7 @@ static inline int f(int x_i, int gi) noexcept { return (x_i * x_i) + gi * gi; }
 static inline int sep(int i, int u, int gi, int gu, int) noexcept { return (u * u - i * i + gu * gu - gi * gi) / (2 * (u - i)); }
 
 /// Code adapted from VFLib: https://github.com/vinniefalco/VFLib (Licence MIT)
+/// The transform is separable: the columns pass and the rows pass are computed in parallel.
 bool computeDistanceMap(image::Image<int>& distance, const image::Image<unsigned char>& mask)
 {
     int width = mask.width();
@@ -58,69 +64,89 @@ bool computeDistanceMap(image::Image<int>& distance, const image::Image<unsigned
     int maxval = width + height;
     image::Image<int> buf(width, height);
 
-    /* Per column distance 1D calculation */
-    for (int j = 0; j < width; j++)
+    /* Per column distance 1D calculation, by blocks of columns to scan the rows contiguously */
+    const int blockWidth = 64;
+    const int countBlocks = (width + blockWidth - 1) / blockWidth;
+
+#pragma omp parallel for
+    for (int block = 0; block < countBlocks; block++)
     {
-        buf(0, j) = mask(0, j) ? 0 : maxval;
+        const int startj = block * blockWidth;
+        const int endj = std::min(width, startj + blockWidth);
+
+        for (int j = startj; j < endj; j++)
+        {
+            buf(0, j) = mask(0, j) ? 0 : maxval;
+        }
 
         /*Top to bottom accumulation */
         for (int i = 1; i < height; i++)
         {
-            buf(i, j) = mask(i, j) ? 0 : 1 + buf(i - 1, j);
+            for (int j = startj; j < endj; j++)
+            {
+                buf(i, j) = mask(i, j) ? 0 : 1 + buf(i - 1, j);
+            }
         }
 
         /*Bottom to top correction */
         for (int i = height - 2; i >= 0; i--)
         {
-            if (buf(i + 1, j) < buf(i, j))
+            for (int j = startj; j < endj; j++)
             {
-                buf(i, j) = 1 + buf(i + 1, j);
+                if (buf(i + 1, j) < buf(i, j))
+                {
+                    buf(i, j) = 1 + buf(i + 1, j);
+                }
             }
         }
     }
 
-    std::vector<int> s(std::max(width, height));
-    std::vector<int> t(std::max(width, height));
-
     /*Per row scan*/
-    for (int i = 0; i < height; i++)
+#pragma omp parallel
     {
-        int q = 0;
-        s[0] = 0;
-        t[0] = 0;
+        std::vector<int> s(std::max(width, height));
+        std::vector<int> t(std::max(width, height));
 
-        // scan 3
-        for (int j = 1; j < width; j++)
+#pragma omp for
+        for (int i = 0; i < height; i++)
         {
-            while (q >= 0 && f(t[q] - s[q], buf(i, s[q])) > f(t[q] - j, buf(i, j)))
-                q--;
+            int q = 0;
+            s[0] = 0;
+            t[0] = 0;
 
-            if (q < 0)
-            {
-                q = 0;
-                s[0] = j;
-            }
-            else
+            // scan 3
+            for (int j = 1; j < width; j++)
             {
-                int const w = 1 + sep(s[q], j, buf(i, s[q]), buf(i, j), maxval);
+                while (q >= 0 && f(t[q] - s[q], buf(i, s[q])) > f(t[q] - j, buf(i, j)))
+                    q--;
 
-                if (w < width)
+                if (q < 0)
+                {
+                    q = 0;
+                    s[0] = j;
+                }
+                else
                 {
-                    ++q;
-                    s[q] = j;
-                    t[q] = w;
+                    int const w = 1 + sep(s[q], j, buf(i, s[q]), buf(i, j), maxval);
+
+                    if (w < width)
+                    {
+                        ++q;
+                        s[q] = j;
+                        t[q] = w;
+                    }
                 }
             }
-        }
 
-        // scan 4
-        for (int j = width - 1; j >= 0; --j)
-        {
-            int const d = f(j - s[q], buf(i, s[q]));
+            // scan 4
+            for (int j = width - 1; j >= 0; --j)
+            {
+                int const d = f(j - s[q], buf(i, s[q]));
 
-            distance(i, j) = d;
-            if (j == t[q])
-                --q;
+                distance(i, j) = d;
+                if (j == t[q])
+                    --q;
+            }
         }
     }
 
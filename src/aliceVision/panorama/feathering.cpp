@@ -6,81 +6,138 @@
 
 #include "feathering.hpp"
 
+#include <atomic>
+
 namespace aliceVision {
 
-bool feathering(aliceVision::image::Image<image::RGBfColor>& output,
-                const aliceVision::image::Image<image::RGBfColor>& color,
-                const aliceVision::image::Image<unsigned char>& inputMask)
+/// images smaller than this (in pixels) are processed by a single thread
+static const int minPixelsPerParallelPass = 256 * 256;
+
+/**
+ * @brief Average the valid pixels of each 2x2 block of the input.
+ * @param[out] half The downscaled colors (of size input size / 2)
+ * @param[out] halfMask The downscaled mask, 1 if at least one pixel of the block is valid
+ * @param[in] src The input colors
+ * @param[in] srcMask The input mask
+ */
+static void downscaleMasked(image::Image<image::RGBfColor>& half,
+                            image::Image<unsigned char>& halfMask,
+                            const image::Image<image::RGBfColor>& src,
+                            const image::Image<unsigned char>& srcMask)
 {
-    std::vector<image::Image<image::RGBfColor>> feathering;
-    std::vector<image::Image<unsigned char>> feathering_mask;
-    feathering.push_back(color);
-    feathering_mask.push_back(inputMask);
-
-    int lvl = 0;
-    int width = color.width();
-    int height = color.height();
+    half.resize(src.width() / 2, src.height() / 2, false);
+    halfMask.resize(src.width() / 2, src.height() / 2, false);
 
-    while (!(width < 2 || height < 2))
+#pragma omp parallel for if (half.width() * half.height() > minPixelsPerParallelPass)
+    for (int i = 0; i < half.height(); i++)
     {
-        const image::Image<image::RGBfColor>& src = feathering[lvl];
-        const image::Image<unsigned char>& src_mask = feathering_mask[lvl];
+        int di = i * 2;
+        for (int j = 0; j < half.width(); j++)
+        {
+            int dj = j * 2;
 
-        image::Image<image::RGBfColor> half(width / 2, height / 2);
-        image::Image<unsigned char> half_mask(width / 2, height / 2);
+            int count = 0;
+            half(i, j) = image::RGBfColor(0.0, 0.0, 0.0);
 
-        for (int i = 0; i < half.height(); i++)
-        {
-            int di = i * 2;
-            for (int j = 0; j < half.width(); j++)
+            if (srcMask(di, dj))
             {
-                int dj = j * 2;
+                half(i, j) += src(di, dj);
+                count++;
+            }
 
-                int count = 0;
-                half(i, j) = image::RGBfColor(0.0, 0.0, 0.0);
+            if (srcMask(di, dj + 1))
+            {
+                half(i, j) += src(di, dj + 1);
+                count++;
+            }
 
-                if (src_mask(di, dj))
-                {
-                    half(i, j) += src(di, dj);
-                    count++;
-                }
+            if (srcMask(di + 1, dj))
+            {
+                half(i, j) += src(di + 1, dj);
+                count++;
+            }
 
-                if (src_mask(di, dj + 1))
-                {
-                    half(i, j) += src(di, dj + 1);
-                    count++;
-                }
+            if (srcMask(di + 1, dj + 1))
+            {
+                half(i, j) += src(di + 1, dj + 1);
+                count++;
+            }
 
-                if (src_mask(di + 1, dj))
-                {
-                    half(i, j) += src(di + 1, dj);
-                    count++;
-                }
+            if (count > 0)
+            {
+                half(i, j) /= float(count);
+                halfMask(i, j) = 1;
+            }
+            else
+            {
+                halfMask(i, j) = 0;
+            }
+        }
+    }
+}
 
-                if (src_mask(di + 1, dj + 1))
-                {
-                    half(i, j) += src(di + 1, dj + 1);
-                    count++;
-                }
+/**
+ * @brief Fill the masked pixels of a level with the pixels of the lower level.
+ * @param[in,out] src The level colors
+ * @param[in,out] srcMask The level mask
+ * @param[in] ref The lower level colors
+ * @param[in] refMask The lower level mask
+ */
+static void fillMasked(image::Image<image::RGBfColor>& src,
+                       image::Image<unsigned char>& srcMask,
+                       const image::Image<image::RGBfColor>& ref,
+                       const image::Image<unsigned char>& refMask)
+{
+#pragma omp parallel for if (src.width() * src.height() > minPixelsPerParallelPass)
+    for (int i = 0; i < srcMask.height(); i++)
+    {
+        for (int j = 0; j < srcMask.width(); j++)
+        {
+            if (!srcMask(i, j))
+            {
+                int mi = i / 2;
+                int mj = j / 2;
 
-                if (count > 0)
+                if (mi >= refMask.height())
                 {
-                    half(i, j) /= float(count);
-                    half_mask(i, j) = 1;
+                    mi = refMask.height() - 1;
                 }
-                else
+
+                if (mj >= refMask.width())
                 {
-                    half_mask(i, j) = 0;
+                    mj = refMask.width() - 1;
                 }
+
+                srcMask(i, j) = refMask(mi, mj);
+                src(i, j) = ref(mi, mj);
             }
         }
+    }
+}
+
+/**
+ * @brief Feather the first level of a pyramid.
+ * @param[in,out] feathering The pyramid colors, with only its first level
+ * @param[in,out] feathering_mask The pyramid masks, with only its first level
+ */
+static void featherPyramid(std::vector<image::Image<image::RGBfColor>>& feathering, std::vector<image::Image<unsigned char>>& feathering_mask)
+{
+    int lvl = 0;
+    int width = feathering[0].width();
+    int height = feathering[0].height();
 
-        feathering.push_back(half);
-        feathering_mask.push_back(half_mask);
+    while (!(width < 2 || height < 2))
+    {
+        image::Image<image::RGBfColor> half;
+        image::Image<unsigned char> half_mask;
+        downscaleMasked(half, half_mask, feathering[lvl], feathering_mask[lvl]);
 
         width = half.width();
         height = half.height();
 
+        feathering.push_back(std::move(half));
+        feathering_mask.push_back(std::move(half_mask));
+
         lvl++;
     }
 
@@ -128,38 +185,46 @@ bool feathering(aliceVision::image::Image<image::RGBfColor>& output,
     // The lower level.
     for (int lvl = feathering.size() - 2; lvl >= 0; lvl--)
     {
-        image::Image<image::RGBfColor>& src = feathering[lvl];
-        image::Image<unsigned char>& src_mask = feathering_mask[lvl];
-        image::Image<image::RGBfColor>& ref = feathering[lvl + 1];
-        image::Image<unsigned char>& ref_mask = feathering_mask[lvl + 1];
+        fillMasked(feathering[lvl], feathering_mask[lvl], feathering[lvl + 1], feathering_mask[lvl + 1]);
+    }
+}
 
-        for (int i = 0; i < src_mask.height(); i++)
-        {
-            for (int j = 0; j < src_mask.width(); j++)
-            {
-                if (!src_mask(i, j))
-                {
-                    int mi = i / 2;
-                    int mj = j / 2;
+bool feathering(aliceVision::image::Image<image::RGBfColor>& output,
+                const aliceVision::image::Image<image::RGBfColor>& color,
+                const aliceVision::image::Image<unsigned char>& inputMask)
+{
+    std::vector<image::Image<image::RGBfColor>> feathering;
+    std::vector<image::Image<unsigned char>> feathering_mask;
+    feathering.push_back(color);
+    feathering_mask.push_back(inputMask);
 
-                    if (mi >= ref_mask.height())
-                    {
-                        mi = ref_mask.height() - 1;
-                    }
+    featherPyramid(feathering, feathering_mask);
 
-                    if (mj >= ref_mask.width())
-                    {
-                        mj = ref_mask.width() - 1;
-                    }
+    output = std::move(feathering[0]);
 
-                    src_mask(i, j) = ref_mask(mi, mj);
-                    src(i, j) = ref(mi, mj);
-                }
-            }
-        }
+    return true;
+}
+
+bool feathering(aliceVision::image::Image<image::RGBfColor>& output,
+                const aliceVision::image::Image<image::RGBfColor>& color,
+                const aliceVision::image::Image<unsigned char>& inputMask,
+                int offsetX,
+                int offsetY)
+{
+    if (offsetX < 0 || offsetY < 0 || offsetX + color.width() > inputMask.width() || offsetY + color.height() > inputMask.height())
+    {
+        return false;
     }
 
-    output = feathering[0];
+    std::vector<image::Image<image::RGBfColor>> feathering(1);
+    std::vector<image::Image<unsigned char>> feathering_mask;
+    feathering[0] = image::Image<image::RGBfColor>(inputMask.width(), inputMask.height(), true, image::RGBfColor(0.0f));
+    feathering[0].block(offsetY, offsetX, color.height(), color.width()) = color;
+    feathering_mask.push_back(inputMask);
+
+    featherPyramid(feathering, feathering_mask);
+
+    output = std::move(feathering[0]);
 
     return true;
 }
@@ -203,94 +268,58 @@ bool feathering(CachedImage<image::RGBfColor>& input_output, CachedImage<unsigne
     gridHeight = pow(2.0, std::ceil(std::log2(float(gridHeight))));
     int gridSize = std::max(gridWidth, gridHeight);
 
-    image::Image<image::RGBfColor> colorTile;
-    image::Image<unsigned char> maskTile;
-
     image::Image<image::RGBfColor> featheredGrid(gridSize, gridSize);
     image::Image<image::RGBfColor> colorGrid(gridSize, gridSize);
     image::Image<unsigned char> maskGrid(gridSize, gridSize, true, 0);
 
-    /*Build the grid color image */
-    for (int i = 0; i < tilesColor.size(); i++)
+    const int tilesRows = tilesColor.size();
+    const int tilesCols = tilesColor[0].size();
+    const int tilesCount = tilesRows * tilesCols;
+    std::atomic<bool> succeeded(true);
+
+    /*Build the grid color image, one pixel per tile (tiles are independent) */
+#pragma omp parallel for schedule(dynamic)
+    for (int id = 0; id < tilesCount; id++)
     {
-        std::vector<image::CachedTile::smart_pointer> rowColor = tilesColor[i];
-        std::vector<image::CachedTile::smart_pointer> rowMask = tilesMask[i];
+        const int i = id / tilesCols;
+        const int j = id % tilesCols;
 
-        for (int j = 0; j < rowColor.size(); j++)
-        {
-            if (!CachedImage<image::RGBfColor>::getTileAsImage(colorTile, rowColor[j]))
-            {
-                return false;
-            }
+        image::Image<image::RGBfColor> colorTile;
+        image::Image<unsigned char> maskTile;
 
-            if (!CachedImage<unsigned char>::getTileAsImage(maskTile, rowMask[j]))
-            {
-                return false;
-            }
+        if (!CachedImage<image::RGBfColor>::getTileAsImage(colorTile, tilesColor[i][j]))
+        {
+            succeeded = false;
+            continue;
+        }
 
-            while (1)
-            {
-                image::Image<image::RGBfColor> smallerTile(colorTile.width() / 2, colorTile.height() / 2);
-                image::Image<unsigned char> smallerMask(maskTile.width() / 2, maskTile.height() / 2);
+        if (!CachedImage<unsigned char>::getTileAsImage(maskTile, tilesMask[i][j]))
+        {
+            succeeded = false;
+            continue;
+        }
 
-                for (int y = 0; y < smallerTile.height(); y++)
-                {
-                    int dy = y * 2;
-                    for (int x = 0; x < smallerTile.width(); x++)
-                    {
-                        int dx = x * 2;
-
-                        int count = 0;
-
-                        smallerTile(y, x) = image::RGBfColor(0.0, 0.0, 0.0);
-
-                        if (maskTile(dy, dx))
-                        {
-                            smallerTile(y, x) += colorTile(dy, dx);
-                            count++;
-                        }
-
-                        if (maskTile(dy, dx + 1))
-                        {
-                            smallerTile(y, x) += colorTile(dy, dx + 1);
-                            count++;
-                        }
-
-                        if (maskTile(dy + 1, dx))
-                        {
-                            smallerTile(y, x) += colorTile(dy + 1, dx);
-                            count++;
-                        }
-
-                        if (maskTile(dy + 1, dx + 1))
-                        {
-                            smallerTile(y, x) += colorTile(dy + 1, dx + 1);
-                            count++;
-                        }
-
-                        if (count > 0)
-                        {
-                            smallerTile(y, x) /= float(count);
-                            smallerMask(y, x) = 1;
-                        }
-                        else
-                        {
-                            smallerMask(y, x) = 0;
-                        }
-                    }
-                }
+        while (1)
+        {
+            image::Image<image::RGBfColor> smallerTile;
+            image::Image<unsigned char> smallerMask;
+            downscaleMasked(smallerTile, smallerMask, colorTile, maskTile);
 
-                colorTile = smallerTile;
-                maskTile = smallerMask;
-                if (colorTile.width() < 2 || colorTile.height() < 2)
-                {
-                    break;
-                }
+            colorTile = std::move(smallerTile);
+            maskTile = std::move(smallerMask);
+            if (colorTile.width() < 2 || colorTile.height() < 2)
+            {
+                break;
             }
-
-            maskGrid(i, j) = maskTile(0, 0);
-            colorGrid(i, j) = colorTile(0, 0);
         }
+
+        maskGrid(i, j) = maskTile(0, 0);
+        colorGrid(i, j) = colorTile(0, 0);
+    }
+
+    if (!succeeded)
+    {
+        return false;
     }
 
     if (!feathering(featheredGrid, colorGrid, maskGrid))
@@ -298,143 +327,65 @@ bool feathering(CachedImage<image::RGBfColor>& input_output, CachedImage<unsigne
         return false;
     }
 
-    for (int i = 0; i < tilesColor.size(); i++)
+    /*Feather each tile, its masked pixels are filled down to the feathered grid */
+#pragma omp parallel for schedule(dynamic)
+    for (int id = 0; id < tilesCount; id++)
     {
-        std::vector<image::CachedTile::smart_pointer> rowColor = tilesColor[i];
-        std::vector<image::CachedTile::smart_pointer> rowMask = tilesMask[i];
+        const int i = id / tilesCols;
+        const int j = id % tilesCols;
+
+        std::vector<image::Image<image::RGBfColor>> pyramid_colors(1);
+        std::vector<image::Image<unsigned char>> pyramid_masks(1);
 
-        for (int j = 0; j < rowColor.size(); j++)
+        if (!CachedImage<image::RGBfColor>::getTileAsImage(pyramid_colors[0], tilesColor[i][j]))
         {
-            if (!CachedImage<image::RGBfColor>::getTileAsImage(colorTile, rowColor[j]))
-            {
-                return false;
-            }
+            succeeded = false;
+            continue;
+        }
 
-            if (!CachedImage<unsigned char>::getTileAsImage(maskTile, rowMask[j]))
-            {
-                return false;
-            }
+        if (!CachedImage<unsigned char>::getTileAsImage(pyramid_masks[0], tilesMask[i][j]))
+        {
+            succeeded = false;
+            continue;
+        }
 
-            std::vector<image::Image<image::RGBfColor>> pyramid_colors;
-            std::vector<image::Image<unsigned char>> pyramid_masks;
+        while (1)
+        {
+            image::Image<image::RGBfColor> smallerTile;
+            image::Image<unsigned char> smallerMask;
+            downscaleMasked(smallerTile, smallerMask, pyramid_colors.back(), pyramid_masks.back());
 
-            pyramid_colors.push_back(colorTile);
-            pyramid_masks.push_back(maskTile);
+            pyramid_colors.push_back(std::move(smallerTile));
+            pyramid_masks.push_back(std::move(smallerMask));
 
-            while (1)
+            if (pyramid_colors.back().width() < 2 || pyramid_colors.back().height() < 2)
             {
-                image::Image<image::RGBfColor>& largerTile = pyramid_colors[pyramid_colors.size() - 1];
-                image::Image<unsigned char>& largerMask = pyramid_masks[pyramid_masks.size() - 1];
-
-                image::Image<image::RGBfColor> smallerTile(largerTile.width() / 2, largerTile.height() / 2);
-                image::Image<unsigned char> smallerMask(largerMask.width() / 2, largerMask.height() / 2);
-
-                for (int y = 0; y < smallerTile.height(); y++)
-                {
-                    int dy = y * 2;
-                    for (int x = 0; x < smallerTile.width(); x++)
-                    {
-                        int dx = x * 2;
-
-                        int count = 0;
-
-                        smallerTile(y, x) = image::RGBfColor(0.0, 0.0, 0.0);
-
-                        if (largerMask(dy, dx))
-                        {
-                            smallerTile(y, x) += largerTile(dy, dx);
-                            count++;
-                        }
-
-                        if (largerMask(dy, dx + 1))
-                        {
-                            smallerTile(y, x) += largerTile(dy, dx + 1);
-                            count++;
-                        }
-
-                        if (largerMask(dy + 1, dx))
-                        {
-                            smallerTile(y, x) += largerTile(dy + 1, dx);
-                            count++;
-                        }
-
-                        if (largerMask(dy + 1, dx + 1))
-                        {
-                            smallerTile(y, x) += largerTile(dy + 1, dx + 1);
-                            count++;
-                        }
-
-                        if (count > 0)
-                        {
-                            smallerTile(y, x) /= float(count);
-                            smallerMask(y, x) = 1;
-                        }
-                        else
-                        {
-                            smallerMask(y, x) = 0;
-                        }
-                    }
-                }
-
-                pyramid_colors.push_back(smallerTile);
-                pyramid_masks.push_back(smallerMask);
-
-                if (smallerTile.width() < 2 || smallerTile.height() < 2)
-                {
-                    break;
-                }
+                break;
             }
+        }
 
-            image::Image<image::RGBfColor>& img = pyramid_colors[pyramid_colors.size() - 1];
-            image::Image<unsigned char>& mask = pyramid_masks[pyramid_masks.size() - 1];
-
-            if (!mask(0, 0))
-            {
-                mask(0, 0) = 255;
-                img(0, 0) = featheredGrid(i, j);
-            }
+        image::Image<image::RGBfColor>& img = pyramid_colors[pyramid_colors.size() - 1];
+        image::Image<unsigned char>& mask = pyramid_masks[pyramid_masks.size() - 1];
 
-            for (int lvl = pyramid_colors.size() - 2; lvl >= 0; lvl--)
-            {
-                image::Image<image::RGBfColor>& src = pyramid_colors[lvl];
-                image::Image<unsigned char>& src_mask = pyramid_masks[lvl];
-                image::Image<image::RGBfColor>& ref = pyramid_colors[lvl + 1];
-                image::Image<unsigned char>& ref_mask = pyramid_masks[lvl + 1];
+        if (!mask(0, 0))
+        {
+            mask(0, 0) = 255;
+            img(0, 0) = featheredGrid(i, j);
+        }
 
-                for (int i = 0; i < src_mask.height(); i++)
-                {
-                    for (int j = 0; j < src_mask.width(); j++)
-                    {
-                        if (!src_mask(i, j))
-                        {
-                            int mi = i / 2;
-                            int mj = j / 2;
-
-                            if (mi >= ref_mask.height())
-                            {
-                                mi = ref_mask.height() - 1;
-                            }
-
-                            if (mj >= ref_mask.width())
-                            {
-                                mj = ref_mask.width() - 1;
-                            }
-
-                            src_mask(i, j) = ref_mask(mi, mj);
-                            src(i, j) = ref(mi, mj);
-                        }
-                    }
-                }
-            }
+        for (int lvl = pyramid_colors.size() - 2; lvl >= 0; lvl--)
+        {
+            fillMasked(pyramid_colors[lvl], pyramid_masks[lvl], pyramid_colors[lvl + 1], pyramid_masks[lvl + 1]);
+        }
 
-            if (!CachedImage<image::RGBfColor>::setTileWithImage(rowColor[j], pyramid_colors[0]))
-            {
-                return false;
-            }
+        if (!CachedImage<image::RGBfColor>::setTileWithImage(tilesColor[i][j], pyramid_colors[0]))
+        {
+            succeeded = false;
+            continue;
         }
     }
 
-    return true;
+    return succeeded;
 }
 
 }  // namespace aliceVision
\ No newline at end of file
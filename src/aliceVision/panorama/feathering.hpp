@@ -16,6 +16,20 @@ bool feathering(aliceVision::image::Image<image::RGBfColor>& output,
                 const aliceVision::image::Image<image::RGBfColor>& color,
                 const aliceVision::image::Image<unsigned char>& inputMask);
 
+/**
+ * @brief Feather a color image virtually padded to the size of its mask, without an intermediate padded copy.
+ * @param[out] output The feathered image, of the size of the mask
+ * @param[in] color The colors
+ * @param[in] inputMask The mask of the padded image
+ * @param[in] offsetX The position of the colors in the mask (the other pixels are masked)
+ * @param[in] offsetY The position of the colors in the mask
+ */
+bool feathering(aliceVision::image::Image<image::RGBfColor>& output,
+                const aliceVision::image::Image<image::RGBfColor>& color,
+                const aliceVision::image::Image<unsigned char>& inputMask,
+                int offsetX,
+                int offsetY);
+
 bool feathering(CachedImage<image::RGBfColor>& input_output, CachedImage<unsigned char>& inputMask);
 
 }  // namespace aliceVision
\ No newline at end of file
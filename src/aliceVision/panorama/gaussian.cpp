@@ -5,6 +5,7 @@
 // You can obtain one at https://mozilla.org/MPL/2.0/.
 
 #include "gaussian.hpp"
+#include "imageOps.hpp"
 
 #include <OpenImageIO/imagebufalgo.h>
 
@@ -61,19 +62,7 @@ bool GaussianPyramidNoMask::process(const image::Image<image::RGBfColor>& input)
 
 bool GaussianPyramidNoMask::downscale(image::Image<image::RGBfColor>& output, const image::Image<image::RGBfColor>& input)
 {
-    for (int i = 0; i < output.height(); i++)
-    {
-        int ui = i * 2;
-
-        for (int j = 0; j < output.width(); j++)
-        {
-            int uj = j * 2;
-
-            output(i, j) = input(ui, uj);
-        }
-    }
-
-    return true;
+    return aliceVision::downscale(output, input);
 }
 
 }  // namespace aliceVision
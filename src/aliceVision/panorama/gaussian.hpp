@@ -8,6 +8,9 @@
 
 #include <aliceVision/image/all.hpp>
 
+#include <algorithm>
+#include <array>
+
 namespace aliceVision {
 
 class GaussianPyramidNoMask
@@ -33,6 +36,45 @@ class GaussianPyramidNoMask
     size_t _scales;
 };
 
+/**
+ * @brief Number of float channels of a pixel type (float, RGBfColor, RGBAfColor).
+ *        The gaussian filters process the image rows as contiguous float arrays, so that Eigen vectorizes them.
+ */
+template<class T>
+constexpr int floatChannels()
+{
+    static_assert(sizeof(T) % sizeof(float) == 0, "The pixel type must be made of floats");
+    return static_cast<int>(sizeof(T) / sizeof(float));
+}
+
+/**
+ * @brief Mirror (5432 | 123456 | 5432) or loop an index in [0, size[.
+ */
+inline int gaussianBorderIndex(int index, int size, bool loop)
+{
+    if (loop)
+    {
+        if (index < 0)
+            return index + size;
+        if (index >= size)
+            return index - size;
+        return index;
+    }
+
+    if (index < 0)
+        index = -index;
+    if (index >= size)
+        index = size - 1 - (index + 1 - size);
+    return std::min(std::max(index, 0), size - 1);
+}
+
+/**
+ * @brief Horizontal 5 taps convolution of a row.
+ * @param[out] output_row the output row
+ * @param[in] input_row the input row
+ * @param[in] kernel the normalized kernel
+ * @param[in] loop true to loop the borders (360 images), false to mirror them
+ */
 template<class T>
 inline void convolveRow(typename image::Image<T>::RowXpr output_row,
                         typename image::Image<T>::ConstRowXpr input_row,
@@ -40,71 +82,73 @@ inline void convolveRow(typename image::Image<T>::RowXpr output_row,
                         bool loop)
 {
     const int radius = 2;
+    const int width = input_row.cols();
 
-    for (int j = 0; j < input_row.cols(); j++)
-    {
+    const auto convolvePixel = [&](int j) {
         T sum = T();
-        float sumw = 0.0f;
-
         for (int k = 0; k < kernel.size(); k++)
-        {
-            float w = kernel(k);
-            int col = j + k - radius;
+            sum += kernel(k) * input_row(gaussianBorderIndex(j + k - radius, width, loop));
+        output_row(j) = sum;
+    };
 
-            /* mirror 5432 | 123456 | 5432 */
+    if (width <= 2 * radius)
+    {
+        for (int j = 0; j < width; j++)
+            convolvePixel(j);
+        return;
+    }
 
-            if (!loop)
-            {
-                if (col < 0)
-                {
-                    col = -col;
-                }
-
-                if (col >= input_row.cols())
-                {
-                    col = input_row.cols() - 1 - (col + 1 - input_row.cols());
-                }
-            }
-            else
-            {
-                if (col < 0)
-                {
-                    col = input_row.cols() + col;
-                }
-
-                if (col >= input_row.cols())
-                {
-                    col = col - input_row.cols();
-                }
-            }
+    // interior pixels: the 5 taps are contiguous float segments shifted by one pixel
+    constexpr int channels = floatChannels<T>();
+    const int size = (width - 2 * radius) * channels;
+    const Eigen::Map<const Eigen::ArrayXf> input(reinterpret_cast<const float*>(input_row.data()), width * channels);
+    Eigen::Map<Eigen::ArrayXf> output(reinterpret_cast<float*>(output_row.data()), width * channels);
 
-            sum += w * input_row(col);
-            sumw += w;
-        }
+    output.segment(radius * channels, size) = kernel(0) * input.segment(0, size) + kernel(1) * input.segment(channels, size) +
+                                              kernel(2) * input.segment(2 * channels, size) + kernel(3) * input.segment(3 * channels, size) +
+                                              kernel(4) * input.segment(4 * channels, size);
 
-        output_row(j) = sum / sumw;
+    // border pixels
+    for (int j = 0; j < radius; j++)
+    {
+        convolvePixel(j);
+        convolvePixel(width - 1 - j);
     }
 }
 
+/**
+ * @brief Vertical 5 taps convolution of the given rows.
+ * @param[out] output_row the output row
+ * @param[in] rows the 5 horizontally filtered rows, from top to bottom
+ * @param[in] kernel the normalized kernel
+ */
 template<class T>
-inline void convolveColumns(typename image::Image<T>::RowXpr output_row, const image::Image<T>& input_rows, const Eigen::Matrix<float, 5, 1>& kernel)
+inline void convolveColumns(typename image::Image<T>::RowXpr output_row,
+                            const std::array<const T*, 5>& rows,
+                            const Eigen::Matrix<float, 5, 1>& kernel)
 {
-    for (int j = 0; j < output_row.cols(); j++)
-    {
-        T sum = T();
-        float sumw = 0.0f;
+    constexpr int channels = floatChannels<T>();
+    const int size = output_row.cols() * channels;
 
-        for (int k = 0; k < kernel.size(); k++)
-        {
-            float w = kernel(k);
-            sum += w * input_rows(k, j);
-            sumw += w;
-        }
+    using ConstMap = Eigen::Map<const Eigen::ArrayXf>;
+    Eigen::Map<Eigen::ArrayXf> output(reinterpret_cast<float*>(output_row.data()), size);
 
-        output_row(j) = sum / sumw;
-    }
+    output = kernel(0) * ConstMap(reinterpret_cast<const float*>(rows[0]), size) +
+             kernel(1) * ConstMap(reinterpret_cast<const float*>(rows[1]), size) +
+             kernel(2) * ConstMap(reinterpret_cast<const float*>(rows[2]), size) +
+             kernel(3) * ConstMap(reinterpret_cast<const float*>(rows[3]), size) +
+             kernel(4) * ConstMap(reinterpret_cast<const float*>(rows[4]), size);
 }
 
+/**
+ * @brief Separable 5x5 gaussian filter ([1 4 6 4 1] / 16), with mirrored top and bottom borders.
+ *        Each input row is filtered horizontally once, in a 5 rows ring buffer which stays in the cache,
+ *        and the vertical pass combines the buffered rows.
+ * @param[out] output the filtered image, with the size of the input image
+ * @param[in] input the input image
+ * @param[in] loop true to loop the left and right borders (360 images), false to mirror them
+ * @return false if the output size is not the input size
+ */
 template<class T>
 bool convolveGaussian5x5(image::Image<T>& output, const image::Image<T>& input, bool loop = false)
 {
@@ -121,48 +165,34 @@ bool convolveGaussian5x5(image::Image<T>& output, const image::Image<T>& input,
     kernel[4] = 1.0f;
     kernel = kernel / kernel.sum();
 
+    const int radius = 2;
+    const int height = output.height();
+
+    // the rows of a window are distinct and span at most 5 consecutive indices, so the row r is stored in the slot r % 5
     image::Image<T> buf(output.width(), 5);
+    std::array<int, 5> bufferedRows;
+    bufferedRows.fill(-1);
 
-    int radius = 2;
+    for (int i = 0; i < height; i++)
+    {
+        std::array<const T*, 5> rows;
 
-    convolveRow<T>(buf.row(0), input.row(2), kernel, loop);
-    convolveRow<T>(buf.row(1), input.row(1), kernel, loop);
-    convolveRow<T>(buf.row(2), input.row(0), kernel, loop);
-    convolveRow<T>(buf.row(3), input.row(1), kernel, loop);
-    convolveRow<T>(buf.row(4), input.row(2), kernel, loop);
+        for (int k = 0; k < 5; k++)
+        {
+            const int inputRow = gaussianBorderIndex(i + k - radius, height, false);
+            const int slot = inputRow % 5;
 
-    for (int i = 0; i < output.height() - 3; i++)
-    {
-        convolveColumns<T>(output.row(i), buf, kernel);
+            if (bufferedRows[slot] != inputRow)
+            {
+                convolveRow<T>(buf.row(slot), input.row(inputRow), kernel, loop);
+                bufferedRows[slot] = inputRow;
+            }
+            rows[k] = buf.row(slot).data();
+        }
 
-        buf.row(0) = buf.row(1);
-        buf.row(1) = buf.row(2);
-        buf.row(2) = buf.row(3);
-        buf.row(3) = buf.row(4);
-        convolveRow<T>(buf.row(4), input.row(i + 3), kernel, loop);
+        convolveColumns<T>(output.row(i), rows, kernel);
     }
 
-    /**
-    current row : -5 -4 -3 -2 -1
-    next 1 : -4 -3 -2 -1 -2
-    next 2 : -3 -2 -1 -2 -3
-    */
-    convolveColumns<T>(output.row(output.height() - 3), buf, kernel);
-
-    buf.row(0) = buf.row(1);
-    buf.row(1) = buf.row(2);
-    buf.row(2) = buf.row(3);
-    buf.row(3) = buf.row(4);
-    convolveRow<T>(buf.row(4), input.row(output.height() - 2), kernel, loop);
-    convolveColumns<T>(output.row(output.height() - 2), buf, kernel);
-
-    buf.row(0) = buf.row(1);
-    buf.row(1) = buf.row(2);
-    buf.row(2) = buf.row(3);
-    buf.row(3) = buf.row(4);
-    convolveRow<T>(buf.row(4), input.row(output.height() - 3), kernel, loop);
-    convolveColumns<T>(output.row(output.height() - 1), buf, kernel);
-
     return true;
 }
 
@@ -43,4 +43,55 @@ void removeNegativeValues(image::Image<image::RGBfColor>& img)
     }
 }
 
-}  // namespace aliceVision
\ No newline at end of file
+bool getPyramidCompatibleBoundingBox(BoundingBox& output, const BoundingBox& input, size_t borderSize, size_t num_levels)
+{
+    if (num_levels == 0)
+    {
+        return false;
+    }
+
+    double maxScale = 1.0 / pow(2.0, num_levels - 1);
+
+    double lowOffsetX = double(input.left) * maxScale;
+    double lowOffsetY = double(input.top) * maxScale;
+
+    /*Make sure offset is integer even at the lowest level*/
+    double correctedLowOffsetX = floor(lowOffsetX);
+    double correctedLowOffsetY = floor(lowOffsetY);
+
+    /*Add some borders on the top and left to make sure mask can be smoothed*/
+    correctedLowOffsetX = correctedLowOffsetX - double(borderSize);
+    correctedLowOffsetY = correctedLowOffsetY - double(borderSize);
+
+    /*Compute offset at largest level*/
+    output.left = int(correctedLowOffsetX / maxScale);
+    output.top = int(correctedLowOffsetY / maxScale);
+
+    /*Compute difference*/
+    double doffsetX = double(input.left) - double(output.left);
+    double doffsetY = double(input.top) - double(output.top);
+
+    /* update size with border update */
+    double large_width = double(input.width) + doffsetX;
+    double large_height = double(input.height) + doffsetY;
+
+    /* compute size at largest scale */
+    double low_width = large_width * maxScale;
+    double low_height = large_height * maxScale;
+
+    /*Make sure width is integer even at the lowest level*/
+    double correctedLowWidth = ceil(low_width);
+    double correctedLowHeight = ceil(low_height);
+
+    /*Add some borders on the right and bottom to make sure mask can be smoothed*/
+    correctedLowWidth = correctedLowWidth + double(borderSize);
+    correctedLowHeight = correctedLowHeight + double(borderSize);
+
+    /*Compute size at largest level*/
+    output.width = int(correctedLowWidth / maxScale);
+    output.height = int(correctedLowHeight / maxScale);
+
+    return true;
+}
+
+}  // namespace aliceVision
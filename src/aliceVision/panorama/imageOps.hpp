@@ -6,27 +6,29 @@
 
 #pragma once
 
+#include "boundingBox.hpp"
 #include "cachedImage.hpp"
 #include <aliceVision/image/all.hpp>
 #include <aliceVision/half.hpp>
 
 namespace aliceVision {
 
+/**
+ * @brief Decimate an image by 2: the output pixel (i, j) is the input pixel (2i, 2j).
+ *        The input is read through a strided map, without any per-pixel index computation.
+ */
 template<class T>
 bool downscale(aliceVision::image::Image<T>& outputColor, const aliceVision::image::Image<T>& inputColor)
 {
-    for (int i = 0; i < outputColor.height(); i++)
+    if (2 * (outputColor.height() - 1) >= inputColor.height() || 2 * (outputColor.width() - 1) >= inputColor.width())
     {
-        int di = i * 2;
-
-        for (int j = 0; j < outputColor.width(); j++)
-        {
-            int dj = j * 2;
-
-            outputColor(i, j) = inputColor(di, dj);
-        }
+        return false;
     }
 
+    using StridedMap = Eigen::Map<const typename aliceVision::image::Image<T>::Base, Eigen::Unaligned, Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic>>;
+    outputColor.getMat() =
+      StridedMap(inputColor.data(), outputColor.height(), outputColor.width(), Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic>(2 * inputColor.width(), 2));
+
     return true;
 }
 
@@ -372,6 +374,17 @@ bool loopyCachedImageExtract(aliceVision::image::Image<T>& output, CachedImage<T
     return true;
 }
 
+/**
+ * @brief Compute the bounding box of an input padded to be compatible with the pyramid processing:
+ *        its position and its size are integers at the lowest level, with borders around it to smooth its mask.
+ * @param[out] output The padded bounding box, in the same coordinates as the input
+ * @param[in] input The bounding box of the input
+ * @param[in] borderSize The border size at the lowest level
+ * @param[in] num_levels The number of levels of the pyramid
+ * @return false if num_levels is 0
+ */
+bool getPyramidCompatibleBoundingBox(BoundingBox& output, const BoundingBox& input, size_t borderSize, size_t num_levels);
+
 template<class T>
 bool makeImagePyramidCompatible(image::Image<T>& output,
                                 int& outOffsetX,
@@ -382,54 +395,17 @@ bool makeImagePyramidCompatible(image::Image<T>& output,
                                 size_t borderSize,
                                 size_t num_levels)
 {
-    if (num_levels == 0)
+    BoundingBox padded;
+    if (!getPyramidCompatibleBoundingBox(padded, BoundingBox(offsetX, offsetY, input.width(), input.height()), borderSize, num_levels))
     {
         return false;
     }
 
-    double maxScale = 1.0 / pow(2.0, num_levels - 1);
-
-    double lowOffsetX = double(offsetX) * maxScale;
-    double lowOffsetY = double(offsetY) * maxScale;
-
-    /*Make sure offset is integer even at the lowest level*/
-    double correctedLowOffsetX = floor(lowOffsetX);
-    double correctedLowOffsetY = floor(lowOffsetY);
-
-    /*Add some borders on the top and left to make sure mask can be smoothed*/
-    correctedLowOffsetX = correctedLowOffsetX - double(borderSize);
-    correctedLowOffsetY = correctedLowOffsetY - double(borderSize);
-
-    /*Compute offset at largest level*/
-    outOffsetX = int(correctedLowOffsetX / maxScale);
-    outOffsetY = int(correctedLowOffsetY / maxScale);
-
-    /*Compute difference*/
-    double doffsetX = double(offsetX) - double(outOffsetX);
-    double doffsetY = double(offsetY) - double(outOffsetY);
-
-    /* update size with border update */
-    double large_width = double(input.width()) + doffsetX;
-    double large_height = double(input.height()) + doffsetY;
-
-    /* compute size at largest scale */
-    double low_width = large_width * maxScale;
-    double low_height = large_height * maxScale;
-
-    /*Make sure width is integer even at the lowest level*/
-    double correctedLowWidth = ceil(low_width);
-    double correctedLowHeight = ceil(low_height);
-
-    /*Add some borders on the right and bottom to make sure mask can be smoothed*/
-    correctedLowWidth = correctedLowWidth + double(borderSize);
-    correctedLowHeight = correctedLowHeight + double(borderSize);
-
-    /*Compute size at largest level*/
-    size_t width = size_t(correctedLowWidth / maxScale);
-    size_t height = size_t(correctedLowHeight / maxScale);
+    outOffsetX = padded.left;
+    outOffsetY = padded.top;
 
-    output = image::Image<T>(width, height, true, T(0.0f));
-    output.block(doffsetY, doffsetX, input.height(), input.width()) = input;
+    output = image::Image<T>(padded.width, padded.height, true, T(0.0f));
+    output.block(offsetY - outOffsetY, offsetX - outOffsetX, input.height(), input.width()) = input;
 
     return true;
 }
@@ -10,12 +10,22 @@
 #include "gaussian.hpp"
 #include "compositer.hpp"
 
+#include <aliceVision/config.hpp>
+#include <aliceVision/system/Logger.hpp>
+
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
+    #include <aliceVision/panorama/cuda/DeviceLaplacianPyramid.hpp>
+#endif
+
+#include <stdexcept>
+
 namespace aliceVision {
 
-LaplacianPyramid::LaplacianPyramid(size_t base_width, size_t base_height, size_t max_levels)
+LaplacianPyramid::LaplacianPyramid(size_t base_width, size_t base_height, size_t max_levels, bool useGpu)
   : _baseWidth(base_width),
     _baseHeight(base_height),
-    _maxLevels(max_levels)
+    _maxLevels(max_levels),
+    _useGpu(useGpu)
 {
     omp_init_lock(&_merge_lock);
 }
@@ -43,6 +53,21 @@ bool LaplacianPyramid::initialize()
         height = int(ceil(float(height) / 2.0f));
     }
 
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
+    if (_useGpu)
+    {
+        try
+        {
+            _devicePyramid.reset(new panorama::cuda::DeviceLaplacianPyramid(_baseWidth, _baseHeight, _maxLevels));
+        }
+        catch (const std::exception& e)
+        {
+            ALICEVISION_LOG_WARNING("The laplacian pyramid can not be allocated on the GPU, use the CPU: " << e.what());
+            _devicePyramid.reset();
+        }
+    }
+#endif
+
     return true;
 }
 
@@ -59,6 +84,40 @@ bool LaplacianPyramid::apply(aliceVision::image::Image<image::RGBfColor>& source
     int offsetX = outputBoundingBox.left;
     int offsetY = outputBoundingBox.top;
 
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
+    if (_devicePyramid)
+    {
+        // the device is shared by all the inputs
+        omp_set_lock(&_merge_lock);
+        try
+        {
+            _devicePyramid->apply(reinterpret_cast<const float*>(source.data()),
+                                  mask.data(),
+                                  weights.data(),
+                                  source.width(),
+                                  source.height(),
+                                  contentBoudingBox.left,
+                                  contentBoudingBox.top,
+                                  width,
+                                  height,
+                                  offsetX,
+                                  offsetY);
+        }
+        catch (const std::exception& e)
+        {
+            omp_unset_lock(&_merge_lock);
+            ALICEVISION_LOG_ERROR("Laplacian pyramid on the GPU: " << e.what());
+            return false;
+        }
+        omp_unset_lock(&_merge_lock);
+
+        source = aliceVision::image::Image<image::RGBfColor>();
+        mask = aliceVision::image::Image<float>();
+        weights = aliceVision::image::Image<float>();
+        return true;
+    }
+#endif
+
     image::Image<image::RGBfColor> currentColor(width, height, true, image::RGBfColor(0.0));
     image::Image<image::RGBfColor> nextColor;
     image::Image<float> currentWeights(width, height, true, 0.0f);
@@ -271,6 +330,26 @@ bool LaplacianPyramid::merge(const aliceVision::image::Image<image::RGBfColor>&
 
 bool LaplacianPyramid::rebuild(image::Image<image::RGBAfColor>& output, const BoundingBox& roi)
 {
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
+    if (_devicePyramid)
+    {
+        // stream back the bands (the inputs last levels are already accumulated)
+        try
+        {
+            for (int l = 0; l < _levels.size(); l++)
+            {
+                _devicePyramid->download(l, reinterpret_cast<float*>(_levels[l].data()), _weights[l].data());
+            }
+        }
+        catch (const std::exception& e)
+        {
+            ALICEVISION_LOG_ERROR("Laplacian pyramid on the GPU: " << e.what());
+            return false;
+        }
+        _devicePyramid.reset();
+    }
+#endif
+
     for (InputInfo& iinfo : _inputInfos)
     {
         if (!merge(iinfo.color, iinfo.weights, _levels.size() - 1, iinfo.offsetX, iinfo.offsetY))
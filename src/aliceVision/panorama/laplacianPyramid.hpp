@@ -10,8 +10,16 @@
 
 #include <aliceVision/image/all.hpp>
 
+#include <memory>
+
 namespace aliceVision {
 
+namespace panorama {
+namespace cuda {
+class DeviceLaplacianPyramid;
+}  // namespace cuda
+}  // namespace panorama
+
 class LaplacianPyramid
 {
   public:
@@ -25,10 +33,21 @@ class LaplacianPyramid
     };
 
   public:
-    LaplacianPyramid(size_t base_width, size_t base_height, size_t max_levels);
+    /**
+     * @brief LaplacianPyramid constructor
+     * @param[in] base_width The width of the first level
+     * @param[in] base_height The height of the first level
+     * @param[in] max_levels The number of levels
+     * @param[in] useGpu Build the pyramids of the inputs and accumulate the bands on the GPU (if available)
+     */
+    LaplacianPyramid(size_t base_width, size_t base_height, size_t max_levels, bool useGpu = false);
 
     virtual ~LaplacianPyramid();
 
+    /**
+     * @brief Allocate the levels.
+     *        If the GPU is requested but can not be used, the pyramid falls back to the CPU.
+     */
     bool initialize();
 
     bool apply(aliceVision::image::Image<image::RGBfColor>& source,
@@ -54,6 +73,10 @@ class LaplacianPyramid
     std::vector<image::Image<image::RGBfColor>> _levels;
     std::vector<image::Image<float>> _weights;
     std::vector<InputInfo> _inputInfos;
+
+    bool _useGpu;
+    /// device bands, the inputs are accumulated on the device and the host levels are only filled by rebuild
+    std::unique_ptr<panorama::cuda::DeviceLaplacianPyramid> _devicePyramid;
 };
 
 }  // namespace aliceVision
\ No newline at end of file
@@ -6,6 +6,12 @@
 
 #include "panoramaMap.hpp"
 
+#include <aliceVision/system/Logger.hpp>
+
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/json_parser.hpp>
+
+#include <filesystem>
 #include <iostream>
 #include <list>
 
@@ -212,4 +218,91 @@ bool PanoramaMap::optimizeChunks(std::vector<std::vector<IndexT>>& chunks, int c
     return true;
 }
 
+namespace {
+
+namespace bpt = boost::property_tree;
+namespace fs = std::filesystem;
+
+const std::string boundingBoxesFilePrefix = "boundingBoxes_";
+
+}  // namespace
+
+bool saveWarpedBoundingBoxes(const std::string& warpingFolder, int chunkId, const WarpedBoundingBoxes& boxes)
+{
+    bpt::ptree fileTree;
+    fileTree.put("panoramaWidth", boxes.panoramaWidth);
+    fileTree.put("panoramaHeight", boxes.panoramaHeight);
+
+    bpt::ptree boxesTree;
+    for (const auto& item : boxes.boundingBoxes)
+    {
+        bpt::ptree boxTree;
+        boxTree.put("warpedPath", item.first);
+        boxTree.put("left", item.second.left);
+        boxTree.put("top", item.second.top);
+        boxTree.put("width", item.second.width);
+        boxTree.put("height", item.second.height);
+        boxesTree.push_back(std::make_pair("", boxTree));
+    }
+    fileTree.add_child("boundingBoxes", boxesTree);
+
+    const std::string path = (fs::path(warpingFolder) / (boundingBoxesFilePrefix + std::to_string(chunkId) + ".json")).string();
+    try
+    {
+        bpt::write_json(path, fileTree);
+    }
+    catch (const bpt::ptree_error& e)
+    {
+        ALICEVISION_LOG_ERROR("Unable to write the bounding boxes file " << path << ": " << e.what());
+        return false;
+    }
+
+    return true;
+}
+
+bool loadWarpedBoundingBoxes(const std::string& warpingFolder, WarpedBoundingBoxes& boxes)
+{
+    boxes = WarpedBoundingBoxes();
+    if (!fs::is_directory(warpingFolder))
+    {
+        return false;
+    }
+
+    bool found = false;
+    for (const auto& entry : fs::directory_iterator(warpingFolder))
+    {
+        const fs::path& path = entry.path();
+        if (path.extension() != ".json" || path.filename().string().rfind(boundingBoxesFilePrefix, 0) != 0)
+        {
+            continue;
+        }
+
+        try
+        {
+            bpt::ptree fileTree;
+            bpt::read_json(path.string(), fileTree);
+
+            boxes.panoramaWidth = fileTree.get<int>("panoramaWidth");
+            boxes.panoramaHeight = fileTree.get<int>("panoramaHeight");
+
+            for (const auto& boxItem : fileTree.get_child("boundingBoxes"))
+            {
+                const bpt::ptree& boxTree = boxItem.second;
+                BoundingBox bb(boxTree.get<int>("left"), boxTree.get<int>("top"), boxTree.get<int>("width"), boxTree.get<int>("height"));
+                boxes.boundingBoxes[boxTree.get<std::string>("warpedPath")] = bb;
+            }
+        }
+        catch (const bpt::ptree_error& e)
+        {
+            ALICEVISION_LOG_WARNING("Invalid bounding boxes file " << path.string() << ": " << e.what());
+            boxes = WarpedBoundingBoxes();
+            return false;
+        }
+
+        found = true;
+    }
+
+    return found;
+}
+
 }  // namespace aliceVision
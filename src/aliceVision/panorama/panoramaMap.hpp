@@ -12,6 +12,8 @@
 
 #include <list>
 #include <map>
+#include <string>
+#include <vector>
 
 namespace aliceVision {
 
@@ -75,4 +77,34 @@ class PanoramaMap
     int _borderSize;
 };
 
+/**
+ * @brief Bounding boxes of the warped images, computed once by the panorama warping.
+ * Each warping chunk writes its own file in the warping folder, so the compositing only reads these files
+ * instead of the metadata of each warped image.
+ */
+struct WarpedBoundingBoxes
+{
+    int panoramaWidth = 0;
+    int panoramaHeight = 0;
+    /// bounding box in the panorama of each warped image, by warped path
+    std::map<std::string, BoundingBox> boundingBoxes;
+};
+
+/**
+ * @brief Write the bounding boxes of the warped images of a warping chunk.
+ * @param[in] warpingFolder The warping output folder
+ * @param[in] chunkId The warping chunk
+ * @param[in] boxes The bounding boxes of the warped images of the chunk
+ * @return false if the file can not be written
+ */
+bool saveWarpedBoundingBoxes(const std::string& warpingFolder, int chunkId, const WarpedBoundingBoxes& boxes);
+
+/**
+ * @brief Read and merge the bounding boxes of all the warping chunks.
+ * @param[in] warpingFolder The warping output folder
+ * @param[out] boxes The bounding boxes of the warped images
+ * @return false if no (valid) bounding boxes file is found
+ */
+bool loadWarpedBoundingBoxes(const std::string& warpingFolder, WarpedBoundingBoxes& boxes);
+
 }  // namespace aliceVision
\ No newline at end of file
@@ -0,0 +1,359 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "rigStitcher.hpp"
+
+#include "distance.hpp"
+#include "remapBbox.hpp"
+#include "seams.hpp"
+#include "warper.hpp"
+
+#include <aliceVision/system/Logger.hpp>
+
+#include <algorithm>
+#include <vector>
+
+namespace aliceVision {
+
+namespace {
+
+/**
+ * @brief Box filter of the rows of an image, with a zero padding or a circular padding.
+ */
+void boxBlurRows(image::Image<float>& image, int radius, bool circular)
+{
+    const int width = image.width();
+    const int size = 2 * radius + 1;
+
+#pragma omp parallel for
+    for (int i = 0; i < image.height(); i++)
+    {
+        // prefix sums of the padded row
+        std::vector<double> sums(width + size + 1, 0.0);
+        for (int k = 0; k < width + size; k++)
+        {
+            int j = k - radius;
+            float value = 0.0f;
+            if (circular)
+            {
+                j = ((j % width) + width) % width;
+                value = image(i, j);
+            }
+            else if (j >= 0 && j < width)
+            {
+                value = image(i, j);
+            }
+            sums[k + 1] = sums[k] + value;
+        }
+
+        for (int j = 0; j < width; j++)
+        {
+            image(i, j) = float((sums[j + size] - sums[j]) / double(size));
+        }
+    }
+}
+
+/**
+ * @brief Box filter of the columns of an image, with a zero padding.
+ */
+void boxBlurColumns(image::Image<float>& image, int radius)
+{
+    const int height = image.height();
+    const int size = 2 * radius + 1;
+
+#pragma omp parallel for
+    for (int j = 0; j < image.width(); j++)
+    {
+        std::vector<double> sums(height + size + 1, 0.0);
+        for (int k = 0; k < height + size; k++)
+        {
+            const int i = k - radius;
+            const float value = (i >= 0 && i < height) ? image(i, j) : 0.0f;
+            sums[k + 1] = sums[k] + value;
+        }
+
+        for (int i = 0; i < height; i++)
+        {
+            image(i, j) = float((sums[i + size] - sums[i]) / double(size));
+        }
+    }
+}
+
+}  // namespace
+
+bool RigStitcher::addCamera(IndexT cameraId, const geometry::Pose3& pose, const camera::IntrinsicBase& intrinsic)
+{
+    const std::pair<int, int> panoramaSize(_panoramaWidth, _panoramaHeight);
+
+    BoundingBox coarseBbox;
+    if (!computeCoarseBB(coarseBbox, panoramaSize, pose, intrinsic))
+    {
+        return false;
+    }
+
+    Camera camera;
+    camera.id = cameraId;
+    camera.sourceWidth = intrinsic.w();
+    camera.sourceHeight = intrinsic.h();
+
+    if (!camera.map.build(panoramaSize, pose, intrinsic, coarseBbox))
+    {
+        return false;
+    }
+
+    if (camera.map.getBoundingBox().isEmpty())
+    {
+        return false;
+    }
+
+    if (!distanceToCenter(camera.distances, camera.map, intrinsic.w(), intrinsic.h()))
+    {
+        return false;
+    }
+
+    _cameras.push_back(std::move(camera));
+
+    return true;
+}
+
+bool RigStitcher::computeSeams()
+{
+    WTASeams seams(_panoramaWidth, _panoramaHeight);
+
+    for (const Camera& camera : _cameras)
+    {
+        if (!seams.appendWithLoop(camera.map.getMask(), camera.distances, camera.id, camera.map.getOffsetX(), camera.map.getOffsetY()))
+        {
+            return false;
+        }
+    }
+
+    _labels = seams.getLabels();
+
+    for (Camera& camera : _cameras)
+    {
+        if (!computeTargetBlending(camera))
+        {
+            return false;
+        }
+        camera.blending = camera.targetBlending;
+    }
+
+    return true;
+}
+
+bool RigStitcher::refineSeams(const std::map<IndexT, image::Image<image::RGBfColor>>& sources, int countLevels, int refinementBand)
+{
+    HierarchicalGraphcutSeams seams(_panoramaWidth, _panoramaHeight, countLevels);
+    seams.setRefinementBand(refinementBand);
+
+    if (!seams.initialize(_labels))
+    {
+        return false;
+    }
+
+    for (const Camera& camera : _cameras)
+    {
+        const auto it = sources.find(camera.id);
+        if (it == sources.end())
+        {
+            continue;
+        }
+
+        Warper warper;
+        if (!warper.warp(camera.map, it->second))
+        {
+            return false;
+        }
+
+        if (!seams.append(warper.getColor(), warper.getMask(), camera.id, warper.getOffsetX(), warper.getOffsetY()))
+        {
+            return false;
+        }
+    }
+
+    if (!seams.process())
+    {
+        return false;
+    }
+
+    _labels = seams.getLabels();
+
+    for (Camera& camera : _cameras)
+    {
+        if (!computeTargetBlending(camera))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void RigStitcher::advanceSeams(float temporalSmoothing)
+{
+    const float current = std::clamp(temporalSmoothing, 0.0f, 1.0f);
+    const float target = 1.0f - current;
+
+    for (Camera& camera : _cameras)
+    {
+#pragma omp parallel for
+        for (int i = 0; i < camera.blending.height(); i++)
+        {
+            for (int j = 0; j < camera.blending.width(); j++)
+            {
+                camera.blending(i, j) = current * camera.blending(i, j) + target * camera.targetBlending(i, j);
+            }
+        }
+    }
+}
+
+bool RigStitcher::stitch(image::Image<image::RGBAfColor>& output, const std::map<IndexT, image::Image<image::RGBfColor>>& sources) const
+{
+    output = image::Image<image::RGBAfColor>(_panoramaWidth, _panoramaHeight, true, image::RGBAfColor(0.0f, 0.0f, 0.0f, 0.0f));
+
+    const image::Sampler2d<image::SamplerLinear> sampler;
+
+    // The cameras are accumulated one after the other:
+    // the maps are not wider than the panorama, so the rows of a camera never overlap
+    for (const Camera& camera : _cameras)
+    {
+        const auto it = sources.find(camera.id);
+        if (it == sources.end())
+        {
+            continue;
+        }
+
+        const image::Image<image::RGBfColor>& source = it->second;
+        if (source.width() != camera.sourceWidth || source.height() != camera.sourceHeight)
+        {
+            ALICEVISION_LOG_ERROR("Invalid image size for the camera " << camera.id << ": " << source.width() << "x" << source.height()
+                                                                        << " instead of " << camera.sourceWidth << "x" << camera.sourceHeight);
+            return false;
+        }
+
+        const image::Image<Eigen::Vector2f>& coordinates = camera.map.getCoordinates();
+        const int offsetX = camera.map.getOffsetX();
+        const int offsetY = camera.map.getOffsetY();
+
+#pragma omp parallel for
+        for (int i = 0; i < coordinates.height(); i++)
+        {
+            const int y = i + offsetY;
+            if (y < 0 || y >= _panoramaHeight)
+            {
+                continue;
+            }
+
+            for (int j = 0; j < coordinates.width(); j++)
+            {
+                const float weight = camera.blending(i, j);
+                if (weight <= 0.0f)
+                {
+                    continue;
+                }
+
+                int x = j + offsetX;
+                if (x < 0)
+                {
+                    x += _panoramaWidth;
+                }
+                if (x >= _panoramaWidth)
+                {
+                    x -= _panoramaWidth;
+                }
+
+                const Eigen::Vector2f& coord = coordinates(i, j);
+                const image::RGBfColor pixel = sampler(source, coord(1), coord(0));
+
+                image::RGBAfColor& accumulated = output(y, x);
+                accumulated.r() += weight * pixel.r();
+                accumulated.g() += weight * pixel.g();
+                accumulated.b() += weight * pixel.b();
+                accumulated.a() += weight;
+            }
+        }
+    }
+
+#pragma omp parallel for
+    for (int y = 0; y < _panoramaHeight; y++)
+    {
+        for (int x = 0; x < _panoramaWidth; x++)
+        {
+            image::RGBAfColor& pixel = output(y, x);
+            if (pixel.a() <= 0.0f)
+            {
+                continue;
+            }
+
+            pixel.r() /= pixel.a();
+            pixel.g() /= pixel.a();
+            pixel.b() /= pixel.a();
+            pixel.a() = 1.0f;
+        }
+    }
+
+    return true;
+}
+
+bool RigStitcher::computeTargetBlending(Camera& camera) const
+{
+    const image::Image<unsigned char>& mask = camera.map.getMask();
+    const int offsetX = camera.map.getOffsetX();
+    const int offsetY = camera.map.getOffsetY();
+
+    image::Image<float>& weights = camera.targetBlending;
+    weights = image::Image<float>(mask.width(), mask.height(), true, 0.0f);
+
+    for (int i = 0; i < mask.height(); i++)
+    {
+        const int y = i + offsetY;
+        if (y < 0 || y >= _labels.height())
+        {
+            continue;
+        }
+
+        for (int j = 0; j < mask.width(); j++)
+        {
+            int x = j + offsetX;
+            if (x < 0)
+            {
+                x += _labels.width();
+            }
+            if (x >= _labels.width())
+            {
+                x -= _labels.width();
+            }
+
+            if (mask(i, j) && _labels(y, x) == camera.id)
+            {
+                weights(i, j) = 1.0f;
+            }
+        }
+    }
+
+    if (_blendWidth > 0)
+    {
+        // Feather the seams: the maps covering the whole panorama width loop around
+        boxBlurRows(weights, _blendWidth, mask.width() >= _panoramaWidth);
+        boxBlurColumns(weights, _blendWidth);
+
+        for (int i = 0; i < mask.height(); i++)
+        {
+            for (int j = 0; j < mask.width(); j++)
+            {
+                if (!mask(i, j))
+                {
+                    weights(i, j) = 0.0f;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+}  // namespace aliceVision
@@ -0,0 +1,106 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/types.hpp>
+#include <aliceVision/image/all.hpp>
+#include <aliceVision/camera/camera.hpp>
+#include <aliceVision/geometry/Pose3.hpp>
+
+#include "coordinatesMap.hpp"
+
+#include <map>
+#include <vector>
+
+namespace aliceVision {
+
+/**
+ * @brief Stitching of the synchronized frames of a rig with a fixed calibration.
+ *
+ * The coordinates maps and the seams only depend on the rig calibration: they are computed once,
+ * then each frame is composited with a single gather of the source pixels through feathered seams.
+ * The seams can be refined on the content of a frame with the hierarchical graphcut,
+ * and the blending weights move progressively toward the new seams to avoid popping between frames.
+ */
+class RigStitcher
+{
+  public:
+    /**
+     * @brief Constructor
+     * @param[in] panoramaWidth the width of the panorama
+     * @param[in] panoramaHeight the height of the panorama
+     * @param[in] blendWidth the half width in pixels of the transition across the seams
+     */
+    RigStitcher(int panoramaWidth, int panoramaHeight, int blendWidth)
+      : _panoramaWidth(panoramaWidth),
+        _panoramaHeight(panoramaHeight),
+        _blendWidth(blendWidth)
+    {}
+
+    /**
+     * @brief Add a camera of the rig and compute its coordinates map.
+     * @param[in] cameraId the camera identifier (the rig sub-pose)
+     * @param[in] pose the camera pose
+     * @param[in] intrinsic the camera intrinsics
+     * @return false if the camera is not visible in the panorama
+     */
+    bool addCamera(IndexT cameraId, const geometry::Pose3& pose, const camera::IntrinsicBase& intrinsic);
+
+    /**
+     * @brief Compute the seams from the distance to the center of the cameras, without any transition.
+     */
+    bool computeSeams();
+
+    /**
+     * @brief Refine the seams with a graphcut on the content of a frame.
+     * @param[in] sources the frame images per camera id, in the working color space
+     * @param[in] countLevels the number of levels of the hierarchical graphcut
+     * @param[in] refinementBand the half width of the refinement band of the finer levels (0 to disable)
+     */
+    bool refineSeams(const std::map<IndexT, image::Image<image::RGBfColor>>& sources, int countLevels, int refinementBand);
+
+    /**
+     * @brief Move the blending weights toward the last computed seams. Called once per frame.
+     * @param[in] temporalSmoothing the weight of the current blending weights in [0, 1), 0 to switch directly to the new seams
+     */
+    void advanceSeams(float temporalSmoothing);
+
+    /**
+     * @brief Composite a frame.
+     * @param[out] output the panorama, with a null alpha where no camera is visible
+     * @param[in] sources the frame images per camera id, missing cameras are ignored
+     */
+    bool stitch(image::Image<image::RGBAfColor>& output, const std::map<IndexT, image::Image<image::RGBfColor>>& sources) const;
+
+    const image::Image<IndexT>& getLabels() const { return _labels; }
+
+  private:
+    struct Camera
+    {
+        IndexT id;
+        int sourceWidth;
+        int sourceHeight;
+        CoordinatesMap map;
+        /// distance to the camera center, used for the initial seams
+        image::Image<float> distances;
+        /// blending weights used to composite the frames
+        image::Image<float> blending;
+        /// blending weights of the last computed seams
+        image::Image<float> targetBlending;
+    };
+
+    bool computeTargetBlending(Camera& camera) const;
+
+    std::vector<Camera> _cameras;
+    image::Image<IndexT> _labels;
+
+    int _panoramaWidth;
+    int _panoramaHeight;
+    int _blendWidth;
+};
+
+}  // namespace aliceVision
@@ -351,15 +351,17 @@ bool HierarchicalGraphcutSeams::append(const aliceVision::image::Image<image::RG
                                        size_t offsetY)
 {
     // Make sure input is compatible with pyramid processing
+    // (only the mask is padded, the colors are padded virtually by the feathering)
     int newOffsetX, newOffsetY;
-    aliceVision::image::Image<image::RGBfColor> potImage;
     aliceVision::image::Image<unsigned char> potMask;
-    makeImagePyramidCompatible(potImage, newOffsetX, newOffsetY, input, offsetX, offsetY, 2, _countLevels);
-    makeImagePyramidCompatible(potMask, newOffsetX, newOffsetY, inputMask, offsetX, offsetY, 2, _countLevels);
+    if (!makeImagePyramidCompatible(potMask, newOffsetX, newOffsetY, inputMask, offsetX, offsetY, 2, _countLevels))
+    {
+        return false;
+    }
 
     // Fill Color images masked parts with fake but coherent info
     aliceVision::image::Image<image::RGBfColor> feathered;
-    if (!feathering(feathered, potImage, potMask))
+    if (!feathering(feathered, input, potMask, int(offsetX) - newOffsetX, int(offsetY) - newOffsetY))
     {
         return false;
     }
@@ -440,6 +442,10 @@ bool HierarchicalGraphcutSeams::process()
         {
             _graphcuts[level].setMaximalDistance(sqrt(w * w + h * h));
         }
+        else if (_refinementBand > 0)
+        {
+            _graphcuts[level].setMaximalDistance(_refinementBand);
+        }
         else
         {
             double sw = double(0.2 * w);
@@ -75,11 +75,21 @@ class HierarchicalGraphcutSeams
 
     bool process();
 
+    /**
+     * @brief Coarse-to-fine mode: the seams are solved on the coarsest level,
+     * then each finer level only refines them in a narrow band around the upscaled seams.
+     * The graphs of the finer levels are restricted to this band, which reduces their size by orders of magnitude.
+     * @param[in] band The half width in pixels of the band at each finer level, 0 to let the seams move up to 20% of the level size
+     */
+    void setRefinementBand(int band) { _refinementBand = band; }
+
     image::Image<IndexT>& getLabels() { return _graphcuts[0].getLabels(); }
 
   private:
     std::vector<GraphcutSeams> _graphcuts;
 
+    int _refinementBand = 0;
+
     size_t _countLevels;
     size_t _outputWidth;
     size_t _outputHeight;
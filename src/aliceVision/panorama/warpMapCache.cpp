@@ -0,0 +1,266 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "warpMapCache.hpp"
+
+#include <aliceVision/stl/hash.hpp>
+#include <aliceVision/system/Logger.hpp>
+#include <aliceVision/utils/filesIO.hpp>
+
+#include <filesystem>
+
+namespace aliceVision {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+/// Increase when the content of the cache files changes
+constexpr int warpMapCacheVersion = 1;
+
+/// Cache pixel: source x, source y, validity
+constexpr int warpMapChannels = 3;
+
+}  // namespace
+
+std::size_t WarpMapCache::computeKey(const camera::IntrinsicBase& intrinsics,
+                                     const geometry::Pose3& pose,
+                                     const std::pair<int, int>& panoramaSize,
+                                     int tileSize)
+{
+    std::size_t seed = 0;
+    stl::hash_combine(seed, warpMapCacheVersion);
+    stl::hash_combine(seed, intrinsics.hashValue());
+
+    const Mat3& R = pose.rotation();
+    for (int i = 0; i < 3; i++)
+    {
+        for (int j = 0; j < 3; j++)
+        {
+            stl::hash_combine(seed, R(i, j));
+        }
+    }
+
+    const Vec3& C = pose.center();
+    for (int i = 0; i < 3; i++)
+    {
+        stl::hash_combine(seed, C(i));
+    }
+
+    stl::hash_combine(seed, panoramaSize.first);
+    stl::hash_combine(seed, panoramaSize.second);
+    stl::hash_combine(seed, tileSize);
+
+    return seed;
+}
+
+std::string WarpMapCache::getPath(std::size_t key, int subId) const
+{
+    return (fs::path(_folder) / (std::to_string(key) + "_" + std::to_string(subId) + ".exr")).string();
+}
+
+bool WarpMapCache::find(std::size_t key, std::vector<BoundingBox>& boundingBoxes) const
+{
+    boundingBoxes.clear();
+
+    const std::string firstPath = getPath(key, 0);
+    if (!utils::exists(firstPath))
+    {
+        return false;
+    }
+
+    const int subCount = image::readImageMetadata(firstPath).get_int("AliceVision:warpCacheSubCount", 0);
+    if (subCount <= 0)
+    {
+        return false;
+    }
+
+    for (int idsub = 0; idsub < subCount; idsub++)
+    {
+        const std::string path = getPath(key, idsub);
+        if (!utils::exists(path))
+        {
+            boundingBoxes.clear();
+            return false;
+        }
+
+        const oiio::ParamValueList metadata = image::readImageMetadata(path);
+
+        BoundingBox bbox;
+        bbox.left = metadata.get_int("AliceVision:offsetX");
+        bbox.top = metadata.get_int("AliceVision:offsetY");
+        bbox.width = metadata.get_int("AliceVision:warpWidth");
+        bbox.height = metadata.get_int("AliceVision:warpHeight");
+        boundingBoxes.push_back(bbox);
+    }
+
+    return true;
+}
+
+bool WarpMapReader::open(const std::string& path, const BoundingBox& globalBbox, int tileSize)
+{
+    _input = oiio::ImageInput::open(path);
+    if (!_input)
+    {
+        ALICEVISION_LOG_ERROR("Unable to open the warp map cache file " << path);
+        return false;
+    }
+
+    const oiio::ImageSpec& spec = _input->spec();
+    if (spec.nchannels != warpMapChannels || spec.tile_width != tileSize || spec.tile_height != tileSize)
+    {
+        ALICEVISION_LOG_ERROR("Invalid warp map cache file " << path);
+        _input.reset();
+        return false;
+    }
+
+    _globalBbox = globalBbox;
+    _tileSize = tileSize;
+
+    return true;
+}
+
+bool WarpMapReader::read(CoordinatesMap& map, const BoundingBox& tileBbox)
+{
+    if (!_input || tileBbox.width != _tileSize || tileBbox.height != _tileSize)
+    {
+        return false;
+    }
+
+    std::vector<float> buffer(std::size_t(_tileSize) * _tileSize * warpMapChannels);
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_input->read_tile(tileBbox.left - _globalBbox.left, tileBbox.top - _globalBbox.top, 0, oiio::TypeDesc::FLOAT, buffer.data()))
+        {
+            return false;
+        }
+    }
+
+    image::Image<Eigen::Vector2f> coordinates(_tileSize, _tileSize);
+    image::Image<unsigned char> mask(_tileSize, _tileSize);
+
+    const float* pixel = buffer.data();
+    for (int i = 0; i < _tileSize; i++)
+    {
+        for (int j = 0; j < _tileSize; j++)
+        {
+            coordinates(i, j) = Eigen::Vector2f(pixel[0], pixel[1]);
+            mask(i, j) = (pixel[2] > 0.5f) ? 1 : 0;
+            pixel += warpMapChannels;
+        }
+    }
+
+    return map.set(coordinates, mask, tileBbox.left, tileBbox.top);
+}
+
+WarpMapWriter::~WarpMapWriter()
+{
+    if (_output)
+    {
+        // not closed: the file is incomplete
+        _output->close();
+        _output.reset();
+        fs::remove(_tmpPath);
+    }
+}
+
+bool WarpMapWriter::open(const std::string& path, const BoundingBox& globalBbox, int tileSize, int subCount)
+{
+    const fs::path bPath = fs::path(path);
+    _path = path;
+    _tmpPath = (bPath.parent_path() / bPath.stem()).string() + "." + utils::generateUniqueFilename() + ".exr";
+    _globalBbox = globalBbox;
+    _tileSize = tileSize;
+    _valid = true;
+
+    _output = oiio::ImageOutput::create(_tmpPath);
+    if (!_output)
+    {
+        return false;
+    }
+
+    // The file keeps whole tiles, so that the tiles read back are exactly the computed ones
+    const int width = divideRoundUp(globalBbox.width, tileSize) * tileSize;
+    const int height = divideRoundUp(globalBbox.height, tileSize) * tileSize;
+
+    oiio::ImageSpec spec(width, height, warpMapChannels, oiio::TypeDesc::FLOAT);
+    spec.tile_width = tileSize;
+    spec.tile_height = tileSize;
+    spec.attribute("compression", "zip");
+    spec.attribute("AliceVision:offsetX", globalBbox.left);
+    spec.attribute("AliceVision:offsetY", globalBbox.top);
+    spec.attribute("AliceVision:warpWidth", globalBbox.width);
+    spec.attribute("AliceVision:warpHeight", globalBbox.height);
+    spec.attribute("AliceVision:warpCacheSubCount", subCount);
+
+    if (!_output->open(_tmpPath, spec))
+    {
+        _output.reset();
+        return false;
+    }
+
+    return true;
+}
+
+bool WarpMapWriter::write(const CoordinatesMap& map)
+{
+    const image::Image<Eigen::Vector2f>& coordinates = map.getCoordinates();
+    const image::Image<unsigned char>& mask = map.getMask();
+
+    if (!_output || coordinates.width() != _tileSize || coordinates.height() != _tileSize)
+    {
+        _valid = false;
+        return false;
+    }
+
+    std::vector<float> buffer(std::size_t(_tileSize) * _tileSize * warpMapChannels);
+
+    float* pixel = buffer.data();
+    for (int i = 0; i < _tileSize; i++)
+    {
+        for (int j = 0; j < _tileSize; j++)
+        {
+            const bool valid = mask(i, j);
+            pixel[0] = valid ? coordinates(i, j).x() : 0.0f;
+            pixel[1] = valid ? coordinates(i, j).y() : 0.0f;
+            pixel[2] = valid ? 1.0f : 0.0f;
+            pixel += warpMapChannels;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!_output->write_tile(map.getOffsetX() - _globalBbox.left, map.getOffsetY() - _globalBbox.top, 0, oiio::TypeDesc::FLOAT, buffer.data()))
+    {
+        _valid = false;
+        return false;
+    }
+
+    return true;
+}
+
+bool WarpMapWriter::close()
+{
+    if (!_output)
+    {
+        return false;
+    }
+
+    const bool closed = _output->close();
+    _output.reset();
+
+    if (!closed || !_valid)
+    {
+        fs::remove(_tmpPath);
+        return false;
+    }
+
+    fs::rename(_tmpPath, _path);
+
+    return true;
+}
+
+}  // namespace aliceVision
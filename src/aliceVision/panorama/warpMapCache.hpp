@@ -0,0 +1,137 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/image/all.hpp>
+#include <aliceVision/camera/camera.hpp>
+#include <aliceVision/geometry/Pose3.hpp>
+
+#include "boundingBox.hpp"
+#include "coordinatesMap.hpp"
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace aliceVision {
+
+/**
+ * @brief Persistent cache of the panorama warping maps.
+ *
+ * The coordinates maps of a view only depend on its intrinsics, its pose, the panorama size and the tile size.
+ * They are stored for each warped sub image in a tiled, zip compressed EXR file (source x, source y, validity),
+ * named after a hash of these inputs.
+ * The next runs, as well as the frames of a fixed rig sharing the same calibration, only gather the source pixels.
+ */
+class WarpMapCache
+{
+  public:
+    explicit WarpMapCache(const std::string& folder)
+      : _folder(folder)
+    {}
+
+    /**
+     * @brief Compute the cache key of a view.
+     * @param intrinsics the camera intrinsics
+     * @param pose the camera pose
+     * @param panoramaSize the panorama size
+     * @param tileSize the size of the warping tiles
+     * @return the key
+     */
+    static std::size_t computeKey(const camera::IntrinsicBase& intrinsics,
+                                  const geometry::Pose3& pose,
+                                  const std::pair<int, int>& panoramaSize,
+                                  int tileSize);
+
+    /**
+     * @brief Get the bounding boxes in the panorama of the cached sub images of a key.
+     * @param key the cache key
+     * @param boundingBoxes the bounding box of each sub image
+     * @return false if the key is not (or only partially) in the cache
+     */
+    bool find(std::size_t key, std::vector<BoundingBox>& boundingBoxes) const;
+
+    /**
+     * @brief Get the path of the cache file of a sub image.
+     */
+    std::string getPath(std::size_t key, int subId) const;
+
+  private:
+    std::string _folder;
+};
+
+/**
+ * @brief Read the cached coordinates maps of a sub image, tile by tile.
+ * @note read is thread safe
+ */
+class WarpMapReader
+{
+  public:
+    /**
+     * @brief Open a cache file.
+     * @param path the cache file of the sub image
+     * @param globalBbox the bounding box of the sub image in the panorama
+     * @param tileSize the size of the warping tiles
+     */
+    bool open(const std::string& path, const BoundingBox& globalBbox, int tileSize);
+
+    /**
+     * @brief Read the coordinates map of a tile.
+     * @param map the output coordinates map
+     * @param tileBbox the bounding box of the tile in the panorama, aligned on the tiles of the sub image
+     */
+    bool read(CoordinatesMap& map, const BoundingBox& tileBbox);
+
+  private:
+    std::unique_ptr<oiio::ImageInput> _input;
+    BoundingBox _globalBbox;
+    int _tileSize = 0;
+    std::mutex _mutex;
+};
+
+/**
+ * @brief Write the coordinates maps of a sub image in a cache file, tile by tile.
+ * The file is written under a temporary name and only renamed on close, so a partial file is never used.
+ * @note write is thread safe
+ */
+class WarpMapWriter
+{
+  public:
+    ~WarpMapWriter();
+
+    /**
+     * @brief Create a cache file.
+     * @param path the cache file of the sub image
+     * @param globalBbox the bounding box of the sub image in the panorama
+     * @param tileSize the size of the warping tiles
+     * @param subCount the number of sub images of the view
+     */
+    bool open(const std::string& path, const BoundingBox& globalBbox, int tileSize, int subCount);
+
+    /**
+     * @brief Write the coordinates map of a tile.
+     * @param map the coordinates map of a tile, aligned on the tiles of the sub image
+     */
+    bool write(const CoordinatesMap& map);
+
+    /**
+     * @brief Finalize the cache file.
+     */
+    bool close();
+
+  private:
+    std::unique_ptr<oiio::ImageOutput> _output;
+    std::string _path;
+    std::string _tmpPath;
+    BoundingBox _globalBbox;
+    int _tileSize = 0;
+    bool _valid = true;
+    std::mutex _mutex;
+};
+
+}  // namespace aliceVision
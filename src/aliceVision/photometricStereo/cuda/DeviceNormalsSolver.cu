@@ -0,0 +1,175 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "DeviceNormalsSolver.hpp"
+
+#include <cuda_runtime.h>
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+#define CHECK_PHOTOMETRIC_CUDA_ERROR(err)                                                                                                            \
+    if (err != cudaSuccess)                                                                                                                          \
+    {                                                                                                                                                \
+        std::stringstream s;                                                                                                                         \
+        s << "\n  CUDA Error: " << cudaGetErrorString(err) << "\n  file:  " << __FILE__ << "\n  function:   " << __FUNCTION__                        \
+          << "\n  line:       " << __LINE__ << "\n";                                                                                                 \
+        throw std::runtime_error(s.str());                                                                                                           \
+    }
+
+namespace aliceVision {
+namespace photometricStereo {
+namespace cuda {
+
+/// Number of threads per block, one thread per pixel
+constexpr int BLOCK_SIZE = 256;
+
+/// Maximal number of unknowns per pixel (second order spherical harmonics)
+constexpr int MAX_DIM = 9;
+
+/**
+ * @brief Product of the pseudo-inverse with the intensities of each pixel, one thread per pixel.
+ */
+__global__ void solveNormals_kernel(const float* pseudoInverse,
+                                    int dim,
+                                    int nbLights,
+                                    const float* intensities,
+                                    std::size_t nbPixels,
+                                    bool normalize,
+                                    float* out_solutions,
+                                    float* out_norms)
+{
+    const std::size_t id = std::size_t(blockIdx.x) * blockDim.x + threadIdx.x;
+    if (id >= nbPixels)
+        return;
+
+    const float* pixel = intensities + id * nbLights;
+
+    float solution[MAX_DIM];
+    float squaredNorm = 0.0f;
+    for (int d = 0; d < dim; ++d)
+    {
+        float value = 0.0f;
+        for (int l = 0; l < nbLights; ++l)
+        {
+            // column major pseudo-inverse
+            value += pseudoInverse[l * dim + d] * pixel[l];
+        }
+        solution[d] = value;
+        squaredNorm += value * value;
+    }
+
+    const float norm = sqrtf(squaredNorm);
+    out_norms[id] = norm;
+
+    float* result = out_solutions + id * dim;
+    for (int d = 0; d < dim; ++d)
+    {
+        // same as the CPU: a null solution gives NaN normals
+        result[d] = normalize ? solution[d] / norm : solution[d];
+    }
+}
+
+DeviceNormalsSolver::~DeviceNormalsSolver()
+{
+    // no throw in destructor
+    cudaFree(_pseudoInverse);
+    cudaFree(_intensities);
+    cudaFree(_solutions);
+    cudaFree(_norms);
+}
+
+void DeviceNormalsSolver::setPseudoInverse(const float* pseudoInverse, int dim, int nbLights)
+{
+    if (dim <= 0 || dim > MAX_DIM || nbLights <= 0)
+    {
+        throw std::invalid_argument("DeviceNormalsSolver: invalid lighting matrix size.");
+    }
+
+    if (dim * nbLights > _dim * _nbLights)
+    {
+        CHECK_PHOTOMETRIC_CUDA_ERROR(cudaFree(_pseudoInverse));
+        _pseudoInverse = nullptr;
+        CHECK_PHOTOMETRIC_CUDA_ERROR(cudaMalloc(&_pseudoInverse, std::size_t(dim) * nbLights * sizeof(float)));
+    }
+
+    // the pixels buffers depend on the sizes
+    if (dim != _dim || nbLights != _nbLights)
+    {
+        CHECK_PHOTOMETRIC_CUDA_ERROR(cudaFree(_intensities));
+        CHECK_PHOTOMETRIC_CUDA_ERROR(cudaFree(_solutions));
+        CHECK_PHOTOMETRIC_CUDA_ERROR(cudaFree(_norms));
+        _intensities = nullptr;
+        _solutions = nullptr;
+        _norms = nullptr;
+        _pixelsCapacity = 0;
+    }
+
+    _dim = dim;
+    _nbLights = nbLights;
+
+    CHECK_PHOTOMETRIC_CUDA_ERROR(cudaMemcpy(_pseudoInverse, pseudoInverse, std::size_t(dim) * nbLights * sizeof(float), cudaMemcpyHostToDevice));
+}
+
+void DeviceNormalsSolver::allocatePixels(std::size_t nbPixels)
+{
+    if (nbPixels <= _pixelsCapacity)
+        return;
+
+    CHECK_PHOTOMETRIC_CUDA_ERROR(cudaFree(_intensities));
+    CHECK_PHOTOMETRIC_CUDA_ERROR(cudaFree(_solutions));
+    CHECK_PHOTOMETRIC_CUDA_ERROR(cudaFree(_norms));
+    _intensities = nullptr;
+    _solutions = nullptr;
+    _norms = nullptr;
+
+    _pixelsCapacity = nbPixels;
+
+    CHECK_PHOTOMETRIC_CUDA_ERROR(cudaMalloc(&_intensities, _pixelsCapacity * _nbLights * sizeof(float)));
+    CHECK_PHOTOMETRIC_CUDA_ERROR(cudaMalloc(&_solutions, _pixelsCapacity * _dim * sizeof(float)));
+    CHECK_PHOTOMETRIC_CUDA_ERROR(cudaMalloc(&_norms, _pixelsCapacity * sizeof(float)));
+}
+
+void DeviceNormalsSolver::solve(const float* intensities, std::size_t nbPixels, bool normalize, float* solutions, float* norms)
+{
+    if (_dim == 0)
+    {
+        throw std::logic_error("DeviceNormalsSolver: the pseudo-inverse is not set.");
+    }
+
+    if (nbPixels == 0)
+        return;
+
+    allocatePixels(std::min(nbPixels, maxBatchPixels));
+
+    for (std::size_t begin = 0; begin < nbPixels; begin += maxBatchPixels)
+    {
+        const std::size_t batchPixels = std::min(maxBatchPixels, nbPixels - begin);
+
+        CHECK_PHOTOMETRIC_CUDA_ERROR(
+          cudaMemcpy(_intensities, intensities + begin * _nbLights, batchPixels * _nbLights * sizeof(float), cudaMemcpyHostToDevice));
+
+        const int nbBlocks = int((batchPixels + BLOCK_SIZE - 1) / BLOCK_SIZE);
+        solveNormals_kernel<<<nbBlocks, BLOCK_SIZE>>>(_pseudoInverse, _dim, _nbLights, _intensities, batchPixels, normalize, _solutions, _norms);
+
+        CHECK_PHOTOMETRIC_CUDA_ERROR(cudaGetLastError());
+
+        if (solutions != nullptr)
+        {
+            CHECK_PHOTOMETRIC_CUDA_ERROR(
+              cudaMemcpy(solutions + begin * _dim, _solutions, batchPixels * _dim * sizeof(float), cudaMemcpyDeviceToHost));
+        }
+        if (norms != nullptr)
+        {
+            CHECK_PHOTOMETRIC_CUDA_ERROR(cudaMemcpy(norms + begin, _norms, batchPixels * sizeof(float), cudaMemcpyDeviceToHost));
+        }
+    }
+}
+
+}  // namespace cuda
+}  // namespace photometricStereo
+}  // namespace aliceVision
@@ -0,0 +1,75 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <cstddef>
+
+namespace aliceVision {
+namespace photometricStereo {
+namespace cuda {
+
+/**
+ * @class DeviceNormalsSolver
+ * @brief Per pixel least squares solve of the photometric stereo on the GPU.
+ *
+ * All the pixels share the same lighting matrix, so the least squares solution of each pixel
+ * is the product of the pseudo-inverse of the lighting matrix with the pixel intensities.
+ * The pseudo-inverse is computed once on the host and stays resident on the device,
+ * then the pixels are solved in batches, one thread per pixel.
+ */
+class DeviceNormalsSolver
+{
+  public:
+    /// Maximal number of pixels solved in a single launch
+    static constexpr std::size_t maxBatchPixels = std::size_t(1) << 22;
+
+    DeviceNormalsSolver() = default;
+    ~DeviceNormalsSolver();
+
+    // no copy
+    DeviceNormalsSolver(const DeviceNormalsSolver&) = delete;
+    DeviceNormalsSolver& operator=(const DeviceNormalsSolver&) = delete;
+
+    /**
+     * @brief Upload the pseudo-inverse of the lighting matrix to the device.
+     * @param[in] pseudoInverse The host pseudo-inverse, column major, dim * nbLights
+     * @param[in] dim The number of unknowns per pixel (3 for directional lights, 9 for second order spherical harmonics)
+     * @param[in] nbLights The number of lights
+     */
+    void setPseudoInverse(const float* pseudoInverse, int dim, int nbLights);
+
+    /**
+     * @brief Solve the least squares problem of a set of pixels.
+     * @param[in] intensities The host intensities, column major, nbLights * nbPixels (the values of a pixel are contiguous)
+     * @param[in] nbPixels The number of pixels
+     * @param[in] normalize Normalize the solutions
+     * @param[out] solutions The host solutions, column major, dim * nbPixels (can be nullptr)
+     * @param[out] norms The host norms of the solutions before normalization, nbPixels (can be nullptr)
+     */
+    void solve(const float* intensities, std::size_t nbPixels, bool normalize, float* solutions, float* norms);
+
+  private:
+    /**
+     * @brief Ensure that the device pixels buffers can hold the given number of pixels.
+     * @param[in] nbPixels The number of pixels of the batch
+     */
+    void allocatePixels(std::size_t nbPixels);
+
+    float* _pseudoInverse = nullptr;
+    int _dim = 0;
+    int _nbLights = 0;
+
+    // pixels buffers, reused between calls
+    float* _intensities = nullptr;
+    float* _solutions = nullptr;
+    float* _norms = nullptr;
+    std::size_t _pixelsCapacity = 0;
+};
+
+}  // namespace cuda
+}  // namespace photometricStereo
+}  // namespace aliceVision
@@ -0,0 +1,546 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "DevicePoissonSolver.hpp"
+
+#include <cuda_runtime.h>
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+
+#define CHECK_PHOTOMETRIC_CUDA_ERROR(err)                                                                                                            \
+    if (err != cudaSuccess)                                                                                                                          \
+    {                                                                                                                                                \
+        std::stringstream s;                                                                                                                         \
+        s << "\n  CUDA Error: " << cudaGetErrorString(err) << "\n  file:  " << __FILE__ << "\n  function:   " << __FUNCTION__                        \
+          << "\n  line:       " << __LINE__ << "\n";                                                                                                 \
+        throw std::runtime_error(s.str());                                                                                                           \
+    }
+
+namespace aliceVision {
+namespace photometricStereo {
+namespace cuda {
+
+/// Number of threads per block, one thread per cell
+constexpr int BLOCK_SIZE = 256;
+
+/// Number of blocks of the reductions, the partial sums are added on the host
+constexpr int REDUCTION_BLOCKS = 1024;
+
+/// Weight of the Jacobi smoother
+constexpr float JACOBI_WEIGHT = 0.8f;
+
+/// Number of pre and post smoothing iterations of the V-cycle
+constexpr int SMOOTHING_ITERATIONS = 2;
+
+/// Number of smoothing iterations on the coarsest level
+constexpr int COARSEST_ITERATIONS = 50;
+
+/// Size under which a level is not coarsened anymore
+constexpr int COARSEST_SIZE = 4;
+
+/// The piecewise constant prolongation underestimates the coarse correction by half
+constexpr float PROLONGATION_SCALE = 2.0f;
+
+inline int nbBlocks(std::size_t size) { return int((size + BLOCK_SIZE - 1) / BLOCK_SIZE); }
+
+/**
+ * @brief Edge weights of the finest level: every edge inside the grid has a unit weight.
+ */
+__global__ void initWeights_kernel(float* weightsX, float* weightsY, int width, int height)
+{
+    const std::size_t id = std::size_t(blockIdx.x) * blockDim.x + threadIdx.x;
+    if (id >= std::size_t(width) * height)
+        return;
+
+    const int i = int(id / width);
+    const int j = int(id % width);
+
+    weightsX[id] = (j + 1 < width) ? 1.0f : 0.0f;
+    weightsY[id] = (i + 1 < height) ? 1.0f : 0.0f;
+}
+
+/**
+ * @brief Galerkin coarse edge weights: sum of the fine edges between two coarse cells.
+ */
+__global__ void coarsenWeights_kernel(const float* fineWeightsX,
+                                      const float* fineWeightsY,
+                                      int fineWidth,
+                                      int fineHeight,
+                                      float* coarseWeightsX,
+                                      float* coarseWeightsY,
+                                      int coarseWidth,
+                                      int coarseHeight)
+{
+    const std::size_t id = std::size_t(blockIdx.x) * blockDim.x + threadIdx.x;
+    if (id >= std::size_t(coarseWidth) * coarseHeight)
+        return;
+
+    const int I = int(id / coarseWidth);
+    const int J = int(id % coarseWidth);
+
+    float sumX = 0.0f;
+    float sumY = 0.0f;
+    for (int k = 0; k < 2; ++k)
+    {
+        // fine edges crossing the right side of the coarse cell
+        const int iX = 2 * I + k;
+        const int jX = 2 * J + 1;
+        if (iX < fineHeight && jX < fineWidth)
+            sumX += fineWeightsX[std::size_t(iX) * fineWidth + jX];
+
+        // fine edges crossing the bottom side of the coarse cell
+        const int iY = 2 * I + 1;
+        const int jY = 2 * J + k;
+        if (iY < fineHeight && jY < fineWidth)
+            sumY += fineWeightsY[std::size_t(iY) * fineWidth + jY];
+    }
+
+    coarseWeightsX[id] = sumX;
+    coarseWeightsY[id] = sumY;
+}
+
+__global__ void diagonal_kernel(const float* weightsX, const float* weightsY, float* diagonal, int width, int height)
+{
+    const std::size_t id = std::size_t(blockIdx.x) * blockDim.x + threadIdx.x;
+    if (id >= std::size_t(width) * height)
+        return;
+
+    const int i = int(id / width);
+    const int j = int(id % width);
+
+    float sum = weightsX[id] + weightsY[id];
+    if (j > 0)
+        sum += weightsX[id - 1];
+    if (i > 0)
+        sum += weightsY[id - width];
+
+    diagonal[id] = sum;
+}
+
+__device__ inline float applyOperatorAt(const float* weightsX, const float* weightsY, const float* diagonal, const float* z, int width, int height, std::size_t id)
+{
+    const int i = int(id / width);
+    const int j = int(id % width);
+
+    float value = diagonal[id] * z[id];
+    if (j + 1 < width)
+        value -= weightsX[id] * z[id + 1];
+    if (j > 0)
+        value -= weightsX[id - 1] * z[id - 1];
+    if (i + 1 < height)
+        value -= weightsY[id] * z[id + width];
+    if (i > 0)
+        value -= weightsY[id - width] * z[id - width];
+
+    return value;
+}
+
+__global__ void applyOperator_kernel(const float* weightsX, const float* weightsY, const float* diagonal, const float* in, float* out, int width, int height)
+{
+    const std::size_t id = std::size_t(blockIdx.x) * blockDim.x + threadIdx.x;
+    if (id >= std::size_t(width) * height)
+        return;
+
+    out[id] = applyOperatorAt(weightsX, weightsY, diagonal, in, width, height, id);
+}
+
+__global__ void residual_kernel(const float* weightsX,
+                                const float* weightsY,
+                                const float* diagonal,
+                                const float* x,
+                                const float* b,
+                                float* r,
+                                int width,
+                                int height)
+{
+    const std::size_t id = std::size_t(blockIdx.x) * blockDim.x + threadIdx.x;
+    if (id >= std::size_t(width) * height)
+        return;
+
+    r[id] = b[id] - applyOperatorAt(weightsX, weightsY, diagonal, x, width, height, id);
+}
+
+__global__ void jacobi_kernel(const float* diagonal, const float* r, float* x, std::size_t size)
+{
+    const std::size_t id = std::size_t(blockIdx.x) * blockDim.x + threadIdx.x;
+    if (id >= size)
+        return;
+
+    if (diagonal[id] > 0.0f)
+        x[id] += JACOBI_WEIGHT * r[id] / diagonal[id];
+}
+
+/**
+ * @brief Restriction of the residual: sum of the 2x2 fine cells of each coarse cell (transpose of the prolongation).
+ */
+__global__ void restrict_kernel(const float* fineResidual, int fineWidth, int fineHeight, float* coarseB, int coarseWidth, int coarseHeight)
+{
+    const std::size_t id = std::size_t(blockIdx.x) * blockDim.x + threadIdx.x;
+    if (id >= std::size_t(coarseWidth) * coarseHeight)
+        return;
+
+    const int I = int(id / coarseWidth);
+    const int J = int(id % coarseWidth);
+
+    float sum = 0.0f;
+    for (int a = 0; a < 2; ++a)
+    {
+        for (int c = 0; c < 2; ++c)
+        {
+            const int i = 2 * I + a;
+            const int j = 2 * J + c;
+            if (i < fineHeight && j < fineWidth)
+                sum += fineResidual[std::size_t(i) * fineWidth + j];
+        }
+    }
+
+    coarseB[id] = sum;
+}
+
+/**
+ * @brief Piecewise constant prolongation of the coarse correction.
+ */
+__global__ void prolongate_kernel(const float* coarseX, int coarseWidth, float* fineX, int fineWidth, int fineHeight)
+{
+    const std::size_t id = std::size_t(blockIdx.x) * blockDim.x + threadIdx.x;
+    if (id >= std::size_t(fineWidth) * fineHeight)
+        return;
+
+    const int i = int(id / fineWidth);
+    const int j = int(id % fineWidth);
+
+    fineX[id] += PROLONGATION_SCALE * coarseX[std::size_t(i / 2) * coarseWidth + j / 2];
+}
+
+/**
+ * @brief Partial sums of the products of two vectors (or of a single vector if b is null), one per block.
+ */
+__global__ void partialDot_kernel(const float* a, const float* b, std::size_t size, double* partialSums)
+{
+    __shared__ double cache[BLOCK_SIZE];
+
+    double sum = 0.0;
+    for (std::size_t id = std::size_t(blockIdx.x) * blockDim.x + threadIdx.x; id < size; id += std::size_t(blockDim.x) * gridDim.x)
+    {
+        sum += (b == nullptr) ? double(a[id]) : double(a[id]) * double(b[id]);
+    }
+
+    cache[threadIdx.x] = sum;
+    __syncthreads();
+
+    for (int s = blockDim.x / 2; s > 0; s /= 2)
+    {
+        if (threadIdx.x < s)
+            cache[threadIdx.x] += cache[threadIdx.x + s];
+        __syncthreads();
+    }
+
+    if (threadIdx.x == 0)
+        partialSums[blockIdx.x] = cache[0];
+}
+
+__global__ void addConstant_kernel(float* a, float value, std::size_t size)
+{
+    const std::size_t id = std::size_t(blockIdx.x) * blockDim.x + threadIdx.x;
+    if (id >= size)
+        return;
+
+    a[id] += value;
+}
+
+/**
+ * @brief x += alpha * p and r -= alpha * Ap
+ */
+__global__ void updateSolution_kernel(float* x, float* r, const float* p, const float* Ap, float alpha, std::size_t size)
+{
+    const std::size_t id = std::size_t(blockIdx.x) * blockDim.x + threadIdx.x;
+    if (id >= size)
+        return;
+
+    x[id] += alpha * p[id];
+    r[id] -= alpha * Ap[id];
+}
+
+/**
+ * @brief p = z + beta * p
+ */
+__global__ void updateDirection_kernel(float* p, const float* z, float beta, std::size_t size)
+{
+    const std::size_t id = std::size_t(blockIdx.x) * blockDim.x + threadIdx.x;
+    if (id >= size)
+        return;
+
+    p[id] = z[id] + beta * p[id];
+}
+
+DevicePoissonSolver::~DevicePoissonSolver()
+{
+    // no throw in destructor
+    for (Level& level : _levels)
+    {
+        cudaFree(level.weightsX);
+        cudaFree(level.weightsY);
+        cudaFree(level.diagonal);
+        cudaFree(level.x);
+        cudaFree(level.b);
+        cudaFree(level.r);
+    }
+    cudaFree(_solution);
+    cudaFree(_residual);
+    cudaFree(_direction);
+    cudaFree(_preconditioned);
+    cudaFree(_product);
+    cudaFree(_partialSums);
+}
+
+void DevicePoissonSolver::release()
+{
+    for (Level& level : _levels)
+    {
+        CHECK_PHOTOMETRIC_CUDA_ERROR(cudaFree(level.weightsX));
+        CHECK_PHOTOMETRIC_CUDA_ERROR(cudaFree(level.weightsY));
+        CHECK_PHOTOMETRIC_CUDA_ERROR(cudaFree(level.diagonal));
+        CHECK_PHOTOMETRIC_CUDA_ERROR(cudaFree(level.x));
+        CHECK_PHOTOMETRIC_CUDA_ERROR(cudaFree(level.b));
+        CHECK_PHOTOMETRIC_CUDA_ERROR(cudaFree(level.r));
+    }
+    _levels.clear();
+
+    CHECK_PHOTOMETRIC_CUDA_ERROR(cudaFree(_solution));
+    CHECK_PHOTOMETRIC_CUDA_ERROR(cudaFree(_residual));
+    CHECK_PHOTOMETRIC_CUDA_ERROR(cudaFree(_direction));
+    CHECK_PHOTOMETRIC_CUDA_ERROR(cudaFree(_preconditioned));
+    CHECK_PHOTOMETRIC_CUDA_ERROR(cudaFree(_product));
+    _solution = nullptr;
+    _residual = nullptr;
+    _direction = nullptr;
+    _preconditioned = nullptr;
+    _product = nullptr;
+}
+
+void DevicePoissonSolver::setSize(int width, int height)
+{
+    if (width <= 0 || height <= 0)
+    {
+        throw std::invalid_argument("DevicePoissonSolver: invalid grid size.");
+    }
+
+    if (!_levels.empty() && _levels.front().width == width && _levels.front().height == height)
+        return;
+
+    release();
+
+    int levelWidth = width;
+    int levelHeight = height;
+    while (true)
+    {
+        Level level;
+        level.width = levelWidth;
+        level.height = levelHeight;
+
+        const std::size_t size = std::size_t(levelWidth) * levelHeight;
+        CHECK_PHOTOMETRIC_CUDA_ERROR(cudaMalloc(&level.weightsX, size * sizeof(float)));
+        CHECK_PHOTOMETRIC_CUDA_ERROR(cudaMalloc(&level.weightsY, size * sizeof(float)));
+        CHECK_PHOTOMETRIC_CUDA_ERROR(cudaMalloc(&level.diagonal, size * sizeof(float)));
+        CHECK_PHOTOMETRIC_CUDA_ERROR(cudaMalloc(&level.x, size * sizeof(float)));
+        CHECK_PHOTOMETRIC_CUDA_ERROR(cudaMalloc(&level.b, size * sizeof(float)));
+        CHECK_PHOTOMETRIC_CUDA_ERROR(cudaMalloc(&level.r, size * sizeof(float)));
+
+        if (_levels.empty())
+        {
+            initWeights_kernel<<<nbBlocks(size), BLOCK_SIZE>>>(level.weightsX, level.weightsY, levelWidth, levelHeight);
+        }
+        else
+        {
+            const Level& fine = _levels.back();
+            coarsenWeights_kernel<<<nbBlocks(size), BLOCK_SIZE>>>(
+              fine.weightsX, fine.weightsY, fine.width, fine.height, level.weightsX, level.weightsY, levelWidth, levelHeight);
+        }
+        CHECK_PHOTOMETRIC_CUDA_ERROR(cudaGetLastError());
+
+        diagonal_kernel<<<nbBlocks(size), BLOCK_SIZE>>>(level.weightsX, level.weightsY, level.diagonal, levelWidth, levelHeight);
+        CHECK_PHOTOMETRIC_CUDA_ERROR(cudaGetLastError());
+
+        _levels.push_back(level);
+
+        if (std::min(levelWidth, levelHeight) <= COARSEST_SIZE)
+            break;
+
+        levelWidth = (levelWidth + 1) / 2;
+        levelHeight = (levelHeight + 1) / 2;
+    }
+
+    const std::size_t size = std::size_t(width) * height;
+    CHECK_PHOTOMETRIC_CUDA_ERROR(cudaMalloc(&_solution, size * sizeof(float)));
+    CHECK_PHOTOMETRIC_CUDA_ERROR(cudaMalloc(&_residual, size * sizeof(float)));
+    CHECK_PHOTOMETRIC_CUDA_ERROR(cudaMalloc(&_direction, size * sizeof(float)));
+    CHECK_PHOTOMETRIC_CUDA_ERROR(cudaMalloc(&_preconditioned, size * sizeof(float)));
+    CHECK_PHOTOMETRIC_CUDA_ERROR(cudaMalloc(&_product, size * sizeof(float)));
+
+    if (_partialSums == nullptr)
+    {
+        CHECK_PHOTOMETRIC_CUDA_ERROR(cudaMalloc(&_partialSums, REDUCTION_BLOCKS * sizeof(double)));
+        _hostPartialSums.resize(REDUCTION_BLOCKS);
+    }
+}
+
+void DevicePoissonSolver::applyOperator(const Level& level, const float* in, float* out)
+{
+    applyOperator_kernel<<<nbBlocks(std::size_t(level.width) * level.height), BLOCK_SIZE>>>(
+      level.weightsX, level.weightsY, level.diagonal, in, out, level.width, level.height);
+    CHECK_PHOTOMETRIC_CUDA_ERROR(cudaGetLastError());
+}
+
+void DevicePoissonSolver::residual(Level& level)
+{
+    residual_kernel<<<nbBlocks(std::size_t(level.width) * level.height), BLOCK_SIZE>>>(
+      level.weightsX, level.weightsY, level.diagonal, level.x, level.b, level.r, level.width, level.height);
+    CHECK_PHOTOMETRIC_CUDA_ERROR(cudaGetLastError());
+}
+
+void DevicePoissonSolver::smooth(Level& level, int nbIterations)
+{
+    const std::size_t size = std::size_t(level.width) * level.height;
+
+    for (int k = 0; k < nbIterations; ++k)
+    {
+        residual(level);
+        jacobi_kernel<<<nbBlocks(size), BLOCK_SIZE>>>(level.diagonal, level.r, level.x, size);
+        CHECK_PHOTOMETRIC_CUDA_ERROR(cudaGetLastError());
+    }
+}
+
+void DevicePoissonSolver::vcycle(std::size_t levelIndex)
+{
+    Level& level = _levels[levelIndex];
+    const std::size_t size = std::size_t(level.width) * level.height;
+
+    CHECK_PHOTOMETRIC_CUDA_ERROR(cudaMemset(level.x, 0, size * sizeof(float)));
+
+    if (levelIndex + 1 == _levels.size())
+    {
+        smooth(level, COARSEST_ITERATIONS);
+        return;
+    }
+
+    smooth(level, SMOOTHING_ITERATIONS);
+    residual(level);
+
+    Level& coarse = _levels[levelIndex + 1];
+    restrict_kernel<<<nbBlocks(std::size_t(coarse.width) * coarse.height), BLOCK_SIZE>>>(
+      level.r, level.width, level.height, coarse.b, coarse.width, coarse.height);
+    CHECK_PHOTOMETRIC_CUDA_ERROR(cudaGetLastError());
+
+    vcycle(levelIndex + 1);
+
+    prolongate_kernel<<<nbBlocks(size), BLOCK_SIZE>>>(coarse.x, coarse.width, level.x, level.width, level.height);
+    CHECK_PHOTOMETRIC_CUDA_ERROR(cudaGetLastError());
+
+    smooth(level, SMOOTHING_ITERATIONS);
+}
+
+double DevicePoissonSolver::dot(const float* a, const float* b, std::size_t size)
+{
+    partialDot_kernel<<<REDUCTION_BLOCKS, BLOCK_SIZE>>>(a, b, size, _partialSums);
+    CHECK_PHOTOMETRIC_CUDA_ERROR(cudaGetLastError());
+
+    CHECK_PHOTOMETRIC_CUDA_ERROR(cudaMemcpy(_hostPartialSums.data(), _partialSums, REDUCTION_BLOCKS * sizeof(double), cudaMemcpyDeviceToHost));
+
+    double sum = 0.0;
+    for (const double partialSum : _hostPartialSums)
+        sum += partialSum;
+
+    return sum;
+}
+
+void DevicePoissonSolver::removeMean(float* a, std::size_t size)
+{
+    const double mean = dot(a, nullptr, size) / double(size);
+
+    addConstant_kernel<<<nbBlocks(size), BLOCK_SIZE>>>(a, float(-mean), size);
+    CHECK_PHOTOMETRIC_CUDA_ERROR(cudaGetLastError());
+}
+
+void DevicePoissonSolver::precondition(const float* in, float* out)
+{
+    Level& finest = _levels.front();
+    const std::size_t size = std::size_t(finest.width) * finest.height;
+
+    CHECK_PHOTOMETRIC_CUDA_ERROR(cudaMemcpy(finest.b, in, size * sizeof(float), cudaMemcpyDeviceToDevice));
+    vcycle(0);
+    CHECK_PHOTOMETRIC_CUDA_ERROR(cudaMemcpy(out, finest.x, size * sizeof(float), cudaMemcpyDeviceToDevice));
+
+    // stay orthogonal to the null space of the Laplacian
+    removeMean(out, size);
+}
+
+int DevicePoissonSolver::solve(const float* f, float* z, float tolerance, int maxIterations)
+{
+    if (_levels.empty())
+    {
+        throw std::logic_error("DevicePoissonSolver: the grid size is not set.");
+    }
+
+    const Level& finest = _levels.front();
+    const std::size_t size = std::size_t(finest.width) * finest.height;
+
+    float* x = _solution;
+    float* Ap = _product;
+
+    // b is projected on the range of the Laplacian, r = b since x = 0
+    CHECK_PHOTOMETRIC_CUDA_ERROR(cudaMemcpy(_residual, f, size * sizeof(float), cudaMemcpyHostToDevice));
+    removeMean(_residual, size);
+    CHECK_PHOTOMETRIC_CUDA_ERROR(cudaMemset(x, 0, size * sizeof(float)));
+
+    const double normB = std::sqrt(dot(_residual, _residual, size));
+    int iteration = 0;
+
+    if (normB > 0.0)
+    {
+        precondition(_residual, _preconditioned);
+        CHECK_PHOTOMETRIC_CUDA_ERROR(cudaMemcpy(_direction, _preconditioned, size * sizeof(float), cudaMemcpyDeviceToDevice));
+        double rz = dot(_residual, _preconditioned, size);
+
+        for (; iteration < maxIterations; ++iteration)
+        {
+            applyOperator(finest, _direction, Ap);
+            const double pAp = dot(_direction, Ap, size);
+            if (pAp <= 0.0)
+                break;
+
+            const float alpha = float(rz / pAp);
+            updateSolution_kernel<<<nbBlocks(size), BLOCK_SIZE>>>(x, _residual, _direction, Ap, alpha, size);
+            CHECK_PHOTOMETRIC_CUDA_ERROR(cudaGetLastError());
+
+            const double normR = std::sqrt(dot(_residual, _residual, size));
+            if (normR <= tolerance * normB)
+            {
+                ++iteration;
+                break;
+            }
+
+            precondition(_residual, _preconditioned);
+            const double rzNext = dot(_residual, _preconditioned, size);
+            const float beta = float(rzNext / rz);
+            rz = rzNext;
+
+            updateDirection_kernel<<<nbBlocks(size), BLOCK_SIZE>>>(_direction, _preconditioned, beta, size);
+            CHECK_PHOTOMETRIC_CUDA_ERROR(cudaGetLastError());
+        }
+    }
+
+    removeMean(x, size);
+    CHECK_PHOTOMETRIC_CUDA_ERROR(cudaMemcpy(z, x, size * sizeof(float), cudaMemcpyDeviceToHost));
+
+    return iteration;
+}
+
+}  // namespace cuda
+}  // namespace photometricStereo
+}  // namespace aliceVision
@@ -28,11 +28,23 @@
 
 #include "photometricDataIO.hpp"
 #include "normalIntegration.hpp"
+#include "poissonSolver.hpp"
+
+#include <aliceVision/config.hpp>
+
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
+    #include <aliceVision/photometricStereo/cuda/DevicePoissonSolver.hpp>
+#endif
 
 namespace aliceVision {
 namespace photometricStereo {
 
-void normalIntegration(const std::string& inputPath, const bool& perspective, const int& downscale, const std::string& outputFolder)
+void normalIntegration(const std::string& inputPath,
+                       const bool& perspective,
+                       const int& downscale,
+                       const std::string& outputFolder,
+                       EIntegrationSolver solver,
+                       bool useGpu)
 {
     std::string normalMapPath = inputPath + "/normals.png";
     std::string pathToK = inputPath + "/K.txt";
@@ -67,7 +79,7 @@ void normalIntegration(const std::string& inputPath, const bool& perspective, co
 
     image::Image<float> depthMap(nbCols, nbRows);
     image::Image<float> distanceMap(nbCols, nbRows);
-    DCTIntegration(normalsImPNG2, depthMap, perspective, K, normalsMask);
+    DCTIntegration(normalsImPNG2, depthMap, perspective, K, normalsMask, solver, useGpu);
 
     // AliceVision uses distance-to-origin convention
     convertZtoDistance(depthMap, distanceMap, K);
@@ -84,7 +96,9 @@ void normalIntegration(const sfmData::SfMData& sfmData,
                        const std::string& inputPath,
                        const bool& perspective,
                        const int& downscale,
-                       const std::string& outputFolder)
+                       const std::string& outputFolder,
+                       EIntegrationSolver solver,
+                       bool useGpu)
 {
     image::Image<image::RGBColor> normalsImPNG;
 
@@ -176,7 +190,7 @@ void normalIntegration(const sfmData::SfMData& sfmData,
             image::Image<float> depthMap;
 
             aliceVision::image::Image<float> distanceMap;
-            DCTIntegration(normalsImPNG2, depthMap, perspective, K, normalsMask);
+            DCTIntegration(normalsImPNG2, depthMap, perspective, K, normalsMask, solver, useGpu);
             image::Image<float> z0(nbCols, nbRows);
             image::Image<float> maskZ0(nbCols, nbRows);
             getZ0FromLandmarks(sfmData, z0, maskZ0, viewId, normalsMask);
@@ -262,7 +276,7 @@ void normalIntegration(const sfmData::SfMData& sfmData,
 
         // Main fonction
         image::Image<float> depthMap(nbCols, nbRows);
-        DCTIntegration(normalsImPNG2, depthMap, perspective, K, normalsMask);
+        DCTIntegration(normalsImPNG2, depthMap, perspective, K, normalsMask, solver, useGpu);
 
         // AliceVision uses distance-to-origin convention
         image::Image<float> distanceMap(nbCols, nbRows);
@@ -316,7 +330,9 @@ void DCTIntegration(const image::Image<image::RGBfColor>& normals,
                     image::Image<float>& depth,
                     bool perspective,
                     const Eigen::Matrix3f& K,
-                    const image::Image<float>& normalsMask)
+                    const image::Image<float>& normalsMask,
+                    EIntegrationSolver solver,
+                    bool useGpu)
 {
     int nbCols = normals.cols();
     int nbRows = normals.rows();
@@ -331,30 +347,60 @@ void DCTIntegration(const image::Image<image::RGBfColor>& normals,
     getDivergenceField(p, q, f);
     setBoundaryConditions(p, q, f);
 
-    // Convert f to OpenCV matrix
-    cv::Mat f_openCV(nbRows, nbCols, CV_32FC1);
-    cv::eigen2cv(f, f_openCV);
+    cv::Mat z(nbRows, nbCols, CV_32FC1);
 
-    // Cosine transform of f
-    cv::Mat fcos(nbRows, nbCols, CV_32FC1);
-    cv::dct(f_openCV, fcos);
+    if (useGpu || solver == EIntegrationSolver::MULTIGRID)
+    {
+        // The Laplacian is symmetric: the column major Eigen matrix is solved as a row major grid of nbRows columns
+        Eigen::MatrixXf zEigen(nbRows, nbCols);
+        int nbIterations;
 
-    // Cosine transform of z
-    cv::Mat z_bar_bar(nbRows, nbCols, CV_32FC1);
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
+        if (useGpu)
+        {
+            cuda::DevicePoissonSolver poissonSolver;
+            poissonSolver.setSize(nbRows, nbCols);
+            nbIterations = poissonSolver.solve(f.data(), zEigen.data());
+        }
+        else
+#endif
+        {
+            PoissonSolver poissonSolver;
+            poissonSolver.setSize(nbRows, nbCols);
+            nbIterations = poissonSolver.solve(f.data(), zEigen.data());
+        }
+        ALICEVISION_LOG_INFO("Normal integration solved in " << nbIterations << " iterations" << (useGpu ? " on the GPU." : "."));
 
-    for (int j = 0; j < nbCols; j++)
+        // Same constant component as the cosine transform, which divides the mean of f by the clamped denominator
+        zEigen.array() += f.mean() / 0.0001f;
+        cv::eigen2cv(zEigen, z);
+    }
+    else
     {
-        for (int i = 0; i < nbRows; i++)
+        // Convert f to OpenCV matrix
+        cv::Mat f_openCV(nbRows, nbCols, CV_32FC1);
+        cv::eigen2cv(f, f_openCV);
+
+        // Cosine transform of f
+        cv::Mat fcos(nbRows, nbCols, CV_32FC1);
+        cv::dct(f_openCV, fcos);
+
+        // Cosine transform of z
+        cv::Mat z_bar_bar(nbRows, nbCols, CV_32FC1);
+
+        for (int j = 0; j < nbCols; j++)
         {
-            double denom = 4 * (pow(sin(0.5 * M_PI * j / nbCols), 2) + pow(sin(0.5 * M_PI * i / nbRows), 2));
-            denom = std::max(denom, 0.0001);
-            z_bar_bar.at<float>(i, j) = fcos.at<float>(i, j) / denom;
+            for (int i = 0; i < nbRows; i++)
+            {
+                double denom = 4 * (pow(sin(0.5 * M_PI * j / nbCols), 2) + pow(sin(0.5 * M_PI * i / nbRows), 2));
+                denom = std::max(denom, 0.0001);
+                z_bar_bar.at<float>(i, j) = fcos.at<float>(i, j) / denom;
+            }
         }
-    }
 
-    // Inverse cosine transform
-    cv::Mat z(nbRows, nbCols, CV_32FC1);
-    cv::idct(z_bar_bar, z);
+        // Inverse cosine transform
+        cv::idct(z_bar_bar, z);
+    }
 
     for (int j = 0; j < nbCols; ++j)
     {
@@ -10,6 +10,11 @@
 #include <aliceVision/sfmData/SfMData.hpp>
 #include <aliceVision/image/Image.hpp>
 
+#include <algorithm>
+#include <istream>
+#include <iterator>
+#include <ostream>
+#include <stdexcept>
 #include <string>
 #include <vector>
 #include <array>
@@ -17,19 +22,87 @@
 namespace aliceVision {
 namespace photometricStereo {
 
-void normalIntegration(const std::string& inputPath, const bool& perspective, const int& downscale, const std::string& outputFolder);
+/**
+ * @brief Solver of the Poisson equation of the normal integration
+ */
+enum class EIntegrationSolver
+{
+    /// cosine transform, with a clamping of the low frequencies
+    DCT,
+    /// conjugate gradient preconditioned by a multigrid V-cycle, linear in the number of pixels
+    MULTIGRID
+};
+
+inline std::string EIntegrationSolver_enumToString(const EIntegrationSolver solver)
+{
+    switch (solver)
+    {
+        case EIntegrationSolver::DCT:
+            return "dct";
+        case EIntegrationSolver::MULTIGRID:
+            return "multigrid";
+    }
+    throw std::out_of_range("Invalid integration solver enum");
+}
+
+inline EIntegrationSolver EIntegrationSolver_stringToEnum(const std::string& solverName)
+{
+    std::string name = solverName;
+    std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+
+    if (name == "dct")
+        return EIntegrationSolver::DCT;
+    if (name == "multigrid")
+        return EIntegrationSolver::MULTIGRID;
+
+    throw std::out_of_range("Invalid integration solver: '" + solverName + "'");
+}
+
+inline std::ostream& operator<<(std::ostream& os, EIntegrationSolver solver)
+{
+    os << EIntegrationSolver_enumToString(solver);
+    return os;
+}
+
+inline std::istream& operator>>(std::istream& in, EIntegrationSolver& solver)
+{
+    std::string token(std::istreambuf_iterator<char>(in), {});
+    solver = EIntegrationSolver_stringToEnum(token);
+    return in;
+}
+
+void normalIntegration(const std::string& inputPath,
+                       const bool& perspective,
+                       const int& downscale,
+                       const std::string& outputFolder,
+                       EIntegrationSolver solver = EIntegrationSolver::DCT,
+                       bool useGpu = false);
 
 void normalIntegration(const sfmData::SfMData& sfmData,
                        const std::string& inputPath,
                        const bool& perspective,
                        const int& downscale,
-                       const std::string& outputFolder);
-
+                       const std::string& outputFolder,
+                       EIntegrationSolver solver = EIntegrationSolver::DCT,
+                       bool useGpu = false);
+
+/**
+ * @brief Integrate a normal map by solving the Poisson equation of the depth with Neumann boundary conditions
+ * @param[in] normals Normal map
+ * @param[out] depth Depth map
+ * @param[in] perspective Perspective or orthographic camera
+ * @param[in] K Intrinsics matrix
+ * @param[in] normalsMask Mask of the valid normals
+ * @param[in] solver Solver of the Poisson equation
+ * @param[in] useGpu Solve with the multigrid conjugate gradient on the GPU, whatever the solver (requires a build with CUDA)
+ */
 void DCTIntegration(const image::Image<image::RGBfColor>& normals,
                     image::Image<float>& depth,
                     bool perspective,
                     const Eigen::Matrix3f& K,
-                    const image::Image<float>& normalsMask);
+                    const image::Image<float>& normalsMask,
+                    EIntegrationSolver solver = EIntegrationSolver::DCT,
+                    bool useGpu = false);
 
 void normal2PQ(const image::Image<image::RGBfColor>& normals,
                Eigen::MatrixXf& p,
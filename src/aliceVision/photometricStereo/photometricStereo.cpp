@@ -11,6 +11,11 @@
 #include <aliceVision/image/io.hpp>
 #include <aliceVision/image/imageAlgo.hpp>
 #include <aliceVision/utils/filesIO.hpp>
+#include <aliceVision/config.hpp>
+
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
+    #include <aliceVision/photometricStereo/cuda/DeviceNormalsSolver.hpp>
+#endif
 
 // Eigen
 #include <Eigen/Dense>
@@ -21,12 +26,342 @@
 #include <filesystem>
 #include <fstream>
 #include <algorithm>
+#include <memory>
 
 namespace fs = std::filesystem;
 
 namespace aliceVision {
 namespace photometricStereo {
 
+namespace {
+
+/**
+ * @brief Solver of the normals and the albedo of sets of pixels sharing the same lights
+ */
+class PixelsSolver
+{
+  public:
+    PixelsSolver(const Eigen::MatrixXf& lightMat, const PhotometricSteroParameters& PSParameters)
+      : _lightMat(lightMat),
+        _isRobust(PSParameters.isRobust)
+    {
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
+        // All the pixels share the lighting matrix: its pseudo-inverse is computed once and the pixels are solved on the GPU
+        if (PSParameters.useGpu && !_isRobust)
+        {
+            const Eigen::MatrixXf pseudoInverse =
+              _lightMat.bdcSvd(Eigen::ComputeThinU | Eigen::ComputeThinV).solve(Eigen::MatrixXf::Identity(_lightMat.rows(), _lightMat.rows()));
+
+            _deviceSolver = std::make_unique<cuda::DeviceNormalsSolver>();
+            _deviceSolver->setPseudoInverse(pseudoInverse.data(), int(pseudoInverse.rows()), int(pseudoInverse.cols()));
+        }
+#endif
+    }
+
+    /**
+     * @brief Solve a set of pixels
+     * @param[in] imMat Color intensities of the pixels, three rows per picture
+     * @param[in] imMat_gray Gray intensities of the pixels, one row per picture
+     * @param[out] normals Normalized solutions, one column per pixel
+     * @param[out] albedo Albedo, one column per pixel
+     */
+    void solve(const Eigen::MatrixXf& imMat, const Eigen::MatrixXf& imMat_gray, Eigen::MatrixXf& normals, Eigen::MatrixXf& albedo)
+    {
+        const Eigen::MatrixXf& lightMat = _lightMat;
+        const std::size_t nbPictures = imMat_gray.rows();
+        const std::size_t nbPixels = imMat_gray.cols();
+
+        Eigen::MatrixXf M_channel(3, nbPixels);
+        albedo.resize(3, nbPixels);
+
+        if (_isRobust)
+        {
+            float mu = 0.1;
+            int max_iterations = 1000;
+            float epsilon = 0.001;
+
+            // Errors (E) and Lagrange multiplicators (W) initialisation
+            Eigen::MatrixXf E = lightMat * M_channel - imMat_gray;
+            Eigen::MatrixXf W = Eigen::MatrixXf::Zero(E.rows(), E.cols());
+
+            Eigen::MatrixXf M_kminus1;
+            Eigen::MatrixXf newImMat;
+
+            for (size_t k = 0; k < max_iterations; ++k)
+            {
+                // Copy for convergence test
+                M_kminus1 = M_channel;
+
+                // M update
+                newImMat = imMat_gray + E - W / mu;
+                M_channel = lightMat.bdcSvd(Eigen::ComputeThinU | Eigen::ComputeThinV).solve(newImMat);
+
+                // E update
+                Eigen::MatrixXf E_before = E;
+                shrink(lightMat * M_channel - imMat_gray + W / mu, 1.0 / mu, E);
+
+                // W update
+                W = W + mu * (lightMat * M_channel - imMat_gray - E);
+
+                // Convergence test
+                Eigen::MatrixXf dev = M_kminus1 - M_channel;
+                float relativeDev = dev.norm() / M_channel.norm();
+
+                if (k > 10 && relativeDev < epsilon)
+                {
+                    ALICEVISION_LOG_INFO(k);
+                    ALICEVISION_LOG_INFO("Convergence");
+                    break;
+                }
+            }
+
+            normals.resize(M_channel.rows(), nbPixels);
+            for (size_t i = 0; i < nbPixels; ++i)
+            {
+                normals.col(i) = M_channel.col(i) / M_channel.col(i).norm();
+            }
+
+            for (size_t ch = 0; ch < 3; ++ch)
+            {
+                // Create I matrix for current pixel
+                Eigen::MatrixXf pixelValues_channel(nbPictures, nbPixels);
+                for (size_t i = 0; i < nbPictures; ++i)
+                {
+                    pixelValues_channel.block(i, 0, 1, nbPixels) = imMat.block(ch + 3 * i, 0, 1, nbPixels);
+                }
+
+                for (size_t i = 0; i < nbPixels; ++i)
+                {
+                    Eigen::VectorXf currentI = pixelValues_channel.col(i);
+                    Eigen::VectorXf currentShading = lightMat * normals.col(i);
+                    Eigen::VectorXf result = currentI.cwiseProduct(currentShading.cwiseInverse());
+                    median(result, albedo(ch, i));
+                }
+            }
+        }
+        else
+        {
+            // Normal estimation
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
+            if (_deviceSolver)
+            {
+                // the solutions are normalized on the device
+                normals.resize(lightMat.cols(), nbPixels);
+                _deviceSolver->solve(imMat_gray.data(), nbPixels, true, normals.data(), nullptr);
+            }
+            else
+#endif
+            {
+                normals = lightMat.bdcSvd(Eigen::ComputeThinU | Eigen::ComputeThinV).solve(imMat_gray);
+                for (size_t i = 0; i < nbPixels; ++i)
+                {
+                    normals.col(i) /= normals.col(i).norm();
+                }
+            }
+
+            // Channelwise albedo estimation
+            for (size_t ch = 0; ch < 3; ++ch)
+            {
+                // Create I matrix for current pixel
+                Eigen::MatrixXf pixelValues_channel(nbPictures, nbPixels);
+                for (size_t i = 0; i < nbPictures; ++i)
+                {
+                    pixelValues_channel.block(i, 0, 1, nbPixels) = imMat.block(ch + 3 * i, 0, 1, nbPixels);
+                }
+
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
+                if (_deviceSolver)
+                {
+                    // only the norms of the solutions are needed
+                    Eigen::VectorXf albedoChannel(nbPixels);
+                    _deviceSolver->solve(pixelValues_channel.data(), nbPixels, false, nullptr, albedoChannel.data());
+                    albedo.row(ch) = albedoChannel.transpose();
+                    continue;
+                }
+#endif
+                M_channel = lightMat.bdcSvd(Eigen::ComputeThinU | Eigen::ComputeThinV).solve(pixelValues_channel);
+                albedo.row(ch) = M_channel.colwise().norm();
+            }
+        }
+    }
+
+  private:
+    const Eigen::MatrixXf& _lightMat;
+    bool _isRobust;
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
+    std::unique_ptr<cuda::DeviceNormalsSolver> _deviceSolver;
+#endif
+};
+
+/**
+ * @brief Read the rows of a picture matching a block of rows of the (downscaled) result
+ */
+void readBlock(image::ImageBandReader& reader, int ybegin, int yend, int downscale, image::Image<image::RGBfColor>& block)
+{
+    reader.read(ybegin * downscale, yend * downscale, block);
+
+    if (downscale > 1)
+    {
+        imageAlgo::resizeImage(downscale, block);
+    }
+}
+
+/**
+ * @brief Apply the PS algorithm block of rows by block of rows:
+ *        only the rows of the current block of all the pictures are decoded and kept in memory.
+ */
+void photometricStereoByBlocks(const std::vector<std::string>& imageList,
+                               const std::vector<std::array<float, 3>>& intList,
+                               const Eigen::MatrixXf& lightMat,
+                               image::Image<float>& mask,
+                               const std::string& pathToAmbiant,
+                               const PhotometricSteroParameters& PSParameters,
+                               image::Image<image::RGBfColor>& normals,
+                               image::Image<image::RGBfColor>& albedo)
+{
+    const bool hasMask = !((mask.rows() == 1) && (mask.cols() == 1));
+    const int downscale = std::max(PSParameters.downscale, 1);
+    const image::ImageReadOptions readOptions(image::EImageColorSpace::NO_CONVERSION);
+
+    // The pictures stay open during the whole process
+    std::vector<std::unique_ptr<image::ImageBandReader>> readers;
+    for (const std::string& picturePath : imageList)
+    {
+        readers.push_back(std::make_unique<image::ImageBandReader>(picturePath, readOptions));
+
+        if (readers.back()->getWidth() != readers.front()->getWidth() || readers.back()->getHeight() != readers.front()->getHeight())
+        {
+            ALICEVISION_THROW_ERROR("The picture '" << picturePath << "' does not have the same size as the other pictures of the light stack.");
+        }
+    }
+
+    std::unique_ptr<image::ImageBandReader> ambiantReader;
+    if (boost::algorithm::icontains(fs::path(pathToAmbiant).stem().string(), "ambiant"))
+    {
+        ALICEVISION_LOG_INFO("Removing ambiant light");
+        ALICEVISION_LOG_INFO(pathToAmbiant);
+
+        ambiantReader = std::make_unique<image::ImageBandReader>(pathToAmbiant, readOptions);
+
+        if (ambiantReader->getWidth() != readers.front()->getWidth() || ambiantReader->getHeight() != readers.front()->getHeight())
+        {
+            ALICEVISION_THROW_ERROR("The ambiant picture '" << pathToAmbiant << "' does not have the same size as the light stack.");
+        }
+    }
+
+    const int pictRows = readers.front()->getHeight() / downscale;
+    const int pictCols = readers.front()->getWidth() / downscale;
+
+    if (hasMask)
+    {
+        if (downscale > 1)
+        {
+            imageAlgo::resizeImage(downscale, mask);
+        }
+
+        if (mask.rows() != pictRows || mask.cols() != pictCols)
+        {
+            ALICEVISION_THROW_ERROR("The mask size (" << mask.cols() << "x" << mask.rows() << ") does not match the pictures size (" << pictCols
+                                                      << "x" << pictRows << ").");
+        }
+    }
+
+    PixelsSolver solver(lightMat, PSParameters);
+
+    normals = image::Image<image::RGBfColor>(pictCols, pictRows, true, image::RGBfColor(0.0f));
+    albedo = image::Image<image::RGBfColor>(pictCols, pictRows, true, image::RGBfColor(0.0f));
+
+    image::Image<image::RGBfColor> block;
+    image::Image<image::RGBfColor> ambiantBlock;
+
+    for (int ybegin = 0; ybegin < pictRows; ybegin += PSParameters.blockHeight)
+    {
+        const int yend = std::min(ybegin + PSParameters.blockHeight, pictRows);
+        const int blockRows = yend - ybegin;
+
+        // Pixels of the block, in the column major order of the pictures
+        std::vector<int> blockIndices;
+        for (int j = 0; j < pictCols; ++j)
+        {
+            for (int i = ybegin; i < yend; ++i)
+            {
+                if (!hasMask || mask(i, j) > 0.7)
+                {
+                    blockIndices.push_back(j * blockRows + i - ybegin);
+                }
+            }
+        }
+
+        if (blockIndices.empty())
+        {
+            continue;
+        }
+
+        ALICEVISION_LOG_INFO("Rows " << ybegin << " to " << yend << " of " << pictRows << ": " << blockIndices.size() << " pixels.");
+
+        if (ambiantReader)
+        {
+            readBlock(*ambiantReader, ybegin, yend, downscale, ambiantBlock);
+        }
+
+        const int blockSize = blockIndices.size();
+        Eigen::MatrixXf imMat(3 * imageList.size(), blockSize);
+        Eigen::MatrixXf imMat_gray(imageList.size(), blockSize);
+
+        for (size_t i = 0; i < imageList.size(); ++i)
+        {
+            readBlock(*readers[i], ybegin, yend, downscale, block);
+
+            if (ambiantReader)
+            {
+                block = block - ambiantBlock;
+            }
+
+            intensityScaling(intList.at(i), block);
+
+            Eigen::MatrixXf currentPicture(3, blockSize);
+            image2PsMatrix(block, blockIndices, currentPicture);
+
+            imMat.block(3 * i, 0, 3, blockSize) = currentPicture;
+            imMat_gray.block(i, 0, 1, blockSize) = currentPicture.block(0, 0, 1, blockSize) * 0.2126 +
+                                                   currentPicture.block(1, 0, 1, blockSize) * 0.7152 +
+                                                   currentPicture.block(2, 0, 1, blockSize) * 0.0722;
+        }
+
+        Eigen::MatrixXf normalsBlock;
+        Eigen::MatrixXf albedoBlock;
+        solver.solve(imMat, imMat_gray, normalsBlock, albedoBlock);
+
+        for (int k = 0; k < blockSize; ++k)
+        {
+            const int j = blockIndices[k] / blockRows;
+            const int i = ybegin + blockIndices[k] - j * blockRows;
+            normals(i, j) = image::RGBfColor(normalsBlock(0, k), normalsBlock(1, k), normalsBlock(2, k));
+            albedo(i, j) = image::RGBfColor(albedoBlock(0, k), albedoBlock(1, k), albedoBlock(2, k));
+        }
+    }
+
+    // Same normalization as the whole pictures solving
+    float albedoMax = 0.0f;
+    for (int i = 0; i < pictRows; ++i)
+    {
+        for (int j = 0; j < pictCols; ++j)
+        {
+            albedoMax = std::max(albedoMax, albedo(i, j).maxCoeff());
+        }
+    }
+
+    for (int i = 0; i < pictRows; ++i)
+    {
+        for (int j = 0; j < pictCols; ++j)
+        {
+            albedo(i, j) = albedo(i, j) / albedoMax;
+        }
+    }
+}
+
+}  // namespace
+
 void photometricStereo(const std::string& inputPath,
                        const std::string& lightData,
                        const std::string& outputPath,
@@ -264,6 +599,12 @@ void photometricStereo(const std::vector<std::string>& imageList,
                        image::Image<image::RGBfColor>& normals,
                        image::Image<image::RGBfColor>& albedo)
 {
+    if (PSParameters.blockHeight > 0)
+    {
+        photometricStereoByBlocks(imageList, intList, lightMat, mask, pathToAmbiant, PSParameters, normals, albedo);
+        return;
+    }
+
     size_t maskSize;
     int pictRows;
     int pictCols;
@@ -339,6 +680,8 @@ void photometricStereo(const std::vector<std::string>& imageList,
     Eigen::MatrixXf normalsVect = Eigen::MatrixXf::Zero(lightMat.cols(), pictRows * pictCols);
     Eigen::MatrixXf albedoVect = Eigen::MatrixXf::Zero(3, pictRows * pictCols);
 
+    PixelsSolver solver(lightMat, PSParameters);
+
     int remainingPixels = maskSize;
     std::vector<int> currentMaskIndices;
 
@@ -400,133 +743,15 @@ void photometricStereo(const std::vector<std::string>& imageList,
                                                          currentPicture.block(2, 0, 1, currentMaskSize) * 0.0722;
         }
 
-        Eigen::MatrixXf M_channel(3, currentMaskSize);
-        int currentIdx;
+        Eigen::MatrixXf normalsBlock;
+        Eigen::MatrixXf albedoBlock;
+        solver.solve(imMat, imMat_gray, normalsBlock, albedoBlock);
 
-        if (PSParameters.isRobust)
+        for (size_t i = 0; i < currentMaskSize; ++i)
         {
-            float mu = 0.1;
-            int max_iterations = 1000;
-            float epsilon = 0.001;
-
-            // Errors (E) and Lagrange multiplicators (W) initialisation
-            Eigen::MatrixXf E = lightMat * M_channel - imMat_gray;
-            Eigen::MatrixXf W = Eigen::MatrixXf::Zero(E.rows(), E.cols());
-
-            Eigen::MatrixXf M_kminus1;
-            Eigen::MatrixXf newImMat;
-
-            for (size_t k = 0; k < max_iterations; ++k)
-            {
-                // Copy for convergence test
-                M_kminus1 = M_channel;
-
-                // M update
-                newImMat = imMat_gray + E - W / mu;
-                M_channel = lightMat.bdcSvd(Eigen::ComputeThinU | Eigen::ComputeThinV).solve(newImMat);
-
-                // E update
-                Eigen::MatrixXf E_before = E;
-                shrink(lightMat * M_channel - imMat_gray + W / mu, 1.0 / mu, E);
-
-                // W update
-                W = W + mu * (lightMat * M_channel - imMat_gray - E);
-
-                // Convergence test
-                Eigen::MatrixXf dev = M_kminus1 - M_channel;
-                float relativeDev = dev.norm() / M_channel.norm();
-
-                if (k > 10 && relativeDev < epsilon)
-                {
-                    ALICEVISION_LOG_INFO(k);
-                    ALICEVISION_LOG_INFO("Convergence");
-                    break;
-                }
-            }
-
-            for (size_t i = 0; i < maskSize; ++i)
-            {
-                if (hasMask)
-                {
-                    currentIdx = indices.at(i);  // Index in picture
-                }
-                else
-                {
-                    currentIdx = i;
-                }
-                normalsVect.col(currentIdx) = M_channel.col(i) / M_channel.col(i).norm();
-            }
-
-            int currentIdx;
-            for (size_t ch = 0; ch < 3; ++ch)
-            {
-                // Create I matrix for current pixel
-                Eigen::MatrixXf pixelValues_channel(imageList.size(), maskSize);
-                for (size_t i = 0; i < imageList.size(); ++i)
-                {
-                    pixelValues_channel.block(i, 0, 1, maskSize) = imMat.block(ch + 3 * i, 0, 1, maskSize);
-                }
-
-                for (size_t i = 0; i < maskSize; ++i)
-                {
-                    if (hasMask)
-                    {
-                        currentIdx = indices.at(i);  // Index in picture
-                    }
-                    else
-                    {
-                        currentIdx = i;
-                    }
-                    Eigen::VectorXf currentI = pixelValues_channel.col(i);
-                    Eigen::VectorXf currentShading = lightMat * normalsVect.col(currentIdx);
-                    Eigen::VectorXf result = currentI.cwiseProduct(currentShading.cwiseInverse());
-                    median(result, albedoVect(ch, currentIdx));
-                }
-            }
-        }
-        else
-        {
-            // Normal estimation
-            M_channel = lightMat.bdcSvd(Eigen::ComputeThinU | Eigen::ComputeThinV).solve(imMat_gray);
-
-            for (size_t i = 0; i < currentMaskSize; ++i)
-            {
-                if (hasMask)
-                {
-                    currentIdx = currentMaskIndices.at(i);  // Index in picture
-                }
-                else
-                {
-                    currentIdx = i;
-                }
-                normalsVect.col(currentIdx) = M_channel.col(i) / M_channel.col(i).norm();
-            }
-
-            // Channelwise albedo estimation
-            for (size_t ch = 0; ch < 3; ++ch)
-            {
-                // Create I matrix for current pixel
-                Eigen::MatrixXf pixelValues_channel(imageList.size(), maskSize);
-                for (size_t i = 0; i < imageList.size(); ++i)
-                {
-                    pixelValues_channel.block(i, 0, 1, maskSize) = imMat.block(ch + 3 * i, 0, 1, maskSize);
-                }
-
-                M_channel = lightMat.bdcSvd(Eigen::ComputeThinU | Eigen::ComputeThinV).solve(pixelValues_channel);
-
-                for (size_t i = 0; i < currentMaskSize; ++i)
-                {
-                    if (hasMask)
-                    {
-                        currentIdx = currentMaskIndices.at(i);  // Index in picture
-                    }
-                    else
-                    {
-                        currentIdx = i;
-                    }
-                    albedoVect(ch, currentIdx) = M_channel.col(i).norm();
-                }
-            }
+            const int currentIdx = currentMaskIndices.at(i);  // Index in picture
+            normalsVect.col(currentIdx) = normalsBlock.col(i);
+            albedoVect.col(currentIdx) = albedoBlock.col(i);
         }
     }
 
@@ -22,6 +22,8 @@ struct PhotometricSteroParameters
     bool removeAmbiant;  // Do we remove ambiant light ? (currently tested)
     bool isRobust;       // Do we use the robust version of the algorithm ? (currently tested)
     int downscale;       // Downscale factor
+    bool useGpu = false; // Solve the normals on the GPU (requires a build with CUDA, not used by the robust version)
+    int blockHeight = 0; // Number of rows of the pictures decoded and solved at once (0 to load the whole pictures)
 };
 
 /**
@@ -61,6 +63,8 @@ void photometricStereo(const sfmData::SfMData& sfmData,
 
 /**
  * @brief Apply the PS algorithm for a given set of pictures sharing the same pose
+ * With a block height, the pictures are decoded block of rows by block of rows:
+ * the memory is bounded by the size of a block of all the pictures instead of the size of all the pictures
  * @param[in] imageList List of pictures to apply the PS on
  * @param[in] intList List of light intensities
  * @param[in] lightMat List of light direction/coefficients (SH)
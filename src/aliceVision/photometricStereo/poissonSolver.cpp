@@ -0,0 +1,369 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "poissonSolver.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace aliceVision {
+namespace photometricStereo {
+
+namespace {
+
+/// Weight of the Jacobi smoother
+constexpr float JACOBI_WEIGHT = 0.8f;
+
+/// Number of pre and post smoothing iterations of the V-cycle
+constexpr int SMOOTHING_ITERATIONS = 2;
+
+/// Number of smoothing iterations on the coarsest level
+constexpr int COARSEST_ITERATIONS = 50;
+
+/// Size under which a level is not coarsened anymore
+constexpr int COARSEST_SIZE = 4;
+
+/// The piecewise constant prolongation underestimates the coarse correction by half
+constexpr float PROLONGATION_SCALE = 2.0f;
+
+double dot(const std::vector<float>& a, const std::vector<float>& b)
+{
+    const std::ptrdiff_t size = a.size();
+    double sum = 0.0;
+
+#pragma omp parallel for reduction(+ : sum)
+    for (std::ptrdiff_t id = 0; id < size; ++id)
+    {
+        sum += double(a[id]) * double(b[id]);
+    }
+
+    return sum;
+}
+
+void removeMean(std::vector<float>& a)
+{
+    const std::ptrdiff_t size = a.size();
+    double sum = 0.0;
+
+#pragma omp parallel for reduction(+ : sum)
+    for (std::ptrdiff_t id = 0; id < size; ++id)
+    {
+        sum += a[id];
+    }
+
+    const float mean = float(sum / double(size));
+
+#pragma omp parallel for
+    for (std::ptrdiff_t id = 0; id < size; ++id)
+    {
+        a[id] -= mean;
+    }
+}
+
+}  // namespace
+
+void PoissonSolver::setSize(int width, int height)
+{
+    if (width <= 0 || height <= 0)
+    {
+        throw std::invalid_argument("PoissonSolver: invalid grid size.");
+    }
+
+    if (!_levels.empty() && _levels.front().width == width && _levels.front().height == height)
+        return;
+
+    _levels.clear();
+
+    int levelWidth = width;
+    int levelHeight = height;
+    while (true)
+    {
+        Level level;
+        level.width = levelWidth;
+        level.height = levelHeight;
+
+        const std::size_t size = std::size_t(levelWidth) * levelHeight;
+        level.weightsX.resize(size);
+        level.weightsY.resize(size);
+        level.diagonal.resize(size);
+        level.x.resize(size);
+        level.b.resize(size);
+        level.r.resize(size);
+
+        if (_levels.empty())
+        {
+            // every edge inside the grid has a unit weight
+#pragma omp parallel for
+            for (int i = 0; i < levelHeight; ++i)
+            {
+                for (int j = 0; j < levelWidth; ++j)
+                {
+                    const std::size_t id = std::size_t(i) * levelWidth + j;
+                    level.weightsX[id] = (j + 1 < levelWidth) ? 1.0f : 0.0f;
+                    level.weightsY[id] = (i + 1 < levelHeight) ? 1.0f : 0.0f;
+                }
+            }
+        }
+        else
+        {
+            // Galerkin coarse edge weights: sum of the fine edges between two coarse cells
+            const Level& fine = _levels.back();
+
+#pragma omp parallel for
+            for (int I = 0; I < levelHeight; ++I)
+            {
+                for (int J = 0; J < levelWidth; ++J)
+                {
+                    float sumX = 0.0f;
+                    float sumY = 0.0f;
+                    for (int k = 0; k < 2; ++k)
+                    {
+                        // fine edges crossing the right side of the coarse cell
+                        const int iX = 2 * I + k;
+                        const int jX = 2 * J + 1;
+                        if (iX < fine.height && jX < fine.width)
+                            sumX += fine.weightsX[std::size_t(iX) * fine.width + jX];
+
+                        // fine edges crossing the bottom side of the coarse cell
+                        const int iY = 2 * I + 1;
+                        const int jY = 2 * J + k;
+                        if (iY < fine.height && jY < fine.width)
+                            sumY += fine.weightsY[std::size_t(iY) * fine.width + jY];
+                    }
+
+                    const std::size_t id = std::size_t(I) * levelWidth + J;
+                    level.weightsX[id] = sumX;
+                    level.weightsY[id] = sumY;
+                }
+            }
+        }
+
+#pragma omp parallel for
+        for (int i = 0; i < levelHeight; ++i)
+        {
+            for (int j = 0; j < levelWidth; ++j)
+            {
+                const std::size_t id = std::size_t(i) * levelWidth + j;
+                float sum = level.weightsX[id] + level.weightsY[id];
+                if (j > 0)
+                    sum += level.weightsX[id - 1];
+                if (i > 0)
+                    sum += level.weightsY[id - levelWidth];
+                level.diagonal[id] = sum;
+            }
+        }
+
+        _levels.push_back(std::move(level));
+
+        if (std::min(levelWidth, levelHeight) <= COARSEST_SIZE)
+            break;
+
+        levelWidth = (levelWidth + 1) / 2;
+        levelHeight = (levelHeight + 1) / 2;
+    }
+
+    const std::size_t size = std::size_t(width) * height;
+    _solution.resize(size);
+    _residual.resize(size);
+    _direction.resize(size);
+    _preconditioned.resize(size);
+    _product.resize(size);
+}
+
+void PoissonSolver::applyOperator(const Level& level, const float* in, float* out) const
+{
+    const int width = level.width;
+    const int height = level.height;
+
+#pragma omp parallel for
+    for (int i = 0; i < height; ++i)
+    {
+        for (int j = 0; j < width; ++j)
+        {
+            const std::size_t id = std::size_t(i) * width + j;
+
+            float value = level.diagonal[id] * in[id];
+            if (j + 1 < width)
+                value -= level.weightsX[id] * in[id + 1];
+            if (j > 0)
+                value -= level.weightsX[id - 1] * in[id - 1];
+            if (i + 1 < height)
+                value -= level.weightsY[id] * in[id + width];
+            if (i > 0)
+                value -= level.weightsY[id - width] * in[id - width];
+
+            out[id] = value;
+        }
+    }
+}
+
+void PoissonSolver::residual(Level& level)
+{
+    applyOperator(level, level.x.data(), level.r.data());
+
+    const std::ptrdiff_t size = level.r.size();
+
+#pragma omp parallel for
+    for (std::ptrdiff_t id = 0; id < size; ++id)
+    {
+        level.r[id] = level.b[id] - level.r[id];
+    }
+}
+
+void PoissonSolver::smooth(Level& level, int nbIterations)
+{
+    const std::ptrdiff_t size = level.x.size();
+
+    for (int k = 0; k < nbIterations; ++k)
+    {
+        residual(level);
+
+#pragma omp parallel for
+        for (std::ptrdiff_t id = 0; id < size; ++id)
+        {
+            if (level.diagonal[id] > 0.0f)
+                level.x[id] += JACOBI_WEIGHT * level.r[id] / level.diagonal[id];
+        }
+    }
+}
+
+void PoissonSolver::vcycle(std::size_t levelIndex)
+{
+    Level& level = _levels[levelIndex];
+
+    std::fill(level.x.begin(), level.x.end(), 0.0f);
+
+    if (levelIndex + 1 == _levels.size())
+    {
+        smooth(level, COARSEST_ITERATIONS);
+        return;
+    }
+
+    smooth(level, SMOOTHING_ITERATIONS);
+    residual(level);
+
+    // restriction of the residual: sum of the 2x2 fine cells of each coarse cell (transpose of the prolongation)
+    Level& coarse = _levels[levelIndex + 1];
+
+#pragma omp parallel for
+    for (int I = 0; I < coarse.height; ++I)
+    {
+        for (int J = 0; J < coarse.width; ++J)
+        {
+            float sum = 0.0f;
+            for (int a = 0; a < 2; ++a)
+            {
+                for (int c = 0; c < 2; ++c)
+                {
+                    const int i = 2 * I + a;
+                    const int j = 2 * J + c;
+                    if (i < level.height && j < level.width)
+                        sum += level.r[std::size_t(i) * level.width + j];
+                }
+            }
+            coarse.b[std::size_t(I) * coarse.width + J] = sum;
+        }
+    }
+
+    vcycle(levelIndex + 1);
+
+    // piecewise constant prolongation of the coarse correction
+#pragma omp parallel for
+    for (int i = 0; i < level.height; ++i)
+    {
+        for (int j = 0; j < level.width; ++j)
+        {
+            level.x[std::size_t(i) * level.width + j] += PROLONGATION_SCALE * coarse.x[std::size_t(i / 2) * coarse.width + j / 2];
+        }
+    }
+
+    smooth(level, SMOOTHING_ITERATIONS);
+}
+
+void PoissonSolver::precondition(const std::vector<float>& in, std::vector<float>& out)
+{
+    Level& finest = _levels.front();
+
+    finest.b = in;
+    vcycle(0);
+    out = finest.x;
+
+    // stay orthogonal to the null space of the Laplacian
+    removeMean(out);
+}
+
+int PoissonSolver::solve(const float* f, float* z, float tolerance, int maxIterations)
+{
+    if (_levels.empty())
+    {
+        throw std::logic_error("PoissonSolver: the grid size is not set.");
+    }
+
+    const Level& finest = _levels.front();
+    const std::ptrdiff_t size = std::ptrdiff_t(finest.width) * finest.height;
+
+    std::vector<float>& x = _solution;
+    std::vector<float>& Ap = _product;
+
+    // b is projected on the range of the Laplacian, r = b since x = 0
+    std::copy(f, f + size, _residual.begin());
+    removeMean(_residual);
+    std::fill(x.begin(), x.end(), 0.0f);
+
+    const double normB = std::sqrt(dot(_residual, _residual));
+    int iteration = 0;
+
+    if (normB > 0.0)
+    {
+        precondition(_residual, _preconditioned);
+        _direction = _preconditioned;
+        double rz = dot(_residual, _preconditioned);
+
+        for (; iteration < maxIterations; ++iteration)
+        {
+            applyOperator(finest, _direction.data(), Ap.data());
+            const double pAp = dot(_direction, Ap);
+            if (pAp <= 0.0)
+                break;
+
+            const float alpha = float(rz / pAp);
+
+#pragma omp parallel for
+            for (std::ptrdiff_t id = 0; id < size; ++id)
+            {
+                x[id] += alpha * _direction[id];
+                _residual[id] -= alpha * Ap[id];
+            }
+
+            const double normR = std::sqrt(dot(_residual, _residual));
+            if (normR <= tolerance * normB)
+            {
+                ++iteration;
+                break;
+            }
+
+            precondition(_residual, _preconditioned);
+            const double rzNext = dot(_residual, _preconditioned);
+            const float beta = float(rzNext / rz);
+            rz = rzNext;
+
+#pragma omp parallel for
+            for (std::ptrdiff_t id = 0; id < size; ++id)
+            {
+                _direction[id] = _preconditioned[id] + beta * _direction[id];
+            }
+        }
+    }
+
+    removeMean(x);
+    std::copy(x.begin(), x.end(), z);
+
+    return iteration;
+}
+
+}  // namespace photometricStereo
+}  // namespace aliceVision
@@ -0,0 +1,78 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace aliceVision {
+namespace photometricStereo {
+
+/**
+ * @class PoissonSolver
+ * @brief Solve the Poisson equation of the normal integration with homogeneous Neumann boundary conditions.
+ *
+ * The system is the 5-point discrete Laplacian diagonalized by the cosine transform of DCTIntegration,
+ * solved with a conjugate gradient preconditioned by a multigrid V-cycle (same scheme as cuda::DevicePoissonSolver).
+ * The coarse levels aggregate 2x2 cells with a Galerkin coarse operator and the smoother is a weighted Jacobi:
+ * each iteration is linear in the number of cells and parallel over the rows,
+ * and the number of iterations is almost independent of the grid size.
+ * The Laplacian is singular: the right hand side is projected on the zero mean fields and the solution has a zero mean.
+ */
+class PoissonSolver
+{
+  public:
+    /**
+     * @brief Build the levels of the solver for a grid size.
+     * @param[in] width The width of the grid
+     * @param[in] height The height of the grid
+     */
+    void setSize(int width, int height);
+
+    /**
+     * @brief Solve -laplacian(z) = f.
+     * @param[in] f The right hand side, row major, width * height
+     * @param[out] z The zero mean solution, row major, width * height
+     * @param[in] tolerance The relative residual norm to reach
+     * @param[in] maxIterations The maximal number of conjugate gradient iterations
+     * @return The number of iterations
+     */
+    int solve(const float* f, float* z, float tolerance = 1e-5f, int maxIterations = 200);
+
+  private:
+    struct Level
+    {
+        int width = 0;
+        int height = 0;
+        /// weights of the edges with the right and bottom neighbours, and sum of the weights of each cell
+        std::vector<float> weightsX;
+        std::vector<float> weightsY;
+        std::vector<float> diagonal;
+        /// solution, right hand side and residual of the level
+        std::vector<float> x;
+        std::vector<float> b;
+        std::vector<float> r;
+    };
+
+    void vcycle(std::size_t levelIndex);
+    void smooth(Level& level, int nbIterations);
+    void residual(Level& level);
+    void applyOperator(const Level& level, const float* in, float* out) const;
+    void precondition(const std::vector<float>& in, std::vector<float>& out);
+
+    std::vector<Level> _levels;
+
+    // conjugate gradient buffers on the finest level
+    std::vector<float> _solution;
+    std::vector<float> _residual;
+    std::vector<float> _direction;
+    std::vector<float> _preconditioned;
+    std::vector<float> _product;
+};
+
+}  // namespace photometricStereo
+}  // namespace aliceVision
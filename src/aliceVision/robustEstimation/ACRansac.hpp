@@ -17,6 +17,7 @@
 #include <iostream>
 #include <iterator>
 #include <limits>
+#include <memory>
 #include <numeric>
 #include <vector>
 
@@ -42,24 +43,45 @@ T logcombi(std::size_t k, std::size_t n, const std::vector<T>& vec_log10)  // ve
 
 /**
  * @brief Tabulate logcombi(.,n)
+ * @note Computed in linear time from log(C(k,n)) = log(C(k-1,n)) + log(n-k+1) - log(k)
  */
 template<typename Type>
 void makelogcombi_n(std::size_t n, std::vector<Type>& l, std::vector<Type>& vec_log10)  // vec_log10: lookuptable [0,n+1]
 {
     l.resize(n + 1);
-    for (std::size_t k = 0; k <= n; ++k)
-        l[k] = logcombi<Type>(k, n, vec_log10);
+    l[0] = 0.0f;
+
+    double r = 0.0;
+    for (std::size_t k = 1; k < n; ++k)
+    {
+        r += double(vec_log10[n - k + 1]) - double(vec_log10[k]);
+        l[k] = static_cast<Type>(r);
+    }
+
+    if (n > 0)
+        l[n] = 0.0f;
 }
 
 /**
  * @brief Tabulate logcombi(k,.)
+ * @note Computed in linear time from log(C(k,n)) = log(C(k,n-1)) + log(n) - log(n-k)
  */
 template<typename Type>
 void makelogcombi_k(std::size_t k, std::size_t nmax, std::vector<Type>& l, std::vector<Type>& vec_log10)  // vec_log10: lookuptable [0,n+1]
 {
     l.resize(nmax + 1);
+
+    double r = 0.0;
     for (std::size_t n = 0; n <= nmax; ++n)
-        l[n] = logcombi<Type>(k, n, vec_log10);
+    {
+        if (k == 0 || n <= k)
+        {
+            l[n] = 0.0f;
+            continue;
+        }
+        r += double(vec_log10[n]) - double(vec_log10[n - k]);
+        l[n] = static_cast<Type>(r);
+    }
 }
 
 template<typename Type>
@@ -139,6 +161,10 @@ inline ErrorIndex bestNFA(int startIndex,  // number of point required for estim
  * @param[in] nIter maximum number of consecutive iterations
  * @param[out] model returned model if found
  * @param[in] precision upper bound of the precision
+ * @param[in] maxIterWithoutModel if not 0, early exit when no meaningful model (NFA < 0)
+ *            has been found after this number of iterations
+ * @param[in] sortedIndices if not null, the data indices sorted by decreasing quality (e.g. matching distance ratio):
+ *            the samples are drawn with PROSAC instead of uniformly until a first meaningful model is found
  *
  * @return (errorMax, minNFA)
  */
@@ -148,7 +174,9 @@ std::pair<double, double> ACRANSAC(const Kernel& kernel,
                                    std::vector<size_t>& vec_inliers,
                                    std::size_t nIter = 1024,
                                    typename Kernel::ModelT* model = nullptr,
-                                   double precision = std::numeric_limits<double>::infinity())
+                                   double precision = std::numeric_limits<double>::infinity(),
+                                   std::size_t maxIterWithoutModel = 0,
+                                   const std::vector<std::size_t>* sortedIndices = nullptr)
 {
     vec_inliers.clear();
 
@@ -161,8 +189,13 @@ std::pair<double, double> ACRANSAC(const Kernel& kernel,
                                   ? std::numeric_limits<double>::infinity()
                                   : precision * precision * kernel.thresholdNormalizer() * kernel.thresholdNormalizer();
 
-    std::vector<ErrorIndex> vec_residuals(nData);  // [residual,index]
+    // Workspaces reused by all the iterations
+    std::vector<ErrorIndex> vec_residuals;  // [residual,index] below the maximum threshold
+    vec_residuals.reserve(nData);
     std::vector<double> vec_residuals_(nData);
+    std::vector<std::size_t> vec_sample(sizeSample);  // Sample indices
+    std::vector<typename Kernel::ModelT> vec_models;  // Up to max_models solutions
+    vec_models.reserve(kernel.getMaximumNbModels());
 
     // Possible sampling indices [0,..,nData] (will change in the optimization phase)
     std::vector<size_t> vec_index(nData);
@@ -183,16 +216,25 @@ std::pair<double, double> ACRANSAC(const Kernel& kernel,
 
     bool bACRansacMode = (precision == std::numeric_limits<double>::infinity());
 
+    // Progressive sampling of the best data
+    std::unique_ptr<ProsacSampler> prosacSampler;
+    if (sortedIndices != nullptr)
+    {
+        assert(sortedIndices->size() == nData);
+        prosacSampler.reset(new ProsacSampler(sizeSample, *sortedIndices));
+    }
+
     // Main estimation loop.
     for (std::size_t iter = 0; iter < nIter; ++iter)
     {
-        std::vector<std::size_t> vec_sample(sizeSample);  // Sample indices
-        if (bACRansacMode)
+        if (prosacSampler)
+            prosacSampler->sample(randomNumberGenerator, vec_sample);  // Get progressive sample
+        else if (bACRansacMode)
             uniformSample(randomNumberGenerator, sizeSample, vec_index, vec_sample);  // Get random sample
         else
             uniformSample(randomNumberGenerator, sizeSample, nData, vec_sample);  // Get random sample
 
-        std::vector<typename Kernel::ModelT> vec_models;  // Up to max_models solutions
+        vec_models.clear();
         kernel.fit(vec_sample, vec_models);
 
         // Evaluate models
@@ -215,10 +257,13 @@ std::pair<double, double> ACRANSAC(const Kernel& kernel,
             }
             if (bACRansacMode)
             {
+                // Only the residuals below the maximum threshold can be inliers, so only those are sorted
+                vec_residuals.clear();
                 for (size_t i = 0; i < nData; ++i)
                 {
                     const double error = vec_residuals_[i];
-                    vec_residuals[i] = ErrorIndex(error, i);
+                    if (error <= maxThreshold)
+                        vec_residuals.emplace_back(error, i);
                 }
                 std::sort(vec_residuals.begin(), vec_residuals.end());
 
@@ -249,6 +294,10 @@ std::pair<double, double> ACRANSAC(const Kernel& kernel,
         if (!bACRansacMode && iter > nIterReserve * 2)
             break;
 
+        // Early exit test -> no meaningful model found after maxIterWithoutModel iterations
+        if (maxIterWithoutModel != 0 && minNFA >= 0 && iter + 1 >= maxIterWithoutModel)
+            break;
+
         // ACRANSAC optimization: draw samples among best set of inliers so far
         if (bACRansacMode && ((better && minNFA < 0) || (iter + 1 == nIter && nIterReserve)))
         {
@@ -262,6 +311,7 @@ std::pair<double, double> ACRANSAC(const Kernel& kernel,
             {
                 // ACRANSAC optimization: draw samples among best set of inliers so far
                 vec_index = vec_inliers;
+                prosacSampler.reset();
                 if (nIterReserve)
                 {
                     nIter = iter + 1 + nIterReserve;
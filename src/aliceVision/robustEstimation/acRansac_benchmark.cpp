@@ -0,0 +1,99 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/numeric/numeric.hpp>
+#include <aliceVision/robustEstimation/LineKernel.hpp>
+#include <aliceVision/robustEstimation/ACRansac.hpp>
+#include <aliceVision/robustEstimation/lineTestGenerator.hpp>
+#include <aliceVision/system/Logger.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace aliceVision;
+using namespace aliceVision::robustEstimation;
+
+namespace {
+
+/**
+ * @brief Scoring of one model hypothesis: residuals sorting and a contrario NFA evaluation.
+ * @param state range(0): number of residuals (putative matches)
+ */
+void BM_bestNFA(benchmark::State& state)
+{
+    const std::size_t nData = static_cast<std::size_t>(state.range(0));
+    const std::size_t sizeSample = 4;  // e.g. homography
+
+    // 60% of inliers with small residuals, the others are uniformly distributed
+    std::mt19937 generator(0);
+    std::normal_distribution<double> inlierDistribution(0.0, 1.0);
+    std::uniform_real_distribution<double> outlierDistribution(0.0, 1000.0);
+    std::vector<double> residuals(nData);
+    for (std::size_t i = 0; i < nData; ++i)
+    {
+        const double r = (i % 5 < 3) ? inlierDistribution(generator) : outlierDistribution(generator);
+        residuals[i] = r * r;
+    }
+
+    std::vector<float> logc_n, logc_k;
+    makelogcombi(sizeSample, nData, logc_k, logc_n);
+    const double loge0 = log10(1.0 * (nData - sizeSample));
+    const double logalpha0 = log10(M_PI / (4000.0 * 3000.0));
+
+    std::vector<ErrorIndex> sortedResiduals;
+    sortedResiduals.reserve(nData);
+
+    for (auto _ : state)
+    {
+        sortedResiduals.clear();
+        for (std::size_t i = 0; i < nData; ++i)
+            sortedResiduals.emplace_back(residuals[i], i);
+        std::sort(sortedResiduals.begin(), sortedResiduals.end());
+
+        benchmark::DoNotOptimize(
+          bestNFA(sizeSample, logalpha0, sortedResiduals, loge0, std::numeric_limits<double>::infinity(), logc_n, logc_k, 2.0));
+    }
+
+    state.SetItemsProcessed(state.iterations() * nData);
+}
+
+/**
+ * @brief Complete AC-RANSAC estimation of a line (sampling, fitting, residuals and scoring).
+ * @param state range(0): number of points
+ */
+void BM_ACRansac_line(benchmark::State& state)
+{
+    const std::size_t nbPoints = static_cast<std::size_t>(state.range(0));
+
+    // do not measure the logging of the successive models
+    system::Logger::get()->setLogLevel(system::EVerboseLevel::Warning);
+
+    std::mt19937 generator(0);
+    Mat2X xy(2, nbPoints);
+    std::vector<std::size_t> inliersGT;
+    generateLine(nbPoints, 0.3, 0.5, Vec2(6.3, -0.9), generator, xy, inliersGT);
+
+    const LineKernel kernel(xy, nbPoints, nbPoints);
+    std::vector<std::size_t> inliers;
+
+    for (auto _ : state)
+    {
+        std::mt19937 randomNumberGenerator(0);
+        MatrixModel<Vec2> model;
+        ACRANSAC(kernel, randomNumberGenerator, inliers, 1024, &model);
+        benchmark::DoNotOptimize(model);
+    }
+
+    state.counters["inliers"] = static_cast<double>(inliers.size());
+}
+
+}  // namespace
+
+BENCHMARK(BM_bestNFA)->Arg(1000)->Arg(10000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ACRansac_line)->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
@@ -105,6 +105,98 @@ BOOST_AUTO_TEST_CASE(RansacLineFitter_TooFewPoints)
     BOOST_CHECK_EQUAL(0, inliers.size());
 }
 
+// Line kernel counting the number of model estimations
+class CountingLineKernel : public LineKernel
+{
+  public:
+    using LineKernel::LineKernel;
+
+    void fit(const std::vector<std::size_t>& samples, std::vector<ModelT>& models) const override
+    {
+        ++nbFit;
+        LineKernel::fit(samples, models);
+    }
+
+    mutable std::size_t nbFit = 0;
+};
+
+// test the early exit when no meaningful model can be found
+BOOST_AUTO_TEST_CASE(RansacLineFitter_NoModelEarlyExit)
+{
+    std::mt19937 randomNumberGenerator;
+    std::mt19937 gen;
+    std::uniform_real_distribution<double> d(0.0, 100.0);
+
+    // random points, there is no meaningful line
+    const int NbPoints = 100;
+    Mat2X xy(2, NbPoints);
+    for (Mat::Index i = 0; i < NbPoints; ++i)
+        xy.col(i) << d(gen), d(gen);
+
+    const std::size_t nIter = 1000;
+    const std::size_t maxIterWithoutModel = 50;
+
+    CountingLineKernel lineKernel(xy, 100, 100);
+    std::vector<std::size_t> inliers;
+    robustEstimation::MatrixModel<Vec2> model;
+
+    ACRANSAC(lineKernel, randomNumberGenerator, inliers, nIter, &model, std::numeric_limits<double>::infinity(), maxIterWithoutModel);
+
+    BOOST_CHECK_EQUAL(0, inliers.size());
+    BOOST_CHECK_EQUAL(maxIterWithoutModel, lineKernel.nbFit);
+
+    // without early exit, all the iterations are performed
+    CountingLineKernel lineKernelNoEarlyExit(xy, 100, 100);
+    ACRANSAC(lineKernelNoEarlyExit, randomNumberGenerator, inliers, nIter, &model);
+
+    BOOST_CHECK_EQUAL(0, inliers.size());
+    BOOST_CHECK_GT(lineKernelNoEarlyExit.nbFit, maxIterWithoutModel);
+}
+
+// test the progressive sampling of the best ranked data (PROSAC)
+BOOST_AUTO_TEST_CASE(RansacLineFitter_ProsacSampling)
+{
+    std::mt19937 randomNumberGenerator;
+    std::mt19937 gen;
+    std::uniform_real_distribution<double> d(0.0, 100.0);
+
+    // y = 2x + 1 for 30 points, 70 random outliers
+    const int NbPoints = 100;
+    const int NbInliers = 30;
+    Mat2X xy(2, NbPoints);
+    std::vector<std::size_t> sortedIndices;
+    for (Mat::Index i = 0; i < NbPoints; ++i)
+    {
+        const double x = d(gen);
+        if (i % 3 == 0 && sortedIndices.size() < NbInliers)
+        {
+            xy.col(i) << x, 2.0 * x + 1.0;
+            sortedIndices.push_back(i);
+        }
+        else
+        {
+            xy.col(i) << x, 2.0 * d(gen) + 1.0;
+        }
+    }
+    // inliers are ranked first
+    for (Mat::Index i = 0; i < NbPoints; ++i)
+    {
+        if (i % 3 != 0 || i / 3 >= NbInliers)
+            sortedIndices.push_back(i);
+    }
+    BOOST_CHECK_EQUAL(NbPoints, sortedIndices.size());
+
+    LineKernel lineKernel(xy, 100, 201);
+    std::vector<std::size_t> inliers;
+    robustEstimation::MatrixModel<Vec2> model;
+
+    ACRANSAC(lineKernel, randomNumberGenerator, inliers, 300, &model, std::numeric_limits<double>::infinity(), 0, &sortedIndices);
+
+    BOOST_CHECK_SMALL(2.0 - model.getMatrix()[1], 1e-6);
+    BOOST_CHECK_SMALL(1.0 - model.getMatrix()[0], 1e-6);
+    BOOST_CHECK_EQUAL(NbInliers, inliers.size());
+}
+
 // from a GT model :
 //  Compute a list of point that fit the model.
 //  Add white noise to given amount of points in this list.
@@ -15,6 +15,8 @@
 #include <random>
 #include <numeric>
 #include <cassert>
+#include <cmath>
+#include <vector>
 
 namespace aliceVision {
 namespace robustEstimation {
@@ -153,5 +155,83 @@ inline void uniformSample(std::mt19937& randomNumberGenerator,
     }
 }
 
+/**
+ * @brief Progressive sampling (PROSAC) of data ordered by decreasing quality.
+ *
+ * The samples are drawn from a growing subset of the best data: the first
+ * samples only contain top ranked data and the sampling converges to a uniform
+ * sampling of all the data after a given number of samples.
+ *
+ * @ref Ondrej Chum, Jiri Matas.
+ *      Matching with PROSAC - Progressive Sample Consensus.
+ *      CVPR 2005.
+ */
+class ProsacSampler
+{
+  public:
+    /**
+     * @param[in] sampleSize The size of the samples to generate.
+     * @param[in] elements The possible data indices, ordered by decreasing quality.
+     * @param[in] nbSamplesToUniform The number of samples after which the sampling is uniform.
+     */
+    ProsacSampler(std::size_t sampleSize, const std::vector<std::size_t>& elements, std::size_t nbSamplesToUniform = 200000)
+      : _sampleSize(sampleSize),
+        _elements(elements),
+        _subsetSize(sampleSize)
+    {
+        assert(elements.size() >= sampleSize);
+
+        // average number of samples containing only data from the first sampleSize data
+        _Tn = static_cast<double>(nbSamplesToUniform);
+        for (std::size_t i = 0; i < sampleSize; ++i)
+            _Tn *= static_cast<double>(sampleSize - i) / static_cast<double>(elements.size() - i);
+    }
+
+    /**
+     * @brief Generate the next sample.
+     * @param[in] generator the random number generator to use
+     * @param[out] sample The sample of sizeSample indices.
+     */
+    void sample(std::mt19937& randomNumberGenerator, std::vector<std::size_t>& sample)
+    {
+        ++_t;
+
+        // grow the hypothesis generation set
+        if (_t == _TnPrime && _subsetSize < _elements.size())
+        {
+            const double TnNext = _Tn * static_cast<double>(_subsetSize + 1) / static_cast<double>(_subsetSize + 1 - _sampleSize);
+            _TnPrime += static_cast<std::size_t>(std::ceil(TnNext - _Tn));
+            _Tn = TnNext;
+            ++_subsetSize;
+        }
+
+        if (_TnPrime < _t)
+        {
+            // uniform sample in the current subset
+            sample = randSample<std::size_t>(randomNumberGenerator, 0, _subsetSize, _sampleSize);
+        }
+        else
+        {
+            // the last data of the subset and a uniform sample of the previous ones
+            sample = randSample<std::size_t>(randomNumberGenerator, 0, _subsetSize - 1, _sampleSize - 1);
+            sample.push_back(_subsetSize - 1);
+        }
+
+        for (auto& s : sample)
+            s = _elements[s];
+    }
+
+    /// The size of the current hypothesis generation set
+    inline std::size_t getSubsetSize() const { return _subsetSize; }
+
+  private:
+    const std::size_t _sampleSize;
+    const std::vector<std::size_t>& _elements;
+    std::size_t _subsetSize;    //< n: size of the hypothesis generation set
+    std::size_t _t = 0;         //< number of generated samples
+    std::size_t _TnPrime = 1;   //< T'n: number of samples at which the subset grows
+    double _Tn = 0.0;           //< Tn: average number of samples from the n first data
+};
+
 }  // namespace robustEstimation
 }  // namespace aliceVision
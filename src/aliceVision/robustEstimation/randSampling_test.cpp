@@ -121,3 +121,44 @@ BOOST_AUTO_TEST_CASE(UniformSampleTest_randSample)
         }
     }
 }
+
+BOOST_AUTO_TEST_CASE(ProsacSamplerTest_ProgressiveSubset)
+{
+    std::mt19937 randomNumberGenerator;
+
+    const std::size_t nbData = 100;
+    const std::size_t sampleSize = 7;
+
+    // data indices ordered by decreasing quality
+    std::vector<std::size_t> elements(nbData);
+    for (std::size_t i = 0; i < nbData; ++i)
+        elements[i] = nbData - 1 - i;
+
+    ProsacSampler sampler(sampleSize, elements, 1000);
+
+    std::size_t previousSubsetSize = sampler.getSubsetSize();
+    for (std::size_t t = 0; t < 5000; ++t)
+    {
+        std::vector<std::size_t> samples(sampleSize);
+        sampler.sample(randomNumberGenerator, samples);
+
+        const std::size_t subsetSize = sampler.getSubsetSize();
+        BOOST_CHECK(subsetSize >= previousSubsetSize);
+        BOOST_CHECK(subsetSize <= nbData);
+        previousSubsetSize = subsetSize;
+
+        BOOST_CHECK_EQUAL(samples.size(), sampleSize);
+        std::set<std::size_t> sampleSet;
+        for (const auto& s : samples)
+        {
+            sampleSet.insert(s);
+            // the sample is drawn from the subset of the best data
+            BOOST_CHECK(s >= nbData - subsetSize);
+            BOOST_CHECK(s < nbData);
+        }
+        BOOST_CHECK_EQUAL(sampleSet.size(), sampleSize);
+    }
+
+    // the sampling is uniform on all the data after enough samples
+    BOOST_CHECK_EQUAL(sampler.getSubsetSize(), nbData);
+}
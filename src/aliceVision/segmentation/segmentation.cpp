@@ -10,20 +10,21 @@
     #include <cuda_runtime.h>
 #endif
 
+#include <aliceVision/half.hpp>
 #include <aliceVision/image/all.hpp>
 #include <aliceVision/image/imageAlgo.hpp>
 #include <aliceVision/numeric/numeric.hpp>
 
+#include <future>
+
 namespace aliceVision {
 namespace segmentation {
 
-void imageToPlanes(std::vector<float>& output, const image::Image<image::RGBfColor>::Base& source)
+void imageToPlanes(float* output, const image::Image<image::RGBfColor>::Base& source)
 {
     size_t planeSize = source.rows() * source.cols();
 
-    output.resize(planeSize * 3);
-
-    float* planeR = output.data();
+    float* planeR = output;
     float* planeG = planeR + planeSize;
     float* planeB = planeG + planeSize;
 
@@ -44,46 +45,51 @@ void imageToPlanes(std::vector<float>& output, const image::Image<image::RGBfCol
 
 bool Segmentation::initialize()
 {
-    const auto& api = Ort::GetApi();
-
-    _ortEnvironment = std::make_unique<Ort::Env>(ORT_LOGGING_LEVEL_WARNING, "aliceVision-imageSegmentation");
+    onnx::SessionOptions sessionOptions;
+    sessionOptions.useGpu = _parameters.useGpu;
+    sessionOptions.intraOpThreads = _parameters.nbThreads;
+
+    // The sessions are cached by the pool: the instances using the same model share their session
+    _ortSession = onnx::SessionPool::get().getSession(_parameters.modelWeights, sessionOptions);
+
+    // Model input and output element types (FP32 or FP16 models)
+    Ort::TypeInfo inputTypeInfo = _ortSession->GetInputTypeInfo(0);
+    const auto inputTensorInfo = inputTypeInfo.GetTensorTypeAndShapeInfo();
+    Ort::TypeInfo outputTypeInfo = _ortSession->GetOutputTypeInfo(0);
+    const auto outputTensorInfo = outputTypeInfo.GetTensorTypeAndShapeInfo();
+    _halfInput = (inputTensorInfo.GetElementType() == ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16);
+    _halfOutput = (outputTensorInfo.GetElementType() == ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16);
+
+    // A dynamic batch dimension (-1) accepts any number of tiles per run
+    const std::vector<int64_t> inputShape = inputTensorInfo.GetShape();
+    _fixedBatchSize = !inputShape.empty() && inputShape[0] > 0;
+    _batchSize = _fixedBatchSize ? static_cast<int>(inputShape[0]) : std::max(1, _parameters.batchSize);
+
+    ALICEVISION_LOG_INFO("Segmentation model: " << (_halfInput ? "FP16" : "FP32") << " input, batches of " << _batchSize << " tile(s)"
+                                                << (_fixedBatchSize ? " (fixed by the model)." : "."));
+
+    // Pre-allocate the batch buffers once
+    const std::size_t inputSize = 3 * _parameters.modelHeight * _parameters.modelWidth;
+    const std::size_t outputSize = _parameters.classes.size() * _parameters.modelHeight * _parameters.modelWidth;
+
+    _hostInput[0].reserve(_batchSize * inputSize);
+    _hostInput[1].reserve(_batchSize * inputSize);
+    _hostOutput.resize(_batchSize * outputSize);
+    if (_halfInput)
+        _hostInputHalf.resize(_batchSize * inputSize);
+    if (_halfOutput)
+        _hostOutputHalf.resize(_batchSize * outputSize);
 
-    Ort::SessionOptions ortSessionOptions;
-
-    // this is false if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_ONNX_GPU) is false
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_ONNX_GPU)
     if (_parameters.useGpu)
     {
-// Disable for compilation purpose if needed
-#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_ONNX_GPU)
-        OrtCUDAProviderOptionsV2* cuda_options = nullptr;
-        api.CreateCUDAProviderOptions(&cuda_options);
-        api.SessionOptionsAppendExecutionProvider_CUDA_V2(static_cast<OrtSessionOptions*>(ortSessionOptions), cuda_options);
-        api.ReleaseCUDAProviderOptions(cuda_options);
-
-    #if defined(_WIN32) || defined(_WIN64)
-        std::wstring modelWeights(_parameters.modelWeights.begin(), _parameters.modelWeights.end());
-        _ortSession = std::make_unique<Ort::Session>(*_ortEnvironment, modelWeights.c_str(), ortSessionOptions);
-    #else
-        _ortSession = std::make_unique<Ort::Session>(*_ortEnvironment, _parameters.modelWeights.c_str(), ortSessionOptions);
-    #endif
-
         Ort::MemoryInfo memInfoCuda("Cuda", OrtAllocatorType::OrtArenaAllocator, 0, OrtMemType::OrtMemTypeDefault);
         Ort::Allocator cudaAllocator(*_ortSession, memInfoCuda);
 
-        _output.resize(_parameters.classes.size() * _parameters.modelHeight * _parameters.modelWidth);
-        _cudaInput = cudaAllocator.Alloc(_output.size() * sizeof(float));
-        _cudaOutput = cudaAllocator.Alloc(_output.size() * sizeof(float));
-#endif
+        _cudaInput = cudaAllocator.Alloc(_batchSize * inputSize * (_halfInput ? sizeof(uint16_t) : sizeof(float)));
+        _cudaOutput = cudaAllocator.Alloc(_batchSize * outputSize * (_halfOutput ? sizeof(uint16_t) : sizeof(float)));
     }
-    else
-    {
-#if defined(_WIN32) || defined(_WIN64)
-        std::wstring modelWeights(_parameters.modelWeights.begin(), _parameters.modelWeights.end());
-        _ortSession = std::make_unique<Ort::Session>(*_ortEnvironment, modelWeights.c_str(), ortSessionOptions);
-#else
-        _ortSession = std::make_unique<Ort::Session>(*_ortEnvironment, _parameters.modelWeights.c_str(), ortSessionOptions);
 #endif
-    }
 
     return true;
 }
@@ -91,10 +97,15 @@ bool Segmentation::initialize()
 bool Segmentation::terminate()
 {
 #if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_ONNX_GPU)
-    Ort::MemoryInfo mem_info_cuda("Cuda", OrtAllocatorType::OrtArenaAllocator, 0, OrtMemType::OrtMemTypeDefault);
-    Ort::Allocator cudaAllocator(*_ortSession, mem_info_cuda);
-    cudaAllocator.Free(_cudaInput);
-    cudaAllocator.Free(_cudaOutput);
+    if (_cudaInput || _cudaOutput)
+    {
+        Ort::MemoryInfo mem_info_cuda("Cuda", OrtAllocatorType::OrtArenaAllocator, 0, OrtMemType::OrtMemTypeDefault);
+        Ort::Allocator cudaAllocator(*_ortSession, mem_info_cuda);
+        cudaAllocator.Free(_cudaInput);
+        cudaAllocator.Free(_cudaOutput);
+        _cudaInput = nullptr;
+        _cudaOutput = nullptr;
+    }
 #endif
 
     return true;
@@ -171,9 +182,8 @@ bool Segmentation::tiledProcess(image::Image<IndexT>& labels, const image::Image
     int cwidth = divideRoundUp(source.width(), _parameters.modelWidth);
     int cheight = divideRoundUp(source.height(), _parameters.modelHeight);
 
-    image::Image<ScoredLabel> scoredLabels(source.width(), source.height(), true, {0, 0.0f});
-
-    // Loop over tiles
+    // Compute the tiles positions
+    std::vector<std::pair<int, int>> tiles;
     for (int i = 0; i < cheight; i++)
     {
         // Compute starting point with overlap on previous
@@ -201,22 +211,68 @@ bool Segmentation::tiledProcess(image::Image<IndexT>& labels, const image::Image
             }
 
             // x and y contains the position of the tile in the input image
-            auto& block = source.block(y, x, _parameters.modelHeight, _parameters.modelWidth);
+            tiles.emplace_back(x, y);
+        }
+    }
 
-            // Compute tile
-            image::Image<ScoredLabel> tileLabels(_parameters.modelWidth, _parameters.modelHeight, true, {0, 0.0f});
+    const int tilesCount = static_cast<int>(tiles.size());
+    const int batchesCount = divideRoundUp(tilesCount, _batchSize);
+    const std::size_t inputSize = 3 * _parameters.modelHeight * _parameters.modelWidth;
+    const std::size_t outputSize = _parameters.classes.size() * _parameters.modelHeight * _parameters.modelWidth;
 
-            if (_parameters.useGpu)
-            {
-                processTileGPU(tileLabels, block);
-            }
-            else
+    // Convert the tiles of a batch to the planar model input
+    const auto prepareBatch = [&](int batch, std::vector<float>& input) {
+        const int first = batch * _batchSize;
+        const int count = std::min(_batchSize, tilesCount - first);
+
+        // A fixed size batch is padded with empty tiles
+        input.assign((_fixedBatchSize ? _batchSize : count) * inputSize, 0.0f);
+
+        for (int k = 0; k < count; k++)
+        {
+            const auto& tile = tiles[first + k];
+            imageToPlanes(input.data() + k * inputSize, source.block(tile.second, tile.first, _parameters.modelHeight, _parameters.modelWidth));
+        }
+    };
+
+    image::Image<ScoredLabel> scoredLabels(source.width(), source.height(), true, {0, 0.0f});
+    image::Image<ScoredLabel> tileLabels(_parameters.modelWidth, _parameters.modelHeight, true, {0, 0.0f});
+
+    prepareBatch(0, _hostInput[0]);
+
+    for (int batch = 0; batch < batchesCount; batch++)
+    {
+        // Prepare the next batch while the current one is processed
+        std::future<void> nextBatch;
+        if (batch + 1 < batchesCount)
+        {
+            nextBatch = std::async(std::launch::async, prepareBatch, batch + 1, std::ref(_hostInput[(batch + 1) % 2]));
+        }
+
+        const int first = batch * _batchSize;
+        const int count = std::min(_batchSize, tilesCount - first);
+
+        const bool processed = processBatch(_hostInput[batch % 2], count);
+
+        if (nextBatch.valid())
+        {
+            nextBatch.get();
+        }
+
+        if (!processed)
+        {
+            return false;
+        }
+
+        for (int k = 0; k < count; k++)
+        {
+            if (!labelsFromModelOutput(tileLabels, _hostOutput.data() + k * outputSize))
             {
-                processTile(tileLabels, block);
+                return false;
             }
 
             // Update the global labeling
-            mergeLabels(scoredLabels, tileLabels, x, y);
+            mergeLabels(scoredLabels, tileLabels, tiles[first + k].first, tiles[first + k].second);
         }
     }
 
@@ -244,7 +300,7 @@ bool Segmentation::mergeLabels(image::Image<ScoredLabel>& labels, image::Image<S
     return true;
 }
 
-bool Segmentation::labelsFromModelOutput(image::Image<ScoredLabel>& labels, const std::vector<float>& modelOutput)
+bool Segmentation::labelsFromModelOutput(image::Image<ScoredLabel>& labels, const float* modelOutput)
 {
     for (int outputY = 0; outputY < _parameters.modelHeight; outputY++)
     {
@@ -273,70 +329,65 @@ bool Segmentation::labelsFromModelOutput(image::Image<ScoredLabel>& labels, cons
     return true;
 }
 
-bool Segmentation::processTile(image::Image<ScoredLabel>& labels, const image::Image<image::RGBfColor>::Base& source)
+bool Segmentation::processBatch(const std::vector<float>& input, int tilesCount)
 {
-    ALICEVISION_LOG_TRACE("Process tile using cpu");
-    Ort::MemoryInfo memInfo = Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault);
+    ALICEVISION_LOG_TRACE("Process a batch of " << tilesCount << " tile(s) using " << (_parameters.useGpu ? "gpu" : "cpu"));
+
+    const int64_t batchSize = _fixedBatchSize ? _batchSize : tilesCount;
+    const std::size_t inputCount = batchSize * 3 * _parameters.modelHeight * _parameters.modelWidth;
+    const std::size_t outputCount = batchSize * _parameters.classes.size() * _parameters.modelHeight * _parameters.modelWidth;
 
     std::vector<const char*> inputNames{"input"};
     std::vector<const char*> outputNames{"output"};
-    std::vector<int64_t> inputDimensions = {1, 3, _parameters.modelHeight, _parameters.modelWidth};
-    std::vector<int64_t> outputDimensions = {1, static_cast<int64_t>(_parameters.classes.size()), _parameters.modelHeight, _parameters.modelWidth};
-
-    std::vector<float> output(_parameters.classes.size() * _parameters.modelHeight * _parameters.modelWidth);
-    Ort::Value outputTensors =
-      Ort::Value::CreateTensor<float>(memInfo, output.data(), output.size(), outputDimensions.data(), outputDimensions.size());
-
-    std::vector<float> transformedInput;
-    imageToPlanes(transformedInput, source);
-
-    Ort::Value inputTensors =
-      Ort::Value::CreateTensor<float>(memInfo, transformedInput.data(), transformedInput.size(), inputDimensions.data(), inputDimensions.size());
-
-    try
+    std::vector<int64_t> inputDimensions = {batchSize, 3, _parameters.modelHeight, _parameters.modelWidth};
+    std::vector<int64_t> outputDimensions = {
+      batchSize, static_cast<int64_t>(_parameters.classes.size()), _parameters.modelHeight, _parameters.modelWidth};
+
+    const ONNXTensorElementDataType inputType = _halfInput ? ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16 : ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT;
+    const ONNXTensorElementDataType outputType = _halfOutput ? ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16 : ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT;
+    const std::size_t inputBytes = inputCount * (_halfInput ? sizeof(uint16_t) : sizeof(float));
+    const std::size_t outputBytes = outputCount * (_halfOutput ? sizeof(uint16_t) : sizeof(float));
+
+    // Host buffers in the model element types
+    void* hostInput = const_cast<float*>(input.data());
+    if (_halfInput)
     {
-        _ortSession->Run(Ort::RunOptions{nullptr}, inputNames.data(), &inputTensors, 1, outputNames.data(), &outputTensors, 1);
-    }
-    catch (const Ort::Exception& exception)
-    {
-        ALICEVISION_LOG_ERROR("ERROR running model inference: " << exception.what());
-        return false;
-    }
-
-    if (!labelsFromModelOutput(labels, output))
-    {
-        return false;
+        for (std::size_t i = 0; i < inputCount; i++)
+        {
+            _hostInputHalf[i] = half(input[i]).bits();
+        }
+        hostInput = _hostInputHalf.data();
     }
+    void* hostOutput = _halfOutput ? static_cast<void*>(_hostOutputHalf.data()) : static_cast<void*>(_hostOutput.data());
 
-    return true;
-}
+    // Bind the pre-allocated buffers, on the device when the gpu is used
+    Ort::MemoryInfo memInfo = Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault);
+    void* modelInput = hostInput;
+    void* modelOutput = hostOutput;
 
-bool Segmentation::processTileGPU(image::Image<ScoredLabel>& labels, const image::Image<image::RGBfColor>::Base& source)
-{
-    ALICEVISION_LOG_TRACE("Process tile using gpu");
 #if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
-    Ort::MemoryInfo mem_info_cuda("Cuda", OrtAllocatorType::OrtArenaAllocator, 0, OrtMemType::OrtMemTypeDefault);
-    Ort::Allocator cudaAllocator(*_ortSession, mem_info_cuda);
-
-    std::vector<const char*> inputNames{"input"};
-    std::vector<const char*> outputNames{"output"};
-    std::vector<int64_t> inputDimensions = {1, 3, _parameters.modelHeight, _parameters.modelWidth};
-    std::vector<int64_t> outputDimensions = {1, static_cast<int64_t>(_parameters.classes.size()), _parameters.modelHeight, _parameters.modelWidth};
-
-    Ort::Value outputTensors = Ort::Value::CreateTensor<float>(
-      mem_info_cuda, reinterpret_cast<float*>(_cudaOutput), _output.size(), outputDimensions.data(), outputDimensions.size());
-
-    std::vector<float> transformedInput;
-    imageToPlanes(transformedInput, source);
-
-    cudaMemcpy(_cudaInput, transformedInput.data(), sizeof(float) * transformedInput.size(), cudaMemcpyHostToDevice);
-
-    Ort::Value inputTensors = Ort::Value::CreateTensor<float>(
-      mem_info_cuda, reinterpret_cast<float*>(_cudaInput), transformedInput.size(), inputDimensions.data(), inputDimensions.size());
+    if (_parameters.useGpu)
+    {
+        memInfo = Ort::MemoryInfo("Cuda", OrtAllocatorType::OrtArenaAllocator, 0, OrtMemType::OrtMemTypeDefault);
+        cudaMemcpy(_cudaInput, hostInput, inputBytes, cudaMemcpyHostToDevice);
+        modelInput = _cudaInput;
+        modelOutput = _cudaOutput;
+    }
+#endif
 
     try
     {
-        _ortSession->Run(Ort::RunOptions{nullptr}, inputNames.data(), &inputTensors, 1, outputNames.data(), &outputTensors, 1);
+        Ort::Value inputTensors =
+          Ort::Value::CreateTensor(memInfo, modelInput, inputBytes, inputDimensions.data(), inputDimensions.size(), inputType);
+        Ort::Value outputTensors =
+          Ort::Value::CreateTensor(memInfo, modelOutput, outputBytes, outputDimensions.data(), outputDimensions.size(), outputType);
+
+        Ort::IoBinding binding(*_ortSession);
+        binding.BindInput(inputNames[0], inputTensors);
+        binding.BindOutput(outputNames[0], outputTensors);
+
+        _ortSession->Run(Ort::RunOptions{nullptr}, binding);
+        binding.SynchronizeOutputs();
     }
     catch (const Ort::Exception& exception)
     {
@@ -344,17 +395,25 @@ bool Segmentation::processTileGPU(image::Image<ScoredLabel>& labels, const image
         return false;
     }
 
-    cudaMemcpy(_output.data(), _cudaOutput, sizeof(float) * _output.size(), cudaMemcpyDeviceToHost);
-
-    if (!labelsFromModelOutput(labels, _output))
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
+    if (_parameters.useGpu)
     {
-        return false;
+        cudaMemcpy(hostOutput, _cudaOutput, outputBytes, cudaMemcpyDeviceToHost);
     }
-
 #endif
 
+    if (_halfOutput)
+    {
+        half value;
+        for (std::size_t i = 0; i < outputCount; i++)
+        {
+            value.setBits(_hostOutputHalf[i]);
+            _hostOutput[i] = value;
+        }
+    }
+
     return true;
 }
 
 }  // namespace segmentation
-}  // namespace aliceVision
\ No newline at end of file
+}  // namespace aliceVision
@@ -10,9 +10,7 @@
 #include <aliceVision/config.hpp>
 #include <aliceVision/types.hpp>
 #include <aliceVision/image/Image.hpp>
-
-// ONNXRuntime
-#include <onnxruntime_cxx_api.h>
+#include <aliceVision/onnx/SessionPool.hpp>
 
 namespace aliceVision {
 namespace segmentation {
@@ -40,6 +38,10 @@ class Segmentation
         int modelHeight;
         double overlapRatio;
         bool useGpu = true;
+        /// Maximum number of tiles processed by a single model run (a model with a fixed batch dimension imposes its own)
+        int batchSize = 4;
+        /// Number of threads used by the inference of an operator (0: ONNX runtime default)
+        int nbThreads = 0;
     };
 
   public:
@@ -47,7 +49,7 @@ class Segmentation
       : _parameters(parameters)
     {
 // Disable gpu if disabled on compilation side
-#if !ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_ONNX_GPU)
+#if !ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_ONNX_GPU) || !ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
         _parameters.useGpu = false;
 #endif
 
@@ -87,23 +89,17 @@ class Segmentation
     /**
      * Transform model output to a label image
      * @param labels the output labels imaage
-     * @param modeloutput the model output vector
-     */
-    bool labelsFromModelOutput(image::Image<ScoredLabel>& labels, const std::vector<float>& modelOutput);
-
-    /**
-     * Process effectively a buffer of the model input size
-     * param labels the output labels
-     * @param source the source tile
+     * @param modeloutput the model output of a tile
      */
-    bool processTile(image::Image<ScoredLabel>& labels, const image::Image<image::RGBfColor>::Base& source);
+    bool labelsFromModelOutput(image::Image<ScoredLabel>& labels, const float* modelOutput);
 
     /**
-     * Process effectively a buffer of the model input size
-     * param labels the output labels
-     * @param source the source tile
+     * Run the model on a batch of tiles, bound to the pre-allocated buffers
+     * The output of the batch is stored in _hostOutput
+     * @param input the planar input of the batch tiles
+     * @param tilesCount the number of tiles in the batch
      */
-    bool processTileGPU(image::Image<ScoredLabel>& labels, const image::Image<image::RGBfColor>::Base& source);
+    bool processBatch(const std::vector<float>& input, int tilesCount);
 
     /**
      * Merge tile labels with global labels image
@@ -116,15 +112,26 @@ class Segmentation
 
   protected:
     Parameters _parameters;
-    std::unique_ptr<Ort::Env> _ortEnvironment;
-    std::unique_ptr<Ort::Session> _ortSession;
-
-    std::vector<float> _output;
-
-#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
-    void* _cudaOutput;
-    void* _cudaInput;
-#endif
+    /// Session shared through the session pool with the other instances using the same model
+    std::shared_ptr<Ort::Session> _ortSession;
+
+    /// Number of tiles processed by a model run
+    int _batchSize = 1;
+    /// The model batch dimension is fixed: the last batch is padded
+    bool _fixedBatchSize = false;
+    /// The model input and output are half floats
+    bool _halfInput = false;
+    bool _halfOutput = false;
+
+    /// Planar input of two batches: the next batch is prepared while the current one is processed
+    std::vector<float> _hostInput[2];
+    std::vector<float> _hostOutput;
+    /// Half float conversion buffers for FP16 models
+    std::vector<uint16_t> _hostInputHalf;
+    std::vector<uint16_t> _hostOutputHalf;
+
+    void* _cudaOutput = nullptr;
+    void* _cudaInput = nullptr;
 };
 
 }  // namespace segmentation
@@ -33,6 +33,19 @@ struct Datasheet
 
     bool operator==(const Datasheet& other) const;
 
+    /**
+     * @brief Normalize a brand or a model name for the comparisons: lower case, without punctuation and spaces.
+     * @param[in] name The brand or model name
+     * @return The normalized name
+     */
+    static std::string normalizeName(const std::string& name);
+
+    /**
+     * @brief Compare normalized brands and models, with the same rules as operator==.
+     *        The brands match if one starts with the other, the models match if one ends with the other.
+     */
+    static bool matchNormalizedNames(const std::string& brandA, const std::string& modelA, const std::string& brandB, const std::string& modelB);
+
     std::string _brand;
     std::string _model;
     double _sensorWidth;
@@ -0,0 +1,63 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "DatasheetIndex.hpp"
+
+namespace aliceVision {
+namespace sensorDB {
+
+DatasheetIndex::DatasheetIndex(const std::vector<Datasheet>& databaseStructure)
+  : _datasheets(databaseStructure)
+{
+    _normalizedNames.reserve(_datasheets.size());
+    for (const Datasheet& datasheet : _datasheets)
+        _normalizedNames.emplace_back(Datasheet::normalizeName(datasheet._brand), Datasheet::normalizeName(datasheet._model));
+}
+
+bool DatasheetIndex::getInfo(const std::string& brand, const std::string& model, Datasheet& datasheetContent) const
+{
+    // the brand length makes the key unambiguous whatever the characters of the names
+    const std::string key = std::to_string(brand.size()) + ':' + brand + model;
+
+    int datasheetIndex = -1;
+    bool cached = false;
+    {
+        std::lock_guard<std::mutex> lock(_cacheMutex);
+        const auto it = _cache.find(key);
+        if (it != _cache.end())
+        {
+            datasheetIndex = it->second;
+            cached = true;
+        }
+    }
+
+    if (!cached)
+    {
+        // first matching datasheet, in the database order
+        const std::string normalizedBrand = Datasheet::normalizeName(brand);
+        const std::string normalizedModel = Datasheet::normalizeName(model);
+        for (std::size_t i = 0; i < _normalizedNames.size(); ++i)
+        {
+            if (Datasheet::matchNormalizedNames(_normalizedNames[i].first, _normalizedNames[i].second, normalizedBrand, normalizedModel))
+            {
+                datasheetIndex = static_cast<int>(i);
+                break;
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(_cacheMutex);
+        _cache.emplace(key, datasheetIndex);
+    }
+
+    if (datasheetIndex < 0)
+        return false;
+
+    datasheetContent = _datasheets[datasheetIndex];
+    return true;
+}
+
+}  // namespace sensorDB
+}  // namespace aliceVision
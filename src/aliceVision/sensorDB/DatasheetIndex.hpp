@@ -0,0 +1,54 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/sensorDB/Datasheet.hpp>
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace aliceVision {
+namespace sensorDB {
+
+/**
+ * @brief Sensor database prepared once for the lookups of many images.
+ *        The brands and models of the datasheets are normalized at construction,
+ *        and the result of each brand / model lookup is cached, as the images of a dataset share a few cameras.
+ *        The lookups return the same datasheet as getInfo and can be done from several threads.
+ */
+class DatasheetIndex
+{
+  public:
+    /**
+     * @brief Build the index of the given sensor database
+     * @param[in] databaseStructure The database in memory
+     */
+    explicit DatasheetIndex(const std::vector<Datasheet>& databaseStructure);
+
+    /**
+     * @brief Get information for the given camera brand / model
+     * @param[in] brand The camera brand
+     * @param[in] model The camera model
+     * @param[out] datasheetContent The corresponding datasheet
+     * @return True if ok
+     */
+    bool getInfo(const std::string& brand, const std::string& model, Datasheet& datasheetContent) const;
+
+  private:
+    std::vector<Datasheet> _datasheets;
+    /// normalized brand and model of each datasheet
+    std::vector<std::pair<std::string, std::string>> _normalizedNames;
+
+    mutable std::mutex _cacheMutex;
+    /// datasheet index per brand / model lookup, -1 if there is no datasheet
+    mutable std::unordered_map<std::string, int> _cache;
+};
+
+}  // namespace sensorDB
+}  // namespace aliceVision
@@ -6,6 +6,7 @@
 // You can obtain one at https://mozilla.org/MPL/2.0/.
 
 #include <aliceVision/sensorDB/parseDatabase.hpp>
+#include <aliceVision/sensorDB/DatasheetIndex.hpp>
 
 #include <filesystem>
 #include <string>
@@ -110,3 +111,35 @@ BOOST_AUTO_TEST_CASE(ParseDatabaseCanon_EOS_1100D)
     BOOST_CHECK(getInfo(sBrand, sModel, vec_database, datasheet));
     BOOST_CHECK_EQUAL(22.2, datasheet._sensorWidth);
 }
+
+BOOST_AUTO_TEST_CASE(DatasheetIndexSameAsGetInfo)
+{
+    std::vector<Datasheet> vec_database;
+    BOOST_CHECK(parseDatabase(sDatabase, vec_database));
+
+    const DatasheetIndex index(vec_database);
+
+    std::vector<std::pair<std::string, std::string>> queries = {
+      {"Canon", "Canon PowerShot SD900"}, {"Canon", "Canon EOS 550D"}, {"NIKON CORPORATION", "NIKON D800"}, {"Unknown", "Unknown"}, {"", ""}};
+    for (std::size_t i = 0; i < vec_database.size(); i += 37)
+        queries.emplace_back(vec_database[i]._brand, vec_database[i]._model);
+
+    // twice, to check the cached results
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        for (const auto& query : queries)
+        {
+            Datasheet expected;
+            Datasheet datasheet;
+            const bool found = getInfo(query.first, query.second, vec_database, expected);
+
+            BOOST_CHECK_EQUAL(index.getInfo(query.first, query.second, datasheet), found);
+            if (found)
+            {
+                BOOST_CHECK_EQUAL(datasheet._brand, expected._brand);
+                BOOST_CHECK_EQUAL(datasheet._model, expected._model);
+                BOOST_CHECK_EQUAL(datasheet._sensorWidth, expected._sensorWidth);
+            }
+        }
+    }
+}
@@ -14,7 +14,12 @@
 #include <aliceVision/geometry/HalfPlane.hpp>
 #include <aliceVision/config.hpp>
 
+#include <Eigen/Geometry>
+
+#include <algorithm>
 #include <fstream>
+#include <limits>
+#include <numeric>
 
 namespace aliceVision {
 namespace sfm {
@@ -56,33 +61,202 @@ void FrustumFilter::initFrustum(const sfmData::SfMData& sfmData)
     }
 }
 
+namespace {
+
+/**
+ * @brief Bounding volume hierarchy of axis aligned boxes, to find the boxes that may overlap a query box
+ *        without testing all of them.
+ */
+class BoxesTree
+{
+  public:
+    using Box = Eigen::AlignedBox3d;
+
+    explicit BoxesTree(const std::vector<Box>& boxes)
+      : _boxes(boxes),
+        _indexes(boxes.size())
+    {
+        std::iota(_indexes.begin(), _indexes.end(), 0);
+        if (!_boxes.empty())
+            build(0, _indexes.size());
+    }
+
+    /**
+     * @brief Get the indexes of the boxes overlapping the query box.
+     * @param[in] box The query box
+     * @param[out] out_indexes The overlapping boxes indexes (not sorted)
+     */
+    void getOverlapping(const Box& box, std::vector<std::size_t>& out_indexes) const
+    {
+        if (_nodes.empty())
+            return;
+
+        std::vector<int> stack(1, 0);
+        while (!stack.empty())
+        {
+            const Node& node = _nodes[stack.back()];
+            stack.pop_back();
+
+            if (!node.box.intersects(box))
+                continue;
+
+            if (node.left < 0)  // leaf
+            {
+                for (std::size_t i = node.begin; i < node.end; ++i)
+                {
+                    if (_boxes[_indexes[i]].intersects(box))
+                        out_indexes.push_back(_indexes[i]);
+                }
+                continue;
+            }
+            stack.push_back(node.left);
+            stack.push_back(node.right);
+        }
+    }
+
+  private:
+    struct Node
+    {
+        Box box;
+        std::size_t begin = 0;
+        std::size_t end = 0;
+        int left = -1;  //< -1 for a leaf
+        int right = -1;
+    };
+
+    /**
+     * @brief Build the subtree of the given range of boxes.
+     * @return the index of the subtree root node
+     */
+    int build(std::size_t begin, std::size_t end)
+    {
+        const int nodeIndex = static_cast<int>(_nodes.size());
+        _nodes.emplace_back();
+
+        Box box;
+        for (std::size_t i = begin; i < end; ++i)
+            box.extend(_boxes[_indexes[i]]);
+        _nodes[nodeIndex].box = box;
+        _nodes[nodeIndex].begin = begin;
+        _nodes[nodeIndex].end = end;
+
+        const std::size_t maxLeafSize = 8;
+        if (end - begin <= maxLeafSize)
+            return nodeIndex;
+
+        // median split of the boxes centers along the largest axis
+        int axis;
+        box.sizes().maxCoeff(&axis);
+        const std::size_t middle = begin + (end - begin) / 2;
+        std::nth_element(_indexes.begin() + begin, _indexes.begin() + middle, _indexes.begin() + end, [&](std::size_t a, std::size_t b) {
+            return _boxes[a].center()(axis) < _boxes[b].center()(axis);
+        });
+
+        const int left = build(begin, middle);
+        const int right = build(middle, end);
+        _nodes[nodeIndex].left = left;
+        _nodes[nodeIndex].right = right;
+        return nodeIndex;
+    }
+
+    const std::vector<Box>& _boxes;
+    std::vector<std::size_t> _indexes;
+    std::vector<Node> _nodes;
+};
+
+}  // namespace
+
 PairSet FrustumFilter::getFrustumIntersectionPairs() const
 {
-    PairSet pairs;
-    // List active view Id
+    // List active view Id (views with a valid frustum)
     std::vector<IndexT> viewIds;
-    viewIds.reserve(z_near_z_far_perView.size());
-    std::transform(z_near_z_far_perView.begin(), z_near_z_far_perView.end(), std::back_inserter(viewIds), stl::RetrieveKey());
+    viewIds.reserve(frustum_perView.size());
+    std::transform(frustum_perView.begin(), frustum_perView.end(), std::back_inserter(viewIds), stl::RetrieveKey());
 
-    auto progressDisplay =
-      system::createConsoleProgressDisplay(viewIds.size() * (viewIds.size() - 1) / 2, std::cout, "\nCompute frustum intersection\n");
+    std::vector<const Frustum*> frustums;
+    frustums.reserve(viewIds.size());
+    for (const IndexT viewId : viewIds)
+        frustums.push_back(&frustum_perView.at(viewId));
 
-// Exhaustive comparison (use the fact that the intersect function is symmetric)
-#pragma omp parallel for
-    for (int i = 0; i < (int)viewIds.size(); ++i)
+    // index the bounding boxes of the bounded frustums, the unbounded ones are tested against all the others
+    std::vector<BoxesTree::Box> boxes;
+    std::vector<std::size_t> boundedFrustums;
+    std::vector<std::size_t> unboundedFrustums;
+    for (std::size_t i = 0; i < frustums.size(); ++i)
     {
-        for (size_t j = i + 1; j < viewIds.size(); ++j)
+        Vec3 bbMin, bbMax;
+        if (frustums[i]->getBoundingBox(bbMin, bbMax))
+        {
+            boxes.emplace_back(bbMin, bbMax);
+            boundedFrustums.push_back(i);
+        }
+        else
         {
-            if (frustum_perView.at(viewIds[i]).intersect(frustum_perView.at(viewIds[j])))
+            unboundedFrustums.push_back(i);
+        }
+    }
+    const BoxesTree boxesTree(boxes);
+
+    ALICEVISION_LOG_DEBUG("Frustum intersection: " << boundedFrustums.size() << " bounded and " << unboundedFrustums.size() << " unbounded frustums.");
+
+    auto progressDisplay = system::createConsoleProgressDisplay(viewIds.size(), std::cout, "\nCompute frustum intersection\n");
+
+    // intersecting views per view, merged in order after the parallel loop
+    std::vector<std::vector<IndexT>> intersectingViews(viewIds.size());
+    std::vector<std::size_t> boxIndexOf(viewIds.size(), std::numeric_limits<std::size_t>::max());
+    for (std::size_t b = 0; b < boundedFrustums.size(); ++b)
+        boxIndexOf[boundedFrustums[b]] = b;
+
+#pragma omp parallel
+    {
+        std::vector<std::size_t> overlappingBoxes;
+        std::vector<std::size_t> candidates;
+
+#pragma omp for schedule(dynamic)
+        for (int i = 0; i < (int)viewIds.size(); ++i)
+        {
+            // candidates j > i (use the fact that the intersect function is symmetric)
+            candidates.clear();
+            if (boxIndexOf[i] != std::numeric_limits<std::size_t>::max())
             {
-#pragma omp critical
+                overlappingBoxes.clear();
+                boxesTree.getOverlapping(boxes[boxIndexOf[i]], overlappingBoxes);
+                for (const std::size_t b : overlappingBoxes)
+                {
+                    if (boundedFrustums[b] > std::size_t(i))
+                        candidates.push_back(boundedFrustums[b]);
+                }
+                for (const std::size_t j : unboundedFrustums)
                 {
-                    pairs.insert(std::make_pair(viewIds[i], viewIds[j]));
+                    if (j > std::size_t(i))
+                        candidates.push_back(j);
                 }
+                std::sort(candidates.begin(), candidates.end());
+            }
+            else
+            {
+                for (std::size_t j = i + 1; j < viewIds.size(); ++j)
+                    candidates.push_back(j);
+            }
+
+            const Frustum& frustumI = *frustums[i];
+            for (const std::size_t j : candidates)
+            {
+                const Frustum& frustumJ = *frustums[j];
+                // the separating planes test is much cheaper than the linear program
+                if (!frustumI.isSeparated(frustumJ) && frustumI.intersect(frustumJ))
+                    intersectingViews[i].push_back(viewIds[j]);
             }
             ++progressDisplay;
         }
     }
+
+    PairSet pairs;
+    for (std::size_t i = 0; i < viewIds.size(); ++i)
+    {
+        for (const IndexT viewIdJ : intersectingViews[i])
+            pairs.insert(std::make_pair(viewIds[i], viewIdJ));
+    }
     return pairs;
 }
 
@@ -10,6 +10,8 @@
 #include <boost/detail/bitmask.hpp>
 #include <string>
 #include <algorithm>
+#include <iterator>
+#include <istream>
 #include <stdexcept>
 
 namespace aliceVision {
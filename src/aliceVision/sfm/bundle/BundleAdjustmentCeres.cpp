@@ -9,6 +9,7 @@
 #include <aliceVision/sfm/ResidualErrorFunctor.hpp>
 #include <aliceVision/sfm/ResidualErrorConstraintFunctor.hpp>
 #include <aliceVision/sfm/ResidualErrorRotationPriorFunctor.hpp>
+#include <aliceVision/sfm/bundle/costfunctions/projectionPinholeRadial.hpp>
 #include <aliceVision/sfmData/SfMData.hpp>
 #include <aliceVision/alicevision_omp.hpp>
 #include <aliceVision/config.hpp>
@@ -187,9 +188,13 @@ class IntrinsicsManifold : public ceres::Manifold
  * @brief Create the appropriate cost functor according the provided input camera intrinsic model
  * @param[in] intrinsicPtr The intrinsic pointer
  * @param[in] observation The corresponding observation
+ * @param[in] useAnalyticJacobians Use the cost functions with analytic Jacobians instead of the automatic differentiation,
+ *            when available for the intrinsic model
  * @return cost functor
  */
-ceres::CostFunction* createCostFunctionFromIntrinsics(const IntrinsicBase* intrinsicPtr, const sfmData::Observation& observation)
+ceres::CostFunction* createCostFunctionFromIntrinsics(const IntrinsicBase* intrinsicPtr,
+                                                      const sfmData::Observation& observation,
+                                                      bool useAnalyticJacobians)
 {
     int w = intrinsicPtr->w();
     int h = intrinsicPtr->h();
@@ -213,6 +218,23 @@ ceres::CostFunction* createCostFunctionFromIntrinsics(const IntrinsicBase* intri
 
     camera::EDISTORTION distoType = camera::getDistortionType(*intrinsicPtr);
 
+    if (useAnalyticJacobians && intrinsicPtr->getType() == EINTRINSIC::PINHOLE_CAMERA)
+    {
+        switch (distoType)
+        {
+            case EDISTORTION::DISTORTION_NONE:
+            case EDISTORTION::DISTORTION_3DEANAMORPHIC4:
+                return new CostProjectionPinholeRadial<0>(w, h, obsUndistorted);
+            case EDISTORTION::DISTORTION_RADIALK1:
+                return new CostProjectionPinholeRadial<1>(w, h, obsUndistorted);
+            case EDISTORTION::DISTORTION_RADIALK3:
+                return new CostProjectionPinholeRadial<3>(w, h, obsUndistorted);
+            default:
+                // no analytic cost function for this model, use the automatic differentiation
+                break;
+        }
+    }
+
     if (intrinsicPtr->getType() == EINTRINSIC::PINHOLE_CAMERA)
     {
         switch (distoType)
@@ -534,6 +556,47 @@ void BundleAdjustmentCeres::Statistics::show() const
                          << "\t- final   RMSE: " << RMSEfinal);
 }
 
+void BundleAdjustmentCeres::CeresOptions::setIterativeBA()
+{
+    // conjugate gradients on the reduced camera system, without explicit factorization
+    preconditionerType = ceres::SCHUR_JACOBI;
+    linearSolverType = ceres::ITERATIVE_SCHUR;
+    sparseLinearAlgebraLibraryType = ceres::SUITE_SPARSE;  // not used but just to avoid a warning in ceres
+    ALICEVISION_LOG_DEBUG("BundleAdjustment[Ceres]: ITERATIVE_SCHUR, SCHUR_JACOBI");
+}
+
+void setCudaSolverOptions(ceres::Solver::Options& solverOptions)
+{
+#if CERES_VERSION_MAJOR > 2 || (CERES_VERSION_MAJOR == 2 && CERES_VERSION_MINOR >= 2)
+    const ceres::LinearSolverType linearSolverType = solverOptions.linear_solver_type;
+
+    if (linearSolverType == ceres::DENSE_SCHUR || linearSolverType == ceres::DENSE_NORMAL_CHOLESKY || linearSolverType == ceres::DENSE_QR)
+    {
+        if (ceres::IsDenseLinearAlgebraLibraryTypeAvailable(ceres::CUDA))
+        {
+            solverOptions.dense_linear_algebra_library_type = ceres::CUDA;
+            ALICEVISION_LOG_DEBUG("BundleAdjustment[Ceres]: dense linear solver on CUDA");
+            return;
+        }
+    }
+#if CERES_VERSION_MAJOR > 2 || CERES_VERSION_MINOR >= 3
+    else if (linearSolverType == ceres::SPARSE_SCHUR || linearSolverType == ceres::SPARSE_NORMAL_CHOLESKY)
+    {
+        if (ceres::IsSparseLinearAlgebraLibraryTypeAvailable(ceres::CUDA_SPARSE))
+        {
+            solverOptions.sparse_linear_algebra_library_type = ceres::CUDA_SPARSE;
+            ALICEVISION_LOG_DEBUG("BundleAdjustment[Ceres]: sparse linear solver on CUDA");
+            return;
+        }
+    }
+#endif
+    ALICEVISION_LOG_WARNING("BundleAdjustment[Ceres]: no CUDA implementation of the linear solver '"
+                            << ceres::LinearSolverTypeToString(linearSolverType) << "' in Ceres, fallback to the CPU solver.");
+#else
+    ALICEVISION_LOG_WARNING("BundleAdjustment[Ceres]: CUDA linear solvers require Ceres >= 2.2, fallback to the CPU solver.");
+#endif
+}
+
 void BundleAdjustmentCeres::setSolverOptions(ceres::Solver::Options& solverOptions) const
 {
     solverOptions.preconditioner_type = _ceresOptions.preconditionerType;
@@ -551,6 +614,11 @@ void BundleAdjustmentCeres::setSolverOptions(ceres::Solver::Options& solverOptio
     solverOptions.num_linear_solver_threads = _ceresOptions.nbThreads;
 #endif
 
+    if (_ceresOptions.useCuda)
+    {
+        setCudaSolverOptions(solverOptions);
+    }
+
     if (_ceresOptions.useParametersOrdering)
     {
         // copy ParameterBlockOrdering
@@ -839,19 +907,26 @@ void BundleAdjustmentCeres::addLandmarksToProblem(const sfmData::SfMData& sfmDat
         // add landmark parameter to the all parameters blocks pointers list
         _allParametersBlocks.push_back(landmarkBlockPtr);
 
+        if (landmark.getObservations().empty())
+            continue;
+
+        const bool isLandmarkConstant = (!refineStructure || landmark.state == EEstimatorParameterState::CONSTANT);
+
+        // apply a specific parameter ordering:
+        if (_ceresOptions.useParametersOrdering)
+            _linearSolverOrdering.AddElementToGroup(landmarkBlockPtr, 0);
+
         // iterate over 2D observation associated to the 3D landmark
         for (const auto& observationPair : landmark.getObservations())
         {
             const sfmData::View& view = sfmData.getView(observationPair.first);
             const sfmData::Observation& observation = observationPair.second;
+            const camera::IntrinsicBase* intrinsic = sfmData.getIntrinsicPtr(view.getIntrinsicId());
 
             // each residual block takes a point and a camera as input and outputs a 2
             // dimensional residual. Internally, the cost function stores the observed
             // image location and compares the reprojection against the observation.
-            const auto& pose = sfmData.getPose(view);
-            const auto& intrinsic = sfmData.getIntrinsicSharedPtr(view);
-
-            assert(pose.getState() != EEstimatorParameterState::IGNORED);
+            assert(sfmData.getPose(view).getState() != EEstimatorParameterState::IGNORED);
             assert(intrinsic->getState() != EEstimatorParameterState::IGNORED);
 
             // needed parameters to create a residual block (K, pose)
@@ -859,19 +934,22 @@ void BundleAdjustmentCeres::addLandmarksToProblem(const sfmData::SfMData& sfmDat
             double* intrinsicBlockPtr = _intrinsicsBlocks.at(view.getIntrinsicId()).data();
 
             // apply a specific parameter ordering:
+            // poses and intrinsics are shared by many observations, only add them once
             if (_ceresOptions.useParametersOrdering)
             {
-                _linearSolverOrdering.AddElementToGroup(landmarkBlockPtr, 0);
-                _linearSolverOrdering.AddElementToGroup(poseBlockPtr, 1);
-                _linearSolverOrdering.AddElementToGroup(intrinsicBlockPtr, 2);
+                if (!_linearSolverOrdering.IsMember(poseBlockPtr))
+                    _linearSolverOrdering.AddElementToGroup(poseBlockPtr, 1);
+                if (!_linearSolverOrdering.IsMember(intrinsicBlockPtr))
+                    _linearSolverOrdering.AddElementToGroup(intrinsicBlockPtr, 2);
             }
 
             if (view.isPartOfRig() && !view.isPoseIndependant())
             {
-                ceres::CostFunction* costFunction = createRigCostFunctionFromIntrinsics(sfmData.getIntrinsicPtr(view.getIntrinsicId()), observation);
+                ceres::CostFunction* costFunction = createRigCostFunctionFromIntrinsics(intrinsic, observation);
 
                 double* rigBlockPtr = _rigBlocks.at(view.getRigId()).at(view.getSubPoseId()).data();
-                _linearSolverOrdering.AddElementToGroup(rigBlockPtr, 1);
+                if (!_linearSolverOrdering.IsMember(rigBlockPtr))
+                    _linearSolverOrdering.AddElementToGroup(rigBlockPtr, 1);
 
                 problem.AddResidualBlock(costFunction,
                                          lossFunction,
@@ -882,7 +960,7 @@ void BundleAdjustmentCeres::addLandmarksToProblem(const sfmData::SfMData& sfmDat
             }
             else
             {
-                ceres::CostFunction* costFunction = createCostFunctionFromIntrinsics(sfmData.getIntrinsicPtr(view.getIntrinsicId()), observation);
+                ceres::CostFunction* costFunction = createCostFunctionFromIntrinsics(intrinsic, observation, _ceresOptions.useAnalyticJacobians);
 
                 problem.AddResidualBlock(costFunction,
                                          lossFunction,
@@ -891,16 +969,13 @@ void BundleAdjustmentCeres::addLandmarksToProblem(const sfmData::SfMData& sfmDat
                                          landmarkBlockPtr);  // do we need to copy 3D point to avoid false motion, if failure ?
             }
 
-            if (!refineStructure || landmark.state == EEstimatorParameterState::CONSTANT)
-            {
-                // set the whole landmark parameter block as constant.
-                _statistics.addState(EParameter::LANDMARK, EEstimatorParameterState::CONSTANT);
-                problem.SetParameterBlockConstant(landmarkBlockPtr);
-            }
-            else
-            {
-                _statistics.addState(EParameter::LANDMARK, EEstimatorParameterState::REFINED);
-            }
+            _statistics.addState(EParameter::LANDMARK, isLandmarkConstant ? EEstimatorParameterState::CONSTANT : EEstimatorParameterState::REFINED);
+        }
+
+        if (isLandmarkConstant)
+        {
+            // set the whole landmark parameter block as constant.
+            problem.SetParameterBlockConstant(landmarkBlockPtr);
         }
     }
 }
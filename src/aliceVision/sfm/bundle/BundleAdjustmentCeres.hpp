@@ -45,6 +45,8 @@ class BundleAdjustmentCeres : public BundleAdjustment
 
         void setDenseBA();
         void setSparseBA();
+        /// iterative Schur solver, for large problems where the factorization of the reduced camera system is too expensive
+        void setIterativeBA();
 
         ceres::LinearSolverType linearSolverType;
         ceres::PreconditionerType preconditionerType;
@@ -53,6 +55,10 @@ class BundleAdjustmentCeres : public BundleAdjustment
         unsigned int nbThreads;
         unsigned int maxNumIterations;
         bool useParametersOrdering = true;
+        /// use the CUDA linear solvers of Ceres when available (Ceres >= 2.2 built with CUDA), fallback to the CPU otherwise
+        bool useCuda = false;
+        /// use the cost functions with analytic Jacobians instead of the automatic differentiation (pinhole, radial K1 and K3 models)
+        bool useAnalyticJacobians = false;
         bool summary = false;
         bool verbose = true;
     };
@@ -243,5 +249,13 @@ class BundleAdjustmentCeres : public BundleAdjustment
     ceres::ParameterBlockOrdering _linearSolverOrdering;
 };
 
+/**
+ * @brief Move the linear solver of the given Ceres options on the GPU, if the Ceres library supports it.
+ *        Dense solvers require Ceres >= 2.2 built with CUDA, sparse solvers require Ceres >= 2.3 built with cuDSS.
+ *        The options are left unchanged (CPU solver) if no CUDA implementation is available.
+ * @param[in,out] solverOptions The Ceres solver options, with the linear solver type already set
+ */
+void setCudaSolverOptions(ceres::Solver::Options& solverOptions);
+
 }  // namespace sfm
 }  // namespace aliceVision
@@ -0,0 +1,421 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "BundleAdjustmentRotation.hpp"
+
+#include <aliceVision/sfmData/SfMData.hpp>
+#include <aliceVision/camera/cameraCommon.hpp>
+#include <aliceVision/geometry/lie.hpp>
+#include <aliceVision/system/Logger.hpp>
+#include <aliceVision/system/Timer.hpp>
+
+#include <Eigen/SparseCholesky>
+
+#include <limits>
+#include <map>
+#include <vector>
+
+namespace aliceVision {
+namespace sfm {
+
+namespace {
+
+/// reprojection of the bearing vector of an observation of a pose in the image of another pose
+struct Reprojection
+{
+    /// bearing vector of the observation in the source camera
+    Vec3 bearing;
+    /// observation in the target image
+    Vec2 observation;
+    /// intrinsic of the target view
+    const camera::IntrinsicBase* intrinsic;
+    /// the points behind the target camera can not be projected (pinhole camera)
+    bool frontOnly;
+    /// the source is the first pose of the pair
+    bool fromFirst;
+};
+
+/// residuals linking the rotations of two poses
+struct PosePairResiduals
+{
+    std::size_t first;
+    std::size_t second;
+    std::vector<Reprojection> reprojections;
+    /// rotation priors (second_R_first)
+    std::vector<Mat3> priors;
+};
+
+/// cost and normal equations blocks of the residuals of a pair of poses
+struct PosePairEvaluation
+{
+    double cost = 0.0;
+    Mat3 H11 = Mat3::Zero();
+    Mat3 H22 = Mat3::Zero();
+    Mat3 H12 = Mat3::Zero();
+    Vec3 g1 = Vec3::Zero();
+    Vec3 g2 = Vec3::Zero();
+};
+
+/**
+ * @brief Inverse of the left jacobian of SO3: log(exp(w) * exp(phi)) = phi + Jl^-1(phi) * w + O(w^2)
+ */
+Mat3 inverseLeftJacobianSO3(const Vec3& phi)
+{
+    const double theta = phi.norm();
+    const Mat3 phiHat = SO3::skew(phi);
+    const double coefficient = (theta < 1e-4) ? 1.0 / 12.0 : (1.0 / (theta * theta) - (1.0 + std::cos(theta)) / (2.0 * theta * std::sin(theta)));
+    return Mat3::Identity() - 0.5 * phiHat + coefficient * phiHat * phiHat;
+}
+
+/**
+ * @brief Evaluate the residuals of a pair of poses.
+ * @param[in] residuals The residuals of the pair
+ * @param[in] rotations The rotations of all the poses
+ * @param[in] lossThreshold The Huber loss threshold of the reprojection errors
+ * @param[in] withDerivatives Compute the normal equations blocks
+ * @param[out] evaluation The evaluation of the pair
+ */
+void evaluatePosePair(const PosePairResiduals& residuals,
+                      const std::vector<Mat3>& rotations,
+                      double lossThreshold,
+                      bool withDerivatives,
+                      PosePairEvaluation& evaluation)
+{
+    evaluation = PosePairEvaluation();
+
+    const Mat3& R1 = rotations[residuals.first];
+    const Mat3& R2 = rotations[residuals.second];
+    const Mat3 R21 = R2 * R1.transpose();
+    const Mat3 R12 = R21.transpose();
+    const Eigen::Matrix4d identity = Eigen::Matrix4d::Identity();
+
+    double cost = 0.0;
+    for (const Reprojection& reprojection : residuals.reprojections)
+    {
+        const Mat3& targetRsource = reprojection.fromFirst ? R21 : R12;
+        const Vec3 point = targetRsource * reprojection.bearing;
+        if (reprojection.frontOnly && point(2) < std::numeric_limits<double>::epsilon())
+            continue;
+
+        const Vec2 residual = reprojection.intrinsic->project(identity, point.homogeneous(), true) - reprojection.observation;
+
+        // Huber loss, same convention as ceres::HuberLoss
+        const double norm = residual.norm();
+        double weight = 1.0;
+        if (norm > lossThreshold)
+        {
+            cost += 2.0 * lossThreshold * norm - lossThreshold * lossThreshold;
+            weight = lossThreshold / norm;
+        }
+        else
+        {
+            cost += norm * norm;
+        }
+
+        if (!withDerivatives)
+            continue;
+
+        // left perturbations of the rotations: d(point)/d(w_source) = [point]x * target_R_source, d(point)/d(w_target) = -[point]x
+        const Eigen::Matrix<double, 2, 3> Jpoint = reprojection.intrinsic->getDerivativeProjectWrtPoint3(identity, point.homogeneous());
+        const Eigen::Matrix<double, 2, 3> JpointHat = Jpoint * SO3::skew(point);
+        const Eigen::Matrix<double, 2, 3> Jsource = JpointHat * targetRsource;
+        const Eigen::Matrix<double, 2, 3> J1 = reprojection.fromFirst ? Jsource : Eigen::Matrix<double, 2, 3>(-JpointHat);
+        const Eigen::Matrix<double, 2, 3> J2 = reprojection.fromFirst ? Eigen::Matrix<double, 2, 3>(-JpointHat) : Jsource;
+
+        evaluation.H11.noalias() += weight * J1.transpose() * J1;
+        evaluation.H22.noalias() += weight * J2.transpose() * J2;
+        evaluation.H12.noalias() += weight * J1.transpose() * J2;
+        evaluation.g1.noalias() += weight * J1.transpose() * residual;
+        evaluation.g2.noalias() += weight * J2.transpose() * residual;
+    }
+
+    for (const Mat3& prior : residuals.priors)
+    {
+        // same residual as CostRotationPrior
+        const Vec3 residual = SO3::logm(R21 * prior.transpose());
+        cost += residual.squaredNorm();
+
+        if (!withDerivatives)
+            continue;
+
+        // left perturbation of R2, and of R1 (a right perturbation of the error by -prior * w)
+        const Mat3 J2 = inverseLeftJacobianSO3(residual);
+        const Mat3 J1 = -J2.transpose() * prior;
+
+        evaluation.H11.noalias() += J1.transpose() * J1;
+        evaluation.H22.noalias() += J2.transpose() * J2;
+        evaluation.H12.noalias() += J1.transpose() * J2;
+        evaluation.g1.noalias() += J1.transpose() * residual;
+        evaluation.g2.noalias() += J2.transpose() * residual;
+    }
+
+    evaluation.cost = 0.5 * cost;
+}
+
+}  // namespace
+
+bool BundleAdjustmentRotation::adjust(sfmData::SfMData& sfmData, ERefineOptions refineOptions)
+{
+    if (refineOptions != REFINE_ROTATION)
+    {
+        ALICEVISION_LOG_ERROR("Rotation bundle adjustment: only the refinement of the rotations is supported.");
+        return false;
+    }
+
+    system::Timer timer;
+
+    // poses linked by the residuals
+    std::map<IndexT, std::size_t> poseIndexes;
+    std::vector<IndexT> poseIds;
+    for (const auto& posePair : sfmData.getPoses())
+    {
+        if (posePair.second.getState() == EEstimatorParameterState::IGNORED)
+            continue;
+        poseIndexes[posePair.first] = poseIds.size();
+        poseIds.push_back(posePair.first);
+    }
+
+    // residuals grouped by pair of poses
+    std::map<Pair, PosePairResiduals> posePairsResiduals;
+    const auto getPosePairResiduals = [&](const sfmData::View& viewA, const sfmData::View& viewB, bool& swapped) -> PosePairResiduals* {
+        const auto itA = poseIndexes.find(viewA.getPoseId());
+        const auto itB = poseIndexes.find(viewB.getPoseId());
+        if (itA == poseIndexes.end() || itB == poseIndexes.end() || itA->second == itB->second)
+            return nullptr;
+
+        swapped = itA->second > itB->second;
+        const Pair pair = swapped ? Pair(itB->second, itA->second) : Pair(itA->second, itB->second);
+        PosePairResiduals& residuals = posePairsResiduals[pair];
+        residuals.first = pair.first;
+        residuals.second = pair.second;
+        return &residuals;
+    };
+
+    // the intrinsics are fixed: the bearing vectors are computed once
+    for (const sfmData::Constraint2D& constraint : sfmData.getConstraints2D())
+    {
+        const sfmData::View& viewFirst = sfmData.getView(constraint.ViewFirst);
+        const sfmData::View& viewSecond = sfmData.getView(constraint.ViewSecond);
+        if (viewFirst.isPartOfRig() || viewSecond.isPartOfRig())
+        {
+            ALICEVISION_LOG_ERROR("Rotation bundle adjustment: the views of a rig are not supported.");
+            return false;
+        }
+
+        bool swapped = false;
+        PosePairResiduals* residuals = getPosePairResiduals(viewFirst, viewSecond, swapped);
+        if (residuals == nullptr)
+            continue;
+
+        const camera::IntrinsicBase* intrinsicFirst = sfmData.getIntrinsicPtr(viewFirst.getIntrinsicId());
+        const camera::IntrinsicBase* intrinsicSecond = sfmData.getIntrinsicPtr(viewSecond.getIntrinsicId());
+        const Vec2& observationFirst = constraint.ObservationFirst.getCoordinates();
+        const Vec2& observationSecond = constraint.ObservationSecond.getCoordinates();
+
+        Reprojection reprojection;
+        reprojection.bearing = intrinsicFirst->toUnitSphere(intrinsicFirst->removeDistortion(intrinsicFirst->ima2cam(observationFirst)));
+        reprojection.observation = observationSecond;
+        reprojection.intrinsic = intrinsicSecond;
+        reprojection.frontOnly = !camera::isEquidistant(intrinsicSecond->getType());
+        reprojection.fromFirst = !swapped;
+        residuals->reprojections.push_back(reprojection);
+
+        // symmetry
+        reprojection.bearing = intrinsicSecond->toUnitSphere(intrinsicSecond->removeDistortion(intrinsicSecond->ima2cam(observationSecond)));
+        reprojection.observation = observationFirst;
+        reprojection.intrinsic = intrinsicFirst;
+        reprojection.frontOnly = !camera::isEquidistant(intrinsicFirst->getType());
+        reprojection.fromFirst = swapped;
+        residuals->reprojections.push_back(reprojection);
+    }
+
+    for (const sfmData::RotationPrior& prior : sfmData.getRotationPriors())
+    {
+        bool swapped = false;
+        PosePairResiduals* residuals = getPosePairResiduals(sfmData.getView(prior.ViewFirst), sfmData.getView(prior.ViewSecond), swapped);
+        if (residuals == nullptr)
+            continue;
+        residuals->priors.push_back(swapped ? Mat3(prior._second_R_first.transpose()) : prior._second_R_first);
+    }
+
+    if (posePairsResiduals.empty())
+    {
+        ALICEVISION_LOG_WARNING("Rotation bundle adjustment: no residual.");
+        return false;
+    }
+
+    std::vector<PosePairResiduals> residualsList;
+    residualsList.reserve(posePairsResiduals.size());
+    for (auto& residualsPair : posePairsResiduals)
+        residualsList.push_back(std::move(residualsPair.second));
+    posePairsResiduals.clear();
+
+    // parameters: the rotations of the refined poses linked by a residual
+    std::vector<Mat3> rotations(poseIds.size());
+    std::vector<int> parameterIndexes(poseIds.size(), -1);
+    int nbParameters = 0;
+    for (std::size_t i = 0; i < poseIds.size(); ++i)
+        rotations[i] = sfmData.getPoses().at(poseIds[i]).getTransform().rotation();
+    for (const PosePairResiduals& residuals : residualsList)
+    {
+        for (const std::size_t poseIndex : {residuals.first, residuals.second})
+        {
+            if (parameterIndexes[poseIndex] < 0 && sfmData.getPoses().at(poseIds[poseIndex]).getState() == EEstimatorParameterState::REFINED)
+                parameterIndexes[poseIndex] = 3 * nbParameters++;
+        }
+    }
+    if (nbParameters == 0)
+    {
+        ALICEVISION_LOG_WARNING("Rotation bundle adjustment: no rotation to refine.");
+        return false;
+    }
+
+    std::vector<PosePairEvaluation> evaluations(residualsList.size());
+    const auto evaluate = [&](const std::vector<Mat3>& currentRotations, bool withDerivatives) -> double {
+#pragma omp parallel for schedule(dynamic)
+        for (int i = 0; i < residualsList.size(); ++i)
+            evaluatePosePair(residualsList[i], currentRotations, _options.lossThreshold, withDerivatives, evaluations[i]);
+
+        // fixed accumulation order
+        double cost = 0.0;
+        for (const PosePairEvaluation& evaluation : evaluations)
+            cost += evaluation.cost;
+        return cost;
+    };
+
+    const int size = 3 * nbParameters;
+    Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>, Eigen::Upper> solver;
+    bool patternAnalyzed = false;
+
+    Eigen::SparseMatrix<double> H(size, size);
+    Eigen::VectorXd g(size);
+    Eigen::VectorXd diagonal(size);
+    std::vector<Eigen::Triplet<double>> triplets;
+
+    const double initialCost = evaluate(rotations, true);
+    double cost = initialCost;
+    double lambda = 1e-4;
+    bool updateNormalEquations = true;
+    std::size_t nbSuccessfulIterations = 0;
+    std::size_t nbUnsuccessfulIterations = 0;
+
+    for (std::size_t iteration = 0; iteration < _options.maxNumIterations; ++iteration)
+    {
+        if (updateNormalEquations)
+        {
+            // upper triangular part of the normal equations
+            triplets.clear();
+            g.setZero();
+            for (std::size_t i = 0; i < residualsList.size(); ++i)
+            {
+                const PosePairEvaluation& evaluation = evaluations[i];
+                const int index1 = parameterIndexes[residualsList[i].first];
+                const int index2 = parameterIndexes[residualsList[i].second];
+                if (index1 >= 0)
+                    g.segment<3>(index1) += evaluation.g1;
+                if (index2 >= 0)
+                    g.segment<3>(index2) += evaluation.g2;
+
+                for (int r = 0; r < 3; ++r)
+                {
+                    for (int c = 0; c < 3; ++c)
+                    {
+                        if (index1 >= 0 && r <= c)
+                            triplets.emplace_back(index1 + r, index1 + c, evaluation.H11(r, c));
+                        if (index2 >= 0 && r <= c)
+                            triplets.emplace_back(index2 + r, index2 + c, evaluation.H22(r, c));
+                        if (index1 >= 0 && index2 >= 0)
+                        {
+                            // index1 < index2 is not guaranteed (constant poses are not parameters)
+                            if (index1 < index2)
+                                triplets.emplace_back(index1 + r, index2 + c, evaluation.H12(r, c));
+                            else
+                                triplets.emplace_back(index2 + c, index1 + r, evaluation.H12(r, c));
+                        }
+                    }
+                }
+            }
+            H.setFromTriplets(triplets.begin(), triplets.end());
+            diagonal = H.diagonal().cwiseMax(1e-12);
+
+            if (g.lpNorm<Eigen::Infinity>() < 1e-10)
+                break;
+        }
+
+        // Levenberg-Marquardt damping
+        Eigen::SparseMatrix<double> damped = H;
+        for (int i = 0; i < size; ++i)
+            damped.coeffRef(i, i) += lambda * diagonal(i);
+
+        if (!patternAnalyzed)
+        {
+            solver.analyzePattern(damped);
+            patternAnalyzed = true;
+        }
+        solver.factorize(damped);
+        if (solver.info() != Eigen::Success)
+        {
+            ALICEVISION_LOG_WARNING("Rotation bundle adjustment: the normal equations can not be factorized.");
+            return false;
+        }
+        const Eigen::VectorXd delta = -solver.solve(g);
+
+        std::vector<Mat3> candidateRotations = rotations;
+        for (std::size_t i = 0; i < rotations.size(); ++i)
+        {
+            if (parameterIndexes[i] >= 0)
+                candidateRotations[i] = SO3::expm(delta.segment<3>(parameterIndexes[i])) * rotations[i];
+        }
+
+        const double candidateCost = evaluate(candidateRotations, false);
+        if (candidateCost < cost)
+        {
+            ++nbSuccessfulIterations;
+            const double decrease = (cost - candidateCost) / cost;
+            rotations.swap(candidateRotations);
+            cost = evaluate(rotations, true);
+            lambda = std::max(lambda / 3.0, 1e-12);
+            updateNormalEquations = true;
+
+            if (decrease < _options.functionTolerance || delta.lpNorm<Eigen::Infinity>() < _options.parameterTolerance)
+                break;
+        }
+        else
+        {
+            ++nbUnsuccessfulIterations;
+            lambda *= 4.0;
+            updateNormalEquations = false;
+            if (lambda > 1e16)
+                break;
+        }
+    }
+
+    // update the refined rotations, the centers are kept
+    for (std::size_t i = 0; i < poseIds.size(); ++i)
+    {
+        if (parameterIndexes[i] < 0)
+            continue;
+        sfmData::CameraPose& pose = sfmData.getPoses().at(poseIds[i]);
+        pose.setTransform(geometry::Pose3(rotations[i], pose.getTransform().center()));
+    }
+
+    if (_options.summary)
+    {
+        ALICEVISION_LOG_INFO("Rotation bundle adjustment:\n"
+                             << "\t- adjustment duration: " << timer.elapsed() << " s\n"
+                             << "\t- # refined rotations: " << nbParameters << "\n"
+                             << "\t- # pairs of poses: " << residualsList.size() << "\n"
+                             << "\t- # successful iterations: " << nbSuccessfulIterations << "\n"
+                             << "\t- # unsuccessful iterations: " << nbUnsuccessfulIterations << "\n"
+                             << "\t- initial cost: " << initialCost << "\n"
+                             << "\t- final cost: " << cost);
+    }
+
+    return true;
+}
+
+}  // namespace sfm
+}  // namespace aliceVision
@@ -0,0 +1,68 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/sfm/bundle/BundleAdjustment.hpp>
+
+#include <cstddef>
+
+namespace aliceVision {
+
+namespace sfmData {
+class SfMData;
+}  // namespace sfmData
+
+namespace sfm {
+
+/**
+ * @brief Rotation-only bundle adjustment of a nodal (panorama) scene.
+ *
+ * Only the rotations of the poses are refined (3 parameters per pose), the intrinsics are fixed.
+ * The residuals are the same as the ones of BundleAdjustmentSymbolicCeres for the 2D constraints
+ * (reprojection of the observation of a view in the other view, in both directions, with a Huber loss)
+ * and for the rotation priors. The jacobians are analytic and the problem is solved with Levenberg-Marquardt
+ * iterations on the sparse normal equations of the rotations:
+ * - the residuals are evaluated pair of poses by pair of poses in parallel and accumulated in a fixed order (deterministic),
+ * - the sparsity pattern of the normal equations (the pose graph) is analyzed once, only the numerical factorization is repeated.
+ */
+class BundleAdjustmentRotation : public BundleAdjustment
+{
+  public:
+    struct Options
+    {
+        /// maximum number of Levenberg-Marquardt iterations
+        std::size_t maxNumIterations = 300;
+        /// reprojection error (in pixels) above which the 2D constraints are down weighted (Huber loss)
+        double lossThreshold = 64.0;
+        /// stop when the relative decrease of the cost is below this tolerance
+        double functionTolerance = 1e-6;
+        /// stop when the largest rotation update (in radians) is below this tolerance
+        double parameterTolerance = 1e-10;
+        /// log a summary of the adjustment
+        bool summary = false;
+    };
+
+    explicit BundleAdjustmentRotation(const Options& options)
+      : _options(options)
+    {}
+
+    /**
+     * @brief Refine the rotations of the poses from the 2D constraints and the rotation priors of the scene.
+     *        The constant poses are kept, the ignored poses and their constraints are not used.
+     * @note The views must not be part of a rig.
+     * @param[in,out] sfmData The scene
+     * @param[in] refineOptions Only REFINE_ROTATION is supported
+     * @return false if the options are not supported or if the normal equations can not be factorized
+     */
+    bool adjust(sfmData::SfMData& sfmData, ERefineOptions refineOptions = REFINE_ROTATION) override;
+
+  private:
+    Options _options;
+};
+
+}  // namespace sfm
+}  // namespace aliceVision
@@ -6,6 +6,7 @@
 // You can obtain one at https://mozilla.org/MPL/2.0/.
 
 #include <aliceVision/sfm/bundle/BundleAdjustmentSymbolicCeres.hpp>
+#include <aliceVision/sfm/bundle/BundleAdjustmentCeres.hpp>
 
 #include <aliceVision/alicevision_omp.hpp>
 
@@ -250,6 +251,11 @@ void BundleAdjustmentSymbolicCeres::setSolverOptions(ceres::Solver::Options& sol
     solverOptions.num_linear_solver_threads = _ceresOptions.nbThreads;
 #endif
 
+    if (_ceresOptions.useCuda)
+    {
+        setCudaSolverOptions(solverOptions);
+    }
+
     if (_ceresOptions.useParametersOrdering)
     {
         // copy ParameterBlockOrdering
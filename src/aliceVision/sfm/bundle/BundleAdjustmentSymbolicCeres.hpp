@@ -59,6 +59,8 @@ class BundleAdjustmentSymbolicCeres : public BundleAdjustment, ceres::Evaluation
         unsigned int nbThreads;
         unsigned int maxNumIterations;
         bool useParametersOrdering = true;
+        /// use the CUDA linear solvers of Ceres when available (Ceres >= 2.2 built with CUDA), fallback to the CPU otherwise
+        bool useCuda = false;
         bool summary = false;
         bool verbose = true;
         bool useFocalPrior = true;
@@ -0,0 +1,165 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/sfm/bundle/costfunctions/projectionPinholeRadial.hpp>
+#include <aliceVision/sfm/ResidualErrorFunctor.hpp>
+#include <aliceVision/system/Logger.hpp>
+
+#include <ceres/ceres.h>
+
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#define BOOST_TEST_MODULE costFunctionPinholeRadial
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/tools/floating_point_comparison.hpp>
+
+using namespace aliceVision;
+using namespace aliceVision::sfm;
+
+namespace {
+
+const int width = 4000;
+const int height = 3000;
+
+struct TestParameters
+{
+    std::vector<double> intrinsics;
+    double pose[6] = {0.1, -0.4, 0.25, 0.2, -0.1, 1.5};
+    double point[3] = {0.5, -0.3, 5.0};
+};
+
+TestParameters getTestParameters(int nbRadialParams)
+{
+    TestParameters p;
+    p.intrinsics = {3100.0, 3080.0, 12.0, -7.0};
+    const double disto[3] = {-0.12, 0.05, -0.01};
+    for (int i = 0; i < nbRadialParams; ++i)
+        p.intrinsics.push_back(disto[i]);
+    return p;
+}
+
+/**
+ * @brief Evaluate the residuals and Jacobians of both cost functions and check that they are equal.
+ */
+void checkCostFunctions(const ceres::CostFunction& analytic, const ceres::CostFunction& autodiff, TestParameters& p)
+{
+    const int nbIntrinsics = p.intrinsics.size();
+    double* parameters[3] = {p.intrinsics.data(), p.pose, p.point};
+
+    double residualsAnalytic[2];
+    double residualsAutodiff[2];
+    std::vector<double> jacobianIntrinsicsAnalytic(2 * nbIntrinsics), jacobianIntrinsicsAutodiff(2 * nbIntrinsics);
+    double jacobianPoseAnalytic[12], jacobianPoseAutodiff[12];
+    double jacobianPointAnalytic[6], jacobianPointAutodiff[6];
+    double* jacobiansAnalytic[3] = {jacobianIntrinsicsAnalytic.data(), jacobianPoseAnalytic, jacobianPointAnalytic};
+    double* jacobiansAutodiff[3] = {jacobianIntrinsicsAutodiff.data(), jacobianPoseAutodiff, jacobianPointAutodiff};
+
+    BOOST_CHECK(analytic.Evaluate(parameters, residualsAnalytic, jacobiansAnalytic));
+    BOOST_CHECK(autodiff.Evaluate(parameters, residualsAutodiff, jacobiansAutodiff));
+
+    for (int i = 0; i < 2; ++i)
+        BOOST_CHECK_SMALL(residualsAnalytic[i] - residualsAutodiff[i], 1e-9);
+    for (int i = 0; i < 2 * nbIntrinsics; ++i)
+        BOOST_CHECK_SMALL(jacobianIntrinsicsAnalytic[i] - jacobianIntrinsicsAutodiff[i], 1e-6);
+    for (int i = 0; i < 12; ++i)
+        BOOST_CHECK_SMALL(jacobianPoseAnalytic[i] - jacobianPoseAutodiff[i], 1e-6);
+    for (int i = 0; i < 6; ++i)
+        BOOST_CHECK_SMALL(jacobianPointAnalytic[i] - jacobianPointAutodiff[i], 1e-6);
+}
+
+/**
+ * @brief Return the number of evaluations (residuals and Jacobians) per second of the given cost function.
+ */
+double evaluationThroughput(const ceres::CostFunction& costFunction, TestParameters& p)
+{
+    const int nbEvaluations = 200000;
+    double* parameters[3] = {p.intrinsics.data(), p.pose, p.point};
+    double residuals[2];
+    std::vector<double> jacobianIntrinsics(2 * p.intrinsics.size());
+    double jacobianPose[12];
+    double jacobianPoint[6];
+    double* jacobians[3] = {jacobianIntrinsics.data(), jacobianPose, jacobianPoint};
+
+    double sum = 0.0;
+    const auto chronoStart = std::chrono::steady_clock::now();
+    for (int i = 0; i < nbEvaluations; ++i)
+    {
+        // move the point to avoid evaluating the same values
+        p.point[0] += 1e-9;
+        costFunction.Evaluate(parameters, residuals, jacobians);
+        sum += residuals[0];
+    }
+    const double duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - chronoStart).count();
+    BOOST_CHECK(std::isfinite(sum));
+
+    return nbEvaluations / duration;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(costFunctionPinholeRadial_Pinhole)
+{
+    const sfmData::Observation obs(Vec2(2150.0, 1320.0), 0, 2.0);
+    TestParameters p = getTestParameters(0);
+
+    const CostProjectionPinholeRadial<0> analytic(width, height, obs);
+    const ceres::AutoDiffCostFunction<ResidualErrorFunctor_Pinhole, 2, 4, 6, 3> autodiff(new ResidualErrorFunctor_Pinhole(width, height, obs));
+
+    checkCostFunctions(analytic, autodiff, p);
+}
+
+BOOST_AUTO_TEST_CASE(costFunctionPinholeRadial_RadialK1)
+{
+    const sfmData::Observation obs(Vec2(2150.0, 1320.0), 0, 0.0);
+    TestParameters p = getTestParameters(1);
+
+    const CostProjectionPinholeRadial<1> analytic(width, height, obs);
+    const ceres::AutoDiffCostFunction<ResidualErrorFunctor_PinholeRadialK1, 2, 5, 6, 3> autodiff(
+      new ResidualErrorFunctor_PinholeRadialK1(width, height, obs));
+
+    checkCostFunctions(analytic, autodiff, p);
+}
+
+BOOST_AUTO_TEST_CASE(costFunctionPinholeRadial_RadialK3)
+{
+    const sfmData::Observation obs(Vec2(2150.0, 1320.0), 0, 1.5);
+    TestParameters p = getTestParameters(3);
+
+    const CostProjectionPinholeRadial<3> analytic(width, height, obs);
+    const ceres::AutoDiffCostFunction<ResidualErrorFunctor_PinholeRadialK3, 2, 7, 6, 3> autodiff(
+      new ResidualErrorFunctor_PinholeRadialK3(width, height, obs));
+
+    checkCostFunctions(analytic, autodiff, p);
+
+    // small rotation, where the angle-axis is close to the singularity
+    p.pose[0] = 1e-12;
+    p.pose[1] = 0.0;
+    p.pose[2] = 0.0;
+    checkCostFunctions(analytic, autodiff, p);
+}
+
+BOOST_AUTO_TEST_CASE(costFunctionPinholeRadial_throughput)
+{
+    // micro-benchmark: the timings are only reported, they are not checked
+    const sfmData::Observation obs(Vec2(2150.0, 1320.0), 0, 1.0);
+    TestParameters p = getTestParameters(3);
+
+    const CostProjectionPinholeRadial<3> analytic(width, height, obs);
+    const ceres::AutoDiffCostFunction<ResidualErrorFunctor_PinholeRadialK3, 2, 7, 6, 3> autodiff(
+      new ResidualErrorFunctor_PinholeRadialK3(width, height, obs));
+
+    const double analyticThroughput = evaluationThroughput(analytic, p);
+    const double autodiffThroughput = evaluationThroughput(autodiff, p);
+
+    ALICEVISION_LOG_INFO("Residual and Jacobians evaluations per second (PinholeRadialK3):\n"
+                         << "\t- analytic: " << analyticThroughput << "\n"
+                         << "\t- autodiff: " << autodiffThroughput << "\n"
+                         << "\t- speedup: " << analyticThroughput / autodiffThroughput);
+}
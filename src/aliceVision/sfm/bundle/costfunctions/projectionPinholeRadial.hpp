@@ -0,0 +1,182 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/numeric/numeric.hpp>
+#include <aliceVision/sfmData/Observation.hpp>
+#include <Eigen/Core>
+#include <ceres/ceres.h>
+
+#include <cmath>
+#include <limits>
+
+namespace aliceVision {
+namespace sfm {
+
+/**
+ * @brief Cost function with analytic Jacobians for a pinhole camera with a polynomial radial distortion.
+ *
+ * Same residual and parameter blocks as ResidualErrorFunctor_Pinhole (NbRadialParams = 0),
+ * ResidualErrorFunctor_PinholeRadialK1 (NbRadialParams = 1) and ResidualErrorFunctor_PinholeRadialK3 (NbRadialParams = 3),
+ * without the cost of the automatic differentiation.
+ *
+ * Data parameter blocks are the following <2, 4 + NbRadialParams, 6, 3>
+ * - 2 => dimension of the residuals,
+ * - 4 + NbRadialParams => the intrinsic data block [focalX, focalY, principal point offset x, y, k1, ...],
+ * - 6 => the camera extrinsic data block [R;t], rotation(angle axis) and translation,
+ * - 3 => a 3D point data block.
+ */
+template<int NbRadialParams>
+class CostProjectionPinholeRadial : public ceres::SizedCostFunction<2, 4 + NbRadialParams, 6, 3>
+{
+  public:
+    CostProjectionPinholeRadial(int w, int h, const sfmData::Observation& obs)
+      : _center(double(w) * 0.5, double(h) * 0.5),
+        _measured(obs.getCoordinates()),
+        _invScale(obs.getScale() > 0.0 ? 1.0 / obs.getScale() : 1.0)
+    {}
+
+    bool Evaluate(double const* const* parameters, double* residuals, double** jacobians) const override
+    {
+        const double* cam_K = parameters[0];
+        const Eigen::Map<const Vec3> angleAxis(parameters[1]);
+        const Eigen::Map<const Vec3> translation(parameters[1] + 3);
+        const Eigen::Map<const Vec3> pos_3dpoint(parameters[2]);
+
+        // rotation matrix (Rodrigues) and left Jacobian of SO(3)
+        const Mat3 W = CrossProductMatrix(angleAxis);
+        const Mat3 W2 = W * W;
+        const double theta2 = angleAxis.squaredNorm();
+        Mat3 R;
+        Mat3 leftJacobian;
+        if (theta2 > std::numeric_limits<double>::epsilon())
+        {
+            const double theta = std::sqrt(theta2);
+            const double sinTheta = std::sin(theta);
+            const double oneMinusCosTheta = 1.0 - std::cos(theta);
+            R = Mat3::Identity() + (sinTheta / theta) * W + (oneMinusCosTheta / theta2) * W2;
+            leftJacobian = Mat3::Identity() + (oneMinusCosTheta / theta2) * W + ((theta - sinTheta) / (theta2 * theta)) * W2;
+        }
+        else
+        {
+            // first order approximation, as in ceres::AngleAxisRotatePoint
+            R = Mat3::Identity() + W;
+            leftJacobian = Mat3::Identity() + 0.5 * W;
+        }
+
+        const Vec3 rotatedPoint = R * pos_3dpoint;
+        const Vec3 pos_proj = rotatedPoint + translation;
+
+        // transform the point from homogeneous to euclidean (undistorted point)
+        const double invZ = 1.0 / pos_proj(2);
+        const double x_u = pos_proj(0) * invZ;
+        const double y_u = pos_proj(1) * invZ;
+
+        // apply distortion (xd,yd) = disto(x_u,y_u), with the derivative of the radial coefficient wrt r2
+        const double r2 = x_u * x_u + y_u * y_u;
+        double radialCoeff = 1.0;
+        double radialCoeffDerivative = 0.0;
+        double r2Pow = 1.0;
+        for (int i = 0; i < NbRadialParams; ++i)
+        {
+            radialCoeffDerivative += (i + 1) * cam_K[OFFSET_DISTO + i] * r2Pow;
+            r2Pow *= r2;
+            radialCoeff += cam_K[OFFSET_DISTO + i] * r2Pow;
+        }
+        const double x_d = x_u * radialCoeff;
+        const double y_d = y_u * radialCoeff;
+
+        // apply focal length and principal point to get the final image coordinates
+        const double focalX = cam_K[OFFSET_FOCAL_LENGTH_X];
+        const double focalY = cam_K[OFFSET_FOCAL_LENGTH_Y];
+        const double projected_x = cam_K[OFFSET_PRINCIPAL_POINT_X] + _center(0) + focalX * x_d;
+        const double projected_y = cam_K[OFFSET_PRINCIPAL_POINT_Y] + _center(1) + focalY * y_d;
+
+        residuals[0] = (projected_x - _measured(0)) * _invScale;
+        residuals[1] = (projected_y - _measured(1)) * _invScale;
+
+        if (jacobians == nullptr)
+        {
+            return true;
+        }
+
+        const double scaledFocalX = focalX * _invScale;
+        const double scaledFocalY = focalY * _invScale;
+
+        if (jacobians[0] != nullptr)
+        {
+            Eigen::Map<Eigen::Matrix<double, 2, 4 + NbRadialParams, Eigen::RowMajor>> J(jacobians[0]);
+
+            J.setZero();
+            J(0, OFFSET_FOCAL_LENGTH_X) = x_d * _invScale;
+            J(1, OFFSET_FOCAL_LENGTH_Y) = y_d * _invScale;
+            J(0, OFFSET_PRINCIPAL_POINT_X) = _invScale;
+            J(1, OFFSET_PRINCIPAL_POINT_Y) = _invScale;
+
+            r2Pow = 1.0;
+            for (int i = 0; i < NbRadialParams; ++i)
+            {
+                r2Pow *= r2;
+                J(0, OFFSET_DISTO + i) = scaledFocalX * x_u * r2Pow;
+                J(1, OFFSET_DISTO + i) = scaledFocalY * y_u * r2Pow;
+            }
+        }
+
+        if (jacobians[1] == nullptr && jacobians[2] == nullptr)
+        {
+            return true;
+        }
+
+        // derivative of the residual wrt the point in the camera frame
+        const double dr = 2.0 * radialCoeffDerivative;
+        Eigen::Matrix2d d_res_d_undisto;
+        d_res_d_undisto << scaledFocalX * (radialCoeff + dr * x_u * x_u), scaledFocalX * dr * x_u * y_u,
+                           scaledFocalY * dr * x_u * y_u, scaledFocalY * (radialCoeff + dr * y_u * y_u);
+
+        Eigen::Matrix<double, 2, 3> d_undisto_d_proj;
+        d_undisto_d_proj << invZ, 0.0, -x_u * invZ,
+                            0.0, invZ, -y_u * invZ;
+
+        const Eigen::Matrix<double, 2, 3> d_res_d_proj = d_res_d_undisto * d_undisto_d_proj;
+
+        if (jacobians[1] != nullptr)
+        {
+            Eigen::Map<Eigen::Matrix<double, 2, 6, Eigen::RowMajor>> J(jacobians[1]);
+
+            // exp(r + dr) X ~ (I + [leftJacobian dr]x) R X
+            J.template leftCols<3>() = -d_res_d_proj * CrossProductMatrix(rotatedPoint) * leftJacobian;
+            J.template rightCols<3>() = d_res_d_proj;
+        }
+
+        if (jacobians[2] != nullptr)
+        {
+            Eigen::Map<Eigen::Matrix<double, 2, 3, Eigen::RowMajor>> J(jacobians[2]);
+
+            J = d_res_d_proj * R;
+        }
+
+        return true;
+    }
+
+  private:
+    // Enum to map intrinsics parameters between aliceVision & ceres camera data parameter block.
+    enum
+    {
+        OFFSET_FOCAL_LENGTH_X = 0,
+        OFFSET_FOCAL_LENGTH_Y = 1,
+        OFFSET_PRINCIPAL_POINT_X = 2,
+        OFFSET_PRINCIPAL_POINT_Y = 3,
+        OFFSET_DISTO = 4
+    };
+
+    const Vec2 _center;
+    const Vec2 _measured;
+    const double _invScale;
+};
+
+}  // namespace sfm
+}  // namespace aliceVision
@@ -0,0 +1,66 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "RegionsCache.hpp"
+
+#include <aliceVision/sfmData/SfMData.hpp>
+#include <aliceVision/sfm/pipeline/regionsIO.hpp>
+
+#include <algorithm>
+
+namespace aliceVision {
+namespace sfm {
+
+RegionsCache::RegionsCache(const sfmData::SfMData& sfmData,
+                           const std::vector<std::string>& folders,
+                           const std::vector<feature::EImageDescriberType>& imageDescriberTypes,
+                           const std::map<IndexT, std::size_t>& nbUsesPerView)
+  : _imageDescriberTypes(imageDescriberTypes)
+{
+    _folders = sfmData.getFeaturesFolders();                         // add sfm features folders
+    _folders.insert(_folders.end(), folders.begin(), folders.end());  // add user features folders
+    _folders.erase(std::unique(_folders.begin(), _folders.end()), _folders.end());
+
+    for (const feature::EImageDescriberType imageDescriberType : _imageDescriberTypes)
+        _imageDescribers.push_back(feature::createImageDescriber(imageDescriberType));
+
+    for (const auto& nbUsesIt : nbUsesPerView)
+    {
+        _entries[nbUsesIt.first].nbUses = nbUsesIt.second;
+        _regionsPerView.getData()[nbUsesIt.first];
+    }
+}
+
+const feature::MapRegionsPerDesc& RegionsCache::acquire(IndexT viewId)
+{
+    ViewEntry& entry = _entries.at(viewId);
+    feature::MapRegionsPerDesc& regionsPerDesc = _regionsPerView.getData().at(viewId);
+
+    std::lock_guard<std::mutex> lock(entry.mutex);
+    if (!entry.loaded)
+    {
+        for (std::size_t i = 0; i < _imageDescriberTypes.size(); ++i)
+            regionsPerDesc[_imageDescriberTypes.at(i)] = loadRegions(_folders, viewId, *_imageDescribers.at(i));
+        entry.loaded = true;
+    }
+    return regionsPerDesc;
+}
+
+void RegionsCache::release(IndexT viewId)
+{
+    ViewEntry& entry = _entries.at(viewId);
+
+    std::lock_guard<std::mutex> lock(entry.mutex);
+    if (entry.nbUses == 0 || --entry.nbUses > 0 || !entry.loaded)
+        return;
+
+    // last pending use: only keep the features
+    for (auto& regionsIt : _regionsPerView.getData().at(viewId))
+        regionsIt.second->clearDescriptors();
+}
+
+}  // namespace sfm
+}  // namespace aliceVision
@@ -0,0 +1,95 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/types.hpp>
+#include <aliceVision/feature/ImageDescriber.hpp>
+#include <aliceVision/feature/imageDescriberCommon.hpp>
+#include <aliceVision/feature/RegionsPerView.hpp>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace aliceVision {
+
+namespace sfmData {
+class SfMData;
+}
+
+namespace sfm {
+
+/**
+ * @brief Thread-safe cache of the regions of the views, loaded on demand from the features folders.
+ *
+ * Each view has a number of pending uses (e.g. its number of image pairs).
+ * The regions of a view are loaded on the first acquire() and its descriptors are released
+ * when the last pending use is released, the features are kept (for the triangulation).
+ * The views have to be registered in the constructor: the regions of the other views are never loaded.
+ */
+class RegionsCache
+{
+  public:
+    /**
+     * @brief RegionsCache constructor
+     * @param[in] sfmData The SfMData (features folders)
+     * @param[in] folders The additional features folders
+     * @param[in] imageDescriberTypes The imageDescriber types
+     * @param[in] nbUsesPerView The number of pending uses of each view that can be loaded
+     */
+    RegionsCache(const sfmData::SfMData& sfmData,
+                 const std::vector<std::string>& folders,
+                 const std::vector<feature::EImageDescriberType>& imageDescriberTypes,
+                 const std::map<IndexT, std::size_t>& nbUsesPerView);
+
+    // no copy
+    RegionsCache(const RegionsCache&) = delete;
+    RegionsCache& operator=(const RegionsCache&) = delete;
+
+    /**
+     * @brief Get the regions of a view, loaded on the first call.
+     * @param[in] viewId The view id (registered in the constructor)
+     * @return the regions of the view per describer type
+     * @throw std::runtime_error if the regions files can not be loaded
+     */
+    const feature::MapRegionsPerDesc& acquire(IndexT viewId);
+
+    /**
+     * @brief Release one pending use of a view.
+     *        The descriptors of the view are released with its last pending use.
+     * @param[in] viewId The view id (registered in the constructor)
+     */
+    void release(IndexT viewId);
+
+    /**
+     * @brief Get the loaded regions.
+     * @note The views that are not loaded yet have no regions.
+     * @return the regions per view
+     */
+    inline const feature::RegionsPerView& getRegionsPerView() const { return _regionsPerView; }
+
+  private:
+    struct ViewEntry
+    {
+        std::mutex mutex;
+        bool loaded = false;
+        std::size_t nbUses = 0;
+    };
+
+    std::vector<std::string> _folders;
+    std::vector<feature::EImageDescriberType> _imageDescriberTypes;
+    std::vector<std::unique_ptr<feature::ImageDescriber>> _imageDescribers;
+    /// one entry per registered view, the map is never modified after the constructor
+    std::map<IndexT, ViewEntry> _entries;
+    /// the outer map is filled in the constructor, only the regions of a view are modified (under the view mutex)
+    feature::RegionsPerView _regionsPerView;
+};
+
+}  // namespace sfm
+}  // namespace aliceVision
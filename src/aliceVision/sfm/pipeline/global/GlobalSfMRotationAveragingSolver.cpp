@@ -164,16 +164,14 @@ void GlobalSfMRotationAveragingSolver::tripletRotationRejection(const double max
     std::vector<graph::Triplet> vecTripletsValidated;
     vecTripletsValidated.reserve(vecTriplets.size());
 
-    std::vector<float> vecErrToIdentityPerTriplet;
-    vecErrToIdentityPerTriplet.reserve(vecTriplets.size());
-    // Compute the composition error for each length 3 cycles
-    for (size_t i = 0; i < vecTriplets.size(); ++i)
+    // Compute the composition error for each length 3 cycles (independent per triplet)
+    std::vector<float> vecErrToIdentityPerTriplet(vecTriplets.size());
+#pragma omp parallel for schedule(dynamic, 256)
+    for (int i = 0; i < static_cast<int>(vecTriplets.size()); ++i)
     {
         const graph::Triplet& triplet = vecTriplets[i];
         const IndexT I = triplet.i, J = triplet.j, K = triplet.k;
 
-        ALICEVISION_LOG_DEBUG("GlobalSfMRotationAveragingSolver::tripletRotationRejection: i: " << i << ", (" << I << ", " << J << ", " << K << ").");
-
         //-- Find the three relative rotations
         const Pair ij(I, J), ji(J, I);
         const Mat3 RIJ = (mapRelatives.count(ij)) ? mapRelatives.at(ij).Rij : Mat3(mapRelatives.at(ji).Rij.transpose());
@@ -185,27 +183,28 @@ void GlobalSfMRotationAveragingSolver::tripletRotationRejection(const double max
         const Mat3 RKI = (mapRelatives.count(ki)) ? mapRelatives.at(ki).Rij : Mat3(mapRelatives.at(ik).Rij.transpose());
 
         const Mat3 RotToIdentity = RIJ * RJK * RKI;  // motion composition
-        const float angularErrorDegree = static_cast<float>(radianToDegree(getRotationMagnitude(RotToIdentity)));
-        vecErrToIdentityPerTriplet.push_back(angularErrorDegree);
+        vecErrToIdentityPerTriplet[i] = static_cast<float>(radianToDegree(getRotationMagnitude(RotToIdentity)));
+    }
+
+    // Keep the relative rotations of the valid triplets
+    for (size_t i = 0; i < vecTriplets.size(); ++i)
+    {
+        const graph::Triplet& triplet = vecTriplets[i];
+        const IndexT I = triplet.i, J = triplet.j, K = triplet.k;
+        const float angularErrorDegree = vecErrToIdentityPerTriplet[i];
 
         if (angularErrorDegree < maxAngularError)
         {
             vecTripletsValidated.push_back(triplet);
 
-            if (mapRelatives.count(ij))
-                mapRelativesValidated[ij] = mapRelatives.at(ij);
-            else
-                mapRelativesValidated[ji] = mapRelatives.at(ji);
-
-            if (mapRelatives.count(jk))
-                mapRelativesValidated[jk] = mapRelatives.at(jk);
-            else
-                mapRelativesValidated[kj] = mapRelatives.at(kj);
-
-            if (mapRelatives.count(ki))
-                mapRelativesValidated[ki] = mapRelatives.at(ki);
-            else
-                mapRelativesValidated[ik] = mapRelatives.at(ik);
+            for (const Pair& edge : {Pair(I, J), Pair(J, K), Pair(K, I)})
+            {
+                const Pair reverseEdge(edge.second, edge.first);
+                if (mapRelatives.count(edge))
+                    mapRelativesValidated[edge] = mapRelatives.at(edge);
+                else
+                    mapRelativesValidated[reverseEdge] = mapRelatives.at(reverseEdge);
+            }
         }
         else
         {
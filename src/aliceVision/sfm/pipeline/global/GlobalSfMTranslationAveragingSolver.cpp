@@ -11,7 +11,6 @@
 #include <aliceVision/sfmDataIO/sfmDataIO.hpp>
 #include <aliceVision/sfm/bundle/BundleAdjustmentCeres.hpp>
 #include <aliceVision/sfm/pipeline/global/reindexGlobalSfM.hpp>
-#include <aliceVision/sfm/pipeline/global/MutexSet.hpp>
 #include <aliceVision/matching/IndMatch.hpp>
 #include <aliceVision/multiview/translationAveraging/common.hpp>
 #include <aliceVision/multiview/translationAveraging/solver.hpp>
@@ -31,6 +30,9 @@
 
 #include <aliceVision/utils/Histogram.hpp>
 
+#include <algorithm>
+#include <atomic>
+
 namespace aliceVision {
 namespace sfm {
 
@@ -38,6 +40,30 @@ using namespace aliceVision::camera;
 using namespace aliceVision::geometry;
 using namespace aliceVision::sfmData;
 
+namespace {
+
+/**
+ * @brief Get the pairwise matches between the views of a triplet of poses.
+ */
+template<typename MatchesPerPosePair>
+void getTripletMatches(const MatchesPerPosePair& matchesPerPosePair, const graph::Triplet& triplet, matching::PairwiseMatches& out_tripletMatches)
+{
+    const IndexT poseIds[3] = {triplet.i, triplet.j, triplet.k};
+    for (int a = 0; a < 3; ++a)
+    {
+        for (int b = a + 1; b < 3; ++b)
+        {
+            const auto it = matchesPerPosePair.find(std::minmax(poseIds[a], poseIds[b]));
+            if (it == matchesPerPosePair.end())
+                continue;
+            for (const auto* matches : it->second)
+                out_tripletMatches.insert(*matches);
+        }
+    }
+}
+
+}  // namespace
+
 /// Use features in normalized camera frames
 bool GlobalSfMTranslationAveragingSolver::run(ETranslationAveragingMethod eTranslationAveragingMethod,
                                               SfMData& sfmData,
@@ -183,9 +209,14 @@ bool GlobalSfMTranslationAveragingSolver::translationAveraging(ETranslationAvera
             break;
 
             case TRANSLATION_AVERAGING_SOFTL1:
+            case TRANSLATION_AVERAGING_L1_IRLS:
             {
                 std::vector<Vec3> vecTranslations;
-                if (!translationAveraging::solve_translations_problem_softl1(vecInitialRijTijEstimatesCpy, true, iNview, vecTranslations))
+                const bool solved =
+                  (eTranslationAveragingMethod == TRANSLATION_AVERAGING_SOFTL1)
+                    ? translationAveraging::solve_translations_problem_softl1(vecInitialRijTijEstimatesCpy, true, iNview, vecTranslations)
+                    : translationAveraging::solve_translations_problem_l1_irls(vecInitialRijTijEstimatesCpy, true, iNview, vecTranslations);
+                if (!solved)
                 {
                     ALICEVISION_LOG_WARNING("Compute global translations: failed");
                     return false;
@@ -327,42 +358,37 @@ void GlobalSfMTranslationAveragingSolver::computePutativeTranslationEdgesCoverag
     const std::vector<graph::Triplet> vecTriplets = graph::tripletListing(rotationPoseIdGraph);
     ALICEVISION_LOG_DEBUG("#Triplets: " << vecTriplets.size());
 
+    // Index the matches by pair of poses once, instead of scanning all the matches for each triplet
+    MatchesPerPosePair matchesPerPosePair;
+    for (const auto& matchIterator : pairwiseMatches)
+    {
+        const IndexT poseI = sfmData.getViews().at(matchIterator.first.first)->getPoseId();
+        const IndexT poseJ = sfmData.getViews().at(matchIterator.first.second)->getPoseId();
+        if (poseI != poseJ && setPoseIds.count(poseI) && setPoseIds.count(poseJ))
+            matchesPerPosePair[std::minmax(poseI, poseJ)].push_back(&matchIterator);
+    }
+
     {
         // Compute triplets of translations
         // Avoid to cover each edge of the graph by using an edge coverage algorithm
         // An estimated triplets of translation mark three edges as estimated.
 
         //-- precompute the number of track per triplet:
-        std::map<IndexT, IndexT> mapTracksPerTriplets;
+        std::vector<std::size_t> vecTracksPerTriplets(vecTriplets.size(), 0);
 
 #pragma omp parallel for schedule(dynamic)
         for (int i = 0; i < (int)vecTriplets.size(); ++i)
         {
             // List matches that belong to the triplet of poses
-            const graph::Triplet& triplet = vecTriplets[i];
             matching::PairwiseMatches mapTripletMatches;
-            const std::set<IndexT> setTripletPoseIds = {triplet.i, triplet.j, triplet.k};
-            // List shared correspondences (pairs) between the triplet poses
-            for (const auto& matchIterator : pairwiseMatches)
-            {
-                const Pair pair = matchIterator.first;
-                const View* v1 = sfmData.getViews().at(pair.first).get();
-                const View* v2 = sfmData.getViews().at(pair.second).get();
-                if (  // Consider the pair iff it is supported by the triplet graph & 2 different pose id
-                  (v1->getPoseId() != v2->getPoseId()) && setTripletPoseIds.count(v1->getPoseId()) && setTripletPoseIds.count(v2->getPoseId()))
-                {
-                    mapTripletMatches.insert(matchIterator);
-                }
-            }
+            getTripletMatches(matchesPerPosePair, vecTriplets[i], mapTripletMatches);
+
             // Compute tracks:
-            {
-                aliceVision::track::TracksBuilder tracksBuilder;
-                tracksBuilder.build(mapTripletMatches);
-                tracksBuilder.filter(true, 3);
+            aliceVision::track::TracksBuilder tracksBuilder;
+            tracksBuilder.build(mapTripletMatches);
+            tracksBuilder.filter(true, 3);
 
-#pragma omp critical
-                mapTracksPerTriplets[i] = tracksBuilder.nbTracks();  // count the # of matches in the UF tree
-            }
+            vecTracksPerTriplets[i] = tracksBuilder.nbTracks();  // count the # of matches in the UF tree
         }
 
         typedef Pair myEdge;
@@ -377,26 +403,43 @@ void GlobalSfMTranslationAveragingSolver::computePutativeTranslationEdgesCoverag
             mapTripletIdsPerEdge[std::make_pair(triplet.j, triplet.k)].push_back(i);
         }
 
-        // Collect edges that are covered by the triplets
+        // Collect edges that are covered by the triplets (sorted, as the map keys)
         std::vector<myEdge> vecEdges;
         std::transform(mapTripletIdsPerEdge.begin(), mapTripletIdsPerEdge.end(), std::back_inserter(vecEdges), stl::RetrieveKey());
 
-        aliceVision::sfm::MutexSet<myEdge> mMutexSet;
+        // Lock-free coverage state: one flag per edge and the number of covered edges
+        std::vector<std::atomic<bool>> isEdgeEstimated(vecEdges.size());
+        for (auto& flag : isEdgeEstimated)
+            flag.store(false);
+        std::atomic<std::size_t> nbEstimatedEdges(0);
+
+        const auto getEdgeIndex = [&vecEdges](const myEdge& edge) -> std::size_t {
+            return std::lower_bound(vecEdges.begin(), vecEdges.end(), edge) - vecEdges.begin();
+        };
+        const auto markEdgeAsEstimated = [&](const myEdge& edge) {
+            if (!isEdgeEstimated[getEdgeIndex(edge)].exchange(true))
+                ++nbEstimatedEdges;
+        };
 
         auto progressDisplay =
           system::createConsoleProgressDisplay(vecEdges.size(), std::cout, "\nRelative translations computation (edge coverage algorithm)\n");
 
-        // set number of threads, 1 if openMP is not enabled
+        // Results sharded per thread (1 if openMP is not enabled), merged after the parallel loop
         std::vector<translationAveraging::RelativeInfoVec> initialEstimates(omp_get_max_threads());
-        const bool bVerbose = false;
+        std::vector<matching::PairwiseMatches> newPairMatchesPerThread(omp_get_max_threads());
+        std::vector<std::mt19937> randomNumberGenerators;
+        for (int i = 0; i < omp_get_max_threads(); ++i)
+            randomNumberGenerators.emplace_back(randomNumberGenerator());
 
 #pragma omp parallel for schedule(dynamic)
         for (int k = 0; k < vecEdges.size(); ++k)
         {
             const myEdge& edge = vecEdges[k];
             ++progressDisplay;
-            if (mMutexSet.count(edge) == 0 && mMutexSet.size() != vecEdges.size())
+            if (!isEdgeEstimated[k] && nbEstimatedEdges != vecEdges.size())
             {
+                const int threadId = omp_get_thread_num();
+
                 // Find the triplets that support the given edge
                 const auto& vecPossibleTripletIndexes = mapTripletIdsPerEdge.at(edge);
 
@@ -404,7 +447,7 @@ void GlobalSfMTranslationAveragingSolver::computePutativeTranslationEdgesCoverag
                 std::vector<size_t> vecCommonTracksPerTriplets;
                 for (const size_t tripletIndex : vecPossibleTripletIndexes)
                 {
-                    vecCommonTracksPerTriplets.push_back(mapTracksPerTriplets[tripletIndex]);
+                    vecCommonTracksPerTriplets.push_back(vecTracksPerTriplets[tripletIndex]);
                 }
 
                 using namespace stl::indexed_sort;
@@ -423,8 +466,8 @@ void GlobalSfMTranslationAveragingSolver::computePutativeTranslationEdgesCoverag
                     const graph::Triplet& triplet = vecTriplets[tripletIndex];
 
                     // If the triplet is already estimated by another thread; try the next one
-                    if (mMutexSet.count(Pair(triplet.i, triplet.j)) && mMutexSet.count(Pair(triplet.i, triplet.k)) &&
-                        mMutexSet.count(Pair(triplet.j, triplet.k)))
+                    if (isEdgeEstimated[getEdgeIndex(Pair(triplet.i, triplet.j))] && isEdgeEstimated[getEdgeIndex(Pair(triplet.i, triplet.k))] &&
+                        isEdgeEstimated[getEdgeIndex(Pair(triplet.j, triplet.k))])
                     {
                         break;
                     }
@@ -442,9 +485,9 @@ void GlobalSfMTranslationAveragingSolver::computePutativeTranslationEdgesCoverag
                     const bool bTripletEstimation = estimateTTriplet(sfmData,
                                                                      mapGlobalR,
                                                                      normalizedFeaturesPerView,
-                                                                     pairwiseMatches,
+                                                                     matchesPerPosePair,
                                                                      triplet,
-                                                                     randomNumberGenerator,
+                                                                     randomNumberGenerators[threadId],
                                                                      vecTis,
                                                                      dPrecision,
                                                                      vecInliers,
@@ -454,9 +497,9 @@ void GlobalSfMTranslationAveragingSolver::computePutativeTranslationEdgesCoverag
                     if (bTripletEstimation)
                     {
                         // Since new translation edges have been computed, mark their corresponding edges as estimated
-                        mMutexSet.insert(std::make_pair(triplet.i, triplet.j));
-                        mMutexSet.insert(std::make_pair(triplet.j, triplet.k));
-                        mMutexSet.insert(std::make_pair(triplet.i, triplet.k));
+                        markEdgeAsEstimated(std::make_pair(triplet.i, triplet.j));
+                        markEdgeAsEstimated(std::make_pair(triplet.j, triplet.k));
+                        markEdgeAsEstimated(std::make_pair(triplet.i, triplet.k));
 
                         // Compute the triplet relative motions (IJ, JK, IK)
                         {
@@ -475,47 +518,38 @@ void GlobalSfMTranslationAveragingSolver::computePutativeTranslationEdgesCoverag
                             Vec3 tik;
                             relativeCameraMotion(RI, ti, RK, tk, &Rik, &tik);
 
-                            // set number of threads, 1 if openMP is not enabled
-                            const int threadId = omp_get_thread_num();
-
                             initialEstimates[threadId].emplace_back(std::make_pair(triplet.i, triplet.j), std::make_pair(Rij, tij));
                             initialEstimates[threadId].emplace_back(std::make_pair(triplet.j, triplet.k), std::make_pair(Rjk, tjk));
                             initialEstimates[threadId].emplace_back(std::make_pair(triplet.i, triplet.k), std::make_pair(Rik, tik));
 
-//--- ATOMIC
-#pragma omp critical
+                            // Add inliers as valid pairwise matches
+                            matching::PairwiseMatches& threadPairMatches = newPairMatchesPerThread[threadId];
+                            std::vector<std::size_t> sortedInliers = vecInliers;
+                            std::sort(sortedInliers.begin(), sortedInliers.end());
+                            auto itTracks = poseTripletTracks.cbegin();
+                            std::size_t itTracksIndex = 0;
+                            for (const std::size_t inlier : sortedInliers)
                             {
-                                // Add inliers as valid pairwise matches
-                                for (std::vector<size_t>::const_iterator iterInliers = vecInliers.begin(); iterInliers != vecInliers.end();
-                                     ++iterInliers)
+                                using namespace aliceVision::track;
+                                std::advance(itTracks, inlier - itTracksIndex);
+                                itTracksIndex = inlier;
+                                const Track& track = itTracks->second;
+
+                                // create pairwise matches from inlier track
+                                for (auto iterI = track.featPerView.begin(); iterI != track.featPerView.end(); ++iterI)
                                 {
-                                    using namespace aliceVision::track;
-                                    TracksMap::iterator itTracks = poseTripletTracks.begin();
-                                    std::advance(itTracks, *iterInliers);
-                                    const Track& track = itTracks->second;
+                                    // extract camera indexes
+                                    const size_t idViewI = iterI->first;
+                                    const size_t idFeatI = iterI->second.featureId;
 
-                                    // create pairwise matches from inlier track
-                                    for (size_t indexI = 0; indexI < track.featPerView.size(); ++indexI)
+                                    // loop on subtracks
+                                    for (auto iterJ = std::next(iterI); iterJ != track.featPerView.end(); ++iterJ)
                                     {
-                                        Track::FeatureIdPerView::const_iterator iterI = track.featPerView.begin();
-                                        std::advance(iterI, indexI);
-
                                         // extract camera indexes
-                                        const size_t idViewI = iterI->first;
-                                        const size_t idFeatI = iterI->second.featureId;
+                                        const size_t idViewJ = iterJ->first;
+                                        const size_t idFeatJ = iterJ->second.featureId;
 
-                                        // loop on subtracks
-                                        for (size_t indexJ = indexI + 1; indexJ < track.featPerView.size(); ++indexJ)
-                                        {
-                                            Track::FeatureIdPerView::const_iterator iterJ = track.featPerView.begin();
-                                            std::advance(iterJ, indexJ);
-
-                                            // extract camera indexes
-                                            const size_t idViewJ = iterJ->first;
-                                            const size_t idFeatJ = iterJ->second.featureId;
-
-                                            newpairMatches[std::make_pair(idViewI, idViewJ)][track.descType].emplace_back(idFeatI, idFeatJ);
-                                        }
+                                        threadPairMatches[std::make_pair(idViewI, idViewJ)][track.descType].emplace_back(idFeatI, idFeatJ);
                                     }
                                 }
                             }
@@ -528,11 +562,19 @@ void GlobalSfMTranslationAveragingSolver::computePutativeTranslationEdgesCoverag
             }
         }
         // Merge thread estimates
-        for (const auto vec : initialEstimates)
+        for (const auto& vec : initialEstimates)
         {
-            for (const auto val : vec)
+            vecInitialEstimates.insert(vecInitialEstimates.end(), vec.begin(), vec.end());
+        }
+        for (const auto& threadPairMatches : newPairMatchesPerThread)
+        {
+            for (const auto& pairMatches : threadPairMatches)
             {
-                vecInitialEstimates.emplace_back(val);
+                for (const auto& descMatches : pairMatches.second)
+                {
+                    matching::IndMatches& matches = newpairMatches[pairMatches.first][descMatches.first];
+                    matches.insert(matches.end(), descMatches.second.begin(), descMatches.second.end());
+                }
             }
         }
     }
@@ -557,7 +599,7 @@ void GlobalSfMTranslationAveragingSolver::computePutativeTranslationEdgesCoverag
 bool GlobalSfMTranslationAveragingSolver::estimateTTriplet(const SfMData& sfmData,
                                                            const std::map<IndexT, Mat3>& mapGlobalR,
                                                            const feature::FeaturesPerView& normalizedFeaturesPerView,
-                                                           const matching::PairwiseMatches& pairwiseMatches,
+                                                           const MatchesPerPosePair& matchesPerPosePair,
                                                            const graph::Triplet& posesId,
                                                            std::mt19937& randomNumberGenerator,
                                                            std::vector<Vec3>& vecTis,
@@ -568,19 +610,7 @@ bool GlobalSfMTranslationAveragingSolver::estimateTTriplet(const SfMData& sfmDat
 {
     // List matches that belong to the triplet of poses
     matching::PairwiseMatches mapTripletMatches;
-    const std::set<IndexT> setPoseIds = {posesId.i, posesId.j, posesId.k};
-    // List shared correspondences (pairs) between poses
-    for (const auto& matchIterator : pairwiseMatches)
-    {
-        const Pair& pair = matchIterator.first;
-        const View* v1 = sfmData.getViews().at(pair.first).get();
-        const View* v2 = sfmData.getViews().at(pair.second).get();
-        if (  // Consider the pair iff it is supported by the triplet graph & 2 different pose id
-          (v1->getPoseId() != v2->getPoseId()) && setPoseIds.count(v1->getPoseId()) && setPoseIds.count(v2->getPoseId()))
-        {
-            mapTripletMatches.insert(matchIterator);
-        }
-    }
+    getTripletMatches(matchesPerPosePair, posesId, mapTripletMatches);
 
     aliceVision::track::TracksBuilder tracksBuilder;
     tracksBuilder.build(mapTripletMatches);
@@ -21,7 +21,8 @@ enum ETranslationAveragingMethod
 {
     TRANSLATION_AVERAGING_L1 = 1,
     TRANSLATION_AVERAGING_L2_DISTANCE_CHORDAL = 2,
-    TRANSLATION_AVERAGING_SOFTL1 = 3
+    TRANSLATION_AVERAGING_SOFTL1 = 3,
+    TRANSLATION_AVERAGING_L1_IRLS = 4
 };
 
 inline std::string ETranslationAveragingMethod_enumToString(ETranslationAveragingMethod eTranslationAveragingMethod)
@@ -34,6 +35,8 @@ inline std::string ETranslationAveragingMethod_enumToString(ETranslationAveragin
             return "L2_minimization";
         case ETranslationAveragingMethod::TRANSLATION_AVERAGING_SOFTL1:
             return "L1_soft_minimization";
+        case ETranslationAveragingMethod::TRANSLATION_AVERAGING_L1_IRLS:
+            return "L1_irls_minimization";
     }
     throw std::out_of_range("Invalid translation averaging method type");
 }
@@ -46,6 +49,8 @@ inline ETranslationAveragingMethod ETranslationAveragingMethod_stringToEnum(cons
         return ETranslationAveragingMethod::TRANSLATION_AVERAGING_L2_DISTANCE_CHORDAL;
     if (TranslationAveragingMethodName == "L1_soft_minimization")
         return ETranslationAveragingMethod::TRANSLATION_AVERAGING_SOFTL1;
+    if (TranslationAveragingMethodName == "L1_irls_minimization")
+        return ETranslationAveragingMethod::TRANSLATION_AVERAGING_L1_IRLS;
 
     throw std::out_of_range("Invalid translation averaging method name : '" + TranslationAveragingMethodName + "'");
 }
@@ -63,6 +68,9 @@ class GlobalSfMTranslationAveragingSolver
 {
     translationAveraging::RelativeInfoVec m_vec_initialRijTijEstimates;
 
+    /// Pairwise matches of the views of each pair of poses (sorted pose ids)
+    using MatchesPerPosePair = std::map<Pair, std::vector<const matching::PairwiseMatches::value_type*>>;
+
   public:
     /**
      * @brief Use features in normalized camera frames
@@ -107,7 +115,7 @@ class GlobalSfMTranslationAveragingSolver
     bool estimateTTriplet(const sfmData::SfMData& sfmData,
                           const std::map<IndexT, Mat3>& mapGlobalR,
                           const feature::FeaturesPerView& normalizedFeaturesPerView,
-                          const matching::PairwiseMatches& pairwiseMatches,
+                          const MatchesPerPosePair& matchesPerPosePair,
                           const graph::Triplet& posesId,
                           std::mt19937& randomNumberGenerator,
                           std::vector<Vec3>& vecTis,
@@ -372,6 +372,8 @@ bool ReconstructionEngine_globalSfM::adjust()
     // refine sfm  scene (in a 3 iteration process (free the parameters regarding their incertainty order)):
     BundleAdjustmentCeres::CeresOptions options;
     options.useParametersOrdering = false;  // disable parameters ordering
+    options.useCuda = _bundleAdjustmentUseCuda;
+    options.useAnalyticJacobians = _bundleAdjustmentAnalyticJacobians;
 
     BundleAdjustmentCeres BA(options);
     // - refine only Structure and translations
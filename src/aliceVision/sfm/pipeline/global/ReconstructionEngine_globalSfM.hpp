@@ -32,6 +32,8 @@ class ReconstructionEngine_globalSfM : public ReconstructionEngine
     void setTranslationAveragingMethod(ETranslationAveragingMethod eTranslationAveragingMethod);
 
     void setLockAllIntrinsics(bool v) { _lockAllIntrinsics = v; }
+    void setBundleAdjustmentUseCuda(bool v) { _bundleAdjustmentUseCuda = v; }
+    void setBundleAdjustmentAnalyticJacobians(bool v) { _bundleAdjustmentAnalyticJacobians = v; }
 
     virtual bool process();
 
@@ -60,6 +62,8 @@ class ReconstructionEngine_globalSfM : public ReconstructionEngine
     ERotationAveragingMethod _eRotationAveragingMethod;
     ETranslationAveragingMethod _eTranslationAveragingMethod;
     bool _lockAllIntrinsics = false;
+    bool _bundleAdjustmentUseCuda = false;
+    bool _bundleAdjustmentAnalyticJacobians = false;
     EFeatureConstraint _featureConstraint = EFeatureConstraint::BASIC;
 
     // Data provider
@@ -33,6 +33,7 @@
 #include <aliceVision/matching/supportEstimation.hpp>
 
 #include <aliceVision/sfm/bundle/BundleAdjustmentSymbolicCeres.hpp>
+#include <aliceVision/sfm/bundle/BundleAdjustmentRotation.hpp>
 
 #include <dependencies/htmlDoc/htmlDoc.hpp>
 
@@ -396,7 +397,7 @@ bool ReconstructionEngine_panorama::adjust()
 
     // Start bundle with rotation only
     BundleAdjustmentSymbolicCeres BA(options);
-    bool success = BA.adjust(_sfmData, BundleAdjustmentSymbolicCeres::REFINE_ROTATION);
+    bool success = adjustRotations(BA);
     if (success)
     {
         ALICEVISION_LOG_INFO("Rotations successfully refined.");
@@ -471,7 +472,7 @@ bool ReconstructionEngine_panorama::adjust()
         addConstraints2DWithKnownRotation();
 
         // Minimize Rotation
-        success = BA.adjust(_sfmData, BundleAdjustmentSymbolicCeres::REFINE_ROTATION);
+        success = adjustRotations(BA);
         if (success)
         {
             ALICEVISION_LOG_INFO("Bundle successfully refined: Rotation after cleaning outliers");
@@ -486,6 +487,24 @@ bool ReconstructionEngine_panorama::adjust()
     return true;
 }
 
+bool ReconstructionEngine_panorama::adjustRotations(BundleAdjustmentSymbolicCeres& BA)
+{
+    if (_params.useRotationBundle)
+    {
+        BundleAdjustmentRotation::Options options;
+        options.summary = true;
+
+        BundleAdjustmentRotation rotationBA(options);
+        if (rotationBA.adjust(_sfmData, BundleAdjustment::REFINE_ROTATION))
+        {
+            return true;
+        }
+        ALICEVISION_LOG_WARNING("Failed to refine the rotations with the rotation bundle adjustment, use Ceres.");
+    }
+
+    return BA.adjust(_sfmData, BundleAdjustmentSymbolicCeres::REFINE_ROTATION);
+}
+
 bool ReconstructionEngine_panorama::addConstraints2DWithKnownRotation()
 {
     sfm::Constraints2D& constraints2d = _sfmData.getConstraints2D();
@@ -559,40 +578,74 @@ void ReconstructionEngine_panorama::computeRelativeRotations(rotationAveraging::
     /// pairwise view relation between poseIds
     typedef std::map<Pair, PairSet> PoseWiseMatches;
 
-    sfmData::RotationPriors& rotationPriors = _sfmData.getRotationPriors();
-    for (auto& iterV1 : _sfmData.getViews())
+    // views with a prior on their rotation
+    std::vector<IndexT> priorViewIds;
+    for (const auto& viewPair : _sfmData.getViews())
     {
-        if (!_sfmData.isPoseAndIntrinsicDefined(iterV1.first))
-        {
-            continue;
-        }
+        if (_sfmData.isPoseAndIntrinsicDefined(viewPair.first))
+            priorViewIds.push_back(viewPair.first);
+    }
+
+    std::vector<Mat3> priorRotations(priorViewIds.size());
+    for (std::size_t i = 0; i < priorViewIds.size(); ++i)
+        priorRotations[i] = _sfmData.getAbsolutePose(_sfmData.getView(priorViewIds[i]).getPoseId()).getTransform().rotation();
 
-        for (auto& iterV2 : _sfmData.getViews())
+    // linked views of each view: all the other views,
+    // or the nearest ones by optical axis (e.g. the neighbours in the grid of a robotic head)
+    std::vector<std::vector<std::size_t>> priorNeighbors(priorViewIds.size());
+    if (_params.nbPriorNeighbors > 0 && _params.nbPriorNeighbors + 1 < priorViewIds.size())
+    {
+#pragma omp parallel for
+        for (int i = 0; i < priorViewIds.size(); ++i)
         {
-            if (iterV1.first == iterV2.first)
+            std::vector<std::pair<double, std::size_t>> distances;
+            distances.reserve(priorViewIds.size() - 1);
+            for (std::size_t j = 0; j < priorViewIds.size(); ++j)
             {
-                continue;
+                if (j != i)
+                    distances.emplace_back(-priorRotations[i].row(2).dot(priorRotations[j].row(2)), j);
             }
+            std::partial_sort(distances.begin(), distances.begin() + _params.nbPriorNeighbors, distances.end());
+            for (std::size_t k = 0; k < _params.nbPriorNeighbors; ++k)
+                priorNeighbors[i].push_back(distances[k].second);
+        }
 
-            if (!_sfmData.isPoseAndIntrinsicDefined(iterV2.first))
+        // symmetric links
+        for (std::size_t i = 0; i < priorViewIds.size(); ++i)
+        {
+            for (std::size_t k = 0; k < _params.nbPriorNeighbors; ++k)
+                priorNeighbors[priorNeighbors[i][k]].push_back(i);
+        }
+        for (auto& neighbors : priorNeighbors)
+        {
+            std::sort(neighbors.begin(), neighbors.end());
+            neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+        }
+    }
+    else
+    {
+        for (std::size_t i = 0; i < priorViewIds.size(); ++i)
+        {
+            for (std::size_t j = 0; j < priorViewIds.size(); ++j)
             {
-                continue;
+                if (j != i)
+                    priorNeighbors[i].push_back(j);
             }
+        }
+    }
 
-            IndexT pid1 = iterV1.second->getPoseId();
-            IndexT pid2 = iterV2.second->getPoseId();
-
-            CameraPose oneTo = _sfmData.getAbsolutePose(iterV1.second->getPoseId());
-            CameraPose twoTo = _sfmData.getAbsolutePose(iterV2.second->getPoseId());
-            Eigen::Matrix3d oneRo = oneTo.getTransform().rotation();
-            Eigen::Matrix3d twoRo = twoTo.getTransform().rotation();
-            Eigen::Matrix3d twoRone = twoRo * oneRo.transpose();
+    sfmData::RotationPriors& rotationPriors = _sfmData.getRotationPriors();
+    for (std::size_t i = 0; i < priorViewIds.size(); ++i)
+    {
+        for (const std::size_t j : priorNeighbors[i])
+        {
+            const Eigen::Matrix3d twoRone = priorRotations[j] * priorRotations[i].transpose();
 
-            sfmData::RotationPrior prior(iterV1.first, iterV2.first, twoRone);
+            sfmData::RotationPrior prior(priorViewIds[i], priorViewIds[j], twoRone);
             rotationPriors.push_back(prior);
 
             // Add prior on relative rotations with a low weight
-            vecRelativesR.emplace_back(iterV1.first, iterV2.first, twoRone, _params.rotationAveragingWeighting ? 1.0 : 0.01);
+            vecRelativesR.emplace_back(priorViewIds[i], priorViewIds[j], twoRone, _params.rotationAveragingWeighting ? 1.0 : 0.01);
         }
     }
 
@@ -606,18 +659,34 @@ void ReconstructionEngine_panorama::computeRelativeRotations(rotationAveraging::
         poseWiseMatches[Pair(v1->getPoseId(), v2->getPoseId())].insert(pair);
     }
 
-    sfm::Constraints2D& constraints2d = _sfmData.getConstraints2D();
-    std::map<IndexT, size_t> connectionSize;
+    // result of the relative rotation estimation of a pair of poses
+    struct RelativeRotationResult
+    {
+        bool valid = false;
+        Mat3 rotation;
+        double weight = 1.0;
+        sfm::Constraints2D constraints2d;
+    };
+
+    const std::vector<PoseWiseMatches::value_type> poseWiseMatchesList(poseWiseMatches.begin(), poseWiseMatches.end());
+    std::vector<RelativeRotationResult> relativeRotationResults(poseWiseMatchesList.size());
+
+    // one seed per pair to get the same results whatever the number of threads
+    std::vector<std::mt19937::result_type> seeds(poseWiseMatchesList.size());
+    for (auto& seed : seeds)
+        seed = _randomNumberGenerator();
 
     ALICEVISION_LOG_INFO("Relative pose computation:");
     // For each pair of matching views, compute the relative pose
-    for (int i = 0; i < poseWiseMatches.size(); ++i)
+#pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < poseWiseMatchesList.size(); ++i)
     {
         {
-            PoseWiseMatches::const_iterator iter(poseWiseMatches.begin());
-            std::advance(iter, i);
-            const auto& relativePoseIterator(*iter);
+            const auto& relativePoseIterator = poseWiseMatchesList[i];
             const Pair relativePosePair = relativePoseIterator.first;
+            RelativeRotationResult& result = relativeRotationResults[i];
+            sfm::Constraints2D& constraints2d = result.constraints2d;
+            std::mt19937 randomNumberGenerator(seeds[i]);
             const PairSet& matchPairs = relativePoseIterator.second;
 
             // If a pair has the same ID, discard it
@@ -733,7 +802,7 @@ void ReconstructionEngine_panorama::computeRelativeRotations(rotationAveraging::
             {
                 case RELATIVE_ROTATION_FROM_E:
                 {
-                    if (!robustRelativeRotation_fromE(K, K, x1, x2, imageSize, imageSize, _randomNumberGenerator, relativePoseInfo))
+                    if (!robustRelativeRotation_fromE(K, K, x1, x2, imageSize, imageSize, randomNumberGenerator, relativePoseInfo))
                     {
                         ALICEVISION_LOG_INFO("Relative pose computation: i: " << i << ", (" << I << ", " << J << ") => FAILED");
                         continue;
@@ -746,7 +815,7 @@ void ReconstructionEngine_panorama::computeRelativeRotations(rotationAveraging::
                     relativeRotationInfo._initialResidualTolerance =
                       std::sqrt(std::sqrt(camI->imagePlaneToCameraPlaneError(2.5) * camJ->imagePlaneToCameraPlaneError(2.5)));
 
-                    if (!robustRelativeRotation_fromH(x1, x2, imageSize, imageSize, _randomNumberGenerator, relativeRotationInfo))
+                    if (!robustRelativeRotation_fromH(x1, x2, imageSize, imageSize, randomNumberGenerator, relativeRotationInfo))
                     {
                         ALICEVISION_LOG_INFO("Relative pose computation: i: " << i << ", (" << I << ", " << J << ") => FAILED");
                         continue;
@@ -764,7 +833,7 @@ void ReconstructionEngine_panorama::computeRelativeRotations(rotationAveraging::
                     relativeRotationInfo._initialResidualTolerance =
                       std::sqrt(std::sqrt(camI->imagePlaneToCameraPlaneError(2.5) * camJ->imagePlaneToCameraPlaneError(2.5)));
 
-                    if (!robustRelativeRotation_fromR(x1, x2, imageSize, imageSize, _randomNumberGenerator, relativeRotationInfo))
+                    if (!robustRelativeRotation_fromR(x1, x2, imageSize, imageSize, randomNumberGenerator, relativeRotationInfo))
                     {
                         ALICEVISION_LOG_INFO("Relative pose computation: i: " << i << ", (" << I << ", " << J << ") => FAILED");
                         ALICEVISION_LOG_INFO("I: " << viewI->getImage().getImagePath() << ", J: " << viewJ->getImage().getImagePath());
@@ -804,18 +873,6 @@ void ReconstructionEngine_panorama::computeRelativeRotations(rotationAveraging::
                 }
             }
 
-            // Add connection to find best constraints
-            if (connectionSize.find(I) == connectionSize.end())
-            {
-                connectionSize[I] = 0;
-            }
-            connectionSize[I] += relativePoseInfo.vec_inliers.size();
-            if (connectionSize.find(J) == connectionSize.end())
-            {
-                connectionSize[J] = 0;
-            }
-            connectionSize[J] += relativePoseInfo.vec_inliers.size();
-
             // Sort all inliers by increasing ids
             if (!relativePoseInfo.vec_inliers.empty())
             {
@@ -858,15 +915,27 @@ void ReconstructionEngine_panorama::computeRelativeRotations(rotationAveraging::
                 }
             }
 
-            // #pragma omp critical
-            {
-                // Add the relative rotation to the relative 'rotation' pose graph
-                using namespace aliceVision::rotationAveraging;
-                vecRelativesR.emplace_back(relativePosePair.first, relativePosePair.second, relativePoseInfo.relativePose.rotation(), weight);
-            }
+            result.valid = true;
+            result.rotation = relativePoseInfo.relativePose.rotation();
+            result.weight = weight;
         }
     }  // for all relative pose
 
+    // gather the results in the pairs order
+    sfm::Constraints2D& constraints2d = _sfmData.getConstraints2D();
+    for (std::size_t i = 0; i < poseWiseMatchesList.size(); ++i)
+    {
+        RelativeRotationResult& result = relativeRotationResults[i];
+        if (!result.valid)
+            continue;
+
+        const Pair& relativePosePair = poseWiseMatchesList[i].first;
+        constraints2d.insert(constraints2d.end(), result.constraints2d.begin(), result.constraints2d.end());
+
+        // Add the relative rotation to the relative 'rotation' pose graph
+        vecRelativesR.emplace_back(relativePosePair.first, relativePosePair.second, result.rotation, result.weight);
+    }
+
     // Debug result
     ALICEVISION_LOG_DEBUG("computeRelativeRotations: vecRelativesR.size(): " << vecRelativesR.size());
     for (rotationAveraging::RelativeRotation& rotation : vecRelativesR)
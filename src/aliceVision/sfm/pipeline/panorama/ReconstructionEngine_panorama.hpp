@@ -16,6 +16,8 @@
 namespace aliceVision {
 namespace sfm {
 
+class BundleAdjustmentSymbolicCeres;
+
 enum ERelativeRotationMethod
 {
     RELATIVE_ROTATION_FROM_E = 0,
@@ -166,6 +168,8 @@ class ReconstructionEngine_panorama : public ReconstructionEngine
         double maxAngularError = 100.0;                //< max angular error in degree (in global rotation averaging)
         bool intermediateRefineWithFocal = false;      //< intermediate refine with rotation+focal
         bool intermediateRefineWithFocalDist = false;  //< intermediate refine with rotation+focal+distortion
+        bool useRotationBundle = false;                //< refine the rotations alone with the sparse rotation bundle adjustment (not Ceres)
+        std::size_t nbPriorNeighbors = 0;              //< number of nearest views (by prior orientation) linked by a rotation prior, 0 for all
     };
     ReconstructionEngine_panorama(const sfmData::SfMData& sfmData,
                                   const Params& params,
@@ -199,6 +203,13 @@ class ReconstructionEngine_panorama : public ReconstructionEngine
     void computeRelativeRotations(aliceVision::rotationAveraging::RelativeRotations& vecRelativesR);
     bool addConstraints2DWithKnownRotation();
 
+    /**
+     * @brief Refine the rotations only (intrinsics fixed), with the rotation bundle adjustment if enabled.
+     * @param[in,out] BA The Ceres bundle adjustment, used if the rotation bundle adjustment is disabled or fails
+     * @return false if the refinement failed
+     */
+    bool adjustRotations(BundleAdjustmentSymbolicCeres& BA);
+
     // Logger
     std::shared_ptr<htmlDocument::htmlDocumentStream> _htmlDocStream;
     std::string _loggingFile;
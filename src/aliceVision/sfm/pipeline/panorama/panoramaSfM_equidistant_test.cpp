@@ -18,3 +18,11 @@ BOOST_AUTO_TEST_CASE(PANORAMA_SFM_EQUIDISTANT)
 
     test_panorama(intrinsic_gt, intrinsic_est, 0.0);
 }
+
+BOOST_AUTO_TEST_CASE(PANORAMA_SFM_EQUIDISTANT_ROTATION_BUNDLE)
+{
+    auto intrinsic_gt = camera::createIntrinsic(camera::EINTRINSIC::EQUIDISTANT_CAMERA, camera::EDISTORTION::DISTORTION_RADIALK3, camera::EUNDISTORTION::UNDISTORTION_NONE, 1920, 1080, 1357.0, 1357.0, 0, 0);
+    auto intrinsic_est = camera::createIntrinsic(camera::EINTRINSIC::EQUIDISTANT_CAMERA, camera::EDISTORTION::DISTORTION_RADIALK3, camera::EUNDISTORTION::UNDISTORTION_NONE, 1920, 1080, 1200.0, 1200.0, 40, -20);
+
+    test_panorama(intrinsic_gt, intrinsic_est, 0.0, true);
+}
@@ -24,7 +24,8 @@ using namespace aliceVision;
 
 void test_panorama(std::shared_ptr<camera::IntrinsicBase>& intrinsic_gt,
                    std::shared_ptr<camera::IntrinsicBase>& intrinsic_noisy,
-                   double ratio_inliers)
+                   double ratio_inliers,
+                   bool useRotationBundle = false)
 {
     sfmData::SfMData sfmdata;
     sfmdata.getIntrinsics().emplace(0, intrinsic_noisy);
@@ -121,6 +122,7 @@ void test_panorama(std::shared_ptr<camera::IntrinsicBase>& intrinsic_gt,
     }
     sfm::ReconstructionEngine_panorama::Params params;
     params.eRelativeRotationMethod = sfm::RELATIVE_ROTATION_FROM_R;
+    params.useRotationBundle = useRotationBundle;
 
     sfm::ReconstructionEngine_panorama pano(sfmdata, params, "");
     pano.setFeaturesProvider(&fpv);
@@ -254,7 +254,8 @@ bool loadRegionsPerView(feature::RegionsPerView& regionsPerView,
 bool loadFeaturesPerView(feature::FeaturesPerView& featuresPerView,
                          const SfMData& sfmData,
                          const std::vector<std::string>& folders,
-                         const std::vector<feature::EImageDescriberType>& imageDescriberTypes)
+                         const std::vector<feature::EImageDescriberType>& imageDescriberTypes,
+                         const std::set<IndexT>& viewIdFilter)
 {
     std::vector<std::string> featuresFolders = sfmData.getFeaturesFolders();        // add sfm features folders
     featuresFolders.insert(featuresFolders.end(), folders.begin(), folders.end());  // add user features folders
@@ -267,7 +268,8 @@ bool loadFeaturesPerView(feature::FeaturesPerView& featuresPerView,
     for (auto it = featuresFolders.begin(); it != featuresFolders.end(); ++it)
         ALICEVISION_LOG_DEBUG("\t - " << *it);
 
-    auto progressDisplay = system::createConsoleProgressDisplay(sfmData.getViews().size(), std::cout, "Loading features\n");
+    const std::size_t nbViews = viewIdFilter.empty() ? sfmData.getViews().size() : viewIdFilter.size();
+    auto progressDisplay = system::createConsoleProgressDisplay(nbViews, std::cout, "Loading features\n");
 
     // read for each view the corresponding features and store them as PointFeatures
     std::atomic_bool invalid(false);
@@ -283,7 +285,9 @@ bool loadFeaturesPerView(feature::FeaturesPerView& featuresPerView,
     {
 #pragma omp single nowait
         {
-            for (std::size_t i = 0; i < imageDescriberTypes.size(); ++i)
+            const bool filtered = !viewIdFilter.empty() && viewIdFilter.find(iter->second.get()->getViewId()) == viewIdFilter.end();
+
+            for (std::size_t i = 0; i < imageDescriberTypes.size() && !filtered; ++i)
             {
                 std::unique_ptr<feature::Regions> regionsPtr;
                 try
@@ -71,12 +71,14 @@ bool loadRegionsPerView(feature::RegionsPerView& regionsPerView,
  * @param[in] sfmData The provided SfMData container
  * @param[in] folders The feature Folders
  * @param[in] imageDescriberTypes The imageDescriber types
+ * @param[in] filter To load Features only for a sub-set of the views contained in the sfmData
  * @return true if the features are correctlty loaded
  */
 bool loadFeaturesPerView(feature::FeaturesPerView& featuresPerView,
                          const sfmData::SfMData& sfmData,
                          const std::vector<std::string>& folders,
-                         const std::vector<feature::EImageDescriberType>& imageDescriberTypes);
+                         const std::vector<feature::EImageDescriberType>& imageDescriberTypes,
+                         const std::set<IndexT>& filter = std::set<IndexT>());
 
 }  // namespace sfm
 }  // namespace aliceVision
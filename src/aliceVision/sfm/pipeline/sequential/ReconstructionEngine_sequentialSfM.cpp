@@ -26,11 +26,15 @@
 #include <aliceVision/stl/stl.hpp>
 #include <aliceVision/system/ProgressDisplay.hpp>
 #include <aliceVision/system/Timer.hpp>
+#include <aliceVision/system/ResourceReport.hpp>
+#include <aliceVision/system/TaskScheduler.hpp>
+#include <aliceVision/system/Tracer.hpp>
 #include <aliceVision/system/cpu.hpp>
 #include <aliceVision/system/MemoryInfo.hpp>
 #include <aliceVision/track/TracksBuilder.hpp>
 #include <aliceVision/track/tracksUtils.hpp>
 #include <aliceVision/utils/filesIO.hpp>
+#include <aliceVision/alicevision_omp.hpp>
 
 #include <dependencies/htmlDoc/htmlDoc.hpp>
 
@@ -172,6 +176,9 @@ ReconstructionEngine_sequentialSfM::ReconstructionEngine_sequentialSfM(const SfM
 
 bool ReconstructionEngine_sequentialSfM::process()
 {
+    ALICEVISION_TRACE_ZONE_CAT("ReconstructionEngine_sequentialSfM::process", "sfm");
+    ALICEVISION_RESOURCE_PHASE("ReconstructionEngine_sequentialSfM::process");
+
     initializePyramidScoring();
 
     if (fuseMatchesIntoTracks() == 0)
@@ -207,6 +214,11 @@ bool ReconstructionEngine_sequentialSfM::process()
         std::vector<Pair> initialImagePairCandidates = getInitialImagePairsCandidates();
         createInitialReconstruction(initialImagePairCandidates);
     }
+    else if (_params.incrementalUpdate && !_sfmData.getLandmarks().empty())
+    {
+        // the reconstructed views are kept as they are: only the new views are localized, triangulated and adjusted
+        ALICEVISION_LOG_INFO("Incremental update of the " << _sfmData.getValidViews().size() << " reconstructed views.");
+    }
     else
     {
         // If we don't have any landmark, we need to triangulate them from the known poses.
@@ -235,6 +247,7 @@ void ReconstructionEngine_sequentialSfM::initializePyramidScoring()
     if (_pyramidWeights.size() != _params.pyramidDepth)
     {
         _pyramidWeights.resize(_params.pyramidDepth);
+        _pyramidNbCells = 0;
         std::size_t maxWeight = 0;
         for (std::size_t level = 0; level < _params.pyramidDepth; ++level)
         {
@@ -245,13 +258,94 @@ void ReconstructionEngine_sequentialSfM::initializePyramidScoring()
             // w = 2^{L-l} with L the number of levels in the pyramid.
             _pyramidWeights[level] = std::pow(2.0, (_params.pyramidDepth - (level + 1)));
             maxWeight += nbCells * _pyramidWeights[level];
+            _pyramidNbCells += nbCells;
         }
         _pyramidThreshold = maxWeight * 0.2;
     }
 }
 
+void ReconstructionEngine_sequentialSfM::updatePyramidScoring()
+{
+    // landmarks are sorted by track id
+    std::vector<std::size_t> reconstructedTrackIds;
+    reconstructedTrackIds.reserve(_sfmData.getLandmarks().size());
+    std::transform(_sfmData.getLandmarks().begin(),
+                   _sfmData.getLandmarks().end(),
+                   std::back_inserter(reconstructedTrackIds),
+                   stl::RetrieveKey());
+
+    std::vector<std::size_t> addedTrackIds;
+    std::vector<std::size_t> removedTrackIds;
+    std::set_difference(reconstructedTrackIds.begin(),
+                        reconstructedTrackIds.end(),
+                        _pyramidScoredTrackIds.begin(),
+                        _pyramidScoredTrackIds.end(),
+                        std::back_inserter(addedTrackIds));
+    std::set_difference(_pyramidScoredTrackIds.begin(),
+                        _pyramidScoredTrackIds.end(),
+                        reconstructedTrackIds.begin(),
+                        reconstructedTrackIds.end(),
+                        std::back_inserter(removedTrackIds));
+
+    // update the cells of the pyramid of all the views observing a changed track
+    const auto updateTrack = [&](std::size_t trackId, bool isReconstructed) {
+        const auto trackIt = _map_tracks.find(trackId);
+        if (trackIt == _map_tracks.end())
+            return;
+
+        for (const auto& featPerView : trackIt->second.featPerView)
+        {
+            const IndexT viewId = featPerView.first;
+            const auto& featsPyramid = _map_featsPyramidPerView.at(viewId);
+
+            // the pyramid indexes of all levels of a track are contiguous in the flat map
+            auto it = featsPyramid.find(trackId * _params.pyramidDepth);
+            if (it == featsPyramid.end())
+                throw std::out_of_range("No pyramid index for track " + std::to_string(trackId) + " in view " + std::to_string(viewId));
+
+            ViewPyramidScore& viewScore = _pyramidScorePerView[viewId];
+            if (viewScore.nbTracksPerCell.empty())
+                viewScore.nbTracksPerCell.resize(_pyramidNbCells, 0);
+
+            for (std::size_t level = 0; level < _params.pyramidDepth; ++level, ++it)
+            {
+                assert(it->first == trackId * _params.pyramidDepth + level);
+                std::uint32_t& nbTracksInCell = viewScore.nbTracksPerCell[it->second];
+
+                if (isReconstructed)
+                {
+                    if (nbTracksInCell++ == 0)
+                        viewScore.score += _pyramidWeights[level];
+                }
+                else
+                {
+                    assert(nbTracksInCell > 0);
+                    if (--nbTracksInCell == 0)
+                        viewScore.score -= _pyramidWeights[level];
+                }
+            }
+
+            if (isReconstructed)
+                ++viewScore.nbTracks;
+            else
+                --viewScore.nbTracks;
+        }
+    };
+
+    for (const std::size_t trackId : removedTrackIds)
+        updateTrack(trackId, false);
+    for (const std::size_t trackId : addedTrackIds)
+        updateTrack(trackId, true);
+
+    _pyramidScoredTrackIds.swap(reconstructedTrackIds);
+
+    ALICEVISION_LOG_DEBUG("Update pyramid scoring: " << addedTrackIds.size() << " new tracks, " << removedTrackIds.size() << " removed tracks.");
+}
+
 std::size_t ReconstructionEngine_sequentialSfM::fuseMatchesIntoTracks()
 {
+    ALICEVISION_TRACE_ZONE_CAT("ReconstructionEngine_sequentialSfM::fuseMatchesIntoTracks", "sfm");
+
     // compute tracks from matches
     track::TracksBuilder tracksBuilder;
 
@@ -335,6 +429,8 @@ std::vector<Pair> ReconstructionEngine_sequentialSfM::getInitialImagePairsCandid
 
 void ReconstructionEngine_sequentialSfM::createInitialReconstruction(const std::vector<Pair>& initialImagePairCandidates)
 {
+    ALICEVISION_TRACE_ZONE_CAT("ReconstructionEngine_sequentialSfM::createInitialReconstruction", "sfm");
+
     // initial pair Essential Matrix and [R|t] estimation.
     for (const auto& initialPairCandidate : initialImagePairCandidates)
     {
@@ -425,15 +521,22 @@ void ReconstructionEngine_sequentialSfM::remapLandmarkIdsToTrackIds()
     for (const auto& landmarkPair : landmarks)
     {
         const IndexT landmarkId = landmarkPair.first;
-        const IndexT firstViewId = landmarkPair.second.getObservations().begin()->first;
-        const IndexT firstFeatureId = landmarkPair.second.getObservations().begin()->second.getFeatureId();
         const feature::EImageDescriberType descType = landmarkPair.second.descType;
 
-        obsToLandmark.emplace(ObsKey(firstViewId, firstFeatureId, descType), landmarkId);
+        // with an incremental update, the tracks may not contain the first observation of the landmarks
+        for (const auto& observationPair : landmarkPair.second.getObservations())
+        {
+            obsToLandmark.emplace(ObsKey(observationPair.first, observationPair.second.getFeatureId(), descType), landmarkId);
+            if (!_params.incrementalUpdate)
+                break;
+        }
     }
 
     ALICEVISION_LOG_DEBUG("Find corresponding landmark id per track id");
 
+    // landmarks already assigned to a track
+    std::set<IndexT> remappedLandmarks;
+
     // find corresponding landmark id per track id
     for (const auto& trackPair : _map_tracks)
     {
@@ -444,7 +547,7 @@ void ReconstructionEngine_sequentialSfM::remapLandmarkIdsToTrackIds()
         {
             const ObsToLandmark::const_iterator it = obsToLandmark.find(ObsKey(featView.first, featView.second.featureId, track.descType));
 
-            if (it != obsToLandmark.end())
+            if (it != obsToLandmark.end() && remappedLandmarks.insert(it->second).second)
             {
                 // re-insert the landmark with the new id
                 _sfmData.getLandmarks().emplace(trackId, landmarks.find(it->second)->second);
@@ -453,14 +556,34 @@ void ReconstructionEngine_sequentialSfM::remapLandmarkIdsToTrackIds()
         }
     }
 
+    std::size_t nbUntrackedLandmarks = 0;
+
+    if (_params.incrementalUpdate)
+    {
+        // keep the landmarks of the reconstructed views not covered by the tracks, with ids that cannot be track ids
+        IndexT landmarkId = _map_tracks.empty() ? 0 : _map_tracks.rbegin()->first + 1;
+
+        for (auto& landmarkPair : landmarks)
+        {
+            if (remappedLandmarks.count(landmarkPair.first))
+                continue;
+
+            _sfmData.getLandmarks().emplace(landmarkId++, std::move(landmarkPair.second));
+            ++nbUntrackedLandmarks;
+        }
+    }
+
     ALICEVISION_LOG_INFO("Landmark ids to track ids remapping: " << std::endl
                                                                  << "\t- # tracks: " << _map_tracks.size() << std::endl
                                                                  << "\t- # input landmarks: " << landmarks.size() << std::endl
-                                                                 << "\t- # output landmarks: " << _sfmData.getLandmarks().size());
+                                                                 << "\t- # output landmarks: " << _sfmData.getLandmarks().size() << std::endl
+                                                                 << "\t- # landmarks kept without track: " << nbUntrackedLandmarks);
 }
 
 double ReconstructionEngine_sequentialSfM::incrementalReconstruction()
 {
+    ALICEVISION_TRACE_ZONE_CAT("ReconstructionEngine_sequentialSfM::incrementalReconstruction", "sfm");
+
     // to be visited views
     std::set<IndexT> viewsToVisit;
 
@@ -637,15 +760,86 @@ std::set<IndexT> ReconstructionEngine_sequentialSfM::resection(IndexT resectionI
                                                                const std::vector<IndexT>& bestViewIds,
                                                                const std::set<IndexT>& prevReconstructedViews)
 {
+    ALICEVISION_TRACE_ZONE_CAT("ReconstructionEngine_sequentialSfM::resection", "sfm");
+
     auto chrono_start = std::chrono::steady_clock::now();
 
-    // add images to the 3D reconstruction
-#pragma omp parallel for
-    for (int i = 0; i < bestViewIds.size(); ++i)
+    // sorted ids of the reconstructed tracks, shared by all the resections
+    std::vector<std::size_t> reconstructedTrackIds;
+    reconstructedTrackIds.reserve(_sfmData.getLandmarks().size());
+    std::transform(_sfmData.getLandmarks().begin(),
+                   _sfmData.getLandmarks().end(),
+                   std::back_inserter(reconstructedTrackIds),
+                   stl::RetrieveKey());
+
+    // one seed per view to get the same results whatever the number of threads
+    std::vector<std::mt19937::result_type> seeds(bestViewIds.size());
+    for (auto& seed : seeds)
+        seed = _randomNumberGenerator();
+
+    std::vector<ResectionData> resectionDataPerView(bestViewIds.size());
+    std::vector<char> hasResectedPerView(bestViewIds.size(), 0);
+
+    // the views of a same rig frame, with known sub-poses and an unknown rig pose, are resected together
+    std::vector<std::vector<std::size_t>> rigFrames;
+    std::vector<int> rigFramePerView(bestViewIds.size(), -1);
+    if (_params.rig.useRigConstraint && !_sfmData.getRigs().empty())
     {
+        std::map<IndexT, std::vector<std::size_t>> viewIndexesPerPoseId;
+        for (std::size_t i = 0; i < bestViewIds.size(); ++i)
+        {
+            const View& view = *_sfmData.getViews().at(bestViewIds[i]);
+            if (view.isPoseIndependant() || _sfmData.existsPose(view) || !_sfmData.getRig(view).isInitialized() ||
+                _sfmData.getRig(view).getSubPose(view.getSubPoseId()).status == ERigSubPoseStatus::UNINITIALIZED)
+                continue;
+
+            viewIndexesPerPoseId[view.getPoseId()].push_back(i);
+        }
+
+        for (const auto& framePair : viewIndexesPerPoseId)
+        {
+            if (framePair.second.size() < 2)
+                continue;
+
+            for (std::size_t i : framePair.second)
+                rigFramePerView[i] = static_cast<int>(rigFrames.size());
+            rigFrames.push_back(framePair.second);
+        }
+
+        if (!rigFrames.empty())
+            ALICEVISION_LOG_DEBUG("Resection of " << rigFrames.size() << " rig frames with known sub-poses.");
+    }
+
+    // compute the resection of each view independently, one task per view or per rig frame,
+    // the scene is not modified during this step
+    system::parallelFor(0, static_cast<std::ptrdiff_t>(bestViewIds.size()), 1, [&](std::ptrdiff_t i) {
         const IndexT viewId = bestViewIds.at(i);
         const View& view = *_sfmData.getViews().at(viewId);
 
+        if (rigFramePerView[i] >= 0)
+        {
+            // the frame is resected by the task of its first view
+            const std::vector<std::size_t>& frame = rigFrames[rigFramePerView[i]];
+            if (frame.front() != static_cast<std::size_t>(i))
+                return;
+
+            std::vector<IndexT> frameViewIds;
+            for (std::size_t frameIndex : frame)
+                frameViewIds.push_back(bestViewIds[frameIndex]);
+
+            std::vector<ResectionData> frameResectionData;
+            std::vector<char> frameHasResected;
+            std::mt19937 randomNumberGenerator(seeds[i]);
+            computeRigFrameResection(frameViewIds, reconstructedTrackIds, randomNumberGenerator, frameResectionData, frameHasResected);
+
+            for (std::size_t k = 0; k < frame.size(); ++k)
+            {
+                resectionDataPerView[frame[k]] = std::move(frameResectionData[k]);
+                hasResectedPerView[frame[k]] = frameHasResected[k];
+            }
+            return;
+        }
+
         if (view.isPartOfRig())
         {
             // some views can become indirectly localized when the sub-pose becomes defined
@@ -657,7 +851,7 @@ std::set<IndexT> ReconstructionEngine_sequentialSfM::resection(IndexT resectionI
                                                             << "\t- rig id: " << view.getRigId() << std::endl
                                                             << "\t- sub-pose id: " << view.getSubPoseId());
 
-                continue;
+                return;
             }
 
             // we cannot localize a view if it is part of an initialized rig with unknown rig pose and unknown sub-pose
@@ -673,28 +867,41 @@ std::set<IndexT> ReconstructionEngine_sequentialSfM::resection(IndexT resectionI
                                                             << "\t- rig id: " << view.getRigId() << std::endl
                                                             << "\t- sub-pose id: " << view.getSubPoseId());
 
-                continue;
+                return;
             }
         }
 
-        ResectionData newResectionData;
+        ResectionData& newResectionData = resectionDataPerView[i];
         newResectionData.error_max = _params.localizerEstimatorError;
         newResectionData.max_iteration = _params.localizerEstimatorMaxIterations;
-        const bool hasResected = computeResection(viewId, newResectionData);
 
-#pragma omp critical
+        std::mt19937 randomNumberGenerator(seeds[i]);
+        hasResectedPerView[i] = computeResection(viewId, reconstructedTrackIds, randomNumberGenerator, newResectionData);
+    });
+
+    // add the resected views to the 3D reconstruction
+    for (int i = 0; i < bestViewIds.size(); ++i)
+    {
+        const IndexT viewId = bestViewIds.at(i);
+        const View& view = *_sfmData.getViews().at(viewId);
+
+        if (!hasResectedPerView[i])
         {
-            if (hasResected)
-            {
-                updateScene(viewId, newResectionData);
-                ALICEVISION_LOG_DEBUG("Resection of image " << i << " ( view id: " << viewId << " ) succeed.");
-                _sfmData.getViews().at(viewId)->setResectionId(resectionId);
-            }
-            else
-            {
-                ALICEVISION_LOG_DEBUG("Resection of image " << i << " ( view id: " << viewId << " ) was not possible.");
-            }
+            ALICEVISION_LOG_DEBUG("Resection of image " << i << " ( view id: " << viewId << " ) was not possible.");
+            continue;
+        }
+
+        // the view may have been indirectly localized by a previous view of the same rig,
+        // unless its observations have been checked against the rig pose of its frame
+        if (view.isPartOfRig() && _sfmData.isPoseAndIntrinsicDefined(viewId) && rigFramePerView[i] < 0)
+        {
+            ALICEVISION_LOG_DEBUG("Resection of image " << i << " ( view id: " << viewId << " ) was skipped, view indirectly localized.");
+            continue;
         }
+
+        updateScene(viewId, resectionDataPerView[i]);
+        ALICEVISION_LOG_DEBUG("Resection of image " << i << " ( view id: " << viewId << " ) succeed.");
+        _sfmData.getViews().at(viewId)->setResectionId(resectionId);
     }
 
     ALICEVISION_LOG_DEBUG(
@@ -719,6 +926,8 @@ std::set<IndexT> ReconstructionEngine_sequentialSfM::resection(IndexT resectionI
 
 void ReconstructionEngine_sequentialSfM::triangulate(const std::set<IndexT>& prevReconstructedViews, const std::set<IndexT>& newReconstructedViews)
 {
+    ALICEVISION_TRACE_ZONE_CAT("ReconstructionEngine_sequentialSfM::triangulate", "sfm");
+
     auto chrono_start = std::chrono::steady_clock::now();
 
     // allow to use to the old triangulatation algorithm (using 2 views only)
@@ -735,6 +944,9 @@ void ReconstructionEngine_sequentialSfM::triangulate(const std::set<IndexT>& pre
 
 bool ReconstructionEngine_sequentialSfM::bundleAdjustment(std::set<IndexT>& newReconstructedViews, bool isInitialPair)
 {
+    ALICEVISION_TRACE_ZONE_CAT("ReconstructionEngine_sequentialSfM::bundleAdjustment", "sfm");
+    ALICEVISION_RESOURCE_PHASE("ReconstructionEngine_sequentialSfM::bundleAdjustment");
+
     ALICEVISION_LOG_INFO("Bundle adjustment start.");
     auto chronoStart = std::chrono::steady_clock::now();
 
@@ -749,6 +961,8 @@ bool ReconstructionEngine_sequentialSfM::bundleAdjustment(std::set<IndexT>& newR
     std::size_t iteration = 0;
     std::size_t nbOutliers = 0;
     bool enableLocalStrategy = false;
+    // number of poses in the solver (refined or constant)
+    std::size_t nbPosesInSolver = _sfmData.getPoses().size();
 
     // enable Sparse solver and local strategy
     if (_sfmData.getPoses().size() > 100)
@@ -791,8 +1005,17 @@ bool ReconstructionEngine_sequentialSfM::bundleAdjustment(std::set<IndexT>& newR
                                  " (nbRefinedPoses: "
                                  << nbRefinedPoses << ", newReconstructedViews.size(): " << newReconstructedViews.size() << ").");
         }
+
+        nbPosesInSolver = nbRefinedPoses + nbConstantPoses;
     }
 
+    // large problems: avoid the factorization of the reduced camera system
+    if (_params.bundleAdjustmentIterativeMinNbCameras > 0 && nbPosesInSolver >= _params.bundleAdjustmentIterativeMinNbCameras)
+        options.setIterativeBA();
+
+    options.useCuda = _params.bundleAdjustmentUseCuda;
+    options.useAnalyticJacobians = _params.bundleAdjustmentAnalyticJacobians;
+
     BundleAdjustmentCeres BA(options, _params.minNbCamerasToRefinePrincipalPoint);
 
     // give the local strategy graph is local strategy is enable
@@ -996,21 +1219,16 @@ bool ReconstructionEngine_sequentialSfM::findConnectedViews(std::vector<ViewConn
     if (remainingViewIds.empty() || _sfmData.getLandmarks().empty())
         return false;
 
-    // Collect tracksIds
-    std::set<size_t> reconstructed_trackId;
-    std::transform(_sfmData.getLandmarks().begin(),
-                   _sfmData.getLandmarks().end(),
-                   std::inserter(reconstructed_trackId, reconstructed_trackId.begin()),
-                   stl::RetrieveKey());
-
     const std::set<IndexT> reconstructedIntrinsics = _sfmData.getReconstructedIntrinsics();
 
-#pragma omp parallel for
-    for (int i = 0; i < remainingViewIds.size(); ++i)
+    const std::vector<IndexT> remainingViewIdsVec(remainingViewIds.begin(), remainingViewIds.end());
+    std::vector<ViewConnectionScore> connectedViews(remainingViewIdsVec.size());
+    std::vector<char> isConnected(remainingViewIdsVec.size(), 0);
+
+#pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < remainingViewIdsVec.size(); ++i)
     {
-        std::set<IndexT>::const_iterator iter = remainingViewIds.cbegin();
-        std::advance(iter, i);
-        const IndexT viewId = *iter;
+        const IndexT viewId = remainingViewIdsVec[i];
         const IndexT intrinsicId = _sfmData.getViews().at(viewId)->getIntrinsicId();
         const bool isIntrinsicsReconstructed = reconstructedIntrinsics.count(intrinsicId);
 
@@ -1043,35 +1261,48 @@ bool ReconstructionEngine_sequentialSfM::findConnectedViews(std::vector<ViewConn
             }
         }
 
-        // Count the common possible putative point
-        //  with the already 3D reconstructed trackId
-        std::vector<std::size_t> vec_trackIdForResection;
-        vec_trackIdForResection.reserve(set_tracksIds.size());
-        std::set_intersection(set_tracksIds.begin(),
-                              set_tracksIds.end(),
-                              reconstructed_trackId.begin(),
-                              reconstructed_trackId.end(),
-                              std::back_inserter(vec_trackIdForResection));
-        // Compute an image score based on the number of matches to the 3D scene
-        // and the repartition of these features in the image.
-        std::size_t score = computeCandidateImageScore(viewId, vec_trackIdForResection);
-#pragma omp critical
+        // Number of common possible putative points with the already 3D reconstructed tracks
+        // and image score based on the repartition of these features in the image,
+        // maintained by updatePyramidScoring.
+        std::size_t nbTracks = 0;
+        std::size_t score = 0;
+        const auto viewScoreIt = _pyramidScorePerView.find(viewId);
+        if (viewScoreIt != _pyramidScorePerView.end())
         {
-            out_connectedViews.emplace_back(viewId, vec_trackIdForResection.size(), score, isIntrinsicsReconstructed);
+            nbTracks = viewScoreIt->second.nbTracks;
+#ifdef ALICEVISION_NEXTBESTVIEW_WITHOUT_SCORE
+            score = nbTracks;
+#else
+            score = viewScoreIt->second.score;
+#endif
         }
+        connectedViews[i] = ViewConnectionScore(viewId, nbTracks, score, isIntrinsicsReconstructed);
+        isConnected[i] = 1;
+    }
+
+    out_connectedViews.reserve(connectedViews.size());
+    for (std::size_t i = 0; i < connectedViews.size(); ++i)
+    {
+        if (isConnected[i])
+            out_connectedViews.push_back(connectedViews[i]);
     }
 
-    // Sort by the image score
+    // Sort by the image score (and view id for a deterministic order)
     std::sort(out_connectedViews.begin(), out_connectedViews.end(), [](const ViewConnectionScore& t1, const ViewConnectionScore& t2) {
-        return std::get<2>(t1) > std::get<2>(t2);
+        if (std::get<2>(t1) != std::get<2>(t2))
+            return std::get<2>(t1) > std::get<2>(t2);
+        return std::get<0>(t1) < std::get<0>(t2);
     });
     return !out_connectedViews.empty();
 }
 
-bool ReconstructionEngine_sequentialSfM::findNextBestViews(std::vector<IndexT>& out_selectedViewIds, const std::set<IndexT>& remainingViewIds) const
+bool ReconstructionEngine_sequentialSfM::findNextBestViews(std::vector<IndexT>& out_selectedViewIds, const std::set<IndexT>& remainingViewIds)
 {
+    ALICEVISION_TRACE_ZONE_CAT("ReconstructionEngine_sequentialSfM::findNextBestViews", "sfm");
+
     out_selectedViewIds.clear();
     auto chrono_start = std::chrono::steady_clock::now();
+    updatePyramidScoring();
     std::vector<ViewConnectionScore> vec_viewsScore;
     if (!findConnectedViews(vec_viewsScore, remainingViewIds))
     {
@@ -1332,6 +1563,8 @@ bool ReconstructionEngine_sequentialSfM::makeInitialPair3D(const Pair& currentPa
 
 bool ReconstructionEngine_sequentialSfM::getBestInitialImagePairs(std::vector<Pair>& out_bestImagePairs, IndexT filterViewId)
 {
+    ALICEVISION_TRACE_ZONE_CAT("ReconstructionEngine_sequentialSfM::getBestInitialImagePairs", "sfm");
+
     // From the k view pairs with the highest number of verified matches
     // select a pair that have the largest baseline (mean angle between its bearing vectors).
 
@@ -1514,15 +1747,32 @@ std::size_t ReconstructionEngine_sequentialSfM::computeCandidateImageScore(Index
     // The number of cells of the pyramid grid represent the score
     // and ensure a proper repartition of features in images.
     const auto& featsPyramid = _map_featsPyramidPerView.at(viewId);
-    for (std::size_t level = 0; level < _params.pyramidDepth; ++level)
+
+    // grid cell indexes in the pyramid per level
+    std::vector<std::vector<std::size_t>> featIndexesPerLevel(_params.pyramidDepth);
+    for (auto& featIndexes : featIndexesPerLevel)
+        featIndexes.reserve(trackIds.size());
+
+    for (IndexT trackId : trackIds)
     {
-        std::set<std::size_t> featIndexes;  // Set of grid cell indexes in the pyramid
-        for (IndexT trackId : trackIds)
+        // the pyramid indexes of all levels of a track are contiguous in the flat map
+        auto it = featsPyramid.find(trackId * _params.pyramidDepth);
+        if (it == featsPyramid.end())
+            throw std::out_of_range("No pyramid index for track " + std::to_string(trackId) + " in view " + std::to_string(viewId));
+
+        for (std::size_t level = 0; level < _params.pyramidDepth; ++level, ++it)
         {
-            std::size_t pyramidIndex = featsPyramid.at(trackId * _params.pyramidDepth + level);
-            featIndexes.insert(pyramidIndex);
+            assert(it->first == trackId * _params.pyramidDepth + level);
+            featIndexesPerLevel[level].push_back(it->second);
         }
-        score += featIndexes.size() * _pyramidWeights[level];
+    }
+
+    for (std::size_t level = 0; level < _params.pyramidDepth; ++level)
+    {
+        std::vector<std::size_t>& featIndexes = featIndexesPerLevel[level];
+        std::sort(featIndexes.begin(), featIndexes.end());
+        const std::size_t nbCells = std::distance(featIndexes.begin(), std::unique(featIndexes.begin(), featIndexes.end()));
+        score += nbCells * _pyramidWeights[level];
     }
     return score;
 #endif
@@ -1539,24 +1789,31 @@ std::size_t ReconstructionEngine_sequentialSfM::computeCandidateImageScore(Index
  * C. Do the resectioning: compute the camera pose.
  * D. Refine the pose of the found camera
  */
-bool ReconstructionEngine_sequentialSfM::computeResection(const IndexT viewId, ResectionData& resectionData)
+bool ReconstructionEngine_sequentialSfM::computeResection(const IndexT viewId,
+                                                          const std::vector<std::size_t>& reconstructedTrackIds,
+                                                          std::mt19937& randomNumberGenerator,
+                                                          ResectionData& resectionData) const
+{
+    if (!computeResectionCorrespondences(viewId, reconstructedTrackIds, resectionData))
+        return false;
+
+    return computeResectionPose(viewId, randomNumberGenerator, resectionData);
+}
+
+bool ReconstructionEngine_sequentialSfM::computeResectionCorrespondences(const IndexT viewId,
+                                                                         const std::vector<std::size_t>& reconstructedTrackIds,
+                                                                         ResectionData& resectionData) const
 {
     // A. Compute 2D/3D matches
     // A1. list tracks ids used by the view
     const aliceVision::track::TrackIdSet& set_tracksIds = _map_tracksPerView.at(viewId);
 
     // A2. intersects the track list with the reconstructed
-    std::set<std::size_t> reconstructed_trackId;
-    std::transform(_sfmData.getLandmarks().begin(),
-                   _sfmData.getLandmarks().end(),
-                   std::inserter(reconstructed_trackId, reconstructed_trackId.begin()),
-                   stl::RetrieveKey());
-
     // Get the ids of the already reconstructed tracks
     std::set_intersection(set_tracksIds.begin(),
                           set_tracksIds.end(),
-                          reconstructed_trackId.begin(),
-                          reconstructed_trackId.end(),
+                          reconstructedTrackIds.begin(),
+                          reconstructedTrackIds.end(),
                           std::inserter(resectionData.tracksId, resectionData.tracksId.begin()));
 
     if (resectionData.tracksId.empty())
@@ -1575,15 +1832,6 @@ bool ReconstructionEngine_sequentialSfM::computeResection(const IndexT viewId, R
     resectionData.pt3D.resize(3, resectionData.tracksId.size());
     resectionData.vec_descType.resize(resectionData.tracksId.size());
 
-    // B. Look if intrinsic data is known or not
-    std::shared_ptr<View> view_I = _sfmData.getViews().at(viewId);
-    std::shared_ptr<camera::IntrinsicBase> intrinsics = _sfmData.getIntrinsicSharedPtr(view_I->getIntrinsicId());
-    if (intrinsics == nullptr)
-    {
-        throw std::runtime_error("Intrinsic " + std::to_string(view_I->getIntrinsicId()) +
-                                 " is not initialized, all intrinsics should be initialized");
-    }
-
     std::size_t cpt = 0;
     std::set<std::size_t>::const_iterator iterTrackId = resectionData.tracksId.begin();
     for (std::vector<track::FeatureId>::const_iterator iterfeatId = resectionData.featuresId.begin(); iterfeatId != resectionData.featuresId.end();
@@ -1594,13 +1842,28 @@ bool ReconstructionEngine_sequentialSfM::computeResection(const IndexT viewId, R
         resectionData.pt2D.col(cpt) = _featuresPerView->getFeatures(viewId, descType)[iterfeatId->second].coords().cast<double>();
         resectionData.vec_descType.at(cpt) = descType;
     }
+    return true;
+}
+
+bool ReconstructionEngine_sequentialSfM::computeResectionPose(const IndexT viewId,
+                                                              std::mt19937& randomNumberGenerator,
+                                                              ResectionData& resectionData) const
+{
+    // B. Look if intrinsic data is known or not
+    std::shared_ptr<View> view_I = _sfmData.getViews().at(viewId);
+    std::shared_ptr<camera::IntrinsicBase> intrinsics = _sfmData.getIntrinsicSharedPtr(view_I->getIntrinsicId());
+    if (intrinsics == nullptr)
+    {
+        throw std::runtime_error("Intrinsic " + std::to_string(view_I->getIntrinsicId()) +
+                                 " is not initialized, all intrinsics should be initialized");
+    }
 
     // C. Do the resectioning: compute the camera pose.
     ALICEVISION_LOG_INFO("[" << _sfmData.getValidViews().size() + 1 << "/" << _sfmData.getViews().size() << "] Robust Resection of view: " << viewId);
 
     const bool bResection = sfm::SfMLocalizer::localize(Pair(view_I->getImage().getWidth(), view_I->getImage().getHeight()),
                                                         intrinsics.get(),
-                                                        _randomNumberGenerator,
+                                                        randomNumberGenerator,
                                                         resectionData,
                                                         resectionData.pose,
                                                         _params.localizerEstimator);
@@ -1608,11 +1871,10 @@ bool ReconstructionEngine_sequentialSfM::computeResection(const IndexT viewId, R
     if (!_htmlLogFile.empty())
     {
         using namespace htmlDocument;
-        std::ostringstream os;
-        os << "Robust resection of view " << viewId << ": <br>";
-        _htmlDocStream->pushInfo(htmlMarkup("h4", os.str()));
+        std::ostringstream osTitle;
+        osTitle << "Robust resection of view " << viewId << ": <br>";
 
-        os.str("");
+        std::ostringstream os;
         os << std::endl
            << "- Image path: " << view_I->getImage().getImagePath() << "<br>"
            << "- Threshold (error max): " << resectionData.error_max << "<br>"
@@ -1621,7 +1883,12 @@ bool ReconstructionEngine_sequentialSfM::computeResection(const IndexT viewId, R
            << "- # points validated by robust estimation: " << resectionData.vec_inliers.size() << "<br>"
            << "- % points validated: " << resectionData.vec_inliers.size() / static_cast<float>(resectionData.featuresId.size()) << "<br>";
 
-        _htmlDocStream->pushInfo(os.str());
+        // views can be resected in parallel
+#pragma omp critical(htmlLog)
+        {
+            _htmlDocStream->pushInfo(htmlMarkup("h4", osTitle.str()));
+            _htmlDocStream->pushInfo(os.str());
+        }
     }
 
     if (!bResection)
@@ -1637,7 +1904,13 @@ bool ReconstructionEngine_sequentialSfM::computeResection(const IndexT viewId, R
         // If we use a camera intrinsic for the first time we need to refine it.
         const bool intrinsicsFirstUsage = (reconstructedIntrinsics.count(view_I->getIntrinsicId()) == 0);
 
-        if (!sfm::SfMLocalizer::refinePose(intrinsics.get(), resectionData.pose, resectionData, true, intrinsicsFirstUsage))
+        // the intrinsic may be shared by other views resected in parallel, so a copy is refined
+        // and it will be applied to the scene in updateScene
+        if (intrinsicsFirstUsage)
+            resectionData.refinedIntrinsics.reset(intrinsics->clone());
+
+        camera::IntrinsicBase* intrinsicsToRefine = intrinsicsFirstUsage ? resectionData.refinedIntrinsics.get() : intrinsics.get();
+        if (!sfm::SfMLocalizer::refinePose(intrinsicsToRefine, resectionData.pose, resectionData, true, intrinsicsFirstUsage))
         {
             ALICEVISION_LOG_INFO("Resection of view " << viewId << " failed during pose refinement.");
             return false;
@@ -1646,6 +1919,87 @@ bool ReconstructionEngine_sequentialSfM::computeResection(const IndexT viewId, R
     return true;
 }
 
+void ReconstructionEngine_sequentialSfM::computeRigFrameResection(const std::vector<IndexT>& viewIds,
+                                                                  const std::vector<std::size_t>& reconstructedTrackIds,
+                                                                  std::mt19937& randomNumberGenerator,
+                                                                  std::vector<ResectionData>& resectionDataPerView,
+                                                                  std::vector<char>& hasResectedPerView) const
+{
+    resectionDataPerView.assign(viewIds.size(), ResectionData());
+    hasResectedPerView.assign(viewIds.size(), 0);
+
+    std::vector<std::size_t> resectionOrder;
+    for (std::size_t i = 0; i < viewIds.size(); ++i)
+    {
+        ResectionData& resectionData = resectionDataPerView[i];
+        resectionData.error_max = _params.localizerEstimatorError;
+        resectionData.max_iteration = _params.localizerEstimatorMaxIterations;
+
+        if (computeResectionCorrespondences(viewIds[i], reconstructedTrackIds, resectionData))
+            resectionOrder.push_back(i);
+    }
+
+    // the best connected view gives the rig pose, the next ones are only tried if it fails
+    std::stable_sort(resectionOrder.begin(), resectionOrder.end(), [&](std::size_t a, std::size_t b) {
+        return resectionDataPerView[a].tracksId.size() > resectionDataPerView[b].tracksId.size();
+    });
+
+    std::size_t resectedIndex = viewIds.size();
+    for (std::size_t i : resectionOrder)
+    {
+        if (computeResectionPose(viewIds[i], randomNumberGenerator, resectionDataPerView[i]))
+        {
+            resectedIndex = i;
+            break;
+        }
+    }
+
+    if (resectedIndex == viewIds.size())
+        return;
+
+    const ResectionData& resectedData = resectionDataPerView[resectedIndex];
+    const View& resectedView = *_sfmData.getViews().at(viewIds[resectedIndex]);
+    const geometry::Pose3 rigPose = _sfmData.getRig(resectedView).getSubPose(resectedView.getSubPoseId()).pose.inverse() * resectedData.pose;
+
+    hasResectedPerView[resectedIndex] = 1;
+
+    // the other views of the frame follow the rig pose, with the threshold found by the resection
+    for (std::size_t i : resectionOrder)
+    {
+        if (i == resectedIndex)
+            continue;
+
+        const View& view = *_sfmData.getViews().at(viewIds[i]);
+        ResectionData& resectionData = resectionDataPerView[i];
+
+        // the intrinsic refined by the resection is shared, whatever the view of the frame updating the scene first
+        if (resectedData.refinedIntrinsics && view.getIntrinsicId() == resectedView.getIntrinsicId())
+            resectionData.refinedIntrinsics = resectedData.refinedIntrinsics;
+
+        const camera::IntrinsicBase* intrinsics =
+          resectionData.refinedIntrinsics ? resectionData.refinedIntrinsics.get() : _sfmData.getIntrinsicPtr(view.getIntrinsicId());
+        if (intrinsics == nullptr)
+            continue;
+
+        resectionData.pose = _sfmData.getRig(view).getSubPose(view.getSubPoseId()).pose * rigPose;
+        resectionData.error_max = resectedData.error_max;
+
+        for (std::size_t j = 0; j < resectionData.pt2D.cols(); ++j)
+        {
+            const Vec3 X = resectionData.pt3D.col(j);
+            const Vec2 residual = intrinsics->residual(resectionData.pose, X.homogeneous(), resectionData.pt2D.col(j));
+            if (residual.norm() < resectionData.error_max && resectionData.pose.depth(X) > 0)
+                resectionData.vec_inliers.push_back(j);
+        }
+
+        ALICEVISION_LOG_DEBUG("Rig frame resection of view " << viewIds[i] << " from view " << viewIds[resectedIndex] << ": "
+                                                             << resectionData.vec_inliers.size() << "/" << resectionData.pt2D.cols()
+                                                             << " consistent associations.");
+
+        hasResectedPerView[i] = 1;
+    }
+}
+
 void ReconstructionEngine_sequentialSfM::updateScene(const IndexT viewIndex, const ResectionData& resectionData)
 {
     // A. Update the global scene with the new found camera pose, intrinsic (if not defined)
@@ -1654,10 +2008,14 @@ void ReconstructionEngine_sequentialSfM::updateScene(const IndexT viewIndex, con
     _map_ACThreshold.insert(std::make_pair(viewIndex, resectionData.error_max));
 
     const View& view = *_sfmData.getViews().at(viewIndex);
-    _sfmData.setPose(view, CameraPose(resectionData.pose));
-
     std::shared_ptr<camera::IntrinsicBase> intrinsics = _sfmData.getIntrinsicSharedPtr(view.getIntrinsicId());
 
+    // update the intrinsic refined during the resection, unless another view has already initialized it
+    if (resectionData.refinedIntrinsics && _sfmData.getReconstructedIntrinsics().count(view.getIntrinsicId()) == 0)
+        intrinsics->assign(*resectionData.refinedIntrinsics);
+
+    _sfmData.setPose(view, CameraPose(resectionData.pose));
+
     // B. Update the observations into the global scene structure
     // - Add the new 2D observations to the reconstructed tracks
     std::set<std::size_t>::const_iterator iterTrackId = resectionData.tracksId.begin();
@@ -1715,83 +2073,101 @@ void ReconstructionEngine_sequentialSfM::getTracksToTriangulate(const std::set<I
                                                                 const std::set<IndexT>& newReconstructedViews,
                                                                 std::map<IndexT, std::set<IndexT>>& mapTracksToTriangulate) const
 {
-    std::set<IndexT> allReconstructedViews;
-    allReconstructedViews.insert(previousReconstructedViews.begin(), previousReconstructedViews.end());
-    allReconstructedViews.insert(newReconstructedViews.begin(), newReconstructedViews.end());
+    std::vector<IndexT> allReconstructedViews;
+    allReconstructedViews.reserve(previousReconstructedViews.size() + newReconstructedViews.size());
+    std::set_union(previousReconstructedViews.begin(),
+                   previousReconstructedViews.end(),
+                   newReconstructedViews.begin(),
+                   newReconstructedViews.end(),
+                   std::back_inserter(allReconstructedViews));
+
+    std::set<IndexT> allTracksInNewViewsSet;
+    track::getTracksInImagesFast(newReconstructedViews, _map_tracksPerView, allTracksInNewViewsSet);
+    const std::vector<IndexT> allTracksInNewViews(allTracksInNewViewsSet.begin(), allTracksInNewViewsSet.end());
 
-    std::set<IndexT> allTracksInNewViews;
-    track::getTracksInImagesFast(newReconstructedViews, _map_tracksPerView, allTracksInNewViews);
+    // one result slot per track, merged in the output map afterwards to avoid a critical section per track
+    std::vector<std::vector<IndexT>> reconstructedViewsPerTrack(allTracksInNewViews.size());
 
-    std::set<IndexT>::iterator it;
-#pragma omp parallel private(it)
+#pragma omp parallel for schedule(dynamic, 256)
+    for (int i = 0; i < allTracksInNewViews.size(); ++i)
     {
-        for (it = allTracksInNewViews.begin(); it != allTracksInNewViews.end(); ++it)
-        {
-#pragma omp single nowait
-            {
-                const std::size_t trackId = *it;
+        const std::size_t trackId = allTracksInNewViews[i];
 
-                const track::Track& track = _map_tracks.at(trackId);
+        const track::Track& track = _map_tracks.at(trackId);
 
-                std::set<IndexT> allViewsSharingTheTrack;
-                std::transform(track.featPerView.begin(),
-                               track.featPerView.end(),
-                               std::inserter(allViewsSharingTheTrack, allViewsSharingTheTrack.begin()),
-                               stl::RetrieveKey());
+        // featPerView is a sorted flat map: intersect its keys directly with the reconstructed views
+        std::vector<IndexT>& allReconstructedViewsSharingTheTrack = reconstructedViewsPerTrack[i];
+        allReconstructedViewsSharingTheTrack.reserve(track.featPerView.size());
+        auto viewIt = allReconstructedViews.begin();
+        for (const auto& featPerView : track.featPerView)
+        {
+            viewIt = std::lower_bound(viewIt, allReconstructedViews.end(), featPerView.first);
+            if (viewIt == allReconstructedViews.end())
+                break;
+            if (*viewIt == featPerView.first)
+                allReconstructedViewsSharingTheTrack.push_back(featPerView.first);
+        }
 
-                std::set<IndexT> allReconstructedViewsSharingTheTrack;
-                std::set_intersection(allViewsSharingTheTrack.begin(),
-                                      allViewsSharingTheTrack.end(),
-                                      allReconstructedViews.begin(),
-                                      allReconstructedViews.end(),
-                                      std::inserter(allReconstructedViewsSharingTheTrack, allReconstructedViewsSharingTheTrack.begin()));
+    }
 
-                if (allReconstructedViewsSharingTheTrack.size() >= _params.minNbObservationsForTriangulation)
-                {
-#pragma omp critical
-                    mapTracksToTriangulate[trackId] = allReconstructedViewsSharingTheTrack;
-                }
-            }
+    // the tracks are sorted by id: insert them at the end of the map
+    for (std::size_t i = 0; i < allTracksInNewViews.size(); ++i)
+    {
+        const std::vector<IndexT>& allReconstructedViewsSharingTheTrack = reconstructedViewsPerTrack[i];
+        if (allReconstructedViewsSharingTheTrack.size() >= _params.minNbObservationsForTriangulation)
+        {
+            mapTracksToTriangulate.emplace_hint(mapTracksToTriangulate.end(),
+                                                allTracksInNewViews[i],
+                                                std::set<IndexT>(allReconstructedViewsSharingTheTrack.begin(), allReconstructedViewsSharingTheTrack.end()));
         }
     }
 }
 
 namespace {
 
-struct ObservationData
+/// Camera data of a reconstructed view, shared by all the tracks triangulated in this view
+struct ViewTriangulationData
 {
-    std::shared_ptr<camera::Pinhole> cam;
+    const camera::Pinhole* cam = nullptr;
     Pose3 pose;
     Mat34 P;
+};
+
+struct ObservationData
+{
+    const camera::Pinhole* cam;
+    const Pose3* pose;
+    const Mat34* P;
     Vec2 x;
     Vec2 xUd;
 
     bool isEmpty() const { return cam == nullptr; }
 };
 
-ObservationData getObservationData(const SfMData& scene, feature::FeaturesPerView* featuresPerView, IndexT viewId, const track::Track& track)
+ObservationData getObservationData(const std::map<IndexT, ViewTriangulationData>& viewsData,
+                                   feature::FeaturesPerView* featuresPerView,
+                                   IndexT viewId,
+                                   const track::Track& track)
 {
-    const View* view = scene.getViews().at(viewId).get();
-
-    std::shared_ptr<camera::IntrinsicBase> cam = scene.getIntrinsics().at(view->getIntrinsicId());
-    std::shared_ptr<camera::Pinhole> camPinHole = std::dynamic_pointer_cast<camera::Pinhole>(cam);
-
-    if (!camPinHole)
-    {
-        ALICEVISION_LOG_ERROR("Camera is not pinhole in triangulateMultiViewsLORANSAC");
-        return {nullptr, {}, {}, {}, {}};
-    }
-
-    Pose3 pose = scene.getPose(*view).getTransform();
-    Mat34 P = camPinHole->getProjectiveEquivalent(pose);
+    const ViewTriangulationData& viewData = viewsData.at(viewId);
+    if (viewData.cam == nullptr)
+        return {nullptr, nullptr, nullptr, {}, {}};
 
     const auto& feature = featuresPerView->getFeatures(viewId, track.descType)[track.featPerView.at(viewId).featureId];
-    Vec2 x = feature.coords().cast<double>();
-    Vec2 xUd = cam->getUndistortedPixel(x);  // undistorted 2D point
+    const Vec2 x = feature.coords().cast<double>();
+    const Vec2 xUd = viewData.cam->getUndistortedPixel(x);  // undistorted 2D point
 
-    return {camPinHole, pose, P, x, xUd};
+    return {viewData.cam, &viewData.pose, &viewData.P, x, xUd};
 }
 
+/// Result of the triangulation of a track
+enum class ETrackTriangulation : unsigned char
+{
+    SKIPPED = 0,  //< not enough observations, the scene is left untouched
+    VALID,        //< the landmark is added to the scene (or replaced)
+    INVALID       //< the landmark is removed from the scene
+};
+
 }  // namespace
 
 void ReconstructionEngine_sequentialSfM::triangulateMultiViewsLORANSAC(SfMData& scene,
@@ -1809,13 +2185,42 @@ void ReconstructionEngine_sequentialSfM::triangulateMultiViewsLORANSAC(SfMData&
     std::vector<IndexT> setTracksId;  // <trackId>
     std::transform(mapTracksToTriangulate.begin(), mapTracksToTriangulate.end(), std::inserter(setTracksId, setTracksId.begin()), stl::RetrieveKey());
 
-#pragma omp parallel for
+    // -- Prepare the camera data of each reconstructed view once for all the tracks
+    std::map<IndexT, ViewTriangulationData> viewsData;
+    for (const std::set<IndexT>* views : {&previousReconstructedViews, &newReconstructedViews})
+    {
+        for (const IndexT viewId : *views)
+        {
+            const View& view = *scene.getViews().at(viewId);
+            ViewTriangulationData& viewData = viewsData[viewId];
+
+            viewData.cam = dynamic_cast<const camera::Pinhole*>(scene.getIntrinsics().at(view.getIntrinsicId()).get());
+            if (viewData.cam == nullptr)
+            {
+                ALICEVISION_LOG_ERROR("Camera is not pinhole in triangulateMultiViewsLORANSAC");
+                continue;
+            }
+            viewData.pose = scene.getPose(view).getTransform();
+            viewData.P = viewData.cam->getProjectiveEquivalent(viewData.pose);
+        }
+    }
+
+    // -- One random generator per thread, seeded from the engine generator
+    std::vector<std::mt19937> randomNumberGenerators;
+    for (int i = 0; i < omp_get_max_threads(); ++i)
+        randomNumberGenerators.emplace_back(_randomNumberGenerator());
+
+    // -- Triangulate each track in its own result slot, without touching the scene
+    std::vector<ETrackTriangulation> triangulationPerTrack(setTracksId.size(), ETrackTriangulation::SKIPPED);
+    std::vector<Landmark> landmarkPerTrack(setTracksId.size());
+
+#pragma omp parallel for schedule(dynamic, 64)
     for (int i = 0; i < setTracksId.size(); i++)  // each track (already reconstructed or not)
     {
         const IndexT trackId = setTracksId.at(i);
         bool isValidTrack = true;
         const track::Track& track = _map_tracks.at(trackId);
-        std::set<IndexT>& observations = mapTracksToTriangulate.at(trackId);  // all the posed views possessing the track
+        const std::set<IndexT>& observations = mapTracksToTriangulate.at(trackId);  // all the posed views possessing the track
 
         // The track needs to be seen by a min. number of views to be triangulated
         if (observations.size() < _params.minNbObservationsForTriangulation)
@@ -1836,8 +2241,8 @@ void ReconstructionEngine_sequentialSfM::triangulateMultiViewsLORANSAC(SfMData&
             IndexT I = *(observations.begin());
             IndexT J = *(observations.rbegin());
 
-            const auto oi = getObservationData(scene, _featuresPerView, I, track);
-            const auto oj = getObservationData(scene, _featuresPerView, J, track);
+            const auto oi = getObservationData(viewsData, _featuresPerView, I, track);
+            const auto oj = getObservationData(viewsData, _featuresPerView, J, track);
 
             if (oi.isEmpty() || oj.isEmpty())
             {
@@ -1845,7 +2250,7 @@ void ReconstructionEngine_sequentialSfM::triangulateMultiViewsLORANSAC(SfMData&
             }
 
             // -- Triangulate:
-            multiview::TriangulateDLT(oi.P, oi.xUd, oj.P, oj.xUd, X_euclidean);
+            multiview::TriangulateDLT(*oi.P, oi.xUd, *oj.P, oj.xUd, X_euclidean);
 
             // -- Check:
             //  - angle (small angle leads imprecise triangulation)
@@ -1857,10 +2262,10 @@ void ReconstructionEngine_sequentialSfM::triangulateMultiViewsLORANSAC(SfMData&
             const double& acThresholdI = (acThresholdItI != _map_ACThreshold.end()) ? acThresholdItI->second : 4.0;
             const double& acThresholdJ = (acThresholdItJ != _map_ACThreshold.end()) ? acThresholdItJ->second : 4.0;
 
-            if (angleBetweenRays(oi.pose, oi.cam.get(), oj.pose, oj.cam.get(), oi.x, oj.x) < _params.minAngleForTriangulation ||
-                oi.pose.depth(X_euclidean) < 0 || oj.pose.depth(X_euclidean) < 0 ||
-                oi.cam->residual(oi.pose, X_euclidean.homogeneous(), oi.x).norm() > acThresholdI ||
-                oj.cam->residual(oj.pose, X_euclidean.homogeneous(), oj.x).norm() > acThresholdJ)
+            if (angleBetweenRays(*oi.pose, oi.cam, *oj.pose, oj.cam, oi.x, oj.x) < _params.minAngleForTriangulation ||
+                oi.pose->depth(X_euclidean) < 0 || oj.pose->depth(X_euclidean) < 0 ||
+                oi.cam->residual(*oi.pose, X_euclidean.homogeneous(), oi.x).norm() > acThresholdI ||
+                oj.cam->residual(*oj.pose, X_euclidean.homogeneous(), oj.x).norm() > acThresholdJ)
                 isValidTrack = false;
         }
         else
@@ -1872,30 +2277,26 @@ void ReconstructionEngine_sequentialSfM::triangulateMultiViewsLORANSAC(SfMData&
             // -- Prepare:
             std::vector<Vec2> features;  // undistorted 2D features (one per pose)
             std::vector<Mat34> Ps;       // projective matrices (one per pose)
+            features.reserve(observations.size());
+            Ps.reserve(observations.size());
+            for (const IndexT& viewId : observations)
             {
-                const track::Track& track = _map_tracks.at(trackId);
+                const auto o = getObservationData(viewsData, _featuresPerView, viewId, track);
 
-                int i = 0;
-                for (const IndexT& viewId : observations)
+                if (o.isEmpty())
                 {
-                    const auto o = getObservationData(scene, _featuresPerView, viewId, track);
-
-                    if (o.isEmpty())
-                    {
-                        continue;
-                    }
-
-                    features.push_back(o.xUd);
-                    Ps.push_back(o.P);
-                    i++;
+                    continue;
                 }
+
+                features.push_back(o.xUd);
+                Ps.push_back(*o.P);
             }
 
             // -- Triangulate:
             Vec4 X_homogeneous = Vec4::Zero();
             std::vector<std::size_t> inliersIndex;
 
-            multiview::TriangulateNViewLORANSAC(features, Ps, _randomNumberGenerator, X_homogeneous, &inliersIndex, 8.0);
+            multiview::TriangulateNViewLORANSAC(features, Ps, randomNumberGenerators[omp_get_thread_num()], X_homogeneous, &inliersIndex, 8.0);
 
             homogeneousToEuclidean(X_homogeneous, X_euclidean);
 
@@ -1912,33 +2313,48 @@ void ReconstructionEngine_sequentialSfM::triangulateMultiViewsLORANSAC(SfMData&
                 isValidTrack = false;
         }
 
-        // -- Add the tringulated point to the scene
-        if (isValidTrack)
+        if (!isValidTrack)
         {
-            Landmark landmark;
-            landmark.X = X_euclidean;
-            landmark.descType = track.descType;
-            for (const IndexT& viewId : inliers)  // add inliers as observations
-            {
-                const Vec2 x = _featuresPerView->getFeatures(viewId, track.descType)[track.featPerView.at(viewId).featureId].coords().cast<double>();
-                const feature::PointFeature& p = _featuresPerView->getFeatures(viewId, track.descType)[track.featPerView.at(viewId).featureId];
-                const double scale = (_params.featureConstraint == EFeatureConstraint::BASIC) ? 0.0 : p.scale();
-                landmark.getObservations()[viewId] = Observation(x, track.featPerView.at(viewId).featureId, scale);
-            }
-#pragma omp critical
-            {
-                scene.getLandmarks()[trackId] = landmark;
-            }
+            triangulationPerTrack[i] = ETrackTriangulation::INVALID;
+            continue;
         }
-        else
+
+        // -- Build the triangulated point
+        Landmark& landmark = landmarkPerTrack[i];
+        landmark.X = X_euclidean;
+        landmark.descType = track.descType;
+        for (const IndexT& viewId : inliers)  // add inliers as observations
         {
-#pragma omp critical
+            const std::size_t featureId = track.featPerView.at(viewId).featureId;
+            const feature::PointFeature& p = _featuresPerView->getFeatures(viewId, track.descType)[featureId];
+            const double scale = (_params.featureConstraint == EFeatureConstraint::BASIC) ? 0.0 : p.scale();
+            landmark.getObservations()[viewId] = Observation(p.coords().cast<double>(), featureId, scale);
+        }
+        triangulationPerTrack[i] = ETrackTriangulation::VALID;
+    }  // for all shared tracks
+
+    // -- Merge the results in the scene, the tracks are sorted by id so the map insertions are hinted
+    Landmarks& landmarks = scene.getLandmarks();
+    auto hint = landmarks.begin();
+    for (std::size_t i = 0; i < setTracksId.size(); ++i)
+    {
+        const IndexT trackId = setTracksId[i];
+        switch (triangulationPerTrack[i])
+        {
+            case ETrackTriangulation::VALID:
+                hint = std::next(landmarks.insert_or_assign(hint, trackId, std::move(landmarkPerTrack[i])));
+                break;
+            case ETrackTriangulation::INVALID:
             {
-                if (scene.getLandmarks().find(trackId) != scene.getLandmarks().end())
-                    scene.getLandmarks().erase(trackId);
+                hint = landmarks.lower_bound(trackId);
+                if (hint != landmarks.end() && hint->first == trackId)
+                    hint = landmarks.erase(hint);
+                break;
             }
+            case ETrackTriangulation::SKIPPED:
+                break;
         }
-    }  // for all shared tracks
+    }
 }
 
 void ReconstructionEngine_sequentialSfM::triangulate2Views(SfMData& scene,
@@ -2121,6 +2537,8 @@ void ReconstructionEngine_sequentialSfM::triangulate2Views(SfMData& scene,
 
 std::size_t ReconstructionEngine_sequentialSfM::removeOutliers()
 {
+    ALICEVISION_TRACE_ZONE_CAT("ReconstructionEngine_sequentialSfM::removeOutliers", "sfm");
+
     const std::size_t nbOutliersResidualErr =
       removeOutliersWithPixelResidualError(_sfmData, _params.featureConstraint, _params.maxReprojectionError, 2);
     const std::size_t nbOutliersAngleErr = removeOutliersWithAngleError(_sfmData, _params.minAngleForLandmark);
@@ -47,6 +47,11 @@ class ReconstructionEngine_sequentialSfM : public ReconstructionEngine
         bool useLocalBundleAdjustment = false;
         int localBundelAdjustementGraphDistanceLimit = 1;
 
+        /// Update an existing reconstruction with its new views: the reconstructed views are neither re-triangulated
+        /// nor globally adjusted before the localization of the new views, and the matches may be limited to the ones
+        /// involving the new views since the landmarks without corresponding track are kept.
+        bool incrementalUpdate = false;
+
         /// Dump current status of the scene every 3 resections
         bool logIntermediateSteps = false;
 
@@ -95,6 +100,17 @@ class ReconstructionEngine_sequentialSfM : public ReconstructionEngine
         /// Using a negative value for this threshold will disable BA iterations.
         int bundleAdjustmentMaxOutliers = 50;
 
+        /// Minimum number of cameras in the bundle adjustment to use the iterative Schur solver
+        /// (with Schur-Jacobi preconditioner) instead of the sparse Schur factorization.
+        /// Using 0 will disable the iterative solver.
+        std::size_t bundleAdjustmentIterativeMinNbCameras = 0;
+
+        /// Use the CUDA linear solvers of Ceres for the bundle adjustment, when available.
+        bool bundleAdjustmentUseCuda = false;
+
+        /// Use the cost functions with analytic Jacobians in the bundle adjustment, when available for the camera model.
+        bool bundleAdjustmentAnalyticJacobians = false;
+
         // Local Bundle Adjustment data
 
         /// The minimum number of shared matches to create an edge between two views (nodes)
@@ -129,6 +145,13 @@ class ReconstructionEngine_sequentialSfM : public ReconstructionEngine
      */
     void initializePyramidScoring();
 
+    /**
+     * @brief Update the pyramid score of the views with the tracks that have been
+     * reconstructed or removed from the reconstruction since the last update.
+     * The cost is proportional to the number of changed tracks.
+     */
+    void updatePyramidScoring();
+
     /**
      * @brief Initialize tracks
      * @return number of traks
@@ -150,6 +173,8 @@ class ReconstructionEngine_sequentialSfM : public ReconstructionEngine
     /**
      * @brief If we have already reconstructed landmarks in a previous reconstruction,
      * we need to recognize the corresponding tracks and update the landmarkIds accordingly.
+     * With an incremental update, the tracks may only cover the new views: a landmark is recognized by any of its
+     * observations, and the landmarks without corresponding track are kept with ids after the track ids.
      */
     void remapLandmarkIdsToTrackIds();
 
@@ -216,7 +241,7 @@ class ReconstructionEngine_sequentialSfM : public ReconstructionEngine
      * @param[in] remainingViewIds: input list of remaining view IDs in which we will search for the best ones for resectioning.
      * @return False if there is no possible resection.
      */
-    bool findNextBestViews(std::vector<IndexT>& out_selectedViewIds, const std::set<IndexT>& remainingViewIds) const;
+    bool findNextBestViews(std::vector<IndexT>& out_selectedViewIds, const std::set<IndexT>& remainingViewIds);
 
   private:
     struct ResectionData : ImageLocalizerMatchData
@@ -227,6 +252,8 @@ class ReconstructionEngine_sequentialSfM : public ReconstructionEngine
         std::vector<track::FeatureId> featuresId;
         /// pose estimated by the resection
         geometry::Pose3 pose;
+        /// intrinsic refined by the resection, only if it was not used by the reconstruction yet
+        std::shared_ptr<camera::IntrinsicBase> refinedIntrinsics;
     };
 
     /**
@@ -266,11 +293,54 @@ class ReconstructionEngine_sequentialSfM : public ReconstructionEngine
 
     /**
      * @brief Apply the resection on a single view.
+     *        It does not modify the scene, so several views can be resected in parallel.
      * @param[in] viewIndex: image index to add to the reconstruction.
+     * @param[in] reconstructedTrackIds: sorted ids of the reconstructed tracks
+     * @param[in,out] randomNumberGenerator: random number generator used by the robust estimation
      * @param[out] resectionData: contains the result (P) and all the data used during the resection.
      * @return false if resection failed
      */
-    bool computeResection(const IndexT viewIndex, ResectionData& resectionData);
+    bool computeResection(const IndexT viewIndex,
+                          const std::vector<std::size_t>& reconstructedTrackIds,
+                          std::mt19937& randomNumberGenerator,
+                          ResectionData& resectionData) const;
+
+    /**
+     * @brief Get the 2D/3D associations of a view with the reconstructed tracks.
+     * @param[in] viewIndex: image index to add to the reconstruction.
+     * @param[in] reconstructedTrackIds: sorted ids of the reconstructed tracks
+     * @param[out] resectionData: filled with the tracks, features and 2D/3D points of the associations.
+     * @return false if the view is not connected to the reconstructed tracks
+     */
+    bool computeResectionCorrespondences(const IndexT viewIndex,
+                                         const std::vector<std::size_t>& reconstructedTrackIds,
+                                         ResectionData& resectionData) const;
+
+    /**
+     * @brief Estimate and refine the pose of a view from its 2D/3D associations.
+     * @param[in] viewIndex: image index to add to the reconstruction.
+     * @param[in,out] randomNumberGenerator: random number generator used by the robust estimation
+     * @param[in,out] resectionData: the 2D/3D associations, contains the result (P).
+     * @return false if resection failed
+     */
+    bool computeResectionPose(const IndexT viewIndex, std::mt19937& randomNumberGenerator, ResectionData& resectionData) const;
+
+    /**
+     * @brief Apply the resection on the views of a rig frame, with known sub-poses and an unknown rig pose.
+     *        Only the view with the most 2D/3D associations is resected, the other views of the frame get
+     *        the same rig pose and keep their associations consistent with it.
+     *        It does not modify the scene, so several frames can be resected in parallel.
+     * @param[in] viewIds: the views of the rig frame
+     * @param[in] reconstructedTrackIds: sorted ids of the reconstructed tracks
+     * @param[in,out] randomNumberGenerator: random number generator used by the robust estimation
+     * @param[out] resectionDataPerView: the result of each view, in the viewIds order
+     * @param[out] hasResectedPerView: whether each view is localized, in the viewIds order
+     */
+    void computeRigFrameResection(const std::vector<IndexT>& viewIds,
+                                  const std::vector<std::size_t>& reconstructedTrackIds,
+                                  std::mt19937& randomNumberGenerator,
+                                  std::vector<ResectionData>& resectionDataPerView,
+                                  std::vector<char>& hasResectedPerView) const;
 
     /**
      * @brief Update the global scene with the new found camera pose, intrinsic (if not defined) and
@@ -368,6 +438,24 @@ class ReconstructionEngine_sequentialSfM : public ReconstructionEngine
     /// internal cache of precomputed values for the weighting of the pyramid levels
     std::vector<int> _pyramidWeights;
     int _pyramidThreshold;
+    /// total number of cells of all the pyramid levels
+    std::size_t _pyramidNbCells = 0;
+
+    /// Pyramid occupancy of the reconstructed tracks in a view
+    struct ViewPyramidScore
+    {
+        /// number of reconstructed tracks per cell of the pyramid (all levels)
+        std::vector<std::uint32_t> nbTracksPerCell;
+        /// number of reconstructed tracks visible in the view
+        std::size_t nbTracks = 0;
+        /// weighted number of occupied cells
+        std::size_t score = 0;
+    };
+
+    /// incrementally updated pyramid score per view
+    std::map<IndexT, ViewPyramidScore> _pyramidScorePerView;
+    /// sorted ids of the reconstructed tracks taken into account in _pyramidScorePerView
+    std::vector<std::size_t> _pyramidScoredTrackIds;
 
     // Temporary data
 
@@ -6,6 +6,7 @@
 // You can obtain one at https://mozilla.org/MPL/2.0/.
 
 #include "StructureEstimationFromKnownPoses.hpp"
+#include <aliceVision/sfm/pipeline/RegionsCache.hpp>
 #include <aliceVision/feature/metric.hpp>
 #include <aliceVision/matching/IndMatch.hpp>
 #include <aliceVision/matching/guidedMatching.hpp>
@@ -17,6 +18,10 @@
 #include <aliceVision/system/ProgressDisplay.hpp>
 #include <aliceVision/config.hpp>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+
 namespace aliceVision {
 namespace sfm {
 
@@ -66,8 +71,94 @@ void StructureEstimationFromKnownPoses::run(SfMData& sfmData,
     triangulate(sfmData, regionsPerView, randomNumberGenerator);
 }
 
+/// Pair-streaming version of run()
+bool StructureEstimationFromKnownPoses::run(SfMData& sfmData,
+                                            const PairSet& pairs,
+                                            RegionsCache& regionsCache,
+                                            std::mt19937& randomNumberGenerator,
+                                            double geometricErrorMax)
+{
+    sfmData.getLandmarks().clear();
+
+    if (!matchAndFilter(sfmData, pairs, regionsCache, geometricErrorMax))
+        return false;
+    triangulate(sfmData, regionsCache.getRegionsPerView(), randomNumberGenerator);
+    return true;
+}
+
 // #define ALICEVISION_EXHAUSTIVE_MATCHING
 
+/// Use guided matching to find the 2-view correspondences of one pair
+void StructureEstimationFromKnownPoses::matchPair(const SfMData& sfmData,
+                                                  const Pair& pair,
+                                                  const feature::MapRegionsPerDesc& regionsL,
+                                                  const feature::MapRegionsPerDesc& regionsR,
+                                                  double geometricErrorMax,
+                                                  matching::MatchesPerDescType& out_matches) const
+{
+    // --
+    // Perform GUIDED MATCHING
+    // --
+    // Use the computed model to check valid correspondences
+    // - by considering geometric error and descriptor distance ratio.
+
+    const View* viewL = sfmData.getViews().at(pair.first).get();
+    const Pose3 poseL = sfmData.getPose(*viewL).getTransform();
+    const Intrinsics::const_iterator iterIntrinsicL = sfmData.getIntrinsics().find(viewL->getIntrinsicId());
+    const View* viewR = sfmData.getViews().at(pair.second).get();
+    const Pose3 poseR = sfmData.getPose(*viewR).getTransform();
+    const Intrinsics::const_iterator iterIntrinsicR = sfmData.getIntrinsics().find(viewR->getIntrinsicId());
+
+    if (iterIntrinsicL == sfmData.getIntrinsics().end() || iterIntrinsicR == sfmData.getIntrinsics().end())
+        return;
+
+    std::shared_ptr<IntrinsicBase> camL = iterIntrinsicL->second;
+    std::shared_ptr<camera::Pinhole> pinHoleCamL = std::dynamic_pointer_cast<camera::Pinhole>(camL);
+    std::shared_ptr<IntrinsicBase> camR = iterIntrinsicR->second;
+    std::shared_ptr<camera::Pinhole> pinHoleCamR = std::dynamic_pointer_cast<camera::Pinhole>(camR);
+    if (!pinHoleCamL || !pinHoleCamR)
+    {
+        ALICEVISION_LOG_ERROR("Camera is not pinhole in match");
+        return;
+    }
+
+    const Mat34 P_L = pinHoleCamL->getProjectiveEquivalent(poseL);
+    const Mat34 P_R = pinHoleCamR->getProjectiveEquivalent(poseR);
+
+    const Mat3 F_lr = F_from_P(P_L, P_R);
+    const std::vector<feature::EImageDescriberType> commonDescTypes = feature::getCommonDescTypes(regionsL, regionsR);
+
+    for (feature::EImageDescriberType descType : commonDescTypes)
+    {
+        std::vector<matching::IndMatch> matches;
+#ifdef ALICEVISION_EXHAUSTIVE_MATCHING
+        matching::guidedMatching<Mat3, multiview::relativePose::FundamentalEpipolarDistanceError>(F_lr,
+                                                                                                 camL.get(),
+                                                                                                 *regionsL.at(descType),
+                                                                                                 camR.get(),
+                                                                                                 *regionsR.at(descType),
+                                                                                                 Square(geometricErrorMax),
+                                                                                                 Square(0.8),
+                                                                                                 matches);
+#else
+        const Vec3 epipole2 = epipole_from_P(P_R, poseL);
+
+        matching::guidedMatchingFundamentalFast<multiview::relativePose::FundamentalEpipolarDistanceError>(F_lr,
+                                                                                                          epipole2,
+                                                                                                          camL.get(),
+                                                                                                          *regionsL.at(descType),
+                                                                                                          camR.get(),
+                                                                                                          *regionsR.at(descType),
+                                                                                                          camR->w(),
+                                                                                                          camR->h(),
+                                                                                                          Square(geometricErrorMax),
+                                                                                                          Square(0.8),
+                                                                                                          matches);
+#endif
+        out_matches[descType] = std::move(matches);
+    }
+}
+
 /// Use guided matching to find corresponding 2-view correspondences
 void StructureEstimationFromKnownPoses::match(const SfMData& sfmData,
                                               const PairSet& pairs,
@@ -81,82 +172,77 @@ void StructureEstimationFromKnownPoses::match(const SfMData& sfmData,
     {
 #pragma omp single nowait
         {
-            // --
-            // Perform GUIDED MATCHING
-            // --
-            // Use the computed model to check valid correspondences
-            // - by considering geometric error and descriptor distance ratio.
-
-            const View* viewL = sfmData.getViews().at(it->first).get();
-            const Pose3 poseL = sfmData.getPose(*viewL).getTransform();
-            const Intrinsics::const_iterator iterIntrinsicL = sfmData.getIntrinsics().find(viewL->getIntrinsicId());
-            const View* viewR = sfmData.getViews().at(it->second).get();
-            const Pose3 poseR = sfmData.getPose(*viewR).getTransform();
-            const Intrinsics::const_iterator iterIntrinsicR = sfmData.getIntrinsics().find(viewR->getIntrinsicId());
-
-            if (sfmData.getIntrinsics().count(viewL->getIntrinsicId()) != 0 || sfmData.getIntrinsics().count(viewR->getIntrinsicId()) != 0)
+            matching::MatchesPerDescType allImagePairMatches;
+            matchPair(sfmData,
+                      *it,
+                      regionsPerView.getRegionsPerDesc(it->first),
+                      regionsPerView.getRegionsPerDesc(it->second),
+                      geometricErrorMax,
+                      allImagePairMatches);
+
+#pragma omp critical
             {
-                std::shared_ptr<IntrinsicBase> camL = iterIntrinsicL->second;
-                std::shared_ptr<camera::Pinhole> pinHoleCamL = std::dynamic_pointer_cast<camera::Pinhole>(camL);
-                if (!pinHoleCamL)
-                {
-                    ALICEVISION_LOG_ERROR("Camera is not pinhole in match");
-                }
+                ++progressDisplay;
+                _putativeMatches[*it] = std::move(allImagePairMatches);
+            }
+        }
+    }
+}
 
-                std::shared_ptr<IntrinsicBase> camR = iterIntrinsicR->second;
-                std::shared_ptr<camera::Pinhole> pinHoleCamR = std::dynamic_pointer_cast<camera::Pinhole>(camR);
-                if (!pinHoleCamL)
-                {
-                    ALICEVISION_LOG_ERROR("Camera is not pinhole in match");
-                }
+/// Keep the correspondences of the view triplet I, J, K that are consistent in the 3 views
+void StructureEstimationFromKnownPoses::filterTriplet(const SfMData& sfmData,
+                                                      IndexT I,
+                                                      IndexT J,
+                                                      IndexT K,
+                                                      const matching::PairwiseMatches& matchesIJK,
+                                                      const feature::RegionsPerView& regionsPerView)
+{
+    if (matchesIJK.size() < 2)
+        return;
 
-                const Mat34 P_L = pinHoleCamL->getProjectiveEquivalent(poseL);
-                const Mat34 P_R = pinHoleCamR->getProjectiveEquivalent(poseR);
+    track::TracksMap map_tracksCommon;
+    track::TracksBuilder tracksBuilder;
+    tracksBuilder.build(matchesIJK);
+    tracksBuilder.filter(true, 3, false);
+    tracksBuilder.exportToSTL(map_tracksCommon);
 
-                const Mat3 F_lr = F_from_P(P_L, P_R);
-                std::vector<feature::EImageDescriberType> commonDescTypes = regionsPerView.getCommonDescTypes(*it);
+    // Triangulate the tracks
+    for (track::TracksMap::const_iterator iterTracks = map_tracksCommon.begin(); iterTracks != map_tracksCommon.end(); ++iterTracks)
+    {
+        const track::Track& subTrack = iterTracks->second;
+        multiview::Triangulation trianObj;
+        for (auto iter = subTrack.featPerView.begin(); iter != subTrack.featPerView.end(); ++iter)
+        {
+            const size_t imaIndex = iter->first;
+            const size_t featIndex = iter->second.featureId;
+            const View* view = sfmData.getViews().at(imaIndex).get();
 
-                matching::MatchesPerDescType allImagePairMatches;
-                for (feature::EImageDescriberType descType : commonDescTypes)
-                {
-                    std::vector<matching::IndMatch> matches;
-#ifdef ALICEVISION_EXHAUSTIVE_MATCHING
-                    matching::guidedMatching<Mat3, multiview::relativePose::FundamentalEpipolarDistanceError>(
-                      F_lr,
-                      iterIntrinsicL->second.get(),
-                      regionsPerView.getRegions(it->first, descType),
-                      iterIntrinsicR->second.get(),
-                      regionsPerView.getRegions(it->second, descType),
-                      // descType,
-                      Square(thresholdF),
-                      Square(0.8),
-                      matches);
-#else
-                    const Vec3 epipole2 = epipole_from_P(P_R, poseL);
-
-                    // const feature::Regions& regions = regionsPerView.getRegions(it->first);
-                    matching::guidedMatchingFundamentalFast<multiview::relativePose::FundamentalEpipolarDistanceError>(
-                      F_lr,
-                      epipole2,
-                      iterIntrinsicL->second.get(),
-                      regionsPerView.getRegions(it->first, descType),
-                      iterIntrinsicR->second.get(),
-                      regionsPerView.getRegions(it->second, descType),
-                      iterIntrinsicR->second->w(),
-                      iterIntrinsicR->second->h(),
-                      // descType,
-                      Square(geometricErrorMax),
-                      Square(0.8),
-                      matches);
-#endif
-                    allImagePairMatches[descType] = matches;
-                }
+            std::shared_ptr<camera::IntrinsicBase> cam = sfmData.getIntrinsics().at(view->getIntrinsicId());
+            std::shared_ptr<camera::Pinhole> camPinHole = std::dynamic_pointer_cast<camera::Pinhole>(cam);
+            if (!camPinHole)
+            {
+                ALICEVISION_LOG_ERROR("Camera is not pinhole in filter");
+                continue;
+            }
 
+            const Pose3 pose = sfmData.getPose(*view).getTransform();
+            const Vec2 pt = regionsPerView.getRegions(imaIndex, subTrack.descType).GetRegionPosition(featIndex);
+            trianObj.add(camPinHole->getProjectiveEquivalent(pose), cam->getUndistortedPixel(pt));
+        }
+        const Vec3 Xs = trianObj.compute();
+        if (trianObj.minDepth() > 0 && trianObj.error() / (double)trianObj.size() < 4.0)
+        // TODO: Add an angular check ?
+        {
 #pragma omp critical
-                {
-                    ++progressDisplay;
-                    _putativeMatches[*it] = allImagePairMatches;
-                }
+            {
+                track::Track::FeatureIdPerView::const_iterator iterI, iterJ, iterK;
+                iterI = iterJ = iterK = subTrack.featPerView.begin();
+                std::advance(iterJ, 1);
+                std::advance(iterK, 2);
+
+                _tripletMatches[std::make_pair(I, J)][subTrack.descType].emplace_back(iterI->second.featureId, iterJ->second.featureId);
+                _tripletMatches[std::make_pair(J, K)][subTrack.descType].emplace_back(iterJ->second.featureId, iterK->second.featureId);
+                _tripletMatches[std::make_pair(I, K)][subTrack.descType].emplace_back(iterI->second.featureId, iterK->second.featureId);
             }
         }
     }
@@ -184,76 +270,137 @@ void StructureEstimationFromKnownPoses::filter(const SfMData& sfmData, const Pai
             const graph::Triplet& triplet = *it;
             const IndexT I = triplet.i, J = triplet.j, K = triplet.k;
 
-            track::TracksMap map_tracksCommon;
-            track::TracksBuilder tracksBuilder;
+            matching::PairwiseMatches map_matchesIJK;
+            if (_putativeMatches.count(std::make_pair(I, J)))
+                map_matchesIJK.insert(*_putativeMatches.find(std::make_pair(I, J)));
+
+            if (_putativeMatches.count(std::make_pair(I, K)))
+                map_matchesIJK.insert(*_putativeMatches.find(std::make_pair(I, K)));
+
+            if (_putativeMatches.count(std::make_pair(J, K)))
+                map_matchesIJK.insert(*_putativeMatches.find(std::make_pair(J, K)));
+
+            filterTriplet(sfmData, I, J, K, map_matchesIJK, regionsPerView);
+        }
+    }
+    // Clear putatives matches since they are no longer required
+    matching::PairwiseMatches().swap(_putativeMatches);
+}
+
+/// Guided matching and 3-view filtering of the pairs in a single parallel pass
+bool StructureEstimationFromKnownPoses::matchAndFilter(const SfMData& sfmData,
+                                                       const PairSet& pairs,
+                                                       RegionsCache& regionsCache,
+                                                       double geometricErrorMax)
+{
+    // the pairs are sorted, so the pairs of a view are processed close in time and its descriptors are released early
+    const std::vector<Pair> pairsList(pairs.begin(), pairs.end());
+    const auto findPair = [&pairsList](IndexT a, IndexT b) -> int {
+        const auto it = std::lower_bound(pairsList.begin(), pairsList.end(), std::make_pair(a, b));
+        return (it != pairsList.end() && *it == std::make_pair(a, b)) ? static_cast<int>(std::distance(pairsList.begin(), it)) : -1;
+    };
+
+    // link the triplets and their pairs, a triplet needs at least 2 pairs to be validated
+    const std::vector<graph::Triplet> allTriplets = graph::tripletListing(pairs);
+    std::vector<std::array<IndexT, 3>> triplets;
+    std::vector<std::vector<int>> pairsPerTriplet;
+    std::vector<std::vector<std::size_t>> tripletsPerPair(pairsList.size());
+    for (const graph::Triplet& triplet : allTriplets)
+    {
+        std::vector<int> tripletPairs;
+        for (const int p : {findPair(triplet.i, triplet.j), findPair(triplet.i, triplet.k), findPair(triplet.j, triplet.k)})
+        {
+            if (p >= 0)
+                tripletPairs.push_back(p);
+        }
+        if (tripletPairs.size() < 2)
+            continue;
+
+        for (const int p : tripletPairs)
+            tripletsPerPair.at(p).push_back(triplets.size());
+        triplets.push_back({triplet.i, triplet.j, triplet.k});
+        pairsPerTriplet.push_back(std::move(tripletPairs));
+    }
+
+    std::vector<std::size_t> nbPendingPairsPerTriplet(triplets.size());
+    for (std::size_t t = 0; t < triplets.size(); ++t)
+        nbPendingPairsPerTriplet.at(t) = pairsPerTriplet.at(t).size();
+    std::vector<std::size_t> nbPendingTripletsPerPair(pairsList.size());
+    for (std::size_t p = 0; p < pairsList.size(); ++p)
+        nbPendingTripletsPerPair.at(p) = tripletsPerPair.at(p).size();
+
+    // putative matches of the pairs with pending triplets
+    std::vector<matching::MatchesPerDescType> putativeMatches(pairsList.size());
+    std::atomic_bool invalid(false);
+
+    ALICEVISION_LOG_INFO("Guided matching of " << pairsList.size() << " image pairs and validation of " << triplets.size() << " view triplets.");
+    auto progressDisplay =
+      system::createConsoleProgressDisplay(pairsList.size(), std::cout, "Compute pairwise guided matching and per triplet validation:\n");
+
+#pragma omp parallel for schedule(dynamic)
+    for (int p = 0; p < static_cast<int>(pairsList.size()); ++p)
+    {
+        if (invalid)
+            continue;
+
+        const Pair& pair = pairsList.at(p);
+        try
+        {
+            const feature::MapRegionsPerDesc& regionsL = regionsCache.acquire(pair.first);
+            const feature::MapRegionsPerDesc& regionsR = regionsCache.acquire(pair.second);
+            matchPair(sfmData, pair, regionsL, regionsR, geometricErrorMax, putativeMatches.at(p));
+        }
+        catch (const std::exception& e)
+        {
+            invalid = true;
+#pragma omp critical
             {
-                matching::PairwiseMatches map_matchesIJK;
-                if (_putativeMatches.count(std::make_pair(I, J)))
-                    map_matchesIJK.insert(*_putativeMatches.find(std::make_pair(I, J)));
+                ALICEVISION_LOG_ERROR(e.what());
+            }
+            continue;
+        }
+        regionsCache.release(pair.first);
+        regionsCache.release(pair.second);
 
-                if (_putativeMatches.count(std::make_pair(I, K)))
-                    map_matchesIJK.insert(*_putativeMatches.find(std::make_pair(I, K)));
+        // the triplets with all their pairs matched are validated by this thread
+        std::vector<std::size_t> readyTriplets;
+#pragma omp critical(StructureEstimationFromKnownPoses_pendingMatches)
+        {
+            ++progressDisplay;
+            for (const std::size_t t : tripletsPerPair.at(p))
+            {
+                if (--nbPendingPairsPerTriplet.at(t) == 0)
+                    readyTriplets.push_back(t);
+            }
+        }
 
-                if (_putativeMatches.count(std::make_pair(J, K)))
-                    map_matchesIJK.insert(*_putativeMatches.find(std::make_pair(J, K)));
+        if (tripletsPerPair.at(p).empty())
+            matching::MatchesPerDescType().swap(putativeMatches.at(p));
 
-                if (map_matchesIJK.size() >= 2)
-                {
-                    tracksBuilder.build(map_matchesIJK);
-                    tracksBuilder.filter(true, 3, false);
-                    tracksBuilder.exportToSTL(map_tracksCommon);
-                }
+        for (const std::size_t t : readyTriplets)
+        {
+            matching::PairwiseMatches matchesIJK;
+            for (const int q : pairsPerTriplet.at(t))
+                matchesIJK.emplace(pairsList.at(q), putativeMatches.at(q));
+
+            filterTriplet(sfmData, triplets.at(t)[0], triplets.at(t)[1], triplets.at(t)[2], matchesIJK, regionsCache.getRegionsPerView());
 
-                // Triangulate the tracks
-                for (track::TracksMap::const_iterator iterTracks = map_tracksCommon.begin(); iterTracks != map_tracksCommon.end(); ++iterTracks)
+            // release the putative matches of the pairs without pending triplets
+            std::vector<int> releasedPairs;
+#pragma omp critical(StructureEstimationFromKnownPoses_pendingMatches)
+            {
+                for (const int q : pairsPerTriplet.at(t))
                 {
-                    {
-                        const track::Track& subTrack = iterTracks->second;
-                        multiview::Triangulation trianObj;
-                        for (auto iter = subTrack.featPerView.begin(); iter != subTrack.featPerView.end(); ++iter)
-                        {
-                            const size_t imaIndex = iter->first;
-                            const size_t featIndex = iter->second.featureId;
-                            const View* view = sfmData.getViews().at(imaIndex).get();
-
-                            std::shared_ptr<camera::IntrinsicBase> cam = sfmData.getIntrinsics().at(view->getIntrinsicId());
-                            std::shared_ptr<camera::Pinhole> camPinHole = std::dynamic_pointer_cast<camera::Pinhole>(cam);
-                            if (!camPinHole)
-                            {
-                                ALICEVISION_LOG_ERROR("Camera is not pinhole in filter");
-                                continue;
-                            }
-
-                            const Pose3 pose = sfmData.getPose(*view).getTransform();
-                            const Vec2 pt = regionsPerView.getRegions(imaIndex, subTrack.descType).GetRegionPosition(featIndex);
-                            trianObj.add(camPinHole->getProjectiveEquivalent(pose), cam->getUndistortedPixel(pt));
-                        }
-                        const Vec3 Xs = trianObj.compute();
-                        if (trianObj.minDepth() > 0 && trianObj.error() / (double)trianObj.size() < 4.0)
-                        // TODO: Add an angular check ?
-                        {
-#pragma omp critical
-                            {
-                                track::Track::FeatureIdPerView::const_iterator iterI, iterJ, iterK;
-                                iterI = iterJ = iterK = subTrack.featPerView.begin();
-                                std::advance(iterJ, 1);
-                                std::advance(iterK, 2);
-
-                                _tripletMatches[std::make_pair(I, J)][subTrack.descType].emplace_back(iterI->second.featureId,
-                                                                                                      iterJ->second.featureId);
-                                _tripletMatches[std::make_pair(J, K)][subTrack.descType].emplace_back(iterJ->second.featureId,
-                                                                                                      iterK->second.featureId);
-                                _tripletMatches[std::make_pair(I, K)][subTrack.descType].emplace_back(iterI->second.featureId,
-                                                                                                      iterK->second.featureId);
-                            }
-                        }
-                    }
+                    if (--nbPendingTripletsPerPair.at(q) == 0)
+                        releasedPairs.push_back(q);
                 }
             }
+            for (const int q : releasedPairs)
+                matching::MatchesPerDescType().swap(putativeMatches.at(q));
         }
     }
-    // Clear putatives matches since they are no longer required
-    matching::PairwiseMatches().swap(_putativeMatches);
+
+    return !invalid;
 }
 
 /// Init & triangulate landmark observations from validated 3-view correspondences
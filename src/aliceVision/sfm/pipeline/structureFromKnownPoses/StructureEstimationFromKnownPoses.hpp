@@ -14,6 +14,8 @@
 namespace aliceVision {
 namespace sfm {
 
+class RegionsCache;
+
 class StructureEstimationFromKnownPoses
 {
   public:
@@ -24,6 +26,22 @@ class StructureEstimationFromKnownPoses
              std::mt19937& randomNumberGenerator,
              double geometricErrorMax);
 
+    /**
+     * @brief Pair-streaming version of run(): the regions are loaded on demand and the putative matches
+     *        of a pair are released as soon as all the view triplets of the pair are validated.
+     * @param[in,out] sfmData The SfMData (the landmarks are replaced)
+     * @param[in] pairs The image pairs
+     * @param[in,out] regionsCache The regions cache (the pending uses of a view are its number of pairs)
+     * @param[in] randomNumberGenerator The random number generator
+     * @param[in] geometricErrorMax Maximum error (in pixels) of the guided matching
+     * @return false if the regions of a view can not be loaded
+     */
+    bool run(sfmData::SfMData& sfmData,
+             const PairSet& pairs,
+             RegionsCache& regionsCache,
+             std::mt19937& randomNumberGenerator,
+             double geometricErrorMax);
+
   public:
     /// Use guided matching to find corresponding 2-view correspondences
     void match(const sfmData::SfMData& sfmData, const PairSet& pairs, const feature::RegionsPerView& regionsPerView, double geometricErrorMax);
@@ -31,12 +49,39 @@ class StructureEstimationFromKnownPoses
     /// Filter inconsistent correspondences by using 3-view correspondences on view triplets
     void filter(const sfmData::SfMData& sfmData, const PairSet& pairs, const feature::RegionsPerView& regionsPerView);
 
+    /**
+     * @brief Guided matching and 3-view filtering of the pairs in a single parallel pass.
+     *        A view triplet is validated by the thread that matches its last pair.
+     * @param[in] sfmData The SfMData
+     * @param[in] pairs The image pairs
+     * @param[in,out] regionsCache The regions cache (the pending uses of a view are its number of pairs)
+     * @param[in] geometricErrorMax Maximum error (in pixels) of the guided matching
+     * @return false if the regions of a view can not be loaded
+     */
+    bool matchAndFilter(const sfmData::SfMData& sfmData, const PairSet& pairs, RegionsCache& regionsCache, double geometricErrorMax);
+
     /// Init & triangulate landmark observations from validated 3-view correspondences
     void triangulate(sfmData::SfMData& sfmData, const feature::RegionsPerView& regionsPerView, std::mt19937& randomNumberGenerator);
 
     const matching::PairwiseMatches& getPutativesMatches() const { return _putativeMatches; }
 
   private:
+    /// Use guided matching to find the 2-view correspondences of one pair
+    void matchPair(const sfmData::SfMData& sfmData,
+                   const Pair& pair,
+                   const feature::MapRegionsPerDesc& regionsL,
+                   const feature::MapRegionsPerDesc& regionsR,
+                   double geometricErrorMax,
+                   matching::MatchesPerDescType& out_matches) const;
+
+    /// Keep the correspondences of the view triplet I, J, K that are consistent in the 3 views
+    void filterTriplet(const sfmData::SfMData& sfmData,
+                       IndexT I,
+                       IndexT J,
+                       IndexT K,
+                       const matching::PairwiseMatches& matchesIJK,
+                       const feature::RegionsPerView& regionsPerView);
+
     //--
     // DATA (temporary)
     //--
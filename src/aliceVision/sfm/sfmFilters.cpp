@@ -7,43 +7,120 @@
 
 #include "sfmFilters.hpp"
 #include <aliceVision/sfmData/SfMData.hpp>
+#include <aliceVision/sfmData/FlatLandmarks.hpp>
 #include <aliceVision/stl/stl.hpp>
 #include <aliceVision/system/Logger.hpp>
 #include <aliceVision/sfm/bundle/BundleAdjustment.hpp>
 
 #include <iterator>
+#include <map>
+#include <vector>
 
 namespace aliceVision {
 namespace sfm {
 
+namespace {
+
+/// Pose and intrinsic of a view, resolved once for all its observations
+struct ViewCamera
+{
+    geometry::Pose3 pose;
+    const camera::IntrinsicBase* intrinsic = nullptr;
+};
+
+/**
+ * @brief Resolve the pose and the intrinsic of all the views with a defined pose and intrinsic.
+ * @param[in] sfmData the scene
+ * @return the camera per view id
+ */
+std::map<IndexT, ViewCamera> getPosedViewCameras(const sfmData::SfMData& sfmData)
+{
+    std::map<IndexT, ViewCamera> cameras;
+    for (const auto& viewPair : sfmData.getViews())
+    {
+        const sfmData::View* view = viewPair.second.get();
+        if (!sfmData.isPoseAndIntrinsicDefined(view))
+            continue;
+
+        ViewCamera& camera = cameras[viewPair.first];
+        camera.pose = sfmData.getPose(*view).getTransform();
+        camera.intrinsic = sfmData.getIntrinsics().at(view->getIntrinsicId()).get();
+    }
+    return cameras;
+}
+
+}  // namespace
+
 IndexT removeOutliersWithPixelResidualError(sfmData::SfMData& sfmData,
                                             EFeatureConstraint featureConstraint,
                                             const double dThresholdPixel,
                                             const unsigned int minTrackLength)
 {
-    IndexT outlierCount = 0;
-    sfmData::Landmarks::iterator iterTracks = sfmData.getLandmarks().begin();
+    sfmData::Landmarks& landmarks = sfmData.getLandmarks();
+
+    // contiguous copy of the observations, traversed per view
+    const sfmData::FlatLandmarks flatLandmarks(landmarks);
+    const std::vector<IndexT>& viewIds = flatLandmarks.getViewIds();
+    const std::vector<std::size_t>& viewObservationIndexes = flatLandmarks.getViewObservationIndexes();
+
+    const std::map<IndexT, ViewCamera> posedCameras = getPosedViewCameras(sfmData);
+
+    std::vector<const ViewCamera*> cameras;
+    for (const IndexT viewId : viewIds)
+        cameras.push_back(&posedCameras.at(viewId));
 
-    while (iterTracks != sfmData.getLandmarks().end())
+    // Project the landmarks observed by each view at once, the observations are only flagged here
+    std::vector<char> isOutlier(flatLandmarks.getNbObservations(), 0);
+
+#pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < static_cast<int>(viewIds.size()); ++i)
     {
-        sfmData::Observations& observations = iterTracks->second.getObservations();
-        sfmData::Observations::iterator itObs = observations.begin();
+        const ViewCamera& camera = *cameras[i];
+        const std::size_t begin = flatLandmarks.getViewObservationsBegin(i);
+        const Eigen::Index nbViewObservations = static_cast<Eigen::Index>(flatLandmarks.getViewObservationsEnd(i) - begin);
 
-        while (itObs != observations.end())
+        Mat3X X(3, nbViewObservations);
+        Mat2X x(2, nbViewObservations);
+        for (Eigen::Index j = 0; j < nbViewObservations; ++j)
         {
-            const sfmData::View* view = sfmData.getViews().at(itObs->first).get();
-            const geometry::Pose3 pose = sfmData.getPose(*view).getTransform();
-            const camera::IntrinsicBase* intrinsic = sfmData.getIntrinsics().at(view->getIntrinsicId()).get();
+            const std::size_t observationIndex = viewObservationIndexes[begin + j];
+            X.col(j) = flatLandmarks.getX(flatLandmarks.getObservationLandmarkIndex(observationIndex));
+            x.col(j) = flatLandmarks.getObservationCoordinates(observationIndex);
+        }
+
+        const Mat2X residuals = camera.intrinsic->residuals(camera.pose, X, x);
+        const Eigen::RowVectorXd depths = camera.pose.rotation().row(2) * (X.colwise() - camera.pose.center());
 
-            Vec2 residual = intrinsic->residual(pose, iterTracks->second.X.homogeneous(), itObs->second.getCoordinates());
-            if (featureConstraint == EFeatureConstraint::SCALE && itObs->second.getScale() > 0.0)
+        for (Eigen::Index j = 0; j < nbViewObservations; ++j)
+        {
+            const std::size_t observationIndex = viewObservationIndexes[begin + j];
+            const double scale = flatLandmarks.getObservationScale(observationIndex);
+
+            double residualNorm = residuals.col(j).norm();
+            if (featureConstraint == EFeatureConstraint::SCALE && scale > 0.0)
             {
                 // Apply the scale of the feature to get a residual value
                 // relative to the feature precision.
-                residual /= itObs->second.getScale();
+                residualNorm /= scale;
             }
 
-            if ((pose.depth(iterTracks->second.X) < 0) || (residual.norm() > dThresholdPixel))
+            isOutlier[observationIndex] = (depths(j) < 0) || (residualNorm > dThresholdPixel);
+        }
+    }
+
+    // Apply the removals, the observations are in the same order as in the flat copy
+    IndexT outlierCount = 0;
+    std::size_t observationIndex = 0;
+    sfmData::Landmarks::iterator iterTracks = landmarks.begin();
+
+    while (iterTracks != landmarks.end())
+    {
+        sfmData::Observations& observations = iterTracks->second.getObservations();
+        sfmData::Observations::iterator itObs = observations.begin();
+
+        while (itObs != observations.end())
+        {
+            if (isOutlier[observationIndex++])
             {
                 ++outlierCount;
                 itObs = observations.erase(itObs);
@@ -53,7 +130,7 @@ IndexT removeOutliersWithPixelResidualError(sfmData::SfMData& sfmData,
         }
 
         if (observations.empty() || observations.size() < minTrackLength)
-            iterTracks = sfmData.getLandmarks().erase(iterTracks);
+            iterTracks = landmarks.erase(iterTracks);
         else
             ++iterTracks;
     }
@@ -70,9 +147,12 @@ IndexT removeOutliersWithAngleError(sfmData::SfMData& sfmData, const double dMin
     vKeys.reserve(sfmData.getLandmarks().size());
     std::transform(sfmData.getLandmarks().cbegin(), sfmData.getLandmarks().cend(), std::back_inserter(vKeys), stl::RetrieveKey());
 
-    LandmarksKeysVec toErase;
+    const std::map<IndexT, ViewCamera> cameras = getPosedViewCameras(sfmData);
+
+    // one flag per landmark, the landmarks are erased afterwards
+    std::vector<char> toErase(vKeys.size(), 0);
 
-#pragma omp parallel for
+#pragma omp parallel for schedule(dynamic, 64)
     for (int landmarkIndex = 0; landmarkIndex < vKeys.size(); ++landmarkIndex)
     {
         const sfmData::Observations& observations = sfmData.getLandmarks().at(vKeys[landmarkIndex]).getObservations();
@@ -92,11 +172,9 @@ IndexT removeOutliersWithAngleError(sfmData::SfMData& sfmData, const double dMin
         // fill matrix, optimistically checking each new entry against col(greedyI)
         for (itObs = observations.begin(), i = 0; itObs != observations.end(); ++itObs, ++i)
         {
-            const sfmData::View* view = sfmData.getViews().at(itObs->first).get();
-            const geometry::Pose3 pose = sfmData.getPose(*view).getTransform();
-            const camera::IntrinsicBase* intrinsic = sfmData.getIntrinsics().at(view->getIntrinsicId()).get();
+            const ViewCamera& camera = cameras.at(itObs->first);
 
-            viewDirections.col(i) = applyIntrinsicExtrinsic(pose, intrinsic, itObs->second.getCoordinates());
+            viewDirections.col(i) = applyIntrinsicExtrinsic(camera.pose, camera.intrinsic, itObs->second.getCoordinates());
 
             double dCosAngle = viewDirections.col(i).transpose() * viewDirections.col(greedyI);
             if (dCosAngle < dMaxAcceptedCosAngle)
@@ -139,17 +217,21 @@ IndexT removeOutliersWithAngleError(sfmData::SfMData& sfmData, const double dMin
         // acceptable angle not found
         if (i == 0)
         {
-#pragma omp critical
-            toErase.push_back(vKeys[landmarkIndex]);
+            toErase[landmarkIndex] = 1;
         }
     }
 
-    for (IndexT key : toErase)
+    IndexT nbErased = 0;
+    for (std::size_t landmarkIndex = 0; landmarkIndex < vKeys.size(); ++landmarkIndex)
     {
-        sfmData.getLandmarks().erase(key);
+        if (toErase[landmarkIndex])
+        {
+            sfmData.getLandmarks().erase(vKeys[landmarkIndex]);
+            ++nbErased;
+        }
     }
 
-    return toErase.size();
+    return nbErased;
 }
 
 bool eraseUnstablePoses(sfmData::SfMData& sfmData, const IndexT minPointsPerPose, std::set<IndexT>* outRemovedViewsId)
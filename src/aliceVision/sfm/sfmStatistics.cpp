@@ -6,6 +6,8 @@
 
 #include "sfmStatistics.hpp"
 
+#include <aliceVision/sfmData/FlatLandmarks.hpp>
+
 #include <aliceVision/sfm/pipeline/localization/SfMLocalizer.hpp>
 
 #include <aliceVision/sfm/pipeline/regionsIO.hpp>
@@ -15,6 +17,64 @@
 namespace aliceVision {
 namespace sfm {
 
+namespace {
+
+/**
+ * @brief Compute the norm of the reprojection residuals of the observations, grouped by view.
+ *        The landmarks observed by a view are projected at once with the batch projection of its intrinsic.
+ * @param[in] sfmData the scene
+ * @param[in] specificViews the views to consider, all the views if empty
+ * @param[out] residualsPerView the residuals norm per view id
+ */
+void computeResidualsNormPerView(const sfmData::SfMData& sfmData,
+                                 const std::set<IndexT>& specificViews,
+                                 std::map<IndexT, std::vector<double>>& residualsPerView)
+{
+    // contiguous copy of the observations, traversed per view
+    const sfmData::FlatLandmarks flatLandmarks(sfmData.getLandmarks());
+    const std::vector<IndexT>& observedViewIds = flatLandmarks.getViewIds();
+    const std::vector<std::size_t>& viewObservationIndexes = flatLandmarks.getViewObservationIndexes();
+
+    std::vector<std::size_t> viewIndexes;
+    for (std::size_t i = 0; i < observedViewIds.size(); ++i)
+    {
+        if (!specificViews.empty() && specificViews.count(observedViewIds[i]) == 0)
+            continue;
+
+        viewIndexes.push_back(i);
+        residualsPerView[observedViewIds[i]];
+    }
+
+#pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < static_cast<int>(viewIndexes.size()); ++i)
+    {
+        const std::size_t viewIndex = viewIndexes[i];
+        const IndexT viewId = observedViewIds[viewIndex];
+        const std::size_t begin = flatLandmarks.getViewObservationsBegin(viewIndex);
+        const Eigen::Index nbObservations = static_cast<Eigen::Index>(flatLandmarks.getViewObservationsEnd(viewIndex) - begin);
+
+        const sfmData::View& view = sfmData.getView(viewId);
+        const geometry::Pose3 pose = sfmData.getPose(view).getTransform();
+        const std::shared_ptr<camera::IntrinsicBase> intrinsic = sfmData.getIntrinsics().find(view.getIntrinsicId())->second;
+
+        Mat3X X(3, nbObservations);
+        Mat2X x(2, nbObservations);
+        for (Eigen::Index j = 0; j < nbObservations; ++j)
+        {
+            const std::size_t observationIndex = viewObservationIndexes[begin + j];
+            X.col(j) = flatLandmarks.getX(flatLandmarks.getObservationLandmarkIndex(observationIndex));
+            x.col(j) = flatLandmarks.getObservationCoordinates(observationIndex);
+        }
+        const Mat2X residuals = intrinsic->residuals(pose, X, x);
+
+        std::vector<double>& viewResiduals = residualsPerView.at(viewId);
+        viewResiduals.resize(nbObservations);
+        Eigen::Map<Eigen::RowVectorXd>(viewResiduals.data(), nbObservations) = residuals.colwise().norm();
+    }
+}
+
+}  // namespace
+
 void computeResidualsHistogram(const sfmData::SfMData& sfmData,
                                BoxStats<double>& outStats,
                                utils::Histogram<double>* outHistogram,
@@ -32,27 +92,14 @@ void computeResidualsHistogram(const sfmData::SfMData& sfmData,
         return;
 
     // Collect residuals for each observation
+    std::map<IndexT, std::vector<double>> residualsPerView;
+    computeResidualsNormPerView(sfmData, specificViews, residualsPerView);
+
     std::vector<double> vecResiduals;
     vecResiduals.reserve(sfmData.getLandmarks().size());
-
-    for (const auto& track : sfmData.getLandmarks())
+    for (const auto& viewResiduals : residualsPerView)
     {
-        const aliceVision::sfmData::Observations& observations = track.second.getObservations();
-        for (const auto& obs : observations)
-        {
-            if (!specificViews.empty())
-            {
-                if (specificViews.count(obs.first) == 0)
-                    continue;
-            }
-            const sfmData::View& view = sfmData.getView(obs.first);
-            const aliceVision::geometry::Pose3 pose = sfmData.getPose(view).getTransform();
-            const std::shared_ptr<aliceVision::camera::IntrinsicBase> intrinsic = sfmData.getIntrinsics().find(view.getIntrinsicId())->second;
-            const Vec2 residual = intrinsic->residual(pose, track.second.X.homogeneous(), obs.second.getCoordinates());
-            vecResiduals.push_back(residual.norm());
-            // ALICEVISION_LOG_INFO("[AliceVision] sfmtstatistics::computeResidualsHistogram track: " << track.first << ", residual: " <<
-            // residual.norm());
-        }
+        vecResiduals.insert(vecResiduals.end(), viewResiduals.second.begin(), viewResiduals.second.end());
     }
 
     // ALICEVISION_LOG_INFO("[AliceVision] sfmtstatistics::computeResidualsHistogram vecResiduals.size(): " << vec_residuals.size());
@@ -331,19 +378,7 @@ void computeResidualsPerView(const sfmData::SfMData& sfmData,
 
     // Collect residuals (number of residuals per 3D points) of all landmarks visible in each view
     std::map<IndexT, std::vector<double>> residualsPerView;
-
-    for (const auto& landmark : sfmData.getLandmarks())
-    {
-        const aliceVision::sfmData::Observations& observations = landmark.second.getObservations();
-        for (const auto& obs : observations)
-        {
-            const sfmData::View& view = sfmData.getView(obs.first);
-            const aliceVision::geometry::Pose3 pose = sfmData.getPose(view).getTransform();
-            const std::shared_ptr<aliceVision::camera::IntrinsicBase> intrinsic = sfmData.getIntrinsics().find(view.getIntrinsicId())->second;
-            const Vec2 residual = intrinsic->residual(pose, landmark.second.X.homogeneous(), obs.second.getCoordinates());
-            residualsPerView[obs.first].push_back(residual.norm());
-        }
-    }
+    computeResidualsNormPerView(sfmData, std::set<IndexT>(), residualsPerView);
 
     std::vector<IndexT> viewKeys;
     for (const auto& v : sfmData.getViews())
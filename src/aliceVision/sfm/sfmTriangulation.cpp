@@ -10,9 +10,11 @@
 #include <aliceVision/robustEstimation/randSampling.hpp>
 #include <aliceVision/system/ProgressDisplay.hpp>
 #include <aliceVision/config.hpp>
+#include <aliceVision/alicevision_omp.hpp>
 
 #include <deque>
 #include <memory>
+#include <vector>
 
 namespace aliceVision {
 namespace sfm {
@@ -110,40 +112,49 @@ void StructureComputationRobust::triangulate(sfmData::SfMData& sfmData, std::mt1
 /// Invalid landmark are removed.
 void StructureComputationRobust::robustTriangulation(sfmData::SfMData& sfmData, std::mt19937& randomNumberGenerator) const
 {
-    std::deque<IndexT> rejectedId;
-
     system::ProgressDisplay progressDisplay;
     if (_bConsoleVerbose)
         progressDisplay = system::createConsoleProgressDisplay(sfmData.getLandmarks().size(), std::cout, "Robust triangulation progress:\n");
 
-#pragma omp parallel
-    for (sfmData::Landmarks::iterator iterTracks = sfmData.getLandmarks().begin(); iterTracks != sfmData.getLandmarks().end(); ++iterTracks)
+    // random access to the landmarks for the parallel loop
+    std::vector<sfmData::Landmarks::iterator> landmarkIts;
+    landmarkIts.reserve(sfmData.getLandmarks().size());
+    for (auto it = sfmData.getLandmarks().begin(); it != sfmData.getLandmarks().end(); ++it)
+        landmarkIts.push_back(it);
+
+    // one random generator per thread, seeded from the input generator
+    std::vector<std::mt19937> randomNumberGenerators;
+    for (int i = 0; i < omp_get_max_threads(); ++i)
+        randomNumberGenerators.emplace_back(randomNumberGenerator());
+
+    // each landmark is only written by its own iteration, the rejected ones are flagged and erased afterwards
+    std::vector<char> isRejected(landmarkIts.size(), 0);
+
+#pragma omp parallel for schedule(dynamic, 64)
+    for (int i = 0; i < landmarkIts.size(); ++i)
     {
-#pragma omp single nowait
+        if (_bConsoleVerbose)
         {
-            if (_bConsoleVerbose)
-            {
-                ++(progressDisplay);
-            }
-            Vec3 X;
-            if (robustTriangulation(sfmData, iterTracks->second.getObservations(), randomNumberGenerator, X))
-            {
-                iterTracks->second.X = X;
-            }
-            else
-            {
-                iterTracks->second.X = Vec3::Zero();
-#pragma omp critical
-                {
-                    rejectedId.push_front(iterTracks->first);
-                }
-            }
+            ++(progressDisplay);
+        }
+        sfmData::Landmark& landmark = landmarkIts[i]->second;
+        Vec3 X;
+        if (robustTriangulation(sfmData, landmark.getObservations(), randomNumberGenerators[omp_get_thread_num()], X))
+        {
+            landmark.X = X;
+        }
+        else
+        {
+            landmark.X = Vec3::Zero();
+            isRejected[i] = 1;
         }
     }
+
     // Erase the unsuccessful triangulated tracks
-    for (auto& it : rejectedId)
+    for (std::size_t i = 0; i < landmarkIts.size(); ++i)
     {
-        sfmData.getLandmarks().erase(it);
+        if (isRejected[i])
+            sfmData.getLandmarks().erase(landmarkIts[i]);
     }
 }
 
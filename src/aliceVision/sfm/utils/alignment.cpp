@@ -8,6 +8,7 @@
 #include <aliceVision/sfm/utils/alignment.hpp>
 #include <aliceVision/geometry/lie.hpp>
 #include <aliceVision/geometry/rigidTransformation3D.hpp>
+#include <aliceVision/stl/hash.hpp>
 #include <aliceVision/stl/regex.hpp>
 
 #include <boost/accumulators/accumulators.hpp>
@@ -21,6 +22,8 @@
 #include <algorithm>
 #include <regex>
 #include <numeric>
+#include <unordered_map>
+#include <unordered_set>
 
 #include <aliceVision/numeric/gps.hpp>
 
@@ -273,10 +276,11 @@ bool computeSimilarityFromCommonCameras_poseId(const sfmData::SfMData& sfmDataA,
     return true;
 }
 
-std::map<std::string, IndexT> retrieveMatchingFilepath(const sfmData::SfMData& sfmData, const std::string& filePatternMatching)
+std::unordered_map<std::string, IndexT> retrieveMatchingFilepath(const sfmData::SfMData& sfmData, const std::string& filePatternMatching)
 {
-    std::set<std::string> duplicates;
-    std::map<std::string, IndexT> uniqueFileparts;
+    const std::regex re(filePatternMatching);
+    std::unordered_set<std::string> duplicates;
+    std::unordered_map<std::string, IndexT> uniqueFileparts;
     for (auto& viewIt : sfmData.getViews())
     {
         const std::string& imagePath = viewIt.second->getImage().getImagePath();
@@ -287,7 +291,6 @@ std::map<std::string, IndexT> retrieveMatchingFilepath(const sfmData::SfMData& s
         }
         else
         {
-            std::regex re(filePatternMatching);
             std::smatch matches;
             if (std::regex_match(imagePath, matches, re))
             {
@@ -299,15 +302,10 @@ std::map<std::string, IndexT> retrieveMatchingFilepath(const sfmData::SfMData& s
             }
         }
         ALICEVISION_LOG_TRACE("retrieveMatchingFilepath: " << imagePath << " -> " << cumulatedValues);
-        auto it = uniqueFileparts.find(cumulatedValues);
-        if (it != uniqueFileparts.end())
+        if (!uniqueFileparts.emplace(cumulatedValues, viewIt.first).second)
         {
             duplicates.insert(cumulatedValues);
         }
-        else
-        {
-            uniqueFileparts[cumulatedValues] = viewIt.first;
-        }
     }
     for (const std::string& d : duplicates)
     {
@@ -316,28 +314,41 @@ std::map<std::string, IndexT> retrieveMatchingFilepath(const sfmData::SfMData& s
     return uniqueFileparts;
 }
 
-void matchViewsByFilePattern(const sfmData::SfMData& sfmDataA,
-                             const sfmData::SfMData& sfmDataB,
-                             const std::string& filePatternMatching,
-                             std::vector<std::pair<IndexT, IndexT>>& out_commonViewIds)
+/**
+ * @brief Hash join of the unique keys of the views of two scenes.
+ * @param[in] keysA The view of each unique key of the first scene
+ * @param[in] keysB The view of each unique key of the second scene
+ * @param[out] out_commonViewIds The pairs of views with the same key, sorted
+ */
+void joinViewsByKey(const std::unordered_map<std::string, IndexT>& keysA,
+                    const std::unordered_map<std::string, IndexT>& keysB,
+                    std::vector<std::pair<IndexT, IndexT>>& out_commonViewIds)
 {
     out_commonViewIds.clear();
-    std::map<std::string, IndexT> filepathValuesA = retrieveMatchingFilepath(sfmDataA, filePatternMatching);
-    std::map<std::string, IndexT> filepathValuesB = retrieveMatchingFilepath(sfmDataB, filePatternMatching);
-
-    using P = std::pair<std::string, IndexT>;
-    std::vector<P> commonMetadataValues;
-    std::set_intersection(filepathValuesA.begin(),
-                          filepathValuesA.end(),  // already sorted
-                          filepathValuesB.begin(),
-                          filepathValuesB.end(),  // already sorted
-                          std::back_inserter(commonMetadataValues),
-                          [](const P& p1, const P& p2) { return p1.first < p2.first; });
+    const bool isASmaller = keysA.size() <= keysB.size();
+    const auto& smallKeys = isASmaller ? keysA : keysB;
+    const auto& largeKeys = isASmaller ? keysB : keysA;
 
-    for (const P& p : commonMetadataValues)
+    for (const auto& keyIt : smallKeys)
     {
-        out_commonViewIds.emplace_back(filepathValuesA.at(p.first), filepathValuesB.at(p.first));
+        const auto it = largeKeys.find(keyIt.first);
+        if (it == largeKeys.end())
+            continue;
+        if (isASmaller)
+            out_commonViewIds.emplace_back(keyIt.second, it->second);
+        else
+            out_commonViewIds.emplace_back(it->second, keyIt.second);
     }
+    // deterministic order for the robust estimation
+    std::sort(out_commonViewIds.begin(), out_commonViewIds.end());
+}
+
+void matchViewsByFilePattern(const sfmData::SfMData& sfmDataA,
+                             const sfmData::SfMData& sfmDataB,
+                             const std::string& filePatternMatching,
+                             std::vector<std::pair<IndexT, IndexT>>& out_commonViewIds)
+{
+    joinViewsByKey(retrieveMatchingFilepath(sfmDataA, filePatternMatching), retrieveMatchingFilepath(sfmDataB, filePatternMatching), out_commonViewIds);
 }
 
 bool computeSimilarityFromCommonCameras_imageFileMatching(const sfmData::SfMData& sfmDataA,
@@ -360,10 +371,10 @@ bool computeSimilarityFromCommonCameras_imageFileMatching(const sfmData::SfMData
     return computeSimilarityFromCommonViews(sfmDataA, sfmDataB, commonViewIds, randomNumberGenerator, out_S, out_R, out_t);
 }
 
-std::map<std::string, IndexT> retrieveUniqueMetadataValues(const sfmData::SfMData& sfmData, const std::vector<std::string>& metadataList)
+std::unordered_map<std::string, IndexT> retrieveUniqueMetadataValues(const sfmData::SfMData& sfmData, const std::vector<std::string>& metadataList)
 {
-    std::set<std::string> duplicates;
-    std::map<std::string, IndexT> uniqueMetadataValues;
+    std::unordered_set<std::string> duplicates;
+    std::unordered_map<std::string, IndexT> uniqueMetadataValues;
     for (auto& viewIt : sfmData.getViews())
     {
         const std::map<std::string, std::string>& m = viewIt.second->getImage().getMetadata();
@@ -375,15 +386,10 @@ std::map<std::string, IndexT> retrieveUniqueMetadataValues(const sfmData::SfMDat
                 cumulatedValues += mIt->second;
         }
         ALICEVISION_LOG_TRACE("retrieveUniqueMetadataValues: " << viewIt.second->getImage().getImagePath() << " -> " << cumulatedValues);
-        auto it = uniqueMetadataValues.find(cumulatedValues);
-        if (it != uniqueMetadataValues.end())
+        if (!uniqueMetadataValues.emplace(cumulatedValues, viewIt.first).second)
         {
             duplicates.insert(cumulatedValues);
         }
-        else
-        {
-            uniqueMetadataValues[cumulatedValues] = viewIt.first;
-        }
     }
     for (const std::string& d : duplicates)
     {
@@ -397,22 +403,7 @@ void matchViewsByMetadataMatching(const sfmData::SfMData& sfmDataA,
                                   const std::vector<std::string>& metadataList,
                                   std::vector<std::pair<IndexT, IndexT>>& out_commonViewIds)
 {
-    out_commonViewIds.clear();
-    std::map<std::string, IndexT> metadataValuesA = retrieveUniqueMetadataValues(sfmDataA, metadataList);
-    std::map<std::string, IndexT> metadataValuesB = retrieveUniqueMetadataValues(sfmDataB, metadataList);
-
-    using P = std::pair<std::string, IndexT>;
-    std::vector<P> commonMetadataValues;
-    std::set_intersection(metadataValuesA.begin(),
-                          metadataValuesA.end(),  // already sorted
-                          metadataValuesB.begin(),
-                          metadataValuesB.end(),  // already sorted
-                          std::back_inserter(commonMetadataValues),
-                          [](const P& p1, const P& p2) { return p1.first < p2.first; });
-    for (const P& p : commonMetadataValues)
-    {
-        out_commonViewIds.emplace_back(metadataValuesA.at(p.first), metadataValuesB.at(p.first));
-    }
+    joinViewsByKey(retrieveUniqueMetadataValues(sfmDataA, metadataList), retrieveUniqueMetadataValues(sfmDataB, metadataList), out_commonViewIds);
 }
 
 bool computeSimilarityFromCommonCameras_metadataMatching(const sfmData::SfMData& sfmDataA,
@@ -541,6 +532,166 @@ bool computeSimilarityFromCommonMarkers(const sfmData::SfMData& sfmDataA,
     return true;
 }
 
+namespace {
+
+/// a feature of a view (observed by at most one landmark of a scene)
+struct ObservationKey
+{
+    IndexT viewId;
+    IndexT featureId;
+    feature::EImageDescriberType descType;
+
+    bool operator==(const ObservationKey& other) const
+    {
+        return viewId == other.viewId && featureId == other.featureId && descType == other.descType;
+    }
+};
+
+struct ObservationKeyHash
+{
+    std::size_t operator()(const ObservationKey& key) const
+    {
+        std::size_t seed = std::hash<IndexT>()(key.viewId);
+        stl::hash_combine(seed, key.featureId);
+        stl::hash_combine(seed, static_cast<int>(key.descType));
+        return seed;
+    }
+};
+
+}  // namespace
+
+void matchLandmarksByObservations(const sfmData::SfMData& sfmDataA,
+                                  const sfmData::SfMData& sfmDataB,
+                                  std::vector<std::pair<IndexT, IndexT>>& out_commonLandmarkIds)
+{
+    out_commonLandmarkIds.clear();
+
+    // hash table of the observations of the first scene in the views of the second scene
+    std::unordered_map<ObservationKey, IndexT, ObservationKeyHash> landmarkPerObservationA;
+    for (const auto& landmarkIt : sfmDataA.getLandmarks())
+    {
+        for (const auto& observationIt : landmarkIt.second.getObservations())
+        {
+            if (sfmDataB.getViews().count(observationIt.first))
+                landmarkPerObservationA.emplace(ObservationKey{observationIt.first, observationIt.second.getFeatureId(), landmarkIt.second.descType},
+                                                landmarkIt.first);
+        }
+    }
+
+    if (landmarkPerObservationA.empty())
+        return;
+
+    std::vector<IndexT> landmarkIdsB;
+    std::vector<const sfmData::Landmark*> landmarksB;
+    for (const auto& landmarkIt : sfmDataB.getLandmarks())
+    {
+        landmarkIdsB.push_back(landmarkIt.first);
+        landmarksB.push_back(&landmarkIt.second);
+    }
+
+    // probe with the observations of each landmark of the second scene: the landmark of the first scene with the most shared observations
+    std::vector<IndexT> bestLandmarkA(landmarksB.size(), UndefinedIndexT);
+    std::vector<std::size_t> bestNbVotes(landmarksB.size(), 0);
+
+#pragma omp parallel
+    {
+        std::vector<IndexT> candidates;
+
+#pragma omp for schedule(dynamic, 1024)
+        for (int b = 0; b < static_cast<int>(landmarksB.size()); ++b)
+        {
+            candidates.clear();
+            for (const auto& observationIt : landmarksB[b]->getObservations())
+            {
+                const auto it =
+                  landmarkPerObservationA.find(ObservationKey{observationIt.first, observationIt.second.getFeatureId(), landmarksB[b]->descType});
+                if (it != landmarkPerObservationA.end())
+                    candidates.push_back(it->second);
+            }
+            std::sort(candidates.begin(), candidates.end());
+
+            for (std::size_t i = 0; i < candidates.size();)
+            {
+                std::size_t j = i;
+                while (j < candidates.size() && candidates[j] == candidates[i])
+                    ++j;
+                if (j - i > bestNbVotes[b])
+                {
+                    bestNbVotes[b] = j - i;
+                    bestLandmarkA[b] = candidates[i];
+                }
+                i = j;
+            }
+        }
+    }
+
+    // one to one correspondences: each landmark of the first scene keeps its most supported landmark of the second scene
+    std::unordered_map<IndexT, std::size_t> bestPerLandmarkA;
+    for (std::size_t b = 0; b < landmarksB.size(); ++b)
+    {
+        if (bestLandmarkA[b] == UndefinedIndexT)
+            continue;
+        const auto it = bestPerLandmarkA.emplace(bestLandmarkA[b], b).first;
+        if (bestNbVotes[b] > bestNbVotes[it->second])
+            it->second = b;
+    }
+
+    out_commonLandmarkIds.reserve(bestPerLandmarkA.size());
+    for (const auto& bestIt : bestPerLandmarkA)
+        out_commonLandmarkIds.emplace_back(bestIt.first, landmarkIdsB[bestIt.second]);
+    // deterministic order for the robust estimation
+    std::sort(out_commonLandmarkIds.begin(), out_commonLandmarkIds.end());
+}
+
+bool computeSimilarityFromCommonLandmarks(const sfmData::SfMData& sfmDataA,
+                                          const sfmData::SfMData& sfmDataB,
+                                          std::mt19937& randomNumberGenerator,
+                                          double* out_S,
+                                          Mat3* out_R,
+                                          Vec3* out_t)
+{
+    assert(out_S != nullptr);
+    assert(out_R != nullptr);
+    assert(out_t != nullptr);
+
+    std::vector<std::pair<IndexT, IndexT>> commonLandmarkIds;
+    matchLandmarksByObservations(sfmDataA, sfmDataB, commonLandmarkIds);
+
+    ALICEVISION_LOG_DEBUG("Found " << commonLandmarkIds.size() << " common landmarks.");
+    if (commonLandmarkIds.size() < 3)
+    {
+        ALICEVISION_LOG_WARNING("Cannot compute similarities with less than 3 common landmarks.");
+        return false;
+    }
+
+    // Move input point in appropriate container
+    Mat xA(3, commonLandmarkIds.size());
+    Mat xB(3, commonLandmarkIds.size());
+    for (std::size_t i = 0; i < commonLandmarkIds.size(); ++i)
+    {
+        xA.col(i) = sfmDataA.getLandmarks().at(commonLandmarkIds[i].first).X;
+        xB.col(i) = sfmDataB.getLandmarks().at(commonLandmarkIds[i].second).X;
+    }
+
+    // Compute rigid transformation p'i = S R pi + t
+    double S;
+    Vec3 t;
+    Mat3 R;
+    std::vector<std::size_t> inliers;
+
+    if (!aliceVision::geometry::ACRansac_FindRTS(xA, xB, randomNumberGenerator, S, t, R, inliers, true))
+        return false;
+
+    ALICEVISION_LOG_DEBUG("There are " << commonLandmarkIds.size() << " common landmarks and " << inliers.size()
+                                       << " were used to compute the similarity transform.");
+
+    *out_S = S;
+    *out_R = R;
+    *out_t = t;
+
+    return true;
+}
+
 /**
  * Image orientation CCW
  */
@@ -120,6 +120,38 @@ bool computeSimilarityFromCommonMarkers(const sfmData::SfMData& sfmDataA,
                                         Mat3* out_R,
                                         Vec3* out_t);
 
+/**
+ * @brief Find the landmarks of two scenes that observe the same features of their common views
+ *        (e.g. overlapping clusters reconstructed independently).
+ *        The observations are joined with a hash table and each landmark is matched at most once,
+ *        to the landmark with the most shared observations.
+ *
+ * @param[in] sfmDataA
+ * @param[in] sfmDataB
+ * @param[out] out_commonLandmarkIds The pairs of landmark ids (in sfmDataA, in sfmDataB), sorted
+ */
+void matchLandmarksByObservations(const sfmData::SfMData& sfmDataA,
+                                  const sfmData::SfMData& sfmDataB,
+                                  std::vector<std::pair<IndexT, IndexT>>& out_commonLandmarkIds);
+
+/**
+ * @brief Compute a 7DOF rigid transform between the landmarks of two scenes that observe the same features of their common views.
+ *
+ * @param[in] sfmDataA
+ * @param[in] sfmDataB
+ * @param[in] randomNumberGenerator random number generator
+ * @param[out] out_S output scale factor
+ * @param[out] out_R output rotation 3x3 matrix
+ * @param[out] out_t output translation vector
+ * @return true if it finds a similarity transformation
+ */
+bool computeSimilarityFromCommonLandmarks(const sfmData::SfMData& sfmDataA,
+                                          const sfmData::SfMData& sfmDataB,
+                                          std::mt19937& randomNumberGenerator,
+                                          double* out_S,
+                                          Mat3* out_R,
+                                          Vec3* out_t);
+
 /**
  * @brief Apply a transformation the given SfMData
  *
@@ -10,6 +10,7 @@
 #include <cmath>
 #include <cstdio>
 #include <iostream>
+#include <random>
 
 #define BOOST_TEST_MODULE alignment
 
@@ -136,6 +137,58 @@ BOOST_AUTO_TEST_CASE(ALIGMENT_CamerasXAxis_checkRotation)
     }
 }
 
+// Test summary:
+// - Create a SfMData scene from a synthetic dataset with a ring of cameras
+// - Create a second scene with a subset of the views, renumbered landmarks and a similarity applied
+// - Find the common landmarks from their shared observations and estimate the similarity
+BOOST_AUTO_TEST_CASE(ALIGMENT_commonLandmarks)
+{
+    const int nviews = 12;
+    const int npoints = 60;
+    const NViewDatasetConfigurator config;
+    const NViewDataSet d = NRealisticCamerasRing(nviews, npoints, config);
+
+    const SfMData sfmDataA = getInputScene(d, config, EINTRINSIC::PINHOLE_CAMERA, EDISTORTION::DISTORTION_NONE);
+
+    // the second scene only shares half of the views, its landmarks are renumbered
+    SfMData sfmDataB = sfmDataA;
+    for (int i = nviews / 2; i < nviews; ++i)
+        sfmDataB.getViews().erase(i);
+    sfmDataB.getLandmarks().clear();
+    for (const auto& landmarkIt : sfmDataA.getLandmarks())
+    {
+        Landmark landmark = landmarkIt.second;
+        for (int i = nviews / 2; i < nviews; ++i)
+            landmark.getObservations().erase(i);
+        sfmDataB.getLandmarks()[1000 + 2 * landmarkIt.first] = landmark;
+    }
+
+    const double aS = 2.5;
+    const Mat3 aR(Eigen::AngleAxisd(0.3, Vec3::UnitX()) * Eigen::AngleAxisd(-1.2, Vec3::UnitY()));
+    const Vec3 at(1.0, -2.0, 0.5);
+    applyTransform(sfmDataB, aS, aR, at);
+
+    std::vector<std::pair<IndexT, IndexT>> commonLandmarkIds;
+    matchLandmarksByObservations(sfmDataA, sfmDataB, commonLandmarkIds);
+    BOOST_CHECK_EQUAL(commonLandmarkIds.size(), npoints);
+    for (const auto& commonLandmark : commonLandmarkIds)
+        BOOST_CHECK_EQUAL(commonLandmark.second, 1000 + 2 * commonLandmark.first);
+
+    std::mt19937 randomNumberGenerator(0);
+    double bS;
+    Mat3 bR;
+    Vec3 bt;
+    BOOST_CHECK(computeSimilarityFromCommonLandmarks(sfmDataA, sfmDataB, randomNumberGenerator, &bS, &bR, &bt));
+    BOOST_CHECK_CLOSE(bS, aS, 1e-4);
+    EXPECT_MATRIX_NEAR(bR, aR, 1e-6);
+    EXPECT_MATRIX_NEAR(bt, at, 1e-5);
+
+    // no common view
+    SfMData sfmDataC = sfmDataB;
+    sfmDataC.getViews().clear();
+    BOOST_CHECK(!computeSimilarityFromCommonLandmarks(sfmDataA, sfmDataC, randomNumberGenerator, &bS, &bR, &bt));
+}
+
 // Translation a synthetic scene into a valid SfMData scene.
 // => A synthetic scene is used:
 //    a random noise between [-.5,.5] is added on observed data points
@@ -8,6 +8,8 @@
 #include "syntheticScene.hpp"
 #include <aliceVision/sfm/sfm.hpp>
 
+#include <algorithm>
+#include <cmath>
 #include <random>
 #include <iostream>
 
@@ -174,5 +176,100 @@ sfmData::SfMData getInputRigScene(const NViewDataSet& d, const NViewDatasetConfi
     return sfmData;
 }
 
+sfmData::SfMData generateSyntheticAerialScene(const SyntheticAerialSceneParams& params)
+{
+    sfmData::SfMData sfmData;
+
+    std::mt19937 generator(params.seed);
+    std::normal_distribution<double> rotationDistribution(0.0, params.rotationJitter);
+    std::uniform_real_distribution<double> uniformDistribution(0.0, 1.0);
+
+    // regular grid of views, with a unit spacing
+    const int nbCols = std::max(1, static_cast<int>(std::ceil(std::sqrt(static_cast<double>(params.nbViews)))));
+    const int nbRows = std::max(1, static_cast<int>((params.nbViews + nbCols - 1) / nbCols));
+
+    // a landmark is seen by the views of a (footprint x footprint) window of the grid
+    const double footprint = std::sqrt(std::max(1.0, params.meanTrackLength));
+    const double altitude = footprint * params.focalLength / params.imageWidth;
+
+    const IndexT intrinsicId = 0;
+    auto intrinsic = camera::createPinhole(camera::EDISTORTION::DISTORTION_NONE,
+                                           camera::EUNDISTORTION::UNDISTORTION_NONE,
+                                           params.imageWidth,
+                                           params.imageHeight,
+                                           params.focalLength,
+                                           params.focalLength,
+                                           0.0,
+                                           0.0);
+    sfmData.getIntrinsics().emplace(intrinsicId, intrinsic);
+
+    // camera looking down (camera z axis along the world -z axis)
+    const Mat3 nadirRotation = Vec3(1.0, -1.0, -1.0).asDiagonal();
+
+    std::vector<geometry::Pose3> poses(params.nbViews);
+    for (std::size_t viewId = 0; viewId < params.nbViews; ++viewId)
+    {
+        const Vec3 center(viewId % nbCols, viewId / nbCols, altitude);
+        const Vec3 jitter(rotationDistribution(generator), rotationDistribution(generator), rotationDistribution(generator));
+        poses[viewId] = geometry::Pose3(SO3::expm(jitter) * nadirRotation, center);
+
+        auto view = std::make_shared<sfmData::View>("", viewId, intrinsicId, viewId, params.imageWidth, params.imageHeight);
+        sfmData.getViews().emplace(viewId, view);
+        sfmData.setPose(*view, sfmData::CameraPose(poses[viewId]));
+    }
+
+    // landmarks on the terrain, uniformly distributed over the covered area
+    const std::size_t nbLandmarks = static_cast<std::size_t>(params.nbViews * params.nbObservationsPerView / std::max(1.0, params.meanTrackLength));
+    const double margin = 0.5 * footprint;
+    const double minX = -margin;
+    const double minY = -margin;
+    const double sizeX = (nbCols - 1) + 2.0 * margin;
+    const double sizeY = (nbRows - 1) + 2.0 * margin;
+
+    // views with a different orientation may see a landmark slightly outside of their nominal footprint
+    const int searchRadius = static_cast<int>(std::ceil(footprint)) + 1;
+
+    std::vector<IndexT> nbFeaturesPerView(params.nbViews, 0);
+    const double unknownScale = 0.0;
+
+    for (std::size_t landmarkId = 0; landmarkId < nbLandmarks; ++landmarkId)
+    {
+        sfmData::Landmark landmark;
+        landmark.X = Vec3(minX + sizeX * uniformDistribution(generator),
+                          minY + sizeY * uniformDistribution(generator),
+                          params.terrainRelief * altitude * (2.0 * uniformDistribution(generator) - 1.0));
+        landmark.descType = feature::EImageDescriberType::UNKNOWN;
+
+        const int col = static_cast<int>(std::round(landmark.X(0)));
+        const int row = static_cast<int>(std::round(landmark.X(1)));
+
+        for (int r = std::max(0, row - searchRadius); r <= std::min(nbRows - 1, row + searchRadius); ++r)
+        {
+            for (int c = std::max(0, col - searchRadius); c <= std::min(nbCols - 1, col + searchRadius); ++c)
+            {
+                const std::size_t viewId = static_cast<std::size_t>(r) * nbCols + c;
+                if (viewId >= params.nbViews)
+                    continue;
+
+                const geometry::Pose3& pose = poses[viewId];
+                if (pose.depth(landmark.X) <= 0.0)
+                    continue;
+
+                const Vec2 pt = intrinsic->project(pose, landmark.X.homogeneous(), true);
+                if (!intrinsic->isVisible(pt))
+                    continue;
+
+                landmark.getObservations()[viewId] = sfmData::Observation(pt, nbFeaturesPerView[viewId]++, unknownScale);
+            }
+        }
+
+        // keep only landmarks which can be triangulated
+        if (landmark.getObservations().size() >= 2)
+            sfmData.getLandmarks().emplace(landmarkId, std::move(landmark));
+    }
+
+    return sfmData;
+}
+
 }  // namespace sfm
 }  // namespace aliceVision
@@ -92,5 +92,38 @@ sfmData::SfMData getInputScene(const NViewDataSet& d, const NViewDatasetConfigur
 // As only one intrinsic is defined we used shared intrinsic
 sfmData::SfMData getInputRigScene(const NViewDataSet& d, const NViewDatasetConfigurator& config, camera::EINTRINSIC eintrinsic, camera::EDISTORTION edistortion);
 
+/**
+ * @brief Parameters of a large synthetic aerial scene (see generateSyntheticAerialScene).
+ */
+struct SyntheticAerialSceneParams
+{
+    /// number of views, placed on a regular grid
+    std::size_t nbViews = 100;
+    /// target mean number of observations per landmark (track length)
+    double meanTrackLength = 6.0;
+    /// target mean number of observations per view
+    std::size_t nbObservationsPerView = 500;
+    /// image size and focal length in pixels (shared pinhole intrinsic without distortion)
+    unsigned int imageWidth = 1000;
+    unsigned int imageHeight = 1000;
+    double focalLength = 1000.0;
+    /// standard deviation of the camera orientation around the nadir direction (radians)
+    double rotationJitter = 0.02;
+    /// amplitude of the terrain relief, as a ratio of the flight altitude
+    double terrainRelief = 0.1;
+    /// random generator seed
+    unsigned int seed = 0;
+};
+
+/**
+ * @brief Generate a synthetic aerial survey: views on a regular grid looking down at a terrain.
+ *        Unlike NViewDataSet, each landmark is only seen by the views that cover it,
+ *        so that the number of observations grows linearly with the number of views.
+ *        The flight altitude is chosen so that the mean track length matches the requested one.
+ * @param[in] params The scene parameters
+ * @return the synthetic scene with views, poses, intrinsic and landmarks (observations without noise)
+ */
+sfmData::SfMData generateSyntheticAerialScene(const SyntheticAerialSceneParams& params);
+
 }  // namespace sfm
 }  // namespace aliceVision
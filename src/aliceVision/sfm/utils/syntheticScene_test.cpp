@@ -0,0 +1,49 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/sfm/utils/syntheticScene.hpp>
+#include <aliceVision/sfm/utils/statistics.hpp>
+
+#define BOOST_TEST_MODULE syntheticScene
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/tools/floating_point_comparison.hpp>
+
+using namespace aliceVision;
+using namespace aliceVision::sfm;
+
+BOOST_AUTO_TEST_CASE(syntheticScene_aerialTrackStatistics)
+{
+    SyntheticAerialSceneParams params;
+    params.nbViews = 900;
+    params.meanTrackLength = 9.0;
+    params.nbObservationsPerView = 200;
+
+    const sfmData::SfMData sfmData = generateSyntheticAerialScene(params);
+
+    BOOST_CHECK_EQUAL(sfmData.getViews().size(), params.nbViews);
+    BOOST_CHECK_EQUAL(sfmData.getPoses().size(), params.nbViews);
+    BOOST_CHECK_EQUAL(sfmData.getIntrinsics().size(), 1);
+
+    std::size_t nbObservations = 0;
+    for (const auto& landmarkPair : sfmData.getLandmarks())
+    {
+        BOOST_CHECK_GE(landmarkPair.second.getObservations().size(), 2);
+        nbObservations += landmarkPair.second.getObservations().size();
+    }
+
+    // the views on the border of the grid see fewer landmarks
+    const double meanTrackLength = double(nbObservations) / sfmData.getLandmarks().size();
+    BOOST_CHECK_GT(meanTrackLength, 0.7 * params.meanTrackLength);
+    BOOST_CHECK_LT(meanTrackLength, 1.1 * params.meanTrackLength);
+
+    const double nbObservationsPerView = double(nbObservations) / sfmData.getViews().size();
+    BOOST_CHECK_GT(nbObservationsPerView, 0.7 * params.nbObservationsPerView);
+    BOOST_CHECK_LT(nbObservationsPerView, 1.1 * params.nbObservationsPerView);
+
+    // the observations are exact projections
+    BOOST_CHECK_SMALL(RMSE(sfmData), 1e-6);
+}
@@ -0,0 +1,543 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "uncertainty.hpp"
+
+#include <aliceVision/sfmData/SfMData.hpp>
+#include <aliceVision/sfm/bundle/manifolds/se3.hpp>
+#include <aliceVision/system/Logger.hpp>
+
+#include <Eigen/OrderingMethods>
+#include <Eigen/SparseCholesky>
+
+#include <algorithm>
+#include <vector>
+
+namespace aliceVision {
+namespace sfm {
+
+bool SparseSelectedInverse::compute(const Eigen::SparseMatrix<double>& matrix)
+{
+    const Eigen::SimplicialLLT<Eigen::SparseMatrix<double>, Eigen::Upper, Eigen::AMDOrdering<int>> llt(matrix);
+    if (llt.info() != Eigen::Success)
+        return false;
+
+    _permutation = llt.permutationP().indices();
+
+    // the inverse has the pattern of the factor, the diagonal is the first entry of each column and the rows are sorted
+    _inverse = llt.matrixL().nestedExpression();
+    _inverse.makeCompressed();
+    const std::vector<double> factor(_inverse.valuePtr(), _inverse.valuePtr() + _inverse.nonZeros());
+
+    const int* outer = _inverse.outerIndexPtr();
+    const int* inner = _inverse.innerIndexPtr();
+    double* values = _inverse.valuePtr();
+
+    // from (inverse * L) = L^-T:
+    // inverse(i, j) = (delta(i, j) / L(j, j) - sum_{k > j} L(k, j) inverse(i, k)) / L(j, j)
+    // the rows k > j of the column j are in the pattern of the columns k (elimination tree), so only selected entries are needed
+    std::vector<double> sums;
+    for (int j = static_cast<int>(_inverse.cols()) - 1; j >= 0; --j)
+    {
+        const int begin = outer[j] + 1;
+        const int end = outer[j + 1];
+        sums.assign(end - begin, 0.0);
+
+        // merge the rows of the column j with the (sorted) rows of the already computed column min(i, k)
+        for (int p = begin; p < end; ++p)
+        {
+            const int column = inner[p];
+            int r = outer[column];
+            for (int q = p; q < end; ++q)
+            {
+                while (inner[r] < inner[q])
+                    ++r;
+                // inverse(k, i) with k >= i, stored in the column i
+                sums[p - begin] += factor[q] * values[r];
+                // inverse(k, i) with k > i, used by the row k of the column j
+                if (q > p)
+                    sums[q - begin] += factor[p] * values[r];
+            }
+        }
+
+        const double diagonal = factor[outer[j]];
+        double sum = 0.0;
+        for (int p = begin; p < end; ++p)
+        {
+            values[p] = -sums[p - begin] / diagonal;
+            sum += factor[p] * values[p];
+        }
+        values[outer[j]] = (1.0 / diagonal - sum) / diagonal;
+    }
+
+    return true;
+}
+
+double SparseSelectedInverse::operator()(int i, int j) const
+{
+    const int row = std::max(_permutation(i), _permutation(j));
+    const int col = std::min(_permutation(i), _permutation(j));
+    return _inverse.coeff(row, col);
+}
+
+namespace {
+
+/// a view with a defined pose and intrinsic
+struct ViewInfo
+{
+    const camera::IntrinsicBase* intrinsic = nullptr;
+    /// world to camera transformation
+    Eigen::Matrix4d transform;
+    /// index of the refined pose, -1 for a fixed pose
+    int camera = -1;
+    /// adjoint of the rig sub-pose (the pose parameters are the ones of the rig)
+    PoseCovariance adjoint = PoseCovariance::Identity();
+};
+
+/// linearized observation of a landmark
+struct LinearizedObservation
+{
+    int camera;
+    Eigen::Matrix<double, 2, 6> jacobianPose;
+    Eigen::Matrix<double, 2, 3> jacobianLandmark;
+};
+
+/**
+ * @brief Linearized observations of a landmark and inverse of its 3x3 block of the normal matrix.
+ */
+class LandmarkLinearization
+{
+  public:
+    LandmarkLinearization(const std::vector<IndexT>& viewIds, const std::vector<ViewInfo>& viewInfos)
+      : _viewIds(viewIds),
+        _viewInfos(viewInfos)
+    {
+        sfm::SE3ManifoldLeft(true, true).PlusJacobian(nullptr, _poseTangent.data());
+    }
+
+    /**
+     * @brief Linearize the observations of the landmark.
+     * @return false if the landmark position is poorly constrained
+     */
+    bool linearize(const sfmData::Landmark& landmark)
+    {
+        observations.clear();
+        Mat3 normal = Mat3::Zero();
+
+        const Vec4 X = landmark.X.homogeneous();
+        for (const auto& observationPair : landmark.getObservations())
+        {
+            const auto it = std::lower_bound(_viewIds.begin(), _viewIds.end(), observationPair.first);
+            if (it == _viewIds.end() || *it != observationPair.first)
+                continue;
+
+            const ViewInfo& viewInfo = _viewInfos.at(std::distance(_viewIds.begin(), it));
+            if (viewInfo.intrinsic == nullptr || (viewInfo.transform.row(2) * X) <= 0.0)
+                continue;
+
+            const sfmData::Observation& observation = observationPair.second;
+            const double scale = (observation.getScale() > 1e-12) ? observation.getScale() : 1.0;
+
+            LinearizedObservation linearized;
+            linearized.camera = viewInfo.camera;
+            linearized.jacobianLandmark = viewInfo.intrinsic->getDerivativeProjectWrtPoint3(viewInfo.transform, X) / scale;
+            if (viewInfo.camera >= 0)
+            {
+                linearized.jacobianPose =
+                  viewInfo.intrinsic->getDerivativeProjectWrtPoseLeft(viewInfo.transform, X) * _poseTangent * viewInfo.adjoint / scale;
+            }
+
+            normal += linearized.jacobianLandmark.transpose() * linearized.jacobianLandmark;
+            observations.push_back(linearized);
+        }
+
+        if (observations.size() < 2)
+            return false;
+
+        // reject the landmarks with a (numerically) singular block, e.g. seen from a single direction
+        const Eigen::SelfAdjointEigenSolver<Mat3> solver(normal);
+        if (solver.info() != Eigen::Success || solver.eigenvalues()(0) <= 1e-9 * solver.eigenvalues()(2))
+            return false;
+
+        normalInverse = solver.eigenvectors() * solver.eigenvalues().cwiseInverse().asDiagonal() * solver.eigenvectors().transpose();
+        return true;
+    }
+
+    std::vector<LinearizedObservation> observations;
+    Mat3 normalInverse;
+
+  private:
+    const std::vector<IndexT>& _viewIds;
+    const std::vector<ViewInfo>& _viewInfos;
+    Eigen::Matrix<double, 16, 6, Eigen::RowMajor> _poseTangent;
+};
+
+/**
+ * @brief Adjoint of a rigid transformation, for the (rotation, translation) tangent vectors of the left perturbation:
+ *        T * exp(delta) * T^-1 = exp(adjoint * delta)
+ */
+PoseCovariance getAdjoint(const geometry::Pose3& pose)
+{
+    PoseCovariance adjoint = PoseCovariance::Zero();
+    const Mat3 R = pose.rotation();
+    adjoint.block<3, 3>(0, 0) = R;
+    adjoint.block<3, 3>(3, 3) = R;
+    adjoint.block<3, 3>(3, 0) = SO3::skew(pose.translation()) * R;
+    return adjoint;
+}
+
+}  // namespace
+
+bool computeCovariances(const sfmData::SfMData& sfmData,
+                        const CovarianceEstimationParams& params,
+                        PosesCovariance& out_posesCovariance,
+                        LandmarksCovariance& out_landmarksCovariance)
+{
+    out_posesCovariance.clear();
+    out_landmarksCovariance.clear();
+
+    // refined poses
+    std::vector<IndexT> poseIds;
+    std::map<IndexT, int> cameraPerPose;
+    std::vector<IndexT> lockedPoseIds;
+    for (const auto& posePair : sfmData.getPoses())
+    {
+        const sfmData::CameraPose& pose = posePair.second;
+        if (pose.getState() == EEstimatorParameterState::IGNORED)
+            continue;
+        if (pose.isLocked() || pose.getState() == EEstimatorParameterState::CONSTANT)
+        {
+            lockedPoseIds.push_back(posePair.first);
+            continue;
+        }
+        cameraPerPose[posePair.first] = static_cast<int>(poseIds.size());
+        poseIds.push_back(posePair.first);
+    }
+    const int nbCameras = static_cast<int>(poseIds.size());
+    if (nbCameras == 0)
+        return true;
+
+    // views with a defined pose and intrinsic
+    std::vector<IndexT> viewIds;
+    for (const auto& viewPair : sfmData.getViews())
+        viewIds.push_back(viewPair.first);
+    std::vector<ViewInfo> viewInfos(viewIds.size());
+    for (std::size_t v = 0; v < viewIds.size(); ++v)
+    {
+        const sfmData::View& view = sfmData.getView(viewIds[v]);
+        if (!sfmData.isPoseAndIntrinsicDefined(&view) || sfmData.getAbsolutePose(view.getPoseId()).getState() == EEstimatorParameterState::IGNORED)
+            continue;
+
+        ViewInfo& viewInfo = viewInfos[v];
+        viewInfo.intrinsic = sfmData.getIntrinsicPtr(view.getIntrinsicId());
+        viewInfo.transform = sfmData.getPose(view).getTransform().getHomogeneous();
+        const auto cameraIt = cameraPerPose.find(view.getPoseId());
+        viewInfo.camera = (cameraIt != cameraPerPose.end()) ? cameraIt->second : -1;
+        if (view.isPartOfRig() && !view.isPoseIndependant())
+            viewInfo.adjoint = getAdjoint(sfmData.getRig(view).getSubPose(view.getSubPoseId()).pose);
+    }
+
+    std::vector<const sfmData::Landmark*> landmarks;
+    std::vector<IndexT> landmarkIds;
+    landmarks.reserve(sfmData.getLandmarks().size());
+    for (const auto& landmarkPair : sfmData.getLandmarks())
+    {
+        landmarkIds.push_back(landmarkPair.first);
+        landmarks.push_back(&landmarkPair.second);
+    }
+    const int nbLandmarks = static_cast<int>(landmarks.size());
+
+    // landmarks seen by each refined pose
+    std::vector<std::vector<int>> landmarksPerCamera(nbCameras);
+    std::vector<std::size_t> nbObservationsPerCamera(nbCameras, 0);
+    for (int l = 0; l < nbLandmarks; ++l)
+    {
+        for (const auto& observationPair : landmarks[l]->getObservations())
+        {
+            const auto it = std::lower_bound(viewIds.begin(), viewIds.end(), observationPair.first);
+            if (it == viewIds.end() || *it != observationPair.first)
+                continue;
+            const int camera = viewInfos[std::distance(viewIds.begin(), it)].camera;
+            if (camera < 0)
+                continue;
+            ++nbObservationsPerCamera[camera];
+            // the views of a rig observe the same landmark with the same pose
+            if (landmarksPerCamera[camera].empty() || landmarksPerCamera[camera].back() != l)
+                landmarksPerCamera[camera].push_back(l);
+        }
+    }
+
+    // gauge: index of each pose parameter in the reduced camera system, -1 for the fixed parameters
+    std::vector<int> parameterIndexes(6 * nbCameras, 0);
+    int nbParameters = 0;
+    {
+        Vec3 referenceCenter;
+        if (lockedPoseIds.empty())
+        {
+            const int reference = static_cast<int>(std::distance(
+              nbObservationsPerCamera.begin(), std::max_element(nbObservationsPerCamera.begin(), nbObservationsPerCamera.end())));
+            std::fill(parameterIndexes.begin() + 6 * reference, parameterIndexes.begin() + 6 * reference + 6, -1);
+            referenceCenter = sfmData.getAbsolutePose(poseIds[reference]).getTransform().center();
+            ALICEVISION_LOG_INFO("Uncertainty: the gauge is fixed by the pose " << poseIds[reference] << ".");
+        }
+        else
+        {
+            referenceCenter = sfmData.getAbsolutePose(lockedPoseIds.front()).getTransform().center();
+        }
+
+        if (lockedPoseIds.size() < 2)
+        {
+            // the scale changes the translation of the farthest pose along the direction to the reference center
+            int farthest = -1;
+            double farthestDistance = 0.0;
+            for (int c = 0; c < nbCameras; ++c)
+            {
+                const double distance = (sfmData.getAbsolutePose(poseIds[c]).getTransform().center() - referenceCenter).norm();
+                if (parameterIndexes[6 * c] >= 0 && distance > farthestDistance)
+                {
+                    farthest = c;
+                    farthestDistance = distance;
+                }
+            }
+            if (farthest >= 0)
+            {
+                const geometry::Pose3 pose = sfmData.getAbsolutePose(poseIds[farthest]).getTransform();
+                Eigen::Index axis;
+                (pose.rotation() * (referenceCenter - pose.center())).cwiseAbs().maxCoeff(&axis);
+                parameterIndexes[6 * farthest + 3 + axis] = -1;
+                ALICEVISION_LOG_INFO("Uncertainty: the scale is fixed by the translation " << axis << " of the pose " << poseIds[farthest] << ".");
+            }
+        }
+
+        for (int& index : parameterIndexes)
+        {
+            if (index >= 0)
+                index = nbParameters++;
+        }
+    }
+
+    if (nbParameters == 0)
+    {
+        for (int c = 0; c < nbCameras; ++c)
+            out_posesCovariance[poseIds[c]] = PoseCovariance::Zero();
+        return true;
+    }
+
+    // Schur complement of the landmarks, one row of 6x6 blocks per refined pose (upper triangular part)
+    std::vector<std::vector<int>> rowsCameras(nbCameras);
+    std::vector<std::vector<PoseCovariance>> rowsBlocks(nbCameras);
+
+#pragma omp parallel
+    {
+        LandmarkLinearization linearization(viewIds, viewInfos);
+        std::vector<int> landmarkCameras;
+
+#pragma omp for schedule(dynamic)
+        for (int c = 0; c < nbCameras; ++c)
+        {
+            std::vector<int>& rowCameras = rowsCameras[c];
+            std::vector<PoseCovariance>& rowBlocks = rowsBlocks[c];
+
+            // pattern of the row: the refined poses (after this one) that see a common landmark
+            rowCameras.push_back(c);
+            for (const int l : landmarksPerCamera[c])
+            {
+                for (const auto& observationPair : landmarks[l]->getObservations())
+                {
+                    const auto it = std::lower_bound(viewIds.begin(), viewIds.end(), observationPair.first);
+                    if (it != viewIds.end() && *it == observationPair.first && viewInfos[std::distance(viewIds.begin(), it)].camera > c)
+                        rowCameras.push_back(viewInfos[std::distance(viewIds.begin(), it)].camera);
+                }
+            }
+            std::sort(rowCameras.begin(), rowCameras.end());
+            rowCameras.erase(std::unique(rowCameras.begin(), rowCameras.end()), rowCameras.end());
+            rowBlocks.assign(rowCameras.size(), PoseCovariance::Zero());
+
+            for (const int l : landmarksPerCamera[c])
+            {
+                if (!linearization.linearize(*landmarks[l]))
+                    continue;
+
+                // landmark block of this pose
+                Eigen::Matrix<double, 6, 3> cameraBlock = Eigen::Matrix<double, 6, 3>::Zero();
+                for (const LinearizedObservation& observation : linearization.observations)
+                {
+                    if (observation.camera != c)
+                        continue;
+                    cameraBlock += observation.jacobianPose.transpose() * observation.jacobianLandmark;
+                    rowBlocks.front() += observation.jacobianPose.transpose() * observation.jacobianPose;
+                }
+                const Eigen::Matrix<double, 6, 3> reducedBlock = cameraBlock * linearization.normalInverse;
+
+                for (const LinearizedObservation& observation : linearization.observations)
+                {
+                    if (observation.camera < c)
+                        continue;
+                    const auto cameraIt = std::lower_bound(rowCameras.begin(), rowCameras.end(), observation.camera);
+                    rowBlocks[std::distance(rowCameras.begin(), cameraIt)] -= reducedBlock * (observation.jacobianLandmark.transpose() * observation.jacobianPose);
+                }
+            }
+        }
+    }
+
+    // reduced camera system, without the fixed parameters
+    Eigen::SparseMatrix<double, Eigen::RowMajor> reducedRowMajor(nbParameters, nbParameters);
+    {
+        std::size_t nbNonZeros = 0;
+        for (int c = 0; c < nbCameras; ++c)
+            nbNonZeros += 36 * rowsCameras[c].size();
+        reducedRowMajor.reserve(nbNonZeros);
+    }
+    for (int c = 0; c < nbCameras; ++c)
+    {
+        for (int a = 0; a < 6; ++a)
+        {
+            const int row = parameterIndexes[6 * c + a];
+            if (row < 0)
+                continue;
+
+            reducedRowMajor.startVec(row);
+            for (std::size_t b = 0; b < rowsCameras[c].size(); ++b)
+            {
+                const int c2 = rowsCameras[c][b];
+                for (int a2 = (c2 == c) ? a : 0; a2 < 6; ++a2)
+                {
+                    const int col = parameterIndexes[6 * c2 + a2];
+                    if (col < 0)
+                        continue;
+                    double value = rowsBlocks[c][b](a, a2);
+                    if (row == col)
+                        value += params.damping * std::max(value, 1e-12);
+                    reducedRowMajor.insertBack(row, col) = value;
+                }
+            }
+        }
+    }
+    reducedRowMajor.finalize();
+
+    ALICEVISION_LOG_INFO("Uncertainty: inversion of the reduced camera system (" << nbParameters << " parameters, " << reducedRowMajor.nonZeros()
+                                                                                 << " non zeros).");
+
+    SparseSelectedInverse inverse;
+    if (!inverse.compute(Eigen::SparseMatrix<double>(reducedRowMajor)))
+    {
+        ALICEVISION_LOG_ERROR("Uncertainty: the reduced camera system is not positive definite.");
+        return false;
+    }
+
+    const auto getCovarianceBlock = [&](int c1, int c2) -> PoseCovariance {
+        PoseCovariance block = PoseCovariance::Zero();
+        for (int a1 = 0; a1 < 6; ++a1)
+        {
+            const int i = parameterIndexes[6 * c1 + a1];
+            for (int a2 = 0; a2 < 6 && i >= 0; ++a2)
+            {
+                const int j = parameterIndexes[6 * c2 + a2];
+                if (j >= 0)
+                    block(a1, a2) = inverse(i, j);
+            }
+        }
+        return block;
+    };
+
+    // covariances of the poses and of the poses that see a common landmark, in the blocks of the reduced camera system
+#pragma omp parallel for schedule(dynamic)
+    for (int c = 0; c < nbCameras; ++c)
+    {
+        for (std::size_t b = 0; b < rowsCameras[c].size(); ++b)
+            rowsBlocks[c][b] = getCovarianceBlock(c, rowsCameras[c][b]);
+    }
+
+    for (int c = 0; c < nbCameras; ++c)
+        out_posesCovariance[poseIds[c]] = rowsBlocks[c].front();
+
+    if (!params.computeLandmarks)
+        return true;
+
+    const auto getCovarianceBlockOfRow = [&](int c1, int c2) -> const PoseCovariance& {
+        const std::vector<int>& rowCameras = rowsCameras[c1];
+        return rowsBlocks[c1][std::distance(rowCameras.begin(), std::lower_bound(rowCameras.begin(), rowCameras.end(), c2))];
+    };
+    const auto getCrossCovariance = [&](int c1, int c2) -> PoseCovariance {
+        if (c1 > c2)
+            return getCovarianceBlockOfRow(c2, c1).transpose();
+        return getCovarianceBlockOfRow(c1, c2);
+    };
+
+    // landmarks covariances: inverse(V) + inverse(V) * W^T * S^-1 * W * inverse(V)
+    std::vector<Mat3> landmarksCovariance(nbLandmarks);
+    std::vector<char> isLandmarkValid(nbLandmarks, 0);
+
+#pragma omp parallel
+    {
+        LandmarkLinearization linearization(viewIds, viewInfos);
+        std::vector<int> cameras;
+        std::vector<Eigen::Matrix<double, 6, 3>> cameraBlocks;
+
+#pragma omp for schedule(dynamic, 256)
+        for (int l = 0; l < nbLandmarks; ++l)
+        {
+            if (!linearization.linearize(*landmarks[l]))
+                continue;
+
+            // landmark block of each refined pose
+            cameras.clear();
+            cameraBlocks.clear();
+            for (const LinearizedObservation& observation : linearization.observations)
+            {
+                if (observation.camera < 0)
+                    continue;
+                const std::size_t i = std::distance(cameras.begin(), std::find(cameras.begin(), cameras.end(), observation.camera));
+                if (i == cameras.size())
+                {
+                    cameras.push_back(observation.camera);
+                    cameraBlocks.push_back(Eigen::Matrix<double, 6, 3>::Zero());
+                }
+                cameraBlocks[i] += observation.jacobianPose.transpose() * observation.jacobianLandmark;
+            }
+
+            Mat3 posesTerm = Mat3::Zero();
+            for (std::size_t i = 0; i < cameras.size(); ++i)
+            {
+                posesTerm += cameraBlocks[i].transpose() * getCovarianceBlockOfRow(cameras[i], cameras[i]) * cameraBlocks[i];
+                for (std::size_t j = i + 1; j < cameras.size(); ++j)
+                {
+                    const Mat3 crossTerm = cameraBlocks[i].transpose() * getCrossCovariance(cameras[i], cameras[j]) * cameraBlocks[j];
+                    posesTerm += crossTerm + crossTerm.transpose();
+                }
+            }
+
+            landmarksCovariance[l] = linearization.normalInverse + linearization.normalInverse * posesTerm * linearization.normalInverse;
+            isLandmarkValid[l] = 1;
+        }
+    }
+
+    for (int l = 0; l < nbLandmarks; ++l)
+    {
+        if (isLandmarkValid[l])
+            out_landmarksCovariance.emplace_hint(out_landmarksCovariance.end(), landmarkIds[l], landmarksCovariance[l]);
+    }
+
+    return true;
+}
+
+void setUncertaintyFromCovariances(const PosesCovariance& posesCovariance, const LandmarksCovariance& landmarksCovariance, sfmData::SfMData& sfmData)
+{
+    for (const auto& covariancePair : posesCovariance)
+    {
+        const Eigen::SelfAdjointEigenSolver<PoseCovariance> solver(covariancePair.second, Eigen::EigenvaluesOnly);
+        sfmData._posesUncertainty[covariancePair.first] = solver.eigenvalues();
+    }
+
+    for (const auto& covariancePair : landmarksCovariance)
+    {
+        const Eigen::SelfAdjointEigenSolver<Mat3> solver(covariancePair.second, Eigen::EigenvaluesOnly);
+        sfmData._landmarksUncertainty[covariancePair.first] = solver.eigenvalues();
+    }
+}
+
+}  // namespace sfm
+}  // namespace aliceVision
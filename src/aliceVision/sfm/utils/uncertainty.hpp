@@ -0,0 +1,114 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/types.hpp>
+#include <aliceVision/numeric/numeric.hpp>
+
+#include <Eigen/SparseCore>
+
+#include <map>
+
+namespace aliceVision {
+
+namespace sfmData {
+class SfMData;
+}  // namespace sfmData
+
+namespace sfm {
+
+/**
+ * @brief Entries of the inverse of a sparse symmetric positive definite matrix,
+ *        computed only in the sparsity pattern of its Cholesky factor (selected inversion).
+ *
+ * The matrix is factorized with a fill-reducing ordering and the entries of the inverse
+ * are computed from the last column of the factor to the first one with the Takahashi recursion [1].
+ * The pattern of the factor contains the pattern of the matrix, so all the entries (i, j)
+ * of a non-zero of the matrix are available.
+ *
+ * [1] Takahashi, Fagan and Chen. Formation of a sparse bus impedance matrix and its application to short circuit study. PICA 1973.
+ */
+class SparseSelectedInverse
+{
+  public:
+    /**
+     * @brief Factorize the matrix and compute the selected entries of its inverse.
+     * @param[in] matrix The symmetric positive definite matrix (only the upper triangular part is used)
+     * @return false if the matrix is not positive definite
+     */
+    bool compute(const Eigen::SparseMatrix<double>& matrix);
+
+    /**
+     * @brief Get an entry of the inverse.
+     * @param[in] i The row
+     * @param[in] j The column
+     * @return the entry, or 0 if it is not in the pattern of the factor
+     */
+    double operator()(int i, int j) const;
+
+  private:
+    /// selected entries of the inverse of the permuted matrix, lower triangular part (pattern of the factor)
+    Eigen::SparseMatrix<double> _inverse;
+    /// index in the permuted matrix of each row of the matrix
+    Eigen::VectorXi _permutation;
+};
+
+using PoseCovariance = Eigen::Matrix<double, 6, 6>;
+using PosesCovariance = std::map<IndexT, PoseCovariance>;
+using LandmarksCovariance = std::map<IndexT, Mat3>;
+
+/**
+ * @brief Parameters of the covariances estimation.
+ */
+struct CovarianceEstimationParams
+{
+    /// relative damping added to the diagonal of the reduced camera system (to keep disconnected scenes solvable)
+    double damping = 1e-10;
+    /// compute the landmarks covariances (the poses covariances are always computed)
+    bool computeLandmarks = true;
+};
+
+/**
+ * @brief Compute the marginal covariances of the poses and of the landmarks of a bundle adjusted scene
+ *        (the inverse of the Gauss-Newton normal matrix of the reprojection errors, with the intrinsics fixed).
+ *
+ * The full normal matrix is never formed nor inverted:
+ * - the landmarks are eliminated, and the Schur complement on the poses is accumulated pose by pose in parallel,
+ * - only the entries of the inverse of the reduced camera system in the pattern of its sparse Cholesky factor are computed,
+ *   they contain the poses covariances and the cross-covariances of the poses that see a common landmark,
+ * - the landmarks covariances are then computed in parallel from their observing poses only.
+ *
+ * The gauge freedom is fixed by the locked poses. If there are less than two locked poses, the pose with the most observations
+ * is fixed (if there is no locked pose) and the scale is fixed by one translation parameter of the farthest pose.
+ * The covariance of the fixed parameters is zero.
+ *
+ * The poses covariances are expressed in the tangent space of the left perturbation (rotation, translation) of the
+ * world to camera transformation (of the rig for the rig views). The observations standard deviation is their scale (or 1 pixel).
+ * The landmarks with a poorly constrained position (non invertible 3x3 block) are ignored and have no covariance.
+ *
+ * @param[in] sfmData The bundle adjusted scene
+ * @param[in] params The covariances estimation parameters
+ * @param[out] out_posesCovariance The covariance of each refined pose
+ * @param[out] out_landmarksCovariance The covariance of each well constrained landmark
+ * @return false if the reduced camera system can not be factorized
+ */
+bool computeCovariances(const sfmData::SfMData& sfmData,
+                        const CovarianceEstimationParams& params,
+                        PosesCovariance& out_posesCovariance,
+                        LandmarksCovariance& out_landmarksCovariance);
+
+/**
+ * @brief Set the uncertainty of the poses and of the landmarks of a scene from their covariances
+ *        (the eigenvalues of the covariances, in ascending order).
+ * @param[in] posesCovariance The poses covariances
+ * @param[in] landmarksCovariance The landmarks covariances
+ * @param[in,out] sfmData The scene
+ */
+void setUncertaintyFromCovariances(const PosesCovariance& posesCovariance, const LandmarksCovariance& landmarksCovariance, sfmData::SfMData& sfmData);
+
+}  // namespace sfm
+}  // namespace aliceVision
@@ -0,0 +1,159 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/sfm/utils/uncertainty.hpp>
+#include <aliceVision/sfm/utils/syntheticScene.hpp>
+#include <aliceVision/sfm/bundle/manifolds/se3.hpp>
+#include <aliceVision/sfmData/SfMData.hpp>
+
+#define BOOST_TEST_MODULE uncertainty
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/tools/floating_point_comparison.hpp>
+
+#include <random>
+
+using namespace aliceVision;
+using namespace aliceVision::sfm;
+
+BOOST_AUTO_TEST_CASE(uncertainty_selectedInverse)
+{
+    // random sparse symmetric positive definite matrix
+    const int size = 200;
+    std::mt19937 randomNumberGenerator(42);
+    std::uniform_int_distribution<int> distributionIndex(0, size - 1);
+    std::uniform_real_distribution<double> distributionValue(-1.0, 1.0);
+
+    Eigen::MatrixXd dense = Eigen::MatrixXd::Zero(size, size);
+    for (int k = 0; k < 4 * size; ++k)
+    {
+        const int i = distributionIndex(randomNumberGenerator);
+        const int j = distributionIndex(randomNumberGenerator);
+        const double value = distributionValue(randomNumberGenerator);
+        dense(i, j) += value;
+        dense(j, i) += value;
+    }
+    dense.diagonal().array() += dense.cwiseAbs().rowwise().sum().transpose().array() + 1.0;
+
+    const Eigen::SparseMatrix<double> sparse = dense.sparseView();
+    SparseSelectedInverse selectedInverse;
+    BOOST_CHECK(selectedInverse.compute(Eigen::SparseMatrix<double>(sparse.triangularView<Eigen::Upper>())));
+
+    // all the entries of the pattern of the matrix are available
+    const Eigen::MatrixXd inverse = dense.inverse();
+    for (int j = 0; j < sparse.outerSize(); ++j)
+    {
+        for (Eigen::SparseMatrix<double>::InnerIterator it(sparse, j); it; ++it)
+            BOOST_CHECK_SMALL(selectedInverse(it.row(), it.col()) - inverse(it.row(), it.col()), 1e-12);
+    }
+
+    // not positive definite
+    dense(0, 0) = -1.0;
+    const Eigen::SparseMatrix<double> indefinite = dense.sparseView();
+    BOOST_CHECK(!selectedInverse.compute(Eigen::SparseMatrix<double>(indefinite.triangularView<Eigen::Upper>())));
+}
+
+BOOST_AUTO_TEST_CASE(uncertainty_denseReference)
+{
+    SyntheticAerialSceneParams sceneParams;
+    sceneParams.nbViews = 16;
+    sceneParams.nbObservationsPerView = 40;
+    sfmData::SfMData sfmData = generateSyntheticAerialScene(sceneParams);
+
+    // two locked poses fix the gauge
+    std::vector<IndexT> poseIds;
+    for (auto& posePair : sfmData.getPoses())
+        poseIds.push_back(posePair.first);
+    sfmData.getPoses().at(poseIds.front()).lock();
+    sfmData.getPoses().at(poseIds.back()).lock();
+
+    PosesCovariance posesCovariance;
+    LandmarksCovariance landmarksCovariance;
+    BOOST_CHECK(computeCovariances(sfmData, CovarianceEstimationParams(), posesCovariance, landmarksCovariance));
+    BOOST_CHECK_EQUAL(posesCovariance.size(), poseIds.size() - 2);
+    BOOST_CHECK_EQUAL(landmarksCovariance.size(), sfmData.getLandmarks().size());
+
+    // dense normal matrix of the refined poses and of the landmarks
+    std::map<IndexT, int> poseIndexes;
+    for (std::size_t p = 1; p + 1 < poseIds.size(); ++p)
+        poseIndexes[poseIds[p]] = 6 * static_cast<int>(p - 1);
+    std::map<IndexT, int> landmarkIndexes;
+    const int nbPosesParameters = 6 * static_cast<int>(poseIndexes.size());
+    for (const auto& landmarkPair : sfmData.getLandmarks())
+        landmarkIndexes[landmarkPair.first] = nbPosesParameters + 3 * static_cast<int>(landmarkIndexes.size());
+    const int nbParameters = nbPosesParameters + 3 * static_cast<int>(landmarkIndexes.size());
+
+    Eigen::Matrix<double, 16, 6, Eigen::RowMajor> poseTangent;
+    SE3ManifoldLeft(true, true).PlusJacobian(nullptr, poseTangent.data());
+
+    Eigen::MatrixXd normal = Eigen::MatrixXd::Zero(nbParameters, nbParameters);
+    for (const auto& landmarkPair : sfmData.getLandmarks())
+    {
+        const Vec4 X = landmarkPair.second.X.homogeneous();
+        for (const auto& observationPair : landmarkPair.second.getObservations())
+        {
+            const sfmData::View& view = sfmData.getView(observationPair.first);
+            const Eigen::Matrix4d T = sfmData.getPose(view).getTransform().getHomogeneous();
+            const camera::IntrinsicBase* intrinsic = sfmData.getIntrinsicPtr(view.getIntrinsicId());
+            const double scale = (observationPair.second.getScale() > 1e-12) ? observationPair.second.getScale() : 1.0;
+
+            Eigen::MatrixXd jacobian = Eigen::MatrixXd::Zero(2, nbParameters);
+            jacobian.middleCols<3>(landmarkIndexes.at(landmarkPair.first)) = intrinsic->getDerivativeProjectWrtPoint3(T, X) / scale;
+            const auto poseIt = poseIndexes.find(view.getPoseId());
+            if (poseIt != poseIndexes.end())
+                jacobian.middleCols<6>(poseIt->second) = intrinsic->getDerivativeProjectWrtPoseLeft(T, X) * poseTangent / scale;
+            normal += jacobian.transpose() * jacobian;
+        }
+    }
+    const Eigen::MatrixXd covariance = normal.inverse();
+
+    for (const auto& poseIndexPair : poseIndexes)
+    {
+        const PoseCovariance reference = covariance.block<6, 6>(poseIndexPair.second, poseIndexPair.second);
+        BOOST_CHECK_SMALL((posesCovariance.at(poseIndexPair.first) - reference).norm() / reference.norm(), 1e-6);
+    }
+    for (const auto& landmarkIndexPair : landmarkIndexes)
+    {
+        const Mat3 reference = covariance.block<3, 3>(landmarkIndexPair.second, landmarkIndexPair.second);
+        BOOST_CHECK_SMALL((landmarksCovariance.at(landmarkIndexPair.first) - reference).norm() / reference.norm(), 1e-6);
+    }
+
+    setUncertaintyFromCovariances(posesCovariance, landmarksCovariance, sfmData);
+    BOOST_CHECK_EQUAL(sfmData._posesUncertainty.size(), posesCovariance.size());
+    for (const auto& uncertaintyPair : sfmData._posesUncertainty)
+        BOOST_CHECK_GT(uncertaintyPair.second(0), 0.0);
+}
+
+BOOST_AUTO_TEST_CASE(uncertainty_gauge)
+{
+    SyntheticAerialSceneParams sceneParams;
+    sceneParams.nbViews = 25;
+    sceneParams.nbObservationsPerView = 40;
+    const sfmData::SfMData sfmData = generateSyntheticAerialScene(sceneParams);
+
+    // no locked pose: one pose and the scale are fixed
+    PosesCovariance posesCovariance;
+    LandmarksCovariance landmarksCovariance;
+    CovarianceEstimationParams params;
+    params.computeLandmarks = false;
+    BOOST_CHECK(computeCovariances(sfmData, params, posesCovariance, landmarksCovariance));
+    BOOST_CHECK_EQUAL(posesCovariance.size(), sfmData.getPoses().size());
+    BOOST_CHECK(landmarksCovariance.empty());
+
+    int nbFixedPoses = 0;
+    for (const auto& covariancePair : posesCovariance)
+    {
+        const PoseCovariance& covariance = covariancePair.second;
+        BOOST_CHECK_SMALL((covariance - covariance.transpose()).norm(), 1e-9 * covariance.norm() + 1e-15);
+        if (covariance.isZero())
+        {
+            ++nbFixedPoses;
+            continue;
+        }
+        BOOST_CHECK_GE(Eigen::SelfAdjointEigenSolver<PoseCovariance>(covariance).eigenvalues()(0), -1e-12 * covariance.norm());
+    }
+    BOOST_CHECK_EQUAL(nbFixedPoses, 1);
+}
@@ -0,0 +1,360 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "viewGraphPartition.hpp"
+
+#include <aliceVision/system/Logger.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <utility>
+
+namespace aliceVision {
+namespace sfm {
+
+namespace {
+
+/// Weighted adjacency list of the view graph, with contiguous node indexes
+using Adjacency = std::vector<std::vector<std::pair<std::size_t, double>>>;
+
+/**
+ * @brief Get the connected components of a subset of nodes.
+ * @param[in] adjacency The graph adjacency
+ * @param[in] nodes The subset of nodes
+ * @param[in,out] nodeLabel Working buffer of the size of the graph, filled with -2 (restored at the end)
+ * @param[out] out_components The nodes of each connected component
+ */
+void getConnectedComponents(const Adjacency& adjacency,
+                            const std::vector<std::size_t>& nodes,
+                            std::vector<int>& nodeLabel,
+                            std::vector<std::vector<std::size_t>>& out_components)
+{
+    out_components.clear();
+
+    // -1: node of the subset not visited yet
+    for (const std::size_t node : nodes)
+        nodeLabel[node] = -1;
+
+    for (const std::size_t seed : nodes)
+    {
+        if (nodeLabel[seed] != -1)
+            continue;
+
+        const int label = static_cast<int>(out_components.size());
+        out_components.emplace_back();
+        std::vector<std::size_t>& component = out_components.back();
+
+        nodeLabel[seed] = label;
+        component.push_back(seed);
+        for (std::size_t i = 0; i < component.size(); ++i)
+        {
+            for (const auto& neighbor : adjacency[component[i]])
+            {
+                if (nodeLabel[neighbor.first] == -1)
+                {
+                    nodeLabel[neighbor.first] = label;
+                    component.push_back(neighbor.first);
+                }
+            }
+        }
+    }
+
+    for (const std::size_t node : nodes)
+        nodeLabel[node] = -2;
+}
+
+/**
+ * @brief Bisect a connected set of nodes with a spectral approximation of the normalized cut.
+ * @param[in] adjacency The graph adjacency
+ * @param[in] nodes The connected set of nodes to split
+ * @param[in,out] localIndex Working buffer of the size of the graph, filled with -1 (restored at the end)
+ * @param[out] out_first The first part
+ * @param[out] out_second The second part
+ */
+void bisect(const Adjacency& adjacency,
+            const std::vector<std::size_t>& nodes,
+            std::vector<int>& localIndex,
+            std::vector<std::size_t>& out_first,
+            std::vector<std::size_t>& out_second)
+{
+    const std::size_t n = nodes.size();
+    for (std::size_t i = 0; i < n; ++i)
+        localIndex[nodes[i]] = static_cast<int>(i);
+
+    // degrees restricted to the set of nodes
+    std::vector<double> degree(n, 0.0);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        for (const auto& neighbor : adjacency[nodes[i]])
+        {
+            if (localIndex[neighbor.first] != -1)
+                degree[i] += neighbor.second;
+        }
+    }
+
+    // trivial eigenvector of the normalized affinity matrix D^-1/2 W D^-1/2
+    std::vector<double> sqrtDegree(n);
+    double sqrtDegreeNorm = 0.0;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        sqrtDegree[i] = std::sqrt(degree[i]);
+        sqrtDegreeNorm += degree[i];
+    }
+    sqrtDegreeNorm = std::sqrt(sqrtDegreeNorm);
+    for (auto& v : sqrtDegree)
+        v /= sqrtDegreeNorm;
+
+    const auto orthonormalize = [&](std::vector<double>& x) {
+        const double dot = std::inner_product(x.begin(), x.end(), sqrtDegree.begin(), 0.0);
+        double norm = 0.0;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            x[i] -= dot * sqrtDegree[i];
+            norm += x[i] * x[i];
+        }
+        norm = std::sqrt(norm);
+        if (norm > 0.0)
+        {
+            for (auto& v : x)
+                v /= norm;
+        }
+    };
+
+    // power iteration on (I + D^-1/2 W D^-1/2) / 2 in the orthogonal of the trivial eigenvector,
+    // to get the eigenvector of the second largest eigenvalue (Fiedler vector of the normalized Laplacian)
+    std::mt19937 generator(static_cast<std::mt19937::result_type>(n));
+    std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+    std::vector<double> x(n);
+    for (auto& v : x)
+        v = distribution(generator);
+    orthonormalize(x);
+
+    const std::size_t maxIterations = 1000;
+    std::vector<double> y(n);
+    for (std::size_t iteration = 0; iteration < maxIterations; ++iteration)
+    {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            double sum = 0.0;
+            for (const auto& neighbor : adjacency[nodes[i]])
+            {
+                const int j = localIndex[neighbor.first];
+                if (j != -1 && sqrtDegree[j] > 0.0)
+                    sum += neighbor.second * x[j] / (sqrtDegree[j] * sqrtDegreeNorm);
+            }
+            y[i] = 0.5 * x[i] + ((sqrtDegree[i] > 0.0) ? 0.5 * sum / (sqrtDegree[i] * sqrtDegreeNorm) : 0.0);
+        }
+        orthonormalize(y);
+
+        double change = 0.0;
+        for (std::size_t i = 0; i < n; ++i)
+            change = std::max(change, std::abs(y[i] - x[i]));
+        x.swap(y);
+
+        if (change < 1e-6)
+            break;
+    }
+
+    // sort the nodes along the Fiedler vector of the generalized eigen problem (D^-1/2 x)
+    std::vector<std::size_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::vector<double> embedding(n);
+    for (std::size_t i = 0; i < n; ++i)
+        embedding[i] = (sqrtDegree[i] > 0.0) ? x[i] / sqrtDegree[i] : 0.0;
+    std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) { return embedding[a] < embedding[b]; });
+
+    // sweep along the sorted nodes and keep the split with the smallest normalized cut,
+    // restricted to reasonably balanced splits
+    const double totalVolume = std::accumulate(degree.begin(), degree.end(), 0.0);
+    std::vector<char> isFirst(n, 0);
+    double cut = 0.0;
+    double firstVolume = 0.0;
+    double bestNCut = std::numeric_limits<double>::max();
+    std::size_t bestSplit = n / 2;
+    const std::size_t minSplit = std::max<std::size_t>(1, n / 4);
+    const std::size_t maxSplit = std::max(minSplit, n - std::max<std::size_t>(1, n / 4));
+
+    for (std::size_t k = 0; k + 1 < n; ++k)
+    {
+        const std::size_t i = order[k];
+        isFirst[i] = 1;
+        firstVolume += degree[i];
+        for (const auto& neighbor : adjacency[nodes[i]])
+        {
+            const int j = localIndex[neighbor.first];
+            if (j == -1 || static_cast<std::size_t>(j) == i)
+                continue;
+            // the edge is now in the first part if j is in the first part, else it is cut
+            cut += isFirst[j] ? -neighbor.second : neighbor.second;
+        }
+
+        const std::size_t firstSize = k + 1;
+        if (firstSize < minSplit || firstSize > maxSplit)
+            continue;
+
+        const double secondVolume = totalVolume - firstVolume;
+        if (firstVolume <= 0.0 || secondVolume <= 0.0)
+            continue;
+
+        const double nCut = cut / firstVolume + cut / secondVolume;
+        if (nCut < bestNCut)
+        {
+            bestNCut = nCut;
+            bestSplit = firstSize;
+        }
+    }
+
+    out_first.clear();
+    out_second.clear();
+    for (std::size_t k = 0; k < n; ++k)
+    {
+        if (k < bestSplit)
+            out_first.push_back(nodes[order[k]]);
+        else
+            out_second.push_back(nodes[order[k]]);
+    }
+
+    // reset the working buffer
+    for (const std::size_t node : nodes)
+        localIndex[node] = -1;
+}
+
+}  // namespace
+
+void computeViewGraphWeights(const matching::PairwiseMatches& pairwiseMatches, std::map<Pair, double>& out_edgeWeights)
+{
+    out_edgeWeights.clear();
+    for (const auto& matchesPair : pairwiseMatches)
+    {
+        const std::size_t nbMatches = matchesPair.second.getNbAllMatches();
+        if (nbMatches > 0)
+            out_edgeWeights[matchesPair.first] += static_cast<double>(nbMatches);
+    }
+}
+
+void partitionViewGraph(const std::map<Pair, double>& edgeWeights,
+                        std::size_t maxClusterSize,
+                        double overlapRatio,
+                        std::vector<std::set<IndexT>>& out_clusters)
+{
+    out_clusters.clear();
+    maxClusterSize = std::max<std::size_t>(maxClusterSize, 1);
+
+    // contiguous node indexes
+    std::vector<IndexT> nodeIds;
+    for (const auto& edge : edgeWeights)
+    {
+        nodeIds.push_back(edge.first.first);
+        nodeIds.push_back(edge.first.second);
+    }
+    std::sort(nodeIds.begin(), nodeIds.end());
+    nodeIds.erase(std::unique(nodeIds.begin(), nodeIds.end()), nodeIds.end());
+
+    const auto getNodeIndex = [&](IndexT id) -> std::size_t { return std::lower_bound(nodeIds.begin(), nodeIds.end(), id) - nodeIds.begin(); };
+
+    Adjacency adjacency(nodeIds.size());
+    for (const auto& edge : edgeWeights)
+    {
+        if (edge.second <= 0.0 || edge.first.first == edge.first.second)
+            continue;
+        const std::size_t a = getNodeIndex(edge.first.first);
+        const std::size_t b = getNodeIndex(edge.first.second);
+        adjacency[a].emplace_back(b, edge.second);
+        adjacency[b].emplace_back(a, edge.second);
+    }
+
+    std::vector<int> componentLabel(nodeIds.size(), -2);
+    std::vector<int> localIndex(nodeIds.size(), -1);
+
+    std::vector<std::vector<std::size_t>> smallComponents;
+    std::vector<std::vector<std::size_t>> toSplit;
+
+    const auto addComponents = [&](const std::vector<std::size_t>& nodes) {
+        std::vector<std::vector<std::size_t>> components;
+        getConnectedComponents(adjacency, nodes, componentLabel, components);
+        for (auto& component : components)
+        {
+            if (component.size() > maxClusterSize)
+                toSplit.push_back(std::move(component));
+            else
+                smallComponents.push_back(std::move(component));
+        }
+    };
+
+    std::vector<std::size_t> allNodes(nodeIds.size());
+    std::iota(allNodes.begin(), allNodes.end(), 0);
+    addComponents(allNodes);
+
+    // recursive bisection of the large connected components,
+    // the parts may be disconnected after the cut so their components are extracted again
+    while (!toSplit.empty())
+    {
+        const std::vector<std::size_t> nodes = std::move(toSplit.back());
+        toSplit.pop_back();
+
+        std::vector<std::size_t> first, second;
+        bisect(adjacency, nodes, localIndex, first, second);
+
+        addComponents(first);
+        addComponents(second);
+    }
+
+    // group the small connected components together, largest first
+    std::stable_sort(smallComponents.begin(), smallComponents.end(), [](const std::vector<std::size_t>& a, const std::vector<std::size_t>& b) {
+        return a.size() > b.size();
+    });
+    std::vector<std::vector<std::size_t>> clusters;
+    for (auto& component : smallComponents)
+    {
+        auto clusterIt = std::find_if(clusters.begin(), clusters.end(), [&](const std::vector<std::size_t>& cluster) {
+            return cluster.size() + component.size() <= maxClusterSize;
+        });
+        if (clusterIt == clusters.end())
+            clusters.push_back(std::move(component));
+        else
+            clusterIt->insert(clusterIt->end(), component.begin(), component.end());
+    }
+
+    // extend each cluster with the most connected views of the other clusters
+    out_clusters.resize(clusters.size());
+    for (std::size_t c = 0; c < clusters.size(); ++c)
+    {
+        const std::vector<std::size_t>& cluster = clusters[c];
+        std::set<IndexT>& outCluster = out_clusters[c];
+        for (const std::size_t node : cluster)
+            outCluster.insert(nodeIds[node]);
+
+        const std::size_t nbOverlapViews = static_cast<std::size_t>(std::ceil(overlapRatio * cluster.size()));
+        if (nbOverlapViews == 0)
+            continue;
+
+        std::map<std::size_t, double> connectionToCluster;
+        for (const std::size_t node : cluster)
+        {
+            for (const auto& neighbor : adjacency[node])
+            {
+                if (outCluster.count(nodeIds[neighbor.first]) == 0)
+                    connectionToCluster[neighbor.first] += neighbor.second;
+            }
+        }
+
+        std::vector<std::pair<std::size_t, double>> candidates(connectionToCluster.begin(), connectionToCluster.end());
+        std::stable_sort(candidates.begin(), candidates.end(), [](const std::pair<std::size_t, double>& a, const std::pair<std::size_t, double>& b) {
+            return a.second > b.second;
+        });
+
+        for (std::size_t i = 0; i < candidates.size() && i < nbOverlapViews; ++i)
+            outCluster.insert(nodeIds[candidates[i].first]);
+    }
+
+    ALICEVISION_LOG_INFO("View graph partition: " << nodeIds.size() << " views in " << out_clusters.size() << " clusters.");
+}
+
+}  // namespace sfm
+}  // namespace aliceVision
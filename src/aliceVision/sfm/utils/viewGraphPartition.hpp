@@ -0,0 +1,50 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/types.hpp>
+#include <aliceVision/matching/IndMatch.hpp>
+
+#include <map>
+#include <set>
+#include <vector>
+
+namespace aliceVision {
+
+namespace sfm {
+
+/**
+ * @brief Compute the weights of the view graph from the pairwise matches.
+ *        The weight of a pair of views is its number of matches (all describer types).
+ * @param[in] pairwiseMatches The pairwise matches
+ * @param[out] out_edgeWeights The weight of each pair of views with matches
+ */
+void computeViewGraphWeights(const matching::PairwiseMatches& pairwiseMatches, std::map<Pair, double>& out_edgeWeights);
+
+/**
+ * @brief Split the view graph into clusters of at most maxClusterSize views, with few matches between the clusters.
+ *
+ * Each connected component larger than maxClusterSize is recursively bisected with a spectral
+ * approximation of the normalized cut (Shi & Malik 2000): the views are sorted by the Fiedler vector
+ * of the normalized graph Laplacian, and split at the position with the smallest normalized cut.
+ * Small connected components are grouped together.
+ *
+ * Each cluster is then extended with the views of the other clusters that are the most connected to it,
+ * so that the reconstructions of the clusters share cameras which can be used to align them.
+ *
+ * @param[in] edgeWeights The weight of each pair of views (e.g. number of matches)
+ * @param[in] maxClusterSize The maximum number of views per cluster (before the overlap extension)
+ * @param[in] overlapRatio The number of views added to each cluster, as a ratio of the cluster size
+ * @param[out] out_clusters The view ids of each cluster
+ */
+void partitionViewGraph(const std::map<Pair, double>& edgeWeights,
+                        std::size_t maxClusterSize,
+                        double overlapRatio,
+                        std::vector<std::set<IndexT>>& out_clusters);
+
+}  // namespace sfm
+}  // namespace aliceVision
@@ -0,0 +1,113 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/sfm/utils/viewGraphPartition.hpp>
+
+#include <map>
+#include <set>
+#include <vector>
+
+#define BOOST_TEST_MODULE viewGraphPartition
+
+#include <boost/test/unit_test.hpp>
+
+using namespace aliceVision;
+using namespace aliceVision::sfm;
+
+/**
+ * @brief Add a fully connected set of views [firstViewId, firstViewId + nbViews[ to the graph.
+ */
+void addClique(std::map<Pair, double>& edgeWeights, IndexT firstViewId, IndexT nbViews, double weight)
+{
+    for (IndexT i = firstViewId; i < firstViewId + nbViews; ++i)
+        for (IndexT j = i + 1; j < firstViewId + nbViews; ++j)
+            edgeWeights[Pair(i, j)] = weight;
+}
+
+std::set<IndexT> getRange(IndexT firstViewId, IndexT nbViews)
+{
+    std::set<IndexT> range;
+    for (IndexT i = firstViewId; i < firstViewId + nbViews; ++i)
+        range.insert(i);
+    return range;
+}
+
+BOOST_AUTO_TEST_CASE(viewGraphPartition_twoCliques)
+{
+    // two strongly connected sets of views linked by a weak pair
+    std::map<Pair, double> edgeWeights;
+    addClique(edgeWeights, 0, 10, 100.0);
+    addClique(edgeWeights, 10, 10, 100.0);
+    edgeWeights[Pair(9, 10)] = 1.0;
+
+    std::vector<std::set<IndexT>> clusters;
+    partitionViewGraph(edgeWeights, 10, 0.0, clusters);
+
+    BOOST_REQUIRE_EQUAL(clusters.size(), 2);
+    const std::set<IndexT> first = getRange(0, 10);
+    const std::set<IndexT> second = getRange(10, 10);
+    BOOST_CHECK((clusters[0] == first && clusters[1] == second) || (clusters[0] == second && clusters[1] == first));
+}
+
+BOOST_AUTO_TEST_CASE(viewGraphPartition_overlap)
+{
+    std::map<Pair, double> edgeWeights;
+    addClique(edgeWeights, 0, 10, 100.0);
+    addClique(edgeWeights, 10, 10, 100.0);
+    edgeWeights[Pair(9, 10)] = 1.0;
+
+    std::vector<std::set<IndexT>> clusters;
+    partitionViewGraph(edgeWeights, 10, 0.1, clusters);
+
+    // each cluster is extended with the view of the other cluster linked to it
+    BOOST_REQUIRE_EQUAL(clusters.size(), 2);
+    for (const auto& cluster : clusters)
+    {
+        BOOST_CHECK_EQUAL(cluster.size(), 11);
+        BOOST_CHECK(cluster.count(9) && cluster.count(10));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(viewGraphPartition_chainOfCliques)
+{
+    std::map<Pair, double> edgeWeights;
+    for (IndexT c = 0; c < 4; ++c)
+    {
+        addClique(edgeWeights, c * 8, 8, 50.0);
+        if (c > 0)
+            edgeWeights[Pair(c * 8 - 1, c * 8)] = 2.0;
+    }
+    // an isolated pair of views
+    edgeWeights[Pair(100, 101)] = 10.0;
+
+    std::vector<std::set<IndexT>> clusters;
+    partitionViewGraph(edgeWeights, 10, 0.0, clusters);
+
+    std::set<IndexT> allViews;
+    std::size_t nbViews = 0;
+    for (const auto& cluster : clusters)
+    {
+        BOOST_CHECK_LE(cluster.size(), 10);
+        allViews.insert(cluster.begin(), cluster.end());
+        nbViews += cluster.size();
+    }
+    // without overlap, each view is in exactly one cluster
+    BOOST_CHECK_EQUAL(allViews.size(), 34);
+    BOOST_CHECK_EQUAL(nbViews, 34);
+
+    // the cliques are not split
+    for (IndexT c = 0; c < 4; ++c)
+    {
+        for (const auto& cluster : clusters)
+        {
+            if (cluster.count(c * 8))
+            {
+                for (IndexT i = c * 8; i < c * 8 + 8; ++i)
+                    BOOST_CHECK(cluster.count(i));
+            }
+        }
+    }
+}
@@ -0,0 +1,91 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "FlatLandmarks.hpp"
+
+#include <algorithm>
+
+namespace aliceVision {
+namespace sfmData {
+
+void FlatLandmarks::build(const Landmarks& landmarks)
+{
+    std::size_t nbObservations = 0;
+    for (const auto& landmarkPair : landmarks)
+        nbObservations += landmarkPair.second.getObservations().size();
+
+    _landmarkIds.clear();
+    _X.clear();
+    _descTypes.clear();
+    _observationOffsets.clear();
+    _observationLandmarkIndexes.clear();
+    _observationViewIds.clear();
+    _observationCoordinates.clear();
+    _observationFeatureIds.clear();
+    _observationScales.clear();
+
+    _landmarkIds.reserve(landmarks.size());
+    _X.reserve(landmarks.size());
+    _descTypes.reserve(landmarks.size());
+    _observationOffsets.reserve(landmarks.size() + 1);
+    _observationLandmarkIndexes.reserve(nbObservations);
+    _observationViewIds.reserve(nbObservations);
+    _observationCoordinates.reserve(nbObservations);
+    _observationFeatureIds.reserve(nbObservations);
+    _observationScales.reserve(nbObservations);
+
+    _observationOffsets.push_back(0);
+    for (const auto& landmarkPair : landmarks)
+    {
+        const std::size_t landmarkIndex = _landmarkIds.size();
+        const Landmark& landmark = landmarkPair.second;
+
+        _landmarkIds.push_back(landmarkPair.first);
+        _X.push_back(landmark.X);
+        _descTypes.push_back(landmark.descType);
+
+        for (const auto& observationPair : landmark.getObservations())
+        {
+            _observationLandmarkIndexes.push_back(landmarkIndex);
+            _observationViewIds.push_back(observationPair.first);
+            _observationCoordinates.push_back(observationPair.second.getCoordinates());
+            _observationFeatureIds.push_back(observationPair.second.getFeatureId());
+            _observationScales.push_back(observationPair.second.getScale());
+        }
+        _observationOffsets.push_back(_observationViewIds.size());
+    }
+
+    // observations per view: counting sort on the observed views
+    _viewIds = _observationViewIds;
+    std::sort(_viewIds.begin(), _viewIds.end());
+    _viewIds.erase(std::unique(_viewIds.begin(), _viewIds.end()), _viewIds.end());
+
+    std::vector<std::size_t> viewIndexPerObservation(nbObservations);
+    _viewOffsets.assign(_viewIds.size() + 1, 0);
+    for (std::size_t i = 0; i < nbObservations; ++i)
+    {
+        viewIndexPerObservation[i] = std::lower_bound(_viewIds.begin(), _viewIds.end(), _observationViewIds[i]) - _viewIds.begin();
+        ++_viewOffsets[viewIndexPerObservation[i] + 1];
+    }
+    for (std::size_t v = 0; v < _viewIds.size(); ++v)
+        _viewOffsets[v + 1] += _viewOffsets[v];
+
+    std::vector<std::size_t> viewPositions(_viewOffsets.begin(), _viewOffsets.end() - 1);
+    _viewObservationIndexes.resize(nbObservations);
+    for (std::size_t i = 0; i < nbObservations; ++i)
+        _viewObservationIndexes[viewPositions[viewIndexPerObservation[i]]++] = i;
+}
+
+std::size_t FlatLandmarks::findIndex(IndexT landmarkId) const
+{
+    const auto it = std::lower_bound(_landmarkIds.begin(), _landmarkIds.end(), landmarkId);
+    if (it == _landmarkIds.end() || *it != landmarkId)
+        return _landmarkIds.size();
+    return static_cast<std::size_t>(it - _landmarkIds.begin());
+}
+
+}  // namespace sfmData
+}  // namespace aliceVision
@@ -0,0 +1,114 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/sfmData/Landmark.hpp>
+#include <aliceVision/numeric/numeric.hpp>
+#include <aliceVision/types.hpp>
+
+#include <map>
+#include <vector>
+
+namespace aliceVision {
+namespace sfmData {
+
+using Landmarks = std::map<IndexT, Landmark>;
+
+/**
+ * @brief Contiguous copy of the landmarks of a scene and of their observations.
+ *        The landmarks are stored by increasing id, so their indices are stable as long as the copy is not rebuilt,
+ *        and their observations are stored in a CSR (compressed sparse row) layout, by increasing view id.
+ *        The observations can also be traversed per view, with the same CSR layout.
+ *        It is dedicated to the read-only passes over large scenes, the landmarks map stays the reference.
+ */
+class FlatLandmarks
+{
+  public:
+    FlatLandmarks() = default;
+
+    /**
+     * @brief Build the contiguous copy of the given landmarks.
+     * @param[in] landmarks the landmarks of the scene
+     */
+    explicit FlatLandmarks(const Landmarks& landmarks) { build(landmarks); }
+
+    /**
+     * @brief Build the contiguous copy of the given landmarks, the previous content is replaced.
+     * @param[in] landmarks the landmarks of the scene
+     */
+    void build(const Landmarks& landmarks);
+
+    /// Number of landmarks
+    std::size_t size() const { return _landmarkIds.size(); }
+
+    /// Number of observations of all the landmarks
+    std::size_t getNbObservations() const { return _observationViewIds.size(); }
+
+    /**
+     * @brief Get the index of a landmark from its id.
+     * @param[in] landmarkId the landmark id
+     * @return the landmark index, or size() if there is no landmark with this id
+     */
+    std::size_t findIndex(IndexT landmarkId) const;
+
+    IndexT getLandmarkId(std::size_t landmarkIndex) const { return _landmarkIds[landmarkIndex]; }
+
+    const Vec3& getX(std::size_t landmarkIndex) const { return _X[landmarkIndex]; }
+
+    feature::EImageDescriberType getDescType(std::size_t landmarkIndex) const { return _descTypes[landmarkIndex]; }
+
+    /// First observation index of a landmark
+    std::size_t getObservationsBegin(std::size_t landmarkIndex) const { return _observationOffsets[landmarkIndex]; }
+
+    /// Past-the-end observation index of a landmark
+    std::size_t getObservationsEnd(std::size_t landmarkIndex) const { return _observationOffsets[landmarkIndex + 1]; }
+
+    /// Landmark index of an observation
+    std::size_t getObservationLandmarkIndex(std::size_t observationIndex) const { return _observationLandmarkIndexes[observationIndex]; }
+
+    IndexT getObservationViewId(std::size_t observationIndex) const { return _observationViewIds[observationIndex]; }
+
+    const Vec2& getObservationCoordinates(std::size_t observationIndex) const { return _observationCoordinates[observationIndex]; }
+
+    IndexT getObservationFeatureId(std::size_t observationIndex) const { return _observationFeatureIds[observationIndex]; }
+
+    double getObservationScale(std::size_t observationIndex) const { return _observationScales[observationIndex]; }
+
+    /// Ids of the observed views, sorted
+    const std::vector<IndexT>& getViewIds() const { return _viewIds; }
+
+    /// First position of the observations of the i-th observed view in getViewObservationIndexes()
+    std::size_t getViewObservationsBegin(std::size_t viewIndex) const { return _viewOffsets[viewIndex]; }
+
+    /// Past-the-end position of the observations of the i-th observed view in getViewObservationIndexes()
+    std::size_t getViewObservationsEnd(std::size_t viewIndex) const { return _viewOffsets[viewIndex + 1]; }
+
+    /// Observation indexes grouped by view, by increasing landmark index within a view
+    const std::vector<std::size_t>& getViewObservationIndexes() const { return _viewObservationIndexes; }
+
+  private:
+    // landmarks
+    std::vector<IndexT> _landmarkIds;
+    std::vector<Vec3> _X;
+    std::vector<feature::EImageDescriberType> _descTypes;
+    std::vector<std::size_t> _observationOffsets;
+
+    // observations of the landmarks
+    std::vector<std::size_t> _observationLandmarkIndexes;
+    std::vector<IndexT> _observationViewIds;
+    std::vector<Vec2> _observationCoordinates;
+    std::vector<IndexT> _observationFeatureIds;
+    std::vector<double> _observationScales;
+
+    // observations per view
+    std::vector<IndexT> _viewIds;
+    std::vector<std::size_t> _viewOffsets;
+    std::vector<std::size_t> _viewObservationIndexes;
+};
+
+}  // namespace sfmData
+}  // namespace aliceVision
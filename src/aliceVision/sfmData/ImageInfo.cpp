@@ -187,6 +187,38 @@ int ImageInfo::getSensorSize(const std::vector<sensorDB::Datasheet>& sensorDatab
                              double& focalLengthmm,
                              camera::EInitMode& intrinsicInitMode,
                              bool verbose)
+{
+    return computeSensorSize([&](const std::string& make, const std::string& model,
+                                 sensorDB::Datasheet& datasheet) { return sensorDB::getInfo(make, model, sensorDatabase, datasheet); },
+                             sensorWidth,
+                             sensorHeight,
+                             focalLengthmm,
+                             intrinsicInitMode,
+                             verbose);
+}
+
+int ImageInfo::getSensorSize(const sensorDB::DatasheetIndex& sensorDatabase,
+                             double& sensorWidth,
+                             double& sensorHeight,
+                             double& focalLengthmm,
+                             camera::EInitMode& intrinsicInitMode,
+                             bool verbose)
+{
+    return computeSensorSize([&](const std::string& make, const std::string& model,
+                                 sensorDB::Datasheet& datasheet) { return sensorDatabase.getInfo(make, model, datasheet); },
+                             sensorWidth,
+                             sensorHeight,
+                             focalLengthmm,
+                             intrinsicInitMode,
+                             verbose);
+}
+
+int ImageInfo::computeSensorSize(const std::function<bool(const std::string&, const std::string&, sensorDB::Datasheet&)>& getDatasheet,
+                                 double& sensorWidth,
+                                 double& sensorHeight,
+                                 double& focalLengthmm,
+                                 camera::EInitMode& intrinsicInitMode,
+                                 bool verbose)
 {
     int errCode = 0;
 
@@ -207,7 +239,7 @@ int ImageInfo::getSensorSize(const std::vector<sensorDB::Datasheet>& sensorDatab
     {
         intrinsicInitMode = camera::EInitMode::UNKNOWN;
         sensorDB::Datasheet datasheet;
-        if (sensorDB::getInfo(make, model, sensorDatabase, datasheet))
+        if (getDatasheet(make, model, datasheet))
         {
             if (verbose)
             {
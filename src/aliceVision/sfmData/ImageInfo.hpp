@@ -13,8 +13,10 @@
 #include <aliceVision/sfmData/ExposureSetting.hpp>
 #include <aliceVision/sfmData/exif.hpp>
 #include <aliceVision/sensorDB/Datasheet.hpp>
+#include <aliceVision/sensorDB/DatasheetIndex.hpp>
 #include <aliceVision/camera/IntrinsicInitMode.hpp>
 
+#include <functional>
 #include <regex>
 
 namespace aliceVision {
@@ -579,7 +581,35 @@ class ImageInfo
                       camera::EInitMode& intrinsicInitMode,
                       bool verbose = false);
 
+    /**
+     * @brief Get sensor size by combining info in metadata and in the indexed sensor database
+     * @param[in] sensorDatabase The indexed sensor database, shared by all the images
+     * @param[out] sensorWidth The sensor width
+     * @param[out] sensorHeight The sensor height
+     * @param[out] focalLengthmm The focal length
+     * @param[out] intrinsicInitMode The intrinsic init mode
+     * @param[in] verbose Enable verbosity
+     * @return An Error or Warning code: 1 - Unknown sensor, 2 - No metadata, 3 - Unsure sensor, 4 - Computation from 35mm Focal
+     */
+    int getSensorSize(const sensorDB::DatasheetIndex& sensorDatabase,
+                      double& sensorWidth,
+                      double& sensorHeight,
+                      double& focalLengthmm,
+                      camera::EInitMode& intrinsicInitMode,
+                      bool verbose = false);
+
   private:
+    /**
+     * @brief Get sensor size by combining info in metadata and in the sensor database
+     * @param[in] getDatasheet The lookup of the datasheet of a camera brand / model in the sensor database
+     */
+    int computeSensorSize(const std::function<bool(const std::string&, const std::string&, sensorDB::Datasheet&)>& getDatasheet,
+                          double& sensorWidth,
+                          double& sensorHeight,
+                          double& focalLengthmm,
+                          camera::EInitMode& intrinsicInitMode,
+                          bool verbose);
+
     /// image path on disk
     std::string _imagePath;
     /// image width
@@ -7,6 +7,7 @@
 %module (module="pyalicevision") sfmData
 
 %include <aliceVision/global.i>
+%include <aliceVision/NumpyArray.i>
 %include <aliceVision/camera/IntrinsicBase.i>
 %include <aliceVision/camera/Pinhole.i>
 %include <aliceVision/camera/Equidistant.i>
@@ -28,6 +29,62 @@ using namespace aliceVision::sfmData;
 using namespace aliceVision::camera;
 %}
 
+// Bulk access to the landmarks, in the order of their ids:
+// the landmarks are stored in a map, their values are gathered in C++ in a single pass instead of one Python call per landmark
+%extend aliceVision::sfmData::SfMData {
+    /// Ids of the landmarks (N)
+    PyObject* getLandmarksIds() const
+    {
+        const aliceVision::sfmData::Landmarks& landmarks = $self->getLandmarks();
+        npy_intp dims[1] = {static_cast<npy_intp>(landmarks.size())};
+        PyObject* array = PyArray_SimpleNew(1, dims, NPY_UINT32);
+        if (array == nullptr)
+            return nullptr;
+        uint32_t* data = static_cast<uint32_t*>(PyArray_DATA(reinterpret_cast<PyArrayObject*>(array)));
+        for (const auto& landmark : landmarks)
+            *data++ = landmark.first;
+        return array;
+    }
+
+    /// Positions of the landmarks (N x 3)
+    PyObject* getLandmarksPositions() const
+    {
+        const aliceVision::sfmData::Landmarks& landmarks = $self->getLandmarks();
+        npy_intp dims[2] = {static_cast<npy_intp>(landmarks.size()), 3};
+        PyObject* array = PyArray_SimpleNew(2, dims, NPY_FLOAT64);
+        if (array == nullptr)
+            return nullptr;
+        double* data = static_cast<double*>(PyArray_DATA(reinterpret_cast<PyArrayObject*>(array)));
+        for (const auto& landmark : landmarks)
+        {
+            const aliceVision::Vec3& X = landmark.second.X;
+            *data++ = X(0);
+            *data++ = X(1);
+            *data++ = X(2);
+        }
+        return array;
+    }
+
+    /// Colors of the landmarks (N x 3)
+    PyObject* getLandmarksColors() const
+    {
+        const aliceVision::sfmData::Landmarks& landmarks = $self->getLandmarks();
+        npy_intp dims[2] = {static_cast<npy_intp>(landmarks.size()), 3};
+        PyObject* array = PyArray_SimpleNew(2, dims, NPY_UINT8);
+        if (array == nullptr)
+            return nullptr;
+        unsigned char* data = static_cast<unsigned char*>(PyArray_DATA(reinterpret_cast<PyArrayObject*>(array)));
+        for (const auto& landmark : landmarks)
+        {
+            const aliceVision::image::RGBColor& rgb = landmark.second.rgb;
+            *data++ = rgb.r();
+            *data++ = rgb.g();
+            *data++ = rgb.b();
+        }
+        return array;
+    }
+}
+
 %template(Constraints2D) std::vector<aliceVision::sfmData::Constraint2D>;
 %template(ImageInfos) std::map<IndexT, std::shared_ptr<aliceVision::sfmData::ImageInfo>>;
 %template(Intrinsics) std::map<IndexT, std::shared_ptr<aliceVision::camera::IntrinsicBase>>;
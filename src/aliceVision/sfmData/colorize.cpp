@@ -13,112 +13,156 @@
 #include <aliceVision/image/io.hpp>
 #include <aliceVision/system/ProgressDisplay.hpp>
 
-#include <map>
-#include <random>
+#include <algorithm>
+#include <numeric>
 #include <vector>
-#include <functional>
 namespace aliceVision {
 namespace sfmData {
 
 void colorizeTracks(SfMData& sfmData)
 {
-    auto progressDisplay = system::createConsoleProgressDisplay(sfmData.getLandmarks().size(), std::cout, "\nCompute scene structure color\n");
-
-    std::vector<std::reference_wrapper<Landmark>> remainingLandmarksToColor;
-    remainingLandmarksToColor.reserve(sfmData.getLandmarks().size());
-
-    for (auto& landmarkPair : sfmData.getLandmarks())
-        remainingLandmarksToColor.push_back(landmarkPair.second);
-
-    struct ViewInfo
-    {
-        ViewInfo(IndexT viewId, std::size_t cardinal)
-          : viewId(viewId),
-            cardinal(cardinal)
-        {}
-
-        IndexT viewId;
-        std::size_t cardinal;
-        std::vector<std::reference_wrapper<Landmark>> landmarks;
+    Landmarks& landmarks = sfmData.getLandmarks();
+    auto progressDisplay = system::createConsoleProgressDisplay(landmarks.size(), std::cout, "\nCompute scene structure color\n");
+
+    std::vector<Landmark*> landmarksList;
+    landmarksList.reserve(landmarks.size());
+    for (auto& landmarkPair : landmarks)
+        landmarksList.push_back(&landmarkPair.second);
+
+    const int nbLandmarks = static_cast<int>(landmarksList.size());
+
+    // dense index of the views
+    std::vector<IndexT> viewIds;
+    viewIds.reserve(sfmData.getViews().size());
+    for (const auto& viewPair : sfmData.getViews())
+        viewIds.push_back(viewPair.first);
+    const auto getViewIndex = [&viewIds](IndexT viewId) -> int {
+        const auto it = std::lower_bound(viewIds.begin(), viewIds.end(), viewId);
+        return (it != viewIds.end() && *it == viewId) ? static_cast<int>(std::distance(viewIds.begin(), it)) : -1;
     };
+    const int nbViews = static_cast<int>(viewIds.size());
 
-    std::vector<ViewInfo> sortedViewsCardinal;
-    sortedViewsCardinal.reserve(sfmData.getViews().size());
+    // number of observations per view
+    std::vector<std::size_t> viewsCardinal(nbViews, 0);
+#pragma omp parallel
     {
-        // create cardinal per viewId map
-        std::map<IndexT, std::size_t> viewsCardinalMap;  // <ViewId, Cardinal>
-        for (const auto& landmarkPair : sfmData.getLandmarks())
+        std::vector<std::size_t> threadViewsCardinal(nbViews, 0);
+#pragma omp for nowait
+        for (int i = 0; i < nbLandmarks; ++i)
         {
-            const Observations& observations = landmarkPair.second.getObservations();
-            for (const auto& observationPair : observations)
-                ++viewsCardinalMap[observationPair.first];  // TODO: 0
+            for (const auto& observationPair : landmarksList[i]->getObservations())
+            {
+                const int viewIndex = getViewIndex(observationPair.first);
+                if (viewIndex >= 0)
+                    ++threadViewsCardinal[viewIndex];
+            }
+        }
+#pragma omp critical
+        {
+            for (int v = 0; v < nbViews; ++v)
+                viewsCardinal[v] += threadViewsCardinal[v];
         }
-
-        // copy key-value pairs from the map to the vector
-        for (const auto& cardinalPair : viewsCardinalMap)
-            sortedViewsCardinal.push_back(ViewInfo(cardinalPair.first, cardinalPair.second));
-
-        // sort the vector, biggest cardinality first
-        std::sort(
-          sortedViewsCardinal.begin(), sortedViewsCardinal.end(), [](const ViewInfo& l, const ViewInfo& r) { return l.cardinal > r.cardinal; });
     }
 
-    // assign each landmark to a view
-    for (ViewInfo& viewCardinal : sortedViewsCardinal)
-    {
-        std::vector<std::reference_wrapper<Landmark>> toKeep;
-        const IndexT viewId = viewCardinal.viewId;
+    // rank the views, biggest cardinality first
+    std::vector<int> sortedViews(nbViews);
+    std::iota(sortedViews.begin(), sortedViews.end(), 0);
+    std::stable_sort(sortedViews.begin(), sortedViews.end(), [&viewsCardinal](int l, int r) { return viewsCardinal[l] > viewsCardinal[r]; });
+    std::vector<int> viewRanks(nbViews);
+    for (int rank = 0; rank < nbViews; ++rank)
+        viewRanks[sortedViews[rank]] = rank;
 
-        for (int i = 0; i < remainingLandmarksToColor.size(); ++i)
+    // assign each landmark to its observing view with the biggest cardinality
+    std::vector<int> landmarksView(nbLandmarks, -1);
+#pragma omp parallel for
+    for (int i = 0; i < nbLandmarks; ++i)
+    {
+        int bestRank = nbViews;
+        for (const auto& observationPair : landmarksList[i]->getObservations())
         {
-            Landmark& landmark = remainingLandmarksToColor.at(i);
-            auto it = landmark.getObservations().find(viewId);
-            if (it != landmark.getObservations().end())
-            {
-                viewCardinal.landmarks.push_back(landmark);
-            }
-            else
-            {
-                toKeep.push_back(landmark);
-            }
+            const int viewIndex = getViewIndex(observationPair.first);
+            if (viewIndex >= 0 && viewRanks[viewIndex] < bestRank)
+                bestRank = viewRanks[viewIndex];
         }
-        std::swap(toKeep, remainingLandmarksToColor);
-
-        if (remainingLandmarksToColor.empty())
-            break;
+        if (bestRank < nbViews)
+            landmarksView[i] = sortedViews[bestRank];
     }
 
-    std::random_device randomDevice;
-    std::mt19937 rng(randomDevice());
-
-    // create an unsorted index container
-    std::vector<int> unsortedIndexes(sortedViewsCardinal.size());
-    std::iota(std::begin(unsortedIndexes), std::end(unsortedIndexes), 0);
-    std::shuffle(unsortedIndexes.begin(), unsortedIndexes.end(), rng);
+    // landmarks grouped per view (counting sort)
+    std::vector<std::size_t> viewOffsets(nbViews + 1, 0);
+    for (int i = 0; i < nbLandmarks; ++i)
+    {
+        if (landmarksView[i] >= 0)
+            ++viewOffsets[landmarksView[i] + 1];
+    }
+    std::partial_sum(viewOffsets.begin(), viewOffsets.end(), viewOffsets.begin());
+    std::vector<std::size_t> viewFill(viewOffsets.begin(), viewOffsets.end() - 1);
+    std::vector<Landmark*> landmarksPerView(viewOffsets.back());
+    for (int i = 0; i < nbLandmarks; ++i)
+    {
+        if (landmarksView[i] >= 0)
+            landmarksPerView[viewFill[landmarksView[i]]++] = landmarksList[i];
+    }
 
-    // landmark colorization
-#pragma omp parallel for
-    for (int i = 0; i < unsortedIndexes.size(); ++i)
+    // landmark colorization: each landmark is colored by a single view, so no synchronization is needed.
+    // The biggest views first for the load balancing.
+#pragma omp parallel for schedule(dynamic)
+    for (int rank = 0; rank < nbViews; ++rank)
     {
-        const ViewInfo& viewCardinal = sortedViewsCardinal.at(unsortedIndexes.at(i));
-        if (!viewCardinal.landmarks.empty())
+        const int viewIndex = sortedViews[rank];
+        const std::size_t begin = viewOffsets[viewIndex];
+        const std::size_t end = viewOffsets[viewIndex + 1];
+        if (begin == end)
+            continue;
+
+        const View& view = sfmData.getView(viewIds[viewIndex]);
+        const IndexT viewId = view.getViewId();
+        int width = static_cast<int>(view.getImage().getWidth());
+        int height = static_cast<int>(view.getImage().getHeight());
+
+        // clamp the pixel position if the feature/marker center is outside the image.
+        const auto getPixel = [&](const Landmark& landmark) -> Vec2i {
+            const Vec2& pt = landmark.getObservations().at(viewId).getCoordinates();
+            return Vec2i(static_cast<int>(clamp(pt.x(), 0.0, static_cast<double>(width - 1))),
+                         static_cast<int>(clamp(pt.y(), 0.0, static_cast<double>(height - 1))));
+        };
+
+        image::Image<image::RGBColor> image;
+        Vec2i origin(0, 0);
+        if (width <= 0 || height <= 0)
         {
-            const View& view = sfmData.getView(viewCardinal.viewId);
-            image::Image<image::RGBColor> image;
+            // unknown image size: decode the whole image
             image::readImage(view.getImage().getImagePath(), image, image::EImageColorSpace::SRGB);
-
-            for (Landmark& landmark : viewCardinal.landmarks)
+            width = image.width();
+            height = image.height();
+        }
+        else
+        {
+            // only decode the region of the observations
+            Vec2i maxPixel = getPixel(*landmarksPerView[begin]);
+            origin = maxPixel;
+            for (std::size_t i = begin + 1; i < end; ++i)
             {
-                // color the point
-                Vec2 pt = landmark.getObservations().at(view.getViewId()).getCoordinates();
-                // clamp the pixel position if the feature/marker center is outside the image.
-                pt.x() = clamp(pt.x(), 0.0, static_cast<double>(image.width() - 1));
-                pt.y() = clamp(pt.y(), 0.0, static_cast<double>(image.height() - 1));
-                landmark.rgb = image(pt.y(), pt.x());
+                const Vec2i pixel = getPixel(*landmarksPerView[i]);
+                origin = origin.cwiseMin(pixel);
+                maxPixel = maxPixel.cwiseMax(pixel);
             }
 
-            progressDisplay += viewCardinal.landmarks.size();
+            image::ImageReadOptions readOptions(image::EImageColorSpace::SRGB);
+            readOptions.subROI = oiio::ROI(origin.x(), maxPixel.x() + 1, origin.y(), maxPixel.y() + 1);
+            image::readImage(view.getImage().getImagePath(), image, readOptions);
         }
+
+        // the decoded region can be smaller if the image size of the view is wrong
+        const Vec2i lastPixel(image.width() - 1, image.height() - 1);
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            Landmark& landmark = *landmarksPerView[i];
+            const Vec2i pixel = (getPixel(landmark) - origin).cwiseMin(lastPixel);
+            landmark.rgb = image(pixel.y(), pixel.x());
+        }
+
+        progressDisplay += end - begin;
     }
 }
 
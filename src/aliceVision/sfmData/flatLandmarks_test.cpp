@@ -0,0 +1,110 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/sfmData/FlatLandmarks.hpp>
+
+#define BOOST_TEST_MODULE flatLandmarks
+
+#include <boost/test/unit_test.hpp>
+
+#include <random>
+
+using namespace aliceVision;
+
+BOOST_AUTO_TEST_CASE(FlatLandmarks_sameContent)
+{
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<IndexT> viewDistribution(0, 20);
+    std::uniform_real_distribution<double> valueDistribution(-10.0, 10.0);
+
+    sfmData::Landmarks landmarks;
+    for (IndexT landmarkId = 0; landmarkId < 500; landmarkId += 3)
+    {
+        sfmData::Landmark& landmark = landmarks[landmarkId];
+        landmark.X = Vec3(valueDistribution(generator), valueDistribution(generator), valueDistribution(generator));
+        landmark.descType = feature::EImageDescriberType::SIFT;
+
+        const int nbObservations = landmarkId % 5;
+        for (int i = 0; i < nbObservations; ++i)
+        {
+            landmark.getObservations()[viewDistribution(generator)] =
+              sfmData::Observation(Vec2(valueDistribution(generator), valueDistribution(generator)), landmarkId + i, 1.0 + i);
+        }
+    }
+
+    const sfmData::FlatLandmarks flatLandmarks(landmarks);
+    BOOST_REQUIRE_EQUAL(flatLandmarks.size(), landmarks.size());
+
+    std::size_t landmarkIndex = 0;
+    std::size_t nbObservations = 0;
+    for (const auto& landmarkPair : landmarks)
+    {
+        BOOST_CHECK_EQUAL(flatLandmarks.getLandmarkId(landmarkIndex), landmarkPair.first);
+        BOOST_CHECK_EQUAL(flatLandmarks.findIndex(landmarkPair.first), landmarkIndex);
+        BOOST_CHECK(flatLandmarks.getX(landmarkIndex) == landmarkPair.second.X);
+        BOOST_CHECK(flatLandmarks.getDescType(landmarkIndex) == landmarkPair.second.descType);
+
+        const sfmData::Observations& observations = landmarkPair.second.getObservations();
+        BOOST_REQUIRE_EQUAL(flatLandmarks.getObservationsEnd(landmarkIndex) - flatLandmarks.getObservationsBegin(landmarkIndex),
+                            observations.size());
+
+        std::size_t observationIndex = flatLandmarks.getObservationsBegin(landmarkIndex);
+        for (const auto& observationPair : observations)
+        {
+            BOOST_CHECK_EQUAL(flatLandmarks.getObservationLandmarkIndex(observationIndex), landmarkIndex);
+            BOOST_CHECK_EQUAL(flatLandmarks.getObservationViewId(observationIndex), observationPair.first);
+            BOOST_CHECK(flatLandmarks.getObservationCoordinates(observationIndex) == observationPair.second.getCoordinates());
+            BOOST_CHECK_EQUAL(flatLandmarks.getObservationFeatureId(observationIndex), observationPair.second.getFeatureId());
+            BOOST_CHECK_EQUAL(flatLandmarks.getObservationScale(observationIndex), observationPair.second.getScale());
+            ++observationIndex;
+        }
+
+        nbObservations += observations.size();
+        ++landmarkIndex;
+    }
+    BOOST_CHECK_EQUAL(flatLandmarks.getNbObservations(), nbObservations);
+
+    // unknown landmark ids
+    BOOST_CHECK_EQUAL(flatLandmarks.findIndex(1), flatLandmarks.size());
+    BOOST_CHECK_EQUAL(flatLandmarks.findIndex(1000), flatLandmarks.size());
+}
+
+BOOST_AUTO_TEST_CASE(FlatLandmarks_observationsPerView)
+{
+    sfmData::Landmarks landmarks;
+    landmarks[10].getObservations()[2] = sfmData::Observation(Vec2(0.0, 0.0), 0, 0.0);
+    landmarks[10].getObservations()[5] = sfmData::Observation(Vec2(1.0, 0.0), 1, 0.0);
+    landmarks[20].getObservations()[5] = sfmData::Observation(Vec2(2.0, 0.0), 2, 0.0);
+    landmarks[30];
+    landmarks[40].getObservations()[2] = sfmData::Observation(Vec2(3.0, 0.0), 3, 0.0);
+    landmarks[40].getObservations()[7] = sfmData::Observation(Vec2(4.0, 0.0), 4, 0.0);
+
+    const sfmData::FlatLandmarks flatLandmarks(landmarks);
+
+    const std::vector<IndexT> expectedViewIds = {2, 5, 7};
+    BOOST_CHECK(flatLandmarks.getViewIds() == expectedViewIds);
+
+    // feature ids of the observations of each view, by increasing landmark id
+    const std::vector<std::vector<IndexT>> expectedFeatureIds = {{0, 3}, {1, 2}, {4}};
+    for (std::size_t v = 0; v < expectedViewIds.size(); ++v)
+    {
+        std::vector<IndexT> featureIds;
+        for (std::size_t i = flatLandmarks.getViewObservationsBegin(v); i < flatLandmarks.getViewObservationsEnd(v); ++i)
+        {
+            const std::size_t observationIndex = flatLandmarks.getViewObservationIndexes()[i];
+            BOOST_CHECK_EQUAL(flatLandmarks.getObservationViewId(observationIndex), expectedViewIds[v]);
+            featureIds.push_back(flatLandmarks.getObservationFeatureId(observationIndex));
+        }
+        BOOST_CHECK(featureIds == expectedFeatureIds[v]);
+    }
+
+    // the copy is replaced by a new build
+    sfmData::FlatLandmarks rebuilt(landmarks);
+    rebuilt.build(sfmData::Landmarks());
+    BOOST_CHECK_EQUAL(rebuilt.size(), 0);
+    BOOST_CHECK_EQUAL(rebuilt.getNbObservations(), 0);
+    BOOST_CHECK(rebuilt.getViewIds().empty());
+}
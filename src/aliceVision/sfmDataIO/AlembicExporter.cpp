@@ -7,6 +7,7 @@
 
 #include "AlembicExporter.hpp"
 #include <aliceVision/version.hpp>
+#include <aliceVision/alicevision_omp.hpp>
 
 #include <Alembic/AbcGeom/All.h>
 #include <Alembic/AbcCoreOgawa/All.h>
@@ -489,22 +490,28 @@ void AlembicExporter::addLandmarks(const sfmData::Landmarks& landmarks,
     if (landmarks.empty())
         return;
 
+    // random access to the landmarks, to fill the arrays in parallel
+    std::vector<const sfmData::Landmark*> landmarkPtrs;
+    landmarkPtrs.reserve(landmarks.size());
+    for (const auto& landmark : landmarks)
+        landmarkPtrs.push_back(&landmark.second);
+
+    const std::ptrdiff_t nbLandmarks = static_cast<std::ptrdiff_t>(landmarkPtrs.size());
+
     // Fill vector with the values taken from AliceVision
-    std::vector<V3f> positions;
-    std::vector<Imath::C3f> colors;
-    std::vector<Alembic::Util::uint32_t> descTypes;
-    positions.reserve(landmarks.size());
-    descTypes.reserve(landmarks.size());
+    std::vector<V3f> positions(landmarkPtrs.size());
+    std::vector<Imath::C3f> colors(landmarkPtrs.size());
+    std::vector<Alembic::Util::uint32_t> descTypes(landmarkPtrs.size());
 
-    // For all the 3d points in the hash_map
-    for (const auto& landmark : landmarks)
+#pragma omp parallel for
+    for (std::ptrdiff_t i = 0; i < nbLandmarks; ++i)
     {
-        const Vec3& pt = landmark.second.X;
-        const image::RGBColor& color = landmark.second.rgb;
+        const Vec3& pt = landmarkPtrs[i]->X;
+        const image::RGBColor& color = landmarkPtrs[i]->rgb;
         // convert position from computer vision convention to computer graphics (opengl-like)
-        positions.emplace_back(pt[0], -pt[1], -pt[2]);
-        colors.emplace_back(color.r() / 255.f, color.g() / 255.f, color.b() / 255.f);
-        descTypes.emplace_back(static_cast<Alembic::Util::uint8_t>(landmark.second.descType));
+        positions[i] = V3f(pt[0], -pt[1], -pt[2]);
+        colors[i] = Imath::C3f(color.r() / 255.f, color.g() / 255.f, color.b() / 255.f);
+        descTypes[i] = static_cast<Alembic::Util::uint8_t>(landmarkPtrs[i]->descType);
     }
 
     std::vector<Alembic::Util::uint64_t> ids(positions.size());
@@ -530,50 +537,53 @@ void AlembicExporter::addLandmarks(const sfmData::Landmarks& landmarks,
 
     if (withVisibility)
     {
-        std::vector<::uint32_t> visibilitySize;
-        visibilitySize.reserve(positions.size());
-        for (const auto& landmark : landmarks)
+        std::vector<::uint32_t> visibilitySize(landmarkPtrs.size());
+        // index of the first observation of each landmark in the visibility arrays
+        std::vector<std::size_t> obsFirstIndexes(landmarkPtrs.size() + 1, 0);
+        for (std::size_t i = 0; i < landmarkPtrs.size(); ++i)
         {
-            visibilitySize.emplace_back(landmark.second.getObservations().size());
+            visibilitySize[i] = landmarkPtrs[i]->getObservations().size();
+            obsFirstIndexes[i + 1] = obsFirstIndexes[i] + visibilitySize[i];
         }
-        std::size_t nbObservations = std::accumulate(visibilitySize.begin(), visibilitySize.end(), 0);
+        const std::size_t nbObservations = obsFirstIndexes.back();
 
         // Use std::vector<::uint32_t> and std::vector<float> instead of std::vector<V2i> and std::vector<V2f>
         // Because Maya don't import them correctly
-        std::vector<::uint32_t> visibilityViewId;
+        std::vector<::uint32_t> visibilityViewId(nbObservations);
         std::vector<::uint32_t> visibilityFeatId;
-        visibilityViewId.reserve(nbObservations);
 
         std::vector<float> featPos2d;
         std::vector<float> featScale;
         if (withFeatures)
         {
-            featPos2d.reserve(nbObservations * 2);
-            visibilityFeatId.reserve(nbObservations);
-            featScale.reserve(nbObservations);
+            featPos2d.resize(nbObservations * 2);
+            visibilityFeatId.resize(nbObservations);
+            featScale.resize(nbObservations);
         }
 
-        for (const auto& landmark : landmarks)
+#pragma omp parallel for
+        for (std::ptrdiff_t i = 0; i < nbLandmarks; ++i)
         {
-            const sfmData::Observations& observations = landmark.second.getObservations();
-            for (const auto& vObs : observations)
+            std::size_t obsGlobalIndex = obsFirstIndexes[i];
+            for (const auto& vObs : landmarkPtrs[i]->getObservations())
             {
                 const sfmData::Observation& obs = vObs.second;
 
                 // viewId
-                visibilityViewId.emplace_back(vObs.first);
+                visibilityViewId[obsGlobalIndex] = vObs.first;
 
                 if (withFeatures)
                 {
                     // featureId
-                    visibilityFeatId.emplace_back(obs.getFeatureId());
+                    visibilityFeatId[obsGlobalIndex] = obs.getFeatureId();
 
                     // feature 2D position (x, y))
-                    featPos2d.emplace_back(obs.getX());
-                    featPos2d.emplace_back(obs.getY());
+                    featPos2d[2 * obsGlobalIndex] = obs.getX();
+                    featPos2d[2 * obsGlobalIndex + 1] = obs.getY();
 
-                    featScale.emplace_back(obs.getScale());
+                    featScale[obsGlobalIndex] = obs.getScale();
                 }
+                ++obsGlobalIndex;
             }
         }
 
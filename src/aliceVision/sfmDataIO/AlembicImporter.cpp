@@ -13,6 +13,9 @@
 
 #include <aliceVision/version.hpp>
 #include <aliceVision/system/Logger.hpp>
+#include <aliceVision/alicevision_omp.hpp>
+
+#include <vector>
 
 namespace aliceVision {
 namespace sfmDataIO {
@@ -188,11 +191,19 @@ bool readPointCloud(const Version& abcVersion, IObject iObj, M44d mat, sfmData::
 
     // Number of points before adding the Alembic data
     const std::size_t nbPointsInit = sfmdata.getLandmarks().size();
-    for (std::size_t point3d_i = 0; point3d_i < positions->size(); ++point3d_i)
+    const std::size_t nbPoints = positions->size();
+
+    // create the landmarks sequentially, then decode their data in parallel
+    std::vector<sfmData::Landmark*> landmarks(nbPoints);
+    for (std::size_t point3d_i = 0; point3d_i < nbPoints; ++point3d_i)
+        landmarks[point3d_i] = &sfmdata.getLandmarks()[nbPointsInit + point3d_i];
+
+#pragma omp parallel for
+    for (std::ptrdiff_t point3d_i = 0; point3d_i < static_cast<std::ptrdiff_t>(nbPoints); ++point3d_i)
     {
         const P3fArraySamplePtr::element_type::value_type& pos_i = positions->get()[point3d_i];
 
-        sfmData::Landmark& landmark = sfmdata.getLandmarks()[nbPointsInit + point3d_i];
+        sfmData::Landmark& landmark = *landmarks[point3d_i];
 
         if (abcVersion < Version(1, 2, 3))
         {
@@ -333,23 +344,35 @@ bool readPointCloud(const Version& abcVersion, IObject iObj, M44d mat, sfmData::
 
         const bool hasFeatures = bool(sampleVisibilityFeatId) && (sampleVisibilityFeatId.size() > 0);
 
-        std::size_t obsGlobalIndex = 0;
-        for (std::size_t point3d_i = 0; point3d_i < positions->size(); ++point3d_i)
+        // index of the first observation of each point
+        std::vector<std::size_t> obsFirstIndexes(nbPoints + 1, 0);
+        for (std::size_t point3d_i = 0; point3d_i < nbPoints; ++point3d_i)
+            obsFirstIndexes[point3d_i + 1] = obsFirstIndexes[point3d_i] + sampleVisibilitySize[point3d_i];
+
+        if (obsFirstIndexes.back() != sampleVisibilityViewId.size())
         {
-            const int landmarkId = nbPointsInit + point3d_i;
-            sfmData::Landmark& landmark = sfmdata.getLandmarks()[landmarkId];
+            ALICEVISION_LOG_ERROR("Alembic Error: the sum of the visibility sizes should be the number of visibility view ids.\n"
+                                  "# observations: "
+                                  << obsFirstIndexes.back() << "\n"
+                                  << "# visibility view ids: " << sampleVisibilityViewId.size() << ".");
+            return false;
+        }
 
-            // Number of observation for this 3d point
-            const std::size_t visibilitySize = sampleVisibilitySize[point3d_i];
+#pragma omp parallel for
+        for (std::ptrdiff_t point3d_i = 0; point3d_i < static_cast<std::ptrdiff_t>(nbPoints); ++point3d_i)
+        {
+            sfmData::Landmark& landmark = *landmarks[point3d_i];
+            sfmData::Observations& observations = landmark.getObservations();
+            observations.reserve(obsFirstIndexes[point3d_i + 1] - obsFirstIndexes[point3d_i]);
 
-            for (std::size_t obs_i = 0; obs_i < visibilitySize; ++obs_i, ++obsGlobalIndex)
+            for (std::size_t obsGlobalIndex = obsFirstIndexes[point3d_i]; obsGlobalIndex < obsFirstIndexes[point3d_i + 1]; ++obsGlobalIndex)
             {
                 const int viewId = sampleVisibilityViewId[obsGlobalIndex];
 
                 if (hasFeatures)
                 {
                     const std::size_t featId = sampleVisibilityFeatId[obsGlobalIndex];
-                    sfmData::Observation& observation = landmark.getObservations()[viewId];
+                    sfmData::Observation& observation = observations[viewId];
                     observation.setFeatureId(featId);
 
                     const float posX = (*sampleVisibilityFeatPos)[2 * obsGlobalIndex];
@@ -364,7 +387,7 @@ bool readPointCloud(const Version& abcVersion, IObject iObj, M44d mat, sfmData::
                 }
                 else
                 {
-                    landmark.getObservations()[viewId] = sfmData::Observation();
+                    observations[viewId] = sfmData::Observation();
                 }
             }
         }
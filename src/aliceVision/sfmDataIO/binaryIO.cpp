@@ -0,0 +1,779 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "binaryIO.hpp"
+#include <aliceVision/sfmDataIO/jsonIO.hpp>
+#include <aliceVision/system/Logger.hpp>
+
+#include <boost/property_tree/json_parser.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+namespace aliceVision {
+namespace sfmDataIO {
+
+namespace {
+
+const char binaryMagic[8] = {'A', 'V', 'S', 'F', 'M', 'B', '\0', '\0'};
+
+enum class ESection : std::uint32_t
+{
+    FOLDERS = 0,
+    VIEWS = 1,
+    ANCESTORS = 2,
+    INTRINSICS = 3,
+    POSES = 4,
+    RIGS = 5,
+    STRUCTURE = 6,
+    LANDMARKS_PER_VIEW = 7
+};
+
+// structure section flags
+const std::uint8_t structureWithObservations = 1;
+const std::uint8_t structureWithFeatures = 2;
+
+template<typename T>
+inline void writeValue(std::ostream& stream, const T& value)
+{
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<typename T>
+inline T readValue(std::istream& stream)
+{
+    T value;
+    stream.read(reinterpret_cast<char*>(&value), sizeof(T));
+    return value;
+}
+
+inline void writeString(std::ostream& stream, const std::string& str)
+{
+    writeValue<std::uint64_t>(stream, str.size());
+    stream.write(str.data(), str.size());
+}
+
+inline std::string readString(std::istream& stream)
+{
+    const std::uint64_t size = readValue<std::uint64_t>(stream);
+    if (!stream)
+        return std::string();
+    std::string str(size, '\0');
+    stream.read(&str[0], size);
+    return str;
+}
+
+inline void writeTree(std::ostream& stream, const bpt::ptree& tree)
+{
+    std::ostringstream treeStream;
+    bpt::write_json(treeStream, tree, false);
+    writeString(stream, treeStream.str());
+}
+
+inline bpt::ptree readTree(std::istream& stream)
+{
+    std::istringstream treeStream(readString(stream));
+    bpt::ptree tree;
+    bpt::read_json(treeStream, tree);
+    return tree;
+}
+
+/**
+ * @brief Write a section header and the section payload, then patch the payload size in the header.
+ */
+template<typename WritePayload>
+void writeSection(std::ostream& stream, ESection section, WritePayload&& writePayload)
+{
+    writeValue<std::uint32_t>(stream, static_cast<std::uint32_t>(section));
+    const std::streampos sizePos = stream.tellp();
+    writeValue<std::uint64_t>(stream, 0);
+
+    writePayload(stream);
+
+    const std::streampos endPos = stream.tellp();
+    stream.seekp(sizePos);
+    writeValue<std::uint64_t>(stream, static_cast<std::uint64_t>(endPos - sizePos) - sizeof(std::uint64_t));
+    stream.seekp(endPos);
+}
+
+/**
+ * @brief Write each element of the container as an individual compact JSON string.
+ */
+template<typename Container, typename SaveElement>
+void writeTrees(std::ostream& stream, const Container& container, SaveElement&& saveElement)
+{
+    writeValue<std::uint64_t>(stream, container.size());
+    for (const auto& element : container)
+    {
+        bpt::ptree tree;
+        saveElement(element, tree);
+        writeTree(stream, tree.front().second);
+    }
+}
+
+void writeFolders(std::ostream& stream, const sfmData::SfMData& sfmData)
+{
+    const std::vector<std::string>& featuresFolders = sfmData.getRelativeFeaturesFolders();
+    const std::vector<std::string>& matchesFolders = sfmData.getRelativeMatchesFolders();
+
+    writeValue<std::uint64_t>(stream, featuresFolders.size());
+    for (const std::string& folder : featuresFolders)
+        writeString(stream, folder);
+
+    writeValue<std::uint64_t>(stream, matchesFolders.size());
+    for (const std::string& folder : matchesFolders)
+        writeString(stream, folder);
+}
+
+void writePoses(std::ostream& stream, const sfmData::Poses& poses)
+{
+    writeValue<std::uint64_t>(stream, poses.size());
+    for (const auto& posePair : poses)
+    {
+        const geometry::Pose3& transform = posePair.second.getTransform();
+        const Mat3& rotation = transform.rotation();
+        const Vec3 center = transform.center();
+
+        writeValue<IndexT>(stream, posePair.first);
+        stream.write(reinterpret_cast<const char*>(rotation.data()), 9 * sizeof(double));
+        stream.write(reinterpret_cast<const char*>(center.data()), 3 * sizeof(double));
+        writeValue<std::uint8_t>(stream, posePair.second.isLocked() ? 1 : 0);
+    }
+}
+
+/**
+ * @brief Write the structure section payload.
+ * @param[out] landmarkOffsets The offset of each landmark record from the beginning of the payload
+ */
+void writeStructure(std::ostream& stream,
+                    const sfmData::Landmarks& landmarks,
+                    bool saveObservations,
+                    bool saveFeatures,
+                    std::vector<std::uint64_t>& landmarkOffsets)
+{
+    const std::streampos payloadStart = stream.tellp();
+    landmarkOffsets.clear();
+    landmarkOffsets.reserve(landmarks.size());
+
+    std::uint8_t flags = 0;
+    if (saveObservations)
+        flags |= structureWithObservations;
+    if (saveFeatures)
+        flags |= structureWithFeatures;
+    writeValue<std::uint8_t>(stream, flags);
+
+    // describer types table
+    std::map<feature::EImageDescriberType, std::uint8_t> descTypeIndexes;
+    for (const auto& landmarkPair : landmarks)
+        descTypeIndexes.emplace(landmarkPair.second.descType, 0);
+
+    writeValue<std::uint8_t>(stream, static_cast<std::uint8_t>(descTypeIndexes.size()));
+    std::uint8_t descTypeIndex = 0;
+    for (auto& descTypePair : descTypeIndexes)
+    {
+        descTypePair.second = descTypeIndex++;
+        writeString(stream, feature::EImageDescriberType_enumToString(descTypePair.first));
+    }
+
+    // landmarks
+    writeValue<std::uint64_t>(stream, landmarks.size());
+    for (const auto& landmarkPair : landmarks)
+    {
+        const sfmData::Landmark& landmark = landmarkPair.second;
+
+        landmarkOffsets.push_back(static_cast<std::uint64_t>(stream.tellp() - payloadStart));
+        writeValue<IndexT>(stream, landmarkPair.first);
+        writeValue<std::uint8_t>(stream, descTypeIndexes.at(landmark.descType));
+        stream.write(reinterpret_cast<const char*>(landmark.X.data()), 3 * sizeof(double));
+        writeValue<std::uint8_t>(stream, landmark.rgb.r());
+        writeValue<std::uint8_t>(stream, landmark.rgb.g());
+        writeValue<std::uint8_t>(stream, landmark.rgb.b());
+
+        if (!saveObservations)
+            continue;
+
+        writeValue<std::uint32_t>(stream, static_cast<std::uint32_t>(landmark.getObservations().size()));
+        for (const auto& obsPair : landmark.getObservations())
+        {
+            writeValue<IndexT>(stream, obsPair.first);
+
+            if (saveFeatures)
+            {
+                const sfmData::Observation& observation = obsPair.second;
+                writeValue<IndexT>(stream, observation.getFeatureId());
+                stream.write(reinterpret_cast<const char*>(observation.getCoordinates().data()), 2 * sizeof(double));
+                writeValue<double>(stream, observation.getScale());
+            }
+        }
+    }
+}
+
+/**
+ * @brief Write the landmarks per view section payload: the offset of each landmark record in the structure section,
+ *        then the list of the landmarks (by their index in the structure section) observed by each view.
+ */
+void writeLandmarksPerView(std::ostream& stream, const sfmData::Landmarks& landmarks, const std::vector<std::uint64_t>& landmarkOffsets)
+{
+    writeValue<std::uint64_t>(stream, landmarkOffsets.size());
+    stream.write(reinterpret_cast<const char*>(landmarkOffsets.data()), landmarkOffsets.size() * sizeof(std::uint64_t));
+
+    std::map<IndexT, std::vector<std::uint32_t>> landmarksPerView;
+    std::uint32_t landmarkIndex = 0;
+    for (const auto& landmarkPair : landmarks)
+    {
+        for (const auto& obsPair : landmarkPair.second.getObservations())
+            landmarksPerView[obsPair.first].push_back(landmarkIndex);
+        ++landmarkIndex;
+    }
+
+    writeValue<std::uint64_t>(stream, landmarksPerView.size());
+    for (const auto& viewLandmarksPair : landmarksPerView)
+    {
+        const std::vector<std::uint32_t>& viewLandmarks = viewLandmarksPair.second;
+        writeValue<IndexT>(stream, viewLandmarksPair.first);
+        writeValue<std::uint32_t>(stream, static_cast<std::uint32_t>(viewLandmarks.size()));
+        stream.write(reinterpret_cast<const char*>(viewLandmarks.data()), viewLandmarks.size() * sizeof(std::uint32_t));
+    }
+}
+
+void readFolders(std::istream& stream, sfmData::SfMData& sfmData)
+{
+    const std::uint64_t nbFeaturesFolders = readValue<std::uint64_t>(stream);
+    for (std::uint64_t i = 0; i < nbFeaturesFolders && stream; ++i)
+        sfmData.addFeaturesFolder(readString(stream));
+
+    const std::uint64_t nbMatchesFolders = readValue<std::uint64_t>(stream);
+    for (std::uint64_t i = 0; i < nbMatchesFolders && stream; ++i)
+        sfmData.addMatchesFolder(readString(stream));
+}
+
+void readPoses(std::istream& stream, sfmData::Poses& poses)
+{
+    const std::uint64_t nbPoses = readValue<std::uint64_t>(stream);
+    for (std::uint64_t i = 0; i < nbPoses && stream; ++i)
+    {
+        const IndexT poseId = readValue<IndexT>(stream);
+        Mat3 rotation;
+        Vec3 center;
+        stream.read(reinterpret_cast<char*>(rotation.data()), 9 * sizeof(double));
+        stream.read(reinterpret_cast<char*>(center.data()), 3 * sizeof(double));
+        const bool locked = readValue<std::uint8_t>(stream) != 0;
+
+        poses.emplace_hint(poses.end(), poseId, sfmData::CameraPose(geometry::Pose3(rotation, center), locked));
+    }
+}
+
+struct StructureHeader
+{
+    bool hasObservations = false;
+    bool hasFeatures = false;
+    std::vector<feature::EImageDescriberType> descTypes;
+};
+
+StructureHeader readStructureHeader(std::istream& stream)
+{
+    StructureHeader header;
+
+    const std::uint8_t flags = readValue<std::uint8_t>(stream);
+    header.hasObservations = (flags & structureWithObservations) != 0;
+    header.hasFeatures = (flags & structureWithFeatures) != 0;
+
+    // describer types table
+    header.descTypes.resize(readValue<std::uint8_t>(stream));
+    for (feature::EImageDescriberType& descType : header.descTypes)
+        descType = feature::EImageDescriberType_stringToEnum(readString(stream));
+
+    return header;
+}
+
+void readLandmark(std::istream& stream,
+                  const StructureHeader& header,
+                  bool loadObservations,
+                  bool loadFeatures,
+                  IndexT& landmarkId,
+                  sfmData::Landmark& landmark)
+{
+    // skipped data of each observation
+    const std::streamoff featureSize = sizeof(IndexT) + 3 * sizeof(double);
+    const std::streamoff observationSize = sizeof(IndexT) + (header.hasFeatures ? featureSize : 0);
+
+    landmarkId = readValue<IndexT>(stream);
+    landmark.descType = header.descTypes.at(readValue<std::uint8_t>(stream));
+    stream.read(reinterpret_cast<char*>(landmark.X.data()), 3 * sizeof(double));
+    landmark.rgb.r() = readValue<std::uint8_t>(stream);
+    landmark.rgb.g() = readValue<std::uint8_t>(stream);
+    landmark.rgb.b() = readValue<std::uint8_t>(stream);
+
+    if (!header.hasObservations)
+        return;
+
+    const std::uint32_t nbObservations = readValue<std::uint32_t>(stream);
+
+    if (!loadObservations)
+    {
+        stream.seekg(nbObservations * observationSize, std::ios::cur);
+        return;
+    }
+
+    sfmData::Observations& observations = landmark.getObservations();
+    observations.reserve(nbObservations);
+
+    for (std::uint32_t j = 0; j < nbObservations && stream; ++j)
+    {
+        const IndexT viewId = readValue<IndexT>(stream);
+        sfmData::Observation observation;
+
+        if (header.hasFeatures)
+        {
+            if (loadFeatures)
+            {
+                observation.setFeatureId(readValue<IndexT>(stream));
+                stream.read(reinterpret_cast<char*>(observation.getCoordinates().data()), 2 * sizeof(double));
+                observation.setScale(readValue<double>(stream));
+            }
+            else
+            {
+                stream.seekg(featureSize, std::ios::cur);
+            }
+        }
+
+        observations.emplace_hint(observations.end(), viewId, observation);
+    }
+}
+
+void readStructure(std::istream& stream, sfmData::Landmarks& landmarks, bool loadObservations, bool loadFeatures)
+{
+    const StructureHeader header = readStructureHeader(stream);
+
+    const std::uint64_t nbLandmarks = readValue<std::uint64_t>(stream);
+    for (std::uint64_t i = 0; i < nbLandmarks && stream; ++i)
+    {
+        IndexT landmarkId;
+        sfmData::Landmark landmark;
+        readLandmark(stream, header, loadObservations, loadFeatures, landmarkId, landmark);
+        landmarks.emplace_hint(landmarks.end(), landmarkId, std::move(landmark));
+    }
+}
+
+/**
+ * @brief Open a binary SfMData file and read its header.
+ * @param[out] fileSize The total size of the file
+ * @param[out] version The file version
+ * @return true if the file is a binary SfMData file readable by this library
+ */
+bool openBinary(std::ifstream& stream, const std::string& filename, std::streampos& fileSize, Version& version)
+{
+    stream.open(filename, std::ios::binary | std::ios::ate);
+    if (!stream.is_open())
+    {
+        ALICEVISION_LOG_ERROR("Unable to open the binary SfMData file: '" << filename << "'.");
+        return false;
+    }
+    fileSize = stream.tellg();
+    stream.seekg(0);
+
+    char magic[sizeof(binaryMagic)];
+    stream.read(magic, sizeof(magic));
+    if (!stream || std::memcmp(magic, binaryMagic, sizeof(binaryMagic)) != 0)
+    {
+        ALICEVISION_LOG_ERROR("The file '" << filename << "' is not a binary SfMData file.");
+        return false;
+    }
+
+    Vec3i v;
+    v(0) = readValue<std::int32_t>(stream);
+    v(1) = readValue<std::int32_t>(stream);
+    v(2) = readValue<std::int32_t>(stream);
+    version = v;
+
+    const Vec3i currentVersion = {ALICEVISION_SFMDATAIO_VERSION_MAJOR, ALICEVISION_SFMDATAIO_VERSION_MINOR, ALICEVISION_SFMDATAIO_VERSION_REVISION};
+    if (!stream || Version(currentVersion) < version)
+    {
+        ALICEVISION_LOG_ERROR("File has a version more recent than this library");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Read the next section header and check that the section is within the file.
+ * @param[out] sectionType The section type
+ * @param[out] sectionEnd The position of the end of the section
+ * @return false if the end of the file is reached or if the section is truncated (the stream is then in a failed state)
+ */
+bool readSectionHeader(std::istream& stream, std::streampos fileSize, std::uint32_t& sectionType, std::streampos& sectionEnd)
+{
+    if (!stream || stream.tellg() >= fileSize)
+        return false;
+
+    sectionType = readValue<std::uint32_t>(stream);
+    const std::uint64_t sectionSize = readValue<std::uint64_t>(stream);
+    if (!stream)
+        return false;
+
+    sectionEnd = stream.tellg() + static_cast<std::streamoff>(sectionSize);
+    if (sectionEnd > fileSize)
+    {
+        stream.setstate(std::ios::failbit);
+        return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+bool saveBinary(const sfmData::SfMData& sfmData, const std::string& filename, ESfMData partFlag)
+{
+    // save flags
+    const bool saveViews = (partFlag & VIEWS) == VIEWS;
+    const bool saveAncestors = (partFlag & ANCESTORS) == ANCESTORS;
+    const bool saveIntrinsics = (partFlag & INTRINSICS) == INTRINSICS;
+    const bool saveExtrinsics = (partFlag & EXTRINSICS) == EXTRINSICS;
+    const bool saveStructure = (partFlag & STRUCTURE) == STRUCTURE;
+    const bool saveFeatures = (partFlag & OBSERVATIONS_WITH_FEATURES) == OBSERVATIONS_WITH_FEATURES;
+    const bool saveObservations = saveFeatures || ((partFlag & OBSERVATIONS) == OBSERVATIONS);
+
+    std::ofstream stream(filename, std::ios::binary);
+    if (!stream.is_open())
+    {
+        ALICEVISION_LOG_ERROR("Unable to open the binary SfMData file: '" << filename << "'.");
+        return false;
+    }
+
+    // header
+    stream.write(binaryMagic, sizeof(binaryMagic));
+    writeValue<std::int32_t>(stream, ALICEVISION_SFMDATAIO_VERSION_MAJOR);
+    writeValue<std::int32_t>(stream, ALICEVISION_SFMDATAIO_VERSION_MINOR);
+    writeValue<std::int32_t>(stream, ALICEVISION_SFMDATAIO_VERSION_REVISION);
+
+    // folders
+    writeSection(stream, ESection::FOLDERS, [&](std::ostream& s) { writeFolders(s, sfmData); });
+
+    // views
+    if (saveViews && !sfmData.getViews().empty())
+    {
+        writeSection(stream, ESection::VIEWS, [&](std::ostream& s) {
+            writeTrees(s, sfmData.getViews(), [](const auto& viewPair, bpt::ptree& tree) { saveView("", *(viewPair.second), tree); });
+        });
+    }
+
+    // ancestors
+    if (saveAncestors && !sfmData.getAncestors().empty())
+    {
+        writeSection(stream, ESection::ANCESTORS, [&](std::ostream& s) {
+            writeTrees(s, sfmData.getAncestors(), [](const auto& ancestorPair, bpt::ptree& tree) {
+                saveAncestor("", ancestorPair.first, ancestorPair.second, tree);
+            });
+        });
+    }
+
+    // intrinsics
+    if (saveIntrinsics && !sfmData.getIntrinsics().empty())
+    {
+        writeSection(stream, ESection::INTRINSICS, [&](std::ostream& s) {
+            writeTrees(s, sfmData.getIntrinsics(), [](const auto& intrinsicPair, bpt::ptree& tree) {
+                saveIntrinsic("", intrinsicPair.first, intrinsicPair.second, tree);
+            });
+        });
+    }
+
+    // extrinsics
+    if (saveExtrinsics)
+    {
+        // poses
+        if (!sfmData.getPoses().empty())
+            writeSection(stream, ESection::POSES, [&](std::ostream& s) { writePoses(s, sfmData.getPoses()); });
+
+        // rigs
+        if (!sfmData.getRigs().empty())
+        {
+            writeSection(stream, ESection::RIGS, [&](std::ostream& s) {
+                writeTrees(s, sfmData.getRigs(), [](const auto& rigPair, bpt::ptree& tree) { saveRig("", rigPair.first, rigPair.second, tree); });
+            });
+        }
+    }
+
+    // structure
+    if (saveStructure && !sfmData.getLandmarks().empty())
+    {
+        std::vector<std::uint64_t> landmarkOffsets;
+        writeSection(stream, ESection::STRUCTURE, [&](std::ostream& s) {
+            writeStructure(s, sfmData.getLandmarks(), saveObservations, saveFeatures, landmarkOffsets);
+        });
+
+        // landmarks per view
+        if (saveObservations)
+        {
+            writeSection(
+              stream, ESection::LANDMARKS_PER_VIEW, [&](std::ostream& s) { writeLandmarksPerView(s, sfmData.getLandmarks(), landmarkOffsets); });
+        }
+    }
+
+    if (!stream)
+    {
+        ALICEVISION_LOG_ERROR("Unable to write the binary SfMData file: '" << filename << "'.");
+        return false;
+    }
+
+    return true;
+}
+
+bool loadBinary(sfmData::SfMData& sfmData, const std::string& filename, ESfMData partFlag)
+{
+    // load flags
+    const bool loadViews = (partFlag & VIEWS) == VIEWS;
+    const bool loadAncestors = (partFlag & ANCESTORS) == ANCESTORS;
+    const bool loadIntrinsics = (partFlag & INTRINSICS) == INTRINSICS;
+    const bool loadExtrinsics = (partFlag & EXTRINSICS) == EXTRINSICS;
+    const bool loadStructure = (partFlag & STRUCTURE) == STRUCTURE;
+    const bool loadFeatures = (partFlag & OBSERVATIONS_WITH_FEATURES) == OBSERVATIONS_WITH_FEATURES;
+    const bool loadObservations = loadFeatures || ((partFlag & OBSERVATIONS) == OBSERVATIONS);
+
+    std::ifstream stream;
+    std::streampos fileSize;
+    Version version;
+    if (!openBinary(stream, filename, fileSize, version))
+        return false;
+
+    // sections
+    std::uint32_t sectionType;
+    std::streampos sectionEnd;
+    while (readSectionHeader(stream, fileSize, sectionType, sectionEnd))
+    {
+        switch (static_cast<ESection>(sectionType))
+        {
+            case ESection::FOLDERS:
+            {
+                readFolders(stream, sfmData);
+                break;
+            }
+            case ESection::VIEWS:
+            {
+                if (!loadViews)
+                    break;
+
+                sfmData::Views& views = sfmData.getViews();
+                const std::uint64_t nbViews = readValue<std::uint64_t>(stream);
+                for (std::uint64_t i = 0; i < nbViews && stream; ++i)
+                {
+                    bpt::ptree viewTree = readTree(stream);
+                    auto view = std::make_shared<sfmData::View>();
+                    loadView(*view, viewTree);
+                    views.emplace(view->getViewId(), view);
+                }
+                break;
+            }
+            case ESection::ANCESTORS:
+            {
+                if (!loadAncestors)
+                    break;
+
+                sfmData::ImageInfos& ancestors = sfmData.getAncestors();
+                const std::uint64_t nbAncestors = readValue<std::uint64_t>(stream);
+                for (std::uint64_t i = 0; i < nbAncestors && stream; ++i)
+                {
+                    bpt::ptree ancestorTree = readTree(stream);
+                    IndexT ancestorId;
+                    std::shared_ptr<sfmData::ImageInfo> ancestor = std::make_shared<sfmData::ImageInfo>();
+                    loadAncestor(ancestorId, ancestor, ancestorTree);
+                    ancestors.emplace(ancestorId, ancestor);
+                }
+                break;
+            }
+            case ESection::INTRINSICS:
+            {
+                if (!loadIntrinsics)
+                    break;
+
+                sfmData::Intrinsics& intrinsics = sfmData.getIntrinsics();
+                const std::uint64_t nbIntrinsics = readValue<std::uint64_t>(stream);
+                for (std::uint64_t i = 0; i < nbIntrinsics && stream; ++i)
+                {
+                    bpt::ptree intrinsicTree = readTree(stream);
+                    IndexT intrinsicId;
+                    std::shared_ptr<camera::IntrinsicBase> intrinsic;
+                    loadIntrinsic(version, intrinsicId, intrinsic, intrinsicTree);
+                    intrinsics.emplace(intrinsicId, intrinsic);
+                }
+                break;
+            }
+            case ESection::POSES:
+            {
+                if (loadExtrinsics)
+                    readPoses(stream, sfmData.getPoses());
+                break;
+            }
+            case ESection::RIGS:
+            {
+                if (!loadExtrinsics)
+                    break;
+
+                sfmData::Rigs& rigs = sfmData.getRigs();
+                const std::uint64_t nbRigs = readValue<std::uint64_t>(stream);
+                for (std::uint64_t i = 0; i < nbRigs && stream; ++i)
+                {
+                    bpt::ptree rigTree = readTree(stream);
+                    IndexT rigId;
+                    sfmData::Rig rig;
+                    loadRig(rigId, rig, rigTree);
+                    rigs.emplace(rigId, rig);
+                }
+                break;
+            }
+            case ESection::STRUCTURE:
+            {
+                if (loadStructure)
+                    readStructure(stream, sfmData.getLandmarks(), loadObservations, loadFeatures);
+                break;
+            }
+            case ESection::LANDMARKS_PER_VIEW:
+            {
+                // only used to load the landmarks of a subset of views
+                break;
+            }
+            default:
+            {
+                // unknown section from a more recent revision: skip it
+                break;
+            }
+        }
+
+        // skip the section remainder (or the whole section if not requested)
+        if (stream.tellg() > sectionEnd)
+            stream.setstate(std::ios::failbit);
+        stream.seekg(sectionEnd);
+    }
+
+    if (!stream)
+    {
+        ALICEVISION_LOG_ERROR("The binary SfMData file '" << filename << "' is truncated or corrupted.");
+        return false;
+    }
+
+    return true;
+}
+
+bool loadBinaryLandmarksOfViews(sfmData::SfMData& sfmData, const std::string& filename, const std::set<IndexT>& viewIds)
+{
+    std::ifstream stream;
+    std::streampos fileSize;
+    Version version;
+    if (!openBinary(stream, filename, fileSize, version))
+        return false;
+
+    // locate the structure and the landmarks per view sections
+    std::streampos structureStart = -1;
+    std::streampos landmarksPerViewStart = -1;
+
+    std::uint32_t sectionType;
+    std::streampos sectionEnd;
+    while (readSectionHeader(stream, fileSize, sectionType, sectionEnd))
+    {
+        if (sectionType == static_cast<std::uint32_t>(ESection::STRUCTURE))
+            structureStart = stream.tellg();
+        else if (sectionType == static_cast<std::uint32_t>(ESection::LANDMARKS_PER_VIEW))
+            landmarksPerViewStart = stream.tellg();
+        stream.seekg(sectionEnd);
+    }
+
+    if (!stream)
+    {
+        ALICEVISION_LOG_ERROR("The binary SfMData file '" << filename << "' is truncated or corrupted.");
+        return false;
+    }
+
+    // no structure
+    if (structureStart == std::streampos(-1))
+        return true;
+
+    sfmData::Landmarks& landmarks = sfmData.getLandmarks();
+
+    stream.seekg(structureStart);
+    const StructureHeader header = readStructureHeader(stream);
+
+    // no index of the landmarks per view: read the whole structure and keep the landmarks observed by the views
+    if (landmarksPerViewStart == std::streampos(-1))
+    {
+        if (!header.hasObservations)
+            return true;
+
+        sfmData::Landmarks allLandmarks;
+        stream.seekg(structureStart);
+        readStructure(stream, allLandmarks, true, true);
+
+        for (auto& landmarkPair : allLandmarks)
+        {
+            const sfmData::Observations& observations = landmarkPair.second.getObservations();
+            if (std::any_of(observations.begin(), observations.end(), [&](const auto& obsPair) { return viewIds.count(obsPair.first) > 0; }))
+                landmarks.emplace(landmarkPair.first, std::move(landmarkPair.second));
+        }
+        return bool(stream);
+    }
+
+    // collect the index of the landmarks observed by the views
+    stream.seekg(landmarksPerViewStart);
+    const std::uint64_t nbLandmarks = readValue<std::uint64_t>(stream);
+    const std::streampos offsetsStart = stream.tellg();
+    stream.seekg(nbLandmarks * sizeof(std::uint64_t), std::ios::cur);
+
+    std::vector<std::uint32_t> landmarkIndexes;
+    const std::uint64_t nbViews = readValue<std::uint64_t>(stream);
+    for (std::uint64_t i = 0; i < nbViews && stream; ++i)
+    {
+        const IndexT viewId = readValue<IndexT>(stream);
+        const std::uint32_t nbViewLandmarks = readValue<std::uint32_t>(stream);
+
+        if (viewIds.count(viewId) == 0)
+        {
+            stream.seekg(nbViewLandmarks * sizeof(std::uint32_t), std::ios::cur);
+            continue;
+        }
+
+        const std::size_t previousSize = landmarkIndexes.size();
+        landmarkIndexes.resize(previousSize + nbViewLandmarks);
+        stream.read(reinterpret_cast<char*>(landmarkIndexes.data() + previousSize), nbViewLandmarks * sizeof(std::uint32_t));
+    }
+
+    std::sort(landmarkIndexes.begin(), landmarkIndexes.end());
+    landmarkIndexes.erase(std::unique(landmarkIndexes.begin(), landmarkIndexes.end()), landmarkIndexes.end());
+
+    // read only the records of these landmarks, in the order of the file
+    for (const std::uint32_t landmarkIndex : landmarkIndexes)
+    {
+        if (!stream || landmarkIndex >= nbLandmarks)
+        {
+            stream.setstate(std::ios::failbit);
+            break;
+        }
+
+        stream.seekg(offsetsStart + static_cast<std::streamoff>(landmarkIndex * sizeof(std::uint64_t)));
+        const std::uint64_t landmarkOffset = readValue<std::uint64_t>(stream);
+        stream.seekg(structureStart + static_cast<std::streamoff>(landmarkOffset));
+
+        IndexT landmarkId;
+        sfmData::Landmark landmark;
+        readLandmark(stream, header, true, true, landmarkId, landmark);
+        landmarks.emplace_hint(landmarks.end(), landmarkId, std::move(landmark));
+    }
+
+    if (!stream)
+    {
+        ALICEVISION_LOG_ERROR("The binary SfMData file '" << filename << "' is truncated or corrupted.");
+        return false;
+    }
+
+    return true;
+}
+
+}  // namespace sfmDataIO
+}  // namespace aliceVision
@@ -0,0 +1,57 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/sfmDataIO/sfmDataIO.hpp>
+
+#include <set>
+#include <string>
+
+namespace aliceVision {
+namespace sfmDataIO {
+
+// AliceVision binary SfMData file (.sfmb):
+// -- Header
+// magic "AVSFMB" + 2 padding bytes, SfMData IO version [major, minor, revision] (int32)
+// -- Sections
+// [section type (uint32), payload size in bytes (uint64), payload]
+// The payload size allows to skip the sections which are not requested by the ESfMData load flags.
+// Small sections (views, ancestors, intrinsics, rigs) store their compact JSON representation,
+// large sections (poses, structure) are stored in a raw little-endian binary layout.
+// When the observations are saved, the structure is followed by a landmarks per view section:
+// the offset of each landmark record in the structure, and the list of the landmarks observed by each view.
+
+/**
+ * @brief Save an SfMData in a binary file, section by section without any intermediate representation.
+ * @param[in] sfmData The input SfMData
+ * @param[in] filename The filename
+ * @param[in] partFlag The ESfMData save flag
+ * @return true if completed
+ */
+bool saveBinary(const sfmData::SfMData& sfmData, const std::string& filename, ESfMData partFlag);
+
+/**
+ * @brief Load a binary SfMData file. The sections not requested by the load flags are skipped without being parsed.
+ * @param[out] sfmData The output SfMData
+ * @param[in] filename The filename
+ * @param[in] partFlag The ESfMData load flag
+ * @return true if completed
+ */
+bool loadBinary(sfmData::SfMData& sfmData, const std::string& filename, ESfMData partFlag);
+
+/**
+ * @brief Load from a binary SfMData file only the landmarks observed by at least one of the given views.
+ *        The landmarks per view section allows to read only their records, without reading the whole structure.
+ * @param[in,out] sfmData The SfMData in which the landmarks are added (with all their observations)
+ * @param[in] filename The filename
+ * @param[in] viewIds The view ids
+ * @return true if completed
+ */
+bool loadBinaryLandmarksOfViews(sfmData::SfMData& sfmData, const std::string& filename, const std::set<IndexT>& viewIds);
+
+}  // namespace sfmDataIO
+}  // namespace aliceVision
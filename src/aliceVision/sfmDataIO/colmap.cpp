@@ -8,6 +8,8 @@
 #include <aliceVision/geometry/Pose3.hpp>
 #include <aliceVision/camera/cameraCommon.hpp>
 
+#include <algorithm>
+#include <cstdint>
 #include <filesystem>
 #include <fstream>
 #include <sstream>
@@ -26,8 +28,119 @@ ColmapConfig::ColmapConfig(const std::string& basePath)
     _camerasTxtPath = (fs::path(_sparseDirectory) / fs::path("cameras.txt")).string();
     _imagesTxtPath = (fs::path(_sparseDirectory) / fs::path("images.txt")).string();
     _points3DPath = (fs::path(_sparseDirectory) / fs::path("points3D.txt")).string();
+    _camerasBinPath = (fs::path(_sparseDirectory) / fs::path("cameras.bin")).string();
+    _imagesBinPath = (fs::path(_sparseDirectory) / fs::path("images.bin")).string();
+    _points3DBinPath = (fs::path(_sparseDirectory) / fs::path("points3D.bin")).string();
 }
 
+namespace {
+
+/// Colmap camera model ids, from Colmap's src/colmap/sensor/models.h
+enum EColmapCameraModel
+{
+    COLMAP_PINHOLE = 1,
+    COLMAP_OPENCV_FISHEYE = 5,
+    COLMAP_FULL_OPENCV = 6,
+    COLMAP_FOV = 7
+};
+
+template<typename T>
+inline void writeBinary(std::ostream& stream, const T& value)
+{
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+/**
+ * @brief Format elements by chunks in parallel and write the chunks in order.
+ *        The chunk streams have the formatting flags of the output stream.
+ * @param[in,out] outfile the output stream
+ * @param[in] nbElements the number of elements
+ * @param[in] format the function formatting an element in a stream: format(elementIndex, stream)
+ */
+template<typename Format>
+void writeInParallel(std::ostream& outfile, std::size_t nbElements, Format format)
+{
+    const std::size_t chunkSize = 4096;
+    const std::size_t chunksPerBlock = 64;
+    const std::size_t nbChunks = (nbElements + chunkSize - 1) / chunkSize;
+
+    // the chunks are written by blocks, to bound the memory used by the formatted data
+    std::vector<std::ostringstream> chunks(std::min(chunksPerBlock, nbChunks));
+    for (std::size_t firstChunk = 0; firstChunk < nbChunks; firstChunk += chunksPerBlock)
+    {
+        const int nbBlockChunks = static_cast<int>(std::min(chunksPerBlock, nbChunks - firstChunk));
+
+#pragma omp parallel for
+        for (int c = 0; c < nbBlockChunks; ++c)
+        {
+            std::ostringstream& chunk = chunks[c];
+            chunk.str(std::string());
+            chunk.copyfmt(outfile);
+
+            const std::size_t begin = (firstChunk + c) * chunkSize;
+            const std::size_t end = std::min(begin + chunkSize, nbElements);
+            for (std::size_t i = begin; i < end; ++i)
+            {
+                format(i, chunk);
+            }
+        }
+
+        for (int c = 0; c < nbBlockChunks; ++c)
+        {
+            const std::string data = chunks[c].str();
+            outfile.write(data.data(), data.size());
+        }
+    }
+}
+
+/**
+ * @brief Observations of the landmarks in the selected views, in the layout of the Colmap binary files.
+ */
+struct ColmapObservations
+{
+    /// the landmarks, in id order
+    std::vector<const sfmData::Landmarks::value_type*> landmarks;
+    /// per view, the points (coordinates and landmark id) in landmark id order
+    std::map<IndexT, std::vector<std::pair<Vec2, IndexT>>> viewsPoints;
+    /// the track of landmark i is tracks[tracksOffsets[i]] to tracks[tracksOffsets[i + 1] - 1]
+    std::vector<std::size_t> tracksOffsets;
+    /// view id and index of the point in the view points
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> tracks;
+};
+
+void computeColmapObservations(const sfmData::SfMData& sfmData, const CompatibleList& viewSelections, ColmapObservations& out_observations)
+{
+    const sfmData::Landmarks& landmarks = sfmData.getLandmarks();
+
+    out_observations.landmarks.reserve(landmarks.size());
+    out_observations.tracksOffsets.reserve(landmarks.size() + 1);
+    out_observations.tracksOffsets.push_back(0);
+
+    for (const auto& viewId : viewSelections)
+    {
+        out_observations.viewsPoints[viewId];
+    }
+
+    for (const auto& land : landmarks)
+    {
+        out_observations.landmarks.push_back(&land);
+
+        for (const auto& itObs : land.second.getObservations())
+        {
+            const auto it = out_observations.viewsPoints.find(itObs.first);
+            if (it == out_observations.viewsPoints.end())
+            {
+                continue;
+            }
+            out_observations.tracks.emplace_back(itObs.first, static_cast<std::uint32_t>(it->second.size()));
+            it->second.emplace_back(itObs.second.getCoordinates(), land.first);
+        }
+        out_observations.tracksOffsets.push_back(out_observations.tracks.size());
+    }
+}
+
+}  // namespace
+
 
 bool isColmapCompatible(camera::EINTRINSIC intrinsicType, camera::EDISTORTION distortionType)
 {
@@ -228,6 +341,51 @@ std::string convertIntrinsicsToColmapString(const IndexT intrinsicsID, std::shar
     return intrString.str();
 }
 
+int getColmapCameraModel(const IndexT intrinsicsID, const camera::IntrinsicBase& intrinsic, std::vector<double>& out_params)
+{
+    const camera::EINTRINSIC current_type = intrinsic.getType();
+    const camera::EDISTORTION distoType = camera::getDistortionType(intrinsic);
+
+    if (current_type != camera::EINTRINSIC::PINHOLE_CAMERA)
+    {
+        throw std::invalid_argument("The intrinsics " + EINTRINSIC_enumToString(current_type) + " for camera " + std::to_string(intrinsicsID) +
+                                    " are not supported in Colmap");
+    }
+
+    const camera::Pinhole& pinhole = dynamic_cast<const camera::Pinhole&>(intrinsic);
+    const std::vector<double> params = pinhole.getParams();
+
+    out_params = {pinhole.getFocalLengthPixX(), pinhole.getFocalLengthPixY(), pinhole.getPrincipalPoint().x(), pinhole.getPrincipalPoint().y()};
+
+    // same conversions as convertIntrinsicsToColmapString
+    switch (distoType)
+    {
+        case camera::DISTORTION_NONE:
+            return COLMAP_PINHOLE;
+        case camera::DISTORTION_RADIALK1:
+            // k1, k2, p1, p2, k3, k4, k5, k6
+            out_params.insert(out_params.end(), {params.at(4), 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0});
+            return COLMAP_FULL_OPENCV;
+        case camera::DISTORTION_RADIALK3:
+            out_params.insert(out_params.end(), {params.at(4), params.at(5), 0.0, 0.0, params.at(6), 0.0, 0.0, 0.0});
+            return COLMAP_FULL_OPENCV;
+        case camera::DISTORTION_BROWN:
+            out_params.insert(out_params.end(), {params.at(4), params.at(5), params.at(7), params.at(8), params.at(6), 0.0, 0.0, 0.0});
+            return COLMAP_FULL_OPENCV;
+        case camera::DISTORTION_FISHEYE:
+            // k1, k2, k3, k4
+            out_params.insert(out_params.end(), {params.at(4), params.at(5), params.at(6), params.at(7)});
+            return COLMAP_OPENCV_FISHEYE;
+        case camera::DISTORTION_FISHEYE1:
+            // omega
+            out_params.push_back(params.at(4));
+            return COLMAP_FOV;
+        default:
+            throw std::invalid_argument("The intrinsics " + EINTRINSIC_enumToString(current_type) + " for camera " + std::to_string(intrinsicsID) +
+                                        " are not supported in Colmap");
+    }
+}
+
 void generateColmapCamerasTxtFile(const sfmData::SfMData& sfmData, const std::string& filename)
 {
     // Adapted from Colmap Reconstruction::WriteCamerasText()
@@ -374,32 +532,179 @@ void generateColmapPoints3DTxtFile(const sfmData::SfMData& sfmData, const Compat
     // default reprojection error (not used)
     const double defaultError{-1.0};
 
+    std::vector<const sfmData::Landmarks::value_type*> landmarks;
+    landmarks.reserve(sfmData.getLandmarks().size());
     for (const auto& iter : sfmData.getLandmarks())
     {
-        const IndexT id = iter.first;
-        const Vec3 exportPoint = iter.second.X;
-        const auto pointColor = iter.second.rgb;
-        outfile << id << " " << exportPoint.x() << " " << exportPoint.y() << " " << exportPoint.z() << " " << static_cast<int>(pointColor.r()) << " "
-                << static_cast<int>(pointColor.g()) << " " << static_cast<int>(pointColor.b()) << " ";
+        landmarks.push_back(&iter);
+    }
+
+    writeInParallel(outfile, landmarks.size(), [&](std::size_t i, std::ostream& stream) {
+        const IndexT id = landmarks[i]->first;
+        const sfmData::Landmark& landmark = landmarks[i]->second;
+        const Vec3 exportPoint = landmark.X;
+        const auto pointColor = landmark.rgb;
+        stream << id << " " << exportPoint.x() << " " << exportPoint.y() << " " << exportPoint.z() << " " << static_cast<int>(pointColor.r()) << " "
+               << static_cast<int>(pointColor.g()) << " " << static_cast<int>(pointColor.b()) << " ";
 
-        outfile << defaultError;
+        stream << defaultError;
 
-        for (const auto& itObs : iter.second.getObservations())
+        for (const auto& itObs : landmark.getObservations())
         {
             const IndexT viewId = itObs.first;
             const IndexT featId = itObs.second.getFeatureId();
 
             if (viewSelections.find(viewId) != viewSelections.end())
             {
-                outfile << " " << viewId << " " << featId;
+                stream << " " << viewId << " " << featId;
             }
         }
-        outfile << "\n";
+        stream << "\n";
+    });
+}
+
+void generateColmapCamerasBinFile(const sfmData::SfMData& sfmData, const std::string& filename)
+{
+    // adapted from Colmap's Reconstruction::WriteCamerasBinary()
+    std::ofstream outfile(filename, std::ios::binary);
+
+    if (!outfile)
+    {
+        ALICEVISION_LOG_ERROR("Unable to create the cameras file " << filename);
+        throw std::runtime_error("Unable to create the cameras file " + filename);
+    }
+
+    std::vector<std::pair<IndexT, const camera::IntrinsicBase*>> intrinsics;
+    for (const auto& iter : sfmData.getIntrinsics())
+    {
+        const camera::IntrinsicBase& intrinsic = *iter.second;
+        if (isColmapCompatible(intrinsic.getType(), camera::getDistortionType(intrinsic)))
+        {
+            intrinsics.emplace_back(iter.first, &intrinsic);
+        }
+    }
+
+    writeBinary<std::uint64_t>(outfile, intrinsics.size());
+    for (const auto& iter : intrinsics)
+    {
+        std::vector<double> params;
+        const int modelId = getColmapCameraModel(iter.first, *iter.second, params);
+
+        writeBinary<std::uint32_t>(outfile, iter.first);
+        writeBinary<std::int32_t>(outfile, modelId);
+        writeBinary<std::uint64_t>(outfile, iter.second->w());
+        writeBinary<std::uint64_t>(outfile, iter.second->h());
+        outfile.write(reinterpret_cast<const char*>(params.data()), params.size() * sizeof(double));
+    }
+}
+
+void generateColmapImagesBinFile(const sfmData::SfMData& sfmData, const CompatibleList& viewSelections, const std::string& filename)
+{
+    // adapted from Colmap's Reconstruction::WriteImagesBinary()
+    std::ofstream outfile(filename, std::ios::binary);
+
+    if (!outfile)
+    {
+        ALICEVISION_LOG_ERROR("Unable to create the image file " << filename);
+        throw std::runtime_error("Unable to create the image file " + filename);
+    }
+
+    ColmapObservations observations;
+    computeColmapObservations(sfmData, viewSelections, observations);
+
+    std::vector<const sfmData::View*> views;
+    for (const auto& iter : sfmData.getViews())
+    {
+        if (viewSelections.find(iter.first) != viewSelections.end())
+        {
+            views.push_back(iter.second.get());
+        }
     }
+
+    writeBinary<std::uint64_t>(outfile, views.size());
+    writeInParallel(outfile, views.size(), [&](std::size_t i, std::ostream& stream) {
+        const sfmData::View& view = *views[i];
+
+        // this is necessary if we copy the images in the image folder because the image path is absolute in AV
+        const std::string imageFilename = fs::path(view.getImage().getImagePath()).filename().string();
+
+        const auto pose = sfmData.getPose(view).getTransform();
+        const Eigen::Quaterniond quat(pose.rotation());
+        const Vec3 tra = pose.translation();
+
+        writeBinary<std::uint32_t>(stream, view.getViewId());
+        writeBinary<double>(stream, quat.w());
+        writeBinary<double>(stream, quat.x());
+        writeBinary<double>(stream, quat.y());
+        writeBinary<double>(stream, quat.z());
+        writeBinary<double>(stream, tra[0]);
+        writeBinary<double>(stream, tra[1]);
+        writeBinary<double>(stream, tra[2]);
+        writeBinary<std::uint32_t>(stream, view.getIntrinsicId());
+        stream.write(imageFilename.c_str(), imageFilename.size() + 1);
+
+        const auto& points = observations.viewsPoints.at(view.getViewId());
+        writeBinary<std::uint64_t>(stream, points.size());
+        for (const auto& point : points)
+        {
+            writeBinary<double>(stream, point.first.x());
+            writeBinary<double>(stream, point.first.y());
+            writeBinary<std::int64_t>(stream, point.second);
+        }
+    });
 }
 
-void generateColmapSceneFiles(const sfmData::SfMData& sfmData, const CompatibleList& viewsSelection, const ColmapConfig& colmapParams)
+void generateColmapPoints3DBinFile(const sfmData::SfMData& sfmData, const CompatibleList& viewSelections, const std::string& filename)
 {
+    // adapted from Colmap's Reconstruction::WritePoints3DBinary()
+    std::ofstream outfile(filename, std::ios::binary);
+
+    if (!outfile)
+    {
+        ALICEVISION_LOG_ERROR("Unable to create the 3D point file " << filename);
+        throw std::runtime_error("Unable to create the 3D point file " + filename);
+    }
+
+    ColmapObservations observations;
+    computeColmapObservations(sfmData, viewSelections, observations);
+
+    // default reprojection error (not used)
+    const double defaultError{-1.0};
+
+    writeBinary<std::uint64_t>(outfile, observations.landmarks.size());
+    writeInParallel(outfile, observations.landmarks.size(), [&](std::size_t i, std::ostream& stream) {
+        const sfmData::Landmark& landmark = observations.landmarks[i]->second;
+
+        writeBinary<std::uint64_t>(stream, observations.landmarks[i]->first);
+        writeBinary<double>(stream, landmark.X.x());
+        writeBinary<double>(stream, landmark.X.y());
+        writeBinary<double>(stream, landmark.X.z());
+        writeBinary<std::uint8_t>(stream, landmark.rgb.r());
+        writeBinary<std::uint8_t>(stream, landmark.rgb.g());
+        writeBinary<std::uint8_t>(stream, landmark.rgb.b());
+        writeBinary<double>(stream, defaultError);
+
+        const std::size_t begin = observations.tracksOffsets[i];
+        const std::size_t end = observations.tracksOffsets[i + 1];
+        writeBinary<std::uint64_t>(stream, end - begin);
+        for (std::size_t t = begin; t < end; ++t)
+        {
+            writeBinary<std::uint32_t>(stream, observations.tracks[t].first);
+            writeBinary<std::uint32_t>(stream, observations.tracks[t].second);
+        }
+    });
+}
+
+void generateColmapSceneFiles(const sfmData::SfMData& sfmData, const CompatibleList& viewsSelection, const ColmapConfig& colmapParams, bool binary)
+{
+    if (binary)
+    {
+        generateColmapCamerasBinFile(sfmData, colmapParams._camerasBinPath);
+        generateColmapImagesBinFile(sfmData, viewsSelection, colmapParams._imagesBinPath);
+        generateColmapPoints3DBinFile(sfmData, viewsSelection, colmapParams._points3DBinPath);
+        return;
+    }
+
     generateColmapCamerasTxtFile(sfmData, colmapParams._camerasTxtPath);
     generateColmapImagesTxtFile(sfmData, viewsSelection, colmapParams._imagesTxtPath);
     generateColmapPoints3DTxtFile(sfmData, viewsSelection, colmapParams._points3DPath);
@@ -415,7 +720,7 @@ void create_directories(const std::string& directory)
     }
 }
 
-void convertToColmapScene(const sfmData::SfMData& sfmData, const std::string& colmapBaseDir, bool copyImages)
+void convertToColmapScene(const sfmData::SfMData& sfmData, const std::string& colmapBaseDir, bool copyImages, bool binary)
 {
     // retrieve the views that are compatible with Colmap and that can be exported
     const auto views2export = getColmapCompatibleViews(sfmData);
@@ -443,7 +748,7 @@ void convertToColmapScene(const sfmData::SfMData& sfmData, const std::string& co
     }
 
     ALICEVISION_LOG_INFO("Generating Colmap files...");
-    generateColmapSceneFiles(sfmData, views2export, colmapParams);
+    generateColmapSceneFiles(sfmData, views2export, colmapParams, binary);
 }
 
 }  // namespace sfmDataIO
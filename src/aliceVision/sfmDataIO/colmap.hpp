@@ -13,6 +13,7 @@
 #include <string>
 #include <set>
 #include <unordered_set>
+#include <vector>
 
 namespace aliceVision {
 namespace sfmDataIO {
@@ -44,6 +45,12 @@ struct ColmapConfig
     std::string _imagesTxtPath{};
     /// the full path for the points3d.txt file
     std::string _points3DPath{};
+    /// the full path for the cameras.bin file
+    std::string _camerasBinPath{};
+    /// the full path for the images.bin file
+    std::string _imagesBinPath{};
+    /// the full path for the points3D.bin file
+    std::string _points3DBinPath{};
 };
 
 /**
@@ -82,6 +89,16 @@ CompatibleList getColmapCompatibleViews(const sfmData::SfMData& sfmData);
  */
 std::string convertIntrinsicsToColmapString(const IndexT intrinsicsID, std::shared_ptr<camera::IntrinsicBase> intrinsic);
 
+/**
+ * @brief Get the Colmap camera model equivalent to the given intrinsic, as written in a cameras.bin file.
+ * @param[in] intrinsicsID the id of the intrinsics.
+ * @param[in] intrinsic the intrinsics.
+ * @param[out] out_params the parameters of the Colmap camera model (the same as the ones of convertIntrinsicsToColmapString).
+ * @return the id of the Colmap camera model.
+ * @throws std::invalid_argument if the intrinsic is not compatible with Colmap.
+ */
+int getColmapCameraModel(const IndexT intrinsicsID, const camera::IntrinsicBase& intrinsic, std::vector<double>& out_params);
+
 /**
  * @brief Given the sfmData it generates the equivalent cameras.txt file with the Colmap compatible cameras.
  * @param[in] sfmData the input sfmData.
@@ -128,14 +145,44 @@ void copyImagesFromSfmData(const sfmData::SfMData& sfmData, const std::string& d
  */
 void generateColmapPoints3DTxtFile(const sfmData::SfMData& sfmData, const CompatibleList& viewSelections, const std::string& filename);
 
+/**
+ * @brief Given the sfmData it generates the equivalent binary cameras.bin file with the Colmap compatible cameras.
+ * @param[in] sfmData the input sfmData.
+ * @param[in] filename the filename where to save the Colmap's scene (usually a cameras.bin)
+ */
+void generateColmapCamerasBinFile(const sfmData::SfMData& sfmData, const std::string& filename);
+
+/**
+ * @brief Given an sfm scene and a selection of its views that are compatible with Colmap, it generates the binary
+ * images.bin file for Colmap scene. The records of the images are formatted in parallel.
+ * @param[in] sfmData the input scene.
+ * @param[in] viewSelections a selection of view IDs that have compatible intrinsics with Colmap.
+ * @param[in] filename the filename where to save the scene (usually a images.bin file)
+ */
+void generateColmapImagesBinFile(const sfmData::SfMData& sfmData, const CompatibleList& viewSelections, const std::string& filename);
+
+/**
+ * @brief Given an sfm scene and a selection of its views that are compatible with Colmap, it generates the binary
+ * points3D.bin file for Colmap scene. The records of the points are formatted in parallel.
+ * The tracks reference the index of the observation in the points of the images.bin file.
+ * @param[in] sfmData the input scene.
+ * @param[in] viewSelections a selection of view IDs that have compatible intrinsics with Colmap.
+ * @param[in] filename the filename where to save the points (usually a points3D.bin file)
+ */
+void generateColmapPoints3DBinFile(const sfmData::SfMData& sfmData, const CompatibleList& viewSelections, const std::string& filename);
+
 /**
  * @brief Given an sfm scene and a selection of its views that are compatible with Colmap, it generates all the Colmap
  * files that represent the scene.
  * @param sfmData the input scene.
  * @param viewsSelection a selection of view IDs that have compatible intrinsics with Colmap.
  * @param colmapParams the configuration data for the Colmap scene.
+ * @param binary generate the binary files (cameras.bin, images.bin and points3D.bin) instead of the text files.
  */
-void generateColmapSceneFiles(const sfmData::SfMData& sfmData, const CompatibleList& viewsSelection, const ColmapConfig& colmapParams);
+void generateColmapSceneFiles(const sfmData::SfMData& sfmData,
+                              const CompatibleList& viewsSelection,
+                              const ColmapConfig& colmapParams,
+                              bool binary = false);
 
 /**
  * @brief iven an sfm scene it generate the folder structure and all the files in Colmap format.
@@ -144,8 +191,9 @@ void generateColmapSceneFiles(const sfmData::SfMData& sfmData, const CompatibleL
  * @param copyImages enable copying the source image into the Colmap scene folder. This can be set to false when the
  * sfmData scene contains images from a single directory: in this case copy can be skipped and the first undistort step
  * of Colmap's MVS process can be called directly on the source folder without copying the images.
+ * @param binary generate the binary files of the scene instead of the text files.
  */
-void convertToColmapScene(const sfmData::SfMData& sfmData, const std::string& colmapBaseDir, bool copyImages);
+void convertToColmapScene(const sfmData::SfMData& sfmData, const std::string& colmapBaseDir, bool copyImages, bool binary = false);
 
 }  // namespace sfmDataIO
 }  // namespace aliceVision
\ No newline at end of file
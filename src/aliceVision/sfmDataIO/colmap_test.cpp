@@ -13,6 +13,9 @@
 #include <boost/test/tools/floating_point_comparison.hpp>
 #include <aliceVision/unitTest.hpp>
 
+#include <cstdint>
+#include <fstream>
+
 using namespace aliceVision;
 
 BOOST_AUTO_TEST_CASE(colmap_isCompatible)
@@ -161,4 +164,119 @@ BOOST_AUTO_TEST_CASE(colmap_convertIntrinsicsToColmapString)
             BOOST_CHECK(sfmDataIO::isColmapCompatible(intrinsics->getType(), distoType));
         }
     }
-}
\ No newline at end of file
+}
+namespace {
+
+template<typename T>
+T readBinary(std::istream& stream)
+{
+    T value;
+    stream.read(reinterpret_cast<char*>(&value), sizeof(T));
+    return value;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(colmap_binaryFiles)
+{
+    sfmData::SfMData sfmTest{};
+    sfmTest.getIntrinsics().emplace(
+      10,
+      camera::createPinhole(camera::EDISTORTION::DISTORTION_NONE, camera::EUNDISTORTION::UNDISTORTION_NONE, 1920, 1080, 1548.76, 1547.32, 992.36, 549.54));
+    // incompatible intrinsics are not exported
+    sfmTest.getIntrinsics().emplace(20, camera::createEquidistant(camera::EDISTORTION::DISTORTION_NONE, 1920, 1080, 1548.76, 549.54, -0.02078));
+
+    for (IndexT viewId = 0; viewId < 3; ++viewId)
+    {
+        sfmTest.getViews().emplace(viewId, std::make_shared<sfmData::View>("", viewId, 10, viewId));
+        sfmTest.getPoses().emplace(viewId, sfmData::CameraPose());
+    }
+
+    // landmark 5 is seen by views 0 and 2, landmark 7 by views 1 and 2
+    sfmData::Landmark landmark5(Vec3(1.0, 2.0, 3.0), feature::EImageDescriberType::SIFT, image::RGBColor(10, 20, 30));
+    landmark5.getObservations().emplace(0, sfmData::Observation(Vec2(1.0, 1.0), 100, 1.0));
+    landmark5.getObservations().emplace(2, sfmData::Observation(Vec2(2.0, 2.0), 101, 1.0));
+    sfmTest.getLandmarks().emplace(5, landmark5);
+    sfmData::Landmark landmark7(Vec3(4.0, 5.0, 6.0), feature::EImageDescriberType::SIFT, image::RGBColor(40, 50, 60));
+    landmark7.getObservations().emplace(1, sfmData::Observation(Vec2(3.0, 3.0), 102, 1.0));
+    landmark7.getObservations().emplace(2, sfmData::Observation(Vec2(4.0, 4.0), 103, 1.0));
+    sfmTest.getLandmarks().emplace(7, landmark7);
+
+    const sfmDataIO::CompatibleList views = sfmDataIO::getColmapCompatibleViews(sfmTest);
+    BOOST_CHECK(views.size() == 3);
+
+    // cameras.bin
+    {
+        const std::string filename = "colmap_test_cameras.bin";
+        sfmDataIO::generateColmapCamerasBinFile(sfmTest, filename);
+
+        std::ifstream stream(filename, std::ios::binary);
+        BOOST_CHECK_EQUAL(readBinary<std::uint64_t>(stream), 1);
+        BOOST_CHECK_EQUAL(readBinary<std::uint32_t>(stream), 10);
+        BOOST_CHECK_EQUAL(readBinary<std::int32_t>(stream), 1);  // PINHOLE
+        BOOST_CHECK_EQUAL(readBinary<std::uint64_t>(stream), 1920);
+        BOOST_CHECK_EQUAL(readBinary<std::uint64_t>(stream), 1080);
+        BOOST_CHECK_CLOSE(readBinary<double>(stream), 1548.76, 1e-6);
+        BOOST_CHECK_CLOSE(readBinary<double>(stream), 1547.32, 1e-6);
+        BOOST_CHECK_CLOSE(readBinary<double>(stream), 1952.36, 1e-6);
+        BOOST_CHECK_CLOSE(readBinary<double>(stream), 1089.54, 1e-6);
+        BOOST_CHECK(stream.good());
+        stream.get();
+        BOOST_CHECK(stream.eof());
+    }
+
+    // points3D.bin, the tracks reference the index of the point in its image
+    {
+        const std::string filename = "colmap_test_points3D.bin";
+        sfmDataIO::generateColmapPoints3DBinFile(sfmTest, views, filename);
+
+        std::ifstream stream(filename, std::ios::binary);
+        BOOST_CHECK_EQUAL(readBinary<std::uint64_t>(stream), 2);
+
+        BOOST_CHECK_EQUAL(readBinary<std::uint64_t>(stream), 5);
+        BOOST_CHECK_EQUAL(readBinary<double>(stream), 1.0);
+        BOOST_CHECK_EQUAL(readBinary<double>(stream), 2.0);
+        BOOST_CHECK_EQUAL(readBinary<double>(stream), 3.0);
+        BOOST_CHECK_EQUAL(readBinary<std::uint8_t>(stream), 10);
+        BOOST_CHECK_EQUAL(readBinary<std::uint8_t>(stream), 20);
+        BOOST_CHECK_EQUAL(readBinary<std::uint8_t>(stream), 30);
+        readBinary<double>(stream);
+        BOOST_CHECK_EQUAL(readBinary<std::uint64_t>(stream), 2);
+        BOOST_CHECK_EQUAL(readBinary<std::uint32_t>(stream), 0);
+        BOOST_CHECK_EQUAL(readBinary<std::uint32_t>(stream), 0);
+        BOOST_CHECK_EQUAL(readBinary<std::uint32_t>(stream), 2);
+        BOOST_CHECK_EQUAL(readBinary<std::uint32_t>(stream), 0);
+
+        BOOST_CHECK_EQUAL(readBinary<std::uint64_t>(stream), 7);
+        stream.ignore(3 * sizeof(double) + 3 + sizeof(double));
+        BOOST_CHECK_EQUAL(readBinary<std::uint64_t>(stream), 2);
+        BOOST_CHECK_EQUAL(readBinary<std::uint32_t>(stream), 1);
+        BOOST_CHECK_EQUAL(readBinary<std::uint32_t>(stream), 0);
+        BOOST_CHECK_EQUAL(readBinary<std::uint32_t>(stream), 2);
+        BOOST_CHECK_EQUAL(readBinary<std::uint32_t>(stream), 1);
+        BOOST_CHECK(stream.good());
+        stream.get();
+        BOOST_CHECK(stream.eof());
+    }
+
+    // images.bin
+    {
+        const std::string filename = "colmap_test_images.bin";
+        sfmDataIO::generateColmapImagesBinFile(sfmTest, views, filename);
+
+        std::ifstream stream(filename, std::ios::binary);
+        BOOST_CHECK_EQUAL(readBinary<std::uint64_t>(stream), 3);
+
+        // view 0: id, identity rotation and null translation, camera id, empty name and one point
+        BOOST_CHECK_EQUAL(readBinary<std::uint32_t>(stream), 0);
+        BOOST_CHECK_EQUAL(readBinary<double>(stream), 1.0);
+        stream.ignore(6 * sizeof(double));
+        BOOST_CHECK_EQUAL(readBinary<std::uint32_t>(stream), 10);
+        BOOST_CHECK_EQUAL(stream.get(), 0);
+        BOOST_CHECK_EQUAL(readBinary<std::uint64_t>(stream), 1);
+        BOOST_CHECK_EQUAL(readBinary<double>(stream), 1.0);
+        BOOST_CHECK_EQUAL(readBinary<double>(stream), 1.0);
+        BOOST_CHECK_EQUAL(readBinary<std::int64_t>(stream), 5);
+        BOOST_CHECK(stream.good());
+    }
+}
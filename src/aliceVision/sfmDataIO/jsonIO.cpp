@@ -7,11 +7,19 @@
 #include "jsonIO.hpp"
 #include <aliceVision/camera/camera.hpp>
 #include <aliceVision/sfmDataIO/viewIO.hpp>
+#include <aliceVision/alicevision_omp.hpp>
 
 #include <boost/property_tree/json_parser.hpp>
 
+#include <algorithm>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <iterator>
 #include <memory>
 #include <cassert>
+#include <sstream>
+#include <vector>
 
 namespace aliceVision {
 namespace sfmDataIO {
@@ -535,6 +543,139 @@ void loadLandmark(IndexT& landmarkId, sfmData::Landmark& landmark, bpt::ptree& l
     }
 }
 
+namespace {
+
+/// number of landmarks formatted or parsed by a parallel batch
+constexpr std::size_t landmarksBatchSize = 16384;
+
+/**
+ * @brief Read a JSON SfMData file as text, except the elements of the top level "structure" array
+ *        which are given one by one (as text) to a callback while reading, so that the whole structure is never in memory.
+ * @param[in] filename The filename
+ * @param[out] out_json The file content, with an empty structure array
+ * @param[in] onLandmark The callback of the structure elements, the text can be moved (ignored if empty)
+ */
+void readJSONStreamingStructure(const std::string& filename, std::string& out_json, const std::function<void(std::string&)>& onLandmark)
+{
+    std::ifstream stream(filename, std::ios::binary);
+    if (!stream)
+        throw bpt::json_parser_error("cannot open file", filename, 0);
+
+    int depth = 0;
+    bool inString = false;
+    bool escape = false;
+    // last string and key at the top level of the file object
+    std::string topLevelString;
+    std::string topLevelKey;
+    bool inStructure = false;
+    std::string element;
+
+    std::vector<char> buffer(1 << 20);
+    while (stream)
+    {
+        stream.read(buffer.data(), buffer.size());
+        const std::streamsize size = stream.gcount();
+
+        for (std::streamsize i = 0; i < size; ++i)
+        {
+            const char c = buffer[i];
+
+            // structure elements
+            if (inStructure)
+            {
+                if (depth > 2)
+                {
+                    if (onLandmark)
+                        element.push_back(c);
+
+                    if (inString)
+                    {
+                        if (escape)
+                            escape = false;
+                        else if (c == '\\')
+                            escape = true;
+                        else if (c == '"')
+                            inString = false;
+                    }
+                    else if (c == '"')
+                    {
+                        inString = true;
+                    }
+                    else if (c == '{' || c == '[')
+                    {
+                        ++depth;
+                    }
+                    else if ((c == '}' || c == ']') && (--depth == 2))
+                    {
+                        if (onLandmark)
+                            onLandmark(element);
+                        element.clear();
+                    }
+                }
+                else if (c == '{')
+                {
+                    // new element
+                    ++depth;
+                    if (onLandmark)
+                        element.push_back(c);
+                }
+                else if (c == ']')
+                {
+                    // end of the structure array
+                    --depth;
+                    inStructure = false;
+                }
+                continue;
+            }
+
+            // other sections
+            if (inString)
+            {
+                if (escape)
+                    escape = false;
+                else if (c == '\\')
+                    escape = true;
+                else if (c == '"')
+                    inString = false;
+                else if (depth == 1)
+                    topLevelString.push_back(c);
+            }
+            else if (c == '"')
+            {
+                inString = true;
+                topLevelString.clear();
+            }
+            else if (depth == 1 && c == ':')
+            {
+                topLevelKey = std::move(topLevelString);
+            }
+            else if (depth == 1 && c == ',')
+            {
+                topLevelKey.clear();
+            }
+            else if (depth == 1 && c == '[' && topLevelKey == "structure")
+            {
+                ++depth;
+                inStructure = true;
+                out_json.append("[]");
+                continue;
+            }
+            else if (c == '{' || c == '[')
+            {
+                ++depth;
+            }
+            else if (c == '}' || c == ']')
+            {
+                --depth;
+            }
+
+            out_json.push_back(c);
+        }
+    }
+}
+
+}  // namespace
+
 bool saveJSON(const sfmData::SfMData& sfmData, const std::string& filename, ESfMData partFlag)
 {
     const Vec3i version = {ALICEVISION_SFMDATAIO_VERSION_MAJOR, ALICEVISION_SFMDATAIO_VERSION_MINOR, ALICEVISION_SFMDATAIO_VERSION_REVISION};
@@ -648,20 +789,74 @@ bool saveJSON(const sfmData::SfMData& sfmData, const std::string& filename, ESfM
         }
     }
 
-    // structure
-    if (saveStructure && !sfmData.getLandmarks().empty())
+    // write the json file with the tree, the same way as bpt::write_json
+    // the structure is not added to the tree: it is formatted by batches of landmarks, in parallel, and written as the last section
+
+    std::ofstream stream(filename);
+    if (!stream)
+        throw bpt::json_parser_error("cannot open file", filename, 0);
+
+    const bool writeStructure = saveStructure && !sfmData.getLandmarks().empty();
+
+    stream << "{\n";
+    for (auto it = fileTree.begin(); it != fileTree.end(); ++it)
+    {
+        stream << "    \"" << bpt::json_parser::create_escapes(it->first) << "\": ";
+        bpt::json_parser::write_json_helper(stream, it->second, 1, true);
+        if (writeStructure || std::next(it) != fileTree.end())
+            stream << ',';
+        stream << '\n';
+    }
+
+    if (writeStructure)
     {
-        bpt::ptree structureTree;
+        stream << "    \"structure\": [\n";
 
+        std::vector<const sfmData::Landmarks::value_type*> landmarks;
+        landmarks.reserve(sfmData.getLandmarks().size());
         for (const auto& structurePair : sfmData.getLandmarks())
-            saveLandmark("", structurePair.first, structurePair.second, structureTree, saveObservations, saveFeatures);
+            landmarks.push_back(&structurePair);
+
+        std::vector<std::ostringstream> chunks(omp_get_max_threads());
+        for (std::size_t batchBegin = 0; batchBegin < landmarks.size(); batchBegin += landmarksBatchSize)
+        {
+            const std::size_t batchEnd = std::min(batchBegin + landmarksBatchSize, landmarks.size());
+            const int nbChunks = static_cast<int>(chunks.size());
+
+#pragma omp parallel for
+            for (int c = 0; c < nbChunks; ++c)
+            {
+                std::ostringstream& chunk = chunks[c];
+                chunk.str(std::string());
+                chunk.copyfmt(stream);
+
+                const std::size_t batchSize = batchEnd - batchBegin;
+                const std::size_t begin = batchBegin + batchSize * c / nbChunks;
+                const std::size_t end = batchBegin + batchSize * (c + 1) / nbChunks;
+                for (std::size_t i = begin; i < end; ++i)
+                {
+                    bpt::ptree landmarkParentTree;
+                    saveLandmark("", landmarks[i]->first, landmarks[i]->second, landmarkParentTree, saveObservations, saveFeatures);
+
+                    chunk << "        ";
+                    bpt::json_parser::write_json_helper(chunk, landmarkParentTree.front().second, 2, true);
+                    if (i + 1 != landmarks.size())
+                        chunk << ',';
+                    chunk << '\n';
+                }
+            }
 
-        fileTree.add_child("structure", structureTree);
+            for (const std::ostringstream& chunk : chunks)
+                stream << chunk.str();
+        }
+
+        stream << "    ]\n";
     }
 
-    // write the json file with the tree
+    stream << '}' << std::endl;
 
-    bpt::write_json(filename, fileTree);
+    if (!stream.good())
+        throw bpt::json_parser_error("write error", filename, 0);
 
     return true;
 }
@@ -684,11 +879,64 @@ bool loadJSON(sfmData::SfMData& sfmData,
     const bool loadFeatures = (partFlag & OBSERVATIONS_WITH_FEATURES) == OBSERVATIONS_WITH_FEATURES;
     const bool loadObservations = loadFeatures || ((partFlag & OBSERVATIONS) == OBSERVATIONS);
 
+    // landmarks, parsed by batches in parallel while the file is read
+    sfmData::Landmarks& structure = sfmData.getLandmarks();
+    std::vector<std::string> landmarksBatch;
+    std::vector<std::pair<IndexT, sfmData::Landmark>> loadedLandmarks;
+
+    const auto loadLandmarksBatch = [&]() {
+        loadedLandmarks.resize(landmarksBatch.size());
+        std::exception_ptr exception;
+
+#pragma omp parallel for
+        for (int i = 0; i < static_cast<int>(landmarksBatch.size()); ++i)
+        {
+            try
+            {
+                bpt::ptree landmarkTree;
+                std::istringstream landmarkStream(landmarksBatch[i]);
+                bpt::read_json(landmarkStream, landmarkTree);
+                loadedLandmarks[i].second = sfmData::Landmark();
+                loadLandmark(loadedLandmarks[i].first, loadedLandmarks[i].second, landmarkTree, loadObservations, loadFeatures);
+            }
+            catch (...)
+            {
+#pragma omp critical
+                exception = std::current_exception();
+            }
+        }
+
+        if (exception)
+            std::rethrow_exception(exception);
+
+        for (auto& landmarkPair : loadedLandmarks)
+            structure.emplace(landmarkPair.first, std::move(landmarkPair.second));
+
+        landmarksBatch.clear();
+    };
+
+    // read the json file and initialize the tree, with the structure section loaded by batches of landmarks while reading
+    std::string fileContent;
+    std::function<void(std::string&)> onLandmark;
+    if (loadStructure)
+    {
+        onLandmark = [&](std::string& landmarkText) {
+            landmarksBatch.push_back(std::move(landmarkText));
+            if (landmarksBatch.size() == landmarksBatchSize)
+                loadLandmarksBatch();
+        };
+    }
+    readJSONStreamingStructure(filename, fileContent, onLandmark);
+    if (!landmarksBatch.empty())
+        loadLandmarksBatch();
+
     // main tree
     bpt::ptree fileTree;
-
-    // read the json file and initialize the tree
-    bpt::read_json(filename, fileTree);
+    {
+        std::istringstream fileStream(fileContent);
+        bpt::read_json(fileStream, fileTree);
+    }
+    fileContent = std::string();
 
     // version
     {
@@ -837,22 +1085,6 @@ bool loadJSON(sfmData::SfMData& sfmData,
         }
     }
 
-    // structure
-    if (loadStructure && fileTree.count("structure"))
-    {
-        sfmData::Landmarks& structure = sfmData.getLandmarks();
-
-        for (bpt::ptree::value_type& landmarkNode : fileTree.get_child("structure"))
-        {
-            IndexT landmarkId;
-            sfmData::Landmark landmark;
-
-            loadLandmark(landmarkId, landmark, landmarkNode.second, loadObservations, loadFeatures);
-
-            structure.emplace(landmarkId, landmark);
-        }
-    }
-
     return true;
 }
 
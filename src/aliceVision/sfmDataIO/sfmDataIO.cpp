@@ -8,9 +8,11 @@
 #include "sfmDataIO.hpp"
 #include <aliceVision/config.hpp>
 #include <aliceVision/stl/mapUtils.hpp>
+#include <aliceVision/system/ResourceReport.hpp>
 #include <aliceVision/sfmDataIO/jsonIO.hpp>
 #include <aliceVision/sfmDataIO/plyIO.hpp>
 #include <aliceVision/sfmDataIO/bafIO.hpp>
+#include <aliceVision/sfmDataIO/binaryIO.hpp>
 #include <aliceVision/sfmDataIO/gtIO.hpp>
 #include <aliceVision/utils/filesIO.hpp>
 
@@ -108,6 +110,8 @@ bool validIds(const aliceVision::sfmData::SfMData& sfmData, ESfMData partFlag)
 
 bool load(aliceVision::sfmData::SfMData& sfmData, const std::string& filename, ESfMData partFlag)
 {
+    ALICEVISION_RESOURCE_PHASE("sfmDataIO::load");
+
     const std::string extension = fs::path(filename).extension().string();
     bool status = false;
 
@@ -115,6 +119,10 @@ bool load(aliceVision::sfmData::SfMData& sfmData, const std::string& filename, E
     {
         status = loadJSON(sfmData, filename, partFlag);
     }
+    else if (extension == ".sfmb")  // Binary File
+    {
+        status = loadBinary(sfmData, filename, partFlag);
+    }
     else if (extension == ".abc")  // Alembic
     {
 #if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_ALEMBIC)
@@ -150,6 +158,8 @@ bool load(aliceVision::sfmData::SfMData& sfmData, const std::string& filename, E
 
 bool save(const aliceVision::sfmData::SfMData& sfmData, const std::string& filename, ESfMData partFlag)
 {
+    ALICEVISION_RESOURCE_PHASE("sfmDataIO::save");
+
     const fs::path bPath = fs::path(filename);
     const std::string extension = bPath.extension().string();
     const std::string tmpPath = (bPath.parent_path() / bPath.stem()).string() + "." + utils::generateUniqueFilename() + extension;
@@ -159,6 +169,10 @@ bool save(const aliceVision::sfmData::SfMData& sfmData, const std::string& filen
     {
         status = saveJSON(sfmData, tmpPath, partFlag);
     }
+    else if (extension == ".sfmb")  // Binary File
+    {
+        status = saveBinary(sfmData, tmpPath, partFlag);
+    }
     else if (extension == ".ply")  // Polygon File
     {
         status = savePLY(sfmData, tmpPath, partFlag);
@@ -189,5 +203,32 @@ bool save(const aliceVision::sfmData::SfMData& sfmData, const std::string& filen
     return status;
 }
 
+bool hasLandmarksPerView(const std::string& filename) { return fs::path(filename).extension().string() == ".sfmb"; }
+
+bool loadLandmarksOfViews(aliceVision::sfmData::SfMData& sfmData, const std::string& filename, const std::set<IndexT>& viewIds)
+{
+    if (hasLandmarksPerView(filename))
+        return loadBinaryLandmarksOfViews(sfmData, filename, viewIds);
+
+    // other formats: load the whole structure and keep the landmarks observed by the views
+    sfmData::SfMData structureData;
+    if (!load(structureData, filename, ESfMData(STRUCTURE | OBSERVATIONS | OBSERVATIONS_WITH_FEATURES)))
+        return false;
+
+    for (auto& landmarkPair : structureData.getLandmarks())
+    {
+        for (const auto& obsPair : landmarkPair.second.getObservations())
+        {
+            if (viewIds.count(obsPair.first))
+            {
+                sfmData.getLandmarks().emplace(landmarkPair.first, std::move(landmarkPair.second));
+                break;
+            }
+        }
+    }
+
+    return true;
+}
+
 }  // namespace sfmDataIO
 }  // namespace aliceVision
@@ -10,6 +10,9 @@
 #include <aliceVision/sfmData/SfMData.hpp>
 #include <aliceVision/version.hpp>
 
+#include <set>
+#include <string>
+
 #define ALICEVISION_SFMDATAIO_VERSION_MAJOR 1
 #define ALICEVISION_SFMDATAIO_VERSION_MINOR 2
 #define ALICEVISION_SFMDATAIO_VERSION_REVISION 8
@@ -49,5 +52,11 @@ bool load(aliceVision::sfmData::SfMData& sfmData, const std::string& filename, E
 /// save SfMData SfM scene to a file
 bool save(const aliceVision::sfmData::SfMData& sfmData, const std::string& filename, ESfMData partFlag);
 
+/// check if the file format stores the landmarks per view, so that loadLandmarksOfViews does not read the whole structure
+bool hasLandmarksPerView(const std::string& filename);
+
+/// load only the landmarks (with their observations) observed by at least one of the given views
+bool loadLandmarksOfViews(aliceVision::sfmData::SfMData& sfmData, const std::string& filename, const std::set<IndexT>& viewIds);
+
 }  // namespace sfmDataIO
 }  // namespace aliceVision
@@ -76,7 +76,7 @@ sfmData::SfMData createTestScene(std::size_t viewsCount = 2, std::size_t observa
 
 BOOST_AUTO_TEST_CASE(SfMData_IO_SAVE_LOAD)
 {
-    std::vector<std::string> ext_Type = {"sfm", "json"};
+    std::vector<std::string> ext_Type = {"sfm", "json", "sfmb"};
 
 #if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_ALEMBIC)
     ext_Type.push_back("abc");
@@ -178,6 +178,82 @@ BOOST_AUTO_TEST_CASE(SfMData_IO_SAVE_LOAD)
     }
 }
 
+BOOST_AUTO_TEST_CASE(SfMData_IO_BINARY)
+{
+    const std::string filename = "SAVE_LOAD_BINARY.sfmb";
+    const sfmData::SfMData sfmData = createTestScene(4, 3, false);
+    BOOST_CHECK(save(sfmData, filename, ALL));
+
+    BOOST_TEST_CONTEXT("LOAD ALL")
+    {
+        sfmData::SfMData sfmDataLoad;
+        BOOST_CHECK(load(sfmDataLoad, filename, ALL));
+        BOOST_CHECK(sfmDataLoad.getPoses() == sfmData.getPoses());
+        BOOST_CHECK(sfmDataLoad.getLandmarks() == sfmData.getLandmarks());
+        BOOST_CHECK(sfmDataLoad.getPose(*sfmDataLoad.getViews().at(0)).isLocked());
+    }
+
+    BOOST_TEST_CONTEXT("LOAD (subparts: STRUCTURE | OBSERVATIONS)")
+    {
+        sfmData::SfMData sfmDataLoad;
+        BOOST_CHECK(load(sfmDataLoad, filename, ESfMData(STRUCTURE | OBSERVATIONS)));
+        BOOST_CHECK_EQUAL(sfmDataLoad.getViews().size(), 0);
+        BOOST_CHECK_EQUAL(sfmDataLoad.getPoses().size(), 0);
+        BOOST_REQUIRE_EQUAL(sfmDataLoad.getLandmarks().size(), 1);
+
+        const sfmData::Landmark& landmark = sfmDataLoad.getLandmarks().at(0);
+        BOOST_CHECK_EQUAL(landmark.getObservations().size(), 3);
+        BOOST_CHECK(landmark.descType == feature::EImageDescriberType::SIFT);
+        BOOST_CHECK_EQUAL(landmark.getObservations().at(2).getFeatureId(), UndefinedIndexT);
+    }
+
+    BOOST_TEST_CONTEXT("LOAD truncated file")
+    {
+        fs::resize_file(filename, fs::file_size(filename) - 8);
+        sfmData::SfMData sfmDataLoad;
+        BOOST_CHECK(!load(sfmDataLoad, filename, ALL));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(SfMData_IO_LANDMARKS_OF_VIEWS)
+{
+    // landmark 0 is observed by the views 0, 1, 2 and landmark 1 by the views 2, 3
+    sfmData::SfMData sfmData = createTestScene(4, 3, false);
+    sfmData.getLandmarks()[1].X = Vec3(1, 2, 3);
+    sfmData.getLandmarks()[1].descType = feature::EImageDescriberType::SIFT;
+    sfmData.getLandmarks()[1].getObservations()[2] = sfmData::Observation(Vec2(5, 6), 10, 1.0);
+    sfmData.getLandmarks()[1].getObservations()[3] = sfmData::Observation(Vec2(7, 8), 11, 1.0);
+
+    for (const std::string& extension : {"sfm", "sfmb"})
+    {
+        const std::string filename = "LANDMARKS_OF_VIEWS." + extension;
+        BOOST_CHECK(save(sfmData, filename, ALL));
+
+        BOOST_TEST_CONTEXT("LOAD landmarks of views {0, 1}, file format: " << extension)
+        {
+            sfmData::SfMData sfmDataLoad;
+            BOOST_CHECK(loadLandmarksOfViews(sfmDataLoad, filename, {0, 1}));
+            BOOST_REQUIRE_EQUAL(sfmDataLoad.getLandmarks().size(), 1);
+            BOOST_CHECK(sfmDataLoad.getLandmarks().at(0) == sfmData.getLandmarks().at(0));
+        }
+
+        BOOST_TEST_CONTEXT("LOAD landmarks of views {2}, file format: " << extension)
+        {
+            sfmData::SfMData sfmDataLoad;
+            BOOST_CHECK(loadLandmarksOfViews(sfmDataLoad, filename, {2}));
+            BOOST_CHECK(sfmDataLoad.getLandmarks() == sfmData.getLandmarks());
+        }
+
+        BOOST_TEST_CONTEXT("LOAD landmarks of views {3}, file format: " << extension)
+        {
+            sfmData::SfMData sfmDataLoad;
+            BOOST_CHECK(loadLandmarksOfViews(sfmDataLoad, filename, {3}));
+            BOOST_REQUIRE_EQUAL(sfmDataLoad.getLandmarks().size(), 1);
+            BOOST_CHECK(sfmDataLoad.getLandmarks().at(1) == sfmData.getLandmarks().at(1));
+        }
+    }
+}
+
 /*
 BOOST_AUTO_TEST_CASE(SfMData_IO_BigFile) {
   const int nbViews = 1000;
@@ -7,6 +7,9 @@
 #include <aliceVision/sphereDetection/sphereDetection.hpp>
 
 // Standard libs
+#include <algorithm>
+#include <cassert>
+#include <exception>
 #include <iostream>
 #include <numeric>
 
@@ -114,7 +117,9 @@ Prediction predict(Ort::Session& session, const fs::path imagePath, const float
     imageOpencv.convertTo(imageOpencv, CV_32FC3, 1 / 255.0);
 
     // HWC to CHW
-    cv::dnn::blobFromImage(imageOpencv, imageOpencv);
+    cv::Mat blob;
+    cv::dnn::blobFromImage(imageOpencv, blob);
+    imageOpencv.release();
 
     // Inference on CPU
     // TODO: use GPU
@@ -123,12 +128,11 @@ Prediction predict(Ort::Session& session, const fs::path imagePath, const float
     // Initialize input tensor
     std::vector<int64_t> inputShape = {1, 3, imageAlice.height(), imageAlice.width()};
     const size_t inputSize = std::accumulate(begin(inputShape), end(inputShape), 1, std::multiplies<size_t>());
-    std::vector<float> inputTensor(inputSize);
-    inputTensor.assign(imageOpencv.begin<float>(), imageOpencv.end<float>());
+    assert(blob.isContinuous() && blob.total() == inputSize);
 
-    // Create input data
+    // Create input data, directly on the (contiguous) blob memory
     std::vector<Ort::Value> inputData;
-    inputData.push_back(Ort::Value::CreateTensor<float>(memoryInfo, inputTensor.data(), inputSize, inputShape.data(), inputShape.size()));
+    inputData.push_back(Ort::Value::CreateTensor<float>(memoryInfo, blob.ptr<float>(), inputSize, inputShape.data(), inputShape.size()));
 
     // Select inputs and outputs
     std::vector<const char*> inputNames{"input"};
@@ -171,22 +175,50 @@ Prediction predict(Ort::Session& session, const fs::path imagePath, const float
     return Prediction{bboxes, scores, imageOpencvShape};
 }
 
-void sphereDetection(const sfmData::SfMData& sfmData, Ort::Session& session, fs::path outputPath, const float minScore)
+void sphereDetection(const sfmData::SfMData& sfmData, Ort::Session& session, fs::path outputPath, const float minScore, int nbConcurrentImages)
 {
     // Main tree
     bpt::ptree fileTree;
 
+    std::vector<IndexT> viewIds;
     for (auto& viewID : sfmData.getViews())
     {
-        ALICEVISION_LOG_DEBUG("View Id: " << viewID);
+        const fs::path imagePath = fs::path(viewID.second->getImage().getImagePath());
+        if (!boost::algorithm::icontains(imagePath.stem().string(), "ambiant"))
+            viewIds.push_back(viewID.first);
+    }
 
-        const std::string sphereName = std::to_string(viewID.second->getViewId());
-        const fs::path imagePath = fs::path(sfmData.getView(viewID.second->getViewId()).getImage().getImagePath());
+    // The inferences are run concurrently on the shared session (Ort::Session::Run is thread-safe)
+    std::vector<Prediction> predictions(viewIds.size());
+    std::exception_ptr exception;
+
+#pragma omp parallel for num_threads(std::max(1, nbConcurrentImages)) schedule(dynamic)
+    for (int i = 0; i < static_cast<int>(viewIds.size()); ++i)
+    {
+        try
+        {
+            const fs::path imagePath = fs::path(sfmData.getView(viewIds[i]).getImage().getImagePath());
+            predictions[i] = predict(session, imagePath, minScore);
+        }
+        catch (...)
+        {
+#pragma omp critical(sphereDetectionException)
+            if (!exception)
+                exception = std::current_exception();
+        }
+    }
+
+    if (exception)
+        std::rethrow_exception(exception);
+
+    for (std::size_t v = 0; v < viewIds.size(); ++v)
+    {
+        ALICEVISION_LOG_DEBUG("View Id: " << viewIds[v]);
 
-        if (boost::algorithm::icontains(imagePath.stem().string(), "ambiant"))
-            continue;
+        const std::string sphereName = std::to_string(viewIds[v]);
+        const fs::path imagePath = fs::path(sfmData.getView(viewIds[v]).getImage().getImagePath());
 
-        const auto pred = predict(session, imagePath, minScore);
+        const auto& pred = predictions[v];
 
         // If there is no bounding box, then no sphere has been detected
         if (pred.bboxes.size() > 0)
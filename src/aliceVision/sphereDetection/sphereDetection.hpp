@@ -44,8 +44,9 @@ void modelExplore(Ort::Session& session);
  * @param session The ONNXRuntime session
  * @param outputPath The path to write the JSON with the detected spheres to
  * @return minScore The minimum score for the predictions
+ * @param nbConcurrentImages The number of images processed concurrently on the session
  */
-void sphereDetection(const sfmData::SfMData& sfmData, Ort::Session& session, fs::path outputPath, const float minScore);
+void sphereDetection(const sfmData::SfMData& sfmData, Ort::Session& session, fs::path outputPath, const float minScore, int nbConcurrentImages = 1);
 
 /**
  * @brief Write JSON for a hand-detected sphere
@@ -0,0 +1,95 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "BatchMode.hpp"
+
+#include <aliceVision/system/Logger.hpp>
+
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/json_parser.hpp>
+
+#include <cstdlib>
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+
+namespace bpt = boost::property_tree;
+
+namespace aliceVision {
+namespace system {
+
+std::vector<std::string> parseBatchJob(const std::string& line)
+{
+    // property_tree only reads JSON objects: wrap the array
+    std::istringstream stream("{\"arguments\": " + line + "}");
+    bpt::ptree tree;
+    try
+    {
+        bpt::read_json(stream, tree);
+    }
+    catch (const bpt::json_parser_error&)
+    {
+        throw std::invalid_argument("Invalid batch job, expected a JSON array of arguments: " + line);
+    }
+
+    const bpt::ptree& argumentsTree = tree.get_child("arguments");
+    // a string is read as a leaf with data, an array as a node of children with empty keys
+    if (argumentsTree.empty() && !argumentsTree.data().empty())
+        throw std::invalid_argument("Invalid batch job, expected a JSON array of arguments: " + line);
+
+    std::vector<std::string> arguments;
+    arguments.reserve(argumentsTree.size());
+    for (const auto& argumentTree : argumentsTree)
+    {
+        if (!argumentTree.first.empty() || !argumentTree.second.empty())
+            throw std::invalid_argument("Invalid batch job, expected a JSON array of arguments: " + line);
+        arguments.push_back(argumentTree.second.data());
+    }
+    return arguments;
+}
+
+int runBatch(const std::string& executable, std::istream& input, std::ostream& output, const std::function<int(int, char**)>& runJob)
+{
+    int batchExitCode = EXIT_SUCCESS;
+    int jobIndex = 0;
+    std::string line;
+    while (std::getline(input, line))
+    {
+        if (line.find_first_not_of(" \t\r") == std::string::npos)
+            continue;
+
+        int exitCode = EXIT_FAILURE;
+        try
+        {
+            std::vector<std::string> arguments = parseBatchJob(line);
+            arguments.insert(arguments.begin(), executable);
+
+            std::vector<char*> argv;
+            argv.reserve(arguments.size() + 1);
+            for (std::string& argument : arguments)
+                argv.push_back(&argument[0]);
+            argv.push_back(nullptr);
+
+            ALICEVISION_LOG_INFO("Batch job " << jobIndex << ": " << line);
+            exitCode = runJob(static_cast<int>(arguments.size()), argv.data());
+        }
+        catch (const std::exception& e)
+        {
+            ALICEVISION_LOG_ERROR("Batch job " << jobIndex << ": " << e.what());
+        }
+
+        if (exitCode != EXIT_SUCCESS)
+            batchExitCode = EXIT_FAILURE;
+
+        output << "{\"job\": " << jobIndex << ", \"exitCode\": " << exitCode << "}" << std::endl;
+        ++jobIndex;
+    }
+    return batchExitCode;
+}
+
+}  // namespace system
+}  // namespace aliceVision
@@ -0,0 +1,47 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace aliceVision {
+namespace system {
+
+/**
+ * @brief The program argument enabling the batch mode of the main() wrapper (system/main.hpp).
+ *
+ * In batch mode, the program reads jobs from the standard input, one JSON array of arguments per line
+ * (the arguments of a regular run, without the executable name), and runs them one after the other in the same process.
+ * The process-wide caches (lens correction maps, DCP profiles, color processors, ...) stay warm between the jobs.
+ * A status line {"job": <index>, "exitCode": <code>} is written on the standard output at the end of each job.
+ */
+constexpr const char* batchModeArgument = "--batch";
+
+/**
+ * @brief Parse the arguments of a batch job.
+ * @param[in] line the job line: a JSON array of strings
+ * @return the job arguments
+ * @throw std::invalid_argument if the line is not a JSON array of strings
+ */
+std::vector<std::string> parseBatchJob(const std::string& line);
+
+/**
+ * @brief Run the jobs of a batch, read from a stream until its end.
+ *        The empty lines are ignored, an invalid line is logged and counted as a failed job.
+ * @param[in] executable the executable name, given as first argument to the jobs
+ * @param[in] input the stream of the job lines
+ * @param[in] output the stream of the job status lines
+ * @param[in] runJob the job function, called with the arguments of a regular run (argc, argv)
+ * @return EXIT_SUCCESS if all the jobs succeeded, EXIT_FAILURE otherwise
+ */
+int runBatch(const std::string& executable, std::istream& input, std::ostream& output, const std::function<int(int, char**)>& runJob);
+
+}  // namespace system
+}  // namespace aliceVision
@@ -0,0 +1,62 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/system/BatchMode.hpp>
+
+#define BOOST_TEST_MODULE BatchMode
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstdlib>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace aliceVision::system;
+
+BOOST_AUTO_TEST_CASE(BatchMode_parseJob)
+{
+    const std::vector<std::string> arguments = parseBatchJob("[\"--input\", \"/data/a b.sfm\", \"--rangeStart\", \"10\"]");
+    BOOST_REQUIRE_EQUAL(arguments.size(), 4);
+    BOOST_CHECK_EQUAL(arguments[1], "/data/a b.sfm");
+    BOOST_CHECK_EQUAL(arguments[3], "10");
+
+    BOOST_CHECK(parseBatchJob("[]").empty());
+
+    BOOST_CHECK_THROW(parseBatchJob("--input a.sfm"), std::invalid_argument);
+    BOOST_CHECK_THROW(parseBatchJob("\"--input\""), std::invalid_argument);
+    BOOST_CHECK_THROW(parseBatchJob("[[\"--input\"]]"), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(BatchMode_run)
+{
+    std::istringstream input("[\"a\"]\n"
+                             "\n"
+                             "not a job\n"
+                             "[\"b\", \"c\"]\n");
+    std::ostringstream output;
+
+    std::vector<std::vector<std::string>> jobs;
+    const int exitCode = runBatch("program", input, output, [&](int argc, char** argv) {
+        jobs.emplace_back(argv, argv + argc);
+        return EXIT_SUCCESS;
+    });
+
+    // the invalid line is a failed job, the empty line is ignored
+    BOOST_CHECK_EQUAL(exitCode, EXIT_FAILURE);
+    BOOST_REQUIRE_EQUAL(jobs.size(), 2);
+    BOOST_CHECK(jobs[0] == std::vector<std::string>({"program", "a"}));
+    BOOST_CHECK(jobs[1] == std::vector<std::string>({"program", "b", "c"}));
+    BOOST_CHECK_EQUAL(output.str(),
+                      "{\"job\": 0, \"exitCode\": 0}\n"
+                      "{\"job\": 1, \"exitCode\": 1}\n"
+                      "{\"job\": 2, \"exitCode\": 0}\n");
+
+    // all the jobs succeeded
+    std::istringstream validInput("[\"a\"]\n[\"b\"]\n");
+    BOOST_CHECK_EQUAL(runBatch("program", validInput, output, [](int, char**) { return EXIT_SUCCESS; }), EXIT_SUCCESS);
+}
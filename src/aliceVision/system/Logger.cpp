@@ -10,6 +10,7 @@
 #include <boost/log/core.hpp>
 #include <boost/log/trivial.hpp>
 #include <boost/log/expressions.hpp>
+#include <boost/log/sinks/async_frontend.hpp>
 #include <boost/log/sinks/sync_frontend.hpp>
 #include <boost/log/sinks/text_ostream_backend.hpp>
 #include <boost/log/sources/severity_logger.hpp>
@@ -85,8 +86,27 @@ std::istream& operator>>(std::istream& in, EVerboseLevel& verboseLevel)
     return in;
 }
 
+namespace detail {
+std::atomic<int> logSeverityThreshold{static_cast<int>(boost::log::trivial::trace)};
+}  // namespace detail
+
+namespace {
+
+using async_sink_t = boost::log::sinks::asynchronous_sink<boost::log::sinks::text_ostream_backend>;
+
+/// the asynchronous sink, if enabled, to write its pending messages at exit
+boost::shared_ptr<async_sink_t> asyncSink;
+
+}  // namespace
+
 std::shared_ptr<Logger> Logger::_instance = nullptr;
 
+bool Logger::useAsyncSink()
+{
+    const char* envAsync = std::getenv("ALICEVISION_LOG_ASYNC");
+    return envAsync != nullptr && std::string(envAsync) != "0";
+}
+
 Logger::Logger()
 {
     namespace expr = boost::log::expressions;
@@ -100,30 +120,34 @@ Logger::Logger()
 #else
     using null_deleter = boost::log::empty_deleter;
 #endif
-    boost::shared_ptr<sink_t> sink;
-
-    {
-        // create a backend and attach a stream to it
-        boost::shared_ptr<sinks::text_ostream_backend> backend = boost::make_shared<sinks::text_ostream_backend>();
-        backend->add_stream(boost::shared_ptr<std::ostream>(&std::clog, null_deleter()));
-        // backend->add_stream( boost::shared_ptr< std::ostream >( new std::ofstream("sample.log") ) );
+    // create a backend and attach a stream to it
+    boost::shared_ptr<sinks::text_ostream_backend> backend = boost::make_shared<sinks::text_ostream_backend>();
+    backend->add_stream(boost::shared_ptr<std::ostream>(&std::clog, null_deleter()));
+    // backend->add_stream( boost::shared_ptr< std::ostream >( new std::ofstream("sample.log") ) );
 
-        // enable auto-flushing after each log record written
-        backend->auto_flush(true);
-
-        // wrap it into the frontend and register in the core.
-        sink = boost::make_shared<sink_t>(backend);
-    }
-
-    sink->reset_formatter();
+    // enable auto-flushing after each log record written
+    backend->auto_flush(true);
 
     // specify format of the log records
-    sink->set_formatter(expr::stream << "[" << expr::format_date_time<boost::posix_time::ptime>("TimeStamp", "%H:%M:%S.%f") << "]"
-                                     << "[" << boost::log::trivial::severity << "]"
-                                     << " " << expr::smessage);
-
-    // register the sink in the logging core
-    boost::log::core::get()->add_sink(sink);
+    const auto formatter = expr::stream << "[" << expr::format_date_time<boost::posix_time::ptime>("TimeStamp", "%H:%M:%S.%f") << "]"
+                                        << "[" << boost::log::trivial::severity << "]"
+                                        << " " << expr::smessage;
+
+    // wrap it into the frontend and register in the core.
+    // the asynchronous frontend formats and writes the records in its own thread,
+    // the logging threads (e.g. in parallel loops) only queue them
+    if (useAsyncSink())
+    {
+        asyncSink = boost::make_shared<async_sink_t>(backend);
+        asyncSink->set_formatter(formatter);
+        boost::log::core::get()->add_sink(asyncSink);
+    }
+    else
+    {
+        boost::shared_ptr<sink_t> sink = boost::make_shared<sink_t>(backend);
+        sink->set_formatter(formatter);
+        boost::log::core::get()->add_sink(sink);
+    }
 
     boost::log::add_common_attributes();
 
@@ -135,6 +159,23 @@ Logger::Logger()
         setLogLevel(envLevel);
 }
 
+Logger::~Logger()
+{
+    if (asyncSink)
+    {
+        boost::log::core::get()->remove_sink(asyncSink);
+        asyncSink->stop();
+        asyncSink->flush();
+        asyncSink.reset();
+    }
+}
+
+void Logger::flush()
+{
+    if (asyncSink)
+        asyncSink->flush();
+}
+
 std::shared_ptr<Logger> Logger::get()
 {
     if (_instance == nullptr)
@@ -177,6 +218,7 @@ void Logger::setLogLevel(const std::string& level) { setLogLevel(EVerboseLevel_s
 
 void Logger::setLogLevel(const boost::log::trivial::severity_level level)
 {
+    detail::logSeverityThreshold.store(static_cast<int>(level), std::memory_order_relaxed);
     boost::log::core::get()->set_filter(boost::log::trivial::severity >= level);
 }
 
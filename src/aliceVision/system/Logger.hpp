@@ -11,6 +11,7 @@
 
 #include <boost/log/trivial.hpp>
 
+#include <atomic>
 #include <memory>
 #include <iostream>
 
@@ -28,12 +29,20 @@
 #define ALICEVISION_LOG_FATAL_OBJ BOOST_LOG_TRIVIAL(fatal)
 #define ALICEVISION_LOG(MODE, a) MODE << a
 
-#define ALICEVISION_LOG_TRACE(a) ALICEVISION_LOG(ALICEVISION_LOG_TRACE_OBJ, a)
-#define ALICEVISION_LOG_DEBUG(a) ALICEVISION_LOG(ALICEVISION_LOG_DEBUG_OBJ, a)
-#define ALICEVISION_LOG_INFO(a) ALICEVISION_LOG(ALICEVISION_LOG_INFO_OBJ, a)
-#define ALICEVISION_LOG_WARNING(a) ALICEVISION_LOG(ALICEVISION_LOG_WARNING_OBJ, a)
-#define ALICEVISION_LOG_ERROR(a) ALICEVISION_LOG(ALICEVISION_LOG_ERROR_OBJ, a)
-#define ALICEVISION_LOG_FATAL(a) ALICEVISION_LOG(ALICEVISION_LOG_FATAL_OBJ, a)
+// the level is checked before the record is opened and the message is built
+#define ALICEVISION_LOG_IF_ENABLED(SEVERITY, MODE, a)                                                                                                \
+    if (!::aliceVision::system::isLogEnabled(boost::log::trivial::SEVERITY))                                                                         \
+    {                                                                                                                                                \
+    }                                                                                                                                                \
+    else                                                                                                                                             \
+        ALICEVISION_LOG(MODE, a)
+
+#define ALICEVISION_LOG_TRACE(a) ALICEVISION_LOG_IF_ENABLED(trace, ALICEVISION_LOG_TRACE_OBJ, a)
+#define ALICEVISION_LOG_DEBUG(a) ALICEVISION_LOG_IF_ENABLED(debug, ALICEVISION_LOG_DEBUG_OBJ, a)
+#define ALICEVISION_LOG_INFO(a) ALICEVISION_LOG_IF_ENABLED(info, ALICEVISION_LOG_INFO_OBJ, a)
+#define ALICEVISION_LOG_WARNING(a) ALICEVISION_LOG_IF_ENABLED(warning, ALICEVISION_LOG_WARNING_OBJ, a)
+#define ALICEVISION_LOG_ERROR(a) ALICEVISION_LOG_IF_ENABLED(error, ALICEVISION_LOG_ERROR_OBJ, a)
+#define ALICEVISION_LOG_FATAL(a) ALICEVISION_LOG_IF_ENABLED(fatal, ALICEVISION_LOG_FATAL_OBJ, a)
 
 #define ALICEVISION_THROW(EXCEPTION, x)                                                                                                              \
     {                                                                                                                                                \
@@ -74,6 +83,21 @@ std::ostream& operator<<(std::ostream& os, EVerboseLevel verboseLevel);
 
 std::istream& operator>>(std::istream& in, EVerboseLevel& verboseLevel);
 
+namespace detail {
+/// lowest severity of the logged messages, set with the Logger level (all the messages before the Logger is set up)
+extern std::atomic<int> logSeverityThreshold;
+}  // namespace detail
+
+/**
+ * @brief Check if the messages of a severity are logged, without lock.
+ * @param[in] severity the message severity
+ * @return true if the messages of this severity pass the Logger level
+ */
+inline bool isLogEnabled(boost::log::trivial::severity_level severity)
+{
+    return static_cast<int>(severity) >= detail::logSeverityThreshold.load(std::memory_order_relaxed);
+}
+
 class Logger
 {
   public:
@@ -83,6 +107,16 @@ class Logger
      */
     static std::shared_ptr<Logger> get();
 
+    /**
+     * @brief Logger destructor, writes the pending messages of the asynchronous sink
+     */
+    ~Logger();
+
+    /**
+     * @brief Wait until the pending messages of the asynchronous sink are written
+     */
+    void flush();
+
     /**
      * @brief get default verbose level
      * @return default verbose level
@@ -107,6 +141,12 @@ class Logger
      */
     Logger();
 
+    /**
+     * @brief Set up an asynchronous sink: the messages are queued by the logging threads and written by a dedicated thread.
+     *        Enabled with the ALICEVISION_LOG_ASYNC environment variable (the pending messages are lost if the process crashes).
+     */
+    static bool useAsyncSink();
+
     /**
      * @brief setLogLevel with boost severity level
      * @param level boost severity level
@@ -31,3 +31,24 @@ BOOST_AUTO_TEST_CASE(Logger_Enums)
 
     BOOST_CHECK_THROW(EVerboseLevel_stringToEnum("not a level"), std::out_of_range);
 }
+
+BOOST_AUTO_TEST_CASE(Logger_disabledLevel)
+{
+    using namespace aliceVision::system;
+    Logger::get()->setLogLevel(EVerboseLevel::Warning);
+
+    BOOST_CHECK(isLogEnabled(boost::log::trivial::error));
+    BOOST_CHECK(isLogEnabled(boost::log::trivial::warning));
+    BOOST_CHECK(!isLogEnabled(boost::log::trivial::info));
+
+    // the message of a disabled level is not built
+    int nbEvaluations = 0;
+    auto evaluate = [&]() { return ++nbEvaluations; };
+    ALICEVISION_LOG_DEBUG("debug " << evaluate());
+    ALICEVISION_LOG_INFO("info " << evaluate());
+    BOOST_CHECK_EQUAL(nbEvaluations, 0);
+    ALICEVISION_LOG_WARNING("warning " << evaluate());
+    BOOST_CHECK_EQUAL(nbEvaluations, 1);
+
+    Logger::get()->setLogLevel(Logger::getDefaultVerboseLevel());
+}
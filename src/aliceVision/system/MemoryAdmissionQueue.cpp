@@ -0,0 +1,128 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "MemoryAdmissionQueue.hpp"
+
+#include <algorithm>
+
+namespace aliceVision {
+namespace system {
+
+MemoryAdmissionQueue::MemoryAdmissionQueue(std::size_t budget)
+  : _budget(budget)
+{}
+
+void MemoryAdmissionQueue::push(std::size_t jobIndex, std::size_t memory)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _pendingJobs.emplace(memory, jobIndex);
+    }
+    _memoryReleased.notify_one();
+}
+
+bool MemoryAdmissionQueue::pop(std::size_t& jobIndex)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    auto it = _pendingJobs.end();
+    _memoryReleased.wait(lock, [&]() {
+        if (_cancelled || _pendingJobs.empty())
+            return true;
+
+        // nothing is running: start the largest job, even if it exceeds the budget
+        if (_runningJobs.empty())
+        {
+            it = _pendingJobs.begin();
+            return true;
+        }
+
+        // largest pending job fitting in the remaining budget
+        const std::size_t remaining = (_reservedMemory < _budget) ? _budget - _reservedMemory : 0;
+        it = _pendingJobs.lower_bound(remaining);
+        return it != _pendingJobs.end();
+    });
+
+    if (_cancelled || _pendingJobs.empty())
+        return false;
+
+    jobIndex = it->second;
+    _runningJobs[jobIndex] = it->first;
+    _reservedMemory += it->first;
+    _pendingJobs.erase(it);
+
+    _peakReservedMemory = std::max(_peakReservedMemory, _reservedMemory);
+    _peakRunningJobs = std::max(_peakRunningJobs, _runningJobs.size());
+    return true;
+}
+
+void MemoryAdmissionQueue::resize(std::size_t jobIndex, std::size_t memory)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        auto it = _runningJobs.find(jobIndex);
+        if (it == _runningJobs.end())
+            return;
+
+        _reservedMemory = _reservedMemory - it->second + memory;
+        it->second = memory;
+        _peakReservedMemory = std::max(_peakReservedMemory, _reservedMemory);
+    }
+    _memoryReleased.notify_all();
+}
+
+void MemoryAdmissionQueue::release(std::size_t jobIndex)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        auto it = _runningJobs.find(jobIndex);
+        if (it == _runningJobs.end())
+            return;
+
+        _reservedMemory -= it->second;
+        _runningJobs.erase(it);
+    }
+    _memoryReleased.notify_all();
+}
+
+void MemoryAdmissionQueue::cancel()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _cancelled = true;
+        _pendingJobs.clear();
+    }
+    _memoryReleased.notify_all();
+}
+
+std::size_t MemoryAdmissionQueue::nbRunningJobs() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _runningJobs.size();
+}
+
+std::size_t MemoryAdmissionQueue::reservedMemory() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _reservedMemory;
+}
+
+std::size_t MemoryAdmissionQueue::peakReservedMemory() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _peakReservedMemory;
+}
+
+std::size_t MemoryAdmissionQueue::peakRunningJobs() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _peakRunningJobs;
+}
+
+}  // namespace system
+}  // namespace aliceVision
@@ -0,0 +1,106 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace aliceVision {
+namespace system {
+
+/**
+ * @brief Admission controller of jobs sharing a memory budget.
+ *        The workers pop the largest pending job fitting in the remaining budget, so that the large jobs
+ *        are started first and the small ones fill the remaining memory.
+ *        A job larger than the whole budget is run alone.
+ *        The memory of a job is reserved when it is popped and released when it is done,
+ *        its reservation can be corrected while it runs when its estimate turns out to be wrong.
+ */
+class MemoryAdmissionQueue
+{
+  public:
+    /**
+     * @param[in] budget the memory budget shared by the running jobs, in bytes
+     */
+    explicit MemoryAdmissionQueue(std::size_t budget);
+
+    /**
+     * @brief Add a pending job.
+     * @param[in] jobIndex the job index
+     * @param[in] memory the estimated memory of the job, in bytes
+     */
+    void push(std::size_t jobIndex, std::size_t memory);
+
+    /**
+     * @brief Wait for a pending job fitting in the remaining budget and reserve its memory.
+     * @param[out] jobIndex the index of the job to run
+     * @return false if there is no more pending job or if the queue has been cancelled
+     */
+    bool pop(std::size_t& jobIndex);
+
+    /**
+     * @brief Correct the memory reserved by a running job.
+     * @note A smaller reservation admits the next jobs sooner, a larger one delays them.
+     * @param[in] jobIndex the running job index
+     * @param[in] memory the corrected memory of the job, in bytes
+     */
+    void resize(std::size_t jobIndex, std::size_t memory);
+
+    /**
+     * @brief Release the memory reserved by a job once it is done.
+     * @param[in] jobIndex the done job index
+     */
+    void release(std::size_t jobIndex);
+
+    /**
+     * @brief Drop the pending jobs and wake up the waiting workers (e.g. after an error).
+     */
+    void cancel();
+
+    /**
+     * @return the number of running jobs
+     */
+    std::size_t nbRunningJobs() const;
+
+    /**
+     * @return the memory currently reserved by the running jobs, in bytes
+     */
+    std::size_t reservedMemory() const;
+
+    /**
+     * @return the maximum memory reserved at once, in bytes
+     */
+    std::size_t peakReservedMemory() const;
+
+    /**
+     * @return the maximum number of jobs run at once
+     */
+    std::size_t peakRunningJobs() const;
+
+  private:
+    const std::size_t _budget;
+
+    /// pending jobs by decreasing memory
+    std::multimap<std::size_t, std::size_t, std::greater<std::size_t>> _pendingJobs;
+    /// reserved memory of the running jobs
+    std::map<std::size_t, std::size_t> _runningJobs;
+
+    std::size_t _reservedMemory = 0;
+    std::size_t _peakReservedMemory = 0;
+    std::size_t _peakRunningJobs = 0;
+    bool _cancelled = false;
+
+    mutable std::mutex _mutex;
+    std::condition_variable _memoryReleased;
+};
+
+}  // namespace system
+}  // namespace aliceVision
@@ -0,0 +1,137 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/system/MemoryAdmissionQueue.hpp>
+
+#define BOOST_TEST_MODULE MemoryAdmissionQueue
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace aliceVision::system;
+
+BOOST_AUTO_TEST_CASE(MemoryAdmissionQueue_largestFittingFirst)
+{
+    MemoryAdmissionQueue queue(100);
+
+    queue.push(0, 10);
+    queue.push(1, 70);
+    queue.push(2, 40);
+    queue.push(3, 20);
+
+    std::size_t jobIndex;
+
+    // the largest job first
+    BOOST_CHECK(queue.pop(jobIndex));
+    BOOST_CHECK_EQUAL(jobIndex, 1);
+
+    // 30 bytes remaining: the 40 bytes job is skipped
+    BOOST_CHECK(queue.pop(jobIndex));
+    BOOST_CHECK_EQUAL(jobIndex, 3);
+    BOOST_CHECK(queue.pop(jobIndex));
+    BOOST_CHECK_EQUAL(jobIndex, 0);
+    BOOST_CHECK_EQUAL(queue.reservedMemory(), 100);
+
+    // the estimate of the first job was too large
+    queue.resize(1, 30);
+    BOOST_CHECK(queue.pop(jobIndex));
+    BOOST_CHECK_EQUAL(jobIndex, 2);
+    BOOST_CHECK_EQUAL(queue.reservedMemory(), 100);
+    BOOST_CHECK_EQUAL(queue.peakRunningJobs(), 4);
+
+    for (std::size_t i = 0; i < 4; ++i)
+        queue.release(i);
+    BOOST_CHECK_EQUAL(queue.reservedMemory(), 0);
+
+    // no more job
+    BOOST_CHECK(!queue.pop(jobIndex));
+}
+
+BOOST_AUTO_TEST_CASE(MemoryAdmissionQueue_oversizedJob)
+{
+    MemoryAdmissionQueue queue(100);
+
+    queue.push(0, 500);
+    queue.push(1, 10);
+
+    std::size_t jobIndex;
+
+    // a job larger than the budget is run when nothing else is running
+    BOOST_CHECK(queue.pop(jobIndex));
+    BOOST_CHECK_EQUAL(jobIndex, 0);
+    BOOST_CHECK_EQUAL(queue.peakReservedMemory(), 500);
+
+    queue.release(0);
+    BOOST_CHECK(queue.pop(jobIndex));
+    BOOST_CHECK_EQUAL(jobIndex, 1);
+    queue.release(1);
+}
+
+BOOST_AUTO_TEST_CASE(MemoryAdmissionQueue_concurrentWorkers)
+{
+    const std::size_t budget = 1000;
+    MemoryAdmissionQueue queue(budget);
+
+    const std::size_t nbJobs = 500;
+    for (std::size_t i = 0; i < nbJobs; ++i)
+        queue.push(i, 50 + (i * 37) % 400);
+
+    std::atomic<std::size_t> nbDoneJobs{0};
+    std::atomic<bool> overBudget{false};
+    std::vector<char> done(nbJobs, 0);
+    std::mutex doneMutex;
+
+    std::vector<std::thread> workers;
+    for (int w = 0; w < 8; ++w)
+    {
+        workers.emplace_back([&]() {
+            std::size_t jobIndex;
+            while (queue.pop(jobIndex))
+            {
+                if (queue.reservedMemory() > budget)
+                    overBudget = true;
+                {
+                    std::lock_guard<std::mutex> lock(doneMutex);
+                    ++done[jobIndex];
+                }
+                ++nbDoneJobs;
+                queue.release(jobIndex);
+            }
+        });
+    }
+    for (std::thread& worker : workers)
+        worker.join();
+
+    BOOST_CHECK_EQUAL(nbDoneJobs, nbJobs);
+    BOOST_CHECK(!overBudget);
+    BOOST_CHECK(std::all_of(done.begin(), done.end(), [](char d) { return d == 1; }));
+    BOOST_CHECK_LE(queue.peakReservedMemory(), budget);
+}
+
+BOOST_AUTO_TEST_CASE(MemoryAdmissionQueue_cancel)
+{
+    MemoryAdmissionQueue queue(100);
+    queue.push(0, 80);
+    queue.push(1, 80);
+
+    std::size_t jobIndex;
+    BOOST_CHECK(queue.pop(jobIndex));
+
+    // the second worker waits for the memory of the first job
+    std::thread worker([&]() {
+        std::size_t otherJobIndex;
+        BOOST_CHECK(!queue.pop(otherJobIndex));
+    });
+
+    queue.cancel();
+    worker.join();
+    queue.release(jobIndex);
+}
@@ -7,14 +7,18 @@
 #include "MemoryInfo.hpp"
 
 #include <aliceVision/system/system.hpp>
+#include <aliceVision/system/cgroup.hpp>
 
+#include <algorithm>
 #include <cmath>
 #include <iomanip>
 
 #if defined(__WINDOWS__)
     #include <windows.h>
+    #include <psapi.h>
 #elif defined(__LINUX__)
     #include <sys/sysinfo.h>
+    #include <sys/resource.h>
     #include <fstream>
     #include <limits>
 #elif defined(__APPLE__)
@@ -24,6 +28,7 @@
     #include <mach/mach_types.h>
     #include <mach/mach_init.h>
     #include <mach/mach_host.h>
+    #include <sys/resource.h>
 #else
     #warning "System unrecognized. Can't found memory infos."
     #include <limits>
@@ -85,6 +90,18 @@ MemoryInfo getMemoryInfo()
     if (infos.availableRam == 0)
         infos.availableRam = infos.freeRam;
 
+    // inside a container, the control group memory limit is reached before the host memory
+    const CgroupLimits cgroupLimits = getCgroupLimits();
+    if (cgroupLimits.memoryLimit > 0 && cgroupLimits.memoryLimit < infos.totalRam)
+    {
+        const std::size_t cgroupAvailableRam =
+          (cgroupLimits.memoryLimit > cgroupLimits.memoryUsage) ? cgroupLimits.memoryLimit - cgroupLimits.memoryUsage : 0;
+
+        infos.totalRam = cgroupLimits.memoryLimit;
+        infos.freeRam = std::min(infos.freeRam, cgroupAvailableRam);
+        infos.availableRam = std::min(infos.availableRam, cgroupAvailableRam);
+    }
+
     // infos.sharedRam = sys_info.sharedram * sys_info.mem_unit;
     // infos.bufferRam = sys_info.bufferram * sys_info.mem_unit;
     infos.totalSwap = sys_info.totalswap * sys_info.mem_unit;
@@ -133,6 +150,29 @@ MemoryInfo getMemoryInfo()
     return infos;
 }
 
+std::size_t getPeakResidentMemory()
+{
+#if defined(__WINDOWS__)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return counters.PeakWorkingSetSize;
+    return 0;
+#elif defined(__LINUX__) || defined(__APPLE__)
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+    #if defined(__APPLE__)
+    // in bytes on macOS
+    return static_cast<std::size_t>(usage.ru_maxrss);
+    #else
+    // in kB on Linux
+    return static_cast<std::size_t>(usage.ru_maxrss) * 1024;
+    #endif
+#else
+    return 0;
+#endif
+}
+
 std::ostream& operator<<(std::ostream& os, const MemoryInfo& infos)
 {
     const double convertionGb = std::pow(2, 30);
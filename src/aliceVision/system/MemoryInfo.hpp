@@ -25,6 +25,12 @@ struct MemoryInfo
 
 MemoryInfo getMemoryInfo();
 
+/**
+ * @brief Get the peak resident set size (maximum physical memory used so far) of the current process.
+ * @return the peak resident memory in bytes, 0 if unavailable on this system
+ */
+std::size_t getPeakResidentMemory();
+
 std::ostream& operator<<(std::ostream& os, const MemoryInfo& infos);
 
 }  // namespace system
@@ -5,7 +5,10 @@
 // You can obtain one at https://mozilla.org/MPL/2.0/.
 
 #include "ProgressDisplay.hpp"
+#include "ProgressReport.hpp"
+#include <boost/algorithm/string/trim.hpp>
 #include <boost/timer/progress_display.hpp>
+#include <chrono>
 #include <mutex>
 
 namespace aliceVision {
@@ -34,17 +37,36 @@ class ProgressDisplayImplBoostProgress : public ProgressDisplayImpl
                                      const std::string& s1,
                                      const std::string& s2,
                                      const std::string& s3)
-      : _display{expectedCount, os, s1, s2, s3}
-    {}
+      : _display{expectedCount, os, s1, s2, s3},
+        _task{boost::algorithm::trim_copy_if(s1, boost::algorithm::is_any_of(" \t\r\n-:"))},
+        _start{std::chrono::steady_clock::now()}
+    {
+        if (_task.empty())
+            _task = "progress";
+    }
 
     ~ProgressDisplayImplBoostProgress() override = default;
 
-    void restart(unsigned long expectedCount) override { _display.restart(expectedCount); }
+    void restart(unsigned long expectedCount) override
+    {
+        std::lock_guard<std::mutex> lock{_mutex};
+        _display.restart(expectedCount);
+        _start = std::chrono::steady_clock::now();
+    }
 
     void increment(unsigned long count) override
     {
-        std::lock_guard<std::mutex> lock{_mutex};
-        _display += count;
+        unsigned long currentCount;
+        std::chrono::steady_clock::time_point start;
+        {
+            std::lock_guard<std::mutex> lock{_mutex};
+            _display += count;
+            currentCount = _display.count();
+            start = _start;
+        }
+        // the heartbeat file is written outside of the display lock
+        if (ProgressReport::get().isEnabled())
+            ProgressReport::get().update(_task, currentCount, _display.expected_count(), start);
     }
 
     unsigned long count() override
@@ -58,6 +80,8 @@ class ProgressDisplayImplBoostProgress : public ProgressDisplayImpl
   private:
     std::mutex _mutex;
     boost::timer::progress_display _display;
+    std::string _task;
+    std::chrono::steady_clock::time_point _start;
 };
 
 ProgressDisplay createConsoleProgressDisplay(unsigned long expectedCount,
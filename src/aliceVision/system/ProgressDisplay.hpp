@@ -25,7 +25,8 @@ class ProgressDisplayImpl
 
 /**
  * This is a generic API to display progress bars. Depending on implementation different
- * destinations for display data may be used. Currently only console output is supported.
+ * destinations for display data may be used. Currently only console output is supported,
+ * the console progress bars also feed the progress report heartbeat (see ProgressReport.hpp).
  *
  * The API is essentially the same as boost::timer::progress_display
  *
@@ -57,7 +58,7 @@ class ProgressDisplay
     std::shared_ptr<ProgressDisplayImpl> _impl;
 };
 
-/// Creates console-based progress bar
+/// Creates console-based progress bar, the first leading string (trimmed) names the task in the progress report
 ProgressDisplay createConsoleProgressDisplay(unsigned long expectedCount,
                                              std::ostream& os,
                                              const std::string& s1 = "\n",  // leading strings
@@ -0,0 +1,99 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "ProgressReport.hpp"
+
+#include <aliceVision/system/Logger.hpp>
+
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/json_parser.hpp>
+
+#include <filesystem>
+#include <system_error>
+
+namespace bpt = boost::property_tree;
+
+namespace aliceVision {
+namespace system {
+
+ProgressReport& ProgressReport::get()
+{
+    static ProgressReport report;
+    return report;
+}
+
+void ProgressReport::enable(const std::string& filepath, double intervalSeconds)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _filepath = filepath;
+    _interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(intervalSeconds));
+    _lastWrite.store(-1, std::memory_order_relaxed);
+    _enabled.store(!filepath.empty(), std::memory_order_relaxed);
+}
+
+void ProgressReport::update(const std::string& task, unsigned long count, unsigned long expectedCount, std::chrono::steady_clock::time_point start)
+{
+    if (!isEnabled())
+        return;
+
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    const bool done = (count >= expectedCount);
+
+    // the intermediate updates are skipped within the interval or while the file is written by another thread,
+    // the end of a task is always written
+    const std::int64_t lastWrite = _lastWrite.load(std::memory_order_relaxed);
+    if (!done && lastWrite >= 0 && now.time_since_epoch().count() - lastWrite < _interval.count())
+        return;
+    std::unique_lock<std::mutex> lock(_mutex, std::try_to_lock);
+    if (!lock.owns_lock())
+    {
+        if (!done)
+            return;
+        lock.lock();
+    }
+    if (!isEnabled())
+        return;
+    _lastWrite.store(now.time_since_epoch().count(), std::memory_order_relaxed);
+
+    const double elapsed = std::chrono::duration<double>(now - start).count();
+    const double itemsPerSecond = (elapsed > 0.0) ? count / elapsed : 0.0;
+    const double eta = done ? 0.0 : ((itemsPerSecond > 0.0) ? (expectedCount - count) / itemsPerSecond : -1.0);
+
+    bpt::ptree tree;
+    tree.put("task", task);
+    tree.put("count", count);
+    tree.put("expectedCount", expectedCount);
+    tree.put("progress", (expectedCount > 0) ? double(count) / expectedCount : 1.0);
+    tree.put("elapsed", elapsed);
+    tree.put("itemsPerSecond", itemsPerSecond);
+    tree.put("eta", eta);
+    tree.put("timestamp", std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count());
+
+    // write then rename, so that the readers never see a partial file
+    const std::string tmpFilepath = _filepath + ".tmp";
+    try
+    {
+        bpt::write_json(tmpFilepath, tree);
+        std::error_code ec;
+        std::filesystem::rename(tmpFilepath, _filepath, ec);
+        if (ec)
+            ALICEVISION_LOG_WARNING("Cannot write the progress report '" << _filepath << "': " << ec.message());
+    }
+    catch (const std::exception& e)
+    {
+        ALICEVISION_LOG_WARNING("Cannot write the progress report '" << _filepath << "': " << e.what());
+    }
+}
+
+void ProgressReport::reset()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _enabled.store(false, std::memory_order_relaxed);
+    _filepath.clear();
+}
+
+}  // namespace system
+}  // namespace aliceVision
@@ -0,0 +1,77 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+namespace aliceVision {
+namespace system {
+
+/**
+ * @brief Live progress of the current process, written as a JSON heartbeat file for the orchestrators.
+ *        The heartbeat gives the current task (the last updated progress display), its count of done and expected items,
+ *        its throughput and its estimated remaining time.
+ *        The file is rewritten (atomically, by a rename) at most once per interval, and at the end of each task.
+ * @note Fed by the progress displays (system/ProgressDisplay.hpp) and enabled by the common --progressFile option.
+ */
+class ProgressReport
+{
+  public:
+    /**
+     * @brief Get the process progress report.
+     * @return the progress report singleton
+     */
+    static ProgressReport& get();
+
+    // singleton, no copy constructor
+    ProgressReport(ProgressReport const&) = delete;
+
+    // singleton, no copy operator
+    void operator=(ProgressReport const&) = delete;
+
+    /**
+     * @brief Enable the report.
+     * @param[in] filepath the JSON heartbeat file
+     * @param[in] intervalSeconds the minimum time between two writes of the file (in seconds)
+     */
+    void enable(const std::string& filepath, double intervalSeconds = 1.0);
+
+    /**
+     * @return true if the report is enabled
+     */
+    inline bool isEnabled() const { return _enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Update the progress of a task. Thread safe, does not wait for a concurrent write of the file.
+     * @param[in] task the task name
+     * @param[in] count the number of items done
+     * @param[in] expectedCount the number of items of the task
+     * @param[in] start the start time of the task
+     */
+    void update(const std::string& task, unsigned long count, unsigned long expectedCount, std::chrono::steady_clock::time_point start);
+
+    /**
+     * @brief Disable the report.
+     */
+    void reset();
+
+  private:
+    ProgressReport() = default;
+
+    std::atomic<bool> _enabled{false};
+    std::string _filepath;
+    std::chrono::steady_clock::duration _interval{std::chrono::seconds(1)};
+    std::atomic<std::int64_t> _lastWrite{-1};  //< steady clock ticks of the last write (-1 before the first one)
+    std::mutex _mutex;
+};
+
+}  // namespace system
+}  // namespace aliceVision
@@ -0,0 +1,62 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/system/ProgressReport.hpp>
+#include <aliceVision/system/ProgressDisplay.hpp>
+
+#define BOOST_TEST_MODULE ProgressReport
+
+#include <boost/test/unit_test.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/json_parser.hpp>
+
+#include <filesystem>
+#include <sstream>
+
+using namespace aliceVision::system;
+namespace bpt = boost::property_tree;
+namespace fs = std::filesystem;
+
+BOOST_AUTO_TEST_CASE(ProgressReport_heartbeat)
+{
+    const fs::path filepath = fs::temp_directory_path() / "ProgressReport_test.json";
+    fs::remove(filepath);
+
+    // the intermediate updates are written at most once per interval
+    ProgressReport::get().enable(filepath.string(), 3600.0);
+
+    std::ostringstream console;
+    ProgressDisplay display = createConsoleProgressDisplay(10, console, "\n- Matching -\n");
+    ++display;
+    BOOST_REQUIRE(fs::exists(filepath));
+    {
+        bpt::ptree tree;
+        bpt::read_json(filepath.string(), tree);
+        BOOST_CHECK_EQUAL(tree.get<std::string>("task"), "Matching");
+        BOOST_CHECK_EQUAL(tree.get<unsigned long>("count"), 1);
+        BOOST_CHECK_EQUAL(tree.get<unsigned long>("expectedCount"), 10);
+    }
+
+    display += 5;
+    {
+        bpt::ptree tree;
+        bpt::read_json(filepath.string(), tree);
+        BOOST_CHECK_EQUAL(tree.get<unsigned long>("count"), 1);
+    }
+
+    // the end of the task is always written
+    display += 4;
+    {
+        bpt::ptree tree;
+        bpt::read_json(filepath.string(), tree);
+        BOOST_CHECK_EQUAL(tree.get<unsigned long>("count"), 10);
+        BOOST_CHECK_EQUAL(tree.get<double>("eta"), 0.0);
+        BOOST_CHECK_EQUAL(tree.get<double>("progress"), 1.0);
+    }
+
+    ProgressReport::get().reset();
+    fs::remove(filepath);
+}
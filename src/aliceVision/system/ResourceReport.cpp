@@ -0,0 +1,227 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "ResourceReport.hpp"
+
+#include <aliceVision/system/system.hpp>
+#include <aliceVision/system/Logger.hpp>
+#include <aliceVision/system/MemoryInfo.hpp>
+#include <aliceVision/system/cpu.hpp>
+
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/json_parser.hpp>
+
+#include <algorithm>
+#include <filesystem>
+
+#if defined(__WINDOWS__)
+    #include <windows.h>
+#elif defined(__LINUX__)
+    #include <sys/resource.h>
+    #include <fstream>
+#elif defined(__APPLE__)
+    #include <sys/resource.h>
+#endif
+
+namespace aliceVision {
+namespace system {
+
+namespace bpt = boost::property_tree;
+
+namespace {
+
+/**
+ * @brief Process I/O counters
+ */
+struct IoCounters
+{
+    /// bytes read by the read system calls (including the page cache hits)
+    std::size_t bytesRead = 0;
+    /// bytes written by the write system calls
+    std::size_t bytesWritten = 0;
+    /// bytes fetched from the storage
+    std::size_t storageBytesRead = 0;
+    /// bytes sent to the storage
+    std::size_t storageBytesWritten = 0;
+};
+
+/**
+ * @brief Get the I/O counters of the current process.
+ * @return the I/O counters, zeros if unavailable on this system
+ */
+IoCounters getIoCounters()
+{
+    IoCounters counters;
+#if defined(__WINDOWS__)
+    IO_COUNTERS ioCounters;
+    if (GetProcessIoCounters(GetCurrentProcess(), &ioCounters))
+    {
+        counters.bytesRead = static_cast<std::size_t>(ioCounters.ReadTransferCount);
+        counters.bytesWritten = static_cast<std::size_t>(ioCounters.WriteTransferCount);
+    }
+#elif defined(__LINUX__)
+    std::ifstream ioFile("/proc/self/io");
+    std::string key;
+    std::size_t value;
+    while (ioFile >> key >> value)
+    {
+        if (key == "rchar:")
+            counters.bytesRead = value;
+        else if (key == "wchar:")
+            counters.bytesWritten = value;
+        else if (key == "read_bytes:")
+            counters.storageBytesRead = value;
+        else if (key == "write_bytes:")
+            counters.storageBytesWritten = value;
+    }
+#endif
+    return counters;
+}
+
+/**
+ * @brief Get the CPU time (user and system) of all the threads of the current process.
+ * @return the CPU time in seconds, 0 if unavailable on this system
+ */
+double getProcessCpuTime()
+{
+#if defined(__WINDOWS__)
+    FILETIME creationTime, exitTime, kernelTime, userTime;
+    if (!GetProcessTimes(GetCurrentProcess(), &creationTime, &exitTime, &kernelTime, &userTime))
+        return 0.0;
+    const auto toSeconds = [](const FILETIME& t) {
+        return double((static_cast<unsigned long long>(t.dwHighDateTime) << 32) | t.dwLowDateTime) * 1e-7;  // 100 ns units
+    };
+    return toSeconds(kernelTime) + toSeconds(userTime);
+#elif defined(__LINUX__) || defined(__APPLE__)
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0.0;
+    return double(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) + double(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1e-6;
+#else
+    return 0.0;
+#endif
+}
+
+}  // namespace
+
+ResourceReport& ResourceReport::get()
+{
+    static ResourceReport report;
+    return report;
+}
+
+ResourceReport::ResourceReport()
+  : _start(std::chrono::steady_clock::now()),
+    _nbThreads(static_cast<unsigned int>(std::max(get_total_cpus(), 1)))
+{}
+
+void ResourceReport::enable(const std::string& filepath)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _filepath = filepath;
+    _enabled.store(!filepath.empty(), std::memory_order_relaxed);
+}
+
+void ResourceReport::setCommandLine(int argc, char* argv[])
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _executable = (argc > 0) ? std::filesystem::path(argv[0]).filename().string() : std::string();
+    _arguments.assign(argv + std::min(argc, 1), argv + argc);
+    _start = std::chrono::steady_clock::now();
+}
+
+void ResourceReport::setNbThreads(unsigned int nbThreads)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _nbThreads = std::max(nbThreads, 1u);
+}
+
+void ResourceReport::addPhaseTime(const std::string& name, double seconds)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    Phase& phase = _phases[name];
+    phase.seconds += seconds;
+    ++phase.count;
+}
+
+void ResourceReport::updatePeakGpuMemory(std::size_t usedBytes)
+{
+    std::size_t peak = _peakGpuMemory.load(std::memory_order_relaxed);
+    while (usedBytes > peak && !_peakGpuMemory.compare_exchange_weak(peak, usedBytes, std::memory_order_relaxed))
+    {
+    }
+}
+
+void ResourceReport::write(int exitCode) const
+{
+    if (!isEnabled())
+        return;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    const double wallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - _start).count();
+    const double cpuTime = getProcessCpuTime();
+    const IoCounters io = getIoCounters();
+
+    bpt::ptree tree;
+    tree.put("executable", _executable);
+
+    bpt::ptree argumentsTree;
+    for (const std::string& argument : _arguments)
+    {
+        bpt::ptree argumentTree;
+        argumentTree.put("", argument);
+        argumentsTree.push_back(std::make_pair("", argumentTree));
+    }
+    tree.add_child("arguments", argumentsTree);
+
+    tree.put("exitCode", exitCode);
+    tree.put("wallTime", wallTime);
+
+    bpt::ptree phasesTree;
+    for (const auto& [name, phase] : _phases)
+    {
+        bpt::ptree phaseTree;
+        phaseTree.put("name", name);
+        phaseTree.put("wallTime", phase.seconds);
+        phaseTree.put("count", phase.count);
+        phasesTree.push_back(std::make_pair("", phaseTree));
+    }
+    tree.add_child("phases", phasesTree);
+
+    tree.put("peakResidentMemory", getPeakResidentMemory());
+    tree.put("peakGpuMemory", _peakGpuMemory.load(std::memory_order_relaxed));
+    tree.put("bytesRead", io.bytesRead);
+    tree.put("bytesWritten", io.bytesWritten);
+    tree.put("storageBytesRead", io.storageBytesRead);
+    tree.put("storageBytesWritten", io.storageBytesWritten);
+    tree.put("cpuTime", cpuTime);
+    tree.put("nbThreads", _nbThreads);
+    tree.put("threadUtilization", (wallTime > 0.0) ? cpuTime / (wallTime * _nbThreads) : 0.0);
+
+    try
+    {
+        bpt::write_json(_filepath, tree);
+        ALICEVISION_LOG_INFO("Resource report written: " << _filepath);
+    }
+    catch (const std::exception& e)
+    {
+        ALICEVISION_LOG_ERROR("Cannot write the resource report '" << _filepath << "': " << e.what());
+    }
+}
+
+void ResourceReport::reset()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _enabled.store(false, std::memory_order_relaxed);
+    _filepath.clear();
+    _nbThreads = 0;
+    _peakGpuMemory.store(0, std::memory_order_relaxed);
+    _phases.clear();
+}
+
+}  // namespace system
+}  // namespace aliceVision
@@ -0,0 +1,152 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace aliceVision {
+namespace system {
+
+/**
+ * @brief Resources used by the current process, written as a JSON file at the end of the run.
+ *        The report gives the wall time of each phase, the peak resident and GPU memory,
+ *        the bytes read and written, and the use ratio of the available threads.
+ * @note Filled by the main() wrapper (system/main.hpp) and enabled by the common --resourceReport option.
+ */
+class ResourceReport
+{
+  public:
+    /**
+     * @brief Get the process resource report.
+     * @return the resource report singleton
+     */
+    static ResourceReport& get();
+
+    // singleton, no copy constructor
+    ResourceReport(ResourceReport const&) = delete;
+
+    // singleton, no copy operator
+    void operator=(ResourceReport const&) = delete;
+
+    /**
+     * @brief Enable the report.
+     * @param[in] filepath the JSON report file written at the end of the run
+     */
+    void enable(const std::string& filepath);
+
+    /**
+     * @return true if the report is enabled
+     */
+    inline bool isEnabled() const { return _enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Set the program command line, restarting the run wall time.
+     * @param[in] argc the number of arguments
+     * @param[in] argv the arguments
+     */
+    void setCommandLine(int argc, char* argv[]);
+
+    /**
+     * @brief Set the number of threads available to the program, used to compute the thread utilization.
+     * @param[in] nbThreads the number of available threads
+     */
+    void setNbThreads(unsigned int nbThreads);
+
+    /**
+     * @brief Add the wall time of a phase, accumulated with the previous runs of the same phase.
+     * @param[in] name the phase name
+     * @param[in] seconds the phase wall time (in seconds)
+     */
+    void addPhaseTime(const std::string& name, double seconds);
+
+    /**
+     * @brief Update the peak GPU memory with the current device memory use.
+     * @param[in] usedBytes the device memory currently used (in bytes)
+     */
+    void updatePeakGpuMemory(std::size_t usedBytes);
+
+    /**
+     * @brief Write the JSON report file (if enabled).
+     * @param[in] exitCode the program exit code
+     */
+    void write(int exitCode) const;
+
+    /**
+     * @brief Disable the report and clear the phases, between the jobs of a batch.
+     * @note The CPU time and the bytes read and written stay the ones of the whole process.
+     */
+    void reset();
+
+  private:
+    ResourceReport();
+
+    struct Phase
+    {
+        double seconds = 0.0;
+        int count = 0;
+    };
+
+    std::atomic<bool> _enabled{false};
+    std::string _filepath;
+    std::string _executable;
+    std::vector<std::string> _arguments;
+    std::chrono::steady_clock::time_point _start;
+    unsigned int _nbThreads = 0;
+    std::atomic<std::size_t> _peakGpuMemory{0};
+    std::map<std::string, Phase> _phases;
+    mutable std::mutex _mutex;
+};
+
+/**
+ * @class Resource report phase
+ * @brief RAII helper adding the wall time of a scope to the resource report.
+ */
+class ResourcePhase
+{
+  public:
+    /**
+     * @brief ResourcePhase constructor.
+     * @param[in] name the phase name
+     */
+    explicit ResourcePhase(const char* name)
+      : _name(name),
+        _start(std::chrono::steady_clock::now())
+    {}
+
+    // no copy constructor
+    ResourcePhase(ResourcePhase const&) = delete;
+
+    // no copy operator
+    void operator=(ResourcePhase const&) = delete;
+
+    // destructor
+    ~ResourcePhase()
+    {
+        if (ResourceReport::get().isEnabled())
+            ResourceReport::get().addPhaseTime(_name, std::chrono::duration<double>(std::chrono::steady_clock::now() - _start).count());
+    }
+
+  private:
+    const char* _name;
+    std::chrono::steady_clock::time_point _start;
+};
+
+}  // namespace system
+}  // namespace aliceVision
+
+#define ALICEVISION_RESOURCE_PHASE_CONCAT_IMPL(a, b) a##b
+#define ALICEVISION_RESOURCE_PHASE_CONCAT(a, b) ALICEVISION_RESOURCE_PHASE_CONCAT_IMPL(a, b)
+
+/// Add the wall time of the current scope to the resource report, under the given phase name
+#define ALICEVISION_RESOURCE_PHASE(name) \
+    ::aliceVision::system::ResourcePhase ALICEVISION_RESOURCE_PHASE_CONCAT(resourcePhase_, __LINE__)(name)
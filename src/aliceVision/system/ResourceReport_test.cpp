@@ -0,0 +1,103 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/system/ResourceReport.hpp>
+
+#define BOOST_TEST_MODULE ResourceReport
+
+#include <boost/test/unit_test.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/json_parser.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace aliceVision::system;
+
+namespace bpt = boost::property_tree;
+
+BOOST_AUTO_TEST_CASE(ResourceReport_disabled)
+{
+    const std::string filepath = (std::filesystem::temp_directory_path() / "aliceVision_resourceReport_disabled.json").string();
+    std::filesystem::remove(filepath);
+
+    ResourceReport& report = ResourceReport::get();
+    report.enable("");
+    BOOST_CHECK(!report.isEnabled());
+
+    report.write(0);
+    BOOST_CHECK(!std::filesystem::exists(filepath));
+}
+
+BOOST_AUTO_TEST_CASE(ResourceReport_write)
+{
+    const std::string filepath = (std::filesystem::temp_directory_path() / "aliceVision_resourceReport.json").string();
+
+    std::vector<std::string> arguments = {"/usr/bin/aliceVision_test", "--rangeStart", "10", "--rangeSize", "5"};
+    std::vector<char*> argv;
+    for (std::string& argument : arguments)
+        argv.push_back(argument.data());
+
+    ResourceReport& report = ResourceReport::get();
+    report.setCommandLine(int(argv.size()), argv.data());
+    report.setNbThreads(4);
+    report.enable(filepath);
+    BOOST_CHECK(report.isEnabled());
+
+    {
+        ALICEVISION_RESOURCE_PHASE("phaseA");
+    }
+    {
+        ALICEVISION_RESOURCE_PHASE("phaseA");
+    }
+    report.addPhaseTime("phaseB", 1.5);
+
+    report.updatePeakGpuMemory(1000);
+    report.updatePeakGpuMemory(3000);
+    report.updatePeakGpuMemory(2000);
+
+    // write some bytes to have non-zero I/O counters
+    {
+        std::ofstream file(filepath);
+        file << std::string(4096, 'x');
+    }
+
+    report.write(0);
+
+    bpt::ptree tree;
+    bpt::read_json(filepath, tree);
+
+    BOOST_CHECK_EQUAL(tree.get<std::string>("executable"), "aliceVision_test");
+    BOOST_CHECK_EQUAL(tree.get_child("arguments").size(), 4);
+    BOOST_CHECK_EQUAL(tree.get_child("arguments").front().second.get_value<std::string>(), "--rangeStart");
+    BOOST_CHECK_EQUAL(tree.get<int>("exitCode"), 0);
+    BOOST_CHECK_GE(tree.get<double>("wallTime"), 0.0);
+    BOOST_CHECK_EQUAL(tree.get<std::size_t>("peakGpuMemory"), 3000);
+    BOOST_CHECK_EQUAL(tree.get<unsigned int>("nbThreads"), 4);
+    BOOST_CHECK_GE(tree.get<double>("threadUtilization"), 0.0);
+
+    int nbPhaseA = 0;
+    double phaseBTime = 0.0;
+    for (const auto& phase : tree.get_child("phases"))
+    {
+        if (phase.second.get<std::string>("name") == "phaseA")
+            nbPhaseA = phase.second.get<int>("count");
+        else if (phase.second.get<std::string>("name") == "phaseB")
+            phaseBTime = phase.second.get<double>("wallTime");
+    }
+    BOOST_CHECK_EQUAL(nbPhaseA, 2);
+    BOOST_CHECK_CLOSE(phaseBTime, 1.5, 1e-6);
+
+#if defined(__linux__)
+    BOOST_CHECK_GE(tree.get<std::size_t>("bytesWritten"), 4096);
+    BOOST_CHECK_GT(tree.get<std::size_t>("peakResidentMemory"), 0);
+#endif
+
+    report.enable("");
+    std::filesystem::remove(filepath);
+}
@@ -0,0 +1,319 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "TaskScheduler.hpp"
+
+#include <aliceVision/system/cpu.hpp>
+
+#include <boost/algorithm/string.hpp>
+
+#include <chrono>
+#include <stdexcept>
+
+namespace aliceVision {
+namespace system {
+
+namespace {
+
+/// Index of the current thread among the scheduler workers, 0 for the other threads
+thread_local unsigned int currentWorkerIndex = 0;
+
+}  // namespace
+
+std::string ETaskBackend_enumToString(ETaskBackend backend)
+{
+    switch (backend)
+    {
+        case ETaskBackend::SCHEDULER:
+            return "scheduler";
+        case ETaskBackend::OPENMP:
+            return "openmp";
+    }
+    throw std::out_of_range("Invalid task backend enum: " + std::to_string(int(backend)));
+}
+
+ETaskBackend ETaskBackend_stringToEnum(const std::string& backend)
+{
+    const std::string b = boost::to_lower_copy(backend);
+
+    if (b == "scheduler")
+        return ETaskBackend::SCHEDULER;
+    if (b == "openmp")
+        return ETaskBackend::OPENMP;
+
+    throw std::out_of_range("Invalid task backend: " + backend);
+}
+
+std::ostream& operator<<(std::ostream& os, ETaskBackend backend) { return os << ETaskBackend_enumToString(backend); }
+
+std::istream& operator>>(std::istream& in, ETaskBackend& backend)
+{
+    std::string token;
+    in >> token;
+    backend = ETaskBackend_stringToEnum(token);
+    return in;
+}
+
+TaskScheduler& TaskScheduler::get()
+{
+    static TaskScheduler scheduler;
+    return scheduler;
+}
+
+TaskScheduler::TaskScheduler()
+  : _nbThreads(static_cast<unsigned int>(std::max(get_available_cpus(), 1)))
+{}
+
+TaskScheduler::~TaskScheduler() { stopWorkers(); }
+
+void TaskScheduler::setNbThreads(unsigned int nbThreads)
+{
+    stopWorkers();
+    _nbThreads = std::max(nbThreads, 1u);
+}
+
+unsigned int TaskScheduler::getCurrentThreadIndex() { return currentWorkerIndex; }
+
+void TaskScheduler::startWorkers()
+{
+    std::lock_guard<std::mutex> lock(_startMutex);
+
+    if (_started)
+        return;
+
+    _stopping = false;
+
+    // the waiting thread runs tasks too, nbThreads - 1 workers
+    const unsigned int nbWorkers = _nbThreads - 1;
+
+    _workers.clear();
+    for (unsigned int i = 0; i < nbWorkers; ++i)
+        _workers.push_back(std::make_unique<Worker>());
+
+    for (unsigned int i = 0; i < nbWorkers; ++i)
+        _threads.emplace_back(&TaskScheduler::workerLoop, this, i + 1);
+
+    _started = true;
+}
+
+void TaskScheduler::stopWorkers()
+{
+    std::lock_guard<std::mutex> lock(_startMutex);
+
+    if (!_started)
+        return;
+
+    {
+        std::lock_guard<std::mutex> sharedLock(_sharedMutex);
+        _stopping = true;
+    }
+    _workAvailable.notify_all();
+
+    for (std::thread& thread : _threads)
+        thread.join();
+
+    _threads.clear();
+    _workers.clear();
+    _started = false;
+}
+
+void TaskScheduler::submit(Task task)
+{
+    if (!_started)
+        startWorkers();
+
+    // count the task before it can be popped
+    {
+        std::lock_guard<std::mutex> lock(_sharedMutex);
+        ++_nbPendingTasks;
+    }
+
+    const unsigned int workerIndex = currentWorkerIndex;
+
+    if (workerIndex > 0)
+    {
+        Worker& worker = *_workers.at(workerIndex - 1);
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.tasks.push_back(std::move(task));
+    }
+    else
+    {
+        std::lock_guard<std::mutex> lock(_sharedMutex);
+        _sharedTasks.push_back(std::move(task));
+    }
+
+    _workAvailable.notify_one();
+}
+
+bool TaskScheduler::popTask(unsigned int workerIndex, Task& task)
+{
+    if (_nbPendingTasks == 0)
+        return false;
+
+    // own tasks, most recent first
+    if (workerIndex > 0)
+    {
+        Worker& worker = *_workers.at(workerIndex - 1);
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        if (!worker.tasks.empty())
+        {
+            task = std::move(worker.tasks.back());
+            worker.tasks.pop_back();
+            --_nbPendingTasks;
+            return true;
+        }
+    }
+
+    // tasks submitted by the other threads
+    {
+        std::lock_guard<std::mutex> lock(_sharedMutex);
+        if (!_sharedTasks.empty())
+        {
+            task = std::move(_sharedTasks.front());
+            _sharedTasks.pop_front();
+            --_nbPendingTasks;
+            return true;
+        }
+    }
+
+    // steal the oldest task of another worker
+    const std::size_t nbWorkers = _workers.size();
+    for (std::size_t i = 0; i < nbWorkers; ++i)
+    {
+        const std::size_t victimIndex = (workerIndex + i) % nbWorkers;
+        if (victimIndex + 1 == workerIndex)
+            continue;
+
+        Worker& victim = *_workers[victimIndex];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty())
+        {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            --_nbPendingTasks;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool TaskScheduler::runPendingTask()
+{
+    if (!_started)
+        return false;
+
+    Task task;
+    if (!popTask(currentWorkerIndex, task))
+        return false;
+
+    task();
+    return true;
+}
+
+void TaskScheduler::workerLoop(unsigned int workerIndex)
+{
+    currentWorkerIndex = workerIndex;
+
+    while (true)
+    {
+        Task task;
+        if (popTask(workerIndex, task))
+        {
+            task();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(_sharedMutex);
+        _workAvailable.wait(lock, [&]() { return _stopping || _nbPendingTasks > 0; });
+
+        if (_stopping)
+            break;
+    }
+
+    currentWorkerIndex = 0;
+}
+
+TaskGroup::~TaskGroup() { waitPending(); }
+
+void TaskGroup::run(std::function<void()> task)
+{
+    TaskScheduler& scheduler = TaskScheduler::get();
+
+    // no worker, run the task immediately
+    if (scheduler.getNbThreads() <= 1)
+    {
+        try
+        {
+            task();
+        }
+        catch (...)
+        {
+            setException(std::current_exception());
+        }
+        return;
+    }
+
+    ++_nbPendingTasks;
+
+    scheduler.submit([this, task = std::move(task)]() {
+        try
+        {
+            task();
+        }
+        catch (...)
+        {
+            setException(std::current_exception());
+        }
+
+        // decrement under the lock, the group may be destroyed as soon as the waiting thread gets it
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (--_nbPendingTasks == 0)
+            _done.notify_all();
+    });
+}
+
+void TaskGroup::waitPending()
+{
+    TaskScheduler& scheduler = TaskScheduler::get();
+
+    while (_nbPendingTasks > 0)
+    {
+        // help with the pending tasks instead of blocking
+        if (scheduler.runPendingTask())
+            continue;
+
+        // the remaining tasks of the group are run by other threads
+        std::unique_lock<std::mutex> lock(_mutex);
+        _done.wait_for(lock, std::chrono::microseconds(100), [&]() { return _nbPendingTasks == 0; });
+    }
+
+    // wait for the last task to release the lock
+    std::lock_guard<std::mutex> lock(_mutex);
+}
+
+void TaskGroup::wait()
+{
+    waitPending();
+
+    std::exception_ptr exception;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        std::swap(exception, _exception);
+    }
+
+    if (exception)
+        std::rethrow_exception(exception);
+}
+
+void TaskGroup::setException(std::exception_ptr exception)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!_exception)
+        _exception = exception;
+}
+
+}  // namespace system
+}  // namespace aliceVision
@@ -0,0 +1,258 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/alicevision_omp.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace aliceVision {
+namespace system {
+
+/**
+ * @brief Backend running the parallel loops
+ */
+enum class ETaskBackend
+{
+    /// Work-stealing task scheduler: nested loops and task groups share the same threads
+    SCHEDULER,
+    /// OpenMP parallel loops, as fallback
+    OPENMP
+};
+
+std::string ETaskBackend_enumToString(ETaskBackend backend);
+ETaskBackend ETaskBackend_stringToEnum(const std::string& backend);
+std::ostream& operator<<(std::ostream& os, ETaskBackend backend);
+std::istream& operator>>(std::istream& in, ETaskBackend& backend);
+
+/**
+ * @brief Process-wide work-stealing task scheduler.
+ *        Each worker owns a deque of tasks: it runs its own tasks in LIFO order (the most recent tasks being
+ *        the most likely in cache) and steals the oldest tasks of the other workers when it runs out of work.
+ *        A thread waiting for a task group runs the pending tasks instead of blocking,
+ *        so nested parallel loops never create more threads than the scheduler has.
+ * @note The workers are started at the first submitted task.
+ */
+class TaskScheduler
+{
+  public:
+    using Task = std::function<void()>;
+
+    /**
+     * @brief Get the process task scheduler.
+     * @return the task scheduler singleton
+     */
+    static TaskScheduler& get();
+
+    // singleton, no copy constructor
+    TaskScheduler(TaskScheduler const&) = delete;
+
+    // singleton, no copy operator
+    void operator=(TaskScheduler const&) = delete;
+
+    /**
+     * @brief Set the number of threads running the tasks, including the waiting thread.
+     * @note Stops the current workers, should not be called while tasks are running.
+     * @param[in] nbThreads the number of threads (e.g. from HardwareContext::getMaxThreads)
+     */
+    void setNbThreads(unsigned int nbThreads);
+
+    /**
+     * @return the number of threads running the tasks
+     */
+    unsigned int getNbThreads() const { return _nbThreads; }
+
+    /**
+     * @brief Set the backend of the parallel loops.
+     * @param[in] backend the backend
+     */
+    void setBackend(ETaskBackend backend) { _backend = backend; }
+
+    /**
+     * @return the backend of the parallel loops
+     */
+    ETaskBackend getBackend() const { return _backend; }
+
+    /**
+     * @brief Get the index of the current thread among the threads running the tasks.
+     * @return the worker index in [1, nbThreads[, or 0 for the other threads (e.g. the main thread)
+     */
+    static unsigned int getCurrentThreadIndex();
+
+    /**
+     * @brief Submit a task.
+     * @note Pushed on the current worker deque, or on the shared queue if called from another thread.
+     * @param[in] task the task to run
+     */
+    void submit(Task task);
+
+    /**
+     * @brief Run one pending task in the current thread (if any).
+     * @return true if a task has been run
+     */
+    bool runPendingTask();
+
+    ~TaskScheduler();
+
+  private:
+    TaskScheduler();
+
+    struct Worker
+    {
+        std::deque<Task> tasks;
+        std::mutex mutex;
+    };
+
+    void startWorkers();
+    void stopWorkers();
+    void workerLoop(unsigned int workerIndex);
+    bool popTask(unsigned int workerIndex, Task& task);
+
+    unsigned int _nbThreads = 1;
+    ETaskBackend _backend = ETaskBackend::SCHEDULER;
+
+    std::vector<std::unique_ptr<Worker>> _workers;
+    std::vector<std::thread> _threads;
+    std::deque<Task> _sharedTasks;
+    std::mutex _sharedMutex;
+    std::condition_variable _workAvailable;
+    std::atomic<std::size_t> _nbPendingTasks{0};
+    std::atomic<bool> _stopping{false};
+    std::mutex _startMutex;
+    std::atomic<bool> _started{false};
+};
+
+/**
+ * @brief Group of tasks run by the task scheduler, waited together.
+ *        The first exception thrown by a task is rethrown by wait.
+ */
+class TaskGroup
+{
+  public:
+    TaskGroup() = default;
+
+    // no copy constructor
+    TaskGroup(TaskGroup const&) = delete;
+
+    // no copy operator
+    void operator=(TaskGroup const&) = delete;
+
+    /**
+     * @brief Wait for the pending tasks, without rethrowing their exceptions.
+     */
+    ~TaskGroup();
+
+    /**
+     * @brief Run a task of the group.
+     * @note Runs the task immediately if the scheduler has a single thread.
+     * @param[in] task the task to run
+     */
+    void run(std::function<void()> task);
+
+    /**
+     * @brief Wait for all the tasks of the group, running the pending tasks in the meantime.
+     * @note Rethrows the first exception thrown by a task.
+     */
+    void wait();
+
+  private:
+    void waitPending();
+    void setException(std::exception_ptr exception);
+
+    std::atomic<int> _nbPendingTasks{0};
+    std::exception_ptr _exception;
+    std::mutex _mutex;
+    std::condition_variable _done;
+};
+
+/**
+ * @brief Call func(i) for each i in [begin, end[, in parallel.
+ *        With the scheduler backend, the range is recursively split in halves down to the grain size,
+ *        the idle threads stealing the largest remaining halves.
+ *        With the OpenMP backend, the grains are run by a dynamically scheduled OpenMP loop.
+ * @param[in] begin the first index
+ * @param[in] end the index past the last one
+ * @param[in] grainSize the number of consecutive indexes run by a task, or 0 to choose it from the number of threads
+ * @param[in] func the function to call for each index
+ */
+template<typename Func>
+void parallelFor(std::ptrdiff_t begin, std::ptrdiff_t end, std::ptrdiff_t grainSize, const Func& func)
+{
+    if (end <= begin)
+        return;
+
+    TaskScheduler& scheduler = TaskScheduler::get();
+    const std::ptrdiff_t size = end - begin;
+
+    if (grainSize <= 0)
+        grainSize = std::max<std::ptrdiff_t>(1, size / (8 * static_cast<std::ptrdiff_t>(scheduler.getNbThreads())));
+
+    if (scheduler.getNbThreads() <= 1 || size <= grainSize)
+    {
+        for (std::ptrdiff_t i = begin; i < end; ++i)
+            func(i);
+        return;
+    }
+
+    if (scheduler.getBackend() == ETaskBackend::OPENMP)
+    {
+        const std::ptrdiff_t nbGrains = (size + grainSize - 1) / grainSize;
+        std::exception_ptr exception;
+
+#pragma omp parallel for schedule(dynamic, 1) num_threads(scheduler.getNbThreads())
+        for (std::ptrdiff_t g = 0; g < nbGrains; ++g)
+        {
+            try
+            {
+                const std::ptrdiff_t grainEnd = std::min(end, begin + (g + 1) * grainSize);
+                for (std::ptrdiff_t i = begin + g * grainSize; i < grainEnd; ++i)
+                    func(i);
+            }
+            catch (...)
+            {
+#pragma omp critical(parallelForException)
+                if (!exception)
+                    exception = std::current_exception();
+            }
+        }
+
+        if (exception)
+            std::rethrow_exception(exception);
+        return;
+    }
+
+    TaskGroup group;
+
+    // split the range in halves, the right halves being submitted to be stolen by the idle threads
+    std::function<void(std::ptrdiff_t, std::ptrdiff_t)> runRange = [&](std::ptrdiff_t rangeBegin, std::ptrdiff_t rangeEnd) {
+        while (rangeEnd - rangeBegin > grainSize)
+        {
+            const std::ptrdiff_t middle = rangeBegin + (rangeEnd - rangeBegin) / 2;
+            group.run([&runRange, middle, rangeEnd]() { runRange(middle, rangeEnd); });
+            rangeEnd = middle;
+        }
+        for (std::ptrdiff_t i = rangeBegin; i < rangeEnd; ++i)
+            func(i);
+    };
+
+    group.run([&runRange, begin, end]() { runRange(begin, end); });
+    group.wait();
+}
+
+}  // namespace system
+}  // namespace aliceVision
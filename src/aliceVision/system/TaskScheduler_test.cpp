@@ -0,0 +1,131 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/system/TaskScheduler.hpp>
+
+#define BOOST_TEST_MODULE TaskScheduler
+
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <numeric>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+using namespace aliceVision::system;
+
+BOOST_AUTO_TEST_CASE(TaskScheduler_parallelFor)
+{
+    TaskScheduler::get().setNbThreads(4);
+    TaskScheduler::get().setBackend(ETaskBackend::SCHEDULER);
+
+    for (const std::ptrdiff_t grainSize : {0, 1, 7, 1000})
+    {
+        std::vector<int> counts(10000, 0);
+        parallelFor(0, static_cast<std::ptrdiff_t>(counts.size()), grainSize, [&](std::ptrdiff_t i) { ++counts[i]; });
+
+        // each index is run exactly once
+        BOOST_CHECK_EQUAL(std::accumulate(counts.begin(), counts.end(), 0), 10000);
+        BOOST_CHECK_EQUAL(*std::min_element(counts.begin(), counts.end()), 1);
+    }
+
+    // empty range
+    parallelFor(10, 10, 1, [&](std::ptrdiff_t) { BOOST_FAIL("empty range"); });
+}
+
+BOOST_AUTO_TEST_CASE(TaskScheduler_nestedParallelFor)
+{
+    TaskScheduler::get().setNbThreads(4);
+    TaskScheduler::get().setBackend(ETaskBackend::SCHEDULER);
+
+    std::atomic<int> sum{0};
+    std::atomic<unsigned int> maxThreadIndex{0};
+
+    parallelFor(0, 64, 1, [&](std::ptrdiff_t) {
+        parallelFor(0, 100, 10, [&](std::ptrdiff_t j) {
+            sum += static_cast<int>(j);
+
+            unsigned int threadIndex = TaskScheduler::getCurrentThreadIndex();
+            unsigned int previous = maxThreadIndex;
+            while (threadIndex > previous && !maxThreadIndex.compare_exchange_weak(previous, threadIndex))
+            {
+            }
+        });
+    });
+
+    BOOST_CHECK_EQUAL(sum, 64 * 4950);
+
+    // the nested loops only run on the scheduler threads, no thread is added
+    BOOST_CHECK_LT(maxThreadIndex, TaskScheduler::get().getNbThreads());
+}
+
+BOOST_AUTO_TEST_CASE(TaskScheduler_taskGroup)
+{
+    TaskScheduler::get().setNbThreads(3);
+    TaskScheduler::get().setBackend(ETaskBackend::SCHEDULER);
+
+    std::atomic<int> nbTasks{0};
+    {
+        TaskGroup group;
+        for (int i = 0; i < 1000; ++i)
+            group.run([&]() { ++nbTasks; });
+        group.wait();
+        BOOST_CHECK_EQUAL(nbTasks, 1000);
+    }
+
+    // the first exception is rethrown by wait, once all the tasks are done
+    nbTasks = 0;
+    TaskGroup group;
+    for (int i = 0; i < 100; ++i)
+    {
+        group.run([&, i]() {
+            ++nbTasks;
+            if (i == 50)
+                throw std::runtime_error("task error");
+        });
+    }
+    BOOST_CHECK_THROW(group.wait(), std::runtime_error);
+    BOOST_CHECK_EQUAL(nbTasks, 100);
+
+    // the group can be reused
+    group.run([&]() { ++nbTasks; });
+    BOOST_CHECK_NO_THROW(group.wait());
+    BOOST_CHECK_EQUAL(nbTasks, 101);
+}
+
+BOOST_AUTO_TEST_CASE(TaskScheduler_singleThreadAndOpenMP)
+{
+    for (const ETaskBackend backend : {ETaskBackend::SCHEDULER, ETaskBackend::OPENMP})
+    {
+        for (const unsigned int nbThreads : {1u, 4u})
+        {
+            TaskScheduler::get().setNbThreads(nbThreads);
+            TaskScheduler::get().setBackend(backend);
+
+            std::vector<int> counts(1000, 0);
+            parallelFor(0, 1000, 16, [&](std::ptrdiff_t i) { ++counts[i]; });
+            BOOST_CHECK_EQUAL(std::accumulate(counts.begin(), counts.end(), 0), 1000);
+
+            BOOST_CHECK_THROW(parallelFor(0, 1000, 16,
+                                          [&](std::ptrdiff_t i) {
+                                              if (i == 500)
+                                                  throw std::runtime_error("loop error");
+                                          }),
+                              std::runtime_error);
+        }
+    }
+
+    TaskScheduler::get().setBackend(ETaskBackend::SCHEDULER);
+}
+
+BOOST_AUTO_TEST_CASE(TaskScheduler_backendString)
+{
+    BOOST_CHECK(ETaskBackend_stringToEnum("scheduler") == ETaskBackend::SCHEDULER);
+    BOOST_CHECK(ETaskBackend_stringToEnum("OpenMP") == ETaskBackend::OPENMP);
+    BOOST_CHECK_EQUAL(ETaskBackend_enumToString(ETaskBackend::OPENMP), "openmp");
+    BOOST_CHECK_THROW(ETaskBackend_stringToEnum("tbb"), std::out_of_range);
+}
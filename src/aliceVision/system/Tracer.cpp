@@ -0,0 +1,235 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "Tracer.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+namespace aliceVision {
+namespace system {
+
+namespace {
+
+// tracer clock origin
+const std::chrono::steady_clock::time_point tracerClockOrigin = std::chrono::steady_clock::now();
+
+// escape a string for a JSON value
+std::string jsonEscape(const std::string& str)
+{
+    std::string out;
+    out.reserve(str.size());
+
+    for (const char c : str)
+    {
+        switch (c)
+        {
+            case '"':
+                out += "\\\"";
+                break;
+            case '\\':
+                out += "\\\\";
+                break;
+            case '\n':
+                out += "\\n";
+                break;
+            case '\t':
+                out += "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20)
+                    out += ' ';
+                else
+                    out += c;
+        }
+    }
+    return out;
+}
+
+}  // namespace
+
+Tracer& Tracer::get()
+{
+    static Tracer instance;
+    return instance;
+}
+
+Tracer::~Tracer()
+{
+    // write the trace file at exit
+    if (!_filepath.empty())
+        exportChromeTrace(_filepath);
+}
+
+void Tracer::enable(const std::string& filepath, std::size_t bufferCapacity)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _filepath = filepath;
+        _bufferCapacity = std::max<std::size_t>(1, bufferCapacity);
+    }
+    _enabled.store(true, std::memory_order_relaxed);
+}
+
+void Tracer::disable() { _enabled.store(false, std::memory_order_relaxed); }
+
+std::int64_t Tracer::nowUs()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - tracerClockOrigin).count();
+}
+
+Tracer::Track& Tracer::createTrack(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    std::unique_ptr<Track> track = std::make_unique<Track>();
+    track->id = static_cast<int>(_tracks.size());
+    track->name = name;
+    track->zones.reserve(_bufferCapacity);
+
+    _tracks.push_back(std::move(track));
+    return *_tracks.back();
+}
+
+Tracer::Track& Tracer::getCurrentThreadTrack()
+{
+    // the tracks are never destroyed before the tracer, the pointer stays valid after clear()
+    thread_local Track* currentThreadTrack = nullptr;
+
+    if (currentThreadTrack == nullptr)
+    {
+        std::ostringstream oss;
+        oss << "thread " << std::this_thread::get_id();
+        currentThreadTrack = &createTrack(oss.str());
+    }
+    return *currentThreadTrack;
+}
+
+void Tracer::setCurrentThreadName(const std::string& name)
+{
+    Track& track = getCurrentThreadTrack();
+    std::lock_guard<std::mutex> lock(track.mutex);
+    track.name = name;
+}
+
+int Tracer::registerTrack(const std::string& name) { return createTrack(name).id; }
+
+void Tracer::addZone(Track& track, const char* name, const char* category, std::int64_t beginUs, std::int64_t endUs)
+{
+    const Zone zone{name, category, beginUs, std::max<std::int64_t>(0, endUs - beginUs)};
+
+    std::lock_guard<std::mutex> lock(track.mutex);
+
+    if (track.zones.size() < track.zones.capacity())
+    {
+        track.zones.push_back(zone);
+        return;
+    }
+
+    // ring buffer full, overwrite the oldest zone
+    track.zones.at(track.next) = zone;
+    track.next = (track.next + 1) % track.zones.size();
+    track.full = true;
+}
+
+void Tracer::addZone(const char* name, const char* category, std::int64_t beginUs, std::int64_t endUs)
+{
+    if (!isEnabled())
+        return;
+
+    addZone(getCurrentThreadTrack(), name, category, beginUs, endUs);
+}
+
+void Tracer::addTrackZone(int trackId, const char* name, const char* category, std::int64_t beginUs, std::int64_t endUs)
+{
+    if (!isEnabled())
+        return;
+
+    Track* track = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (trackId < 0 || trackId >= static_cast<int>(_tracks.size()))
+            return;
+        track = _tracks.at(trackId).get();
+    }
+    addZone(*track, name, category, beginUs, endUs);
+}
+
+std::size_t Tracer::getNbZones() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    std::size_t nbZones = 0;
+    for (const auto& track : _tracks)
+    {
+        std::lock_guard<std::mutex> trackLock(track->mutex);
+        nbZones += track->zones.size();
+    }
+    return nbZones;
+}
+
+void Tracer::clear()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    for (auto& track : _tracks)
+    {
+        std::lock_guard<std::mutex> trackLock(track->mutex);
+        track->zones.clear();
+        track->next = 0;
+        track->full = false;
+    }
+}
+
+bool Tracer::exportChromeTrace(const std::string& filepath) const
+{
+    std::ofstream file(filepath);
+
+    if (!file.is_open())
+        return false;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    bool first = true;
+    const auto separator = [&]() -> std::ostream& {
+        if (!first)
+            file << ",";
+        first = false;
+        return file << "\n";
+    };
+
+    for (const auto& track : _tracks)
+    {
+        std::lock_guard<std::mutex> trackLock(track->mutex);
+
+        // track name metadata
+        separator() << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << track->id << ",\"args\":{\"name\":\""
+                    << jsonEscape(track->name) << "\"}}";
+
+        // zones from the oldest to the newest
+        const std::size_t nbZones = track->zones.size();
+        const std::size_t oldest = track->full ? track->next : 0;
+
+        for (std::size_t i = 0; i < nbZones; ++i)
+        {
+            const Zone& zone = track->zones.at((oldest + i) % nbZones);
+
+            separator() << "{\"name\":\"" << jsonEscape(zone.name) << "\",\"cat\":\"" << jsonEscape(zone.category)
+                        << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << track->id << ",\"ts\":" << zone.beginUs << ",\"dur\":" << zone.durationUs << "}";
+        }
+    }
+
+    file << "\n]}\n";
+    return file.good();
+}
+
+}  // namespace system
+}  // namespace aliceVision
@@ -0,0 +1,191 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace aliceVision {
+namespace system {
+
+/**
+ * @brief Lightweight scoped tracing, exported as a Chrome trace JSON file (chrome://tracing, Perfetto).
+ *        Each thread records its zones in its own ring buffer, the oldest zones being overwritten when the buffer is full.
+ *        Tracks not bound to a CPU thread (e.g. GPU timelines) can be registered and filled explicitly.
+ * @note When disabled, a zone only costs an atomic load.
+ */
+class Tracer
+{
+  public:
+    /**
+     * @brief Get the process tracer.
+     * @return the tracer singleton
+     */
+    static Tracer& get();
+
+    // singleton, no copy constructor
+    Tracer(Tracer const&) = delete;
+
+    // singleton, no copy operator
+    void operator=(Tracer const&) = delete;
+
+    /**
+     * @brief Enable tracing.
+     * @param[in] filepath the Chrome trace JSON file written at exit (or empty to only export explicitly)
+     * @param[in] bufferCapacity the maximum number of zones kept per track
+     */
+    void enable(const std::string& filepath = "", std::size_t bufferCapacity = 1 << 16);
+
+    /**
+     * @brief Disable tracing, the recorded zones are kept.
+     */
+    void disable();
+
+    /**
+     * @return true if tracing is enabled
+     */
+    inline bool isEnabled() const { return _enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Get the current time of the tracer clock.
+     * @return elapsed time since the tracer creation (in microseconds)
+     */
+    static std::int64_t nowUs();
+
+    /**
+     * @brief Name the current thread track.
+     * @param[in] name the thread name
+     */
+    void setCurrentThreadName(const std::string& name);
+
+    /**
+     * @brief Register a track not bound to a CPU thread.
+     * @param[in] name the track name
+     * @return the track id
+     */
+    int registerTrack(const std::string& name);
+
+    /**
+     * @brief Record a zone in the current thread track.
+     * @param[in] name the zone name, must outlive the tracer (string literal)
+     * @param[in] category the zone category, must outlive the tracer (string literal)
+     * @param[in] beginUs the zone begin time (in microseconds)
+     * @param[in] endUs the zone end time (in microseconds)
+     */
+    void addZone(const char* name, const char* category, std::int64_t beginUs, std::int64_t endUs);
+
+    /**
+     * @brief Record a zone in the given track.
+     * @param[in] trackId the track id from registerTrack
+     * @param[in] name the zone name, must outlive the tracer (string literal)
+     * @param[in] category the zone category, must outlive the tracer (string literal)
+     * @param[in] beginUs the zone begin time (in microseconds)
+     * @param[in] endUs the zone end time (in microseconds)
+     */
+    void addTrackZone(int trackId, const char* name, const char* category, std::int64_t beginUs, std::int64_t endUs);
+
+    /**
+     * @brief Get the number of zones currently recorded in all tracks.
+     * @return number of zones
+     */
+    std::size_t getNbZones() const;
+
+    /**
+     * @brief Remove the recorded zones of all tracks.
+     */
+    void clear();
+
+    /**
+     * @brief Write the recorded zones in a Chrome trace JSON file.
+     * @param[in] filepath the output file path
+     * @return false if the file cannot be written
+     */
+    bool exportChromeTrace(const std::string& filepath) const;
+
+  private:
+    struct Zone
+    {
+        const char* name;
+        const char* category;
+        std::int64_t beginUs;
+        std::int64_t durationUs;
+    };
+
+    struct Track
+    {
+        int id;
+        std::string name;
+        std::vector<Zone> zones;   //< ring buffer
+        std::size_t next = 0;      //< next ring buffer position
+        bool full = false;         //< the ring buffer wrapped around
+        mutable std::mutex mutex;  //< protect the zones, written by the owner thread and read at export
+    };
+
+    Tracer() = default;
+    ~Tracer();
+
+    Track& getCurrentThreadTrack();
+    Track& createTrack(const std::string& name);
+    void addZone(Track& track, const char* name, const char* category, std::int64_t beginUs, std::int64_t endUs);
+
+    std::atomic<bool> _enabled{false};
+    std::size_t _bufferCapacity = 1 << 16;
+    std::string _filepath;
+    std::vector<std::unique_ptr<Track>> _tracks;
+    mutable std::mutex _mutex;  //< protect the tracks list and the export settings
+};
+
+/**
+ * @brief RAII zone recorded in the current thread track of the tracer.
+ */
+class TraceZone
+{
+  public:
+    /**
+     * @param[in] name the zone name (string literal)
+     * @param[in] category the zone category (string literal)
+     */
+    explicit TraceZone(const char* name, const char* category = "aliceVision")
+      : _name(name),
+        _category(category),
+        _beginUs(Tracer::get().isEnabled() ? Tracer::nowUs() : -1)
+    {}
+
+    ~TraceZone()
+    {
+        if (_beginUs >= 0)
+            Tracer::get().addZone(_name, _category, _beginUs, Tracer::nowUs());
+    }
+
+    // no copy constructor
+    TraceZone(TraceZone const&) = delete;
+
+    // no copy operator
+    void operator=(TraceZone const&) = delete;
+
+  private:
+    const char* _name;
+    const char* _category;
+    const std::int64_t _beginUs;
+};
+
+}  // namespace system
+}  // namespace aliceVision
+
+#define ALICEVISION_TRACE_CONCAT_IMPL(a, b) a##b
+#define ALICEVISION_TRACE_CONCAT(a, b) ALICEVISION_TRACE_CONCAT_IMPL(a, b)
+
+/// scoped zone of the current thread, the name must be a string literal
+#define ALICEVISION_TRACE_ZONE(name) ::aliceVision::system::TraceZone ALICEVISION_TRACE_CONCAT(traceZone_, __LINE__)(name)
+
+/// scoped zone of the current thread with a category, the name and the category must be string literals
+#define ALICEVISION_TRACE_ZONE_CAT(name, category) \
+    ::aliceVision::system::TraceZone ALICEVISION_TRACE_CONCAT(traceZone_, __LINE__)(name, category)
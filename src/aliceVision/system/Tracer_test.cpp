@@ -0,0 +1,130 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/system/Tracer.hpp>
+
+#define BOOST_TEST_MODULE Tracer
+
+#include <boost/test/unit_test.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/json_parser.hpp>
+
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace aliceVision::system;
+
+BOOST_AUTO_TEST_CASE(Tracer_disabled)
+{
+    Tracer& tracer = Tracer::get();
+    tracer.disable();
+    tracer.clear();
+
+    {
+        ALICEVISION_TRACE_ZONE("disabled zone");
+    }
+
+    BOOST_CHECK_EQUAL(tracer.getNbZones(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(Tracer_threadsAndExport)
+{
+    Tracer& tracer = Tracer::get();
+    tracer.enable();
+    tracer.clear();
+
+    const int nbThreads = 4;
+    const int nbZonesPerThread = 10;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < nbThreads; ++t)
+    {
+        threads.emplace_back([&]() {
+            for (int i = 0; i < nbZonesPerThread; ++i)
+            {
+                ALICEVISION_TRACE_ZONE_CAT("outer \"zone\"", "test");
+                ALICEVISION_TRACE_ZONE("inner zone");
+            }
+        });
+    }
+
+    for (auto& thread : threads)
+        thread.join();
+
+    const int gpuTrack = tracer.registerTrack("CUDA device 0");
+    tracer.addTrackZone(gpuTrack, "kernel", "cuda", 10, 20);
+
+    BOOST_CHECK_EQUAL(tracer.getNbZones(), nbThreads * nbZonesPerThread * 2 + 1);
+
+    const std::string filepath = (std::filesystem::temp_directory_path() / "aliceVision_tracer_test.json").string();
+    BOOST_REQUIRE(tracer.exportChromeTrace(filepath));
+
+    boost::property_tree::ptree tree;
+    boost::property_tree::read_json(filepath, tree);
+
+    int nbCompleteZones = 0;
+    int nbKernelZones = 0;
+    for (const auto& event : tree.get_child("traceEvents"))
+    {
+        if (event.second.get<std::string>("ph") != "X")
+            continue;
+
+        ++nbCompleteZones;
+        BOOST_CHECK_GE(event.second.get<std::int64_t>("dur"), 0);
+
+        if (event.second.get<std::string>("name") == "kernel")
+        {
+            ++nbKernelZones;
+            BOOST_CHECK_EQUAL(event.second.get<std::int64_t>("ts"), 10);
+            BOOST_CHECK_EQUAL(event.second.get<std::int64_t>("dur"), 10);
+        }
+    }
+
+    BOOST_CHECK_EQUAL(nbCompleteZones, nbThreads * nbZonesPerThread * 2 + 1);
+    BOOST_CHECK_EQUAL(nbKernelZones, 1);
+
+    std::filesystem::remove(filepath);
+    tracer.disable();
+}
+
+BOOST_AUTO_TEST_CASE(Tracer_ringBuffer)
+{
+    Tracer& tracer = Tracer::get();
+    tracer.enable("", 8);
+    tracer.clear();
+
+    // the capacity only applies to the tracks created after enable
+    const int track = tracer.registerTrack("ring buffer");
+    const std::size_t nbZonesBefore = tracer.getNbZones();
+
+    for (int i = 0; i < 20; ++i)
+        tracer.addTrackZone(track, "zone", "test", i, i + 1);
+
+    BOOST_CHECK_EQUAL(tracer.getNbZones() - nbZonesBefore, 8);
+
+    const std::string filepath = (std::filesystem::temp_directory_path() / "aliceVision_tracer_ring_test.json").string();
+    BOOST_REQUIRE(tracer.exportChromeTrace(filepath));
+
+    boost::property_tree::ptree tree;
+    boost::property_tree::read_json(filepath, tree);
+
+    // the oldest zones are overwritten, the remaining ones are exported in order
+    std::vector<std::int64_t> timestamps;
+    for (const auto& event : tree.get_child("traceEvents"))
+    {
+        if (event.second.get<std::string>("ph") == "X" && event.second.get<int>("tid") == track)
+            timestamps.push_back(event.second.get<std::int64_t>("ts"));
+    }
+
+    BOOST_REQUIRE_EQUAL(timestamps.size(), 8);
+    for (std::size_t i = 0; i < timestamps.size(); ++i)
+        BOOST_CHECK_EQUAL(timestamps.at(i), 12 + i);
+
+    std::filesystem::remove(filepath);
+    tracer.disable();
+}
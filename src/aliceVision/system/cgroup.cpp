@@ -0,0 +1,240 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "cgroup.hpp"
+
+#include <aliceVision/system/system.hpp>
+
+#if defined(__LINUX__)
+    #include <fstream>
+    #include <stdexcept>
+    #include <vector>
+#endif
+
+namespace aliceVision {
+namespace system {
+
+#if defined(__LINUX__)
+namespace {
+
+/// cgroup v1 reports "unlimited" as the largest page-aligned 64-bit value
+constexpr unsigned long long cgroupV1Unlimited = 1ull << 62;
+
+/**
+ * @brief Get a control group directory and all its parents, from the leaf to the mount point.
+ * @param[in] mountPoint the cgroup hierarchy mount point
+ * @param[in] cgroupPath the control group path in the hierarchy (e.g. "/kubepods/pod1234")
+ * @return the directories
+ */
+std::vector<std::string> getCgroupDirectories(const std::string& mountPoint, std::string cgroupPath)
+{
+    std::vector<std::string> directories;
+
+    while (!cgroupPath.empty() && cgroupPath != "/")
+    {
+        directories.push_back(mountPoint + cgroupPath);
+        cgroupPath = cgroupPath.substr(0, cgroupPath.find_last_of('/'));
+    }
+    // inside a container with its own cgroup namespace, the mount point is the container control group
+    directories.push_back(mountPoint);
+    return directories;
+}
+
+/**
+ * @brief Read the first tokens of a cgroup file.
+ * @param[in] filepath the file path
+ * @param[out] first the first token
+ * @param[out] second the second token (if any)
+ * @return true if the file contains at least one token
+ */
+bool readCgroupFile(const std::string& filepath, std::string& first, std::string* second = nullptr)
+{
+    std::ifstream file(filepath);
+    if (!(file >> first))
+        return false;
+    if (second && !(file >> *second))
+        second->clear();
+    return true;
+}
+
+/**
+ * @brief Read a memory value of a cgroup file.
+ * @param[in] filepath the file path
+ * @param[out] value the memory value in bytes, 0 if unlimited
+ * @return true if the file exists
+ */
+bool readCgroupMemory(const std::string& filepath, unsigned long long& value)
+{
+    std::string token;
+    if (!readCgroupFile(filepath, token))
+        return false;
+
+    value = 0;
+    if (token != "max")
+    {
+        try
+        {
+            value = std::stoull(token);
+        }
+        catch (const std::exception&)
+        {
+            return false;
+        }
+        if (value >= cgroupV1Unlimited)
+            value = 0;
+    }
+    return true;
+}
+
+/**
+ * @brief Read an entry of a cgroup memory.stat file.
+ * @param[in] filepath the memory.stat file path
+ * @param[in] key the entry name
+ * @return the entry value, 0 if not found
+ */
+unsigned long long readCgroupMemoryStat(const std::string& filepath, const std::string& key)
+{
+    std::ifstream file(filepath);
+    std::string name;
+    unsigned long long value;
+    while (file >> name >> value)
+    {
+        if (name == key)
+            return value;
+    }
+    return 0;
+}
+
+/// keep the most restrictive of two limits, 0 meaning unlimited
+template<typename T>
+T minLimit(T a, T b)
+{
+    if (a <= 0)
+        return b;
+    if (b <= 0)
+        return a;
+    return (a < b) ? a : b;
+}
+
+}  // namespace
+#endif
+
+CgroupLimits getCgroupLimits(const std::string& cgroupRoot, const std::string& procCgroupFile)
+{
+    CgroupLimits limits;
+
+#if defined(__LINUX__)
+    // lines of "<hierarchy id>:<controllers>:<path>", hierarchy 0 with no controller for cgroup v2
+    std::string v2Path;
+    std::string memoryPath;
+    std::string cpuPath;
+    bool hasV2 = false;
+    {
+        std::ifstream file(procCgroupFile);
+        std::string line;
+        while (std::getline(file, line))
+        {
+            const std::size_t first = line.find(':');
+            const std::size_t second = line.find(':', first + 1);
+            if (first == std::string::npos || second == std::string::npos)
+                continue;
+
+            const std::string controllers = "," + line.substr(first + 1, second - first - 1) + ",";
+            const std::string path = line.substr(second + 1);
+
+            if (controllers == ",,")
+            {
+                v2Path = path;
+                hasV2 = true;
+            }
+            if (controllers.find(",memory,") != std::string::npos)
+                memoryPath = path;
+            if (controllers.find(",cpu,") != std::string::npos)
+                cpuPath = path;
+        }
+    }
+
+    bool hasUsage = false;
+    unsigned long long memoryLimit = 0;
+    unsigned long long memoryUsage = 0;
+    double cpuQuota = 0.0;
+
+    if (hasV2 && memoryPath.empty() && cpuPath.empty())
+    {
+        // cgroup v2 unified hierarchy
+        for (const std::string& directory : getCgroupDirectories(cgroupRoot, v2Path))
+        {
+            unsigned long long value;
+            if (readCgroupMemory(directory + "/memory.max", value))
+                memoryLimit = minLimit(memoryLimit, value);
+
+            if (!hasUsage && readCgroupMemory(directory + "/memory.current", memoryUsage))
+            {
+                // the page cache is reclaimed before an out-of-memory kill
+                const unsigned long long inactiveFile = readCgroupMemoryStat(directory + "/memory.stat", "inactive_file");
+                memoryUsage = (memoryUsage > inactiveFile) ? memoryUsage - inactiveFile : 0;
+                hasUsage = true;
+            }
+
+            // "<quota> <period>", "max" if unlimited
+            std::string quota, period;
+            if (readCgroupFile(directory + "/cpu.max", quota, &period) && quota != "max" && !period.empty())
+            {
+                try
+                {
+                    cpuQuota = minLimit(cpuQuota, std::stod(quota) / std::stod(period));
+                }
+                catch (const std::exception&)
+                {}
+            }
+        }
+    }
+    else
+    {
+        // cgroup v1, one hierarchy per controller
+        for (const std::string& directory : getCgroupDirectories(cgroupRoot + "/memory", memoryPath))
+        {
+            unsigned long long value;
+            if (readCgroupMemory(directory + "/memory.limit_in_bytes", value))
+                memoryLimit = minLimit(memoryLimit, value);
+
+            if (!hasUsage && readCgroupMemory(directory + "/memory.usage_in_bytes", memoryUsage))
+            {
+                const unsigned long long inactiveFile = readCgroupMemoryStat(directory + "/memory.stat", "total_inactive_file");
+                memoryUsage = (memoryUsage > inactiveFile) ? memoryUsage - inactiveFile : 0;
+                hasUsage = true;
+            }
+        }
+
+        for (const std::string& directory : getCgroupDirectories(cgroupRoot + "/cpu", cpuPath))
+        {
+            // quota is -1 if unlimited
+            std::string quota, period;
+            if (readCgroupFile(directory + "/cpu.cfs_quota_us", quota) && readCgroupFile(directory + "/cpu.cfs_period_us", period))
+            {
+                try
+                {
+                    const double q = std::stod(quota);
+                    const double p = std::stod(period);
+                    if (q > 0.0 && p > 0.0)
+                        cpuQuota = minLimit(cpuQuota, q / p);
+                }
+                catch (const std::exception&)
+                {}
+            }
+        }
+    }
+
+    limits.cpuQuota = cpuQuota;
+    limits.memoryLimit = static_cast<std::size_t>(memoryLimit);
+    limits.memoryUsage = static_cast<std::size_t>(memoryUsage);
+#endif
+
+    return limits;
+}
+
+}  // namespace system
+}  // namespace aliceVision
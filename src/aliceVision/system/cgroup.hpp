@@ -0,0 +1,39 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace aliceVision {
+namespace system {
+
+/**
+ * @brief CPU and memory limits of the control group of the process (e.g. container limits).
+ */
+struct CgroupLimits
+{
+    /// CPU bandwidth quota in number of CPUs, 0 if unlimited
+    double cpuQuota{0.0};
+    /// memory limit in bytes, 0 if unlimited
+    std::size_t memoryLimit{0};
+    /// memory used by the control group in bytes, without the reclaimable page cache
+    std::size_t memoryUsage{0};
+};
+
+/**
+ * @brief Get the limits of the control group of the process, from cgroup v2 or v1.
+ *        The most restrictive limit of the control group and its parents is used.
+ * @note Only available on Linux, no limit on the other systems.
+ * @param[in] cgroupRoot the cgroup filesystem mount point
+ * @param[in] procCgroupFile the file listing the control groups of the process
+ * @return the control group limits
+ */
+CgroupLimits getCgroupLimits(const std::string& cgroupRoot = "/sys/fs/cgroup", const std::string& procCgroupFile = "/proc/self/cgroup");
+
+}  // namespace system
+}  // namespace aliceVision
@@ -0,0 +1,108 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/system/cgroup.hpp>
+#include <aliceVision/system/cpu.hpp>
+#include <aliceVision/system/MemoryInfo.hpp>
+
+#define BOOST_TEST_MODULE cgroup
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+using namespace aliceVision::system;
+
+namespace {
+
+void writeFile(const std::filesystem::path& filepath, const std::string& content)
+{
+    std::filesystem::create_directories(filepath.parent_path());
+    std::ofstream file(filepath.string());
+    file << content;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(cgroup_v2)
+{
+    const std::filesystem::path root = std::filesystem::temp_directory_path() / "aliceVision_cgroup_v2";
+    std::filesystem::remove_all(root);
+
+    writeFile(root / "proc_cgroup", "0::/kubepods/pod1\n");
+
+    // the parent limit on memory is the most restrictive one
+    writeFile(root / "fs/kubepods/memory.max", "1073741824\n");
+    writeFile(root / "fs/kubepods/cpu.max", "max 100000\n");
+    writeFile(root / "fs/kubepods/pod1/memory.max", "2147483648\n");
+    writeFile(root / "fs/kubepods/pod1/memory.current", "536870912\n");
+    writeFile(root / "fs/kubepods/pod1/memory.stat", "anon 268435456\ninactive_file 134217728\n");
+    writeFile(root / "fs/kubepods/pod1/cpu.max", "250000 100000\n");
+
+    const CgroupLimits limits = getCgroupLimits((root / "fs").string(), (root / "proc_cgroup").string());
+
+    BOOST_CHECK_EQUAL(limits.memoryLimit, 1073741824);
+    BOOST_CHECK_EQUAL(limits.memoryUsage, 536870912 - 134217728);
+    BOOST_CHECK_CLOSE(limits.cpuQuota, 2.5, 1e-6);
+
+    std::filesystem::remove_all(root);
+}
+
+BOOST_AUTO_TEST_CASE(cgroup_v1)
+{
+    const std::filesystem::path root = std::filesystem::temp_directory_path() / "aliceVision_cgroup_v1";
+    std::filesystem::remove_all(root);
+
+    writeFile(root / "proc_cgroup", "4:memory:/docker/abc\n3:cpu,cpuacct:/docker/abc\n0::/\n");
+
+    // unlimited values
+    writeFile(root / "fs/memory/memory.limit_in_bytes", "9223372036854771712\n");
+    writeFile(root / "fs/cpu/cpu.cfs_quota_us", "-1\n");
+    writeFile(root / "fs/cpu/cpu.cfs_period_us", "100000\n");
+
+    {
+        const CgroupLimits limits = getCgroupLimits((root / "fs").string(), (root / "proc_cgroup").string());
+        BOOST_CHECK_EQUAL(limits.memoryLimit, 0);
+        BOOST_CHECK_EQUAL(limits.cpuQuota, 0.0);
+    }
+
+    writeFile(root / "fs/memory/docker/abc/memory.limit_in_bytes", "4294967296\n");
+    writeFile(root / "fs/memory/docker/abc/memory.usage_in_bytes", "1073741824\n");
+    writeFile(root / "fs/memory/docker/abc/memory.stat", "cache 0\ntotal_inactive_file 73741824\n");
+    writeFile(root / "fs/cpu/docker/abc/cpu.cfs_quota_us", "400000\n");
+    writeFile(root / "fs/cpu/docker/abc/cpu.cfs_period_us", "100000\n");
+
+    {
+        const CgroupLimits limits = getCgroupLimits((root / "fs").string(), (root / "proc_cgroup").string());
+        BOOST_CHECK_EQUAL(limits.memoryLimit, 4294967296);
+        BOOST_CHECK_EQUAL(limits.memoryUsage, 1000000000);
+        BOOST_CHECK_CLOSE(limits.cpuQuota, 4.0, 1e-6);
+    }
+
+    std::filesystem::remove_all(root);
+}
+
+BOOST_AUTO_TEST_CASE(cgroup_noCgroup)
+{
+    const CgroupLimits limits = getCgroupLimits("/nonexistent_cgroup_root", "/nonexistent_proc_cgroup");
+
+    BOOST_CHECK_EQUAL(limits.memoryLimit, 0);
+    BOOST_CHECK_EQUAL(limits.memoryUsage, 0);
+    BOOST_CHECK_EQUAL(limits.cpuQuota, 0.0);
+}
+
+BOOST_AUTO_TEST_CASE(cgroup_processLimits)
+{
+    // the process limits never exceed the host resources
+    const MemoryInfo memoryInfo = getMemoryInfo();
+    BOOST_CHECK_LE(memoryInfo.availableRam, memoryInfo.totalRam);
+
+    BOOST_CHECK_GE(get_available_cpus(), 1);
+    BOOST_CHECK_LE(get_available_cpus(), std::max(get_total_cpus(), 1));
+}
@@ -5,6 +5,7 @@
 // You can obtain one at https://mozilla.org/MPL/2.0/.
 
 #include "cpu.hpp"
+#include "cgroup.hpp"
 #include "system.hpp"
 
 #ifdef __WINDOWS__
@@ -171,3 +172,197 @@ int get_total_cpus(void) { return 1; }
 }  // namespace aliceVision
 
 #endif /* GET_TOTAL_CPUS_DEFINED */
+
+#if defined linux || defined __linux__
+    #include <sched.h>
+    #include <algorithm>
+    #include <cmath>
+#endif
+
+namespace aliceVision {
+namespace system {
+
+int get_available_cpus()
+{
+    int nbCpus = get_total_cpus();
+
+#if defined linux || defined __linux__
+    // CPUs of the process affinity mask (e.g. taskset, cpuset cgroup)
+    cpu_set_t processCpus;
+    CPU_ZERO(&processCpus);
+    if (sched_getaffinity(0, sizeof(processCpus), &processCpus) == 0)
+        nbCpus = std::min(nbCpus, CPU_COUNT(&processCpus));
+
+    // CPU bandwidth quota of the cgroup (e.g. container CPU limit)
+    const double cpuQuota = getCgroupLimits().cpuQuota;
+    if (cpuQuota > 0.0)
+        nbCpus = std::min(nbCpus, static_cast<int>(std::ceil(cpuQuota)));
+#endif
+
+    return (nbCpus > 1) ? nbCpus : 1;
+}
+
+}  // namespace system
+}  // namespace aliceVision
+
+#include "Logger.hpp"
+
+#include <boost/algorithm/string/case_conv.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+
+#if defined(ALICEVISION_SIMD_X86)
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+        #include <immintrin.h>
+    #else
+        #include <cpuid.h>
+    #endif
+#endif
+
+namespace aliceVision {
+namespace system {
+
+std::string ESimdLevel_enumToString(ESimdLevel simdLevel)
+{
+    switch (simdLevel)
+    {
+        case ESimdLevel::Generic:
+            return "generic";
+        case ESimdLevel::SSE2:
+            return "sse2";
+        case ESimdLevel::AVX2:
+            return "avx2";
+        case ESimdLevel::AVX512:
+            return "avx512";
+    }
+    throw std::out_of_range("Invalid SIMD level enum");
+}
+
+ESimdLevel ESimdLevel_stringToEnum(std::string simdLevel)
+{
+    boost::to_lower(simdLevel);
+
+    if (simdLevel == "generic")
+        return ESimdLevel::Generic;
+    if (simdLevel == "sse2")
+        return ESimdLevel::SSE2;
+    if (simdLevel == "avx2")
+        return ESimdLevel::AVX2;
+    if (simdLevel == "avx512")
+        return ESimdLevel::AVX512;
+
+    throw std::out_of_range("Invalid SIMD level : '" + simdLevel + "'");
+}
+
+std::ostream& operator<<(std::ostream& os, ESimdLevel simdLevel)
+{
+    os << ESimdLevel_enumToString(simdLevel);
+    return os;
+}
+
+#if defined(ALICEVISION_SIMD_X86)
+namespace {
+
+/// registers eax, ebx, ecx, edx of a cpuid leaf, zero if the leaf is not supported
+struct CpuidRegisters
+{
+    unsigned int eax = 0;
+    unsigned int ebx = 0;
+    unsigned int ecx = 0;
+    unsigned int edx = 0;
+};
+
+CpuidRegisters cpuid(unsigned int leaf, unsigned int subleaf)
+{
+    CpuidRegisters registers;
+    #if defined(_MSC_VER)
+    int info[4];
+    __cpuidex(info, static_cast<int>(leaf), static_cast<int>(subleaf));
+    registers.eax = static_cast<unsigned int>(info[0]);
+    registers.ebx = static_cast<unsigned int>(info[1]);
+    registers.ecx = static_cast<unsigned int>(info[2]);
+    registers.edx = static_cast<unsigned int>(info[3]);
+    #else
+    if (!__get_cpuid_count(leaf, subleaf, &registers.eax, &registers.ebx, &registers.ecx, &registers.edx))
+        return CpuidRegisters();
+    #endif
+    return registers;
+}
+
+/// extended control register XCR0: the register states saved by the OS on context switches
+unsigned long long xgetbv0()
+{
+    #if defined(_MSC_VER)
+    return _xgetbv(0);
+    #else
+    unsigned int eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<unsigned long long>(edx) << 32) | eax;
+    #endif
+}
+
+bool hasBit(unsigned int value, int bit) { return (value >> bit) & 1u; }
+
+}  // namespace
+#endif
+
+ESimdLevel detectSimdLevel()
+{
+#if defined(ALICEVISION_SIMD_X86)
+    const unsigned int maxLeaf = cpuid(0, 0).eax;
+    if (maxLeaf < 1)
+        return ESimdLevel::Generic;
+
+    const CpuidRegisters leaf1 = cpuid(1, 0);
+    if (!hasBit(leaf1.edx, 26))
+        return ESimdLevel::Generic;
+
+    // the AVX registers must be enabled by the OS (OSXSAVE, then YMM and XMM states in XCR0)
+    const bool osxsave = hasBit(leaf1.ecx, 27);
+    const unsigned long long xcr0 = osxsave ? xgetbv0() : 0;
+    const bool osAvx = (xcr0 & 0x6) == 0x6;
+    // and the AVX-512 opmask and ZMM states
+    const bool osAvx512 = osAvx && (xcr0 & 0xE0) == 0xE0;
+
+    const CpuidRegisters leaf7 = (maxLeaf >= 7) ? cpuid(7, 0) : CpuidRegisters();
+
+    const bool avx2 = osAvx && hasBit(leaf1.ecx, 28) && hasBit(leaf1.ecx, 12) && hasBit(leaf1.ecx, 23) && hasBit(leaf7.ebx, 5);
+    if (!avx2)
+        return ESimdLevel::SSE2;
+
+    const bool avx512 = osAvx512 && hasBit(leaf7.ebx, 16) && hasBit(leaf7.ebx, 30) && hasBit(leaf7.ebx, 31);
+    return avx512 ? ESimdLevel::AVX512 : ESimdLevel::AVX2;
+#else
+    return ESimdLevel::Generic;
+#endif
+}
+
+ESimdLevel getSimdLevel()
+{
+    static const ESimdLevel simdLevel = [] {
+        ESimdLevel level = detectSimdLevel();
+
+        const char* envLevel = std::getenv("ALICEVISION_SIMD_LEVEL");
+        if (envLevel != nullptr)
+        {
+            try
+            {
+                level = std::min(level, ESimdLevel_stringToEnum(envLevel));
+            }
+            catch (const std::out_of_range& e)
+            {
+                ALICEVISION_LOG_WARNING("ALICEVISION_SIMD_LEVEL is ignored: " << e.what());
+            }
+        }
+
+        ALICEVISION_LOG_DEBUG("SIMD level of the vectorized kernels: " << level);
+        return level;
+    }();
+    return simdLevel;
+}
+
+}  // namespace system
+}  // namespace aliceVision
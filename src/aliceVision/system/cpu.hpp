@@ -6,6 +6,26 @@
 
 #pragma once
 
+#include <ostream>
+#include <string>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    /// The SIMD kernels dispatched at runtime on the CPU features are only available on x86
+    #define ALICEVISION_SIMD_X86
+#endif
+
+#if defined(ALICEVISION_SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+    /// Compile a function for the instruction set of a SIMD level, independently of the build target
+    #define ALICEVISION_TARGET_SSE2 __attribute__((target("sse2")))
+    #define ALICEVISION_TARGET_AVX2 __attribute__((target("avx2,fma,popcnt")))
+    #define ALICEVISION_TARGET_AVX512 __attribute__((target("avx512f,avx512bw,avx512vl,avx2,fma,popcnt")))
+#else
+    // MSVC accepts the intrinsics of all the instruction sets without specific flags
+    #define ALICEVISION_TARGET_SSE2
+    #define ALICEVISION_TARGET_AVX2
+    #define ALICEVISION_TARGET_AVX512
+#endif
+
 namespace aliceVision {
 namespace system {
 
@@ -22,5 +42,74 @@ int cpu_clock_by_os();
  */
 int get_total_cpus();
 
+/**
+ * @brief Returns the number of CPUs the process can use.
+ *        Bounded by the process affinity and the cgroup CPU quota (e.g. container limits) on Linux.
+ */
+int get_available_cpus();
+
+/**
+ * @brief SIMD instruction sets of the vectorized kernels, from the lowest to the highest.
+ */
+enum class ESimdLevel
+{
+    /// no explicit SIMD instructions
+    Generic,
+    SSE2,
+    /// AVX2, FMA and POPCNT
+    AVX2,
+    /// AVX-512 F, BW and VL
+    AVX512
+};
+
+/**
+ * @brief convert an enum ESimdLevel to its corresponding string
+ * @param[in] simdLevel The SIMD level.
+ * @return the string corresponding to the SIMD level.
+ */
+std::string ESimdLevel_enumToString(ESimdLevel simdLevel);
+
+/**
+ * @brief convert a string to its corresponding enum ESimdLevel
+ * @param[in] simdLevel the string with the SIMD level
+ * @return the corresponding ESimdLevel
+ */
+ESimdLevel ESimdLevel_stringToEnum(std::string simdLevel);
+
+std::ostream& operator<<(std::ostream& os, ESimdLevel simdLevel);
+
+/**
+ * @brief Detect the highest SIMD level supported by the CPU and enabled by the OS (saved AVX registers).
+ * @return the detected SIMD level, Generic on other architectures than x86
+ */
+ESimdLevel detectSimdLevel();
+
+/**
+ * @brief Get the SIMD level of the vectorized kernels, detected once.
+ *        The ALICEVISION_SIMD_LEVEL environment variable (generic, sse2, avx2 or avx512) caps the detected level,
+ *        e.g. to compare the results or the performance of the kernels.
+ * @return the SIMD level used by the dispatched kernels
+ */
+ESimdLevel getSimdLevel();
+
+/**
+ * @brief Select the implementation of a kernel for a SIMD level.
+ * @param[in] simdLevel the highest SIMD level to use (detected with getSimdLevel)
+ * @param[in] generic the implementation without explicit SIMD instructions, always available
+ * @param[in] sse2, avx2, avx512 the implementations for each SIMD level, nullptr if there is none
+ * @return the implementation of the highest level available, lower or equal to simdLevel
+ */
+template<typename Function>
+Function* selectSimdImplementation(ESimdLevel simdLevel, Function* generic, Function* sse2, Function* avx2, Function* avx512)
+{
+    if (simdLevel >= ESimdLevel::AVX512 && avx512 != nullptr)
+        return avx512;
+    if (simdLevel >= ESimdLevel::AVX2 && avx2 != nullptr)
+        return avx2;
+    if (simdLevel >= ESimdLevel::SSE2 && sse2 != nullptr)
+        return sse2;
+    return generic;
+}
+
 }  // namespace system
 }  // namespace aliceVision
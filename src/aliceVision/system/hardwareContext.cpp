@@ -1,7 +1,9 @@
 #include "hardwareContext.hpp"
 
+#include "cgroup.hpp"
 #include "cpu.hpp"
 #include "MemoryInfo.hpp"
+#include "numa.hpp"
 #include <aliceVision/alicevision_omp.hpp>
 
 namespace aliceVision {
@@ -12,6 +14,11 @@ void HardwareContext::displayHardware()
 
     std::cout << "\tDetected core count : " << system::get_total_cpus() << std::endl;
 
+    if (system::get_available_cpus() < system::get_total_cpus())
+    {
+        std::cout << "\tAvailable core count (affinity, cgroup quota) : " << system::get_available_cpus() << std::endl;
+    }
+
     if (_maxUserCoresAvailable < std::numeric_limits<unsigned int>::max())
     {
         std::cout << "\tUser upper limit on core count : " << _maxUserCoresAvailable << std::endl;
@@ -19,10 +26,24 @@ void HardwareContext::displayHardware()
 
     std::cout << "\tOpenMP will use " << omp_get_max_threads() << " cores" << std::endl;
 
+    std::cout << "\tSIMD level of the vectorized kernels : " << system::getSimdLevel() << std::endl;
+
+    std::cout << "\tDetected NUMA node count : " << system::getNumaNodesCpus().size() << std::endl;
+
     auto meminfo = system::getMemoryInfo();
 
     std::cout << "\tDetected available memory : " << meminfo.availableRam / (1024 * 1024) << " Mo" << std::endl;
 
+    const system::CgroupLimits cgroupLimits = system::getCgroupLimits();
+    if (cgroupLimits.memoryLimit > 0)
+    {
+        std::cout << "\tContainer memory limit : " << cgroupLimits.memoryLimit / (1024 * 1024) << " Mo" << std::endl;
+    }
+    if (cgroupLimits.cpuQuota > 0.0)
+    {
+        std::cout << "\tContainer CPU quota : " << cgroupLimits.cpuQuota << " cores" << std::endl;
+    }
+
     if (_maxUserMemoryAvailable < std::numeric_limits<size_t>::max())
     {
         std::cout << "\tUser upper limit on memory available : " << _maxUserMemoryAvailable / (1024 * 1024) << " Mo" << std::endl;
@@ -33,8 +54,8 @@ void HardwareContext::displayHardware()
 
 unsigned int HardwareContext::getMaxThreads() const
 {
-    // Get hardware limit on threads
-    unsigned int count = system::get_total_cpus();
+    // Get hardware limit on threads (bounded by the process affinity and the cgroup CPU quota)
+    unsigned int count = system::get_available_cpus();
 
     // Get User max threads
     if (count > _maxUserCoresAvailable)
@@ -51,6 +72,14 @@ unsigned int HardwareContext::getMaxThreads() const
     return count;
 }
 
+bool HardwareContext::bindThreadsToNumaNodes() const
+{
+    if (!_numaAware)
+        return false;
+
+    return system::bindOpenMPThreadsToNumaNodes(static_cast<int>(getMaxThreads()));
+}
+
 size_t HardwareContext::getMaxMemory() const
 {
     auto meminfo = system::getMemoryInfo();
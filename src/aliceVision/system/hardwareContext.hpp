@@ -26,6 +26,10 @@ class HardwareContext
 
     void setUserCoresLimit(unsigned int coresLimit) { _limitUserCores = coresLimit; }
 
+    bool isNumaAware() const { return _numaAware; }
+
+    void setNumaAware(bool numaAware) { _numaAware = numaAware; }
+
     unsigned int getMaxThreads() const;
 
     /**
@@ -34,6 +38,13 @@ class HardwareContext
      */
     size_t getMaxMemory() const;
 
+    /**
+     * @brief Bind the OpenMP threads to the NUMA nodes (if the NUMA-aware mode is enabled)
+     * @see system::bindOpenMPThreadsToNumaNodes
+     * @return true if the threads have been bound
+     */
+    bool bindThreadsToNumaNodes() const;
+
   private:
     /**
      * @brief This is the maximum memory available
@@ -54,6 +65,12 @@ class HardwareContext
      * The value will only be used if less than the _maxUserCoresAvailable value
      */
     unsigned int _limitUserCores = std::numeric_limits<unsigned int>::max();
+
+    /**
+     * @brief Bind the threads to the NUMA nodes
+     * On multi-socket systems, keeps the threads and the memory they first touch on the same node
+     */
+    bool _numaAware = false;
 };
 
 }  // namespace aliceVision
@@ -14,27 +14,40 @@
  * To use this wrapper you need to change your source file containing \c main() as such:
  * 1. Include this header
  * 2. Rename \c main() to \c aliceVision_main()
+ *
+ * The programs can also run many jobs in one process, with the \c --batch argument (see BatchMode.hpp).
  */
 
+#include "BatchMode.hpp"
 #include "Logger.hpp"
+#include "ProgressReport.hpp"
+#include "ResourceReport.hpp"
 
+#include <cstdlib>
+#include <iostream>
 #include <stdexcept>
+#include <string>
 
 /**
  * @brief Name of the application entry function, replacing \c main().
  */
 int aliceVision_main(int argc, char* argv[]);
 
-/* Implementation of the unique main() entry point.
- * This method will call aliceVision_main() and, in case of any exception not
- * handled there, catch those and log the error message.
+namespace {
+
+/* Run aliceVision_main() once.
+ * In case of any exception not handled there, catch those and log the error message.
  * On Windows, unhandled exceptions abort the program with the cause hard to
- * find out, something this main() function avoids. */
-int main(int argc, char* argv[])
+ * find out, something this function avoids.
+ * The resource report (if enabled by the program options) is written at the end of the run. */
+int runAliceVisionMain(int argc, char* argv[])
 {
+    aliceVision::system::ResourceReport::get().setCommandLine(argc, argv);
+
+    int exitCode = EXIT_FAILURE;
     try
     {
-        return aliceVision_main(argc, argv);
+        exitCode = aliceVision_main(argc, argv);
     }
     catch (const std::exception& e)
     {
@@ -44,5 +57,28 @@ int main(int argc, char* argv[])
     {
         ALICEVISION_LOG_FATAL("Unknown exception");
     }
-    return EXIT_FAILURE;
+
+    aliceVision::system::ResourceReport::get().write(exitCode);
+    return exitCode;
+}
+
+}  // namespace
+
+/* Implementation of the unique main() entry point.
+ * With the single argument --batch, the runs are read from the standard input
+ * and executed one after the other in this process (see system/BatchMode.hpp). */
+int main(int argc, char* argv[])
+{
+    if (argc == 2 && std::string(argv[1]) == aliceVision::system::batchModeArgument)
+    {
+        return aliceVision::system::runBatch(argv[0], std::cin, std::cout, [](int jobArgc, char* jobArgv[]) {
+            const int exitCode = runAliceVisionMain(jobArgc, jobArgv);
+            // the next job enables its own reports
+            aliceVision::system::ResourceReport::get().reset();
+            aliceVision::system::ProgressReport::get().reset();
+            return exitCode;
+        });
+    }
+
+    return runAliceVisionMain(argc, argv);
 }
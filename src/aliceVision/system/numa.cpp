@@ -0,0 +1,153 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "numa.hpp"
+
+#include <aliceVision/system/system.hpp>
+#include <aliceVision/system/Logger.hpp>
+#include <aliceVision/system/cpu.hpp>
+#include <aliceVision/alicevision_omp.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+
+#if defined(__LINUX__)
+    #include <sched.h>
+    #include <fstream>
+    #include <sstream>
+#endif
+
+namespace aliceVision {
+namespace system {
+
+#if defined(__LINUX__)
+namespace {
+
+/**
+ * @brief Parse a Linux CPU or node list (e.g. "0-15,32-47").
+ * @param[in] cpuList the list string
+ * @return the ids
+ */
+std::vector<int> parseCpuList(const std::string& cpuList)
+{
+    std::vector<int> cpus;
+    std::stringstream ss(cpuList);
+    std::string range;
+
+    while (std::getline(ss, range, ','))
+    {
+        if (range.empty() || range == "\n")
+            continue;
+
+        const std::size_t dash = range.find('-');
+        const int first = std::stoi(range.substr(0, dash));
+        const int last = (dash == std::string::npos) ? first : std::stoi(range.substr(dash + 1));
+
+        for (int cpu = first; cpu <= last; ++cpu)
+            cpus.push_back(cpu);
+    }
+    return cpus;
+}
+
+}  // namespace
+#endif
+
+std::vector<std::vector<int>> getNumaNodesCpus()
+{
+    std::vector<std::vector<int>> nodesCpus;
+
+#if defined(__LINUX__)
+    // CPUs available to the process (e.g. restricted by cgroups or taskset)
+    cpu_set_t processCpus;
+    CPU_ZERO(&processCpus);
+    const bool hasProcessCpus = (sched_getaffinity(0, sizeof(processCpus), &processCpus) == 0);
+
+    // online NUMA nodes, their ids may not be contiguous
+    std::string nodeList;
+    {
+        std::ifstream nodeListFile("/sys/devices/system/node/online");
+        std::getline(nodeListFile, nodeList);
+    }
+
+    for (const int node : parseCpuList(nodeList))
+    {
+        std::ifstream cpuListFile("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+        if (!cpuListFile.is_open())
+            continue;
+
+        std::string cpuList;
+        std::getline(cpuListFile, cpuList);
+
+        std::vector<int> cpus;
+        for (const int cpu : parseCpuList(cpuList))
+        {
+            if (!hasProcessCpus || (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &processCpus)))
+                cpus.push_back(cpu);
+        }
+
+        if (!cpus.empty())
+            nodesCpus.push_back(cpus);
+    }
+#endif
+
+    if (nodesCpus.empty())
+    {
+        // no NUMA information, a single node with all the CPUs
+        std::vector<int> cpus(std::max(get_total_cpus(), 1));
+        for (int i = 0; i < cpus.size(); ++i)
+            cpus[i] = i;
+        nodesCpus.push_back(cpus);
+    }
+
+    return nodesCpus;
+}
+
+bool bindOpenMPThreadsToNumaNodes(int nbThreads)
+{
+    const std::vector<std::vector<int>> nodesCpus = getNumaNodesCpus();
+
+    if (nodesCpus.size() < 2)
+    {
+        ALICEVISION_LOG_INFO("NUMA binding: single NUMA node, the threads are not bound.");
+        return false;
+    }
+
+#if defined(__LINUX__)
+    nbThreads = std::max(nbThreads, 1);
+    omp_set_num_threads(nbThreads);
+
+    const int nbNodes = static_cast<int>(nodesCpus.size());
+    std::atomic<int> nbBoundThreads{0};
+
+    // bind each thread of the team, the team threads being reused by the next parallel regions of the same size
+#pragma omp parallel num_threads(nbThreads)
+    {
+        const int threadId = omp_get_thread_num();
+        const int nbTeamThreads = omp_get_num_threads();
+
+        // contiguous blocks of threads per node
+        const int node = static_cast<int>((static_cast<long long>(threadId) * nbNodes) / nbTeamThreads);
+
+        cpu_set_t nodeCpus;
+        CPU_ZERO(&nodeCpus);
+        for (const int cpu : nodesCpus.at(node))
+            CPU_SET(cpu, &nodeCpus);
+
+        if (sched_setaffinity(0, sizeof(nodeCpus), &nodeCpus) == 0)
+            ++nbBoundThreads;
+    }
+
+    ALICEVISION_LOG_INFO("NUMA binding: " << nbBoundThreads.load() << " / " << nbThreads << " thread(s) bound to " << nbNodes << " NUMA nodes.");
+    return nbBoundThreads == nbThreads;
+#else
+    ALICEVISION_LOG_WARNING("NUMA binding is not supported on this system.");
+    return false;
+#endif
+}
+
+}  // namespace system
+}  // namespace aliceVision
@@ -0,0 +1,99 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace aliceVision {
+namespace system {
+
+/**
+ * @brief Get the CPUs of each NUMA node available to the current process.
+ * @note Without NUMA information (or on other systems than Linux), all the CPUs are returned as a single node.
+ * @return the CPU ids per NUMA node, the nodes without available CPU being skipped
+ */
+std::vector<std::vector<int>> getNumaNodesCpus();
+
+/**
+ * @brief Bind the OpenMP threads to the NUMA nodes.
+ *        The threads are split in contiguous blocks, one block per node, each thread being free to move
+ *        between the CPUs of its node. A statically scheduled loop then processes a contiguous part
+ *        of the data per node, which keeps the memory first-touched by a loop local to the threads of the next ones.
+ * @note The thread team size is set to nbThreads. The master thread is bound to the first node,
+ *       and the threads created afterwards inherit its binding.
+ * @param[in] nbThreads the number of OpenMP threads
+ * @return false if there is a single NUMA node or if the binding is not supported
+ */
+bool bindOpenMPThreadsToNumaNodes(int nbThreads);
+
+/**
+ * @brief Allocator leaving the trivial elements uninitialized on default construction.
+ *        Used with parallelFirstTouchResize, the memory pages of a large array are first touched
+ *        by the threads that will process them, instead of by the allocating thread.
+ */
+template<typename T>
+class FirstTouchAllocator : public std::allocator<T>
+{
+  public:
+    template<typename U>
+    struct rebind
+    {
+        using other = FirstTouchAllocator<U>;
+    };
+
+    FirstTouchAllocator() = default;
+
+    template<typename U>
+    FirstTouchAllocator(const FirstTouchAllocator<U>& other) noexcept
+      : std::allocator<T>(other)
+    {}
+
+    template<typename U>
+    void construct(U* ptr) noexcept(std::is_nothrow_default_constructible<U>::value)
+    {
+        if constexpr (!(std::is_trivially_copyable<U>::value && std::is_trivially_destructible<U>::value))
+            ::new (static_cast<void*>(ptr)) U();
+    }
+
+    template<typename U, typename... Args>
+    void construct(U* ptr, Args&&... args)
+    {
+        ::new (static_cast<void*>(ptr)) U(std::forward<Args>(args)...);
+    }
+};
+
+/// Vector of trivial elements, to be initialized with parallelFirstTouchResize
+template<typename T>
+using FirstTouchVector = std::vector<T, FirstTouchAllocator<T>>;
+
+/**
+ * @brief Resize a vector and initialize its elements in a statically scheduled parallel loop,
+ *        so that each memory page is placed on the NUMA node of the thread processing it.
+ * @param[in,out] vec the vector to resize, its previous elements are discarded
+ * @param[in] size the new size
+ * @param[in] value the initial value of the elements
+ */
+template<typename T>
+void parallelFirstTouchResize(FirstTouchVector<T>& vec, std::size_t size, const T& value = T())
+{
+    vec.clear();
+    vec.resize(size);
+
+    T* data = vec.data();
+
+#pragma omp parallel for schedule(static)
+    for (std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t>(size); ++i)
+        data[i] = value;
+}
+
+}  // namespace system
+}  // namespace aliceVision
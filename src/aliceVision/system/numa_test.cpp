@@ -0,0 +1,75 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/system/numa.hpp>
+
+#define BOOST_TEST_MODULE numa
+
+#include <boost/test/unit_test.hpp>
+
+#include <array>
+#include <set>
+#include <vector>
+
+using namespace aliceVision::system;
+
+BOOST_AUTO_TEST_CASE(numa_nodesCpus)
+{
+    const std::vector<std::vector<int>> nodesCpus = getNumaNodesCpus();
+
+    BOOST_CHECK(!nodesCpus.empty());
+
+    // each CPU belongs to a single node
+    std::set<int> cpus;
+    std::size_t nbCpus = 0;
+    for (const std::vector<int>& nodeCpus : nodesCpus)
+    {
+        BOOST_CHECK(!nodeCpus.empty());
+        cpus.insert(nodeCpus.begin(), nodeCpus.end());
+        nbCpus += nodeCpus.size();
+    }
+    BOOST_CHECK_EQUAL(cpus.size(), nbCpus);
+}
+
+BOOST_AUTO_TEST_CASE(numa_parallelFirstTouchResize)
+{
+    struct Element
+    {
+        float weight = 1.0f;
+        std::array<int, 3> ids{{1, 2, 3}};
+    };
+
+    FirstTouchVector<Element> elements;
+    parallelFirstTouchResize(elements, 100000, Element());
+
+    BOOST_CHECK_EQUAL(elements.size(), 100000);
+
+    bool allInitialized = true;
+    for (const Element& element : elements)
+        allInitialized = allInitialized && (element.weight == 1.0f) && (element.ids[2] == 3);
+    BOOST_CHECK(allInitialized);
+
+    // resize to a smaller size with another value
+    Element other;
+    other.weight = 2.0f;
+    parallelFirstTouchResize(elements, 10, other);
+
+    BOOST_CHECK_EQUAL(elements.size(), 10);
+    BOOST_CHECK_EQUAL(elements.back().weight, 2.0f);
+
+    // non trivial elements are still constructed
+    FirstTouchVector<std::vector<int>> vectors(10);
+    BOOST_CHECK(vectors.front().empty());
+}
+
+BOOST_AUTO_TEST_CASE(numa_bindThreads)
+{
+    // the binding is skipped on single node systems
+    const bool bound = bindOpenMPThreadsToNumaNodes(4);
+
+    if (getNumaNodesCpus().size() < 2)
+        BOOST_CHECK(!bound);
+}
@@ -45,6 +45,8 @@ struct KeypointId
         return descType < other.descType;
     }
 
+    bool operator==(const KeypointId& other) const { return descType == other.descType && featIndex == other.featIndex; }
+
     feature::EImageDescriberType descType = feature::EImageDescriberType::UNINITIALIZED;
     std::size_t featIndex = 0;
 };
@@ -7,35 +7,63 @@
 
 #include "TracksBuilder.hpp"
 
-#include <lemon/list_graph.h>
-#include <lemon/unionfind.h>
+#include <algorithm>
+#include <limits>
+#include <numeric>
 
 namespace aliceVision {
 namespace track {
 
 using namespace aliceVision::matching;
-using namespace lemon;
 
 /// IndexedFeaturePair is: map<viewId, keypointId>
 using IndexedFeaturePair = std::pair<std::size_t, KeypointId>;
-using IndexMap = lemon::ListDigraph::NodeMap<std::size_t>;
-using UnionFindObject = lemon::UnionFindEnum<IndexMap>;
-
-using MapNodeToIndex = stl::flat_map<lemon::ListDigraph::Node, IndexedFeaturePair>;
-using MapIndexToNode = stl::flat_map<IndexedFeaturePair, lemon::ListDigraph::Node>;
 
 struct TracksBuilderData
 {
-    /// graph container to create the node
-    lemon::ListDigraph graph;
-    /// node to index map
-    MapNodeToIndex map_nodeToIndex;
-    std::unique_ptr<IndexMap> index;
-    std::unique_ptr<UnionFindObject> tracksUF;
+    /// all referenced features, sorted and unique: the position in this vector is the feature index
+    std::vector<IndexedFeaturePair> features;
+    /// union-find parent of each feature index
+    std::vector<std::size_t> parent;
+    /// union-find size of each set (only valid for roots)
+    std::vector<std::size_t> setSize;
+
+    /// features of the track t are trackFeatures[trackOffsets[t]] to trackFeatures[trackOffsets[t+1] - 1]
+    std::vector<std::size_t> trackOffsets{0};
+    /// feature indexes grouped per track, each track is sorted by feature index (so by viewId)
+    std::vector<std::size_t> trackFeatures;
+
+    std::size_t getFeatureIndex(const IndexedFeaturePair& featPair) const
+    {
+        return std::distance(features.begin(), std::lower_bound(features.begin(), features.end(), featPair));
+    }
 
-    const UnionFindObject& getUnionFindEnum() const { return *tracksUF; }
+    std::size_t findRoot(std::size_t i)
+    {
+        // path halving
+        while (parent[i] != i)
+        {
+            parent[i] = parent[parent[i]];
+            i = parent[i];
+        }
+        return i;
+    }
 
-    const MapNodeToIndex& getReverseMap() const { return map_nodeToIndex; }
+    void join(std::size_t i, std::size_t j)
+    {
+        i = findRoot(i);
+        j = findRoot(j);
+        if (i == j)
+            return;
+
+        // union by size
+        if (setSize[i] < setSize[j])
+            std::swap(i, j);
+        parent[j] = i;
+        setSize[i] += setSize[j];
+    }
+
+    std::size_t nbTracks() const { return trackOffsets.size() - 1; }
 };
 
 TracksBuilder::TracksBuilder() { _d.reset(new TracksBuilderData()); }
@@ -44,12 +72,20 @@ TracksBuilder::~TracksBuilder() = default;
 
 void TracksBuilder::build(const PairwiseMatches& pairwiseMatches)
 {
-    typedef std::set<IndexedFeaturePair> SetIndexedPair;
+    std::vector<IndexedFeaturePair>& features = _d->features;
+    features.clear();
 
     // set of all features of all images: (imageIndex, featureIndex)
-    SetIndexedPair allFeatures;
+    {
+        std::size_t nbMatches = 0;
+        for (const auto& matchesPerDescIt : pairwiseMatches)
+        {
+            for (const auto& matchesIt : matchesPerDescIt.second)
+                nbMatches += matchesIt.second.size();
+        }
+        features.reserve(2 * nbMatches);
+    }
 
-    // for each couple of images make the union according the pair matches
     for (const auto& matchesPerDescIt : pairwiseMatches)
     {
         const std::size_t& I = matchesPerDescIt.first.first;
@@ -63,34 +99,20 @@ void TracksBuilder::build(const PairwiseMatches& pairwiseMatches)
             // we have correspondences between I and J image index.
             for (const IndMatch& m : matches)
             {
-                IndexedFeaturePair pairI(I, KeypointId(descType, m._i));
-                IndexedFeaturePair pairJ(J, KeypointId(descType, m._j));
-                allFeatures.insert(pairI);
-                allFeatures.insert(pairJ);
+                features.emplace_back(I, KeypointId(descType, m._i));
+                features.emplace_back(J, KeypointId(descType, m._j));
             }
         }
     }
 
-    // build the node indirection for each referenced feature
-    MapIndexToNode map_indexToNode;
-    map_indexToNode.reserve(allFeatures.size());
-    _d->map_nodeToIndex.reserve(allFeatures.size());
-
-    for (const IndexedFeaturePair& featPair : allFeatures)
-    {
-        lemon::ListDigraph::Node node = _d->graph.addNode();
-        map_indexToNode.insert(std::make_pair(featPair, node));
-        _d->map_nodeToIndex.insert(std::make_pair(node, featPair));
-    }
+    std::sort(features.begin(), features.end());
+    features.erase(std::unique(features.begin(), features.end()), features.end());
+    features.shrink_to_fit();
 
-    // add the element of myset to the UnionFind insert method.
-    _d->index.reset(new IndexMap(_d->graph));
-    _d->tracksUF.reset(new UnionFindObject(*_d->index));
-
-    for (ListDigraph::NodeIt it(_d->graph); it != INVALID; ++it)
-    {
-        _d->tracksUF->insert(it);
-    }
+    // each feature starts in its own set
+    _d->parent.resize(features.size());
+    std::iota(_d->parent.begin(), _d->parent.end(), 0);
+    _d->setSize.assign(features.size(), 1);
 
     // make the union according the pair matches
     for (const auto& matchesPerDescIt : pairwiseMatches)
@@ -106,12 +128,47 @@ void TracksBuilder::build(const PairwiseMatches& pairwiseMatches)
             // we have correspondences between I and J image index.
             for (const IndMatch& m : matches)
             {
-                IndexedFeaturePair pairI(I, KeypointId(descType, m._i));
-                IndexedFeaturePair pairJ(J, KeypointId(descType, m._j));
-                _d->tracksUF->join(map_indexToNode[pairI], map_indexToNode[pairJ]);
+                const IndexedFeaturePair pairI(I, KeypointId(descType, m._i));
+                const IndexedFeaturePair pairJ(J, KeypointId(descType, m._j));
+                _d->join(_d->getFeatureIndex(pairI), _d->getFeatureIndex(pairJ));
             }
         }
     }
+
+    // group the features per track, tracks are ordered by their first feature
+    const std::size_t nbFeatures = features.size();
+    std::vector<std::size_t> trackIndexPerRoot(nbFeatures, std::numeric_limits<std::size_t>::max());
+    std::vector<std::size_t> trackIndexPerFeature(nbFeatures);
+    std::vector<std::size_t> trackSizes;
+
+    for (std::size_t i = 0; i < nbFeatures; ++i)
+    {
+        const std::size_t root = _d->findRoot(i);
+        std::size_t& trackIndex = trackIndexPerRoot[root];
+        if (trackIndex == std::numeric_limits<std::size_t>::max())
+        {
+            trackIndex = trackSizes.size();
+            trackSizes.push_back(0);
+        }
+        trackIndexPerFeature[i] = trackIndex;
+        ++trackSizes[trackIndex];
+    }
+
+    // the union-find is not needed anymore
+    std::vector<std::size_t>().swap(trackIndexPerRoot);
+    std::vector<std::size_t>().swap(_d->parent);
+    std::vector<std::size_t>().swap(_d->setSize);
+
+    _d->trackOffsets.assign(trackSizes.size() + 1, 0);
+    for (std::size_t t = 0; t < trackSizes.size(); ++t)
+        _d->trackOffsets[t + 1] = _d->trackOffsets[t] + trackSizes[t];
+
+    _d->trackFeatures.resize(nbFeatures);
+    std::vector<std::size_t> trackFill(_d->trackOffsets.begin(), _d->trackOffsets.end() - 1);
+    for (std::size_t i = 0; i < nbFeatures; ++i)
+    {
+        _d->trackFeatures[trackFill[trackIndexPerFeature[i]]++] = i;
+    }
 }
 
 void TracksBuilder::filter(bool clearForks, std::size_t minTrackLength, bool multithreaded)
@@ -122,48 +179,60 @@ void TracksBuilder::filter(bool clearForks, std::size_t minTrackLength, bool mul
     if (!clearForks && minTrackLength == 0)
         return;
 
-    std::set<int> set_classToErase;
+    const std::size_t nbTracks = _d->nbTracks();
+    std::vector<char> keepTrack(nbTracks, 0);
 
-#pragma omp parallel if (multithreaded)
-    for (lemon::UnionFindEnum<IndexMap>::ClassIt cit(*_d->tracksUF); cit != INVALID; ++cit)
+#pragma omp parallel for if (multithreaded)
+    for (std::ptrdiff_t t = 0; t < static_cast<std::ptrdiff_t>(nbTracks); ++t)
     {
-#pragma omp single nowait
+        const std::size_t begin = _d->trackOffsets[t];
+        const std::size_t end = _d->trackOffsets[t + 1];
+
+        // features of a track are sorted by viewId: count distinct consecutive viewIds
+        std::size_t nbViews = 0;
+        for (std::size_t i = begin; i < end; ++i)
         {
-            std::size_t cpt = 0;
-            std::set<std::size_t> myset;
-            for (lemon::UnionFindEnum<IndexMap>::ItemIt iit(*_d->tracksUF, cit); iit != INVALID; ++iit)
-            {
-                myset.insert(_d->map_nodeToIndex[iit].first);
-                ++cpt;
-            }
-            if ((clearForks && myset.size() != cpt) || myset.size() < minTrackLength)
-            {
-#pragma omp critical
-                set_classToErase.insert(cit.operator int());
-            }
+            if (i == begin || _d->features[_d->trackFeatures[i]].first != _d->features[_d->trackFeatures[i - 1]].first)
+                ++nbViews;
         }
+        const std::size_t cpt = end - begin;
+
+        keepTrack[t] = !((clearForks && nbViews != cpt) || nbViews < minTrackLength);
     }
 
-    std::for_each(set_classToErase.begin(), set_classToErase.end(), [&](int toErase) { _d->tracksUF->eraseClass(toErase); });
+    // compact the kept tracks, in place and in the same order
+    std::size_t nbKeptTracks = 0;
+    std::size_t nbKeptFeatures = 0;
+    for (std::size_t t = 0; t < nbTracks; ++t)
+    {
+        if (!keepTrack[t])
+            continue;
+
+        const std::size_t begin = _d->trackOffsets[t];
+        const std::size_t end = _d->trackOffsets[t + 1];
+        std::copy(_d->trackFeatures.begin() + begin, _d->trackFeatures.begin() + end, _d->trackFeatures.begin() + nbKeptFeatures);
+        nbKeptFeatures += end - begin;
+        _d->trackOffsets[++nbKeptTracks] = nbKeptFeatures;
+    }
+    _d->trackOffsets.resize(nbKeptTracks + 1);
+    _d->trackFeatures.resize(nbKeptFeatures);
 }
 
 bool TracksBuilder::exportToStream(std::ostream& os)
 {
-    std::size_t cpt = 0;
-    for (lemon::UnionFindEnum<IndexMap>::ClassIt cit(*_d->tracksUF); cit != INVALID; ++cit)
+    for (std::size_t t = 0; t < _d->nbTracks(); ++t)
     {
-        os << "Class: " << cpt++ << std::endl;
-        std::size_t cptTrackLength = 0;
-        for (lemon::UnionFindEnum<IndexMap>::ItemIt iit(*_d->tracksUF, cit); iit != INVALID; ++iit)
-        {
-            ++cptTrackLength;
-        }
+        const std::size_t begin = _d->trackOffsets[t];
+        const std::size_t end = _d->trackOffsets[t + 1];
+
+        os << "Class: " << t << std::endl;
         os << "\t"
-           << "track length: " << cptTrackLength << std::endl;
+           << "track length: " << (end - begin) << std::endl;
 
-        for (lemon::UnionFindEnum<IndexMap>::ItemIt iit(*_d->tracksUF, cit); iit != INVALID; ++iit)
+        for (std::size_t i = begin; i < end; ++i)
         {
-            os << _d->map_nodeToIndex[iit].first << "  " << _d->map_nodeToIndex[iit].second << std::endl;
+            const IndexedFeaturePair& currentPair = _d->features[_d->trackFeatures[i]];
+            os << currentPair.first << "  " << currentPair.second << std::endl;
         }
     }
     return os.good();
@@ -172,32 +241,30 @@ bool TracksBuilder::exportToStream(std::ostream& os)
 void TracksBuilder::exportToSTL(TracksMap& allTracks) const
 {
     allTracks.clear();
+    allTracks.reserve(_d->nbTracks());
 
-    std::size_t trackIndex = 0;
-    for (lemon::UnionFindEnum<IndexMap>::ClassIt cit(*_d->tracksUF); cit != INVALID; ++cit, ++trackIndex)
+    for (std::size_t t = 0; t < _d->nbTracks(); ++t)
     {
-        // create the output track
-        std::pair<TracksMap::iterator, bool> ret = allTracks.insert(std::make_pair(trackIndex, Track()));
+        const std::size_t begin = _d->trackOffsets[t];
+        const std::size_t end = _d->trackOffsets[t + 1];
 
-        Track& outTrack = ret.first->second;
+        // create the output track, track indexes are increasing
+        Track& outTrack = allTracks.emplace_hint(allTracks.end(), t, Track())->second;
+        outTrack.featPerView.reserve(end - begin);
 
-        for (lemon::UnionFindEnum<IndexMap>::ItemIt iit(*_d->tracksUF, cit); iit != INVALID; ++iit)
+        for (std::size_t i = begin; i < end; ++i)
         {
-            const IndexedFeaturePair& currentPair = _d->map_nodeToIndex.at(iit);
+            const IndexedFeaturePair& currentPair = _d->features[_d->trackFeatures[i]];
             // all descType inside the track will be the same
             outTrack.descType = currentPair.second.descType;
-            outTrack.featPerView[currentPair.first].featureId = currentPair.second.featIndex;
+            // features are sorted by viewId
+            outTrack.featPerView.emplace_hint(outTrack.featPerView.end(), currentPair.first, TrackItem())->second.featureId =
+              currentPair.second.featIndex;
         }
     }
 }
 
-std::size_t TracksBuilder::nbTracks() const
-{
-    std::size_t cpt = 0;
-    for (lemon::UnionFindEnum<IndexMap>::ClassIt cit(*_d->tracksUF); cit != lemon::INVALID; ++cit)
-        ++cpt;
-    return cpt;
-}
+std::size_t TracksBuilder::nbTracks() const { return _d->nbTracks(); }
 
 }  // namespace track
 }  // namespace aliceVision
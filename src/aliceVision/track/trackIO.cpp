@@ -6,9 +6,206 @@
 
 #include "trackIO.hpp"
 
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <sstream>
+
 namespace aliceVision {
 namespace track {
 
+namespace {
+
+// binary tracks file layout:
+//  - header (fixed size): magic, version, number of tracks, pairs and views, offset of the index
+//  - tracks: varint {trackId, descType, nbObservations, {viewId delta, featureId} * nbObservations}
+//  - index (fixed size): {viewA, viewB, nbCommonTracks} per pair, {viewId, first, count} per view, then the per view track offsets
+// fixed size values are stored in native endianness
+const char binaryTracksMagic[8] = {'A', 'V', 'T', 'R', 'A', 'C', 'K', 'S'};
+const std::uint32_t binaryTracksVersion = 2;
+
+constexpr std::size_t headerSize = sizeof(binaryTracksMagic) + sizeof(std::uint32_t) + 4 * sizeof(std::uint64_t);
+constexpr std::size_t pairEntrySize = 2 * sizeof(std::uint32_t) + sizeof(std::uint64_t);
+constexpr std::size_t viewEntrySize = sizeof(std::uint32_t) + 2 * sizeof(std::uint64_t);
+
+struct BinaryTracksHeader
+{
+    std::uint64_t nbTracks = 0;
+    std::uint64_t nbPairs = 0;
+    std::uint64_t nbViews = 0;
+    std::uint64_t indexOffset = 0;
+};
+
+template<typename T>
+void writeValue(std::ostream& os, const T& value)
+{
+    os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void writeVarint(std::ostream& os, std::uint64_t value)
+{
+    char bytes[10];
+    int size = 0;
+    while (value >= 0x80)
+    {
+        bytes[size++] = static_cast<char>((value & 0x7f) | 0x80);
+        value >>= 7;
+    }
+    bytes[size++] = static_cast<char>(value);
+    os.write(bytes, size);
+}
+
+void writeHeader(std::ostream& os, const BinaryTracksHeader& header)
+{
+    os.write(binaryTracksMagic, sizeof(binaryTracksMagic));
+    writeValue<std::uint32_t>(os, binaryTracksVersion);
+    writeValue<std::uint64_t>(os, header.nbTracks);
+    writeValue<std::uint64_t>(os, header.nbPairs);
+    writeValue<std::uint64_t>(os, header.nbViews);
+    writeValue<std::uint64_t>(os, header.indexOffset);
+}
+
+/**
+ * @brief Bounds checked reader over a memory range.
+ */
+class MemoryReader
+{
+  public:
+    MemoryReader(const unsigned char* begin, const unsigned char* end)
+      : _begin(begin),
+        _current(begin),
+        _end(end)
+    {}
+
+    bool isValid() const { return _valid; }
+
+    void seek(std::uint64_t offset)
+    {
+        if (offset > static_cast<std::uint64_t>(_end - _begin))
+        {
+            _valid = false;
+            return;
+        }
+        _current = _begin + offset;
+    }
+
+    template<typename T>
+    T readValue()
+    {
+        T value{};
+        if (static_cast<std::size_t>(_end - _current) < sizeof(T))
+        {
+            _valid = false;
+            return value;
+        }
+        std::memcpy(&value, _current, sizeof(T));
+        _current += sizeof(T);
+        return value;
+    }
+
+    std::uint64_t readVarint()
+    {
+        std::uint64_t value = 0;
+        for (int shift = 0; shift < 64 && _current != _end; shift += 7)
+        {
+            const unsigned char byte = *_current++;
+            value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0)
+                return value;
+        }
+        _valid = false;
+        return 0;
+    }
+
+  private:
+    const unsigned char* _begin;
+    const unsigned char* _current;
+    const unsigned char* _end;
+    bool _valid = true;
+};
+
+/**
+ * @brief Read only memory mapping of a binary tracks file, with its header.
+ */
+class MappedTracksFile
+{
+  public:
+    bool open(const std::string& filename)
+    {
+        try
+        {
+            _mapping = boost::interprocess::file_mapping(filename.c_str(), boost::interprocess::read_only);
+            _region = boost::interprocess::mapped_region(_mapping, boost::interprocess::read_only);
+        }
+        catch (const boost::interprocess::interprocess_exception&)
+        {
+            return false;
+        }
+
+        if (_region.get_size() < headerSize || std::memcmp(_region.get_address(), binaryTracksMagic, sizeof(binaryTracksMagic)) != 0)
+            return false;
+
+        MemoryReader reader = getReader();
+        reader.seek(sizeof(binaryTracksMagic));
+        if (reader.readValue<std::uint32_t>() != binaryTracksVersion)
+            return false;
+
+        _header.nbTracks = reader.readValue<std::uint64_t>();
+        _header.nbPairs = reader.readValue<std::uint64_t>();
+        _header.nbViews = reader.readValue<std::uint64_t>();
+        _header.indexOffset = reader.readValue<std::uint64_t>();
+
+        return reader.isValid() && _header.indexOffset <= _region.get_size();
+    }
+
+    const BinaryTracksHeader& getHeader() const { return _header; }
+
+    MemoryReader getReader() const
+    {
+        const unsigned char* begin = static_cast<const unsigned char*>(_region.get_address());
+        return MemoryReader(begin, begin + _region.get_size());
+    }
+
+  private:
+    boost::interprocess::file_mapping _mapping;
+    boost::interprocess::mapped_region _region;
+    BinaryTracksHeader _header;
+};
+
+void readTrack(MemoryReader& reader, std::size_t& trackId, Track& track)
+{
+    trackId = reader.readVarint();
+    track.descType = static_cast<feature::EImageDescriberType>(reader.readVarint());
+
+    const std::uint64_t nbObservations = reader.readVarint();
+
+    // observations are stored sorted by view id
+    std::vector<std::pair<std::size_t, TrackItem>> observations;
+    observations.reserve(std::min<std::uint64_t>(nbObservations, 1024));
+
+    std::size_t viewId = 0;
+    for (std::uint64_t i = 0; i < nbObservations && reader.isValid(); ++i)
+    {
+        viewId += reader.readVarint();
+        TrackItem item;
+        item.featureId = reader.readVarint();
+        observations.emplace_back(viewId, item);
+    }
+
+    track.featPerView.clear();
+    track.featPerView.insert(boost::container::ordered_unique_range, observations.begin(), observations.end());
+}
+
+bool isJsonFilename(const std::string& filename) { return std::filesystem::path(filename).extension() == ".json"; }
+
+}  // namespace
+
 void tag_invoke(const boost::json::value_from_tag&, boost::json::value& jv, aliceVision::track::TrackItem const& input)
 {
     jv = {{"featureId", boost::json::value_from(input.featureId)}};
@@ -40,5 +237,231 @@ aliceVision::track::Track tag_invoke(boost::json::value_to_tag<aliceVision::trac
     return ret;
 }
 
+bool saveBinaryTracks(const std::string& filename, const TracksMap& tracks)
+{
+    std::ofstream of(filename, std::ios::binary);
+    if (!of.is_open())
+        return false;
+
+    // the header is written again once the index offset is known
+    BinaryTracksHeader header;
+    header.nbTracks = tracks.size();
+    writeHeader(of, header);
+
+    std::map<IndexT, std::vector<std::uint64_t>> trackOffsetsPerView;
+    std::map<Pair, std::uint64_t> covisibility;
+
+    for (const auto& [trackId, track] : tracks)
+    {
+        const std::uint64_t offset = static_cast<std::uint64_t>(of.tellp());
+
+        writeVarint(of, trackId);
+        writeVarint(of, static_cast<std::uint64_t>(track.descType));
+        writeVarint(of, track.featPerView.size());
+
+        std::size_t previousViewId = 0;
+        for (auto it = track.featPerView.begin(); it != track.featPerView.end(); ++it)
+        {
+            writeVarint(of, it->first - previousViewId);
+            writeVarint(of, it->second.featureId);
+            previousViewId = it->first;
+
+            trackOffsetsPerView[it->first].push_back(offset);
+
+            // featPerView is sorted by view id, so pairs are stored with first < second
+            for (auto next = std::next(it); next != track.featPerView.end(); ++next)
+                ++covisibility[Pair(it->first, next->first)];
+        }
+    }
+
+    header.nbPairs = covisibility.size();
+    header.nbViews = trackOffsetsPerView.size();
+    header.indexOffset = static_cast<std::uint64_t>(of.tellp());
+
+    for (const auto& [pair, count] : covisibility)
+    {
+        writeValue<std::uint32_t>(of, static_cast<std::uint32_t>(pair.first));
+        writeValue<std::uint32_t>(of, static_cast<std::uint32_t>(pair.second));
+        writeValue<std::uint64_t>(of, count);
+    }
+
+    std::uint64_t first = 0;
+    for (const auto& [viewId, offsets] : trackOffsetsPerView)
+    {
+        writeValue<std::uint32_t>(of, static_cast<std::uint32_t>(viewId));
+        writeValue<std::uint64_t>(of, first);
+        writeValue<std::uint64_t>(of, offsets.size());
+        first += offsets.size();
+    }
+
+    for (const auto& viewOffsets : trackOffsetsPerView)
+    {
+        for (const std::uint64_t offset : viewOffsets.second)
+            writeValue<std::uint64_t>(of, offset);
+    }
+
+    of.seekp(0);
+    writeHeader(of, header);
+
+    return bool(of);
+}
+
+bool isBinaryTracksFile(const std::string& filename)
+{
+    std::ifstream is(filename, std::ios::binary);
+    char magic[sizeof(binaryTracksMagic)];
+    is.read(magic, sizeof(magic));
+    return is && std::memcmp(magic, binaryTracksMagic, sizeof(magic)) == 0;
+}
+
+bool loadBinaryTracks(const std::string& filename, TracksMap& tracks)
+{
+    tracks.clear();
+
+    MappedTracksFile file;
+    if (!file.open(filename))
+        return false;
+
+    const BinaryTracksHeader& header = file.getHeader();
+    MemoryReader reader = file.getReader();
+    reader.seek(headerSize);
+
+    tracks.reserve(header.nbTracks);
+    for (std::uint64_t i = 0; i < header.nbTracks && reader.isValid(); ++i)
+    {
+        std::size_t trackId;
+        Track track;
+        readTrack(reader, trackId, track);
+
+        // tracks are stored sorted by id
+        tracks.emplace_hint(tracks.end(), trackId, std::move(track));
+    }
+
+    return reader.isValid();
+}
+
+bool loadBinaryTracksPairs(const std::string& filename, std::vector<std::pair<Pair, std::size_t>>& pairs)
+{
+    MappedTracksFile file;
+    if (!file.open(filename))
+        return false;
+
+    const BinaryTracksHeader& header = file.getHeader();
+    MemoryReader reader = file.getReader();
+    reader.seek(header.indexOffset);
+
+    pairs.resize(header.nbPairs);
+    for (auto& pair : pairs)
+    {
+        pair.first.first = reader.readValue<std::uint32_t>();
+        pair.first.second = reader.readValue<std::uint32_t>();
+        pair.second = reader.readValue<std::uint64_t>();
+    }
+
+    return reader.isValid();
+}
+
+bool loadBinaryTracks(const std::string& filename, const PairSet& pairs, TracksMap& tracks)
+{
+    tracks.clear();
+
+    MappedTracksFile file;
+    if (!file.open(filename))
+        return false;
+
+    std::set<IndexT> viewIds;
+    for (const Pair& pair : pairs)
+    {
+        viewIds.insert(pair.first);
+        viewIds.insert(pair.second);
+    }
+
+    // skip the pairs to read the views table
+    const BinaryTracksHeader& header = file.getHeader();
+    MemoryReader reader = file.getReader();
+    reader.seek(header.indexOffset + header.nbPairs * pairEntrySize);
+
+    std::vector<std::pair<std::uint64_t, std::uint64_t>> viewRanges;
+    for (std::uint64_t i = 0; i < header.nbViews; ++i)
+    {
+        const IndexT viewId = reader.readValue<std::uint32_t>();
+        const std::uint64_t first = reader.readValue<std::uint64_t>();
+        const std::uint64_t count = reader.readValue<std::uint64_t>();
+
+        if (viewIds.count(viewId))
+            viewRanges.emplace_back(first, count);
+    }
+
+    if (!reader.isValid())
+        return false;
+
+    // offsets of the tracks observed by at least one of the views
+    const std::uint64_t offsetsStart = header.indexOffset + header.nbPairs * pairEntrySize + header.nbViews * viewEntrySize;
+    std::vector<std::uint64_t> trackOffsets;
+    for (const auto& [first, count] : viewRanges)
+    {
+        reader.seek(offsetsStart + first * sizeof(std::uint64_t));
+        for (std::uint64_t i = 0; i < count && reader.isValid(); ++i)
+            trackOffsets.push_back(reader.readValue<std::uint64_t>());
+    }
+    std::sort(trackOffsets.begin(), trackOffsets.end());
+    trackOffsets.erase(std::unique(trackOffsets.begin(), trackOffsets.end()), trackOffsets.end());
+
+    // tracks are read in file order, so sorted by id
+    for (const std::uint64_t offset : trackOffsets)
+    {
+        reader.seek(offset);
+
+        std::size_t trackId;
+        Track track;
+        readTrack(reader, trackId, track);
+
+        if (!reader.isValid())
+            return false;
+
+        bool sharedByPair = false;
+        for (auto it = track.featPerView.begin(); it != track.featPerView.end() && !sharedByPair; ++it)
+        {
+            for (auto next = std::next(it); next != track.featPerView.end() && !sharedByPair; ++next)
+                sharedByPair = pairs.count(Pair(it->first, next->first)) > 0;
+        }
+
+        if (sharedByPair)
+            tracks.emplace_hint(tracks.end(), trackId, std::move(track));
+    }
+
+    return reader.isValid();
+}
+
+bool saveTracks(const std::string& filename, const TracksMap& tracks)
+{
+    if (!isJsonFilename(filename))
+        return saveBinaryTracks(filename, tracks);
+
+    std::ofstream of(filename);
+    if (!of.is_open())
+        return false;
+
+    of << boost::json::serialize(boost::json::value_from(tracks));
+    return bool(of);
+}
+
+bool loadTracks(const std::string& filename, TracksMap& tracks)
+{
+    if (isBinaryTracksFile(filename))
+        return loadBinaryTracks(filename, tracks);
+
+    std::ifstream tracksFile(filename);
+    if (!tracksFile.is_open())
+        return false;
+
+    std::stringstream buffer;
+    buffer << tracksFile.rdbuf();
+    const boost::json::value jv = boost::json::parse(buffer.str());
+    tracks = flat_map_value_to<Track>(jv);
+
+    return true;
+}
+
 }  // namespace track
 }  // namespace aliceVision
@@ -10,6 +10,10 @@
 
 #include <boost/json.hpp>
 
+#include <string>
+#include <utility>
+#include <vector>
+
 namespace aliceVision {
 namespace track {
 
@@ -39,5 +43,63 @@ void tag_invoke(const boost::json::value_from_tag&, boost::json::value& jv, alic
  */
 aliceVision::track::Track tag_invoke(boost::json::value_to_tag<aliceVision::track::Track>, boost::json::value const& jv);
 
+/**
+ * @brief Save the tracks in a compact binary file: varint encoded tracks, followed by the covisible view pairs
+ *        and a per view index of the tracks, so that the tracks of a subset of view pairs can be loaded alone.
+ * @param[in] filename the output file path
+ * @param[in] tracks the tracks to save
+ * @return true if the file has been written
+ */
+bool saveBinaryTracks(const std::string& filename, const TracksMap& tracks);
+
+/**
+ * @brief Check if a file is a binary tracks file.
+ * @param[in] filename the tracks file path
+ * @return true if the file starts with the binary tracks signature
+ */
+bool isBinaryTracksFile(const std::string& filename);
+
+/**
+ * @brief Load all the tracks of a binary tracks file.
+ * @param[in] filename the binary tracks file path
+ * @param[out] tracks the loaded tracks
+ * @return true if the tracks have been read
+ */
+bool loadBinaryTracks(const std::string& filename, TracksMap& tracks);
+
+/**
+ * @brief Load the covisible view pairs of a binary tracks file.
+ * @param[in] filename the binary tracks file path
+ * @param[out] pairs the covisible view pairs sorted by pair, with their number of common tracks
+ * @return true if the index has been read
+ */
+bool loadBinaryTracksPairs(const std::string& filename, std::vector<std::pair<Pair, std::size_t>>& pairs);
+
+/**
+ * @brief Load from a binary tracks file only the tracks observed by both views of at least one of the given pairs.
+ *        Only the tracks of the pairs views are decoded.
+ * @param[in] filename the binary tracks file path
+ * @param[in] pairs the view pairs of interest
+ * @param[out] tracks the loaded tracks
+ * @return true if the tracks have been read
+ */
+bool loadBinaryTracks(const std::string& filename, const PairSet& pairs, TracksMap& tracks);
+
+/**
+ * @brief Save the tracks, as JSON if the file extension is .json and in the binary format otherwise.
+ * @param[in] filename the output file path
+ * @param[in] tracks the tracks to save
+ * @return true if the file has been written
+ */
+bool saveTracks(const std::string& filename, const TracksMap& tracks);
+
+/**
+ * @brief Load the tracks of a JSON or binary tracks file.
+ * @param[in] filename the tracks file path
+ * @param[out] tracks the loaded tracks
+ * @return true if the tracks have been read
+ */
+bool loadTracks(const std::string& filename, TracksMap& tracks);
+
 }  // namespace track
 }  // namespace aliceVision
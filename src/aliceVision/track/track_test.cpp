@@ -7,10 +7,13 @@
 
 #include "aliceVision/track/TracksBuilder.hpp"
 #include "aliceVision/track/tracksUtils.hpp"
+#include "aliceVision/track/trackIO.hpp"
 #include "aliceVision/matching/IndMatch.hpp"
 
 #include <vector>
 #include <utility>
+#include <filesystem>
+#include <limits>
 
 #define BOOST_TEST_MODULE Track
 
@@ -221,3 +224,82 @@ BOOST_AUTO_TEST_CASE(Track_GetCommonTracksInImages)
         BOOST_CHECK_EQUAL(base.size(), set_visibleTracks.size());
     }
 }
+
+BOOST_AUTO_TEST_CASE(Track_BinaryTracksIO)
+{
+    // A    B    C    D
+    // 0 -> 0 -> 0
+    // 1 -> 1
+    //      2 -> 2 -> 2
+    PairwiseMatches map_pairwisematches;
+    map_pairwisematches[std::make_pair(0, 1)][EImageDescriberType::SIFT] = {IndMatch(0, 0), IndMatch(1, 1)};
+    map_pairwisematches[std::make_pair(1, 2)][EImageDescriberType::SIFT] = {IndMatch(0, 0), IndMatch(2, 2)};
+    map_pairwisematches[std::make_pair(2, 3)][EImageDescriberType::SIFT] = {IndMatch(2, 2)};
+
+    TracksBuilder trackBuilder;
+    trackBuilder.build(map_pairwisematches);
+    TracksMap map_tracks;
+    trackBuilder.exportToSTL(map_tracks);
+    BOOST_CHECK_EQUAL(3, map_tracks.size());
+
+    const std::string filename = (std::filesystem::temp_directory_path() / "track_test_binaryTracks.bin").string();
+    BOOST_CHECK(saveTracks(filename, map_tracks));
+    BOOST_CHECK(isBinaryTracksFile(filename));
+
+    std::vector<std::pair<aliceVision::Pair, std::size_t>> pairs;
+    BOOST_CHECK(loadBinaryTracksPairs(filename, pairs));
+
+    const std::vector<std::pair<aliceVision::Pair, std::size_t>> expectedPairs = {
+      {{0, 1}, 2}, {{0, 2}, 1}, {{1, 2}, 2}, {{1, 3}, 1}, {{2, 3}, 1}};
+    BOOST_CHECK(pairs == expectedPairs);
+
+    // all the tracks
+    {
+        TracksMap loadedTracks;
+        BOOST_CHECK(loadTracks(filename, loadedTracks));
+        BOOST_CHECK_EQUAL(map_tracks.size(), loadedTracks.size());
+        for (const auto& [trackId, track] : map_tracks)
+        {
+            const Track& loadedTrack = loadedTracks.at(trackId);
+            BOOST_CHECK(loadedTrack.descType == track.descType);
+            BOOST_CHECK_EQUAL(track.featPerView.size(), loadedTrack.featPerView.size());
+            for (const auto& [viewId, item] : track.featPerView)
+                BOOST_CHECK_EQUAL(item.featureId, loadedTrack.featPerView.at(viewId).featureId);
+        }
+    }
+
+    // only the track shared by the views 2 and 3
+    {
+        TracksMap loadedTracks;
+        BOOST_CHECK(loadBinaryTracks(filename, {{2, 3}}, loadedTracks));
+        BOOST_CHECK_EQUAL(1, loadedTracks.size());
+        BOOST_CHECK_EQUAL(3, loadedTracks.begin()->second.featPerView.size());
+    }
+
+    // the views 0 and 3 have no common track
+    {
+        TracksMap loadedTracks;
+        BOOST_CHECK(loadBinaryTracks(filename, {{0, 3}}, loadedTracks));
+        BOOST_CHECK(loadedTracks.empty());
+    }
+
+    // large ids use several varint bytes
+    {
+        TracksMap largeTracks;
+        Track& track = largeTracks[std::numeric_limits<std::uint32_t>::max()];
+        track.descType = EImageDescriberType::AKAZE;
+        track.featPerView[10].featureId = 123456789;
+        track.featPerView[4000000000u].featureId = 0;
+        BOOST_CHECK(saveBinaryTracks(filename, largeTracks));
+
+        TracksMap loadedTracks;
+        BOOST_CHECK(loadBinaryTracks(filename, loadedTracks));
+        BOOST_CHECK_EQUAL(1, loadedTracks.size());
+        const Track& loadedTrack = loadedTracks.at(std::numeric_limits<std::uint32_t>::max());
+        BOOST_CHECK(loadedTrack.descType == EImageDescriberType::AKAZE);
+        BOOST_CHECK_EQUAL(123456789, loadedTrack.featPerView.at(10).featureId);
+        BOOST_CHECK_EQUAL(0, loadedTrack.featPerView.at(4000000000u).featureId);
+    }
+
+    std::filesystem::remove(filename);
+}
@@ -6,8 +6,10 @@
 
 #include "Database.hpp"
 #include <aliceVision/system/ProgressDisplay.hpp>
+#include <aliceVision/alicevision_omp.hpp>
 #include <boost/accumulators/accumulators.hpp>
 #include <boost/accumulators/statistics/tail.hpp>
+#include <algorithm>
 #include <cmath>
 #include <fstream>
 #include <stdexcept>
@@ -37,9 +39,51 @@ std::ostream& operator<<(std::ostream& os, const DocMatches& matches)
     return os;
 }
 
+namespace {
+
+/// Append an unsigned integer to the buffer as a LEB128 varint.
+inline void writeVarint(std::vector<uint8_t>& buffer, uint32_t value)
+{
+    while (value >= 0x80)
+    {
+        buffer.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    buffer.push_back(static_cast<uint8_t>(value));
+}
+
+/// Read a LEB128 varint from the buffer and advance the pointer.
+inline uint32_t readVarint(const uint8_t*& ptr)
+{
+    uint32_t value = 0;
+    int shift = 0;
+    while (*ptr & 0x80)
+    {
+        value |= static_cast<uint32_t>(*ptr++ & 0x7F) << shift;
+        shift += 7;
+    }
+    value |= static_cast<uint32_t>(*ptr++) << shift;
+    return value;
+}
+
+/// Header of the database files
+const char databaseFileMagic[8] = {'A', 'V', 'V', 'T', 'D', 'B', '\0', '\0'};
+const uint32_t databaseFileVersion = 1;
+
+/**
+ * @brief Check if the distance method can be computed from the inverted index,
+ *        i.e. if it only depends on the words shared by the query and the document and on the document size.
+ */
+inline bool isInvertedIndexDistance(const std::string& distanceMethod)
+{
+    return distanceMethod == "classic" || distanceMethod == "commonPoints" || distanceMethod == "strongCommonPoints" ||
+           distanceMethod == "inversedWeightedCommonPoints";
+}
+
+}  // namespace
+
 Database::Database(uint32_t num_words)
-  : word_files_(num_words),
-    word_weights_(num_words, 1.0f)
+  : word_weights_(num_words, 1.0f)
 {}
 
 DocId Database::insert(DocId doc_id, const SparseHistogram& document)
@@ -47,20 +91,83 @@ DocId Database::insert(DocId doc_id, const SparseHistogram& document)
     // Ensure that the new document to insert is not already there.
     assert(database_.find(doc_id) == database_.end());
 
-    // For each word, retrieve its inverted file and increment the count for doc_id.
-    for (SparseHistogram::const_iterator it = document.begin(), end = document.end(); it != end; ++it)
+    database_[doc_id] = document;
+
+    // the inverted index is rebuilt by the next query
+    std::lock_guard<std::mutex> lock(*indexMutex_);
+    indexUpToDate_ = false;
+
+    return doc_id;
+}
+
+const Database::InvertedIndex& Database::getIndex() const
+{
+    std::lock_guard<std::mutex> lock(*indexMutex_);
+    if (indexUpToDate_)
+        return index_;
+
+    InvertedIndex& index = index_;
+    const std::size_t nbDocs = database_.size();
+
+    std::size_t nbWords = word_weights_.size();
+    for (const auto& document : database_)
     {
-        Word word = it->first;
-        InvertedFile& file = word_files_[word];
-        if (file.empty() || file.back().id != doc_id)
-            file.push_back(WordFrequency(doc_id, it->second.size()));
-        else
-            file.back().count += it->second.size();
+        if (!document.second.empty())
+            nbWords = std::max(nbWords, static_cast<std::size_t>(document.second.rbegin()->first) + 1);
     }
 
-    database_[doc_id] = document;
+    // count the postings, and the encoded size of the posting lists
+    std::vector<DocId>().swap(index.docIds);
+    std::vector<uint32_t>().swap(index.docSizes);
+    index.docIds.reserve(nbDocs);
+    index.docSizes.reserve(nbDocs);
+    index.nbPostings.assign(nbWords, 0);
+    for (const auto& document : database_)
+    {
+        uint32_t docSize = 0;
+        for (const auto& word : document.second)
+        {
+            ++index.nbPostings[word.first];
+            docSize += word.second.size();
+        }
+        index.docIds.push_back(document.first);
+        index.docSizes.push_back(docSize);
+    }
 
-    return doc_id;
+    // encode the postings of each word in increasing document index order (documents sorted by DocId)
+    std::vector<std::vector<uint8_t>> postings(nbWords);
+    std::vector<uint32_t> lastDocIndex(nbWords, 0);
+    for (std::size_t i = 0; i < nbWords; ++i)
+        postings[i].reserve(2 * index.nbPostings[i]);
+
+    uint32_t docIndex = 0;
+    for (const auto& document : database_)
+    {
+        for (const auto& word : document.second)
+        {
+            std::vector<uint8_t>& wordPostings = postings[word.first];
+            // the first posting stores docIndex + 1, so all the deltas are at least 1
+            writeVarint(wordPostings, docIndex + 1 - lastDocIndex[word.first]);
+            writeVarint(wordPostings, static_cast<uint32_t>(word.second.size()));
+            lastDocIndex[word.first] = docIndex + 1;
+        }
+        ++docIndex;
+    }
+
+    // concatenate the posting lists in one arena
+    index.offsets.assign(nbWords + 1, 0);
+    for (std::size_t i = 0; i < nbWords; ++i)
+        index.offsets[i + 1] = index.offsets[i] + postings[i].size();
+    std::vector<uint8_t>().swap(index.arena);
+    index.arena.reserve(index.offsets.back());
+    for (std::size_t i = 0; i < nbWords; ++i)
+    {
+        index.arena.insert(index.arena.end(), postings[i].begin(), postings[i].end());
+        std::vector<uint8_t>().swap(postings[i]);
+    }
+
+    indexUpToDate_ = true;
+    return index_;
 }
 
 void Database::sanityCheck(std::size_t N, std::map<std::size_t, DocMatches>& matches) const
@@ -83,13 +190,18 @@ void Database::sanityCheck(std::size_t N, std::map<std::size_t, DocMatches>& mat
     // query allocate the whole memory
     auto display = system::createConsoleProgressDisplay(database_.size(), std::cout);
 
-    // #pragma omp parallel for default(none) shared(database_)
+    std::vector<const SparseHistogram*> queries;
+    queries.reserve(database_.size());
+    for (const auto& doc : database_)
+        queries.push_back(&doc.second);
+
+    std::vector<DocMatches> queriesMatches;
+    find(queries, N, queriesMatches);
+
+    std::size_t i = 0;
     for (const auto& doc : database_)
     {
-        std::vector<DocMatch> m;
-        find(doc.second, N, m);
-        //		matches.emplace_back( m );
-        matches[doc.first] = m;
+        matches[doc.first].swap(queriesMatches[i++]);
         ++display;
     }
 }
@@ -121,19 +233,154 @@ void Database::find(const std::vector<Word>& document, std::size_t N, std::vecto
  * @param[in] distanceMethod the method used to compute distance between histograms.
  */
 void Database::find(const SparseHistogram& query, std::size_t N, std::vector<DocMatch>& matches, const std::string& distanceMethod) const
+{
+    std::vector<DocMatches> queriesMatches;
+    find(std::vector<const SparseHistogram*>{&query}, N, queriesMatches, distanceMethod);
+    matches.swap(queriesMatches.front());
+}
+
+/**
+ * @brief Find the top N matches in the database for each query document, in parallel.
+ *
+ * @param[in] queries The query documents, sets of quantized words.
+ * @param[in] N The number of matches to return for each query.
+ * @param[out] matches IDs and scores for the top N matching database documents of each query.
+ * @param[in] distanceMethod the method used to compute distance between histograms.
+ */
+void Database::find(const std::vector<const SparseHistogram*>& queries,
+                    std::size_t N,
+                    std::vector<DocMatches>& matches,
+                    const std::string& distanceMethod) const
 {
     matches.clear();
-    matches.reserve(database_.size());
-    for (const auto& document : database_)
+    matches.resize(queries.size());
+
+    if (!isInvertedIndexDistance(distanceMethod))
     {
         // for each document/image in the database compute the distance between the
         // histograms of the query image and the others
-        const float distance = sparseDistance(query, document.second, distanceMethod, word_weights_);
-        matches.emplace_back(document.first, distance);
+#pragma omp parallel for
+        for (ptrdiff_t q = 0; q < static_cast<ptrdiff_t>(queries.size()); ++q)
+        {
+            DocMatches& queryMatches = matches[q];
+            queryMatches.reserve(database_.size());
+            for (const auto& document : database_)
+            {
+                const float distance = sparseDistance(*queries[q], document.second, distanceMethod, word_weights_);
+                queryMatches.emplace_back(document.first, distance);
+            }
+            const std::size_t nMatches = std::min(N, queryMatches.size());
+            std::partial_sort(queryMatches.begin(), queryMatches.begin() + nMatches, queryMatches.end(), [](const DocMatch& a, const DocMatch& b) {
+                return a.score < b.score || (a.score == b.score && a.id < b.id);
+            });
+            queryMatches.resize(nMatches);
+        }
+        return;
+    }
+
+    const InvertedIndex& index = getIndex();
+    const std::size_t nbDocs = index.docIds.size();
+    const std::size_t nbWords = index.nbPostings.size();
+    const std::size_t nMatches = std::min(N, nbDocs);
+
+    const bool classic = (distanceMethod == "classic");
+    const bool strongCommonPoints = (distanceMethod == "strongCommonPoints");
+    const bool inversedWeightedCommonPoints = (distanceMethod == "inversedWeightedCommonPoints");
+
+#pragma omp parallel
+    {
+        // per-thread scores and words counts of the documents
+        std::vector<float> scores(nbDocs);
+        std::vector<uint32_t> commonCounts(classic ? nbDocs : 0);
+        std::vector<uint32_t> heap;
+        heap.reserve(nMatches + 1);
+
+#pragma omp for schedule(dynamic)
+        for (ptrdiff_t q = 0; q < static_cast<ptrdiff_t>(queries.size()); ++q)
+        {
+            const SparseHistogram& query = *queries[q];
+            std::fill(scores.begin(), scores.end(), 0.0f);
+            std::fill(commonCounts.begin(), commonCounts.end(), 0);
+
+            uint32_t querySize = 0;
+            for (const auto& queryWord : query)
+            {
+                const uint32_t queryCount = queryWord.second.size();
+                querySize += queryCount;
+                if (queryWord.first < 0 || static_cast<std::size_t>(queryWord.first) >= nbWords)
+                    continue;
+                if (strongCommonPoints && queryCount != 1)
+                    continue;
+
+                // accumulate the contribution of the word to the documents of its posting list,
+                // in the words order like sparseDistance
+                const float weight = inversedWeightedCommonPoints ? word_weights_[queryWord.first] : 1.0f;
+                const uint8_t* ptr = index.arena.data() + index.offsets[queryWord.first];
+                const uint8_t* end = index.arena.data() + index.offsets[queryWord.first + 1];
+                uint32_t docIndex = 0;
+                while (ptr < end)
+                {
+                    docIndex += readVarint(ptr);
+                    const uint32_t docCount = readVarint(ptr);
+                    const uint32_t d = docIndex - 1;
+
+                    if (strongCommonPoints)
+                    {
+                        if (docCount == 1)
+                            scores[d] += 1.0f;
+                    }
+                    else if (inversedWeightedCommonPoints)
+                    {
+                        scores[d] += (1.f / std::min(queryCount, docCount)) * weight;
+                    }
+                    else if (classic)
+                    {
+                        commonCounts[d] += std::min(queryCount, docCount);
+                    }
+                    else  // commonPoints
+                    {
+                        scores[d] += std::min(queryCount, docCount);
+                    }
+                }
+            }
+
+            // the distance is the opposite of the common points score, or the L1 distance of the histograms for classic
+            if (classic)
+            {
+                for (std::size_t d = 0; d < nbDocs; ++d)
+                    scores[d] = static_cast<float>(querySize + index.docSizes[d] - 2 * commonCounts[d]);
+            }
+            else
+            {
+                for (std::size_t d = 0; d < nbDocs; ++d)
+                    scores[d] = -scores[d];
+            }
+
+            // top N documents with a max-heap on (distance, document index)
+            const auto worse = [&](uint32_t a, uint32_t b) { return scores[a] < scores[b] || (scores[a] == scores[b] && a < b); };
+            heap.clear();
+            for (uint32_t d = 0; d < nbDocs && nMatches > 0; ++d)
+            {
+                if (heap.size() < nMatches)
+                {
+                    heap.push_back(d);
+                    std::push_heap(heap.begin(), heap.end(), worse);
+                }
+                else if (worse(d, heap.front()))
+                {
+                    std::pop_heap(heap.begin(), heap.end(), worse);
+                    heap.back() = d;
+                    std::push_heap(heap.begin(), heap.end(), worse);
+                }
+            }
+            std::sort_heap(heap.begin(), heap.end(), worse);
+
+            DocMatches& queryMatches = matches[q];
+            queryMatches.reserve(heap.size());
+            for (const uint32_t d : heap)
+                queryMatches.emplace_back(index.docIds[d], scores[d]);
+        }
     }
-    const std::size_t nMatches = std::min(N, matches.size());
-    std::partial_sort(matches.begin(), matches.begin() + nMatches, matches.end());
-    matches.resize(nMatches);
 }
 
 /**
@@ -144,11 +391,12 @@ void Database::find(const SparseHistogram& query, std::size_t N, std::vector<Doc
  */
 void Database::computeTfIdfWeights(float default_weight)
 {
+    const InvertedIndex& index = getIndex();
     float N = (float)database_.size();
-    std::size_t num_words = word_files_.size();
+    std::size_t num_words = word_weights_.size();
     for (std::size_t i = 0; i < num_words; ++i)
     {
-        std::size_t Ni = word_files_[i].size();
+        std::size_t Ni = index.nbPostings[i];
         if (Ni != 0)
             word_weights_[i] = std::log(N / Ni);
         else
@@ -174,9 +422,10 @@ void Database::loadWeights(const std::string& file)
         in.open(file, std::ios_base::binary);
         uint32_t num_words = 0;
         in.read((char*)(&num_words), sizeof(uint32_t));
-        word_files_.resize(num_words);  // Inverted files start out empty
         word_weights_.resize(num_words);
         in.read((char*)(&word_weights_[0]), num_words * sizeof(float));
+        std::lock_guard<std::mutex> lock(*indexMutex_);
+        indexUpToDate_ = false;
     }
     catch (std::ifstream::failure& e)
     {
@@ -184,6 +433,99 @@ void Database::loadWeights(const std::string& file)
     }
 }
 
+bool Database::contains(DocId doc_id) const { return database_.find(doc_id) != database_.end(); }
+
+void Database::save(const std::string& file) const
+{
+    std::ofstream out;
+    out.exceptions(std::ofstream::failbit | std::ofstream::badbit);
+
+    try
+    {
+        out.open(file, std::ios_base::binary);
+        out.write(databaseFileMagic, sizeof(databaseFileMagic));
+        out.write((char*)(&databaseFileVersion), sizeof(uint32_t));
+
+        const uint32_t num_words = word_weights_.size();
+        out.write((char*)(&num_words), sizeof(uint32_t));
+        out.write((char*)(word_weights_.data()), num_words * sizeof(float));
+
+        const uint32_t num_documents = database_.size();
+        out.write((char*)(&num_documents), sizeof(uint32_t));
+        for (const auto& document : database_)
+        {
+            const uint32_t num_document_words = document.second.size();
+            out.write((char*)(&document.first), sizeof(DocId));
+            out.write((char*)(&num_document_words), sizeof(uint32_t));
+            for (const auto& word : document.second)
+            {
+                const uint32_t num_features = word.second.size();
+                out.write((char*)(&word.first), sizeof(Word));
+                out.write((char*)(&num_features), sizeof(uint32_t));
+                out.write((char*)(word.second.data()), num_features * sizeof(IndexT));
+            }
+        }
+    }
+    catch (std::ofstream::failure& e)
+    {
+        throw std::runtime_error((boost::format("Failed to save vocabulary database file '%s'") % file).str());
+    }
+}
+
+void Database::load(const std::string& file)
+{
+    std::ifstream in;
+    in.exceptions(std::ifstream::eofbit | std::ifstream::failbit | std::ifstream::badbit);
+
+    try
+    {
+        in.open(file, std::ios_base::binary);
+
+        char magic[sizeof(databaseFileMagic)];
+        uint32_t version = 0;
+        in.read(magic, sizeof(magic));
+        in.read((char*)(&version), sizeof(uint32_t));
+        if (!std::equal(magic, magic + sizeof(magic), databaseFileMagic) || version != databaseFileVersion)
+            throw std::runtime_error((boost::format("Invalid vocabulary database file '%s'") % file).str());
+
+        uint32_t num_words = 0;
+        in.read((char*)(&num_words), sizeof(uint32_t));
+        word_weights_.resize(num_words);
+        in.read((char*)(word_weights_.data()), num_words * sizeof(float));
+
+        uint32_t num_documents = 0;
+        in.read((char*)(&num_documents), sizeof(uint32_t));
+        database_.clear();
+        for (uint32_t i = 0; i < num_documents; ++i)
+        {
+            DocId doc_id;
+            uint32_t num_document_words = 0;
+            in.read((char*)(&doc_id), sizeof(DocId));
+            in.read((char*)(&num_document_words), sizeof(uint32_t));
+
+            SparseHistogram& document = database_[doc_id];
+            for (uint32_t j = 0; j < num_document_words; ++j)
+            {
+                Word word;
+                uint32_t num_features = 0;
+                in.read((char*)(&word), sizeof(Word));
+                in.read((char*)(&num_features), sizeof(uint32_t));
+
+                std::vector<IndexT>& features = document[word];
+                features.resize(num_features);
+                in.read((char*)(features.data()), num_features * sizeof(IndexT));
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(*indexMutex_);
+        indexUpToDate_ = false;
+    }
+    catch (std::ifstream::failure& e)
+    {
+        throw std::runtime_error((boost::format("Failed to load vocabulary database file '%s'") % file).str());
+    }
+}
+
 ///**
 // * Normalize a document vector representing the histogram of visual words for a given image
 // *
@@ -10,8 +10,11 @@
 #include <aliceVision/types.hpp>
 
 #include <map>
+#include <memory>
+#include <mutex>
 #include <cstddef>
 #include <string>
+#include <vector>
 
 namespace aliceVision {
 namespace voctree {
@@ -102,6 +105,21 @@ class Database
               std::vector<DocMatch>& matches,
               const std::string& distanceMethod = "strongCommonPoints") const;
 
+    /**
+     * @brief Find the top N matches in the database for each query document, in parallel.
+     *        The scores are accumulated from the inverted index, so only the documents sharing words with a query are visited.
+     *        The matches with the same score are sorted by increasing document id.
+     *
+     * @param[in] queries The query documents, sets of quantized words.
+     * @param[in] N The number of matches to return for each query.
+     * @param[out] matches IDs and scores for the top N matching database documents of each query.
+     * @param[in] distanceMethod distance method (norm L1, etc.)
+     */
+    void find(const std::vector<const SparseHistogram*>& queries,
+              std::size_t N,
+              std::vector<DocMatches>& matches,
+              const std::string& distanceMethod = "strongCommonPoints") const;
+
     /**
      * @brief Compute the TF-IDF weights of all the words. To be called after inserting a corpus of
      * training examples into the database.
@@ -121,37 +139,66 @@ class Database
     /// Load the vocabulary word weights from a file.
     void loadWeights(const std::string& file);
 
-    // Save weights and documents
-    // void save(const std::string& file) const;
-    // void load(const std::string& file);
+    /**
+     * @brief Check if a document is in the database.
+     * @param[in] doc_id The document ID
+     * @return true if the document has been inserted
+     */
+    bool contains(DocId doc_id) const;
+
+    /**
+     * @brief Save the vocabulary word weights and the documents to a file.
+     *        The inverted index is not saved, it is rebuilt from the documents at the first query after loading.
+     * @param[in] file The database filepath
+     */
+    void save(const std::string& file) const;
+
+    /**
+     * @brief Load the vocabulary word weights and the documents from a file saved with save().
+     *        The current weights and documents are replaced. More documents can be inserted after loading.
+     * @param[in] file The database filepath
+     */
+    void load(const std::string& file);
 
     const SparseHistogramPerImage& getSparseHistogramPerImage() const { return database_; }
 
+    const std::vector<float>& getWeights() const { return word_weights_; }
+
   private:
-    struct WordFrequency
+    /**
+     * @brief Compact inverted index of the documents.
+     *
+     * The posting lists of all the words are stored contiguously in one arena. A posting is a pair of
+     * LEB128 varints: the delta of the document index (documents sorted by DocId) and the word count in the document.
+     */
+    struct InvertedIndex
     {
-        DocId id;
-        uint32_t count;
-
-        WordFrequency() = default;
-        WordFrequency(DocId _id, uint32_t _count)
-          : id(_id),
-            count(_count)
-        {}
+        /// DocId of each document index
+        std::vector<DocId> docIds;
+        /// total number of words of each document
+        std::vector<uint32_t> docSizes;
+        /// offset of the posting list of each word in the arena (nbWords + 1 offsets)
+        std::vector<std::size_t> offsets;
+        /// number of documents containing each word
+        std::vector<uint32_t> nbPostings;
+        /// encoded posting lists
+        std::vector<uint8_t> arena;
     };
 
-    // Stored in increasing order by DocId
-    typedef std::vector<WordFrequency> InvertedFile;
-
-    /// @todo Use sorted vector?
-    // typedef std::vector< std::pair<Word, float> > DocumentVector;
-
     friend std::ostream& operator<<(std::ostream& os, const SparseHistogram& dv);
 
-    std::vector<InvertedFile> word_files_;
+    /**
+     * @brief Get the inverted index, (re)built from the documents if some documents have been inserted since the last build.
+     */
+    const InvertedIndex& getIndex() const;
+
     std::vector<float> word_weights_;
     SparseHistogramPerImage database_;  // Precomputed for inserted documents
 
+    mutable InvertedIndex index_;
+    mutable bool indexUpToDate_ = false;
+    std::unique_ptr<std::mutex> indexMutex_ = std::make_unique<std::mutex>();
+
     /**
      * Normalize a document vector representing the histogram of visual words for a given image
      * @param[in/out] v the unnormalized histogram of visual words
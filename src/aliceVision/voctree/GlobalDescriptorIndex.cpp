@@ -0,0 +1,111 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "GlobalDescriptorIndex.hpp"
+#include "SimpleKmeans.hpp"
+#include "distance.hpp"
+
+#include <Eigen/Core>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+
+namespace aliceVision {
+namespace voctree {
+
+GlobalDescriptorIndex::GlobalDescriptorIndex(std::size_t nbProbes)
+  : _nbProbes(std::max<std::size_t>(nbProbes, 1))
+{}
+
+void GlobalDescriptorIndex::insert(DocId docId, const std::vector<float>& descriptor)
+{
+    if (_docIds.empty())
+        _dimension = descriptor.size();
+    else if (descriptor.size() != _dimension)
+        throw std::invalid_argument("GlobalDescriptorIndex: all the descriptors must have the same size.");
+
+    _docIds.push_back(docId);
+    _descriptors.insert(_descriptors.end(), descriptor.begin(), descriptor.end());
+    _lists.clear();
+}
+
+void GlobalDescriptorIndex::build()
+{
+    _lists.clear();
+    _centers.clear();
+
+    const std::size_t nbDocs = _docIds.size();
+    if (nbDocs == 0)
+        return;
+
+    const std::size_t nbLists = std::max<std::size_t>(1, static_cast<std::size_t>(std::sqrt(static_cast<double>(nbDocs))));
+
+    using Feature = Eigen::VectorXf;
+
+    // coarse k-means on the descriptors
+    std::vector<Feature> features(nbDocs);
+    for (std::size_t i = 0; i < nbDocs; ++i)
+        features[i] = Eigen::Map<const Feature>(&_descriptors[i * _dimension], _dimension);
+
+    std::vector<Feature> centers;
+    std::vector<unsigned int> membership;
+    if (nbLists == 1)
+    {
+        centers.assign(1, Feature::Zero(_dimension));
+        membership.assign(nbDocs, 0);
+    }
+    else
+    {
+        SimpleKmeans<Feature> kmeans(Feature::Zero(_dimension));
+        kmeans.setInitMethod(InitRandom());
+        kmeans.setMaxIterations(50);
+        // the coarse quantization does not need to be accurate
+        kmeans.setMiniBatchSize(std::max<std::size_t>(4096, 16 * nbLists));
+        kmeans.cluster(features, nbLists, centers, membership);
+    }
+
+    _centers.resize(nbLists * _dimension);
+    for (std::size_t j = 0; j < nbLists; ++j)
+        std::copy(centers[j].data(), centers[j].data() + _dimension, &_centers[j * _dimension]);
+
+    _lists.resize(nbLists);
+    for (std::size_t i = 0; i < nbDocs; ++i)
+        _lists[membership[i]].push_back(i);
+}
+
+void GlobalDescriptorIndex::find(const std::vector<float>& query, std::size_t N, DocMatches& matches) const
+{
+    matches.clear();
+    if (_lists.empty())
+        throw std::logic_error("GlobalDescriptorIndex: the index is not built.");
+    if (query.size() != _dimension)
+        throw std::invalid_argument("GlobalDescriptorIndex: invalid query descriptor size.");
+
+    // select the closest lists
+    std::vector<std::pair<float, std::size_t>> listDistances(_lists.size());
+    for (std::size_t j = 0; j < _lists.size(); ++j)
+        listDistances[j] = {squaredL2(query.data(), &_centers[j * _dimension], _dimension), j};
+    const std::size_t nbProbes = std::min(_nbProbes, listDistances.size());
+    std::partial_sort(listDistances.begin(), listDistances.begin() + nbProbes, listDistances.end());
+
+    // scan the documents of these lists
+    for (std::size_t p = 0; p < nbProbes; ++p)
+    {
+        for (const std::size_t i : _lists[listDistances[p].second])
+            matches.emplace_back(_docIds[i], squaredL2(query.data(), &_descriptors[i * _dimension], _dimension));
+    }
+
+    const std::size_t nbMatches = std::min(N, matches.size());
+    std::partial_sort(matches.begin(), matches.begin() + nbMatches, matches.end(), [](const DocMatch& a, const DocMatch& b) {
+        return a.score < b.score || (a.score == b.score && a.id < b.id);
+    });
+    matches.resize(nbMatches);
+}
+
+}  // namespace voctree
+}  // namespace aliceVision
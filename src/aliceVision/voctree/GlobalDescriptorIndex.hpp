@@ -0,0 +1,72 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include "Database.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace aliceVision {
+namespace voctree {
+
+/**
+ * @brief Approximate nearest neighbors index of global image descriptors (e.g. VLAD), using an inverted file (IVF).
+ *
+ * The descriptors are partitioned by a coarse k-means into about sqrt(N) lists. A query only scans the lists
+ * of its closest coarse centers, so the cost of a query grows sub-linearly with the number of documents.
+ */
+class GlobalDescriptorIndex
+{
+  public:
+    /**
+     * @brief Constructor
+     * @param[in] nbProbes The number of lists scanned by a query (the higher, the more exact)
+     */
+    explicit GlobalDescriptorIndex(std::size_t nbProbes = 8);
+
+    /**
+     * @brief Insert a new document. All the descriptors must have the same size.
+     * @param[in] docId Unique ID of the new document to insert
+     * @param[in] descriptor The global descriptor of the document
+     */
+    void insert(DocId docId, const std::vector<float>& descriptor);
+
+    /**
+     * @brief Build the inverted file from the inserted documents. To be called before querying.
+     */
+    void build();
+
+    /**
+     * @brief Find the approximate top N nearest documents of a query descriptor.
+     * @param[in] query The query global descriptor
+     * @param[in] N The number of matches to return
+     * @param[out] matches IDs and squared L2 distances of the top N documents, sorted by increasing distance
+     */
+    void find(const std::vector<float>& query, std::size_t N, DocMatches& matches) const;
+
+    /// Get the number of documents
+    std::size_t size() const { return _docIds.size(); }
+
+    /// Get the number of lists of the inverted file
+    std::size_t nbLists() const { return _lists.size(); }
+
+  private:
+    std::size_t _nbProbes;
+    std::size_t _dimension = 0;
+    /// DocId of each document index
+    std::vector<DocId> _docIds;
+    /// descriptors of the documents, stored contiguously
+    std::vector<float> _descriptors;
+    /// coarse centers of the lists, stored contiguously
+    std::vector<float> _centers;
+    /// document indexes of each list
+    std::vector<std::vector<std::size_t>> _lists;
+};
+
+}  // namespace voctree
+}  // namespace aliceVision
@@ -285,6 +285,11 @@ bool checkVectorElements(const std::vector<Feature>& f, const char* str)
  * @brief Class for performing K-means clustering, optimized for a particular feature type and metric.
  *
  * The standard Lloyd's algorithm is used. By default, cluster centers are initialized randomly.
+ * With a mini-batch size, the mini-batch k-means is used instead: at each iteration the centers are only
+ * updated from a random sample of the features.
+ *
+ *  Sculley, D. (2010). "Web-scale k-means clustering" Proceedings of the 19th
+ *  international conference on World Wide Web. pp. 1177–1178.
  */
 template<class Feature, class Distance = L2<Feature, Feature>>
 class SimpleKmeans
@@ -317,6 +322,11 @@ class SimpleKmeans
 
     void setVerbose(const int verboseLevel) { verbose_ = verboseLevel; }
 
+    std::size_t getMiniBatchSize() const { return mini_batch_size_; }
+
+    /// Set the number of features sampled at each iteration of the mini-batch k-means (0 to use all the features).
+    void setMiniBatchSize(std::size_t miniBatchSize) { mini_batch_size_ = miniBatchSize; }
+
     /**
      * @brief Partition a set of features into k clusters.
      *
@@ -352,11 +362,26 @@ class SimpleKmeans
                                       std::vector<Feature>& centers,
                                       std::vector<unsigned int>& membership) const;
 
+    squared_distance_type clusterOnceMiniBatch(const std::vector<Feature*>& features,
+                                               std::size_t k,
+                                               std::vector<Feature>& centers,
+                                               std::vector<unsigned int>& membership) const;
+
+    /// Find the nearest cluster center of a feature
+    unsigned int nearestCenter(const Feature& feature, const std::vector<Feature>& centers, std::size_t k) const;
+
+    /// Assign each feature to its nearest center and return the sum squared error
+    squared_distance_type assignAll(const std::vector<Feature*>& features,
+                                    std::size_t k,
+                                    const std::vector<Feature>& centers,
+                                    std::vector<unsigned int>& membership) const;
+
     Feature zero_;
     Distance distance_;
     Initializer choose_centers_;
     std::size_t max_iterations_;
     std::size_t restarts_;
+    std::size_t mini_batch_size_;
     int verbose_;
 };
 
@@ -367,8 +392,9 @@ SimpleKmeans<Feature, Distance>::SimpleKmeans(const Feature& zero, Distance d, c
     //    choose_centers_( InitRandom( ) ),
     choose_centers_(InitKmeanspp()),
     max_iterations_(100),
-    verbose_(verbose),
-    restarts_(1)
+    restarts_(1),
+    mini_batch_size_(0),
+    verbose_(verbose)
 {}
 
 template<class Feature, class Distance>
@@ -402,7 +428,9 @@ typename SimpleKmeans<Feature, Distance>::squared_distance_type SimpleKmeans<Fea
         if (verbose_ > 0)
             ALICEVISION_LOG_DEBUG("Trial " << starts + 1 << "/" << restarts_);
         choose_centers_(features, k, new_centers, distance_, verbose_);
-        squared_distance_type sse = clusterOnce(features, k, new_centers, new_membership);
+        const bool useMiniBatch = mini_batch_size_ > 0 && mini_batch_size_ < features.size();
+        squared_distance_type sse = useMiniBatch ? clusterOnceMiniBatch(features, k, new_centers, new_membership)
+                                                 : clusterOnce(features, k, new_centers, new_membership);
         if (verbose_ > 0)
             ALICEVISION_LOG_DEBUG("End of Trial " << starts + 1 << "/" << restarts_);
         if (sse < least_sse)
@@ -418,6 +446,45 @@ typename SimpleKmeans<Feature, Distance>::squared_distance_type SimpleKmeans<Fea
     return least_sse;
 }
 
+template<class Feature, class Distance>
+unsigned int SimpleKmeans<Feature, Distance>::nearestCenter(const Feature& feature, const std::vector<Feature>& centers, std::size_t k) const
+{
+    squared_distance_type d_min = std::numeric_limits<squared_distance_type>::max();
+    unsigned int nearest = 0;
+
+    // @todo if k is large, let's say k>100 use FLAAN to retrieve the
+    // cluster center
+    for (unsigned int j = 0; j < k; ++j)
+    {
+        const squared_distance_type distance = distance_(feature, centers[j]);
+        if (distance < d_min)
+        {
+            d_min = distance;
+            nearest = j;
+        }
+    }
+    return nearest;
+}
+
+template<class Feature, class Distance>
+typename SimpleKmeans<Feature, Distance>::squared_distance_type SimpleKmeans<Feature, Distance>::assignAll(
+  const std::vector<Feature*>& features,
+  std::size_t k,
+  const std::vector<Feature>& centers,
+  std::vector<unsigned int>& membership) const
+{
+    const bool enableMultithreading = features.size() * k > 1000000;
+
+    squared_distance_type sse = squared_distance_type(0);
+#pragma omp parallel for reduction(+ : sse) if (enableMultithreading)
+    for (ptrdiff_t i = 0; i < static_cast<ptrdiff_t>(features.size()); ++i)
+    {
+        membership[i] = nearestCenter(*features[i], centers, k);
+        sse += distance_(*features[i], centers[membership[i]]);
+    }
+    return sse;
+}
+
 template<class Feature, class Distance>
 typename SimpleKmeans<Feature, Distance>::squared_distance_type SimpleKmeans<Feature, Distance>::clusterOnce(
   const std::vector<Feature*>& features,
@@ -425,14 +492,20 @@ typename SimpleKmeans<Feature, Distance>::squared_distance_type SimpleKmeans<Fea
   std::vector<Feature>& centers,
   std::vector<unsigned int>& membership) const
 {
-    typedef typename std::vector<Feature>::value_type centerType;
-    typedef typename Distance::value_type feature_value_type;
-
     std::vector<std::size_t> new_center_counts(k);
     std::vector<Feature> new_centers(k);
-    std::vector<std::mutex> centersLocks(k);
     squared_distance_type max_center_shift = std::numeric_limits<squared_distance_type>::max();
 
+    // On small problems enabling multithreading does much more harm than good because thread
+    // creation is relatively expensive.
+    // When the k-means is already run in parallel (e.g. on the sibling nodes of a tree), it stays sequential.
+    const bool enableMultithreading = features.size() * k > 1000000 && !omp_in_parallel();
+    const int nbThreads = enableMultithreading ? omp_get_max_threads() : 1;
+
+    // accumulators of each thread, to avoid the synchronization when the features are added to the centers
+    std::vector<std::vector<Feature>> thread_centers(nbThreads, std::vector<Feature>(k));
+    std::vector<std::vector<std::size_t>> thread_center_counts(nbThreads, std::vector<std::size_t>(k));
+
     if (verbose_ > 0)
         ALICEVISION_LOG_DEBUG("Iterations");
     for (std::size_t iter = 0; iter < max_iterations_; ++iter)
@@ -440,67 +513,48 @@ typename SimpleKmeans<Feature, Distance>::squared_distance_type SimpleKmeans<Fea
         if (verbose_ > 0)
             ALICEVISION_LOG_DEBUG("*");
         // Zero out new centers and counts
-        std::fill(new_center_counts.begin(), new_center_counts.end(), 0);
-        //		for(std::size_t i = 0; i < k; checkElements(new_centers[i++], "bef"));
-        std::fill(new_centers.begin(), new_centers.end(), zero_);
-        //		for(std::size_t i = 0; i < k; checkElements(new_centers[i++], "aft"));
-        assert(checkVectorElements(new_centers, "newcenters init"));
-        bool is_stable = true;
-
-        // On small problems enabling multithreading does much more harm than good because thread
-        // creation is relatively expensive.
-        // TODO: Ideally a thread pool would be created before the first iteration and the iterations
-        // would reuse the existing threads.
-        bool enableMultithreading = features.size() * k > 1000000;
+        for (int t = 0; t < nbThreads; ++t)
+        {
+            std::fill(thread_centers[t].begin(), thread_centers[t].end(), zero_);
+            std::fill(thread_center_counts[t].begin(), thread_center_counts[t].end(), 0);
+        }
+        std::size_t nbChanged = 0;
 
 // Assign data objects to current centers
-#pragma omp parallel for shared(new_centers, new_center_counts, features, centers, membership) if (enableMultithreading)
+#pragma omp parallel for schedule(static) reduction(+ : nbChanged) num_threads(nbThreads) if (enableMultithreading)
         for (ptrdiff_t i = 0; i < static_cast<ptrdiff_t>(features.size()); ++i)
         {
-            squared_distance_type d_min = std::numeric_limits<squared_distance_type>::max();
-            unsigned int nearest = 0;
-            bool found = false;
-
-            // @todo if k is large, let's say k>100 use FLAAN to retrieve the
-            // cluster center
-
             // Find the nearest cluster center to feature i
-            for (unsigned int j = 0; j < k; ++j)
-            {
-                squared_distance_type distance = distance_(*features[i], centers[j]);
-                //		printf("\t\tdistance %f\n", (float)distance);
-                //		PrintFeat(*features[i] );
-                if (distance < d_min)
-                {
-                    d_min = distance;
-                    nearest = j;
-                    found = true;
-                }
-                //		 printf("\t distance %f %f\n", (double)distance, (double)d_min);
-            }
-            assert(found);
+            const unsigned int nearest = nearestCenter(*features[i], centers, k);
+
             // Assign feature i to the cluster it is nearest to
             if (membership[i] != nearest)
             {
-                is_stable = false;
+                ++nbChanged;
                 membership[i] = nearest;
             }
             // Accumulate the cluster center and its membership count
-            //	  printf("\t nearest %d\n", nearest);
-            //			checkElements(*features[i], "feat");
-            {
-                std::lock_guard<std::mutex> lock{centersLocks[nearest]};
-                new_centers[nearest] += *features[i];
-                //			checkElements(new_centers[nearest], "sum");
-                //	  printf("\t new_centers[nearest] += *features[i];\n");
-                ++new_center_counts[nearest];
-                //	  printf("\taccumulate\n");
-            }
+            const int t = omp_get_thread_num();
+            thread_centers[t][nearest] += *features[i];
+            ++thread_center_counts[t][nearest];
         }  // for
 
-        if (is_stable)
+        if (nbChanged == 0)
             break;
 
+        // Merge the accumulators of the threads
+        std::fill(new_centers.begin(), new_centers.end(), zero_);
+        std::fill(new_center_counts.begin(), new_center_counts.end(), 0);
+        for (int t = 0; t < nbThreads; ++t)
+        {
+            for (std::size_t i = 0; i < k; ++i)
+            {
+                new_centers[i] += thread_centers[t][i];
+                new_center_counts[i] += thread_center_counts[t][i];
+            }
+        }
+        assert(checkVectorElements(new_centers, "newcenters init"));
+
         if (iter > 0)
             max_center_shift = 0;
         // Assign new centers
@@ -508,9 +562,6 @@ typename SimpleKmeans<Feature, Distance>::squared_distance_type SimpleKmeans<Fea
         {
             if (new_center_counts[i] > 0)
             {
-                //		  printf("%d - %d\n", i, new_center_counts[i] );
-                //		  PrintFeat(new_centers[i] );
-                //		checkElements(new_centers[i], "bef");
                 new_centers[i] = new_centers[i] / new_center_counts[i];
 
                 squared_distance_type shift = distance_(new_centers[i], centers[i]);
@@ -518,9 +569,6 @@ typename SimpleKmeans<Feature, Distance>::squared_distance_type SimpleKmeans<Fea
                 max_center_shift = std::max(max_center_shift, shift);
 
                 centers[i] = new_centers[i];
-                //					centers[i] = new_centers[i] / new_center_counts[i];
-                //		checkElements(new_centers[i], "aft");
-                //		PrintFeat(centers[i] );
             }
             else
             {
@@ -549,5 +597,62 @@ typename SimpleKmeans<Feature, Distance>::squared_distance_type SimpleKmeans<Fea
     return sse;
 }
 
+template<class Feature, class Distance>
+typename SimpleKmeans<Feature, Distance>::squared_distance_type SimpleKmeans<Feature, Distance>::clusterOnceMiniBatch(
+  const std::vector<Feature*>& features,
+  std::size_t k,
+  std::vector<Feature>& centers,
+  std::vector<unsigned int>& membership) const
+{
+    // sum and number of the samples assigned to each center since the first iteration:
+    // the per-center learning rate 1/count makes each center the mean of all its samples
+    std::vector<Feature> center_sums(k, zero_);
+    std::vector<std::size_t> center_counts(k, 0);
+
+    std::vector<const Feature*> batch(mini_batch_size_);
+    std::vector<unsigned int> batch_membership(mini_batch_size_);
+    std::vector<char> updated(k);
+
+    const bool enableMultithreading = mini_batch_size_ * k > 100000 && !omp_in_parallel();
+
+    if (verbose_ > 0)
+        ALICEVISION_LOG_DEBUG("Mini-batch iterations");
+    for (std::size_t iter = 0; iter < max_iterations_; ++iter)
+    {
+        // Sample the mini-batch
+        for (std::size_t b = 0; b < mini_batch_size_; ++b)
+            batch[b] = features[rand() % features.size()];
+
+        // Assign the samples to the current centers
+#pragma omp parallel for if (enableMultithreading)
+        for (ptrdiff_t b = 0; b < static_cast<ptrdiff_t>(mini_batch_size_); ++b)
+            batch_membership[b] = nearestCenter(*batch[b], centers, k);
+
+        // Update the centers of the samples
+        std::fill(updated.begin(), updated.end(), 0);
+        for (std::size_t b = 0; b < mini_batch_size_; ++b)
+        {
+            center_sums[batch_membership[b]] += *batch[b];
+            ++center_counts[batch_membership[b]];
+            updated[batch_membership[b]] = 1;
+        }
+
+        squared_distance_type max_center_shift = 0;
+        for (std::size_t i = 0; i < k; ++i)
+        {
+            if (!updated[i])
+                continue;
+            const Feature new_center = center_sums[i] / center_counts[i];
+            max_center_shift = std::max(max_center_shift, distance_(new_center, centers[i]));
+            centers[i] = new_center;
+        }
+        if (max_center_shift <= 10e-10)
+            break;
+    }
+
+    // Assign all the features to the final centers
+    return assignAll(features, k, centers, membership);
+}
+
 }  // namespace voctree
 }  // namespace aliceVision
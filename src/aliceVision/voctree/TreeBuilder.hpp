@@ -103,18 +103,28 @@ void TreeBuilder<Feature, DistanceT>::build(const FeatureVector& training_featur
             feature_ptrs.push_back(const_cast<Feature*>(&f));
         }
     }
-    FeatureVector centers;  // always size k
     for (uint32_t level = 0; level < levels; ++level)
     {
         if (verbose_)
             printf("# Level %u\n", level);
-        std::vector<unsigned int> membership;
 
-        for (std::size_t i = 0, ie = subset_queue.size(); i < ie; ++i)
+        // The subsets of a level are disjoint: their k-means are run in parallel.
+        // At the first levels, where there are only a few subsets, each k-means is parallelized instead.
+        const std::size_t nbSubsets = subset_queue.size();
+        std::vector<FeatureVector> subsetCenters(nbSubsets);  // always size k
+        std::vector<std::size_t> subsetNbValidCenters(nbSubsets, k);
+        std::vector<std::vector<std::vector<Feature*>>> subsetChildren(nbSubsets);
+
+#pragma omp parallel for schedule(dynamic) if (nbSubsets >= 2 * static_cast<std::size_t>(omp_get_max_threads()))
+        for (ptrdiff_t i = 0; i < static_cast<ptrdiff_t>(nbSubsets); ++i)
         {
-            std::vector<Feature*>& subset = subset_queue.front();
+            std::vector<Feature*>& subset = subset_queue[i];
+            FeatureVector& centers = subsetCenters[i];
+            std::vector<std::vector<Feature*>>& new_subsets = subsetChildren[i];
+            new_subsets.resize(k);
+
             if (verbose_ > 1)
-                printf("#\tClustering subset %lu/%lu of size %lu\n", i + 1, ie, subset.size());
+                printf("#\tClustering subset %lu/%lu of size %lu\n", i + 1, nbSubsets, subset.size());
 
             // If the subset already has k or fewer elements, just use those as the centers.
             if (subset.size() <= k)
@@ -122,29 +132,20 @@ void TreeBuilder<Feature, DistanceT>::build(const FeatureVector& training_featur
                 if (verbose_ > 2)
                     printf("#\tno need to cluster %lu elements\n", subset.size());
                 for (std::size_t j = 0; j < subset.size(); ++j)
-                {
-                    tree_.centers().push_back(*subset[j]);
-                    tree_.validCenters().push_back(1);
-                }
+                    centers.push_back(*subset[j]);
                 // Mark non-existent centers as invalid.
-                tree_.centers().insert(tree_.centers().end(), k - subset.size(), zero_);
-                tree_.validCenters().insert(tree_.validCenters().end(), k - subset.size(), 0);
-
-                // Push k empty subsets into the queue so all children get marked invalid.
-                subset_queue.pop_front();
-                subset_queue.insert(subset_queue.end(), k, std::vector<Feature*>());
+                centers.insert(centers.end(), k - subset.size(), zero_);
+                subsetNbValidCenters[i] = subset.size();
+                // The k children subsets stay empty so all children get marked invalid.
             }
             else
             {
                 // Cluster the current subset into k centers.
                 if (verbose_ > 2)
                     printf("#\tclustering the current subset of %lu elements into %d centers\n", subset.size(), k);
+                std::vector<unsigned int> membership;
                 kmeans_.clusterPointers(subset, k, centers, membership);
-                // Add the centers and mark them as valid.
-                tree_.centers().insert(tree_.centers().end(), centers.begin(), centers.end());
-                tree_.validCenters().insert(tree_.validCenters().end(), k, 1);
                 // Partition the current subset into k new subsets based on the cluster assignments.
-                std::vector<std::vector<Feature*>> new_subsets(k);
                 assert(membership.size() >= subset.size());
                 for (std::size_t j = 0; j < subset.size(); ++j)
                 {
@@ -152,10 +153,19 @@ void TreeBuilder<Feature, DistanceT>::build(const FeatureVector& training_featur
                     assert(membership[j] < new_subsets.size());
                     new_subsets[membership[j]].push_back(subset[j]);
                 }
-                // Update the queue
-                subset_queue.pop_front();
-                subset_queue.insert(subset_queue.end(), new_subsets.begin(), new_subsets.end());
             }
+            std::vector<Feature*>().swap(subset);
+        }
+
+        // Add the centers (and mark them as valid) and update the queue in the subsets order
+        subset_queue.clear();
+        for (std::size_t i = 0; i < nbSubsets; ++i)
+        {
+            tree_.centers().insert(tree_.centers().end(), subsetCenters[i].begin(), subsetCenters[i].end());
+            tree_.validCenters().insert(tree_.validCenters().end(), subsetNbValidCenters[i], 1);
+            tree_.validCenters().insert(tree_.validCenters().end(), k - subsetNbValidCenters[i], 0);
+            for (std::vector<Feature*>& new_subset : subsetChildren[i])
+                subset_queue.push_back(std::move(new_subset));
         }
         if (verbose_)
             printf("# centers so far = %lu\n", tree_.centers().size());
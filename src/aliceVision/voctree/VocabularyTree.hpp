@@ -15,15 +15,20 @@
 
 #include <aliceVision/types.hpp>
 #include <aliceVision/system/Logger.hpp>
+#include <aliceVision/alicevision_omp.hpp>
 
 #include <stdint.h>
 #include <vector>
 #include <map>
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <limits>
 #include <fstream>
+#include <numeric>
 #include <stdexcept>
 #include <iostream>
+#include <type_traits>
 
 namespace aliceVision {
 namespace voctree {
@@ -58,6 +63,19 @@ inline void computeSparseHistogram(const std::vector<Word>& document, SparseHist
     }
 }
 
+/**
+ * @brief Check if a descriptor type has a compile-time size and arithmetic bins (like feature::Descriptor),
+ *        so that the L2 distances to the tree centers can be computed on contiguous float vectors.
+ */
+template<class DescriptorT, class = void>
+struct isFixedSizeDescriptor : std::false_type
+{};
+
+template<class DescriptorT>
+struct isFixedSizeDescriptor<DescriptorT, typename std::enable_if<std::is_arithmetic<typename DescriptorT::bin_type>::value && (DescriptorT::static_size > 0)>::type>
+  : std::true_type
+{};
+
 class IVocabularyTree
 {
   public:
@@ -118,10 +136,35 @@ class VocabularyTree : public IVocabularyTree
     template<class DescriptorT>
     std::vector<Word> quantize(const std::vector<DescriptorT>& features) const;
 
+    /**
+     * @brief Quantizes a contiguous set of features into visual words.
+     *        For fixed-size descriptors with the L2 distance, the features are processed by blocks per node:
+     *        at each level they are grouped by their current node, so the children centers of a node are converted
+     *        to floats once and the distances to these contiguous centers are computed with SIMD.
+     * @param[in] features Pointer to the first feature
+     * @param[in] nbFeatures The number of features
+     * @return the visual word of each feature
+     */
+    template<class DescriptorT>
+    std::vector<Word> quantize(const DescriptorT* features, std::size_t nbFeatures) const;
+
     /// Quantizes a set of features into sparse histogram of visual words.
     template<class DescriptorT>
     SparseHistogram quantizeToSparse(const std::vector<DescriptorT>& features) const;
 
+    /**
+     * @brief Compute the VLAD global descriptor of a set of features (Jegou et al., "Aggregating local descriptors
+     *        into a compact image representation", CVPR 2010).
+     *        Each feature is quantized to a node of the given level of the tree, and the residuals to the node
+     *        centers are accumulated per node. The concatenated residuals are power normalized (signed square root)
+     *        and L2 normalized.
+     * @param[in] features The features of the image
+     * @param[in] level The level of the nodes used as visual words (0 for the k children of the root)
+     * @return the global descriptor, of size (number of nodes of the level) * (feature dimension)
+     */
+    template<class DescriptorT>
+    std::vector<float> computeVLAD(const std::vector<DescriptorT>& features, uint32_t level = 0) const;
+
     SparseHistogram quantizeToSparse(const void* blindDescriptors) const override
     {
         const std::vector<Feature>* descriptors = static_cast<const std::vector<Feature>*>(blindDescriptors);
@@ -150,6 +193,13 @@ class VocabularyTree : public IVocabularyTree
     }
 
   protected:
+    /// Find the node of the given level closest to a feature, going down the tree from the root.
+    template<class DescriptorT>
+    int32_t findNode(const DescriptorT& feature, uint32_t level) const;
+
+    template<class DescriptorT>
+    std::vector<Word> quantizeBlocks(const DescriptorT* features, std::size_t nbFeatures) const;
+
     std::vector<Feature> centers_;
     std::vector<uint8_t> valid_centers_;  /// @todo Consider bit-vector
 
@@ -185,13 +235,20 @@ template<class Feature, template<typename, typename> class Distance>
 template<class DescriptorT>
 Word VocabularyTree<Feature, Distance>::quantize(const DescriptorT& feature) const
 {
-    typedef typename Distance<Feature, DescriptorT>::result_type distance_type;
-
     //	printf("asserting\n");
     assert(initialized());
     //	printf("initialized\n");
+    return findNode(feature, levels_ - 1) - word_start_;
+}
+
+template<class Feature, template<typename, typename> class Distance>
+template<class DescriptorT>
+int32_t VocabularyTree<Feature, Distance>::findNode(const DescriptorT& feature, uint32_t nodeLevel) const
+{
+    typedef typename Distance<Feature, DescriptorT>::result_type distance_type;
+
     int32_t index = -1;  // virtual "root" index, which has no associated center.
-    for (unsigned level = 0; level < levels_; ++level)
+    for (unsigned level = 0; level <= nodeLevel; ++level)
     {
         // Calculate the offset to the first child of the current index.
         int32_t first_child = (index + 1) * splits();
@@ -212,7 +269,52 @@ Word VocabularyTree<Feature, Distance>::quantize(const DescriptorT& feature) con
         index = best_child;
     }
 
-    return index - word_start_;
+    return index;
+}
+
+template<class Feature, template<typename, typename> class Distance>
+template<class DescriptorT>
+std::vector<float> VocabularyTree<Feature, Distance>::computeVLAD(const std::vector<DescriptorT>& features, uint32_t level) const
+{
+    assert(initialized());
+    assert(level < levels_);
+
+    // offset of the first node of the level, and number of nodes of the level
+    std::size_t levelStart = 0;
+    std::size_t nbNodes = k_;
+    for (uint32_t i = 0; i < level; ++i)
+    {
+        levelStart += nbNodes;
+        nbNodes *= k_;
+    }
+
+    const std::size_t dim = centers_.front().size();
+    std::vector<float> vlad(nbNodes * dim, 0.0f);
+
+    // accumulate the residuals of the features to their node center
+    for (const DescriptorT& feature : features)
+    {
+        const int32_t node = findNode(feature, level);
+        const Feature& center = centers_[node];
+        float* residuals = &vlad[(node - levelStart) * dim];
+        for (std::size_t d = 0; d < dim; ++d)
+            residuals[d] += static_cast<float>(feature[d]) - static_cast<float>(center[d]);
+    }
+
+    // power and L2 normalization
+    double squaredNorm = 0.0;
+    for (float& v : vlad)
+    {
+        v = (v < 0.0f) ? -std::sqrt(-v) : std::sqrt(v);
+        squaredNorm += v * v;
+    }
+    if (squaredNorm > 0.0)
+    {
+        const float invNorm = static_cast<float>(1.0 / std::sqrt(squaredNorm));
+        for (float& v : vlad)
+            v *= invNorm;
+    }
+    return vlad;
 }
 
 template<class Feature, template<typename, typename> class Distance>
@@ -220,11 +322,25 @@ template<class DescriptorT>
 std::vector<Word> VocabularyTree<Feature, Distance>::quantize(const std::vector<DescriptorT>& features) const
 {
     // ALICEVISION_LOG_DEBUG("VocabularyTree quantize: " << features.size());
-    std::vector<Word> imgVisualWords(features.size(), 0);
+    return quantize(features.data(), features.size());
+}
+
+template<class Feature, template<typename, typename> class Distance>
+template<class DescriptorT>
+std::vector<Word> VocabularyTree<Feature, Distance>::quantize(const DescriptorT* features, std::size_t nbFeatures) const
+{
+    if constexpr (isFixedSizeDescriptor<DescriptorT>::value && isFixedSizeDescriptor<Feature>::value &&
+                  std::is_same<Distance<DescriptorT, Feature>, L2<DescriptorT, Feature>>::value)
+    {
+        if constexpr (DescriptorT::static_size == Feature::static_size)
+            return quantizeBlocks(features, nbFeatures);
+    }
+
+    std::vector<Word> imgVisualWords(nbFeatures, 0);
 
 // quantize the features
 #pragma omp parallel for
-    for (ptrdiff_t j = 0; j < static_cast<ptrdiff_t>(features.size()); ++j)
+    for (ptrdiff_t j = 0; j < static_cast<ptrdiff_t>(nbFeatures); ++j)
     {
         // store the visual word associated to the feature in the temporary list
         imgVisualWords[j] = quantize<DescriptorT>(features[j]);
@@ -234,6 +350,86 @@ std::vector<Word> VocabularyTree<Feature, Distance>::quantize(const std::vector<
     return imgVisualWords;
 }
 
+template<class Feature, template<typename, typename> class Distance>
+template<class DescriptorT>
+std::vector<Word> VocabularyTree<Feature, Distance>::quantizeBlocks(const DescriptorT* features, std::size_t nbFeatures) const
+{
+    constexpr std::size_t dim = Feature::static_size;
+
+    assert(initialized());
+
+    const ptrdiff_t nbDescriptors = static_cast<ptrdiff_t>(nbFeatures);
+
+    // convert the queries once, as contiguous float vectors
+    std::vector<float> queries(nbFeatures * dim);
+#pragma omp parallel for
+    for (ptrdiff_t j = 0; j < nbDescriptors; ++j)
+        std::copy(features[j].getData(), features[j].getData() + dim, queries.begin() + j * dim);
+
+    // current node of each descriptor, starting from the virtual "root" index
+    std::vector<int32_t> nodes(nbDescriptors, -1);
+    // descriptors sorted by their current node
+    std::vector<ptrdiff_t> order(nbDescriptors);
+    std::iota(order.begin(), order.end(), 0);
+
+    for (unsigned level = 0; level < levels_; ++level)
+    {
+        if (level > 0)
+        {
+            // group the descriptors of the same node, so its children centers are reused by contiguous descriptors
+            std::sort(order.begin(), order.end(), [&](ptrdiff_t a, ptrdiff_t b) { return nodes[a] < nodes[b] || (nodes[a] == nodes[b] && a < b); });
+        }
+
+#pragma omp parallel
+        {
+            // children centers of the last node processed by this thread, as contiguous float vectors
+            int32_t currentNode = std::numeric_limits<int32_t>::min();
+            int32_t firstChild = 0;
+            int nbChildren = 0;
+            std::vector<float> children(splits() * dim);
+
+#pragma omp for schedule(static)
+            for (ptrdiff_t i = 0; i < nbDescriptors; ++i)
+            {
+                const ptrdiff_t j = order[i];
+                if (nodes[j] != currentNode)
+                {
+                    currentNode = nodes[j];
+                    // Calculate the offset to the first child of the current index.
+                    firstChild = (currentNode + 1) * splits();
+                    nbChildren = 0;
+                    while (nbChildren < static_cast<int>(splits()) && valid_centers_[firstChild + nbChildren])
+                    {
+                        const Feature& center = centers_[firstChild + nbChildren];
+                        std::copy(center.getData(), center.getData() + dim, children.begin() + nbChildren * dim);
+                        ++nbChildren;  // Fewer than splits() children.
+                    }
+                }
+
+                // Find the child center closest to the query.
+                const float* query = &queries[j * dim];
+                int bestChild = 0;
+                float bestDistance = std::numeric_limits<float>::max();
+                for (int child = 0; child < nbChildren; ++child)
+                {
+                    const float childDistance = squaredL2(&children[child * dim], query, dim);
+                    if (childDistance < bestDistance)
+                    {
+                        bestChild = child;
+                        bestDistance = childDistance;
+                    }
+                }
+                nodes[j] = firstChild + bestChild;
+            }
+        }
+    }
+
+    std::vector<Word> imgVisualWords(nbDescriptors);
+    for (ptrdiff_t j = 0; j < nbDescriptors; ++j)
+        imgVisualWords[j] = nodes[j] - word_start_;
+    return imgVisualWords;
+}
+
 template<class Feature, template<typename, typename> class Distance>
 template<class DescriptorT>
 SparseHistogram VocabularyTree<Feature, Distance>::quantizeToSparse(const std::vector<DescriptorT>& features) const
@@ -38,6 +38,21 @@ std::size_t populateDatabase(const sfmData::SfMData& sfmData,
                              Database& db,
                              const int Nmax = 0);
 
+/**
+ * @brief Given a vocabulary tree and a set of descriptor files it inserts their documents in a database
+ *
+ * @param[in] descriptorsFiles The descriptor file of each document to insert
+ * @param[in] tree The vocabulary tree to be used for feature quantization
+ * @param[in,out] db The database, which can already contain other documents
+ * @param[in] Nmax The maximum number of features loaded in each desc file. For Nmax = 0 (default), all the descriptors are loaded.
+ * @return the number of overall features read
+ */
+template<class DescriptorT, class VocDescriptorT>
+std::size_t populateDatabase(const std::map<IndexT, std::string>& descriptorsFiles,
+                             const VocabularyTree<VocDescriptorT>& tree,
+                             Database& db,
+                             const int Nmax = 0);
+
 /**
  * @brief Given an non empty database, it queries the database with a set of images
  * and their associated features and returns, for each image, the first \p numResults best
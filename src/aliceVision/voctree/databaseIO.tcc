@@ -29,6 +29,15 @@ std::size_t populateDatabase(const sfmData::SfMData& sfmData,
 {
   std::map<IndexT, std::string> descriptorsFiles;
   getListOfDescriptorFiles(sfmData, featuresFolders, descriptorsFiles);
+  return populateDatabase<DescriptorT>(descriptorsFiles, tree, db, Nmax);
+}
+
+template<class DescriptorT, class VocDescriptorT>
+std::size_t populateDatabase(const std::map<IndexT, std::string>& descriptorsFiles,
+                             const VocabularyTree<VocDescriptorT>& tree,
+                             Database& db,
+                             const int Nmax)
+{
   std::size_t numDescriptors = 0;
   
   // Read the descriptors
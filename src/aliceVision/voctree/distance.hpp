@@ -6,7 +6,11 @@
 
 #pragma once
 
+#include <aliceVision/feature/Descriptor.hpp>
+#include <aliceVision/feature/metricKernels.hpp>
+
 #include <stdint.h>
+#include <cstddef>
 #include <Eigen/Core>
 
 namespace aliceVision {
@@ -51,5 +55,26 @@ struct L2<Eigen::Matrix<Scalar, Rows, Cols, Options, MaxRows, MaxCols>, Eigen::M
     result_type operator()(const feature_type& a, const feature_type& b) const { return (a - b).squaredNorm(); }
 };
 
+/**
+ * @brief Squared L2 distance between two contiguous float vectors (SIMD instructions of the CPU).
+ * @param[in] a The first vector
+ * @param[in] b The second vector
+ * @param[in] size The number of elements
+ * @return the squared distance
+ */
+inline float squaredL2(const float* a, const float* b, std::size_t size) { return feature::squaredL2(a, b, size); }
+
+/// Specialization for float descriptors, with SIMD.
+
+template<std::size_t N>
+struct L2<feature::Descriptor<float, N>, feature::Descriptor<float, N>>
+{
+    typedef feature::Descriptor<float, N> feature_type;
+    typedef float value_type;
+    typedef double result_type;
+
+    result_type operator()(const feature_type& a, const feature_type& b) const { return squaredL2(a.getData(), b.getData(), N); }
+};
+
 }  // namespace voctree
 }  // namespace aliceVision
@@ -306,3 +306,49 @@ BOOST_AUTO_TEST_CASE(kmeanVarying)
         }
     }
 }
+
+BOOST_AUTO_TEST_CASE(kmeanMiniBatch)
+{
+    using namespace aliceVision;
+
+    makeRandomOperationsReproducible();
+
+    const std::size_t DIMENSION = 16;
+    const std::size_t FEATURENUMBER = 2000;
+    const std::size_t K = 8;
+
+    typedef Eigen::Matrix<float, 1, DIMENSION> FeatureFloat;
+    typedef std::vector<FeatureFloat> FeatureFloatVector;
+
+    // K clusters well far away
+    FeatureFloatVector features;
+    features.reserve(FEATURENUMBER * K);
+    for (std::size_t i = 0; i < K; ++i)
+    {
+        for (std::size_t j = 0; j < FEATURENUMBER; ++j)
+            features.push_back(FeatureFloat::Random(1, DIMENSION) + Eigen::MatrixXf::Constant(1, DIMENSION, 10 * i));
+    }
+
+    voctree::SimpleKmeans<FeatureFloat> kmeans(FeatureFloat::Zero());
+    kmeans.setRestarts(3);
+    kmeans.setMiniBatchSize(500);
+
+    FeatureFloatVector centers;
+    std::vector<unsigned int> membership;
+    kmeans.cluster(features, K, centers, membership);
+
+    BOOST_REQUIRE_EQUAL(centers.size(), K);
+    BOOST_REQUIRE_EQUAL(membership.size(), features.size());
+    BOOST_CHECK(voctree::checkVectorElements(centers, "miniBatch"));
+
+    // all the features of a cluster are assigned to the same center, and each center has its own cluster
+    std::vector<unsigned int> clusterCenter(K);
+    for (std::size_t i = 0; i < K; ++i)
+    {
+        clusterCenter[i] = membership[i * FEATURENUMBER];
+        for (std::size_t j = 0; j < FEATURENUMBER; ++j)
+            BOOST_CHECK_EQUAL(membership[i * FEATURENUMBER + j], clusterCenter[i]);
+    }
+    std::sort(clusterCenter.begin(), clusterCenter.end());
+    BOOST_CHECK(std::unique(clusterCenter.begin(), clusterCenter.end()) == clusterCenter.end());
+}
@@ -0,0 +1,96 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/voctree/MutableVocabularyTree.hpp>
+#include <aliceVision/feature/Descriptor.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+using namespace aliceVision::voctree;
+
+namespace {
+
+typedef aliceVision::feature::Descriptor<float, 128> DescriptorFloat;
+typedef aliceVision::feature::Descriptor<unsigned char, 128> DescriptorUChar;
+
+/// number of SIFT descriptors of a typical image
+const std::size_t nbDescriptors = 10000;
+
+/**
+ * @brief Tree with random centers (the quantization cost does not depend on the centers values).
+ */
+MutableVocabularyTree<DescriptorFloat> randomTree(uint32_t levels, uint32_t splits)
+{
+    MutableVocabularyTree<DescriptorFloat> tree;
+    tree.setSize(levels, splits);
+    tree.centers().resize(tree.nodes());
+    tree.validCenters().assign(tree.nodes(), 1);
+
+    std::mt19937 generator(0);
+    std::uniform_real_distribution<float> distribution(0.0f, 80.0f);
+    for (auto& center : tree.centers())
+        for (std::size_t i = 0; i < center.size(); ++i)
+            center[i] = distribution(generator);
+    return tree;
+}
+
+std::vector<DescriptorUChar> randomDescriptors()
+{
+    std::mt19937 generator(1);
+    std::uniform_int_distribution<int> distribution(0, 120);
+    std::vector<DescriptorUChar> descriptors(nbDescriptors);
+    for (auto& descriptor : descriptors)
+        for (std::size_t i = 0; i < descriptor.size(); ++i)
+            descriptor[i] = static_cast<unsigned char>(distribution(generator));
+    return descriptors;
+}
+
+/**
+ * @brief Quantization of the descriptors of an image, one descriptor at a time.
+ * @param state range(0): number of levels, range(1): number of splits per node
+ */
+void BM_quantize(benchmark::State& state)
+{
+    const MutableVocabularyTree<DescriptorFloat> tree = randomTree(state.range(0), state.range(1));
+    const std::vector<DescriptorUChar> descriptors = randomDescriptors();
+
+    for (auto _ : state)
+    {
+        for (const DescriptorUChar& descriptor : descriptors)
+        {
+            benchmark::DoNotOptimize(tree.quantize(descriptor));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * descriptors.size());
+}
+
+/**
+ * @brief Batched quantization of the descriptors of an image.
+ * @param state range(0): number of levels, range(1): number of splits per node
+ */
+void BM_quantizeBatch(benchmark::State& state)
+{
+    const MutableVocabularyTree<DescriptorFloat> tree = randomTree(state.range(0), state.range(1));
+    const std::vector<DescriptorUChar> descriptors = randomDescriptors();
+
+    for (auto _ : state)
+    {
+        const std::vector<Word> words = tree.quantize(descriptors);
+        benchmark::DoNotOptimize(words.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * descriptors.size());
+}
+
+}  // namespace
+
+// 80 splits and 3 levels is the default tree of the image matching (K80L3), a smaller and a deeper tree are added for comparison
+BENCHMARK(BM_quantize)->Args({2, 80})->Args({3, 80})->Args({5, 10})->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_quantizeBatch)->Args({2, 80})->Args({3, 80})->Args({5, 10})->Unit(benchmark::kMillisecond);
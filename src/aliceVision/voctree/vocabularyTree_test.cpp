@@ -5,9 +5,13 @@
 // You can obtain one at https://mozilla.org/MPL/2.0/.
 
 #include <aliceVision/voctree/Database.hpp>
+#include <aliceVision/voctree/GlobalDescriptorIndex.hpp>
+#include <aliceVision/voctree/MutableVocabularyTree.hpp>
+#include <aliceVision/feature/Descriptor.hpp>
 
 #include <iostream>
 #include <fstream>
+#include <random>
 #include <vector>
 
 #define BOOST_TEST_MODULE vocabularyTree
@@ -57,3 +61,215 @@ BOOST_AUTO_TEST_CASE(database)
         BOOST_CHECK_SMALL(static_cast<double>(match[0].score), 0.001);
     }
 }
+
+BOOST_AUTO_TEST_CASE(quantizeBlocks)
+{
+    typedef aliceVision::feature::Descriptor<float, 128> DescriptorFloat;
+    typedef aliceVision::feature::Descriptor<unsigned char, 128> DescriptorUChar;
+
+    // random tree with some missing children
+    MutableVocabularyTree<DescriptorFloat> tree;
+    tree.setSize(4, 10);
+    tree.centers().resize(tree.nodes());
+    tree.validCenters().assign(tree.nodes(), 1);
+
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<float> centerDistribution(0.0f, 80.0f);
+    for (auto& center : tree.centers())
+        for (std::size_t i = 0; i < center.size(); ++i)
+            center[i] = centerDistribution(generator);
+    for (std::size_t i = 7; i < tree.validCenters().size(); i += 31)
+        tree.validCenters()[i] = 0;
+
+    std::uniform_int_distribution<int> descriptorDistribution(0, 120);
+    std::vector<DescriptorUChar> descriptors(2000);
+    for (auto& descriptor : descriptors)
+        for (std::size_t i = 0; i < descriptor.size(); ++i)
+            descriptor[i] = static_cast<unsigned char>(descriptorDistribution(generator));
+
+    // the batched quantization gives the same words as the quantization of each descriptor
+    const std::vector<Word> words = tree.quantize(descriptors);
+    BOOST_REQUIRE_EQUAL(words.size(), descriptors.size());
+    for (std::size_t i = 0; i < descriptors.size(); ++i)
+        BOOST_CHECK_EQUAL(words[i], tree.quantize(descriptors[i]));
+}
+
+BOOST_AUTO_TEST_CASE(databaseInvertedIndex)
+{
+    const std::size_t nbWords = 300;
+    const std::size_t nbDocs = 60;
+
+    std::mt19937 generator(7);
+    std::uniform_int_distribution<Word> wordDistribution(0, nbWords - 1);
+    std::uniform_int_distribution<int> docSizeDistribution(0, 200);
+
+    Database db(nbWords);
+    std::vector<SparseHistogram> histograms(nbDocs);
+    for (std::size_t i = 0; i < nbDocs; ++i)
+    {
+        // documents with missing ids and repeated words
+        std::vector<Word> document(docSizeDistribution(generator));
+        for (auto& word : document)
+            word = wordDistribution(generator);
+        computeSparseHistogram(document, histograms[i]);
+        db.insert(3 * i + 1, histograms[i]);
+    }
+    db.computeTfIdfWeights();
+
+    std::vector<float> weights(nbWords);
+    {
+        // weights are only reachable through the weights file
+        const std::string weightsFile = "databaseInvertedIndex_weights.bin";
+        db.saveWeights(weightsFile);
+        std::ifstream in(weightsFile, std::ios_base::binary);
+        uint32_t nbWeights = 0;
+        in.read((char*)(&nbWeights), sizeof(uint32_t));
+        BOOST_REQUIRE_EQUAL(nbWeights, nbWords);
+        in.read((char*)(weights.data()), nbWords * sizeof(float));
+    }
+
+    std::vector<const SparseHistogram*> queries;
+    for (const auto& histogram : histograms)
+        queries.push_back(&histogram);
+
+    // the inverted index gives the same scores as the direct comparison of the histograms
+    for (const std::string distanceMethod : {"classic", "commonPoints", "strongCommonPoints", "inversedWeightedCommonPoints"})
+    {
+        std::vector<DocMatches> matches;
+        db.find(queries, nbDocs, matches, distanceMethod);
+        BOOST_REQUIRE_EQUAL(matches.size(), nbDocs);
+
+        for (std::size_t q = 0; q < nbDocs; ++q)
+        {
+            BOOST_REQUIRE_EQUAL(matches[q].size(), nbDocs);
+            for (std::size_t m = 0; m < nbDocs; ++m)
+            {
+                const DocMatch& match = matches[q][m];
+                const float distance = sparseDistance(histograms[q], histograms[(match.id - 1) / 3], distanceMethod, weights);
+                BOOST_CHECK_CLOSE(match.score, distance, 0.001);
+                if (m > 0)
+                    BOOST_CHECK_LE(matches[q][m - 1].score, match.score);
+            }
+        }
+
+        // the top N matches are the first N matches of the full list
+        std::vector<DocMatch> top;
+        db.find(histograms[5], 4, top, distanceMethod);
+        BOOST_REQUIRE_EQUAL(top.size(), 4);
+        for (std::size_t m = 0; m < top.size(); ++m)
+            BOOST_CHECK_EQUAL(top[m].id, matches[5][m].id);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(databaseSaveLoad)
+{
+    const std::size_t nbWords = 100;
+
+    std::mt19937 generator(11);
+    std::uniform_int_distribution<Word> wordDistribution(0, nbWords - 1);
+    const auto randomDocument = [&]() {
+        std::vector<Word> document(50);
+        for (auto& word : document)
+            word = wordDistribution(generator);
+        SparseHistogram histogram;
+        computeSparseHistogram(document, histogram);
+        return histogram;
+    };
+
+    Database db(nbWords);
+    for (DocId i = 0; i < 20; ++i)
+        db.insert(i, randomDocument());
+    db.computeTfIdfWeights();
+
+    const std::string databaseFile = "databaseSaveLoad.bin";
+    db.save(databaseFile);
+
+    Database loadedDb;
+    loadedDb.load(databaseFile);
+    BOOST_CHECK_EQUAL(loadedDb.size(), db.size());
+    BOOST_CHECK(loadedDb.getWeights() == db.getWeights());
+    BOOST_CHECK(loadedDb.getSparseHistogramPerImage() == db.getSparseHistogramPerImage());
+
+    // the loaded database can be appended with new documents
+    const SparseHistogram newDocument = randomDocument();
+    db.insert(20, newDocument);
+    loadedDb.insert(20, newDocument);
+    BOOST_CHECK(loadedDb.contains(20));
+
+    std::vector<DocMatch> matches;
+    std::vector<DocMatch> loadedMatches;
+    db.find(newDocument, 5, matches, "classic");
+    loadedDb.find(newDocument, 5, loadedMatches, "classic");
+    BOOST_CHECK(matches == loadedMatches);
+    BOOST_CHECK_EQUAL(loadedMatches.front().id, 20);
+}
+
+BOOST_AUTO_TEST_CASE(globalDescriptorIndex)
+{
+    typedef aliceVision::feature::Descriptor<float, 128> DescriptorFloat;
+    typedef aliceVision::feature::Descriptor<unsigned char, 128> DescriptorUChar;
+
+    MutableVocabularyTree<DescriptorFloat> tree;
+    tree.setSize(2, 8);
+    tree.centers().resize(tree.nodes());
+    tree.validCenters().assign(tree.nodes(), 1);
+
+    std::mt19937 generator(3);
+    std::uniform_real_distribution<float> centerDistribution(0.0f, 80.0f);
+    for (auto& center : tree.centers())
+        for (std::size_t i = 0; i < center.size(); ++i)
+            center[i] = centerDistribution(generator);
+
+    // global descriptors of random images
+    const std::size_t nbImages = 300;
+    std::uniform_int_distribution<int> descriptorDistribution(0, 120);
+    std::vector<std::vector<float>> globalDescriptors(nbImages);
+    for (auto& globalDescriptor : globalDescriptors)
+    {
+        std::vector<DescriptorUChar> descriptors(100);
+        for (auto& descriptor : descriptors)
+            for (std::size_t i = 0; i < descriptor.size(); ++i)
+                descriptor[i] = static_cast<unsigned char>(descriptorDistribution(generator));
+        globalDescriptor = tree.computeVLAD(descriptors, 0);
+
+        BOOST_REQUIRE_EQUAL(globalDescriptor.size(), 8 * 128);
+        double squaredNorm = 0.0;
+        for (const float v : globalDescriptor)
+            squaredNorm += v * v;
+        BOOST_CHECK_CLOSE(squaredNorm, 1.0, 0.01);
+    }
+
+    // probing all the lists gives the exact nearest neighbors
+    GlobalDescriptorIndex exactIndex(1000);
+    GlobalDescriptorIndex index(4);
+    for (std::size_t i = 0; i < nbImages; ++i)
+    {
+        exactIndex.insert(i, globalDescriptors[i]);
+        index.insert(i, globalDescriptors[i]);
+    }
+    exactIndex.build();
+    index.build();
+    BOOST_CHECK_EQUAL(index.nbLists(), 17);
+
+    for (std::size_t i = 0; i < nbImages; ++i)
+    {
+        std::vector<float> distances(nbImages);
+        for (std::size_t j = 0; j < nbImages; ++j)
+            distances[j] = squaredL2(globalDescriptors[i].data(), globalDescriptors[j].data(), globalDescriptors[i].size());
+        std::vector<float> sortedDistances = distances;
+        std::sort(sortedDistances.begin(), sortedDistances.end());
+
+        DocMatches exactMatches;
+        exactIndex.find(globalDescriptors[i], 5, exactMatches);
+        BOOST_REQUIRE_EQUAL(exactMatches.size(), 5);
+        for (std::size_t m = 0; m < exactMatches.size(); ++m)
+            BOOST_CHECK_EQUAL(exactMatches[m].score, sortedDistances[m]);
+
+        // the document itself is always in one of the probed lists
+        DocMatches matches;
+        index.find(globalDescriptors[i], 5, matches);
+        BOOST_REQUIRE(!matches.empty());
+        BOOST_CHECK_EQUAL(matches.front().id, i);
+        BOOST_CHECK_EQUAL(matches.front().score, 0.0f);
+    }
+}
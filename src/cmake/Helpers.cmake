@@ -275,3 +275,73 @@ function(alicevision_add_test test_file)
   endif()
 
 endfunction()
+
+# Add micro-benchmark function
+# The 'benchmarks' target runs all the micro-benchmarks and writes one JSON report per benchmark
+# in <build>/benchmarks/<target architecture>, to track the results per architecture.
+function(alicevision_add_benchmark benchmark_file)
+  set(options "")
+  set(singleValues NAME)
+  set(multipleValues LINKS INCLUDE_DIRS)
+
+  cmake_parse_arguments(BENCHMARK "${options}" "${singleValues}" "${multipleValues}" ${ARGN})
+
+  if(NOT benchmark_file)
+    message(FATAL_ERROR "You must provide the benchmark file in 'alicevision_add_benchmark'")
+  endif()
+
+  if(NOT BENCHMARK_NAME)
+    message(FATAL_ERROR "You must provide the NAME in 'alicevision_add_benchmark'")
+  endif()
+
+  if(NOT ALICEVISION_HAVE_BENCHMARK)
+    return()
+  endif()
+
+  set(BENCHMARK_EXECUTABLE_NAME "aliceVision_benchmark_${BENCHMARK_NAME}")
+
+  add_executable(${BENCHMARK_EXECUTABLE_NAME} ${benchmark_file})
+
+  target_link_libraries(${BENCHMARK_EXECUTABLE_NAME}
+    PUBLIC ${BENCHMARK_LINKS}
+           ${ALICEVISION_LIBRARY_DEPENDENCIES}
+           benchmark::benchmark_main
+  )
+
+  target_include_directories(${BENCHMARK_EXECUTABLE_NAME}
+    PUBLIC ${BENCHMARK_INCLUDE_DIRS}
+  )
+
+  set_property(TARGET ${BENCHMARK_EXECUTABLE_NAME}
+    PROPERTY FOLDER Benchmark
+  )
+
+  if(NOT TARGET benchmarks)
+    add_custom_target(benchmarks
+      COMMENT "Running the micro-benchmarks"
+    )
+    set_property(TARGET benchmarks
+      PROPERTY FOLDER Benchmark
+    )
+  endif()
+
+  set(BENCHMARK_OUTPUT_DIR "${CMAKE_BINARY_DIR}/benchmarks/${TARGET_ARCHITECTURE}")
+
+  add_custom_target(run_${BENCHMARK_EXECUTABLE_NAME}
+    COMMAND ${CMAKE_COMMAND} -E make_directory ${BENCHMARK_OUTPUT_DIR}
+    COMMAND $<TARGET_FILE:${BENCHMARK_EXECUTABLE_NAME}>
+            --benchmark_out=${BENCHMARK_OUTPUT_DIR}/${BENCHMARK_NAME}.json
+            --benchmark_out_format=json
+            --benchmark_context=architecture=${TARGET_ARCHITECTURE},compiler=${CMAKE_CXX_COMPILER_ID}-${CMAKE_CXX_COMPILER_VERSION}
+    DEPENDS ${BENCHMARK_EXECUTABLE_NAME}
+    VERBATIM
+    USES_TERMINAL
+  )
+
+  set_property(TARGET run_${BENCHMARK_EXECUTABLE_NAME}
+    PROPERTY FOLDER Benchmark
+  )
+
+  add_dependencies(benchmarks run_${BENCHMARK_EXECUTABLE_NAME})
+
+endfunction()
@@ -665,6 +665,10 @@ Gaussian window size is set to have standard deviation
 #include <math.h>
 #include <stdio.h>
 
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
 /** @internal @brief Use bilinear interpolation to compute orientations */
 #define VL_SIFT_BILINEAR_ORIENTATIONS 1
 
@@ -802,17 +806,46 @@ _vl_sift_smooth (VlSiftFilt * self,
     return ;
   }
 
-  vl_imconvcol_vf (tempImage, height,
-                   inputImage, width, height, width,
-                   self->gaussFilter,
-                   - self->gaussFilterWidth, self->gaussFilterWidth,
-                   1, VL_PAD_BY_CONTINUITY | VL_TRANSPOSE) ;
-
-  vl_imconvcol_vf (outputImage, width,
-                   tempImage, height, width, height,
-                   self->gaussFilter,
-                   - self->gaussFilterWidth, self->gaussFilterWidth,
-                   1, VL_PAD_BY_CONTINUITY | VL_TRANSPOSE) ;
+  /* The columns are filtered independently, so both passes are split
+   * in bands of columns filtered in parallel. The bands start on
+   * multiples of 4 columns to keep the SSE2 alignment. */
+  {
+    vl_index nbBands = 1 ;
+    vl_index band ;
+#if defined(_OPENMP)
+    nbBands = VL_MAX(VL_MIN((vl_index)omp_get_max_threads(), (vl_index)VL_MIN(width, height) / 64), 1) ;
+#endif
+
+#if defined(_OPENMP)
+#pragma omp parallel for if(nbBands > 1)
+#endif
+    for (band = 0 ; band < nbBands ; ++band) {
+      vl_index const x0 = ((band * (vl_index)width / nbBands) / 4) * 4 ;
+      vl_index const x1 = (band + 1 == nbBands) ? (vl_index)width : (((band + 1) * (vl_index)width / nbBands) / 4) * 4 ;
+      if (x1 > x0) {
+        vl_imconvcol_vf (tempImage + x0 * height, height,
+                         inputImage + x0, x1 - x0, height, width,
+                         self->gaussFilter,
+                         - self->gaussFilterWidth, self->gaussFilterWidth,
+                         1, VL_PAD_BY_CONTINUITY | VL_TRANSPOSE) ;
+      }
+    }
+
+#if defined(_OPENMP)
+#pragma omp parallel for if(nbBands > 1)
+#endif
+    for (band = 0 ; band < nbBands ; ++band) {
+      vl_index const y0 = ((band * (vl_index)height / nbBands) / 4) * 4 ;
+      vl_index const y1 = (band + 1 == nbBands) ? (vl_index)height : (((band + 1) * (vl_index)height / nbBands) / 4) * 4 ;
+      if (y1 > y0) {
+        vl_imconvcol_vf (outputImage + y0 * width, width,
+                         tempImage + y0, y1 - y0, width, height,
+                         self->gaussFilter,
+                         - self->gaussFilterWidth, self->gaussFilterWidth,
+                         1, VL_PAD_BY_CONTINUITY | VL_TRANSPOSE) ;
+      }
+    }
+  }
 }
 
 /** ------------------------------------------------------------------
@@ -1173,14 +1206,17 @@ vl_sift_detect (VlSiftFilt * f)
   /* clear current list */
   f-> nkeys = 0 ;
 
-  /* compute difference of gaussian (DoG) */
-  pt = f-> dog ;
+  /* compute difference of gaussian (DoG), the scales in parallel */
+#if defined(_OPENMP)
+#pragma omp parallel for
+#endif
   for (s = s_min ; s <= s_max - 1 ; ++s) {
     vl_sift_pix* src_a = vl_sift_get_octave (f, s    ) ;
     vl_sift_pix* src_b = vl_sift_get_octave (f, s + 1) ;
     vl_sift_pix* end_a = src_a + w * h ;
+    vl_sift_pix* pt_s = f-> dog + (vl_size)(s - s_min) * w * h ;
     while (src_a != end_a) {
-      *pt++ = *src_b++ - *src_a++ ;
+      *pt_s++ = *src_b++ - *src_a++ ;
     }
   }
 
@@ -1457,6 +1493,10 @@ vl_sift_update_gradient (VlSiftFilt *f)
 
   if (f->grad_o == f->o_cur) return ;
 
+  /* the scales are processed in parallel */
+#if defined(_OPENMP)
+#pragma omp parallel for private(y)
+#endif
   for (s  = s_min + 1 ;
        s <= s_max - 2 ; ++ s) {
 
@@ -95,9 +95,16 @@ int aliceVision_main(int argc, char** argv)
 
     flags = (flags) ? flags : sfmDataIO::ALL;
 
+    // only load the parts of the scene which are saved or needed by the filters
+    int loadFlags = flags;
+    if (!imageWhiteList.empty())
+        loadFlags |= sfmDataIO::VIEWS;
+    if (describerTypesName.empty())
+        loadFlags &= ~(sfmDataIO::STRUCTURE | sfmDataIO::OBSERVATIONS | sfmDataIO::OBSERVATIONS_WITH_FEATURES);
+
     // load input SfMData scene
     sfmData::SfMData sfmData;
-    if (!sfmDataIO::load(sfmData, sfmDataFilename, sfmDataIO::ESfMData::ALL))
+    if (!sfmDataIO::load(sfmData, sfmDataFilename, sfmDataIO::ESfMData(loadFlags)))
     {
         ALICEVISION_LOG_ERROR("The input SfMData file '" << sfmDataFilename << "' cannot be read");
         return EXIT_FAILURE;
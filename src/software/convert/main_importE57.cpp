@@ -18,12 +18,15 @@
 #include <boost/program_options.hpp>
 #include "nanoflann.hpp"
 
+#include <exception>
 #include <fstream>
+#include <future>
+#include <unordered_map>
 
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 1
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 1
 
 using namespace aliceVision;
 
@@ -205,17 +208,28 @@ int aliceVision_main(int argc, char** argv)
     reader.reset();
 
     // Create buffers for reading
-    std::vector<dataio::E57Reader::PointInfo> vertices;
-    Eigen::Matrix<size_t, -1, -1> grid;
+    // the next scan is decoded while the current one is filtered
+    std::vector<dataio::E57Reader::PointInfo> vertices, nextVertices;
+    Eigen::Vector3d nextSensorPosition;
+    int64_t maxRows = 0, maxColumns = 0, nextMaxRows = 0, nextMaxColumns = 0;
+    const auto readNext = [&]() { return reader.getNext(nextSensorPosition, nextVertices, nextMaxRows, nextMaxColumns); };
 
     ALICEVISION_LOG_INFO("Extracting Meshes");
     // Loop through all meshes
     std::vector<dataio::E57Reader::PointInfo> allVertices;
-    while (reader.getNext(sensorPosition, vertices, grid))
+    std::future<bool> reading = std::async(std::launch::async, readNext);
+    while (reading.get())
     {
+        std::swap(vertices, nextVertices);
+        sensorPosition = nextSensorPosition;
+        maxRows = nextMaxRows;
+        maxColumns = nextMaxColumns;
+
         const int idMesh = reader.getIdMesh();
         ALICEVISION_LOG_INFO("Extracting Mesh " << idMesh);
 
+        reading = std::async(std::launch::async, readNext);
+
         PointInfoVectorAdaptator pointCloudRef(vertices);
 
         nanoflann::KDTreeSingleIndexAdaptorParams params(10, nanoflann::KDTreeSingleIndexAdaptorFlags::None, 0);
@@ -226,7 +240,7 @@ int aliceVision_main(int argc, char** argv)
         ALICEVISION_LOG_INFO("Built tree");
 
         // Angular definition of a ray
-        double angularRes = 2.0 * M_PI / std::max(grid.rows(), grid.cols());
+        double angularRes = 2.0 * M_PI / std::max(maxRows, maxColumns);
         double cord = 2.0 * sin(angularRes * 0.5);
         double maxLength = 1.5 * maxDensity / cord;
 
@@ -271,6 +285,9 @@ int aliceVision_main(int argc, char** argv)
 
         ALICEVISION_LOG_INFO("Mesh has " << allVertices.size() - originalSize << " points");
     }
+    // release the buffers of the scans before the final point cloud
+    std::vector<dataio::E57Reader::PointInfo>().swap(vertices);
+    std::vector<dataio::E57Reader::PointInfo>().swap(nextVertices);
 
     {
         ALICEVISION_LOG_INFO("Building final point cloud");
@@ -347,45 +364,115 @@ int aliceVision_main(int argc, char** argv)
 
     ALICEVISION_LOG_INFO("Generating " << list.size() << "sub regions");
 
-    fuseCut::InputSet inputs;
+    // Add borders of 20 cm
+    const double border = 0.2;
 
+    // Assign the landmarks to the sub regions in one pass over the octree
+    std::unordered_map<fuseCut::SimpleNode::ptr, int> nodeToRegion;
     for (int id = 0; id < list.size(); id++)
     {
-        const auto& item = list[id];
+        nodeToRegion[list[id]] = id;
+    }
 
-        Eigen::Vector3d bbmin = item->getBBMin();
-        Eigen::Vector3d bbmax = item->getBBMax();
+    std::vector<std::vector<IndexT>> regionLandmarks(list.size());
+    {
+        const sfmData::Landmarks& landmarks = sfmData.getLandmarks();
+        std::vector<fuseCut::SimpleNode::ptr> nodes;
+        for (const auto& pt : landmarks)
+        {
+            nodes.clear();
+            octree.getNodesContaining(pt.second.X, border, nodes);
+            for (const auto& node : nodes)
+            {
+                regionLandmarks[nodeToRegion.at(node)].push_back(pt.first);
+            }
+        }
+    }
 
-        // Add borders of 20 cm
-        Eigen::Vector3d center = (bbmin + bbmax) * 0.2;
-        bbmin -= Eigen::Vector3d::Ones() * 0.2;
-        bbmax += Eigen::Vector3d::Ones() * 0.2;
+    // Save the sub regions concurrently, the number of regions in memory is bounded by their size
+    size_t maxRegionPoints = 1;
+    for (const auto& ids : regionLandmarks)
+    {
+        maxRegionPoints = std::max(maxRegionPoints, ids.size());
+    }
+    // landmark with its observation, in the sub SfMData and in the writer buffers
+    const double regionMemory = static_cast<double>(maxRegionPoints) * 2.0 * (sizeof(sfmData::Landmarks::value_type) + 128);
+    const int nbParallelRegions =
+      std::max(1, std::min(static_cast<int>(hwc.getMaxThreads()), static_cast<int>(static_cast<double>(hwc.getMaxMemory()) / regionMemory)));
+    ALICEVISION_LOG_INFO("Save " << nbParallelRegions << " sub regions in parallel.");
 
-        double sx = std::abs(bbmax.x() - bbmin.x());
-        double sy = std::abs(bbmax.y() - bbmin.y());
-        double sz = std::abs(bbmax.z() - bbmin.z());
+    fuseCut::InputSet inputs(list.size());
+    std::exception_ptr exception;
 
-        ALICEVISION_LOG_INFO("Local Bounding box: " << sx << " x " << sy << " x " << sz);
+#pragma omp parallel for schedule(dynamic) num_threads(nbParallelRegions)
+    for (int id = 0; id < list.size(); id++)
+    {
+        if (exception)
+        {
+            continue;
+        }
+
+        try
+        {
+            const auto& item = list[id];
 
-        sfmData::SfMData subSfmData(sfmData, bbmin, bbmax);
+            Eigen::Vector3d bbmin = item->getBBMin();
+            Eigen::Vector3d bbmax = item->getBBMax();
 
-        ALICEVISION_LOG_INFO("local count : " << subSfmData.getLandmarks().size() << " points");
+            bbmin -= Eigen::Vector3d::Ones() * border;
+            bbmax += Eigen::Vector3d::Ones() * border;
 
-        std::filesystem::path p = outputJsonFilename;
-        std::filesystem::path transformed = p.parent_path() / "sfm";
-        transformed += "_";
-        transformed += std::to_string(id);
-        transformed += ".abc";
+            double sx = std::abs(bbmax.x() - bbmin.x());
+            double sy = std::abs(bbmax.y() - bbmin.y());
+            double sz = std::abs(bbmax.z() - bbmin.z());
 
-        fuseCut::Input input;
-        input.bbMin = bbmin;
-        input.bbMax = bbmax;
-        input.sfmPath = transformed.string();
+            ALICEVISION_LOG_INFO("Local Bounding box: " << sx << " x " << sy << " x " << sz);
 
-        ALICEVISION_LOG_INFO("Saving to " << input.sfmPath);
-        sfmDataIO::save(subSfmData, input.sfmPath, sfmDataIO::ESfMData::ALL);
+            // same content as sfmData::SfMData(sfmData, bbmin, bbmax), without iterating over all the landmarks
+            sfmData::SfMData subSfmData;
+            subSfmData.getViews() = sfmData.getViews();
+            subSfmData.getIntrinsics() = sfmData.getIntrinsics();
+            subSfmData.getPoses() = sfmData.getPoses();
 
-        inputs.push_back(input);
+            sfmData::Landmarks& subLandmarks = subSfmData.getLandmarks();
+            for (const IndexT landmarkId : regionLandmarks[id])
+            {
+                subLandmarks.emplace(landmarkId, sfmData.getLandmarks().at(landmarkId));
+            }
+            std::vector<IndexT>().swap(regionLandmarks[id]);
+
+            ALICEVISION_LOG_INFO("local count : " << subSfmData.getLandmarks().size() << " points");
+
+            std::filesystem::path p = outputJsonFilename;
+            std::filesystem::path transformed = p.parent_path() / "sfm";
+            transformed += "_";
+            transformed += std::to_string(id);
+            transformed += ".abc";
+
+            fuseCut::Input& input = inputs[id];
+            input.bbMin = bbmin;
+            input.bbMax = bbmax;
+            input.ownedBbMin = item->getBBMin();
+            input.ownedBbMax = item->getBBMax();
+            input.sfmPath = transformed.string();
+            input.nbPoints = subSfmData.getLandmarks().size();
+
+            ALICEVISION_LOG_INFO("Saving to " << input.sfmPath);
+            if (!sfmDataIO::save(subSfmData, input.sfmPath, sfmDataIO::ESfMData::ALL))
+            {
+                throw std::runtime_error("Cannot save the sub region to " + input.sfmPath);
+            }
+        }
+        catch (...)
+        {
+#pragma omp critical
+            exception = std::current_exception();
+        }
+    }
+
+    if (exception)
+    {
+        std::rethrow_exception(exception);
     }
 
     std::ofstream of(outputJsonFilename);
@@ -19,7 +19,7 @@
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 1
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 1
 
 using namespace aliceVision;
 
@@ -31,6 +31,7 @@ int aliceVision_main(int argc, char* argv[])
     std::string sfmDataFilename;
     std::string outDirectory;
     bool copyImages{false};
+    bool binary{false};
 
     // clang-format off
     po::options_description requiredParams("Required parameters");
@@ -42,7 +43,9 @@ int aliceVision_main(int argc, char* argv[])
          "and points3D.txt files.")
         ("copyImages", po::value<bool>(&copyImages)->default_value(copyImages),
          "Copy original images to Colmap folder. This is required if your images are not all in the same "
-         "folder.");
+         "folder.")
+        ("binary", po::value<bool>(&binary)->default_value(binary),
+         "Write the binary cameras.bin, images.bin and points3D.bin files instead of the text files.");
     // clang-format on
 
     CmdLine cmdline("Export an AV SfMData to a Colmap scene, creating the folder structure and "
@@ -67,7 +70,7 @@ int aliceVision_main(int argc, char* argv[])
         return EXIT_FAILURE;
     }
 
-    sfmDataIO::convertToColmapScene(sfmData, outDirectory, copyImages);
+    sfmDataIO::convertToColmapScene(sfmData, outDirectory, copyImages, binary);
 
     return EXIT_SUCCESS;
 }
\ No newline at end of file
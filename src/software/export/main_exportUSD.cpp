@@ -162,10 +162,13 @@ int aliceVision_main(int argc, char** argv)
     VtArray<GfVec3f> pointsData;
     pointsData.resize(inputMesh->pts.size());
 
+    // raw access, the VtArray accessors check the copy-on-write at each call
+    auto* pointsDataPtr = pointsData.data();
+#pragma omp parallel for
     for (int i = 0; i < inputMesh->pts.size(); ++i)
     {
         const Point3d& point = inputMesh->pts[i];
-        pointsData[i] = {static_cast<float>(point.x), static_cast<float>(-point.y), static_cast<float>(-point.z)};
+        pointsDataPtr[i] = {static_cast<float>(point.x), static_cast<float>(-point.y), static_cast<float>(-point.z)};
     }
 
     points.Set(pointsData);
@@ -189,11 +192,13 @@ int aliceVision_main(int argc, char** argv)
     VtArray<int> faceVertexIndicesData;
     faceVertexIndicesData.resize(inputMesh->tris.size() * 3);
 
+    auto* faceVertexIndicesDataPtr = faceVertexIndicesData.data();
+#pragma omp parallel for
     for (int i = 0; i < inputMesh->tris.size(); ++i)
     {
-        faceVertexIndicesData[i * 3] = inputMesh->tris[i].v[0];
-        faceVertexIndicesData[i * 3 + 1] = inputMesh->tris[i].v[1];
-        faceVertexIndicesData[i * 3 + 2] = inputMesh->tris[i].v[2];
+        faceVertexIndicesDataPtr[i * 3] = inputMesh->tris[i].v[0];
+        faceVertexIndicesDataPtr[i * 3 + 1] = inputMesh->tris[i].v[1];
+        faceVertexIndicesDataPtr[i * 3 + 2] = inputMesh->tris[i].v[2];
     }
     faceVertexIndices.Set(faceVertexIndicesData);
 
@@ -203,21 +208,25 @@ int aliceVision_main(int argc, char** argv)
         VtArray<GfVec3f> normalsData;
         normalsData.resize(inputMesh->normals.size());
 
+        auto* normalsDataPtr = normalsData.data();
+#pragma omp parallel for
         for (int i = 0; i < inputMesh->normals.size(); ++i)
         {
             const Point3d& normal = inputMesh->normals[i];
-            normalsData[i] = {static_cast<float>(normal.x), static_cast<float>(-normal.y), static_cast<float>(-normal.z)};
+            normalsDataPtr[i] = {static_cast<float>(normal.x), static_cast<float>(-normal.y), static_cast<float>(-normal.z)};
         }
 
         VtIntArray normalIndices;
         normalIndices.resize(inputMesh->trisNormalsIds.size() * 3);
 
+        auto* normalIndicesPtr = normalIndices.data();
+#pragma omp parallel for
         for (int i = 0; i < inputMesh->trisNormalsIds.size(); ++i)
         {
             const Voxel& indices = inputMesh->trisNormalsIds[i];
-            normalIndices[i * 3] = indices.x;
-            normalIndices[i * 3 + 1] = indices.y;
-            normalIndices[i * 3 + 2] = indices.z;
+            normalIndicesPtr[i * 3] = indices.x;
+            normalIndicesPtr[i * 3 + 1] = indices.y;
+            normalIndicesPtr[i * 3 + 2] = indices.z;
         }
 
         UsdGeomPrimvarsAPI primvarsApi = UsdGeomPrimvarsAPI(mesh);
@@ -232,10 +241,12 @@ int aliceVision_main(int argc, char** argv)
         VtArray<GfVec3f> normalsData;
         normalsData.resize(normals.size());
 
+        auto* normalsDataPtr = normalsData.data();
+#pragma omp parallel for
         for (int i = 0; i < normals.size(); ++i)
         {
             const Point3d& normal = normals[i];
-            normalsData[i] = {static_cast<float>(normal.x), static_cast<float>(-normal.y), static_cast<float>(-normal.z)};
+            normalsDataPtr[i] = {static_cast<float>(normal.x), static_cast<float>(-normal.y), static_cast<float>(-normal.z)};
         }
 
         UsdAttribute normalsAttr = mesh.CreateNormalsAttr();
@@ -248,21 +259,25 @@ int aliceVision_main(int argc, char** argv)
         VtArray<GfVec2f> uvsData;
         uvsData.resize(inputMesh->uvCoords.size());
 
+        auto* uvsDataPtr = uvsData.data();
+#pragma omp parallel for
         for (int i = 0; i < inputMesh->uvCoords.size(); ++i)
         {
             const Point2d& coord = inputMesh->uvCoords[i];
-            uvsData[i] = {static_cast<float>(coord.x), static_cast<float>(coord.y)};
+            uvsDataPtr[i] = {static_cast<float>(coord.x), static_cast<float>(coord.y)};
         }
 
         VtIntArray uvsIndices;
         uvsIndices.resize(inputMesh->trisUvIds.size() * 3);
 
+        auto* uvsIndicesPtr = uvsIndices.data();
+#pragma omp parallel for
         for (int i = 0; i < inputMesh->trisUvIds.size(); ++i)
         {
             const Voxel& indices = inputMesh->trisUvIds[i];
-            uvsIndices[i * 3] = indices.x;
-            uvsIndices[i * 3 + 1] = indices.y;
-            uvsIndices[i * 3 + 2] = indices.z;
+            uvsIndicesPtr[i * 3] = indices.x;
+            uvsIndicesPtr[i * 3 + 1] = indices.y;
+            uvsIndicesPtr[i * 3 + 2] = indices.z;
         }
 
         UsdGeomPrimvarsAPI primvarsApi = UsdGeomPrimvarsAPI(mesh);
@@ -318,14 +333,12 @@ int aliceVision_main(int argc, char** argv)
     const fs::path sourceFolder = fs::path(inputMeshPath).parent_path();
     const fs::path destinationFolder = fs::canonical(outputFolderPath);
 
-    for (int i = 0; i < texturing.material.numAtlases(); ++i)
+    // getAllTextures already lists the textures of all the atlases
+    for (const auto& texture : texturing.material.getAllTextures())
     {
-        for (const auto& texture : texturing.material.getAllTextures())
+        if (utils::exists(sourceFolder / texture))
         {
-            if (utils::exists(sourceFolder / texture))
-            {
-                fs::copy_file(sourceFolder / texture, destinationFolder / texture, fs::copy_options::update_existing);
-            }
+            fs::copy_file(sourceFolder / texture, destinationFolder / texture, fs::copy_options::update_existing);
         }
     }
 
@@ -342,14 +355,11 @@ int aliceVision_main(int argc, char** argv)
         }
 
         writer.AddFile(stagePath.string(), "texturedMesh." + extension);
-        for (int i = 0; i < texturing.material.numAtlases(); ++i)
+        for (const auto& texture : texturing.material.getAllTextures())
         {
-            for (const auto& texture : texturing.material.getAllTextures())
+            if (utils::exists(destinationFolder / texture))
             {
-                if (utils::exists(destinationFolder / texture))
-                {
-                    writer.AddFile((destinationFolder / texture).string(), texture);
-                }
+                writer.AddFile((destinationFolder / texture).string(), texture);
             }
         }
         writer.Save();
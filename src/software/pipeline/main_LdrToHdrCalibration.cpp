@@ -38,7 +38,7 @@
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 0
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 1
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 2
 
 using namespace aliceVision;
 using namespace aliceVision::hdr;
@@ -91,6 +91,35 @@ void computeLuminanceStatFromSamples(const std::vector<hdr::ImageSample>& sample
     }
 }
 
+/**
+ * @brief Read the samples extracted for a group by the sampling step.
+ * @param[out] samples the samples of the group
+ * @param[in] samplesFolder the folder of the samples files
+ * @param[in] firstViewId the id of the first view of the group, used to name the file
+ * @return false if the file cannot be read
+ */
+bool readSamples(std::vector<hdr::ImageSample>& samples, const std::string& samplesFolder, IndexT firstViewId)
+{
+    const std::string samplesFilepath = (fs::path(samplesFolder) / (std::to_string(firstViewId) + "_samples.dat")).string();
+    std::ifstream fileSamples(samplesFilepath, std::ios::binary);
+    if (!fileSamples.is_open())
+    {
+        ALICEVISION_LOG_ERROR("Cannot read samples from file " << samplesFilepath << ".");
+        return false;
+    }
+
+    std::size_t size = 0;
+    fileSamples.read((char*)&size, sizeof(size));
+
+    samples.resize(size);
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        fileSamples >> samples[i];
+    }
+
+    return true;
+}
+
 void computeLuminanceInfoFromImage(image::Image<image::RGBfColor>& image, luminanceInfo& lumaInfo)
 {
     // Luminance statistics are calculated from a subsampled square, centered and rotated by 45 degree.
@@ -149,6 +178,7 @@ int aliceVision_main(int argc, char** argv)
     int channelQuantizationPower = 10;
     image::EImageColorSpace workingColorSpace = image::EImageColorSpace::AUTO;
     std::size_t maxTotalPoints = 1000000;
+    std::size_t maxSamplesPerValue = 500;
     bool byPass = false;
 
     // Command line parameters
@@ -181,7 +211,10 @@ int aliceVision_main(int argc, char** argv)
          ("Working color space: " + image::EImageColorSpace_informations()).c_str())
         ("maxTotalPoints", po::value<std::size_t>(&maxTotalPoints)->default_value(maxTotalPoints),
          "Maximum number of points used from the sampling. This ensures that the number of pixels values extracted by "
-         "the sampling can be managed by the calibration step (in terms of computation time and memory usage).");
+         "the sampling can be managed by the calibration step (in terms of computation time and memory usage).")
+        ("maxSamplesPerValue", po::value<std::size_t>(&maxSamplesPerValue)->default_value(maxSamplesPerValue),
+         "Maximum number of samples kept for each quantized value of each channel and exposure while analyzing the groups. "
+         "This bounds the memory usage of the analysis whatever the number of groups.");
     // clang-format on
 
     CmdLine cmdline("This program recovers the Camera Response Function (CRF) from samples extracted from LDR images with multi-bracketing.\n"
@@ -314,57 +347,73 @@ int aliceVision_main(int argc, char** argv)
                 groupedExposures.push_back(getExposures(exposuresSetting));
             }
 
-            std::size_t group_pos = 0;
-            hdr::Sampling sampling;
-
-            ALICEVISION_LOG_INFO("Analyzing samples for each group.");
-            for (auto& group : groupedViews)
+            // Only the groups with views have samples
+            std::vector<std::size_t> groupIndices;
+            for (std::size_t i = 0; i < groupedViews.size(); ++i)
             {
-                if (group.size() == 0)
+                if (!groupedViews[i].empty())
                 {
-                    continue;
+                    groupIndices.push_back(i);
                 }
+            }
 
-                bool first = true;
-                IndexT firstViewId = group.begin()->get()->getViewId();
+            hdr::Sampling sampling(maxSamplesPerValue);
+            v_luminanceInfos.resize(groupIndices.size());
 
-                // Read from file
-                const std::string samplesFilepath = (fs::path(samplesFolder) / (std::to_string(firstViewId) + "_samples.dat")).string();
-                std::ifstream fileSamples(samplesFilepath, std::ios::binary);
-                if (!fileSamples.is_open())
+            // The groups are analyzed in parallel, each thread keeps its own bounded reservoirs
+            // which are merged at the end: only the samples of the groups being read are in memory.
+            ALICEVISION_LOG_INFO("Analyzing samples for each group.");
+            {
+                // Each sampling is constructed to get its own random generator
+                std::vector<hdr::Sampling> threadSamplings;
+                for (int i = 0; i < omp_get_max_threads(); ++i)
                 {
-                    ALICEVISION_LOG_ERROR("Cannot read samples from file " << samplesFilepath << ".");
-                    return EXIT_FAILURE;
+                    threadSamplings.emplace_back(maxSamplesPerValue);
                 }
+                bool readError = false;
 
-                std::size_t size;
-                fileSamples.read((char*)&size, sizeof(size));
-
-                std::vector<hdr::ImageSample> samples(size);
-                for (std::size_t i = 0; i < size; ++i)
+#pragma omp parallel for schedule(dynamic)
+                for (int group_pos = 0; group_pos < groupIndices.size(); ++group_pos)
                 {
-                    fileSamples >> samples[i];
-                }
+                    const auto& group = groupedViews[groupIndices[group_pos]];
+                    const IndexT firstViewId = group.begin()->get()->getViewId();
+
+                    std::vector<hdr::ImageSample> samples;
+                    if (!readSamples(samples, samplesFolder, firstViewId))
+                    {
+#pragma omp critical
+                        readError = true;
+                        continue;
+                    }
 
-                sampling.analyzeSource(samples, channelQuantization, group_pos);
+                    threadSamplings[omp_get_thread_num()].analyzeSource(samples, channelQuantization, group_pos);
 
-                std::map<int, luminanceInfo> luminanceInfos;
-                computeLuminanceStatFromSamples(samples, luminanceInfos);
+                    std::map<int, luminanceInfo> luminanceInfos;
+                    computeLuminanceStatFromSamples(samples, luminanceInfos);
 
-                // Check that all views in the group have an associated luminance stat info
-                for (const auto& v : group)
-                {
-                    if (luminanceInfos.find(v->getViewId()) == luminanceInfos.end())
+                    // Check that all views in the group have an associated luminance stat info
+                    for (const auto& v : group)
                     {
-                        luminanceInfo lumaInfo;
-                        lumaInfo.exposure = -1.0;  // Dummy exposure used later indicating a dummy info
-                        luminanceInfos[v->getViewId()] = lumaInfo;
+                        if (luminanceInfos.find(v->getViewId()) == luminanceInfos.end())
+                        {
+                            luminanceInfo lumaInfo;
+                            lumaInfo.exposure = -1.0;  // Dummy exposure used later indicating a dummy info
+                            luminanceInfos[v->getViewId()] = lumaInfo;
+                        }
                     }
+
+                    v_luminanceInfos[group_pos] = std::move(luminanceInfos);
                 }
 
-                v_luminanceInfos.push_back(luminanceInfos);
+                if (readError)
+                {
+                    return EXIT_FAILURE;
+                }
 
-                ++group_pos;
+                for (const hdr::Sampling& threadSampling : threadSamplings)
+                {
+                    sampling.merge(threadSampling);
+                }
             }
 
             if (!byPass)
@@ -372,52 +421,37 @@ int aliceVision_main(int argc, char** argv)
                 // We need to trim samples list
                 sampling.filter(maxTotalPoints);
 
-                ALICEVISION_LOG_INFO("Extracting samples for each group.");
-                group_pos = 0;
-
-                std::size_t total = 0;
-                for (auto& group : groupedViews)
+                if (calibrationMethod == ECalibrationMethod::AUTO && !groupIndices.empty())
                 {
-                    if (group.size() == 0)
-                    {
-                        continue;
-                    }
-
-                    bool first = true;
-                    IndexT firstViewId = group.begin()->get()->getViewId();
-
-                    if (calibrationMethod == ECalibrationMethod::AUTO)
-                    {
-                        const bool isRAW = image::isRawFormat(group.begin()->get()->getImage().getImagePath());
+                    const bool isRAW = image::isRawFormat(groupedViews[groupIndices.front()].begin()->get()->getImage().getImagePath());
 
-                        calibrationMethod = isRAW ? ECalibrationMethod::LINEAR : ECalibrationMethod::DEBEVEC;
-                        ALICEVISION_LOG_INFO("Calibration method automatically set to " << calibrationMethod << ".");
-                    }
+                    calibrationMethod = isRAW ? ECalibrationMethod::LINEAR : ECalibrationMethod::DEBEVEC;
+                    ALICEVISION_LOG_INFO("Calibration method automatically set to " << calibrationMethod << ".");
+                }
 
-                    // Read from file
-                    const std::string samplesFilepath = (fs::path(samplesFolder) / (std::to_string(firstViewId) + "_samples.dat")).string();
-                    std::ifstream fileSamples(samplesFilepath, std::ios::binary);
-                    if (!fileSamples.is_open())
-                    {
-                        ALICEVISION_LOG_ERROR("Cannot read samples from file " << samplesFilepath << ".");
-                        return EXIT_FAILURE;
-                    }
+                ALICEVISION_LOG_INFO("Extracting the " << sampling.getCountSamples() << " selected samples from each group.");
+                calibrationSamples.resize(groupIndices.size());
+                bool readError = false;
 
-                    std::size_t size = 0;
-                    fileSamples.read((char*)&size, sizeof(size));
+#pragma omp parallel for schedule(dynamic)
+                for (int group_pos = 0; group_pos < groupIndices.size(); ++group_pos)
+                {
+                    const IndexT firstViewId = groupedViews[groupIndices[group_pos]].begin()->get()->getViewId();
 
-                    std::vector<hdr::ImageSample> samples(size);
-                    for (int i = 0; i < size; ++i)
+                    std::vector<hdr::ImageSample> samples;
+                    if (!readSamples(samples, samplesFolder, firstViewId))
                     {
-                        fileSamples >> samples[i];
+#pragma omp critical
+                        readError = true;
+                        continue;
                     }
 
-                    std::vector<hdr::ImageSample> out_samples;
-                    sampling.extractUsefulSamples(out_samples, samples, group_pos);
-
-                    calibrationSamples.push_back(out_samples);
+                    sampling.extractUsefulSamples(calibrationSamples[group_pos], samples, group_pos);
+                }
 
-                    ++group_pos;
+                if (readError)
+                {
+                    return EXIT_FAILURE;
                 }
 
                 // Define calibration weighting curve from name
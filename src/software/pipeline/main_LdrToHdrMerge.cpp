@@ -24,14 +24,21 @@
 // Command line parameters
 #include <boost/program_options.hpp>
 
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
 #include <filesystem>
+#include <memory>
+#include <mutex>
 #include <sstream>
 #include <iomanip>
+#include <thread>
 
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 0
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 1
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 3
 
 using namespace aliceVision;
 
@@ -70,6 +77,176 @@ std::string getHdrMaskPath(const std::string& outputPath, std::size_t g, const s
     return hdrImagePath;
 }
 
+namespace {
+
+/**
+ * @brief A group of brackets to merge into an HDR image.
+ */
+struct MergeGroup
+{
+    /// the position of the HDR image in the output SfMData
+    int pos = 0;
+    IndexT intrinsicId = UndefinedIndexT;
+    std::vector<std::shared_ptr<sfmData::View>> views;
+    std::shared_ptr<sfmData::View> targetView;
+    std::vector<double> exposures;
+};
+
+/**
+ * @brief The same rows of all the brackets of a group.
+ */
+struct BracketsBand
+{
+    std::size_t groupIndex = 0;
+    int width = 0;
+    int height = 0;
+    int ybegin = 0;
+    int rows = 0;
+    std::vector<image::Image<image::RGBfColor>> images;
+};
+
+/**
+ * @brief An HDR image and its masks, ready to be written.
+ */
+struct MergedImage
+{
+    std::size_t groupIndex = 0;
+    bool computeLightMasks = false;
+    image::Image<image::RGBfColor> HDRimage;
+    image::Image<image::RGBfColor> lowLightMask;
+    image::Image<image::RGBfColor> highLightMask;
+    image::Image<image::RGBfColor> noMidLightMask;
+    image::Image<float> isPixelClamped;
+};
+
+/**
+ * @brief Blocking FIFO queue with a maximum size connecting two stages of the pipeline.
+ */
+template<class T>
+class JobQueue
+{
+  public:
+    explicit JobQueue(std::size_t maxSize)
+      : _maxSize(std::max<std::size_t>(maxSize, 1))
+    {}
+
+    /**
+     * @brief Append a job, wait while the queue is full.
+     * @return false if the queue has been aborted
+     */
+    bool push(std::unique_ptr<T> job)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _notFull.wait(lock, [&] { return _aborted || _jobs.size() < _maxSize; });
+        if (_aborted)
+            return false;
+        _jobs.push_back(std::move(job));
+        _notEmpty.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief Remove the first job, wait while the queue is empty.
+     * @return nullptr at the end of the stream or if the queue has been aborted
+     */
+    std::unique_ptr<T> pop()
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _notEmpty.wait(lock, [&] { return _aborted || _closed || !_jobs.empty(); });
+        if (_aborted || _jobs.empty())
+            return nullptr;
+        std::unique_ptr<T> job = std::move(_jobs.front());
+        _jobs.pop_front();
+        _notFull.notify_one();
+        return job;
+    }
+
+    /// End of the stream: the remaining jobs can still be popped.
+    void close()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _closed = true;
+        _notEmpty.notify_all();
+    }
+
+    /// Stop the pipeline: the remaining jobs are dropped and the waiting stages are released.
+    void abort()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _aborted = true;
+        _jobs.clear();
+        _notEmpty.notify_all();
+        _notFull.notify_all();
+    }
+
+  private:
+    std::size_t _maxSize;
+    std::deque<std::unique_ptr<T>> _jobs;
+    bool _closed = false;
+    bool _aborted = false;
+    std::mutex _mutex;
+    std::condition_variable _notEmpty;
+    std::condition_variable _notFull;
+};
+
+/**
+ * @brief Write an HDR image and its masks with the metadata of the target view of its group.
+ */
+void writeMergedImage(const MergedImage& merged,
+                      const MergeGroup& mergeGroup,
+                      const std::string& outputPath,
+                      bool keepSourceImageName,
+                      image::EImageColorSpace mergedColorSpace,
+                      image::EStorageDataType storageDataType)
+{
+    const std::shared_ptr<sfmData::View>& targetView = mergeGroup.targetView;
+    const int pos = mergeGroup.pos;
+
+    fs::path p(targetView->getImage().getImagePath());
+    const std::string hdrImagePath = getHdrImagePath(outputPath, pos, keepSourceImageName ? p.stem().string() : "");
+
+    // Write an image with parameters from the target view
+    std::map<std::string, std::string> viewMetadata = targetView->getImage().getMetadata();
+
+    oiio::ParamValueList targetMetadata;
+    for (const auto& meta : viewMetadata)
+    {
+        if (meta.first.compare(0, 3, "raw") == 0)
+        {
+            targetMetadata.add_or_replace(oiio::ParamValue("AliceVision:" + meta.first, meta.second));
+        }
+        else
+        {
+            targetMetadata.add_or_replace(oiio::ParamValue(meta.first, meta.second));
+        }
+    }
+
+    targetMetadata.add_or_replace(oiio::ParamValue("AliceVision:ColorSpace", image::EImageColorSpace_enumToString(mergedColorSpace)));
+
+    image::ImageWriteOptions writeOptions;
+    writeOptions.fromColorSpace(mergedColorSpace);
+    writeOptions.toColorSpace(mergedColorSpace);
+    writeOptions.storageDataType(storageDataType);
+
+    image::writeImage(hdrImagePath, merged.HDRimage, writeOptions, targetMetadata);
+
+    if (merged.computeLightMasks)
+    {
+        const std::string hdrMaskLowLightPath = getHdrMaskPath(outputPath, pos, "lowLight", keepSourceImageName ? p.stem().string() : "");
+        const std::string hdrMaskHighLightPath = getHdrMaskPath(outputPath, pos, "highLight", keepSourceImageName ? p.stem().string() : "");
+        const std::string hdrMaskNoMidLightPath = getHdrMaskPath(outputPath, pos, "noMidLight", keepSourceImageName ? p.stem().string() : "");
+
+        image::ImageWriteOptions maskWriteOptions;
+        maskWriteOptions.exrCompressionMethod(image::EImageExrCompression::None);
+
+        image::writeImage(hdrMaskLowLightPath, merged.lowLightMask, maskWriteOptions);
+        image::writeImage(hdrMaskHighLightPath, merged.highLightMask, maskWriteOptions);
+        image::writeImage(hdrMaskNoMidLightPath, merged.noMidLightMask, maskWriteOptions);
+    }
+}
+
+}  // namespace
+
 int aliceVision_main(int argc, char** argv)
 {
     std::string sfmInputDataFilename;
@@ -95,6 +272,9 @@ int aliceVision_main(int argc, char** argv)
     int rangeStart = -1;
     int rangeSize = 1;
 
+    int bandHeight = 1024;
+    int queueSize = 2;
+
     // Command line parameters
     // clang-format off
     po::options_description requiredParams("Required parameters");
@@ -142,6 +322,10 @@ int aliceVision_main(int argc, char** argv)
          ("Storage data type: " + image::EStorageDataType_informations()).c_str())
         ("rangeStart", po::value<int>(&rangeStart)->default_value(rangeStart),
          "Range image index start.")
+        ("bandHeight", po::value<int>(&bandHeight)->default_value(bandHeight),
+         "Number of rows of the brackets merged at once, to bound the memory (0 to merge the whole images at once).")
+        ("queueSize", po::value<int>(&queueSize)->default_value(queueSize),
+         "Maximum number of decoded bands waiting to be merged and of merged images waiting to be written.")
         ("rangeSize", po::value<int>(&rangeSize)->default_value(rangeSize),
          "Range size.");
     // clang-format on
@@ -415,6 +599,12 @@ int aliceVision_main(int argc, char** argv)
 
     int rangeEnd = rangeStart + rangeSize;
 
+    // The response curves are loaded once per intrinsic
+    hdr::rgbCurve fusionWeight(channelQuantization);
+    fusionWeight.setFunction(fusionWeightFunction);
+    std::map<IndexT, hdr::rgbCurve> responsePerIntrinsics;
+
+    std::vector<MergeGroup> mergeGroups;
     int pos = 0;
     for (const auto& pGroupedViews : groupedViewsPerIntrinsics)
     {
@@ -423,17 +613,6 @@ int aliceVision_main(int argc, char** argv)
         const auto& groupedViews = pGroupedViews.second;
         const auto& targetViews = targetViewsPerIntrinsics.at(intrinsicId);
 
-        hdr::rgbCurve fusionWeight(channelQuantization);
-        fusionWeight.setFunction(fusionWeightFunction);
-        hdr::rgbCurve response(channelQuantization);
-
-        const std::string baseName = (fs::path(inputResponsePath).parent_path() / std::string("response_")).string();
-        const std::string intrinsicName = baseName + std::to_string(intrinsicId);
-        const std::string intrinsicInputResponsePath = intrinsicName + ".csv";
-
-        ALICEVISION_LOG_DEBUG("inputResponsePath: " << intrinsicInputResponsePath);
-        response.read(intrinsicInputResponsePath);
-
         for (std::size_t g = 0; g < groupedViews.size(); ++g, ++pos)
         {
             if (pos < rangeStart || pos >= rangeEnd)
@@ -441,37 +620,28 @@ int aliceVision_main(int argc, char** argv)
                 continue;
             }
 
-            const std::vector<std::shared_ptr<sfmData::View>>& group = groupedViews[g];
-
-            std::vector<image::Image<image::RGBfColor>> images(group.size());
-            std::shared_ptr<sfmData::View> targetView = targetViews[g];
-            std::vector<sfmData::ExposureSetting> exposuresSetting(group.size());
-
-            // Load all images of the group
-            for (std::size_t i = 0; i < group.size(); ++i)
+            if (responsePerIntrinsics.find(intrinsicId) == responsePerIntrinsics.end())
             {
-                const std::string filepath = group[i]->getImage().getImagePath();
-                ALICEVISION_LOG_INFO("Load " << filepath);
-
-                image::ImageReadOptions options;
-                options.workingColorSpace = workingColorSpace;
-                options.rawColorInterpretation = image::ERawColorInterpretation_stringToEnum(group[i]->getImage().getRawColorInterpretation());
-                options.colorProfileFileName = group[i]->getImage().getColorProfileFileName();
-
-                // Whatever the raw color interpretation mode, the default read processing for raw images is to apply
-                // white balancing in libRaw, before demosaicing.
-                // The DcpMetadata mode allows to not apply color management after demosaicing.
-                // Because if requested after demosaicing, white balancing is done at color management stage, we can
-                // set this option to true to get real raw data, without any white balancing, when the DcpMetadata mode
-                // is selected.
-                if (options.rawColorInterpretation == image::ERawColorInterpretation::DcpMetadata)
-                {
-                    options.doWBAfterDemosaicing = true;
-                }
+                const std::string baseName = (fs::path(inputResponsePath).parent_path() / std::string("response_")).string();
+                const std::string intrinsicName = baseName + std::to_string(intrinsicId);
+                const std::string intrinsicInputResponsePath = intrinsicName + ".csv";
+
+                ALICEVISION_LOG_DEBUG("inputResponsePath: " << intrinsicInputResponsePath);
+                hdr::rgbCurve response(channelQuantization);
+                response.read(intrinsicInputResponsePath);
+                responsePerIntrinsics.emplace(intrinsicId, response);
+            }
 
-                image::readImage(filepath, images[i], options);
+            MergeGroup mergeGroup;
+            mergeGroup.pos = pos;
+            mergeGroup.intrinsicId = intrinsicId;
+            mergeGroup.views = groupedViews[g];
+            mergeGroup.targetView = targetViews[g];
 
-                exposuresSetting[i] = group[i]->getImage().getCameraExposureSetting();
+            std::vector<sfmData::ExposureSetting> exposuresSetting(mergeGroup.views.size());
+            for (std::size_t i = 0; i < mergeGroup.views.size(); ++i)
+            {
+                exposuresSetting[i] = mergeGroup.views[i]->getImage().getCameraExposureSetting();
             }
 
             if (!sfmData::hasComparableExposures(exposuresSetting))
@@ -479,86 +649,226 @@ int aliceVision_main(int argc, char** argv)
                 ALICEVISION_THROW_ERROR("Camera exposure settings are inconsistent.");
             }
 
-            std::vector<double> exposures = getExposures(exposuresSetting);
+            mergeGroup.exposures = getExposures(exposuresSetting);
+            mergeGroups.push_back(mergeGroup);
+        }
+    }
 
-            // Merge HDR images
-            image::Image<image::RGBfColor> HDRimage;
-            image::Image<image::RGBfColor> lowLightMask;
-            image::Image<image::RGBfColor> highLightMask;
-            image::Image<image::RGBfColor> noMidLightMask;
-            if (images.size() > 1)
+    // The groups go through a pipeline so the disk and the CPU are busy at the same time:
+    // a decode thread reads the bands of the brackets, the caller thread merges them (with all the cores)
+    // and a write thread encodes the merged images.
+    JobQueue<BracketsBand> decodedBands(queueSize);
+    JobQueue<MergedImage> mergedImages(queueSize);
+    std::exception_ptr decodeError;
+    std::exception_ptr writeError;
+
+    // decode stage
+    std::thread decodeThread([&] {
+        try
+        {
+            for (std::size_t groupIndex = 0; groupIndex < mergeGroups.size(); ++groupIndex)
             {
-                hdr::hdrMerge merge;
-                sfmData::ExposureSetting targetCameraSetting = targetView->getImage().getCameraExposureSetting();
-                hdr::MergingParams mergingParams;
-                mergingParams.targetCameraExposure = targetCameraSetting.getExposure();
-                mergingParams.refImageIndex = targetIndexPerIntrinsics[intrinsicId];
-                mergingParams.minSignificantValue = minSignificantValue;
-                mergingParams.maxSignificantValue = maxSignificantValue;
-                mergingParams.computeLightMasks = computeLightMasks;
+                const std::vector<std::shared_ptr<sfmData::View>>& group = mergeGroups[groupIndex].views;
+
+                std::vector<std::unique_ptr<image::ImageBandReader>> readers;
+
+                // Open all images of the group, the non raw images are decoded band by band
+                for (std::size_t i = 0; i < group.size(); ++i)
+                {
+                    const std::string filepath = group[i]->getImage().getImagePath();
+                    ALICEVISION_LOG_INFO("Load " << filepath);
+
+                    image::ImageReadOptions options;
+                    options.workingColorSpace = workingColorSpace;
+                    options.rawColorInterpretation = image::ERawColorInterpretation_stringToEnum(group[i]->getImage().getRawColorInterpretation());
+                    options.colorProfileFileName = group[i]->getImage().getColorProfileFileName();
+
+                    // Whatever the raw color interpretation mode, the default read processing for raw images is to apply
+                    // white balancing in libRaw, before demosaicing.
+                    // The DcpMetadata mode allows to not apply color management after demosaicing.
+                    // Because if requested after demosaicing, white balancing is done at color management stage, we can
+                    // set this option to true to get real raw data, without any white balancing, when the DcpMetadata mode
+                    // is selected.
+                    if (options.rawColorInterpretation == image::ERawColorInterpretation::DcpMetadata)
+                    {
+                        options.doWBAfterDemosaicing = true;
+                    }
+
+                    readers.push_back(std::make_unique<image::ImageBandReader>(filepath, options));
+
+                    if (readers.back()->getWidth() != readers.front()->getWidth() || readers.back()->getHeight() != readers.front()->getHeight())
+                    {
+                        ALICEVISION_THROW_ERROR("The brackets of the image '" << filepath << "' have different sizes.");
+                    }
+                }
+
+                const int width = readers.front()->getWidth();
+                const int height = readers.front()->getHeight();
+                const int bandRows = (bandHeight > 0) ? std::min(bandHeight, height) : height;
+
+                bool aborted = false;
+                for (int ybegin = 0; ybegin < height && !aborted; ybegin += bandRows)
+                {
+                    auto band = std::make_unique<BracketsBand>();
+                    band->groupIndex = groupIndex;
+                    band->width = width;
+                    band->height = height;
+                    band->ybegin = ybegin;
+                    band->rows = std::min(bandRows, height - ybegin);
+
+                    band->images.resize(readers.size());
+                    for (std::size_t i = 0; i < readers.size(); ++i)
+                    {
+                        readers[i]->read(ybegin, ybegin + band->rows, band->images[i]);
+                    }
+
+                    aborted = !decodedBands.push(std::move(band));
+                }
 
-                merge.process(images, exposures, fusionWeight, response, HDRimage, lowLightMask, highLightMask, noMidLightMask, mergingParams);
-                if (highlightCorrectionFactor > 0.0f)
+                if (aborted)
                 {
-                    merge.postProcessHighlight(images,
-                                               exposures,
-                                               fusionWeight,
-                                               response,
-                                               HDRimage,
-                                               targetCameraSetting.getExposure(),
-                                               highlightCorrectionFactor,
-                                               highlightTargetLux);
+                    break;
                 }
             }
-            else if (images.size() == 1)
+        }
+        catch (...)
+        {
+            decodeError = std::current_exception();
+        }
+        decodedBands.close();
+    });
+
+    // write stage
+    std::thread writeThread([&] {
+        try
+        {
+            while (std::unique_ptr<MergedImage> merged = mergedImages.pop())
             {
-                // Nothing to do
-                HDRimage = images[0];
+                writeMergedImage(*merged, mergeGroups[merged->groupIndex], outputPath, keepSourceImageName, mergedColorSpace, storageDataType);
             }
+        }
+        catch (...)
+        {
+            writeError = std::current_exception();
+            decodedBands.abort();
+            mergedImages.abort();
+        }
+    });
 
-            fs::path p(targetView->getImage().getImagePath());
-            const std::string hdrImagePath = getHdrImagePath(outputPath, pos, keepSourceImageName ? p.stem().string() : "");
-
-            // Write an image with parameters from the target view
-            std::map<std::string, std::string> viewMetadata = targetView->getImage().getMetadata();
+    // merge stage, on the caller thread
+    try
+    {
+        std::unique_ptr<MergedImage> merged;
+        hdr::hdrMerge merge;
+        hdr::MergingParams mergingParams;
+        bool correctHighlights = false;
 
-            oiio::ParamValueList targetMetadata;
-            for (const auto& meta : viewMetadata)
+        while (std::unique_ptr<BracketsBand> band = decodedBands.pop())
+        {
+            const MergeGroup& mergeGroup = mergeGroups[band->groupIndex];
+            const int width = band->width;
+            const int height = band->height;
+            const int ybegin = band->ybegin;
+            const int rows = band->rows;
+            std::vector<image::Image<image::RGBfColor>>& images = band->images;
+
+            // First band of a group
+            if (ybegin == 0)
             {
-                if (meta.first.compare(0, 3, "raw") == 0)
+                merged = std::make_unique<MergedImage>();
+                merged->groupIndex = band->groupIndex;
+                merged->computeLightMasks = computeLightMasks;
+                merged->HDRimage.resize(width, height);
+                if (computeLightMasks)
                 {
-                    targetMetadata.add_or_replace(oiio::ParamValue("AliceVision:" + meta.first, meta.second));
+                    merged->lowLightMask.resize(width, height);
+                    merged->highLightMask.resize(width, height);
+                    merged->noMidLightMask.resize(width, height);
                 }
-                else
+
+                correctHighlights = (images.size() > 1) && (highlightCorrectionFactor > 0.0f);
+                if (correctHighlights)
                 {
-                    targetMetadata.add_or_replace(oiio::ParamValue(meta.first, meta.second));
+                    merged->isPixelClamped.resize(width, height);
                 }
+
+                sfmData::ExposureSetting targetCameraSetting = mergeGroup.targetView->getImage().getCameraExposureSetting();
+                mergingParams = hdr::MergingParams();
+                mergingParams.targetCameraExposure = targetCameraSetting.getExposure();
+                mergingParams.refImageIndex = targetIndexPerIntrinsics[mergeGroup.intrinsicId];
+                mergingParams.minSignificantValue = minSignificantValue;
+                mergingParams.maxSignificantValue = maxSignificantValue;
+                mergingParams.computeLightMasks = computeLightMasks;
             }
 
-            targetMetadata.add_or_replace(oiio::ParamValue("AliceVision:ColorSpace", image::EImageColorSpace_enumToString(mergedColorSpace)));
+            // The merge is pixelwise: only the queued bands of the brackets are in memory
+            if (images.size() > 1)
+            {
+                const hdr::rgbCurve& response = responsePerIntrinsics.at(mergeGroup.intrinsicId);
 
-            image::ImageWriteOptions writeOptions;
-            writeOptions.fromColorSpace(mergedColorSpace);
-            writeOptions.toColorSpace(mergedColorSpace);
-            writeOptions.storageDataType(storageDataType);
+                image::Image<image::RGBfColor> bandHDR;
+                image::Image<image::RGBfColor> bandLowLight;
+                image::Image<image::RGBfColor> bandHighLight;
+                image::Image<image::RGBfColor> bandNoMidLight;
+                merge.process(images, mergeGroup.exposures, fusionWeight, response, bandHDR, bandLowLight, bandHighLight, bandNoMidLight, mergingParams);
 
-            image::writeImage(hdrImagePath, HDRimage, writeOptions, targetMetadata);
+                merged->HDRimage.getMat().block(ybegin, 0, rows, width) = bandHDR.getMat();
+                if (computeLightMasks)
+                {
+                    merged->lowLightMask.getMat().block(ybegin, 0, rows, width) = bandLowLight.getMat();
+                    merged->highLightMask.getMat().block(ybegin, 0, rows, width) = bandHighLight.getMat();
+                    merged->noMidLightMask.getMat().block(ybegin, 0, rows, width) = bandNoMidLight.getMat();
+                }
 
-            if (computeLightMasks)
+                if (correctHighlights)
+                {
+                    image::Image<float> bandClamped;
+                    hdr::hdrMerge::computeClampedPixels(images.front(), bandClamped);
+                    merged->isPixelClamped.getMat().block(ybegin, 0, rows, width) = bandClamped.getMat();
+                }
+            }
+            else
             {
-                const std::string hdrMaskLowLightPath = getHdrMaskPath(outputPath, pos, "lowLight", keepSourceImageName ? p.stem().string() : "");
-                const std::string hdrMaskHighLightPath = getHdrMaskPath(outputPath, pos, "highLight", keepSourceImageName ? p.stem().string() : "");
-                const std::string hdrMaskNoMidLightPath = getHdrMaskPath(outputPath, pos, "noMidLight", keepSourceImageName ? p.stem().string() : "");
+                // Nothing to do
+                merged->HDRimage.getMat().block(ybegin, 0, rows, width) = images[0].getMat();
+            }
 
-                image::ImageWriteOptions maskWriteOptions;
-                maskWriteOptions.exrCompressionMethod(image::EImageExrCompression::None);
+            // Last band of a group
+            if (ybegin + rows >= height)
+            {
+                // The highlight correction filters the clamped pixels map, so it is done on the whole image
+                if (correctHighlights)
+                {
+                    merge.postProcessHighlight(
+                      merged->isPixelClamped, merged->HDRimage, mergingParams.targetCameraExposure, highlightCorrectionFactor, highlightTargetLux);
+                    merged->isPixelClamped = image::Image<float>();
+                }
 
-                image::writeImage(hdrMaskLowLightPath, lowLightMask, maskWriteOptions);
-                image::writeImage(hdrMaskHighLightPath, highLightMask, maskWriteOptions);
-                image::writeImage(hdrMaskNoMidLightPath, noMidLightMask, maskWriteOptions);
+                if (!mergedImages.push(std::move(merged)))
+                {
+                    break;
+                }
             }
         }
     }
+    catch (...)
+    {
+        decodedBands.abort();
+        mergedImages.abort();
+        decodeThread.join();
+        writeThread.join();
+        throw;
+    }
+
+    // the write stage ends once the merged images are written
+    mergedImages.close();
+    decodeThread.join();
+    writeThread.join();
+
+    if (decodeError)
+        std::rethrow_exception(decodeError);
+    if (writeError)
+        std::rethrow_exception(writeError);
 
     return EXIT_SUCCESS;
 }
\ No newline at end of file
@@ -9,6 +9,7 @@
 #include <aliceVision/sfmDataIO/jsonIO.hpp>
 #include <aliceVision/sfmDataIO/viewIO.hpp>
 #include <aliceVision/sensorDB/parseDatabase.hpp>
+#include <aliceVision/sensorDB/DatasheetIndex.hpp>
 #include <aliceVision/lensCorrectionProfile/lcp.hpp>
 #include <aliceVision/system/Logger.hpp>
 #include <aliceVision/system/main.hpp>
@@ -340,6 +341,9 @@ int aliceVision_main(int argc, char** argv)
         return EXIT_FAILURE;
     }
 
+    // the database is normalized once and the lookups are cached per camera brand / model
+    const sensorDB::DatasheetIndex sensorDatabaseIndex(sensorDatabase);
+
     // use current time as seed for random generator for intrinsic Id without metadata
     std::srand(std::time(0));
 
@@ -572,7 +576,7 @@ int aliceVision_main(int argc, char** argv)
 
         camera::EInitMode intrinsicInitMode = camera::EInitMode::UNKNOWN;
 
-        int errCode = view.getImage().getSensorSize(sensorDatabase, sensorWidth, sensorHeight, focalLengthmm, intrinsicInitMode, false);
+        int errCode = view.getImage().getSensorSize(sensorDatabaseIndex, sensorWidth, sensorHeight, focalLengthmm, intrinsicInitMode, false);
 
         // Throw a warning at the end
         if (errCode == 1)
@@ -588,7 +592,7 @@ int aliceVision_main(int argc, char** argv)
         else if (errCode == 3)
         {
             sensorDB::Datasheet datasheet;
-            sensorDB::getInfo(make, model, sensorDatabase, datasheet);
+            sensorDatabaseIndex.getInfo(make, model, datasheet);
 #pragma omp critical(unsureSensors)
             unsureSensors.emplace(std::make_pair(make, model), std::make_pair(view.getImage().getImagePath(), datasheet));
         }
@@ -11,6 +11,7 @@
     #include <aliceVision/localization/CCTagLocalizer.hpp>
 #endif
 #include <aliceVision/localization/LocalizationResult.hpp>
+#include <aliceVision/localization/LocalizationServer.hpp>
 #include <aliceVision/localization/optimization.hpp>
 #include <aliceVision/image/io.hpp>
 #include <aliceVision/dataio/FeedProvider.hpp>
@@ -47,7 +48,7 @@
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 1
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 2
 
 using namespace aliceVision;
 
@@ -100,6 +101,12 @@ int aliceVision_main(int argc, char** argv)
     std::string weightsFilepath;
     /// Number of previous frame of the sequence to use for matching
     std::size_t nbFrameBufferMatching = 10;
+    /// Number of threads used to match the query image with the similar database images
+    int nbMatchingThreads = 0;
+    /// Track the landmarks of the previous frame before querying the database
+    bool tracking = false;
+    /// Radius (in pixels) of the search of the tracked landmarks
+    double trackingSearchRadius = 20.0;
     /// enable/disable the robust matching (geometric validation) when matching query image
     /// and databases images
     bool robustMatching = true;
@@ -180,6 +187,14 @@ int aliceVision_main(int argc, char** argv)
          "geometric verification. If set to 0 it lets the ACRansac select an optimal value.")
         ("nbFrameBufferMatching", po::value<std::size_t>(&nbFrameBufferMatching)->default_value(nbFrameBufferMatching),
          "[voctree] Number of previous frame of the sequence to use for matching (0 = Disable).")
+        ("nbMatchingThreads", po::value<int>(&nbMatchingThreads)->default_value(nbMatchingThreads),
+         "[voctree] Number of threads used to match the query image with the similar images of the database "
+         "(0 to use all the available threads).")
+        ("tracking", po::value<bool>(&tracking)->default_value(tracking),
+         "[voctree] Track the landmarks of the previous localized frame with guided matching before querying the "
+         "vocabulary tree. The retrieval is used when the tracking fails.")
+        ("trackingSearchRadius", po::value<double>(&trackingSearchRadius)->default_value(trackingSearchRadius),
+         "[voctree] Radius (in pixels) around the previous position of a landmark where it is searched for tracking.")
         ("robustMatching", po::value<bool>(&robustMatching)->default_value(robustMatching),
          "[voctree] Enable/Disable the robust matching between query and database images, "
          "all putative matches will be considered.")
@@ -322,6 +337,9 @@ int aliceVision_main(int argc, char** argv)
         tmpParam->_ccTagUseCuda = false;
         tmpParam->_matchingError = matchingErrorMax;
         tmpParam->_nbFrameBufferMatching = nbFrameBufferMatching;
+        tmpParam->_nbMatchingThreads = nbMatchingThreads;
+        tmpParam->_useTracking = tracking;
+        tmpParam->_trackingSearchRadius = trackingSearchRadius;
         tmpParam->_useRobustMatching = robustMatching;
     }
 
@@ -356,10 +374,6 @@ int aliceVision_main(int argc, char** argv)
     exporter.initAnimatedCamera("camera");
 #endif
 
-    image::Image<float> imageGrey;
-    camera::Pinhole queryIntrinsics;
-    bool hasIntrinsics = false;
-
     std::size_t frameCounter = 0;
     std::size_t goodFrameCounter = 0;
     std::vector<std::string> goodFrameList;
@@ -372,22 +386,33 @@ int aliceVision_main(int argc, char** argv)
     // Define an accumulator set for computing the mean and the
     // standard deviation of the time taken for localization
     bacc::accumulator_set<double, bacc::stats<bacc::tag::mean, bacc::tag::min, bacc::tag::max, bacc::tag::sum>> stats;
+    bacc::accumulator_set<double, bacc::stats<bacc::tag::mean>> decodeStats;
+    bacc::accumulator_set<double, bacc::stats<bacc::tag::mean>> extractionStats;
+    bacc::accumulator_set<double, bacc::stats<bacc::tag::mean>> localizationStats;
 
     std::vector<localization::LocalizationResult> vec_localizationResults;
 
-    while (feed.readImage(imageGrey, queryIntrinsics, currentImgName, hasIntrinsics))
-    {
+    // the frames are decoded, described and localized on their own threads
+    localization::LocalizationServer server(*localizer, *param);
+
+    const auto readFrame = [&](localization::LocalizationFrame& frame) {
+        if (frame.frameId > 0)
+            feed.goToNextFrame();
+        return feed.readImage(frame.imageGrey, frame.queryIntrinsics, frame.imagePath, frame.hasIntrinsics);
+    };
+
+    const auto onLocalized = [&](const localization::LocalizationFrame& frame, const localization::LocalizationResult& localizationResult) {
+        currentImgName = frame.imagePath;
         ALICEVISION_COUT("******************************");
         ALICEVISION_COUT("FRAME " << utils::toStringZeroPadded(frameCounter, 4));
         ALICEVISION_COUT("******************************");
-        localization::LocalizationResult localizationResult;
-        auto detect_start = std::chrono::steady_clock::now();
-        localizer->localize(
-          imageGrey, param.get(), generator, hasIntrinsics /*useInputIntrinsics*/, queryIntrinsics, localizationResult, currentImgName);
-        auto detect_end = std::chrono::steady_clock::now();
-        auto detect_elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(detect_end - detect_start);
-        ALICEVISION_COUT("\nLocalization took  " << detect_elapsed.count() << " [ms]");
-        stats(detect_elapsed.count());
+        ALICEVISION_COUT("\nLocalization took  " << frame.latency.totalMs << " [ms] (decode: " << frame.latency.decodeMs
+                                                  << " [ms], extraction: " << frame.latency.extractionMs
+                                                  << " [ms], matching and resection: " << frame.latency.localizationMs << " [ms])");
+        stats(frame.latency.totalMs);
+        decodeStats(frame.latency.decodeMs);
+        extractionStats(frame.latency.extractionMs);
+        localizationStats(frame.latency.localizationMs);
 
         vec_localizationResults.emplace_back(localizationResult);
 
@@ -395,7 +420,7 @@ int aliceVision_main(int argc, char** argv)
         if (localizationResult.isValid())
         {
 #if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_ALEMBIC)
-            exporter.addCameraKeyframe(localizationResult.getPose(), &queryIntrinsics, currentImgName, frameCounter, frameCounter);
+            exporter.addCameraKeyframe(localizationResult.getPose(), &frame.queryIntrinsics, currentImgName, frameCounter, frameCounter);
 #endif
 
             goodFrameCounter++;
@@ -409,8 +434,9 @@ int aliceVision_main(int argc, char** argv)
 #endif
         }
         ++frameCounter;
-        feed.goToNextFrame();
-    }
+    };
+
+    server.processStream(readFrame, onLocalized, generator);
 
     if (wantsJsonOutput)
     {
@@ -481,6 +507,8 @@ int aliceVision_main(int argc, char** argv)
     ALICEVISION_COUT("Mean time for localization:   " << bacc::mean(stats) << " [ms]");
     ALICEVISION_COUT("Max time for localization:   " << bacc::max(stats) << " [ms]");
     ALICEVISION_COUT("Min time for localization:   " << bacc::min(stats) << " [ms]");
+    ALICEVISION_COUT("Mean time per stage:   decode " << bacc::mean(decodeStats) << " [ms], extraction " << bacc::mean(extractionStats)
+                                                       << " [ms], matching and resection " << bacc::mean(localizationStats) << " [ms]");
 
     return EXIT_SUCCESS;
 }
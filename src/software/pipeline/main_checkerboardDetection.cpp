@@ -19,10 +19,13 @@
 #include <boost/program_options.hpp>
 #include <boost/property_tree/json_parser.hpp>
 
+#include <algorithm>
+#include <exception>
+
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 1
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 1
 
 namespace po = boost::program_options;
 
@@ -37,6 +40,7 @@ int aliceVision_main(int argc, char* argv[])
     bool exportDebugImages = false;
     bool doubleSize = false;
     bool useNestedGrids = false;
+    bool coarseToFine = false;
 
     // Command line parameters
     // clang-format off
@@ -59,7 +63,10 @@ int aliceVision_main(int argc, char* argv[])
         ("doubleSize", po::value<bool>(&doubleSize)->default_value(doubleSize), 
          "Double image size prior to processing.")
         ("useNestedGrids", po::value<bool>(&useNestedGrids)->default_value(useNestedGrids), 
-         "Images contain nested calibration grids. These grids must be centered on image center.");
+         "Images contain nested calibration grids. These grids must be centered on image center.")
+        ("coarseToFine", po::value<bool>(&coarseToFine)->default_value(coarseToFine),
+         "Only search the corners on downscaled images and refine them at full resolution. "
+         "Faster on large images, but the smallest checkers may be missed.");
     // clang-format on
 
     CmdLine cmdline("AliceVision checkerboardDetection");
@@ -113,86 +120,116 @@ int aliceVision_main(int argc, char* argv[])
 
     ALICEVISION_LOG_DEBUG("Range to compute: rangeStart=" << rangeStart << ", rangeSize=" << rangeSize);
 
+    // Process the views in parallel, as many at once as the memory allows
+    const HardwareContext hwc = cmdline.getHardwareContext();
+    std::size_t maxViewMemory = 1;
     for (int itemidx = 0; itemidx < rangeSize; itemidx++)
     {
-        std::shared_ptr<sfmData::View> view = viewsOrderedByName[rangeStart + itemidx];
-
-        IndexT viewId = view->getViewId();
+        const sfmData::View& view = *viewsOrderedByName[rangeStart + itemidx];
+        const std::size_t scale = (doubleSize) ? 2 : 1;
+        const std::size_t memory =
+          calibration::CheckerDetector::getMemoryConsumption(view.getImage().getWidth() * scale, view.getImage().getHeight() * scale, exportDebugImages);
+        maxViewMemory = std::max(maxViewMemory, memory);
+    }
+    const int nbParallelViews =
+      std::max(1, std::min(static_cast<int>(hwc.getMaxThreads()), static_cast<int>(hwc.getMaxMemory() / maxViewMemory)));
+    ALICEVISION_LOG_INFO("Processing " << rangeSize << " views, " << nbParallelViews << " at once");
 
-        // Load image and convert it to sRGB colorspace
-        std::string imagePath = view->getImage().getImagePath();
-        ALICEVISION_LOG_INFO("Load image with path " << imagePath);
-        image::Image<image::RGBColor> source;
-        image::readImage(imagePath, source, image::EImageColorSpace::SRGB);
+    std::exception_ptr exception;
 
-        double pixelRatio = view->getImage().getDoubleMetadata({"PixelAspectRatio"});
-        if (pixelRatio < 0.0)
+#pragma omp parallel for num_threads(nbParallelViews) schedule(dynamic)
+    for (int itemidx = 0; itemidx < rangeSize; itemidx++)
+    {
+        try
         {
-            pixelRatio = 1.0;
-        }
+            std::shared_ptr<sfmData::View> view = viewsOrderedByName[rangeStart + itemidx];
 
-        if (pixelRatio != 1.0 || doubleSize)
-        {
-            // if pixel are not squared, convert the image for easier lines extraction
-            const double w = source.width();
-            const double h = source.height();
+            IndexT viewId = view->getViewId();
 
-            const double nw = w * ((doubleSize) ? 2.0 : 1.0);
-            const double nh = h * ((doubleSize) ? 2.0 : 1.0) / pixelRatio;
+            // Load image and convert it to sRGB colorspace
+            std::string imagePath = view->getImage().getImagePath();
+            ALICEVISION_LOG_INFO("Load image with path " << imagePath);
+            image::Image<image::RGBColor> source;
+            image::readImage(imagePath, source, image::EImageColorSpace::SRGB);
 
-            ALICEVISION_LOG_DEBUG("Resize image with dimensions " << nw << "x" << nh);
+            double pixelRatio = view->getImage().getDoubleMetadata({"PixelAspectRatio"});
+            if (pixelRatio < 0.0)
+            {
+                pixelRatio = 1.0;
+            }
 
-            image::Image<image::RGBColor> resizedInput;
-            imageAlgo::resizeImage(nw, nh, source, resizedInput);
-            source.swap(resizedInput);
-        }
+            if (pixelRatio != 1.0 || doubleSize)
+            {
+                // if pixel are not squared, convert the image for easier lines extraction
+                const double w = source.width();
+                const double h = source.height();
 
-        // Lookup checkerboard
-        calibration::CheckerDetector detect;
-        ALICEVISION_LOG_INFO("Launching checkerboard detection");
-        if (!detect.process(source, useNestedGrids, exportDebugImages))
-        {
-            ALICEVISION_LOG_ERROR("Detection failed");
-            continue;
-        }
+                const double nw = w * ((doubleSize) ? 2.0 : 1.0);
+                const double nh = h * ((doubleSize) ? 2.0 : 1.0) / pixelRatio;
 
-        ALICEVISION_LOG_INFO("Detected " << detect.getBoards().size() << " boards and " << detect.getCorners().size() << " corners");
+                ALICEVISION_LOG_DEBUG("Resize image with dimensions " << nw << "x" << nh);
 
-        // Restore aspect ratio for corners coordinates
-        if (pixelRatio != 1.0 || doubleSize)
-        {
-            std::vector<calibration::CheckerDetector::CheckerBoardCorner>& cs = detect.getCorners();
-            for (auto& c : cs)
+                image::Image<image::RGBColor> resizedInput;
+                imageAlgo::resizeImage(nw, nh, source, resizedInput);
+                source.swap(resizedInput);
+            }
+
+            // Lookup checkerboard
+            calibration::CheckerDetector detect;
+            ALICEVISION_LOG_INFO("Launching checkerboard detection");
+            if (!detect.process(source, useNestedGrids, exportDebugImages, coarseToFine))
             {
-                c.center(1) *= pixelRatio;
+                ALICEVISION_LOG_ERROR("Detection failed");
+                continue;
+            }
+
+            ALICEVISION_LOG_INFO("Detected " << detect.getBoards().size() << " boards and " << detect.getCorners().size() << " corners");
 
-                if (doubleSize)
+            // Restore aspect ratio for corners coordinates
+            if (pixelRatio != 1.0 || doubleSize)
+            {
+                std::vector<calibration::CheckerDetector::CheckerBoardCorner>& cs = detect.getCorners();
+                for (auto& c : cs)
                 {
-                    c.center(0) /= 2.0;
-                    c.center(1) /= 2.0;
+                    c.center(1) *= pixelRatio;
+
+                    if (doubleSize)
+                    {
+                        c.center(0) /= 2.0;
+                        c.center(1) /= 2.0;
+                    }
                 }
             }
-        }
 
-        // write the json file with the tree
-        ALICEVISION_LOG_INFO("Writing detection output in "
-                             << "checkers_" << viewId << ".json");
-        std::stringstream ss;
-        ss << outputFilePath << "/"
-           << "checkers_" << viewId << ".json";
-        boost::json::value jv = boost::json::value_from(detect);
-        std::ofstream of(ss.str());
-        of << boost::json::serialize(jv);
-        of.close();
-
-        if (exportDebugImages)
-        {
-            ALICEVISION_LOG_INFO("Writing debug image");
+            // write the json file with the tree
+            ALICEVISION_LOG_INFO("Writing detection output in "
+                                 << "checkers_" << viewId << ".json");
             std::stringstream ss;
-            ss << outputFilePath << "/" << viewId << ".png";
-            image::writeImage(ss.str(), detect.getDebugImage(), image::ImageWriteOptions());
+            ss << outputFilePath << "/"
+               << "checkers_" << viewId << ".json";
+            boost::json::value jv = boost::json::value_from(detect);
+            std::ofstream of(ss.str());
+            of << boost::json::serialize(jv);
+            of.close();
+
+            if (exportDebugImages)
+            {
+                ALICEVISION_LOG_INFO("Writing debug image");
+                std::stringstream ss;
+                ss << outputFilePath << "/" << viewId << ".png";
+                image::writeImage(ss.str(), detect.getDebugImage(), image::ImageWriteOptions());
+            }
+        }
+        catch (...)
+        {
+#pragma omp critical(checkerboardDetectionException)
+            if (!exception)
+                exception = std::current_exception();
         }
     }
 
+    if (exception)
+        std::rethrow_exception(exception);
+
     return EXIT_SUCCESS;
 }
@@ -9,6 +9,7 @@
 #include <aliceVision/sfmDataIO/sfmDataIO.hpp>
 #include <aliceVision/sfm/sfm.hpp>
 #include <aliceVision/sfm/pipeline/regionsIO.hpp>
+#include <aliceVision/sfm/pipeline/RegionsCache.hpp>
 #include <aliceVision/matching/IndMatch.hpp>
 #include <aliceVision/system/Timer.hpp>
 #include <aliceVision/system/Logger.hpp>
@@ -91,14 +92,6 @@ int aliceVision_main(int argc, char** argv)
     // get imageDescriberMethodType
     std::vector<EImageDescriberType> describerMethodTypes = EImageDescriberType_stringToEnums(describerTypesName);
 
-    // prepare the Regions provider
-    feature::RegionsPerView regionsPerView;
-    if (!sfm::loadRegionsPerView(regionsPerView, sfmData, featuresFolders, describerMethodTypes))
-    {
-        ALICEVISION_LOG_ERROR("Invalid regions.");
-        return EXIT_FAILURE;
-    }
-
     // Pair selection method:
     // - geometry guided -> camera frustum intersection,
     // - putative matches guided (photometric matches)
@@ -128,18 +121,23 @@ int aliceVision_main(int argc, char** argv)
     // clear previous 3D landmarks
     sfmData.getLandmarks().clear();
 
-    // compute Structure from known camera poses
-    sfm::StructureEstimationFromKnownPoses structureEstimator;
-    structureEstimator.match(sfmData, pairs, regionsPerView, geometricErrorMax);
-
-    // unload descriptors before triangulation
-    regionsPerView.clearDescriptors();
-
-    // filter matches
-    structureEstimator.filter(sfmData, pairs, regionsPerView);
+    // the regions are loaded on demand and the descriptors of a view are unloaded once all its pairs are matched
+    std::map<IndexT, std::size_t> nbPairsPerView;
+    for (const Pair& pair : pairs)
+    {
+        ++nbPairsPerView[pair.first];
+        ++nbPairsPerView[pair.second];
+    }
+    sfm::RegionsCache regionsCache(sfmData, featuresFolders, describerMethodTypes, nbPairsPerView);
 
-    // create 3D landmarks
-    structureEstimator.triangulate(sfmData, regionsPerView, randomNumberGenerator);
+    // compute Structure from known camera poses:
+    // pairs matching and triplets filtering in a single pass, then 3D landmarks creation
+    sfm::StructureEstimationFromKnownPoses structureEstimator;
+    if (!structureEstimator.run(sfmData, pairs, regionsCache, randomNumberGenerator, geometricErrorMax))
+    {
+        ALICEVISION_LOG_ERROR("Invalid regions.");
+        return EXIT_FAILURE;
+    }
 
     sfm::removeOutliersWithAngleError(sfmData, 2.0);
 
@@ -22,7 +22,7 @@
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 4
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 9
 
 using namespace aliceVision;
 
@@ -89,18 +89,22 @@ int aliceVision_main(int argc, char* argv[])
     // number of GPUs to use (0 means use all GPUs)
     int nbGPUs = 0;
 
+    // storage of the output depth/sim maps
+    mvsUtils::EMapStorage mapStorage = mvsUtils::EMapStorage::Float;
+
     // clang-format off
     po::options_description requiredParams("Required parameters");
     requiredParams.add_options()
         ("input,i", po::value<std::string>(&sfmDataFilename)->required(),
          "SfMData file.")
-        ("imagesFolder", po::value<std::string>(&imagesFolder)->required(),
-         "Images folder. Filename should be the image uid.")
         ("output,o", po::value<std::string>(&outputFolder)->required(),
          "Output folder for generated depth maps.");
 
     po::options_description optionalParams("Optional parameters");
     optionalParams.add_options()
+        ("imagesFolder", po::value<std::string>(&imagesFolder)->default_value(imagesFolder),
+         "Images folder (prepareDenseScene output). Filename should be the image uid.\n"
+         "If empty, the source images of the SfMData are read and undistorted on the GPU.")
         ("rangeStart", po::value<int>(&rangeStart)->default_value(rangeStart),
          "Compute a sub-range of images from index rangeStart to rangeStart+rangeSize.")
         ("rangeSize", po::value<int>(&rangeSize)->default_value(rangeSize),
@@ -163,6 +167,13 @@ int aliceVision_main(int argc, char* argv[])
          "Semi Global Matching: Compare patch with consistent scale for similarity volume computation.")
         ("sgmUseCustomPatchPattern", po::value<bool>(&sgmParams.useCustomPatchPattern)->default_value(sgmParams.useCustomPatchPattern),
          "Semi Global Matching: Use user custom patch pattern for similarity volume computation.")
+        ("sgmCoarseToFineFactor", po::value<int>(&sgmParams.coarseToFineFactor)->default_value(sgmParams.coarseToFineFactor),
+         "Semi Global Matching: Number of depths per coarse depth of a first plane sweep pass. "
+         "Only the depths around the best coarse depths of each tile are then computed. "
+         "1 means no coarse pass.")
+        ("sgmCoarseToFineLowResolution", po::value<bool>(&sgmParams.coarseToFineLowResolution)->default_value(sgmParams.coarseToFineLowResolution),
+         "Semi Global Matching: Compute the coarse plane sweep pass at a resolution downscaled by the coarse-to-fine factor. "
+         "The per-pixel best coarse depths bound the depths of each tile at the SGM resolution.")
         ("refineScale", po::value<int>(&refineParams.scale)->default_value(refineParams.scale),
          "Refine: Downscale factor applied on source images for the Refine step (in addition to the global downscale).")
         ("refineStepXY", po::value<int>(&refineParams.stepXY)->default_value(refineParams.stepXY),
@@ -195,8 +206,38 @@ int aliceVision_main(int argc, char* argv[])
          "Enable/Disable depth/similarity map refinement process.")
         ("colorOptimizationEnabled", po::value<bool>(&refineParams.useColorOptimization)->default_value(refineParams.useColorOptimization),
          "Enable/Disable depth/similarity map post-process color optimization.")
+        ("refineComputeNormalMap", po::value<bool>(&refineParams.computeNormalMap)->default_value(refineParams.computeNormalMap),
+         "Refine: Compute the normal map of the refined depth map on GPU at the end of the refinement and write it alongside the depth map "
+         "(instead of a separate normal map estimation reading the depth maps back).")
         ("autoAdjustSmallImage", po::value<bool>(&depthMapParams.autoAdjustSmallImage)->default_value(depthMapParams.autoAdjustSmallImage),
          "Automatically adjust depth map parameters if images are smaller than one tile (maxTCamsPerTile=maxTCams, adjust step if needed).")
+        ("prefetchImages", po::value<bool>(&depthMapParams.prefetchImages)->default_value(depthMapParams.prefetchImages),
+         "Load the images of the next batch of tiles on CPU while the current batch is computed on GPU.")
+        ("orderCamsByViewGraph", po::value<bool>(&depthMapParams.orderCamsByViewGraph)->default_value(depthMapParams.orderCamsByViewGraph),
+         "Process the cameras along the view graph, consecutive cameras sharing most of their neighbour cameras images on GPU.")
+        ("usePatchMatch", po::value<bool>(&depthMapParams.usePatchMatch)->default_value(depthMapParams.usePatchMatch),
+         "Use the PatchMatch estimator (propagation and random refinement of oriented planes) instead of SGM + Refine. "
+         "No similarity volume is allocated, the memory only depends on the image size.")
+        ("patchMatchScale", po::value<int>(&depthMapParams.patchMatch.scale)->default_value(depthMapParams.patchMatch.scale),
+         "PatchMatch: Downscale factor applied on source images (in addition to the global downscale).")
+        ("patchMatchStepXY", po::value<int>(&depthMapParams.patchMatch.stepXY)->default_value(depthMapParams.patchMatch.stepXY),
+         "PatchMatch: Step is used to compute the depth map for one pixel over N (in the XY image plane).")
+        ("patchMatchMaxTCamsPerTile", po::value<int>(&depthMapParams.patchMatch.maxTCamsPerTile)->default_value(depthMapParams.patchMatch.maxTCamsPerTile),
+         "PatchMatch: Maximum number of neighbour cameras used per tile.")
+        ("patchMatchNbIterations", po::value<int>(&depthMapParams.patchMatch.nbIterations)->default_value(depthMapParams.patchMatch.nbIterations),
+         "PatchMatch: Number of propagation and random refinement iterations.")
+        ("patchMatchWSH", po::value<int>(&depthMapParams.patchMatch.wsh)->default_value(depthMapParams.patchMatch.wsh),
+         "PatchMatch: Half-size of the patch used to compute the similarity. Patch width is wsh*2+1.")
+        ("patchMatchGammaC", po::value<double>(&depthMapParams.patchMatch.gammaC)->default_value(depthMapParams.patchMatch.gammaC),
+         "PatchMatch: GammaC threshold used for similarity computation.")
+        ("patchMatchGammaP", po::value<double>(&depthMapParams.patchMatch.gammaP)->default_value(depthMapParams.patchMatch.gammaP),
+         "PatchMatch: GammaP threshold used for similarity computation.")
+        ("patchMatchMaxSimilarity", po::value<double>(&depthMapParams.patchMatch.maxSimilarity)->default_value(depthMapParams.patchMatch.maxSimilarity),
+         "PatchMatch: Maximum similarity (between -1 and 0) of a valid depth.")
+        ("patchMatchUseConsistentScale", po::value<bool>(&depthMapParams.patchMatch.useConsistentScale)->default_value(depthMapParams.patchMatch.useConsistentScale),
+         "PatchMatch: Compare patch with consistent scale for similarity computation.")
+        ("patchMatchUseCustomPatchPattern", po::value<bool>(&depthMapParams.patchMatch.useCustomPatchPattern)->default_value(depthMapParams.patchMatch.useCustomPatchPattern),
+         "PatchMatch: Use user custom patch pattern for similarity computation.")
         ("customPatchPatternSubparts", po::value<std::vector<depthMap::CustomPatchPatternParams::SubpartParams>>(&depthMapParams.customPatchPattern.subpartsParams)->multitoken()->default_value(depthMapParams.customPatchPattern.subpartsParams),
          "User custom patch pattern subparts for similarity volume computation.")
         ("customPatchPatternGroupSubpartsPerLevel", po::value<bool>(&depthMapParams.customPatchPattern.groupSubpartsPerLevel)->default_value(depthMapParams.customPatchPattern.groupSubpartsPerLevel),
@@ -215,8 +256,12 @@ int aliceVision_main(int argc, char* argv[])
          "Export intermediate volumes 9 points from the SGM and Refine steps in CSV files.")
         ("exportTilePattern", po::value<bool>(&depthMapParams.exportTilePattern)->default_value(depthMapParams.exportTilePattern),
          "Export workflow tile pattern.")
+        ("exportMemoryPlan", po::value<bool>(&depthMapParams.exportMemoryPlan)->default_value(depthMapParams.exportMemoryPlan),
+         "Export the device memory plan (budget, costs per tile, number of simultaneous tiles) of each GPU in a JSON file.")
         ("nbGPUs", po::value<int>(&nbGPUs)->default_value(nbGPUs),
-         "Number of GPUs to use (0 means use all GPUs).");
+         "Number of GPUs to use (0 means use all GPUs).")
+        ("mapStorage", po::value<mvsUtils::EMapStorage>(&mapStorage)->default_value(mapStorage),
+         mvsUtils::EMapStorage_informations().c_str());
     // clang-format on
 
     CmdLine cmdline("Dense Reconstruction.\n"
@@ -243,6 +288,7 @@ int aliceVision_main(int argc, char* argv[])
     refineParams.exportIntermediateCrossVolumes = exportIntermediateCrossVolumes;
     refineParams.exportIntermediateTopographicCutVolumes = exportIntermediateTopographicCutVolumes;
     refineParams.exportIntermediateVolume9pCsv = exportIntermediateVolume9pCsv;
+    depthMapParams.patchMatch.exportNormalMaps = exportIntermediateNormalMaps;
 
     // print GPU Information
     ALICEVISION_LOG_INFO(gpu::gpuInformationCUDA());
@@ -261,8 +307,16 @@ int aliceVision_main(int argc, char* argv[])
         return EXIT_FAILURE;
     }
 
+    // check PatchMatch parameters
+    if (depthMapParams.usePatchMatch &&
+        (depthMapParams.patchMatch.scale < 1 || depthMapParams.patchMatch.stepXY < 1 || depthMapParams.patchMatch.nbIterations < 0))
+    {
+        ALICEVISION_LOG_ERROR("Invalid value for PatchMatch scale / stepXY / nbIterations parameter(s).");
+        return EXIT_FAILURE;
+    }
+
     // check that Sgm scaleStep is greater or equal to the Refine scaleStep
-    if (depthMapParams.useRefine)
+    if (depthMapParams.useRefine && !depthMapParams.usePatchMatch)
     {
         const int sgmScaleStep = sgmParams.scale * sgmParams.stepXY;
         const int refineScaleStep = refineParams.scale * refineParams.stepXY;
@@ -288,8 +342,13 @@ int aliceVision_main(int argc, char* argv[])
     }
 
     // read the input SfM scene
+    // for a sub-range of cameras, only the landmarks observed by these cameras are read (if supported by the file format)
+    const bool loadLandmarksOfRange = (rangeSize != -1) && sfmDataIO::hasLandmarksPerView(sfmDataFilename);
     sfmData::SfMData sfmData;
-    if (!sfmDataIO::load(sfmData, sfmDataFilename, sfmDataIO::ESfMData::ALL))
+    if (!sfmDataIO::load(sfmData,
+                         sfmDataFilename,
+                         loadLandmarksOfRange ? sfmDataIO::ESfMData(sfmDataIO::ESfMData::ALL & ~sfmDataIO::ESfMData::STRUCTURE)
+                                              : sfmDataIO::ESfMData::ALL))
     {
         ALICEVISION_LOG_ERROR("The input SfMData file '" << sfmDataFilename << "' cannot be read.");
         return EXIT_FAILURE;
@@ -302,6 +361,9 @@ int aliceVision_main(int argc, char* argv[])
     mp.setMinViewAngle(minViewAngle);
     mp.setMaxViewAngle(maxViewAngle);
 
+    // set MultiViewParams output depth/sim maps storage
+    mp.setMapStorage(mapStorage);
+
     // set undefined tile dimensions
     if (tileParams.bufferWidth <= 0 || tileParams.bufferHeight <= 0)
     {
@@ -376,6 +438,14 @@ int aliceVision_main(int argc, char* argv[])
             refineParams.maxTCamsPerTile = depthMapParams.maxTCams;
         }
 
+        // update PatchMatch maxTCamsPerTile
+        if (depthMapParams.patchMatch.maxTCamsPerTile < depthMapParams.maxTCams)
+        {
+            ALICEVISION_LOG_WARNING("Single tile computation, override PatchMatch maximum number of T cameras per tile (before: "
+                                    << depthMapParams.patchMatch.maxTCamsPerTile << ", now: " << depthMapParams.maxTCams << ").");
+            depthMapParams.patchMatch.maxTCamsPerTile = depthMapParams.maxTCams;
+        }
+
         const int maxSgmBufferWidth = divideRoundUp(mp.getMaxImageWidth(), sgmParams.scale * sgmParams.stepXY);
         const int maxSgmBufferHeight = divideRoundUp(mp.getMaxImageHeight(), sgmParams.scale * sgmParams.stepXY);
 
@@ -390,7 +460,9 @@ int aliceVision_main(int argc, char* argv[])
     }
 
     // compute the maximum downscale factor
-    const int maxDownscale = std::max(sgmParams.scale * sgmParams.stepXY, refineParams.scale * refineParams.stepXY);
+    const int maxDownscale = (depthMapParams.usePatchMatch)
+                               ? (depthMapParams.patchMatch.scale * depthMapParams.patchMatch.stepXY)
+                               : std::max(sgmParams.scale * sgmParams.stepXY, refineParams.scale * refineParams.stepXY);
 
     // check padding
     if (tileParams.padding % maxDownscale != 0)
@@ -425,9 +497,28 @@ int aliceVision_main(int argc, char* argv[])
         }
     }
 
+    // read the landmarks observed by the sub-range of cameras
+    if (loadLandmarksOfRange)
+    {
+        std::set<IndexT> viewIds;
+        for (const int rc : cams)
+            viewIds.insert(mp.getViewId(rc));
+
+        if (!sfmDataIO::loadLandmarksOfViews(sfmData, sfmDataFilename, viewIds))
+        {
+            ALICEVISION_LOG_ERROR("The landmarks of the input SfMData file '" << sfmDataFilename << "' cannot be read.");
+            return EXIT_FAILURE;
+        }
+    }
+
     // initialize depth map estimator
     depthMap::DepthMapEstimator depthMapEstimator(mp, tileParams, depthMapParams, sgmParams, refineParams);
 
+    // order cameras along the view graph
+    // note: the chunks dispatched to each GPU stay made of neighbour cameras
+    if (depthMapParams.orderCamsByViewGraph)
+        depthMapEstimator.orderCamsByViewGraph(cams);
+
     // estimate depth maps
     depthMap::computeOnMultiGPUs(cams, depthMapEstimator, nbGPUs);
 
@@ -14,8 +14,10 @@
 #include <aliceVision/system/Logger.hpp>
 #include <aliceVision/system/main.hpp>
 #include <aliceVision/system/Timer.hpp>
+#include <aliceVision/gpu/gpu.hpp>
 
 #include <aliceVision/depthMap/computeOnMultiGPUs.hpp>
+#include <aliceVision/depthMap/DepthMapFilter.hpp>
 #include <aliceVision/depthMap/NormalMapEstimator.hpp>
 
 #include <boost/program_options.hpp>
@@ -23,7 +25,7 @@
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 2
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 2
 
 using namespace aliceVision;
 
@@ -52,6 +54,8 @@ int aliceVision_main(int argc, char* argv[])
     int pixSizeBallWithLowSimilarity = 0;
     int nNearestCams = 10;
     bool computeNormalMaps = false;
+    bool useGpu = true;
+    mvsUtils::EMapStorage mapStorage = mvsUtils::EMapStorage::Float;
 
     // clang-format off
     po::options_description requiredParams("Required parameters");
@@ -86,7 +90,11 @@ int aliceVision_main(int argc, char* argv[])
         ("nNearestCams", po::value<int>(&nNearestCams)->default_value(nNearestCams),
          "Number of nearest cameras.")
         ("computeNormalMaps", po::value<bool>(&computeNormalMaps)->default_value(computeNormalMaps),
-         "Compute normal maps per depth map.");
+         "Compute normal maps per depth map.")
+        ("useGpu", po::value<bool>(&useGpu)->default_value(useGpu),
+         "Filter the depth maps on the GPU, fallback to the CPU if no CUDA-Enabled GPU is available.")
+        ("mapStorage", po::value<mvsUtils::EMapStorage>(&mapStorage)->default_value(mapStorage),
+         mvsUtils::EMapStorage_informations().c_str());
     // clang-format on
 
     CmdLine cmdline("This program filters depth maps to remove values that are not consistent with other depth maps.\n"
@@ -99,8 +107,13 @@ int aliceVision_main(int argc, char* argv[])
     }
 
     // read the input SfM scene
+    // for a sub-range of cameras, only the landmarks observed by these cameras are read (if supported by the file format)
+    const bool loadLandmarksOfRange = (rangeSize != -1) && sfmDataIO::hasLandmarksPerView(sfmDataFilename);
     sfmData::SfMData sfmData;
-    if (!sfmDataIO::load(sfmData, sfmDataFilename, sfmDataIO::ESfMData::ALL))
+    if (!sfmDataIO::load(sfmData,
+                         sfmDataFilename,
+                         loadLandmarksOfRange ? sfmDataIO::ESfMData(sfmDataIO::ESfMData::ALL & ~sfmDataIO::ESfMData::STRUCTURE)
+                                              : sfmDataIO::ESfMData::ALL))
     {
         ALICEVISION_LOG_ERROR("The input SfMData file '" << sfmDataFilename << "' cannot be read.");
         return EXIT_FAILURE;
@@ -111,6 +124,7 @@ int aliceVision_main(int argc, char* argv[])
 
     mp.setMinViewAngle(minViewAngle);
     mp.setMaxViewAngle(maxViewAngle);
+    mp.setMapStorage(mapStorage);
 
     std::vector<int> cams;
     cams.reserve(mp.ncams);
@@ -136,8 +150,47 @@ int aliceVision_main(int argc, char* argv[])
         }
     }
 
+    // read the landmarks observed by the sub-range of cameras
+    if (loadLandmarksOfRange)
+    {
+        std::set<IndexT> viewIds;
+        for (const int rc : cams)
+            viewIds.insert(mp.getViewId(rc));
+
+        if (!sfmDataIO::loadLandmarksOfViews(sfmData, sfmDataFilename, viewIds))
+        {
+            ALICEVISION_LOG_ERROR("The landmarks of the input SfMData file '" << sfmDataFilename << "' cannot be read.");
+            return EXIT_FAILURE;
+        }
+    }
+
     ALICEVISION_LOG_INFO("Filter depth maps.");
 
+    if (useGpu && !gpu::gpuSupportCUDA(2, 0))
+    {
+        ALICEVISION_LOG_WARNING("No CUDA-Enabled GPU (with at least compute capability 2.0), filter depth maps on the CPU.");
+        useGpu = false;
+    }
+
+    if (useGpu)
+    {
+        depthMap::DepthMapFilterParams filterParams;
+        filterParams.pixToleranceFactor = pixToleranceFactor;
+        filterParams.pixSizeBall = pixSizeBall;
+        filterParams.pixSizeBallWithLowSimilarity = pixSizeBallWithLowSimilarity;
+        filterParams.nNearestCams = nNearestCams;
+        filterParams.minNumOfConsistentCams = minNumOfConsistentCams;
+        filterParams.minNumOfConsistentCamsWithLowSimilarity = minNumOfConsistentCamsWithLowSimilarity;
+
+        int nbGPUs = 0;
+
+        // initialize depth map filter
+        depthMap::DepthMapFilter depthMapFilter(mp, filterParams);
+
+        // filter depth maps
+        depthMap::computeOnMultiGPUs(cams, depthMapFilter, nbGPUs);
+    }
+    else
     {
         fuseCut::Fuser fs(mp);
         fs.filterGroups(cams, pixToleranceFactor, pixSizeBall, pixSizeBallWithLowSimilarity, nNearestCams);
@@ -34,12 +34,15 @@
 #include <boost/property_tree/json_parser.hpp>
 #include <boost/math/constants/constants.hpp>
 
+#include <atomic>
 #include <fstream>
+#include <map>
+#include <vector>
 
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 2
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 1
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 2
 
 namespace po = boost::program_options;
 using namespace aliceVision;
@@ -124,13 +127,14 @@ bool estimateDistortionMultiStep(std::shared_ptr<camera::Undistortion> undistort
                                  calibration::Statistics& statistics,
                                  std::vector<calibration::LineWithPoints>& lines,
                                  std::vector<double> initialParams,
-                                 std::vector<std::vector<bool>> lockSteps)
+                                 std::vector<std::vector<bool>> lockSteps,
+                                 const calibration::EstimationOptions& options)
 {
     undistortion->setParameters(initialParams);
 
     for (std::size_t i = 0; i < lockSteps.size(); ++i)
     {
-        if (!calibration::estimate(undistortion, statistics, lines, true, lockSteps[i]))
+        if (!calibration::estimate(undistortion, statistics, lines, true, lockSteps[i], options))
         {
             ALICEVISION_LOG_ERROR("Failed to calibrate at step " << i);
             return false;
@@ -147,6 +151,7 @@ int aliceVision_main(int argc, char* argv[])
     std::string sfmOutputDataFilepath;
 
     std::string undistortionModelName = "3deanamorphic4";
+    std::string linearSolverName = calibration::ELinearSolver_enumToString(calibration::ELinearSolver::DENSE_QR);
 
     // clang-format off
     po::options_description requiredParams("Required parameters");
@@ -161,7 +166,10 @@ int aliceVision_main(int argc, char* argv[])
     po::options_description optionalParams("Optional parameters");
     optionalParams.add_options()
         ("undistortionModelName", po::value<std::string>(&undistortionModelName)->default_value(undistortionModelName),
-         "Distortion model used for estimating undistortion.");
+         "Distortion model used for estimating undistortion.")
+        ("linearSolver", po::value<std::string>(&linearSolverName)->default_value(linearSolverName),
+         "Linear solver of the estimation: dense_qr, dense_schur or sparse_schur. "
+         "The Schur solvers eliminate the lines parameters and are faster with many checkerboards.");
     // clang-format on
 
     CmdLine cmdline("This program calibrates camera distortion.\n"
@@ -207,9 +215,35 @@ int aliceVision_main(int argc, char* argv[])
     // Retrieve camera model
     camera::EUNDISTORTION undistortionModel = camera::EUNDISTORTION_stringToEnum(undistortionModelName);
 
-    // Calibrate each intrinsic independently
+    calibration::EstimationOptions estimationOptions;
+    estimationOptions.linearSolver = calibration::ELinearSolver_stringToEnum(linearSolverName);
+
+    // Group the views by intrinsic
+    std::map<IndexT, std::vector<IndexT>> viewsPerIntrinsic;
+    for (const auto& pv : sfmData.getViews())
+    {
+        if (boardsAllImages.count(pv.first))
+        {
+            viewsPerIntrinsic[pv.second->getIntrinsicId()].push_back(pv.first);
+        }
+    }
+
+    std::vector<std::pair<IndexT, std::shared_ptr<camera::IntrinsicBase>*>> intrinsics;
     for (auto& [intrinsicId, intrinsicPtr] : sfmData.getIntrinsics())
     {
+        intrinsics.emplace_back(intrinsicId, &intrinsicPtr);
+    }
+
+    // Calibrate each intrinsic independently, in parallel
+    const HardwareContext hwc = cmdline.getHardwareContext();
+    std::atomic<bool> success(true);
+
+#pragma omp parallel for num_threads(hwc.getMaxThreads()) schedule(dynamic)
+    for (int intrinsicIndex = 0; intrinsicIndex < static_cast<int>(intrinsics.size()); ++intrinsicIndex)
+    {
+        const IndexT intrinsicId = intrinsics[intrinsicIndex].first;
+        std::shared_ptr<camera::IntrinsicBase>& intrinsicPtr = *intrinsics[intrinsicIndex].second;
+
         // Convert to pinhole
         std::shared_ptr<camera::Pinhole> cameraIn = std::dynamic_pointer_cast<camera::Pinhole>(intrinsicPtr);
 
@@ -228,7 +262,8 @@ int aliceVision_main(int argc, char* argv[])
         if (!cameraIn || !cameraOut)
         {
             ALICEVISION_LOG_ERROR("Only work for pinhole cameras");
-            return EXIT_FAILURE;
+            success = false;
+            continue;
         }
 
         ALICEVISION_LOG_INFO("Processing Intrinsic " << intrinsicId);
@@ -248,20 +283,18 @@ int aliceVision_main(int argc, char* argv[])
         if (!undistortion)
         {
             ALICEVISION_LOG_ERROR("Only work for cameras that support undistortion");
-            return EXIT_FAILURE;
+            success = false;
+            continue;
         }
 
         // Transform checkerboards to line With points
         std::vector<calibration::LineWithPoints> allLinesWithPoints;
-        for (auto& pv : sfmData.getViews())
+        const auto viewsIt = viewsPerIntrinsic.find(intrinsicId);
+        const std::vector<IndexT> noViews;
+        for (const IndexT viewId : (viewsIt != viewsPerIntrinsic.end()) ? viewsIt->second : noViews)
         {
-            if (pv.second->getIntrinsicId() != intrinsicId)
-            {
-                continue;
-            }
-
             std::vector<calibration::LineWithPoints> linesWithPoints;
-            if (!retrieveLines(linesWithPoints, boardsAllImages[pv.first]))
+            if (!retrieveLines(linesWithPoints, boardsAllImages.at(viewId)))
             {
                 continue;
             }
@@ -283,21 +316,28 @@ int aliceVision_main(int argc, char* argv[])
         else
         {
             ALICEVISION_LOG_ERROR("Unsupported camera model for undistortion.");
-            return EXIT_FAILURE;
+            success = false;
+            continue;
         }
 
-        if (!estimateDistortionMultiStep(undistortion, statistics, allLinesWithPoints, initialParams, lockSteps))
+        if (!estimateDistortionMultiStep(undistortion, statistics, allLinesWithPoints, initialParams, lockSteps, estimationOptions))
         {
-            ALICEVISION_LOG_ERROR("Error estimating distortion");
-            return EXIT_FAILURE;
+            ALICEVISION_LOG_ERROR("Error estimating distortion of intrinsic " << intrinsicId);
+            success = false;
+            continue;
         }
 
         // Override input intrinsic with output camera
         intrinsicPtr = cameraOut;
 
-        ALICEVISION_LOG_INFO("Result quality of calibration: ");
-        ALICEVISION_LOG_INFO("Mean of error (stddev): " << statistics.mean << "(" << statistics.stddev << ")");
-        ALICEVISION_LOG_INFO("Median of error: " << statistics.median);
+        ALICEVISION_LOG_INFO("Result quality of calibration of intrinsic " << intrinsicId << ": " << std::endl
+                                 << "\t- mean of error (stddev): " << statistics.mean << "(" << statistics.stddev << ")" << std::endl
+                                 << "\t- median of error: " << statistics.median);
+    }
+
+    if (!success)
+    {
+        return EXIT_FAILURE;
     }
 
     // Save sfmData to disk
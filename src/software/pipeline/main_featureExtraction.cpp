@@ -32,7 +32,7 @@
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 1
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 2
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 3
 
 using namespace aliceVision;
 
@@ -56,6 +56,7 @@ int aliceVision_main(int argc, char** argv)
     int rangeSize = 1;
     int maxThreads = 0;
     bool forceCpuExtraction = false;
+    int nbGPUs = 0;
     image::EImageColorSpace workingColorSpace = image::EImageColorSpace::SRGB;
     std::string maskExtension = "png";
     bool maskInvert = false;
@@ -89,6 +90,8 @@ int aliceVision_main(int argc, char** argv)
          ("Working color space: " + image::EImageColorSpace_informations()).c_str())
         ("forceCpuExtraction", po::value<bool>(&forceCpuExtraction)->default_value(forceCpuExtraction),
          "Use only CPU feature extraction methods.")
+        ("nbGPUs", po::value<int>(&nbGPUs)->default_value(nbGPUs),
+         "Number of GPUs to use for the GPU feature extraction methods (0 means use all available GPUs).")
         ("masksFolder", po::value<std::string>(&masksFolder),
          "Masks folder.")
         ("maskExtension", po::value<std::string>(&maskExtension)->default_value(maskExtension),
@@ -182,6 +185,7 @@ int aliceVision_main(int argc, char** argv)
             imageDescriber->setConfigurationPreset(featDescConfig);
             if (forceCpuExtraction)
                 imageDescriber->setUseCuda(false);
+            imageDescriber->setNbGPUs(nbGPUs);
 
             extractor.addImageDescriber(imageDescriber);
         }
@@ -23,6 +23,7 @@
 #include <aliceVision/matchingImageCollection/GeometricFilterMatrix_E_AC.hpp>
 #include <aliceVision/matchingImageCollection/GeometricFilterMatrix_H_AC.hpp>
 #include <aliceVision/matchingImageCollection/GeometricFilterMatrix_HGrowing.hpp>
+#include <aliceVision/matchingImageCollection/GeometricFilterDevice.hpp>
 #include <aliceVision/matchingImageCollection/GeometricFilterType.hpp>
 #include <aliceVision/matchingImageCollection/ImagePairListIO.hpp>
 #include <aliceVision/matching/pairwiseAdjacencyDisplay.hpp>
@@ -43,7 +44,7 @@
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 2
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 7
 
 using namespace aliceVision;
 using namespace aliceVision::camera;
@@ -111,14 +112,20 @@ int aliceVision_main(int argc, char** argv)
     bool guidedMatching = false;
     bool crossMatching = false;
     int maxIteration = 50000;
+    int maxIterationWithoutModel = 0;
+    bool useProsacSampling = false;
     bool matchFilePerImage = false;
     size_t numMatchesToKeep = 0;
     bool useGridSort = true;
     bool exportDebugFiles = false;
     bool matchFromKnownCameraPoses = false;
-    const std::string fileExtension = "txt";
+    std::string fileExtension = "txt";
     int randomSeed = std::mt19937::default_seed;
     double minRequired2DMotion = -1.0;
+    bool gpuGeometricFilter = false;
+    int pairsBatchSize = 0;
+    bool appendToMatchesFile = false;
+    matchingImageCollection::DeviceGeometricFilterParams gpuGeometricFilterParams;
 
     // clang-format off
     po::options_description requiredParams("Required parameters");
@@ -145,6 +152,9 @@ int aliceVision_main(int argc, char** argv)
          "* CASCADE_HASHING_L2: L2 Cascade Hashing matching\n"
          "* FAST_CASCADE_HASHING_L2: L2 Cascade Hashing with precomputed hashed regions\n"
          "(faster than CASCADE_HASHING_L2 but use more memory)\n"
+         "* BRUTE_FORCE_L2_CUDA: L2 BruteForce matching on the GPU (requires a build with CUDA)\n"
+         "* PRODUCT_QUANTIZATION_L2: L2 matching on product quantized descriptors, "
+         "with an exact verification of the best approximate neighbors\n"
          "For Binary based descriptor:\n"
          "* BRUTE_FORCE_HAMMING: BruteForce Hamming matching")
         ("geometricEstimator", po::value<robustEstimation::ERobustEstimator>(&geometricEstimator)->default_value(geometricEstimator),
@@ -168,10 +178,35 @@ int aliceVision_main(int argc, char** argv)
          "Make sure that the matching process is symmetric (same matches for I->J than fo J->I).")
         ("matchFilePerImage", po::value<bool>(&matchFilePerImage)->default_value(matchFilePerImage),
          "Save matches in a separate file per image.")
+        ("matchesFileFormat", po::value<std::string>(&fileExtension)->default_value(fileExtension),
+         "Matches file format: txt or bin (indexed binary format, faster to load and allows to read only a subset of pairs).")
+        ("pairsBatchSize", po::value<int>(&pairsBatchSize)->default_value(pairsBatchSize),
+         "Match and verify the image pairs by batches of this size (0 for a single batch), "
+         "so that only the putative matches of a batch are in memory. "
+         "With the bin format and a global match file, the verified matches of each batch are written as soon as they are available.")
+        ("appendToMatchesFile", po::value<bool>(&appendToMatchesFile)->default_value(appendToMatchesFile),
+         "Append the verified matches to the global bin match file of the output folder instead of writing one file per range. "
+         "Several chunks can append to the same file concurrently.")
         ("distanceRatio", po::value<float>(&distRatio)->default_value(distRatio),
          "Distance ratio to discard non meaningful matches.")
         ("maxIteration", po::value<int>(&maxIteration)->default_value(maxIteration),
          "Maximum number of iterations allowed in Ransac step.")
+        ("maxIterationWithoutModel", po::value<int>(&maxIterationWithoutModel)->default_value(maxIterationWithoutModel),
+         "Stop the A Contrario Ransac step of a pair when no meaningful model is found after this number of iterations "
+         "(0 to disable). Speeds up the rejection of non-overlapping pairs.")
+        ("useProsacSampling", po::value<bool>(&useProsacSampling)->default_value(useProsacSampling),
+         "Draw the Ransac samples among the matches with the lowest distance ratio first (PROSAC). "
+         "Speeds up the estimation on pairs with many outliers.")
+        ("gpuGeometricFilter", po::value<bool>(&gpuGeometricFilter)->default_value(gpuGeometricFilter),
+         "Reject the outliers and the non-overlapping pairs of all the putative matches with a fixed threshold Ransac on the GPU "
+         "before the geometric estimation (requires a build with CUDA). Only for fundamental, essential and homography matrix filters.")
+        ("gpuGeometricFilterError", po::value<double>(&gpuGeometricFilterParams.maxError)->default_value(gpuGeometricFilterParams.maxError),
+         "Maximum error (in pixels) of an inlier of the GPU geometric filtering.")
+        ("gpuGeometricFilterIteration", po::value<int>(&gpuGeometricFilterParams.nbIterations)->default_value(gpuGeometricFilterParams.nbIterations),
+         "Number of Ransac iterations per image pair of the GPU geometric filtering.")
+        ("gpuGeometricFilterMinInliers",
+         po::value<std::size_t>(&gpuGeometricFilterParams.minNbInliers)->default_value(gpuGeometricFilterParams.minNbInliers),
+         "Minimum number of inliers of the GPU geometric filtering to keep an image pair.")
         ("useGridSort", po::value<bool>(&useGridSort)->default_value(useGridSort),
          "Use matching grid sort.")
         ("minRequired2DMotion", po::value<double>(&minRequired2DMotion)->default_value(minRequired2DMotion),
@@ -277,8 +312,6 @@ int aliceVision_main(int argc, char** argv)
         filter.insert(pair.second);
     }
 
-    PairwiseMatches mapPutativesMatches;
-
     // allocate the right Matcher according the Matching requested method
     EMatcherType collectionMatcherType = EMatcherType_stringToEnum(nearestMatchingMethod);
     std::unique_ptr<IImageCollectionMatcher> imageCollectionMatcher = createImageCollectionMatcher(collectionMatcherType, distRatio, crossMatching);
@@ -297,234 +330,350 @@ int aliceVision_main(int argc, char** argv)
         return EXIT_FAILURE;
     }
 
-    // perform the matching
-    system::Timer timer;
-    PairSet pairsPoseKnown;
-    PairSet pairsPoseUnknown;
+    // when a range is specified, generate a file prefix to reflect the current iteration (rangeStart/rangeSize)
+    // => with matchFilePerImage: avoids overwriting files if a view is present in several iterations
+    // => without matchFilePerImage: avoids overwriting the unique resulting file
+    const std::string filePrefix = rangeSize > 0 ? std::to_string(rangeStart / rangeSize) + "." : "";
 
-    if (matchFromKnownCameraPoses)
+    // the global binary match files are written batch by batch, the other outputs once all the pairs are verified
+    const bool streamMatches = (fileExtension == "bin") && !matchFilePerImage;
+    if (appendToMatchesFile && !streamMatches)
     {
-        for (const auto& p : pairs)
-        {
-            if (sfmData.isPoseAndIntrinsicDefined(p.first) && sfmData.isPoseAndIntrinsicDefined(p.second))
-            {
-                pairsPoseKnown.insert(p);
-            }
-            else
-            {
-                pairsPoseUnknown.insert(p);
-            }
-        }
+        ALICEVISION_LOG_ERROR("Appending to the match file requires the bin format with a global match file.");
+        return EXIT_FAILURE;
     }
-    else
+    const std::string matchesFilename = (appendToMatchesFile ? "" : filePrefix) + "matches.bin";
+    const std::string matchesFilepath = (fs::path(matchesFolder) / matchesFilename).string();
+    const std::string putativeMatchesFilepath = (fs::path(matchesFolder) / "putativeMatches" / matchesFilename).string();
+    std::unique_ptr<MatchesStreamWriter> matchesWriter;
+    std::unique_ptr<MatchesStreamWriter> putativeMatchesWriter;
+    PairwiseMatches allFinalMatches;
+    PairwiseMatches allPutativeMatches;
+    std::size_t nbPutativePairs = 0;
+
+    // split the pairs in batches
+    std::vector<PairSet> pairsBatches;
+    for (const Pair& pair : pairs)
     {
-        pairsPoseUnknown = pairs;
+        if (pairsBatches.empty() || (pairsBatchSize > 0 && pairsBatches.back().size() >= static_cast<std::size_t>(pairsBatchSize)))
+            pairsBatches.emplace_back();
+        pairsBatches.back().insert(pair);
     }
 
-    if (!pairsPoseKnown.empty())
+    for (std::size_t batchIndex = 0; batchIndex < pairsBatches.size(); ++batchIndex)
     {
-        // compute matches from known camera poses when you have an initialization on the camera poses
-        ALICEVISION_LOG_INFO("Putative matches from known poses: " << pairsPoseKnown.size() << " image pairs.");
+        const PairSet& batchPairs = pairsBatches.at(batchIndex);
+        ALICEVISION_LOG_INFO("Batch " << batchIndex + 1 << "/" << pairsBatches.size() << ": " << batchPairs.size() << " image pairs.");
 
-        sfm::StructureEstimationFromKnownPoses structureEstimator;
-        structureEstimator.match(sfmData, pairsPoseKnown, regionPerView, knownPosesGeometricErrorMax);
-        mapPutativesMatches = structureEstimator.getPutativesMatches();
-    }
+        // perform the matching
+        system::Timer timer;
+        PairwiseMatches mapPutativesMatches;
+        PairSet pairsPoseKnown;
+        PairSet pairsPoseUnknown;
 
-    if (!pairsPoseUnknown.empty())
-    {
-        ALICEVISION_LOG_INFO("Putative matches (unknown poses): " << pairsPoseUnknown.size() << " image pairs.");
-        // match feature descriptors between them without geometric notion
+        if (matchFromKnownCameraPoses)
+        {
+            for (const auto& p : batchPairs)
+            {
+                if (sfmData.isPoseAndIntrinsicDefined(p.first) && sfmData.isPoseAndIntrinsicDefined(p.second))
+                {
+                    pairsPoseKnown.insert(p);
+                }
+                else
+                {
+                    pairsPoseUnknown.insert(p);
+                }
+            }
+        }
+        else
+        {
+            pairsPoseUnknown = batchPairs;
+        }
 
-        for (const feature::EImageDescriberType descType : describerTypes)
+        if (!pairsPoseKnown.empty())
         {
-            assert(descType != feature::EImageDescriberType::UNINITIALIZED);
-            ALICEVISION_LOG_INFO(EImageDescriberType_enumToString(descType) + " Regions Matching");
+            // compute matches from known camera poses when you have an initialization on the camera poses
+            ALICEVISION_LOG_INFO("Putative matches from known poses: " << pairsPoseKnown.size() << " image pairs.");
+
+            sfm::StructureEstimationFromKnownPoses structureEstimator;
+            structureEstimator.match(sfmData, pairsPoseKnown, regionPerView, knownPosesGeometricErrorMax);
+            mapPutativesMatches = structureEstimator.getPutativesMatches();
+        }
+
+        if (!pairsPoseUnknown.empty())
+        {
+            ALICEVISION_LOG_INFO("Putative matches (unknown poses): " << pairsPoseUnknown.size() << " image pairs.");
+            // match feature descriptors between them without geometric notion
+
+            for (const feature::EImageDescriberType descType : describerTypes)
+            {
+                assert(descType != feature::EImageDescriberType::UNINITIALIZED);
+                ALICEVISION_LOG_INFO(EImageDescriberType_enumToString(descType) + " Regions Matching");
 
-            // photometric matching of putative pairs
-            imageCollectionMatcher->Match(randomNumberGenerator, regionPerView, pairsPoseUnknown, descType, mapPutativesMatches);
+                // photometric matching of putative pairs
+                imageCollectionMatcher->Match(randomNumberGenerator, regionPerView, pairsPoseUnknown, descType, mapPutativesMatches);
 
-            // TODO: DELI
-            // if(!guided_matching) regionPerView.clearDescriptors()
+                // TODO: DELI
+                // if(!guided_matching) regionPerView.clearDescriptors()
+            }
         }
-    }
 
-    filterMatchesByMin2DMotion(mapPutativesMatches, regionPerView, minRequired2DMotion);
+        filterMatchesByMin2DMotion(mapPutativesMatches, regionPerView, minRequired2DMotion);
 
-    if (mapPutativesMatches.empty())
-    {
-        ALICEVISION_LOG_INFO("No putative feature matches.");
-        // If we only compute a selection of matches, we may have no match.
-        return rangeSize ? EXIT_SUCCESS : EXIT_FAILURE;
-    }
+        if (mapPutativesMatches.empty())
+        {
+            ALICEVISION_LOG_INFO("No putative feature matches in the batch.");
+            continue;
+        }
+        nbPutativePairs += mapPutativesMatches.size();
 
-    if (geometricFilterType == EGeometricFilterType::HOMOGRAPHY_GROWING)
-    {
-        // sort putative matches according to their Lowe ratio
-        // This is suggested by [F.Srajer, 2016]: the matches used to be the seeds of the homographies growing are chosen according
-        // to the putative matches order. This modification should improve recall.
-        for (auto& imgPair : mapPutativesMatches)
+        if (geometricFilterType == EGeometricFilterType::HOMOGRAPHY_GROWING)
         {
-            for (auto& descType : imgPair.second)
+            // sort putative matches according to their Lowe ratio
+            // This is suggested by [F.Srajer, 2016]: the matches used to be the seeds of the homographies growing are chosen according
+            // to the putative matches order. This modification should improve recall.
+            for (auto& imgPair : mapPutativesMatches)
             {
-                IndMatches& matches = descType.second;
-                sortMatches_byDistanceRatio(matches);
+                for (auto& descType : imgPair.second)
+                {
+                    IndMatches& matches = descType.second;
+                    sortMatches_byDistanceRatio(matches);
+                }
             }
         }
-    }
-
-    // when a range is specified, generate a file prefix to reflect the current iteration (rangeStart/rangeSize)
-    // => with matchFilePerImage: avoids overwriting files if a view is present in several iterations
-    // => without matchFilePerImage: avoids overwriting the unique resulting file
-    const std::string filePrefix = rangeSize > 0 ? std::to_string(rangeStart / rangeSize) + "." : "";
 
-    ALICEVISION_LOG_INFO(std::to_string(mapPutativesMatches.size()) << " putative image pair matches");
+        ALICEVISION_LOG_INFO(std::to_string(mapPutativesMatches.size()) << " putative image pair matches");
 
-    for (const auto& imageMatch : mapPutativesMatches)
-        ALICEVISION_LOG_INFO("\t- image pair (" + std::to_string(imageMatch.first.first)
-                             << ", " + std::to_string(imageMatch.first.second) + ") contains " + std::to_string(imageMatch.second.getNbAllMatches()) +
-                                  " putative matches.");
+        for (const auto& imageMatch : mapPutativesMatches)
+            ALICEVISION_LOG_INFO("\t- image pair (" + std::to_string(imageMatch.first.first)
+                                 << ", " + std::to_string(imageMatch.first.second) + ") contains " +
+                                      std::to_string(imageMatch.second.getNbAllMatches()) + " putative matches.");
 
-    // export putative matches
-    if (savePutativeMatches)
-        Save(mapPutativesMatches, (fs::path(matchesFolder) / "putativeMatches").string(), fileExtension, matchFilePerImage, filePrefix);
+        // export putative matches
+        if (savePutativeMatches)
+        {
+            if (streamMatches)
+            {
+                if (!putativeMatchesWriter)
+                    putativeMatchesWriter.reset(new MatchesStreamWriter(putativeMatchesFilepath, appendToMatchesFile));
+                for (const auto& pairMatches : mapPutativesMatches)
+                    putativeMatchesWriter->write(pairMatches.first, pairMatches.second);
+            }
+            else
+            {
+                allPutativeMatches.insert(mapPutativesMatches.begin(), mapPutativesMatches.end());
+            }
+        }
 
-    ALICEVISION_LOG_INFO("Task (Regions Matching) done in (s): " + std::to_string(timer.elapsed()));
+        ALICEVISION_LOG_INFO("Task (Regions Matching) done in (s): " + std::to_string(timer.elapsed()));
 
-    /*
-    // TODO: DELI
-    if(exportDebugFiles)
-    {
-      //-- export putative matches Adjacency matrix
-      PairwiseMatchingToAdjacencyMatrixSVG(sfmData.getViews().size(),
-        mapPutativesMatches,
-        (fs::path(matchesFolder) / "PutativeAdjacencyMatrix.svg").string());
-      //-- export view pair graph once putative graph matches have been computed
-      {
-        std::set<IndexT> set_ViewIds;
-
-        std::transform(sfmData.getViews().begin(), sfmData.getViews().end(),
-          std::inserter(set_ViewIds, set_ViewIds.begin()), stl::RetrieveKey());
-
-        graph::indexedGraph putativeGraph(set_ViewIds, getPairs(mapPutativesMatches));
-
-        graph::exportToGraphvizData(
-          (fs::path(matchesFolder) / "putative_matches.dot").string(),
-          putativeGraph.g);
-      }
-    }
-    */
+        /*
+        // TODO: DELI
+        if(exportDebugFiles)
+        {
+          //-- export putative matches Adjacency matrix
+          PairwiseMatchingToAdjacencyMatrixSVG(sfmData.getViews().size(),
+            mapPutativesMatches,
+            (fs::path(matchesFolder) / "PutativeAdjacencyMatrix.svg").string());
+          //-- export view pair graph once putative graph matches have been computed
+          {
+            std::set<IndexT> set_ViewIds;
+
+            std::transform(sfmData.getViews().begin(), sfmData.getViews().end(),
+              std::inserter(set_ViewIds, set_ViewIds.begin()), stl::RetrieveKey());
+
+            graph::indexedGraph putativeGraph(set_ViewIds, getPairs(mapPutativesMatches));
+
+            graph::exportToGraphvizData(
+              (fs::path(matchesFolder) / "putative_matches.dot").string(),
+              putativeGraph.g);
+          }
+        }
+        */
 
 #ifdef ALICEVISION_DEBUG_MATCHING
-    {
-        ALICEVISION_LOG_DEBUG("PUTATIVE");
-        getStatsMap(mapPutativesMatches);
-    }
+        {
+            ALICEVISION_LOG_DEBUG("PUTATIVE");
+            getStatsMap(mapPutativesMatches);
+        }
 #endif
 
-    // c. Geometric filtering of putative matches
-    //    - AContrario Estimation of the desired geometric model
-    //    - Use an upper bound for the a contrario estimated threshold
+        // c. Geometric filtering of putative matches
+        //    - AContrario Estimation of the desired geometric model
+        //    - Use an upper bound for the a contrario estimated threshold
 
-    timer.reset();
+        timer.reset();
 
-    matching::PairwiseMatches geometricMatches;
+        // optional GPU geometric filtering of all the pairs at once: rejects most of the outliers and of the non-overlapping pairs,
+        // the robust estimation of the geometric filter then only runs on the remaining inliers
+        matching::PairwiseMatches gpuFilteredMatches;
+        if (gpuGeometricFilter)
+        {
+            if (!isDeviceGeometricFilterSupported(geometricFilterType))
+            {
+                ALICEVISION_LOG_ERROR("The GPU geometric filtering is not available for the geometric filter type "
+                                      << matchingImageCollection::EGeometricFilterType_enumToString(geometricFilterType) << ".");
+                return EXIT_FAILURE;
+            }
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
+            matchingImageCollection::deviceGeometricFilter(
+              gpuFilteredMatches, sfmData, regionPerView, mapPutativesMatches, geometricFilterType, gpuGeometricFilterParams, randomNumberGenerator);
+            ALICEVISION_LOG_INFO("Task (GPU Geometric Filtering) done in (s): " + std::to_string(timer.elapsed()));
+#else
+            ALICEVISION_LOG_ERROR("The GPU geometric filtering requires a build with CUDA.");
+            return EXIT_FAILURE;
+#endif
+        }
+        const matching::PairwiseMatches& matchesToFilter = gpuGeometricFilter ? gpuFilteredMatches : mapPutativesMatches;
 
-    ALICEVISION_LOG_INFO("Geometric filtering: using " << matchingImageCollection::EGeometricFilterType_enumToString(geometricFilterType));
+        matching::PairwiseMatches geometricMatches;
 
-    switch (geometricFilterType)
-    {
-        case EGeometricFilterType::NO_FILTERING:
-            geometricMatches = mapPutativesMatches;
-            break;
+        ALICEVISION_LOG_INFO("Geometric filtering: using " << matchingImageCollection::EGeometricFilterType_enumToString(geometricFilterType));
 
-        case EGeometricFilterType::FUNDAMENTAL_MATRIX:
+        switch (geometricFilterType)
         {
-            matchingImageCollection::robustModelEstimation(geometricMatches,
-                                                           &sfmData,
-                                                           regionPerView,
-                                                           GeometricFilterMatrix_F_AC(geometricErrorMax, maxIteration, geometricEstimator),
-                                                           mapPutativesMatches,
-                                                           randomNumberGenerator,
-                                                           guidedMatching);
-        }
-        break;
+            case EGeometricFilterType::NO_FILTERING:
+                geometricMatches = mapPutativesMatches;
+                break;
 
-        case EGeometricFilterType::FUNDAMENTAL_WITH_DISTORTION:
-        {
-            matchingImageCollection::robustModelEstimation(geometricMatches,
-                                                           &sfmData,
-                                                           regionPerView,
-                                                           GeometricFilterMatrix_F_AC(geometricErrorMax, maxIteration, geometricEstimator, true),
-                                                           mapPutativesMatches,
-                                                           randomNumberGenerator,
-                                                           guidedMatching);
+            case EGeometricFilterType::FUNDAMENTAL_MATRIX:
+            {
+                GeometricFilterMatrix_F_AC geometricFilter(geometricErrorMax, maxIteration, geometricEstimator);
+                geometricFilter.m_stIterationWithoutModel = maxIterationWithoutModel;
+                geometricFilter.m_useProsacSampling = useProsacSampling;
+                matchingImageCollection::robustModelEstimation(geometricMatches,
+                                                               &sfmData,
+                                                               regionPerView,
+                                                               geometricFilter,
+                                                               matchesToFilter,
+                                                               randomNumberGenerator,
+                                                               guidedMatching);
+            }
+            break;
+
+            case EGeometricFilterType::FUNDAMENTAL_WITH_DISTORTION:
+            {
+                GeometricFilterMatrix_F_AC geometricFilter(geometricErrorMax, maxIteration, geometricEstimator, true);
+                geometricFilter.m_stIterationWithoutModel = maxIterationWithoutModel;
+                geometricFilter.m_useProsacSampling = useProsacSampling;
+                matchingImageCollection::robustModelEstimation(geometricMatches,
+                                                               &sfmData,
+                                                               regionPerView,
+                                                               geometricFilter,
+                                                               matchesToFilter,
+                                                               randomNumberGenerator,
+                                                               guidedMatching);
+            }
+            break;
+
+            case EGeometricFilterType::ESSENTIAL_MATRIX:
+            {
+                GeometricFilterMatrix_E_AC geometricFilter(geometricErrorMax, maxIteration);
+                geometricFilter.m_stIterationWithoutModel = maxIterationWithoutModel;
+                geometricFilter.m_useProsacSampling = useProsacSampling;
+                matchingImageCollection::robustModelEstimation(geometricMatches,
+                                                               &sfmData,
+                                                               regionPerView,
+                                                               geometricFilter,
+                                                               matchesToFilter,
+                                                               randomNumberGenerator,
+                                                               guidedMatching);
+
+                removePoorlyOverlappingImagePairs(geometricMatches, mapPutativesMatches, 0.3f, 50);
+            }
+            break;
+
+            case EGeometricFilterType::HOMOGRAPHY_MATRIX:
+            {
+                const bool onlyGuidedMatching = true;
+                GeometricFilterMatrix_H_AC geometricFilter(geometricErrorMax, maxIteration);
+                geometricFilter.m_stIterationWithoutModel = maxIterationWithoutModel;
+                geometricFilter.m_useProsacSampling = useProsacSampling;
+                matchingImageCollection::robustModelEstimation(geometricMatches,
+                                                               &sfmData,
+                                                               regionPerView,
+                                                               geometricFilter,
+                                                               matchesToFilter,
+                                                               randomNumberGenerator,
+                                                               guidedMatching,
+                                                               onlyGuidedMatching ? -1.0 : 0.6);
+            }
+            break;
+
+            case EGeometricFilterType::HOMOGRAPHY_GROWING:
+            {
+                matchingImageCollection::robustModelEstimation(geometricMatches,
+                                                               &sfmData,
+                                                               regionPerView,
+                                                               GeometricFilterMatrix_HGrowing(geometricErrorMax, maxIteration),
+                                                               matchesToFilter,
+                                                               randomNumberGenerator,
+                                                               guidedMatching);
+            }
+            break;
         }
-        break;
 
-        case EGeometricFilterType::ESSENTIAL_MATRIX:
+        ALICEVISION_LOG_INFO(std::to_string(geometricMatches.size()) + " geometric image pair matches:");
+        for (const auto& matchGeo : geometricMatches)
+            ALICEVISION_LOG_INFO("\t- image pair (" + std::to_string(matchGeo.first.first) + ", " + std::to_string(matchGeo.first.second) +
+                                 ") contains " + std::to_string(matchGeo.second.getNbAllMatches()) + " geometric matches.");
+
+        // grid filtering
+        ALICEVISION_LOG_INFO("Grid filtering");
+
+        PairwiseMatches finalMatches;
+        matchesGridFilteringForAllPairs(geometricMatches, sfmData, regionPerView, useGridSort, numMatchesToKeep, finalMatches);
+
+        ALICEVISION_LOG_INFO("After grid filtering:");
+        for (const auto& matchGridFiltering : finalMatches)
         {
-            matchingImageCollection::robustModelEstimation(geometricMatches,
-                                                           &sfmData,
-                                                           regionPerView,
-                                                           GeometricFilterMatrix_E_AC(geometricErrorMax, maxIteration),
-                                                           mapPutativesMatches,
-                                                           randomNumberGenerator,
-                                                           guidedMatching);
-
-            removePoorlyOverlappingImagePairs(geometricMatches, mapPutativesMatches, 0.3f, 50);
+            ALICEVISION_LOG_INFO("\t- image pair (" << matchGridFiltering.first.first << ", " << matchGridFiltering.first.second << ") contains "
+                                                    << matchGridFiltering.second.getNbAllMatches() << " geometric matches.");
         }
-        break;
 
-        case EGeometricFilterType::HOMOGRAPHY_MATRIX:
+        // export geometric filtered matches, the binary matches are written while the next batch is matched
+        if (!streamMatches || exportDebugFiles)
+            allFinalMatches.insert(finalMatches.begin(), finalMatches.end());
+        if (streamMatches)
         {
-            const bool onlyGuidedMatching = true;
-            matchingImageCollection::robustModelEstimation(geometricMatches,
-                                                           &sfmData,
-                                                           regionPerView,
-                                                           GeometricFilterMatrix_H_AC(geometricErrorMax, maxIteration),
-                                                           mapPutativesMatches,
-                                                           randomNumberGenerator,
-                                                           guidedMatching,
-                                                           onlyGuidedMatching ? -1.0 : 0.6);
+            if (!matchesWriter)
+                matchesWriter.reset(new MatchesStreamWriter(matchesFilepath, appendToMatchesFile));
+            for (auto& pairMatches : finalMatches)
+                matchesWriter->write(pairMatches.first, std::move(pairMatches.second));
         }
-        break;
+        ALICEVISION_LOG_INFO("Task done in (s): " + std::to_string(timer.elapsed()));
 
-        case EGeometricFilterType::HOMOGRAPHY_GROWING:
+#ifdef ALICEVISION_DEBUG_MATCHING
         {
-            matchingImageCollection::robustModelEstimation(geometricMatches,
-                                                           &sfmData,
-                                                           regionPerView,
-                                                           GeometricFilterMatrix_HGrowing(geometricErrorMax, maxIteration),
-                                                           mapPutativesMatches,
-                                                           randomNumberGenerator,
-                                                           guidedMatching);
+            ALICEVISION_LOG_DEBUG("GEOMETRIC");
+            getStatsMap(geometricMatches);
         }
-        break;
+#endif
     }
 
-    ALICEVISION_LOG_INFO(std::to_string(geometricMatches.size()) + " geometric image pair matches:");
-    for (const auto& matchGeo : geometricMatches)
-        ALICEVISION_LOG_INFO("\t- image pair (" + std::to_string(matchGeo.first.first) + ", " + std::to_string(matchGeo.first.second) +
-                             ") contains " + std::to_string(matchGeo.second.getNbAllMatches()) + " geometric matches.");
-
-    // grid filtering
-    ALICEVISION_LOG_INFO("Grid filtering");
-
-    PairwiseMatches finalMatches;
-    matchesGridFilteringForAllPairs(geometricMatches, sfmData, regionPerView, useGridSort, numMatchesToKeep, finalMatches);
-
-    ALICEVISION_LOG_INFO("After grid filtering:");
-    for (const auto& matchGridFiltering : finalMatches)
+    if (nbPutativePairs == 0)
     {
-        ALICEVISION_LOG_INFO("\t- image pair (" << matchGridFiltering.first.first << ", " << matchGridFiltering.first.second << ") contains "
-                                                << matchGridFiltering.second.getNbAllMatches() << " geometric matches.");
+        ALICEVISION_LOG_INFO("No putative feature matches.");
+        // If we only compute a selection of matches, we may have no match.
+        return rangeSize ? EXIT_SUCCESS : EXIT_FAILURE;
     }
 
-    // export geometric filtered matches
     ALICEVISION_LOG_INFO("Save geometric matches.");
-    Save(finalMatches, matchesFolder, fileExtension, matchFilePerImage, filePrefix);
-    ALICEVISION_LOG_INFO("Task done in (s): " + std::to_string(timer.elapsed()));
+    if (streamMatches)
+    {
+        if (putativeMatchesWriter)
+            putativeMatchesWriter->close();
+        if (matchesWriter)
+            matchesWriter->close();
+        else if (!appendToMatchesFile)
+            Save(PairwiseMatches(), matchesFolder, fileExtension, matchFilePerImage, filePrefix);
+    }
+    else
+    {
+        if (savePutativeMatches)
+            Save(allPutativeMatches, (fs::path(matchesFolder) / "putativeMatches").string(), fileExtension, matchFilePerImage, filePrefix);
+        Save(allFinalMatches, matchesFolder, fileExtension, matchFilePerImage, filePrefix);
+    }
 
     // d. Export some statistics
     if (exportDebugFiles)
@@ -532,7 +681,7 @@ int aliceVision_main(int argc, char** argv)
         // export Adjacency matrix
         ALICEVISION_LOG_INFO("Export Adjacency Matrix of the pairwise's geometric matches");
         PairwiseMatchingToAdjacencyMatrixSVG(
-          sfmData.getViews().size(), finalMatches, (fs::path(matchesFolder) / "GeometricAdjacencyMatrix.svg").string());
+          sfmData.getViews().size(), allFinalMatches, (fs::path(matchesFolder) / "GeometricAdjacencyMatrix.svg").string());
 
         /*
         // export view pair graph once geometric filter have been done
@@ -548,12 +697,5 @@ int aliceVision_main(int argc, char** argv)
         */
     }
 
-#ifdef ALICEVISION_DEBUG_MATCHING
-    {
-        ALICEVISION_LOG_DEBUG("GEOMETRIC");
-        getStatsMap(geometricMatches);
-    }
-#endif
-
     return EXIT_SUCCESS;
 }
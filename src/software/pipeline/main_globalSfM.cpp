@@ -24,7 +24,7 @@
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 1
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 3
 
 using namespace aliceVision;
 
@@ -47,6 +47,8 @@ int aliceVision_main(int argc, char** argv)
     sfm::ERotationAveragingMethod rotationAveragingMethod = sfm::ROTATION_AVERAGING_L2;
     sfm::ETranslationAveragingMethod translationAveragingMethod = sfm::TRANSLATION_AVERAGING_SOFTL1;
     bool lockAllIntrinsics = false;
+    bool bundleAdjustmentUseCuda = false;
+    bool bundleAdjustmentAnalyticJacobians = false;
     int randomSeed = std::mt19937::default_seed;
 
     // clang-format off
@@ -75,9 +77,16 @@ int aliceVision_main(int argc, char** argv)
         ("translationAveraging", po::value<sfm::ETranslationAveragingMethod>(&translationAveragingMethod)->default_value(translationAveragingMethod),
          "* 1: L1 minimization\n"
          "* 2: L2 minimization of sum of squared Chordal distances\n"
-         "* 3: L1 soft minimization")
+         "* 3: L1 soft minimization\n"
+         "* 4: L1 minimization with iteratively reweighted sparse least squares (scales to large relative translation graphs)")
         ("lockAllIntrinsics", po::value<bool>(&lockAllIntrinsics)->default_value(lockAllIntrinsics),
          "Force lock of all camera intrinsic parameters, so they will not be refined during Bundle Adjustment.")
+        ("bundleAdjustmentUseCuda", po::value<bool>(&bundleAdjustmentUseCuda)->default_value(bundleAdjustmentUseCuda),
+         "Use the CUDA linear solvers of Ceres for the bundle adjustment (requires Ceres >= 2.2 built with CUDA, "
+         "and Ceres >= 2.3 with cuDSS for the sparse solvers). Fallback to the CPU solvers if not available.")
+        ("bundleAdjustmentAnalyticJacobians", po::value<bool>(&bundleAdjustmentAnalyticJacobians)->default_value(bundleAdjustmentAnalyticJacobians),
+         "Use cost functions with analytic Jacobians instead of the automatic differentiation in the bundle adjustment "
+         "(pinhole camera without distortion or with radial K1/K3 distortion). Other camera models use the automatic differentiation.")
         ("randomSeed", po::value<int>(&randomSeed)->default_value(randomSeed),
          "This seed value will generate a sequence using a linear random generator. Set -1 to use a random seed.");
     // clang-format on
@@ -101,7 +110,7 @@ int aliceVision_main(int argc, char** argv)
         return EXIT_FAILURE;
     }
 
-    if (translationAveragingMethod < sfm::TRANSLATION_AVERAGING_L1 || translationAveragingMethod > sfm::TRANSLATION_AVERAGING_SOFTL1)
+    if (translationAveragingMethod < sfm::TRANSLATION_AVERAGING_L1 || translationAveragingMethod > sfm::TRANSLATION_AVERAGING_L1_IRLS)
     {
         ALICEVISION_LOG_ERROR("Translation averaging method is invalid");
         return EXIT_FAILURE;
@@ -166,6 +175,8 @@ int aliceVision_main(int argc, char** argv)
 
     // configure reconstruction parameters
     sfmEngine.setLockAllIntrinsics(lockAllIntrinsics);  // TODO: rename param
+    sfmEngine.setBundleAdjustmentUseCuda(bundleAdjustmentUseCuda);
+    sfmEngine.setBundleAdjustmentAnalyticJacobians(bundleAdjustmentAnalyticJacobians);
 
     // configure motion averaging method
     sfmEngine.setRotationAveragingMethod(sfm::ERotationAveragingMethod(rotationAveragingMethod));
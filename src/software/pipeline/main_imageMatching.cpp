@@ -31,7 +31,7 @@
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 1
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 2
 
 using namespace aliceVision;
 using namespace aliceVision::voctree;
@@ -66,6 +66,8 @@ int aliceVision_main(int argc, char** argv)
     std::string weightsFilepath;
     /// flag for the optional weights file
     bool withWeights = false;
+    /// the filename of the incremental voctree database
+    std::string databaseFilepath;
 
     // multiple SfM parameters
 
@@ -95,7 +97,9 @@ int aliceVision_main(int argc, char** argv)
          " * SequentialAndVocabularyTree: combine both previous approaches\n"
          " * Exhaustive: all images combinations\n"
          " * Frustum: images with camera frustum intersection (only for cameras with known poses)\n"
-         " * FrustumOrVocTree: frustum intersection if cameras with known poses else use VocTree.\n")
+         " * FrustumOrVocTree: frustum intersection if cameras with known poses else use VocTree.\n"
+         " * GlobalDescriptor: images with the closest global descriptors (aggregated on the vocabulary tree), "
+         "retrieved with an approximate nearest neighbors index (only in mode a/a).\n")
         ("minNbImages", po::value<std::size_t>(&minNbImages)->default_value(minNbImages),
          "Minimal number of images to use the vocabulary tree. "
          "If we have less images than this threshold, we will compute all matching combinations.")
@@ -110,7 +114,12 @@ int aliceVision_main(int argc, char** argv)
          "This software is intended to be used with a generic, pre-trained vocabulary tree.")
         ("weights,w", po::value<std::string>(&weightsFilepath)->default_value(weightsFilepath),
          "Input name for the vocabulary tree weight file. "
-         "If not provided, all the voctree leaves will have the same weight.");
+         "If not provided, all the voctree leaves will have the same weight.")
+        ("database", po::value<std::string>(&databaseFilepath)->default_value(databaseFilepath),
+         "File path of the vocabulary tree database (histograms of the images and word weights), "
+         "to select the image pairs incrementally (only in mode a/a). "
+         "If the file exists, only the images which are not in the database are inserted and queried, "
+         "so only their pairs are selected. The updated database is saved to this file.");
 
     po::options_description multiSfMParams("Multiple SfM");
     multiSfMParams.add_options()
@@ -219,6 +228,7 @@ int aliceVision_main(int argc, char** argv)
                              useMultiSfM,
                              descriptorsFilesA,
                              numImageQuery,
+                             databaseFilepath,
                              selectedPairs);
             break;
         }
@@ -245,6 +255,7 @@ int aliceVision_main(int argc, char** argv)
                              useMultiSfM,
                              descriptorsFilesA,
                              numImageQuery,
+                             databaseFilepath,
                              selectedPairs);
             break;
         }
@@ -265,6 +276,17 @@ int aliceVision_main(int argc, char** argv)
             }
             break;
         }
+        case EImageMatchingMethod::GLOBALDESCRIPTOR:
+        {
+            ALICEVISION_LOG_INFO("Use GLOBALDESCRIPTOR matching.");
+            if (matchingMode != EImageMatchingMode::A_A)
+            {
+                throw std::runtime_error("GLOBALDESCRIPTOR matching is only supported in mode: " +
+                                         EImageMatchingMode_enumToString(EImageMatchingMode::A_A));
+            }
+            conditionGlobalDescriptor(treeFilepath, descriptorsFilesA, nbMaxDescriptors, numImageQuery, selectedPairs);
+            break;
+        }
         case EImageMatchingMethod::FRUSTUM_OR_VOCABULARYTREE:
         {
             throw std::runtime_error("FRUSTUM_OR_VOCABULARYTREE should have been decided before.");
@@ -26,6 +26,7 @@
 #include <filesystem>
 #include <fstream>
 #include <algorithm>
+#include <future>
 #include <memory>
 #include <string>
 
@@ -34,7 +35,7 @@
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 1
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 2
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 3
 
 using namespace aliceVision;
 
@@ -91,6 +92,7 @@ int aliceVision_main(int argc, char** argv)
     int rangeStart = -1;
     int rangeSize = 1;
     bool useGpu = true;
+    int batchSize = 4;
     bool keepFilename = false;
 
     // Description of mandatory parameters
@@ -112,6 +114,8 @@ int aliceVision_main(int argc, char** argv)
          "Invert mask values. If selected, the pixels corresponding to the mask will be set to 0.0 instead of 1.0.")
         ("useGpu", po::value<bool>(&useGpu)->default_value(useGpu),
          "Use GPU if available.")
+        ("batchSize", po::value<int>(&batchSize)->default_value(batchSize),
+         "Maximum number of image tiles processed by a single model inference (ignored if the model has a fixed batch size).")
         ("keepFilename", po::value<bool>(&keepFilename)->default_value(keepFilename),
          "Keep input filename.")
         ("rangeStart", po::value<int>(&rangeStart)->default_value(rangeStart), 
@@ -181,6 +185,8 @@ int aliceVision_main(int argc, char** argv)
     parameters.modelHeight = 720;
     parameters.overlapRatio = 0.3;
     parameters.useGpu = useGpu;
+    parameters.batchSize = batchSize;
+    parameters.nbThreads = static_cast<int>(cmdline.getHardwareContext().getMaxThreads());
 
     aliceVision::segmentation::Segmentation seg(parameters);
 
@@ -206,6 +212,43 @@ int aliceVision_main(int argc, char** argv)
         }
     }
 
+    struct InputImage
+    {
+        image::Image<image::RGBfColor> image;
+        double pixelRatio = 1.0;
+    };
+
+    // Read an input image, resampled in order to work with square pixels
+    const auto loadImage = [&](int itemidx) {
+        const auto& view = viewsOrderedByName[rangeStart + itemidx];
+
+        InputImage input;
+        image::readImage(view->getImage().getImagePath(), input.image, image::EImageColorSpace::SRGB);
+
+        view->getImage().getDoubleMetadata({"PixelAspectRatio"}, input.pixelRatio);
+        if (input.pixelRatio != 1.0)
+        {
+            // Resample input image in order to work with square pixels
+            const int w = input.image.width();
+            const int h = input.image.height();
+
+            const int nw = static_cast<int>(static_cast<double>(w) * input.pixelRatio);
+            const int nh = h;
+
+            image::Image<image::RGBfColor> resizedInput;
+            imageAlgo::resizeImage(nw, nh, input.image, resizedInput);
+            input.image.swap(resizedInput);
+        }
+
+        return input;
+    };
+
+    std::future<InputImage> nextInput;
+    if (rangeSize > 0)
+    {
+        nextInput = std::async(std::launch::async, loadImage, 0);
+    }
+
     for (int itemidx = 0; itemidx < rangeSize; itemidx++)
     {
         const auto& view = viewsOrderedByName[rangeStart + itemidx];
@@ -216,23 +259,14 @@ int aliceVision_main(int argc, char** argv)
         const fs::path fsPath = path;
         const std::string fileName = fsPath.stem().string();
 
-        image::Image<image::RGBfColor> image;
-        image::readImage(path, image, image::EImageColorSpace::SRGB);
+        InputImage input = nextInput.get();
+        image::Image<image::RGBfColor>& image = input.image;
+        const double pixelRatio = input.pixelRatio;
 
-        double pixelRatio = 1.0;
-        view->getImage().getDoubleMetadata({"PixelAspectRatio"}, pixelRatio);
-        if (pixelRatio != 1.0)
+        // Read the next image while the current one is segmented
+        if (itemidx + 1 < rangeSize)
         {
-            // Resample input image in order to work with square pixels
-            const int w = image.width();
-            const int h = image.height();
-
-            const int nw = static_cast<int>(static_cast<double>(w) * pixelRatio);
-            const int nh = h;
-
-            image::Image<image::RGBfColor> resizedInput;
-            imageAlgo::resizeImage(nw, nh, image, resizedInput);
-            image.swap(resizedInput);
+            nextInput = std::async(std::launch::async, loadImage, itemidx + 1);
         }
 
         image::Image<IndexT> labels;
@@ -9,6 +9,7 @@
 #include <aliceVision/sfmDataIO/sfmDataIO.hpp>
 #include <aliceVision/sfm/sfm.hpp>
 #include <aliceVision/sfm/pipeline/regionsIO.hpp>
+#include <aliceVision/matching/io.hpp>
 #include <aliceVision/feature/imageDescriberCommon.hpp>
 #include <aliceVision/system/Timer.hpp>
 #include <aliceVision/system/Logger.hpp>
@@ -29,7 +30,7 @@
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 2
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 4
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 8
 
 using namespace aliceVision;
 
@@ -164,6 +165,15 @@ int aliceVision_main(int argc, char** argv)
         ("bundleAdjustmentMaxOutliers", po::value<int>(&sfmParams.bundleAdjustmentMaxOutliers)->default_value(sfmParams.bundleAdjustmentMaxOutliers),
          "Threshold for the maximum number of outliers allowed at the end of a bundle adjustment iteration."
          "Using a negative value for this threshold will disable BA iterations.")
+        ("bundleAdjustmentIterativeMinNbCameras", po::value<std::size_t>(&sfmParams.bundleAdjustmentIterativeMinNbCameras)->default_value(sfmParams.bundleAdjustmentIterativeMinNbCameras),
+         "Minimum number of cameras in a bundle adjustment to use an iterative Schur solver (with Schur-Jacobi preconditioner) "
+         "instead of the sparse Schur factorization. Faster on large reconstructions. Set it to 0 to disable the iterative solver.")
+        ("bundleAdjustmentUseCuda", po::value<bool>(&sfmParams.bundleAdjustmentUseCuda)->default_value(sfmParams.bundleAdjustmentUseCuda),
+         "Use the CUDA linear solvers of Ceres for the bundle adjustment (requires Ceres >= 2.2 built with CUDA, "
+         "and Ceres >= 2.3 with cuDSS for the sparse solvers). Fallback to the CPU solvers if not available.")
+        ("bundleAdjustmentAnalyticJacobians", po::value<bool>(&sfmParams.bundleAdjustmentAnalyticJacobians)->default_value(sfmParams.bundleAdjustmentAnalyticJacobians),
+         "Use cost functions with analytic Jacobians instead of the automatic differentiation in the bundle adjustment "
+         "(pinhole camera without distortion or with radial K1/K3 distortion). Other camera models use the automatic differentiation.")
         ("localizerEstimator", po::value<robustEstimation::ERobustEstimator>(&sfmParams.localizerEstimator)->default_value(sfmParams.localizerEstimator),
          "Estimator type used to localize cameras (acransac (default), ransac, lsmeds, loransac, maxconsensus).")
         ("localizerEstimatorError", po::value<double>(&sfmParams.localizerEstimatorError)->default_value(0.0),
@@ -182,6 +192,10 @@ int aliceVision_main(int argc, char** argv)
          "Minimal number of cameras to start the calibration of the rig.")
         ("lockScenePreviouslyReconstructed", po::value<bool>(&lockScenePreviouslyReconstructed)->default_value(lockScenePreviouslyReconstructed),
          "Lock/Unlock scene previously reconstructed.")
+        ("incrementalUpdate", po::value<bool>(&sfmParams.incrementalUpdate)->default_value(sfmParams.incrementalUpdate),
+         "Update the input reconstruction with its new views, without re-triangulating and globally adjusting the reconstructed views. "
+         "Only the matches involving the new views and the features of the matched views are loaded. "
+         "Recommended with the local bundle adjustment.")
         ("observationConstraint", po::value<EFeatureConstraint>(&sfmParams.featureConstraint)->default_value(sfmParams.featureConstraint),
          "Use of an observation constraint: basic, scale the observation or use of the covariance.")
         ("computeStructureColor", po::value<bool>(&computeStructureColor)->default_value(computeStructureColor),
@@ -243,14 +257,6 @@ int aliceVision_main(int argc, char** argv)
     // get imageDescriber type
     const std::vector<feature::EImageDescriberType> describerTypes = feature::EImageDescriberType_stringToEnums(describerTypesName);
 
-    // features reading
-    feature::FeaturesPerView featuresPerView;
-    if (!sfm::loadFeaturesPerView(featuresPerView, sfmData, featuresFolders, describerTypes))
-    {
-        ALICEVISION_LOG_ERROR("Invalid features.");
-        return EXIT_FAILURE;
-    }
-
     // matches reading
     matching::PairwiseMatches pairwiseMatches;
     if (!sfm::loadPairwiseMatches(
@@ -260,6 +266,51 @@ int aliceVision_main(int argc, char** argv)
         return EXIT_FAILURE;
     }
 
+    // views for which the features are needed, all of them by default
+    std::set<IndexT> featuresViewIds;
+
+    if (sfmParams.incrementalUpdate && !sfmData.getPoses().empty())
+    {
+        std::set<IndexT> newViewIds;
+        for (const auto& viewPair : sfmData.getViews())
+        {
+            if (!sfmData.isPoseAndIntrinsicDefined(viewPair.second.get()))
+                newViewIds.insert(viewPair.first);
+        }
+
+        // the tracks of the new views only need their matches, and the features of the views they are matched with
+        matching::filterMatchesTouchingViews(pairwiseMatches, newViewIds);
+
+        featuresViewIds = newViewIds;
+        for (const auto& matchesPair : pairwiseMatches)
+        {
+            featuresViewIds.insert(matchesPair.first.first);
+            featuresViewIds.insert(matchesPair.first.second);
+        }
+
+        ALICEVISION_LOG_INFO("Incremental update:" << std::endl
+                                                   << "\t- # new views: " << newViewIds.size() << std::endl
+                                                   << "\t- # image pairs involving the new views: " << pairwiseMatches.size() << std::endl
+                                                   << "\t- # views with features to load: " << featuresViewIds.size());
+
+        if (newViewIds.empty())
+        {
+            ALICEVISION_LOG_WARNING("No new view to add to the reconstruction.");
+            // a filter on an undefined view loads no features, while an empty one loads all of them
+            featuresViewIds.insert(UndefinedIndexT);
+        }
+        if (!sfmParams.useLocalBundleAdjustment)
+            ALICEVISION_LOG_WARNING("The incremental update adjusts all the landmarks at each step without the local bundle adjustment.");
+    }
+
+    // features reading
+    feature::FeaturesPerView featuresPerView;
+    if (!sfm::loadFeaturesPerView(featuresPerView, sfmData, featuresFolders, describerTypes, featuresViewIds))
+    {
+        ALICEVISION_LOG_ERROR("Invalid features.");
+        return EXIT_FAILURE;
+    }
+
     if (extraInfoFolder.empty())
         extraInfoFolder = fs::path(outputSfM).parent_path().string();
 
@@ -12,23 +12,35 @@
 #include <boost/program_options.hpp>
 #include <aliceVision/stl/hash.hpp>
 #include <aliceVision/geometry/Intersection.hpp>
+#include <algorithm>
+#include <cmath>
 #include <fstream>
 
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 1
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 1
 
 using namespace aliceVision;
 
 namespace po = boost::program_options;
 
-inline size_t computeHash(const Point3d& pt)
+/**
+ * @brief Cell of a point in the uniform grid used to look up the coincident vertices.
+ */
+inline Eigen::Vector3i computeCell(const Point3d& pt, double cellSize)
+{
+    return Eigen::Vector3i(static_cast<int>(std::floor(pt.x / cellSize)),
+                           static_cast<int>(std::floor(pt.y / cellSize)),
+                           static_cast<int>(std::floor(pt.z / cellSize)));
+}
+
+inline size_t computeHash(const Eigen::Vector3i& cell)
 {
     size_t seed = 0;
-    stl::hash_combine(seed, size_t(pt.x * 100.0));
-    stl::hash_combine(seed, size_t(pt.y * 100.0));
-    stl::hash_combine(seed, size_t(pt.z * 100.0));
+    stl::hash_combine(seed, cell.x());
+    stl::hash_combine(seed, cell.y());
+    stl::hash_combine(seed, cell.z());
     return seed;
 }
 
@@ -41,12 +53,42 @@ inline size_t computeHash(const mesh::Mesh::triangle& tri)
     return seed;
 }
 
+/**
+ * @brief Keep the triangles of a sub mesh whose centroid is inside its owned region.
+ *        The borders of the sub regions are meshed by the neighboring sub regions as well,
+ *        the half-open owned regions give each part of the surface to a single sub mesh.
+ * @param[in,out] subMesh the sub mesh, its vertices are left unchanged
+ * @param[in] bbMin the minimal corner of the owned region
+ * @param[in] bbMax the maximal corner of the owned region
+ */
+void cropToOwnedRegion(mesh::Mesh& subMesh, const Eigen::Vector3d& bbMin, const Eigen::Vector3d& bbMax)
+{
+    StaticVector<mesh::Mesh::triangle> tris;
+    tris.reserve(subMesh.tris.size());
+
+    for (int indexTriangle = 0; indexTriangle < subMesh.tris.size(); indexTriangle++)
+    {
+        const auto& tri = subMesh.tris[indexTriangle];
+        const Point3d center = (subMesh.pts[tri.v[0]] + subMesh.pts[tri.v[1]] + subMesh.pts[tri.v[2]]) / 3.0;
+
+        if (center.x < bbMin.x() || center.y < bbMin.y() || center.z < bbMin.z())
+            continue;
+        if (center.x >= bbMax.x() || center.y >= bbMax.y() || center.z >= bbMax.z())
+            continue;
+
+        tris.push_back(tri);
+    }
+
+    subMesh.tris.swap(tris);
+}
+
 int aliceVision_main(int argc, char* argv[])
 {
     system::Timer timer;
 
     std::string jsonFilename = "";
     std::string outputMeshFilename = "";
+    double weldTolerance = 0.001;
 
     // clang-format off
     po::options_description requiredParams("Required parameters");
@@ -55,10 +97,16 @@ int aliceVision_main(int argc, char* argv[])
          "Input JSON file.")
         ("output,o", po::value<std::string>(&outputMeshFilename)->required(),
          "Output mesh file.");
+
+    po::options_description optionalParams("Optional parameters");
+    optionalParams.add_options()
+        ("weldTolerance", po::value<double>(&weldTolerance)->default_value(weldTolerance),
+         "Maximal distance in meters between the vertices of two sub meshes merged on their seam (0 to merge the identical vertices only).");
     // clang-format on
 
-    CmdLine cmdline("AliceVision lidarMeshing");
+    CmdLine cmdline("AliceVision lidarMerging");
     cmdline.add(requiredParams);
+    cmdline.add(optionalParams);
     if (!cmdline.execute(argc, argv))
     {
         return EXIT_FAILURE;
@@ -66,7 +114,6 @@ int aliceVision_main(int argc, char* argv[])
 
     // Set maxThreads
     HardwareContext hwc = cmdline.getHardwareContext();
-    // omp_set_num_threads(std::min(32u, hwc.getMaxThreads()));
 
     std::ifstream inputfile(jsonFilename);
     if (!inputfile.is_open())
@@ -82,75 +129,115 @@ int aliceVision_main(int argc, char* argv[])
 
     int setSize = static_cast<int>(inputsets.size());
 
-    mesh::Mesh globalMesh;
-
-    std::unordered_map<size_t, std::vector<size_t>> hashedpts;
-    std::unordered_map<size_t, std::vector<size_t>> hashedtris;
+    // Load the sub meshes and crop them to their owned region in parallel
+    std::vector<mesh::Mesh> subMeshes(setSize);
+    bool failed = false;
 
+#pragma omp parallel for schedule(dynamic) num_threads(hwc.getMaxThreads())
     for (int idRef = 0; idRef < setSize; idRef++)
     {
         const fuseCut::Input& refInput = inputsets[idRef];
 
-        mesh::Mesh meshReference;
         try
         {
-            meshReference.load(refInput.subMeshPath);
+            subMeshes[idRef].load(refInput.subMeshPath);
         }
         catch (...)
         {
             ALICEVISION_LOG_ERROR("Can't read mesh " << refInput.subMeshPath);
-            return EXIT_FAILURE;
+#pragma omp critical
+            failed = true;
+            continue;
         }
 
-        std::unordered_map<size_t, size_t> transform;
+        cropToOwnedRegion(subMeshes[idRef], refInput.ownedBbMin, refInput.ownedBbMax);
+    }
+
+    if (failed)
+    {
+        return EXIT_FAILURE;
+    }
+
+    mesh::Mesh globalMesh;
+
+    // the cells are larger than the tolerance: the coincident vertices are in the same or the adjacent cells
+    const double cellSize = std::max(0.01, weldTolerance);
+    const int searchRadius = weldTolerance > 0.0 ? 1 : 0;
+
+    std::unordered_map<size_t, std::vector<size_t>> hashedpts;
+    std::unordered_map<size_t, std::vector<size_t>> hashedtris;
+
+    for (int idRef = 0; idRef < setSize; idRef++)
+    {
+        mesh::Mesh& meshReference = subMeshes[idRef];
+
+        // index in the global mesh of each vertex of the sub mesh, only the vertices of the kept triangles are merged
+        std::vector<int> transform(meshReference.pts.size(), -1);
+
+        const auto getGlobalIndex = [&](int indexPt) {
+            if (transform[indexPt] >= 0)
+            {
+                return transform[indexPt];
+            }
 
-        int count = 0;
-        for (int indexPt = 0; indexPt < meshReference.pts.size(); indexPt++)
-        {
             const Point3d& pt = meshReference.pts[indexPt];
+            const Eigen::Vector3i cell = computeCell(pt, cellSize);
 
-            // Lookup if the point exist in the global mesh
-            size_t hash = computeHash(pt);
-            size_t indexFound = 0;
-            bool found = false;
-            auto it = hashedpts.find(hash);
-            if (it != hashedpts.end())
+            // Lookup the closest point of the global mesh within the tolerance
+            int indexFound = -1;
+            double bestDistance = weldTolerance;
+            for (int dx = -searchRadius; dx <= searchRadius; dx++)
             {
-                for (const auto& idx : it->second)
+                for (int dy = -searchRadius; dy <= searchRadius; dy++)
                 {
-                    const Point3d& otherPt = globalMesh.pts[idx];
-                    if (otherPt == pt)
+                    for (int dz = -searchRadius; dz <= searchRadius; dz++)
                     {
-                        found = true;
-                        indexFound = idx;
-                        break;
+                        auto it = hashedpts.find(computeHash(Eigen::Vector3i(cell + Eigen::Vector3i(dx, dy, dz))));
+                        if (it == hashedpts.end())
+                        {
+                            continue;
+                        }
+
+                        for (const auto& idx : it->second)
+                        {
+                            const double distance = (globalMesh.pts[idx] - pt).size();
+                            if (distance <= bestDistance)
+                            {
+                                bestDistance = distance;
+                                indexFound = idx;
+                            }
+                        }
                     }
                 }
             }
 
-            if (found)
-            {
-                transform[indexPt] = indexFound;
-                count++;
-            }
-            else
+            if (indexFound < 0)
             {
                 // If not found, it's a new point !
-                size_t index = globalMesh.pts.size();
-                transform[indexPt] = index;
+                indexFound = globalMesh.pts.size();
                 globalMesh.pts.push_back(pt);
-                hashedpts[hash].push_back(index);
+                hashedpts[computeHash(cell)].push_back(indexFound);
             }
-        }
+
+            transform[indexPt] = indexFound;
+            return indexFound;
+        };
 
         // Copy the triangles
         for (size_t indexTriangle = 0; indexTriangle < meshReference.tris.size(); indexTriangle++)
         {
             const auto& tri = meshReference.tris[indexTriangle];
 
-            int tv1 = transform[tri.v[0]];
-            int tv2 = transform[tri.v[1]];
-            int tv3 = transform[tri.v[2]];
+            int tv1 = getGlobalIndex(tri.v[0]);
+            int tv2 = getGlobalIndex(tri.v[1]);
+            int tv3 = getGlobalIndex(tri.v[2]);
+
+            // the welding may collapse a small triangle on the seam
+            if (tv1 == tv2 || tv2 == tv3 || tv1 == tv3)
+            {
+                continue;
+            }
+
             mesh::Mesh::triangle newTriangle(tv1, tv2, tv3);
 
             /*Check if the triangle exists in the global mesh*/
@@ -179,6 +266,9 @@ int aliceVision_main(int argc, char* argv[])
             hashedtris[hash].push_back(globalMesh.tris.size());
             globalMesh.tris.push_back(newTriangle);
         }
+
+        // release the sub mesh once merged
+        meshReference = mesh::Mesh();
     }
 
     globalMesh.save(outputMeshFilename);
@@ -23,18 +23,31 @@
 #include <aliceVision/mesh/meshPostProcessing.hpp>
 
 #include <boost/program_options.hpp>
+
+#include <algorithm>
+#include <exception>
 #include <fstream>
 
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 1
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 1
 
 using namespace aliceVision;
 
 namespace po = boost::program_options;
 
-bool computeSubMesh(const std::string& pathSfmData, std::string& outputFile, const Eigen::Vector3d& bbMin, const Eigen::Vector3d& bbMax)
+/**
+ * @brief Rough upper bound of the meshing memory per input point,
+ *        dominated by the tetrahedra (about 6.5 per vertex) and their graph cut information.
+ */
+constexpr double meshingMemoryPerPoint = 1024.0;
+
+bool computeSubMesh(const std::string& pathSfmData,
+                    std::string& outputFile,
+                    const Eigen::Vector3d& bbMin,
+                    const Eigen::Vector3d& bbMax,
+                    bool parallelDelaunay)
 {
     // initialization
     StaticVector<StaticVector<int>> ptsCams;
@@ -118,7 +131,7 @@ bool computeSubMesh(const std::string& pathSfmData, std::string& outputFile, con
     sfmData.clear();
 
     ALICEVISION_LOG_INFO("Tetrahedralization");
-    fuseCut::Tetrahedralization tetrahedralization(pointcloud.getVertices());
+    fuseCut::Tetrahedralization tetrahedralization(pointcloud.getVertices(), parallelDelaunay);
     ALICEVISION_LOG_INFO("Tetrahedralization done");
 
     fuseCut::GraphFiller gfiller(mp, pointcloud, tetrahedralization);
@@ -218,19 +231,71 @@ int aliceVision_main(int argc, char* argv[])
         rangeEnd = setSize;
     }
 
+    // Mesh several sub regions concurrently when they fit in memory.
+    // The size of the sub regions is unknown for the inputs written by an older importE57: one at a time.
+    std::size_t maxPoints = 0;
+    bool knownSizes = true;
+    for (int idSub = rangeStart; idSub < rangeEnd; idSub++)
+    {
+        maxPoints = std::max(maxPoints, inputsets[idSub].nbPoints);
+        knownSizes = knownSizes && inputsets[idSub].nbPoints > 0;
+    }
+
+    int nbParallelSubMeshes = 1;
+    if (knownSizes && maxPoints > 0)
+    {
+        const double subMeshMemory = static_cast<double>(maxPoints) * meshingMemoryPerPoint;
+        nbParallelSubMeshes = std::max(
+          1, std::min(static_cast<int>(hwc.getMaxThreads()), static_cast<int>(static_cast<double>(hwc.getMaxMemory()) / subMeshMemory)));
+    }
+    nbParallelSubMeshes = std::min(nbParallelSubMeshes, std::max(1, rangeEnd - rangeStart));
+    ALICEVISION_LOG_INFO("Compute " << nbParallelSubMeshes << " sub meshes in parallel.");
+
+    // the parallel Delaunay would compete with the other sub meshes for the threads
+    const bool parallelDelaunay = nbParallelSubMeshes == 1;
+
+    std::exception_ptr exception;
+    bool failed = false;
+
+#pragma omp parallel for schedule(dynamic) num_threads(nbParallelSubMeshes)
     for (int idSub = rangeStart; idSub < rangeEnd; idSub++)
     {
-        const fuseCut::Input& input = inputsets[idSub];
-        std::string ss = outputDirectory + "/subobj_" + std::to_string(idSub) + ".obj";
+        if (exception || failed)
+        {
+            continue;
+        }
 
-        ALICEVISION_LOG_INFO("Computing sub mesh " << idSub + 1 << " / " << setSize);
-        if (!computeSubMesh(input.sfmPath, ss, input.bbMin, input.bbMax))
+        try
         {
-            ALICEVISION_LOG_ERROR("Error computing sub mesh");
-            return EXIT_FAILURE;
+            const fuseCut::Input& input = inputsets[idSub];
+            std::string ss = outputDirectory + "/subobj_" + std::to_string(idSub) + ".obj";
+
+            ALICEVISION_LOG_INFO("Computing sub mesh " << idSub + 1 << " / " << setSize);
+            if (!computeSubMesh(input.sfmPath, ss, input.bbMin, input.bbMax, parallelDelaunay))
+            {
+                ALICEVISION_LOG_ERROR("Error computing sub mesh");
+#pragma omp critical
+                failed = true;
+                continue;
+            }
+
+            ALICEVISION_LOG_INFO(ss);
+        }
+        catch (...)
+        {
+#pragma omp critical
+            exception = std::current_exception();
         }
+    }
+
+    if (exception)
+    {
+        std::rethrow_exception(exception);
+    }
 
-        ALICEVISION_LOG_INFO(ss);
+    if (failed)
+    {
+        return EXIT_FAILURE;
     }
 
     // Only the first chunk may update the json file
@@ -9,6 +9,8 @@
 #include <aliceVision/system/main.hpp>
 #include <aliceVision/system/Timer.hpp>
 #include <aliceVision/mvsUtils/common.hpp>
+#include <aliceVision/mesh/Mesh.hpp>
+#include <aliceVision/mesh/meshDecimation.hpp>
 
 #include <OpenMesh/Core/IO/reader/OBJReader.hh>
 #include <OpenMesh/Core/IO/writer/OBJWriter.hh>
@@ -25,13 +27,40 @@
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 1
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 1
 
 using namespace aliceVision;
 
 namespace fs = std::filesystem;
 namespace po = boost::program_options;
 
+int computeNbOutputVertices(int nbInputPoints, float simplificationFactor, int fixedNbVertices, int minVertices, int maxVertices)
+{
+    int nbOutputPoints = 0;
+    if (fixedNbVertices != 0)
+    {
+        nbOutputPoints = fixedNbVertices;
+    }
+    else
+    {
+        if (simplificationFactor != 0.0)
+        {
+            nbOutputPoints = simplificationFactor * nbInputPoints;
+        }
+        if (minVertices != 0)
+        {
+            if (nbInputPoints > minVertices && nbOutputPoints < minVertices)
+                nbOutputPoints = minVertices;
+        }
+        if (maxVertices != 0)
+        {
+            if (nbInputPoints > maxVertices && nbOutputPoints > maxVertices)
+                nbOutputPoints = maxVertices;
+        }
+    }
+    return nbOutputPoints;
+}
+
 int aliceVision_main(int argc, char* argv[])
 {
     system::Timer timer;
@@ -43,6 +72,8 @@ int aliceVision_main(int argc, char* argv[])
     int minVertices = 0;
     int maxVertices = 0;
     bool flipNormals = false;
+    bool blockDecimation = false;
+    mesh::BlockDecimationParams blockParams;
 
     // clang-format off
     po::options_description requiredParams("Required parameters");
@@ -64,7 +95,14 @@ int aliceVision_main(int argc, char* argv[])
          "Max number of output vertices.")
         ("flipNormals", po::value<bool>(&flipNormals)->default_value(flipNormals),
          "Option to flip face normals. It can be needed as it depends on the vertices order in triangles and the "
-         "convention changes from one software to another.");
+         "convention changes from one software to another.")
+        ("blockDecimation", po::value<bool>(&blockDecimation)->default_value(blockDecimation),
+         "Decimate the mesh by spatial blocks in parallel, the vertices on the borders of the blocks being locked. "
+         "The grid of blocks is shifted at each iteration to decimate the previous borders.")
+        ("maxTrianglesPerBlock", po::value<int>(&blockParams.maxTrianglesPerBlock)->default_value(blockParams.maxTrianglesPerBlock),
+         "Block decimation: target number of triangles per block.")
+        ("blockIterations", po::value<int>(&blockParams.nbIterations)->default_value(blockParams.nbIterations),
+         "Block decimation: number of passes over the blocks.");
     // clang-format on
 
     CmdLine cmdline("AliceVision meshDecimate");
@@ -80,6 +118,37 @@ int aliceVision_main(int argc, char* argv[])
     if (!fs::is_directory(outDirectory))
         fs::create_directory(outDirectory);
 
+    if (blockDecimation)
+    {
+        mesh::Mesh inputMesh;
+        inputMesh.load(inputMeshPath);
+
+        ALICEVISION_LOG_INFO("Mesh file: \"" << inputMeshPath << "\" loaded.");
+
+        const int nbInputPoints = inputMesh.pts.size();
+        const int nbOutputPoints = computeNbOutputVertices(nbInputPoints, simplificationFactor, fixedNbVertices, minVertices, maxVertices);
+
+        ALICEVISION_LOG_INFO("Input mesh: " << nbInputPoints << " vertices and " << inputMesh.tris.size() << " facets.");
+        ALICEVISION_LOG_INFO("Target output mesh: " << nbOutputPoints << " vertices.");
+
+        mesh::decimateByBlocks(inputMesh, nbOutputPoints, blockParams);
+
+        ALICEVISION_LOG_INFO("Output mesh: " << inputMesh.pts.size() << " vertices and " << inputMesh.tris.size() << " facets.");
+
+        if (inputMesh.tris.empty())
+        {
+            ALICEVISION_LOG_ERROR("Failed: the output mesh is empty.");
+            return EXIT_FAILURE;
+        }
+
+        ALICEVISION_LOG_INFO("Save mesh.");
+        inputMesh.save(outputMeshPath);
+        ALICEVISION_LOG_INFO("Mesh file: \"" << outputMeshPath << "\" saved.");
+
+        ALICEVISION_LOG_INFO("Task done in (s): " + std::to_string(timer.elapsed()));
+        return EXIT_SUCCESS;
+    }
+
     // Mesh type
     typedef OpenMesh::TriMesh_ArrayKernelT<> Mesh;
     // Decimater type
@@ -97,28 +166,7 @@ int aliceVision_main(int argc, char* argv[])
     ALICEVISION_LOG_INFO("Mesh file: \"" << inputMeshPath << "\" loaded.");
 
     int nbInputPoints = mesh.n_vertices();
-    int nbOutputPoints = 0;
-    if (fixedNbVertices != 0)
-    {
-        nbOutputPoints = fixedNbVertices;
-    }
-    else
-    {
-        if (simplificationFactor != 0.0)
-        {
-            nbOutputPoints = simplificationFactor * nbInputPoints;
-        }
-        if (minVertices != 0)
-        {
-            if (nbInputPoints > minVertices && nbOutputPoints < minVertices)
-                nbOutputPoints = minVertices;
-        }
-        if (maxVertices != 0)
-        {
-            if (nbInputPoints > maxVertices && nbOutputPoints > maxVertices)
-                nbOutputPoints = maxVertices;
-        }
-    }
+    int nbOutputPoints = computeNbOutputVertices(nbInputPoints, simplificationFactor, fixedNbVertices, minVertices, maxVertices);
 
     ALICEVISION_LOG_INFO("Input mesh: " << nbInputPoints << " vertices and " << mesh.n_faces() << " facets.");
     ALICEVISION_LOG_INFO("Target output mesh: " << nbOutputPoints << " vertices.");
@@ -34,7 +34,7 @@
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 4
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 3
 
 using namespace aliceVision;
 
@@ -167,6 +167,8 @@ int aliceVision_main(int argc, char* argv[])
     double nPixelSizeBehind = 4.0;
     double fullWeight = 1.0;
     bool exportDebugTetrahedralization = false;
+    bool parallelDelaunay = true;
+    fuseCut::EMaxFlowType maxFlowType = fuseCut::EMaxFlowType::ADJLIST;
     int maxNbConnectedHelperPoints = 50;
 
     // clang-format off
@@ -195,6 +197,8 @@ int aliceVision_main(int argc, char* argv[])
          "The step used to load depth values from depth maps is computed from maxInputPts. "
          "Here we define the minimal value for this step, so on small datasets we will not spend too much time at the "
          "beginning loading all depth values.")
+        ("nbLoadThreads", po::value<int>(&fuseParams.nbLoadThreads)->default_value(fuseParams.nbLoadThreads),
+         "Number of depth maps loaded in parallel (the memory usage grows with it).")
         ("simFactor", po::value<float>(&fuseParams.simFactor)->default_value(fuseParams.simFactor),
          "simFactor.")
         ("angleFactor", po::value<float>(&fuseParams.angleFactor)->default_value(fuseParams.angleFactor),
@@ -267,6 +271,10 @@ int aliceVision_main(int argc, char* argv[])
          "Maximum number of connected helper points before we remove them.")
         ("exportDebugTetrahedralization", po::value<bool>(&exportDebugTetrahedralization)->default_value(exportDebugTetrahedralization),
          "Export debug cells score as tetrahedral mesh. WARNING: could create huge meshes, only use on very small datasets.")
+        ("parallelDelaunay", po::value<bool>(&parallelDelaunay)->default_value(parallelDelaunay),
+         "Use the multithreaded Delaunay tetrahedralization.")
+        ("maxFlowType", po::value<fuseCut::EMaxFlowType>(&maxFlowType)->default_value(maxFlowType),
+         "Maxflow graph representation for the graph cut: adjList or csr (less memory).")
         ("seed", po::value<unsigned int>(&seed)->default_value(seed),
          "Seed used in random processes. (0 to use a random seed).");
     // clang-format on
@@ -317,6 +325,7 @@ int aliceVision_main(int argc, char* argv[])
     mp.userParams.put("delaunaycut.nPixelSizeBehind", nPixelSizeBehind);
     mp.userParams.put("delaunaycut.fullWeight", fullWeight);
     mp.userParams.put("delaunaycut.voteFilteringForWeaklySupportedSurfaces", voteFilteringForWeaklySupportedSurfaces);
+    mp.userParams.put("delaunaycut.maxFlowType", fuseCut::EMaxFlowType_enumToString(maxFlowType));
     mp.userParams.put("hallucinationsFiltering.invertTetrahedronBasedOnNeighborsNbIterations", invertTetrahedronBasedOnNeighborsNbIterations);
     mp.userParams.put("hallucinationsFiltering.minSolidAngleRatio", minSolidAngleRatio);
     mp.userParams.put("hallucinationsFiltering.nbSolidAngleFilteringIterations", nbSolidAngleFilteringIterations);
@@ -400,7 +409,7 @@ int aliceVision_main(int argc, char* argv[])
                     fuseCut::PointCloud pc(mp);
                     pc.createDensePointCloud(&hexah[0], cams, addLandmarksToTheDensePointCloud ? &sfmData : nullptr, meshingFromDepthMaps ? &fuseParams : nullptr);
 
-                    fuseCut::Tetrahedralization tetrahedralization(pc.getVertices());
+                    fuseCut::Tetrahedralization tetrahedralization(pc.getVertices(), parallelDelaunay);
 
                     if (saveRawDensePointCloud)
                     {
@@ -449,6 +458,20 @@ int aliceVision_main(int argc, char* argv[])
     if (ptsCams.empty())
         throw std::runtime_error("Points visibilities data has not been initialized.");
 
+    // spatial order of the vertices and triangles, for the memory locality of the next steps
+    {
+        StaticVector<int> ptIdToNewPtId;
+        mesh->reorderSpatially(ptIdToNewPtId);
+
+        StaticVector<StaticVector<int>> reorderedPtsCams;
+        reorderedPtsCams.resize(ptsCams.size());
+        for (int i = 0; i < ptsCams.size(); ++i)
+        {
+            reorderedPtsCams[ptIdToNewPtId[i]].swap(ptsCams[i]);
+        }
+        ptsCams.swap(reorderedPtsCams);
+    }
+
     sfmData::SfMData densePointCloud;
     createDenseSfMData(sfmData, mp, mesh->pts.getData(), ptsCams, densePointCloud);
 
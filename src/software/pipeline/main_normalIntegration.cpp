@@ -19,6 +19,10 @@
 #include <aliceVision/cmdline/cmdline.hpp>
 #include <aliceVision/system/main.hpp>
 #include <aliceVision/system/Logger.hpp>
+#include <aliceVision/config.hpp>
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
+    #include <aliceVision/gpu/gpu.hpp>
+#endif
 
 #include <boost/algorithm/string.hpp>
 #include <boost/program_options.hpp>
@@ -43,7 +47,7 @@
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 1
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 2
 
 using namespace aliceVision;
 
@@ -62,6 +66,9 @@ int aliceVision_main(int argc, char** argv)
     // Image downscale factor during process
     int downscale = 1;
 
+    photometricStereo::EIntegrationSolver solver = photometricStereo::EIntegrationSolver::DCT;
+    bool useGpu = false;
+
     // clang-format off
     po::options_description requiredParams("Required parameters");
     requiredParams.add_options()
@@ -75,7 +82,12 @@ int aliceVision_main(int argc, char** argv)
         ("sfmDataFile,s", po::value<std::string>(&sfmDataFile)->default_value(""),
          "Path to the input SfMData file.")
         ("downscale,d", po::value<int>(&downscale)->default_value(downscale),
-         "Downscale factor for faster results.");
+         "Downscale factor for faster results.")
+        ("solver", po::value<photometricStereo::EIntegrationSolver>(&solver)->default_value(solver),
+         "Solver of the Poisson equation of the depth: dct (cosine transform) or multigrid (preconditioned conjugate gradient, "
+         "linear in the number of pixels, for the large normal maps).")
+        ("useGpu", po::value<bool>(&useGpu)->default_value(useGpu),
+         "Solve the Poisson equation of the depth with the multigrid solver on the GPU (requires a build with CUDA).");
     // clang-format on
 
     CmdLine cmdline("AliceVision normalIntegration");
@@ -87,9 +99,23 @@ int aliceVision_main(int argc, char** argv)
         return EXIT_FAILURE;
     }
 
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
+    if (useGpu && !gpu::gpuSupportCUDA(3, 0))
+    {
+        ALICEVISION_LOG_WARNING("No compatible CUDA device found, the normals will be integrated on the CPU.");
+        useGpu = false;
+    }
+#else
+    if (useGpu)
+    {
+        ALICEVISION_LOG_WARNING("GPU normal integration requires a build with CUDA, the normals will be integrated on the CPU.");
+        useGpu = false;
+    }
+#endif
+
     if (sfmDataFile.compare("") == 0)
     {
-        photometricStereo::normalIntegration(inputPath, isPerspective, downscale, outputFolder);
+        photometricStereo::normalIntegration(inputPath, isPerspective, downscale, outputFolder, solver, useGpu);
     }
     else
     {
@@ -99,7 +125,7 @@ int aliceVision_main(int argc, char** argv)
             ALICEVISION_LOG_ERROR("The input file '" + sfmDataFile + "' cannot be read.");
             return EXIT_FAILURE;
         }
-        photometricStereo::normalIntegration(sfmData, inputPath, isPerspective, downscale, outputFolder);
+        photometricStereo::normalIntegration(sfmData, inputPath, isPerspective, downscale, outputFolder, solver, useGpu);
     }
 
     ALICEVISION_LOG_INFO("Task done in (s): " + std::to_string(timer.elapsed()));
@@ -19,6 +19,11 @@
 
 // System
 #include <aliceVision/system/Logger.hpp>
+#include <aliceVision/config.hpp>
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
+    #include <aliceVision/gpu/gpu.hpp>
+#endif
+#include <aliceVision/utils/filesIO.hpp>
 
 // Reading command line options
 #include <boost/program_options.hpp>
@@ -32,13 +37,14 @@
 #include <filesystem>
 #include <fstream>
 #include <algorithm>
+#include <map>
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/json_parser.hpp>
 
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 1
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 2
 
 using namespace aliceVision;
 
@@ -89,6 +95,13 @@ std::unique_ptr<PanoramaMap> buildMap(const sfmData::SfMData& sfmData,
     std::vector<std::pair<IndexT, BoundingBox>> listBoundingBox;
     std::pair<std::size_t, std::size_t> panoramaSize;
 
+    // Bounding boxes precomputed by the warping, the metadata of the masks are only read for the missing ones
+    WarpedBoundingBoxes warpedBoxes;
+    if (loadWarpedBoundingBoxes(inputPath, warpedBoxes))
+    {
+        ALICEVISION_LOG_TRACE("Bounding boxes of " << warpedBoxes.boundingBoxes.size() << " warped images loaded");
+    }
+
     for (const auto& viewIt : sfmData.getViews())
     {
         if (!sfmData.isPoseAndIntrinsicDefined(viewIt.first))
@@ -96,29 +109,37 @@ std::unique_ptr<PanoramaMap> buildMap(const sfmData::SfMData& sfmData,
 
         const std::string warpedPath = viewIt.second->getImage().getMetadata().at("AliceVision:warpedPath");
 
-        // Load mask
-        const std::string maskPath = (fs::path(inputPath) / (warpedPath + "_mask.exr")).string();
-        ALICEVISION_LOG_TRACE("Load metadata of mask with path " << maskPath);
-
-        int width = 0;
-        int height = 0;
-        oiio::ParamValueList metadata = image::readImageMetadata(maskPath, width, height);
-        const int offsetX = metadata.find("AliceVision:offsetX")->get_int();
-        const int offsetY = metadata.find("AliceVision:offsetY")->get_int();
-        panoramaSize.first = metadata.find("AliceVision:panoramaWidth")->get_int();
-        panoramaSize.second = metadata.find("AliceVision:panoramaHeight")->get_int();
-
         BoundingBox bb;
-        bb.left = offsetX;
-        bb.top = offsetY;
-        bb.width = width;
-        bb.height = height;
+        const auto itWarpedBox = warpedBoxes.boundingBoxes.find(warpedPath);
+        if (itWarpedBox != warpedBoxes.boundingBoxes.end())
+        {
+            bb = itWarpedBox->second;
+            panoramaSize.first = warpedBoxes.panoramaWidth;
+            panoramaSize.second = warpedBoxes.panoramaHeight;
+        }
+        else
+        {
+            // Load mask
+            const std::string maskPath = (fs::path(inputPath) / (warpedPath + "_mask.exr")).string();
+            ALICEVISION_LOG_TRACE("Load metadata of mask with path " << maskPath);
+
+            int width = 0;
+            int height = 0;
+            oiio::ParamValueList metadata = image::readImageMetadata(maskPath, width, height);
+            panoramaSize.first = metadata.find("AliceVision:panoramaWidth")->get_int();
+            panoramaSize.second = metadata.find("AliceVision:panoramaHeight")->get_int();
+
+            bb.left = metadata.find("AliceVision:offsetX")->get_int();
+            bb.top = metadata.find("AliceVision:offsetY")->get_int();
+            bb.width = width;
+            bb.height = height;
+        }
 
         if (viewIt.first == 0)
             continue;
 
         listBoundingBox.push_back(std::make_pair(viewIt.first, bb));
-        size_t scale = getCompositingOptimalScale(width, height);
+        size_t scale = getCompositingOptimalScale(bb.width, bb.height);
         if (scale > max_scale)
         {
             max_scale = scale;
@@ -142,17 +163,27 @@ std::unique_ptr<PanoramaMap> buildMap(const sfmData::SfMData& sfmData,
     return ret;
 }
 
-bool processImage(const PanoramaMap& panoramaMap,
-                  const sfmData::SfMData& sfmData,
-                  const std::string& compositerType,
-                  const std::string& warpingFolder,
-                  const std::string& labelsFilePath,
-                  const std::string& outputFolder,
-                  const image::EStorageDataType& storageDataType,
-                  IndexT viewReference,
-                  const BoundingBox& referenceBoundingBox,
-                  bool showBorders,
-                  bool showSeams)
+/**
+ * @brief Composite the inputs overlapping a region of the panorama.
+ * @param[in] useGpu Build the laplacian pyramids of the multiband compositer on the GPU
+ * @param[out] output The composited region
+ * @param[out] metadata The metadata of the output image
+ * @param[out] colorSpace The color space of the inputs
+ * @return false if an error occurred
+ */
+bool compositeRegion(const PanoramaMap& panoramaMap,
+                     const sfmData::SfMData& sfmData,
+                     const std::string& compositerType,
+                     const std::string& warpingFolder,
+                     const std::string& labelsFilePath,
+                     const image::EStorageDataType& storageDataType,
+                     const BoundingBox& referenceBoundingBox,
+                     bool showBorders,
+                     bool showSeams,
+                     bool useGpu,
+                     image::Image<image::RGBAfColor>& output,
+                     oiio::ParamValueList& metadata,
+                     std::string& colorSpace)
 {
     // The laplacian pyramid must also contains some pixels outside of the bounding box to make sure
     // there is a continuity between all the "views" of the panorama.
@@ -175,7 +206,7 @@ bool processImage(const PanoramaMap& panoramaMap,
         panoramaBoundingBox.clampBottom(panoramaMap.getHeight());
 
         compositer =
-          std::unique_ptr<Compositer>(new LaplacianCompositer(panoramaBoundingBox.width, panoramaBoundingBox.height, panoramaMap.getScale()));
+          std::unique_ptr<Compositer>(new LaplacianCompositer(panoramaBoundingBox.width, panoramaBoundingBox.height, panoramaMap.getScale(), useGpu));
     }
     else if (compositerType == "alpha")
     {
@@ -191,19 +222,20 @@ bool processImage(const PanoramaMap& panoramaMap,
     }
 
     // Get the list of input which should be processed for this reference view bounding box
-    std::vector<IndexT> overlappingViews;
-    if (!panoramaMap.getOverlaps(overlappingViews, referenceBoundingBox))
+    std::vector<IndexT> candidateViews;
+    if (!panoramaMap.getOverlaps(candidateViews, referenceBoundingBox))
     {
         ALICEVISION_LOG_ERROR("Problem analyzing neighboorhood");
         return false;
     }
 
-    // Compute the bounding box of the intersections with the reference bounding box
-    // (which may be larger than the reference Bounding box because of dilatation)
-    BoundingBox globalUnionBoundingBox;
-    for (IndexT viewCurrent : overlappingViews)
+    // Compute once the list of intersections between each view and the reference view
+    // (and the bounding box of the view, shifted for each loop of the panorama)
+    std::vector<IndexT> overlappingViews;
+    std::map<IndexT, std::vector<BoundingBox>> intersectionsPerView;
+    std::map<IndexT, std::vector<BoundingBox>> boundingBoxesPerView;
+    for (IndexT viewCurrent : candidateViews)
     {
-        // Compute list of intersection between this view and the reference view
         std::vector<BoundingBox> intersections;
         std::vector<BoundingBox> currentBoundingBoxes;
         if (!panoramaMap.getIntersectionsList(intersections, currentBoundingBoxes, referenceBoundingBox, viewCurrent))
@@ -211,7 +243,17 @@ bool processImage(const PanoramaMap& panoramaMap,
             continue;
         }
 
-        for (BoundingBox& bb : intersections)
+        overlappingViews.push_back(viewCurrent);
+        intersectionsPerView[viewCurrent] = std::move(intersections);
+        boundingBoxesPerView[viewCurrent] = std::move(currentBoundingBoxes);
+    }
+
+    // Compute the bounding box of the intersections with the reference bounding box
+    // (which may be larger than the reference Bounding box because of dilatation)
+    BoundingBox globalUnionBoundingBox;
+    for (IndexT viewCurrent : overlappingViews)
+    {
+        for (const BoundingBox& bb : intersectionsPerView.at(viewCurrent))
         {
             globalUnionBoundingBox = globalUnionBoundingBox.unionWith(bb);
         }
@@ -231,13 +273,8 @@ bool processImage(const PanoramaMap& panoramaMap,
         image::Image<unsigned char> mask;
         image::readImageDirect(maskPath, mask);
 
-        // Compute list of intersection between this view and the reference view
-        std::vector<BoundingBox> intersections;
-        std::vector<BoundingBox> currentBoundingBoxes;
-        if (!panoramaMap.getIntersectionsList(intersections, currentBoundingBoxes, referenceBoundingBox, viewCurrent))
-        {
-            continue;
-        }
+        const std::vector<BoundingBox>& intersections = intersectionsPerView.at(viewCurrent);
+        const std::vector<BoundingBox>& currentBoundingBoxes = boundingBoxesPerView.at(viewCurrent);
 
         for (int indexIntersection = 0; indexIntersection < intersections.size(); indexIntersection++)
         {
@@ -397,7 +434,7 @@ bool processImage(const PanoramaMap& panoramaMap,
     bool hasFailed = false;
 
     // Load metadata to get image color space
-    std::string colorSpace = "Linear";
+    colorSpace = "Linear";
     oiio::ParamValueList srcMetadata;
     if (!overlappingViews.empty())
     {
@@ -420,13 +457,8 @@ bool processImage(const PanoramaMap& panoramaMap,
 
         ALICEVISION_LOG_INFO("Processing input " << posCurrent << "/" << overlappingViews.size());
 
-        // Compute list of intersection between this view and the reference view
-        std::vector<BoundingBox> intersections;
-        std::vector<BoundingBox> currentBoundingBoxes;
-        if (!panoramaMap.getIntersectionsList(intersections, currentBoundingBoxes, referenceBoundingBox, viewCurrent))
-        {
-            continue;
-        }
+        const std::vector<BoundingBox>& intersections = intersectionsPerView.at(viewCurrent);
+        const std::vector<BoundingBox>& currentBoundingBoxes = boundingBoxesPerView.at(viewCurrent);
 
         if (intersections.empty())
         {
@@ -522,19 +554,7 @@ bool processImage(const PanoramaMap& panoramaMap,
         return false;
     }
 
-    std::string warpedPath;
-
-    if (viewReference == UndefinedIndexT)
-    {
-        warpedPath = "panorama";
-    }
-    else
-    {
-        warpedPath = sfmData.getViews().at(viewReference)->getImage().getMetadata().at("AliceVision:warpedPath");
-    }
-
-    const std::string outputFilePath = (fs::path(outputFolder) / (warpedPath + ".exr")).string();
-    image::Image<image::RGBAfColor>& output = compositer->getOutput();
+    output.swap(compositer->getOutput());
 
     if (storageDataType == image::EStorageDataType::HalfFinite)
     {
@@ -562,13 +582,8 @@ bool processImage(const PanoramaMap& panoramaMap,
         ALICEVISION_LOG_INFO("Draw borders");
         for (IndexT viewCurrent : overlappingViews)
         {
-            // Compute list of intersection between this view and the reference view
-            std::vector<BoundingBox> intersections;
-            std::vector<BoundingBox> currentBoundingBoxes;
-            if (!panoramaMap.getIntersectionsList(intersections, currentBoundingBoxes, referenceBoundingBox, viewCurrent))
-            {
-                continue;
-            }
+            const std::vector<BoundingBox>& intersections = intersectionsPerView.at(viewCurrent);
+            const std::vector<BoundingBox>& currentBoundingBoxes = boundingBoxesPerView.at(viewCurrent);
 
             // Load mask
             const std::string warpedPath = sfmData.getViews().at(viewCurrent)->getImage().getMetadata().at("AliceVision:warpedPath");
@@ -606,7 +621,7 @@ bool processImage(const PanoramaMap& panoramaMap,
           output, referenceLabels, globalUnionBoundingBox.left - referenceBoundingBox.left, globalUnionBoundingBox.top - referenceBoundingBox.top);
     }
 
-    oiio::ParamValueList metadata = srcMetadata;
+    metadata = srcMetadata;
     metadata.remove("orientation", oiio::TypeDesc::UNKNOWN, false);
     metadata.remove("crop", oiio::TypeDesc::UNKNOWN, false);
     metadata.remove("width", oiio::TypeDesc::UNKNOWN, false);
@@ -616,6 +631,55 @@ bool processImage(const PanoramaMap& panoramaMap,
     metadata.push_back(oiio::ParamValue("AliceVision:panoramaWidth", int(panoramaMap.getWidth())));
     metadata.push_back(oiio::ParamValue("AliceVision:panoramaHeight", int(panoramaMap.getHeight())));
 
+    return true;
+}
+
+bool processImage(const PanoramaMap& panoramaMap,
+                  const sfmData::SfMData& sfmData,
+                  const std::string& compositerType,
+                  const std::string& warpingFolder,
+                  const std::string& labelsFilePath,
+                  const std::string& outputFolder,
+                  const image::EStorageDataType& storageDataType,
+                  IndexT viewReference,
+                  const BoundingBox& referenceBoundingBox,
+                  bool showBorders,
+                  bool showSeams,
+                  bool useGpu)
+{
+    image::Image<image::RGBAfColor> output;
+    oiio::ParamValueList metadata;
+    std::string colorSpace;
+    if (!compositeRegion(panoramaMap,
+                         sfmData,
+                         compositerType,
+                         warpingFolder,
+                         labelsFilePath,
+                         storageDataType,
+                         referenceBoundingBox,
+                         showBorders,
+                         showSeams,
+                         useGpu,
+                         output,
+                         metadata,
+                         colorSpace))
+    {
+        return false;
+    }
+
+    std::string warpedPath;
+
+    if (viewReference == UndefinedIndexT)
+    {
+        warpedPath = "panorama";
+    }
+    else
+    {
+        warpedPath = sfmData.getViews().at(viewReference)->getImage().getMetadata().at("AliceVision:warpedPath");
+    }
+
+    const std::string outputFilePath = (fs::path(outputFolder) / (warpedPath + ".exr")).string();
+
     image::writeImage(outputFilePath,
                       output,
                       image::ImageWriteOptions()
@@ -627,6 +691,114 @@ bool processImage(const PanoramaMap& panoramaMap,
     return true;
 }
 
+/**
+ * @brief Composite the whole panorama by horizontal bands and write each band in a tiled EXR file as soon as it is done.
+ * Only one band (and the borders required by its pyramid) is kept in memory.
+ * @param[in] bandHeight The height of the bands, rounded up to a multiple of the tile size
+ * @return false if an error occurred
+ */
+bool processBands(const PanoramaMap& panoramaMap,
+                  const sfmData::SfMData& sfmData,
+                  const std::string& compositerType,
+                  const std::string& warpingFolder,
+                  const std::string& labelsFilePath,
+                  const std::string& outputFolder,
+                  const image::EStorageDataType& storageDataType,
+                  int bandHeight,
+                  bool showBorders,
+                  bool showSeams,
+                  bool useGpu)
+{
+    const int tileSize = 256;
+    const int panoramaWidth = panoramaMap.getWidth();
+    const int panoramaHeight = panoramaMap.getHeight();
+    const int alignedBandHeight = divideRoundUp(bandHeight, tileSize) * tileSize;
+    const int countBands = divideRoundUp(panoramaHeight, alignedBandHeight);
+
+    const std::string outputFilePath = (fs::path(outputFolder) / "panorama.exr").string();
+    const std::string tmpPath = (fs::path(outputFolder) / ("panorama." + utils::generateUniqueFilename() + ".exr")).string();
+
+    std::unique_ptr<oiio::ImageOutput> out = oiio::ImageOutput::create(tmpPath);
+    if (!out)
+    {
+        ALICEVISION_LOG_ERROR("Can't create the output image file '" << outputFilePath << "'.");
+        return false;
+    }
+
+    for (int band = 0; band < countBands; band++)
+    {
+        ALICEVISION_LOG_INFO("processing band " << band + 1 << "/" << countBands);
+
+        BoundingBox bandBoundingBox;
+        bandBoundingBox.left = 0;
+        bandBoundingBox.top = band * alignedBandHeight;
+        bandBoundingBox.width = panoramaWidth;
+        bandBoundingBox.height = std::min(alignedBandHeight, panoramaHeight - bandBoundingBox.top);
+
+        image::Image<image::RGBAfColor> output;
+        oiio::ParamValueList metadata;
+        std::string colorSpace;
+        if (!compositeRegion(panoramaMap,
+                             sfmData,
+                             compositerType,
+                             warpingFolder,
+                             labelsFilePath,
+                             storageDataType,
+                             bandBoundingBox,
+                             showBorders,
+                             showSeams,
+                             useGpu,
+                             output,
+                             metadata,
+                             colorSpace))
+        {
+            return false;
+        }
+
+        if (band == 0)
+        {
+            // the whole panorama can't be checked for half overflows, so the automatic storage uses floats
+            const bool useHalf = (storageDataType == image::EStorageDataType::Half || storageDataType == image::EStorageDataType::HalfFinite);
+
+            oiio::ImageSpec spec(panoramaWidth, panoramaHeight, 4, useHalf ? oiio::TypeDesc::HALF : oiio::TypeDesc::FLOAT);
+            spec.tile_width = tileSize;
+            spec.tile_height = tileSize;
+            spec.extra_attribs = metadata;
+            spec.attribute("compression", "zips");
+            spec.attribute("AliceVision:offsetX", 0);
+            spec.attribute("AliceVision:offsetY", 0);
+            spec.attribute("AliceVision:ColorSpace", colorSpace);
+            spec.attribute("AliceVision:storageDataType", image::EStorageDataType_enumToString(storageDataType));
+
+            if (!out->open(tmpPath, spec))
+            {
+                ALICEVISION_LOG_ERROR("Can't open the output image file '" << outputFilePath << "'.");
+                return false;
+            }
+        }
+
+        if (!out->write_tiles(0,
+                              panoramaWidth,
+                              bandBoundingBox.top,
+                              bandBoundingBox.top + bandBoundingBox.height,
+                              0,
+                              1,
+                              oiio::TypeDesc::FLOAT,
+                              output.data()))
+        {
+            ALICEVISION_LOG_ERROR("Can't write the band " << band << " in the output image file '" << outputFilePath << "'.");
+            return false;
+        }
+    }
+
+    out->close();
+
+    // rename temporary filename
+    fs::rename(tmpPath, outputFilePath);
+
+    return true;
+}
+
 int aliceVision_main(int argc, char** argv)
 {
     std::string sfmDataFilepath;
@@ -642,6 +814,8 @@ int aliceVision_main(int argc, char** argv)
     bool showBorders = false;
     bool showSeams = false;
     bool useTiling = true;
+    int bandHeight = 0;
+    bool useGpu = false;
 
     image::EStorageDataType storageDataType = image::EStorageDataType::Float;
 
@@ -676,7 +850,12 @@ int aliceVision_main(int argc, char** argv)
         ("labels,l", po::value<std::string>(&labelsFilepath)->required(),
          "Labels image from seams estimation.")
         ("useTiling,n", po::value<bool>(&useTiling)->default_value(useTiling),
-         "Use tiling for compositing.");
+         "Use tiling for compositing.")
+        ("bandHeight", po::value<int>(&bandHeight)->default_value(bandHeight),
+         "Without tiling, composite the panorama by horizontal bands of this height (rounded up to a multiple of 256 pixels) "
+         "written directly to the output file, to bound the memory. 0 composites the whole panorama at once.")
+        ("useGpu", po::value<bool>(&useGpu)->default_value(useGpu),
+         "Build the laplacian pyramids of the multiband compositing on the GPU (if available).");
     // clang-format on
 
     CmdLine cmdline("Performs the panorama stiching of warped images, with an option to use constraints from precomputed seams maps.\n"
@@ -706,6 +885,20 @@ int aliceVision_main(int argc, char** argv)
         showSeams = true;
     }
 
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
+    if (useGpu && !gpu::gpuSupportCUDA(3, 0))
+    {
+        ALICEVISION_LOG_WARNING("No compatible CUDA device found, the laplacian pyramids will be built on the CPU.");
+        useGpu = false;
+    }
+#else
+    if (useGpu)
+    {
+        ALICEVISION_LOG_WARNING("GPU compositing requires a build with CUDA, the laplacian pyramids will be built on the CPU.");
+        useGpu = false;
+    }
+#endif
+
     if (forceMinPyramidLevels > 16)
     {
         ALICEVISION_LOG_ERROR("forceMinPyramidLevels parameter has a value which is too large.");
@@ -837,13 +1030,31 @@ int aliceVision_main(int argc, char** argv)
                               viewReference,
                               referenceBoundingBox,
                               showBorders,
-                              showSeams))
+                              showSeams,
+                              useGpu))
             {
                 succeeded = false;
                 continue;
             }
         }
     }
+    else if (bandHeight > 0)
+    {
+        if (!processBands(*panoramaMap,
+                          sfmData,
+                          compositerType,
+                          warpingFolder,
+                          labelsFilepath,
+                          outputFolder,
+                          storageDataType,
+                          bandHeight,
+                          showBorders,
+                          showSeams,
+                          useGpu))
+        {
+            succeeded = false;
+        }
+    }
     else
     {
         BoundingBox referenceBoundingBox;
@@ -862,7 +1073,8 @@ int aliceVision_main(int argc, char** argv)
                           UndefinedIndexT,
                           referenceBoundingBox,
                           showBorders,
-                          showSeams))
+                          showSeams,
+                          useGpu))
         {
             succeeded = false;
         }
@@ -30,7 +30,7 @@
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 1
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 1
 
 using namespace aliceVision;
 
@@ -103,6 +103,12 @@ int aliceVision_main(int argc, char** argv)
          "Add an intermediate refine with rotation+focal in the different BA steps.")
         ("intermediateRefineWithFocalDist", po::value<bool>(&params.intermediateRefineWithFocalDist)->default_value(params.intermediateRefineWithFocalDist),
          "Add an intermediate refine with rotation+focal+distortion in the different BA steps.")
+        ("useRotationBundle", po::value<bool>(&params.useRotationBundle)->default_value(params.useRotationBundle),
+         "Refine the rotations alone (first and last BA steps) with a dedicated sparse solver instead of Ceres, "
+         "faster on large panoramas.")
+        ("nbPriorNeighbors", po::value<std::size_t>(&params.nbPriorNeighbors)->default_value(params.nbPriorNeighbors),
+         "Number of nearest views (by prior orientation) linked by a rotation prior, 0 to link all the views. "
+         "For large captures from a motorized head, only link the neighbors in the capture grid (e.g. 8).")
         ("outputViewsAndPoses", po::value<std::string>(&outputViewsAndPosesFilepath),
          "Path of the output SfMData file.")
         ("randomSeed", po::value<int>(&randomSeed)->default_value(randomSeed),
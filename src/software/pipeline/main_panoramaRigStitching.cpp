@@ -0,0 +1,418 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+// Input and geometry
+#include <aliceVision/sfmData/SfMData.hpp>
+#include <aliceVision/sfmDataIO/sfmDataIO.hpp>
+
+// Image stuff
+#include <aliceVision/image/all.hpp>
+
+// Logging stuff
+#include <aliceVision/system/Logger.hpp>
+#include <aliceVision/system/Timer.hpp>
+
+// Reading command line options
+#include <boost/program_options.hpp>
+#include <aliceVision/cmdline/cmdline.hpp>
+#include <aliceVision/system/main.hpp>
+
+#include <aliceVision/panorama/rigStitcher.hpp>
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+// These constants define the current software version.
+// They must be updated when the command line is changed.
+#define ALICEVISION_SOFTWARE_VERSION_MAJOR 1
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+
+using namespace aliceVision;
+
+namespace po = boost::program_options;
+namespace fs = std::filesystem;
+
+namespace {
+
+/**
+ * @brief A synchronized frame of the rig.
+ */
+struct RigFrame
+{
+    IndexT frameId = UndefinedIndexT;
+    /// the images of the frame per rig sub-pose
+    std::map<IndexT, image::Image<image::RGBfColor>> sources;
+    /// the stitched panorama
+    image::Image<image::RGBAfColor> panorama;
+};
+
+/**
+ * @brief Blocking FIFO queue with a maximum size connecting two stages of the pipeline.
+ */
+class FrameQueue
+{
+  public:
+    explicit FrameQueue(std::size_t maxSize)
+      : _maxSize(std::max<std::size_t>(maxSize, 1))
+    {}
+
+    /**
+     * @brief Append a frame, wait while the queue is full.
+     * @return false if the queue has been aborted
+     */
+    bool push(std::unique_ptr<RigFrame> frame)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _notFull.wait(lock, [&] { return _aborted || _frames.size() < _maxSize; });
+        if (_aborted)
+            return false;
+        _frames.push_back(std::move(frame));
+        _notEmpty.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief Remove the first frame, wait while the queue is empty.
+     * @return nullptr at the end of the stream or if the queue has been aborted
+     */
+    std::unique_ptr<RigFrame> pop()
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _notEmpty.wait(lock, [&] { return _aborted || _closed || !_frames.empty(); });
+        if (_aborted || _frames.empty())
+            return nullptr;
+        std::unique_ptr<RigFrame> frame = std::move(_frames.front());
+        _frames.pop_front();
+        _notFull.notify_one();
+        return frame;
+    }
+
+    /// End of the stream: the remaining frames can still be popped.
+    void close()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _closed = true;
+        _notEmpty.notify_all();
+    }
+
+    /// Stop the pipeline: the remaining frames are dropped and the waiting stages are released.
+    void abort()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _aborted = true;
+        _frames.clear();
+        _notEmpty.notify_all();
+        _notFull.notify_all();
+    }
+
+  private:
+    std::size_t _maxSize;
+    std::deque<std::unique_ptr<RigFrame>> _frames;
+    bool _closed = false;
+    bool _aborted = false;
+    std::mutex _mutex;
+    std::condition_variable _notEmpty;
+    std::condition_variable _notFull;
+};
+
+}  // namespace
+
+int aliceVision_main(int argc, char** argv)
+{
+    std::string sfmDataFilepath;
+    std::string outputFolder;
+
+    int panoramaWidth = 4096;
+    int blendWidth = 16;
+    bool useGraphCut = false;
+    int graphCutLevels = 3;
+    int graphCutRefinementBand = 0;
+    int seamsUpdateInterval = 0;
+    float seamsTemporalSmoothing = 0.9f;
+    int queueSize = 2;
+    std::string outputExtension = "exr";
+
+    image::EStorageDataType storageDataType = image::EStorageDataType::Float;
+    image::EImageColorSpace workingColorSpace = image::EImageColorSpace::LINEAR;
+    image::EImageColorSpace outputColorSpace = image::EImageColorSpace::LINEAR;
+
+    int rangeStart = -1;
+    int rangeSize = 1;
+
+    // Description of mandatory parameters
+    // clang-format off
+    po::options_description requiredParams("Required parameters");
+    requiredParams.add_options()
+        ("input,i", po::value<std::string>(&sfmDataFilepath)->required(),
+         "SfMData file with a calibrated rig.")
+        ("output,o", po::value<std::string>(&outputFolder)->required(),
+         "Path of the output folder.");
+
+    // Description of optional parameters
+    po::options_description optionalParams("Optional parameters");
+    optionalParams.add_options()
+        ("panoramaWidth,w", po::value<int>(&panoramaWidth)->default_value(panoramaWidth),
+         "Panorama width in pixels.")
+        ("blendWidth", po::value<int>(&blendWidth)->default_value(blendWidth),
+         "Half width in pixels of the transition across the seams (0 for hard seams).")
+        ("useGraphCut", po::value<bool>(&useGraphCut)->default_value(useGraphCut),
+         "Refine the seams with a graphcut on the content of the frames.")
+        ("graphCutLevels", po::value<int>(&graphCutLevels)->default_value(graphCutLevels),
+         "Number of levels of the hierarchical graphcut.")
+        ("graphCutRefinementBand", po::value<int>(&graphCutRefinementBand)->default_value(graphCutRefinementBand),
+         "Half width in pixels of the band in which the finer graphcut levels refine the seams (0 for no restriction).")
+        ("seamsUpdateInterval", po::value<int>(&seamsUpdateInterval)->default_value(seamsUpdateInterval),
+         "Number of frames between two graphcut refinements of the seams (0 to refine them only on the first frame).")
+        ("seamsTemporalSmoothing", po::value<float>(&seamsTemporalSmoothing)->default_value(seamsTemporalSmoothing),
+         "Weight in [0, 1) of the previous frame blending when the seams change (0 to switch directly to the new seams).")
+        ("queueSize", po::value<int>(&queueSize)->default_value(queueSize),
+         "Maximum number of frames waiting between the decoding, the stitching and the encoding.")
+        ("outputExtension", po::value<std::string>(&outputExtension)->default_value(outputExtension),
+         "File extension of the output panoramas.")
+        ("workingColorSpace", po::value<image::EImageColorSpace>(&workingColorSpace)->default_value(workingColorSpace),
+         ("Working color space: " + image::EImageColorSpace_informations()).c_str())
+        ("outputColorSpace", po::value<image::EImageColorSpace>(&outputColorSpace)->default_value(outputColorSpace),
+         ("Output color space: " + image::EImageColorSpace_informations()).c_str())
+        ("storageDataType", po::value<image::EStorageDataType>(&storageDataType)->default_value(storageDataType),
+         ("Storage data type: " + image::EStorageDataType_informations()).c_str())
+        ("rangeStart", po::value<int>(&rangeStart)->default_value(rangeStart),
+         "Range frame index start.")
+        ("rangeSize", po::value<int>(&rangeSize)->default_value(rangeSize),
+         "Range size.");
+    // clang-format on
+
+    CmdLine cmdline("Stitches the synchronized frames of a calibrated rig, reusing the warping maps and the seams between the frames.\n"
+                    "AliceVision panoramaRigStitching");
+
+    cmdline.add(requiredParams);
+    cmdline.add(optionalParams);
+    if (!cmdline.execute(argc, argv))
+    {
+        return EXIT_FAILURE;
+    }
+
+    // set maxThreads
+    HardwareContext hwc = cmdline.getHardwareContext();
+    omp_set_num_threads(hwc.getMaxThreads());
+
+    sfmData::SfMData sfmData;
+    if (!sfmDataIO::load(sfmData, sfmDataFilepath, sfmDataIO::ESfMData(sfmDataIO::VIEWS | sfmDataIO::INTRINSICS | sfmDataIO::EXTRINSICS)))
+    {
+        ALICEVISION_LOG_ERROR("The input SfMData file '" << sfmDataFilepath << "' cannot be read.");
+        return EXIT_FAILURE;
+    }
+
+    // Group the views of the rig by frame
+    IndexT rigId = UndefinedIndexT;
+    std::map<IndexT, std::map<IndexT, std::shared_ptr<sfmData::View>>> frames;
+    for (const auto& viewIt : sfmData.getViews())
+    {
+        const std::shared_ptr<sfmData::View>& view = viewIt.second;
+        if (!view->isPartOfRig() || !sfmData.isPoseAndIntrinsicDefined(view.get()))
+        {
+            continue;
+        }
+
+        if (rigId == UndefinedIndexT)
+        {
+            rigId = view->getRigId();
+        }
+        else if (view->getRigId() != rigId)
+        {
+            ALICEVISION_LOG_WARNING("Ignore the view " << view->getViewId() << " of the rig " << view->getRigId()
+                                                       << ", only the rig " << rigId << " is stitched.");
+            continue;
+        }
+
+        frames[view->getFrameId()][view->getSubPoseId()] = view;
+    }
+
+    if (frames.empty())
+    {
+        ALICEVISION_LOG_ERROR("No calibrated rig view in the input SfMData.");
+        return EXIT_FAILURE;
+    }
+
+    std::vector<IndexT> frameIds;
+    for (const auto& frameIt : frames)
+    {
+        frameIds.push_back(frameIt.first);
+    }
+
+    // Define range to compute
+    if (rangeStart != -1)
+    {
+        if (rangeStart < 0 || rangeSize < 0 || std::size_t(rangeStart) > frameIds.size())
+        {
+            ALICEVISION_LOG_ERROR("Range is incorrect");
+            return EXIT_FAILURE;
+        }
+
+        if (std::size_t(rangeStart + rangeSize) > frameIds.size())
+        {
+            rangeSize = int(frameIds.size()) - rangeStart;
+        }
+    }
+    else
+    {
+        rangeStart = 0;
+        rangeSize = int(frameIds.size());
+    }
+    ALICEVISION_LOG_DEBUG("Range to compute: rangeStart=" << rangeStart << ", rangeSize=" << rangeSize);
+
+    // The rig is fixed: the geometry of each camera is taken from the first frame where it is calibrated
+    const int panoramaHeight = panoramaWidth / 2;
+    RigStitcher stitcher(panoramaWidth, panoramaHeight, blendWidth);
+
+    std::map<IndexT, std::shared_ptr<sfmData::View>> referenceViews;
+    for (const auto& frameIt : frames)
+    {
+        for (const auto& cameraIt : frameIt.second)
+        {
+            referenceViews.emplace(cameraIt.first, cameraIt.second);
+        }
+    }
+
+    for (const auto& cameraIt : referenceViews)
+    {
+        const sfmData::View& view = *cameraIt.second;
+        const geometry::Pose3 camPose = sfmData.getPose(view).getTransform();
+        const camera::IntrinsicBase& intrinsic = *sfmData.getIntrinsicSharedPtr(view.getIntrinsicId());
+
+        if (!stitcher.addCamera(cameraIt.first, camPose, intrinsic))
+        {
+            ALICEVISION_LOG_WARNING("The rig camera " << cameraIt.first << " is not visible in the panorama.");
+        }
+    }
+
+    if (!stitcher.computeSeams())
+    {
+        ALICEVISION_LOG_ERROR("Failed to compute the seams of the rig.");
+        return EXIT_FAILURE;
+    }
+
+    ALICEVISION_LOG_INFO("Warping maps and seams of the " << referenceViews.size() << " rig cameras computed.");
+
+    FrameQueue decodedFrames(queueSize);
+    FrameQueue stitchedFrames(queueSize);
+    std::exception_ptr decodeError;
+    std::exception_ptr encodeError;
+
+    // decode stage
+    std::thread decodeThread([&] {
+        try
+        {
+            for (int i = rangeStart; i < rangeStart + rangeSize; ++i)
+            {
+                auto frame = std::make_unique<RigFrame>();
+                frame->frameId = frameIds[i];
+                for (const auto& cameraIt : frames.at(frame->frameId))
+                {
+                    image::readImage(cameraIt.second->getImage().getImagePath(), frame->sources[cameraIt.first], workingColorSpace);
+                }
+                if (!decodedFrames.push(std::move(frame)))
+                    break;
+            }
+        }
+        catch (...)
+        {
+            decodeError = std::current_exception();
+        }
+        decodedFrames.close();
+    });
+
+    // encode stage
+    std::thread encodeThread([&] {
+        try
+        {
+            while (std::unique_ptr<RigFrame> frame = stitchedFrames.pop())
+            {
+                const std::string outputFilePath = (fs::path(outputFolder) / (std::to_string(frame->frameId) + "." + outputExtension)).string();
+                image::writeImage(outputFilePath,
+                                  frame->panorama,
+                                  image::ImageWriteOptions().fromColorSpace(workingColorSpace).toColorSpace(outputColorSpace).storageDataType(storageDataType));
+            }
+        }
+        catch (...)
+        {
+            encodeError = std::current_exception();
+            stitchedFrames.abort();
+        }
+    });
+
+    // stitching stage, multithreaded on the caller thread
+    system::Timer timer;
+    int countFrames = 0;
+    bool success = true;
+    try
+    {
+        while (std::unique_ptr<RigFrame> frame = decodedFrames.pop())
+        {
+            if (useGraphCut && (countFrames == 0 || (seamsUpdateInterval > 0 && countFrames % seamsUpdateInterval == 0)))
+            {
+                if (!stitcher.refineSeams(frame->sources, graphCutLevels, graphCutRefinementBand))
+                {
+                    ALICEVISION_LOG_WARNING("Failed to refine the seams on the frame " << frame->frameId << ".");
+                }
+            }
+
+            // The first frame switches directly to its seams
+            stitcher.advanceSeams((countFrames == 0) ? 0.0f : seamsTemporalSmoothing);
+
+            if (!stitcher.stitch(frame->panorama, frame->sources))
+            {
+                ALICEVISION_LOG_ERROR("Failed to stitch the frame " << frame->frameId << ".");
+                success = false;
+                break;
+            }
+            frame->sources.clear();
+
+            if (!stitchedFrames.push(std::move(frame)))
+            {
+                success = false;
+                break;
+            }
+
+            ++countFrames;
+            ALICEVISION_LOG_INFO("[" << countFrames << "/" << rangeSize << "] frames stitched (" << countFrames / timer.elapsed() << " fps).");
+        }
+    }
+    catch (...)
+    {
+        decodedFrames.abort();
+        stitchedFrames.abort();
+        decodeThread.join();
+        encodeThread.join();
+        throw;
+    }
+
+    if (!success)
+    {
+        decodedFrames.abort();
+    }
+    stitchedFrames.close();
+
+    decodeThread.join();
+    encodeThread.join();
+
+    if (decodeError)
+    {
+        std::rethrow_exception(decodeError);
+    }
+    if (encodeError)
+    {
+        std::rethrow_exception(encodeError);
+    }
+
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
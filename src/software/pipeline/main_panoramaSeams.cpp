@@ -34,7 +34,7 @@
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 1
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 1
 
 using namespace aliceVision;
 
@@ -98,7 +98,8 @@ bool computeGCLabels(image::Image<IndexT>& labels,
                      const std::string& inputPath,
                      std::pair<int, int>& panoramaSize,
                      int smallestViewScale,
-                     int downscale)
+                     int downscale,
+                     int refinementBand)
 {
     ALICEVISION_LOG_INFO("Estimating smart seams for panorama");
 
@@ -106,6 +107,7 @@ bool computeGCLabels(image::Image<IndexT>& labels,
     ALICEVISION_LOG_INFO("Graphcut pyramid size is " << pyramidSize);
 
     HierarchicalGraphcutSeams seams(panoramaSize.first / downscale, panoramaSize.second / downscale, pyramidSize);
+    seams.setRefinementBand(refinementBand);
 
     if (!seams.initialize(labels))
     {
@@ -189,6 +191,7 @@ int aliceVision_main(int argc, char** argv)
 
     int maxPanoramaWidth = 3000;
     bool useGraphCut = true;
+    int graphCutRefinementBand = 0;
     image::EStorageDataType storageDataType = image::EStorageDataType::Float;
 
     // Description of mandatory parameters
@@ -210,7 +213,10 @@ int aliceVision_main(int argc, char** argv)
         ("maxWidth", po::value<int>(&maxPanoramaWidth)->required(),
          "Maximum panorama width.")
         ("useGraphCut,g", po::value<bool>(&useGraphCut)->default_value(useGraphCut),
-         "Enable graphcut algorithm to improve seams.");
+         "Enable graphcut algorithm to improve seams.")
+        ("graphCutRefinementBand", po::value<int>(&graphCutRefinementBand)->default_value(graphCutRefinementBand),
+         "Coarse-to-fine graphcut: half width in pixels of the band around the seams refined at each finer level. "
+         "0 lets the seams move up to 20% of the level size.");
     // clang-format on
 
     CmdLine cmdline("Estimates the ideal path for the transition between images in order to minimize seams artifacts.\n"
@@ -361,7 +367,7 @@ int aliceVision_main(int argc, char** argv)
 
     if (useGraphCut)
     {
-        if (!computeGCLabels(labels, views, warpingFolder, panoramaSize, smallestScale, downscaleFactor))
+        if (!computeGCLabels(labels, views, warpingFolder, panoramaSize, smallestScale, downscaleFactor, graphCutRefinementBand))
         {
             ALICEVISION_LOG_ERROR("Error computing graph cut labels");
             return EXIT_FAILURE;
@@ -21,13 +21,23 @@
 #include <aliceVision/panorama/remapBbox.hpp>
 #include <aliceVision/panorama/warper.hpp>
 #include <aliceVision/panorama/distance.hpp>
+#include <aliceVision/panorama/warpMapCache.hpp>
+#include <aliceVision/panorama/panoramaMap.hpp>
 
+#include <aliceVision/config.hpp>
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
+    #include <aliceVision/gpu/gpu.hpp>
+    #include <aliceVision/panorama/cuda/DeviceGaussianWarper.hpp>
+#endif
+
+#include <cstring>
 #include <filesystem>
+#include <functional>
 
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 1
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 1
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 3
 
 using namespace aliceVision;
 
@@ -94,6 +104,309 @@ bool computeOptimalPanoramaSize(std::pair<int, int>& optimalSize, const sfmData:
     return true;
 }
 
+/**
+ * @brief Compute the bounding box in the panorama of the pixels of a view visible in a coarse bounding box.
+ */
+BoundingBox computeGlobalBoundingBox(const BoundingBox& coarseBbox,
+                                     const std::pair<int, int>& panoramaSize,
+                                     const geometry::Pose3& camPose,
+                                     const camera::IntrinsicBase& intrinsic,
+                                     int tileSize)
+{
+    // round to the closest tiles
+    BoundingBox snappedCoarseBbox;
+    snappedCoarseBbox = coarseBbox;
+    snappedCoarseBbox.snapToGrid(tileSize);
+
+    // Initialize bouding box for image
+    BoundingBox globalBbox;
+
+    {
+        // Search for first non empty box starting from the top
+        bool found = false;
+
+        for (int y = 0; y < snappedCoarseBbox.height; y += tileSize)
+        {
+#pragma omp parallel for
+            for (int x = 0; x < snappedCoarseBbox.width; x += tileSize)
+            {
+                if (found)
+                {
+                    continue;
+                }
+
+                BoundingBox localBbox;
+                localBbox.left = x + snappedCoarseBbox.left;
+                localBbox.top = y + snappedCoarseBbox.top;
+                localBbox.width = tileSize;
+                localBbox.height = tileSize;
+
+                localBbox.clampRight(snappedCoarseBbox.getRight());
+                localBbox.clampBottom(snappedCoarseBbox.getBottom());
+
+                // Prepare coordinates map
+                CoordinatesMap map;
+                if (!map.build(panoramaSize, camPose, intrinsic, localBbox))
+                {
+                    continue;
+                }
+
+#pragma omp critical
+                {
+                    if (!map.getBoundingBox().isEmpty())
+                    {
+                        globalBbox = globalBbox.unionWith(map.getBoundingBox());
+                        found = true;
+                    }
+                }
+            }
+
+            if (found)
+            {
+                break;
+            }
+        }
+    }
+
+    {
+        // Search for first non empty box starting from the bottom
+        bool found = false;
+        for (int y = snappedCoarseBbox.height - 1; y >= 0; y -= tileSize)
+        {
+#pragma omp parallel for
+            for (int x = 0; x < snappedCoarseBbox.width; x += tileSize)
+            {
+                if (found)
+                {
+                    continue;
+                }
+
+                BoundingBox localBbox;
+                localBbox.left = x + snappedCoarseBbox.left;
+                localBbox.top = y + snappedCoarseBbox.top;
+                localBbox.width = tileSize;
+                localBbox.height = tileSize;
+
+                localBbox.clampRight(snappedCoarseBbox.getRight());
+                localBbox.clampBottom(snappedCoarseBbox.getBottom());
+
+                // Prepare coordinates map
+                CoordinatesMap map;
+                if (!map.build(panoramaSize, camPose, intrinsic, localBbox))
+                {
+                    continue;
+                }
+
+#pragma omp critical
+                {
+                    if (!map.getBoundingBox().isEmpty())
+                    {
+                        globalBbox = globalBbox.unionWith(map.getBoundingBox());
+                        found = true;
+                    }
+                }
+            }
+
+            if (found)
+            {
+                break;
+            }
+        }
+    }
+
+    {
+        // Search for first non empty box starting from the left
+        bool found = false;
+        for (int x = 0; x < snappedCoarseBbox.width; x += tileSize)
+        {
+#pragma omp parallel for
+            for (int y = 0; y < snappedCoarseBbox.height; y += tileSize)
+            {
+                if (found)
+                {
+                    continue;
+                }
+
+                BoundingBox localBbox;
+                localBbox.left = x + snappedCoarseBbox.left;
+                localBbox.top = y + snappedCoarseBbox.top;
+                localBbox.width = tileSize;
+                localBbox.height = tileSize;
+
+                localBbox.clampRight(snappedCoarseBbox.getRight());
+                localBbox.clampBottom(snappedCoarseBbox.getBottom());
+
+                // Prepare coordinates map
+                CoordinatesMap map;
+                if (!map.build(panoramaSize, camPose, intrinsic, localBbox))
+                {
+                    continue;
+                }
+
+#pragma omp critical
+                {
+                    if (!map.getBoundingBox().isEmpty())
+                    {
+                        globalBbox = globalBbox.unionWith(map.getBoundingBox());
+                        found = true;
+                    }
+                }
+            }
+
+            if (found)
+            {
+                break;
+            }
+        }
+    }
+
+    {
+        // Search for first non empty box starting from the left
+        bool found = false;
+        for (int x = snappedCoarseBbox.width - 1; x >= 0; x -= tileSize)
+        {
+#pragma omp parallel for
+            for (int y = 0; y < snappedCoarseBbox.height; y += tileSize)
+            {
+                if (found)
+                {
+                    continue;
+                }
+
+                BoundingBox localBbox;
+                localBbox.left = x + snappedCoarseBbox.left;
+                localBbox.top = y + snappedCoarseBbox.top;
+                localBbox.width = tileSize;
+                localBbox.height = tileSize;
+
+                localBbox.clampRight(snappedCoarseBbox.getRight());
+                localBbox.clampBottom(snappedCoarseBbox.getBottom());
+
+                // Prepare coordinates map
+                CoordinatesMap map;
+                if (!map.build(panoramaSize, camPose, intrinsic, localBbox))
+                {
+                    continue;
+                }
+
+#pragma omp critical
+                {
+                    if (!map.getBoundingBox().isEmpty())
+                    {
+                        globalBbox = globalBbox.unionWith(map.getBoundingBox());
+                        found = true;
+                    }
+                }
+            }
+
+            if (found)
+            {
+                break;
+            }
+        }
+    }
+
+    // Rare case ... When all boxes valid are after the loop
+    if (globalBbox.left >= panoramaSize.first)
+    {
+        globalBbox.left -= panoramaSize.first;
+    }
+
+    globalBbox.width = std::min(globalBbox.width, panoramaSize.first);
+    globalBbox.height = std::min(globalBbox.height, panoramaSize.second);
+
+    return globalBbox;
+}
+
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
+/**
+ * @brief Warp the tiles of a source image on the GPU, by batches of tiles.
+ * The coordinates maps are built on the CPU, the pyramid sampling and the weights are computed on the device.
+ * @param[in] buildMap The function building (or reading from the cache) the coordinates map of a tile
+ */
+void warpTilesOnGpu(panorama::cuda::DeviceGaussianWarper& deviceWarper,
+                    const GaussianPyramidNoMask& pyramid,
+                    const std::vector<BoundingBox>& boxes,
+                    const BoundingBox& globalBbox,
+                    const std::function<bool(CoordinatesMap&, const BoundingBox&)>& buildMap,
+                    const camera::IntrinsicBase& intrinsic,
+                    int tileSize,
+                    bool clampHalf,
+                    oiio::ImageOutput& outView,
+                    oiio::ImageOutput& outMask,
+                    oiio::ImageOutput& outWeights)
+{
+    // Maximal number of pixels sent to the device at once
+    const std::size_t maxBatchPixels = 8 * 1024 * 1024;
+
+    std::vector<const float*> levels;
+    std::vector<int> widths;
+    std::vector<int> heights;
+    for (const image::Image<image::RGBfColor>& level : pyramid.getPyramidColor())
+    {
+        levels.push_back(reinterpret_cast<const float*>(level.data()));
+        widths.push_back(level.width());
+        heights.push_back(level.height());
+    }
+    deviceWarper.setPyramid(levels, widths, heights);
+
+    const std::size_t tilePixels = std::size_t(tileSize) * tileSize;
+    const int batchSize = std::max<int>(1, maxBatchPixels / tilePixels);
+
+    std::vector<float> coordinates;
+    std::vector<unsigned char> masks;
+    std::vector<float> colors;
+    std::vector<float> weights;
+    std::vector<char> validTiles;
+
+    for (int batchStart = 0; batchStart < boxes.size(); batchStart += batchSize)
+    {
+        const int batchCount = std::min<int>(batchSize, boxes.size() - batchStart);
+
+        coordinates.resize(batchCount * tilePixels * 2);
+        masks.assign(batchCount * tilePixels, 0);
+        colors.resize(batchCount * tilePixels * 3);
+        weights.resize(batchCount * tilePixels);
+        validTiles.assign(batchCount, 0);
+
+        // Prepare coordinates maps
+#pragma omp parallel for
+        for (int k = 0; k < batchCount; k++)
+        {
+            CoordinatesMap map;
+            if (!buildMap(map, boxes[batchStart + k]))
+            {
+                continue;
+            }
+
+            std::memcpy(coordinates.data() + k * tilePixels * 2, map.getCoordinates().data(), tilePixels * sizeof(Eigen::Vector2f));
+            std::memcpy(masks.data() + k * tilePixels, map.getMask().data(), tilePixels * sizeof(unsigned char));
+            validTiles[k] = 1;
+        }
+
+        // Warp images
+        deviceWarper.warp(
+          coordinates.data(), masks.data(), batchCount, tileSize, tileSize, clampHalf, intrinsic.w(), intrinsic.h(), colors.data(), weights.data());
+
+        // Store
+        for (int k = 0; k < batchCount; k++)
+        {
+            if (!validTiles[k])
+            {
+                continue;
+            }
+
+            const int x = boxes[batchStart + k].left - globalBbox.left;
+            const int y = boxes[batchStart + k].top - globalBbox.top;
+
+            outView.write_tile(x, y, 0, oiio::TypeDesc::FLOAT, colors.data() + k * tilePixels * 3);
+            outMask.write_tile(x, y, 0, oiio::TypeDesc::UCHAR, masks.data() + k * tilePixels);
+            outWeights.write_tile(x, y, 0, oiio::TypeDesc::FLOAT, weights.data() + k * tilePixels);
+        }
+    }
+}
+#endif
+
 int aliceVision_main(int argc, char** argv)
 {
     std::string sfmDataFilename;
@@ -109,6 +422,9 @@ int aliceVision_main(int argc, char** argv)
     int rangeStart = -1;
     int rangeSize = 1;
 
+    bool useGpu = false;
+    std::string warpCacheFolder;
+
     // Program description
     // Description of mandatory parameters
     // clang-format off
@@ -135,7 +451,11 @@ int aliceVision_main(int argc, char** argv)
         ("rangeStart", po::value<int>(&rangeStart)->default_value(rangeStart),
          "Range image index start.")
         ("rangeSize", po::value<int>(&rangeSize)->default_value(rangeSize),
-         "Range size.");
+         "Range size.")
+        ("useGpu", po::value<bool>(&useGpu)->default_value(useGpu),
+         "Warp the images on the GPU (requires a build with CUDA).")
+        ("warpCacheFolder", po::value<std::string>(&warpCacheFolder)->default_value(warpCacheFolder),
+         "Folder where the coordinates maps are cached and reused between runs (disabled if empty).");
     // clang-format on
 
     CmdLine cmdline("Warps the input images in the panorama coordinate system.\n"
@@ -163,6 +483,21 @@ int aliceVision_main(int argc, char** argv)
         }
     }
 
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
+    if (useGpu && !gpu::gpuSupportCUDA(3, 0))
+    {
+        ALICEVISION_LOG_WARNING("No compatible CUDA device found, the images will be warped on the CPU.");
+        useGpu = false;
+    }
+    panorama::cuda::DeviceGaussianWarper deviceWarper;
+#else
+    if (useGpu)
+    {
+        ALICEVISION_LOG_WARNING("GPU warping requires a build with CUDA, the images will be warped on the CPU.");
+        useGpu = false;
+    }
+#endif
+
     // Load information about inputs
     // Camera images
     // Camera intrinsics
@@ -237,12 +572,31 @@ int aliceVision_main(int argc, char** argv)
     panoramaSize.second = panoramaSize.first / 2;
     ALICEVISION_LOG_INFO("Choosen panorama size : " << panoramaSize.first << "x" << panoramaSize.second);
 
+    // The tiles weights all have the same size: reuse their buffers
+    image::ImagePool<float> weightsPool;
+
+    // Persistent cache of the coordinates maps
+    std::unique_ptr<WarpMapCache> warpCache;
+    if (!warpCacheFolder.empty())
+    {
+        if (!fs::exists(warpCacheFolder))
+        {
+            fs::create_directories(warpCacheFolder);
+        }
+        warpCache = std::make_unique<WarpMapCache>(warpCacheFolder);
+    }
+
     // Define empty tiles data
     std::unique_ptr<float> empty_float(new float[tileSize * tileSize * 3]);
     std::unique_ptr<char> empty_char(new char[tileSize * tileSize]);
     std::memset(empty_float.get(), 0, tileSize * tileSize * 3 * sizeof(float));
     std::memset(empty_char.get(), 0, tileSize * tileSize * sizeof(char));
 
+    // Bounding boxes of the warped images of this chunk, for the compositing
+    WarpedBoundingBoxes warpedBoxes;
+    warpedBoxes.panoramaWidth = panoramaSize.first;
+    warpedBoxes.panoramaHeight = panoramaSize.second;
+
     // Preprocessing per view
     for (std::size_t i = std::size_t(rangeStart); i < std::size_t(rangeStart + rangeSize); ++i)
     {
@@ -262,248 +616,62 @@ int aliceVision_main(int argc, char** argv)
         geometry::Pose3 camPose = sfmData.getPose(view).getTransform();
         std::shared_ptr<camera::IntrinsicBase> intrinsic = sfmData.getIntrinsicSharedPtr(view.getIntrinsicId());
 
-        // Compute coarse bounding box to make computations faster
-        BoundingBox coarseBboxInitial;
-        if (!computeCoarseBB(coarseBboxInitial, panoramaSize, camPose, *(intrinsic.get())))
-        {
-            continue;
-        }
-
-        std::vector<BoundingBox> coarsesBbox;
-        if (coarseBboxInitial.width > coarseBboxInitial.height * 2.0)
+        // Compute the bounding boxes of the warped sub images, or get them from the warp maps cache
+        const std::size_t warpCacheKey = WarpMapCache::computeKey(*(intrinsic.get()), camPose, panoramaSize, tileSize);
+        std::vector<BoundingBox> globalBboxes;
+        const bool useCachedMaps = warpCache && warpCache->find(warpCacheKey, globalBboxes);
+        if (useCachedMaps)
         {
-            const int count = int(double(coarseBboxInitial.width) / double(coarseBboxInitial.height));
-            const int width = coarseBboxInitial.width / count;
-
-            int pos = 0;
-            for (int id = 0; id < count; id++)
-            {
-                BoundingBox subCoarseBbox;
-                subCoarseBbox.left = coarseBboxInitial.left + pos;
-                subCoarseBbox.top = coarseBboxInitial.top;
-                subCoarseBbox.width = width;
-                subCoarseBbox.height = coarseBboxInitial.height;
-
-                coarsesBbox.push_back(subCoarseBbox);
-                pos += width;
-            }
+            ALICEVISION_LOG_INFO("Use the cached warp maps " << warpCacheKey);
         }
         else
         {
-            coarsesBbox.push_back(coarseBboxInitial);
-        }
-
-        // Load image and convert it to linear colorspace
-        const std::string imagePath = view.getImage().getImagePath();
-        ALICEVISION_LOG_INFO("Load image with path " << imagePath);
-        image::Image<image::RGBfColor> source;
-        image::readImage(imagePath, source, workingColorSpace);
-
-        for (int idsub = 0; idsub < coarsesBbox.size(); idsub++)
-        {
-            const auto coarseBbox = coarsesBbox[idsub];
-
-            // round to the closest tiles
-            BoundingBox snappedCoarseBbox;
-            snappedCoarseBbox = coarseBbox;
-            snappedCoarseBbox.snapToGrid(tileSize);
-
-            // Initialize bouding box for image
-            BoundingBox globalBbox;
-
+            // Compute coarse bounding box to make computations faster
+            BoundingBox coarseBboxInitial;
+            if (!computeCoarseBB(coarseBboxInitial, panoramaSize, camPose, *(intrinsic.get())))
             {
-                // Search for first non empty box starting from the top
-                bool found = false;
-
-                for (int y = 0; y < snappedCoarseBbox.height; y += tileSize)
-                {
-#pragma omp parallel for
-                    for (int x = 0; x < snappedCoarseBbox.width; x += tileSize)
-                    {
-                        if (found)
-                        {
-                            continue;
-                        }
-
-                        BoundingBox localBbox;
-                        localBbox.left = x + snappedCoarseBbox.left;
-                        localBbox.top = y + snappedCoarseBbox.top;
-                        localBbox.width = tileSize;
-                        localBbox.height = tileSize;
-
-                        localBbox.clampRight(snappedCoarseBbox.getRight());
-                        localBbox.clampBottom(snappedCoarseBbox.getBottom());
-
-                        // Prepare coordinates map
-                        CoordinatesMap map;
-                        if (!map.build(panoramaSize, camPose, *(intrinsic.get()), localBbox))
-                        {
-                            continue;
-                        }
-
-#pragma omp critical
-                        {
-                            if (!map.getBoundingBox().isEmpty())
-                            {
-                                globalBbox = globalBbox.unionWith(map.getBoundingBox());
-                                found = true;
-                            }
-                        }
-                    }
-
-                    if (found)
-                    {
-                        break;
-                    }
-                }
+                continue;
             }
 
+            std::vector<BoundingBox> coarsesBbox;
+            if (coarseBboxInitial.width > coarseBboxInitial.height * 2.0)
             {
-                // Search for first non empty box starting from the bottom
-                bool found = false;
-                for (int y = snappedCoarseBbox.height - 1; y >= 0; y -= tileSize)
-                {
-#pragma omp parallel for
-                    for (int x = 0; x < snappedCoarseBbox.width; x += tileSize)
-                    {
-                        if (found)
-                        {
-                            continue;
-                        }
-
-                        BoundingBox localBbox;
-                        localBbox.left = x + snappedCoarseBbox.left;
-                        localBbox.top = y + snappedCoarseBbox.top;
-                        localBbox.width = tileSize;
-                        localBbox.height = tileSize;
-
-                        localBbox.clampRight(snappedCoarseBbox.getRight());
-                        localBbox.clampBottom(snappedCoarseBbox.getBottom());
-
-                        // Prepare coordinates map
-                        CoordinatesMap map;
-                        if (!map.build(panoramaSize, camPose, *(intrinsic.get()), localBbox))
-                        {
-                            continue;
-                        }
-
-#pragma omp critical
-                        {
-                            if (!map.getBoundingBox().isEmpty())
-                            {
-                                globalBbox = globalBbox.unionWith(map.getBoundingBox());
-                                found = true;
-                            }
-                        }
-                    }
+                const int count = int(double(coarseBboxInitial.width) / double(coarseBboxInitial.height));
+                const int width = coarseBboxInitial.width / count;
 
-                    if (found)
-                    {
-                        break;
-                    }
-                }
-            }
-
-            {
-                // Search for first non empty box starting from the left
-                bool found = false;
-                for (int x = 0; x < snappedCoarseBbox.width; x += tileSize)
+                int pos = 0;
+                for (int id = 0; id < count; id++)
                 {
-#pragma omp parallel for
-                    for (int y = 0; y < snappedCoarseBbox.height; y += tileSize)
-                    {
-                        if (found)
-                        {
-                            continue;
-                        }
-
-                        BoundingBox localBbox;
-                        localBbox.left = x + snappedCoarseBbox.left;
-                        localBbox.top = y + snappedCoarseBbox.top;
-                        localBbox.width = tileSize;
-                        localBbox.height = tileSize;
-
-                        localBbox.clampRight(snappedCoarseBbox.getRight());
-                        localBbox.clampBottom(snappedCoarseBbox.getBottom());
-
-                        // Prepare coordinates map
-                        CoordinatesMap map;
-                        if (!map.build(panoramaSize, camPose, *(intrinsic.get()), localBbox))
-                        {
-                            continue;
-                        }
-
-#pragma omp critical
-                        {
-                            if (!map.getBoundingBox().isEmpty())
-                            {
-                                globalBbox = globalBbox.unionWith(map.getBoundingBox());
-                                found = true;
-                            }
-                        }
-                    }
-
-                    if (found)
-                    {
-                        break;
-                    }
+                    BoundingBox subCoarseBbox;
+                    subCoarseBbox.left = coarseBboxInitial.left + pos;
+                    subCoarseBbox.top = coarseBboxInitial.top;
+                    subCoarseBbox.width = width;
+                    subCoarseBbox.height = coarseBboxInitial.height;
+
+                    coarsesBbox.push_back(subCoarseBbox);
+                    pos += width;
                 }
             }
-
+            else
             {
-                // Search for first non empty box starting from the left
-                bool found = false;
-                for (int x = snappedCoarseBbox.width - 1; x >= 0; x -= tileSize)
-                {
-#pragma omp parallel for
-                    for (int y = 0; y < snappedCoarseBbox.height; y += tileSize)
-                    {
-                        if (found)
-                        {
-                            continue;
-                        }
-
-                        BoundingBox localBbox;
-                        localBbox.left = x + snappedCoarseBbox.left;
-                        localBbox.top = y + snappedCoarseBbox.top;
-                        localBbox.width = tileSize;
-                        localBbox.height = tileSize;
-
-                        localBbox.clampRight(snappedCoarseBbox.getRight());
-                        localBbox.clampBottom(snappedCoarseBbox.getBottom());
-
-                        // Prepare coordinates map
-                        CoordinatesMap map;
-                        if (!map.build(panoramaSize, camPose, *(intrinsic.get()), localBbox))
-                        {
-                            continue;
-                        }
-
-#pragma omp critical
-                        {
-                            if (!map.getBoundingBox().isEmpty())
-                            {
-                                globalBbox = globalBbox.unionWith(map.getBoundingBox());
-                                found = true;
-                            }
-                        }
-                    }
-
-                    if (found)
-                    {
-                        break;
-                    }
-                }
+                coarsesBbox.push_back(coarseBboxInitial);
             }
 
-            // Rare case ... When all boxes valid are after the loop
-            if (globalBbox.left >= panoramaSize.first)
+            for (const BoundingBox& coarseBbox : coarsesBbox)
             {
-                globalBbox.left -= panoramaSize.first;
+                globalBboxes.push_back(computeGlobalBoundingBox(coarseBbox, panoramaSize, camPose, *(intrinsic.get()), tileSize));
             }
+        }
 
-            globalBbox.width = std::min(globalBbox.width, panoramaSize.first);
-            globalBbox.height = std::min(globalBbox.height, panoramaSize.second);
+        // Load image and convert it to linear colorspace
+        const std::string imagePath = view.getImage().getImagePath();
+        ALICEVISION_LOG_INFO("Load image with path " << imagePath);
+        image::Image<image::RGBfColor> source;
+        image::readImage(imagePath, source, workingColorSpace);
+
+        for (int idsub = 0; idsub < globalBboxes.size(); idsub++)
+        {
+            const BoundingBox globalBbox = globalBboxes[idsub];
 
             // Load metadata and update for output
             oiio::ParamValueList metadata = image::readImageMetadata(imagePath);
@@ -562,6 +730,47 @@ int aliceVision_main(int argc, char** argv)
                 continue;
             }
 
+            // Read the coordinates maps from the cache, or store the computed ones in it
+            std::unique_ptr<WarpMapReader> cacheReader;
+            std::unique_ptr<WarpMapWriter> cacheWriter;
+            if (useCachedMaps)
+            {
+                cacheReader = std::make_unique<WarpMapReader>();
+                if (!cacheReader->open(warpCache->getPath(warpCacheKey, idsub), globalBbox, tileSize))
+                {
+                    ALICEVISION_LOG_WARNING("Invalid warp maps cache file, the coordinates maps are computed.");
+                    cacheReader.reset();
+                }
+            }
+            else if (warpCache)
+            {
+                cacheWriter = std::make_unique<WarpMapWriter>();
+                if (!cacheWriter->open(warpCache->getPath(warpCacheKey, idsub), globalBbox, tileSize, globalBboxes.size()))
+                {
+                    ALICEVISION_LOG_WARNING("Failed to create the warp maps cache file.");
+                    cacheWriter.reset();
+                }
+            }
+
+            const std::function<bool(CoordinatesMap&, const BoundingBox&)> buildMap = [&](CoordinatesMap& map, const BoundingBox& localBbox) {
+                if (cacheReader)
+                {
+                    return cacheReader->read(map, localBbox);
+                }
+
+                if (!map.build(panoramaSize, camPose, *(intrinsic.get()), localBbox))
+                {
+                    return false;
+                }
+
+                if (cacheWriter)
+                {
+                    cacheWriter->write(map);
+                }
+
+                return true;
+            };
+
             std::vector<BoundingBox> boxes;
             for (int y = 0; y < globalBbox.height; y += tileSize)
             {
@@ -576,59 +785,93 @@ int aliceVision_main(int argc, char** argv)
                 }
             }
 
-#pragma omp parallel for
-            for (int boxId = 0; boxId < boxes.size(); boxId++)
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
+            if (useGpu)
             {
-                BoundingBox localBbox = boxes[boxId];
+                warpTilesOnGpu(deviceWarper,
+                               pyramid,
+                               boxes,
+                               globalBbox,
+                               buildMap,
+                               *(intrinsic.get()),
+                               tileSize,
+                               clampHalf,
+                               *out_view,
+                               *out_mask,
+                               *out_weights);
+            }
+            else
+#endif
+            {
+#pragma omp parallel for
+                for (int boxId = 0; boxId < boxes.size(); boxId++)
+                {
+                    BoundingBox localBbox = boxes[boxId];
 
-                int x = localBbox.left - globalBbox.left;
-                int y = localBbox.top - globalBbox.top;
+                    int x = localBbox.left - globalBbox.left;
+                    int y = localBbox.top - globalBbox.top;
 
-                // Prepare coordinates map
-                CoordinatesMap map;
-                if (!map.build(panoramaSize, camPose, *(intrinsic.get()), localBbox))
-                {
-                    continue;
-                }
+                    // Prepare coordinates map
+                    CoordinatesMap map;
+                    if (!buildMap(map, localBbox))
+                    {
+                        continue;
+                    }
 
-                // Warp image
-                GaussianWarper warper;
-                if (!warper.warp(map, pyramid, clampHalf))
-                {
-                    continue;
-                }
+                    // Warp image
+                    GaussianWarper warper;
+                    if (!warper.warp(map, pyramid, clampHalf))
+                    {
+                        continue;
+                    }
 
-                // Alpha mask
-                aliceVision::image::Image<float> weights;
-                if (!distanceToCenter(weights, map, intrinsic->w(), intrinsic->h()))
-                {
-                    continue;
-                }
+                    // Alpha mask
+                    aliceVision::image::Image<float> weights = weightsPool.acquire(map.getCoordinates().width(), map.getCoordinates().height());
+                    if (!distanceToCenter(weights, map, intrinsic->w(), intrinsic->h()))
+                    {
+                        weightsPool.release(weights);
+                        continue;
+                    }
 
 // Store
 #pragma omp critical
-                {
-                    out_view->write_tile(x, y, 0, oiio::TypeDesc::FLOAT, warper.getColor().data());
-                }
+                    {
+                        out_view->write_tile(x, y, 0, oiio::TypeDesc::FLOAT, warper.getColor().data());
+                    }
 
 // Store
 #pragma omp critical
-                {
-                    out_mask->write_tile(x, y, 0, oiio::TypeDesc::UCHAR, warper.getMask().data());
-                }
+                    {
+                        out_mask->write_tile(x, y, 0, oiio::TypeDesc::UCHAR, warper.getMask().data());
+                    }
 
 // Store
 #pragma omp critical
-                {
-                    out_weights->write_tile(x, y, 0, oiio::TypeDesc::FLOAT, weights.data());
+                    {
+                        out_weights->write_tile(x, y, 0, oiio::TypeDesc::FLOAT, weights.data());
+                    }
+
+                    weightsPool.release(weights);
                 }
             }
 
             out_view->close();
             out_mask->close();
             out_weights->close();
+
+            if (cacheWriter && !cacheWriter->close())
+            {
+                ALICEVISION_LOG_WARNING("Failed to store the warp maps in the cache.");
+            }
+
+            warpedBoxes.boundingBoxes[viewIdStr + "_" + subIdStr] = globalBbox;
         }
     }
 
+    if (!saveWarpedBoundingBoxes(outputDirectory, rangeStart, warpedBoxes))
+    {
+        return EXIT_FAILURE;
+    }
+
     return EXIT_SUCCESS;
 }
@@ -19,6 +19,10 @@
 #include <aliceVision/cmdline/cmdline.hpp>
 #include <aliceVision/system/main.hpp>
 #include <aliceVision/system/Logger.hpp>
+#include <aliceVision/config.hpp>
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
+    #include <aliceVision/gpu/gpu.hpp>
+#endif
 
 #include <boost/algorithm/string.hpp>
 #include <boost/program_options.hpp>
@@ -44,7 +48,7 @@
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 1
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 2
 
 namespace po = boost::program_options;
 namespace fs = std::filesystem;
@@ -84,7 +88,12 @@ int aliceVision_main(int argc, char** argv)
         ("isRobust,r", po::value<bool>(&PSParameters.isRobust)->default_value(false),
          "True to use the robust algorithm, false otherwise.")
         ("downscale, d", po::value<int>(&PSParameters.downscale)->default_value(1),
-         "Downscale factor for faster results.");
+         "Downscale factor for faster results.")
+        ("useGpu", po::value<bool>(&PSParameters.useGpu)->default_value(PSParameters.useGpu),
+         "Solve the normals on the GPU (requires a build with CUDA, ignored by the robust algorithm).")
+        ("blockHeight", po::value<int>(&PSParameters.blockHeight)->default_value(PSParameters.blockHeight),
+         "Number of rows (after downscale) of the pictures decoded and solved at once, to bound the memory with large light stacks "
+         "(0 to load the whole pictures).");
     // clang-format on
 
     CmdLine cmdline("AliceVision photometricStereo");
@@ -96,6 +105,20 @@ int aliceVision_main(int argc, char** argv)
         return EXIT_FAILURE;
     }
 
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
+    if (PSParameters.useGpu && !gpu::gpuSupportCUDA(3, 0))
+    {
+        ALICEVISION_LOG_WARNING("No compatible CUDA device found, the normals will be solved on the CPU.");
+        PSParameters.useGpu = false;
+    }
+#else
+    if (PSParameters.useGpu)
+    {
+        ALICEVISION_LOG_WARNING("GPU photometric stereo requires a build with CUDA, the normals will be solved on the CPU.");
+        PSParameters.useGpu = false;
+    }
+#endif
+
     // If the path to light data is empty, set it to inputPath :
     if (pathToLightData.compare("") && fs::is_directory(inputPath))
     {
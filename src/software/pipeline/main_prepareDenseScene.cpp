@@ -7,6 +7,7 @@
 #include <aliceVision/sfmData/SfMData.hpp>
 #include <aliceVision/sfmDataIO/sfmDataIO.hpp>
 #include <aliceVision/image/all.hpp>
+#include <aliceVision/camera/UndistortionMap.hpp>
 #include <aliceVision/system/Logger.hpp>
 #include <aliceVision/system/ProgressDisplay.hpp>
 #include <aliceVision/cmdline/cmdline.hpp>
@@ -19,8 +20,11 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <algorithm>
 #include <cmath>
+#include <exception>
 #include <filesystem>
+#include <future>
 #include <vector>
 #include <set>
 #include <iterator>
@@ -30,7 +34,7 @@
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 2
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 1
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 3
 
 using namespace aliceVision;
 using namespace aliceVision::camera;
@@ -42,6 +46,33 @@ using namespace aliceVision::sfmDataIO;
 namespace po = boost::program_options;
 namespace fs = std::filesystem;
 
+/**
+ * @brief Get the memory used to process a view.
+ * @param[in] width the image width
+ * @param[in] height the image height
+ * @param[in] downscaleLevels the pre-downscaled images to export
+ * @return the memory in bytes
+ */
+std::size_t getViewMemoryConsumption(std::size_t width, std::size_t height, const std::vector<int>& downscaleLevels)
+{
+    const std::size_t nbPixels = width * height;
+
+    // source and undistorted RGBA float images, and the mask
+    std::size_t memory = nbPixels * (2 * sizeof(image::RGBAfColor) + sizeof(unsigned char));
+
+    // largest pre-downscaled image, they are computed one after the other
+    int minDownscale = 0;
+    for (const int downscale : downscaleLevels)
+    {
+        if (downscale > 1 && (minDownscale == 0 || downscale < minDownscale))
+            minDownscale = downscale;
+    }
+    if (minDownscale > 1)
+        memory += nbPixels * sizeof(image::RGBAfColor) / (minDownscale * minDownscale);
+
+    return memory;
+}
+
 template<class ImageT, class MaskFuncT>
 void process(const std::string& dstColorImage,
              const IntrinsicBase* cam,
@@ -49,6 +80,8 @@ void process(const std::string& dstColorImage,
              const std::string& srcImage,
              bool evCorrection,
              float exposureCompensation,
+             const std::vector<int>& downscaleLevels,
+             const image::ImageWriteOptions& writeOptions,
              MaskFuncT&& maskFunc)
 {
     ImageT image, image_ud;
@@ -72,15 +105,38 @@ void process(const std::string& dstColorImage,
     if (cam->isValid() && cam->hasDistortion())
     {
         // undistort the image and save it
+        // the undistortion map is computed once and shared by the images of the same intrinsic
         using Pix = typename ImageT::Tpixel;
         Pix pixZero(Pix::Zero());
-        UndistortImage(image, cam, image_ud, pixZero);
-        writeImage(dstColorImage, image_ud, image::ImageWriteOptions(), metadata);
+        const std::shared_ptr<const camera::UndistortionMap> undistortionMap =
+          camera::UndistortionMapCache::get().getMap(*cam, image.width(), image.height());
+        undistortionMap->remap(image, image_ud, pixZero);
     }
     else
     {
-        writeImage(dstColorImage, image, image::ImageWriteOptions(), metadata);
+        image_ud.swap(image);
     }
+
+    // write the full resolution image while the downscaled ones are computed
+    std::future<void> writing = std::async(std::launch::async, [&]() { writeImage(dstColorImage, image_ud, writeOptions, metadata); });
+
+    // pre-downscaled images
+    // dense nodes read them instead of decoding and downscaling the full resolution image
+    for (const int downscale : downscaleLevels)
+    {
+        if (downscale <= 1)
+            continue;
+
+        ImageT image_ds;
+        imageAlgo::resizeImage(downscale, image_ud, image_ds);
+
+        oiio::ParamValueList metadata_ds = metadata;
+        metadata_ds.attribute("AliceVision:downscale", downscale);
+
+        writeImage(getDownscaledImagePath(dstColorImage, downscale), image_ds, writeOptions, metadata_ds);
+    }
+
+    writing.get();
 }
 
 bool prepareDenseScene(const SfMData& sfmData,
@@ -93,7 +149,10 @@ bool prepareDenseScene(const SfMData& sfmData,
                        image::EImageFileType outputFileType,
                        bool saveMetadata,
                        bool saveMatricesFiles,
-                       bool evCorrection)
+                       bool evCorrection,
+                       const std::vector<int>& downscaleLevels,
+                       image::EStorageDataType storageDataType,
+                       const HardwareContext& hwc)
 {
     // defined view Ids
     std::set<IndexT> viewIds;
@@ -129,157 +188,185 @@ bool prepareDenseScene(const SfMData& sfmData,
     const double medianCameraExposure = sfmData.getMedianCameraExposureSetting().getExposure();
     ALICEVISION_LOG_INFO("Median Camera Exposure: " << medianCameraExposure << ", Median EV: " << std::log2(1.0 / medianCameraExposure));
 
-#pragma omp parallel for num_threads(3)
-    for (int i = 0; i < viewIds.size(); ++i)
+    const image::ImageWriteOptions writeOptions = image::ImageWriteOptions().storageDataType(storageDataType);
+
+    // process the views in parallel, as many at once as the memory allows
+    // the decoding, the undistortion and the writing of the different views overlap
+    std::size_t maxViewMemory = 1;
+    for (const IndexT viewId : viewIds)
     {
-        auto itView = viewIds.begin();
-        std::advance(itView, i);
+        const View& view = sfmData.getView(viewId);
+        maxViewMemory = std::max(maxViewMemory, getViewMemoryConsumption(view.getImage().getWidth(), view.getImage().getHeight(), downscaleLevels));
+    }
+    const int nbParallelViews =
+      std::max(1, std::min(static_cast<int>(hwc.getMaxThreads()), static_cast<int>(hwc.getMaxMemory() / maxViewMemory)));
+    ALICEVISION_LOG_INFO("Processing " << viewIds.size() << " views, " << nbParallelViews << " at once");
 
-        const IndexT viewId = *itView;
-        const View* view = sfmData.getViews().at(viewId).get();
+    std::exception_ptr exception;
 
-        Intrinsics::const_iterator iterIntrinsic = sfmData.getIntrinsics().find(view->getIntrinsicId());
+#pragma omp parallel for num_threads(nbParallelViews) schedule(dynamic)
+    for (int i = 0; i < viewIds.size(); ++i)
+    {
+        try
+        {
+            auto itView = viewIds.begin();
+            std::advance(itView, i);
 
-        // we have a valid view with a corresponding camera & pose
-        const std::string baseFilename = std::to_string(viewId);
+            const IndexT viewId = *itView;
+            const View* view = sfmData.getViews().at(viewId).get();
 
-        // get metadata from source image to be sure we get all metadata. We don't use the metadatas from the Views inside the SfMData to avoid type
-        // conversion problems with string maps.
-        std::string srcImage = view->getImage().getImagePath();
-        oiio::ParamValueList metadata = image::readImageMetadata(srcImage);
+            Intrinsics::const_iterator iterIntrinsic = sfmData.getIntrinsics().find(view->getIntrinsicId());
 
-        // export camera
-        if (saveMetadata || saveMatricesFiles)
-        {
-            // get camera pose / projection
-            const Pose3 pose = sfmData.getPose(*view).getTransform();
+            // we have a valid view with a corresponding camera & pose
+            const std::string baseFilename = std::to_string(viewId);
 
-            std::shared_ptr<camera::IntrinsicBase> cam = iterIntrinsic->second;
-            std::shared_ptr<camera::Pinhole> camPinHole = std::dynamic_pointer_cast<camera::Pinhole>(cam);
-            if (!camPinHole)
+            // get metadata from source image to be sure we get all metadata. We don't use the metadatas from the Views inside the SfMData to avoid type
+            // conversion problems with string maps.
+            std::string srcImage = view->getImage().getImagePath();
+            oiio::ParamValueList metadata = image::readImageMetadata(srcImage);
+
+            // export camera
+            if (saveMetadata || saveMatricesFiles)
             {
-                ALICEVISION_LOG_ERROR("Camera is not pinhole in filter");
-                continue;
-            }
+                // get camera pose / projection
+                const Pose3 pose = sfmData.getPose(*view).getTransform();
 
-            Mat34 P = camPinHole->getProjectiveEquivalent(pose);
+                std::shared_ptr<camera::IntrinsicBase> cam = iterIntrinsic->second;
+                std::shared_ptr<camera::Pinhole> camPinHole = std::dynamic_pointer_cast<camera::Pinhole>(cam);
+                if (!camPinHole)
+                {
+                    ALICEVISION_LOG_ERROR("Camera is not pinhole in filter");
+                    continue;
+                }
 
-            // get camera intrinsics matrices
-            const Mat3 K = dynamic_cast<const Pinhole*>(sfmData.getIntrinsicPtr(view->getIntrinsicId()))->K();
-            const Mat3& R = pose.rotation();
-            const Vec3& t = pose.translation();
+                Mat34 P = camPinHole->getProjectiveEquivalent(pose);
 
-            if (saveMatricesFiles)
-            {
-                std::ofstream fileP((fs::path(outFolder) / (baseFilename + "_P.txt")).string());
-                fileP << std::setprecision(10) << P(0, 0) << " " << P(0, 1) << " " << P(0, 2) << " " << P(0, 3) << "\n"
-                      << P(1, 0) << " " << P(1, 1) << " " << P(1, 2) << " " << P(1, 3) << "\n"
-                      << P(2, 0) << " " << P(2, 1) << " " << P(2, 2) << " " << P(2, 3) << "\n";
-                fileP.close();
-
-                std::ofstream fileKRt((fs::path(outFolder) / (baseFilename + "_KRt.txt")).string());
-                fileKRt << std::setprecision(10) << K(0, 0) << " " << K(0, 1) << " " << K(0, 2) << "\n"
-                        << K(1, 0) << " " << K(1, 1) << " " << K(1, 2) << "\n"
-                        << K(2, 0) << " " << K(2, 1) << " " << K(2, 2) << "\n"
-                        << "\n"
-                        << R(0, 0) << " " << R(0, 1) << " " << R(0, 2) << "\n"
-                        << R(1, 0) << " " << R(1, 1) << " " << R(1, 2) << "\n"
-                        << R(2, 0) << " " << R(2, 1) << " " << R(2, 2) << "\n"
-                        << "\n"
-                        << t(0) << " " << t(1) << " " << t(2) << "\n";
-                fileKRt.close();
-            }
+                // get camera intrinsics matrices
+                const Mat3 K = dynamic_cast<const Pinhole*>(sfmData.getIntrinsicPtr(view->getIntrinsicId()))->K();
+                const Mat3& R = pose.rotation();
+                const Vec3& t = pose.translation();
 
-            if (saveMetadata)
-            {
-                // convert to 44 matix
-                Mat4 projectionMatrix;
-                projectionMatrix << P(0, 0), P(0, 1), P(0, 2), P(0, 3), P(1, 0), P(1, 1), P(1, 2), P(1, 3), P(2, 0), P(2, 1), P(2, 2), P(2, 3), 0, 0,
-                  0, 1;
-
-                // convert matrices to rowMajor
-                std::vector<double> vP(projectionMatrix.size());
-                std::vector<double> vK(K.size());
-                std::vector<double> vR(R.size());
-
-                typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> RowMatrixXd;
-                Eigen::Map<RowMatrixXd>(vP.data(), projectionMatrix.rows(), projectionMatrix.cols()) = projectionMatrix;
-                Eigen::Map<RowMatrixXd>(vK.data(), K.rows(), K.cols()) = K;
-                Eigen::Map<RowMatrixXd>(vR.data(), R.rows(), R.cols()) = R;
-
-                // add metadata
-                metadata.push_back(oiio::ParamValue("AliceVision:downscale", 1));
-                metadata.push_back(oiio::ParamValue("AliceVision:P", oiio::TypeDesc(oiio::TypeDesc::DOUBLE, oiio::TypeDesc::MATRIX44), 1, vP.data()));
-                metadata.push_back(oiio::ParamValue("AliceVision:K", oiio::TypeDesc(oiio::TypeDesc::DOUBLE, oiio::TypeDesc::MATRIX33), 1, vK.data()));
-                metadata.push_back(oiio::ParamValue("AliceVision:R", oiio::TypeDesc(oiio::TypeDesc::DOUBLE, oiio::TypeDesc::MATRIX33), 1, vR.data()));
-                metadata.push_back(oiio::ParamValue("AliceVision:t", oiio::TypeDesc(oiio::TypeDesc::DOUBLE, oiio::TypeDesc::VEC3), 1, t.data()));
+                if (saveMatricesFiles)
+                {
+                    std::ofstream fileP((fs::path(outFolder) / (baseFilename + "_P.txt")).string());
+                    fileP << std::setprecision(10) << P(0, 0) << " " << P(0, 1) << " " << P(0, 2) << " " << P(0, 3) << "\n"
+                          << P(1, 0) << " " << P(1, 1) << " " << P(1, 2) << " " << P(1, 3) << "\n"
+                          << P(2, 0) << " " << P(2, 1) << " " << P(2, 2) << " " << P(2, 3) << "\n";
+                    fileP.close();
+
+                    std::ofstream fileKRt((fs::path(outFolder) / (baseFilename + "_KRt.txt")).string());
+                    fileKRt << std::setprecision(10) << K(0, 0) << " " << K(0, 1) << " " << K(0, 2) << "\n"
+                            << K(1, 0) << " " << K(1, 1) << " " << K(1, 2) << "\n"
+                            << K(2, 0) << " " << K(2, 1) << " " << K(2, 2) << "\n"
+                            << "\n"
+                            << R(0, 0) << " " << R(0, 1) << " " << R(0, 2) << "\n"
+                            << R(1, 0) << " " << R(1, 1) << " " << R(1, 2) << "\n"
+                            << R(2, 0) << " " << R(2, 1) << " " << R(2, 2) << "\n"
+                            << "\n"
+                            << t(0) << " " << t(1) << " " << t(2) << "\n";
+                    fileKRt.close();
+                }
+
+                if (saveMetadata)
+                {
+                    // convert to 44 matix
+                    Mat4 projectionMatrix;
+                    projectionMatrix << P(0, 0), P(0, 1), P(0, 2), P(0, 3), P(1, 0), P(1, 1), P(1, 2), P(1, 3), P(2, 0), P(2, 1), P(2, 2), P(2, 3), 0, 0,
+                      0, 1;
+
+                    // convert matrices to rowMajor
+                    std::vector<double> vP(projectionMatrix.size());
+                    std::vector<double> vK(K.size());
+                    std::vector<double> vR(R.size());
+
+                    typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> RowMatrixXd;
+                    Eigen::Map<RowMatrixXd>(vP.data(), projectionMatrix.rows(), projectionMatrix.cols()) = projectionMatrix;
+                    Eigen::Map<RowMatrixXd>(vK.data(), K.rows(), K.cols()) = K;
+                    Eigen::Map<RowMatrixXd>(vR.data(), R.rows(), R.cols()) = R;
+
+                    // add metadata
+                    metadata.push_back(oiio::ParamValue("AliceVision:downscale", 1));
+                    metadata.push_back(oiio::ParamValue("AliceVision:P", oiio::TypeDesc(oiio::TypeDesc::DOUBLE, oiio::TypeDesc::MATRIX44), 1, vP.data()));
+                    metadata.push_back(oiio::ParamValue("AliceVision:K", oiio::TypeDesc(oiio::TypeDesc::DOUBLE, oiio::TypeDesc::MATRIX33), 1, vK.data()));
+                    metadata.push_back(oiio::ParamValue("AliceVision:R", oiio::TypeDesc(oiio::TypeDesc::DOUBLE, oiio::TypeDesc::MATRIX33), 1, vR.data()));
+                    metadata.push_back(oiio::ParamValue("AliceVision:t", oiio::TypeDesc(oiio::TypeDesc::DOUBLE, oiio::TypeDesc::VEC3), 1, t.data()));
+                }
             }
-        }
 
-        // export undistort image
-        {
-            if (!imagesFolders.empty())
+            // export undistort image
             {
-                std::vector<std::string> paths = sfmDataIO::viewPathsFromFolders(*view, imagesFolders);
-
-                // if path was not found
-                if (paths.empty())
+                if (!imagesFolders.empty())
                 {
-                    throw std::runtime_error("Cannot find view '" + std::to_string(view->getViewId()) + "' image file in given folder(s)");
+                    std::vector<std::string> paths = sfmDataIO::viewPathsFromFolders(*view, imagesFolders);
+
+                    // if path was not found
+                    if (paths.empty())
+                    {
+                        throw std::runtime_error("Cannot find view '" + std::to_string(view->getViewId()) + "' image file in given folder(s)");
+                    }
+                    else if (paths.size() > 1)
+                    {
+                        throw std::runtime_error("Ambiguous case: Multiple source image files found in given folder(s) for the view '" +
+                                                 std::to_string(view->getViewId()) + "'.");
+                    }
+
+                    srcImage = paths[0];
                 }
-                else if (paths.size() > 1)
+                const std::string dstColorImage =
+                  (fs::path(outFolder) / (baseFilename + "." + image::EImageFileType_enumToString(outputFileType))).string();
+                const IntrinsicBase* cam = iterIntrinsic->second.get();
+
+                // add exposure values to images metadata
+                const double cameraExposure = view->getImage().getCameraExposureSetting().getExposure();
+                const double ev = std::log2(1.0 / cameraExposure);
+                const float exposureCompensation = float(medianCameraExposure / cameraExposure);
+                metadata.push_back(oiio::ParamValue("AliceVision:EV", float(ev)));
+                metadata.push_back(oiio::ParamValue("AliceVision:EVComp", exposureCompensation));
+
+                if (evCorrection)
                 {
-                    throw std::runtime_error("Ambiguous case: Multiple source image files found in given folder(s) for the view '" +
-                                             std::to_string(view->getViewId()) + "'.");
+                    ALICEVISION_LOG_INFO("image " << viewId << ", exposure: " << cameraExposure << ", Ev " << ev
+                                                  << " Ev compensation: " + std::to_string(exposureCompensation));
                 }
 
-                srcImage = paths[0];
-            }
-            const std::string dstColorImage =
-              (fs::path(outFolder) / (baseFilename + "." + image::EImageFileType_enumToString(outputFileType))).string();
-            const IntrinsicBase* cam = iterIntrinsic->second.get();
-
-            // add exposure values to images metadata
-            const double cameraExposure = view->getImage().getCameraExposureSetting().getExposure();
-            const double ev = std::log2(1.0 / cameraExposure);
-            const float exposureCompensation = float(medianCameraExposure / cameraExposure);
-            metadata.push_back(oiio::ParamValue("AliceVision:EV", float(ev)));
-            metadata.push_back(oiio::ParamValue("AliceVision:EVComp", exposureCompensation));
-
-            if (evCorrection)
-            {
-                ALICEVISION_LOG_INFO("image " << viewId << ", exposure: " << cameraExposure << ", Ev " << ev
-                                              << " Ev compensation: " + std::to_string(exposureCompensation));
+                image::Image<unsigned char> mask;
+                if (tryLoadMask(&mask, masksFolders, viewId, srcImage, maskExtension))
+                {
+                    process<Image<RGBAfColor>>(
+                      dstColorImage, cam, metadata, srcImage, evCorrection, exposureCompensation, downscaleLevels, writeOptions, [&mask](Image<RGBAfColor>& image) {
+                          if (image.width() * image.height() != mask.width() * mask.height())
+                          {
+                              ALICEVISION_LOG_WARNING("Invalid image mask size: mask is ignored.");
+                              return;
+                          }
+
+                          for (int pix = 0; pix < image.width() * image.height(); ++pix)
+                          {
+                              const bool masked = (mask(pix) == 0);
+                              image(pix).a() = masked ? 0.f : 1.f;
+                          }
+                      });
+                }
+                else
+                {
+                    const auto noMaskingFunc = [](Image<RGBAfColor>& image) {};
+                    process<Image<RGBAfColor>>(
+                      dstColorImage, cam, metadata, srcImage, evCorrection, exposureCompensation, downscaleLevels, writeOptions, noMaskingFunc);
+                }
             }
 
-            image::Image<unsigned char> mask;
-            if (tryLoadMask(&mask, masksFolders, viewId, srcImage, maskExtension))
-            {
-                process<Image<RGBAfColor>>(
-                  dstColorImage, cam, metadata, srcImage, evCorrection, exposureCompensation, [&mask](Image<RGBAfColor>& image) {
-                      if (image.width() * image.height() != mask.width() * mask.height())
-                      {
-                          ALICEVISION_LOG_WARNING("Invalid image mask size: mask is ignored.");
-                          return;
-                      }
-
-                      for (int pix = 0; pix < image.width() * image.height(); ++pix)
-                      {
-                          const bool masked = (mask(pix) == 0);
-                          image(pix).a() = masked ? 0.f : 1.f;
-                      }
-                  });
-            }
-            else
-            {
-                const auto noMaskingFunc = [](Image<RGBAfColor>& image) {};
-                process<Image<RGBAfColor>>(dstColorImage, cam, metadata, srcImage, evCorrection, exposureCompensation, noMaskingFunc);
-            }
+            ++progressDisplay;
+        }
+        catch (...)
+        {
+#pragma omp critical
+            exception = std::current_exception();
         }
-
-        ++progressDisplay;
     }
 
+    if (exception)
+        std::rethrow_exception(exception);
+
     return true;
 }
 
@@ -299,6 +386,8 @@ int aliceVision_main(int argc, char* argv[])
     bool saveMetadata = true;
     bool saveMatricesTxtFiles = false;
     bool evCorrection = false;
+    std::vector<int> downscaleLevels;
+    image::EStorageDataType storageDataType = image::EStorageDataType::Float;
 
     // clang-format off
     po::options_description requiredParams("Required parameters");
@@ -329,7 +418,13 @@ int aliceVision_main(int argc, char* argv[])
         ("rangeSize", po::value<int>(&rangeSize)->default_value(rangeSize),
          "Range size.")
         ("evCorrection", po::value<bool>(&evCorrection)->default_value(evCorrection),
-         "Correct exposure value.");
+         "Correct exposure value.")
+        ("downscaleLevels", po::value<std::vector<int>>(&downscaleLevels)->multitoken(),
+         "Also export pre-downscaled undistorted images for the given downscale factors (eg 2 4).\n"
+         "Dense reconstruction nodes use them instead of downscaling the full resolution images.")
+        ("storageDataType", po::value<image::EStorageDataType>(&storageDataType)->default_value(storageDataType),
+         ("Storage data type of the EXR images: " + image::EStorageDataType_informations() + "\n"
+          "Half float images take half of the disk space and are read faster by the dense reconstruction nodes.").c_str());
     // clang-format on
 
     CmdLine cmdline("AliceVision prepareDenseScene");
@@ -347,9 +442,9 @@ int aliceVision_main(int argc, char* argv[])
     if (!utils::exists(outFolder))
         fs::create_directory(outFolder);
 
-    // Read the input SfM scene
+    // Read the input SfM scene (the structure is not used)
     SfMData sfmData;
-    if (!sfmDataIO::load(sfmData, sfmDataFilename, sfmDataIO::ESfMData::ALL))
+    if (!sfmDataIO::load(sfmData, sfmDataFilename, sfmDataIO::ESfMData(sfmDataIO::ESfMData::ALL & ~sfmDataIO::ESfMData::STRUCTURE)))
     {
         ALICEVISION_LOG_ERROR("The input SfMData file '" << sfmDataFilename << "' cannot be read.");
         return EXIT_FAILURE;
@@ -393,7 +488,10 @@ int aliceVision_main(int argc, char* argv[])
                           outputFileType,
                           saveMetadata,
                           saveMatricesTxtFiles,
-                          evCorrection))
+                          evCorrection,
+                          downscaleLevels,
+                          storageDataType,
+                          cmdline.getHardwareContext()))
         return EXIT_SUCCESS;
 
     return EXIT_FAILURE;
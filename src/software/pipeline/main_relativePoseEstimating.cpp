@@ -44,7 +44,7 @@
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 1
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 2
 
 using namespace aliceVision;
 
@@ -266,7 +266,7 @@ int aliceVision_main(int argc, char** argv)
         ("input,i", po::value<std::string>(&sfmDataFilename)->required(),
          "SfMData file.")
         ("tracksFilename,t", po::value<std::string>(&tracksFilename)->required(),
-         "Tracks file.")
+         "Tracks file. With a binary tracks file, only the tracks of the pairs of the range are loaded.")
         ("output,o", po::value<std::string>(&outputDirectory)->required(),
          "Path to the output directory.");
 
@@ -328,30 +328,72 @@ int aliceVision_main(int argc, char** argv)
     }
     ALICEVISION_LOG_DEBUG("Range to compute: rangeStart=" << rangeStart << ", rangeSize=" << rangeSize);
 
-    // get imageDescriber type
-    const std::vector<feature::EImageDescriberType> describerTypes = feature::EImageDescriberType_stringToEnums(describerTypesName);
+    // Covisible pairs, sorted by pair
+    std::vector<Pair> covisiblePairs;
+    track::TracksMap mapTracks;
 
-    // features reading
-    feature::FeaturesPerView featuresPerView;
-    ALICEVISION_LOG_INFO("Load features");
-    if (!sfm::loadFeaturesPerView(featuresPerView, sfmData, featuresFolders, describerTypes))
+    // The binary tracks file stores the co-visibility and is indexed by view
+    const bool binaryTracks = track::isBinaryTracksFile(tracksFilename);
+
+    if (binaryTracks)
     {
-        ALICEVISION_LOG_ERROR("Invalid features.");
-        return EXIT_FAILURE;
+        ALICEVISION_LOG_INFO("Load co-visibility");
+        std::vector<std::pair<Pair, std::size_t>> pairs;
+        if (!track::loadBinaryTracksPairs(tracksFilename, pairs))
+        {
+            ALICEVISION_LOG_ERROR("The input tracks file '" + tracksFilename + "' cannot be read.");
+            return EXIT_FAILURE;
+        }
+
+        covisiblePairs.reserve(pairs.size());
+        for (const auto& pair : pairs)
+        {
+            covisiblePairs.push_back(pair.first);
+        }
+    }
+    else
+    {
+        // Load tracks
+        ALICEVISION_LOG_INFO("Load tracks");
+        if (!track::loadTracks(tracksFilename, mapTracks))
+        {
+            ALICEVISION_LOG_ERROR("The input tracks file '" + tracksFilename + "' cannot be read.");
+            return EXIT_FAILURE;
+        }
+
+        ALICEVISION_LOG_INFO("Compute co-visibility");
+        std::map<Pair, unsigned int> covisibility;
+        computeCovisibility(covisibility, mapTracks);
+
+        covisiblePairs.reserve(covisibility.size());
+        for (const auto& item : covisibility)
+        {
+            covisiblePairs.push_back(item.first);
+        }
+    }
+
+    double ratioChunk = double(covisiblePairs.size()) / double(sfmData.getViews().size());
+    int chunkStart = int(double(rangeStart) * ratioChunk);
+    int chunkEnd = int(double(rangeStart + rangeSize) * ratioChunk);
+
+    // Only the tracks and the features of the pairs of the chunk are needed
+    const PairSet chunkPairs(covisiblePairs.begin() + chunkStart, covisiblePairs.begin() + chunkEnd);
+    std::set<IndexT> chunkViewIds;
+    for (const Pair& pair : chunkPairs)
+    {
+        chunkViewIds.insert(pair.first);
+        chunkViewIds.insert(pair.second);
     }
 
-    // Load tracks
-    ALICEVISION_LOG_INFO("Load tracks");
-    std::ifstream tracksFile(tracksFilename);
-    if (tracksFile.is_open() == false)
+    if (binaryTracks)
     {
-        ALICEVISION_LOG_ERROR("The input tracks file '" + tracksFilename + "' cannot be read.");
-        return EXIT_FAILURE;
+        ALICEVISION_LOG_INFO("Load tracks of " << chunkPairs.size() << " pairs");
+        if (!track::loadBinaryTracks(tracksFilename, chunkPairs, mapTracks))
+        {
+            ALICEVISION_LOG_ERROR("The input tracks file '" + tracksFilename + "' cannot be read.");
+            return EXIT_FAILURE;
+        }
     }
-    std::stringstream buffer;
-    buffer << tracksFile.rdbuf();
-    boost::json::value jv = boost::json::parse(buffer.str());
-    track::TracksMap mapTracks(track::flat_map_value_to<track::Track>(jv));
 
     // Compute tracks per view
     ALICEVISION_LOG_INFO("Estimate tracks per view");
@@ -363,9 +405,20 @@ int aliceVision_main(int argc, char** argv)
     }
     track::computeTracksPerView(mapTracks, mapTracksPerView);
 
-    ALICEVISION_LOG_INFO("Compute co-visibility");
-    std::map<Pair, unsigned int> covisibility;
-    computeCovisibility(covisibility, mapTracks);
+    // get imageDescriber type
+    const std::vector<feature::EImageDescriberType> describerTypes = feature::EImageDescriberType_stringToEnums(describerTypesName);
+
+    // features reading
+    feature::FeaturesPerView featuresPerView;
+    if (!chunkViewIds.empty())
+    {
+        ALICEVISION_LOG_INFO("Load features");
+        if (!sfm::loadFeaturesPerView(featuresPerView, sfmData, featuresFolders, describerTypes, chunkViewIds))
+        {
+            ALICEVISION_LOG_ERROR("Invalid features.");
+            return EXIT_FAILURE;
+        }
+    }
 
     ALICEVISION_LOG_INFO("Process co-visibility");
     std::stringstream ss;
@@ -374,20 +427,13 @@ int aliceVision_main(int argc, char** argv)
 
     std::vector<sfm::ReconstructedPair> reconstructedPairs;
 
-    double ratioChunk = double(covisibility.size()) / double(sfmData.getViews().size());
-    int chunkStart = int(double(rangeStart) * ratioChunk);
-    int chunkEnd = int(double(rangeStart + rangeSize) * ratioChunk);
-
     // For each covisible pair
 #pragma omp parallel for
     for (int posPairs = chunkStart; posPairs < chunkEnd; posPairs++)
     {
-        auto iterPairs = covisibility.begin();
-        std::advance(iterPairs, posPairs);
-
         // Retrieve pair information
-        IndexT refImage = iterPairs->first.first;
-        IndexT nextImage = iterPairs->first.second;
+        IndexT refImage = covisiblePairs[posPairs].first;
+        IndexT nextImage = covisiblePairs[posPairs].second;
 
         const sfmData::View& refView = sfmData.getView(refImage);
         const sfmData::View& nextView = sfmData.getView(nextImage);
@@ -510,7 +556,8 @@ int aliceVision_main(int argc, char** argv)
             if (reconstructedPairs.size() > 1000)
             {
                 boost::json::value jv = boost::json::value_from(reconstructedPairs);
-                of << boost::json::serialize(jv);
+                // one array per line, read back as a sequence of JSON values
+                of << boost::json::serialize(jv) << std::endl;
                 reconstructedPairs.clear();
             }
         }
@@ -519,7 +566,7 @@ int aliceVision_main(int argc, char** argv)
     // Serialize last pairs
     {
         boost::json::value jv = boost::json::value_from(reconstructedPairs);
-        of << boost::json::serialize(jv);
+        of << boost::json::serialize(jv) << std::endl;
     }
 
     of.close();
@@ -8,6 +8,7 @@
 #include <aliceVision/cmdline/cmdline.hpp>
 #include <aliceVision/system/main.hpp>
 #include <aliceVision/system/Logger.hpp>
+#include <aliceVision/onnx/SessionPool.hpp>
 
 #include <aliceVision/sphereDetection/sphereDetection.hpp>
 
@@ -30,7 +31,7 @@
 #include <onnxruntime_cxx_api.h>
 
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 1
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 2
 
 namespace fs = std::filesystem;
 namespace po = boost::program_options;
@@ -49,6 +50,8 @@ int aliceVision_main(int argc, char** argv)
     bool autoDetect;
     Eigen::Vector2f sphereCenterOffset(0, 0);
     double sphereRadius = 1.0;
+    // images processed concurrently on the session, sharing the available threads
+    int nbConcurrentImages = 2;
 
     // clang-format off
     po::options_description requiredParams("Required parameters");
@@ -71,7 +74,9 @@ int aliceVision_main(int argc, char** argv)
         ("y,y", po::value<float>(&sphereCenterOffset(1))->default_value(0.0),
          "Sphere's center offset Y (pixels).")
         ("sphereRadius,r", po::value<double>(&sphereRadius)->default_value(1.0),
-         "Sphere's radius (pixels).");
+         "Sphere's radius (pixels).")
+        ("nbConcurrentImages", po::value<int>(&nbConcurrentImages)->default_value(nbConcurrentImages),
+         "Number of images processed concurrently by the automatic detection, on a single shared model session.");
     // clang-format on
 
     CmdLine cmdline("AliceVision sphereDetection");
@@ -97,19 +102,15 @@ int aliceVision_main(int argc, char** argv)
     if (autoDetect)
     {
         // ONNXRuntime session setup
-        Ort::Env env(ORT_LOGGING_LEVEL_WARNING, "Sphere detector ONNX model environment");
-        Ort::SessionOptions sessionOptions;
-#if defined(_WIN32) || defined(_WIN64)
-        std::wstring modelPath(inputModelPath.begin(), inputModelPath.end());
-        Ort::Session session(env, modelPath.c_str(), sessionOptions);
-#else
-        Ort::Session session(env, inputModelPath.c_str(), sessionOptions);
-#endif
+        const HardwareContext hwc = cmdline.getHardwareContext();
+        std::shared_ptr<Ort::Session> session =
+          onnx::SessionPool::get().getSession(inputModelPath, onnx::getSessionOptions(hwc, false, nbConcurrentImages));
+
         // DEBUG: print model I/O
-        sphereDetection::modelExplore(session);
+        sphereDetection::modelExplore(*session);
 
         // Neural network magic
-        sphereDetection::sphereDetection(sfmData, session, fsOutputPath, inputMinScore);
+        sphereDetection::sphereDetection(sfmData, *session, fsOutputPath, inputMinScore, nbConcurrentImages);
     }
     else
     {
@@ -20,6 +20,11 @@
 #include <aliceVision/system/main.hpp>
 #include <aliceVision/system/Timer.hpp>
 
+#include <aliceVision/config.hpp>
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
+    #include <aliceVision/gpu/gpu.hpp>
+#endif
+
 #include <geogram/basic/common.h>
 
 #include <boost/program_options.hpp>
@@ -29,7 +34,7 @@
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 3
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 3
 
 using namespace aliceVision;
 
@@ -136,7 +141,15 @@ int aliceVision_main(int argc, char* argv[])
          " * PullPush: Combine results from Pull and Push results.'")
         ("subdivisionTargetRatio", po::value<float>(&texParams.subdivisionTargetRatio)->default_value(texParams.subdivisionTargetRatio),
          "Percentage of the density of the reconstruction as the target for the subdivision "
-         "(0: disable subdivision, 0.5: half density of the reconstruction, 1: full density of the reconstruction).");
+         "(0: disable subdivision, 0.5: half density of the reconstruction, 1: full density of the reconstruction).")
+        ("useGpu", po::value<bool>(&texParams.useGpu)->default_value(texParams.useGpu),
+         "Project and blend the cameras contributions on the GPU (requires a build with CUDA).")
+        ("cameraMajorOrder", po::value<bool>(&texParams.cameraMajorOrder)->default_value(texParams.cameraMajorOrder),
+         "Load each camera image once for all the texture atlases, instead of processing the atlases by chunks fitting in memory. "
+         "The atlases are accumulated by tiles, moved to disk in the output folder when they don't fit in memory.")
+        ("tiledTextures", po::value<bool>(&texParams.tiledTextures)->default_value(texParams.tiledTextures),
+         "Write the textures as tiled (256x256) MIP-mapped EXR files, so that the viewers only stream the visible tiles. "
+         "The textures are written in EXR whatever the color mapping file type.");
     // clang-format on
 
     CmdLine cmdline("AliceVision texturing");
@@ -157,6 +170,20 @@ int aliceVision_main(int argc, char* argv[])
     // set bump mapping file type
     bumpMappingParams.bumpMappingFileType = (bumpMappingParams.bumpType == mesh::EBumpMappingType::Normal) ? normalFileType : heightFileType;
 
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
+    if (texParams.useGpu && !gpu::gpuSupportCUDA(3, 0))
+    {
+        ALICEVISION_LOG_WARNING("No compatible CUDA device found, the textures will be computed on the CPU.");
+        texParams.useGpu = false;
+    }
+#else
+    if (texParams.useGpu)
+    {
+        ALICEVISION_LOG_WARNING("GPU texturing requires a build with CUDA, the textures will be computed on the CPU.");
+        texParams.useGpu = false;
+    }
+#endif
+
     GEO::initialize();
 
     texParams.visibilityRemappingMethod = mesh::EVisibilityRemappingMethod_stringToEnum(visibilityRemappingMethod);
@@ -199,11 +226,16 @@ int aliceVision_main(int argc, char* argv[])
     mesh::Mesh refMesh;
     mvsUtils::createRefMeshFromDenseSfMData(refMesh, sfmData, mp);
 
+    // nearest vertex search in the reference mesh, built once for all the remappings and the subdivision
+    std::unique_ptr<mesh::NearestVertexSearch> refMeshSearch;
+    if (!refMesh.pts.empty())
+        refMeshSearch.reset(new mesh::NearestVertexSearch(refMesh));
+
     // generate UVs if necessary
     if (!mesh.hasUVs())
     {
         // Need visibilities to compute unwrap
-        mesh.remapVisibilities(texParams.visibilityRemappingMethod, mp, refMesh);
+        mesh.remapVisibilities(texParams.visibilityRemappingMethod, mp, refMesh, refMeshSearch.get());
         ALICEVISION_LOG_INFO("Input mesh has no UV coordinates, start unwrapping (" + unwrapMethod + ")");
         mesh.unwrap(mp, mesh::EUnwrapMethod_stringToEnum(unwrapMethod));
         ALICEVISION_LOG_INFO("Unwrapping done.");
@@ -212,7 +244,8 @@ int aliceVision_main(int argc, char* argv[])
     if (texParams.subdivisionTargetRatio > 0)
     {
         const bool remapVisibilities = false;
-        const int nbSubdiv = mesh.mesh->subdivideMesh(refMesh, texParams.subdivisionTargetRatio, remapVisibilities);
+        const int nbSubdiv = refMeshSearch ? mesh.mesh->subdivideMesh(refMesh, refMeshSearch->getKdTree(), texParams.subdivisionTargetRatio, remapVisibilities)
+                                           : mesh.mesh->subdivideMesh(refMesh, texParams.subdivisionTargetRatio, remapVisibilities);
         ALICEVISION_LOG_INFO("Number of triangle subdivisions: " << nbSubdiv);
 
         mesh.updateAtlases();
@@ -223,7 +256,7 @@ int aliceVision_main(int argc, char* argv[])
 
     if (mesh.mesh->pointsVisibilities.empty())
     {
-        mesh.remapVisibilities(texParams.visibilityRemappingMethod, mp, refMesh);
+        mesh.remapVisibilities(texParams.visibilityRemappingMethod, mp, refMesh, refMeshSearch.get());
 
         // DEBUG: export subdivided mesh
         // mesh.saveAsOBJ(outputFolder, "subdividedMesh", outputTextureFileType);
@@ -27,7 +27,7 @@
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 1
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 2
 
 using namespace aliceVision;
 
@@ -55,7 +55,7 @@ int aliceVision_main(int argc, char** argv)
         ("input,i", po::value<std::string>(&sfmDataFilename)->required(),
          "SfMData file.")
         ("output,o", po::value<std::string>(&tracksFilename)->required(),
-         "Path to the tracks file.");
+         "Path to the tracks file: JSON if the extension is .json, compact binary indexed by view otherwise.");
 
     po::options_description optionalParams("Optional parameters");
     optionalParams.add_options()
@@ -136,14 +136,13 @@ int aliceVision_main(int argc, char** argv)
     track::TracksMap mapTracks;
     tracksBuilder.exportToSTL(mapTracks);
 
-    // write the json file with the tree
+    // write the tracks file
     ALICEVISION_LOG_INFO("Export to file");
-    std::stringstream ss;
-
-    boost::json::value jv = boost::json::value_from(mapTracks);
-    std::ofstream of(tracksFilename);
-    of << boost::json::serialize(jv);
-    of.close();
+    if (!track::saveTracks(tracksFilename, mapTracks))
+    {
+        ALICEVISION_LOG_ERROR("The tracks file '" + tracksFilename + "' cannot be written.");
+        return EXIT_FAILURE;
+    }
 
     return EXIT_SUCCESS;
 }
@@ -10,7 +10,9 @@
 #include <aliceVision/image/all.hpp>
 #include <aliceVision/cmdline/cmdline.hpp>
 #include <aliceVision/system/main.hpp>
+#include <aliceVision/system/hardwareContext.hpp>
 #include <aliceVision/config.hpp>
+#include <aliceVision/alicevision_omp.hpp>
 #include <aliceVision/utils/filesIO.hpp>
 #include <aliceVision/utils/regexFilter.hpp>
 
@@ -25,7 +27,11 @@
 #include <opencv2/imgcodecs.hpp>
 #include <opencv2/mcc.hpp>
 
+#include <atomic>
+#include <exception>
 #include <filesystem>
+#include <functional>
+#include <sstream>
 #include <string>
 #include <fstream>
 #include <vector>
@@ -34,7 +40,7 @@
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 1
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 1
 
 using namespace aliceVision;
 
@@ -143,6 +149,10 @@ struct CCheckerDetectionSettings
     unsigned int maxCountByImage;
     std::string outputData;
     bool debug;
+    /// maximum size of the image of the coarse detection pass (0: detection on the full resolution image only)
+    int coarseMaxSize;
+    /// folder of the per-image detections cache (empty: no cache)
+    std::string cacheFolder;
 };
 
 struct Quad
@@ -329,13 +339,122 @@ struct MacbethCCheckerQuad : Quad
     }
 };
 
-void detectColorChecker(std::vector<MacbethCCheckerQuad>& detectedCCheckers, ImageOptions& imgOpt, CCheckerDetectionSettings& settings)
+/**
+ * @brief Detect the color checkers of an image.
+ *        If the image is larger than the coarse size, the checkers are first detected on a downscaled image,
+ *        then refined on the full resolution image only in the regions of interest around the coarse detections.
+ *        The detection on the full resolution image is used when the coarse pass finds no checker (too small checkers).
+ * @note A detector is not thread-safe: each thread uses its own detector.
+ */
+bool processDetection(cv::Ptr<cv::mcc::CCheckerDetector>& detector, const cv::Mat& imgBGR, const CCheckerDetectionSettings& settings)
+{
+    const int maxSize = std::max(imgBGR.cols, imgBGR.rows);
+    if (settings.coarseMaxSize <= 0 || maxSize <= settings.coarseMaxSize)
+        return detector->process(imgBGR, settings.typechart, settings.maxCountByImage);
+
+    const double scale = static_cast<double>(settings.coarseMaxSize) / maxSize;
+    cv::Mat imgCoarse;
+    cv::resize(imgBGR, imgCoarse, cv::Size(), scale, scale, cv::INTER_AREA);
+
+    cv::Ptr<cv::mcc::CCheckerDetector> coarseDetector = cv::mcc::CCheckerDetector::create();
+    if (coarseDetector->process(imgCoarse, settings.typechart, settings.maxCountByImage))
+    {
+        // regions of interest at full resolution, around the coarse detections with a margin
+        const cv::Rect imageRect(0, 0, imgBGR.cols, imgBGR.rows);
+        std::vector<cv::Rect> regionsOfInterest;
+        for (const cv::Ptr<cv::mcc::CChecker>& cchecker : coarseDetector->getListColorChecker())
+        {
+            const cv::Rect box = cv::boundingRect(cchecker->getBox());
+            const double margin = 0.25 * std::max(box.width, box.height);
+            const cv::Point tl(cvFloor((box.x - margin) / scale), cvFloor((box.y - margin) / scale));
+            const cv::Point br(cvCeil((box.x + box.width + margin) / scale), cvCeil((box.y + box.height + margin) / scale));
+            regionsOfInterest.push_back(cv::Rect(tl, br) & imageRect);
+        }
+
+        if (detector->process(imgBGR, settings.typechart, regionsOfInterest, settings.maxCountByImage))
+            return true;
+    }
+
+    // the checkers may be too small to be detected on the downscaled image
+    return detector->process(imgBGR, settings.typechart, settings.maxCountByImage);
+}
+
+/**
+ * @brief Get the key of the detections of an image in the cache: the image, its last modification and the settings.
+ */
+std::string getCacheKey(const ImageOptions& imgOpt, const CCheckerDetectionSettings& settings)
+{
+    std::error_code ec;
+    std::ostringstream key;
+    key << imgOpt.imgFsPath.string() << "|" << fs::file_size(imgOpt.imgFsPath, ec) << "|"
+        << fs::last_write_time(imgOpt.imgFsPath, ec).time_since_epoch().count() << "|" << imgOpt.viewId << "|" << imgOpt.bodySerialNumber << "|"
+        << imgOpt.lensSerialNumber << "|" << static_cast<int>(settings.typechart) << "|" << settings.maxCountByImage << "|" << settings.coarseMaxSize;
+    return key.str();
+}
+
+fs::path getCachePath(const std::string& key, const CCheckerDetectionSettings& settings)
+{
+    std::ostringstream filename;
+    filename << std::hex << std::hash<std::string>()(key) << ".json";
+    return fs::path(settings.cacheFolder) / filename.str();
+}
+
+/**
+ * @brief Load the cached detections of an image.
+ * @return false if the image has no valid detections in the cache
+ */
+bool loadCachedDetections(const std::string& key, const CCheckerDetectionSettings& settings, std::vector<bpt::ptree>& detectedCCheckers)
+{
+    const fs::path cachePath = getCachePath(key, settings);
+    if (!fs::exists(cachePath))
+        return false;
+
+    try
+    {
+        bpt::ptree cache;
+        bpt::read_json(cachePath.string(), cache);
+        if (cache.get<std::string>("key", "") != key)
+            return false;
+
+        for (const auto& checker : cache.get_child("checkers"))
+            detectedCCheckers.push_back(checker.second);
+    }
+    catch (const bpt::ptree_error& e)
+    {
+        ALICEVISION_LOG_WARNING("Invalid color checker cache file '" << cachePath.string() << "': " << e.what());
+        detectedCCheckers.clear();
+        return false;
+    }
+    return true;
+}
+
+void saveCachedDetections(const std::string& key, const CCheckerDetectionSettings& settings, const std::vector<bpt::ptree>& detectedCCheckers)
+{
+    bpt::ptree cache, ptCheckers;
+    cache.put("key", key);
+    for (const auto& checker : detectedCCheckers)
+        ptCheckers.push_back(std::make_pair("", checker));
+    cache.add_child("checkers", ptCheckers);
+
+    bpt::write_json(getCachePath(key, settings).string(), cache);
+}
+
+void detectColorChecker(std::vector<bpt::ptree>& detectedCCheckers, const ImageOptions& imgOpt, const CCheckerDetectionSettings& settings)
 {
     const std::string outputFolder = fs::path(settings.outputData).parent_path().string() + "/";
     const std::string imgSrcPath = imgOpt.imgFsPath.string();
     const std::string imgSrcStem = imgOpt.imgFsPath.stem().string();
     const std::string imgDestStem = imgSrcStem;
 
+    // Reuse the detections of a previous run (the debug data are only written by an actual detection)
+    const bool useCache = !settings.cacheFolder.empty();
+    const std::string cacheKey = useCache ? getCacheKey(imgOpt, settings) : std::string();
+    if (useCache && !settings.debug && loadCachedDetections(cacheKey, settings, detectedCCheckers))
+    {
+        ALICEVISION_LOG_INFO(detectedCCheckers.size() << " checker(s) loaded from the cache for '" << imgSrcStem << "'");
+        return;
+    }
+
     // Load image
     image::Image<image::RGBAfColor> img;
     image::readImage(imgSrcPath, img, imgOpt.readOptions);
@@ -343,16 +462,17 @@ void detectColorChecker(std::vector<MacbethCCheckerQuad>& detectedCCheckers, Ima
 
     if (imgBGR.cols == 0 || imgBGR.rows == 0)
     {
-        ALICEVISION_LOG_ERROR("Image at: '" << imgSrcPath << "'.\n"
-                                            << "is empty.");
-        exit(EXIT_FAILURE);
+        ALICEVISION_THROW_ERROR("Image at: '" << imgSrcPath << "'.\n"
+                                              << "is empty.");
     }
 
     cv::Ptr<cv::mcc::CCheckerDetector> detector = cv::mcc::CCheckerDetector::create();
 
-    if (!detector->process(imgBGR, settings.typechart, settings.maxCountByImage))
+    if (!processDetection(detector, imgBGR, settings))
     {
         ALICEVISION_LOG_INFO("Checker not detected in image at: '" << imgSrcPath << "'");
+        if (useCache)
+            saveCachedDetections(cacheKey, settings, detectedCCheckers);
         return;
     }
 
@@ -365,7 +485,7 @@ void detectColorChecker(std::vector<MacbethCCheckerQuad>& detectedCCheckers, Ima
         ALICEVISION_LOG_INFO("Checker #" << counter << " successfully detected in '" << imgSrcStem << "'");
 
         MacbethCCheckerQuad ccq(cchecker, img, imgOpt);
-        detectedCCheckers.push_back(ccq);
+        detectedCCheckers.push_back(ccq.ptree());
 
         if (settings.debug)
         {
@@ -377,12 +497,15 @@ void detectColorChecker(std::vector<MacbethCCheckerQuad>& detectedCCheckers, Ima
             cv::imwrite(outputFolder + imgDestStem + counterStr + ".jpg", imgBGR);
 
             const std::string masksFolder = outputFolder + "masks/";
-            fs::create_directory(masksFolder);
+            fs::create_directories(masksFolder);
 
             for (int i = 0; i < ccq._cellMasks.size(); ++i)
                 cv::imwrite(masksFolder + imgDestStem + counterStr + "_" + std::to_string(i) + ".jpg", ccq._cellMasks[i]);
         }
     }
+
+    if (useCache)
+        saveCachedDetections(cacheKey, settings, detectedCCheckers);
 }
 
 int aliceVision_main(int argc, char** argv)
@@ -394,6 +517,8 @@ int aliceVision_main(int argc, char** argv)
     // user optional parameters
     bool debug = false;
     unsigned int maxCountByImage = 1;
+    int coarseMaxSize = 2048;
+    std::string cacheFolder;
 
     // clang-format off
     po::options_description inputParams("Required parameters");
@@ -409,7 +534,13 @@ int aliceVision_main(int argc, char** argv)
         ("debug", po::value<bool>(&debug),
          "Output debug data.")
         ("maxCount", po::value<unsigned int>(&maxCountByImage),
-         "Maximum color charts count to detect in a single image.");
+         "Maximum color charts count to detect in a single image.")
+        ("coarseMaxSize", po::value<int>(&coarseMaxSize)->default_value(coarseMaxSize),
+         "Maximum size of the downscaled image of the coarse detection, refined on the full resolution image "
+         "around the detected charts (0 to detect on the full resolution image only).")
+        ("cacheFolder", po::value<std::string>(&cacheFolder)->default_value(cacheFolder),
+         "Folder in which the detections of each image are cached, to be reused when the image and the settings "
+         "did not change (empty to disable the cache).");
     // clang-format on
 
     CmdLine cmdline("This program is used to perform Macbeth color checker chart detection.\n"
@@ -426,8 +557,13 @@ int aliceVision_main(int argc, char** argv)
     settings.maxCountByImage = maxCountByImage;
     settings.outputData = outputData;
     settings.debug = debug;
+    settings.coarseMaxSize = coarseMaxSize;
+    settings.cacheFolder = cacheFolder;
+
+    if (!cacheFolder.empty())
+        fs::create_directories(cacheFolder);
 
-    std::vector<MacbethCCheckerQuad> detectedCCheckers;
+    std::vector<ImageOptions> images;
 
     // Check if inputExpression is recognized as sfm data file
     const std::string inputExt = boost::to_lower_copy(fs::path(inputExpression).extension().string());
@@ -442,21 +578,17 @@ int aliceVision_main(int argc, char** argv)
             return EXIT_FAILURE;
         }
 
-        int counter = 0;
-
-        // Detect color checker for each images
         for (const auto& viewIt : sfmData.getViews())
         {
             const sfmData::View& view = *(viewIt.second);
 
-            ALICEVISION_LOG_INFO(++counter << "/" << sfmData.getViews().size() << " - Process image at: '" << view.getImage().getImagePath() << "'.");
             ImageOptions imgOpt = {view.getImage().getImagePath(),
                                    std::to_string(view.getViewId()),
                                    view.getImage().getMetadataBodySerialNumber(),
                                    view.getImage().getMetadataLensSerialNumber()};
             imgOpt.readOptions.workingColorSpace = image::EImageColorSpace::SRGB;
             imgOpt.readOptions.rawColorInterpretation = image::ERawColorInterpretation_stringToEnum(view.getImage().getRawColorInterpretation());
-            detectColorChecker(detectedCCheckers, imgOpt, settings);
+            images.push_back(imgOpt);
         }
     }
     else
@@ -493,15 +625,61 @@ int aliceVision_main(int argc, char** argv)
             ALICEVISION_LOG_INFO(size << " images found.");
         }
 
-        int counter = 0;
         for (const std::string& imgSrcPath : filesStrPaths)
         {
-            ALICEVISION_LOG_INFO(++counter << "/" << size << " - Process image at: '" << imgSrcPath << "'.");
             ImageOptions imgOpt;
             imgOpt.imgFsPath = imgSrcPath;
             imgOpt.readOptions.workingColorSpace = image::EImageColorSpace::SRGB;
-            detectColorChecker(detectedCCheckers, imgOpt, settings);
+            images.push_back(imgOpt);
+        }
+    }
+
+    // Detect the color checkers of the images in parallel, as many at once as the memory allows
+    // (float RGBA image, 8 bits BGR image and downscaled image)
+    const HardwareContext hwc = cmdline.getHardwareContext();
+    std::size_t maxImageMemory = 1;
+    if (!images.empty())
+    {
+        int width = 0, height = 0;
+        image::readImageSize(images.front().imgFsPath.string(), width, height);
+        maxImageMemory = std::max<std::size_t>(1, static_cast<std::size_t>(width) * height * (sizeof(image::RGBAfColor) + 2 * 3));
+    }
+    const int nbParallelImages =
+      std::max(1, std::min(static_cast<int>(hwc.getMaxThreads()), static_cast<int>(hwc.getMaxMemory() / maxImageMemory)));
+    ALICEVISION_LOG_INFO("Processing " << images.size() << " images, " << nbParallelImages << " at once");
+
+    // the threads of OpenCV are shared between the images processed at once
+    cv::setNumThreads(std::max(1, static_cast<int>(hwc.getMaxThreads()) / nbParallelImages));
+
+    std::vector<std::vector<bpt::ptree>> imagesCCheckers(images.size());
+    std::atomic<int> counter(0);
+    std::exception_ptr exception;
+
+#pragma omp parallel for num_threads(nbParallelImages) schedule(dynamic)
+    for (int i = 0; i < static_cast<int>(images.size()); ++i)
+    {
+        try
+        {
+            ALICEVISION_LOG_INFO(++counter << "/" << images.size() << " - Process image at: '" << images[i].imgFsPath.string() << "'.");
+            detectColorChecker(imagesCCheckers[i], images[i], settings);
         }
+        catch (...)
+        {
+#pragma omp critical(colorCheckerDetectionException)
+            if (!exception)
+                exception = std::current_exception();
+        }
+    }
+
+    if (exception)
+        std::rethrow_exception(exception);
+
+    // keep the order of the input images
+    std::vector<bpt::ptree> detectedCCheckers;
+    for (std::vector<bpt::ptree>& imageCCheckers : imagesCCheckers)
+    {
+        for (bpt::ptree& cchecker : imageCCheckers)
+            detectedCCheckers.push_back(std::move(cchecker));
     }
 
     if (detectedCCheckers.empty())
@@ -515,7 +693,7 @@ int aliceVision_main(int argc, char** argv)
     bpt::ptree data, ptCheckers;
     for (const auto& cchecker : detectedCCheckers)
     {
-        ptCheckers.push_back(std::make_pair("", cchecker.ptree()));
+        ptCheckers.push_back(std::make_pair("", cchecker));
     }
     data.add_child("checkers", ptCheckers);
 
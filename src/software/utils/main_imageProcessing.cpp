@@ -5,6 +5,7 @@
 // You can obtain one at https://mozilla.org/MPL/2.0/.
 
 #include <aliceVision/image/all.hpp>
+#include <aliceVision/camera/UndistortionMap.hpp>
 #include <aliceVision/cmdline/cmdline.hpp>
 #include <aliceVision/system/Logger.hpp>
 #include <aliceVision/system/main.hpp>
@@ -18,6 +19,7 @@
 #include <aliceVision/utils/filesIO.hpp>
 #include <aliceVision/stl/mapUtils.hpp>
 #include <aliceVision/lensCorrectionProfile/lcp.hpp>
+#include <aliceVision/lensCorrectionProfile/correctionMaps.hpp>
 
 #include <boost/program_options.hpp>
 #include <boost/algorithm/string.hpp>
@@ -33,6 +35,7 @@
 #include <OpenImageIO/imagebufalgo.h>
 #include <OpenImageIO/color.h>
 
+#include <atomic>
 #include <filesystem>
 #include <string>
 #include <cmath>
@@ -44,7 +47,7 @@
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 3
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 3
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 4
 
 using namespace aliceVision;
 namespace po = boost::program_options;
@@ -358,6 +361,7 @@ struct ProcessingParams
     bool reconstructedViewsOnly = false;
     bool keepImageFilename = false;
     bool exposureCompensation = false;
+    float exposureFactor = 1.0f;
     bool rawAutoBright = false;
     float rawExposureAdjust = 0.0;
     EImageFormat outputFormat = EImageFormat::RGBA;
@@ -424,36 +428,33 @@ struct ProcessingParams
     };
 };
 
-void undistortVignetting(aliceVision::image::Image<aliceVision::image::RGBAfColor>& img, const std::vector<float>& vparam)
+void compensateExposure(aliceVision::image::Image<aliceVision::image::RGBAfColor>& img, float compensationFactor)
 {
-    if (vparam.size() >= 7)
-    {
-        const float focX = vparam[0];
-        const float focY = vparam[1];
-        const float imageXCenter = vparam[2];
-        const float imageYCenter = vparam[3];
-
-        const float p1 = -vparam[4];
-        const float p2 = vparam[4] * vparam[4] - vparam[5];
-        const float p3 = -(vparam[4] * vparam[4] * vparam[4] - 2 * vparam[4] * vparam[5] + vparam[6]);
-        const float p4 =
-          vparam[4] * vparam[4] * vparam[4] * vparam[4] + vparam[5] * vparam[5] + 2 * vparam[4] * vparam[6] - 3 * vparam[4] * vparam[4] * vparam[5];
-
 #pragma omp parallel for
-        for (int j = 0; j < img.height(); ++j)
-            for (int i = 0; i < img.width(); ++i)
-            {
-                const aliceVision::Vec2 p(i, j);
-
-                aliceVision::Vec2 np;
-                np(0) = ((p(0) / img.width()) - imageXCenter) / focX;
-                np(1) = ((p(1) / img.height()) - imageYCenter) / focY;
-
-                const float rsqr = np(0) * np(0) + np(1) * np(1);
-                const float gain = 1.f + p1 * rsqr + p2 * rsqr * rsqr + p3 * rsqr * rsqr * rsqr + p4 * rsqr * rsqr * rsqr * rsqr;
+    for (int i = 0; i < img.width() * img.height(); ++i)
+    {
+        img(i)[0] *= compensationFactor;
+        img(i)[1] *= compensationFactor;
+        img(i)[2] *= compensationFactor;
+    }
+}
 
-                img(j, i) *= gain;
-            }
+void undistortVignetting(aliceVision::image::Image<aliceVision::image::RGBAfColor>& img,
+                         const std::vector<float>& vparam,
+                         float compensationFactor = 1.0f)
+{
+    if (VignettingMap::isValid(vparam))
+    {
+        // the gain map is computed once and shared by the images of the same lens settings
+        const std::shared_ptr<const VignettingMap> vignettingMap = LensCorrectionMapCache::get().getVignettingMap(vparam, img.width(), img.height());
+        if (compensationFactor != 1.0f)
+        {
+            vignettingMap->apply(img, compensationFactor);
+        }
+        else
+        {
+            vignettingMap->apply(img);
+        }
     }
 }
 
@@ -507,56 +508,10 @@ void undistortChromaticAberrations(const aliceVision::image::Image<aliceVision::
 {
     if (!greenModel.isEmpty && greenModel.FocalLengthX != 0.0 && greenModel.FocalLengthY != 0.0)
     {
-        img_ud.resize(img.width(), img.height(), true, fillcolor);
-        const image::Sampler2d<image::SamplerLinear> sampler;
-
-        const float maxWH = std::max(img.width(), img.height());
-        const float ppX = greenModel.ImageXCenter * img.width();
-        const float ppY = greenModel.ImageYCenter * img.height();
-        const float scaleX = greenModel.FocalLengthX * maxWH;
-        const float scaleY = greenModel.FocalLengthY * maxWH;
-
-#pragma omp parallel for
-        for (int v = 0; v < img.height(); ++v)
-            for (int u = 0; u < img.width(); ++u)
-            {
-                // image to camera
-                const float x = (u - ppX) / scaleX;
-                const float y = (v - ppY) / scaleY;
-
-                // disto
-                float xdRed, ydRed, xdGreen, ydGreen, xdBlue, ydBlue;
-                if (undistortGeometry)
-                {
-                    greenModel.distort(x, y, xdGreen, ydGreen);
-                }
-                else
-                {
-                    xdGreen = x;
-                    ydGreen = y;
-                }
-                redGreenModel.distort(xdGreen, ydGreen, xdRed, ydRed);
-                blueGreenModel.distort(xdGreen, ydGreen, xdBlue, ydBlue);
-
-                // camera to image
-                const Vec2 distoPixRed(xdRed * scaleX + ppX, ydRed * scaleY + ppY);
-                const Vec2 distoPixGreen(xdGreen * scaleX + ppX, ydGreen * scaleY + ppY);
-                const Vec2 distoPixBlue(xdBlue * scaleX + ppX, ydBlue * scaleY + ppY);
-
-                // pick pixel if it is in the image domain
-                if (img.contains(distoPixRed(1), distoPixRed(0)))
-                {
-                    img_ud(v, u)[0] = sampler(img, distoPixRed(1), distoPixRed(0))[0];
-                }
-                if (img.contains(distoPixGreen(1), distoPixGreen(0)))
-                {
-                    img_ud(v, u)[1] = sampler(img, distoPixGreen(1), distoPixGreen(0))[1];
-                }
-                if (img.contains(distoPixBlue(1), distoPixBlue(0)))
-                {
-                    img_ud(v, u)[2] = sampler(img, distoPixBlue(1), distoPixBlue(0))[2];
-                }
-            }
+        // the source positions of the channels are computed once and shared by the images of the same lens settings
+        const std::shared_ptr<const ChromaticAberrationMap> caMap = LensCorrectionMapCache::get().getChromaticAberrationMap(
+          greenModel, blueGreenModel, redGreenModel, img.width(), img.height(), undistortGeometry);
+        caMap->remap(img, img_ud, fillcolor);
     }
 }
 
@@ -567,6 +522,16 @@ void processImage(image::Image<image::RGBAfColor>& image,
 {
     const unsigned int nchannels = 4;
 
+    // The exposure compensation is done in the same pass as the vignetting correction when no other operation is applied in between
+    const bool fuseExposureVignetting = pParams.exposureFactor != 1.0f && !(pParams.fixNonFinite || pParams.fillHoles) &&
+                                        pParams.lensCorrection.enabled && pParams.lensCorrection.vignetting &&
+                                        VignettingMap::isValid(pParams.lensCorrection.vParams);
+
+    if (pParams.exposureFactor != 1.0f && !fuseExposureVignetting)
+    {
+        compensateExposure(image, pParams.exposureFactor);
+    }
+
     // Fix non-finite pixels
     // Note: fill holes needs to fix non-finite values first
     if (pParams.fixNonFinite || pParams.fillHoles)
@@ -582,7 +547,7 @@ void processImage(image::Image<image::RGBAfColor>& image,
     {
         if (pParams.lensCorrection.vignetting && !pParams.lensCorrection.vParams.empty())
         {
-            undistortVignetting(image, pParams.lensCorrection.vParams);
+            undistortVignetting(image, pParams.lensCorrection.vParams, fuseExposureVignetting ? pParams.exposureFactor : 1.0f);
         }
         else if (pParams.lensCorrection.vignetting && pParams.lensCorrection.vParams.empty())
         {
@@ -595,7 +560,7 @@ void processImage(image::Image<image::RGBAfColor>& image,
             image::Image<image::RGBAfColor> image_ud;
             undistortChromaticAberrations(
               image, pParams.lensCorrection.caGModel, pParams.lensCorrection.caBGModel, pParams.lensCorrection.caRGModel, image_ud, FBLACK_A, false);
-            image = image_ud;
+            image.swap(image_ud);
         }
         else if (pParams.lensCorrection.chromaticAberration && pParams.lensCorrection.caGModel.isEmpty)
         {
@@ -606,13 +571,13 @@ void processImage(image::Image<image::RGBAfColor>& image,
         {
             const image::RGBAfColor FBLACK_A(.0f, .0f, .0f, 1.0f);
             image::Image<image::RGBAfColor> image_ud;
-            const image::Sampler2d<image::SamplerLinear> sampler;
 
-            image_ud.resize(image.width(), image.height(), true, FBLACK_A);
+            // the undistortion map is computed once and shared by the images of the same intrinsic
+            const std::shared_ptr<const camera::UndistortionMap> undistortionMap =
+              camera::UndistortionMapCache::get().getMap(*cam, image.width(), image.height());
+            undistortionMap->remap(image, image_ud, FBLACK_A);
 
-            camera::UndistortImage(image, cam.get(), image_ud, FBLACK_A);
-
-            image = image_ud;
+            image.swap(image_ud);
         }
         else if (pParams.lensCorrection.geometry && cam != NULL && !cam->hasDistortion())
         {
@@ -1020,6 +985,7 @@ int aliceVision_main(int argc, char* argv[])
     std::string lensCorrectionProfileInfo;
     bool lensCorrectionProfileSearchIgnoreCameraModel = true;
     std::string sensorDatabasePath;
+    int parallelImages = 1;
 
     ProcessingParams pParams;
 
@@ -1209,7 +1175,11 @@ int aliceVision_main(int argc, char* argv[])
          "JPEG quality after compression (between 0 and 100).")
 
         ("extension", po::value<std::string>(&extension)->default_value(extension),
-         "Output image extension (like exr, or empty to keep the source file format.");
+         "Output image extension (like exr, or empty to keep the source file format.")
+
+        ("parallelImages", po::value<int>(&parallelImages)->default_value(parallelImages),
+         "Number of images processed at the same time (the processing of each image is then single threaded). "
+         "Increases the throughput on large batches of small images, at the cost of the memory of several images.");
     // clang-format on
 
     CmdLine cmdline("AliceVision imageProcessing");
@@ -1228,6 +1198,12 @@ int aliceVision_main(int argc, char* argv[])
         return EXIT_FAILURE;
     }
 
+    if (parallelImages < 1)
+    {
+        ALICEVISION_LOG_ERROR("Invalid option: parallelImages must be greater than 0.");
+        return EXIT_FAILURE;
+    }
+
 #if !ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_OPENCV)
     if (pParams.bilateralFilter.enabled || pParams.claheFilter.enabled || pParams.nlmFilter.enabled)
     {
@@ -1298,15 +1274,30 @@ int aliceVision_main(int argc, char* argv[])
             }
         }
 
-        const int size = ViewPaths.size();
-        int i = 0;
+        const std::vector<std::pair<IndexT, std::string>> viewPathsList(ViewPaths.begin(), ViewPaths.end());
+        const int size = viewPathsList.size();
 
-        for (auto& viewIt : ViewPaths)
+        // The rescale of the intrinsics uses the pixel aspect ratio of the last view
+        if (pParams.par.enabled && size > 0)
         {
-            const IndexT viewId = viewIt.first;
-            const std::string viewPath = viewIt.second;
+            const sfmData::View& lastView = sfmData.getView(viewPathsList.back().first);
+            const std::shared_ptr<camera::IntrinsicBase> lastCam = sfmData.getIntrinsics().at(lastView.getIntrinsicId());
+            pParams.par.value = lastCam->getParams()[1] / lastCam->getParams()[0];
+        }
+
+        const double medianCameraExposure = pParams.exposureCompensation ? sfmData.getMedianCameraExposureSetting().getExposure() : 1.0;
+
+        // Each view is processed with its own copy of the parameters
+#pragma omp parallel for schedule(dynamic) num_threads(parallelImages) if (parallelImages > 1)
+        for (int i = 0; i < size; ++i)
+        {
+            const IndexT viewId = viewPathsList[i].first;
+            const std::string& viewPath = viewPathsList[i].second;
             sfmData::View& view = sfmData.getView(viewId);
 
+            ProcessingParams viewParams = pParams;
+            image::EImageColorSpace viewWorkingColorSpace = workingColorSpace;
+
             const bool isRAW = image::isRawFormat(viewPath);
 
             const fs::path fsPath = viewPath;
@@ -1314,19 +1305,19 @@ int aliceVision_main(int argc, char* argv[])
             const std::string fileExt = fsPath.extension().string();
             const std::string outputExt = extension.empty() ? (isRAW ? ".exr" : fileExt) : (std::string(".") + extension);
             const std::string outputfilePath =
-              (fs::path(outputPath) / ((pParams.keepImageFilename ? fileName : std::to_string(viewId)) + outputExt)).generic_string();
+              (fs::path(outputPath) / ((viewParams.keepImageFilename ? fileName : std::to_string(viewId)) + outputExt)).generic_string();
 
-            ALICEVISION_LOG_INFO(++i << "/" << size << " - Process view '" << viewId << "'.");
+            ALICEVISION_LOG_INFO(i + 1 << "/" << size << " - Process view '" << viewId << "'.");
 
             auto metadata = view.getImage().getMetadata();
 
-            if (pParams.applyDcpMetadata && metadata["AliceVision:ColorSpace"] != "no_conversion")
+            if (viewParams.applyDcpMetadata && metadata["AliceVision:ColorSpace"] != "no_conversion")
             {
                 ALICEVISION_LOG_WARNING("A dcp profile will be applied on an image containing non raw data!");
             }
 
             image::ImageReadOptions options;
-            options.workingColorSpace = pParams.applyDcpMetadata ? image::EImageColorSpace::NO_CONVERSION : workingColorSpace;
+            options.workingColorSpace = viewParams.applyDcpMetadata ? image::EImageColorSpace::NO_CONVERSION : viewWorkingColorSpace;
 
             if (isRAW)
             {
@@ -1353,52 +1344,53 @@ int aliceVision_main(int argc, char* argv[])
                 options.colorProfileFileName = view.getImage().getColorProfileFileName();
                 options.demosaicingAlgo = demosaicingAlgo;
                 options.highlightMode = highlightMode;
-                options.rawExposureAdjustment = std::pow(2.f, pParams.rawExposureAdjust);
-                options.rawAutoBright = pParams.rawAutoBright;
+                options.rawExposureAdjustment = std::pow(2.f, viewParams.rawExposureAdjust);
+                options.rawAutoBright = viewParams.rawAutoBright;
                 options.correlatedColorTemperature = correlatedColorTemperature;
-                pParams.correlatedColorTemperature = correlatedColorTemperature;
-                pParams.enableColorTempProcessing = options.rawColorInterpretation == image::ERawColorInterpretation::DcpLinearProcessing;
+                viewParams.correlatedColorTemperature = correlatedColorTemperature;
+                viewParams.enableColorTempProcessing = options.rawColorInterpretation == image::ERawColorInterpretation::DcpLinearProcessing;
             }
             else
             {
                 options.inputColorSpace = inputColorSpace;
             }
 
-            if (pParams.lensCorrection.enabled && pParams.lensCorrection.vignetting)
+            if (viewParams.lensCorrection.enabled && viewParams.lensCorrection.vignetting)
             {
-                if (!view.getImage().getVignettingParams(pParams.lensCorrection.vParams))
+                if (!view.getImage().getVignettingParams(viewParams.lensCorrection.vParams))
                 {
-                    pParams.lensCorrection.vParams.clear();
+                    viewParams.lensCorrection.vParams.clear();
                 }
             }
 
-            if (pParams.lensCorrection.enabled && pParams.lensCorrection.chromaticAberration)
+            if (viewParams.lensCorrection.enabled && viewParams.lensCorrection.chromaticAberration)
             {
                 std::vector<float> caGParams, caBGParams, caRGParams;
                 view.getImage().getChromaticAberrationParams(caGParams, caBGParams, caRGParams);
 
-                pParams.lensCorrection.caGModel.init3(caGParams);
-                pParams.lensCorrection.caBGModel.init3(caBGParams);
-                pParams.lensCorrection.caRGModel.init3(caRGParams);
+                viewParams.lensCorrection.caGModel.init3(caGParams);
+                viewParams.lensCorrection.caBGModel.init3(caBGParams);
+                viewParams.lensCorrection.caRGModel.init3(caRGParams);
 
-                if (pParams.lensCorrection.caGModel.FocalLengthX == 0.0)
+                if (viewParams.lensCorrection.caGModel.FocalLengthX == 0.0)
                 {
                     float sensorWidth = view.getImage().getSensorWidth();
-                    pParams.lensCorrection.caGModel.FocalLengthX = view.getImage().getWidth() * view.getImage().getMetadataFocalLength() /
-                                                                   sensorWidth / std::max(view.getImage().getWidth(), view.getImage().getHeight());
+                    viewParams.lensCorrection.caGModel.FocalLengthX = view.getImage().getWidth() * view.getImage().getMetadataFocalLength() /
+                                                                      sensorWidth / std::max(view.getImage().getWidth(), view.getImage().getHeight());
                 }
-                if (pParams.lensCorrection.caGModel.FocalLengthY == 0.0)
+                if (viewParams.lensCorrection.caGModel.FocalLengthY == 0.0)
                 {
                     float sensorHeight = view.getImage().getSensorHeight();
-                    pParams.lensCorrection.caGModel.FocalLengthY = view.getImage().getHeight() * view.getImage().getMetadataFocalLength() /
-                                                                   sensorHeight / std::max(view.getImage().getWidth(), view.getImage().getHeight());
+                    viewParams.lensCorrection.caGModel.FocalLengthY =
+                      view.getImage().getHeight() * view.getImage().getMetadataFocalLength() / sensorHeight /
+                      std::max(view.getImage().getWidth(), view.getImage().getHeight());
                 }
 
-                if ((pParams.lensCorrection.caGModel.FocalLengthX <= 0.0) || (pParams.lensCorrection.caGModel.FocalLengthY <= 0.0))
+                if ((viewParams.lensCorrection.caGModel.FocalLengthX <= 0.0) || (viewParams.lensCorrection.caGModel.FocalLengthY <= 0.0))
                 {
-                    pParams.lensCorrection.caGModel.reset();
-                    pParams.lensCorrection.caBGModel.reset();
-                    pParams.lensCorrection.caRGModel.reset();
+                    viewParams.lensCorrection.caGModel.reset();
+                    viewParams.lensCorrection.caBGModel.reset();
+                    viewParams.lensCorrection.caRGModel.reset();
                 }
             }
 
@@ -1409,42 +1401,38 @@ int aliceVision_main(int argc, char* argv[])
             // If exposureCompensation is needed for sfmData files
             if (pParams.exposureCompensation)
             {
-                const double medianCameraExposure = sfmData.getMedianCameraExposureSetting().getExposure();
                 const double cameraExposure = view.getImage().getCameraExposureSetting().getExposure();
                 const double ev = std::log2(1.0 / cameraExposure);
                 const float compensationFactor = static_cast<float>(medianCameraExposure / cameraExposure);
 
                 ALICEVISION_LOG_INFO("View: " << viewId << ", Ev: " << ev << ", Ev compensation: " << compensationFactor);
 
-                for (int i = 0; i < image.width() * image.height(); ++i)
-                {
-                    image(i)[0] *= compensationFactor;
-                    image(i)[1] *= compensationFactor;
-                    image(i)[2] *= compensationFactor;
-                }
+                // applied by processImage, with the vignetting correction if possible
+                viewParams.exposureFactor = compensationFactor;
             }
 
-            sfmData::Intrinsics::const_iterator iterIntrinsic = sfmData.getIntrinsics().find(view.getIntrinsicId());
-            std::shared_ptr<camera::IntrinsicBase> cam = iterIntrinsic->second;
+            std::shared_ptr<camera::IntrinsicBase> cam;
+#pragma omp critical(intrinsics)
+            cam = sfmData.getIntrinsics().at(view.getIntrinsicId());
 
             std::map<std::string, std::string> viewMetadata = view.getImage().getMetadata();
 
-            if (pParams.par.enabled)
+            if (viewParams.par.enabled)
             {
-                pParams.par.value = cam->getParams()[1] / cam->getParams()[0];
+                viewParams.par.value = cam->getParams()[1] / cam->getParams()[0];
             }
 
             // Image processing
-            processImage(image, pParams, viewMetadata, cam);
+            processImage(image, viewParams, viewMetadata, cam);
 
-            if (pParams.applyDcpMetadata)
+            if (viewParams.applyDcpMetadata)
             {
-                workingColorSpace = image::EImageColorSpace::ACES2065_1;
+                viewWorkingColorSpace = image::EImageColorSpace::ACES2065_1;
             }
 
             image::ImageWriteOptions writeOptions;
 
-            writeOptions.fromColorSpace(workingColorSpace);
+            writeOptions.fromColorSpace(viewWorkingColorSpace);
             writeOptions.toColorSpace(outputColorSpace);
             writeOptions.exrCompressionMethod(exrCompressionMethod);
             writeOptions.exrCompressionLevel(exrCompressionLevel);
@@ -1468,7 +1456,8 @@ int aliceVision_main(int argc, char* argv[])
             if (viewMetadata.find("Orientation") != viewMetadata.end())
                 view.getImage().addMetadata("Orientation", viewMetadata.at("Orientation"));
 
-            if (pParams.reorient && image.width() != cam->w() && image.width() == cam->h())  // The image has been rotated by automatic reorientation
+            // The image has been rotated by automatic reorientation
+            if (viewParams.reorient && image.width() != cam->w() && image.width() == cam->h())
             {
                 camera::IntrinsicBase* cam2 = cam->clone();
 
@@ -1480,6 +1469,7 @@ int aliceVision_main(int argc, char* argv[])
 
                 IndexT intrinsicId = cam2->hashValue();
                 view.setIntrinsicId(intrinsicId);
+#pragma omp critical(intrinsics)
                 sfmData.getIntrinsics().emplace(intrinsicId, cam2);
             }
         }
@@ -1579,9 +1569,17 @@ int aliceVision_main(int argc, char* argv[])
             }
         }
 
-        int i = 0;
-        for (const std::string& inputFilePath : filesStrPaths)
+        std::atomic<bool> succeeded(true);
+
+        // Each image is processed with its own copy of the parameters
+#pragma omp parallel for schedule(dynamic) num_threads(parallelImages) if (parallelImages > 1)
+        for (int i = 0; i < size; ++i)
         {
+            const std::string& inputFilePath = filesStrPaths[i];
+
+            ProcessingParams imageParams = pParams;
+            image::EImageColorSpace imageWorkingColorSpace = workingColorSpace;
+
             const bool isRAW = image::isRawFormat(inputFilePath);
 
             const fs::path path = fs::path(inputFilePath);
@@ -1589,7 +1587,7 @@ int aliceVision_main(int argc, char* argv[])
             const std::string fileExt = path.extension().string();
             const std::string outputExt = extension.empty() ? (isRAW ? ".exr" : fileExt) : (std::string(".") + extension);
 
-            ALICEVISION_LOG_INFO(++i << "/" << size << " - Process image '" << filename << fileExt << "'.");
+            ALICEVISION_LOG_INFO(i + 1 << "/" << size << " - Process image '" << filename << fileExt << "'.");
 
             const std::string userExt = fs::path(outputPath).extension().string();
             std::string outputFilePath;
@@ -1627,16 +1625,23 @@ int aliceVision_main(int argc, char* argv[])
             if (isRAW && (rawColorInterpretation == image::ERawColorInterpretation::DcpLinearProcessing ||
                           rawColorInterpretation == image::ERawColorInterpretation::DcpMetadata))
             {
-                // Load DCP color profiles database if not already loaded
-                dcpDatabase.load(colorProfileDatabaseDirPath.empty() ? getColorProfileDatabaseFolder() : colorProfileDatabaseDirPath, false);
+                bool dcpFound = false;
+#pragma omp critical(dcp)
+                {
+                    // Load DCP color profiles database if not already loaded
+                    dcpDatabase.load(colorProfileDatabaseDirPath.empty() ? getColorProfileDatabaseFolder() : colorProfileDatabaseDirPath, false);
 
-                // Get DCP profile
-                if (!dcpDatabase.retrieveDcpForCamera(make, model, dcpProf))
+                    // Get DCP profile
+                    dcpFound = dcpDatabase.retrieveDcpForCamera(make, model, dcpProf);
+                }
+
+                if (!dcpFound)
                 {
                     if (errorOnMissingColorProfile)
                     {
                         ALICEVISION_LOG_ERROR("The specified DCP database does not contain an appropriate profil for DSLR " << make << " " << model);
-                        return EXIT_FAILURE;
+                        succeeded = false;
+                        continue;
                     }
                     else
                     {
@@ -1648,13 +1653,14 @@ int aliceVision_main(int argc, char* argv[])
                 view.getImage().addDCPMetadata(dcpProf);
             }
 
-            if (isRAW && pParams.lensCorrection.enabled &&
-                (pParams.lensCorrection.geometry || pParams.lensCorrection.vignetting || pParams.lensCorrection.chromaticAberration))
+            if (isRAW && imageParams.lensCorrection.enabled &&
+                (imageParams.lensCorrection.geometry || imageParams.lensCorrection.vignetting || imageParams.lensCorrection.chromaticAberration))
             {
                 // try to find an appropriate Lens Correction Profile
                 LCPinfo* lcpData = nullptr;
                 if (lcpStore.size() == 1)
                 {
+#pragma omp critical(lcp)
                     lcpData = lcpStore.retrieveLCP();
                 }
                 else if (!lcpStore.empty())
@@ -1687,14 +1693,14 @@ int aliceVision_main(int argc, char* argv[])
                     camera::EInitMode intrinsicInitMode = camera::EInitMode::UNKNOWN;
                     view.getImage().getSensorSize(sensorDatabase, sensorWidth, sensorHeight, focalLengthmm, intrinsicInitMode, true);
 
-                    if (lensParam.hasVignetteParams() && !lensParam.vignParams.isEmpty && pParams.lensCorrection.vignetting)
+                    if (lensParam.hasVignetteParams() && !lensParam.vignParams.isEmpty && imageParams.lensCorrection.vignetting)
                     {
                         float FocX = lensParam.vignParams.FocalLengthX != 0.0 ? lensParam.vignParams.FocalLengthX
                                                                               : width * focalLengthmm / sensorWidth / std::max(width, height);
                         float FocY = lensParam.vignParams.FocalLengthY != 0.0 ? lensParam.vignParams.FocalLengthY
                                                                               : height * focalLengthmm / sensorHeight / std::max(width, height);
 
-                        pParams.lensCorrection.vParams.clear();
+                        imageParams.lensCorrection.vParams.clear();
 
                         if (FocX == 0.0 || FocY == 0.0)
                         {
@@ -1702,17 +1708,17 @@ int aliceVision_main(int argc, char* argv[])
                         }
                         else
                         {
-                            pParams.lensCorrection.vParams.push_back(FocX);
-                            pParams.lensCorrection.vParams.push_back(FocY);
-                            pParams.lensCorrection.vParams.push_back(lensParam.vignParams.ImageXCenter);
-                            pParams.lensCorrection.vParams.push_back(lensParam.vignParams.ImageYCenter);
-                            pParams.lensCorrection.vParams.push_back(lensParam.vignParams.VignetteModelParam1);
-                            pParams.lensCorrection.vParams.push_back(lensParam.vignParams.VignetteModelParam2);
-                            pParams.lensCorrection.vParams.push_back(lensParam.vignParams.VignetteModelParam3);
+                            imageParams.lensCorrection.vParams.push_back(FocX);
+                            imageParams.lensCorrection.vParams.push_back(FocY);
+                            imageParams.lensCorrection.vParams.push_back(lensParam.vignParams.ImageXCenter);
+                            imageParams.lensCorrection.vParams.push_back(lensParam.vignParams.ImageYCenter);
+                            imageParams.lensCorrection.vParams.push_back(lensParam.vignParams.VignetteModelParam1);
+                            imageParams.lensCorrection.vParams.push_back(lensParam.vignParams.VignetteModelParam2);
+                            imageParams.lensCorrection.vParams.push_back(lensParam.vignParams.VignetteModelParam3);
                         }
                     }
 
-                    if (pParams.lensCorrection.chromaticAberration && lensParam.hasChromaticParams() && !lensParam.ChromaticGreenParams.isEmpty)
+                    if (imageParams.lensCorrection.chromaticAberration && lensParam.hasChromaticParams() && !lensParam.ChromaticGreenParams.isEmpty)
                     {
                         if (lensParam.ChromaticGreenParams.FocalLengthX == 0.0)
                         {
@@ -1725,21 +1731,21 @@ int aliceVision_main(int argc, char* argv[])
 
                         if (lensParam.ChromaticGreenParams.FocalLengthX == 0.0 || lensParam.ChromaticGreenParams.FocalLengthY == 0.0)
                         {
-                            pParams.lensCorrection.caGModel.reset();
-                            pParams.lensCorrection.caBGModel.reset();
-                            pParams.lensCorrection.caRGModel.reset();
+                            imageParams.lensCorrection.caGModel.reset();
+                            imageParams.lensCorrection.caBGModel.reset();
+                            imageParams.lensCorrection.caRGModel.reset();
 
                             ALICEVISION_LOG_WARNING("Chromatic Aberration correction is requested but cannot be applied due to missing info.");
                         }
                         else
                         {
-                            pParams.lensCorrection.caGModel = lensParam.ChromaticGreenParams;
-                            pParams.lensCorrection.caBGModel = lensParam.ChromaticBlueGreenParams;
-                            pParams.lensCorrection.caRGModel = lensParam.ChromaticRedGreenParams;
+                            imageParams.lensCorrection.caGModel = lensParam.ChromaticGreenParams;
+                            imageParams.lensCorrection.caBGModel = lensParam.ChromaticBlueGreenParams;
+                            imageParams.lensCorrection.caRGModel = lensParam.ChromaticRedGreenParams;
                         }
                     }
 
-                    if (pParams.lensCorrection.geometry)
+                    if (imageParams.lensCorrection.geometry)
                     {
                         // build intrinsic
                         const camera::EINTRINSIC defaultCameraModel = camera::EINTRINSIC::PINHOLE_CAMERA;
@@ -1761,7 +1767,7 @@ int aliceVision_main(int argc, char* argv[])
                                                                     defaultCameraModel,
                                                                     defaultDistortionModel);
 
-                        pParams.lensCorrection.geometryModel = lensParam.perspParams;
+                        imageParams.lensCorrection.geometryModel = lensParam.perspParams;
                     }
                 }
                 else
@@ -1773,12 +1779,12 @@ int aliceVision_main(int argc, char* argv[])
 
             std::map<std::string, std::string> md = view.getImage().getMetadata();
 
-            pParams.par.value = 1.0;
-            if (pParams.par.enabled)
+            imageParams.par.value = 1.0;
+            if (imageParams.par.enabled)
             {
                 double pixelAspectRatio = 1.0;
                 view.getImage().getDoubleMetadata({"PixelAspectRatio"}, pixelAspectRatio);
-                pParams.par.value = pixelAspectRatio;
+                imageParams.par.value = pixelAspectRatio;
                 md["PixelAspectRatio"] = "1.0";
             }
 
@@ -1799,7 +1805,7 @@ int aliceVision_main(int argc, char* argv[])
                     readOptions.rawColorInterpretation = rawColorInterpretation;
                 }
 
-                if (pParams.applyDcpMetadata && md["AliceVision::ColorSpace"] != "no_conversion")
+                if (imageParams.applyDcpMetadata && md["AliceVision::ColorSpace"] != "no_conversion")
                 {
                     ALICEVISION_LOG_WARNING("A dcp profile will be applied on an image containing non raw data!");
                 }
@@ -1808,16 +1814,16 @@ int aliceVision_main(int argc, char* argv[])
                 readOptions.doWBAfterDemosaicing = doWBAfterDemosaicing;
                 readOptions.demosaicingAlgo = demosaicingAlgo;
                 readOptions.highlightMode = highlightMode;
-                readOptions.rawExposureAdjustment = std::pow(2.f, pParams.rawExposureAdjust);
-                readOptions.rawAutoBright = pParams.rawAutoBright;
+                readOptions.rawExposureAdjustment = std::pow(2.f, imageParams.rawExposureAdjust);
+                readOptions.rawAutoBright = imageParams.rawAutoBright;
                 readOptions.correlatedColorTemperature = correlatedColorTemperature;
-                pParams.correlatedColorTemperature = correlatedColorTemperature;
-                pParams.enableColorTempProcessing = readOptions.rawColorInterpretation == image::ERawColorInterpretation::DcpLinearProcessing;
+                imageParams.correlatedColorTemperature = correlatedColorTemperature;
+                imageParams.enableColorTempProcessing = readOptions.rawColorInterpretation == image::ERawColorInterpretation::DcpLinearProcessing;
 
-                pParams.useDCPColorMatrixOnly = useDCPColorMatrixOnly;
-                if (pParams.applyDcpMetadata)
+                imageParams.useDCPColorMatrixOnly = useDCPColorMatrixOnly;
+                if (imageParams.applyDcpMetadata)
                 {
-                    workingColorSpace = image::EImageColorSpace::ACES2065_1;
+                    imageWorkingColorSpace = image::EImageColorSpace::ACES2065_1;
                 }
             }
             else
@@ -1825,18 +1831,18 @@ int aliceVision_main(int argc, char* argv[])
                 readOptions.inputColorSpace = inputColorSpace;
             }
 
-            readOptions.workingColorSpace = pParams.applyDcpMetadata ? image::EImageColorSpace::NO_CONVERSION : workingColorSpace;
+            readOptions.workingColorSpace = imageParams.applyDcpMetadata ? image::EImageColorSpace::NO_CONVERSION : imageWorkingColorSpace;
 
             // Read original image
             image::Image<image::RGBAfColor> image;
             image::readImage(inputFilePath, image, readOptions);
 
             // Image processing
-            processImage(image, pParams, md, intrinsicBase);
+            processImage(image, imageParams, md, intrinsicBase);
 
             image::ImageWriteOptions writeOptions;
 
-            writeOptions.fromColorSpace(workingColorSpace);
+            writeOptions.fromColorSpace(imageWorkingColorSpace);
             writeOptions.toColorSpace(outputColorSpace);
             writeOptions.exrCompressionMethod(exrCompressionMethod);
             writeOptions.exrCompressionLevel(exrCompressionLevel);
@@ -1850,6 +1856,11 @@ int aliceVision_main(int argc, char* argv[])
             // Save the image
             saveImage(image, inputFilePath, outputFilePath, md, metadataFolders, outputFormat, writeOptions);
         }
+
+        if (!succeeded)
+        {
+            return EXIT_FAILURE;
+        }
     }
 
     return 0;
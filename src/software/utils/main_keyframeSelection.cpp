@@ -19,7 +19,7 @@
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 5
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 1
 
 using namespace aliceVision;
 
@@ -56,6 +56,7 @@ int aliceVision_main(int argc, char** argv)
       image::EStorageDataType::Float;
     bool renameKeyframes = false;        // name selected keyframes as consecutive frames instead of using their index as a name
     std::size_t minBlockSize = 10;       // minimum number of frames in a block for multi-threading
+    bool useGpu = false;                 // compute the scores on the GPU if available
     std::vector<std::string> maskPaths;  // masks path list
 
     // Debug options
@@ -140,6 +141,9 @@ int aliceVision_main(int argc, char** argv)
          "Size, in pixels, of the cells within an input frame that are used to compute the optical flow scores.")
         ("minBlockSize", po::value<std::size_t>(&minBlockSize)->default_value(minBlockSize),
          "Minimum number of frames processed by a single thread when multi-threading is used.")
+        ("useGpu", po::value<bool>(&useGpu)->default_value(useGpu),
+         "Compute the sharpness and optical flow scores on the GPU, by batches of frames, if a CUDA device is available "
+         "(the GPU optical flow is a Farneback flow instead of a DeepFlow).")
         ("maskPaths", po::value<std::vector<std::string>>(&maskPaths)->default_value(models)->multitoken(),
          "Paths to directories containing masks. Masks (e.g. segmentation masks) will be used to ignore some parts "
          "of the frames when computing the scores.");
@@ -255,6 +259,7 @@ int aliceVision_main(int argc, char** argv)
     selector.setMinOutFrames(minNbOutFrames);
     selector.setMaxOutFrames(maxNbOutFrames);
     selector.setMinBlockSize(minBlockSize);
+    selector.setUseGpu(useGpu);
 
     if (flowVisualisationOnly)
     {
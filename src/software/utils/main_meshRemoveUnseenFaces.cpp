@@ -19,6 +19,11 @@
 #include <aliceVision/system/Logger.hpp>
 #include <aliceVision/system/main.hpp>
 #include <aliceVision/system/Timer.hpp>
+#include <aliceVision/config.hpp>
+
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
+    #include <aliceVision/gpu/gpu.hpp>
+#endif
 
 #include <geogram/basic/common.h>
 
@@ -29,7 +34,7 @@
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 3
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 1
 
 using namespace aliceVision;
 
@@ -48,6 +53,8 @@ int aliceVision_main(int argc, char* argv[])
 
     int minObservations = 1;
     int minVertices = 3;
+    bool useGpu = false;
+    double depthTolerance = 0.001;
 
     const bool flipNormals = false;
 
@@ -66,7 +73,12 @@ int aliceVision_main(int argc, char* argv[])
         ("minObservations", po::value<int>(&minObservations)->default_value(minObservations),
          "Minimal number of observation to keep the vertex.")
         ("minVertices", po::value<int>(&minVertices)->default_value(minVertices),
-         "Minimal number of visible vertices to remove the triangle.");
+         "Minimal number of visible vertices to remove the triangle.")
+        ("useGpu", po::value<bool>(&useGpu)->default_value(useGpu),
+         "Test the vertices occlusions against depth maps of the mesh rendered on the GPU, "
+         "instead of casting a ray per vertex and camera on the CPU (requires a build with CUDA).")
+        ("depthTolerance", po::value<double>(&depthTolerance)->default_value(depthTolerance),
+         "Relative depth tolerance of the GPU occlusion test.");
     // clang-format on
 
     CmdLine cmdline("AliceVision Mesh Remove Unseen Faces");
@@ -78,6 +90,20 @@ int aliceVision_main(int argc, char* argv[])
         return EXIT_FAILURE;
     }
 
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_CUDA)
+    if (useGpu && !gpu::gpuSupportCUDA(3, 0))
+    {
+        ALICEVISION_LOG_WARNING("No compatible CUDA device found, the visibilities will be computed on the CPU.");
+        useGpu = false;
+    }
+#else
+    if (useGpu)
+    {
+        ALICEVISION_LOG_WARNING("GPU visibilities require a build with CUDA, the visibilities will be computed on the CPU.");
+        useGpu = false;
+    }
+#endif
+
     GEO::initialize();
 
     // read the input SfM scene
@@ -111,7 +137,10 @@ int aliceVision_main(int argc, char* argv[])
     mesh::Mesh& mesh = *texturing.mesh;
 
     ALICEVISION_LOG_INFO("Remap visibilities from mesh itself.");
-    mesh::remapMeshVisibilities_meshItself(mp, mesh);
+    if (useGpu)
+        mesh::remapMeshVisibilities_meshItselfGpu(mp, mesh, depthTolerance);
+    else
+        mesh::remapMeshVisibilities_meshItself(mp, mesh);
 
     StaticVectorBool trisToStay(mesh.tris.size(), true);
 
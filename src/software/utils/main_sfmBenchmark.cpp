@@ -0,0 +1,328 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/sfmData/SfMData.hpp>
+#include <aliceVision/sfmData/FlatLandmarks.hpp>
+#include <aliceVision/sfm/sfm.hpp>
+#include <aliceVision/sfm/utils/statistics.hpp>
+#include <aliceVision/sfm/utils/syntheticScene.hpp>
+#include <aliceVision/geometry/lie.hpp>
+#include <aliceVision/cmdline/cmdline.hpp>
+#include <aliceVision/system/Logger.hpp>
+#include <aliceVision/system/MemoryInfo.hpp>
+#include <aliceVision/system/Timer.hpp>
+#include <aliceVision/system/main.hpp>
+#include <aliceVision/alicevision_omp.hpp>
+
+#include <boost/program_options.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/json_parser.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+// These constants define the current software version.
+// They must be updated when the command line is changed.
+#define ALICEVISION_SOFTWARE_VERSION_MAJOR 1
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 1
+
+using namespace aliceVision;
+
+namespace po = boost::program_options;
+namespace bpt = boost::property_tree;
+namespace fs = std::filesystem;
+
+/**
+ * @brief Add the duration and the peak resident memory of a benchmark phase to the given property tree.
+ */
+void addPhase(bpt::ptree& ptPhases, const std::string& name, const system::Timer& timer)
+{
+    bpt::ptree ptPhase;
+    ptPhase.put("name", name);
+    ptPhase.put("durationSec", timer.elapsed());
+    ptPhase.put("peakResidentMemory", system::getPeakResidentMemory());
+    ptPhases.push_back(std::make_pair("", ptPhase));
+
+    ALICEVISION_LOG_INFO("Benchmark phase '" << name << "': " << system::prettyTime(timer.elapsedMs()));
+}
+
+/**
+ * @brief Perturb the poses (except the first one, locked to fix the gauge) and the landmarks of the scene.
+ */
+void perturbScene(sfmData::SfMData& sfmData, std::mt19937& generator)
+{
+    std::normal_distribution<double> rotationNoise(0.0, 0.005);
+    std::normal_distribution<double> positionNoise(0.0, 0.02);
+
+    bool isFirstPose = true;
+    for (auto& posePair : sfmData.getPoses())
+    {
+        const geometry::Pose3& pose = posePair.second.getTransform();
+        if (isFirstPose)
+        {
+            posePair.second = sfmData::CameraPose(pose, true);
+            isFirstPose = false;
+            continue;
+        }
+        const Vec3 rotationJitter(rotationNoise(generator), rotationNoise(generator), rotationNoise(generator));
+        const Vec3 positionJitter(positionNoise(generator), positionNoise(generator), positionNoise(generator));
+        posePair.second.setTransform(geometry::Pose3(SO3::expm(rotationJitter) * pose.rotation(), pose.center() + positionJitter));
+    }
+
+    for (auto& landmarkPair : sfmData.getLandmarks())
+    {
+        landmarkPair.second.X += Vec3(positionNoise(generator), positionNoise(generator), positionNoise(generator));
+    }
+}
+
+/**
+ * @brief Measure the iteration over the landmarks and their observations, and the lookups of landmarks by id,
+ *        on the landmarks map and on its contiguous copy.
+ * @return true if both containers give the same results
+ */
+bool benchmarkContainers(const sfmData::Landmarks& landmarks, bpt::ptree& ptRunPhases, std::mt19937& generator)
+{
+    system::Timer timer;
+
+    // iteration: sum of the observations coordinates weighted by the landmarks depth
+    double mapSum = 0.0;
+    for (const auto& landmarkPair : landmarks)
+    {
+        for (const auto& observationPair : landmarkPair.second.getObservations())
+            mapSum += landmarkPair.second.X.z() * observationPair.second.getCoordinates().sum();
+    }
+    addPhase(ptRunPhases, "mapIteration", timer);
+
+    timer.reset();
+    const sfmData::FlatLandmarks flatLandmarks(landmarks);
+    addPhase(ptRunPhases, "flatBuild", timer);
+
+    timer.reset();
+    double flatSum = 0.0;
+    for (std::size_t i = 0; i < flatLandmarks.size(); ++i)
+    {
+        for (std::size_t j = flatLandmarks.getObservationsBegin(i); j < flatLandmarks.getObservationsEnd(i); ++j)
+            flatSum += flatLandmarks.getX(i).z() * flatLandmarks.getObservationCoordinates(j).sum();
+    }
+    addPhase(ptRunPhases, "flatIteration", timer);
+
+    // lookups: random existing landmark ids
+    std::vector<IndexT> landmarkIds;
+    if (!landmarks.empty())
+    {
+        std::uniform_int_distribution<std::size_t> indexDistribution(0, flatLandmarks.size() - 1);
+        landmarkIds.resize(std::min<std::size_t>(flatLandmarks.size(), 10000000));
+        for (IndexT& landmarkId : landmarkIds)
+            landmarkId = flatLandmarks.getLandmarkId(indexDistribution(generator));
+    }
+
+    timer.reset();
+    double mapLookupSum = 0.0;
+    for (const IndexT landmarkId : landmarkIds)
+        mapLookupSum += landmarks.find(landmarkId)->second.X.z();
+    addPhase(ptRunPhases, "mapLookup", timer);
+
+    timer.reset();
+    double flatLookupSum = 0.0;
+    for (const IndexT landmarkId : landmarkIds)
+        flatLookupSum += flatLandmarks.getX(flatLandmarks.findIndex(landmarkId)).z();
+    addPhase(ptRunPhases, "flatLookup", timer);
+
+    return mapSum == flatSum && mapLookupSum == flatLookupSum;
+}
+
+int aliceVision_main(int argc, char** argv)
+{
+    // command-line parameters
+    std::string outputFilename;
+    sfm::SyntheticAerialSceneParams sceneParams;
+    double noise = 0.5;
+    std::vector<std::string> engines = {"sequential", "global", "bundleAdjustment"};
+    std::vector<int> nbThreadsList = {0};
+    int randomSeed = std::mt19937::default_seed;
+
+    // clang-format off
+    po::options_description requiredParams("Required parameters");
+    requiredParams.add_options()
+        ("output,o", po::value<std::string>(&outputFilename)->required(),
+         "Output JSON file with the benchmark results.");
+
+    po::options_description optionalParams("Optional parameters");
+    optionalParams.add_options()
+        ("nbViews", po::value<std::size_t>(&sceneParams.nbViews)->default_value(sceneParams.nbViews),
+         "Number of views of the synthetic scene (aerial survey on a regular grid).")
+        ("meanTrackLength", po::value<double>(&sceneParams.meanTrackLength)->default_value(sceneParams.meanTrackLength),
+         "Target mean number of observations per landmark.")
+        ("nbObservationsPerView", po::value<std::size_t>(&sceneParams.nbObservationsPerView)->default_value(sceneParams.nbObservationsPerView),
+         "Target mean number of observations per view.")
+        ("noise", po::value<double>(&noise)->default_value(noise),
+         "Standard deviation of the gaussian noise added to the features (in pixels).")
+        ("engines", po::value<std::vector<std::string>>(&engines)->multitoken()->default_value(engines, "sequential global bundleAdjustment"),
+         "Benchmarked engines: sequential, global, bundleAdjustment, containers (iteration and lookups on the landmarks containers).")
+        ("nbThreads", po::value<std::vector<int>>(&nbThreadsList)->multitoken()->default_value(nbThreadsList, "0"),
+         "List of numbers of threads used to run each engine, to measure the scaling (0 to use all the available threads).")
+        ("randomSeed", po::value<int>(&randomSeed)->default_value(randomSeed),
+         "This seed value will generate a sequence using a linear random generator. Set -1 to use a random seed.");
+    // clang-format on
+
+    CmdLine cmdline("AliceVision sfmBenchmark\n"
+                    "Generate a synthetic scene and measure the duration and the memory of the SfM engines on it. "
+                    "The peak resident memory is the maximum of the process since its start: "
+                    "run one engine per process to measure the memory of each engine.");
+    cmdline.add(requiredParams);
+    cmdline.add(optionalParams);
+    if (!cmdline.execute(argc, argv))
+    {
+        return EXIT_FAILURE;
+    }
+
+    for (const std::string& engine : engines)
+    {
+        if (engine != "sequential" && engine != "global" && engine != "bundleAdjustment" && engine != "containers")
+        {
+            ALICEVISION_LOG_ERROR("Unknown engine: '" << engine << "'.");
+            return EXIT_FAILURE;
+        }
+    }
+
+    const unsigned int seed = (randomSeed == -1) ? std::random_device()() : static_cast<unsigned int>(randomSeed);
+    sceneParams.seed = seed;
+    std::mt19937 generator(seed);
+
+    const int maxNbThreads = omp_get_max_threads();
+    const std::string outputFolder = fs::path(outputFilename).parent_path().string();
+
+    bpt::ptree ptResults;
+    bpt::ptree ptPhases;
+
+    // synthetic scene
+    system::Timer timer;
+    const sfmData::SfMData sfmDataGT = sfm::generateSyntheticAerialScene(sceneParams);
+    addPhase(ptPhases, "sceneGeneration", timer);
+
+    std::size_t nbObservations = 0;
+    for (const auto& landmarkPair : sfmDataGT.getLandmarks())
+        nbObservations += landmarkPair.second.getObservations().size();
+
+    ALICEVISION_LOG_INFO("Synthetic scene:\n"
+                         << "\t- # views: " << sfmDataGT.getViews().size() << "\n"
+                         << "\t- # landmarks: " << sfmDataGT.getLandmarks().size() << "\n"
+                         << "\t- # observations: " << nbObservations);
+
+    // features and matches
+    timer.reset();
+    std::normal_distribution<double> featuresNoise(0.0, noise);
+    feature::FeaturesPerView featuresPerView;
+    sfm::generateSyntheticFeatures(featuresPerView, feature::EImageDescriberType::UNKNOWN, sfmDataGT, featuresNoise);
+    matching::PairwiseMatches pairwiseMatches;
+    sfm::generateSyntheticMatches(pairwiseMatches, sfmDataGT, feature::EImageDescriberType::UNKNOWN);
+    addPhase(ptPhases, "featuresAndMatchesGeneration", timer);
+
+    // input scene of the SfM engines: views and intrinsics only
+    sfmData::SfMData sfmDataInput = sfmDataGT;
+    sfmDataInput.getPoses().clear();
+    sfmDataInput.getLandmarks().clear();
+
+    bpt::ptree ptRuns;
+    for (const std::string& engine : engines)
+    {
+        for (const int nbThreadsParam : nbThreadsList)
+        {
+            const int nbThreads = (nbThreadsParam <= 0) ? maxNbThreads : std::min(nbThreadsParam, maxNbThreads);
+            omp_set_num_threads(nbThreads);
+            ALICEVISION_LOG_INFO("Benchmark engine '" << engine << "' with " << nbThreads << " threads.");
+
+            bpt::ptree ptRun;
+            bpt::ptree ptRunPhases;
+            ptRun.put("engine", engine);
+            ptRun.put("nbThreads", nbThreads);
+
+            bool success = false;
+            sfmData::SfMData sfmDataResult;
+
+            if (engine == "sequential")
+            {
+                sfm::ReconstructionEngine_sequentialSfM::Params sfmParams;
+                sfmParams.lockAllIntrinsics = true;
+
+                timer.reset();
+                sfm::ReconstructionEngine_sequentialSfM sfmEngine(sfmDataInput, sfmParams, outputFolder);
+                sfmEngine.setFeatures(&featuresPerView);
+                sfmEngine.setMatches(&pairwiseMatches);
+                success = sfmEngine.process();
+                addPhase(ptRunPhases, "process", timer);
+
+                sfmDataResult = sfmEngine.getSfMData();
+            }
+            else if (engine == "global")
+            {
+                timer.reset();
+                sfm::ReconstructionEngine_globalSfM sfmEngine(sfmDataInput, outputFolder);
+                sfmEngine.setFeaturesProvider(&featuresPerView);
+                sfmEngine.setMatchesProvider(&pairwiseMatches);
+                sfmEngine.setLockAllIntrinsics(true);
+                sfmEngine.setRotationAveragingMethod(sfm::ROTATION_AVERAGING_L2);
+                sfmEngine.setTranslationAveragingMethod(sfm::TRANSLATION_AVERAGING_SOFTL1);
+                success = sfmEngine.process();
+                addPhase(ptRunPhases, "process", timer);
+
+                sfmDataResult = sfmEngine.getSfMData();
+            }
+            else if (engine == "containers")
+            {
+                std::mt19937 lookupGenerator(generator());
+                success = benchmarkContainers(sfmDataGT.getLandmarks(), ptRunPhases, lookupGenerator);
+            }
+            else
+            {
+                sfmDataResult = sfmDataGT;
+                std::mt19937 perturbGenerator(generator());
+                perturbScene(sfmDataResult, perturbGenerator);
+
+                timer.reset();
+                sfm::BundleAdjustmentCeres::CeresOptions options(false);
+                options.setSparseBA();
+                sfm::BundleAdjustmentCeres BA(options);
+                success = BA.adjust(sfmDataResult,
+                                    sfm::BundleAdjustment::REFINE_ROTATION | sfm::BundleAdjustment::REFINE_TRANSLATION |
+                                      sfm::BundleAdjustment::REFINE_STRUCTURE);
+                addPhase(ptRunPhases, "adjust", timer);
+            }
+
+            ptRun.put("success", success);
+            ptRun.put("nbPoses", sfmDataResult.getPoses().size());
+            ptRun.put("nbLandmarks", sfmDataResult.getLandmarks().size());
+            ptRun.put("rmse", sfm::RMSE(sfmDataResult));
+            ptRun.add_child("phases", ptRunPhases);
+            ptRuns.push_back(std::make_pair("", ptRun));
+        }
+    }
+
+    bpt::ptree ptScene;
+    ptScene.put("nbViews", sfmDataGT.getViews().size());
+    ptScene.put("nbLandmarks", sfmDataGT.getLandmarks().size());
+    ptScene.put("nbObservations", nbObservations);
+    ptScene.put("meanTrackLength", sfmDataGT.getLandmarks().empty() ? 0.0 : double(nbObservations) / sfmDataGT.getLandmarks().size());
+    ptScene.put("seed", seed);
+
+    ptResults.add_child("scene", ptScene);
+    ptResults.put("maxNbThreads", maxNbThreads);
+    ptResults.add_child("phases", ptPhases);
+    ptResults.add_child("runs", ptRuns);
+
+    std::ofstream outputFile(outputFilename);
+    if (!outputFile.is_open())
+    {
+        ALICEVISION_LOG_ERROR("Unable to write the output file '" << outputFilename << "'.");
+        return EXIT_FAILURE;
+    }
+    bpt::write_json(outputFile, ptResults);
+
+    return EXIT_SUCCESS;
+}
@@ -22,7 +22,7 @@
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 1
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 1
 
 using namespace aliceVision;
 
@@ -38,6 +38,7 @@ int aliceVision_main(int argc, char** argv)
     std::vector<std::string> matchesFolders;
     std::string describerTypesName = feature::EImageDescriberType_enumToString(feature::EImageDescriberType::SIFT);
     EHistogramSelectionMethod selectionMethod;
+    colorHarmonization::EGainOffsetSolver solver = colorHarmonization::EGainOffsetSolver::LINF_LP;
     int imgRef;
 
     // user optional parameters
@@ -60,7 +61,12 @@ int aliceVision_main(int argc, char** argv)
     po::options_description optionalParams("Optional parameters");
     optionalParams.add_options()
         ("describerTypes,d", po::value<std::string>(&describerTypesName)->default_value(describerTypesName),
-         feature::EImageDescriberType_informations().c_str());
+         feature::EImageDescriberType_informations().c_str())
+        ("solver", po::value<colorHarmonization::EGainOffsetSolver>(&solver)->default_value(solver),
+         "Gain and offset solver:\n"
+         "* linf_lp: minimize the maximal histogram quantile residual with a linear program.\n"
+         "* l2: minimize the sum of squared residuals with a sparse least squares, for the large image graphs.\n"
+         "* l1_irls: minimize the sum of absolute residuals with an iteratively reweighted least squares, robust to the outlier pairs.");
     // clang-format on
 
     CmdLine cmdline("AliceVision sfmColorHarmonize");
@@ -87,7 +93,7 @@ int aliceVision_main(int argc, char** argv)
     aliceVision::system::Timer timer;
 
     ColorHarmonizationEngineGlobal colorHarmonizeEngine(
-      sfmDataFilename, featuresFolders, matchesFolders, outputFolder, describerTypes, selectionMethod, imgRef);
+      sfmDataFilename, featuresFolders, matchesFolders, outputFolder, describerTypes, selectionMethod, solver, imgRef);
 
     if (colorHarmonizeEngine.process())
     {
@@ -14,111 +14,157 @@
 
 #include <string>
 #include <sstream>
+#include <vector>
 
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 1
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 2
 
 using namespace aliceVision;
 
 namespace po = boost::program_options;
 
+namespace {
+
+/**
+ * @brief Move the elements of a map into another one (without copy of the elements).
+ * @param[in,out] destination The map receiving the elements, its elements are kept if their id is also in the source
+ * @param[in,out] source The map giving its elements, only the elements with an id of the destination are left
+ * @return the number of elements with an id of the destination
+ */
+template<typename MapT>
+std::size_t moveElements(MapT& destination, MapT& source)
+{
+    destination.merge(source);
+    return source.size();
+}
+
+/**
+ * @brief Merge a scene into another one.
+ * @param[in,out] sfmData The merged scene
+ * @param[in,out] sfmDataOther The scene to merge, its data is moved
+ * @param[in] allowOverlap Allow views, intrinsics, rigs and poses shared by both scenes (the ones of sfmData are kept)
+ * @return false if there are shared data that are not allowed
+ */
+bool mergeSfMData(sfmData::SfMData& sfmData, sfmData::SfMData& sfmDataOther, bool allowOverlap)
+{
+    if (moveElements(sfmData.getViews(), sfmDataOther.getViews()) > 0 && !allowOverlap)
+    {
+        ALICEVISION_LOG_ERROR("Unhandled error: common view ID between both SfMData");
+        return false;
+    }
+    if (moveElements(sfmData.getIntrinsics(), sfmDataOther.getIntrinsics()) > 0 && !allowOverlap)
+    {
+        ALICEVISION_LOG_ERROR("Unhandled error: common intrinsics ID between both SfMData");
+        return false;
+    }
+    if (moveElements(sfmData.getRigs(), sfmDataOther.getRigs()) > 0 && !allowOverlap)
+    {
+        ALICEVISION_LOG_ERROR("Unhandled error: common rigs ID between both SfMData");
+        return false;
+    }
+    if (moveElements(sfmData.getPoses(), sfmDataOther.getPoses()) > 0 && !allowOverlap)
+    {
+        ALICEVISION_LOG_ERROR("Unhandled error: common poses ID between both SfMData");
+        return false;
+    }
+
+    if (allowOverlap && !sfmData.getLandmarks().empty())
+    {
+        // the landmarks of both scenes are independent, even if they share some views
+        IndexT landmarkId = sfmData.getLandmarks().rbegin()->first + 1;
+        sfmData::Landmarks& landmarks = sfmData.getLandmarks();
+        for (auto& landmarkIt : sfmDataOther.getLandmarks())
+            landmarks.emplace_hint(landmarks.end(), landmarkId++, std::move(landmarkIt.second));
+        sfmDataOther.getLandmarks().clear();
+    }
+    else if (moveElements(sfmData.getLandmarks(), sfmDataOther.getLandmarks()) > 0)
+    {
+        ALICEVISION_LOG_ERROR("Unhandled error: common landmarks ID between both SfMData");
+        return false;
+    }
+
+    sfmData.addFeaturesFolders(sfmDataOther.getRelativeFeaturesFolders());
+    sfmData.addMatchesFolders(sfmDataOther.getRelativeMatchesFolders());
+
+    return true;
+}
+
+}  // namespace
+
 int aliceVision_main(int argc, char** argv)
 {
     // command-line parameters
     std::string sfmDataFilename1, sfmDataFilename2;
+    std::vector<std::string> sfmDataFilenames;
     std::string outSfMDataFilename;
+    bool allowOverlap = false;
 
     // clang-format off
     po::options_description requiredParams("Required parameters");
     requiredParams.add_options()
-        ("firstinput,i1", po::value<std::string>(&sfmDataFilename1)->required(),
-         "First SfMData file to merge.")
-        ("secondinput,i2", po::value<std::string>(&sfmDataFilename2)->required(),
-         "Second SfMData file to merge.")
         ("output,o", po::value<std::string>(&outSfMDataFilename)->required(),
          "Output SfMData scene.");
+
+    po::options_description optionalParams("Optional parameters");
+    optionalParams.add_options()
+        ("firstinput,i1", po::value<std::string>(&sfmDataFilename1),
+         "First SfMData file to merge.")
+        ("secondinput,i2", po::value<std::string>(&sfmDataFilename2),
+         "Second SfMData file to merge.")
+        ("inputs", po::value<std::vector<std::string>>(&sfmDataFilenames)->multitoken(),
+         "SfMData files to merge (after the first and second inputs). "
+         "All the scenes are merged in a single pass, in the given order.")
+        ("allowOverlap", po::value<bool>(&allowOverlap)->default_value(allowOverlap),
+         "Allow views, intrinsics, rigs and poses shared by both SfMData (e.g. overlapping clusters from sfmPartition, "
+         "aligned beforehand with sfmAlignment). The shared data of the first SfMData is kept "
+         "and the landmarks of the second SfMData are renumbered.");
     // clang-format on
 
     CmdLine cmdline("AliceVision sfmMerge");
     cmdline.add(requiredParams);
+    cmdline.add(optionalParams);
     if (!cmdline.execute(argc, argv))
     {
         return EXIT_FAILURE;
     }
 
-    // Load input scene
-    sfmData::SfMData sfmData1;
-    if (!sfmDataIO::load(sfmData1, sfmDataFilename1, sfmDataIO::ESfMData::ALL))
-    {
-        ALICEVISION_LOG_ERROR("The input SfMData file '" << sfmDataFilename1 << "' cannot be read");
-        return EXIT_FAILURE;
-    }
+    if (!sfmDataFilename2.empty())
+        sfmDataFilenames.insert(sfmDataFilenames.begin(), sfmDataFilename2);
+    if (!sfmDataFilename1.empty())
+        sfmDataFilenames.insert(sfmDataFilenames.begin(), sfmDataFilename1);
 
-    sfmData::SfMData sfmData2;
-    if (!sfmDataIO::load(sfmData2, sfmDataFilename2, sfmDataIO::ESfMData::ALL))
+    if (sfmDataFilenames.size() < 2)
     {
-        ALICEVISION_LOG_ERROR("The input SfMData file '" << sfmDataFilename2 << "' cannot be read");
+        ALICEVISION_LOG_ERROR("At least two SfMData files are required.");
         return EXIT_FAILURE;
     }
 
+    // Load input scenes, each scene is moved into the merged one once loaded
+    sfmData::SfMData sfmData;
+    for (std::size_t i = 0; i < sfmDataFilenames.size(); ++i)
     {
-        auto& views1 = sfmData1.getViews();
-        auto& views2 = sfmData2.getViews();
-        const size_t totalSize = views1.size() + views2.size();
-
-        views1.insert(views2.begin(), views2.end());
-        if (views1.size() < totalSize)
-        {
-            ALICEVISION_LOG_ERROR("Unhandled error: common view ID between both SfMData");
-            return EXIT_FAILURE;
-        }
-    }
-
-    {
-        auto& intrinsics1 = sfmData1.getIntrinsics();
-        auto& intrinsics2 = sfmData2.getIntrinsics();
-        const size_t totalSize = intrinsics1.size() + intrinsics2.size();
-
-        intrinsics1.insert(intrinsics2.begin(), intrinsics2.end());
-        if (intrinsics1.size() < totalSize)
-        {
-            ALICEVISION_LOG_ERROR("Unhandled error: common intrinsics ID between both SfMData");
-            return EXIT_FAILURE;
-        }
-    }
-
-    {
-        auto& rigs1 = sfmData1.getRigs();
-        auto& rigs2 = sfmData2.getRigs();
-        const size_t totalSize = rigs1.size() + rigs2.size();
+        const std::string& sfmDataFilename = sfmDataFilenames[i];
 
-        rigs1.insert(rigs2.begin(), rigs2.end());
-        if (rigs1.size() < totalSize)
+        sfmData::SfMData sfmDataOther;
+        if (!sfmDataIO::load((i == 0) ? sfmData : sfmDataOther, sfmDataFilename, sfmDataIO::ESfMData::ALL))
         {
-            ALICEVISION_LOG_ERROR("Unhandled error: common rigs ID between both SfMData");
+            ALICEVISION_LOG_ERROR("The input SfMData file '" << sfmDataFilename << "' cannot be read");
             return EXIT_FAILURE;
         }
-    }
-
-    {
-        auto& landmarks1 = sfmData1.getLandmarks();
-        auto& landmarks2 = sfmData2.getLandmarks();
-        const size_t totalSize = landmarks1.size() + landmarks2.size();
 
-        landmarks1.insert(landmarks2.begin(), landmarks2.end());
-        if (landmarks1.size() < totalSize)
+        if (i > 0 && !mergeSfMData(sfmData, sfmDataOther, allowOverlap))
         {
-            ALICEVISION_LOG_ERROR("Unhandled error: common rigs landmarks between both SfMData");
+            ALICEVISION_LOG_ERROR("The SfMData file '" << sfmDataFilename << "' cannot be merged");
             return EXIT_FAILURE;
         }
     }
 
-    sfmData1.addFeaturesFolders(sfmData2.getRelativeFeaturesFolders());
-    sfmData1.addMatchesFolders(sfmData2.getRelativeMatchesFolders());
+    ALICEVISION_LOG_INFO("Merged " << sfmDataFilenames.size() << " SfMData files: " << sfmData.getViews().size() << " views, "
+                                   << sfmData.getPoses().size() << " poses and " << sfmData.getLandmarks().size() << " landmarks.");
 
-    if (!sfmDataIO::save(sfmData1, outSfMDataFilename, sfmDataIO::ESfMData::ALL))
+    if (!sfmDataIO::save(sfmData, outSfMDataFilename, sfmDataIO::ESfMData::ALL))
     {
         ALICEVISION_LOG_ERROR("An error occurred while trying to save '" << outSfMDataFilename << "'");
         return EXIT_FAILURE;
@@ -0,0 +1,141 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/sfmData/SfMData.hpp>
+#include <aliceVision/sfmDataIO/sfmDataIO.hpp>
+#include <aliceVision/sfm/pipeline/pairwiseMatchesIO.hpp>
+#include <aliceVision/sfm/utils/viewGraphPartition.hpp>
+#include <aliceVision/feature/imageDescriberCommon.hpp>
+#include <aliceVision/cmdline/cmdline.hpp>
+#include <aliceVision/system/Logger.hpp>
+#include <aliceVision/system/main.hpp>
+
+#include <boost/program_options.hpp>
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// These constants define the current software version.
+// They must be updated when the command line is changed.
+#define ALICEVISION_SOFTWARE_VERSION_MAJOR 1
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+
+using namespace aliceVision;
+
+namespace po = boost::program_options;
+namespace fs = std::filesystem;
+
+int aliceVision_main(int argc, char** argv)
+{
+    // command-line parameters
+    std::string sfmDataFilename;
+    std::string outputFolder;
+    std::vector<std::string> matchesFolders;
+    std::string describerTypesName = feature::EImageDescriberType_enumToString(feature::EImageDescriberType::SIFT);
+    std::size_t maxClusterSize = 500;
+    double overlapRatio = 0.1;
+
+    // clang-format off
+    po::options_description requiredParams("Required parameters");
+    requiredParams.add_options()
+        ("input,i", po::value<std::string>(&sfmDataFilename)->required(),
+         "SfMData file.")
+        ("matchesFolders,m", po::value<std::vector<std::string>>(&matchesFolders)->multitoken()->required(),
+         "Path to folder(s) in which computed matches are stored.")
+        ("output,o", po::value<std::string>(&outputFolder)->required(),
+         "Output folder for the SfMData file of each cluster.");
+
+    po::options_description optionalParams("Optional parameters");
+    optionalParams.add_options()
+        ("describerTypes,d", po::value<std::string>(&describerTypesName)->default_value(describerTypesName),
+         feature::EImageDescriberType_informations().c_str())
+        ("maxClusterSize", po::value<std::size_t>(&maxClusterSize)->default_value(maxClusterSize),
+         "Maximum number of views per cluster (before the overlap extension).")
+        ("overlapRatio", po::value<double>(&overlapRatio)->default_value(overlapRatio),
+         "Number of views of the neighbouring clusters added to each cluster, as a ratio of the cluster size. "
+         "The shared views are used to align the reconstructions of the clusters.");
+    // clang-format on
+
+    CmdLine cmdline("AliceVision sfmPartition\n"
+                    "Split the view graph into clusters of strongly matched views, "
+                    "so that each cluster can be reconstructed independently before being aligned and merged.");
+    cmdline.add(requiredParams);
+    cmdline.add(optionalParams);
+    if (!cmdline.execute(argc, argv))
+    {
+        return EXIT_FAILURE;
+    }
+
+    // load input scene
+    sfmData::SfMData sfmData;
+    if (!sfmDataIO::load(sfmData, sfmDataFilename, sfmDataIO::ESfMData::ALL))
+    {
+        ALICEVISION_LOG_ERROR("The input SfMData file '" << sfmDataFilename << "' cannot be read");
+        return EXIT_FAILURE;
+    }
+
+    const std::vector<feature::EImageDescriberType> describerTypes = feature::EImageDescriberType_stringToEnums(describerTypesName);
+
+    // matches reading
+    matching::PairwiseMatches pairwiseMatches;
+    if (!sfm::loadPairwiseMatches(pairwiseMatches, sfmData, matchesFolders, describerTypes))
+    {
+        ALICEVISION_LOG_ERROR("Unable to load matches.");
+        return EXIT_FAILURE;
+    }
+
+    std::map<Pair, double> edgeWeights;
+    sfm::computeViewGraphWeights(pairwiseMatches, edgeWeights);
+
+    std::vector<std::set<IndexT>> clusters;
+    sfm::partitionViewGraph(edgeWeights, maxClusterSize, overlapRatio, clusters);
+
+    if (!fs::exists(outputFolder))
+    {
+        fs::create_directory(outputFolder);
+    }
+
+    for (std::size_t c = 0; c < clusters.size(); ++c)
+    {
+        // the cluster only contains the views, their intrinsics and rigs
+        sfmData::SfMData sfmDataCluster;
+        sfmDataCluster.addFeaturesFolders(sfmData.getFeaturesFolders());
+        sfmDataCluster.addMatchesFolders(sfmData.getMatchesFolders());
+
+        for (const IndexT viewId : clusters[c])
+        {
+            const auto viewIt = sfmData.getViews().find(viewId);
+            if (viewIt == sfmData.getViews().end())
+                continue;
+
+            const sfmData::View& view = *viewIt->second;
+            sfmDataCluster.getViews().emplace(viewId, viewIt->second);
+
+            const auto intrinsicIt = sfmData.getIntrinsics().find(view.getIntrinsicId());
+            if (intrinsicIt != sfmData.getIntrinsics().end())
+                sfmDataCluster.getIntrinsics().emplace(intrinsicIt->first, intrinsicIt->second);
+
+            if (view.isPartOfRig())
+            {
+                const auto rigIt = sfmData.getRigs().find(view.getRigId());
+                if (rigIt != sfmData.getRigs().end())
+                    sfmDataCluster.getRigs().emplace(rigIt->first, rigIt->second);
+            }
+        }
+
+        const std::string clusterFilename = (fs::path(outputFolder) / ("cluster_" + std::to_string(c) + ".sfm")).string();
+        ALICEVISION_LOG_INFO("Cluster " << c << ": " << sfmDataCluster.getViews().size() << " views, saved in '" << clusterFilename << "'.");
+
+        if (!sfmDataIO::save(sfmDataCluster, clusterFilename, sfmDataIO::ESfMData::ALL))
+        {
+            ALICEVISION_LOG_ERROR("An error occurred while trying to save '" << clusterFilename << "'");
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
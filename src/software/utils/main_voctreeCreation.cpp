@@ -27,7 +27,7 @@
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 1
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 1
 
 static const int DIMENSION = 128;
 
@@ -52,6 +52,7 @@ int aliceVision_main(int argc, char** argv)
     std::uint32_t K = 10;
     std::uint32_t restart = 5;
     std::uint32_t LEVELS = 6;
+    std::size_t miniBatchSize = 0;
     bool sanityCheck = true;
 
     // clang-format off
@@ -74,6 +75,9 @@ int aliceVision_main(int argc, char** argv)
          "Number of times that the kmean is launched for each cluster, the best solution is kept.")
         (",L", po::value<uint32_t>(&LEVELS)->default_value(6),
          "Number of levels of the tree.")
+        ("miniBatchSize", po::value<std::size_t>(&miniBatchSize)->default_value(miniBatchSize),
+         "Number of descriptors sampled at each iteration of the kmeans (mini-batch kmeans). "
+         "It is only used for the nodes with more descriptors. 0 means that all the descriptors are used (standard kmeans).")
         ("sanitycheck,s", po::value<bool>(&sanityCheck)->default_value(sanityCheck),
          "Perform a sanity check at the end of the creation of the vocabulary tree. "
          "The sanity check is a query to the database with the same documents/images useed to train the vocabulary tree.");
@@ -122,6 +126,7 @@ int aliceVision_main(int argc, char** argv)
     aliceVision::voctree::TreeBuilder<DescriptorFloat> builder(DescriptorFloat(0));
     builder.setVerbose(tbVerbosity);
     builder.kmeans().setRestarts(restart);
+    builder.kmeans().setMiniBatchSize(miniBatchSize);
     ALICEVISION_COUT("Building a tree of L=" << LEVELS << " levels with a branching factor of k=" << K);
     detect_start = std::chrono::steady_clock::now();
     builder.build(descriptors, K, LEVELS);
@@ -143,17 +148,8 @@ int aliceVision_main(int argc, char** argv)
     for (size_t i = 0; i < descRead.size(); ++i)
     {
         // for each image:
-        // clear the temporary vector used to save all the visual word and allocate the proper size
-        imgVisualWords.clear();
-        // allocate as many visual words as the number of the features in the image
-        imgVisualWords.resize(descRead[i], 0);
-
-#pragma omp parallel for
-        for (ptrdiff_t j = 0; j < static_cast<ptrdiff_t>(descRead[i]); ++j)
-        {
-            //	store the visual word associated to the feature in the temporary list
-            imgVisualWords[j] = builder.tree().quantize(descriptors[j + offset]);
-        }
+        // store the visual words associated to the features of the image in the temporary list
+        imgVisualWords = builder.tree().quantize(descriptors.data() + offset, descRead[i]);
         aliceVision::voctree::SparseHistogram histo;
         aliceVision::voctree::computeSparseHistogram(imgVisualWords, histo);
         // add the vector to the documents
@@ -8,6 +8,7 @@
 #include "colorHarmonizeEngineGlobal.hpp"
 #include "software/utils/sfmHelper/sfmIOHelper.hpp"
 
+#include <aliceVision/system/Logger.hpp>
 #include <aliceVision/system/ProgressDisplay.hpp>
 #include <aliceVision/system/Timer.hpp>
 #include <aliceVision/utils/filesIO.hpp>
@@ -40,6 +41,7 @@
 #include <functional>
 #include <filesystem>
 #include <sstream>
+#include <exception>
 
 namespace fs = std::filesystem;
 
@@ -94,6 +96,7 @@ ColorHarmonizationEngineGlobal::ColorHarmonizationEngineGlobal(const std::string
                                                                const std::string& outputDirectory,
                                                                const std::vector<feature::EImageDescriberType>& descTypes,
                                                                EHistogramSelectionMethod selectionMethod,
+                                                               colorHarmonization::EGainOffsetSolver solver,
                                                                int imgRef)
   : _sfmDataFilename(sfmDataFilename),
     _featuresFolders(featuresFolders),
@@ -101,6 +104,7 @@ ColorHarmonizationEngineGlobal::ColorHarmonizationEngineGlobal(const std::string
     _outputDirectory(outputDirectory),
     _descTypes(descTypes),
     _selectionMethod(selectionMethod),
+    _solver(solver),
     _imgRef(imgRef)
 {
     if (!utils::exists(outputDirectory))
@@ -201,119 +205,149 @@ bool ColorHarmonizationEngineGlobal::process()
     mapRelativeHistograms[1].resize(_pairwiseMatches.size());
     mapRelativeHistograms[2].resize(_pairwiseMatches.size());
 
-    for (size_t i = 0; i < _pairwiseMatches.size(); ++i)
+    switch (_selectionMethod)
     {
-        matching::PairwiseMatches::const_iterator iter = _pairwiseMatches.begin();
-        std::advance(iter, i);
-
-        const size_t viewI = iter->first.first;
-        const size_t viewJ = iter->first.second;
+        case EHistogramSelectionMethod::eHistogramHarmonizeFullFrame:
+        case EHistogramSelectionMethod::eHistogramHarmonizeMatchedPoints:
+        case EHistogramSelectionMethod::eHistogramHarmonizeVLDSegment:
+            break;
+        default:
+            std::cout << "Selection method unsupported" << std::endl;
+            return false;
+    }
 
-        const MatchesPerDescType& matchesPerDesc = iter->second;
+    // the edges are independent: the masks and histograms are computed in parallel
+    std::vector<matching::PairwiseMatches::const_iterator> pairIterators;
+    pairIterators.reserve(_pairwiseMatches.size());
+    for (matching::PairwiseMatches::const_iterator iter = _pairwiseMatches.begin(); iter != _pairwiseMatches.end(); ++iter)
+        pairIterators.push_back(iter);
 
-        //-- Edges names:
-        std::pair<std::string, std::string> p_imaNames;
-        p_imaNames = make_pair(_fileNames[viewI], _fileNames[viewJ]);
-        std::cout << "Current edge : " << fs::path(p_imaNames.first).filename().string() << "\t" << fs::path(p_imaNames.second).filename().string()
-                  << std::endl;
+    std::exception_ptr exception;
 
-        //-- Compute the masks from the data selection:
-        Image<unsigned char> maskI(_imageSize[viewI].first, _imageSize[viewI].second);
-        Image<unsigned char> maskJ(_imageSize[viewJ].first, _imageSize[viewJ].second);
+#pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < static_cast<int>(pairIterators.size()); ++i)
+    {
+        if (exception)
+            continue;
 
-        switch (_selectionMethod)
+        try
         {
-            case EHistogramSelectionMethod::eHistogramHarmonizeFullFrame:
-            {
-                colorHarmonization::CommonDataByPair_fullFrame dataSelector(p_imaNames.first, p_imaNames.second);
-                dataSelector.computeMask(maskI, maskJ);
-            }
-            break;
-            case EHistogramSelectionMethod::eHistogramHarmonizeMatchedPoints:
-            {
-                int circleSize = 10;
-                colorHarmonization::CommonDataByPair_matchedPoints dataSelector(p_imaNames.first,
-                                                                                p_imaNames.second,
-                                                                                matchesPerDesc,
-                                                                                _regionsPerView.getRegionsPerDesc(viewI),
-                                                                                _regionsPerView.getRegionsPerDesc(viewJ),
-                                                                                circleSize);
-                dataSelector.computeMask(maskI, maskJ);
-            }
-            break;
-            case EHistogramSelectionMethod::eHistogramHarmonizeVLDSegment:
-            {
-                maskI.fill(0);
-                maskJ.fill(0);
+            const matching::PairwiseMatches::const_iterator iter = pairIterators[i];
 
-                for (const auto& matchesIt : matchesPerDesc)
-                {
-                    const feature::EImageDescriberType descType = matchesIt.first;
-                    const IndMatches& matches = matchesIt.second;
-                    colorHarmonization::CommonDataByPair_vldSegment dataSelector(p_imaNames.first,
-                                                                                 p_imaNames.second,
-                                                                                 matches,
-                                                                                 _regionsPerView.getRegions(viewI, descType).Features(),
-                                                                                 _regionsPerView.getRegions(viewJ, descType).Features());
+            const size_t viewI = iter->first.first;
+            const size_t viewJ = iter->first.second;
+
+            const MatchesPerDescType& matchesPerDesc = iter->second;
+
+            //-- Edges names:
+            std::pair<std::string, std::string> p_imaNames;
+            p_imaNames = make_pair(_fileNames[viewI], _fileNames[viewJ]);
+            ALICEVISION_LOG_INFO("Current edge : " << fs::path(p_imaNames.first).filename().string() << "\t"
+                                                   << fs::path(p_imaNames.second).filename().string());
+
+            //-- Compute the masks from the data selection:
+            Image<unsigned char> maskI(_imageSize[viewI].first, _imageSize[viewI].second);
+            Image<unsigned char> maskJ(_imageSize[viewJ].first, _imageSize[viewJ].second);
 
+            switch (_selectionMethod)
+            {
+                case EHistogramSelectionMethod::eHistogramHarmonizeFullFrame:
+                {
+                    colorHarmonization::CommonDataByPair_fullFrame dataSelector(p_imaNames.first, p_imaNames.second);
+                    dataSelector.computeMask(maskI, maskJ);
+                }
+                break;
+                case EHistogramSelectionMethod::eHistogramHarmonizeMatchedPoints:
+                {
+                    int circleSize = 10;
+                    colorHarmonization::CommonDataByPair_matchedPoints dataSelector(p_imaNames.first,
+                                                                                    p_imaNames.second,
+                                                                                    matchesPerDesc,
+                                                                                    _regionsPerView.getRegionsPerDesc(viewI),
+                                                                                    _regionsPerView.getRegionsPerDesc(viewJ),
+                                                                                    circleSize);
                     dataSelector.computeMask(maskI, maskJ);
                 }
+                break;
+                case EHistogramSelectionMethod::eHistogramHarmonizeVLDSegment:
+                {
+                    maskI.fill(0);
+                    maskJ.fill(0);
+
+                    for (const auto& matchesIt : matchesPerDesc)
+                    {
+                        const feature::EImageDescriberType descType = matchesIt.first;
+                        const IndMatches& matches = matchesIt.second;
+                        colorHarmonization::CommonDataByPair_vldSegment dataSelector(p_imaNames.first,
+                                                                                     p_imaNames.second,
+                                                                                     matches,
+                                                                                     _regionsPerView.getRegions(viewI, descType).Features(),
+                                                                                     _regionsPerView.getRegions(viewJ, descType).Features());
+
+                        dataSelector.computeMask(maskI, maskJ);
+                    }
+                }
+                break;
             }
-            break;
-            default:
-                std::cout << "Selection method unsupported" << std::endl;
-                return false;
-        }
 
-        //-- Export the masks
-        bool bExportMask = false;
-        if (bExportMask)
-        {
-            std::string sEdge = _fileNames[viewI] + "_" + _fileNames[viewJ];
-            sEdge = (fs::path(_outputDirectory) / sEdge).string();
+            //-- Export the masks
+            bool bExportMask = false;
+            if (bExportMask)
+            {
+                std::string sEdge = _fileNames[viewI] + "_" + _fileNames[viewJ];
+                sEdge = (fs::path(_outputDirectory) / sEdge).string();
 
-            if (!utils::exists(sEdge))
-                fs::create_directory(sEdge);
+                if (!utils::exists(sEdge))
+                    fs::create_directory(sEdge);
 
-            std::string outFilenameI = "00_mask_I.png";
-            outFilenameI = (fs::path(sEdge) / outFilenameI).string();
+                std::string outFilenameI = "00_mask_I.png";
+                outFilenameI = (fs::path(sEdge) / outFilenameI).string();
 
-            std::string outFilenameJ = "00_mask_J.png";
-            outFilenameJ = (fs::path(sEdge) / outFilenameJ).string();
-            writeImage(outFilenameI, maskI, image::ImageWriteOptions());
-            writeImage(outFilenameJ, maskJ, image::ImageWriteOptions());
-        }
+                std::string outFilenameJ = "00_mask_J.png";
+                outFilenameJ = (fs::path(sEdge) / outFilenameJ).string();
+                writeImage(outFilenameI, maskI, image::ImageWriteOptions());
+                writeImage(outFilenameJ, maskJ, image::ImageWriteOptions());
+            }
 
-        //-- Compute the histograms
-        Image<RGBColor> imageI, imageJ;
-        readImage(p_imaNames.first, imageI, image::EImageColorSpace::LINEAR);
-        readImage(p_imaNames.second, imageJ, image::EImageColorSpace::LINEAR);
-
-        utils::Histogram<double> histoI(minvalue, maxvalue, bin);
-        utils::Histogram<double> histoJ(minvalue, maxvalue, bin);
-
-        int channelIndex = 0;  // RED channel
-        colorHarmonization::CommonDataByPair::computeHisto(histoI, maskI, channelIndex, imageI);
-        colorHarmonization::CommonDataByPair::computeHisto(histoJ, maskJ, channelIndex, imageJ);
-        relativeColorHistogramEdge& edgeR = mapRelativeHistograms[channelIndex][i];
-        edgeR = relativeColorHistogramEdge(mapCameraNodeToCameraIndex[viewI], mapCameraNodeToCameraIndex[viewJ], histoI.GetHist(), histoJ.GetHist());
-
-        histoI = histoJ = utils::Histogram<double>(minvalue, maxvalue, bin);
-        channelIndex = 1;  // GREEN channel
-        colorHarmonization::CommonDataByPair::computeHisto(histoI, maskI, channelIndex, imageI);
-        colorHarmonization::CommonDataByPair::computeHisto(histoJ, maskJ, channelIndex, imageJ);
-        relativeColorHistogramEdge& edgeG = mapRelativeHistograms[channelIndex][i];
-        edgeG = relativeColorHistogramEdge(mapCameraNodeToCameraIndex[viewI], mapCameraNodeToCameraIndex[viewJ], histoI.GetHist(), histoJ.GetHist());
-
-        histoI = histoJ = utils::Histogram<double>(minvalue, maxvalue, bin);
-        channelIndex = 2;  // BLUE channel
-        colorHarmonization::CommonDataByPair::computeHisto(histoI, maskI, channelIndex, imageI);
-        colorHarmonization::CommonDataByPair::computeHisto(histoJ, maskJ, channelIndex, imageJ);
-        relativeColorHistogramEdge& edgeB = mapRelativeHistograms[channelIndex][i];
-        edgeB = relativeColorHistogramEdge(mapCameraNodeToCameraIndex[viewI], mapCameraNodeToCameraIndex[viewJ], histoI.GetHist(), histoJ.GetHist());
+            //-- Compute the histograms
+            Image<RGBColor> imageI, imageJ;
+            readImage(p_imaNames.first, imageI, image::EImageColorSpace::LINEAR);
+            readImage(p_imaNames.second, imageJ, image::EImageColorSpace::LINEAR);
+
+            utils::Histogram<double> histoI(minvalue, maxvalue, bin);
+            utils::Histogram<double> histoJ(minvalue, maxvalue, bin);
+
+            int channelIndex = 0;  // RED channel
+            colorHarmonization::CommonDataByPair::computeHisto(histoI, maskI, channelIndex, imageI);
+            colorHarmonization::CommonDataByPair::computeHisto(histoJ, maskJ, channelIndex, imageJ);
+            relativeColorHistogramEdge& edgeR = mapRelativeHistograms[channelIndex][i];
+            edgeR = relativeColorHistogramEdge(mapCameraNodeToCameraIndex.at(viewI), mapCameraNodeToCameraIndex.at(viewJ), histoI.GetHist(), histoJ.GetHist());
+
+            histoI = histoJ = utils::Histogram<double>(minvalue, maxvalue, bin);
+            channelIndex = 1;  // GREEN channel
+            colorHarmonization::CommonDataByPair::computeHisto(histoI, maskI, channelIndex, imageI);
+            colorHarmonization::CommonDataByPair::computeHisto(histoJ, maskJ, channelIndex, imageJ);
+            relativeColorHistogramEdge& edgeG = mapRelativeHistograms[channelIndex][i];
+            edgeG = relativeColorHistogramEdge(mapCameraNodeToCameraIndex.at(viewI), mapCameraNodeToCameraIndex.at(viewJ), histoI.GetHist(), histoJ.GetHist());
+
+            histoI = histoJ = utils::Histogram<double>(minvalue, maxvalue, bin);
+            channelIndex = 2;  // BLUE channel
+            colorHarmonization::CommonDataByPair::computeHisto(histoI, maskI, channelIndex, imageI);
+            colorHarmonization::CommonDataByPair::computeHisto(histoJ, maskJ, channelIndex, imageJ);
+            relativeColorHistogramEdge& edgeB = mapRelativeHistograms[channelIndex][i];
+            edgeB = relativeColorHistogramEdge(mapCameraNodeToCameraIndex.at(viewI), mapCameraNodeToCameraIndex.at(viewJ), histoI.GetHist(), histoJ.GetHist());
+        }
+        catch (...)
+        {
+#pragma omp critical
+            exception = std::current_exception();
+        }
     }
 
-    std::cout << "\n -- \n SOLVE for color consistency with linear programming\n --" << std::endl;
+    if (exception)
+        std::rethrow_exception(exception);
+
+    std::cout << "\n -- \n SOLVE for color consistency with solver: " << _solver << "\n --" << std::endl;
     //-- Solve for the gains and offsets:
     std::vector<size_t> vecIndexToFix;
     vecIndexToFix.push_back(mapCameraNodeToCameraIndex[_imgRef]);
@@ -331,38 +365,31 @@ bool ColorHarmonizationEngineGlobal::process()
 #else
     typedef OSI_CISolverWrapper SOLVER_LP_T;
 #endif
-    // Red channel
-    {
-        SOLVER_LP_T lpSolver(vecSolutionR.size());
-
-        GainOffsetConstraintBuilder cstBuilder(mapRelativeHistograms[0], vecIndexToFix);
-        LPConstraintsSparse constraint;
-        cstBuilder.Build(constraint);
-        lpSolver.setup(constraint);
-        lpSolver.solve();
-        lpSolver.getSolution(vecSolutionR);
-    }
-    // Green channel
-    {
-        SOLVER_LP_T lpSolver(vecSolutionG.size());
-
-        GainOffsetConstraintBuilder cstBuilder(mapRelativeHistograms[1], vecIndexToFix);
-        LPConstraintsSparse constraint;
-        cstBuilder.Build(constraint);
-        lpSolver.setup(constraint);
-        lpSolver.solve();
-        lpSolver.getSolution(vecSolutionG);
-    }
-    // Blue channel
+    std::vector<double>* vecSolutions[3] = {&vecSolutionR, &vecSolutionG, &vecSolutionB};
+    for (int channelIndex = 0; channelIndex < 3; ++channelIndex)
     {
-        SOLVER_LP_T lpSolver(vecSolutionB.size());
-
-        GainOffsetConstraintBuilder cstBuilder(mapRelativeHistograms[2], vecIndexToFix);
-        LPConstraintsSparse constraint;
-        cstBuilder.Build(constraint);
-        lpSolver.setup(constraint);
-        lpSolver.solve();
-        lpSolver.getSolution(vecSolutionB);
+        std::vector<double>& vecSolution = *vecSolutions[channelIndex];
+
+        if (_solver == colorHarmonization::EGainOffsetSolver::LINF_LP)
+        {
+            SOLVER_LP_T lpSolver(vecSolution.size());
+
+            GainOffsetConstraintBuilder cstBuilder(mapRelativeHistograms[channelIndex], vecIndexToFix);
+            LPConstraintsSparse constraint;
+            cstBuilder.Build(constraint);
+            lpSolver.setup(constraint);
+            lpSolver.solve();
+            lpSolver.getSolution(vecSolution);
+        }
+        else if (!colorHarmonization::solveGainOffsetLeastSquares(setIndexImage.size(),
+                                                                  mapRelativeHistograms[channelIndex],
+                                                                  vecIndexToFix,
+                                                                  _solver == colorHarmonization::EGainOffsetSolver::L1_IRLS,
+                                                                  vecSolution))
+        {
+            std::cout << "Cannot solve the gains and offsets of the channel " << channelIndex << std::endl;
+            return false;
+        }
     }
 
     std::cout << std::endl
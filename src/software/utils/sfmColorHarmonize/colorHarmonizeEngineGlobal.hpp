@@ -8,6 +8,7 @@
 #pragma once
 
 #include <aliceVision/numeric/numeric.hpp>
+#include <aliceVision/colorHarmonization/GainOffsetLeastSquares.hpp>
 #include <aliceVision/feature/feature.hpp>
 #include <aliceVision/feature/RegionsPerView.hpp>
 #include <aliceVision/track/TracksBuilder.hpp>
@@ -53,6 +54,7 @@ class ColorHarmonizationEngineGlobal
                                    const std::string& outputDirectory,
                                    const std::vector<feature::EImageDescriberType>& descTypes,
                                    EHistogramSelectionMethod selectionMethod,
+                                   colorHarmonization::EGainOffsetSolver solver = colorHarmonization::EGainOffsetSolver::LINF_LP,
                                    int imgRef = 0);
 
     ~ColorHarmonizationEngineGlobal();
@@ -61,6 +63,7 @@ class ColorHarmonizationEngineGlobal
 
   private:
     EHistogramSelectionMethod _selectionMethod;
+    colorHarmonization::EGainOffsetSolver _solver;
     int _imgRef;
 
     // Input data